@@ -22,9 +22,14 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "tensorflow/c/c_api.h"
 #include "tensorflow/c/eager/c_api_internal.h"
+#include "tensorflow/c/eager/immediate_execution_context.h"
+#include "tensorflow/c/eager/immediate_execution_operation.h"
+#include "tensorflow/c/eager/immediate_execution_tensor_handle.h"
 #include "tensorflow/c/eager/tfe_context_internal.h"
 #include "tensorflow/c/eager/tfe_op_internal.h"
 #include "tensorflow/c/eager/tfe_tensorhandle_internal.h"
@@ -36,11 +41,16 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/coordination/coordination_service_error_util.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph_debug_info.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op_def.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/platform/casts.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/strcat.h"
 #include "tsl/c/tsl_status_internal.h"
@@ -992,3 +1002,195 @@ void TFE_InitializeLocalOnlyContext(TFE_Context* ctx, int keep_alive_secs,
           ->GetDistributedManager()
           ->InitializeLocalOnlyContext(server_def, keep_alive_secs);
 }
+
+namespace tensorflow {
+namespace {
+
+// Builds the function that runs a program given to TFE_ExecuteProgram, with
+// an empty name.
+Status BuildProgramFunction(
+    ImmediateExecutionContext* ctx,
+    absl::Span<ImmediateExecutionOperation* const> ops,
+    const TFE_ProgramValue* op_inputs, const int* num_op_inputs,
+    absl::Span<ImmediateExecutionTensorHandle* const> inputs,
+    absl::Span<const TFE_ProgramValue> outputs, FunctionDef* fdef) {
+  OpDef* signature = fdef->mutable_signature();
+  for (int i = 0; i < inputs.size(); ++i) {
+    OpDef::ArgDef* arg = signature->add_input_arg();
+    arg->set_name(strings::StrCat("input_", i));
+    arg->set_type(inputs[i]->DataType());
+  }
+  // The flattened output tensors of each op, as names in the function and
+  // types.
+  std::vector<std::vector<string>> op_output_names(ops.size());
+  std::vector<DataTypeVector> op_output_types(ops.size());
+  // Resolves a value available to ops before `num_ops`.
+  auto resolve = [&](const TFE_ProgramValue& value, int num_ops,
+                     string* name, DataType* dtype) {
+    if (value.op_index == -1) {
+      if (value.index < 0 || value.index >= inputs.size()) {
+        return errors::InvalidArgument("The program has ", inputs.size(),
+                                       " inputs, not input ", value.index);
+      }
+      *name = signature->input_arg(value.index).name();
+      *dtype = inputs[value.index]->DataType();
+      return OkStatus();
+    }
+    if (value.op_index < 0 || value.op_index >= num_ops) {
+      return errors::InvalidArgument("Op ", value.op_index,
+                                     " of the program cannot be used there");
+    }
+    const std::vector<string>& names = op_output_names[value.op_index];
+    if (value.index < 0 || value.index >= names.size()) {
+      return errors::InvalidArgument("Op ", value.op_index, " has ",
+                                     names.size(), " outputs, not output ",
+                                     value.index);
+    }
+    *name = names[value.index];
+    *dtype = op_output_types[value.op_index][value.index];
+    return OkStatus();
+  };
+
+  const TFE_ProgramValue* next_input = op_inputs;
+  for (int i = 0; i < ops.size(); ++i) {
+    ImmediateExecutionOperation* op = ops[i];
+    if (op->GetContext() != ctx) {
+      return errors::InvalidArgument("Op ", i, " (", op->Name(),
+                                     ") belongs to another context");
+    }
+    if (!op->GetInputs().empty()) {
+      return errors::InvalidArgument(
+          "Op ", i, " (", op->Name(),
+          ") has inputs of its own; they must be given by the program");
+    }
+    const OpDef* op_def = op->OpDef();
+    if (op_def == nullptr) {
+      return errors::Unimplemented("The program cannot call function ",
+                                   op->Name());
+    }
+    NameAttrList attrs;
+    op->GetOpAttrs()->GetNameAttrList(&attrs);
+    NodeDef* node = fdef->add_node_def();
+    node->set_name(strings::StrCat("op_", i));
+    node->set_op(op->Name());
+    node->set_device(op->DeviceName());
+    node->mutable_attr()->swap(*attrs.mutable_attr());
+    AddDefaultsToNodeDef(*op_def, node);
+
+    DataTypeVector input_types;
+    TF_RETURN_IF_ERROR(
+        InOutTypesForNode(*node, *op_def, &input_types, &op_output_types[i]));
+    if (num_op_inputs[i] != input_types.size()) {
+      return errors::InvalidArgument("Op ", i, " (", op->Name(), ") takes ",
+                                     input_types.size(), " inputs, not ",
+                                     num_op_inputs[i]);
+    }
+    for (int j = 0; j < input_types.size(); ++j) {
+      string name;
+      DataType dtype;
+      TF_RETURN_IF_ERROR(resolve(*next_input++, i, &name, &dtype));
+      if (dtype != input_types[j]) {
+        return errors::InvalidArgument(
+            "Input ", j, " of op ", i, " (", op->Name(), ") must be ",
+            DataTypeString(input_types[j]), ", not ", DataTypeString(dtype));
+      }
+      node->add_input(name);
+    }
+
+    NameRangeMap output_ranges;
+    TF_RETURN_IF_ERROR(
+        NameRangesForNode(*node, *op_def, nullptr, &output_ranges));
+    op_output_names[i].resize(op_output_types[i].size());
+    for (const auto& range : output_ranges) {
+      for (int j = range.second.first; j < range.second.second; ++j) {
+        op_output_names[i][j] = strings::StrCat(
+            node->name(), ":", range.first, ":", j - range.second.first);
+      }
+    }
+    // Stateful ops run even when none of their outputs are returned.
+    if (op_def->is_stateful()) {
+      signature->set_is_stateful(true);
+      signature->add_control_output(node->name());
+      (*fdef->mutable_control_ret())[node->name()] = node->name();
+    }
+  }
+
+  for (int i = 0; i < outputs.size(); ++i) {
+    if (outputs[i].op_index == -1) {
+      return errors::InvalidArgument("Output ", i,
+                                     " of the program must be an op output");
+    }
+    string name;
+    DataType dtype;
+    TF_RETURN_IF_ERROR(resolve(outputs[i], ops.size(), &name, &dtype));
+    OpDef::ArgDef* arg = signature->add_output_arg();
+    arg->set_name(strings::StrCat("output_", i));
+    arg->set_type(dtype);
+    (*fdef->mutable_ret())[arg->name()] = name;
+  }
+  return OkStatus();
+}
+
+Status ExecuteProgram(ImmediateExecutionContext* ctx,
+                      absl::Span<ImmediateExecutionOperation* const> ops,
+                      const TFE_ProgramValue* op_inputs,
+                      const int* num_op_inputs,
+                      absl::Span<ImmediateExecutionTensorHandle* const> inputs,
+                      absl::Span<const TFE_ProgramValue> outputs,
+                      ImmediateExecutionTensorHandle** retvals) {
+  FunctionDef fdef;
+  TF_RETURN_IF_ERROR(BuildProgramFunction(ctx, ops, op_inputs, num_op_inputs,
+                                          inputs, outputs, &fdef));
+  // The name depends on the program only, so a repeated program reuses its
+  // function and the kernel cached for it.
+  string serialized;
+  if (!SerializeToStringDeterministic(fdef, &serialized)) {
+    return errors::Internal("Unable to serialize the program");
+  }
+  const string name = absl::StrCat(
+      "__program_", absl::Hex(Fingerprint64(serialized), absl::kZeroPad16));
+  if (ctx->FindFunctionDef(name) == nullptr) {
+    fdef.mutable_signature()->set_name(name);
+    TF_RETURN_IF_ERROR(ctx->AddFunctionDef(fdef));
+  }
+
+  ImmediateOpPtr call_op(ctx->CreateOperation());
+  TF_RETURN_IF_ERROR(call_op->Reset(name.c_str(), nullptr));
+  for (ImmediateExecutionTensorHandle* input : inputs) {
+    TF_RETURN_IF_ERROR(call_op->AddInput(input));
+  }
+  int num_retvals = outputs.size();
+  TF_RETURN_IF_ERROR(ctx->GetCustomDeviceOpHandler().Execute(
+      call_op.get(), retvals, &num_retvals));
+  if (num_retvals != outputs.size()) {
+    return errors::Internal("The program returned ", num_retvals,
+                            " outputs instead of ", outputs.size());
+  }
+  return OkStatus();
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+void TFE_ExecuteProgram(TFE_Context* ctx, TFE_Op** ops, int num_ops,
+                        const TFE_ProgramValue* op_inputs,
+                        const int* num_op_inputs, TFE_TensorHandle** inputs,
+                        int num_inputs, const TFE_ProgramValue* outputs,
+                        int num_outputs, TFE_TensorHandle** retvals,
+                        TF_Status* status) {
+  std::vector<tensorflow::ImmediateExecutionOperation*> unwrapped_ops;
+  unwrapped_ops.reserve(num_ops);
+  for (int i = 0; i < num_ops; ++i) {
+    unwrapped_ops.push_back(tensorflow::unwrap(ops[i]));
+  }
+  std::vector<tensorflow::ImmediateExecutionTensorHandle*> unwrapped_inputs;
+  unwrapped_inputs.reserve(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    unwrapped_inputs.push_back(tensorflow::unwrap(inputs[i]));
+  }
+  status->status = tensorflow::ExecuteProgram(
+      tensorflow::unwrap(ctx), unwrapped_ops, op_inputs, num_op_inputs,
+      unwrapped_inputs, absl::MakeConstSpan(outputs, num_outputs),
+      reinterpret_cast<tensorflow::ImmediateExecutionTensorHandle**>(
+          retvals));
+}
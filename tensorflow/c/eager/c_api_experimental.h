@@ -788,6 +788,35 @@ TF_CAPI_EXPORT extern void TFE_InitializeLocalOnlyContext(TFE_Context* ctx,
                                                           size_t proto_len,
                                                           TF_Status* status);
 
+// A value in a program run by TFE_ExecuteProgram: output `index` of op
+// `op_index` of the program, or input `index` of the program when `op_index`
+// is -1.
+typedef struct TFE_ProgramValue {
+  int op_index;
+  int index;
+} TFE_ProgramValue;
+
+// Runs the `num_ops` ops in `ops` as a single eager call, which is cheaper
+// than calling TFE_Execute for each of them when they are small.
+//
+// The ops must have all their attributes set, including the ones that
+// TFE_OpAddInput would infer, and no inputs. Instead, the inputs of `ops[i]`
+// are the next `num_op_inputs[i]` values in `op_inputs`, which may refer to
+// `inputs` or to (flattened) outputs of `ops[0]` to `ops[i - 1]`. The
+// `num_outputs` values in `outputs` must refer to op outputs and are returned
+// in `retvals`, as new handles owned by the caller.
+//
+// The program is rewritten into a function, which is added to `ctx` once per
+// distinct program and then runs as one op: it is placed, instantiated and
+// cached once, and each run enqueues a single node. The ops keep the devices
+// set on them.
+TF_CAPI_EXPORT extern void TFE_ExecuteProgram(
+    TFE_Context* ctx, TFE_Op** ops, int num_ops,
+    const TFE_ProgramValue* op_inputs, const int* num_op_inputs,
+    TFE_TensorHandle** inputs, int num_inputs,
+    const TFE_ProgramValue* outputs, int num_outputs,
+    TFE_TensorHandle** retvals, TF_Status* status);
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
@@ -402,6 +402,60 @@ void Executor_MatMul_CPU(bool async) {
 TEST(CAPI, Executor_MatMul_CPU) { Executor_MatMul_CPU(false); }
 TEST(CAPI, Executor_MatMul_CPUAsync) { Executor_MatMul_CPU(true); }
 
+TFE_Op* ProgramOp(TFE_Context* ctx, const char* op_type, TF_Status* status) {
+  TFE_Op* op = TFE_NewOp(ctx, op_type, status);
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TFE_OpSetAttrType(op, "T", TF_FLOAT);
+  return op;
+}
+
+TEST(CAPI, ExecuteProgram) {
+  TF_Status* status = TF_NewStatus();
+  TFE_ContextOptions* opts = TFE_NewContextOptions();
+  TFE_Context* ctx = TFE_NewContext(opts, status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TFE_DeleteContextOptions(opts);
+  TFE_TensorHandle* m = TestMatrixTensorHandle(ctx);
+
+  // Computes matmul(m, m) + m.
+  TFE_Op* ops[] = {ProgramOp(ctx, "MatMul", status),
+                   ProgramOp(ctx, "AddV2", status)};
+  const TFE_ProgramValue op_inputs[] = {{-1, 0}, {-1, 0}, {0, 0}, {-1, 0}};
+  const int num_op_inputs[] = {2, 2};
+  const TFE_ProgramValue outputs[] = {{1, 0}};
+  // Runs the program twice, the second time with its cached function.
+  for (int run = 0; run < 2; ++run) {
+    TFE_TensorHandle* retval = nullptr;
+    TFE_ExecuteProgram(ctx, ops, 2, op_inputs, num_op_inputs, &m, 1, outputs,
+                       1, &retval, status);
+    ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TF_Tensor* t = TFE_TensorHandleResolve(retval, status);
+    ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    float product[4] = {0};
+    EXPECT_EQ(sizeof(product), TF_TensorByteSize(t));
+    memcpy(&product[0], TF_TensorData(t), TF_TensorByteSize(t));
+    TF_DeleteTensor(t);
+    TFE_DeleteTensorHandle(retval);
+    EXPECT_EQ(8, product[0]);
+    EXPECT_EQ(12, product[1]);
+    EXPECT_EQ(18, product[2]);
+    EXPECT_EQ(26, product[3]);
+  }
+
+  // An op cannot use the outputs of the ops after it.
+  const TFE_ProgramValue bad_op_inputs[] = {{1, 0}, {-1, 0}, {-1, 0}, {-1, 0}};
+  TFE_TensorHandle* retval = nullptr;
+  TFE_ExecuteProgram(ctx, ops, 2, bad_op_inputs, num_op_inputs, &m, 1,
+                     outputs, 1, &retval, status);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(status)) << TF_Message(status);
+
+  TFE_DeleteOp(ops[0]);
+  TFE_DeleteOp(ops[1]);
+  TFE_DeleteTensorHandle(m);
+  TFE_DeleteContext(ctx);
+  TF_DeleteStatus(status);
+}
+
 void Deleter(void* data, size_t unused, void* tensor_handle) {
   TFE_DeleteTensorHandle(static_cast<TFE_TensorHandle*>(tensor_handle));
 }
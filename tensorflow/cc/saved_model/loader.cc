@@ -18,7 +18,11 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/cc/saved_model/constants.h"
@@ -33,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op_def.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/graph/tensor_id.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/sampler.h"
@@ -41,12 +46,14 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/file_system_helper.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
 namespace {
@@ -266,6 +273,260 @@ Status RunRestore(const RunOptions& run_options, const string& export_dir,
                  nullptr /* outputs */, &run_metadata, session);
 }
 
+// Restores the variables of a SavedModel on demand.
+//
+// The restore graph of a saver reads each variable with an output of a
+// RestoreV2 op and assigns it with an Assign or AssignVariableOp op. A subset
+// of the variables is restored by reading them from the checkpoint directly,
+// feeding them to the outputs of the RestoreV2 ops, and running only their
+// assign ops.
+class LazyVariableRestorer {
+ public:
+  // Returns Unimplemented if the restore graph of the saver is not one that
+  // can be split by variable.
+  static Status Create(const MetaGraphDef& meta_graph,
+                       const string& variables_path,
+                       const RunOptions& run_options,
+                       std::unique_ptr<LazyVariableRestorer>* restorer) {
+    std::unique_ptr<LazyVariableRestorer> result(
+        new LazyVariableRestorer(variables_path, run_options));
+    absl::flat_hash_map<string, const NodeDef*> nodes;
+    for (const NodeDef& node : meta_graph.graph_def().node()) {
+      nodes[node.name()] = &node;
+      std::vector<string>& inputs = result->inputs_[node.name()];
+      for (const string& input : node.input()) {
+        inputs.emplace_back(ParseTensorName(input).node());
+      }
+    }
+    auto get_node = [&nodes](absl::string_view name) -> const NodeDef* {
+      auto it = nodes.find(ParseTensorName(name).node());
+      return it == nodes.end() ? nullptr : it->second;
+    };
+    auto unsupported = [](absl::string_view reason) {
+      return absl::UnimplementedError(
+          absl::StrCat("Cannot restore variables lazily: ", reason));
+    };
+
+    size_t num_restored_tensors = 0;
+    absl::flat_hash_set<string> restore_ops;
+    for (const string& name : result->Fanin(
+             {meta_graph.saver_def().restore_op_name()}, nullptr)) {
+      const NodeDef* node = get_node(name);
+      if (node == nullptr) continue;
+      if (node->op() == "RestoreV2") {
+        restore_ops.insert(node->name());
+        num_restored_tensors += node->attr().at("dtypes").list().type_size();
+        continue;
+      }
+      if (node->op() == "Restore" || node->op() == "RestoreSlice") {
+        return unsupported(absl::StrCat("found ", node->op(), " op"));
+      }
+      if ((node->op() != "Assign" && node->op() != "AssignVariableOp") ||
+          node->input_size() < 2) {
+        continue;
+      }
+      // Find the RestoreV2 output that is assigned.
+      TensorId value = ParseTensorName(node->input(1));
+      const NodeDef* value_node = get_node(value.node());
+      while (value_node != nullptr && value_node->op() == "Identity") {
+        value = ParseTensorName(value_node->input(0));
+        value_node = get_node(value.node());
+      }
+      if (value_node == nullptr || value_node->op() != "RestoreV2") continue;
+      const NodeDef* names_node = get_node(value_node->input(1));
+      const NodeDef* slices_node = get_node(value_node->input(2));
+      Tensor names, slices;
+      if (names_node == nullptr || names_node->op() != "Const" ||
+          slices_node == nullptr || slices_node->op() != "Const" ||
+          !names.FromProto(names_node->attr().at("value").tensor()) ||
+          !slices.FromProto(slices_node->attr().at("value").tensor()) ||
+          names.dtype() != DT_STRING || slices.dtype() != DT_STRING ||
+          value.index() >= names.NumElements() ||
+          value.index() >= slices.NumElements()) {
+        return unsupported(
+            absl::StrCat("unexpected inputs of ", value_node->name()));
+      }
+      if (!slices.flat<tstring>()(value.index()).empty()) {
+        return unsupported(
+            absl::StrCat("partitioned variable ",
+                         string(names.flat<tstring>()(value.index()))));
+      }
+      Variable& variable =
+          result->variables_[ParseTensorName(node->input(0)).node()];
+      variable.key = names.flat<tstring>()(value.index());
+      variable.value_tensor = value.ToString();
+      variable.assign_node = node->name();
+    }
+    if (result->variables_.size() != num_restored_tensors) {
+      return unsupported("not every restored tensor is assigned to a variable");
+    }
+    *restorer = std::move(result);
+    return OkStatus();
+  }
+
+  // Restores the variables used by the given tensors and nodes that are not
+  // restored yet.
+  Status RestoreFanin(const std::vector<string>& names, Session* session) {
+    {
+      tf_shared_lock l(mu_);
+      if (restored_.size() == variables_.size()) return OkStatus();
+      bool all_restored = true;
+      for (const string& name : names) {
+        if (!restored_fanin_.contains(ParseTensorName(name).node())) {
+          all_restored = false;
+          break;
+        }
+      }
+      if (all_restored) return OkStatus();
+    }
+    mutex_lock l(mu_);
+    std::vector<string> variables;
+    for (const string& name : Fanin(names, &restored_fanin_)) {
+      if (variables_.contains(name) && !restored_.contains(name)) {
+        variables.push_back(name);
+      }
+    }
+    TF_RETURN_IF_ERROR(Restore(variables, session));
+    for (const string& name : names) {
+      restored_fanin_.insert(string(ParseTensorName(name).node()));
+    }
+    return OkStatus();
+  }
+
+  // Restores all the variables that are not restored yet.
+  Status RestoreAll(Session* session) {
+    mutex_lock l(mu_);
+    std::vector<string> variables;
+    for (const auto& variable : variables_) {
+      if (!restored_.contains(variable.first)) {
+        variables.push_back(variable.first);
+      }
+    }
+    return Restore(variables, session);
+  }
+
+ private:
+  // How the restore graph restores a variable.
+  struct Variable {
+    // The key of the variable in the checkpoint.
+    string key;
+    // The RestoreV2 output that is assigned to the variable.
+    string value_tensor;
+    // The op that assigns the variable.
+    string assign_node;
+  };
+
+  LazyVariableRestorer(const string& variables_path,
+                       const RunOptions& run_options)
+      : variables_path_(variables_path), run_options_(run_options) {}
+
+  // Returns the nodes in the transitive fanin of `names`, including their own
+  // nodes. The fanin of the nodes in `done` is not visited.
+  std::vector<string> Fanin(
+      const std::vector<string>& names,
+      const absl::flat_hash_set<string>* done) const {
+    std::vector<string> fanin;
+    absl::flat_hash_set<string> visited;
+    for (const string& name : names) {
+      const string node(ParseTensorName(name).node());
+      if (visited.insert(node).second) fanin.push_back(node);
+    }
+    for (size_t i = 0; i < fanin.size(); ++i) {
+      if (done != nullptr && done->contains(fanin[i])) continue;
+      auto it = inputs_.find(fanin[i]);
+      if (it == inputs_.end()) continue;
+      for (const string& input : it->second) {
+        if (visited.insert(input).second) fanin.push_back(input);
+      }
+    }
+    return fanin;
+  }
+
+  Status Restore(const std::vector<string>& variables, Session* session)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (variables.empty()) return OkStatus();
+    LOG(INFO) << "Restoring " << variables.size()
+              << " variables of SavedModel bundle on demand.";
+    BundleReader reader(Env::Default(), variables_path_);
+    TF_RETURN_IF_ERROR(reader.status());
+    std::vector<std::pair<string, Tensor>> inputs;
+    std::vector<string> targets;
+    for (const string& name : variables) {
+      const Variable& variable = variables_.at(name);
+      Tensor value;
+      TF_RETURN_IF_ERROR(reader.Lookup(variable.key, &value));
+      inputs.emplace_back(variable.value_tensor, std::move(value));
+      targets.push_back(variable.assign_node);
+    }
+    RunMetadata run_metadata;
+    TF_RETURN_IF_ERROR(RunOnce(run_options_, inputs, {}, targets,
+                               nullptr /* outputs */, &run_metadata, session));
+    restored_.insert(variables.begin(), variables.end());
+    return OkStatus();
+  }
+
+  const string variables_path_;
+  const RunOptions run_options_;
+  // The input nodes of each node of the graph.
+  absl::flat_hash_map<string, std::vector<string>> inputs_;
+  // The restorable variables, by the name of their node.
+  absl::flat_hash_map<string, Variable> variables_;
+
+  mutable mutex mu_;
+  absl::flat_hash_set<string> restored_ TF_GUARDED_BY(mu_);
+  // The nodes whose variables in their fanin are all restored.
+  absl::flat_hash_set<string> restored_fanin_ TF_GUARDED_BY(mu_);
+};
+
+// Restores the variables used by the eager signatures and the init op of
+// `meta_graph`, and sets `restorer` to restore the others on demand. Leaves
+// `restorer` null if all variables must be restored instead.
+Status RunLazyRestore(const RunOptions& run_options, const string& export_dir,
+                      const MetaGraphDef& meta_graph,
+                      const LazyLoadOptions& lazy_options, Session* session,
+                      std::unique_ptr<LazyVariableRestorer>* restorer) {
+  const string variables_directory =
+      io::JoinPath(export_dir, kSavedModelVariablesDirectory);
+  TF_ASSIGN_OR_RETURN(
+      bool variables_index_exists,
+      internal::FileExists(
+          Env::Default(),
+          io::JoinPath(variables_directory,
+                       MetaFilename(kSavedModelVariablesFilename))));
+  if (!variables_index_exists) return OkStatus();
+
+  std::vector<string> eager_names;
+  for (const string& signature_name : lazy_options.eager_signatures) {
+    const auto signature = meta_graph.signature_def().find(signature_name);
+    if (signature == meta_graph.signature_def().end()) {
+      return absl::NotFoundError(
+          absl::StrCat("Eager signature ", signature_name, " not found"));
+    }
+    for (const auto& output : signature->second.outputs()) {
+      eager_names.push_back(output.second.name());
+    }
+  }
+  string init_op_name;
+  TF_RETURN_IF_ERROR(
+      internal::GetInitOp(export_dir, meta_graph, &init_op_name));
+  if (!init_op_name.empty()) eager_names.push_back(init_op_name);
+
+  std::unique_ptr<LazyVariableRestorer> lazy_restorer;
+  const Status create_status = LazyVariableRestorer::Create(
+      meta_graph,
+      io::JoinPath(variables_directory, kSavedModelVariablesFilename),
+      run_options, &lazy_restorer);
+  if (!create_status.ok()) {
+    LOG(WARNING) << create_status << ". Restoring all variables.";
+    return OkStatus();
+  }
+  LOG(INFO) << "Restoring the variables of SavedModel bundle for "
+            << lazy_options.eager_signatures.size() << " eager signatures.";
+  TF_RETURN_IF_ERROR(lazy_restorer->RestoreFanin(eager_names, session));
+  *restorer = std::move(lazy_restorer);
+  return OkStatus();
+}
+
 }  // namespace
 
 SavedModelBundleInterface::~SavedModelBundleInterface() = default;
@@ -280,10 +541,23 @@ Status LoadMetagraphIntoSession(const SessionOptions& session_options,
   return (*session)->Create(meta_graph.graph_def());
 }
 
+namespace {
+
+Status RestoreSessionInternal(const RunOptions& run_options,
+                              const MetaGraphDef& meta_graph,
+                              const string& export_dir,
+                              const LazyLoadOptions* lazy_options,
+                              std::unique_ptr<LazyVariableRestorer>* restorer,
+                              std::unique_ptr<Session>* session);
+
+// Loads the SavedModel into `bundle`. If `lazy_options` is not null, the
+// variables that are not restored yet are left to `restorer`.
 Status LoadSavedModelInternal(const SessionOptions& session_options,
                               const RunOptions& run_options,
                               const string& export_dir,
                               const std::unordered_set<string>& tags,
+                              const LazyLoadOptions* lazy_options,
+                              std::unique_ptr<LazyVariableRestorer>* restorer,
                               SavedModelBundle* const bundle) {
   TF_RETURN_IF_ERROR(ReadMetaGraphDefFromSavedModel(export_dir, tags,
                                                     &bundle->meta_graph_def));
@@ -291,15 +565,20 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
       ReadSavedModelDebugInfoIfPresent(export_dir, &bundle->debug_info));
   TF_RETURN_IF_ERROR(LoadMetagraphIntoSession(
       session_options, bundle->meta_graph_def, &bundle->session));
-  TF_RETURN_IF_ERROR(RestoreSession(run_options, bundle->meta_graph_def,
-                                    export_dir, &bundle->session));
+  TF_RETURN_IF_ERROR(RestoreSessionInternal(run_options,
+                                            bundle->meta_graph_def, export_dir,
+                                            lazy_options, restorer,
+                                            &bundle->session));
   return OkStatus();
 }
 
-Status LoadSavedModel(const SessionOptions& session_options,
-                      const RunOptions& run_options, const string& export_dir,
-                      const std::unordered_set<string>& tags,
-                      SavedModelBundle* const bundle) {
+Status LoadSavedModelAndRecord(const SessionOptions& session_options,
+                               const RunOptions& run_options,
+                               const string& export_dir,
+                               const std::unordered_set<string>& tags,
+                               const LazyLoadOptions* lazy_options,
+                               std::unique_ptr<LazyVariableRestorer>* restorer,
+                               SavedModelBundle* const bundle) {
   metrics::SavedModelReadApi(kCCLoadLabel).IncrementBy(1);
   auto fingerprint_proto =
       saved_model::fingerprinting::ReadSavedModelFingerprint(export_dir);
@@ -311,8 +590,9 @@ Status LoadSavedModel(const SessionOptions& session_options,
 
   // TODO(robson): Add tests for the counters.
   const uint64 start_microseconds = Env::Default()->NowMicros();
-  const Status status = LoadSavedModelInternal(session_options, run_options,
-                                               export_dir, tags, bundle);
+  const Status status =
+      LoadSavedModelInternal(session_options, run_options, export_dir, tags,
+                             lazy_options, restorer, bundle);
   auto log_and_count = [&](const string& status_str) {
     LOG(INFO) << "SavedModel load for tags { " << absl::StrJoin(tags, " ")
               << " }; Status: " << status_str << ": " << status << ". Took "
@@ -330,6 +610,17 @@ Status LoadSavedModel(const SessionOptions& session_options,
   return status;
 }
 
+}  // namespace
+
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options, const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      SavedModelBundle* const bundle) {
+  return LoadSavedModelAndRecord(session_options, run_options, export_dir, tags,
+                                 /*lazy_options=*/nullptr,
+                                 /*restorer=*/nullptr, bundle);
+}
+
 namespace {
 // Session wrapper that prevents calls to Session::Create(), Session::Extend(),
 // and the deprecated partial-run methods.
@@ -337,10 +628,14 @@ namespace {
 // Limiting the available methods on a returned Session gives us the option
 // to replace the Session with a cut-down implementation, without breaking any
 // users.
+//
+// If `restorer` is not null, runs restore the variables they use first.
 class LiteSessionWrapper : public Session {
  public:
-  explicit LiteSessionWrapper(std::unique_ptr<Session> wrapped)
-      : wrapped_(std::move(wrapped)) {}
+  explicit LiteSessionWrapper(
+      std::unique_ptr<Session> wrapped,
+      std::unique_ptr<LazyVariableRestorer> restorer = nullptr)
+      : wrapped_(std::move(wrapped)), restorer_(std::move(restorer)) {}
 
   Status Create(const GraphDef& graph) override {
     return absl::UnimplementedError("Session::Create()");
@@ -360,6 +655,7 @@ class LiteSessionWrapper : public Session {
              const std::vector<string>& output_tensor_names,
              const std::vector<string>& target_node_names,
              std::vector<Tensor>* outputs) override {
+    TF_RETURN_IF_ERROR(MaybeRestore(output_tensor_names, target_node_names));
     return wrapped_->Run(inputs, output_tensor_names, target_node_names,
                          outputs);
   }
@@ -385,6 +681,7 @@ class LiteSessionWrapper : public Session {
              const std::vector<string>& output_tensor_names,
              const std::vector<string>& target_node_names,
              std::vector<Tensor>* outputs, RunMetadata* run_metadata) override {
+    TF_RETURN_IF_ERROR(MaybeRestore(output_tensor_names, target_node_names));
     return wrapped_->Run(run_options, inputs, output_tensor_names,
                          target_node_names, outputs, run_metadata);
   }
@@ -411,6 +708,9 @@ class LiteSessionWrapper : public Session {
 
   Status MakeCallable(const CallableOptions& callable_options,
                       CallableHandle* out_handle) override {
+    TF_RETURN_IF_ERROR(MaybeRestore(
+        {callable_options.fetch().begin(), callable_options.fetch().end()},
+        {callable_options.target().begin(), callable_options.target().end()}));
     return wrapped_->MakeCallable(callable_options, out_handle);
   }
 
@@ -434,24 +734,52 @@ class LiteSessionWrapper : public Session {
     return wrapped_->ReleaseCallable(handle);
   }
 
-  Status Finalize() override { return wrapped_->Finalize(); }
+  Status Finalize() override {
+    // No variable can be restored once the session is finalized.
+    if (restorer_) {
+      TF_RETURN_IF_ERROR(restorer_->RestoreAll(wrapped_.get()));
+    }
+    return wrapped_->Finalize();
+  }
 
  private:
+  Status MaybeRestore(const std::vector<string>& output_tensor_names,
+                      const std::vector<string>& target_node_names) {
+    if (!restorer_) return OkStatus();
+    std::vector<string> names(output_tensor_names);
+    names.insert(names.end(), target_node_names.begin(),
+                 target_node_names.end());
+    return restorer_->RestoreFanin(names, wrapped_.get());
+  }
+
   const std::unique_ptr<Session> wrapped_;
+  const std::unique_ptr<LazyVariableRestorer> restorer_;
 };
 }  // namespace
 
-Status RestoreSession(const RunOptions& run_options,
-                      const MetaGraphDef& meta_graph, const string& export_dir,
-                      std::unique_ptr<Session>* session) {
+namespace {
+
+Status RestoreSessionInternal(const RunOptions& run_options,
+                              const MetaGraphDef& meta_graph,
+                              const string& export_dir,
+                              const LazyLoadOptions* lazy_options,
+                              std::unique_ptr<LazyVariableRestorer>* restorer,
+                              std::unique_ptr<Session>* session) {
   const uint64 read_start_microseconds = Env::Default()->NowMicros();
   std::vector<AssetFileDef> asset_file_defs;
   TF_RETURN_IF_ERROR(internal::GetAssetFileDefs(meta_graph, &asset_file_defs));
   if (meta_graph.has_saver_def()) {
-    TF_RETURN_IF_ERROR(RunRestore(run_options, export_dir,
-                                  meta_graph.saver_def().restore_op_name(),
-                                  meta_graph.saver_def().filename_tensor_name(),
-                                  asset_file_defs, session->get()));
+    if (lazy_options != nullptr) {
+      TF_RETURN_IF_ERROR(RunLazyRestore(run_options, export_dir, meta_graph,
+                                        *lazy_options, session->get(),
+                                        restorer));
+    }
+    if (lazy_options == nullptr || *restorer == nullptr) {
+      TF_RETURN_IF_ERROR(RunRestore(
+          run_options, export_dir, meta_graph.saver_def().restore_op_name(),
+          meta_graph.saver_def().filename_tensor_name(), asset_file_defs,
+          session->get()));
+    }
   }
   // Record walltime spent in restoring graph from disk, but postpone metric
   // increments until graph init finishes.
@@ -472,10 +800,12 @@ Status RestoreSession(const RunOptions& run_options,
   return OkStatus();
 }
 
-Status LoadSavedModel(const SessionOptions& session_options,
-                      const RunOptions& run_options, const string& export_dir,
-                      const std::unordered_set<string>& tags,
-                      SavedModelBundleLite* const bundle) {
+Status LoadSavedModelLite(const SessionOptions& session_options,
+                          const RunOptions& run_options,
+                          const string& export_dir,
+                          const std::unordered_set<string>& tags,
+                          const LazyLoadOptions* lazy_options,
+                          SavedModelBundleLite* const bundle) {
   SavedModelBundle legacy_bundle;
   SessionOptions rewritten_options(session_options);
   // We disallow calls to Session::Extend() on the returned session, so we can
@@ -489,14 +819,44 @@ Status LoadSavedModel(const SessionOptions& session_options,
       ->set_disable_output_partition_graphs(true);
   // TODO(mrry): Consider specializing the session creation to reduce peak
   // RAM consumption by using `Session::Create(GraphDef&&)`.
-  TF_RETURN_IF_ERROR(LoadSavedModel(rewritten_options, run_options, export_dir,
-                                    tags, &legacy_bundle));
+  std::unique_ptr<LazyVariableRestorer> restorer;
+  TF_RETURN_IF_ERROR(LoadSavedModelAndRecord(rewritten_options, run_options,
+                                             export_dir, tags, lazy_options,
+                                             &restorer, &legacy_bundle));
   *bundle = SavedModelBundleLite(
-      std::make_unique<LiteSessionWrapper>(std::move(legacy_bundle.session)),
+      std::make_unique<LiteSessionWrapper>(std::move(legacy_bundle.session),
+                                           std::move(restorer)),
       std::move(*legacy_bundle.meta_graph_def.mutable_signature_def()));
   return OkStatus();
 }
 
+}  // namespace
+
+Status RestoreSession(const RunOptions& run_options,
+                      const MetaGraphDef& meta_graph, const string& export_dir,
+                      std::unique_ptr<Session>* session) {
+  return RestoreSessionInternal(run_options, meta_graph, export_dir,
+                                /*lazy_options=*/nullptr, /*restorer=*/nullptr,
+                                session);
+}
+
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options, const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      SavedModelBundleLite* const bundle) {
+  return LoadSavedModelLite(session_options, run_options, export_dir, tags,
+                            /*lazy_options=*/nullptr, bundle);
+}
+
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options, const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      const LazyLoadOptions& lazy_options,
+                      SavedModelBundleLite* const bundle) {
+  return LoadSavedModelLite(session_options, run_options, export_dir, tags,
+                            &lazy_options, bundle);
+}
+
 bool MaybeSavedModelDirectory(const string& export_dir) {
   const string saved_model_pb_path =
       io::JoinPath(export_dir, kSavedModelFilenamePb);
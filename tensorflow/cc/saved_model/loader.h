@@ -135,6 +135,29 @@ Status LoadSavedModel(const SessionOptions& session_options,
                       const std::unordered_set<string>& tags,
                       SavedModelBundleLite* bundle);
 
+/// Options for loading a SavedModel lazily.
+struct LazyLoadOptions {
+  /// The signatures that are ready to serve once loading returns. The
+  /// variables used only by other signatures are restored on the first run
+  /// that uses them.
+  std::unordered_set<string> eager_signatures;
+};
+
+/// Loads a SavedModel like the overload above, but restores only the
+/// variables used by `lazy_options.eager_signatures` and the init op. The
+/// other variables are restored from the export directory by the first run
+/// (or callable) of the session that uses them, and by Session::Finalize().
+///
+/// The session already prunes, optimizes and instantiates the subgraph of a
+/// signature on its first run, so deferring the restore of the variables
+/// makes loading cost only what the eager signatures need. If the restore
+/// graph of the saver cannot be split, all variables are restored eagerly.
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options, const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      const LazyLoadOptions& lazy_options,
+                      SavedModelBundleLite* bundle);
+
 /// Checks whether the provided directory could contain a SavedModel. Note that
 /// the method does not load any data by itself. If the method returns `false`,
 /// the export directory definitely does not contain a SavedModel. If the method
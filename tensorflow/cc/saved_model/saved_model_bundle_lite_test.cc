@@ -148,6 +148,47 @@ TEST_F(LoaderTest, TagMatch) {
   CheckSavedModelBundle(export_dir, bundle);
 }
 
+TEST_F(LoaderTest, LazyLoad) {
+  SavedModelBundleLite bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+  LazyLoadOptions lazy_options;
+  lazy_options.eager_signatures = {"regress_x_to_y"};
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                              {kSavedModelTagServe}, lazy_options, &bundle));
+  CheckSavedModelBundle(export_dir, bundle);
+
+  // The variable "c" is only used by the lazy signatures, and is restored by
+  // their first run.
+  const auto& signature_def = bundle.GetSignatures().at("regress_x2_to_y3");
+  const string input_name = signature_def.inputs().at(kRegressInputs).name();
+  const string output_name = signature_def.outputs().at(kRegressOutputs).name();
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(bundle.GetSession()->Run(
+      {{input_name, test::AsTensor<float>({1, 2}, TensorShape({2, 1}))}},
+      {output_name}, {}, &outputs));
+  ASSERT_EQ(outputs.size(), 1);
+  test::ExpectTensorEqual<float>(
+      outputs[0], test::AsTensor<float>({3.5, 4}, TensorShape({2, 1})));
+}
+
+TEST_F(LoaderTest, LazyLoadMissingSignature) {
+  SavedModelBundleLite bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+  LazyLoadOptions lazy_options;
+  lazy_options.eager_signatures = {"missing-signature"};
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  Status st = LoadSavedModel(session_options, run_options, export_dir,
+                             {kSavedModelTagServe}, lazy_options, &bundle);
+  EXPECT_TRUE(errors::IsNotFound(st)) << st;
+}
+
 TEST_F(LoaderTest, NoTagMatch) {
   SavedModelBundleLite bundle;
   RunOptions run_options;
@@ -0,0 +1,153 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/warmup.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
+
+namespace tensorflow {
+namespace {
+
+// Runs "request" on the signature it targets, fetching all the outputs of
+// the signature.
+Status RunWarmupRequest(const RunOptions& run_options,
+                        const SavedModelWarmupRequest& request,
+                        const SavedModelBundleInterface& bundle) {
+  const auto& signatures = bundle.GetSignatures();
+  const auto signature = signatures.find(request.signature_key);
+  if (signature == signatures.end()) {
+    return errors::NotFound("Warmup request for unknown signature ",
+                            request.signature_key);
+  }
+  std::vector<std::pair<string, Tensor>> inputs;
+  inputs.reserve(request.inputs.size());
+  for (const auto& [key, tensor] : request.inputs) {
+    const auto input = signature->second.inputs().find(key);
+    if (input == signature->second.inputs().end()) {
+      return errors::InvalidArgument("Signature ", request.signature_key,
+                                     " has no input ", key);
+    }
+    inputs.emplace_back(input->second.name(), tensor);
+  }
+  std::vector<string> output_names;
+  for (const auto& output : signature->second.outputs()) {
+    output_names.push_back(output.second.name());
+  }
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  return bundle.GetSession()->Run(run_options, inputs, output_names,
+                                  /*target_node_names=*/{}, &outputs,
+                                  &run_metadata);
+}
+
+}  // namespace
+
+std::string GetSavedModelWarmupCachePath(const std::string& export_dir) {
+  return io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory,
+                      kSavedModelWarmupCacheFilename);
+}
+
+Status SaveSavedModelWarmupCache(Env* env, const std::string& path) {
+  std::string serialized;
+  TF_RETURN_IF_ERROR(SerializeAutotuneMaps(&serialized));
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(std::string(io::Dirname(path))));
+  return WriteStringToFile(env, path, serialized);
+}
+
+Status LoadSavedModelWarmupCache(Env* env, const std::string& path,
+                                 bool* loaded) {
+  *loaded = false;
+  const Status exists = env->FileExists(path);
+  if (errors::IsNotFound(exists)) {
+    return OkStatus();
+  }
+  TF_RETURN_IF_ERROR(exists);
+  std::string serialized;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, path, &serialized));
+  TF_RETURN_IF_ERROR(LoadSerializedAutotuneMaps(serialized));
+  *loaded = true;
+  return OkStatus();
+}
+
+Status RunSavedModelWarmup(const SavedModelWarmupOptions& options,
+                           const RunOptions& run_options,
+                           const std::vector<SavedModelWarmupRequest>& requests,
+                           const SavedModelBundleInterface& bundle) {
+  Env* env = Env::Default();
+  bool cache_loaded = false;
+  if (!options.cache_path.empty()) {
+    TF_RETURN_IF_ERROR(
+        LoadSavedModelWarmupCache(env, options.cache_path, &cache_loaded));
+  }
+
+  serving::WarmupStateRegistry::Handle handle;
+  if (options.model_key.has_value()) {
+    auto per_model_data =
+        std::make_unique<serving::WarmupStateRegistry::PerModelData>();
+    per_model_data->warmup_all_batch_sizes = options.warmup_all_batch_sizes;
+    TF_ASSIGN_OR_RETURN(handle,
+                        serving::GetGlobalWarmupStateRegistry().Register(
+                            *options.model_key, std::move(per_model_data)));
+  }
+
+  // With a loaded cache, autotuning is skipped, and a single replay is enough
+  // to create the executors and initialize the kernels.
+  const int num_replays = cache_loaded ? 1 : std::max(options.num_replays, 1);
+  mutex mu;
+  Status status;
+  auto replay = [&](const SavedModelWarmupRequest& request) {
+    for (int i = 0; i < num_replays; ++i) {
+      const Status run_status = RunWarmupRequest(run_options, request, bundle);
+      if (!run_status.ok()) {
+        mutex_lock l(mu);
+        status.Update(run_status);
+        return;
+      }
+    }
+  };
+  const int num_threads =
+      std::min<int>(options.num_threads, static_cast<int>(requests.size()));
+  if (num_threads <= 1) {
+    for (const auto& request : requests) replay(request);
+  } else {
+    // The destructor of the pool waits for all the replays.
+    thread::ThreadPool pool(env, "TF_saved_model_warmup", num_threads);
+    for (const auto& request : requests) {
+      pool.Schedule([&replay, &request]() { replay(request); });
+    }
+  }
+  TF_RETURN_IF_ERROR(status);
+
+  if (!options.cache_path.empty() && !cache_loaded) {
+    TF_RETURN_IF_ERROR(SaveSavedModelWarmupCache(env, options.cache_path));
+  }
+  return OkStatus();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,88 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Replays warmup requests on a loaded SavedModel, and persists the caches
+// populated by warmup next to the model so that later loads can skip the
+// expensive part of it.
+
+#ifndef TENSORFLOW_CC_SAVED_MODEL_WARMUP_H_
+#define TENSORFLOW_CC_SAVED_MODEL_WARMUP_H_
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/cc/saved_model/loader.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/batching_util/warmup.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+
+/// File in the assets.extra directory of a SavedModel holding the autotune
+/// results collected by warmup.
+inline constexpr char kSavedModelWarmupCacheFilename[] =
+    "tf_warmup_autotune_maps.pb";
+
+/// A request replayed on a signature of the SavedModel during warmup.
+struct SavedModelWarmupRequest {
+  std::string signature_key;
+  /// Inputs keyed by the input names of the signature.
+  std::vector<std::pair<std::string, Tensor>> inputs;
+};
+
+struct SavedModelWarmupOptions {
+  /// Number of threads replaying the requests. Requests are independent, so
+  /// requests for different signatures and batch sizes warm up in parallel.
+  int num_threads = 1;
+
+  /// Number of times each request is replayed. After a warmup cache was
+  /// loaded, each request is only replayed once.
+  int num_replays = 1;
+
+  /// If set, the model is registered in the global WarmupStateRegistry while
+  /// the requests are replayed.
+  std::optional<serving::WarmupStateRegistry::Key> model_key;
+  bool warmup_all_batch_sizes = false;
+
+  /// If non-empty, the warmup cache is loaded from this file when it exists,
+  /// and written to it after warmup otherwise. Usually the result of
+  /// GetSavedModelWarmupCachePath.
+  std::string cache_path;
+};
+
+/// Returns the path of the warmup cache of the SavedModel in "export_dir".
+std::string GetSavedModelWarmupCachePath(const std::string& export_dir);
+
+/// Writes the autotune results collected so far to "path".
+Status SaveSavedModelWarmupCache(Env* env, const std::string& path);
+
+/// Loads the autotune results in "path" into the runtime. Sets "*loaded" to
+/// false, and returns OK, if there is no such file.
+Status LoadSavedModelWarmupCache(Env* env, const std::string& path,
+                                 bool* loaded);
+
+/// Replays "requests" on "bundle" as described by "options".
+Status RunSavedModelWarmup(const SavedModelWarmupOptions& options,
+                           const RunOptions& run_options,
+                           const std::vector<SavedModelWarmupRequest>& requests,
+                           const SavedModelBundleInterface& bundle);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CC_SAVED_MODEL_WARMUP_H_
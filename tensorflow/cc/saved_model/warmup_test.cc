@@ -0,0 +1,118 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/warmup.h"
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/saved_model/loader.h"
+#include "tensorflow/cc/saved_model/signature_constants.h"
+#include "tensorflow/cc/saved_model/tag_constants.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kTestDataSharded[] =
+    "cc/saved_model/testdata/half_plus_two/00000123";
+
+class SavedModelWarmupTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const string export_dir =
+        io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+    TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                                {kSavedModelTagServe}, &bundle_));
+  }
+
+  // Returns requests on "regress_x2_to_y3" for several batch sizes.
+  std::vector<SavedModelWarmupRequest> MakeRequests() {
+    std::vector<SavedModelWarmupRequest> requests;
+    for (int64_t batch_size : {1, 2, 4, 8}) {
+      SavedModelWarmupRequest request;
+      request.signature_key = "regress_x2_to_y3";
+      Tensor input(DT_FLOAT, TensorShape({batch_size, 1}));
+      test::FillIota<float>(&input, 0);
+      request.inputs.emplace_back(kRegressInputs, input);
+      requests.push_back(request);
+    }
+    return requests;
+  }
+
+  SavedModelBundleLite bundle_;
+};
+
+TEST_F(SavedModelWarmupTest, ReplaysInParallelAndPersistsCache) {
+  SavedModelWarmupOptions options;
+  options.num_threads = 4;
+  options.num_replays = 2;
+  options.cache_path =
+      GetSavedModelWarmupCachePath(io::JoinPath(testing::TmpDir(), "warmup"));
+  Env* env = Env::Default();
+  EXPECT_TRUE(errors::IsNotFound(env->FileExists(options.cache_path)));
+  TF_ASSERT_OK(
+      RunSavedModelWarmup(options, RunOptions(), MakeRequests(), bundle_));
+  TF_EXPECT_OK(env->FileExists(options.cache_path));
+
+  // A later warmup loads the cache.
+  bool loaded = false;
+  TF_ASSERT_OK(LoadSavedModelWarmupCache(env, options.cache_path, &loaded));
+  EXPECT_TRUE(loaded);
+  TF_ASSERT_OK(
+      RunSavedModelWarmup(options, RunOptions(), MakeRequests(), bundle_));
+}
+
+TEST_F(SavedModelWarmupTest, RegistersModelWhileReplaying) {
+  SavedModelWarmupOptions options;
+  options.model_key = serving::WarmupStateRegistry::Key("half_plus_two", 123);
+  options.warmup_all_batch_sizes = true;
+  TF_ASSERT_OK(
+      RunSavedModelWarmup(options, RunOptions(), MakeRequests(), bundle_));
+  // The registration is released after warmup.
+  EXPECT_EQ(
+      serving::GetGlobalWarmupStateRegistry().Lookup(*options.model_key),
+      nullptr);
+}
+
+TEST_F(SavedModelWarmupTest, InvalidRequests) {
+  SavedModelWarmupOptions options;
+  options.num_threads = 2;
+  std::vector<SavedModelWarmupRequest> requests = MakeRequests();
+  requests[1].signature_key = "missing";
+  EXPECT_TRUE(errors::IsNotFound(
+      RunSavedModelWarmup(options, RunOptions(), requests, bundle_)));
+
+  requests = MakeRequests();
+  requests[0].inputs[0].first = "missing";
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      RunSavedModelWarmup(options, RunOptions(), requests, bundle_)));
+}
+
+TEST(SavedModelWarmupCacheTest, MissingCache) {
+  bool loaded = true;
+  TF_ASSERT_OK(LoadSavedModelWarmupCache(
+      Env::Default(), io::JoinPath(testing::TmpDir(), "no_warmup_cache.pb"),
+      &loaded));
+  EXPECT_FALSE(loaded);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include <utility>
 
 #include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/xla_activity.pb.h"
 #include "tensorflow/compiler/jit/xla_activity_listener.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
@@ -166,6 +167,17 @@ bool DeviceCompilationProfiler::ShouldCompileCluster(
     return false;
   }
 
+  // Clusters that used up their compile budget keep their executables, but run
+  // in the TF executor for signatures they haven't been compiled for.
+  const int64_t max_compiles =
+      GetXlaOpsCommonFlags()->tf_xla_max_compiles_per_cluster;
+  if (max_compiles > 0 && it->second.compile_count >= max_compiles) {
+    VLOG(2) << "Not compiling cluster " << function.name()
+            << " because it has been compiled " << it->second.compile_count
+            << " times; the limit is " << max_compiles << ".";
+    return false;
+  }
+
   // TODO(b/255826209): Figure out if Lazy compilation is still needed given
   // that we always compile a cluster the first time it is executed (explained
   // below) regardless of compilation mode. If it is not, clean up the related
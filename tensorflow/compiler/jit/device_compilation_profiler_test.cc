@@ -21,6 +21,7 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/tests/device_compiler_test_helper.h"
 #include "tensorflow/compiler/jit/xla_activity.pb.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
@@ -239,5 +240,41 @@ TEST(DeviceCompilationProfilerTest, ShouldCompileClusterLazy) {
                                              kDefaultCompilationThreshold));
 }
 
+TEST(DeviceCompilationProfilerTest, ShouldCompileClusterOverBudget) {
+  DeviceCompilationProfiler* profiler = new DeviceCompilationProfiler();
+  core::ScopedUnref profiler_ref(profiler);
+
+  NameAttrList function;
+  function.set_name("TestFunc");
+
+  XlaOpsCommonFlags* flags = GetXlaOpsCommonFlags();
+  const int64_t old_max_compiles = flags->tf_xla_max_compiles_per_cluster;
+  flags->tf_xla_max_compiles_per_cluster = 3;
+
+  // Execute often enough for the cluster not to go megamorphic.
+  for (int i = 0; i < 100; ++i) {
+    profiler->RegisterExecution(function);
+  }
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(profiler->RegisterCompilation(function, 1, false).ok());
+  }
+  EXPECT_TRUE(
+      profiler->ShouldCompileCluster(function, DeviceCompileMode::kLazy, 2));
+
+  EXPECT_TRUE(profiler->RegisterCompilation(function, 1, false).ok());
+  EXPECT_FALSE(
+      profiler->ShouldCompileCluster(function, DeviceCompileMode::kLazy, 2));
+  EXPECT_FALSE(
+      profiler->ShouldCompileCluster(function, DeviceCompileMode::kAsync, 0));
+  TF_ASSERT_OK_AND_ASSIGN(auto stats, profiler->GetCompileStats(function));
+  EXPECT_FALSE(stats.is_megamorphic);
+
+  // Always compile for strict compile mode.
+  EXPECT_TRUE(
+      profiler->ShouldCompileCluster(function, DeviceCompileMode::kStrict, 0));
+
+  flags->tf_xla_max_compiles_per_cluster = old_max_compiles;
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -55,6 +55,15 @@ class DeviceCompilerClient {
       const XlaCompiler::CompilationResult& result,
       const std::string& serialized_executable) = 0;
 
+  // Returns a description of the device that executables built with `options`
+  // run on, e.g. its name and runtime version, or an empty string if it can't
+  // be described. Executables are only interchangeable between devices with the
+  // same description.
+  virtual std::string GetDeviceDescription(
+      const XlaCompiler::Options& options) {
+    return "";
+  }
+
   // Waits for the underlying `ClientType` backend's programs to finish
   // executing before returning.
   virtual void WaitForProgramsToFinish() = 0;
@@ -20,17 +20,20 @@ limitations under the License.
 #include <string>
 
 #include "absl/log/log.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/compiler/jit/xla_compilation_cache.pb.h"
 #include "tensorflow/compiler/jit/xla_device_compiler_client.h"
 #include "tensorflow/compiler/tf2xla/xla_compiler.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/util.h"
+#include "xla/xla.pb.h"
 #include "tensorflow/core/framework/device.h"
 #include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/statusor.h"
 
 namespace tensorflow {
@@ -114,11 +117,20 @@ class DeviceExecutablePersistor {
   // Returns a cache key proto that identifies an entry in the compilation
   // cache.
   XlaSerializedCacheKey BuildSerializedCacheKey(
-      uint64 signature_hash, const xla::HloModuleProto& hlo_module) const;
+      uint64 signature_hash, const xla::HloModuleProto& hlo_module,
+      uint64 environment_fingerprint) const;
 
   XlaSerializedCacheKey BuildSerializedCacheKey(
       uint64 signature_hash, const xla::HloModuleProto& hlo_module,
-      bool compiled_using_pjrt) const;
+      uint64 environment_fingerprint, bool compiled_using_pjrt) const;
+
+  // Returns a fingerprint of the device and XLA debug options that executables
+  // compiled with `options` depend on, or 0 if `compiler_client` can't
+  // describe its device.
+  uint64 GetEnvironmentFingerprint(
+      const XlaCompiler::Options& options,
+      const XlaCompiler::CompilationResult& compilation_result,
+      DeviceCompilerClient<ExecutableType, ClientType>* compiler_client) const;
 
   // Serializes the signature and its corresponding entry to a proto message.
   StatusOr<XlaSerializedCacheEntry> SerializeEntry(
@@ -183,7 +195,11 @@ std::string DeviceExecutablePersistor<ExecutableType, ClientType>::
       key.device_type(),
       key.compiled_using_pjrt()
           ? absl::StrCat(kXlaSerializedCacheKeySeparator, "pjrt")
-          : "");
+          : "",
+      key.environment_fingerprint() == 0
+          ? ""
+          : absl::StrCat(kXlaSerializedCacheKeySeparator,
+                         key.environment_fingerprint()));
 }
 
 template <typename ExecutableType, typename ClientType>
@@ -198,21 +214,24 @@ template <typename ExecutableType, typename ClientType>
 XlaSerializedCacheKey
 DeviceExecutablePersistor<ExecutableType, ClientType>::BuildSerializedCacheKey(
     uint64 signature_hash, const xla::HloModuleProto& hlo_module,
-    bool compiled_using_pjrt) const {
+    uint64 environment_fingerprint, bool compiled_using_pjrt) const {
   XlaSerializedCacheKey key;
   key.set_signature_fingerprint(signature_hash);
   key.set_cluster_fingerprint(DeterministicProtoHash64(hlo_module));
   key.set_device_type(device_type().type_string());
   key.set_prefix(persistence_prefix());
   key.set_compiled_using_pjrt(compiled_using_pjrt);
+  key.set_environment_fingerprint(environment_fingerprint);
   return key;
 }
 
 template <typename ExecutableType, typename ClientType>
 XlaSerializedCacheKey
 DeviceExecutablePersistor<ExecutableType, ClientType>::BuildSerializedCacheKey(
-    uint64 signature_hash, const xla::HloModuleProto& hlo_module) const {
-  return BuildSerializedCacheKey(signature_hash, hlo_module, false);
+    uint64 signature_hash, const xla::HloModuleProto& hlo_module,
+    uint64 environment_fingerprint) const {
+  return BuildSerializedCacheKey(signature_hash, hlo_module,
+                                 environment_fingerprint, false);
 }
 
 // This template specialization sets compiled_using_prjt to true in the cache
@@ -221,8 +240,29 @@ template <>
 inline XlaSerializedCacheKey
 DeviceExecutablePersistor<xla::PjRtLoadedExecutable, xla::PjRtClient>::
     BuildSerializedCacheKey(uint64 signature_hash,
-                            const xla::HloModuleProto& hlo_module) const {
-  return BuildSerializedCacheKey(signature_hash, hlo_module, true);
+                            const xla::HloModuleProto& hlo_module,
+                            uint64 environment_fingerprint) const {
+  return BuildSerializedCacheKey(signature_hash, hlo_module,
+                                 environment_fingerprint, true);
+}
+
+template <typename ExecutableType, typename ClientType>
+uint64 DeviceExecutablePersistor<ExecutableType, ClientType>::
+    GetEnvironmentFingerprint(
+        const XlaCompiler::Options& options,
+        const XlaCompiler::CompilationResult& compilation_result,
+        DeviceCompilerClient<ExecutableType, ClientType>* compiler_client)
+        const {
+  const std::string device_description =
+      compiler_client->GetDeviceDescription(options);
+  if (device_description.empty()) {
+    return 0;
+  }
+  const xla::ExecutableBuildOptions build_options = GetExecutableBuildOptions(
+      options, compilation_result, /*default_device_ordinal=*/-1);
+  return tsl::FingerprintCat64(
+      tsl::Fingerprint64(device_description),
+      DeterministicProtoHash64(build_options.debug_options()));
 }
 
 template <typename ExecutableType, typename ClientType>
@@ -319,8 +359,9 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::SerializeEntry(
   XlaSerializedCacheEntry serialized_entry;
   const xla::HloModuleProto& hlo_module =
       compilation_result.computation->proto();
-  *serialized_entry.mutable_key() =
-      BuildSerializedCacheKey(signature_hash, hlo_module);
+  *serialized_entry.mutable_key() = BuildSerializedCacheKey(
+      signature_hash, hlo_module,
+      GetEnvironmentFingerprint(options, compilation_result, compiler_client));
   *serialized_entry.mutable_hlo_module() = hlo_module;
 
   // XLA compiler supports exporting executables as an AOT compilation result
@@ -358,8 +399,9 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToLoadExecutable(
   const xla::HloModuleProto& hlo_module =
       compilation_result.computation->proto();
 
-  XlaSerializedCacheKey cache_key =
-      BuildSerializedCacheKey(signature_hash, hlo_module);
+  XlaSerializedCacheKey cache_key = BuildSerializedCacheKey(
+      signature_hash, hlo_module,
+      GetEnvironmentFingerprint(options, compilation_result, compiler_client));
 
   std::optional<XlaSerializedCacheEntry> serialized_entry;
   {
@@ -175,6 +175,20 @@ class MockXlaCompilerClient : public XlaDeviceCompilerClient {
               (override));
 };
 
+// A mock client whose device is described as `device_description`.
+class MockXlaCompilerClientWithDevice : public MockXlaCompilerClient {
+ public:
+  explicit MockXlaCompilerClientWithDevice(std::string device_description)
+      : device_description_(std::move(device_description)) {}
+  std::string GetDeviceDescription(
+      const XlaCompiler::Options& options) override {
+    return device_description_;
+  }
+
+ private:
+  const std::string device_description_;
+};
+
 class MockPjRtCompilerClient : public PjRtDeviceCompilerClient {
  public:
   MockPjRtCompilerClient() : PjRtDeviceCompilerClient(nullptr) {}
@@ -628,5 +642,40 @@ TEST_F(DeviceExecutionPersistorTest, PersistPjRtAndXlaExecutables) {
   EXPECT_EQ(entry.executable(), serialized_xla_executable_);
 }
 
+TEST_F(DeviceExecutionPersistorTest, LoadOnlyForSameDevice) {
+  XlaDeviceExecutablePersistor::Config config(
+      /*persistent_cache_directory=*/cache_dir_,
+      /*disable_strict_signature_checks=*/false,
+      /*persistence_prefix=*/"xla");
+  XlaDeviceExecutablePersistor persistor(config,
+                                         DefaultXlaOptions().device_type);
+
+  MockXlaCompilerClientWithDevice device_a_client("device_a");
+  EXPECT_CALL(device_a_client, SerializeExecutable(_))
+      .WillOnce(Return(serialized_xla_executable_));
+  TF_ASSERT_OK_AND_ASSIGN(auto executable, BuildSampleExecutable());
+  TF_EXPECT_OK(persistor.TryToPersistExecutable(
+      /*signature_hash=*/456, "signature_string", DefaultXlaOptions(),
+      compilation_result_add_, *executable, &device_a_client));
+
+  // The executable was compiled for another device.
+  MockXlaCompilerClientWithDevice device_b_client("device_b");
+  EXPECT_FALSE(persistor
+                   .TryToLoadExecutable(
+                       /*signature_hash=*/456, "signature_string",
+                       DefaultXlaOptions(), compilation_result_add_,
+                       &device_b_client)
+                   .has_value());
+
+  EXPECT_CALL(device_a_client,
+              LoadExecutable(_, _, serialized_xla_executable_))
+      .WillOnce(Return(ByMove(std::move(executable))));
+  auto loaded_executable = persistor.TryToLoadExecutable(
+      /*signature_hash=*/456, "signature_string", DefaultXlaOptions(),
+      compilation_result_add_, &device_a_client);
+  ASSERT_TRUE(loaded_executable.has_value());
+  TF_EXPECT_OK(loaded_executable->status());
+}
+
 }  // namespace
 }  // namespace tensorflow
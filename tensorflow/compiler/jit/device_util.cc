@@ -47,6 +47,19 @@ bool DeviceSet::IsEmpty() const {
   return absl::c_all_of(storage_, [&](uint64 val) { return val == 0; });
 }
 
+bool DeviceSet::operator==(const DeviceSet& other) const {
+  const int size = NumNonZeroWords();
+  if (size != other.NumNonZeroWords()) {
+    return false;
+  }
+  for (int i = 0; i < size; i++) {
+    if (storage_[i] != other.storage_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 StatusOr<DeviceId> DeviceInfoCache::GetIdFor(absl::string_view name) {
   TF_RET_CHECK(!name.empty());
 
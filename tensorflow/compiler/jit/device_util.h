@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
@@ -63,6 +64,20 @@ class DeviceSet {
   void UnionWith(const DeviceSet& other);
   bool IsEmpty() const;
 
+  // Two sets are equal if they contain the same devices, regardless of how
+  // much storage each of them has allocated.
+  bool operator==(const DeviceSet& other) const;
+  bool operator!=(const DeviceSet& other) const { return !(*this == other); }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const DeviceSet& device_set) {
+    const int size = device_set.NumNonZeroWords();
+    for (int i = 0; i < size; i++) {
+      h = H::combine(std::move(h), device_set.storage_[i]);
+    }
+    return H::combine(std::move(h), size);
+  }
+
   // Calls `func` on each DeviceId in the set.  Stops iterating early if `func`
   // return false.
   //
@@ -103,6 +118,13 @@ class DeviceSet {
 #endif
   }
 
+  // Returns the size of `storage_` without trailing zero words.
+  int NumNonZeroWords() const {
+    int size = storage_.size();
+    while (size > 0 && storage_[size - 1] == 0) size--;
+    return size;
+  }
+
   absl::InlinedVector<uint64, 1> storage_;
 
   const int kWordSize = 64;
@@ -139,5 +139,39 @@ TEST(DeviceSetTest, SimpleRoundTrip_Large) {
   SimpleRoundTripTestForDeviceSet(800);
 }
 
+TEST(DeviceSetTest, EqualityAndHash) {
+  jit::DeviceInfoCache device_info_cache;
+  std::vector<jit::DeviceId> device_ids;
+  for (int i = 0; i < 100; i++) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        jit::DeviceId device_id,
+        device_info_cache.GetIdFor(
+            absl::StrCat("/job:localhost/replica:0/task:0/device:XPU:", i)));
+    device_ids.push_back(device_id);
+  }
+
+  jit::DeviceSet small;
+  small.Insert(device_ids[1]);
+  jit::DeviceSet large;
+  large.Insert(device_ids[99]);
+
+  // Build the same set in a different order.
+  jit::DeviceSet both;
+  both.Insert(device_ids[1]);
+  both.UnionWith(large);
+  jit::DeviceSet both_reversed = large;
+  both_reversed.UnionWith(small);
+
+  EXPECT_NE(small, large);
+  EXPECT_NE(both, small);
+  EXPECT_EQ(both, both_reversed);
+  EXPECT_EQ(jit::DeviceSet(), jit::DeviceSet());
+
+  absl::flat_hash_map<jit::DeviceSet, int> map;
+  map.emplace(both, 1);
+  EXPECT_EQ(map.count(both_reversed), 1);
+  EXPECT_EQ(map.count(small), 0);
+}
+
 }  // namespace
 }  // namespace tensorflow
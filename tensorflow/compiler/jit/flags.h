@@ -151,6 +151,12 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile compiles the cluster asynchronously with respect to
   // the main execution. The fallback path is taken while compilation happens.
   bool tf_xla_async_compilation;
+  // If positive, a cluster that has been compiled this many times is not
+  // compiled for further signatures in lazy or async compilation mode, and
+  // runs in the TF executor for them instead. Bounds the compile time and cache
+  // size of clusters that see many distinct input shapes. Defaults to 0, which
+  // means no limit.
+  int64_t tf_xla_max_compiles_per_cluster;
 
   class PjRtForSingleDeviceCompilationRollout {
    public:
@@ -476,6 +476,11 @@ class MarkForCompilationPassImpl {
   const std::string cluster_name_prefix_;
   absl::flat_hash_map<const Cluster*, bool> should_compile_cluster_cache_;
   jit::DeviceInfoCache device_info_cache_;
+  // Memoizes MaybePickDeviceForXla for AreDevicesCompatible, which is queried
+  // for every edge (and every predecessor of its destination) in each phase
+  // but only ever sees a handful of distinct device sets.
+  absl::flat_hash_map<jit::DeviceSet, std::optional<jit::DeviceId>>
+      device_for_xla_cache_;
 
   bool initialized_ = false;
   bool edges_contracted_ = false;
@@ -692,6 +697,8 @@ StatusOr<bool> MarkForCompilationPassImpl::Initialize() {
 template <typename FnTy>
 StatusOr<bool> MarkForCompilationPassImpl::ForEachEdgeInPostOrder(FnTy fn) {
   bool changed = false;
+  // Reused across nodes to avoid an allocation per node.
+  std::vector<int32> successors_copy;
   for (int32_t node : cycles_graph_.AllNodesInPostOrder()) {
     Cluster* cluster_from = GetClusterForCyclesGraphNode(node);
     if (!cluster_from) {
@@ -700,8 +707,9 @@ StatusOr<bool> MarkForCompilationPassImpl::ForEachEdgeInPostOrder(FnTy fn) {
 
     // Make a copy of the set of successors because we may modify the graph in
     // TryToContractEdge.
-    std::vector<int32> successors_copy =
-        cycles_graph_.SuccessorsCopy(cluster_from->cycles_graph_node_id());
+    absl::Span<const int32> successors =
+        cycles_graph_.Successors(cluster_from->cycles_graph_node_id());
+    successors_copy.assign(successors.begin(), successors.end());
 
     for (int to : successors_copy) {
       iteration_count_++;
@@ -882,15 +890,17 @@ Status MarkForCompilationPassImpl::RunEdgeContractionLoop() {
                      }).status());
 
   // Check that the conclusion made above (that iterating over the graph once in
-  // post order gives a maximal clustering) holds.  Once the linear time
-  // post-order scheme has been battle tested we can move this to happen only in
-  // debug builds.
+  // post order gives a maximal clustering) holds.  This repeats every
+  // contraction attempt, including the cycle checks, so it only runs in debug
+  // builds.
+#ifndef NDEBUG
   VLOG(2) << "Checking idempotence";
   TF_ASSIGN_OR_RETURN(bool changed,
                       ForEachEdgeInPostOrder([&](Cluster* from, Cluster* to) {
                         return TryToContractEdge(from, to);
                       }));
   TF_RET_CHECK(!changed);
+#endif
 
   return OkStatus();
 }
@@ -1528,13 +1538,7 @@ StatusOr<bool> MarkForCompilationPassImpl::TryToContractEdge(Cluster* from,
     return false;
   }
 
-  TF_ASSIGN_OR_RETURN(bool devices_compatible,
-                      AreDevicesCompatible(*from, *to));
-  if (!devices_compatible) {
-    return LogNotContractableAndReturnFalse(
-        from, to, "the two nodes have incompatible devices");
-  }
-
+  // The checks below are independent of each other; the cheap ones run first.
   if (from->xla_scope().has_value() && to->xla_scope().has_value() &&
       *from->xla_scope() != *to->xla_scope()) {
     return LogNotContractableAndReturnFalse(
@@ -1548,6 +1552,13 @@ StatusOr<bool> MarkForCompilationPassImpl::TryToContractEdge(Cluster* from,
         from, to, "the new cluster will be larger than the max cluster size");
   }
 
+  TF_ASSIGN_OR_RETURN(bool devices_compatible,
+                      AreDevicesCompatible(*from, *to));
+  if (!devices_compatible) {
+    return LogNotContractableAndReturnFalse(
+        from, to, "the two nodes have incompatible devices");
+  }
+
   TF_ASSIGN_OR_RETURN(bool will_introduce_cross_device_dependency,
                       ClusteringWillIntroduceInterDeviceDependency(*from, *to));
 
@@ -1761,10 +1772,17 @@ StatusOr<bool> MarkForCompilationPassImpl::AreDevicesCompatible(
   DeviceSet devices = cluster_a.devices();
   devices.UnionWith(cluster_b.devices());
 
-  TF_ASSIGN_OR_RETURN(
-      std::optional<jit::DeviceId> maybe_chosen_device,
-      MaybePickDeviceForXla(device_info_cache_, devices,
-                            /*allow_mixing_unknown_and_cpu=*/false));
+  std::optional<jit::DeviceId> maybe_chosen_device;
+  auto it = device_for_xla_cache_.find(devices);
+  if (it != device_for_xla_cache_.end()) {
+    maybe_chosen_device = it->second;
+  } else {
+    TF_ASSIGN_OR_RETURN(
+        maybe_chosen_device,
+        MaybePickDeviceForXla(device_info_cache_, devices,
+                              /*allow_mixing_unknown_and_cpu=*/false));
+    device_for_xla_cache_.emplace(devices, maybe_chosen_device);
+  }
   if (!maybe_chosen_device.has_value()) {
     return false;
   }
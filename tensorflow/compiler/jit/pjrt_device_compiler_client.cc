@@ -19,6 +19,8 @@ limitations under the License.
 #include <string>
 #include <utility>
 
+#include "absl/strings/str_cat.h"
+
 namespace tensorflow {
 
 xla::CompileOptions GetPjRtCompileOptions(
@@ -81,6 +83,17 @@ PjRtDeviceCompilerClient::LoadExecutable(
                                         GetPjRtCompileOptions(options, result));
 }
 
+std::string PjRtDeviceCompilerClient::GetDeviceDescription(
+    const XlaCompiler::Options& options) {
+  if (client_ == nullptr || client_->addressable_devices().empty()) return "";
+
+  // Portable executables run on any addressable device, which all have the
+  // same kind.
+  return absl::StrCat(client_->platform_name(), ":",
+                      client_->platform_version(), ":",
+                      client_->addressable_devices()[0]->device_kind());
+}
+
 void PjRtDeviceCompilerClient::WaitForProgramsToFinish() {
   // TODO(b/255826209): Modify this if PjRtClient exposes a function to wait for
   // programs to finish.
@@ -62,6 +62,10 @@ class PjRtDeviceCompilerClient
       const XlaCompiler::CompilationResult& result,
       const std::string& serialized_executable) override;
 
+  // Describes the platform and the kind of the client's devices.
+  std::string GetDeviceDescription(
+      const XlaCompiler::Options& options) override;
+
   // No-op. PJRT uses futures and waiting for programs to finish isn't
   // necessary.
   void WaitForProgramsToFinish() override;
@@ -20,7 +20,9 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "xla/client/local_client.h"
+#include "xla/stream_executor/device_description.h"
 
 namespace tensorflow {
 namespace {
@@ -101,6 +103,23 @@ XlaDeviceCompilerClient::LoadExecutable(
   return client_->Load(serialized_executable, build_options);
 }
 
+std::string XlaDeviceCompilerClient::GetDeviceDescription(
+    const XlaCompiler::Options& options) {
+  if (client_ == nullptr) return "";
+
+  const int device_ordinal = options.device_ordinal != -1
+                                 ? options.device_ordinal
+                                 : client_->default_device_ordinal();
+  auto executor = client_->backend().stream_executor(device_ordinal);
+  if (!executor.ok()) return "";
+  const se::DeviceDescription& description =
+      (*executor)->GetDeviceDescription();
+  return absl::StrCat(client_->platform()->Name(), ":", description.name(),
+                      ":", description.platform_version(), ":",
+                      description.driver_version(), ":",
+                      description.runtime_version());
+}
+
 void XlaDeviceCompilerClient::WaitForProgramsToFinish() {
   if (client_ == nullptr) return;
 
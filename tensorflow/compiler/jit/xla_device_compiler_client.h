@@ -53,6 +53,10 @@ class XlaDeviceCompilerClient
       const XlaCompiler::CompilationResult& result,
       const std::string& serialized_executable) override;
 
+  // Describes the stream executor device that executables are built for.
+  std::string GetDeviceDescription(
+      const XlaCompiler::Options& options) override;
+
   void WaitForProgramsToFinish() override;
 
   xla::LocalClient* client() const override { return client_; }
@@ -112,9 +112,10 @@ float CalculateRandomSparsity(const ElementsAttr& attr,
 float CalculateBlockSparsity(const ElementsAttr& attr, const ShapedType& type,
                              const std::vector<int>& block_size) {
   float sparsity = 0;
-  std::vector<int> shape(2);
-  shape[0] = type.getDimSize(0);
-  shape[1] = type.getDimSize(1);
+  std::vector<int> shape(type.getRank());
+  for (int i = 0; i < type.getRank(); i++) {
+    shape[i] = type.getDimSize(i);
+  }
 
   std::vector<int> traversal_order = {};
   std::vector<TfLiteDimensionType> format = {};
@@ -76,3 +76,31 @@ func.func @not_fuse_promise_return(%p: !mlrt.promise, %v: !tf_mlrt.tensor) -> (!
   tf_mlrt.promise %p, %v
   func.return %v : !tf_mlrt.tensor
 }
+
+// -----
+
+// CHECK-LABEL: @fuse_promise
+// CHECK-SAME: ([[p0:%.*]]: !mlrt.promise, [[p1:%.*]]: !mlrt.promise, [[p2:%.*]]: !mlrt.promise, [[v:%.*]]: !tf_mlrt.tensor)
+func.func @fuse_promise(%p0: !mlrt.promise, %p1: !mlrt.promise, %p2: !mlrt.promise, %v: !tf_mlrt.tensor) -> (!tf_mlrt.tensor) {
+  // CHECK-NEXT: [[r:%.*]] = tf_mlrt.executeop([[v]], [[v]])
+  // CHECK-NEXT: tf_mlrt.promise_all([[p0]], [[p1]]), ([[v]], [[r]])
+  // CHECK-NOT: tf_mlrt.promise
+  // CHECK-NEXT: return [[v]]
+  %r = tf_mlrt.executeop(%v, %v) {node_def = "AddV2", op_key = 0 : i32} : (!tf_mlrt.tensor, !tf_mlrt.tensor) -> (!tf_mlrt.tensor)
+  tf_mlrt.promise %p0, %v
+  tf_mlrt.promise %p1, %r
+  func.return %v : !tf_mlrt.tensor
+}
+
+// -----
+
+// CHECK-LABEL: @fuse_promise_before_promise_return
+// CHECK-SAME: ([[p0:%.*]]: !mlrt.promise, [[p1:%.*]]: !mlrt.promise, [[p2:%.*]]: !mlrt.promise, [[v:%.*]]: !tf_mlrt.tensor)
+func.func @fuse_promise_before_promise_return(%p0: !mlrt.promise, %p1: !mlrt.promise, %p2: !mlrt.promise, %v: !tf_mlrt.tensor) -> () {
+  // CHECK-NEXT: tf_mlrt.promise_all([[p0]], [[p1]]), ([[v]], [[v]])
+  // CHECK-NEXT: tf_mlrt.promise_return [[p2]], [[v]]
+  tf_mlrt.promise %p0, %v
+  tf_mlrt.promise %p1, %v
+  tf_mlrt.promise %p2, %v
+  func.return
+}
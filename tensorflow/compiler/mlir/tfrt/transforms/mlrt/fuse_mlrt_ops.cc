@@ -149,6 +149,44 @@ void FusePromiseReturn(mlir::OpBuilder& builder, mlir::Block& block) {
   promise_op->erase();
 }
 
+// Fuses each run of consecutive tf_mlrt.promise ops, e.g. the ones setting the
+// outputs of a stream, into one tf_mlrt.promise_all to save kernel dispatches.
+void FusePromiseOps(mlir::OpBuilder& builder, mlir::Block& block) {
+  llvm::SmallVector<tf_mlrt::PromiseOp> promise_ops;
+  for (auto& op : llvm::make_early_inc_range(block)) {
+    if (auto promise_op = llvm::dyn_cast<tf_mlrt::PromiseOp>(&op)) {
+      promise_ops.push_back(promise_op);
+      continue;
+    }
+
+    // The last op is always a return op, so it is guaranteed to process all
+    // groups of the candidate ops.
+    if (promise_ops.size() > 1) {
+      auto last_promise = promise_ops.back();
+
+      builder.setInsertionPointAfter(last_promise);
+
+      llvm::SmallVector<mlir::Value> promises;
+      llvm::SmallVector<mlir::Value> tensors;
+      promises.reserve(promise_ops.size());
+      tensors.reserve(promise_ops.size());
+      for (auto op : promise_ops) {
+        promises.push_back(op.getPromise());
+        tensors.push_back(op.getTensor());
+      }
+
+      builder.create<tf_mlrt::PromiseAllOp>(last_promise.getLoc(), promises,
+                                            tensors);
+
+      for (auto promise_op : promise_ops) {
+        promise_op->erase();
+      }
+    }
+
+    promise_ops.clear();
+  }
+}
+
 void FuseMlrtOpPass::runOnOperation() {
   auto func = getOperation();
 
@@ -162,6 +200,7 @@ void FuseMlrtOpPass::runOnOperation() {
                mlrt::compiler::AwaitAllControlOp>(builder, func.front());
   FuseGetResourceOps(builder, func.front());
   FusePromiseReturn(builder, func.front());
+  FusePromiseOps(builder, func.front());
 }
 
 }  // namespace
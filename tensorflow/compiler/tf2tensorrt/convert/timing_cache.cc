@@ -16,21 +16,77 @@ limitations under the License.
 
 #include "tensorflow/compiler/tf2tensorrt/convert/timing_cache.h"
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/compiler/tf2tensorrt/common/utils.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/env_var.h"
 #include "third_party/tensorrt/NvInfer.h"
 
 namespace tensorflow {
 namespace tensorrt {
 namespace convert {
 
+std::string TimingCacheRegistry::CacheFilePath(const string& name) {
+  static const std::string* cache_dir = [] {
+    std::string dir;
+    TF_CHECK_OK(ReadStringFromEnvVar("TF_TRT_TIMING_CACHE_DIR",
+                                     /*default_val=*/"", &dir));
+    return new std::string(dir);
+  }();
+  if (cache_dir->empty()) return "";
+  return io::JoinPath(*cache_dir, absl::StrCat(name, ".trt_timing_cache"));
+}
+
+void TimingCacheRegistry::MaybeLoadFromFile(const string& name) {
+  if (!loaded_from_file_.insert(name).second) return;
+  const std::string path = CacheFilePath(name);
+  if (path.empty() || !Env::Default()->FileExists(path).ok()) return;
+  std::string data;
+  Status status = ReadFileToString(Env::Default(), path, &data);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to read TensorRT timing cache " << path << ": "
+                 << status;
+    return;
+  }
+  VLOG(1) << "Loaded TensorRT timing cache " << name << " from " << path;
+  map_[name] = SerializedTimingCache(data.begin(), data.end());
+}
+
+void TimingCacheRegistry::WriteToFile(const string& name,
+                                      const SerializedTimingCache& cache) {
+  const std::string path = CacheFilePath(name);
+  if (path.empty()) return;
+  // Write to a unique temporary file first and rename it, so that concurrent
+  // writers never leave a truncated cache behind.
+  std::string tmp_path = path;
+  if (!Env::Default()->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    LOG(WARNING) << "Failed to create a temporary file for " << path;
+    return;
+  }
+  Status status = WriteStringToFile(
+      Env::Default(), tmp_path,
+      absl::string_view(reinterpret_cast<const char*>(cache.data()),
+                        cache.size()));
+  if (status.ok()) status = Env::Default()->RenameFile(tmp_path, path);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to write TensorRT timing cache " << path << ": "
+                 << status;
+  }
+}
+
 StatusOr<TimingCacheRegistry::TimingCachePtr> TimingCacheRegistry::LookUp(
     const string& name, nvinfer1::IBuilderConfig* builder_config) {
 #if IS_TRT_VERSION_GE(8, 0, 0, 0)
   TRT_ENSURE(builder_config != nullptr);
   mutex_lock scoped_lock(mu_);
+  MaybeLoadFromFile(name);
   if (map_.find(name) != map_.end()) {
     const std::vector<uint8_t>& data = map_[name];
     return std::unique_ptr<nvinfer1::ITimingCache>(
@@ -52,23 +108,15 @@ void TimingCacheRegistry::Upsert(const string& name, TimingCache* cache) {
     return;
   }
 
-  if (map_.find(name) == map_.end()) {
-    // If the timing cache with the given name does not exist, emplace the
-    // serialized buffer.
-    std::vector<uint8_t> mem(memory->size());
-    std::copy_n(static_cast<uint8_t*>(memory->data()), memory->size(),
-                mem.begin());
-    {
-      mutex_lock scoped_lock(mu_);
-      map_.emplace(name, std::move(mem));
-    }
-  } else {
-    // If the timing cache does exist, use the existing buffer.
+  {
+    // Inserts the serialized buffer, or reuses the existing one if the timing
+    // cache with the given name exists.
     mutex_lock scoped_lock(mu_);
     std::vector<uint8_t>& mem = map_[name];
     mem.resize(memory->size());
     std::copy_n(static_cast<uint8_t*>(memory->data()), memory->size(),
                 mem.begin());
+    WriteToFile(name, mem);
   }
   memory->destroy();
 #endif  // IS_TRT_VERSION_GE(8, 0, 0, 0)
@@ -15,7 +15,10 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_TF2TENSORRT_CONVERT_TIMING_CACHE_H_
 #define TENSORFLOW_COMPILER_TF2TENSORRT_CONVERT_TIMING_CACHE_H_
 #if GOOGLE_CUDA && GOOGLE_TENSORRT
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "tensorflow/compiler/tf2tensorrt/common/utils.h"
 #include "tensorflow/core/framework/registration/registration.h"
@@ -30,6 +33,12 @@ namespace convert {
 // A registry for holding serialized TensorRT autotuner timing caches.
 // For TensorRT versions < 8.0, the timing cache is not serializable, so these
 // operations become no-ops.
+//
+// If the environment variable TF_TRT_TIMING_CACHE_DIR is set, each cache is
+// also persisted to a file named after the cache in that directory. The file
+// is loaded on the first lookup of the cache and rewritten on every update,
+// so that engine builds in later runs and in other processes sharing the
+// directory reuse the measured tactic timings.
 class TimingCacheRegistry {
  public:
   TimingCacheRegistry() = default;
@@ -56,8 +65,23 @@ class TimingCacheRegistry {
  private:
   using SerializedTimingCache = std::vector<uint8_t>;
 
+  // Returns the file the cache `name` is persisted to, or an empty string if
+  // caches are not persisted.
+  static std::string CacheFilePath(const string& name);
+
+  // Loads the cache `name` from its file into `map_` if it has not been
+  // looked up yet.
+  void MaybeLoadFromFile(const string& name) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Writes `cache` to the file of the cache `name`.
+  static void WriteToFile(const string& name,
+                          const SerializedTimingCache& cache);
+
   mutex mu_;
-  std::unordered_map<std::string, SerializedTimingCache> map_;
+  std::unordered_map<std::string, SerializedTimingCache> map_
+      TF_GUARDED_BY(mu_);
+  // Names of the caches which have been looked up in their file already.
+  std::unordered_set<std::string> loaded_from_file_ TF_GUARDED_BY(mu_);
 };
 
 TimingCacheRegistry* GetTimingCacheRegistry();
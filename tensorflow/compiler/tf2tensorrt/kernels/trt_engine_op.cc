@@ -19,6 +19,7 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/compiler/tf2tensorrt/common/utils.h"
 #include "tensorflow/compiler/tf2tensorrt/convert/convert_nodes.h"
@@ -199,6 +200,12 @@ class TRTEngineOp : public AsyncOpKernel {
   // Verify that the input shapes are consistent and can be handled by this op.
   Status VerifyInputShapes(const std::vector<TensorShape>& shapes);
 
+  // Records input shapes that no optimization profile covers, and proposes
+  // them as additional profiles once they occur frequently enough.
+  void RecordUnmatchedShape(const std::vector<TensorShape>& shapes,
+                            TRTEngineCacheResource* cache_res)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(engine_mutex_);
+
   std::vector<string> input_nodes_;
   std::vector<string> output_nodes_;
 
@@ -811,6 +818,40 @@ static bool AllowEngineNativeSegmentExecution() {
   return value;
 }
 
+// Returns the number of times the same unmatched input shapes have to be seen
+// before they are proposed as an additional optimization profile. 0 disables
+// the proposals.
+static int64_t UnmatchedShapeReportThreshold() {
+  int64_t value;
+  Status status = ReadInt64FromEnvVar("TF_TRT_UNMATCHED_SHAPE_REPORT_THRESHOLD",
+                                      /*default_val=*/100, &value);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  return value;
+}
+
+void TRTEngineOp::RecordUnmatchedShape(const std::vector<TensorShape>& shapes,
+                                       TRTEngineCacheResource* cache_res) {
+  static const int64_t threshold = UnmatchedShapeReportThreshold();
+  if (threshold <= 0) return;
+  if (cache_res->profiles_.RecordUnmatchedShape(shapes) != threshold) return;
+  std::vector<std::vector<TensorShape>> candidates =
+      cache_res->profiles_.GetUnmatchedShapes(threshold);
+  std::vector<string> shape_lists;
+  shape_lists.reserve(candidates.size());
+  for (const auto& candidate : candidates) {
+    shape_lists.push_back(TensorShapeUtils::ShapeListString(candidate));
+  }
+  LOG_WARNING_WITH_PREFIX
+      << "Input shapes " << TensorShapeUtils::ShapeListString(shapes)
+      << " of " << name() << " were not covered by any optimization profile "
+      << threshold << " times and ran with native TF. Consider adding the "
+      << "following frequent input shapes to the profile generation inputs "
+      << "(e.g. the input_fn of TrtGraphConverterV2.build): "
+      << absl::StrJoin(shape_lists, ", ");
+}
+
 void TRTEngineOp::ComputeAsync(OpKernelContext* ctx,
                                AsyncOpKernel::DoneCallback done) {
   tensorflow::profiler::TraceMe activity(
@@ -1168,6 +1209,7 @@ StatusOr<std::pair<EngineContext*, int>> TRTEngineOp::GetEngine(
           return std::pair<EngineContext*, int>(cache.begin()->second.get(),
                                                 profile_id);
         }
+        RecordUnmatchedShape(input_concrete_shapes, cache_res);
       }
       return std::pair<EngineContext*, int>(&empty_context, 0);
     }
@@ -1265,6 +1307,7 @@ StatusOr<std::pair<EngineContext*, int>> TRTEngineOp::GetEngine(
     // Since all profiles are already created at this point, finding no
     // compatible profiles results in falling back to native TF.
     if (profile_id == -1) {
+      RecordUnmatchedShape(input_concrete_shapes, cache_res);
       return std::pair<EngineContext*, int>(&empty_context, 0);
     }
   }
@@ -500,6 +500,37 @@ int TrtShapeOptimizationProfile::GetProfileNumber(
   return -1;
 }
 
+int TrtShapeOptimizationProfile::RecordUnmatchedShape(
+    const std::vector<TensorShape>& shapes) {
+  for (UnmatchedShape& unmatched : unmatched_shapes_) {
+    if (unmatched.shapes == shapes &&
+        unmatched.shape_values == actual_shape_values_) {
+      return ++unmatched.count;
+    }
+  }
+  if (unmatched_shapes_.size() >= kMaxUnmatchedShapes) return 0;
+  unmatched_shapes_.push_back({shapes, actual_shape_values_, 1});
+  return 1;
+}
+
+std::vector<std::vector<TensorShape>>
+TrtShapeOptimizationProfile::GetUnmatchedShapes(int min_count) const {
+  std::vector<const UnmatchedShape*> candidates;
+  for (const UnmatchedShape& unmatched : unmatched_shapes_) {
+    if (unmatched.count >= min_count) candidates.push_back(&unmatched);
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const UnmatchedShape* a, const UnmatchedShape* b) {
+                     return a->count > b->count;
+                   });
+  std::vector<std::vector<TensorShape>> result;
+  result.reserve(candidates.size());
+  for (const UnmatchedShape* unmatched : candidates) {
+    result.push_back(unmatched->shapes);
+  }
+  return result;
+}
+
 Status TrtShapeOptimizationProfile::CreateExecutionContexts(
     nvinfer1::ICudaEngine* engine,
     std::vector<ExecutionContext>* exec_contexts) {
@@ -260,6 +260,16 @@ class TrtShapeOptimizationProfile {
   bool HasShape() const { return !input_shapes_.empty(); }
   bool NeedProfiles() const { return need_profiles_; }
 
+  // Records input shapes (together with the shape values of the current call)
+  // that are not covered by any of the profiles, and returns how many times
+  // this combination has been seen so far. At most kMaxUnmatchedShapes
+  // distinct combinations are tracked, further ones are counted as 0.
+  int RecordUnmatchedShape(const std::vector<TensorShape>& shapes);
+
+  // Returns the unmatched input shapes recorded at least min_count times, most
+  // frequent first. These are the candidates for additional profiles.
+  std::vector<std::vector<TensorShape>> GetUnmatchedShapes(int min_count) const;
+
   // Restores profiles from the engine (used after deserialization).
   Status RestoreProfiles(const nvinfer1::ICudaEngine* engine,
                          int n_network_inputs);
@@ -282,6 +292,15 @@ class TrtShapeOptimizationProfile {
   }
 
  private:
+  // Upper bound on the distinct unmatched shapes tracked per engine.
+  static constexpr int kMaxUnmatchedShapes = 32;
+
+  struct UnmatchedShape {
+    std::vector<TensorShape> shapes;
+    std::vector<nvinfer1::Dims> shape_values;
+    int count;
+  };
+
   // Set of input shape vetors that we collect during profile_generation_mode.
   std::vector<std::vector<TensorShape>> input_shapes_;
 
@@ -293,6 +312,9 @@ class TrtShapeOptimizationProfile {
   // Shape values present in the current inference call.
   std::vector<nvinfer1::Dims> actual_shape_values_;
 
+  // Input shapes seen at inference time that none of profiles_ covers.
+  std::vector<UnmatchedShape> unmatched_shapes_;
+
   // The optimization profiles generated from input_shapes_.
   std::vector<OptimizationProfileConfig> profiles_;
 
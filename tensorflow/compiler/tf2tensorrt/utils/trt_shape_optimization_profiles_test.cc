@@ -250,6 +250,30 @@ TEST_P(TrtShapeOptimizationProfileTest, Dynamic) {
   CheckProfile(unseen_shapes, &profile, has_prof, false);
 }
 
+TEST(TrtShapeOptimizationProfileUnmatchedTest, RecordUnmatchedShape) {
+  TrtShapeOptimizationProfile profile;
+  std::vector<TensorShape> frequent = DimVecToShapeVec(
+      {nvinfer1::Dims3(5, 5, 10), nvinfer1::Dims3(5, 5, 10)});
+  std::vector<TensorShape> rare = DimVecToShapeVec(
+      {nvinfer1::Dims3(9, 9, 10), nvinfer1::Dims3(9, 9, 10)});
+
+  EXPECT_EQ(profile.RecordUnmatchedShape(rare), 1);
+  EXPECT_EQ(profile.RecordUnmatchedShape(frequent), 1);
+  EXPECT_EQ(profile.RecordUnmatchedShape(frequent), 2);
+  EXPECT_EQ(profile.RecordUnmatchedShape(frequent), 3);
+
+  std::vector<std::vector<TensorShape>> candidates =
+      profile.GetUnmatchedShapes(/*min_count=*/2);
+  ASSERT_EQ(candidates.size(), 1);
+  EXPECT_EQ(candidates[0], frequent);
+
+  // All candidates are returned most frequent first.
+  candidates = profile.GetUnmatchedShapes(/*min_count=*/1);
+  ASSERT_EQ(candidates.size(), 2);
+  EXPECT_EQ(candidates[0], frequent);
+  EXPECT_EQ(candidates[1], rare);
+}
+
 }  // namespace tensorrt
 }  // namespace tensorflow
 
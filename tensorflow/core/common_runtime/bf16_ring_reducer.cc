@@ -0,0 +1,76 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/bf16_ring_reducer.h"
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/bfloat16.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+Status Bf16RingReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  if (col_params->instance.data_type != DT_FLOAT ||
+      col_params->group.device_type != DEVICE_CPU) {
+    return errors::InvalidArgument(
+        "Bf16RingReduce requires float tensors on CPU, not ",
+        DataTypeString(col_params->instance.data_type), " on ",
+        col_params->group.device_type.type_string());
+  }
+  return RingReducer::InitializeCollectiveParams(col_params);
+}
+
+void Bf16RingReducer::DispatchSend(RingField* rf, const StatusCallback& done) {
+  Tensor* wire = new Tensor(
+      col_ctx_->device->GetAllocator(col_ctx_->op_ctx->output_alloc_attr(0)),
+      DT_BFLOAT16, rf->chunk.shape());
+  const int64_t n = rf->chunk.NumElements();
+  RoundFloatToBFloat16(rf->chunk.flat<float>().data(),
+                       wire->flat<bfloat16>().data(), n);
+  if (rf->second_pass) {
+    // Keep the value this device ends up with the same as the others get.
+    BFloat16ToFloat(wire->flat<bfloat16>().data(),
+                    rf->chunk.flat<float>().data(), n);
+  }
+  PostValue(rf, wire, [wire, done](const Status& s) {
+    delete wire;
+    done(s);
+  });
+}
+
+void Bf16RingReducer::DispatchRecv(RingField* rf, const StatusCallback& done) {
+  Tensor* dst = RecvDestination(rf);
+  Tensor* wire = new Tensor(
+      col_ctx_->device->GetAllocator(col_ctx_->op_ctx->output_alloc_attr(0)),
+      DT_BFLOAT16, dst->shape());
+  RecvValue(rf, wire, [wire, dst, done](const Status& s) {
+    if (s.ok()) {
+      BFloat16ToFloat(wire->flat<bfloat16>().data(), dst->flat<float>().data(),
+                      dst->NumElements());
+    }
+    delete wire;
+    done(s);
+  });
+}
+
+namespace {
+REGISTER_COLLECTIVE(Bf16RingReduce, Bf16RingReducer);
+}  // namespace
+
+}  // namespace tensorflow
@@ -0,0 +1,41 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_BF16_RING_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_BF16_RING_REDUCER_H_
+
+#include "tensorflow/core/common_runtime/ring_reducer.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+
+// Ring all-reduce of float tensors on CPU devices that sends the chunks as
+// bfloat16, halving the bytes transferred, and accumulates them as float.
+// The chunks are rounded to bfloat16 before the second pass sends them, so
+// that every device ends up with the same values.
+class Bf16RingReducer : public RingReducer {
+ public:
+  Bf16RingReducer() : RingReducer("Bf16RingReduce") {}
+
+  // Checks that the tensor is float and on CPU, then sets up the ring as
+  // RingReducer does.
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+ protected:
+  void DispatchSend(RingField* rf, const StatusCallback& done) override;
+  void DispatchRecv(RingField* rf, const StatusCallback& done) override;
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_BF16_RING_REDUCER_H_
@@ -23,6 +23,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -699,6 +700,37 @@ void CollectiveParamResolverLocal::AssignCollectiveType(CollectiveParams* cp) {
       CollectiveRegistry::LookupParamResolverInstance("NcclReduce", &col_impl)
           .ok();
   cp->instance.impl_details.collective_name = GetCollectiveName(cp, use_nccl);
+  // The compressed reductions are chosen only by the communication hint, as
+  // they change the results.
+  const string& hint = cp->instance.impl_details.communication_hint;
+  if (cp->instance.impl_details.collective_name == "RingReduce" &&
+      cp->instance.data_type == DT_FLOAT &&
+      cp->group.device_type == DEVICE_CPU) {
+    const char* compressed_name = nullptr;
+    if (hint == "bf16") {
+      compressed_name = "Bf16RingReduce";
+    } else if (hint == "topk" || absl::StartsWith(hint, "topk:")) {
+      compressed_name = "TopKReduce";
+    }
+    if (compressed_name != nullptr &&
+        CollectiveRegistry::LookupParamResolverInstance(compressed_name,
+                                                        &col_impl)
+            .ok()) {
+      cp->instance.impl_details.collective_name = compressed_name;
+    }
+  }
+  // A reduction over several tasks with several devices each pays the
+  // inter-task latency on fewer hops when reduced within each task first,
+  // unless a flat ring is asked for.
+  if (cp->instance.impl_details.collective_name == "RingReduce" &&
+      hint != "ring" &&
+      cp->group.num_tasks > 1 && cp->group.same_num_devices_per_task &&
+      cp->group.group_size > cp->group.num_tasks &&
+      CollectiveRegistry::LookupParamResolverInstance("HierarchicalReduce",
+                                                      &col_impl)
+          .ok()) {
+    cp->instance.impl_details.collective_name = "HierarchicalReduce";
+  }
   VLOG(1) << "AssignCollectiveType "
           << cp->instance.impl_details.collective_name;
 }
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/device/device_event_mgr.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -100,6 +101,7 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
       polling_active_delay_usecs_(gpu_options.polling_active_delay_usecs()
                                       ? gpu_options.polling_active_delay_usecs()
                                       : 10),
+      polling_delay_usecs_(polling_active_delay_usecs_),
       threadpool_(Env::Default(), "Device_Event_Manager", kNumThreads) {
   device_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
@@ -142,10 +144,12 @@ void EventMgr::StopPollingLoop() {
 // A polling loop to detect completion of device events.
 //
 // While one or more events is outstanding, poll for completed events.  When no
-// events are outstanding, we sleep until one is enqueued.
+// events are outstanding, we sleep until one is enqueued.  Sweeps that retire
+// nothing double the delay until the next one, up to a bounded maximum.
 void EventMgr::PollLoop() {
   while (true) {
     bool events_still_pending;
+    int32 delay_usecs;
     {
       mutex_lock l(mu_);
       if (stop_polling_) {
@@ -154,12 +158,19 @@ void EventMgr::PollLoop() {
       if (callbacks_.empty()) {
         events_pending_.wait(l);
       }
-      PollEvents(/*stream=*/nullptr);  // poll all streams
+      if (PollEvents(/*stream=*/nullptr) > 0) {  // poll all streams
+        polling_delay_usecs_ = polling_active_delay_usecs_;
+      } else {
+        polling_delay_usecs_ =
+            std::min(2 * polling_delay_usecs_,
+                     kMaxPollingDelayMultiplier * polling_active_delay_usecs_);
+      }
       events_still_pending = !callbacks_.empty();
+      delay_usecs = polling_delay_usecs_;
     }
 
     if (events_still_pending) {
-      Env::Default()->SleepForMicroseconds(polling_active_delay_usecs_);
+      Env::Default()->SleepForMicroseconds(delay_usecs);
     }
   }
   polling_stopped_->Notify();
@@ -182,6 +193,7 @@ void EventMgr::EnqueueCallback(se::Stream* stream, std::function<void()> func) {
 
   bool was_empty = callbacks_.empty();
   callbacks_[stream].push_back({std::move(e), std::move(func)});
+  polling_delay_usecs_ = polling_active_delay_usecs_;
 
   // Wake up the polling thread if it was sleeping.
   if (was_empty) {
@@ -196,11 +208,13 @@ void EventMgr::EnqueueCallback(se::Stream* stream, std::function<void()> func) {
 // spikes of up to several hundred outstanding.  (If GPUKernelTracker
 // is used to cap pending kernels there should never be more than
 // that many.)
-void EventMgr::PollEvents(se::Stream* stream /*=nullptr*/) {
+int EventMgr::PollEvents(se::Stream* stream /*=nullptr*/) {
   VLOG(2) << "PollEvents with one or more callbacks pending on "
           << callbacks_.size() << " streams and " << free_events_.size()
           << " unused event objects.";
 
+  int num_retired = 0;
+
   // Polls the events for one stream.
   //
   // `stream_it` should be an iterator into callbacks_.  Modifies stream_it so
@@ -230,6 +244,7 @@ void EventMgr::PollEvents(se::Stream* stream /*=nullptr*/) {
             case se::Event::Status::kComplete:
               free_events_.push_back(std::move(event));
               threadpool_.Schedule(std::move(callback));
+              ++num_retired;
               // std::deque::erase() does invalidate iterators, so we can't
               // erase `it` here.  Instead, we'll wait until the end of the loop
               // over stream_callbacks and erase all of the completed events at
@@ -267,6 +282,7 @@ void EventMgr::PollEvents(se::Stream* stream /*=nullptr*/) {
       poll_events_for_stream_it(stream_it);
     }
   }
+  return num_retired;
 }
 
 EventMgrFactory* EventMgrFactory::Singleton() {
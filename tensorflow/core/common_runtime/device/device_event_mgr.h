@@ -83,6 +83,14 @@ class EventMgr {
   mutex mu_;
   condition_variable events_pending_ TF_GUARDED_BY(mu_);
 
+  // Current sleep of the polling loop between sweeps. Starts at
+  // polling_active_delay_usecs_ and backs off while sweeps retire nothing, up
+  // to kMaxPollingDelayMultiplier times that, so that long-running work does
+  // not keep the poller contending for mu_. Reset whenever a callback is
+  // enqueued or an event completes.
+  static constexpr int32 kMaxPollingDelayMultiplier = 8;
+  int32 polling_delay_usecs_ TF_GUARDED_BY(mu_);
+
   EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options);
 
   // Set up `func` to be called once `stream` completes all its outstanding
@@ -94,8 +102,8 @@ class EventMgr {
   // to check whether pending events have recorded, and then retire them.
   //
   // If `stream` is not null, we only poll events for that stream.  Otherwise we
-  // poll events for all streams.
-  void PollEvents(se::Stream* stream = nullptr)
+  // poll events for all streams.  Returns the number of retired events.
+  int PollEvents(se::Stream* stream = nullptr)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   // An internal polling loop that runs at a low frequency to clear straggler
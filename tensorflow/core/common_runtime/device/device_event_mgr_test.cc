@@ -17,6 +17,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/device/device_event_mgr.h"
 
+#include <algorithm>
 #include <atomic>
 
 #include "xla/stream_executor/gpu/gpu_init.h"
@@ -28,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -479,6 +481,57 @@ static void BM_no_ops(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_no_ops)->UseRealTime()->Arg(4)->Arg(8)->Arg(32);
 
+// Measures the delay between enqueueing a callback and running it while
+// `threads` threads keep the EventMgr busy.
+static void BM_callback_latency(::testing::benchmark::State& state) {
+  const int threads = state.range(0);
+  const int iters = state.max_iterations;
+
+  auto stream_exec = se::GPUMachineManager()->ExecutorForDevice(0).value();
+  std::unique_ptr<se::Stream> stream(new se::Stream(stream_exec));
+  CHECK(stream);
+  stream->Init();
+  TEST_EventMgr em(stream_exec, GPUOptions());
+
+  std::atomic<int64_t> total_latency_usecs(0);
+  auto benchmark_exec = [&]() {
+    std::atomic<int> counter(0);
+    se::Stream* stream_ptr = stream.get();
+    auto runner = [&em, &counter, &total_latency_usecs, stream_ptr, iters]() {
+      for (int i = 0; i < iters; ++i) {
+        const uint64 enqueue_time = Env::Default()->NowMicros();
+        em.ThenExecute(stream_ptr, [&counter, &total_latency_usecs,
+                                    enqueue_time]() {
+          total_latency_usecs.fetch_add(Env::Default()->NowMicros() -
+                                        enqueue_time);
+          counter.fetch_add(1);
+        });
+      }
+    };
+    for (int t = 0; t < threads; ++t) {
+      Env::Default()->SchedClosure(runner);
+    }
+    int expected = iters * threads;
+    while (counter < expected) {
+      Env::Default()->SleepForMicroseconds(1);
+    }
+  };
+
+#ifdef PLATFORM_GOOGLE
+  while (state.KeepRunningBatch(state.max_iterations)) {
+    benchmark_exec();
+  }
+#else
+  state.ResumeTiming();
+  benchmark_exec();
+  state.PauseTiming();
+#endif
+  state.SetLabel(strings::StrCat(
+      "mean callback latency us = ",
+      total_latency_usecs.load() / std::max<int64_t>(1, iters * threads)));
+}
+BENCHMARK(BM_callback_latency)->UseRealTime()->Arg(1)->Arg(8)->Arg(32);
+
 // Benchmark functions are defined at top level.  In order to provide a real,
 // persistent GPUDevice to the following function it also needs to be at top
 // level.  But then we can't clean it up without a cuda runtime error, so we
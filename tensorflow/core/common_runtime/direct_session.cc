@@ -365,6 +365,11 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.message();
   }
+  const Status slots_status = ReadBoolFromEnvVar(
+      "TF_RENDEZVOUS_STATIC_SLOTS", false, &use_rendezvous_slots_);
+  if (!slots_status.ok()) {
+    LOG(ERROR) << slots_status.message();
+  }
   session_handle_ =
       strings::StrCat("direct", strings::FpToString(random::New64()));
   int devices_added = 0;
@@ -717,6 +722,20 @@ Status DirectSession::RunInternal(
 
   Status run_status;
 
+  // The arenas of the partitions that plan their memory, which must outlive
+  // the executors of the step.
+  std::vector<std::unique_ptr<StepMemoryArena>> step_memory_arenas(
+      num_executors);
+  auto begin_step_memory_arena = [executors_and_keys,
+                                  &step_memory_arenas](size_t i) {
+    StepMemoryPlanner* planner =
+        executors_and_keys->items[i].memory_planner.get();
+    if (planner != nullptr) {
+      step_memory_arenas[i] = planner->BeginStep();
+    }
+    return step_memory_arenas[i].get();
+  };
+
   auto set_threadpool_args_for_item =
       [&default_runner, &handler](const PerPartitionExecutorsAndLib& item,
                                   Executor::Args* args) {
@@ -747,6 +766,7 @@ Status DirectSession::RunInternal(
 
     const auto& item = executors_and_keys->items[0];
     set_threadpool_args_for_item(item, &args);
+    args.step_memory_arena = begin_step_memory_arena(0);
     run_status = item.executor->Run(args);
   } else {
     core::RefCountPtr<RefCountedIntraProcessRendezvous> rendezvous(
@@ -765,8 +785,10 @@ Status DirectSession::RunInternal(
                               executors_done.Notify();
                             });
 
-    for (const auto& item : executors_and_keys->items) {
+    for (size_t i = 0; i < num_executors; ++i) {
+      const auto& item = executors_and_keys->items[i];
       set_threadpool_args_for_item(item, &args);
+      args.step_memory_arena = begin_step_memory_arena(i);
       item.executor->RunAsync(args, barrier->Get());
     }
 
@@ -778,6 +800,14 @@ Status DirectSession::RunInternal(
     }
   }
 
+  for (size_t i = 0; i < num_executors; ++i) {
+    StepMemoryPlanner* planner =
+        executors_and_keys->items[i].memory_planner.get();
+    if (planner != nullptr) {
+      planner->EndStep(std::move(step_memory_arenas[i]), run_status);
+    }
+  }
+
   if (step_cancellation_manager.IsCancelled()) {
     run_status.Update(errors::Cancelled("Run call was cancelled"));
   }
@@ -1448,6 +1478,11 @@ Status DirectSession::CreateExecutors(
     auto executor_type = options_.config.experimental().executor_type();
     TF_RETURN_IF_ERROR(
         NewExecutor(executor_type, params, *partition_graph, &item->executor));
+    if (options_.config.experimental().enable_step_memory_plan() &&
+        device->device_type() == DEVICE_CPU) {
+      item->memory_planner = std::make_unique<StepMemoryPlanner>(
+          device->GetAllocator(AllocatorAttributes()));
+    }
     if (!options_.config.experimental().disable_output_partition_graphs() ||
         options_.config.graph_options().build_cost_model() > 0) {
       item->graph = std::move(partition_graph);
@@ -1699,6 +1734,7 @@ Status DirectSession::CreateGraphs(
   };
   popts.flib_def = flib_def->get();
   popts.control_flow_added = false;
+  popts.assign_rendezvous_slots = use_rendezvous_slots_;
 
   std::unordered_map<string, GraphDef> partitions;
   TF_RETURN_IF_ERROR(Partition(popts, &client_graph->graph, &partitions));
@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/session_factory.h"
+#include "tensorflow/core/common_runtime/step_memory_planner.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -148,6 +149,9 @@ class DirectSession : public Session {
     Device* device = nullptr;                // not owned.
     FunctionLibraryRuntime* flib = nullptr;  // not owned.
     std::unique_ptr<Executor> executor;
+    // Set if `ConfigProto.Experimental.enable_step_memory_plan` is true and
+    // the partition runs on a CPU device.
+    std::unique_ptr<StepMemoryPlanner> memory_planner;
   };
 
   // An ExecutorsAndKeys is created for a given set of feeds/fetches.
@@ -355,6 +359,10 @@ class DirectSession : public Session {
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
 
+  // If true, intra-process Send/Recv pairs in the root frame are matched
+  // through preassigned rendezvous slots instead of the keyed table.
+  bool use_rendezvous_slots_ = false;
+
   std::vector<std::unique_ptr<FunctionInfo>> functions_
       TF_GUARDED_BY(executor_lock_);
 
@@ -264,6 +264,34 @@ TEST_F(DirectSessionMinusAXTest,
       absl::StrContains(s.message(), "disable_output_partition_graphs"));
 }
 
+TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_StepMemoryPlan) {
+  Initialize({3, 2, -1, 0});
+  SessionOptions options(DefaultSessionOptions());
+  options.config.mutable_experimental()->set_enable_step_memory_plan(true);
+  auto session = absl::WrapUnique(NewSession(options));
+
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+  std::vector<std::pair<string, Tensor>> inputs;
+
+  // The first step records the plan, which is used by the later steps. The
+  // outputs of every step are kept alive while the later steps run.
+  std::vector<string> output_names = {y_ + ":0", z_ + ":0"};
+  std::vector<std::vector<Tensor>> outputs(4);
+  for (auto& step_outputs : outputs) {
+    TF_ASSERT_OK(session->Run(inputs, output_names, {}, &step_outputs));
+  }
+  for (const auto& step_outputs : outputs) {
+    ASSERT_EQ(2, step_outputs.size());
+    auto y = step_outputs[0].matrix<float>();
+    auto z = step_outputs[1].matrix<float>();
+    EXPECT_FLOAT_EQ(5.0, y(0, 0));
+    EXPECT_FLOAT_EQ(-1.0, y(1, 0));
+    EXPECT_FLOAT_EQ(-5.0, z(0, 0));
+    EXPECT_FLOAT_EQ(1.0, z(1, 0));
+  }
+}
+
 TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_FinalizeWithCallables) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
@@ -68,6 +68,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
 #endif  // !IS_MOBILE_PLATFORM
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/util/env_var.h"
@@ -97,10 +98,23 @@ bool ReadBoolFromEnvVar(StringPiece env_var_name, bool default_val) {
   return default_val;
 }
 
+int64_t ReadInt64FromEnvVar(StringPiece env_var_name, int64_t default_val) {
+  int64_t val;
+  if (tensorflow::ReadInt64FromEnvVar(env_var_name, default_val, &val).ok()) {
+    return val;
+  }
+  return default_val;
+}
+
 auto* eager_context_created =
     monitoring::Gauge<bool, 0>::New("/tensorflow/core/eager_context_created",
                                     "True if an eager context was created.");
 
+auto* eager_kernel_cache_events = monitoring::Counter<1>::New(
+    "/tensorflow/core/eager_kernel_cache_events",
+    "The number of hits, misses and evictions of the eager kernel cache.",
+    "event");
+
 }  // namespace
 
 const int64_t EagerContext::kGlobalRendezvousId = -1;
@@ -132,6 +146,7 @@ EagerContext::EagerContext(
       rendezvous_(std::move(rendezvous)),
       thread_pool_(NewThreadPoolFromSessionOptions(opts)),
       cluster_flr_(cluster_flr),
+      kernel_cache_(ReadInt64FromEnvVar("TF_EAGER_KERNEL_CACHE_CAPACITY", 0)),
       log_device_placement_(opts.config.log_device_placement()),
       allow_soft_placement_(opts.config.allow_soft_placement()),
       num_active_steps_(0),
@@ -456,7 +471,7 @@ void EagerContext::ClearCachesAndDefaultExecutor() {
     // during this time as well.
     mutex_lock ml(cache_mu_);
     default_executor_.WaitForAllPendingNodes().IgnoreError();
-    kernel_cache_.clear();
+    kernel_cache_.Clear();
     for (auto& entry : registered_functions_) {
       entry.second->cached_kernel_keys->clear();
     }
@@ -1103,7 +1118,7 @@ Status EagerContext::RemoveFunction(const string& func) {
     is_last_ref = registered_function->RefCountIsOne();
     if (is_last_ref) {
       for (auto& key : *registered_function->cached_kernel_keys) {
-        kernel_cache_.erase(key);
+        kernel_cache_.Erase(key);
       }
       registered_functions_.erase(func);
     }
@@ -1186,14 +1201,10 @@ Status EagerContext::SyncExecutors() {
 
 core::RefCountPtr<KernelAndDevice> EagerContext::GetCachedKernel(
     Fprint128 cache_key) {
-  tf_shared_lock l(cache_mu_);
-  auto iter = kernel_cache_.find(cache_key);
-  if (iter == kernel_cache_.end()) {
-    return nullptr;
-  }
-  core::RefCountPtr<KernelAndDevice> new_ref(iter->second.get());
-  new_ref->Ref();
-  return new_ref;
+  core::RefCountPtr<KernelAndDevice> kernel = kernel_cache_.Lookup(cache_key);
+  eager_kernel_cache_events->GetCell(kernel == nullptr ? "miss" : "hit")
+      ->IncrementBy(1);
+  return kernel;
 }
 
 Device* EagerContext::GetCachedDevice(Fprint128 device_cache_key) {
@@ -1205,10 +1216,13 @@ Device* EagerContext::GetCachedDevice(Fprint128 device_cache_key) {
 
 void EagerContext::AddKernelToCache(Fprint128 cache_key,
                                     KernelAndDevice* kernel) {
+  // Lookups only lock a shard of kernel_cache_, but insertions also hold
+  // cache_mu_ so that RemoveFunction sees the keys of all cached kernels.
   mutex_lock ml(cache_mu_);
-  core::RefCountPtr<KernelAndDevice> new_ref(kernel);
-  new_ref->Ref();
-  kernel_cache_[cache_key] = std::move(new_ref);
+  const int num_evicted = kernel_cache_.Insert(cache_key, kernel);
+  if (num_evicted > 0) {
+    eager_kernel_cache_events->GetCell("eviction")->IncrementBy(num_evicted);
+  }
   auto* registered_function =
       gtl::FindPtrOrNull(registered_functions_, kernel->name());
 
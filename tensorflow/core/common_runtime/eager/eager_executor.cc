@@ -18,10 +18,12 @@ limitations under the License.
 #include <forward_list>
 #include <functional>
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
@@ -32,11 +34,20 @@ bool IsAsyncWaitForRemoteFunctionEnabled() {
                                  true, &enabled));
   return enabled;
 }
+
+int64_t RunThreadSpinMicros() {
+  int64_t micros;
+  TF_CHECK_OK(
+      ReadInt64FromEnvVar("TF_EAGER_EXECUTOR_SPIN_MICROS", 20, &micros));
+  return micros;
+}
 }  // namespace
 
 EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue,
                              int in_flight_nodes_limit)
     : next_node_id_(0),
+      num_queued_nodes_(0),
+      run_thread_spin_micros_(RunThreadSpinMicros()),
       ok_(true),
       thread_(async ? tensorflow::Env::Default()->StartThread(
                           tensorflow::ThreadOptions(), "eager_async_executor",
@@ -161,10 +172,11 @@ Status EagerExecutor::AddOrExecute(std::unique_ptr<EagerNode> node) {
       status = status_;
       if (status.ok()) {
         node_queue_.push(std::move(item));
-        // If there were no previous nodes pending, wake the run thread to
-        // start processing requests again.
-        if (node_queue_.size() == 1) {
-          nodes_pending_.notify_all();
+        num_queued_nodes_.fetch_add(1, std::memory_order_relaxed);
+        // Only a parked run thread needs waking; a running or spinning one
+        // sees the node by itself.
+        if (run_thread_parked_) {
+          nodes_pending_.notify_one();
         }
         if (in_flight_nodes_limit_ == 0) {
           return OkStatus();
@@ -257,6 +269,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
       // Since this was from the async queue, pop it from the front of the queue
       DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
       node_queue_.pop();
+      num_queued_nodes_.fetch_sub(1, std::memory_order_relaxed);
     } else if (async) {
       // If it is an Async node then we will find the node in the unfinished
       // nodes list. However we only notify if we are at the front of the list
@@ -292,6 +305,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
         items_to_destroy.push_front(std::move(node_queue_.front()));
         node_queue_.pop();
       }
+      num_queued_nodes_.store(0, std::memory_order_relaxed);
       for (auto& it : unfinished_nodes_) {
         items_to_destroy.push_front(std::move(it.second));
       }
@@ -349,11 +363,22 @@ void EagerExecutor::Run() {
       gtl::MakeCleanup([this] { thread_exited_notification_.Notify(); });
   while (true) {
     core::RefCountPtr<NodeItem> curr_item;
+    if (run_thread_spin_micros_ > 0 &&
+        num_queued_nodes_.load(std::memory_order_relaxed) == 0) {
+      Env* env = Env::Default();
+      const uint64 deadline = env->NowMicros() + run_thread_spin_micros_;
+      while (num_queued_nodes_.load(std::memory_order_relaxed) == 0 &&
+             env->NowMicros() < deadline) {
+        std::this_thread::yield();
+      }
+    }
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
       while (node_queue_.empty() || !status_.ok()) {
         if (state_ == ExecutorState::kShutDown) return;
+        run_thread_parked_ = true;
         nodes_pending_.wait(l);
+        run_thread_parked_ = false;
       }
       // Obtain raw pointer since we don't want to remove from the queue until
       // the node has been run. Otherwise, WaitForAllPendingNodes can return
@@ -435,6 +460,7 @@ Status EagerExecutor::MoveToUnfinished(core::RefCountPtr<NodeItem> item,
   if (from_queue) {
     DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
     node_queue_.pop();
+    num_queued_nodes_.fetch_sub(1, std::memory_order_relaxed);
   }
 
   DVLOG(3) << "Add Node: [id " << item->id << "] to unfinished map.";
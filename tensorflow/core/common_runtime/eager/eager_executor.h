@@ -232,6 +232,16 @@ class EagerExecutor {
   // Queue of pending NodeItems. Ordered by NodeItem::id.
   std::queue<core::RefCountPtr<NodeItem>> node_queue_
       TF_GUARDED_BY(node_queue_mutex_);
+  // The size of node_queue_, which the run thread reads without the lock
+  // while it spins for new nodes.
+  std::atomic<int64_t> num_queued_nodes_;
+  // Whether the run thread waits on nodes_pending_. AddOrExecute only needs to
+  // wake it then, since it checks node_queue_ before it parks.
+  bool run_thread_parked_ TF_GUARDED_BY(node_queue_mutex_) = false;
+  // How long the run thread polls for new nodes once node_queue_ is empty
+  // before it parks, which saves a wakeup when nodes arrive in quick
+  // succession. It is set before the run thread starts.
+  const int64_t run_thread_spin_micros_;
 
   // Ordered by NodeItem::id.
   std::map<uint64, core::RefCountPtr<NodeItem>, std::less<uint64>>
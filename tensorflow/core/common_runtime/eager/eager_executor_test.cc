@@ -14,12 +14,17 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 
+#include <atomic>
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/status.h"
 #include "tsl/protobuf/error_codes.pb.h"
@@ -281,5 +286,67 @@ TEST(EagerExecutorTest, TestAsyncExecutorAddNodesAfterShutdown) {
       async_executor->AddOrExecute(std::move(node)),
       tensorflow::testing::StatusIs(tensorflow::error::FAILED_PRECONDITION));
 }
+
+class CountingEagerNode : public EagerNode {
+ public:
+  explicit CountingEagerNode(std::atomic<int>* count) : count_(count) {}
+  Status Run() override {
+    count_->fetch_add(1, std::memory_order_relaxed);
+    return OkStatus();
+  }
+  void Abort(Status status) override {}
+  string DebugString() const override { return "countingEagerNode"; }
+
+ private:
+  std::atomic<int>* count_;
+};
+
+// Enqueues `num_nodes` nodes from each of `num_producers` threads.
+void AddNodesConcurrently(EagerExecutor* executor, thread::ThreadPool* pool,
+                          int num_producers, int num_nodes,
+                          std::atomic<int>* count) {
+  BlockingCounter producers(num_producers);
+  for (int i = 0; i < num_producers; ++i) {
+    pool->Schedule([executor, num_nodes, count, &producers] {
+      for (int j = 0; j < num_nodes; ++j) {
+        TF_CHECK_OK(executor->AddOrExecute(
+            std::make_unique<CountingEagerNode>(count)));
+      }
+      producers.DecrementCount();
+    });
+  }
+  producers.Wait();
+}
+
+TEST(EagerExecutorTest, TestAsyncExecutorWithConcurrentProducers) {
+  auto async_executor = std::make_unique<EagerExecutor>(
+      /*async=*/true, /*enable_streaming_enqueue=*/true);
+  thread::ThreadPool pool(Env::Default(), "producers", 8);
+  std::atomic<int> count(0);
+  for (int round = 0; round < 10; ++round) {
+    AddNodesConcurrently(async_executor.get(), &pool, 8, 100, &count);
+    TF_ASSERT_OK(async_executor->WaitForAllPendingNodes());
+    EXPECT_EQ(count, (round + 1) * 800);
+  }
+  TF_ASSERT_OK(async_executor->ShutDown());
+}
+
+void BM_AsyncAddOrExecute(::testing::benchmark::State& state) {
+  const int num_producers = state.range(0);
+  constexpr int kNodesPerProducer = 1000;
+  EagerExecutor executor(/*async=*/true, /*enable_streaming_enqueue=*/true);
+  thread::ThreadPool pool(Env::Default(), "producers", num_producers);
+  std::atomic<int> count(0);
+  for (auto s : state) {
+    AddNodesConcurrently(&executor, &pool, num_producers, kNodesPerProducer,
+                         &count);
+    TF_CHECK_OK(executor.WaitForAllPendingNodes());
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          kNodesPerProducer);
+  TF_CHECK_OK(executor.ShutDown());
+}
+BENCHMARK(BM_AsyncAddOrExecute)->RangeMultiplier(2)->Range(1, 32);
+
 }  // namespace
 }  // namespace tensorflow
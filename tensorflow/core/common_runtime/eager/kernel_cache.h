@@ -0,0 +1,141 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_KERNEL_CACHE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_KERNEL_CACHE_H_
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/mutex.h"
+#include "tsl/platform/refcount.h"
+#include "tsl/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// A cache of ref-counted kernels keyed by fingerprint, split into shards with
+// a lock each so that concurrent eager ops rarely contend. When "capacity" is
+// positive, each shard keeps at most capacity / kNumShards kernels (rounded
+// up) and evicts its least recently used ones beyond that. Evicted kernels
+// stay alive while ops still hold references to them.
+//
+// T is KernelAndDevice in EagerContext; the cache is a template so that it
+// can be tested without kernels.
+template <typename T>
+class KernelCache {
+ public:
+  static constexpr int kNumShards = 16;
+
+  // A capacity of 0 or less means that the cache is unbounded.
+  explicit KernelCache(int64_t capacity)
+      : shard_capacity_(capacity <= 0
+                            ? 0
+                            : (capacity + kNumShards - 1) / kNumShards) {}
+
+  // Returns a new reference to the kernel cached for "key", or nullptr.
+  tsl::core::RefCountPtr<T> Lookup(const tsl::Fprint128& key) {
+    Shard& shard = GetShard(key);
+    tsl::mutex_lock l(shard.mu);
+    auto iter = shard.index.find(key);
+    if (iter == shard.index.end()) return nullptr;
+    shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+    T* kernel = iter->second->second.get();
+    kernel->Ref();
+    return tsl::core::RefCountPtr<T>(kernel);
+  }
+
+  // Caches "kernel", taking a new reference to it, and returns the number of
+  // kernels evicted to make room.
+  int Insert(const tsl::Fprint128& key, T* kernel) {
+    kernel->Ref();
+    tsl::core::RefCountPtr<T> new_ref(kernel);
+    Shard& shard = GetShard(key);
+    // The evicted kernels are released outside of the lock.
+    std::list<Entry> evicted;
+    {
+      tsl::mutex_lock l(shard.mu);
+      auto iter = shard.index.find(key);
+      if (iter != shard.index.end()) {
+        iter->second->second.swap(new_ref);
+        shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+      } else {
+        shard.lru.emplace_front(key, std::move(new_ref));
+        shard.index[key] = shard.lru.begin();
+      }
+      while (shard_capacity_ > 0 &&
+             static_cast<int64_t>(shard.lru.size()) > shard_capacity_) {
+        shard.index.erase(shard.lru.back().first);
+        evicted.splice(evicted.begin(), shard.lru, std::prev(shard.lru.end()));
+      }
+    }
+    return evicted.size();
+  }
+
+  void Erase(const tsl::Fprint128& key) {
+    Shard& shard = GetShard(key);
+    std::list<Entry> erased;
+    tsl::mutex_lock l(shard.mu);
+    auto iter = shard.index.find(key);
+    if (iter == shard.index.end()) return;
+    erased.splice(erased.begin(), shard.lru, iter->second);
+    shard.index.erase(iter);
+  }
+
+  void Clear() {
+    for (Shard& shard : shards_) {
+      std::list<Entry> cleared;
+      tsl::mutex_lock l(shard.mu);
+      cleared.swap(shard.lru);
+      shard.index.clear();
+    }
+  }
+
+  int64_t size() const {
+    int64_t size = 0;
+    for (const Shard& shard : shards_) {
+      tsl::mutex_lock l(shard.mu);
+      size += shard.lru.size();
+    }
+    return size;
+  }
+
+ private:
+  typedef std::pair<tsl::Fprint128, tsl::core::RefCountPtr<T>> Entry;
+
+  struct Shard {
+    mutable tsl::mutex mu;
+    // The most recently used entries come first.
+    std::list<Entry> lru TF_GUARDED_BY(mu);
+    absl::flat_hash_map<tsl::Fprint128, typename std::list<Entry>::iterator,
+                        tsl::Fprint128Hasher>
+        index TF_GUARDED_BY(mu);
+  };
+
+  Shard& GetShard(const tsl::Fprint128& key) {
+    return shards_[key.high64 % kNumShards];
+  }
+
+  const int64_t shard_capacity_;
+  std::array<Shard, kNumShards> shards_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_KERNEL_CACHE_H_
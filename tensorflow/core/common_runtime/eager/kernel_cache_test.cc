@@ -0,0 +1,99 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/eager/kernel_cache.h"
+
+#include <cstdint>
+
+#include "tensorflow/core/platform/test.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/refcount.h"
+
+namespace tensorflow {
+namespace {
+
+class FakeKernel : public tsl::core::RefCounted {};
+
+tsl::Fprint128 Key(uint64_t i) { return {i, i}; }
+
+// Caches a new FakeKernel for "key", owned by "cache" only.
+int InsertNewKernel(KernelCache<FakeKernel>* cache, const tsl::Fprint128& key) {
+  tsl::core::RefCountPtr<FakeKernel> kernel(new FakeKernel);
+  return cache->Insert(key, kernel.get());
+}
+
+TEST(KernelCacheTest, Unbounded) {
+  KernelCache<FakeKernel> cache(/*capacity=*/0);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(InsertNewKernel(&cache, Key(i)), 0);
+  }
+  EXPECT_EQ(cache.size(), 1000);
+  EXPECT_NE(cache.Lookup(Key(0)), nullptr);
+  EXPECT_EQ(cache.Lookup(Key(1000)), nullptr);
+}
+
+TEST(KernelCacheTest, EvictsLeastRecentlyUsed) {
+  // Keys with the same high64 are in the same shard, which keeps at most one
+  // kernel.
+  KernelCache<FakeKernel> cache(KernelCache<FakeKernel>::kNumShards);
+  const tsl::Fprint128 first = {0, 1};
+  const tsl::Fprint128 second = {0, 2};
+  EXPECT_EQ(InsertNewKernel(&cache, first), 0);
+  tsl::core::RefCountPtr<FakeKernel> held = cache.Lookup(first);
+  ASSERT_NE(held, nullptr);
+  EXPECT_EQ(InsertNewKernel(&cache, second), 1);
+  EXPECT_EQ(cache.Lookup(first), nullptr);
+  EXPECT_NE(cache.Lookup(second), nullptr);
+  // The evicted kernel is still alive for its user.
+  EXPECT_TRUE(held->RefCountIsOne());
+}
+
+TEST(KernelCacheTest, LookupRefreshes) {
+  KernelCache<FakeKernel> cache(2 * KernelCache<FakeKernel>::kNumShards);
+  const tsl::Fprint128 a = {0, 1};
+  const tsl::Fprint128 b = {0, 2};
+  const tsl::Fprint128 c = {0, 3};
+  InsertNewKernel(&cache, a);
+  InsertNewKernel(&cache, b);
+  EXPECT_NE(cache.Lookup(a), nullptr);
+  EXPECT_EQ(InsertNewKernel(&cache, c), 1);
+  EXPECT_NE(cache.Lookup(a), nullptr);
+  EXPECT_EQ(cache.Lookup(b), nullptr);
+  EXPECT_NE(cache.Lookup(c), nullptr);
+}
+
+TEST(KernelCacheTest, ReplacesKernel) {
+  KernelCache<FakeKernel> cache(/*capacity=*/0);
+  InsertNewKernel(&cache, Key(1));
+  tsl::core::RefCountPtr<FakeKernel> kernel(new FakeKernel);
+  EXPECT_EQ(cache.Insert(Key(1), kernel.get()), 0);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.Lookup(Key(1)).get(), kernel.get());
+}
+
+TEST(KernelCacheTest, EraseAndClear) {
+  KernelCache<FakeKernel> cache(/*capacity=*/0);
+  for (int i = 0; i < 100; ++i) InsertNewKernel(&cache, Key(i));
+  cache.Erase(Key(7));
+  cache.Erase(Key(100));
+  EXPECT_EQ(cache.size(), 99);
+  EXPECT_EQ(cache.Lookup(Key(7)), nullptr);
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.Lookup(Key(8)), nullptr);
+}
+
+}  // namespace
+}  // namespace tensorflow
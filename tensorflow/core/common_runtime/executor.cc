@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -36,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/work_stealing_queue.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
@@ -298,6 +300,12 @@ class ExecutorState {
 
   struct AsyncState;
 
+  // A ready node queued for work stealing, and the time it was scheduled.
+  struct ScheduledNode {
+    TaggedNode tagged_node;
+    int64_t scheduled_nsec;
+  };
+
   // Process a ready node in current thread.
   void Process(const TaggedNode& node, int64_t scheduled_nsec);
 
@@ -346,6 +354,14 @@ class ExecutorState {
   template <typename Closure>
   void RunTask(Closure&& c, int sample_rate = 0);
 
+  // Pushes `nodes` to `work_stealing_queue_` and starts up to `nodes.size()`
+  // idle workers to run them.
+  //
+  // REQUIRES: The calling thread still owns another ready node, so that the
+  // execution cannot complete before this method returns.
+  void ScheduleWithWorkStealing(const TaggedNodeSeq& nodes,
+                                int64_t scheduled_nsec);
+
   // Clean up when this executor is done.
   void Finish();
   void ScheduleFinish();
@@ -377,6 +393,7 @@ class ExecutorState {
   string session_handle_;
   const SessionMetadata* session_metadata_ = nullptr;
   TensorStore* tensor_store_;
+  StepMemoryArena* step_memory_arena_;
   // Step-local container.
   ScopedStepContainer* step_container_;
   StepStatsCollectorInterface* const stats_collector_;
@@ -398,6 +415,11 @@ class ExecutorState {
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
 
+  // Queues the expensive ready nodes if `Args::num_work_stealing_workers` is
+  // positive. Shared with the closures that run its workers, which may outlive
+  // this ExecutorState.
+  std::shared_ptr<WorkStealingQueue<ScheduledNode>> work_stealing_queue_;
+
   PropagatorStateType propagator_;
 
   // Invoked when the execution finishes.
@@ -431,6 +453,7 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       session_handle_(args.session_handle),
       session_metadata_(immutable_state.params().session_metadata),
       tensor_store_(args.tensor_store),
+      step_memory_arena_(args.step_memory_arena),
       step_container_(args.step_container),
       stats_collector_(args.stats_collector),
       event_collector_(
@@ -453,6 +476,10 @@ ExecutorState<PropagatorStateType>::ExecutorState(
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (args.num_work_stealing_workers > 0 && !run_all_kernels_inline_) {
+    work_stealing_queue_ = std::make_shared<WorkStealingQueue<ScheduledNode>>(
+        args.num_work_stealing_workers);
+  }
 }
 
 template <class PropagatorStateType>
@@ -487,6 +514,31 @@ void ExecutorState<PropagatorStateType>::RunTask(Closure&& c, int sample_rate) {
   });
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::ScheduleWithWorkStealing(
+    const TaggedNodeSeq& nodes, int64_t scheduled_nsec) {
+  for (const TaggedNode& tagged_node : nodes) {
+    work_stealing_queue_->Push({tagged_node, scheduled_nsec});
+  }
+  // Pushes before reserving workers, so that a worker that stops concurrently
+  // either is reserved again or finds the new nodes.
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const int worker_id = work_stealing_queue_->ReserveWorker();
+    if (worker_id < 0) {
+      break;
+    }
+    RunTask(
+        [this, queue = work_stealing_queue_, worker_id]() {
+          // `this` is only used while the queue holds a node, which keeps the
+          // execution alive.
+          queue->RunWorker(worker_id, [this](const ScheduledNode& node) {
+            Process(node.tagged_node, node.scheduled_nsec);
+          });
+        },
+        /*sample_rate=*/nodes.size());
+  }
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::RunAsync(Executor::DoneCallback done) {
   TaggedNodeSeq ready;
@@ -763,6 +815,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
   params->session_handle = session_handle_;
   params->session_metadata = session_metadata_;
   params->tensor_store = tensor_store_;
+  params->step_memory_arena = step_memory_arena_;
   params->cancellation_manager = cancellation_manager_;
   params->coordination_service_agent = coordination_service_agent_;
   params->stack_trace = stack_trace_;
@@ -1297,7 +1350,17 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   } else {
     const TaggedNode* curr_expensive_node = nullptr;
     TaggedNodeSeq expensive_nodes;
-    if (inline_ready == nullptr) {
+    if (inline_ready == nullptr && work_stealing_queue_) {
+      // Queue all but the first ready op for work stealing. The first op is
+      // dispatched last, so that the execution is kept alive until every
+      // other op has been queued.
+      const TaggedNode first_node = ready->front();
+      TaggedNodeSeq queued_nodes(std::next(ready->begin()), ready->end());
+      if (!queued_nodes.empty()) {
+        ScheduleWithWorkStealing(queued_nodes, scheduled_nsec);
+      }
+      RunTask([=]() { Process(first_node, scheduled_nsec); });
+    } else if (inline_ready == nullptr) {
       // Schedule to run all the ready ops in thread pool.
       for (auto& tagged_node : *ready) {
         RunTask([=]() { Process(tagged_node, scheduled_nsec); },
@@ -1327,7 +1390,10 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
       }
     }
     if (!expensive_nodes.empty()) {
-      if (expensive_nodes.size() < kInlineScheduleReadyThreshold) {
+      if (work_stealing_queue_) {
+        // The nodes in `inline_ready` keep the execution alive.
+        ScheduleWithWorkStealing(expensive_nodes, scheduled_nsec);
+      } else if (expensive_nodes.size() < kInlineScheduleReadyThreshold) {
         for (auto& tagged_node : expensive_nodes) {
           RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
                             scheduled_nsec),
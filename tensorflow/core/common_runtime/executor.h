@@ -105,6 +105,10 @@ class Executor {
     // Unique session identifier. Can be empty.
     string session_handle;
     TensorStore* tensor_store = nullptr;
+    // If not nullptr, provides the memory for the outputs of the kernels of
+    // the step (see OpKernelContext::Params::step_memory_arena). Must outlive
+    // the step.
+    StepMemoryArena* step_memory_arena = nullptr;
     ScopedStepContainer* step_container = nullptr;
     CollectiveExecutor* collective_executor = nullptr;
     thread::ThreadPoolInterface* user_intra_op_threadpool = nullptr;
@@ -124,6 +128,14 @@ class Executor {
     // If true, all kernels will be treated as "inexpensive", and hence executed
     // on the scheduling thread.
     bool run_all_kernels_inline = false;
+
+    // If positive, the expensive kernels that become ready are queued into
+    // this many per-worker deques instead of being dispatched to "runner" one
+    // closure at a time. At most this many closures run kernels at once, each
+    // runs the successors of its own kernels first, and steals from the other
+    // workers when it runs out of work. Typically set to the number of threads
+    // backing "runner". Ignored if `run_all_kernels_inline` is true.
+    int num_work_stealing_workers = 0;
   };
   typedef std::function<void(const Status&)> DoneCallback;
 
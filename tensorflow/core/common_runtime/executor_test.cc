@@ -97,11 +97,12 @@ class ExecutorTest : public ::testing::Test {
     runner_ = [this](std::function<void()> fn) { thread_pool_->Schedule(fn); };
   }
 
-  Status Run(Rendezvous* rendez) {
+  Status Run(Rendezvous* rendez, int num_work_stealing_workers = 0) {
     Executor::Args args;
     args.rendezvous = rendez;
     args.stats_collector = &step_stats_collector_;
     args.runner = runner_;
+    args.num_work_stealing_workers = num_work_stealing_workers;
     return exec_->Run(args);
   }
 
@@ -186,6 +187,34 @@ TEST_F(ExecutorTest, SimpleAdd) {
   EXPECT_EQ(2.0, V(out));  // out = 1.0 + 1.0 = 2.0
 }
 
+TEST_F(ExecutorTest, WorkStealing) {
+  // 16 chains of v = v + v, 8 deep, starting from a, then summed up.
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  const int kWidth = 16;
+  const int kDepth = 8;
+  Node* sum = nullptr;
+  for (int i = 0; i < kWidth; ++i) {
+    Node* v = in;
+    for (int j = 0; j < kDepth; ++j) {
+      v = test::graph::Add(g.get(), v, v);
+    }
+    sum = sum == nullptr ? v : test::graph::Add(g.get(), sum, v);
+  }
+  test::graph::Send(g.get(), sum, "b", BOB, 1, ALICE);
+  Create(std::move(g));
+  Rendezvous::Args args;
+  // a = 1.0
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_, /*num_work_stealing_workers=*/4));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+  EXPECT_EQ(kWidth * 256.0, V(out));  // out = 16 * 2^8
+}
+
 TEST_F(ExecutorTest, SelfAdd) {
   // v0 <- a
   // v1 = v0 + v0
@@ -521,6 +550,79 @@ BENCHMARK(BM_const_identity)
     ->ArgPair(100, 1)
     ->ArgPair(100, 100);
 
+// Create a graph of 'width' independent chains of 'depth' small matmuls, which
+// all start from the same constant. Runs it on the default inter-op thread
+// pool, with as many work-stealing workers as threads if 'work_stealing'.
+static void BM_executor_matmul_chains(::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+  const bool work_stealing = state.range(2);
+
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  Tensor weights_t(DT_FLOAT, TensorShape({32, 32}));
+  weights_t.flat<float>().setRandom();
+  Node* weights = test::graph::Constant(g.get(), weights_t);
+  for (int i = 0; i < width; ++i) {
+    Node* v = weights;
+    for (int j = 0; j < depth; ++j) {
+      v = test::graph::Matmul(g.get(), v, weights, false, false);
+    }
+  }
+  FixupSourceAndSinkEdges(g.get());
+
+  std::unique_ptr<Device> device = DeviceFactory::NewDevice(
+      "CPU", {}, "/job:localhost/replica:0/task:0");
+  const int version = g->versions().producer();
+  LocalExecutorParams params;
+  params.device = device.get();
+  params.create_kernel =
+      [&device, version](const std::shared_ptr<const NodeProperties>& props,
+                         OpKernel** kernel) {
+        return CreateNonCachedKernel(device.get(), nullptr, props, version,
+                                     kernel);
+      };
+  params.delete_kernel = [](OpKernel* kernel) {
+    DeleteNonCachedKernel(kernel);
+  };
+  Executor* exec = nullptr;
+  TF_CHECK_OK(NewLocalExecutor(params, *g, &exec));
+  std::unique_ptr<Executor> exec_owner(exec);
+
+  thread::ThreadPool* pool = ComputePool(SessionOptions());
+  Executor::Args args;
+  args.runner = [pool](std::function<void()> fn) {
+    pool->Schedule(std::move(fn));
+  };
+  if (work_stealing) {
+    args.num_work_stealing_workers = pool->NumThreads();
+  }
+  for (auto s : state) {
+    TF_CHECK_OK(exec->Run(args));
+  }
+
+  const int64_t num_nodes = 1 + width * depth;
+  state.SetLabel(strings::StrCat("Nodes = ", num_nodes));
+  state.SetItemsProcessed(num_nodes * static_cast<int64_t>(state.iterations()));
+}
+
+// Wide graphs
+BENCHMARK(BM_executor_matmul_chains)
+    ->UseRealTime()
+    ->Args({1024, 4, 0})
+    ->Args({1024, 4, 1});
+
+// Deep graphs
+BENCHMARK(BM_executor_matmul_chains)
+    ->UseRealTime()
+    ->Args({8, 512, 0})
+    ->Args({8, 512, 1});
+
+// Wide and deep graphs
+BENCHMARK(BM_executor_matmul_chains)
+    ->UseRealTime()
+    ->Args({256, 64, 0})
+    ->Args({256, 64, 1});
+
 static void BM_FeedInputFetchOutput(::testing::benchmark::State& state) {
   Graph* g = new Graph(OpRegistry::Global());
   // z = x + y: x and y are provided as benchmark inputs.  z is the
@@ -20,7 +20,10 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tsl/framework/bfc_allocator.h"
 #include "tsl/platform/logging.h"
 
@@ -82,6 +85,65 @@ bool GetGarbageCollectionValue() {
 }
 }  // anonymous namespace
 
+// Events are created on demand, and repeatedly reused.
+class GPUBFCAllocator::EventPool {
+ public:
+  std::unique_ptr<se::Event> Get(se::StreamExecutor* executor) {
+    {
+      mutex_lock l(mu_);
+      std::vector<std::unique_ptr<se::Event>>& events = free_events_[executor];
+      if (!events.empty()) {
+        std::unique_ptr<se::Event> event = std::move(events.back());
+        events.pop_back();
+        return event;
+      }
+    }
+    auto event = std::make_unique<se::Event>(executor);
+    if (!event->Init()) {
+      return nullptr;
+    }
+    return event;
+  }
+
+  void Put(se::StreamExecutor* executor, std::unique_ptr<se::Event> event) {
+    mutex_lock l(mu_);
+    free_events_[executor].push_back(std::move(event));
+  }
+
+ private:
+  mutex mu_;
+  absl::flat_hash_map<se::StreamExecutor*,
+                      std::vector<std::unique_ptr<se::Event>>>
+      free_events_ TF_GUARDED_BY(mu_);
+};
+
+class GPUBFCAllocator::StreamEvent : public tsl::BFCAllocator::StreamEvent {
+ public:
+  StreamEvent(std::shared_ptr<EventPool> pool, se::StreamExecutor* executor,
+              std::unique_ptr<se::Event> event)
+      : pool_(std::move(pool)), executor_(executor), event_(std::move(event)) {}
+
+  ~StreamEvent() override { pool_->Put(executor_, std::move(event_)); }
+
+  bool IsComplete() override {
+    se::Event::Status s = event_->PollForStatus();
+    switch (s) {
+      case se::Event::Status::kPending:
+        return false;
+      case se::Event::Status::kComplete:
+        return true;
+      default:
+        // The memory cannot be reused safely if the stream failed.
+        LOG(FATAL) << "Unexpected Event status: " << static_cast<int>(s);
+    }
+  }
+
+ private:
+  const std::shared_ptr<EventPool> pool_;
+  se::StreamExecutor* const executor_;
+  std::unique_ptr<se::Event> event_;
+};
+
 GPUBFCAllocator::GPUBFCAllocator(
     std::unique_ptr<tsl::SubAllocator> sub_allocator, size_t total_memory,
     const std::string& name, const Options& opts)
@@ -95,7 +157,31 @@ GPUBFCAllocator::GPUBFCAllocator(
           o.garbage_collection = GetGarbageCollectionValue();
         }
         o.fragmentation_fraction = opts.fragmentation_fraction;
+        o.defragmentation = opts.defragmentation;
+        o.record_allocation_sites = opts.record_allocation_sites;
         return o;
-      }()) {}
+      }()),
+      event_pool_(std::make_shared<EventPool>()) {}
+
+void GPUBFCAllocator::DeallocateRawOnStream(void* ptr, se::Stream* stream) {
+  if (ptr == nullptr) {
+    return;
+  }
+  se::StreamExecutor* executor = stream->parent();
+  std::unique_ptr<se::Event> event = event_pool_->Get(executor);
+  if (event == nullptr) {
+    LOG(ERROR) << "Failed to create an event, freeing " << ptr
+               << " after the work of the stream";
+    if (!stream->BlockHostUntilDone().ok()) {
+      LOG(FATAL) << "Failed to wait for the stream";
+    }
+    DeallocateRaw(ptr);
+    return;
+  }
+  stream->ThenRecordEvent(event.get());
+  DeallocateRawOnStream(
+      ptr, stream,
+      std::make_unique<StreamEvent>(event_pool_, executor, std::move(event)));
+}
 
 }  // namespace tensorflow
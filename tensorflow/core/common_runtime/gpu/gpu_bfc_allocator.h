@@ -20,6 +20,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 
+#include "tensorflow/core/platform/stream_executor.h"
 #include "tsl/framework/allocator.h"
 #include "tsl/framework/bfc_allocator.h"
 #include "tsl/platform/macros.h"
@@ -46,6 +47,12 @@ class GPUBFCAllocator : public tsl::BFCAllocator {
 
     double fragmentation_fraction = 0;
     bool allow_retry_on_failure = true;
+
+    // Requires a sub allocator that can release pages, e.g. a
+    // GpuVirtualMemAllocator whose pages are mapped individually.
+    bool defragmentation = false;
+
+    bool record_allocation_sites = false;
   };
 
   GPUBFCAllocator(std::unique_ptr<tsl::SubAllocator> sub_allocator,
@@ -54,8 +61,23 @@ class GPUBFCAllocator : public tsl::BFCAllocator {
 
   ~GPUBFCAllocator() override {}
 
+  // Frees ptr once the work enqueued so far on `stream` is done with it, see
+  // BFCAllocator::DeallocateRawOnStream. Records an event on `stream`, which
+  // the allocations on other streams wait for. The allocations on `stream`
+  // should use AllocateRawOnStream(alignment, num_bytes, stream, attr) to
+  // reuse the memory right away.
+  void DeallocateRawOnStream(void* ptr, se::Stream* stream);
+  using tsl::BFCAllocator::DeallocateRawOnStream;
+
   GPUBFCAllocator(const GPUBFCAllocator&) = delete;
   void operator=(const GPUBFCAllocator&) = delete;
+
+ private:
+  class EventPool;
+  class StreamEvent;
+
+  // Shared with the events, which may outlive the allocator's members.
+  std::shared_ptr<EventPool> event_pool_;
 };
 
 }  // namespace tensorflow
@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/bfc_memory_map.pb.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tsl/framework/device_id.h"
+#include "tsl/lib/core/status_test_util.h"
 #include "tsl/lib/gtl/inlined_vector.h"
 #include "tsl/lib/random/simple_philox.h"
 #include "tsl/platform/logging.h"
@@ -329,6 +330,32 @@ TEST_P(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   }
 }
 
+TEST_P(GPUBFCAllocatorTest, StreamOrderedDeallocation) {
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1 << 30, "GPU_0_bfc", {});
+  auto executor = GPUMachineManager()->ExecutorForDevice(0).value();
+  std::unique_ptr<se::Stream> s1(new se::Stream(executor));
+  s1->Init();
+  std::unique_ptr<se::Stream> s2(new se::Stream(executor));
+  s2->Init();
+  AllocationAttributes attr;
+
+  void* p1 = a.AllocateRawOnStream(1, 1024, s1.get(), attr);
+  ASSERT_NE(p1, nullptr);
+  a.DeallocateRawOnStream(p1, s1.get());
+  // The stream that freed the memory can reuse it right away.
+  void* p2 = a.AllocateRawOnStream(1, 1024, s1.get(), attr);
+  EXPECT_EQ(p2, p1);
+  a.DeallocateRawOnStream(p2, s1.get());
+
+  // Other streams can once the work of the stream is done.
+  TF_ASSERT_OK(s1->BlockHostUntilDone());
+  void* p3 = a.AllocateRawOnStream(1, 1024, s2.get(), attr);
+  EXPECT_EQ(p3, p1);
+  a.DeallocateRawOnStream(p3, s2.get());
+  TF_ASSERT_OK(s2->BlockHostUntilDone());
+  CheckStats(&a, 3, 0, 1024, 1024);
+}
+
 TEST_P(GPUBFCAllocatorTest, DISABLED_AllocatorReceivesZeroMemory) {
   GPUBFCAllocator a(GetParam()(1ul << 62), 1UL << 60, "GPU_0_bfc", {});
   GPUBFCAllocator b(GetParam()(1ul << 62), 1UL << 60, "GPU_0_bfc", {});
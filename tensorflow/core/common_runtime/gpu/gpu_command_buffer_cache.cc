@@ -0,0 +1,59 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/gpu/gpu_command_buffer_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/statusor.h"
+
+namespace tensorflow {
+
+Status GpuCommandBufferCache::Run(se::Stream* stream, const std::string& key,
+                                  const Function& function) {
+  se::StreamExecutor* executor = stream->parent();
+  // The lock is held while the work is enqueued so that concurrent runs of a
+  // key neither trace it twice nor interleave with the tracing.
+  mutex_lock l(mu_);
+  Entry& entry = entries_[key];
+  if (entry.command_buffer == nullptr) {
+    if (entry.num_runs < warmup_runs_) {
+      ++entry.num_runs;
+      return function(stream);
+    }
+    TF_ASSIGN_OR_RETURN(
+        se::CommandBuffer command_buffer,
+        se::CommandBuffer::Trace(
+            executor, [&function](se::Stream* s) { return function(s); }));
+    VLOG(1) << "Recorded command buffer for " << key;
+    entry.command_buffer =
+        std::make_unique<se::CommandBuffer>(std::move(command_buffer));
+  }
+  return executor->Submit(stream, *entry.command_buffer);
+}
+
+int GpuCommandBufferCache::num_recorded() const {
+  tf_shared_lock l(mu_);
+  int n = 0;
+  for (const auto& [key, entry] : entries_) {
+    if (entry.command_buffer != nullptr) ++n;
+  }
+  return n;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,73 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_COMMAND_BUFFER_CACHE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_COMMAND_BUFFER_CACHE_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "xla/stream_executor/command_buffer.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Replays GPU work issued through se::Stream from recorded command buffers
+// (CUDA graphs) instead of launching it piece by piece.
+//
+// Work is identified by a caller-provided key, e.g. a fingerprint of the input
+// shapes. The first `warmup_runs` runs of a key issue the work directly, which
+// lets lazily initialized state (autotuning, library handles, scratch
+// allocations) settle. The next run traces the work into a command buffer and
+// every later run of that key submits the command buffer.
+//
+// The traced work must be fully determined by the key: it may not depend on
+// host-side values that change between runs, and every device buffer it
+// touches must keep the same address, e.g. by being allocated once from the
+// device arena and reused across runs.
+//
+// Thread-safe.
+class GpuCommandBufferCache {
+ public:
+  using Function = std::function<Status(se::Stream*)>;
+
+  explicit GpuCommandBufferCache(int warmup_runs)
+      : warmup_runs_(warmup_runs) {}
+
+  // Enqueues the work of `function` for `key` onto `stream`.
+  Status Run(se::Stream* stream, const std::string& key,
+             const Function& function);
+
+  // Returns the number of keys that have a recorded command buffer.
+  int num_recorded() const;
+
+ private:
+  struct Entry {
+    int num_runs = 0;
+    std::unique_ptr<se::CommandBuffer> command_buffer;
+  };
+
+  const int warmup_runs_;
+  mutable mutex mu_;
+  absl::flat_hash_map<std::string, Entry> entries_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_COMMAND_BUFFER_CACHE_H_
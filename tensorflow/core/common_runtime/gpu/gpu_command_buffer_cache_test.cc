@@ -0,0 +1,69 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#include "tensorflow/core/common_runtime/gpu/gpu_command_buffer_cache.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "xla/stream_executor/gpu/gpu_init.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tsl/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(GpuCommandBufferCacheTest, ReplaysRecordedWorkAfterWarmup) {
+  se::StreamExecutor* executor =
+      se::GPUMachineManager()->ExecutorForDevice(0).value();
+  se::Stream stream(executor);
+  stream.Init();
+
+  constexpr int kLength = 16;
+  se::ScopedDeviceMemory<uint32_t> buffer =
+      executor->AllocateOwnedArray<uint32_t>(kLength);
+  se::DeviceMemoryBase memory = *buffer.ptr();
+
+  int num_calls = 0;
+  uint32_t pattern = 0;
+  auto fill = [&](se::Stream* s) {
+    ++num_calls;
+    s->ThenMemset32(&memory, pattern, kLength * sizeof(uint32_t));
+    return s->ok() ? OkStatus() : errors::Internal("Memset failed");
+  };
+
+  GpuCommandBufferCache cache(/*warmup_runs=*/2);
+  std::vector<uint32_t> host(kLength);
+  for (int i = 0; i < 5; ++i) {
+    // Changing `pattern` is only visible to runs that issue the work directly,
+    // the recorded command buffer replays the value it was traced with.
+    pattern = i;
+    TF_ASSERT_OK(cache.Run(&stream, "fill", fill));
+    stream.ThenMemcpy(host.data(), memory, kLength * sizeof(uint32_t));
+    TF_ASSERT_OK(stream.BlockHostUntilDone());
+    EXPECT_EQ(host[0], i < 2 ? i : 2);
+  }
+  // Two warmup runs and one traced run.
+  EXPECT_EQ(num_calls, 3);
+  EXPECT_EQ(cache.num_recorded(), 1);
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
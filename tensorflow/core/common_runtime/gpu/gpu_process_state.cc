@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -84,6 +85,33 @@ static bool UseCudaMallocAsyncAllocator() {
 #endif
 }
 
+// NOLINTNEXTLINE(clang-diagnostic-unused-function)
+static bool UseDefragmentingAllocator() {
+  const char* allocator_env = std::getenv("TF_GPU_ALLOCATOR");
+  auto result = allocator_env != nullptr &&
+                std::strcmp(allocator_env, "defragmenting_bfc") == 0;
+#if defined(GOOGLE_CUDA) && CUDA_VERSION >= 10020
+  return result;
+#else
+  if (result)
+    LOG(ERROR) << "TF_GPU_ALLOCATOR=defragmenting_bfc environment found, "
+               << "but TensorFlow was not compiled with CUDA 10.2+.";
+  return false;
+#endif
+}
+
+// Tags the chunks with the ops that allocate them, see
+// tsl::BFCAllocator::Options::record_allocation_sites.
+static bool RecordAllocationSites() {
+  bool record_allocation_sites = false;
+  Status status = tsl::ReadBoolFromEnvVar("TF_GPU_BFC_RECORD_ALLOCATION_SITES",
+                                          false, &record_allocation_sites);
+  if (!status.ok()) {
+    LOG(ERROR) << "GetGPUAllocator: " << status.message();
+  }
+  return record_allocation_sites;
+}
+
 /*static*/ GPUProcessState* GPUProcessState::singleton(GPUProcessState* ps) {
   static GPUProcessState* instance = ps ? ps : new GPUProcessState;
   DCHECK((!ps) || (ps == instance))
@@ -116,6 +144,38 @@ static std::unique_ptr<SubAllocator> CreateSubAllocator(
                       se::GPUMachineManager(), platform_device_id)
                       .value();
 
+#if defined(GOOGLE_CUDA) && CUDA_VERSION >= 10020
+  // The BFC allocator releases the pages of its free chunks to defragment its
+  // memory, which are mapped again behind new virtual addresses.
+  if (UseDefragmentingAllocator() &&
+      options.per_process_gpu_memory_fraction() <= 1.0 &&
+      !options.experimental().use_unified_memory()) {
+    auto* gpu_context = reinterpret_cast<stream_executor::gpu::GpuContext*>(
+        executor->platform_specific_handle().context);
+    std::vector<tsl::PlatformDeviceId> platform_peer_gpu_ids;
+    platform_peer_gpu_ids.reserve(peer_gpu_ids.size());
+    for (const tsl::TfDeviceId peer_tf_device_id : peer_gpu_ids) {
+      tsl::PlatformDeviceId peer_platform_device_id;
+      TF_CHECK_OK(GpuIdManager::TfToPlatformDeviceId(
+          peer_tf_device_id, &peer_platform_device_id));
+      platform_peer_gpu_ids.push_back(peer_platform_device_id);
+    }
+    // The holes left by the released pages are re-used by the regions that
+    // fit, but leave room for the others.
+    auto allocator = GpuVirtualMemAllocator::Create(
+        alloc_visitors, {}, *gpu_context, platform_device_id,
+        /*virtual_address_space_size=*/total_bytes * 4, platform_peer_gpu_ids,
+        /*map_pages_individually=*/true);
+    if (allocator.ok()) {
+      LOG(INFO) << "Using defragmenting BFC allocator for GPU: "
+                << platform_device_id;
+      return std::move(allocator).value();
+    }
+    LOG(ERROR) << "Could not create the defragmenting BFC allocator for GPU "
+               << platform_device_id << ": " << allocator.status();
+  }
+#endif
+
   // FIXME(imintz): Observed OOM issues when using the virtual memory
   // allocators. This should be reenabled when resolved.
 #if 0 && defined(GOOGLE_CUDA) && CUDA_VERSION >= 10020
@@ -207,6 +267,8 @@ Allocator* GPUProcessState::GetGPUAllocator(
               !options.experimental().disallow_retry_on_allocation_failure();
           o.fragmentation_fraction =
               options.experimental().internal_fragmentation_fraction();
+          o.defragmentation = UseDefragmentingAllocator();
+          o.record_allocation_sites = RecordAllocationSites();
           return o;
         }());
     Allocator* gpu_allocator = gpu_bfc_allocator.get();
@@ -398,6 +460,14 @@ Allocator* GPUProcessState::GetGpuHostAllocator(const GPUOptions& options,
     tsl::BFCAllocator::Options allocator_opts;
     allocator_opts.allow_growth =
         !options.experimental().gpu_host_mem_disallow_growth();
+    int64_t thread_cache_bytes = 0;
+    Status status = tsl::ReadInt64FromEnvVar(
+        "TF_GPU_HOST_BFC_THREAD_CACHE_BYTES", 0, &thread_cache_bytes);
+    if (!status.ok()) {
+      LOG(ERROR) << "GetGpuHostAllocator: " << status.message();
+    }
+    allocator_opts.thread_cache_bytes =
+        std::max<int64_t>(thread_cache_bytes, 0);
     tsl::Allocator* allocator =
         new tsl::BFCAllocator(absl::WrapUnique(sub_allocator), mem_limit_bytes,
                               /*name=*/"gpu_host_bfc", allocator_opts);
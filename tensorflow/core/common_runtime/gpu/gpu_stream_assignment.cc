@@ -0,0 +1,66 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_assignment.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tensorflow/core/graph/algorithm.h"
+
+namespace tensorflow {
+
+GpuStreamAssignment AssignGpuStreams(const Graph& graph, int max_streams) {
+  max_streams = std::max(max_streams, 1);
+  GpuStreamAssignment assignment;
+  assignment.node_to_stream.assign(graph.num_node_ids(), -1);
+
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+
+  // Whether some consumer already continues on the stream of a node.
+  std::vector<bool> continued(graph.num_node_ids(), false);
+  std::vector<int> stream_sizes(max_streams, 0);
+  for (const Node* node : order) {
+    if (!node->IsOp()) continue;
+    int stream = -1;
+    for (const Edge* edge : node->in_edges()) {
+      const Node* src = edge->src();
+      if (!src->IsOp() || continued[src->id()]) continue;
+      continued[src->id()] = true;
+      stream = assignment.node_to_stream[src->id()];
+      break;
+    }
+    if (stream == -1) {
+      stream = std::min_element(stream_sizes.begin(), stream_sizes.end()) -
+               stream_sizes.begin();
+    }
+    assignment.node_to_stream[node->id()] = stream;
+    ++stream_sizes[stream];
+  }
+
+  assignment.num_streams_used =
+      std::count_if(stream_sizes.begin(), stream_sizes.end(),
+                    [](int size) { return size > 0; });
+  for (const Edge* edge : graph.edges()) {
+    if (!edge->src()->IsOp() || !edge->dst()->IsOp()) continue;
+    if (assignment.node_to_stream[edge->src()->id()] !=
+        assignment.node_to_stream[edge->dst()->id()]) {
+      ++assignment.num_cross_stream_edges;
+    }
+  }
+  return assignment;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,51 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ASSIGNMENT_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ASSIGNMENT_H_
+
+#include <vector>
+
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+// Assignment of the op nodes of a graph to GPU compute streams.
+struct GpuStreamAssignment {
+  // Compute stream of each node, indexed by Node::id(). -1 for nodes that are
+  // not ops (e.g. _SOURCE and _SINK).
+  std::vector<int> node_to_stream;
+
+  // Number of distinct streams that have at least one node assigned.
+  int num_streams_used = 0;
+
+  // Number of data and control edges whose endpoints are on different
+  // streams. Each of them requires the consumer stream to wait on an event
+  // recorded on the producer stream.
+  int num_cross_stream_edges = 0;
+};
+
+// Assigns the op nodes of `graph` to at most `max_streams` compute streams so
+// that independent chains of ops can run concurrently.
+//
+// Nodes are visited in reverse post order. A node continues on the stream of
+// the first of its producers that no other consumer has continued yet, so
+// that linear chains stay on one stream and need no events. Otherwise, e.g.
+// for the second consumer of a fan-out or for a node without producers, it
+// starts on the stream with the fewest nodes so far.
+GpuStreamAssignment AssignGpuStreams(const Graph& graph, int max_streams);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ASSIGNMENT_H_
@@ -0,0 +1,80 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_assignment.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+Node* Const(Graph* g) {
+  return test::graph::Constant(g, Tensor(DT_FLOAT, TensorShape({})));
+}
+
+TEST(GpuStreamAssignmentTest, IndependentChainsUseSeparateStreams) {
+  Graph g(OpRegistry::Global());
+  Node* a0 = test::graph::Identity(&g, Const(&g));
+  Node* a1 = test::graph::Identity(&g, a0);
+  Node* b0 = test::graph::Identity(&g, Const(&g));
+  Node* b1 = test::graph::Identity(&g, b0);
+
+  GpuStreamAssignment assignment = AssignGpuStreams(g, /*max_streams=*/4);
+  EXPECT_EQ(assignment.num_streams_used, 2);
+  EXPECT_EQ(assignment.num_cross_stream_edges, 0);
+  EXPECT_EQ(assignment.node_to_stream[a0->id()],
+            assignment.node_to_stream[a1->id()]);
+  EXPECT_EQ(assignment.node_to_stream[b0->id()],
+            assignment.node_to_stream[b1->id()]);
+  EXPECT_NE(assignment.node_to_stream[a1->id()],
+            assignment.node_to_stream[b1->id()]);
+  EXPECT_EQ(assignment.node_to_stream[g.source_node()->id()], -1);
+}
+
+TEST(GpuStreamAssignmentTest, FanOutAndJoinNeedEvents) {
+  Graph g(OpRegistry::Global());
+  Node* x = Const(&g);
+  Node* left = test::graph::Identity(&g, x);
+  Node* right = test::graph::Identity(&g, x);
+  Node* sum = test::graph::Add(&g, left, right);
+
+  GpuStreamAssignment assignment = AssignGpuStreams(g, /*max_streams=*/4);
+  EXPECT_EQ(assignment.num_streams_used, 2);
+  EXPECT_NE(assignment.node_to_stream[left->id()],
+            assignment.node_to_stream[right->id()]);
+  // One edge from `x` into the second branch, one from the second branch into
+  // the join.
+  EXPECT_EQ(assignment.num_cross_stream_edges, 2);
+  const int sum_stream = assignment.node_to_stream[sum->id()];
+  EXPECT_TRUE(sum_stream == assignment.node_to_stream[left->id()] ||
+              sum_stream == assignment.node_to_stream[right->id()]);
+}
+
+TEST(GpuStreamAssignmentTest, SingleStream) {
+  Graph g(OpRegistry::Global());
+  Node* x = Const(&g);
+  test::graph::Add(&g, test::graph::Identity(&g, x),
+                   test::graph::Identity(&g, Const(&g)));
+
+  GpuStreamAssignment assignment = AssignGpuStreams(g, /*max_streams=*/1);
+  EXPECT_EQ(assignment.num_streams_used, 1);
+  EXPECT_EQ(assignment.num_cross_stream_edges, 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_util.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 
 #include "tensorflow/core/common_runtime/copy_tensor.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/common_runtime/gpu_device_context.h"
 #include "tensorflow/core/framework/log_memory.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_reference.h"
@@ -34,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/tensor_coding.h"
@@ -59,6 +62,20 @@ extern bool FLAGS_brain_gpu_record_mem_types;
 
 namespace tensorflow {
 
+// One in kTransferSamplingPeriod host-device copies is timed for the transfer
+// bandwidth metric.
+constexpr int kTransferSamplingPeriod = 16;
+
+// Returns the current time if the copy of `total_bytes` should be timed, and 0
+// otherwise.
+static uint64 SampledTransferStartMicros(int64_t total_bytes) {
+  static std::atomic<uint64> num_transfers{0};
+  if (total_bytes == 0) return 0;
+  const uint64 index = num_transfers.fetch_add(1, std::memory_order_relaxed);
+  if (index % kTransferSamplingPeriod != 0) return 0;
+  return Env::Default()->NowMicros();
+}
+
 using se::DeviceMemoryBase;
 using se::Stream;
 
@@ -303,15 +320,22 @@ void GPUUtil::CopyGPUTensorToCPU(Device* gpu_device,
     DeviceMemoryBase gpu_src_ptr(src_ptr, total_bytes);
     void* dst_ptr = GetBase(cpu_tensor);
     send_device_to_host_stream->ThenMemcpy(dst_ptr, gpu_src_ptr, total_bytes);
+    metrics::RecordDeviceTransferBytes(/*host_to_device=*/false, total_bytes);
   }
+  const uint64 start_us = SampledTransferStartMicros(total_bytes);
   // Use of the input may outlive stack scope, so keep a ref.
   TensorReference input_ref(*gpu_tensor);
   dev_info->event_mgr->ThenExecute(
       send_device_to_host_stream,
-      [send_device_to_host_stream, done, input_ref]() {
+      [send_device_to_host_stream, done, input_ref, total_bytes, start_us]() {
         if (!send_device_to_host_stream->ok()) {
           LOG(FATAL) << "GPU->CPU Memcpy failed";
         }
+        if (start_us > 0) {
+          metrics::RecordDeviceTransferDuration(
+              /*host_to_device=*/false, total_bytes,
+              Env::Default()->NowMicros() - start_us);
+        }
         input_ref.Unref();
         done(OkStatus());
       });
@@ -381,12 +405,14 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
       recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, src_ptr,
                                              total_bytes);
     }
+    metrics::RecordDeviceTransferBytes(/*host_to_device=*/true, total_bytes);
   }
+  const uint64 start_us = SampledTransferStartMicros(total_bytes);
 
   dev_info->event_mgr->ThenExecute(
       recv_host_to_device_stream,
       [recv_host_to_device_stream, done, input_ref, do_staging, staging_buffer,
-       host_memory_allocator]() {
+       host_memory_allocator, total_bytes, start_us]() {
         if (do_staging) {
           host_memory_allocator->DeallocateRaw(staging_buffer);
         } else {
@@ -395,6 +421,11 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
         if (!recv_host_to_device_stream->ok()) {
           LOG(FATAL) << "CPU->GPU Memcpy failed";
         }
+        if (start_us > 0) {
+          metrics::RecordDeviceTransferDuration(
+              /*host_to_device=*/true, total_bytes,
+              Env::Default()->NowMicros() - start_us);
+        }
         done(OkStatus());
       });
 }
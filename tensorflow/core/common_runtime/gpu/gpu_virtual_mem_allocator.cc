@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_virtual_mem_allocator.h"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
 #include "absl/strings/str_format.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "tsl/platform/numbers.h"
@@ -63,7 +68,8 @@ GpuVirtualMemAllocator::Create(
     const std::vector<Visitor>& alloc_visitors,
     const std::vector<Visitor>& free_visitors, GpuContext& gpu_context,
     tsl::PlatformDeviceId gpu_id, size_t virtual_address_space_size,
-    const std::vector<tsl::PlatformDeviceId>& peer_gpu_ids) {
+    const std::vector<tsl::PlatformDeviceId>& peer_gpu_ids,
+    bool map_pages_individually) {
   tsl::profiler::TraceMe traceme("GpuVirtualMemAllocator::Create");
 
   std::vector<GpuDeviceHandle> access_gpu_handles;
@@ -107,7 +113,8 @@ GpuVirtualMemAllocator::Create(
 
   return std::unique_ptr<GpuVirtualMemAllocator>(new GpuVirtualMemAllocator(
       alloc_visitors, free_visitors, gpu_context, gpu_id,
-      std::move(access_gpu_handles), vmem, max_granularity));
+      std::move(access_gpu_handles), vmem, max_granularity,
+      map_pages_individually));
 }
 
 GpuVirtualMemAllocator::GpuVirtualMemAllocator(
@@ -115,13 +122,14 @@ GpuVirtualMemAllocator::GpuVirtualMemAllocator(
     const std::vector<Visitor>& free_visitors, GpuContext& gpu_context,
     tsl::PlatformDeviceId gpu_id,
     const std::vector<GpuDeviceHandle> access_gpu_handles,
-    GpuDriver::VmemSpan vmem, size_t granularity)
+    GpuDriver::VmemSpan vmem, size_t granularity, bool map_pages_individually)
     : SubAllocator(alloc_visitors, free_visitors),
       gpu_context_(gpu_context),
       gpu_id_(gpu_id),
       access_gpu_handles_(access_gpu_handles),
       vmem_(vmem),
-      granularity_(granularity) {}
+      granularity_(granularity),
+      map_pages_individually_(map_pages_individually) {}
 
 GpuVirtualMemAllocator::~GpuVirtualMemAllocator() {
   for (const auto mapping : mappings_) {
@@ -138,7 +146,8 @@ void* GpuVirtualMemAllocator::Alloc(size_t alignment, size_t num_bytes,
   if (num_bytes == 0) return nullptr;
   size_t padded_bytes = (num_bytes + granularity_ - 1) & ~(granularity_ - 1);
 
-  GpuDevicePtr next_va = vmem_.base + next_alloc_offset_;
+  const size_t offset = FindFreeOffset(padded_bytes);
+  GpuDevicePtr next_va = vmem_.base + offset;
 
   // TODO(imintz): Attempt to extend the vmem allocation by reserving additional
   // virtual memory at the specific address at the end of the initial vmem
@@ -151,25 +160,41 @@ void* GpuVirtualMemAllocator::Alloc(size_t alignment, size_t num_bytes,
     return nullptr;
   }
 
-  // Create physical memory backing allocation.
-  auto maybe_handle =
-      GpuDriver::CreateMemoryHandle(&gpu_context_, padded_bytes);
-  if (!maybe_handle.ok()) {
-    LOG(ERROR) << maybe_handle.status();
-    return nullptr;
-  }
-  GpuDriver::GenericMemoryHandle handle = std::move(maybe_handle).value();
-
-  // Map VAs for this physical memory.
-  auto status =
-      GpuDriver::MapMemory(&gpu_context_, next_va, handle, access_gpu_handles_);
-  if (!status.ok()) {
-    LOG(ERROR) << status;
-    GpuDriver::ReleaseMemoryHandle(&gpu_context_, std::move(handle));
-    return nullptr;
+  // Create physical memory backing allocation, and map VAs for it. Each page
+  // gets its own physical memory if the pages are mapped individually.
+  const size_t handle_bytes =
+      map_pages_individually_ ? granularity_ : padded_bytes;
+  std::vector<Mapping> new_mappings;
+  new_mappings.reserve(padded_bytes / handle_bytes);
+  for (size_t mapped_bytes = 0; mapped_bytes < padded_bytes;
+       mapped_bytes += handle_bytes) {
+    auto maybe_handle =
+        GpuDriver::CreateMemoryHandle(&gpu_context_, handle_bytes);
+    if (!maybe_handle.ok()) {
+      LOG(ERROR) << maybe_handle.status();
+      UnmapAndRelease(new_mappings);
+      return nullptr;
+    }
+    GpuDriver::GenericMemoryHandle handle = std::move(maybe_handle).value();
+
+    auto status = GpuDriver::MapMemory(&gpu_context_, next_va + mapped_bytes,
+                                       handle, access_gpu_handles_);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+      GpuDriver::ReleaseMemoryHandle(&gpu_context_, std::move(handle));
+      UnmapAndRelease(new_mappings);
+      return nullptr;
+    }
+    new_mappings.push_back({next_va + mapped_bytes, std::move(handle)});
   }
-  next_alloc_offset_ += handle.bytes;
-  mappings_.push_back({next_va, std::move(handle)});
+  next_alloc_offset_ = std::max(next_alloc_offset_, offset + padded_bytes);
+
+  // Keep the mappings sorted by va.
+  auto insert_it = std::lower_bound(
+      mappings_.begin(), mappings_.end(), next_va,
+      [](const Mapping& mapping, GpuDevicePtr va) { return mapping.va < va; });
+  mappings_.insert(insert_it, std::make_move_iterator(new_mappings.begin()),
+                   std::make_move_iterator(new_mappings.end()));
   VisitAlloc(reinterpret_cast<void*>(next_va), gpu_id_.value(), padded_bytes);
   *bytes_received = padded_bytes;
   return reinterpret_cast<void*>(next_va);
@@ -193,7 +218,7 @@ void GpuVirtualMemAllocator::Free(void* ptr, size_t num_bytes) {
   }
 
   int num_mappings_to_free = 0;
-  int total_bytes = 0;
+  size_t total_bytes = 0;
   for (auto it = mapping_it; it != mappings_.end() && total_bytes < num_bytes;
        ++it) {
     ++num_mappings_to_free;
@@ -210,20 +235,58 @@ void GpuVirtualMemAllocator::Free(void* ptr, size_t num_bytes) {
 
   VLOG(1) << "Freeing " << num_mappings_to_free << " mappings for a total of "
           << total_bytes << " bytes";
-  for (auto it = mapping_it; it < mapping_it + num_mappings_to_free; ++it) {
-    GpuDriver::UnmapMemory(&gpu_context_, it->va, it->physical.bytes);
-    GpuDriver::ReleaseMemoryHandle(&gpu_context_, std::move(it->physical));
+  // Kernels enqueued before the memory was freed by the BFC allocator may
+  // still use it.
+  if (!GpuDriver::SynchronizeContext(&gpu_context_)) {
+    LOG(ERROR) << "Could not synchronize GPU " << gpu_id_.value()
+               << " before freeing GPU vmem mappings.";
   }
+  std::vector<Mapping> freed_mappings(
+      std::make_move_iterator(mapping_it),
+      std::make_move_iterator(mapping_it + num_mappings_to_free));
+  UnmapAndRelease(freed_mappings);
+  const bool freed_at_end =
+      mapping_it + num_mappings_to_free == mappings_.end();
+  mappings_.erase(mapping_it, mapping_it + num_mappings_to_free);
 
   // Move back the next_alloc_offset_ if this free was at the end.
-  if (mapping_it + num_mappings_to_free == mappings_.end()) {
-    next_alloc_offset_ = mapping_it->va - vmem_.base;
+  if (freed_at_end) {
+    next_alloc_offset_ =
+        mappings_.empty()
+            ? 0
+            : mappings_.back().va + mappings_.back().physical.bytes -
+                  vmem_.base;
   }
-
-  mappings_.erase(mapping_it, mapping_it + num_mappings_to_free);
   VisitFree(ptr, gpu_id_.value(), num_bytes);
 }
 
+size_t GpuVirtualMemAllocator::ReleaseGranularity() const {
+  // The BFC allocator releases pages aligned to the granularity, which must
+  // be those of the mappings.
+  if (!map_pages_individually_ || vmem_.base % granularity_ != 0) return 0;
+  return granularity_;
+}
+
+size_t GpuVirtualMemAllocator::FindFreeOffset(size_t num_bytes) const {
+  if (map_pages_individually_) {
+    GpuDevicePtr hole_begin = vmem_.base;
+    for (const Mapping& mapping : mappings_) {
+      if (mapping.va - hole_begin >= num_bytes) {
+        return hole_begin - vmem_.base;
+      }
+      hole_begin = mapping.va + mapping.physical.bytes;
+    }
+  }
+  return next_alloc_offset_;
+}
+
+void GpuVirtualMemAllocator::UnmapAndRelease(std::vector<Mapping>& mappings) {
+  for (Mapping& mapping : mappings) {
+    GpuDriver::UnmapMemory(&gpu_context_, mapping.va, mapping.physical.bytes);
+    GpuDriver::ReleaseMemoryHandle(&gpu_context_, std::move(mapping.physical));
+  }
+}
+
 }  // namespace tensorflow
 
 #endif
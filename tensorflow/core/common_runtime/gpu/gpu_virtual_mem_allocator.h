@@ -47,7 +47,8 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
       const std::vector<Visitor>& free_visitors,
       stream_executor::gpu::GpuContext& gpu_context,
       tsl::PlatformDeviceId gpu_id, size_t virtual_address_space_size,
-      const std::vector<tsl::PlatformDeviceId>& peer_gpu_ids);
+      const std::vector<tsl::PlatformDeviceId>& peer_gpu_ids,
+      bool map_pages_individually = false);
   ~GpuVirtualMemAllocator() override;
 
   // Allocates memory at least as large as requested by num_bytes. Will be
@@ -67,10 +68,17 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
   //
   // In practice, since the BFC allocator coalesces adjacent AllocationRegions,
   // this free function should never be invoked.
+  //
+  // If the pages are mapped individually, any range of pages can be freed, and
+  // the holes are re-used by the allocations that fit, first fit. The BFC
+  // allocator then frees the pages of its free chunks to defragment its
+  // memory, see BFCAllocator::Options::defragmentation.
   void Free(void* ptr, size_t num_bytes) override;
 
   bool SupportsCoalescing() const override { return true; }
 
+  size_t ReleaseGranularity() const override;
+
  private:
   GpuVirtualMemAllocator(
       const std::vector<Visitor>& alloc_visitors,
@@ -78,7 +86,12 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
       stream_executor::gpu::GpuContext& gpu_context,
       tsl::PlatformDeviceId gpu_id,
       std::vector<stream_executor::gpu::GpuDeviceHandle> access_device_handles,
-      stream_executor::gpu::GpuDriver::VmemSpan vmem, size_t granularity);
+      stream_executor::gpu::GpuDriver::VmemSpan vmem, size_t granularity,
+      bool map_pages_individually);
+
+  // Returns the offset from the vmem base address of the first hole of at
+  // least num_bytes, or of the end of the allocations.
+  size_t FindFreeOffset(size_t num_bytes) const;
 
   stream_executor::gpu::GpuContext& gpu_context_;
   tsl::PlatformDeviceId gpu_id_;
@@ -99,6 +112,10 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
   // Smallest allocation as determined by CUDA.
   const size_t granularity_;
 
+  // Whether each page of granularity_ bytes has its own physical memory, so
+  // that it can be unmapped on its own.
+  const bool map_pages_individually_;
+
   struct Mapping {
     stream_executor::gpu::GpuDevicePtr va;
     stream_executor::gpu::GpuDriver::GenericMemoryHandle physical;
@@ -106,6 +123,9 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
   // List of mappings, sorted by va.
   std::vector<Mapping> mappings_;
 
+  // Unmaps the mappings and releases their physical memory.
+  void UnmapAndRelease(std::vector<Mapping>& mappings);
+
   GpuVirtualMemAllocator(const GpuVirtualMemAllocator&) = delete;
   void operator=(const GpuVirtualMemAllocator&) = delete;
 };
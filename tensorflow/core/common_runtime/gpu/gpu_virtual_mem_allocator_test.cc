@@ -34,7 +34,8 @@ using ::stream_executor::gpu::GpuDriver;
 constexpr size_t k2MiB{2 << 20};
 
 // Creates an allocator with 8 MiB of virtual address space.
-std::unique_ptr<GpuVirtualMemAllocator> CreateAllocator() {
+std::unique_ptr<GpuVirtualMemAllocator> CreateAllocator(
+    bool map_pages_individually = false) {
   tsl::PlatformDeviceId gpu_id(0);
   auto executor = se::DeviceIdUtil::ExecutorForPlatformDeviceId(
                       se::GPUMachineManager(), gpu_id)
@@ -43,7 +44,8 @@ std::unique_ptr<GpuVirtualMemAllocator> CreateAllocator() {
       executor->platform_specific_handle().context);
   return GpuVirtualMemAllocator::Create(
              {}, {}, *gpu_context, gpu_id,
-             /*virtual_address_space_size=*/4 * k2MiB, {})
+             /*virtual_address_space_size=*/4 * k2MiB, {},
+             map_pages_individually)
       .value();
 }
 
@@ -179,6 +181,38 @@ TEST(GpuVirtualMemAllocatorTest, FreeRange) {
   ASSERT_EQ(re_alloc, first_alloc);
 }
 
+TEST(GpuVirtualMemAllocatorTest, FreePagesOfAllocation) {
+  auto allocator = CreateAllocator(/*map_pages_individually=*/true);
+  EXPECT_EQ(allocator->ReleaseGranularity(), k2MiB);
+  size_t bytes_received;  // Ignored in this test.
+  void* first_alloc = allocator->Alloc(
+      /*alignment=*/0, /*num_bytes=*/3 * k2MiB, &bytes_received);
+  ASSERT_NE(first_alloc, nullptr);
+
+  void* middle = reinterpret_cast<char*>(first_alloc) + k2MiB;
+  allocator->Free(middle, k2MiB);
+
+  // Too large for the hole.
+  void* over_alloc = allocator->Alloc(
+      /*alignment=*/0, /*num_bytes=*/2 * k2MiB, &bytes_received);
+  ASSERT_EQ(over_alloc, nullptr);
+
+  // The hole is re-used.
+  void* re_alloc =
+      allocator->Alloc(/*alignment=*/0, /*num_bytes=*/k2MiB, &bytes_received);
+  ASSERT_EQ(re_alloc, middle);
+
+  allocator->Free(first_alloc, 3 * k2MiB);
+  void* second_alloc = allocator->Alloc(
+      /*alignment=*/0, /*num_bytes=*/4 * k2MiB, &bytes_received);
+  ASSERT_EQ(second_alloc, first_alloc);
+}
+
+TEST(GpuVirtualMemAllocatorTest, PagesNotReleasableByDefault) {
+  auto allocator = CreateAllocator();
+  EXPECT_EQ(allocator->ReleaseGranularity(), 0);
+}
+
 }  // namespace
 }  // namespace tensorflow
 
@@ -63,6 +63,10 @@ namespace {
 // can skip expensive duplicates check in 'AddControlEdge'.
 static constexpr const bool kDoNotCheckDuplicates = true;
 
+// Graphs with fewer nodes than this are always prepared sequentially in
+// Convert(), since scheduling the work would cost more than it saves.
+static constexpr const int64_t kMinNodesForParallelPrepare = 1024;
+
 inline bool IsMerge(const NodeDef& node_def) {
   return node_def.op() == "Merge" || node_def.op() == "RefMerge" ||
          node_def.op() == "_XlaMerge";
@@ -107,7 +111,8 @@ class GraphConstructor {
           importing(false),
           validate_nodes(in.validate_nodes),
           validate_colocation_constraints(false),
-          add_default_attributes(in.add_default_attributes) {}
+          add_default_attributes(in.add_default_attributes),
+          thread_pool(in.thread_pool) {}
     Options(const ImportGraphDefOptions& in)  // NOLINT(runtime/explicit)
         : allow_internal_ops(false),
           expect_device_spec(false),
@@ -162,6 +167,9 @@ class GraphConstructor {
     bool add_default_attributes = true;
 
     string default_device;
+
+    // Only used when not importing. Not owned.
+    thread::ThreadPool* thread_pool = nullptr;
   };
 
   typedef gtl::ArraySlice<const NodeDef*> NodeDefSlice;
@@ -202,6 +210,7 @@ class GraphConstructor {
     TF_RETURN_IF_ERROR(ValidateInputMapAndControlDependencies());
     TF_RETURN_IF_ERROR(BuildNodeIndex());
     TF_RETURN_IF_ERROR(InitFromEdges());
+    TF_RETURN_IF_ERROR(PrepareNodeDefs());
 
     // NOTE: Convert() invokes `consume_node_def()` on each node in the input
     // graph, so `get_node_def()` is no longer usable once it is called.
@@ -222,6 +231,10 @@ class GraphConstructor {
   Status ValidateInputMapAndControlDependencies();
   Status BuildNodeIndex();
   Status InitFromEdges();
+  // Adds default attributes to and validates every NodeDef on
+  // `opts_.thread_pool`, so that Convert() can skip both. Does nothing when
+  // importing, since the NodeDefs are then rewritten in topological order.
+  Status PrepareNodeDefs();
   Status Convert();
   Status AddBackEdges();
   Status UpdateVersionDef();
@@ -300,6 +313,11 @@ class GraphConstructor {
   // possible. After calling this method, the result of get_node_def(i) is
   // undefined.
   virtual NodeDef consume_node_def(int i) = 0;
+  // Makes mutable_node_def() usable. Called once before any call to it.
+  virtual void PrepareMutableNodeDefs() {}
+  // Returns the i^th node in the graph for in-place modification. Must be
+  // thread-safe for distinct `i`. Must not be called after consume_node_def(i).
+  virtual NodeDef* mutable_node_def(int i) = 0;
   // Returns the version information for the graph, or nullptr if none is
   // available.
   virtual const VersionDef* versions() const = 0;
@@ -406,6 +424,10 @@ class GraphConstructor {
   };
   std::vector<EdgeInfo> back_edges_;
 
+  // True if PrepareNodeDefs() already added default attributes to and
+  // validated all NodeDefs.
+  bool node_defs_prepared_ = false;
+
   GraphConstructor(const GraphConstructor&) = delete;
   void operator=(const GraphConstructor&) = delete;
 };
@@ -433,8 +455,21 @@ class NodeDefCopyingGraphConstructor : public GraphConstructor {
 
  private:
   size_t node_def_count() const override { return node_defs_.size(); }
-  const NodeDef& get_node_def(int i) const override { return *node_defs_[i]; }
-  NodeDef consume_node_def(int i) override { return *node_defs_[i]; }
+  const NodeDef& get_node_def(int i) const override {
+    if (!copies_.empty() && copies_[i].has_value()) return *copies_[i];
+    return *node_defs_[i];
+  }
+  NodeDef consume_node_def(int i) override {
+    if (!copies_.empty() && copies_[i].has_value()) {
+      return *std::move(copies_[i]);
+    }
+    return *node_defs_[i];
+  }
+  void PrepareMutableNodeDefs() override { copies_.resize(node_defs_.size()); }
+  NodeDef* mutable_node_def(int i) override {
+    if (!copies_[i].has_value()) copies_[i] = *node_defs_[i];
+    return &*copies_[i];
+  }
   const VersionDef* versions() const override { return versions_; }
   std::optional<FunctionDefLibrary> consume_library() override {
     if (library_ == nullptr) {
@@ -446,6 +481,9 @@ class NodeDefCopyingGraphConstructor : public GraphConstructor {
   const GraphDebugInfo* debug_info() const override { return debug_info_; }
 
   const NodeDefSlice node_defs_;
+  // Copies of `node_defs_` modified in place, only populated by
+  // mutable_node_def().
+  std::vector<std::optional<NodeDef>> copies_;
   const VersionDef* const versions_;
   const FunctionDefLibrary* const library_;
   const GraphDebugInfo* const debug_info_;
@@ -477,6 +515,9 @@ class NodeDefMovingGraphConstructor : public GraphConstructor {
     is_consumed_[i] = true;
     return std::move(*graph_def_.mutable_node(i));
   }
+  NodeDef* mutable_node_def(int i) override {
+    return graph_def_.mutable_node(i);
+  }
   const VersionDef* versions() const override { return &graph_def_.versions(); }
   std::optional<FunctionDefLibrary> consume_library() override {
     return std::move(*graph_def_.mutable_library());
@@ -1161,6 +1202,46 @@ GraphConstructor::CreateStackTracesForFunctionDefLibrary(
   }
 }
 
+Status GraphConstructor::PrepareNodeDefs() {
+  const int64_t num_nodes = node_def_count();
+  thread::ThreadPool* pool = opts_.thread_pool;
+  if (pool == nullptr || opts_.importing ||
+      num_nodes < kMinNodesForParallelPrepare) {
+    return OkStatus();
+  }
+  PrepareMutableNodeDefs();
+
+  const OpRegistryInterface* registry = g_->op_registry();
+  std::vector<Status> statuses(num_nodes);
+  // Most of the cost is in attr handling, so charge per node a rough estimate
+  // of its cycles.
+  const int64_t kCostPerNode = 10000;
+  pool->ParallelFor(num_nodes, kCostPerNode, [&](int64_t begin, int64_t end) {
+    // Graphs use few distinct op types, so each shard memoizes its op lookups
+    // instead of hitting the registry lock for every node.
+    absl::flat_hash_map<std::string, const OpDef*> op_defs;
+    for (int64_t i = begin; i < end; ++i) {
+      NodeDef* node_def = mutable_node_def(i);
+      const OpDef*& op_def = op_defs[node_def->op()];
+      if (op_def == nullptr) {
+        statuses[i] = registry->LookUpOpDef(node_def->op(), &op_def);
+        if (!statuses[i].ok()) continue;
+      }
+      if (opts_.add_default_attributes) {
+        AddDefaultsToNodeDef(*op_def, node_def);
+      }
+      if (opts_.validate_nodes) {
+        statuses[i] = ValidateNodeDef(*node_def, *op_def);
+      }
+    }
+  });
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  node_defs_prepared_ = true;
+  return OkStatus();
+}
+
 Status GraphConstructor::Convert() {
   if (debug_info() != nullptr) {
     traces_ = LoadTracesFromDebugInfo(*debug_info());
@@ -1297,7 +1378,7 @@ Status GraphConstructor::Convert() {
 
     if (opts_.importing) {
       TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&node_def));
-    } else {
+    } else if (!node_defs_prepared_) {
       const OpDef* op_def;
       TF_RETURN_IF_ERROR(
           g_->op_registry()->LookUpOpDef(node_def.op(), &op_def));
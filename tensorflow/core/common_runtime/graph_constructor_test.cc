@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
@@ -916,6 +917,51 @@ TEST_F(GraphConstructorTest, SimpleModelWithControlEdges) {
   EXPECT_TRUE(HasControlEdge("t1", "t2"));
 }
 
+TEST_F(GraphConstructorTest, ParallelPrepareAddsDefaultAttrs) {
+  // Large enough for the NodeDefs to be prepared on the thread pool.
+  GraphDef def;
+  for (int i = 0; i < 2048; ++i) {
+    NodeDef* node = def.add_node();
+    node->set_name(strings::StrCat("n", i));
+    node->set_op("TestDefaultAttr");
+  }
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+  opts.thread_pool = &pool;
+
+  // Both the copying and the moving variants prepare the NodeDefs.
+  Graph moved_graph(OpRegistry::Global());
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, def, &graph_));
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, GraphDef(def), &moved_graph));
+  for (const Graph* g : {&graph_, &moved_graph}) {
+    EXPECT_EQ(g->num_op_nodes(), 2048);
+    for (const Node* node : g->op_nodes()) {
+      int64_t value;
+      TF_ASSERT_OK(GetNodeAttr(node->attrs(), "default_int", &value));
+      EXPECT_EQ(value, 31415);
+    }
+  }
+}
+
+TEST_F(GraphConstructorTest, ParallelPrepareReportsInvalidNode) {
+  GraphDef def;
+  for (int i = 0; i < 2048; ++i) {
+    NodeDef* node = def.add_node();
+    node->set_name(strings::StrCat("n", i));
+    node->set_op(i == 1000 ? "DoesNotExist" : "TestParams");
+  }
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  GraphConstructorOptions opts;
+  opts.thread_pool = &pool;
+
+  Status status = ConvertGraphDefToGraph(opts, def, &graph_);
+  EXPECT_TRUE(absl::StrContains(status.message(),
+                                "Op type not registered 'DoesNotExist'"))
+      << status;
+  EXPECT_EQ(graph_.num_op_nodes(), 0);
+}
+
 TEST_F(GraphConstructorTest, Error_ControlEdgeBeforeRealInput) {
   ExpectError(
       "node { name: 'W1' op: 'TestParams' }"
@@ -0,0 +1,229 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_reducer.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns the rank of the member "rank" among the members of its task.
+int RankInTask(const CollGroupParams& group, int rank) {
+  int rank_in_task = 0;
+  for (int i = 0; i < rank; ++i) {
+    if (group.members[i].task == group.members[rank].task) ++rank_in_task;
+  }
+  return rank_in_task;
+}
+
+}  // namespace
+
+Status HierarchicalReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  if (col_params->instance.type != REDUCTION_COLLECTIVE ||
+      col_params->instance.impl_details.collective_name !=
+          "HierarchicalReduce") {
+    return errors::Internal("HierarchicalReducer cannot run ",
+                            col_params->instance.impl_details.collective_name);
+  }
+  int dev_per_task = -1;
+  for (const auto& task_devs : col_params->group.num_devices_per_task) {
+    if (dev_per_task != -1 && task_devs.second != dev_per_task) {
+      return errors::Internal(
+          "HierarchicalReduce requires the same number of devices on every "
+          "task but group ",
+          col_params->group.group_key, " has ", dev_per_task, " and ",
+          task_devs.second);
+    }
+    dev_per_task = task_devs.second;
+  }
+  return OkStatus();
+}
+
+Status HierarchicalReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  DCHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void HierarchicalReducer::Run(StatusCallback done) {
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  core::RefCountPtr<CollectiveParams> local_params = LocalParams();
+  done(RunStep(local_params.get(), strings::StrCat(col_ctx_->exec_key, ":l"),
+               col_ctx_->input, col_ctx_->output,
+               [this](const std::vector<Tensor*>& chunks) {
+                 return ReduceAcrossTasks(chunks);
+               }));
+}
+
+core::RefCountPtr<CollectiveParams> HierarchicalReducer::LocalParams() const {
+  core::RefCountPtr<CollectiveParams> params(new CollectiveParams());
+  const CollGroupParams& group = col_params_->group;
+  const string& task = group.members[col_params_->default_rank].task;
+  params->name = col_params_->name;
+  params->group.group_key = group.group_key;
+  params->group.device_type = group.device_type;
+  for (int i = 0; i < group.group_size; ++i) {
+    if (group.members[i].task != task) continue;
+    if (i == col_params_->default_rank) {
+      params->default_rank = params->group.members.size();
+    }
+    params->group.members.push_back(group.members[i]);
+  }
+  params->group.group_size = params->group.members.size();
+  params->group.num_tasks = 1;
+  params->group.num_devices_per_task[task] = params->group.group_size;
+  params->group.same_num_devices_per_task = true;
+
+  params->instance.instance_key = col_params_->instance.instance_key;
+  params->instance.step_id = col_params_->instance.step_id;
+  params->instance.type = REDUCTION_COLLECTIVE;
+  params->instance.data_type = col_params_->instance.data_type;
+  params->instance.shape = col_params_->instance.shape;
+  // The chunk reduced by this device must be at the same place on every
+  // task, so the local ring has a single subdivision and segment.  Its
+  // transfers are local copies, which gain little from either.
+  params->instance.impl_details.collective_name = "RingReduce";
+  params->instance.impl_details.subdiv_offsets = {0};
+  params->instance.impl_details.ring_segments = 1;
+  params->merge_op = col_params_->merge_op;
+  // The final op is applied by ReduceAcrossTasks, with the size of the
+  // whole group.
+  params->final_op = nullptr;
+  return params;
+}
+
+core::RefCountPtr<CollectiveParams> HierarchicalReducer::CrossTaskParams(
+    const Tensor& chunk) const {
+  core::RefCountPtr<CollectiveParams> params(new CollectiveParams());
+  const CollGroupParams& group = col_params_->group;
+  const int rank_in_task = RankInTask(group, col_params_->default_rank);
+  params->name = col_params_->name;
+  params->group.group_key = group.group_key;
+  params->group.device_type = group.device_type;
+  std::unordered_map<string, int> num_seen;
+  for (int i = 0; i < group.group_size; ++i) {
+    const CollGroupMember& member = group.members[i];
+    if (num_seen[member.task]++ != rank_in_task) continue;
+    if (i == col_params_->default_rank) {
+      params->default_rank = params->group.members.size();
+    }
+    params->group.members.push_back(member);
+    params->group.num_devices_per_task[member.task] = 1;
+  }
+  params->group.group_size = params->group.members.size();
+  params->group.num_tasks = params->group.group_size;
+  params->group.same_num_devices_per_task = true;
+
+  params->instance.instance_key = col_params_->instance.instance_key;
+  params->instance.step_id = col_params_->instance.step_id;
+  params->instance.type = REDUCTION_COLLECTIVE;
+  params->instance.data_type = col_params_->instance.data_type;
+  params->instance.shape = chunk.shape();
+  params->instance.impl_details.collective_name = "RingReduce";
+  params->instance.impl_details.max_subdivs_per_device =
+      col_params_->instance.impl_details.max_subdivs_per_device;
+  params->merge_op = col_params_->merge_op;
+  params->final_op = nullptr;
+  return params;
+}
+
+Status HierarchicalReducer::ReduceAcrossTasks(
+    const std::vector<Tensor*>& chunks) {
+  for (int i = 0; i < chunks.size(); ++i) {
+    core::RefCountPtr<CollectiveParams> params = CrossTaskParams(*chunks[i]);
+    TF_RETURN_IF_ERROR(
+        RunStep(params.get(), strings::StrCat(col_ctx_->exec_key, ":x", i),
+                chunks[i], chunks[i], nullptr));
+  }
+  if (col_params_->final_op == nullptr || chunks.empty()) return OkStatus();
+
+  Tensor tmp(*chunks[0]);
+  std::unique_ptr<CollectiveAdapter> ca(
+      MakeCollectiveAdapter(&tmp, 1, nullptr));
+  Tensor group_size = ca->Scalar(col_params_->group.group_size);
+  if (col_params_->group.device_type != DEVICE_CPU) {
+    Tensor host_group_size = group_size;
+    group_size = ca->Scalar(
+        col_ctx_->device->GetAllocator(col_ctx_->op_ctx->input_alloc_attr(0)),
+        AllocationAttributes());
+    Notification note;
+    Status status;
+    col_ctx_->op_ctx->op_device_context()->CopyCPUTensorToDevice(
+        &host_group_size, col_ctx_->device, &group_size,
+        [&note, &status](const Status& s) {
+          status = s;
+          note.Notify();
+        });
+    note.WaitForNotification();
+    TF_RETURN_IF_ERROR(status);
+  }
+  for (Tensor* chunk : chunks) {
+    TF_RETURN_IF_ERROR(collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->final_op, chunk, &group_size));
+  }
+  return OkStatus();
+}
+
+Status HierarchicalReducer::RunStep(
+    CollectiveParams* params, const string& exec_key, const Tensor* input,
+    Tensor* output, RingReducer::BetweenPassesFn between_passes) {
+  profiler::TraceMe activity(
+      [&] { return strings::StrCat("HierarchicalReduce:", exec_key); },
+      profiler::TraceMeLevel::kInfo);
+  core::RefCountPtr<RingReducer> reducer(
+      new RingReducer(std::move(between_passes)));
+  TF_RETURN_IF_ERROR(reducer->InitializeCollectiveParams(params));
+  auto col_ctx = std::make_shared<CollectiveContext>(
+      col_ctx_->col_exec, col_ctx_->nccl_communicator, col_ctx_->dev_mgr,
+      col_ctx_->op_ctx, col_ctx_->op_params, params, exec_key,
+      col_ctx_->step_id, input, output);
+  TF_RETURN_IF_ERROR(reducer->InitializeCollectiveContext(col_ctx));
+  Notification note;
+  Status status;
+  reducer->Run([&note, &status](const Status& s) {
+    status = s;
+    note.Notify();
+  });
+  note.WaitForNotification();
+  return status;
+}
+
+namespace {
+REGISTER_COLLECTIVE(HierarchicalReduce, HierarchicalReducer);
+}  // namespace
+
+}  // namespace tensorflow
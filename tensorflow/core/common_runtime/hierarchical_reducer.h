@@ -0,0 +1,76 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/common_runtime/ring_reducer.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+
+// Hierarchical implementation of collective all-reduce, for groups spanning
+// several tasks with the same number of devices each.  The devices of each
+// task first reduce-scatter the tensor over a task-local ring, so that each
+// holds the sum over its task of one shard.  Each then all-reduces its shard
+// over a ring of the devices holding the same shard on the other tasks, and
+// finally the devices of each task all-gather the shards over the local
+// ring.  Only shards cross task boundaries, and each one crosses num_tasks
+// rather than group_size links.
+class HierarchicalReducer : public CollectiveImplementationInterface {
+ public:
+  HierarchicalReducer() = default;
+  ~HierarchicalReducer() override = default;
+
+  // Checks that every task has the same number of devices.  The rings of
+  // the steps are set up by Run.
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Runs the steps of the reduction one after another.
+  // Must be called in a blockable thread.
+  void Run(StatusCallback done) override;
+
+ private:
+  // Returns the params of the ring among the devices of this task.
+  core::RefCountPtr<CollectiveParams> LocalParams() const;
+
+  // Returns the params of the ring among the devices with the same rank in
+  // their task as this one, which reduce "chunk".
+  core::RefCountPtr<CollectiveParams> CrossTaskParams(
+      const Tensor& chunk) const;
+
+  // All-reduces "chunks" with the other tasks, and applies the final op.
+  Status ReduceAcrossTasks(const std::vector<Tensor*>& chunks);
+
+  // Runs a RingReducer step with "params" from "input" into "output".
+  Status RunStep(CollectiveParams* params, const string& exec_key,
+                 const Tensor* input, Tensor* output,
+                 RingReducer::BetweenPassesFn between_passes);
+
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_ = nullptr;  // Not owned
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
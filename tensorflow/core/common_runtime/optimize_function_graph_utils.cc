@@ -17,6 +17,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdlib>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -26,6 +27,8 @@ limitations under the License.
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/common_runtime/composite_device.h"
@@ -40,19 +43,23 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/partitioning_utils.h"
 #include "tensorflow/core/common_runtime/placer.h"
 #include "tensorflow/core/common_runtime/replicate_per_replica_nodes.h"
+#include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/device.h"
+#include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/optimized_function_graph.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/public/version.h"
 #include "tensorflow/core/util/debug_data_dumper.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
-#include "tsl/platform/host_info.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/statusor.h"
@@ -231,29 +238,22 @@ StatusOr<OptimizedFunctionGraphInfo> ReadFromCache(const string& file_name,
   return optimized_function_graph_info_restored;
 }
 
-// Gets the full path name of the file cache.
-// TODO(b/276813768) Include more runtime specific info like env/flag
-// values, or line number. An alternative is to use the fingerprint of the
-// graph once graph building cache is enabled.
-//
-// Current file cache key components:
-// 1) Job name.
-// 2) Task ID.
-// 3) Function name (without UUID suffix).
-// 4) TF graph node count.
+// Returns "function_name" without its random UUID suffix.
+string PlainFunctionName(const string& function_name) {
+  if (!absl::StrContains(function_name, "_")) return function_name;
+  std::vector<string> func_name_tokens = absl::StrSplit(function_name, '_');
+  func_name_tokens.pop_back();
+  return absl::StrJoin(func_name_tokens, "_");
+}
+
+// Gets the full path name of the file cache, which is the plain function
+// name and its node count, to keep the files recognizable, followed by the
+// hexadecimal FunctionGraphCacheFingerprint.
 string GetFileCacheName(const string& dir_name, const string& function_name,
-                        const FunctionDef* fdef) {
-  string plain_func_name = function_name;
-  // Remove the random UUID in the function name.
-  if (absl::StrContains(function_name, "_")) {
-    std::vector<string> func_name_tokens = absl::StrSplit(function_name, '_');
-    func_name_tokens.pop_back();
-    plain_func_name = absl::StrJoin(func_name_tokens, "_");
-  }
-
-  return absl::StrCat(dir_name, "/", tsl::port::JobName(), "_",
-                      tsl::port::TaskId(), "_", plain_func_name, "_",
-                      fdef->node_def_size());
+                        const FunctionDef* fdef, uint64 fingerprint) {
+  return absl::StrCat(dir_name, "/", PlainFunctionName(function_name), "_",
+                      fdef->node_def_size(), "_",
+                      absl::Hex(fingerprint, absl::kZeroPad16));
 }
 
 // Generates graph and return information given the input function name,
@@ -647,6 +647,73 @@ StatusOr<OptimizedFunctionGraphInfo> OptimizeFunctionGraph(
       optimization_source);
 }
 
+StatusOr<uint64> FunctionGraphCacheFingerprint(
+    const string& function_name, AttrSlice attrs,
+    const FunctionLibraryRuntime::InstantiateOptions& options,
+    const DeviceSet& dev_set, const FunctionLibraryDefinition* lib_def,
+    Device* default_device) {
+  const FunctionDef* fdef = lib_def->Find(function_name);
+  if (fdef == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("Failed to find function ", function_name));
+  }
+  // The parts of the key are separated by '|', and hashes are written in
+  // hexadecimal, so that no two different keys are the same string.
+  string key = absl::StrCat(TF_VERSION_STRING, "|", TF_GRAPH_DEF_VERSION,
+                            "|", PlainFunctionName(function_name), "|");
+  // The name of the function itself may embed a UUID, so it is left out of
+  // its definition.
+  FunctionDef unnamed_fdef = *fdef;
+  unnamed_fdef.mutable_signature()->clear_name();
+  absl::StrAppend(&key, absl::Hex(FunctionDefHash(unnamed_fdef)), "|");
+  const FunctionLibraryDefinition reachable =
+      lib_def->ReachableDefinitions(*fdef);
+  std::vector<string> reachable_names = reachable.ListFunctionNames();
+  std::sort(reachable_names.begin(), reachable_names.end());
+  for (const string& name : reachable_names) {
+    absl::StrAppend(&key, name, ":",
+                    absl::Hex(FunctionDefHash(*reachable.Find(name))), ",");
+  }
+
+  std::map<string, const AttrValue*> sorted_attrs;
+  for (const auto& attr : attrs) sorted_attrs[attr.first] = &attr.second;
+  absl::StrAppend(&key, "|");
+  for (const auto& attr : sorted_attrs) {
+    absl::StrAppend(&key, attr.first, ":",
+                    absl::Hex(AttrValueHash(*attr.second)), ",");
+  }
+
+  string config_proto;
+  SerializeToStringDeterministic(options.config_proto, &config_proto);
+  absl::StrAppend(
+      &key, "|", options.target, "|", absl::StrJoin(options.input_devices, ","),
+      "|", absl::StrJoin(options.output_devices, ","), "|",
+      FunctionLibraryRuntime::ExecutorType(options, attrs), "|",
+      options.is_multi_device_function, options.allow_soft_placement,
+      options.int_args_and_retvals_on_device,
+      options.default_device_to_target, "|", options.xla_compile_device_type,
+      "|", absl::Hex(Fingerprint64(config_proto)), "|");
+  std::map<int, const DtypeAndPartialTensorShape*> resources;
+  for (const auto& resource : options.input_resource_dtypes_and_shapes) {
+    resources[resource.first] = &resource.second;
+  }
+  for (const auto& resource : resources) {
+    absl::StrAppend(&key, resource.first, ":",
+                    DataTypeString(resource.second->dtype),
+                    resource.second->shape.DebugString(), ",");
+  }
+
+  std::vector<string> devices;
+  for (const Device* device : dev_set.devices()) {
+    devices.push_back(
+        absl::StrCat(device->name(), ":", device->device_type()));
+  }
+  std::sort(devices.begin(), devices.end());
+  absl::StrAppend(&key, "|", absl::StrJoin(devices, ","), "|",
+                  default_device == nullptr ? "" : default_device->name());
+  return Fingerprint64(key);
+}
+
 StatusOr<OptimizedFunctionGraphInfo> OptimizeFunctionGraphOrReadFromFileCache(
     const string& function_name, AttrSlice attrs,
     const FunctionLibraryRuntime::InstantiateOptions& options,
@@ -680,7 +747,12 @@ StatusOr<OptimizedFunctionGraphInfo> OptimizeFunctionGraphOrReadFromFileCache(
         "Failed to find function ", function_name,
         " in function library: ", lib_def->ToProto().DebugString()));
   }
-  const string file_name = GetFileCacheName(dir_name, function_name, fdef);
+  TF_ASSIGN_OR_RETURN(
+      const uint64 fingerprint,
+      FunctionGraphCacheFingerprint(function_name, attrs, options, dev_set,
+                                    lib_def, default_device));
+  const string file_name =
+      GetFileCacheName(dir_name, function_name, fdef, fingerprint);
 
   // Scenario (2): File cache exists for this function; restore from the cache.
   if (env->FileExists(file_name).ok()) {
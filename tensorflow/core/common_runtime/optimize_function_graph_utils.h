@@ -62,6 +62,18 @@ StatusOr<OptimizedFunctionGraphInfo> OptimizeFunctionGraph(
     Device* default_device, Env* env,
     OptimizedFunctionGraph::OptimizationSource optimization_source);
 
+// Returns the fingerprint keying the file cache of the optimized graph of
+// "function_name": the definitions of the function and of the functions it
+// reaches, "attrs", the options affecting the optimizations (including the
+// RewriterConfig in the ConfigProto), the devices of "dev_set" and the
+// TensorFlow version. The random UUID suffix of "function_name" is ignored.
+// Returns an error if the function is not in "lib_def".
+StatusOr<uint64> FunctionGraphCacheFingerprint(
+    const string& function_name, AttrSlice attrs,
+    const FunctionLibraryRuntime::InstantiateOptions& options,
+    const DeviceSet& dev_set, const FunctionLibraryDefinition* lib_def,
+    Device* default_device);
+
 // Outputs graph optimization results (as OptimizedFunctionGraphInfo proto),
 // either by running the actual graph optimization passes,  or by reloading from
 // the file cache if existent. If cache loading fails, it goes ahead and runs
@@ -27,11 +27,13 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/function_testlib.h"
 #include "tensorflow/core/common_runtime/optimized_function_graph_info.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/statusor.h"
 
 namespace tensorflow {
 namespace {
@@ -194,7 +196,7 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   // Check that only one cache file exists.
   file_list.clear();
   TF_ASSERT_OK(env->GetMatchingPaths(
-      absl::StrCat(temp_dir, "/_-1_FindDevice_1"), &file_list));
+      absl::StrCat(temp_dir, "/FindDevice_1_*"), &file_list));
   EXPECT_EQ(file_list.size(), 1);
   EXPECT_EQ(metrics::GetFunctionGraphOptimizationSavingTimeUsecs(
                 metrics::GraphOptimizationSource::kJit),
@@ -214,7 +216,7 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   TF_ASSERT_OK(optimized_info.status());
   file_list.clear();
   TF_ASSERT_OK(env->GetMatchingPaths(
-      absl::StrCat(temp_dir, "/_-1_FindDevice_1"), &file_list));
+      absl::StrCat(temp_dir, "/FindDevice_1_*"), &file_list));
   EXPECT_EQ(file_list.size(), 1);
   EXPECT_GT(metrics::GetFunctionGraphOptimizationSavingTimeUsecs(
                 metrics::GraphOptimizationSource::kJit),
@@ -245,5 +247,64 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   ASSERT_TRUE(empty_file_list.empty());
 }
 
+TEST(OptimizeFunctionGraphTest, CacheFingerprintCoversConfigAndDevices) {
+  FunctionLibraryRuntime::InstantiateOptions opts;
+  opts.is_multi_device_function = true;
+  FunctionDefLibrary proto;
+  *(proto.add_function()) = test::function::FindDeviceWithUuid();
+  *(proto.add_function()) = test::function::FindDevice();
+  auto lib_def =
+      std::make_unique<FunctionLibraryDefinition>(OpRegistry::Global(), proto);
+  std::vector<std::unique_ptr<Device>> devices;
+  CreateCpuDeviceList(kDevicePrefix, 3, devices);
+  DeviceSet device_set;
+  for (const auto& device : devices) {
+    device_set.AddDevice(device.get());
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      const uint64 fingerprint,
+      FunctionGraphCacheFingerprint("FindDevice_1234", {}, opts, device_set,
+                                    lib_def.get(), devices[1].get()));
+  TF_ASSERT_OK_AND_ASSIGN(
+      const uint64 same_fingerprint,
+      FunctionGraphCacheFingerprint("FindDevice_1234", {}, opts, device_set,
+                                    lib_def.get(), devices[1].get()));
+  EXPECT_EQ(fingerprint, same_fingerprint);
+
+  // The same definition under another UUID has the same fingerprint.
+  TF_ASSERT_OK_AND_ASSIGN(
+      const uint64 other_uuid_fingerprint,
+      FunctionGraphCacheFingerprint("FindDevice", {}, opts, device_set,
+                                    lib_def.get(), devices[1].get()));
+  EXPECT_EQ(fingerprint, other_uuid_fingerprint);
+
+  FunctionLibraryRuntime::InstantiateOptions rewritten_opts = opts;
+  rewritten_opts.config_proto.mutable_graph_options()
+      ->mutable_rewrite_options()
+      ->set_constant_folding(RewriterConfig::OFF);
+  TF_ASSERT_OK_AND_ASSIGN(
+      const uint64 rewritten_fingerprint,
+      FunctionGraphCacheFingerprint("FindDevice_1234", {}, rewritten_opts,
+                                    device_set, lib_def.get(),
+                                    devices[1].get()));
+  EXPECT_NE(fingerprint, rewritten_fingerprint);
+
+  DeviceSet smaller_device_set;
+  smaller_device_set.AddDevice(devices[0].get());
+  smaller_device_set.AddDevice(devices[1].get());
+  TF_ASSERT_OK_AND_ASSIGN(
+      const uint64 smaller_fingerprint,
+      FunctionGraphCacheFingerprint("FindDevice_1234", {}, opts,
+                                    smaller_device_set, lib_def.get(),
+                                    devices[1].get()));
+  EXPECT_NE(fingerprint, smaller_fingerprint);
+
+  EXPECT_TRUE(absl::IsNotFound(
+      FunctionGraphCacheFingerprint("Missing", {}, opts, device_set,
+                                    lib_def.get(), devices[1].get())
+          .status()));
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -15,22 +15,29 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/placer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/colocation_graph.h"
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/shape_refiner.h"
 #include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph_node_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/device_name_utils.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/port.h"
 
 namespace tensorflow {
@@ -138,6 +145,145 @@ void LogDeviceAssignment(const Node* node, bool log_device_placement) {
   }
 }
 
+// A colocation group of nodes that the Placer assigns, with the devices it
+// could be assigned to.
+struct PlacementGroup {
+  std::vector<Node*> nodes;
+  std::vector<Device*> devices;
+  // Whether the group has nodes that were assigned before the Placer ran.
+  bool fixed = false;
+  bool moved = false;
+};
+
+// The relative cost of copying a byte between two devices: nothing on the
+// same device, PCIe or NVLink within a task, and the network, taken to be 8
+// times slower, across tasks.
+double TransferCostPerByte(const Device* src, const Device* dst) {
+  if (src == dst) {
+    return 0;
+  }
+  if (DeviceNameUtils::IsSameAddressSpace(src->parsed_name(),
+                                          dst->parsed_name())) {
+    return 1;
+  }
+  return 8;
+}
+
+// Returns the size in bytes of the tensor on each data edge of "graph", by
+// edge id, as far as shape inference can tell. Unknown dimensions count as 1.
+std::vector<int64_t> EstimateEdgeBytes(const Graph& graph) {
+  ShapeRefiner refiner(graph.versions(), graph.op_registry());
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+  for (const Node* node : order) {
+    // Nodes whose shapes can't be inferred, and their fanout, keep unknown
+    // shapes.
+    refiner.AddNode(node).IgnoreError();
+  }
+  std::vector<int64_t> edge_bytes(graph.num_edge_ids(), 0);
+  for (const Edge* edge : graph.edges()) {
+    if (edge->IsControlEdge() || !edge->src()->IsOp()) {
+      continue;
+    }
+    int64_t num_elements = 1;
+    shape_inference::InferenceContext* c = refiner.GetContext(edge->src());
+    if (c != nullptr) {
+      shape_inference::ShapeHandle shape = c->output(edge->src_output());
+      if (c->RankKnown(shape)) {
+        for (int i = 0; i < c->Rank(shape); ++i) {
+          num_elements *= std::max<int64_t>(1, c->Value(c->Dim(shape, i)));
+        }
+      }
+    }
+    const DataType dtype = edge->src()->output_type(edge->src_output());
+    edge_bytes[edge->id()] = num_elements * std::max(1, DataTypeSize(dtype));
+  }
+  return edge_bytes;
+}
+
+// Moves each group in "groups" to the device, among the ones it could be
+// assigned to, that minimizes the cost of copying tensors between it and the
+// nodes it shares edges with, whenever that lowers the cost. Every move
+// lowers the total cost, and the number of sweeps over the groups is bounded.
+void MinimizeTransfers(const DeviceSet& devices,
+                       std::map<int, PlacementGroup>* groups, Graph* graph) {
+  constexpr int kMaxSweeps = 8;
+  const std::vector<int64_t> edge_bytes = EstimateEdgeBytes(*graph);
+  std::vector<const Device*> node_devices(graph->num_node_ids(), nullptr);
+  for (const Node* node : graph->op_nodes()) {
+    node_devices[node->id()] =
+        devices.FindDeviceByName(node->assigned_device_name());
+  }
+  std::vector<int> node_groups(graph->num_node_ids(), -1);
+  for (const auto& entry : *groups) {
+    for (const Node* node : entry.second.nodes) {
+      node_groups[node->id()] = entry.first;
+    }
+  }
+
+  auto transfer_cost = [&](int root, const PlacementGroup& group,
+                           const Device* device) {
+    double cost = 0;
+    auto add_edge_cost = [&](const Edge* edge, const Node* other) {
+      const Device* other_device = node_devices[other->id()];
+      if (edge->IsControlEdge() || !other->IsOp() ||
+          node_groups[other->id()] == root || other_device == nullptr) {
+        return;
+      }
+      cost +=
+          edge_bytes[edge->id()] * TransferCostPerByte(other_device, device);
+    };
+    for (const Node* node : group.nodes) {
+      for (const Edge* edge : node->in_edges()) {
+        add_edge_cost(edge, edge->src());
+      }
+      for (const Edge* edge : node->out_edges()) {
+        add_edge_cost(edge, edge->dst());
+      }
+    }
+    return cost;
+  };
+
+  for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+    bool changed = false;
+    for (auto& entry : *groups) {
+      PlacementGroup& group = entry.second;
+      if (group.fixed || group.nodes.empty() || group.devices.size() < 2) {
+        continue;
+      }
+      const Device* current = node_devices[group.nodes[0]->id()];
+      if (current == nullptr) {
+        continue;
+      }
+      const Device* best = current;
+      double best_cost = transfer_cost(entry.first, group, current);
+      for (const Device* device : group.devices) {
+        const double cost = transfer_cost(entry.first, group, device);
+        if (cost < best_cost) {
+          best = device;
+          best_cost = cost;
+        }
+      }
+      if (best == current) {
+        continue;
+      }
+      VLOG(2) << "Moving the colocation group of " << group.nodes[0]->name()
+              << " from " << current->name() << " to " << best->name()
+              << " to reduce the cost of transfers to " << best_cost;
+      const int device_index = graph->InternDeviceName(best->name());
+      for (Node* node : group.nodes) {
+        node->set_assigned_device_name_index(device_index);
+        node_devices[node->id()] = best;
+      }
+      group.moved = true;
+      changed = true;
+    }
+    if (!changed) {
+      break;
+    }
+  }
+}
+
 Status AssignAndLog(int assigned_device, Node* node,
                     ColocationGraph* colocation_graph,
                     bool log_device_placement) {
@@ -208,6 +354,22 @@ Status Placer::Run(const GraphOptimizationPassOptions& options) {
 
   TF_RETURN_IF_ERROR(colocation_graph.Initialize());
 
+  // When set, the heuristic placement below is refined to reduce the bytes
+  // copied between devices, within the colocation constraints.
+  bool minimize_transfers;
+  TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_PLACER_MINIMIZE_TRANSFERS",
+                                        /*default_val=*/false,
+                                        &minimize_transfers));
+  std::map<int, PlacementGroup> groups;
+  auto add_to_group = [&](Node* node, const std::vector<Device*>& devices) {
+    PlacementGroup& group =
+        groups[colocation_graph.FindAndUpdateRoot(node->id())];
+    if (group.nodes.empty()) {
+      group.devices = devices;
+    }
+    group.nodes.push_back(node);
+  };
+
   // For each node, assign a device based on the constraints in the disjoint
   // node set.
   std::vector<Node*> second_pass;
@@ -216,6 +378,9 @@ Status Placer::Run(const GraphOptimizationPassOptions& options) {
     // devices (e.g., for stateful placements), so the placer should not try to
     // place nodes that are already placed.
     if (node->has_assigned_device_name()) {
+      if (minimize_transfers) {
+        groups[colocation_graph.FindAndUpdateRoot(node->id())].fixed = true;
+      }
       TF_RETURN_IF_ERROR(colocation_graph.LimitToAssignedDevice(*node));
       LogDeviceAssignment(node, log_device_placement_);
       continue;
@@ -240,6 +405,9 @@ Status Placer::Run(const GraphOptimizationPassOptions& options) {
                                   node->name(), ": ", status.message()),
           *node);
     }
+    if (minimize_transfers) {
+      add_to_group(node, *devices);
+    }
 
     // TODO(mdan): This is a constrained optimization solver. Write it like one.
 
@@ -290,6 +458,9 @@ Status Placer::Run(const GraphOptimizationPassOptions& options) {
                                   node->name(), ": ", status.message()),
           *node);
     }
+    if (minimize_transfers) {
+      add_to_group(node, *devices);
+    }
 
     int assigned_device = -1;
 
@@ -319,6 +490,18 @@ Status Placer::Run(const GraphOptimizationPassOptions& options) {
                                     log_device_placement_));
   }
 
+  if (minimize_transfers) {
+    MinimizeTransfers(*devices_, &groups, graph_);
+    for (const auto& entry : groups) {
+      if (!entry.second.moved) {
+        continue;
+      }
+      for (const Node* node : entry.second.nodes) {
+        LogDeviceAssignment(node, log_device_placement_);
+      }
+    }
+  }
+
   if (VLOG_IS_ON(3)) {
     DumpGraphToFile(
         strings::StrCat(options.debug_filename_prefix, "placer_output"),
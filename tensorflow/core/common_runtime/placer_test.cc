@@ -431,6 +431,30 @@ TEST_F(PlacerTest, TestNoConstraints) {
   EXPECT_DEVICE_TYPE(g, "n2", "FakeGPU");
 }
 
+// Test that TF_PLACER_MINIMIZE_TRANSFERS moves nodes that can run anywhere off
+// the default device when that avoids copying their inputs and outputs.
+TEST_F(PlacerTest, TestMinimizeTransfers) {
+  Graph g(OpRegistry::Global());
+  {  // Scope for temporary variables used to construct g.
+    GraphDefBuilder b(GraphDefBuilder::kFailImmediately);
+    Node* input = ops::SourceOp("TestInput", b.opts().WithName("in"));
+    Node* n1 = ops::UnaryOp("TestRelu", ops::NodeOut(input, 0),
+                            b.opts().WithName("n1"));
+    ops::UnaryOp("ReluGPU", n1, b.opts().WithName("n2"));
+    ops::UnaryOp("TestRelu", ops::NodeOut(input, 1), b.opts().WithName("n3"));
+    TF_EXPECT_OK(BuildGraph(b, &g));
+  }
+
+  setenv("TF_PLACER_MINIMIZE_TRANSFERS", "true", /*overwrite=*/1);
+  TF_EXPECT_OK(Place(&g));
+  unsetenv("TF_PLACER_MINIMIZE_TRANSFERS");
+  EXPECT_DEVICE_TYPE(g, "in", "FakeCPU");
+  // n1 copies a tensor either way, so it stays on the default device.
+  EXPECT_DEVICE_TYPE(g, "n1", "FakeGPU");
+  EXPECT_DEVICE_TYPE(g, "n2", "FakeGPU");
+  EXPECT_COLOCATED(g, "in", "n3");
+}
+
 // Test that a graph with no constraints but using kernels that have a specified
 // device priority will successfully assign nodes to the device with higher
 // priority
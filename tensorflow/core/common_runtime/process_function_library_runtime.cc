@@ -748,6 +748,16 @@ Status ProcessFunctionLibraryRuntime::InstantiateMultiDevice(
   }
   TF_RETURN_IF_ERROR(group.as_summary_status());
 
+  // Precompute everything the run path would otherwise derive per call.
+  for (auto& pair : data->glue_) {
+    ComponentFunctionData* comp_data = &pair.second;
+    comp_data->flr = GetFLR(pair.first);
+    comp_data->use_device_runner =
+        comp_data->flr != nullptr &&
+        comp_data->flr->device()->tensorflow_device_thread_pool() != nullptr;
+  }
+  data->ordered_subgraphs_ = GetOrderedSubgraphs(data.get());
+
   std::vector<core::RefCountPtr<FunctionRecord>> function_records;
   const bool should_publish_function_graphs =
       flags::Global().publish_function_graphs.value();
@@ -898,9 +908,9 @@ Status ProcessFunctionLibraryRuntime::RunMultiDeviceSync(
   //
   // We assume that the partitioning has a valid deadlock-free ordering and the
   // safety of running synchronously has already been confirmed by this point.
-  std::vector<string> subgraph_keys = GetOrderedSubgraphs(data);
-
-  for (const string& target : subgraph_keys) {
+  // The order is computed once at instantiation.
+  rets->resize(data->num_outputs_);
+  for (const string& target : data->ordered_subgraphs_) {
     const ComponentFunctionData& comp_data = data->glue_.at(target);
     FunctionLibraryRuntime::Handle comp_handle = comp_data.handle;
 
@@ -913,17 +923,16 @@ Status ProcessFunctionLibraryRuntime::RunMultiDeviceSync(
       VLOG(2) << "Failed to get component function arguments: " << args_status;
       return args_status;
     }
-    rets->resize(data->num_outputs_);
 
     VLOG(1) << "Running component function on device " << target << " from "
             << data->function_name_ << " with handle " << comp_handle;
-    FunctionLibraryRuntime* flr = GetFLR(target);
+    FunctionLibraryRuntime* flr = comp_data.flr;
     if (flr != nullptr) {
       opts_copy.remote_execution = false;
       // When target device has private thread pool, use the target device
       // runner
-      thread::ThreadPool* pool = flr->device()->tensorflow_device_thread_pool();
-      opts_copy.runner = (pool == nullptr) ? opts.runner : flr->runner();
+      opts_copy.runner =
+          comp_data.use_device_runner ? flr->runner() : opts.runner;
       VLOG(4) << "    with " << opts_copy.DebugString();
 
       std::vector<Tensor> comp_tensor_rets;
@@ -992,6 +1001,7 @@ void ProcessFunctionLibraryRuntime::RunMultiDeviceAsync(
   for (int i = 0; i < data->glue_.size(); ++i) {
     refcounted_done->Ref();
   }
+  rets->resize(data->num_outputs_);
 
   FunctionLibraryRuntime::Options opts_copy = opts;
   for (const auto& pair : data->glue_) {
@@ -1013,10 +1023,12 @@ void ProcessFunctionLibraryRuntime::RunMultiDeviceAsync(
       continue;
     }
     std::vector<FunctionRet>* comp_rets = new std::vector<FunctionRet>;
-    rets->resize(data->num_outputs_);
 
-    auto component_fn_callback = [comp_rets, rets, comp_data, refcounted_done,
-                                  cm, local_cm, data, comp_handle,
+    // `comp_data` is owned by `data`, which outlives the call, so it is
+    // captured by pointer rather than copied for every component.
+    auto component_fn_callback = [comp_rets, rets, comp_data = &comp_data,
+                                  refcounted_done, cm, local_cm, data,
+                                  comp_handle,
                                   target](const Status& status) {
       if (!status.ok()) {
         VLOG(2) << "Component function execution on target " << target
@@ -1034,7 +1046,7 @@ void ProcessFunctionLibraryRuntime::RunMultiDeviceAsync(
                 << " from " << data->function_name_ << " with handle "
                 << comp_handle << " succeeded.";
         for (int i = 0; i < comp_rets->size(); ++i) {
-          (*rets)[comp_data.ret_indices[i]] = (*comp_rets)[i];
+          (*rets)[comp_data->ret_indices[i]] = (*comp_rets)[i];
         }
       }
       delete comp_rets;
@@ -1042,13 +1054,13 @@ void ProcessFunctionLibraryRuntime::RunMultiDeviceAsync(
       refcounted_done->Unref();
     };
 
-    FunctionLibraryRuntime* flr = GetFLR(target);
+    FunctionLibraryRuntime* flr = comp_data.flr;
     if (flr != nullptr) {
       opts_copy.remote_execution = false;
       // When target device has private thread pool, use the target device
       // runner
-      thread::ThreadPool* pool = flr->device()->tensorflow_device_thread_pool();
-      opts_copy.runner = (pool == nullptr) ? opts.runner : flr->runner();
+      opts_copy.runner =
+          comp_data.use_device_runner ? flr->runner() : opts.runner;
 
       VLOG(1) << "Running component function on device " << target << " from "
               << data->function_name_ << " with handle " << comp_handle;
@@ -1269,6 +1281,7 @@ Status ProcessFunctionLibraryRuntime::GetComponentArgs(
     const gtl::ArraySlice<Tensor> args,
     const ProcessFunctionLibraryRuntime::ComponentFunctionData& comp_data,
     ProcessFunctionLibraryRuntime::InternalArgs* comp_args) {
+  comp_args->args.reserve(comp_data.arg_indices.size());
   // "Index"s of _Arg nodes are unique when all arguments are local Tensors.
   for (const auto& it : comp_data.arg_indices) {
     if (it.index >= args.size()) {
@@ -1301,6 +1314,7 @@ Status ProcessFunctionLibraryRuntime::GetComponentArgs(
     const FunctionArgsInterface& args,
     const ProcessFunctionLibraryRuntime::ComponentFunctionData& comp_data,
     ProcessFunctionLibraryRuntime::InternalArgs* comp_args) {
+  comp_args->args.reserve(comp_data.arg_indices.size());
   for (int i = 0; i < comp_data.arg_indices.size(); ++i) {
     const FunctionArgIndex index = comp_data.arg_indices.at(i);
     Tensor tensor;
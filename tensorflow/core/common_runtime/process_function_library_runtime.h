@@ -283,6 +283,15 @@ class ProcessFunctionLibraryRuntime {
     std::vector<AllocatorAttributes> ret_alloc_attrs;
 
     AsyncAttributes async_attributes;
+
+    // The runtime of the device the component function runs on, resolved
+    // once at instantiation so that running the function does not look up
+    // the device on every call. nullptr if the device is not local to this
+    // process.
+    FunctionLibraryRuntime* flr = nullptr;
+    // Whether the component function runs on the device's private thread
+    // pool rather than on the caller-provided runner.
+    bool use_device_runner = false;
   };
 
   // Data structure holding information for a single instantiated multi-device
@@ -319,6 +328,11 @@ class ProcessFunctionLibraryRuntime {
     // Maps the device name to the information about the component function
     // be run on this device.
     std::unordered_map<string, ComponentFunctionData> glue_;
+
+    // The keys of `glue_` in the order in which RunMultiDeviceSync runs the
+    // component functions (see GetOrderedSubgraphs()), computed once at
+    // instantiation.
+    std::vector<string> ordered_subgraphs_;
   };
 
   struct CleanUpItem {
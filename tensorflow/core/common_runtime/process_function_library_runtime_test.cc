@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/public/version.h"
@@ -920,6 +921,42 @@ FunctionDef AddVarAcrossDevices() {
       {{"y", "add:z:0"}});
 }
 
+// Returns a function which doubles its input on two CPU devices.
+FunctionDef TwoCpuAdd() {
+  return FunctionDefHelper::Create(
+      // Name
+      "TwoCpuAdd",
+      // Args
+      {"x: float"},
+      // Return values
+      {"y0: float", "y1: float"},
+      // Attr def
+      {},
+      // Nodes
+      {
+          {{"add0"}, "Add", {"x", "x"}, {{"T", DT_FLOAT}}, {}, "/device:CPU:0"},
+          {{"add1"}, "Add", {"x", "x"}, {{"T", DT_FLOAT}}, {}, "/device:CPU:1"},
+      },
+      {{"y0", "add0:z:0"}, {"y1", "add1:z:0"}});
+}
+
+TEST_F(ProcessFunctionLibraryRuntimeTest, MultiDevice_RepeatedRuns) {
+  Init({TwoCpuAdd()});
+  FunctionLibraryRuntime::Handle handle;
+  TF_CHECK_OK(Instantiate("TwoCpuAdd", {},
+                          MakeOptions("CPU:0", {"CPU:0"}, {"CPU:0", "CPU:1"}),
+                          &handle));
+  // The component plan computed at instantiation is reused by every call.
+  for (int i = 0; i < 3; ++i) {
+    Tensor y0;
+    Tensor y1;
+    TF_CHECK_OK(RunInstantiated(handle, {}, {test::AsTensor<float>({1, 2, 3})},
+                                {&y0, &y1}));
+    test::ExpectTensorEqual<float>(y0, test::AsTensor<float>({2, 4, 6}));
+    test::ExpectTensorEqual<float>(y1, test::AsTensor<float>({2, 4, 6}));
+  }
+}
+
 // An implementation of FunctionArgsInterface for packed inputs.
 class TestFunctionPackedArgs : public FunctionArgsInterface {
  public:
@@ -1409,5 +1446,55 @@ TEST_F(ProcessFunctionLibraryRuntimeTest, RecordAotSavingTimeAndHitCount) {
             1);
 }
 
+// Measures the host overhead of running a small two-device function.
+void BM_RunMultiDevice(::testing::benchmark::State& state) {
+  SessionOptions options;
+  (*options.config.mutable_device_count())["CPU"] = 2;
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_CHECK_OK(DeviceFactory::AddDevices(options, "/job:a/replica:0/task:0",
+                                        &devices));
+  DynamicDeviceMgr device_mgr;
+  TF_CHECK_OK(device_mgr.AddDevices(std::move(devices)));
+
+  FunctionDefLibrary proto;
+  *proto.add_function() = TwoCpuAdd();
+  FunctionLibraryDefinition lib_def(OpRegistry::Global(), proto);
+  ProcessFunctionLibraryRuntime pflr(
+      &device_mgr, Env::Default(), /*config=*/nullptr, TF_GRAPH_DEF_VERSION,
+      &lib_def, OptimizerOptions(), /*thread_pool=*/nullptr,
+      /*parent=*/nullptr, /*session_metadata=*/nullptr,
+      Rendezvous::Factory{[](const int64_t step_id,
+                             const DeviceMgr* device_mgr,
+                             tsl::core::RefCountPtr<Rendezvous>* r) {
+        *r = tsl::core::RefCountPtr<Rendezvous>(
+            new IntraProcessRendezvous(device_mgr));
+        return OkStatus();
+      }});
+  FunctionLibraryRuntime::Handle handle;
+  TF_CHECK_OK(pflr.Instantiate(
+      "TwoCpuAdd", {}, MakeOptions("CPU:0", {"CPU:0"}, {"CPU:0", "CPU:1"}),
+      &handle));
+
+  std::function<void(std::function<void()>)> runner =
+      [](std::function<void()> fn) {
+        test::function::FunctionTestSchedClosure(fn);
+      };
+  FunctionLibraryRuntime::Options opts;
+  opts.runner = &runner;
+  const std::vector<Tensor> args = {test::AsTensor<float>({1, 2, 3})};
+  std::vector<Tensor> rets;
+  for (auto s : state) {
+    Status status;
+    Notification done;
+    pflr.Run(opts, handle, args, &rets, [&status, &done](const Status& s) {
+      status = s;
+      done.Notify();
+    });
+    done.WaitForNotification();
+    TF_CHECK_OK(status);
+  }
+}
+BENCHMARK(BM_RunMultiDevice);
+
 }  // anonymous namespace
 }  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/process_state.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <vector>
@@ -101,8 +102,17 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
       int64_t cpu_mem_limit = cpu_mem_limit_in_mb * (1LL << 20);
       DCHECK(sub_allocator);
 
+      int64_t thread_cache_bytes = 0;
+      status = ReadInt64FromEnvVar("TF_CPU_BFC_THREAD_CACHE_BYTES", 0,
+                                   &thread_cache_bytes);
+      if (!status.ok()) {
+        LOG(ERROR) << "GetCPUAllocator: " << status.message();
+      }
+
       BFCAllocator::Options allocator_opts;
       allocator_opts.allow_growth = true;
+      allocator_opts.thread_cache_bytes =
+          std::max<int64_t>(thread_cache_bytes, 0);
       allocator = new BFCAllocator(
           absl::WrapUnique(sub_allocator), cpu_mem_limit,
           /*name=*/"bfc_cpu_allocator_for_gpu", allocator_opts);
@@ -104,7 +104,8 @@ RingAlg::RingAlg(CollectiveType type, const string& name)
       col_params_(nullptr),
       done_(nullptr),
       group_size_(-1),
-      num_subdivs_(-1) {}
+      num_subdivs_(-1),
+      num_segments_(1) {}
 
 namespace {
 Status GenerateSubdivsInCollectiveParams(CollectiveParams* col_params) {
@@ -331,8 +332,10 @@ void RingAlg::InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
   // a device can simultaneously send data by 2 or more independent
   // channels we can speed up the transfer by subdividing chunks and
   // processing multiple subdivisions at once.  So the actual number
-  // of RingFields is group_size_ * num_subdivs_.
-  DCHECK_EQ(field_idx, (chunk_idx * num_subdivs_) + subdiv_idx);
+  // of RingFields is group_size_ * num_subdivs_.  Each subdivision may in
+  // turn be split into num_segments_ consecutive segments that are pipelined
+  // through the same ring.
+  DCHECK_EQ(field_idx / num_segments_, (chunk_idx * num_subdivs_) + subdiv_idx);
   rf->chunk_idx = chunk_idx;
   rf->subdiv_idx = subdiv_idx;
   rf->sc_idx = field_idx;
@@ -395,6 +398,11 @@ string RingAlg::RingField::DebugString() const {
 }
 
 void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
+  PostValue(rf, &rf->chunk, done);
+}
+
+void RingAlg::PostValue(RingField* rf, const Tensor* tensor,
+                        const StatusCallback& done) {
   DCHECK(rf->do_send);
   string send_buf_key = RingAlgBufKey(name_, col_ctx_->exec_key,
                                       rf->second_pass, rf->sc_idx, rf->rank);
@@ -408,12 +416,23 @@ void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
       col_params_->group.members[send_to_dev_idx].device.name(),
       col_params_->group.members[send_to_dev_idx].task, send_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
-      col_ctx_->op_ctx->output_alloc_attr(0), &rf->chunk,
+      col_ctx_->op_ctx->output_alloc_attr(0), tensor,
       col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
       done);
 }
 
+Tensor* RingAlg::RecvDestination(RingField* rf) {
+  return (!rf->second_pass && (col_params_->merge_op != nullptr))
+             ? &rf->tmp_chunk
+             : &rf->chunk;
+}
+
 void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
+  RecvValue(rf, RecvDestination(rf), done);
+}
+
+void RingAlg::RecvValue(RingField* rf, Tensor* tensor,
+                        const StatusCallback& done) {
   DCHECK(rf->do_recv);
   string recv_buf_key =
       RingAlgBufKey(name_, col_ctx_->exec_key, rf->second_pass, rf->sc_idx,
@@ -421,15 +440,12 @@ void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
   VLOG(3) << "DispatchRecv rank=" << col_params_->default_rank << " recv key "
           << recv_buf_key << " chunk " << ca_->TBounds(rf->chunk) << " into "
           << ((col_params_->merge_op != nullptr) ? "tmp_chunk" : "chunk");
-  Tensor* dst_tensor = (!rf->second_pass && (col_params_->merge_op != nullptr))
-                           ? &rf->tmp_chunk
-                           : &rf->chunk;
   col_ctx_->col_exec->remote_access()->RecvFromPeer(
       col_params_->group.members[rf->recv_dev_idx].device.name(),
       col_params_->group.members[rf->recv_dev_idx].task,
       col_params_->group.members[rf->recv_dev_idx].is_local, recv_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
-      col_ctx_->op_ctx->output_alloc_attr(0), dst_tensor,
+      col_ctx_->op_ctx->output_alloc_attr(0), tensor,
       col_ctx_->device_locality, rf->subdiv_idx,
       col_ctx_->op_ctx->cancellation_manager(), done);
 }
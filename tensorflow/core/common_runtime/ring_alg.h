@@ -81,8 +81,16 @@ class RingAlg : public CollectiveImplementationInterface {
   virtual void InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
                              int field_idx);
   void AdvanceToSecondPass(RingField* rf);
-  void DispatchSend(RingField* rf, const StatusCallback& done);
-  void DispatchRecv(RingField* rf, const StatusCallback& done);
+  // Send rf->chunk to the next device of the ring, and receive the value of
+  // rf from the previous one.
+  virtual void DispatchSend(RingField* rf, const StatusCallback& done);
+  virtual void DispatchRecv(RingField* rf, const StatusCallback& done);
+  // Send "tensor" as the value of rf, and receive it into "tensor".
+  void PostValue(RingField* rf, const Tensor* tensor,
+                 const StatusCallback& done);
+  void RecvValue(RingField* rf, Tensor* tensor, const StatusCallback& done);
+  // Returns the tensor the value of rf is received into.
+  Tensor* RecvDestination(RingField* rf);
 
   // For constructing log messages for debugging.
   string FieldState();
@@ -108,6 +116,7 @@ class RingAlg : public CollectiveImplementationInterface {
   StatusCallback done_;
   int group_size_;
   int num_subdivs_;
+  int num_segments_;  // per subdivision of a chunk
   Tensor group_size_tensor_;
   Notification group_size_tensor_ready_;
   std::unique_ptr<CollectiveAdapter> ca_;
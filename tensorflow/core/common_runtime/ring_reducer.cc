@@ -16,8 +16,11 @@ limitations under the License.
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <utility>
 
 #include "tensorflow/core/common_runtime/collective_rma_local.h"
@@ -40,16 +43,78 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
+namespace {
+// Segments smaller than this cost more in per-transfer overhead than their
+// pipelining saves, whatever the link model says.
+constexpr size_t kMinSegmentBytes = 256 * 1024;
+// Bounds the number of segments of one field, and so the outstanding
+// transfers of one device.
+constexpr int kMaxSegmentsPerField = 64;
+
+// Sets ring_segments in col_params if not set yet. Every member of the
+// group must make the same choice, since the segments determine both the
+// chunk boundaries and the BufRendezvous keys, so it depends only on the
+// instance and on TF_RING_LINK_LATENCY_MICROS and
+// TF_RING_LINK_MEGABYTES_PER_SEC, which must be set alike in every task.
+// Segmentation is off unless both are set.
+//
+// With s segments of a field of C bytes, each of the 2 * (group_size - 1)
+// ring steps takes latency + C / (s * bandwidth), and the steps of
+// consecutive segments overlap, so the field takes
+// (s + 2 * (group_size - 1) - 1) steps. That is least for
+// s = sqrt((2 * group_size - 3) * C / (latency * bandwidth)).
+Status GenerateSegmentsInCollectiveParams(CollectiveParams* col_params) {
+  CollImplDetails& details = col_params->instance.impl_details;
+  if (details.ring_segments > 0) return OkStatus();
+  details.ring_segments = 1;
+  int64_t latency_micros;
+  int64_t mbytes_per_sec;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_RING_LINK_LATENCY_MICROS", 0,
+                                         &latency_micros));
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_RING_LINK_MEGABYTES_PER_SEC", 0,
+                                         &mbytes_per_sec));
+  const int group_size = col_params->group.group_size;
+  if (latency_micros <= 0 || mbytes_per_sec <= 0 || group_size < 2) {
+    return OkStatus();
+  }
+  const int num_fields =
+      group_size * static_cast<int>(details.subdiv_permutations.size());
+  const size_t field_bytes = col_params->instance.shape.num_elements() *
+                             DataTypeSize(col_params->instance.data_type) /
+                             num_fields;
+  // A megabyte per second is a byte per microsecond.
+  const double latency_bytes =
+      static_cast<double>(latency_micros) * mbytes_per_sec;
+  int num_segments = static_cast<int>(
+      std::sqrt((2 * group_size - 3) * field_bytes / latency_bytes));
+  num_segments = std::min<int>(num_segments, field_bytes / kMinSegmentBytes);
+  num_segments = std::min(num_segments, kMaxSegmentsPerField);
+  // RingField indices are int16.
+  num_segments =
+      std::min(num_segments, std::numeric_limits<int16>::max() / num_fields);
+  if (num_segments > 1) details.ring_segments = num_segments;
+  VLOG(2) << "Using " << details.ring_segments << " segments of "
+          << field_bytes / details.ring_segments << " bytes per field in "
+          << details.collective_name;
+  return OkStatus();
+}
+}  // namespace
 
-RingReducer::~RingReducer() { group_size_tensor_ready_.WaitForNotification(); }
+RingReducer::~RingReducer() {
+  // The notification is pending only once Run has created ca_.
+  if (ca_ != nullptr) group_size_tensor_ready_.WaitForNotification();
+}
 
 Status RingReducer::InitializeCollectiveParams(CollectiveParams* col_params) {
   // TODO(b/113171733): change CHECKs to return errors.
   CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
-  CHECK_EQ(col_params->instance.impl_details.collective_name, "RingReduce");
-  return RingAlg::InitializeCollectiveParams(col_params);
+  CHECK_EQ(col_params->instance.impl_details.collective_name,
+           collective_name_);
+  TF_RETURN_IF_ERROR(RingAlg::InitializeCollectiveParams(col_params));
+  return GenerateSegmentsInCollectiveParams(col_params);
 }
 
 void RingReducer::Run(StatusCallback done) {
@@ -57,13 +122,15 @@ void RingReducer::Run(StatusCallback done) {
   CHECK(col_params_);
   // Since `RingReducer` doesn't require non-overlapping collectives, unblock
   // any collective that is blocked on this instance.
-  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  if (!is_step_) col_ctx_->col_exec->UnblockDependencies(*col_params_);
 
   done_ = std::move(done);
   group_size_ = col_params_->group.group_size;
   num_subdivs_ = static_cast<int>(
       col_params_->instance.impl_details.subdiv_permutations.size());
   CHECK_GT(num_subdivs_, 0);
+  num_segments_ =
+      std::max(col_params_->instance.impl_details.ring_segments, 1);
 
   if (VLOG_IS_ON(1)) {
     string buf;
@@ -117,7 +184,8 @@ void RingReducer::Run(StatusCallback done) {
 // which cannot be blocked.
 void RingReducer::ContinueAfterInputCopy() {
   AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
-  ca_.reset(MakeCollectiveAdapter(col_ctx_->output, group_size_ * num_subdivs_,
+  ca_.reset(MakeCollectiveAdapter(col_ctx_->output,
+                                  group_size_ * num_subdivs_ * num_segments_,
                                   col_ctx_->device->GetAllocator(attr)));
 
   if (col_params_->final_op) {
@@ -178,13 +246,19 @@ bool RingReducer::RunAsyncParts() {
   // complete. Hence function local variables are accessible only by that
   // one thread and do not require an explicit mutex.
   rfv_.clear();
-  rfv_.resize(group_size_ * num_subdivs_);
+  rfv_.resize(group_size_ * num_subdivs_ * num_segments_);
   PCQueue ready_queue;
+  // The segments of a subdivision are enqueued first to last, so that they
+  // make their way around the ring in that order.
   for (int chunk_idx = 0; chunk_idx < group_size_; ++chunk_idx) {
     for (int subdiv_idx = 0; subdiv_idx < num_subdivs_; ++subdiv_idx) {
-      int rf_index = (chunk_idx * num_subdivs_) + subdiv_idx;
-      InitRingField(&rfv_[rf_index], chunk_idx, subdiv_idx, rf_index);
-      ready_queue.Enqueue(&rfv_[rf_index]);
+      for (int seg_idx = 0; seg_idx < num_segments_; ++seg_idx) {
+        int rf_index =
+            ((chunk_idx * num_subdivs_) + subdiv_idx) * num_segments_ +
+            seg_idx;
+        InitRingField(&rfv_[rf_index], chunk_idx, subdiv_idx, rf_index);
+        ready_queue.Enqueue(&rfv_[rf_index]);
+      }
     }
   }
   const DeviceBase::AcceleratorDeviceInfo* gpu_info =
@@ -210,6 +284,7 @@ bool RingReducer::RunAsyncParts() {
   }
 
   int field_done_count = 0;
+  int first_pass_done_count = 0;
   int send_pending_count = 0;
   int recv_pending_count = 0;
   std::atomic<bool> aborted(false);
@@ -313,6 +388,26 @@ bool RingReducer::RunAsyncParts() {
           if (rf->second_pass) {
             ++field_done_count;
             break;  // from do while(!dispatched)
+          } else if (between_passes_) {
+            // Hold the fields until the first pass is complete.
+            if (++first_pass_done_count == rfv_.size()) {
+              std::vector<Tensor*> chunks;
+              for (RingField& f : rfv_) {
+                if (f.is_final && ca_->ChunkBytes(f.sc_idx) > 0) {
+                  chunks.push_back(&f.chunk);
+                }
+              }
+              Status s = between_passes_(chunks);
+              if (!s.ok()) {
+                aborted = true;
+                StartAbort(s);
+              }
+              for (RingField& f : rfv_) {
+                AdvanceToSecondPass(&f);
+                ready_queue.Enqueue(&f);
+              }
+            }
+            break;  // from do while(!dispatched)
           } else {
             AdvanceToSecondPass(rf);
           }
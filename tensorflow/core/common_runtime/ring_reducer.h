@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <deque>
 #include <memory>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/base_collective_executor.h"
@@ -30,7 +32,23 @@ class Device;
 // Ring-algorithm implementation of collective all-reduce.
 class RingReducer : public RingAlg {
  public:
+  // Called with the chunks of the tensor that are fully reduced on this
+  // device at the end of the first pass.
+  typedef std::function<Status(const std::vector<Tensor*>& chunks)>
+      BetweenPassesFn;
+
   RingReducer() : RingAlg(REDUCTION_COLLECTIVE, "Reduce") {}
+
+  // Constructs a RingReducer that runs as a step of another collective,
+  // which unblocks the collectives depending on it itself. If set,
+  // "between_passes" is called once every field has completed the first
+  // pass, and may update the chunks before the second pass copies them to
+  // the other devices.
+  explicit RingReducer(BetweenPassesFn between_passes)
+      : RingAlg(REDUCTION_COLLECTIVE, "Reduce"),
+        is_step_(true),
+        between_passes_(std::move(between_passes)) {}
+
   ~RingReducer() override;
 
   // Begins async execution of the ring reduce algorithm.
@@ -42,6 +60,11 @@ class RingReducer : public RingAlg {
   Status InitializeCollectiveParams(CollectiveParams* col_params) override;
 
  protected:
+  // For subclasses registered as "collective_name".
+  explicit RingReducer(const string& collective_name)
+      : RingAlg(REDUCTION_COLLECTIVE, "Reduce"),
+        collective_name_(collective_name) {}
+
   void InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
                      int field_idx) override;
 
@@ -51,6 +74,9 @@ class RingReducer : public RingAlg {
 
   Tensor group_size_tensor_;
   Notification group_size_tensor_ready_;
+  const string collective_name_ = "RingReduce";
+  const bool is_step_ = false;
+  const BetweenPassesFn between_passes_;
 
   friend class RingReducerTest;
   friend class RingReducerInitParamsTest;
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/common_runtime/ring_reducer.h"
 
+#include <stdlib.h>
+
 #include <algorithm>
 
 #include "absl/memory/memory.h"
@@ -83,14 +85,14 @@ class RingReducerTest : public ::testing::Test {
  protected:
   void Init(int num_workers, int num_devices, DataType dtype,
             const TensorShape& shape, const DeviceType& device_type,
-            int num_subdivs, int fail_after) {
+            int num_subdivs, int fail_after, int ring_segments) {
     test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, device_type);
     test_env_->remote_access->set_fail_after(fail_after);
     for (int wi = 0; wi < num_workers; ++wi) {
       for (int di = 0; di < num_devices; ++di) {
         int rank = wi * num_devices + di;
         instances_.push_back(std::make_unique<DeviceInstance>(
-            rank, num_subdivs, dtype, shape, test_env_.get()));
+            rank, num_subdivs, ring_segments, dtype, shape, test_env_.get()));
       }
     }
   }
@@ -115,9 +117,9 @@ class RingReducerTest : public ::testing::Test {
   template <typename T>
   void RunTest(DataType dtype, const DeviceType& device_type, int num_workers,
                int num_devices, int num_subdivs, int tensor_len,
-               int fail_after) {
+               int fail_after, int ring_segments = 0) {
     Init(num_workers, num_devices, dtype, TensorShape({tensor_len}),
-         device_type, num_subdivs, fail_after);
+         device_type, num_subdivs, fail_after, ring_segments);
     std::vector<T> expected(tensor_len);
     for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
       instances_[di]->InitTensor([&expected, dtype, di](Tensor* t) {
@@ -155,8 +157,9 @@ class RingReducerTest : public ::testing::Test {
 
   class DeviceInstance {
    public:
-    DeviceInstance(int rank, int num_subdivs, DataType dtype,
-                   const TensorShape& shape, CollectiveTestEnv* test_env)
+    DeviceInstance(int rank, int num_subdivs, int ring_segments,
+                   DataType dtype, const TensorShape& shape,
+                   CollectiveTestEnv* test_env)
         : test_env_(test_env), tensor_(dtype, shape) {
       col_params_ = CreateCollectiveParams(*test_env_, rank, "RingReduce",
                                            REDUCTION_COLLECTIVE, dtype, shape);
@@ -165,6 +168,7 @@ class RingReducerTest : public ::testing::Test {
             GenerateEvenSubdivOffsets(test_env->num_devices_per_worker,
                                       num_subdivs);
       }
+      col_params_->instance.impl_details.ring_segments = ring_segments;
       string dev_name = col_params_->group.members[rank].device.name();
       TF_CHECK_OK(test_env_->device_mgr->LookupDevice(dev_name, &device_))
           << "Couldn't find device " << dev_name
@@ -374,6 +378,48 @@ TEST_F(RingReducerInitParamsTest, AutomaticSubdivDisabled) {
   RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
 }
 
+TEST_F(RingReducerInitParamsTest, AutomaticSegments) {
+  const int kNumDevsPerWorker = 1;
+  const int kNumWorkers = 4;
+  auto test_env =
+      CreateCollectiveTestEnv(kNumWorkers, kNumDevsPerWorker, DEVICE_CPU);
+  auto cp =
+      CreateCollectiveParams(*test_env, /*rank*/ 0, "RingReduce",
+                             REDUCTION_COLLECTIVE, DT_FLOAT, TensorShape({1}));
+  cp->default_rank = 0;
+  cp->instance.impl_details.max_subdivs_per_device = -1;
+  // 64 MiB per chunk.
+  cp->instance.shape = TensorShape({268435456 / DataTypeSize(DT_FLOAT)});
+
+  // Without a link model no segmentation is done.
+  cp->instance.impl_details.subdiv_offsets.clear();
+  RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
+  EXPECT_EQ(cp->instance.impl_details.ring_segments, 1);
+
+  // sqrt(5 * 64 MiB / (100 us * 1000 MB/s)) segments.
+  setenv("TF_RING_LINK_LATENCY_MICROS", "100", 1);
+  setenv("TF_RING_LINK_MEGABYTES_PER_SEC", "1000", 1);
+  cp->instance.impl_details.subdiv_offsets.clear();
+  cp->instance.impl_details.ring_segments = 0;
+  RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
+  EXPECT_EQ(cp->instance.impl_details.ring_segments, 57);
+
+  // Segments are no smaller than 256 KiB.
+  cp->instance.shape = TensorShape({4194304 / DataTypeSize(DT_FLOAT)});
+  cp->instance.impl_details.subdiv_offsets.clear();
+  cp->instance.impl_details.ring_segments = 0;
+  RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
+  EXPECT_EQ(cp->instance.impl_details.ring_segments, 4);
+
+  // A given count is kept.
+  cp->instance.impl_details.subdiv_offsets.clear();
+  cp->instance.impl_details.ring_segments = 3;
+  RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
+  EXPECT_EQ(cp->instance.impl_details.ring_segments, 3);
+  unsetenv("TF_RING_LINK_LATENCY_MICROS");
+  unsetenv("TF_RING_LINK_MEGABYTES_PER_SEC");
+}
+
 // TODO(b/113171733): change to use TEST_P.
 #define DEF_TEST(B, T, W, D, S, L, A)                                         \
   TEST_F(RingReducerTest,                                                     \
@@ -423,6 +469,14 @@ DEF_TEST(INT32, CPU, 2, 8, 3, 4095, 0)
 DEF_TEST(INT64, CPU, 1, 2, 1, 1001, 0)
 DEF_TEST(INT64, CPU, 2, 8, 3, 4095, 0)
 
+TEST_F(RingReducerTest, SegmentedFields) {
+  RunTest<float>(DT_FLOAT, DEVICE_CPU, 2, 4, 2, 100003, 0,
+                 /*ring_segments=*/3);
+  instances_.clear();
+  RunTest<int32>(DT_INT32, DEVICE_CPU, 4, 1, 1, 4095, 0,
+                 /*ring_segments=*/5);
+}
+
 // Failure tests
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 1)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 7)
@@ -22,11 +22,13 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/common_runtime/eval_const_tensor.h"
 #include "tensorflow/core/common_runtime/function_utils.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
+#include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -158,9 +160,100 @@ Status ShapeRefiner::InferShapesForFunctionSubNode(
 // NOTE: Recursive user-defined functions are not supported.
 // Maybe we won't support recursive functions at all in TF, because of
 // other maintainability issues.
+std::string ShapeRefiner::FunctionShapesKey(const FunctionDef* function_def,
+                                            AttrSlice attributes,
+                                            InferenceContext* outer_context) {
+  std::string key = Canonicalize(function_def->signature().name(), attributes);
+  for (int i = 0; i < outer_context->num_inputs(); ++i) {
+    absl::StrAppend(&key, "|");
+    ShapeHandle input = outer_context->input(i);
+    if (!input.SameHandle(ShapeHandle())) {
+      absl::StrAppend(&key, outer_context->DebugString(input));
+    }
+    const auto* handle_data = outer_context->input_handle_shapes_and_types(i);
+    if (handle_data != nullptr) {
+      for (const ShapeAndType& shape_and_type : *handle_data) {
+        absl::StrAppend(&key, ";", outer_context->DebugString(shape_and_type),
+                        ":", shape_and_type.type.SerializeAsString());
+      }
+    }
+    const Tensor* tensor = outer_context->input_tensor(i);
+    if (tensor != nullptr) {
+      TensorProto proto;
+      tensor->AsProtoTensorContent(&proto);
+      absl::StrAppend(&key, "=", proto.SerializeAsString());
+    }
+  }
+  return key;
+}
+
+Status ShapeRefiner::ApplyFunctionShapes(const FunctionShapes& shapes,
+                                         InferenceContext* outer_context) {
+  for (int i = 0; i < shapes.output_shapes.size(); ++i) {
+    ShapeHandle handle;
+    TF_RETURN_IF_ERROR(outer_context->MakeShapeFromShapeProto(
+        shapes.output_shapes[i], &handle));
+    outer_context->set_output(i, handle);
+
+    const auto& handle_data = shapes.output_handle_shapes_and_types[i];
+    if (handle_data.has_value()) {
+      std::vector<ShapeAndType> shapes_and_types;
+      shapes_and_types.reserve(handle_data->size());
+      for (const auto& shape_and_type : *handle_data) {
+        TF_RETURN_IF_ERROR(outer_context->MakeShapeFromShapeProto(
+            shape_and_type.shape, &handle));
+        shapes_and_types.push_back(
+            ShapeAndType(handle, shape_and_type.dtype, shape_and_type.type));
+      }
+      outer_context->set_output_handle_shapes_and_types(i, shapes_and_types);
+    }
+  }
+  // The caller re-runs inference once these constants become available, which
+  // then looks up the entry keyed by their values.
+  for (int index : shapes.requested_input_tensors) {
+    outer_context->request_input_tensor(index);
+  }
+  return OkStatus();
+}
+
+void ShapeRefiner::RecordFunctionShapes(InferenceContext* outer_context,
+                                        FunctionShapes* shapes) {
+  const int num_outputs = outer_context->num_outputs();
+  shapes->output_shapes.resize(num_outputs);
+  shapes->output_handle_shapes_and_types.resize(num_outputs);
+  for (int i = 0; i < num_outputs; ++i) {
+    outer_context->ShapeHandleToProto(outer_context->output(i),
+                                      &shapes->output_shapes[i]);
+    const auto* handle_data = outer_context->output_handle_shapes_and_types(i);
+    if (handle_data != nullptr) {
+      auto& recorded = shapes->output_handle_shapes_and_types[i].emplace();
+      recorded.reserve(handle_data->size());
+      for (const ShapeAndType& shape_and_type : *handle_data) {
+        FunctionShapes::HandleShapeAndType entry;
+        outer_context->ShapeHandleToProto(shape_and_type.shape, &entry.shape);
+        entry.dtype = shape_and_type.dtype;
+        entry.type = shape_and_type.type;
+        recorded.push_back(std::move(entry));
+      }
+    }
+  }
+  for (int i = 0; i < outer_context->num_inputs(); ++i) {
+    if (outer_context->requested_input_tensor(i)) {
+      shapes->requested_input_tensors.push_back(i);
+    }
+  }
+}
+
 Status ShapeRefiner::InferShapesForFunction(const FunctionDef* function_def,
                                             AttrSlice attributes,
                                             InferenceContext* outer_context) {
+  const std::string shapes_key =
+      FunctionShapesKey(function_def, attributes, outer_context);
+  auto shapes_it = function_shapes_.find(shapes_key);
+  if (shapes_it != function_shapes_.end()) {
+    return ApplyFunctionShapes(shapes_it->second, outer_context);
+  }
+
   const Graph* graph;
   const string& fname = function_def->signature().name();
   auto it = functions_.find(fname);
@@ -205,6 +298,9 @@ Status ShapeRefiner::InferShapesForFunction(const FunctionDef* function_def,
     node_to_context_.erase(node);
   }
 
+  if (inference_status.ok()) {
+    RecordFunctionShapes(outer_context, &function_shapes_[shapes_key]);
+  }
   return inference_status;
 }
 
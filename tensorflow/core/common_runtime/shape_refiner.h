@@ -16,14 +16,18 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_SHAPE_REFINER_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/graph_runner.h"
+#include "tensorflow/core/framework/full_type.pb.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
@@ -145,8 +149,9 @@ class ShapeRefiner {
   // Set function library to enable function shape inference.
   // Without function library, function inference always yields unknown shapes.
   // With this enabled, shape inference can take more time since it descends
-  // into all function calls. It doesn't do inference once for each function
-  // definition, but once for each function call.
+  // into all function calls. The inferred output shapes of a function call are
+  // memoized by function instantiation and input shapes, so the body is only
+  // re-inferred for calls that differ in either.
   // The function library must outlive the shape refiner.
   void set_function_library_for_shape_inference(
       const tensorflow::FunctionLibraryDefinition* lib) {
@@ -188,6 +193,39 @@ class ShapeRefiner {
       const FunctionDef* function_def, AttrSlice attributes,
       shape_inference::InferenceContext* outer_context);
 
+  // Output shapes of a function call, stored independently of any
+  // InferenceContext so they can be replayed into the contexts of later calls.
+  struct FunctionShapes {
+    struct HandleShapeAndType {
+      TensorShapeProto shape;
+      DataType dtype;
+      FullTypeDef type;
+    };
+    std::vector<TensorShapeProto> output_shapes;
+    std::vector<std::optional<std::vector<HandleShapeAndType>>>
+        output_handle_shapes_and_types;
+    // Inputs whose constant value the function body asked for.
+    std::vector<int> requested_input_tensors;
+  };
+
+  // Returns the key under which the result of inferring the shapes of
+  // 'function_def' instantiated with 'attributes' is memoized, covering the
+  // input shapes, handle data and known constant inputs of 'outer_context'.
+  static std::string FunctionShapesKey(
+      const FunctionDef* function_def, AttrSlice attributes,
+      shape_inference::InferenceContext* outer_context);
+
+  // Sets the outputs of 'outer_context' to the memoized 'shapes'.
+  static Status ApplyFunctionShapes(
+      const FunctionShapes& shapes,
+      shape_inference::InferenceContext* outer_context);
+
+  // Records the outputs of 'outer_context' after the function body was
+  // inferred.
+  static void RecordFunctionShapes(
+      shape_inference::InferenceContext* outer_context,
+      FunctionShapes* shapes);
+
   // Performs shape inference for a node inside a function.
   //
   // 'outer_context' is the 'InferenceContext' for the function's call op.
@@ -327,6 +365,12 @@ class ShapeRefiner {
   // are refined.
   absl::flat_hash_map<std::string, std::unique_ptr<const Graph>> functions_;
 
+  // Memoizes the output shapes of function calls, keyed by
+  // FunctionShapesKey(). Calls to the same function with the same input
+  // shapes, e.g. repeated instantiations of a loop body, skip re-running shape
+  // inference over the function graph.
+  absl::flat_hash_map<std::string, FunctionShapes> function_shapes_;
+
   ShapeRefiner(const ShapeRefiner&) = delete;
   void operator=(const ShapeRefiner&) = delete;
 };
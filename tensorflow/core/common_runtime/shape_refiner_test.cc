@@ -59,6 +59,10 @@ class ShapeRefinerTest : public ::testing::Test {
     return ShapeRefiner::IsUpdatedShapesOrTypes(c, existing, updated);
   }
 
+  static size_t NumMemoizedFunctionShapes(const ShapeRefiner& m) {
+    return m.function_shapes_.size();
+  }
+
   static constexpr int64_t kMaxTensorSize = ShapeRefiner::kMaxTensorSize;
 
   void TestStridedSlice(const PartialTensorShape& input_shape, int begin,
@@ -1527,6 +1531,77 @@ TEST_F(ShapeRefinerTest, ChainedFunctionShapeInferenceWithMultipleInputs) {
   EXPECT_SHAPE("[3,3]", m, wxplusb16, 0);
 }
 
+TEST_F(ShapeRefinerTest, FunctionShapeInferenceIsMemoized) {
+  FunctionDefLibrary f_lib_proto;
+  *(f_lib_proto.add_function()) = test::function::XTimesTwo();
+  FunctionLibraryDefinition f_lib(OpRegistry::Global(), f_lib_proto);
+
+  Scope root = Scope::NewRootScope();
+  TF_ASSERT_OK(root.graph()->AddFunctionLibrary(f_lib_proto));
+  auto x = ops::Const(root, {{1.0f, 2.0f}});
+  auto y = ops::Const(root, {{1.0f, 2.0f}});
+  auto z = ops::Const(root, {1.0f, 2.0f, 3.0f});
+  auto x2 = test::function::Call(&root, "x2", "XTimesTwo", {x});
+  auto y2 = test::function::Call(&root, "y2", "XTimesTwo", {y});
+  auto z2 = test::function::Call(&root, "z2", "XTimesTwo", {z});
+
+  ShapeRefiner m(TF_GRAPH_DEF_VERSION, &f_lib);
+  m.set_function_library_for_shape_inference(&f_lib);
+
+  TF_ASSERT_OK(m.AddNode(x.node()));
+  TF_ASSERT_OK(m.AddNode(y.node()));
+  TF_ASSERT_OK(m.AddNode(z.node()));
+  TF_ASSERT_OK(m.AddNode(x2.node()));
+  EXPECT_EQ(NumMemoizedFunctionShapes(m), 1);
+
+  // Same function and input shapes: served from the memo.
+  TF_ASSERT_OK(m.AddNode(y2.node()));
+  EXPECT_EQ(NumMemoizedFunctionShapes(m), 1);
+
+  // Different input shapes are inferred separately.
+  TF_ASSERT_OK(m.AddNode(z2.node()));
+  EXPECT_EQ(NumMemoizedFunctionShapes(m), 2);
+
+  EXPECT_SHAPE("[1,2]", m, x2, 0);
+  EXPECT_SHAPE("[1,2]", m, y2, 0);
+  EXPECT_SHAPE("[3]", m, z2, 0);
+}
+
+TEST_F(ShapeRefinerTest, MemoizedFunctionShapesKeepResourceHandles) {
+  FunctionDefLibrary f_lib_proto;
+  *(f_lib_proto.add_function()) = test::function::Swap();
+  FunctionLibraryDefinition f_lib(OpRegistry::Global(), f_lib_proto);
+
+  Scope root = Scope::NewRootScope().ExitOnError();
+  TF_ASSERT_OK(root.graph()->AddFunctionLibrary(f_lib_proto));
+
+  auto x1 = ops::VarHandleOp(root, DataType::DT_FLOAT, TensorShape({128, 256}));
+  auto x2 = ops::VarHandleOp(root, DataType::DT_DOUBLE, TensorShape({1024}));
+  auto x3 = ops::VarHandleOp(root, DataType::DT_DOUBLE, TensorShape({512}));
+  auto swap = test::function::Call(&root, "swap", "Swap", {x1, x2});
+  auto swap_again = test::function::Call(&root, "swap_again", "Swap", {x1, x2});
+  auto swap_other = test::function::Call(&root, "swap_other", "Swap", {x1, x3});
+
+  ShapeRefiner m(TF_GRAPH_DEF_VERSION, &f_lib);
+  m.set_function_library_for_shape_inference(&f_lib);
+
+  TF_ASSERT_OK(m.AddNode(x1.node()));
+  TF_ASSERT_OK(m.AddNode(x2.node()));
+  TF_ASSERT_OK(m.AddNode(x3.node()));
+  TF_ASSERT_OK(m.AddNode(swap.node()));
+  TF_ASSERT_OK(m.AddNode(swap_again.node()));
+  EXPECT_EQ(NumMemoizedFunctionShapes(m), 1);
+  // The handle data differs, so the memoized shapes don't apply.
+  TF_ASSERT_OK(m.AddNode(swap_other.node()));
+  EXPECT_EQ(NumMemoizedFunctionShapes(m), 2);
+
+  EXPECT_RESOURCE_SINGLE_SHAPE("[1024]", m, swap_again, 0);
+  EXPECT_RESOURCE_SINGLE_SHAPE("[128,256]", m, swap_again, 1);
+  EXPECT_RESOURCE_SINGLE_TYPE(DataType::DT_DOUBLE, m, swap_again, 0);
+  EXPECT_RESOURCE_SINGLE_TYPE(DataType::DT_FLOAT, m, swap_again, 1);
+  EXPECT_RESOURCE_SINGLE_SHAPE("[512]", m, swap_other, 0);
+}
+
 TEST_F(ShapeRefinerTest, FunctionShapeInferenceWorksForResourceHandles) {
   FunctionDefLibrary f_lib_proto;
   *(f_lib_proto.add_function()) = test::function::Swap();
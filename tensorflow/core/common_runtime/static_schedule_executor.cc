@@ -0,0 +1,745 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_schedule_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/common_runtime/entry.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/renamed_device.h"
+#include "tensorflow/core/common_runtime/single_threaded_executor.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace {
+
+typedef gtl::InlinedVector<TensorValue, 4> TensorValueVec;
+typedef gtl::InlinedVector<AllocatorAttributes, 4> AllocatorAttributeVec;
+
+static const string& kStaticScheduleExecutor =
+    *new string("STATIC_SCHEDULE_EXECUTOR");
+
+// Relative costs used to balance the lanes of the schedule.
+constexpr int64_t kInexpensiveKernelCost = 1;
+constexpr int64_t kExpensiveKernelCost = 10;
+// The cost of handing the outputs of a kernel over to a kernel on another lane.
+constexpr int64_t kCrossLaneCost = 5;
+
+class StaticScheduleExecutorImpl : public Executor {
+ public:
+  explicit StaticScheduleExecutorImpl(const LocalExecutorParams& params)
+      : params_(params) {}
+
+  ~StaticScheduleExecutorImpl() override {
+    for (const KernelState& kernel_state : kernels_) {
+      params_.delete_kernel(kernel_state.kernel);
+    }
+    for (const ConstTensorKernelState& kernel_state : const_tensor_kernels_) {
+      params_.delete_kernel(kernel_state.kernel);
+    }
+  }
+
+  Status Initialize(const Graph& graph, int num_threads) {
+    // Topologicially sort `graph` to get a sequence of OpKernels.
+    std::vector<Node*> ordered_nodes;
+    ordered_nodes.reserve(graph.num_nodes());
+    GetReversePostOrder(graph, &ordered_nodes);
+    if (static_cast<int>(ordered_nodes.size()) != graph.num_nodes()) {
+      return errors::InvalidArgument("Graph had ", graph.num_nodes(),
+                                     " but reverse post-order had ",
+                                     ordered_nodes.size());
+    }
+
+    std::vector<Node*> nodes_with_kernels;
+    std::vector<Node*> nodes_with_const_tensor_kernels;
+    std::map<size_t, Node*> arg_index_to_node_map;
+    absl::flat_hash_map<const Node*, size_t> node_to_index_map;
+
+    // Create the kernel and input-related structures for each node in `graph`.
+    for (Node* n : ordered_nodes) {
+      if (n->IsSource() || n->IsSink()) {
+        continue;
+      }
+      TF_RETURN_IF_ERROR(ValidateOpIsSafeForSyncExecution(
+          *n, params_.allow_control_flow_sync_execution));
+      if (n->IsRecv()) {
+        return errors::Unimplemented(
+            "Static schedule executor does not support receiving tensors from "
+            "other partitions, but saw node ",
+            n->name());
+      }
+      if (n->IsArg()) {
+        int32_t arg_index;
+        TF_RETURN_IF_ERROR(GetNodeAttr(n->attrs(), "index", &arg_index));
+        if (arg_index < 0) {
+          return errors::InvalidArgument("Invalid argument index ", arg_index,
+                                         " in node ", n->name());
+        }
+        arg_index_to_node_map[arg_index] = n;
+        // As in the single-threaded executor, arguments are forwarded directly
+        // to the inputs of the kernels that consume them.
+        continue;
+      }
+
+      OpKernel* kernel;
+      TF_RETURN_IF_ERROR(params_.create_kernel(n->properties(), &kernel));
+
+      const Tensor* const_tensor;
+      if (n->num_outputs() == 1 && (const_tensor = kernel->const_tensor())) {
+        // Constants are evaluated once, and forwarded to the inputs of their
+        // consumers at the beginning of each step.
+        const_tensor_kernels_.push_back({});
+        nodes_with_const_tensor_kernels.push_back(n);
+        ConstTensorKernelState& kernel_state = const_tensor_kernels_.back();
+        kernel_state.kernel = kernel;
+        kernel_state.const_tensor = *const_tensor;
+        kernel_state.output_alloc_attr.set_on_host(
+            kernel->output_memory_types()[0] == HOST_MEMORY);
+      } else {
+        const size_t kernel_index = kernels_.size();
+        kernels_.push_back({});
+        nodes_with_kernels.push_back(n);
+        KernelState& kernel_state = kernels_.back();
+        kernel_state.kernel = kernel;
+        kernel_state.num_inputs = n->num_inputs();
+        kernel_state.num_outputs = n->num_outputs();
+        node_to_index_map[n] = kernel_index;
+        kernel_state.input_start_index =
+            kernel_index == 0 ? 0
+                              : kernels_[kernel_index - 1].input_start_index +
+                                    kernels_[kernel_index - 1].num_inputs;
+      }
+    }
+    total_num_inputs_ =
+        kernels_.empty()
+            ? 0
+            : kernels_.back().input_start_index + kernels_.back().num_inputs;
+
+    input_alloc_attrs_.resize(total_num_inputs_);
+
+    // Returns the location in the flat `inputs` vector of the destination of
+    // `e`.
+    auto input_location = [&](const Edge* e) {
+      return kernels_[node_to_index_map[e->dst()]].input_start_index +
+             e->dst_input();
+    };
+
+    if (!arg_index_to_node_map.empty()) {
+      arg_output_locations_.resize(arg_index_to_node_map.rbegin()->first + 1);
+      for (const auto& [arg_index, arg_node] : arg_index_to_node_map) {
+        for (const Edge* e : arg_node->out_edges()) {
+          if (e->src_output() == Graph::kControlSlot) {
+            continue;
+          } else if (e->src_output() != 0) {
+            return errors::Internal("Invalid output index ", e->src_output(),
+                                    " from argument node ", arg_index);
+          }
+          arg_output_locations_[arg_index].push_back(input_location(e));
+        }
+      }
+    }
+
+    for (size_t i = 0; i < const_tensor_kernels_.size(); ++i) {
+      const Node* n = nodes_with_const_tensor_kernels[i];
+      for (const Edge* e : n->out_edges()) {
+        if (e->src_output() == Graph::kControlSlot) {
+          continue;
+        } else if (e->src_output() != 0) {
+          return errors::Internal("Invalid output index ", e->src_output(),
+                                  " from node ", n->DebugString());
+        }
+        ConstTensorKernelState& kernel_state = const_tensor_kernels_[i];
+        const size_t location = input_location(e);
+        kernel_state.output_locations.push_back(location);
+        input_alloc_attrs_[location] = kernel_state.output_alloc_attr;
+      }
+    }
+
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      const Node* n = nodes_with_kernels[i];
+      KernelState& kernel_state = kernels_[i];
+      kernel_state.output_locations.resize(kernel_state.num_outputs);
+      kernel_state.output_alloc_attrs.resize(kernel_state.num_outputs);
+      for (int out = 0; out < n->num_outputs(); ++out) {
+        if (kernel_state.kernel->output_memory_types()[out] == HOST_MEMORY) {
+          kernel_state.output_alloc_attrs[out].set_on_host(true);
+        }
+      }
+      for (const Edge* e : n->out_edges()) {
+        if (!e->IsControlEdge() && !e->dst()->IsSink()) {
+          const size_t location = input_location(e);
+          kernel_state.output_locations[e->src_output()].push_back(location);
+          input_alloc_attrs_[location] =
+              kernel_state.output_alloc_attrs[e->src_output()];
+        }
+      }
+    }
+
+    // The kernels that each kernel waits for. Arguments and constants are
+    // available from the beginning of the step.
+    std::vector<std::vector<size_t>> producers(kernels_.size());
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      absl::flat_hash_set<size_t> seen;
+      for (const Edge* e : nodes_with_kernels[i]->in_edges()) {
+        auto it = node_to_index_map.find(e->src());
+        if (it != node_to_index_map.end() && seen.insert(it->second).second) {
+          producers[i].push_back(it->second);
+        }
+      }
+    }
+    BuildSchedule(producers, std::max(num_threads, 1));
+    return OkStatus();
+  }
+
+  Status Run(const Args& args) override {
+    Status ret;
+    Notification n;
+    StartStep(
+        args,
+        [&ret, &n](const Status& s) {
+          ret = s;
+          n.Notify();
+        },
+        /*run_first_lane_inline=*/true);
+    n.WaitForNotification();
+    return ret;
+  }
+
+ private:
+  // The state of a step. Reused across steps, see `AcquireStepState()`.
+  struct StepState {
+    // The inputs of every kernel, laid out as in the single-threaded
+    // executor: the inputs of `kernels_[i]` start at
+    // `kernels_[i].input_start_index`. Every entry is empty between steps.
+    std::vector<Entry> inputs;
+
+    // For each kernel with inputs from other lanes, the number of those
+    // producers that have not completed, plus one until the lane of the
+    // kernel reaches it.
+    std::unique_ptr<std::atomic<int>[]> pending_counts;
+
+    // The number of lanes that have not reached their end.
+    std::atomic<int> num_running_lanes{0};
+
+    // Set once a kernel fails. The remaining kernels are skipped.
+    std::atomic<bool> aborted{false};
+
+    mutex mu;
+    Status status TF_GUARDED_BY(mu);
+
+    Device* device = nullptr;
+    std::unique_ptr<Device> user_device;
+    Args::Runner runner;
+    // The parameters shared by all kernels of the step.
+    OpKernelContext::Params params;
+    DoneCallback done;
+  };
+
+  // Runs all operations through `args.runner`, as the default executor does.
+  void RunAsyncInternal(const Args& args, DoneCallback done) override {
+    StartStep(args, std::move(done), /*run_first_lane_inline=*/false);
+  }
+
+  // Assigns each kernel to a lane by list scheduling in topological order:
+  // each kernel goes to the lane on which it can start the earliest, given
+  // the estimated finish time of its producers and the cost of receiving
+  // their outputs from another lane, preferring the lane of its last producer
+  // on ties.
+  void BuildSchedule(const std::vector<std::vector<size_t>>& producers,
+                     int num_threads) {
+    std::vector<int64_t> lane_finish_times(num_threads, 0);
+    std::vector<int64_t> finish_times(kernels_.size(), 0);
+    std::vector<int> lanes(kernels_.size(), 0);
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      int preferred_lane = -1;
+      int64_t last_producer_finish_time = -1;
+      for (const size_t producer : producers[i]) {
+        if (finish_times[producer] > last_producer_finish_time) {
+          last_producer_finish_time = finish_times[producer];
+          preferred_lane = lanes[producer];
+        }
+      }
+      int best_lane = 0;
+      int64_t best_start_time = std::numeric_limits<int64_t>::max();
+      for (int lane = 0; lane < num_threads; ++lane) {
+        int64_t start_time = lane_finish_times[lane];
+        for (const size_t producer : producers[i]) {
+          start_time = std::max(
+              start_time, finish_times[producer] +
+                              (lanes[producer] == lane ? 0 : kCrossLaneCost));
+        }
+        if (start_time < best_start_time ||
+            (start_time == best_start_time && lane == preferred_lane)) {
+          best_start_time = start_time;
+          best_lane = lane;
+        }
+      }
+      lanes[i] = best_lane;
+      finish_times[i] =
+          best_start_time + (kernels_[i].kernel->IsExpensive()
+                                 ? kExpensiveKernelCost
+                                 : kInexpensiveKernelCost);
+      lane_finish_times[best_lane] = finish_times[i];
+    }
+
+    // Drops the lanes without kernels, and records the dependencies between
+    // kernels of different lanes.
+    std::vector<int> lane_ids(num_threads, -1);
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      int& lane_id = lane_ids[lanes[i]];
+      if (lane_id < 0) {
+        lane_id = lanes_.size();
+        lanes_.emplace_back();
+      }
+      KernelState& kernel_state = kernels_[i];
+      kernel_state.lane = lane_id;
+      kernel_state.lane_position = lanes_[lane_id].size();
+      lanes_[lane_id].push_back(i);
+
+      int num_cross_lane_producers = 0;
+      for (const size_t producer : producers[i]) {
+        if (lanes[producer] != lanes[i]) {
+          kernels_[producer].cross_lane_consumers.push_back(i);
+          ++num_cross_lane_producers;
+        }
+      }
+      if (num_cross_lane_producers > 0) {
+        kernel_state.initial_pending_count = num_cross_lane_producers + 1;
+        kernels_with_cross_lane_producers_.push_back(i);
+      }
+    }
+    VLOG(1) << "Scheduled " << kernels_.size() << " kernels on "
+            << lanes_.size() << " lanes, with "
+            << kernels_with_cross_lane_producers_.size()
+            << " kernels waiting for other lanes.";
+  }
+
+  std::unique_ptr<StepState> AcquireStepState() {
+    {
+      mutex_lock l(step_states_mu_);
+      if (!free_step_states_.empty()) {
+        std::unique_ptr<StepState> step = std::move(free_step_states_.back());
+        free_step_states_.pop_back();
+        return step;
+      }
+    }
+    auto step = std::make_unique<StepState>();
+    step->inputs.resize(total_num_inputs_);
+    step->pending_counts.reset(new std::atomic<int>[kernels_.size()]);
+    return step;
+  }
+
+  void ReleaseStepState(std::unique_ptr<StepState> step) {
+    step->user_device.reset();
+    step->runner = nullptr;
+    if (step->params.op_device_context != nullptr) {
+      step->params.op_device_context->Unref();
+    }
+    step->params = OpKernelContext::Params();
+    mutex_lock l(step_states_mu_);
+    free_step_states_.push_back(std::move(step));
+  }
+
+  void StartStep(const Args& args, DoneCallback done,
+                 bool run_first_lane_inline) {
+    std::unique_ptr<StepState> step = AcquireStepState();
+
+    // Override intra op thread pool if requested.
+    step->device = params_.device;
+    if (args.user_intra_op_threadpool != nullptr) {
+      step->user_device = RenamedDevice::NewRenamedDevice(
+          params_.device->name(), params_.device, /*owns_underlying=*/false,
+          /*isolate_session_state=*/false, args.user_intra_op_threadpool);
+      step->device = step->user_device.get();
+    }
+    step->runner = args.runner;
+
+    // Prepare the parameters that will be the same for all kernels.
+    OpKernelContext::Params& params = step->params;
+    params.step_id = args.step_id;
+    params.device = step->device;
+    params.log_memory = false;
+    params.rendezvous = args.rendezvous;
+    params.session_state = args.session_state;
+    params.session_metadata = params_.session_metadata;
+    params.tensor_store = args.tensor_store;
+    params.cancellation_manager = args.cancellation_manager;
+    params.call_frame = args.call_frame;
+    params.function_library = params_.function_library;
+    params.resource_manager = step->device->resource_manager();
+    params.step_container = args.step_container;
+    params.collective_executor = args.collective_executor;
+    params.stack_trace = args.stack_trace;
+    params.slice_reader_cache = nullptr;
+    params.runner = &step->runner;
+    params.run_all_kernels_inline = args.run_all_kernels_inline;
+    params.stats_collector = args.stats_collector;
+    params.executor_type = &kStaticScheduleExecutor;
+    // The graph is loopless and condless.
+    params.frame_iter = FrameAndIter(0, 0);
+    params.is_input_dead = false;
+    params.forward_from_array = nullptr;
+    step->device->TryGetDeviceContext(&params.op_device_context)
+        .IgnoreError();
+
+    Status s = ForwardArgs(args, step.get());
+    if (!s.ok()) {
+      for (Entry& input : step->inputs) {
+        input.ClearVal();
+      }
+      ReleaseStepState(std::move(step));
+      done(s);
+      return;
+    }
+    for (const ConstTensorKernelState& kernel_state : const_tensor_kernels_) {
+      for (const size_t location : kernel_state.output_locations) {
+        Entry& input = step->inputs[location];
+        input.state = Entry::State::HAS_CONST_TENSOR;
+        input.const_tensor = &kernel_state.const_tensor;
+      }
+    }
+
+    if (lanes_.empty()) {
+      ReleaseStepState(std::move(step));
+      done(OkStatus());
+      return;
+    }
+    for (const size_t i : kernels_with_cross_lane_producers_) {
+      step->pending_counts[i].store(kernels_[i].initial_pending_count,
+                                    std::memory_order_relaxed);
+    }
+    step->num_running_lanes.store(lanes_.size(), std::memory_order_relaxed);
+    step->aborted.store(false, std::memory_order_relaxed);
+    {
+      mutex_lock l(step->mu);
+      step->status = OkStatus();
+    }
+    step->done = std::move(done);
+
+    // The first lane is started last, so that the step, which completes when
+    // all lanes have reached their end, outlives the loop.
+    StepState* const step_ptr = step.release();
+    for (int lane = lanes_.size() - 1; lane > 0; --lane) {
+      step_ptr->runner([this, step_ptr, lane]() {
+        RunLane(step_ptr, lane, /*position=*/0, /*resumed=*/false);
+      });
+    }
+    if (run_first_lane_inline) {
+      RunLane(step_ptr, /*lane=*/0, /*position=*/0, /*resumed=*/false);
+    } else {
+      step_ptr->runner([this, step_ptr]() {
+        RunLane(step_ptr, /*lane=*/0, /*position=*/0, /*resumed=*/false);
+      });
+    }
+  }
+
+  // Forwards the arguments of the step to the inputs of the kernels that
+  // consume them.
+  Status ForwardArgs(const Args& args, StepState* step) const {
+    const size_t received_args =
+        args.call_frame ? args.call_frame->num_args() : 0;
+    if (TF_PREDICT_FALSE(arg_output_locations_.size() > received_args)) {
+      return errors::InvalidArgument("Expected ", arg_output_locations_.size(),
+                                     " arguments, but only received ",
+                                     received_args, ".");
+    }
+    for (size_t i = 0; i < arg_output_locations_.size(); ++i) {
+      const std::vector<size_t>& locations = arg_output_locations_[i];
+      if (locations.empty()) {
+        continue;
+      }
+      if (args.call_frame->CanConsumeArg(i)) {
+        // The first destination input can consume the argument, and the
+        // others get a shallow copy of it.
+        Entry& first_input = step->inputs[locations[0]];
+        first_input.state = Entry::State::HAS_VALUE;
+        first_input.val.Init();
+        args.call_frame->ConsumeArg(i, first_input.val.get());
+        for (size_t j = 1; j < locations.size(); ++j) {
+          Entry& input = step->inputs[locations[j]];
+          input.state = Entry::State::HAS_VALUE;
+          input.val.Init(*first_input.val);
+        }
+      } else {
+        const Tensor* arg;
+        TF_RETURN_IF_ERROR(args.call_frame->GetArg(i, &arg));
+        for (const size_t location : locations) {
+          // Shallow copies keep the reference count of the argument above one
+          // until all consuming kernels have run, which inhibits forwarding.
+          Entry& input = step->inputs[location];
+          input.state = Entry::State::HAS_VALUE;
+          input.val.Init(*arg);
+        }
+      }
+    }
+    return OkStatus();
+  }
+
+  // Runs the kernels of `lane`, starting at `position`, until the lane ends or
+  // reaches a kernel that still waits for another lane. That kernel's last
+  // producer resumes the lane. `resumed` is true if the kernel at `position`
+  // no longer waits.
+  void RunLane(StepState* step, int lane, size_t position, bool resumed) {
+    const std::vector<size_t>& lane_kernels = lanes_[lane];
+    OpKernelContext::Params params = step->params;
+    TensorValueVec node_inputs;
+    AllocatorAttributeVec input_alloc_attrs;
+    for (size_t p = position; p < lane_kernels.size(); ++p) {
+      const size_t i = lane_kernels[p];
+      const KernelState& kernel_state = kernels_[i];
+      if (kernel_state.initial_pending_count > 0 &&
+          !(resumed && p == position) &&
+          step->pending_counts[i].fetch_sub(1, std::memory_order_acq_rel) !=
+              1) {
+        return;
+      }
+
+      RunKernel(step, i, &params, &node_inputs, &input_alloc_attrs);
+
+      for (const size_t consumer : kernel_state.cross_lane_consumers) {
+        if (step->pending_counts[consumer].fetch_sub(
+                1, std::memory_order_acq_rel) == 1) {
+          // The lane of `consumer` is waiting for this kernel. This lane has
+          // not reached its end, so the step outlives the closure.
+          const KernelState& consumer_state = kernels_[consumer];
+          step->runner([this, step, lane = consumer_state.lane,
+                        position = consumer_state.lane_position]() {
+            RunLane(step, lane, position, /*resumed=*/true);
+          });
+        }
+      }
+    }
+
+    if (step->num_running_lanes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Status status;
+      {
+        mutex_lock l(step->mu);
+        status = step->status;
+      }
+      DoneCallback done = std::move(step->done);
+      ReleaseStepState(std::unique_ptr<StepState>(step));
+      done(status);
+    }
+  }
+
+  // Runs `kernels_[i]` and forwards its outputs to the inputs of its
+  // consumers. If the step has already failed, only clears the inputs of the
+  // kernel.
+  void RunKernel(StepState* step, size_t i, OpKernelContext::Params* params,
+                 TensorValueVec* node_inputs,
+                 AllocatorAttributeVec* input_alloc_attrs) {
+    const KernelState& kernel_state = kernels_[i];
+    Entry* const inputs = step->inputs.data() + kernel_state.input_start_index;
+    const size_t num_inputs = kernel_state.num_inputs;
+    const size_t num_outputs = kernel_state.num_outputs;
+    if (step->aborted.load(std::memory_order_relaxed)) {
+      for (size_t j = 0; j < num_inputs; ++j) {
+        inputs[j].ClearVal();
+      }
+      return;
+    }
+
+    node_inputs->clear();
+    node_inputs->resize(num_inputs);
+    input_alloc_attrs->clear();
+    input_alloc_attrs->resize(num_inputs);
+    for (size_t j = 0; j < num_inputs; ++j) {
+      Entry& input = inputs[j];
+      switch (input.state) {
+        case Entry::State::HAS_CONST_TENSOR:
+          // See the single-threaded executor for why the `const_cast` is safe.
+          (*node_inputs)[j].tensor = const_cast<Tensor*>(input.const_tensor);
+          break;
+        case Entry::State::HAS_VALUE:
+          (*node_inputs)[j].tensor = input.val.get();
+          break;
+        default:
+          DCHECK(false) << "Input did not have a valid value.";
+      }
+      (*input_alloc_attrs)[j] =
+          input_alloc_attrs_[kernel_state.input_start_index + j];
+    }
+    params->inputs = *node_inputs;
+    params->input_alloc_attrs = *input_alloc_attrs;
+    params->op_kernel = kernel_state.kernel;
+    params->output_attr_array = kernel_state.output_alloc_attrs.data();
+    OpKernelContext ctx(params, num_outputs);
+    step->device->Compute(kernel_state.kernel, &ctx);
+
+    for (size_t j = 0; j < num_inputs; ++j) {
+      inputs[j].ClearVal();
+    }
+    if (TF_PREDICT_FALSE(!ctx.status().ok())) {
+      mutex_lock l(step->mu);
+      if (step->status.ok()) {
+        step->status = ctx.status();
+      }
+      step->aborted.store(true, std::memory_order_relaxed);
+      return;
+    }
+
+    for (size_t j = 0; j < num_outputs; ++j) {
+      TensorValue val = ctx.release_output(j);
+      const std::vector<size_t>& locations = kernel_state.output_locations[j];
+      for (size_t k = 0; k < locations.size(); ++k) {
+        Entry& input = step->inputs[locations[k]];
+        input.state = Entry::State::HAS_VALUE;
+        if (val.tensor == nullptr) {
+          input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
+        } else if (k + 1 < locations.size()) {
+          input.val.Init(*val.tensor);
+        } else {
+          // Move the output to the last consumer to avoid copying it.
+          input.val.Init(std::move(*val.tensor));
+        }
+      }
+      delete val.tensor;
+    }
+  }
+
+  const LocalExecutorParams params_;
+
+  // All following members are read-only after Initialize().
+
+  // The sum of the number of inputs for each kernel.
+  size_t total_num_inputs_ = 0;
+
+  struct KernelState {
+    // The kernel object. Not owned.
+    //
+    // This pointer is managed by `params_.create_kernel()` and
+    // `params_.delete_kernel()`.
+    OpKernel* kernel;
+
+    // These fields determine the range of elements in `StepState::inputs`
+    // that corresponds to the inputs of `kernel`.
+    size_t input_start_index;
+    size_t num_inputs;
+
+    size_t num_outputs;
+
+    // For the `j`th output of `kernel`, `output_locations[j]` contains the
+    // locations in `StepState::inputs` to which that output must be copied.
+    std::vector<std::vector<size_t>> output_locations;
+
+    // Memory space information for each output of `kernel`.
+    std::vector<AllocatorAttributes> output_alloc_attrs;
+
+    // The lane that runs `kernel`, and the index of `kernel` in that lane.
+    int lane = 0;
+    size_t lane_position = 0;
+
+    // The initial value of `StepState::pending_counts` for this kernel, or 0
+    // if all its producers run on its own lane.
+    int initial_pending_count = 0;
+
+    // The kernels on other lanes that wait for `kernel`.
+    std::vector<size_t> cross_lane_consumers;
+  };
+  std::vector<KernelState> kernels_;
+
+  // The indices in `kernels_` of the kernels that each lane runs, in
+  // topological order.
+  std::vector<std::vector<size_t>> lanes_;
+
+  // The indices in `kernels_` of the kernels with a nonzero
+  // `initial_pending_count`.
+  std::vector<size_t> kernels_with_cross_lane_producers_;
+
+  // For the `i`th argument, `arg_output_locations_[i]` contains the locations
+  // in `StepState::inputs` to which that argument must be copied.
+  std::vector<std::vector<size_t>> arg_output_locations_;
+
+  // Represents cached graph structure state for each kernel that produces
+  // a single constant-valued tensor.
+  struct ConstTensorKernelState {
+    // The kernel object. Not owned.
+    OpKernel* kernel;
+
+    // The cached value of `kernel->const_tensor()`, which keeps the reference
+    // count of the underlying buffer above one, so that no kernel forwards it.
+    Tensor const_tensor;
+
+    // The locations in `StepState::inputs` to which the single output of
+    // `kernel` must be copied.
+    std::vector<size_t> output_locations;
+
+    // Memory space information for the single output of `kernel`.
+    AllocatorAttributes output_alloc_attr;
+  };
+  std::vector<ConstTensorKernelState> const_tensor_kernels_;
+
+  // Memory space information for each location in `StepState::inputs`.
+  std::vector<AllocatorAttributes> input_alloc_attrs_;
+
+  // The states of the steps that have completed, reused by the next steps.
+  mutex step_states_mu_;
+  std::vector<std::unique_ptr<StepState>> free_step_states_
+      TF_GUARDED_BY(step_states_mu_);
+};
+
+class StaticScheduleExecutorRegistrar {
+ public:
+  StaticScheduleExecutorRegistrar() {
+    ExecutorFactory::Register(kStaticScheduleExecutor, new Factory());
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret;
+      TF_RETURN_IF_ERROR(NewStaticScheduleExecutor(
+          params, graph, port::MaxParallelism(), &ret));
+      out_executor->reset(ret);
+      return OkStatus();
+    }
+  };
+};
+static StaticScheduleExecutorRegistrar registrar;
+
+}  // namespace
+
+Status NewStaticScheduleExecutor(const LocalExecutorParams& params,
+                                 const Graph& graph, int num_threads,
+                                 Executor** executor) {
+  auto impl = std::make_unique<StaticScheduleExecutorImpl>(params);
+  TF_RETURN_IF_ERROR(impl->Initialize(graph, num_threads));
+  *executor = impl.release();
+  return OkStatus();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,52 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
+
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/local_executor_params.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/status.h"
+
+namespace tensorflow {
+
+// Creates a new `Executor` for executing `graph` with a schedule that is
+// computed once, when the executor is created.
+//
+// The executor assigns every kernel to one of at most `num_threads` lanes,
+// balancing the estimated cost of the lanes and keeping producers and consumers
+// on the same lane whenever that does not delay the consumer. Each step runs
+// every lane in topological order on its own closure of `Args::runner`. Only
+// the dependencies between kernels of different lanes are tracked at run
+// time, with one precomputed counter per kernel, so that the per-step cost of
+// scheduling small ops is close to that of the single-threaded executor. The
+// kernels and the buffers that hold the inputs of the kernels are reused
+// across steps.
+//
+// The executor has the same limitations as the single-threaded executor (see
+// "single_threaded_executor.h"). In addition, graphs with "_Recv" nodes are
+// not supported, because a lane blocked on a rendezvous would block the
+// kernels scheduled after it on the same lane.
+//
+// The executor is registered as "STATIC_SCHEDULE_EXECUTOR", with one lane per
+// schedulable CPU.
+Status NewStaticScheduleExecutor(const LocalExecutorParams& params,
+                                 const Graph& graph, int num_threads,
+                                 Executor** executor);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
@@ -0,0 +1,278 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_schedule_executor.h"
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/versions.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kNumThreads = 4;
+
+class StaticScheduleExecutorTest : public ::testing::Test {
+ protected:
+  StaticScheduleExecutorTest()
+      : device_(DeviceFactory::NewDevice("CPU", {},
+                                         "/job:localhost/replica:0/task:0")),
+        thread_pool_(Env::Default(), "test", kNumThreads) {}
+
+  Status Create(std::unique_ptr<const Graph> graph) {
+    const int version = graph->versions().producer();
+    LocalExecutorParams params;
+    params.device = device_.get();
+    params.create_kernel =
+        [this, version](const std::shared_ptr<const NodeProperties>& props,
+                        OpKernel** kernel) {
+          return CreateNonCachedKernel(device_.get(), nullptr, props, version,
+                                       kernel);
+        };
+    params.delete_kernel = [](OpKernel* kernel) {
+      DeleteNonCachedKernel(kernel);
+    };
+    Executor* exec;
+    TF_RETURN_IF_ERROR(
+        NewStaticScheduleExecutor(params, *graph, kNumThreads, &exec));
+    exec_.reset(exec);
+    return OkStatus();
+  }
+
+  Executor::Args MakeArgs(CallFrameInterface* call_frame) {
+    Executor::Args args;
+    args.call_frame = call_frame;
+    args.runner = [this](std::function<void()> fn) {
+      thread_pool_.Schedule(std::move(fn));
+    };
+    return args;
+  }
+
+  Status Run(CallFrameInterface* call_frame) {
+    return exec_->Run(MakeArgs(call_frame));
+  }
+
+  std::unique_ptr<Device> device_;
+  thread::ThreadPool thread_pool_;
+  std::unique_ptr<Executor> exec_;
+};
+
+// A float val -> Tensor<float>
+Tensor V(const float val) {
+  Tensor tensor(DT_FLOAT, TensorShape({}));
+  tensor.scalar<float>()() = val;
+  return tensor;
+}
+
+// Tensor<float> -> a float val.
+float V(const Tensor& tensor) {
+  CHECK_EQ(tensor.dtype(), DT_FLOAT);
+  CHECK(TensorShapeUtils::IsScalar(tensor.shape()));
+  return tensor.scalar<float>()();
+}
+
+TEST_F(StaticScheduleExecutorTest, SimpleAdd) {
+  // c = a + b
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  auto in1 = test::graph::Arg(g.get(), 1, DT_FLOAT);
+  auto tmp = test::graph::Add(g.get(), in0, in1);
+  test::graph::Retval(g.get(), 0, tmp);
+  FixupSourceAndSinkEdges(g.get());
+  TF_ASSERT_OK(Create(std::move(g)));
+  FunctionCallFrame call_frame({DT_FLOAT, DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0), V(2.0)}));
+  TF_ASSERT_OK(Run(&call_frame));
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(3.0, V(retvals[0]));  // out = 1.0 + 2.0 = 3.0
+}
+
+// Builds a graph with `width` chains of v = v + v, `depth` deep, which start
+// from argument 0 and are summed up into return value 0.
+void BuildChains(int width, int depth, Graph* g) {
+  auto in = test::graph::Arg(g, 0, DT_FLOAT);
+  Node* sum = nullptr;
+  for (int i = 0; i < width; ++i) {
+    Node* v = in;
+    for (int j = 0; j < depth; ++j) {
+      v = test::graph::Add(g, v, v);
+    }
+    sum = sum == nullptr ? v : test::graph::Add(g, sum, v);
+  }
+  test::graph::Retval(g, 0, sum);
+  FixupSourceAndSinkEdges(g);
+}
+
+TEST_F(StaticScheduleExecutorTest, Chains) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildChains(/*width=*/16, /*depth=*/8, g.get());
+  TF_ASSERT_OK(Create(std::move(g)));
+  // Runs several steps, which reuse the same step state.
+  for (int step = 0; step < 10; ++step) {
+    FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+    TF_ASSERT_OK(call_frame.SetArgs({V(step)}));
+    TF_ASSERT_OK(Run(&call_frame));
+    std::vector<Tensor> retvals;
+    TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+    EXPECT_EQ(16 * 256.0 * step, V(retvals[0]));  // out = 16 * 2^8 * a
+  }
+}
+
+// Builds a graph which adds N copies of one variable "in", parenthesized
+// randomly.
+void BuildTree(int N, Graph* g) {
+  CHECK_GT(N, 1);
+  auto in = test::graph::Arg(g, 0, DT_FLOAT);
+  std::vector<Node*> nodes;
+  for (int i = 0; i < N; ++i) {
+    nodes.push_back(test::graph::Identity(g, in, 0));
+  }
+  random::PhiloxRandom philox(0, 17);
+  random::SimplePhilox rnd(&philox);
+  while (nodes.size() > 1) {
+    int x = rnd.Uniform(nodes.size());
+    auto in0 = nodes[x];
+    nodes[x] = nodes.back();
+    nodes.resize(nodes.size() - 1);
+    x = rnd.Uniform(nodes.size());
+    auto in1 = nodes[x];
+    nodes[x] = test::graph::Add(g, in0, in1);
+  }
+  test::graph::Retval(g, 0, nodes.back());
+  FixupSourceAndSinkEdges(g);
+}
+
+TEST_F(StaticScheduleExecutorTest, RandomTree) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  TF_ASSERT_OK(Create(std::move(g)));
+  FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+  TF_ASSERT_OK(Run(&call_frame));
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(4096.0, V(retvals[0]));
+}
+
+TEST_F(StaticScheduleExecutorTest, RunAsync) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildChains(/*width=*/8, /*depth=*/4, g.get());
+  TF_ASSERT_OK(Create(std::move(g)));
+  FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+  Status status;
+  Notification done;
+  exec_->RunAsync(MakeArgs(&call_frame), [&](const Status& s) {
+    status = s;
+    done.Notify();
+  });
+  done.WaitForNotification();
+  TF_ASSERT_OK(status);
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(8 * 16.0, V(retvals[0]));
+}
+
+TEST_F(StaticScheduleExecutorTest, OpError) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto zero = test::graph::Constant(g.get(), V(0.0));
+  auto inf = test::graph::Unary(g.get(), "Reciprocal", zero);
+  auto check = test::graph::CheckNumerics(g.get(), inf, "message");
+  auto two = test::graph::Constant(g.get(), V(2.0));
+  test::graph::Binary(g.get(), "Mul", check, two);
+  FixupSourceAndSinkEdges(g.get());
+  TF_ASSERT_OK(Create(std::move(g)));
+  FunctionCallFrame call_frame({}, {});
+  EXPECT_TRUE(absl::IsInvalidArgument(Run(&call_frame)));
+  // The failed step does not leak into the next one.
+  EXPECT_TRUE(absl::IsInvalidArgument(Run(&call_frame)));
+}
+
+TEST_F(StaticScheduleExecutorTest, MissingArgs) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildChains(/*width=*/2, /*depth=*/2, g.get());
+  TF_ASSERT_OK(Create(std::move(g)));
+  FunctionCallFrame call_frame({}, {DT_FLOAT});
+  EXPECT_TRUE(absl::IsInvalidArgument(Run(&call_frame)));
+}
+
+TEST_F(StaticScheduleExecutorTest, RecvNotSupported) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in = test::graph::Recv(g.get(), "a", "float",
+                              "/job:j/replica:0/task:0/cpu:0", 1,
+                              "/job:j/replica:0/task:0/cpu:1");
+  test::graph::Retval(g.get(), 0, in);
+  FixupSourceAndSinkEdges(g.get());
+  EXPECT_TRUE(absl::IsUnimplemented(Create(std::move(g))));
+}
+
+// Create a graph with 'width' chains of 'depth' small matmuls.
+void BM_executor(::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor weights_t(DT_FLOAT, TensorShape({16, 16}));
+  weights_t.flat<float>().setRandom();
+  Node* weights = test::graph::Constant(g, weights_t);
+  for (int i = 0; i < width; ++i) {
+    Node* v = weights;
+    for (int j = 0; j < depth; ++j) {
+      v = test::graph::Matmul(g, v, weights, false, false);
+    }
+  }
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, nullptr, nullptr, nullptr,
+                  "STATIC_SCHEDULE_EXECUTOR", /*old_benchmark_api=*/false)
+      .Run(state);
+  const int64_t num_nodes = 1 + width * depth;
+  state.SetLabel(strings::StrCat("Nodes = ", num_nodes));
+  state.SetItemsProcessed(num_nodes * static_cast<int64_t>(state.iterations()));
+}
+
+// Tall skinny graphs
+BENCHMARK(BM_executor)->UseRealTime()->ArgPair(4, 256);
+
+// Short fat graphs
+BENCHMARK(BM_executor)->UseRealTime()->ArgPair(256, 4);
+
+// Tall fat graph
+BENCHMARK(BM_executor)->UseRealTime()->ArgPair(64, 64);
+
+}  // namespace
+}  // namespace tensorflow
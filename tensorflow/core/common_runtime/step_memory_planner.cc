@@ -0,0 +1,220 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_memory_planner.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace {
+
+// Identifies an output by its kernel and its index.
+using OutputKey = std::pair<const OpKernel*, int>;
+
+// Aliases the bytes [offset, offset + size) of the buffer of a step.
+class ArenaSliceBuffer : public TensorBuffer {
+ public:
+  ArenaSliceBuffer(Tensor buffer, size_t offset, size_t size)
+      : TensorBuffer(buffer.flat<int8>().data() + offset),
+        buffer_(std::move(buffer)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("step_memory_arena");
+  }
+  // Prevents the slice from being forwarded to an output that has no slot.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  // Keeps the buffer alive, and tells the planner that it is still in use.
+  const Tensor buffer_;
+  const size_t size_;
+};
+
+size_t AlignedSize(size_t bytes) {
+  return (bytes + Allocator::kAllocatorAlignment - 1) /
+         Allocator::kAllocatorAlignment * Allocator::kAllocatorAlignment;
+}
+
+}  // namespace
+
+struct StepMemoryPlanner::Plan {
+  struct Slot {
+    size_t offset;
+    size_t bytes;
+  };
+  std::vector<Slot> slots;
+  // Maps each planned output to its index in "slots".
+  absl::flat_hash_map<OutputKey, int> slot_index;
+  // The size of the buffer that holds all the slots.
+  size_t bytes = 0;
+};
+
+class StepMemoryPlanner::RecordingArena : public StepMemoryArena {
+ public:
+  struct Record {
+    int num_allocations = 0;
+    Tensor tensor;
+  };
+
+  bool AllocateOutput(const OpKernel* kernel, int index, DataType type,
+                      const TensorShape& shape, Tensor* tensor) override {
+    return false;
+  }
+
+  void RecordOutput(const OpKernel* kernel, int index,
+                    const Tensor& tensor) override {
+    if (!DataTypeCanUseMemcpy(tensor.dtype())) return;
+    mutex_lock l(mu_);
+    Record& record = records_[{kernel, index}];
+    // An output allocated more than once per step, e.g. in a loop, cannot
+    // have a slot, so there is no need to keep it alive.
+    record.tensor = ++record.num_allocations == 1 ? tensor : Tensor();
+  }
+
+  absl::flat_hash_map<OutputKey, Record> TakeRecords() {
+    mutex_lock l(mu_);
+    return std::move(records_);
+  }
+
+ private:
+  mutex mu_;
+  absl::flat_hash_map<OutputKey, Record> records_ TF_GUARDED_BY(mu_);
+};
+
+class StepMemoryPlanner::PlannedArena : public StepMemoryArena {
+ public:
+  PlannedArena(const Plan* plan, Tensor buffer)
+      : plan_(plan),
+        buffer_(std::move(buffer)),
+        claimed_(new std::atomic<bool>[plan->slots.size()]) {
+    for (size_t i = 0; i < plan_->slots.size(); ++i) {
+      claimed_[i].store(false, std::memory_order_relaxed);
+    }
+  }
+
+  bool AllocateOutput(const OpKernel* kernel, int index, DataType type,
+                      const TensorShape& shape, Tensor* tensor) override {
+    if (!DataTypeCanUseMemcpy(type)) return false;
+    auto it = plan_->slot_index.find(OutputKey(kernel, index));
+    if (it == plan_->slot_index.end()) return false;
+    const Plan::Slot& slot = plan_->slots[it->second];
+    if (static_cast<size_t>(shape.num_elements()) * DataTypeSize(type) !=
+        slot.bytes) {
+      return false;
+    }
+    // Each slot is handed out at most once per step, in case the output is
+    // allocated more often than in the recording step.
+    if (claimed_[it->second].exchange(true, std::memory_order_relaxed)) {
+      return false;
+    }
+    core::RefCountPtr<TensorBuffer> buf(
+        new ArenaSliceBuffer(buffer_, slot.offset, slot.bytes));
+    *tensor = Tensor(type, shape, std::move(buf));
+    return true;
+  }
+
+  void RecordOutput(const OpKernel* kernel, int index,
+                    const Tensor& tensor) override {}
+
+ private:
+  const Plan* const plan_;  // Not owned.
+  const Tensor buffer_;
+  std::unique_ptr<std::atomic<bool>[]> claimed_;
+};
+
+StepMemoryPlanner::StepMemoryPlanner(Allocator* allocator)
+    : allocator_(allocator) {}
+
+StepMemoryPlanner::~StepMemoryPlanner() {}
+
+std::unique_ptr<StepMemoryArena> StepMemoryPlanner::BeginStep() {
+  mutex_lock l(mu_);
+  if (plan_ == nullptr) {
+    // Only one step records at a time, the others run without an arena.
+    if (recording_arena_ != nullptr) return nullptr;
+    auto arena = std::make_unique<RecordingArena>();
+    recording_arena_ = arena.get();
+    return arena;
+  }
+  if (plan_->bytes == 0) return nullptr;
+  for (const Tensor& buffer : buffers_) {
+    // Only the planner refers to the buffer once all the tensors carved out
+    // of it have been released.
+    if (buffer.RefCountIsOne()) {
+      return std::make_unique<PlannedArena>(plan_.get(), buffer);
+    }
+  }
+  Tensor buffer(allocator_, DT_INT8,
+                TensorShape({static_cast<int64_t>(plan_->bytes)}));
+  if (!buffer.IsInitialized()) return nullptr;
+  if (buffers_.size() < kMaxPooledBuffers) {
+    buffers_.push_back(buffer);
+  }
+  return std::make_unique<PlannedArena>(plan_.get(), std::move(buffer));
+}
+
+void StepMemoryPlanner::EndStep(std::unique_ptr<StepMemoryArena> arena,
+                                const Status& status) {
+  mutex_lock l(mu_);
+  if (arena == nullptr || arena.get() != recording_arena_) return;
+  recording_arena_ = nullptr;
+  // A failed step may not have run all its kernels, so the next step records
+  // again.
+  if (!status.ok()) return;
+  auto plan = std::make_unique<Plan>();
+  for (const auto& [key, record] :
+       static_cast<RecordingArena*>(arena.get())->TakeRecords()) {
+    // The recording arena holds the only reference to the outputs that were
+    // released by the end of the step.
+    if (record.num_allocations != 1 || !record.tensor.RefCountIsOne()) {
+      continue;
+    }
+    const size_t bytes = record.tensor.TotalBytes();
+    if (bytes == 0) continue;
+    plan->slot_index.emplace(key, plan->slots.size());
+    plan->slots.push_back({plan->bytes, bytes});
+    plan->bytes += AlignedSize(bytes);
+  }
+  VLOG(1) << "Planned " << plan->slots.size() << " outputs in "
+          << plan->bytes << " bytes";
+  plan_ = std::move(plan);
+}
+
+bool StepMemoryPlanner::planned() const {
+  tf_shared_lock l(mu_);
+  return plan_ != nullptr;
+}
+
+size_t StepMemoryPlanner::planned_bytes() const {
+  tf_shared_lock l(mu_);
+  return plan_ == nullptr ? 0 : plan_->bytes;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,102 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_MEMORY_PLANNER_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Plans the memory of the outputs of the kernels of one executor across its
+// steps, in the spirit of the arena planner of TensorFlow Lite, for graphs
+// whose shapes do not change from step to step.
+//
+// The first step that succeeds is a recording step: the planner records the
+// outputs that the kernels of the step allocate, by kernel and output index.
+// An output gets a slot in the plan if it was allocated exactly once in the
+// step, has a type that can be copied with memcpy, and was released by the
+// end of the step, i.e. it was not fetched, aliased by a fetched tensor, or
+// kept in a variable, the session state or the tensor store. The recording
+// step holds on to its outputs until it ends, so that its peak memory is the
+// size of the plan.
+//
+// The slots of the plan do not overlap: the executor runs the kernels of a
+// step in an order that changes from step to step, so two outputs cannot be
+// assumed to have disjoint lifetimes.
+//
+// Every later step allocates all its planned outputs from one buffer, which
+// is reused by a later step as soon as no tensor carved out of it is alive.
+// An output whose size does not match its slot is allocated as usual.
+// Outputs placed in the buffer are never forwarded to the outputs of their
+// consumers, which could keep the whole buffer alive past the step.
+class StepMemoryPlanner {
+ public:
+  // "allocator" is used to allocate the buffers of the steps, and must
+  // outlive the planner.
+  explicit StepMemoryPlanner(Allocator* allocator);
+  ~StepMemoryPlanner();
+
+  // Returns the arena for a new step, or nullptr if the step must allocate
+  // its outputs as usual. The arena must be passed to EndStep() once the
+  // step has completed.
+  std::unique_ptr<StepMemoryArena> BeginStep();
+
+  // Ends the step that used "arena", which is nullptr or was returned by
+  // BeginStep(). "status" is the status of the step.
+  void EndStep(std::unique_ptr<StepMemoryArena> arena, const Status& status);
+
+  // Returns true once the plan has been built.
+  bool planned() const;
+
+  // Returns the size in bytes of the buffer used by every step once the plan
+  // has been built.
+  size_t planned_bytes() const;
+
+ private:
+  struct Plan;
+  class PlannedArena;
+  class RecordingArena;
+
+  // The maximum number of buffers kept for reuse, which bounds the number of
+  // concurrent steps that do not allocate a buffer of their own.
+  static constexpr int kMaxPooledBuffers = 4;
+
+  Allocator* const allocator_;
+
+  mutable mutex mu_;
+  // Not owned. The arena of the step that is recording, if any.
+  const StepMemoryArena* recording_arena_ TF_GUARDED_BY(mu_) = nullptr;
+  // Never changes once set, so that the arenas can refer to it without
+  // holding "mu_".
+  std::unique_ptr<const Plan> plan_ TF_GUARDED_BY(mu_);
+  std::vector<Tensor> buffers_ TF_GUARDED_BY(mu_);
+
+  StepMemoryPlanner(const StepMemoryPlanner&) = delete;
+  void operator=(const StepMemoryPlanner&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_MEMORY_PLANNER_H_
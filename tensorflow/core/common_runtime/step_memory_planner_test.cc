@@ -0,0 +1,158 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_memory_planner.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// The planner only uses the kernels as keys.
+const OpKernel* FakeKernel(intptr_t id) {
+  return reinterpret_cast<const OpKernel*>(id);
+}
+
+// Records an output of `kernel` with `num_elements` floats.
+Tensor RecordOutput(StepMemoryArena* arena, const OpKernel* kernel,
+                    int64_t num_elements) {
+  Tensor tensor(cpu_allocator(), DT_FLOAT, TensorShape({num_elements}));
+  arena->RecordOutput(kernel, 0, tensor);
+  return tensor;
+}
+
+bool AllocateOutput(StepMemoryArena* arena, const OpKernel* kernel,
+                    int64_t num_elements, Tensor* tensor) {
+  return arena->AllocateOutput(kernel, 0, DT_FLOAT,
+                               TensorShape({num_elements}), tensor);
+}
+
+TEST(StepMemoryPlannerTest, PlansReleasedOutputs) {
+  StepMemoryPlanner planner(cpu_allocator());
+  {
+    std::unique_ptr<StepMemoryArena> arena = planner.BeginStep();
+    ASSERT_NE(arena, nullptr);
+    Tensor tensor;
+    EXPECT_FALSE(AllocateOutput(arena.get(), FakeKernel(1), 4, &tensor));
+    RecordOutput(arena.get(), FakeKernel(1), 4);
+    RecordOutput(arena.get(), FakeKernel(2), 100);
+    // Still alive at the end of the step, as if it was fetched.
+    Tensor fetched = RecordOutput(arena.get(), FakeKernel(3), 4);
+    // Allocated twice in the step.
+    RecordOutput(arena.get(), FakeKernel(4), 4);
+    RecordOutput(arena.get(), FakeKernel(4), 4);
+    EXPECT_FALSE(planner.planned());
+    planner.EndStep(std::move(arena), OkStatus());
+  }
+  ASSERT_TRUE(planner.planned());
+  // Each slot is aligned.
+  EXPECT_EQ(planner.planned_bytes(), 64 + 448);
+
+  std::unique_ptr<StepMemoryArena> arena = planner.BeginStep();
+  ASSERT_NE(arena, nullptr);
+  Tensor t1, t2, tensor;
+  ASSERT_TRUE(AllocateOutput(arena.get(), FakeKernel(1), 4, &t1));
+  ASSERT_TRUE(AllocateOutput(arena.get(), FakeKernel(2), 100, &t2));
+  EXPECT_EQ(t1.NumElements(), 4);
+  EXPECT_EQ(t2.NumElements(), 100);
+  EXPECT_NE(t1.tensor_data().data(), t2.tensor_data().data());
+  // The outputs in the arena are never forwarded.
+  EXPECT_FALSE(t1.RefCountIsOne());
+  EXPECT_FALSE(AllocateOutput(arena.get(), FakeKernel(3), 4, &tensor));
+  EXPECT_FALSE(AllocateOutput(arena.get(), FakeKernel(4), 4, &tensor));
+  // Each slot is handed out once per step.
+  EXPECT_FALSE(AllocateOutput(arena.get(), FakeKernel(1), 4, &tensor));
+  planner.EndStep(std::move(arena), OkStatus());
+}
+
+TEST(StepMemoryPlannerTest, ChecksSizeOfSlot) {
+  StepMemoryPlanner planner(cpu_allocator());
+  std::unique_ptr<StepMemoryArena> arena = planner.BeginStep();
+  RecordOutput(arena.get(), FakeKernel(1), 4);
+  planner.EndStep(std::move(arena), OkStatus());
+
+  arena = planner.BeginStep();
+  Tensor tensor;
+  EXPECT_FALSE(AllocateOutput(arena.get(), FakeKernel(1), 8, &tensor));
+  EXPECT_FALSE(arena->AllocateOutput(FakeKernel(1), 0, DT_DOUBLE,
+                                     TensorShape({4}), &tensor));
+  // Same number of bytes.
+  EXPECT_TRUE(arena->AllocateOutput(FakeKernel(1), 0, DT_INT32,
+                                    TensorShape({2, 2}), &tensor));
+  planner.EndStep(std::move(arena), OkStatus());
+}
+
+TEST(StepMemoryPlannerTest, ReusesReleasedBuffers) {
+  StepMemoryPlanner planner(cpu_allocator());
+  std::unique_ptr<StepMemoryArena> arena = planner.BeginStep();
+  RecordOutput(arena.get(), FakeKernel(1), 4);
+  planner.EndStep(std::move(arena), OkStatus());
+
+  Tensor first;
+  arena = planner.BeginStep();
+  ASSERT_TRUE(AllocateOutput(arena.get(), FakeKernel(1), 4, &first));
+  planner.EndStep(std::move(arena), OkStatus());
+
+  // The buffer of the first step is still in use by `first`.
+  Tensor second;
+  arena = planner.BeginStep();
+  ASSERT_TRUE(AllocateOutput(arena.get(), FakeKernel(1), 4, &second));
+  planner.EndStep(std::move(arena), OkStatus());
+  EXPECT_NE(first.tensor_data().data(), second.tensor_data().data());
+
+  const char* data = first.tensor_data().data();
+  first = Tensor();
+  Tensor third;
+  arena = planner.BeginStep();
+  ASSERT_TRUE(AllocateOutput(arena.get(), FakeKernel(1), 4, &third));
+  planner.EndStep(std::move(arena), OkStatus());
+  EXPECT_EQ(third.tensor_data().data(), data);
+}
+
+TEST(StepMemoryPlannerTest, RecordsOneStepAtATime) {
+  StepMemoryPlanner planner(cpu_allocator());
+  std::unique_ptr<StepMemoryArena> recording = planner.BeginStep();
+  ASSERT_NE(recording, nullptr);
+  EXPECT_EQ(planner.BeginStep(), nullptr);
+  planner.EndStep(nullptr, OkStatus());
+  RecordOutput(recording.get(), FakeKernel(1), 4);
+  // A failed step does not build the plan, and the next step records again.
+  planner.EndStep(std::move(recording), errors::Internal("failed"));
+  EXPECT_FALSE(planner.planned());
+
+  recording = planner.BeginStep();
+  ASSERT_NE(recording, nullptr);
+  RecordOutput(recording.get(), FakeKernel(1), 4);
+  planner.EndStep(std::move(recording), OkStatus());
+  EXPECT_TRUE(planner.planned());
+  EXPECT_EQ(planner.planned_bytes(), 64);
+}
+
+TEST(StepMemoryPlannerTest, EmptyPlan) {
+  StepMemoryPlanner planner(cpu_allocator());
+  planner.EndStep(planner.BeginStep(), OkStatus());
+  EXPECT_TRUE(planner.planned());
+  EXPECT_EQ(planner.BeginStep(), nullptr);
+}
+
+}  // namespace
+}  // namespace tensorflow
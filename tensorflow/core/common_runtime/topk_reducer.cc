@@ -0,0 +1,230 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/topk_reducer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/ring_gatherer.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numbers.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr float kDefaultDensity = 0.01;
+
+// What the elements left out of the previous reductions add up to.
+class TopKResidual : public ResourceBase {
+ public:
+  string DebugString() const override {
+    mutex_lock l(mu);
+    return strings::StrCat("TopKResidual of ", value.NumElements(),
+                           " elements");
+  }
+
+  int64_t MemoryUsed() const override {
+    mutex_lock l(mu);
+    return value.TotalBytes();
+  }
+
+  mutable mutex mu;
+  Tensor value TF_GUARDED_BY(mu);
+};
+
+}  // namespace
+
+Status TopKReducer::ParseDensity(const string& communication_hint,
+                                 float* density) {
+  *density = kDefaultDensity;
+  if (communication_hint == "topk") return OkStatus();
+  if (!absl::StartsWith(communication_hint, "topk:") ||
+      !strings::safe_strtof(communication_hint.substr(5), density) ||
+      !(*density > 0 && *density <= 1)) {
+    return errors::InvalidArgument(
+        "TopKReduce needs a communication hint of topk or topk:<density> "
+        "with a density in (0, 1], not ",
+        communication_hint);
+  }
+  return OkStatus();
+}
+
+Status TopKReducer::InitializeCollectiveParams(CollectiveParams* col_params) {
+  if (col_params->instance.data_type != DT_FLOAT ||
+      col_params->group.device_type != DEVICE_CPU) {
+    return errors::InvalidArgument(
+        "TopKReduce requires float tensors on CPU, not ",
+        DataTypeString(col_params->instance.data_type), " on ",
+        col_params->group.device_type.type_string());
+  }
+  if (col_params->instance.shape.num_elements() >
+      std::numeric_limits<int32>::max()) {
+    return errors::InvalidArgument("TopKReduce of ",
+                                   col_params->instance.shape.num_elements(),
+                                   " elements, which is too many");
+  }
+  float density;
+  return ParseDensity(col_params->instance.impl_details.communication_hint,
+                      &density);
+}
+
+Status TopKReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  DCHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void TopKReducer::Run(StatusCallback done) {
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  done(Reduce());
+}
+
+Status TopKReducer::Reduce() {
+  const OpKernel* merge_op = col_params_->merge_op;
+  if (merge_op == nullptr ||
+      (merge_op->type_string() != "Add" &&
+       merge_op->type_string() != "AddV2")) {
+    return errors::InvalidArgument("TopKReduce requires the Add merge op");
+  }
+  float density;
+  TF_RETURN_IF_ERROR(ParseDensity(
+      col_params_->instance.impl_details.communication_hint, &density));
+  const int64_t n = col_ctx_->input->NumElements();
+  const int64_t k = std::min<int64_t>(
+      n, std::max<int64_t>(1, std::ceil(density * n)));
+  Allocator* allocator =
+      col_ctx_->device->GetAllocator(col_ctx_->op_ctx->output_alloc_attr(0));
+
+  // Pick the k elements of input + residual with the largest magnitudes.
+  // The payload is their indices, as the bits of floats, then their values.
+  Tensor payload(allocator, DT_FLOAT, TensorShape({2 * k}));
+  {
+    TopKResidual* residual;
+    ResourceMgr* rm = col_ctx_->device->resource_manager();
+    TF_RETURN_IF_ERROR(rm->LookupOrCreate<TopKResidual>(
+        "TopKReduce",
+        strings::StrCat(col_params_->group.group_key, ":",
+                        col_params_->instance.instance_key),
+        &residual, [](TopKResidual** r) {
+          *r = new TopKResidual;
+          return OkStatus();
+        }));
+    core::ScopedUnref unref(residual);
+    mutex_lock l(residual->mu);
+    if (residual->value.NumElements() != n) {
+      residual->value = Tensor(DT_FLOAT, TensorShape({n}));
+      residual->value.flat<float>().setZero();
+    }
+    float* acc = residual->value.flat<float>().data();
+    const float* input = col_ctx_->input->flat<float>().data();
+    for (int64_t i = 0; i < n; ++i) acc[i] += input[i];
+
+    std::vector<int32> indices(n);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::nth_element(indices.begin(), indices.begin() + (k - 1),
+                     indices.end(), [acc](int32 a, int32 b) {
+                       return std::abs(acc[a]) > std::abs(acc[b]);
+                     });
+    std::sort(indices.begin(), indices.begin() + k);
+    float* out = payload.flat<float>().data();
+    for (int64_t j = 0; j < k; ++j) {
+      const int32 index = indices[j];
+      std::memcpy(&out[j], &index, sizeof(index));
+      out[k + j] = acc[index];
+      acc[index] = 0;
+    }
+  }
+
+  const int group_size = col_params_->group.group_size;
+  Tensor gathered(allocator, DT_FLOAT, TensorShape({group_size * 2 * k}));
+  TF_RETURN_IF_ERROR(Gather(&payload, &gathered));
+
+  // Every device sums the payloads in the same order, so they all get the
+  // same output.
+  float* out = col_ctx_->output->flat<float>().data();
+  std::fill(out, out + n, 0.0f);
+  const float* in = gathered.flat<float>().data();
+  for (int r = 0; r < group_size; ++r, in += 2 * k) {
+    for (int64_t j = 0; j < k; ++j) {
+      int32 index;
+      std::memcpy(&index, &in[j], sizeof(index));
+      if (index < 0 || index >= n) {
+        return errors::Internal("TopKReduce received index ", index,
+                                " of a tensor of ", n, " elements");
+      }
+      out[index] += in[k + j];
+    }
+  }
+  if (col_params_->final_op == nullptr) return OkStatus();
+  Tensor group_size_val(static_cast<float>(group_size));
+  return collective_util::ComputeBinOp(
+      col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+      col_params_->final_op, col_ctx_->output, &group_size_val);
+}
+
+Status TopKReducer::Gather(const Tensor* input, Tensor* output) {
+  core::RefCountPtr<CollectiveParams> params(new CollectiveParams());
+  params->name = col_params_->name;
+  params->group = col_params_->group;
+  params->default_rank = col_params_->default_rank;
+  params->instance.instance_key = col_params_->instance.instance_key;
+  params->instance.step_id = col_params_->instance.step_id;
+  params->instance.type = GATHER_COLLECTIVE;
+  params->instance.data_type = DT_FLOAT;
+  params->instance.shape = input->shape();
+  params->instance.impl_details.collective_name = "RingGather";
+
+  core::RefCountPtr<RingGatherer> gatherer(new RingGatherer());
+  TF_RETURN_IF_ERROR(gatherer->InitializeCollectiveParams(params.get()));
+  auto col_ctx = std::make_shared<CollectiveContext>(
+      col_ctx_->col_exec, col_ctx_->nccl_communicator, col_ctx_->dev_mgr,
+      col_ctx_->op_ctx, col_ctx_->op_params, params.get(),
+      strings::StrCat(col_ctx_->exec_key, ":g"), col_ctx_->step_id, input,
+      output);
+  TF_RETURN_IF_ERROR(gatherer->InitializeCollectiveContext(col_ctx));
+  Notification note;
+  Status status;
+  gatherer->Run([&note, &status](const Status& s) {
+    status = s;
+    note.Notify();
+  });
+  note.WaitForNotification();
+  return status;
+}
+
+namespace {
+REGISTER_COLLECTIVE(TopKReduce, TopKReducer);
+}  // namespace
+
+}  // namespace tensorflow
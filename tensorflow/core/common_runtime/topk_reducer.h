@@ -0,0 +1,69 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_TOPK_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_TOPK_REDUCER_H_
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+
+// Sparsified all-reduce of float tensors on CPU devices, for gradients.
+// Each device adds its input to the residual it kept from the previous
+// reductions of the same instance, and contributes only the k elements of
+// the sum with the largest magnitudes, keeping the others as the new
+// residual.  The devices all-gather the (index, value) pairs with a
+// RingGatherer and sum them into the output, so each device sends
+// 2 * k * (group_size - 1) numbers instead of about twice the tensor.
+//
+// k is the "density" fraction of the elements, which is 0.01 unless the
+// communication hint is "topk:<density>".  The residuals are resources of
+// the devices.  The merge op must be Add.
+class TopKReducer : public CollectiveImplementationInterface {
+ public:
+  TopKReducer() = default;
+  ~TopKReducer() override = default;
+
+  // Checks that the tensor is float and on CPU, and the communication hint.
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Must be called in a blockable thread.
+  void Run(StatusCallback done) override;
+
+  // Sets "*density" from a communication hint of "topk" or
+  // "topk:<density>".
+  static Status ParseDensity(const string& communication_hint,
+                             float* density);
+
+ private:
+  Status Reduce();
+
+  // All-gathers "input" from every device into "output".
+  Status Gather(const Tensor* input, Tensor* output);
+
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_ = nullptr;  // Not owned
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_TOPK_REDUCER_H_
@@ -0,0 +1,175 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/topk_reducer.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/collective_test_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<OpKernel> GetBinOp(const string& op, DataType dtype,
+                                   const DeviceType& device_type,
+                                   DeviceBase* device) {
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder(strings::StrCat(op, "_node"), op)
+                  .Attr("T", dtype)
+                  .Input(FakeInput(dtype))
+                  .Input(FakeInput(dtype))
+                  .Finalize(&node_def));
+  Status status;
+  std::unique_ptr<OpKernel> k = CreateOpKernel(
+      device_type, device, device->GetAllocator(AllocatorAttributes()),
+      node_def, TF_GRAPH_DEF_VERSION, &status);
+  TF_CHECK_OK(status);
+  return k;
+}
+
+class TopKReducerTest : public ::testing::Test {
+ protected:
+  class DeviceInstance {
+   public:
+    DeviceInstance(int rank, const TensorShape& shape,
+                   CollectiveTestEnv* test_env)
+        : test_env_(test_env), tensor_(DT_FLOAT, shape) {
+      col_params_ = CreateCollectiveParams(*test_env_, rank, "TopKReduce",
+                                           REDUCTION_COLLECTIVE, DT_FLOAT,
+                                           shape);
+      string dev_name = col_params_->group.members[rank].device.name();
+      TF_CHECK_OK(test_env_->device_mgr->LookupDevice(dev_name, &device_));
+      merge_op_ = GetBinOp("Add", DT_FLOAT, test_env_->device_type, device_);
+      final_op_ = GetBinOp("Div", DT_FLOAT, test_env_->device_type, device_);
+      col_params_->merge_op = merge_op_.get();
+      col_params_->final_op = final_op_.get();
+    }
+
+    void DoReduce() {
+      status_ = RunCollective(test_env_, col_params_.get(), device_, &tensor_,
+                              &tensor_);
+    }
+
+    CollectiveTestEnv* test_env_;
+    Tensor tensor_;
+    Device* device_;
+    core::RefCountPtr<CollectiveParams> col_params_;
+    std::unique_ptr<OpKernel> merge_op_;
+    std::unique_ptr<OpKernel> final_op_;
+    Status status_;
+  };
+
+  void Init(int num_workers, int num_devices, int tensor_len) {
+    test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, DEVICE_CPU);
+    for (int rank = 0; rank < num_workers * num_devices; ++rank) {
+      instances_.push_back(std::make_unique<DeviceInstance>(
+          rank, TensorShape({tensor_len}), test_env_.get()));
+    }
+  }
+
+  void Reduce() {
+    std::atomic<int> done(0);
+    for (auto& di : instances_) {
+      SchedClosure([&di, &done] {
+        di->DoReduce();
+        ++done;
+      });
+    }
+    while (done < static_cast<int>(instances_.size())) {
+      Env::Default()->SleepForMicroseconds(1000);
+    }
+    for (auto& di : instances_) {
+      TF_EXPECT_OK(di->status_);
+    }
+  }
+
+  std::unique_ptr<CollectiveTestEnv> test_env_;
+  std::vector<std::unique_ptr<DeviceInstance>> instances_;
+};
+
+TEST_F(TopKReducerTest, ParseDensity) {
+  float density;
+  TF_EXPECT_OK(TopKReducer::ParseDensity("topk", &density));
+  EXPECT_EQ(density, 0.01f);
+  TF_EXPECT_OK(TopKReducer::ParseDensity("topk:0.25", &density));
+  EXPECT_EQ(density, 0.25f);
+  EXPECT_FALSE(TopKReducer::ParseDensity("topk:0", &density).ok());
+  EXPECT_FALSE(TopKReducer::ParseDensity("topk:2", &density).ok());
+  EXPECT_FALSE(TopKReducer::ParseDensity("ring", &density).ok());
+}
+
+TEST_F(TopKReducerTest, DenseWithDensityOne) {
+  const int kLen = 1001;
+  Init(2, 2, kLen);
+  std::vector<float> expected(kLen);
+  for (int rank = 0; rank < instances_.size(); ++rank) {
+    instances_[rank]->col_params_->instance.impl_details.communication_hint =
+        "topk:1";
+    for (int i = 0; i < kLen; ++i) {
+      const float value = rank * 10 + i;
+      instances_[rank]->tensor_.flat<float>()(i) = value;
+      expected[i] += value / instances_.size();
+    }
+  }
+  Reduce();
+  for (auto& di : instances_) {
+    test::ExpectTensorEqual<float>(test::AsTensor<float>(expected),
+                                   di->tensor_);
+  }
+}
+
+TEST_F(TopKReducerTest, FeedsBackResiduals) {
+  Init(1, 2, 4);
+  for (int rank = 0; rank < instances_.size(); ++rank) {
+    instances_[rank]->col_params_->instance.impl_details.communication_hint =
+        "topk:0.25";
+    instances_[rank]->tensor_ =
+        test::AsTensor<float>({1, 2, -3, 10.0f * (rank + 1)});
+  }
+  Reduce();
+  for (auto& di : instances_) {
+    test::ExpectTensorEqual<float>(test::AsTensor<float>({0, 0, 0, 15}),
+                                   di->tensor_);
+  }
+
+  // The elements left out are sent next time.
+  for (auto& di : instances_) {
+    di->tensor_ = test::AsTensor<float>({0, 0, 0, 0});
+  }
+  Reduce();
+  for (auto& di : instances_) {
+    test::ExpectTensorEqual<float>(test::AsTensor<float>({0, 0, -3, 0}),
+                                   di->tensor_);
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,209 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_QUEUE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// A set of per-worker deques of items of type `T`, shared by a bounded number
+// of workers that steal items from one another.
+//
+// An item pushed by a worker goes to the back of that worker's own deque, and
+// the worker pops its newest item first, so that work produced by a worker
+// keeps running on the same thread while its inputs are still in cache. A
+// worker whose deque is empty steals the oldest item of another worker.
+//
+// Workers are not threads: the owner reserves an idle worker with
+// `ReserveWorker()` whenever it pushes new items, and runs it on a thread of
+// its choice with `RunWorker()`, which returns once every deque is empty.
+//
+// Usage:
+//
+//   auto queue = std::make_shared<WorkStealingQueue<Work>>(num_workers);
+//   queue->Push(std::move(work));
+//   const int worker_id = queue->ReserveWorker();
+//   if (worker_id >= 0) {
+//     runner([queue, worker_id]() {
+//       queue->RunWorker(worker_id, [](Work work) { ... });
+//     });
+//   }
+//
+// This class is thread-safe.
+template <typename T>
+class WorkStealingQueue {
+ public:
+  explicit WorkStealingQueue(int num_workers)
+      : num_workers_(std::max(num_workers, 1)),
+        deques_(new WorkerDeque[num_workers_]),
+        running_(num_workers_, false) {}
+
+  WorkStealingQueue(const WorkStealingQueue&) = delete;
+  void operator=(const WorkStealingQueue&) = delete;
+
+  int num_workers() const { return num_workers_; }
+
+  // Pushes `item` to the back of the deque of the calling worker, or of a
+  // worker chosen round-robin if the calling thread is not running a worker
+  // of this queue.
+  void Push(T item) {
+    int worker_id = current_worker_id_;
+    if (current_queue_ != this) {
+      worker_id = next_deque_.fetch_add(1, std::memory_order_relaxed) %
+                  num_workers_;
+    }
+    WorkerDeque& deque = deques_[worker_id];
+    mutex_lock l(deque.mu);
+    deque.items.push_back(std::move(item));
+  }
+
+  // Reserves an idle worker, which the caller must then run with
+  // `RunWorker()`. Returns the id of the worker, or -1 if every worker is
+  // already running.
+  int ReserveWorker() {
+    mutex_lock l(workers_mu_);
+    if (num_running_ == num_workers_) {
+      return -1;
+    }
+    const int worker_id = static_cast<int>(
+        std::find(running_.begin(), running_.end(), false) - running_.begin());
+    running_[worker_id] = true;
+    ++num_running_;
+    return worker_id;
+  }
+
+  // Runs the worker `worker_id`, which must have been reserved with
+  // `ReserveWorker()`: calls `fn` on items popped from its own deque or stolen
+  // from the other deques until they are all empty.
+  //
+  // `fn` may push more items. The queue itself does not touch any state
+  // captured by `fn` once the deques are empty, so `fn` may destroy the
+  // owner of the queue when it processes the last item.
+  template <typename Fn>
+  void RunWorker(int worker_id, Fn fn) {
+    DCHECK_GE(worker_id, 0);
+    DCHECK_LT(worker_id, num_workers_);
+    WorkStealingQueue* const parent_queue = current_queue_;
+    const int parent_worker_id = current_worker_id_;
+    current_queue_ = this;
+    current_worker_id_ = worker_id;
+    while (true) {
+      while (std::optional<T> item = PopOrSteal(worker_id)) {
+        fn(*std::move(item));
+      }
+      if (StopWorker(worker_id)) {
+        break;
+      }
+    }
+    current_queue_ = parent_queue;
+    current_worker_id_ = parent_worker_id;
+  }
+
+ private:
+  // Aligned to avoid false sharing between the locks of different workers,
+  // assuming the cacheline size is 64 bytes or smaller.
+  struct alignas(64) WorkerDeque {
+    mutex mu;
+    std::deque<T> items TF_GUARDED_BY(mu);
+  };
+
+  // Pops the newest item of the deque of `worker_id`, or steals the oldest
+  // item of another deque. Returns `nullopt` if every deque is empty.
+  std::optional<T> PopOrSteal(int worker_id) {
+    {
+      WorkerDeque& deque = deques_[worker_id];
+      mutex_lock l(deque.mu);
+      if (!deque.items.empty()) {
+        std::optional<T> item(std::move(deque.items.back()));
+        deque.items.pop_back();
+        return item;
+      }
+    }
+    for (int i = 1; i < num_workers_; ++i) {
+      WorkerDeque& deque = deques_[(worker_id + i) % num_workers_];
+      mutex_lock l(deque.mu);
+      if (!deque.items.empty()) {
+        std::optional<T> item(std::move(deque.items.front()));
+        deque.items.pop_front();
+        return item;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Marks `worker_id` idle after it found every deque empty. Returns false if
+  // an item was pushed meanwhile without a worker being reserved for it, in
+  // which case the worker keeps running.
+  bool StopWorker(int worker_id) {
+    {
+      mutex_lock l(workers_mu_);
+      running_[worker_id] = false;
+      --num_running_;
+    }
+    // A concurrent `Push()` may have found every worker running just before
+    // this worker was marked idle, so checks the deques once more.
+    for (int i = 0; i < num_workers_; ++i) {
+      WorkerDeque& deque = deques_[i];
+      mutex_lock l(deque.mu);
+      if (!deque.items.empty()) {
+        mutex_lock workers_lock(workers_mu_);
+        if (running_[worker_id]) {
+          // The worker has been reserved again and will be run by its new
+          // owner.
+          return true;
+        }
+        running_[worker_id] = true;
+        ++num_running_;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The queue and worker run by the calling thread, if any.
+  static thread_local WorkStealingQueue* current_queue_;
+  static thread_local int current_worker_id_;
+
+  const int num_workers_;
+  const std::unique_ptr<WorkerDeque[]> deques_;
+  std::atomic<uint32_t> next_deque_{0};
+
+  mutex workers_mu_;
+  std::vector<bool> running_ TF_GUARDED_BY(workers_mu_);
+  int num_running_ TF_GUARDED_BY(workers_mu_) = 0;
+};
+
+template <typename T>
+thread_local WorkStealingQueue<T>* WorkStealingQueue<T>::current_queue_ =
+    nullptr;
+
+template <typename T>
+thread_local int WorkStealingQueue<T>::current_worker_id_ = 0;
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_QUEUE_H_
@@ -0,0 +1,104 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/work_stealing_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(WorkStealingQueueTest, ReserveWorker) {
+  WorkStealingQueue<int> queue(/*num_workers=*/2);
+  EXPECT_EQ(queue.num_workers(), 2);
+  EXPECT_EQ(queue.ReserveWorker(), 0);
+  EXPECT_EQ(queue.ReserveWorker(), 1);
+  EXPECT_EQ(queue.ReserveWorker(), -1);
+}
+
+TEST(WorkStealingQueueTest, PopsNewestItemFirst) {
+  WorkStealingQueue<int> queue(/*num_workers=*/1);
+  for (int i = 0; i < 3; ++i) {
+    queue.Push(i);
+  }
+  std::vector<int> items;
+  queue.RunWorker(queue.ReserveWorker(),
+                  [&items](int item) { items.push_back(item); });
+  EXPECT_THAT(items, ElementsAre(2, 1, 0));
+  // The worker is idle again once the queue is empty.
+  EXPECT_EQ(queue.ReserveWorker(), 0);
+}
+
+TEST(WorkStealingQueueTest, RunsOwnItemsBeforeStealing) {
+  WorkStealingQueue<int> queue(/*num_workers=*/2);
+  // Pushed round-robin to the deques of workers 0 and 1.
+  queue.Push(0);
+  queue.Push(1);
+  std::vector<int> items;
+  queue.RunWorker(queue.ReserveWorker(), [&queue, &items](int item) {
+    items.push_back(item);
+    if (item == 0) {
+      // Pushed to the deque of the running worker.
+      queue.Push(10);
+      queue.Push(11);
+    }
+  });
+  EXPECT_THAT(items, ElementsAre(0, 11, 10, 1));
+}
+
+TEST(WorkStealingQueueTest, ConcurrentWorkers) {
+  constexpr int kNumWorkers = 4;
+  constexpr int kNumRoots = 100;
+  constexpr int kNumChildren = 10;
+  auto queue = std::make_shared<WorkStealingQueue<int>>(kNumWorkers);
+  std::atomic<int> num_processed{0};
+  BlockingCounter counter(kNumRoots * (kNumChildren + 1));
+  // Destroyed first, so that it waits for the workers to return.
+  thread::ThreadPool pool(Env::Default(), "test", kNumWorkers);
+
+  auto start_workers = [&]() {
+    for (int worker_id = queue->ReserveWorker(); worker_id >= 0;
+         worker_id = queue->ReserveWorker()) {
+      pool.Schedule([&, worker_id]() {
+        queue->RunWorker(worker_id, [&](int item) {
+          if (item < 0) {
+            for (int i = 0; i < kNumChildren; ++i) {
+              queue->Push(i);
+            }
+          }
+          num_processed.fetch_add(1);
+          counter.DecrementCount();
+        });
+      });
+    }
+  };
+  for (int i = 0; i < kNumRoots; ++i) {
+    queue->Push(-1);
+    start_workers();
+  }
+  counter.Wait();
+  EXPECT_EQ(num_processed.load(), kNumRoots * (kNumChildren + 1));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,391 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/columnar_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/platform/byte_order.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/raw_coding.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kMagic[] = "TFCOLUMN";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+// Footer size, footer checksum and magic.
+constexpr size_t kTrailerSize = sizeof(uint64) + sizeof(uint32) + kMagicSize;
+
+bool IsNumeric(DataType dtype) {
+  return dtype == DT_INT32 || dtype == DT_INT64 || dtype == DT_FLOAT ||
+         dtype == DT_DOUBLE;
+}
+
+bool IsSupported(DataType dtype) {
+  return IsNumeric(dtype) || dtype == DT_STRING;
+}
+
+template <typename T>
+void ComputeStats(const Tensor& tensor, ColumnarChunk* chunk) {
+  for (const T value : tensor.flat<T>()) {
+    const double d = static_cast<double>(value);
+    if (std::isnan(d)) continue;
+    if (!chunk->has_stats) {
+      chunk->min_value = chunk->max_value = d;
+      chunk->has_stats = true;
+    } else {
+      chunk->min_value = std::min(chunk->min_value, d);
+      chunk->max_value = std::max(chunk->max_value, d);
+    }
+  }
+}
+
+void PutDouble(std::string* dst, double value) {
+  core::PutFixed64(dst, absl::bit_cast<uint64>(value));
+}
+
+bool GetFixed32(StringPiece* input, uint32* value) {
+  if (input->size() < sizeof(uint32)) return false;
+  *value = core::DecodeFixed32(input->data());
+  input->remove_prefix(sizeof(uint32));
+  return true;
+}
+
+bool GetFixed64(StringPiece* input, uint64* value) {
+  if (input->size() < sizeof(uint64)) return false;
+  *value = core::DecodeFixed64(input->data());
+  input->remove_prefix(sizeof(uint64));
+  return true;
+}
+
+bool GetDouble(StringPiece* input, double* value) {
+  uint64 bits;
+  if (!GetFixed64(input, &bits)) return false;
+  *value = absl::bit_cast<double>(bits);
+  return true;
+}
+
+bool GetLengthPrefixed(StringPiece* input, std::string* value) {
+  uint32 size;
+  if (!core::GetVarint32(input, &size) || input->size() < size) return false;
+  value->assign(input->data(), size);
+  input->remove_prefix(size);
+  return true;
+}
+
+}  // namespace
+
+ColumnarWriter::ColumnarWriter(WritableFile* file,
+                               std::vector<ColumnarColumn> columns)
+    : file_(file), columns_(std::move(columns)) {}
+
+Status ColumnarWriter::WriteHeaderIfNeeded() {
+  if (offset_ > 0) {
+    return OkStatus();
+  }
+  if (!port::kLittleEndian) {
+    return errors::Unimplemented(
+        "Columnar files can only be written on little-endian platforms.");
+  }
+  for (const ColumnarColumn& column : columns_) {
+    if (!IsSupported(column.dtype)) {
+      return errors::InvalidArgument("Column ", column.name,
+                                     " has unsupported type ",
+                                     DataTypeString(column.dtype));
+    }
+  }
+  TF_RETURN_IF_ERROR(file_->Append(StringPiece(kMagic, kMagicSize)));
+  offset_ = kMagicSize;
+  return OkStatus();
+}
+
+Status ColumnarWriter::WriteRowGroup(const std::vector<Tensor>& columns) {
+  if (finished_) {
+    return errors::FailedPrecondition("The columnar writer is finished.");
+  }
+  TF_RETURN_IF_ERROR(WriteHeaderIfNeeded());
+  if (columns.size() != columns_.size()) {
+    return errors::InvalidArgument("Expected ", columns_.size(),
+                                   " columns, got ", columns.size());
+  }
+  ColumnarRowGroup row_group;
+  row_group.num_rows = columns.empty() ? 0 : columns[0].NumElements();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const Tensor& tensor = columns[i];
+    if (tensor.dtype() != columns_[i].dtype || tensor.dims() != 1 ||
+        tensor.NumElements() != row_group.num_rows) {
+      return errors::InvalidArgument(
+          "Column ", columns_[i].name, " must be a vector of ",
+          row_group.num_rows, " ", DataTypeString(columns_[i].dtype),
+          " values, got ", DataTypeString(tensor.dtype()), " tensor of shape ",
+          tensor.shape().DebugString());
+    }
+
+    ColumnarChunk chunk;
+    StringPiece data;
+    std::string string_data;
+    switch (tensor.dtype()) {
+      case DT_INT32:
+        ComputeStats<int32>(tensor, &chunk);
+        data = tensor.tensor_data();
+        break;
+      case DT_INT64:
+        ComputeStats<int64_t>(tensor, &chunk);
+        data = tensor.tensor_data();
+        break;
+      case DT_FLOAT:
+        ComputeStats<float>(tensor, &chunk);
+        data = tensor.tensor_data();
+        break;
+      case DT_DOUBLE:
+        ComputeStats<double>(tensor, &chunk);
+        data = tensor.tensor_data();
+        break;
+      case DT_STRING: {
+        const auto values = tensor.flat<tstring>();
+        size_t total_size = 0;
+        for (const tstring& value : values) {
+          core::PutVarint64(&string_data, value.size());
+          total_size += value.size();
+        }
+        string_data.reserve(string_data.size() + total_size);
+        for (const tstring& value : values) {
+          string_data.append(value.data(), value.size());
+        }
+        data = string_data;
+        break;
+      }
+      default:
+        return errors::Internal("Unsupported type ",
+                                DataTypeString(tensor.dtype()));
+    }
+    chunk.offset = offset_;
+    chunk.size = data.size();
+    chunk.masked_crc = crc32c::Mask(crc32c::Value(data.data(), data.size()));
+    TF_RETURN_IF_ERROR(file_->Append(data));
+    offset_ += data.size();
+    row_group.chunks.push_back(chunk);
+  }
+  row_groups_.push_back(std::move(row_group));
+  return OkStatus();
+}
+
+Status ColumnarWriter::Finish() {
+  if (finished_) {
+    return errors::FailedPrecondition("The columnar writer is finished.");
+  }
+  TF_RETURN_IF_ERROR(WriteHeaderIfNeeded());
+  finished_ = true;
+
+  std::string footer;
+  core::PutVarint32(&footer, columns_.size());
+  for (const ColumnarColumn& column : columns_) {
+    core::PutVarint32(&footer, column.name.size());
+    footer.append(column.name);
+    core::PutVarint32(&footer, column.dtype);
+  }
+  core::PutVarint64(&footer, row_groups_.size());
+  for (const ColumnarRowGroup& row_group : row_groups_) {
+    core::PutVarint64(&footer, row_group.num_rows);
+    for (const ColumnarChunk& chunk : row_group.chunks) {
+      core::PutFixed64(&footer, chunk.offset);
+      core::PutFixed64(&footer, chunk.size);
+      core::PutFixed32(&footer, chunk.masked_crc);
+      footer.push_back(chunk.has_stats ? 1 : 0);
+      if (chunk.has_stats) {
+        PutDouble(&footer, chunk.min_value);
+        PutDouble(&footer, chunk.max_value);
+      }
+    }
+  }
+  const uint32 masked_crc =
+      crc32c::Mask(crc32c::Value(footer.data(), footer.size()));
+  core::PutFixed64(&footer, footer.size());
+  core::PutFixed32(&footer, masked_crc);
+  footer.append(kMagic, kMagicSize);
+  return file_->Append(footer);
+}
+
+StatusOr<std::unique_ptr<ColumnarReader>> ColumnarReader::Open(
+    Env* env, const std::string& filename) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+  std::unique_ptr<ColumnarReader> reader(
+      new ColumnarReader(filename, std::move(file)));
+  uint64 file_size;
+  TF_RETURN_IF_ERROR(env->GetFileSize(filename, &file_size));
+  if (file_size < kMagicSize + kTrailerSize) {
+    return errors::DataLoss("Columnar file ", filename, " is too short.");
+  }
+
+  std::string trailer(kTrailerSize, '\0');
+  StringPiece result;
+  TF_RETURN_IF_ERROR(reader->file_->Read(file_size - kTrailerSize,
+                                         kTrailerSize, &result, &trailer[0]));
+  if (result.size() != kTrailerSize ||
+      result.substr(kTrailerSize - kMagicSize) !=
+          StringPiece(kMagic, kMagicSize)) {
+    return errors::DataLoss(filename, " is not a columnar file.");
+  }
+  const uint64 footer_size = core::DecodeFixed64(result.data());
+  const uint32 masked_crc = core::DecodeFixed32(result.data() + sizeof(uint64));
+  if (footer_size > file_size - kMagicSize - kTrailerSize) {
+    return errors::DataLoss("Corrupted footer in columnar file ", filename);
+  }
+
+  std::string footer(footer_size, '\0');
+  TF_RETURN_IF_ERROR(
+      reader->file_->Read(file_size - kTrailerSize - footer_size, footer_size,
+                          &result, &footer[0]));
+  if (result.size() != footer_size ||
+      crc32c::Unmask(masked_crc) !=
+          crc32c::Value(result.data(), result.size())) {
+    return errors::DataLoss("Corrupted footer in columnar file ", filename);
+  }
+
+  StringPiece input = result;
+  const auto corrupted = [&filename]() {
+    return errors::DataLoss("Corrupted footer in columnar file ", filename);
+  };
+  uint32 num_columns;
+  if (!core::GetVarint32(&input, &num_columns)) return corrupted();
+  for (uint32 i = 0; i < num_columns; ++i) {
+    ColumnarColumn column;
+    uint32 dtype;
+    if (!GetLengthPrefixed(&input, &column.name) ||
+        !core::GetVarint32(&input, &dtype) ||
+        !IsSupported(static_cast<DataType>(dtype))) {
+      return corrupted();
+    }
+    column.dtype = static_cast<DataType>(dtype);
+    reader->columns_.push_back(std::move(column));
+  }
+  uint64 num_row_groups;
+  if (!core::GetVarint64(&input, &num_row_groups)) return corrupted();
+  for (uint64 i = 0; i < num_row_groups; ++i) {
+    ColumnarRowGroup row_group;
+    uint64 num_rows;
+    if (!core::GetVarint64(&input, &num_rows)) return corrupted();
+    row_group.num_rows = num_rows;
+    for (uint32 c = 0; c < num_columns; ++c) {
+      ColumnarChunk chunk;
+      if (!GetFixed64(&input, &chunk.offset) ||
+          !GetFixed64(&input, &chunk.size) ||
+          !GetFixed32(&input, &chunk.masked_crc) || input.empty()) {
+        return corrupted();
+      }
+      chunk.has_stats = input[0] != 0;
+      input.remove_prefix(1);
+      if (chunk.has_stats && (!GetDouble(&input, &chunk.min_value) ||
+                              !GetDouble(&input, &chunk.max_value))) {
+        return corrupted();
+      }
+      if (chunk.offset + chunk.size > file_size) return corrupted();
+      const DataType dtype = reader->columns_[c].dtype;
+      if (IsNumeric(dtype) && chunk.size != num_rows * DataTypeSize(dtype)) {
+        return corrupted();
+      }
+      row_group.chunks.push_back(chunk);
+    }
+    reader->row_groups_.push_back(std::move(row_group));
+  }
+  if (!input.empty()) return corrupted();
+  return reader;
+}
+
+int ColumnarReader::FindColumn(const std::string& name) const {
+  for (int i = 0; i < columns_.size(); ++i) {
+    if (columns_[i].name == name) return i;
+  }
+  return -1;
+}
+
+bool ColumnarReader::MayContain(int64_t row_group, int column, double lower,
+                                double upper) const {
+  const ColumnarChunk& chunk = row_groups_[row_group].chunks[column];
+  if (!chunk.has_stats) return true;
+  return chunk.max_value >= lower && chunk.min_value <= upper;
+}
+
+Status ColumnarReader::ReadColumn(int64_t row_group, int column,
+                                  Allocator* allocator, Tensor* tensor) const {
+  if (row_group < 0 || row_group >= num_row_groups() || column < 0 ||
+      column >= columns_.size()) {
+    return errors::InvalidArgument("Invalid row group ", row_group,
+                                   " or column ", column, " in ", filename_);
+  }
+  const ColumnarRowGroup& group = row_groups_[row_group];
+  const ColumnarChunk& chunk = group.chunks[column];
+  const DataType dtype = columns_[column].dtype;
+  *tensor = Tensor(allocator, dtype, TensorShape({group.num_rows}));
+
+  // Numeric values are read straight into the tensor.
+  std::string string_data;
+  char* scratch;
+  if (IsNumeric(dtype)) {
+    scratch = const_cast<char*>(tensor->tensor_data().data());
+  } else {
+    string_data.resize(chunk.size);
+    scratch = &string_data[0];
+  }
+  StringPiece data;
+  Status s = file_->Read(chunk.offset, chunk.size, &data, scratch);
+  if (!s.ok() && !(errors::IsOutOfRange(s) && data.size() == chunk.size)) {
+    return s;
+  }
+  if (data.size() != chunk.size ||
+      crc32c::Unmask(chunk.masked_crc) !=
+          crc32c::Value(data.data(), data.size())) {
+    return errors::DataLoss("Corrupted column ", columns_[column].name,
+                            " in row group ", row_group, " of ", filename_);
+  }
+  if (IsNumeric(dtype)) {
+    if (data.data() != scratch) {
+      memmove(scratch, data.data(), data.size());
+    }
+    return OkStatus();
+  }
+
+  auto values = tensor->flat<tstring>();
+  std::vector<uint64> sizes(group.num_rows);
+  for (int64_t i = 0; i < group.num_rows; ++i) {
+    if (!core::GetVarint64(&data, &sizes[i])) {
+      return errors::DataLoss("Corrupted column ", columns_[column].name,
+                              " in row group ", row_group, " of ", filename_);
+    }
+  }
+  for (int64_t i = 0; i < group.num_rows; ++i) {
+    if (data.size() < sizes[i]) {
+      return errors::DataLoss("Corrupted column ", columns_[column].name,
+                              " in row group ", row_group, " of ", filename_);
+    }
+    values(i).assign(data.data(), sizes[i]);
+    data.remove_prefix(sizes[i]);
+  }
+  return OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,141 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_COLUMNAR_FORMAT_H_
+#define TENSORFLOW_CORE_DATA_COLUMNAR_FORMAT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/statusor.h"
+
+namespace tensorflow {
+namespace data {
+
+// A columnar file format that stores tables of named, typed columns. Rows are
+// split into row groups, and each row group stores each column as a separate
+// chunk, so that readers only read and decode the columns they need.
+//
+// File layout:
+//   magic ("TFCOLUMN")
+//   column chunks, row group by row group
+//   footer: the schema, and the offset, size, checksum and min/max statistics
+//           of each column chunk
+//   fixed64 footer size
+//   fixed32 masked crc32c of the footer
+//   magic
+//
+// Numeric columns (DT_INT32, DT_INT64, DT_FLOAT, DT_DOUBLE) are stored as
+// little-endian values. String columns store the varint lengths of the values
+// followed by their bytes.
+
+// A column of a columnar file.
+struct ColumnarColumn {
+  std::string name;
+  DataType dtype = DT_INVALID;
+};
+
+// Metadata of one column of one row group.
+struct ColumnarChunk {
+  uint64 offset = 0;
+  uint64 size = 0;
+  uint32 masked_crc = 0;
+  // Whether `min_value` and `max_value` are set. Only numeric chunks with at
+  // least one non-NaN value have statistics. Integer values are rounded to the
+  // nearest double, which preserves their order.
+  bool has_stats = false;
+  double min_value = 0;
+  double max_value = 0;
+};
+
+// Metadata of one row group.
+struct ColumnarRowGroup {
+  int64_t num_rows = 0;
+  // One chunk per column, in schema order.
+  std::vector<ColumnarChunk> chunks;
+};
+
+// Writes a columnar file. Not thread-safe.
+class ColumnarWriter {
+ public:
+  // Does not take ownership of `file`, which must outlive *this.
+  ColumnarWriter(WritableFile* file, std::vector<ColumnarColumn> columns);
+
+  // Writes a row group. `columns` has one vector per column of the schema, in
+  // schema order, which all have the same number of rows.
+  Status WriteRowGroup(const std::vector<Tensor>& columns);
+
+  // Writes the footer. The file has to be closed by the caller.
+  Status Finish();
+
+ private:
+  Status WriteHeaderIfNeeded();
+
+  WritableFile* const file_;  // Not owned.
+  const std::vector<ColumnarColumn> columns_;
+  uint64 offset_ = 0;
+  std::vector<ColumnarRowGroup> row_groups_;
+  bool finished_ = false;
+};
+
+// Reads a columnar file. Thread-safe once opened.
+class ColumnarReader {
+ public:
+  // Opens `filename` and reads its footer.
+  static StatusOr<std::unique_ptr<ColumnarReader>> Open(
+      Env* env, const std::string& filename);
+
+  const std::vector<ColumnarColumn>& columns() const { return columns_; }
+
+  // Returns the index of the column named `name`, or -1 if there is none.
+  int FindColumn(const std::string& name) const;
+
+  int64_t num_row_groups() const { return row_groups_.size(); }
+
+  const ColumnarRowGroup& row_group(int64_t index) const {
+    return row_groups_[index];
+  }
+
+  // Returns false if the statistics of `column` in `row_group` show that no
+  // value is in [`lower`, `upper`]. Returns true if some may be.
+  bool MayContain(int64_t row_group, int column, double lower,
+                  double upper) const;
+
+  // Reads `column` of `row_group` into a vector allocated with `allocator`.
+  Status ReadColumn(int64_t row_group, int column, Allocator* allocator,
+                    Tensor* tensor) const;
+
+ private:
+  ColumnarReader(std::string filename, std::unique_ptr<RandomAccessFile> file)
+      : filename_(std::move(filename)), file_(std::move(file)) {}
+
+  const std::string filename_;
+  const std::unique_ptr<RandomAccessFile> file_;
+  std::vector<ColumnarColumn> columns_;
+  std::vector<ColumnarRowGroup> row_groups_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_COLUMNAR_FORMAT_H_
@@ -0,0 +1,176 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/columnar_format.h"
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/error_codes.pb.h"
+#include "tsl/platform/status_matchers.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+std::string TestFilename(const std::string& name) {
+  return io::JoinPath(testing::TmpDir(), name);
+}
+
+std::vector<ColumnarColumn> TestColumns() {
+  return {{"id", DT_INT64}, {"score", DT_FLOAT}, {"name", DT_STRING}};
+}
+
+Status WriteTestFile(const std::string& filename) {
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewWritableFile(filename, &file));
+  ColumnarWriter writer(file.get(), TestColumns());
+  TF_RETURN_IF_ERROR(writer.WriteRowGroup(
+      {test::AsTensor<int64_t>({1, 2, 3}), test::AsTensor<float>({.5, .25, 1}),
+       test::AsTensor<tstring>({"a", "", "abc"})}));
+  TF_RETURN_IF_ERROR(writer.WriteRowGroup(
+      {test::AsTensor<int64_t>({std::numeric_limits<int64_t>::max(), 10}),
+       test::AsTensor<float>({std::numeric_limits<float>::quiet_NaN(), -2}),
+       test::AsTensor<tstring>({"long string", "x"})}));
+  TF_RETURN_IF_ERROR(writer.Finish());
+  return file->Close();
+}
+
+TEST(ColumnarFormatTest, RoundTrip) {
+  const std::string filename = TestFilename("round_trip");
+  TF_ASSERT_OK(WriteTestFile(filename));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ColumnarReader> reader,
+                          ColumnarReader::Open(Env::Default(), filename));
+  ASSERT_EQ(reader->columns().size(), 3);
+  EXPECT_EQ(reader->columns()[2].name, "name");
+  EXPECT_EQ(reader->columns()[2].dtype, DT_STRING);
+  EXPECT_EQ(reader->FindColumn("score"), 1);
+  EXPECT_EQ(reader->FindColumn("missing"), -1);
+  ASSERT_EQ(reader->num_row_groups(), 2);
+  EXPECT_EQ(reader->row_group(0).num_rows, 3);
+  EXPECT_EQ(reader->row_group(1).num_rows, 2);
+
+  Tensor tensor;
+  TF_ASSERT_OK(reader->ReadColumn(0, 0, cpu_allocator(), &tensor));
+  test::ExpectEqual(tensor, test::AsTensor<int64_t>({1, 2, 3}));
+  TF_ASSERT_OK(reader->ReadColumn(0, 2, cpu_allocator(), &tensor));
+  test::ExpectEqual(tensor, test::AsTensor<tstring>({"a", "", "abc"}));
+  TF_ASSERT_OK(reader->ReadColumn(1, 0, cpu_allocator(), &tensor));
+  test::ExpectEqual(tensor, test::AsTensor<int64_t>(
+                                {std::numeric_limits<int64_t>::max(), 10}));
+  TF_ASSERT_OK(reader->ReadColumn(1, 2, cpu_allocator(), &tensor));
+  test::ExpectEqual(tensor, test::AsTensor<tstring>({"long string", "x"}));
+  EXPECT_THAT(reader->ReadColumn(2, 0, cpu_allocator(), &tensor),
+              StatusIs(error::INVALID_ARGUMENT));
+}
+
+TEST(ColumnarFormatTest, Statistics) {
+  const std::string filename = TestFilename("statistics");
+  TF_ASSERT_OK(WriteTestFile(filename));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ColumnarReader> reader,
+                          ColumnarReader::Open(Env::Default(), filename));
+  const ColumnarChunk& ids = reader->row_group(0).chunks[0];
+  ASSERT_TRUE(ids.has_stats);
+  EXPECT_EQ(ids.min_value, 1);
+  EXPECT_EQ(ids.max_value, 3);
+  // NaN values are ignored.
+  const ColumnarChunk& scores = reader->row_group(1).chunks[1];
+  ASSERT_TRUE(scores.has_stats);
+  EXPECT_EQ(scores.min_value, -2);
+  EXPECT_EQ(scores.max_value, -2);
+  EXPECT_FALSE(reader->row_group(0).chunks[2].has_stats);
+
+  EXPECT_TRUE(reader->MayContain(0, 0, 3, 5));
+  EXPECT_FALSE(reader->MayContain(0, 0, 4, 5));
+  EXPECT_FALSE(reader->MayContain(0, 0, -1, 0.5));
+  EXPECT_TRUE(reader->MayContain(1, 0, 5, 10));
+  EXPECT_TRUE(reader->MayContain(1, 0, 9e18, 1e19));
+  EXPECT_FALSE(reader->MayContain(1, 0, 1e19, 1e20));
+  EXPECT_FALSE(reader->MayContain(1, 1, 0, 1));
+  // Columns without statistics may contain anything.
+  EXPECT_TRUE(reader->MayContain(0, 2, 0, 1));
+}
+
+TEST(ColumnarFormatTest, EmptyFile) {
+  const std::string filename = TestFilename("empty");
+  std::unique_ptr<WritableFile> file;
+  TF_ASSERT_OK(Env::Default()->NewWritableFile(filename, &file));
+  ColumnarWriter writer(file.get(), TestColumns());
+  TF_ASSERT_OK(writer.Finish());
+  TF_ASSERT_OK(file->Close());
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ColumnarReader> reader,
+                          ColumnarReader::Open(Env::Default(), filename));
+  EXPECT_EQ(reader->columns().size(), 3);
+  EXPECT_EQ(reader->num_row_groups(), 0);
+}
+
+TEST(ColumnarFormatTest, InvalidRowGroup) {
+  std::unique_ptr<WritableFile> file;
+  TF_ASSERT_OK(
+      Env::Default()->NewWritableFile(TestFilename("invalid_rows"), &file));
+  ColumnarWriter writer(file.get(), TestColumns());
+  EXPECT_THAT(writer.WriteRowGroup({test::AsTensor<int64_t>({1})}),
+              StatusIs(error::INVALID_ARGUMENT));
+  EXPECT_THAT(writer.WriteRowGroup({test::AsTensor<int64_t>({1, 2}),
+                                    test::AsTensor<float>({1}),
+                                    test::AsTensor<tstring>({"a", "b"})}),
+              StatusIs(error::INVALID_ARGUMENT));
+  EXPECT_THAT(writer.WriteRowGroup({test::AsTensor<int64_t>({1}),
+                                    test::AsTensor<int64_t>({1}),
+                                    test::AsTensor<tstring>({"a"})}),
+              StatusIs(error::INVALID_ARGUMENT));
+}
+
+TEST(ColumnarFormatTest, CorruptedFile) {
+  const std::string filename = TestFilename("corrupted");
+  TF_ASSERT_OK(WriteTestFile(filename));
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filename, &contents));
+
+  // Corrupts the first id.
+  std::string corrupted = contents;
+  corrupted[8] ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, corrupted));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ColumnarReader> reader,
+                          ColumnarReader::Open(Env::Default(), filename));
+  Tensor tensor;
+  EXPECT_THAT(reader->ReadColumn(0, 0, cpu_allocator(), &tensor),
+              StatusIs(error::DATA_LOSS));
+  TF_EXPECT_OK(reader->ReadColumn(0, 1, cpu_allocator(), &tensor));
+
+  // Corrupts the footer.
+  corrupted = contents;
+  corrupted[contents.size() - 30] ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, corrupted));
+  EXPECT_THAT(ColumnarReader::Open(Env::Default(), filename),
+              StatusIs(error::DATA_LOSS));
+
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, "not columnar"));
+  EXPECT_THAT(ColumnarReader::Open(Env::Default(), filename),
+              StatusIs(error::DATA_LOSS));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -14,18 +14,24 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <algorithm>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/types.h"
+#include "zstd.h"  // from @net_zstd
 
 namespace tensorflow {
 namespace data {
@@ -35,6 +41,244 @@ namespace {
 // `UncompressElement` function will determine what to read according to the
 // version.
 constexpr int kCompressedElementVersion = 0;
+// Version of `CompressedElement`s whose data is made of independently
+// compressed chunks, described by `chunk_uncompressed_bytes` and
+// `chunk_compressed_bytes`.
+constexpr int kChunkedCompressedElementVersion = 1;
+
+// Level used for zstd compression. Level 3 is the zstd default, which
+// compresses much better than snappy at a moderate CPU cost.
+constexpr int kZstdCompressionLevel = 3;
+
+// Runs `fn(i)` for `i` in `[0, n)`, on `thread_pool` if it is not null, and
+// returns the first error.
+Status RunInParallel(thread::ThreadPool* thread_pool, int64_t n,
+                     const std::function<Status(int64_t)>& fn) {
+  if (thread_pool == nullptr || n <= 1) {
+    for (int64_t i = 0; i < n; ++i) {
+      TF_RETURN_IF_ERROR(fn(i));
+    }
+    return OkStatus();
+  }
+  std::vector<Status> statuses(n);
+  BlockingCounter counter(n - 1);
+  for (int64_t i = 1; i < n; ++i) {
+    thread_pool->Schedule([&fn, &statuses, &counter, i]() {
+      statuses[i] = fn(i);
+      counter.DecrementCount();
+    });
+  }
+  statuses[0] = fn(0);
+  counter.Wait();
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return OkStatus();
+}
+
+// Splits the bytes described by the `num_pieces` iovecs of `pieces` into
+// consecutive chunks of `chunk_size` bytes (the last chunk may be smaller),
+// returning the iovecs describing each chunk.
+std::vector<std::vector<struct iovec>> SplitIntoChunks(
+    const struct iovec* pieces, size_t num_pieces, size_t chunk_size) {
+  std::vector<std::vector<struct iovec>> chunks;
+  size_t chunk_bytes = chunk_size;
+  for (size_t i = 0; i < num_pieces; ++i) {
+    char* base = static_cast<char*>(pieces[i].iov_base);
+    size_t len = pieces[i].iov_len;
+    while (len > 0) {
+      if (chunk_bytes == chunk_size) {
+        chunks.emplace_back();
+        chunk_bytes = 0;
+      }
+      size_t n = std::min(len, chunk_size - chunk_bytes);
+      chunks.back().push_back({base, n});
+      chunk_bytes += n;
+      base += n;
+      len -= n;
+    }
+  }
+  return chunks;
+}
+
+size_t NumBytes(const std::vector<struct iovec>& pieces) {
+  size_t num_bytes = 0;
+  for (const auto& piece : pieces) {
+    num_bytes += piece.iov_len;
+  }
+  return num_bytes;
+}
+
+Status SnappyCompress(const std::vector<struct iovec>& pieces,
+                      std::string* out) {
+  const size_t num_bytes = NumBytes(pieces);
+  if (num_bytes > kuint32max) {
+    return errors::OutOfRange("Encountered dataset element of size ",
+                              num_bytes, ", exceeding the 4GB Snappy limit.");
+  }
+  if (!port::Snappy_CompressFromIOVec(pieces.data(), num_bytes, out)) {
+    return errors::Internal("Failed to compress using snappy.");
+  }
+  return OkStatus();
+}
+
+Status SnappyUncompress(absl::string_view data,
+                        const std::vector<struct iovec>& pieces) {
+  size_t uncompressed_size;
+  if (!port::Snappy_GetUncompressedLength(data.data(), data.size(),
+                                          &uncompressed_size)) {
+    return errors::Internal(
+        "Could not get snappy uncompressed length. Compressed data size: ",
+        data.size());
+  }
+  if (uncompressed_size != NumBytes(pieces)) {
+    return errors::Internal(
+        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", NumBytes(pieces));
+  }
+  if (!port::Snappy_UncompressToIOVec(data.data(), data.size(), pieces.data(),
+                                      pieces.size())) {
+    return errors::Internal("Failed to perform snappy decompression.");
+  }
+  return OkStatus();
+}
+
+Status ZstdCompress(const std::vector<struct iovec>& pieces,
+                    std::string* out) {
+  const size_t num_bytes = NumBytes(pieces);
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(ZSTD_createCCtx(),
+                                                            &ZSTD_freeCCtx);
+  if (cctx == nullptr) {
+    return errors::ResourceExhausted("Failed to create a zstd context.");
+  }
+  ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_compressionLevel,
+                         kZstdCompressionLevel);
+  ZSTD_CCtx_setPledgedSrcSize(cctx.get(), num_bytes);
+  // The output is sized for the worst case, so the compressor never runs out
+  // of output space.
+  out->resize(ZSTD_compressBound(num_bytes));
+  ZSTD_outBuffer output = {&(*out)[0], out->size(), 0};
+  for (const auto& piece : pieces) {
+    ZSTD_inBuffer input = {piece.iov_base, piece.iov_len, 0};
+    while (input.pos < input.size) {
+      size_t result = ZSTD_compressStream2(cctx.get(), &output, &input,
+                                           ZSTD_e_continue);
+      if (ZSTD_isError(result)) {
+        return errors::Internal("Failed to compress using zstd: ",
+                                ZSTD_getErrorName(result));
+      }
+    }
+  }
+  ZSTD_inBuffer input = {nullptr, 0, 0};
+  size_t remaining;
+  do {
+    remaining = ZSTD_compressStream2(cctx.get(), &output, &input, ZSTD_e_end);
+    if (ZSTD_isError(remaining)) {
+      return errors::Internal("Failed to compress using zstd: ",
+                              ZSTD_getErrorName(remaining));
+    }
+  } while (remaining > 0);
+  out->resize(output.pos);
+  return OkStatus();
+}
+
+Status ZstdUncompress(absl::string_view data,
+                      const std::vector<struct iovec>& pieces) {
+  unsigned long long uncompressed_size =  // NOLINT(runtime/int)
+      ZSTD_getFrameContentSize(data.data(), data.size());
+  if (uncompressed_size == ZSTD_CONTENTSIZE_ERROR ||
+      uncompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return errors::Internal(
+        "Could not get zstd uncompressed length. Compressed data size: ",
+        data.size());
+  }
+  if (uncompressed_size != NumBytes(pieces)) {
+    return errors::Internal(
+        "Uncompressed size mismatch. Zstd expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", NumBytes(pieces));
+  }
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(ZSTD_createDCtx(),
+                                                            &ZSTD_freeDCtx);
+  if (dctx == nullptr) {
+    return errors::ResourceExhausted("Failed to create a zstd context.");
+  }
+  ZSTD_inBuffer input = {data.data(), data.size(), 0};
+  for (const auto& piece : pieces) {
+    ZSTD_outBuffer output = {piece.iov_base, piece.iov_len, 0};
+    while (output.pos < output.size) {
+      const size_t input_pos = input.pos;
+      const size_t output_pos = output.pos;
+      size_t result = ZSTD_decompressStream(dctx.get(), &output, &input);
+      if (ZSTD_isError(result)) {
+        return errors::Internal("Failed to perform zstd decompression: ",
+                                ZSTD_getErrorName(result));
+      }
+      if (input.pos == input_pos && output.pos == output_pos) {
+        return errors::Internal(
+            "Failed to perform zstd decompression: truncated data.");
+      }
+    }
+  }
+  return OkStatus();
+}
+
+Status CopyUncompressed(const std::vector<struct iovec>& pieces,
+                        std::string* out) {
+  out->reserve(NumBytes(pieces));
+  for (const auto& piece : pieces) {
+    out->append(static_cast<const char*>(piece.iov_base), piece.iov_len);
+  }
+  return OkStatus();
+}
+
+Status CopyToPieces(absl::string_view data,
+                    const std::vector<struct iovec>& pieces) {
+  if (data.size() != NumBytes(pieces)) {
+    return errors::Internal("Uncompressed size mismatch. Data has ",
+                            data.size(),
+                            " bytes whereas the tensor metadata suggests ",
+                            NumBytes(pieces));
+  }
+  for (const auto& piece : pieces) {
+    memcpy(piece.iov_base, data.data(), piece.iov_len);
+    data.remove_prefix(piece.iov_len);
+  }
+  return OkStatus();
+}
+
+// Compresses the bytes described by `pieces` with `codec`.
+Status CompressChunk(CompressedElement::Codec codec,
+                     const std::vector<struct iovec>& pieces,
+                     std::string* out) {
+  switch (codec) {
+    case CompressedElement::CODEC_SNAPPY:
+      return SnappyCompress(pieces, out);
+    case CompressedElement::CODEC_ZSTD:
+      return ZstdCompress(pieces, out);
+    case CompressedElement::CODEC_NONE:
+      return CopyUncompressed(pieces, out);
+    default:
+      return errors::InvalidArgument("Unsupported compression codec: ",
+                                     CompressedElement::Codec_Name(codec));
+  }
+}
+
+// Uncompresses `data`, compressed with `codec`, into the memory described by
+// `pieces`.
+Status UncompressChunk(CompressedElement::Codec codec, absl::string_view data,
+                       const std::vector<struct iovec>& pieces) {
+  switch (codec) {
+    case CompressedElement::CODEC_SNAPPY:
+      return SnappyUncompress(data, pieces);
+    case CompressedElement::CODEC_ZSTD:
+      return ZstdUncompress(data, pieces);
+    case CompressedElement::CODEC_NONE:
+      return CopyToPieces(data, pieces);
+    default:
+      return errors::Internal("Unsupported compression codec: ",
+                              CompressedElement::Codec_Name(codec));
+  }
+}
 
 }  // namespace
 
@@ -61,8 +305,75 @@ class Iov {
   size_t num_bytes_;
 };
 
+namespace {
+
+// Uncompresses the chunks of `compressed` in parallel, directly into the
+// memory described by `iov`.
+Status UncompressChunks(const CompressedElement& compressed, Iov& iov,
+                        thread::ThreadPool* thread_pool) {
+  const size_t chunk_size = compressed.chunk_uncompressed_bytes();
+  if (chunk_size == 0 || compressed.chunk_compressed_bytes_size() == 0) {
+    return errors::Internal(
+        "Chunked compressed element does not describe its chunks.");
+  }
+  std::vector<std::vector<struct iovec>> chunks =
+      SplitIntoChunks(iov.Data(), iov.NumPieces(), chunk_size);
+  if (chunks.size() !=
+      static_cast<size_t>(compressed.chunk_compressed_bytes_size())) {
+    return errors::Internal("Compressed element has ",
+                            compressed.chunk_compressed_bytes_size(),
+                            " chunks whereas the tensor metadata suggests ",
+                            chunks.size());
+  }
+  const std::string& compressed_data = compressed.data();
+  std::vector<size_t> offsets(chunks.size() + 1, 0);
+  for (int i = 0; i < chunks.size(); ++i) {
+    offsets[i + 1] = offsets[i] + compressed.chunk_compressed_bytes(i);
+  }
+  if (offsets.back() != compressed_data.size()) {
+    return errors::Internal("Compressed chunks add up to ", offsets.back(),
+                            " bytes, but the compressed data has ",
+                            compressed_data.size(), " bytes");
+  }
+  return RunInParallel(thread_pool, chunks.size(), [&](int64_t i) {
+    return UncompressChunk(
+        compressed.codec(),
+        absl::string_view(compressed_data.data() + offsets[i],
+                          offsets[i + 1] - offsets[i]),
+        chunks[i]);
+  });
+}
+
+}  // namespace
+
+StatusOr<CompressedElement::Codec> ParseCompressionCodec(
+    absl::string_view codec) {
+  if (codec == kSnappyCodec) {
+    return CompressedElement::CODEC_SNAPPY;
+  }
+  if (codec == kZstdCodec) {
+    return CompressedElement::CODEC_ZSTD;
+  }
+  if (codec == kNoCodec) {
+    return CompressedElement::CODEC_NONE;
+  }
+  return errors::InvalidArgument("Unknown compression codec: ", codec,
+                                 ". Supported codecs are ", kSnappyCodec, ", ",
+                                 kZstdCodec, " and ", kNoCodec, ".");
+}
+
+Status CompressElement(const std::vector<Tensor>& element,
+                       CompressedElement* out) {
+  return CompressElement(element, CompressElementOptions(), out);
+}
+
 Status CompressElement(const std::vector<Tensor>& element,
+                       const CompressElementOptions& options,
                        CompressedElement* out) {
+  const size_t chunk_size_bytes = options.chunk_size_bytes;
+  if (chunk_size_bytes == 0) {
+    return errors::InvalidArgument("Chunk size must be positive.");
+  }
   // First pass: preprocess the non`memcpy`able tensors.
   size_t num_string_tensors = 0;
   size_t num_string_tensor_strings = 0;
@@ -120,16 +431,35 @@ Status CompressElement(const std::vector<Tensor>& element,
     }
   }
 
-  if (iov.NumBytes() > kuint32max) {
-    return errors::OutOfRange("Encountered dataset element of size ",
-                              iov.NumBytes(),
-                              ", exceeding the 4GB Snappy limit.");
-  }
-  if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
-                                      out->mutable_data())) {
-    return errors::Internal("Failed to compress using snappy.");
+  out->set_codec(options.codec);
+  if (iov.NumBytes() <= chunk_size_bytes) {
+    TF_RETURN_IF_ERROR(CompressChunk(
+        options.codec,
+        std::vector<struct iovec>(iov.Data(), iov.Data() + iov.NumPieces()),
+        out->mutable_data()));
+    out->set_version(kCompressedElementVersion);
+  } else {
+    std::vector<std::vector<struct iovec>> chunks =
+        SplitIntoChunks(iov.Data(), iov.NumPieces(), chunk_size_bytes);
+    std::vector<std::string> compressed_chunks(chunks.size());
+    TF_RETURN_IF_ERROR(
+        RunInParallel(options.thread_pool, chunks.size(), [&](int64_t i) {
+          return CompressChunk(options.codec, chunks[i],
+                               &compressed_chunks[i]);
+        }));
+    size_t total_compressed_bytes = 0;
+    for (const auto& compressed_chunk : compressed_chunks) {
+      total_compressed_bytes += compressed_chunk.size();
+    }
+    std::string* data = out->mutable_data();
+    data->reserve(total_compressed_bytes);
+    for (const auto& compressed_chunk : compressed_chunks) {
+      data->append(compressed_chunk);
+      out->add_chunk_compressed_bytes(compressed_chunk.size());
+    }
+    out->set_chunk_uncompressed_bytes(chunk_size_bytes);
+    out->set_version(kChunkedCompressedElementVersion);
   }
-  out->set_version(kCompressedElementVersion);
   VLOG(3) << "Compressed element from " << iov.NumBytes() << " bytes to "
           << out->data().size() << " bytes";
   return OkStatus();
@@ -137,7 +467,14 @@ Status CompressElement(const std::vector<Tensor>& element,
 
 Status UncompressElement(const CompressedElement& compressed,
                          std::vector<Tensor>* out) {
-  if (compressed.version() != kCompressedElementVersion) {
+  return UncompressElement(compressed, /*thread_pool=*/nullptr, out);
+}
+
+Status UncompressElement(const CompressedElement& compressed,
+                         thread::ThreadPool* thread_pool,
+                         std::vector<Tensor>* out) {
+  if (compressed.version() != kCompressedElementVersion &&
+      compressed.version() != kChunkedCompressedElementVersion) {
     return errors::Internal("Unsupported compressed element version: ",
                             compressed.version());
   }
@@ -190,23 +527,12 @@ Status UncompressElement(const CompressedElement& compressed,
   }
 
   // Step 2: Uncompress into the iovec.
-  const std::string& compressed_data = compressed.data();
-  size_t uncompressed_size;
-  if (!port::Snappy_GetUncompressedLength(
-          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
-    return errors::Internal(
-        "Could not get snappy uncompressed length. Compressed data size: ",
-        compressed_data.size());
-  }
-  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
-    return errors::Internal(
-        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
-        " whereas the tensor metadata suggests ", iov.NumBytes());
-  }
-  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
-                                      compressed_data.size(), iov.Data(),
-                                      iov.NumPieces())) {
-    return errors::Internal("Failed to perform snappy decompression.");
+  if (compressed.version() == kChunkedCompressedElementVersion) {
+    TF_RETURN_IF_ERROR(UncompressChunks(compressed, iov, thread_pool));
+  } else {
+    TF_RETURN_IF_ERROR(UncompressChunk(
+        compressed.codec(), compressed.data(),
+        std::vector<struct iovec>(iov.Data(), iov.Data() + iov.NumPieces())));
   }
 
   // Third pass: deserialize nonstring, non`memcpy`able tensors.
@@ -15,15 +15,40 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 #define TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 
+#include <limits>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace data {
 
+// Names of the supported compression codecs, as accepted by
+// `ParseCompressionCodec`.
+constexpr char kSnappyCodec[] = "snappy";
+constexpr char kZstdCodec[] = "zstd";
+constexpr char kNoCodec[] = "none";
+
+// Returns the codec named `codec`.
+StatusOr<CompressedElement::Codec> ParseCompressionCodec(
+    absl::string_view codec);
+
+// Options for compressing elements.
+struct CompressElementOptions {
+  // The codec used to compress the element.
+  CompressedElement::Codec codec = CompressedElement::CODEC_SNAPPY;
+  // Elements larger than this are split into chunks which are compressed
+  // independently, and can be uncompressed in parallel by `UncompressElement`.
+  size_t chunk_size_bytes = std::numeric_limits<size_t>::max();
+  // If not null, chunks are compressed in parallel on this thread pool.
+  thread::ThreadPool* thread_pool = nullptr;
+};
+
 // Compresses the components of `element` into the `CompressedElement` proto.
 //
 // In addition to writing the actual compressed bytes, `Compress` fills
@@ -33,10 +58,26 @@ namespace data {
 Status CompressElement(const std::vector<Tensor>& element,
                        CompressedElement* out);
 
+// Like `CompressElement`, but compresses according to `options`. The codec is
+// recorded in the `CompressedElement`, so `UncompressElement` does not need to
+// know it.
+//
+// Returns an error if `options.chunk_size_bytes` is 0, or if snappy is used
+// and the element or a chunk exceeds 4GB.
+Status CompressElement(const std::vector<Tensor>& element,
+                       const CompressElementOptions& options,
+                       CompressedElement* out);
+
 // Uncompresses a `CompressedElement` into a vector of tensor components.
 Status UncompressElement(const CompressedElement& compressed,
                          std::vector<Tensor>* out);
 
+// Like `UncompressElement`, but uncompresses the chunks of chunked elements in
+// parallel on `thread_pool`, directly into the output tensor buffers.
+Status UncompressElement(const CompressedElement& compressed,
+                         thread::ThreadPool* thread_pool,
+                         std::vector<Tensor>* out);
+
 }  // namespace data
 }  // namespace tensorflow
 
@@ -14,12 +14,15 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <limits>
 #include <string>
 #include <vector>
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 #include "tsl/platform/status_matchers.h"
 
@@ -28,6 +31,7 @@ namespace data {
 namespace {
 
 using ::testing::HasSubstr;
+using ::tsl::testing::IsOkAndHolds;
 using ::tsl::testing::StatusIs;
 
 TEST(CompressionUtilsTest, Exceeds4GB) {
@@ -39,6 +43,74 @@ TEST(CompressionUtilsTest, Exceeds4GB) {
                        HasSubstr("exceeding the 4GB Snappy limit")));
 }
 
+CompressElementOptions ChunkSize(size_t chunk_size_bytes) {
+  CompressElementOptions options;
+  options.chunk_size_bytes = chunk_size_bytes;
+  return options;
+}
+
+TEST(CompressionUtilsTest, ParseCompressionCodec) {
+  EXPECT_THAT(ParseCompressionCodec("snappy"),
+              IsOkAndHolds(CompressedElement::CODEC_SNAPPY));
+  EXPECT_THAT(ParseCompressionCodec("zstd"),
+              IsOkAndHolds(CompressedElement::CODEC_ZSTD));
+  EXPECT_THAT(ParseCompressionCodec("none"),
+              IsOkAndHolds(CompressedElement::CODEC_NONE));
+  EXPECT_THAT(ParseCompressionCodec("lz4"),
+              StatusIs(error::INVALID_ARGUMENT));
+}
+
+TEST(CompressionUtilsTest, CodecIsRecorded) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{1024})};
+  CompressElementOptions options;
+  options.codec = CompressedElement::CODEC_ZSTD;
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  EXPECT_EQ(compressed.codec(), CompressedElement::CODEC_ZSTD);
+
+  options.codec = CompressedElement::CODEC_NONE;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  EXPECT_EQ(compressed.codec(), CompressedElement::CODEC_NONE);
+  EXPECT_EQ(compressed.data().size(), 1024 * sizeof(int64_t));
+}
+
+TEST(CompressionUtilsTest, ChunkedElement) {
+  std::vector<Tensor> element = {
+      CreateTensor<int64_t>(TensorShape{128, 128}),
+      CreateTensor<tstring>(TensorShape{2}, {"abc", "xyz"})};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, ChunkSize(1000), &compressed));
+  EXPECT_EQ(compressed.version(), 1);
+  EXPECT_EQ(compressed.chunk_uncompressed_bytes(), 1000);
+  // 128 * 128 * 8 bytes of int64s and 6 bytes of strings.
+  EXPECT_EQ(compressed.chunk_compressed_bytes_size(), 132);
+}
+
+TEST(CompressionUtilsTest, SingleChunkElement) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{16})};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, ChunkSize(1 << 20), &compressed));
+  EXPECT_EQ(compressed.version(), 0);
+  EXPECT_EQ(compressed.chunk_compressed_bytes_size(), 0);
+}
+
+TEST(CompressionUtilsTest, InvalidChunkSize) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{16})};
+  CompressedElement compressed;
+  EXPECT_THAT(CompressElement(element, ChunkSize(0), &compressed),
+              StatusIs(error::INVALID_ARGUMENT));
+}
+
+TEST(CompressionUtilsTest, CorruptedChunkMetadata) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{128})};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, ChunkSize(100), &compressed));
+  compressed.add_chunk_compressed_bytes(1);
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              StatusIs(error::INTERNAL));
+}
+
 std::vector<std::vector<Tensor>> TestCases() {
   return {
       // Single int64.
@@ -104,6 +176,45 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
               StatusIs(error::INTERNAL));
 }
 
+TEST_P(ParameterizedCompressionUtilsTest, ChunkedRoundTrip) {
+  std::vector<Tensor> element = GetParam();
+  thread::ThreadPool thread_pool(Env::Default(), "chunked_compression",
+                                 /*num_threads=*/4);
+  for (size_t chunk_size : {1, 3, 64, 1 << 20}) {
+    for (thread::ThreadPool* pool :
+         {&thread_pool, static_cast<thread::ThreadPool*>(nullptr)}) {
+      CompressedElement compressed;
+      CompressElementOptions options;
+      options.chunk_size_bytes = chunk_size;
+      options.thread_pool = pool;
+      TF_ASSERT_OK(CompressElement(element, options, &compressed));
+      std::vector<Tensor> round_trip_element;
+      TF_ASSERT_OK(UncompressElement(compressed, pool, &round_trip_element));
+      TF_EXPECT_OK(
+          ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+    }
+  }
+}
+
+TEST_P(ParameterizedCompressionUtilsTest, CodecRoundTrip) {
+  std::vector<Tensor> element = GetParam();
+  for (CompressedElement::Codec codec :
+       {CompressedElement::CODEC_SNAPPY, CompressedElement::CODEC_ZSTD,
+        CompressedElement::CODEC_NONE}) {
+    for (size_t chunk_size : {size_t{7}, std::numeric_limits<size_t>::max()}) {
+      CompressElementOptions options;
+      options.codec = codec;
+      options.chunk_size_bytes = chunk_size;
+      CompressedElement compressed;
+      TF_ASSERT_OK(CompressElement(element, options, &compressed));
+      std::vector<Tensor> round_trip_element;
+      TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+      TF_EXPECT_OK(
+          ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
@@ -917,6 +917,11 @@ bool ShouldUsePrivateThreadPool(const Options& options) {
          ThreadingOptions::kPrivateThreadpoolSize;
 }
 
+bool ShouldPinToNumaNode(const Options& options) {
+  return options.threading_options().optional_numa_node_case() ==
+         ThreadingOptions::kNumaNode;
+}
+
 bool ShouldUseAutotuning(const Options& options) {
   return options.autotune_options().optional_enabled_case() !=
              AutotuneOptions::kEnabled ||
@@ -983,6 +988,8 @@ REGISTER_DATASET_EXPERIMENT("allow_small_function_optimizations",
                             RandomJobSamplePercentage<0>, AllTasks);
 REGISTER_DATASET_EXPERIMENT("autotune_buffer_optimization",
                             RandomJobSamplePercentage<0>, IndependentHostTasks);
+REGISTER_DATASET_EXPERIMENT("autotune_rewrites", RandomJobSamplePercentage<0>,
+                            AllTasks);
 REGISTER_DATASET_EXPERIMENT(kFilterParallelizationOpt,
                             RandomJobSamplePercentage<0>, AllTasks);
 REGISTER_DATASET_EXPERIMENT("min_outer_interleave_parallelism",
@@ -1009,6 +1016,12 @@ REGISTER_DATASET_EXPERIMENT("reduce_array_record_dataset_memory_usage",
                             RandomJobSamplePercentage<50>, AllTasks);
 REGISTER_DATASET_EXPERIMENT("map_fusion", RandomJobSamplePercentage<0>,
                             AllTasks);
+REGISTER_DATASET_EXPERIMENT("map_vectorization", RandomJobSamplePercentage<0>,
+                            AllTasks);
+REGISTER_DATASET_EXPERIMENT("tfrecord_readahead", RandomJobSamplePercentage<0>,
+                            AllTasks);
+REGISTER_DATASET_EXPERIMENT("tfrecord_string_views",
+                            RandomJobSamplePercentage<0>, AllTasks);
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -348,6 +348,9 @@ bool ShouldConfigureMaxIntraOpParallelism(const Options& options);
 // Determines whether private threadpool should be used.
 bool ShouldUsePrivateThreadPool(const Options& options);
 
+// Determines whether the iterator threads should be pinned to a NUMA node.
+bool ShouldPinToNumaNode(const Options& options);
+
 // Determines whether autotuning should be used.
 bool ShouldUseAutotuning(const Options& options);
 
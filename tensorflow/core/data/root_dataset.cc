@@ -26,6 +26,8 @@ limitations under the License.
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/rewrite_utils.h"
+#include "tensorflow/core/data/unbounded_thread_pool.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
 #include "tensorflow/core/framework/model.h"
@@ -33,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringprintf.h"
@@ -55,6 +58,7 @@ constexpr char kPrivateThreadpoolSize[] = "threadpool_size";
 constexpr char kRamBudget[] = "ram_budget_megabytes";
 constexpr char kRamUsage[] = "ram_usage_megabytes";
 constexpr char kMaxBufferBytes[] = "max_buffered_megabytes";
+constexpr char kNumaNode[] = "numa_node";
 constexpr char kWarmStart[] = "warm_start";
 
 // If value `x` matches `y`, returns default value `z`. Otherwise, return `x`.
@@ -71,6 +75,20 @@ void SetRootDatasetParams(const Options& options, RootDataset::Params* params) {
     params->private_threadpool_size =
         options.threading_options().private_threadpool_size();
   }
+  if (ShouldPinToNumaNode(options)) {
+    const int64_t numa_node = options.threading_options().numa_node();
+    if (!port::NUMAEnabled()) {
+      LOG(WARNING) << "Ignoring `numa_node` threading option because NUMA is "
+                      "not supported on this platform.";
+    } else if (numa_node < 0 || numa_node >= port::NUMANumNodes()) {
+      LOG(WARNING) << "Ignoring `numa_node` threading option because NUMA "
+                      "node "
+                   << numa_node << " is out of range [0, "
+                   << port::NUMANumNodes() << ").";
+    } else {
+      params->numa_node = numa_node;
+    }
+  }
   params->autotune = ShouldUseAutotuning(options);
   params->autotune_algorithm = model::AutotuneAlgorithm::DEFAULT;
   auto experiments = GetExperiments();
@@ -134,6 +152,11 @@ void AddTraceMetadata(const RootDataset::Params& params, const Options& options,
                                     params.private_threadpool_size, 0,
                                     port::MaxParallelism())))));
   }
+  if (params.numa_node != port::kNUMANoAffinity) {
+    trace_metadata->push_back(std::make_pair(
+        kNumaNode,
+        strings::Printf("%lld", static_cast<long long>(params.numa_node))));
+  }
   auto experiments = GetExperiments();
   if (!experiments.empty()) {
     trace_metadata->push_back(
@@ -172,12 +195,29 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
           value_or_default(dataset()->params_.max_intra_op_parallelism, 0,
                            port::MaxParallelism());
     }
+    ThreadOptions thread_options;
+    const int64_t numa_node = dataset()->params_.numa_node;
+    if (numa_node != port::kNUMANoAffinity) {
+      // Pin all threads started by the iterators of this pipeline (and the
+      // threads executing the user-defined functions) to the requested NUMA
+      // node. If no private threadpool has been requested, use one sized to
+      // the parallelism of the node so that function execution does not
+      // escape to the other sockets through the inter-op threadpool.
+      thread_options.numa_node = numa_node;
+      numa_thread_pool_ = std::make_unique<UnboundedThreadPool>(
+          Env::Default(), "tf_data_numa_iterator", thread_options);
+    }
     if (dataset()->params_.private_threadpool_size >= 0) {
       threadpool_size_ =
           value_or_default(dataset()->params_.private_threadpool_size, 0,
-                           port::MaxParallelism());
+                           port::MaxParallelism(numa_node));
+      thread_pool_ = std::make_unique<thread::ThreadPool>(
+          Env::Default(), thread_options, "data_private_threadpool",
+          threadpool_size_);
+    } else if (numa_node != port::kNUMANoAffinity) {
+      threadpool_size_ = port::MaxParallelism(numa_node);
       thread_pool_ = std::make_unique<thread::ThreadPool>(
-          Env::Default(), ThreadOptions{}, "data_private_threadpool",
+          Env::Default(), thread_options, "data_numa_threadpool",
           threadpool_size_);
     }
     cancellation_manager_ = std::make_unique<CancellationManager>();
@@ -205,6 +245,9 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
       if (experiments.contains("autotune_buffer_optimization")) {
         model_->AddExperiment("autotune_buffer_optimization");
       }
+      if (experiments.contains("autotune_rewrites")) {
+        model_->AddExperiment("autotune_rewrites");
+      }
     }
     IteratorContext iter_ctx(CreateParams(ctx));
     if (model_) {
@@ -315,12 +358,29 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
     // been set to a valid model in `Initialize()` if autotuning is on. We
     // should simply set `params.model` to `model_` here.
     params.model = model_;
-    if (dataset()->params_.private_threadpool_size >= 0) {
+    if (thread_pool_) {
       params.runner = [pool = thread_pool_.get()](std::function<void()> c) {
         pool->Schedule(std::move(c));
       };
       params.runner_threadpool_size = threadpool_size_;
     }
+    if (numa_thread_pool_) {
+      params.thread_factory = numa_thread_pool_->get_thread_factory();
+      params.thread_pool = numa_thread_pool_.get();
+      // Serve host allocations from memory local to the NUMA node so that
+      // element buffers produced by the pinned threads stay on the node.
+      params.allocator_getter =
+          [allocator_getter = std::move(params.allocator_getter),
+           numa_node = dataset()->params_.numa_node](
+              AllocatorAttributes attrs) -> Allocator* {
+        Allocator* allocator =
+            allocator_getter ? allocator_getter(attrs) : cpu_allocator();
+        if (attrs.on_host() || allocator == cpu_allocator()) {
+          return cpu_allocator(numa_node);
+        }
+        return allocator;
+      };
+    }
     if (dataset()->params_.max_intra_op_parallelism >= 0) {
       params.runner =
           RunnerWithMaxParallelism(params.runner, max_intra_op_parallelism_);
@@ -332,7 +392,7 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
     mutex_lock l(mu_);
     if (!model_thread_) {
       RunMode run_mode = ctx->run_mode();
-      model_thread_ = ctx->StartThread("tf_data_model", [this, run_mode]() {
+      auto model_thread_fn = [this, run_mode]() {
         RootDataset::Params params = dataset()->params_;
         std::function<int64_t(int64_t)> ram_budget_func;
         std::optional<int64_t> raw_ram_budget;
@@ -349,7 +409,15 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
         if (!status.ok()) {
           LOG(WARNING) << "Optimization loop failed: " << status;
         }
-      });
+      };
+      if (numa_thread_pool_) {
+        model_thread_ =
+            numa_thread_pool_->get_thread_factory()->StartThread(
+                "tf_data_model", std::move(model_thread_fn));
+      } else {
+        model_thread_ =
+            ctx->StartThread("tf_data_model", std::move(model_thread_fn));
+      }
     }
     return OkStatus();
   }
@@ -366,6 +434,10 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
   int64_t max_intra_op_parallelism_;
   int64_t threadpool_size_;
   std::unique_ptr<thread::ThreadPool> thread_pool_;
+  // Hosts the threads of the input pipeline when they are pinned to a NUMA
+  // node. Must be ordered after `model_thread_` and before `input_impl_` so
+  // that the logical threads are joined before the pool is destroyed.
+  std::unique_ptr<UnboundedThreadPool> numa_thread_pool_;
 
   // The end time of the previous `GetNextInternal` call.
   uint64_t end_time_usec_ TF_GUARDED_BY(mu_) = 0;
@@ -36,6 +36,11 @@ namespace tensorflow {
 namespace data {
 
 constexpr double kAutoScalerOutlierSigmas = 1.0;
+// Time constants of the EWMAs of the consumption rates sum and of its trend.
+// The trend is smoothed more slowly so that heartbeat jitter is not
+// extrapolated.
+constexpr absl::Duration kForecastLevelTimeConstant = absl::Minutes(1);
+constexpr absl::Duration kForecastTrendTimeConstant = absl::Minutes(5);
 
 template <typename T>
 double GetMedian(const absl::flat_hash_map<T, double>& rates) {
@@ -96,13 +101,8 @@ void ReplaceOutliers(const absl::flat_hash_map<T, double>& rates,
   }
 }
 
-std::optional<int64_t> AutoScaler::GetOptimalNumberOfWorkers() const
-    TF_LOCKS_EXCLUDED(mu_) {
-  tsl::mutex_lock l(mu_);
-
-  if (worker_throughputs_.empty() || consumption_rates_.empty())
-    return std::nullopt;
-
+double AutoScaler::GetConsumptionRatesSum() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   std::vector<double> consumption_rates_without_outliers;
   // TODO(armandouv): Discard outlier replacement when we ensure reported time
   // values are correct.
@@ -110,10 +110,12 @@ std::optional<int64_t> AutoScaler::GetOptimalNumberOfWorkers() const
   // low).
   ReplaceOutliers(consumption_rates_, consumption_rates_without_outliers,
                   kAutoScalerOutlierSigmas);
-  double consumption_rates_sum_ =
-      std::accumulate(consumption_rates_without_outliers.begin(),
-                      consumption_rates_without_outliers.end(), 0.0);
+  return std::accumulate(consumption_rates_without_outliers.begin(),
+                         consumption_rates_without_outliers.end(), 0.0);
+}
 
+double AutoScaler::GetAverageWorkerThroughput() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   std::vector<double> worker_throughputs_without_outliers;
   ReplaceOutliers(worker_throughputs_, worker_throughputs_without_outliers,
                   kAutoScalerOutlierSigmas);
@@ -121,15 +123,76 @@ std::optional<int64_t> AutoScaler::GetOptimalNumberOfWorkers() const
       std::accumulate(worker_throughputs_without_outliers.begin(),
                       worker_throughputs_without_outliers.end(), 0.0);
 
-  double average_worker_throughput =
-      worker_throughputs_sum_ / static_cast<double>(worker_throughputs_.size());
+  return worker_throughputs_sum_ /
+         static_cast<double>(worker_throughputs_.size());
+}
+
+void AutoScaler::UpdateForecast() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  absl::Time now = absl::FromUnixMicros(env_->NowMicros());
+  double consumption_rates_sum = GetConsumptionRatesSum();
+  if (!last_forecast_update_time_.has_value()) {
+    forecast_level_ = consumption_rates_sum;
+    forecast_trend_ = 0.0;
+    last_forecast_update_time_ = now;
+    return;
+  }
+
+  // Reports arrive at irregular intervals, so the smoothing factors decay with
+  // the time since the last update rather than with the number of updates.
+  // Reports at the same instant are picked up by the next update, since the
+  // sum of consumption rates is recomputed from scratch.
+  double elapsed_seconds =
+      absl::ToDoubleSeconds(now - *last_forecast_update_time_);
+  if (elapsed_seconds <= 0.0) return;
+  double level_alpha =
+      1.0 - std::exp(-elapsed_seconds /
+                     absl::ToDoubleSeconds(kForecastLevelTimeConstant));
+  double trend_beta =
+      1.0 - std::exp(-elapsed_seconds /
+                     absl::ToDoubleSeconds(kForecastTrendTimeConstant));
+
+  double predicted_level = forecast_level_ + forecast_trend_ * elapsed_seconds;
+  double level =
+      predicted_level + level_alpha * (consumption_rates_sum - predicted_level);
+  double observed_trend = (level - forecast_level_) / elapsed_seconds;
+  forecast_trend_ += trend_beta * (observed_trend - forecast_trend_);
+  forecast_level_ = level;
+  last_forecast_update_time_ = now;
+}
+
+std::optional<int64_t> AutoScaler::GetOptimalNumberOfWorkers() const
+    TF_LOCKS_EXCLUDED(mu_) {
+  tsl::mutex_lock l(mu_);
+
+  if (worker_throughputs_.empty() || consumption_rates_.empty())
+    return std::nullopt;
 
   int64_t optimal_number_of_workers =
-      ceil(consumption_rates_sum_ / average_worker_throughput);
+      ceil(GetConsumptionRatesSum() / GetAverageWorkerThroughput());
 
   return std::max(int64_t{1}, optimal_number_of_workers);
 }
 
+std::optional<int64_t> AutoScaler::GetForecastNumberOfWorkers(
+    absl::Duration horizon) const TF_LOCKS_EXCLUDED(mu_) {
+  tsl::mutex_lock l(mu_);
+
+  if (worker_throughputs_.empty() || consumption_rates_.empty() ||
+      !last_forecast_update_time_.has_value())
+    return std::nullopt;
+
+  absl::Time now = absl::FromUnixMicros(env_->NowMicros());
+  double forecast_seconds = absl::ToDoubleSeconds(
+      std::max(now - *last_forecast_update_time_, absl::ZeroDuration()) +
+      std::max(horizon, absl::ZeroDuration()));
+  double forecast_consumption_rates_sum =
+      std::max(0.0, forecast_level_ + forecast_trend_ * forecast_seconds);
+  int64_t forecast_number_of_workers =
+      ceil(forecast_consumption_rates_sum / GetAverageWorkerThroughput());
+
+  return std::max(int64_t{1}, forecast_number_of_workers);
+}
+
 tsl::Status AutoScaler::ReportProcessingTime(const std::string& worker_address,
                                              absl::Duration processing_time)
     TF_LOCKS_EXCLUDED(mu_) {
@@ -159,6 +222,7 @@ tsl::Status AutoScaler::ReportTargetProcessingTime(
   double consumption_rate = 1.0 / absl::ToDoubleSeconds(target_processing_time);
   tsl::mutex_lock l(mu_);
   consumption_rates_[consumer_id] = consumption_rate;
+  UpdateForecast();
 
   return tsl::OkStatus();
 }
@@ -183,14 +247,33 @@ tsl::Status AutoScaler::RemoveConsumer(int64_t consumer_id)
         absl::StrCat("Consumer with ID ", consumer_id, " not found"));
 
   consumption_rates_.erase(consumer_id);
+  UpdateForecast();
 
   return tsl::OkStatus();
 }
 
+namespace {
+
+// Limits `number_of_workers` to wait for target processing times to converge
+// to a feasible value. First, start increasing exponentially by 4x. Once
+// increases are greater than 500, scale linearly.
+int64_t BoundNumberOfWorkers(int64_t number_of_workers,
+                             int64_t current_number_of_workers) {
+  if (number_of_workers > current_number_of_workers * 4 ||
+      number_of_workers > current_number_of_workers + 500) {
+    number_of_workers = std::min(current_number_of_workers * 4,
+                                 current_number_of_workers + 500);
+  }
+  // Limit the estimate to at most 100k workers.
+  return std::min(number_of_workers, int64_t{100000});
+}
+
+}  // namespace
+
 void MultipleIterationsAutoScaler::EnsureIterationIsRegistered(
     int64_t iteration_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   if (!auto_scalers_.contains(iteration_id)) {
-    auto_scalers_[iteration_id] = std::make_unique<AutoScaler>();
+    auto_scalers_[iteration_id] = std::make_unique<AutoScaler>(env_);
   }
 }
 
@@ -220,25 +303,22 @@ tsl::Status MultipleIterationsAutoScaler::UpdateOptimalNumberOfWorkersMetric(
 
   VLOG(3) << "Estimated optimal number of workers: "
           << optimal_number_of_workers.value();
-
-  // Limit the estimate to wait for target processing times to converge to a
-  // feasible value. First, start increasing exponentially by 4x. Once
-  // increases are greater than 500, scale linearly.
-  int64_t bound_optimal_number_of_workers = optimal_number_of_workers.value();
-  if (bound_optimal_number_of_workers > current_number_of_workers * 4 ||
-      bound_optimal_number_of_workers > current_number_of_workers + 500) {
-    bound_optimal_number_of_workers = std::min(current_number_of_workers * 4,
-                                               current_number_of_workers + 500);
-  }
-  // Limit the estimate to at most 100k workers.
-  bound_optimal_number_of_workers =
-      std::min(bound_optimal_number_of_workers, int64_t{100000});
+  int64_t bound_optimal_number_of_workers = BoundNumberOfWorkers(
+      optimal_number_of_workers.value(), current_number_of_workers);
   VLOG(3) << "Bound optimal number of workers: "
           << bound_optimal_number_of_workers;
-
   metrics::RecordTFDataServiceOptimalNumberOfWorkers(
       bound_optimal_number_of_workers);
 
+  std::optional<int64_t> forecast_number_of_workers =
+      GetForecastNumberOfWorkers(kDefaultAutoScalerForecastHorizon);
+  if (forecast_number_of_workers.has_value()) {
+    VLOG(3) << "Forecast number of workers: "
+            << forecast_number_of_workers.value();
+    metrics::RecordTFDataServiceForecastNumberOfWorkers(BoundNumberOfWorkers(
+        forecast_number_of_workers.value(), current_number_of_workers));
+  }
+
   return tsl::OkStatus();
 }
 
@@ -263,6 +343,20 @@ std::optional<int64_t> MultipleIterationsAutoScaler::GetOptimalNumberOfWorkers()
     return optimal_number_of_workers;
 }
 
+std::optional<int64_t> MultipleIterationsAutoScaler::GetForecastNumberOfWorkers(
+    absl::Duration horizon) const TF_LOCKS_EXCLUDED(mu_) {
+  std::optional<int64_t> forecast_number_of_workers;
+  tsl::tf_shared_lock l(mu_);
+  for (const auto& [iteration_id, auto_scaler] : auto_scalers_) {
+    std::optional<int64_t> iteration_forecast =
+        auto_scaler->GetForecastNumberOfWorkers(horizon);
+    if (!iteration_forecast.has_value()) continue;
+    forecast_number_of_workers =
+        std::max(forecast_number_of_workers.value_or(0), *iteration_forecast);
+  }
+  return forecast_number_of_workers;
+}
+
 tsl::Status MultipleIterationsAutoScaler::ReportProcessingTime(
     int64_t iteration_id, const std::string& worker_address,
     absl::Duration processing_time) TF_LOCKS_EXCLUDED(mu_) {
@@ -23,6 +23,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/time/time.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/mutex.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/thread_annotations.h"
@@ -30,6 +31,11 @@ limitations under the License.
 namespace tensorflow {
 namespace data {
 
+// How far ahead `MultipleIterationsAutoScaler` forecasts the number of workers
+// for the /tensorflow/data/service/forecast_number_of_workers metric.
+inline constexpr absl::Duration kDefaultAutoScalerForecastHorizon =
+    absl::Minutes(5);
+
 // Estimates the optimal number of tf.data service workers for an Iteration
 // based on the current workload.
 // Note: It is assumed that all reported times correspond to the same Iteration.
@@ -63,16 +69,29 @@ namespace data {
 // follows:
 //  N = (Sum of CRs reported by all consumers) /
 //      (Average of WTs reported by all workers)
+// 3. It also forecasts the sum of CRs with double exponential smoothing (an
+// EWMA of the sum plus an EWMA of its trend), updated whenever a consumer
+// reports or is removed. Extrapolating the trend lets external autoscalers
+// provision workers before a rising workload starves the consumers, instead of
+// waiting for the reactive estimate to catch up.
 //
 // AutoScaler is thread-safe.
 class AutoScaler {
  public:
-  AutoScaler() = default;
+  AutoScaler() : AutoScaler(tsl::Env::Default()) {}
+  // Uses the clock of `env` to time the reports. Does not take ownership of
+  // `env`, which must outlive *this.
+  explicit AutoScaler(tsl::Env* env) : env_(env) {}
   // Returns the estimated optimal number of workers according to the current
   // observed workload. If there are no previously reported processing and
   // target processing times, returns nullopt.
   std::optional<int64_t> GetOptimalNumberOfWorkers() const
       TF_LOCKS_EXCLUDED(mu_);
+  // Returns the number of workers needed to keep up with the forecast sum of
+  // consumption rates `horizon` from now. If there are no previously reported
+  // processing and target processing times, returns nullopt.
+  std::optional<int64_t> GetForecastNumberOfWorkers(
+      absl::Duration horizon) const TF_LOCKS_EXCLUDED(mu_);
   // Reports the latest observed processing time from the worker with
   // `worker_address`. Returns an error if `processing_time` is ZeroDuration or
   // negative.
@@ -96,17 +115,35 @@ class AutoScaler {
   tsl::Status RemoveConsumer(int64_t consumer_id) TF_LOCKS_EXCLUDED(mu_);
 
  private:
+  // Returns the sum of the reported consumption rates, with outliers replaced.
+  double GetConsumptionRatesSum() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns the average of the reported worker throughputs, with outliers
+  // replaced.
+  double GetAverageWorkerThroughput() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Smooths the current sum of consumption rates into the forecast.
+  void UpdateForecast() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  tsl::Env* const env_;
   mutable tsl::mutex mu_;
   // Map from worker address to worker throughput.
   absl::flat_hash_map<std::string, double> worker_throughputs_
       TF_GUARDED_BY(mu_);
   // Map from consumer id to consumption rate.
   absl::flat_hash_map<int64_t, double> consumption_rates_ TF_GUARDED_BY(mu_);
+  // Smoothed sum of consumption rates, in elements per second.
+  double forecast_level_ TF_GUARDED_BY(mu_) = 0.0;
+  // Smoothed rate of change of `forecast_level_`, in elements per second per
+  // second.
+  double forecast_trend_ TF_GUARDED_BY(mu_) = 0.0;
+  // Time of the last forecast update, or nullopt if there has been none.
+  std::optional<absl::Time> last_forecast_update_time_ TF_GUARDED_BY(mu_);
 };
 
 // Exports a metric (/tensorflow/data/service/optimal_number_of_workers) with
 // the estimated optimal number of tf.data service workers, according to
-// the observed cluster workload.
+// the observed cluster workload, and a metric
+// (/tensorflow/data/service/forecast_number_of_workers) with the number of
+// workers forecast to be needed `kDefaultAutoScalerForecastHorizon` from now.
 //
 // It estimates the number of workers as the maximum of the estimated optimal
 // number of workers for all Iterations running in the tf.data service cluster.
@@ -114,16 +151,20 @@ class AutoScaler {
 // MultipleIterationsAutoScaler is thread-safe.
 class MultipleIterationsAutoScaler {
  public:
-  MultipleIterationsAutoScaler() = default;
+  MultipleIterationsAutoScaler()
+      : MultipleIterationsAutoScaler(tsl::Env::Default()) {}
+  // Uses the clock of `env` to time the reports. Does not take ownership of
+  // `env`, which must outlive *this.
+  explicit MultipleIterationsAutoScaler(tsl::Env* env) : env_(env) {}
   // Unregisters iteration with `iteration_id`, removing its reported
   // times from consideration of the current workload estimation.
   // Returns an error if the specified iteration does not exist.
   tsl::Status UnregisterIteration(int64_t iteration_id) TF_LOCKS_EXCLUDED(mu_);
-  // Updates the metric value with the current estimated optimal number of
-  // workers. The estimate is limited to min(4 * `current_number_of_workers`,
-  // `current_number_of_workers` + 500). Returns an error if there are no
-  // previously reported processing and target processing times for at least one
-  // iteration, or `current_number_of_workers` is not positive.
+  // Updates the metric values with the current estimated optimal number of
+  // workers and the forecast number of workers. The estimates are limited to
+  // min(4 * `current_number_of_workers`, `current_number_of_workers` + 500).
+  // Returns an error if there are no previously reported processing and target
+  // processing times for at least one iteration, or `current_number_of_workers` is not positive.
   tsl::Status UpdateOptimalNumberOfWorkersMetric(
       int64_t current_number_of_workers) TF_LOCKS_EXCLUDED(mu_);
   // Returns the estimated optimal number of workers according to the current
@@ -131,6 +172,12 @@ class MultipleIterationsAutoScaler {
   // target processing times for at least one iteration, returns nullopt.
   std::optional<int64_t> GetOptimalNumberOfWorkers() const
       TF_LOCKS_EXCLUDED(mu_);
+  // Returns the maximum over all iterations of the number of workers forecast
+  // to be needed `horizon` from now. If there are no previously reported
+  // processing and target processing times for at least one iteration, returns
+  // nullopt.
+  std::optional<int64_t> GetForecastNumberOfWorkers(
+      absl::Duration horizon) const TF_LOCKS_EXCLUDED(mu_);
   // Reports the latest observed processing time from the worker with
   // `worker_address` for iteration with `iteration_id`. Returns an error if
   // `processing_time` is ZeroDuration or negative.
@@ -167,6 +214,7 @@ class MultipleIterationsAutoScaler {
   // workload estimation.
   void EnsureIterationIsRegistered(int64_t iteration_id)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  tsl::Env* const env_;
   mutable tsl::mutex mu_;
   // Map from iteration id to AutoScaler.
   absl::flat_hash_map<int64_t, std::unique_ptr<AutoScaler>> auto_scalers_
@@ -15,11 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/data/service/auto_scaler.h"
 
+#include <cstdint>
 #include <optional>
 
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/util/fake_clock_env.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/status_matchers.h"
 
@@ -29,6 +31,16 @@ namespace {
 
 using ::tsl::testing::StatusIs;
 
+// Reports a consumption rate of `consumption_rate` elements per second from
+// consumer 0, then advances the clock of `env` by 10 seconds.
+tsl::Status ReportConsumptionRate(AutoScaler& auto_scaler, FakeClockEnv& env,
+                                  int64_t consumption_rate) {
+  tsl::Status status = auto_scaler.ReportTargetProcessingTime(
+      0, absl::Seconds(1.0 / consumption_rate));
+  env.AdvanceByMicroseconds(absl::ToInt64Microseconds(absl::Seconds(10)));
+  return status;
+}
+
 TEST(AutoScalerTest, GetOptimalNumberOfWorkersInitialState) {
   AutoScaler auto_scaler;
   EXPECT_EQ(auto_scaler.GetOptimalNumberOfWorkers(), std::nullopt);
@@ -308,6 +320,57 @@ TEST(AutoScalerTest, RemoveConsumerAfterNewTPTReported) {
   TF_ASSERT_OK(auto_scaler.RemoveConsumer(0));
 }
 
+TEST(AutoScalerTest, GetForecastNumberOfWorkersInitialState) {
+  AutoScaler auto_scaler;
+  EXPECT_EQ(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(5)),
+            std::nullopt);
+  TF_ASSERT_OK(auto_scaler.ReportProcessingTime("/worker/task/0:20000",
+                                                absl::Seconds(1)));
+  EXPECT_EQ(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(5)),
+            std::nullopt);
+}
+
+TEST(AutoScalerTest, GetForecastNumberOfWorkersSteadyWorkload) {
+  FakeClockEnv env(Env::Default());
+  AutoScaler auto_scaler(&env);
+  TF_ASSERT_OK(auto_scaler.ReportProcessingTime("/worker/task/0:20000",
+                                                absl::Seconds(1)));
+  for (int i = 0; i < 30; ++i) {
+    TF_ASSERT_OK(ReportConsumptionRate(auto_scaler, env, 8));
+  }
+  EXPECT_EQ(auto_scaler.GetOptimalNumberOfWorkers(), 8);
+  EXPECT_EQ(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(5)), 8);
+}
+
+TEST(AutoScalerTest, GetForecastNumberOfWorkersRisingWorkload) {
+  FakeClockEnv env(Env::Default());
+  AutoScaler auto_scaler(&env);
+  TF_ASSERT_OK(auto_scaler.ReportProcessingTime("/worker/task/0:20000",
+                                                absl::Seconds(1)));
+  for (int64_t consumption_rate = 1; consumption_rate <= 30;
+       ++consumption_rate) {
+    TF_ASSERT_OK(ReportConsumptionRate(auto_scaler, env, consumption_rate));
+  }
+  EXPECT_EQ(auto_scaler.GetOptimalNumberOfWorkers(), 30);
+  // The forecast anticipates that the consumption rate keeps rising.
+  EXPECT_GT(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(5)), 30);
+  EXPECT_GT(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(10)),
+            auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(5)));
+}
+
+TEST(AutoScalerTest, GetForecastNumberOfWorkersFallingWorkload) {
+  FakeClockEnv env(Env::Default());
+  AutoScaler auto_scaler(&env);
+  TF_ASSERT_OK(auto_scaler.ReportProcessingTime("/worker/task/0:20000",
+                                                absl::Seconds(1)));
+  for (int64_t consumption_rate = 30; consumption_rate >= 1;
+       --consumption_rate) {
+    TF_ASSERT_OK(ReportConsumptionRate(auto_scaler, env, consumption_rate));
+  }
+  EXPECT_EQ(auto_scaler.GetOptimalNumberOfWorkers(), 1);
+  EXPECT_EQ(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(10)), 1);
+}
+
 TEST(MultipleIterationsAutoScalerTest, UnregisterExistingIteration) {
   MultipleIterationsAutoScaler auto_scaler;
   TF_ASSERT_OK(
@@ -380,6 +443,32 @@ TEST(MultipleIterationsAutoScalerTest,
   metrics::RecordTFDataServiceOptimalNumberOfWorkers(0);
 }
 
+TEST(MultipleIterationsAutoScalerTest,
+     UpdateOptimalNumberOfWorkersMetricRecordsForecast) {
+  FakeClockEnv env(Env::Default());
+  MultipleIterationsAutoScaler auto_scaler(&env);
+  TF_ASSERT_OK(auto_scaler.ReportProcessingTime(0, "/worker/task/0:20000",
+                                                absl::Seconds(1)));
+  for (int64_t consumption_rate = 1; consumption_rate <= 30;
+       ++consumption_rate) {
+    TF_ASSERT_OK(auto_scaler.ReportTargetProcessingTime(
+        0, 0, absl::Seconds(1.0 / consumption_rate)));
+    env.AdvanceByMicroseconds(absl::ToInt64Microseconds(absl::Seconds(10)));
+  }
+  EXPECT_GT(auto_scaler.GetForecastNumberOfWorkers(absl::Minutes(5)),
+            auto_scaler.GetOptimalNumberOfWorkers());
+
+  TF_ASSERT_OK(auto_scaler.UpdateOptimalNumberOfWorkersMetric(30));
+  monitoring::testing::CellReader<int64_t> optimal_cell_reader(
+      "/tensorflow/data/service/optimal_number_of_workers");
+  monitoring::testing::CellReader<int64_t> forecast_cell_reader(
+      "/tensorflow/data/service/forecast_number_of_workers");
+  EXPECT_EQ(optimal_cell_reader.Read(), 30);
+  EXPECT_GT(forecast_cell_reader.Read(), 30);
+  metrics::RecordTFDataServiceOptimalNumberOfWorkers(0);
+  metrics::RecordTFDataServiceForecastNumberOfWorkers(0);
+}
+
 TEST(MultipleIterationsAutoScalerTest,
      UpdateOptimalNumberOfWorkersMetricIncreaseWithinLimit) {
   MultipleIterationsAutoScaler auto_scaler;
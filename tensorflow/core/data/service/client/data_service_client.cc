@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/client/data_service_client.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -42,8 +43,12 @@ limitations under the License.
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -59,6 +64,28 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+// The maximum number of bytes of elements fetched by a batched GetElements
+// request.
+constexpr int64_t kMaxGetElementsBytes = 16 << 20;  // 16MB
+
+// Returns the number of bytes of `element` transferred from the worker, which
+// is the compressed size for compressed elements.
+int64_t ReceivedBytes(const std::vector<Tensor>& element) {
+  int64_t bytes = 0;
+  for (const Tensor& component : element) {
+    if (component.dtype() == DT_VARIANT && component.NumElements() == 1) {
+      const CompressedElement* compressed =
+          component.unaligned_flat<Variant>()(0).get<CompressedElement>();
+      if (compressed != nullptr) {
+        bytes += compressed->data().size();
+        continue;
+      }
+    }
+    bytes += component.TotalBytes();
+  }
+  return bytes;
+}
+
 bool IsColocatedTask(const TaskInfo& task) {
   return absl::c_any_of(task.worker_tags(), [](std::string_view worker_tag) {
     return absl::AsciiStrToUpper(worker_tag) == kColocatedWorkerTag;
@@ -442,6 +469,13 @@ void DataServiceClient::Heartbeat() TF_LOCKS_EXCLUDED(mu_) {
     mutex_lock l(mu_);
     double target_processing_time_nsec = ctx_->GetTargetProcessingTimeNsec();
     req.set_target_processing_time_nsec(target_processing_time_nsec);
+    const int64_t now_micros = Env::Default()->NowMicros();
+    if (last_heartbeat_micros_ > 0 && now_micros > last_heartbeat_micros_) {
+      req.set_received_bytes_per_sec(received_bytes_since_heartbeat_ * 1e6 /
+                                     (now_micros - last_heartbeat_micros_));
+    }
+    received_bytes_since_heartbeat_ = 0;
+    last_heartbeat_micros_ = now_micros;
   }
   ClientHeartbeatResponse resp;
   Status s = dispatcher_->ClientHeartbeat(req, resp);
@@ -718,8 +752,23 @@ void DataServiceClient::AdvanceTaskIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   }
 }
 
-Status DataServiceClient::TryGetElement(const Task& task,
-                                        GetElementResult& result) {
+int64_t DataServiceClient::MaxElementsPerRequest() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (IsCoordinatedRead()) {
+    return 1;
+  }
+  // Each outstanding request already holds one buffer slot. The free slots are
+  // shared among the outstanding requests.
+  const int64_t free_slots = max_outstanding_requests_ -
+                             static_cast<int64_t>(results_.size()) -
+                             outstanding_requests_;
+  return 1 + std::max<int64_t>(free_slots, 0) /
+                 std::max<int64_t>(outstanding_requests_, 1);
+}
+
+Status DataServiceClient::TryGetElements(
+    const Task& task, int64_t max_elements,
+    std::vector<GetElementResult>& results) {
   GetElementRequest req;
   req.set_task_id(task.info.task_id());
   req.set_skipped_previous_round(task.skipped_previous_round);
@@ -731,7 +780,12 @@ Status DataServiceClient::TryGetElement(const Task& task,
   if (params_.cross_trainer_cache_options) {
     req.set_trainer_id(params_.cross_trainer_cache_options->trainer_id());
   }
-  return task.worker->GetElement(req, result);
+  if (max_elements <= 1) {
+    results.emplace_back();
+    return task.worker->GetElement(req, results.back());
+  }
+  return task.worker->GetElements(req, max_elements, kMaxGetElementsBytes,
+                                  results);
 }
 
 void DataServiceClient::ProcessGetElementResponse(
@@ -743,6 +797,8 @@ void DataServiceClient::ProcessGetElementResponse(
   result->skip = get_element_result.skip;
   if (!get_element_result.end_of_sequence && !get_element_result.skip) {
     task.skipped_previous_round = false;
+    received_bytes_since_heartbeat_ +=
+        ReceivedBytes(get_element_result.components);
     result->element = std::move(get_element_result.components);
     result->element_index = get_element_result.element_index;
     result->task_id = task.info.task_id();
@@ -818,9 +874,15 @@ Status DataServiceClient::GetElement(Task* task, int64_t deadline_micros,
                                      bool enqueue_result,
                                      std::shared_ptr<Result> result)
     TF_LOCKS_EXCLUDED(mu_) {
-  GetElementResult get_element_result;
+  int64_t max_elements;
+  {
+    mutex_lock l(mu_);
+    max_elements = MaxElementsPerRequest();
+  }
+  std::vector<GetElementResult> get_element_results;
   while (true) {
-    Status s = TryGetElement(*task, get_element_result);
+    get_element_results.clear();
+    Status s = TryGetElements(*task, max_elements, get_element_results);
     if (s.ok()) {
       task->num_retries = 0;
       break;
@@ -876,7 +938,14 @@ Status DataServiceClient::GetElement(Task* task, int64_t deadline_micros,
       return OkStatus();
     }
   }
-  ProcessGetElementResponse(enqueue_result, get_element_result, result, *task);
+  ProcessGetElementResponse(enqueue_result, get_element_results[0], result,
+                            *task);
+  // Batched elements beyond the first are only fetched for uncoordinated
+  // reads, which enqueue their results.
+  for (size_t i = 1; i < get_element_results.size(); ++i) {
+    ProcessGetElementResponse(enqueue_result, get_element_results[i],
+                              std::make_shared<Result>(), *task);
+  }
   return OkStatus();
 }
 
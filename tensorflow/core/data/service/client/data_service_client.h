@@ -174,7 +174,11 @@ class DataServiceClient {
   // task a chance to proceed.
   std::shared_ptr<Task> GetTaskToProcess();
   void AdvanceTaskIndex();
-  Status TryGetElement(const Task& task, GetElementResult& result);
+  // Returns how many elements a request may fetch without buffering more than
+  // `max_outstanding_requests_` elements.
+  int64_t MaxElementsPerRequest() const;
+  Status TryGetElements(const Task& task, int64_t max_elements,
+                        std::vector<GetElementResult>& results);
   void ProcessGetElementResponse(bool enqueue_result,
                                  GetElementResult& get_element_result,
                                  std::shared_ptr<Result> result, Task& task);
@@ -250,6 +254,11 @@ class DataServiceClient {
   bool iteration_finished_ TF_GUARDED_BY(mu_) = false;
   bool should_finish_iteration_ TF_GUARDED_BY(mu_) = true;
 
+  // Bytes received from workers since the last heartbeat, and the time of the
+  // last heartbeat, used to report the receive throughput to the dispatcher.
+  int64_t received_bytes_since_heartbeat_ TF_GUARDED_BY(mu_) = 0;
+  int64_t last_heartbeat_micros_ TF_GUARDED_BY(mu_) = 0;
+
   // The set of worker UIDs that we have already recorded metrics for.
   absl::flat_hash_set<int64_t> worker_uids_ TF_GUARDED_BY(mu_);
 
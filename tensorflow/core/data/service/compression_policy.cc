@@ -0,0 +1,97 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/compression_policy.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/mutex.h"
+#include "tsl/platform/status.h"
+
+namespace tensorflow {
+namespace data {
+
+std::string CompressionPolicy::GetCodec(int64_t job_id) const {
+  tsl::tf_shared_lock l(mu_);
+  if (worker_cpu_utilizations_.empty()) {
+    return kSnappyCodec;
+  }
+  double total_cpu_utilization = 0.0;
+  for (const auto& [worker_address, cpu_utilization] :
+       worker_cpu_utilizations_) {
+    total_cpu_utilization += cpu_utilization;
+  }
+  const double cpu_utilization =
+      total_cpu_utilization / worker_cpu_utilizations_.size();
+  if (cpu_utilization > options_.high_cpu_utilization) {
+    return kNoCodec;
+  }
+
+  double total_bytes_per_sec = 0.0;
+  int64_t num_clients = 0;
+  for (const auto& [client_id, throughput] : client_throughputs_) {
+    if (throughput.job_id == job_id) {
+      total_bytes_per_sec += throughput.bytes_per_sec;
+      ++num_clients;
+    }
+  }
+  if (num_clients > 0 && cpu_utilization < options_.low_cpu_utilization &&
+      total_bytes_per_sec / num_clients <
+          options_.low_throughput_bytes_per_sec) {
+    return kZstdCodec;
+  }
+  return kSnappyCodec;
+}
+
+tsl::Status CompressionPolicy::ReportWorkerCpuUtilization(
+    const std::string& worker_address, double cpu_utilization) {
+  if (cpu_utilization < 0) {
+    return tsl::errors::InvalidArgument(absl::StrCat(
+        "Cannot update CPU utilization with negative value ", cpu_utilization,
+        " for worker ", worker_address));
+  }
+  tsl::mutex_lock l(mu_);
+  worker_cpu_utilizations_[worker_address] = cpu_utilization;
+  return tsl::OkStatus();
+}
+
+tsl::Status CompressionPolicy::ReportClientThroughput(int64_t job_id,
+                                                      int64_t client_id,
+                                                      double bytes_per_sec) {
+  if (bytes_per_sec < 0) {
+    return tsl::errors::InvalidArgument(absl::StrCat(
+        "Cannot update throughput with negative value ", bytes_per_sec,
+        " for client ", client_id));
+  }
+  tsl::mutex_lock l(mu_);
+  client_throughputs_[client_id] = {job_id, bytes_per_sec};
+  return tsl::OkStatus();
+}
+
+void CompressionPolicy::RemoveWorker(const std::string& worker_address) {
+  tsl::mutex_lock l(mu_);
+  worker_cpu_utilizations_.erase(worker_address);
+}
+
+void CompressionPolicy::RemoveClient(int64_t client_id) {
+  tsl::mutex_lock l(mu_);
+  client_throughputs_.erase(client_id);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,97 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_COMPRESSION_POLICY_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_COMPRESSION_POLICY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tsl/platform/mutex.h"
+#include "tsl/platform/status.h"
+#include "tsl/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Chooses the codec used to compress the elements of each job, trading worker
+// CPU time against network bandwidth:
+//
+// * If the workers are CPU-saturated, compression slows down the input
+//   pipelines, so elements are sent uncompressed ("none").
+// * If the workers have spare CPU and the job's clients receive data slowly,
+//   the network is the bottleneck, so elements are compressed with "zstd",
+//   which compresses better than snappy at a higher CPU cost.
+// * Otherwise, and until enough has been reported to decide, elements are
+//   compressed with "snappy".
+//
+// CPU utilization is the fraction of a worker's cores used by the worker
+// process, averaged over all workers. Client throughput is the number of bytes
+// per second received by a client, averaged over the clients of a job.
+//
+// CompressionPolicy is thread-safe.
+class CompressionPolicy {
+ public:
+  struct Options {
+    // Workers whose average CPU utilization is above this are CPU-saturated.
+    double high_cpu_utilization = 0.9;
+    // Workers whose average CPU utilization is below this have spare CPU.
+    double low_cpu_utilization = 0.5;
+    // Clients receiving fewer bytes per second than this are network-bound.
+    double low_throughput_bytes_per_sec = 100.0 * 1024 * 1024;
+  };
+
+  CompressionPolicy() : CompressionPolicy(Options()) {}
+  explicit CompressionPolicy(const Options& options) : options_(options) {}
+
+  // Returns the codec to use for new tasks of the job with `job_id`.
+  std::string GetCodec(int64_t job_id) const TF_LOCKS_EXCLUDED(mu_);
+
+  // Reports the latest CPU utilization of the worker with `worker_address`.
+  // Returns an error if `cpu_utilization` is negative.
+  tsl::Status ReportWorkerCpuUtilization(const std::string& worker_address,
+                                         double cpu_utilization)
+      TF_LOCKS_EXCLUDED(mu_);
+  // Reports the latest receive throughput of the client identified by
+  // `client_id`, which reads from the job with `job_id`. Returns an error if
+  // `bytes_per_sec` is negative.
+  tsl::Status ReportClientThroughput(int64_t job_id, int64_t client_id,
+                                     double bytes_per_sec)
+      TF_LOCKS_EXCLUDED(mu_);
+  // Removes the worker with `worker_address` from consideration.
+  void RemoveWorker(const std::string& worker_address) TF_LOCKS_EXCLUDED(mu_);
+  // Removes the client identified by `client_id` from consideration.
+  void RemoveClient(int64_t client_id) TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct ClientThroughput {
+    int64_t job_id;
+    double bytes_per_sec;
+  };
+
+  const Options options_;
+  mutable tsl::mutex mu_;
+  // Map from worker address to CPU utilization.
+  absl::flat_hash_map<std::string, double> worker_cpu_utilizations_
+      TF_GUARDED_BY(mu_);
+  // Map from client id to receive throughput.
+  absl::flat_hash_map<int64_t, ClientThroughput> client_throughputs_
+      TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_COMPRESSION_POLICY_H_
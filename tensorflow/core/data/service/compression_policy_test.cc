@@ -0,0 +1,97 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/compression_policy.h"
+
+#include "absl/status/status.h"
+#include "tensorflow/core/platform/test.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/status_matchers.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+constexpr double kMegabyte = 1024 * 1024;
+
+TEST(CompressionPolicyTest, SnappyByDefault) {
+  CompressionPolicy policy;
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "snappy");
+}
+
+TEST(CompressionPolicyTest, NoCompressionWhenCpuSaturated) {
+  CompressionPolicy policy;
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/0:20000", 0.95));
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/1:20000", 1.0));
+  TF_ASSERT_OK(policy.ReportClientThroughput(/*job_id=*/0, /*client_id=*/0,
+                                             /*bytes_per_sec=*/kMegabyte));
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "none");
+}
+
+TEST(CompressionPolicyTest, ZstdWhenNetworkBound) {
+  CompressionPolicy policy;
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/0:20000", 0.2));
+  TF_ASSERT_OK(policy.ReportClientThroughput(/*job_id=*/0, /*client_id=*/0,
+                                             /*bytes_per_sec=*/kMegabyte));
+  TF_ASSERT_OK(policy.ReportClientThroughput(/*job_id=*/1, /*client_id=*/1,
+                                             /*bytes_per_sec=*/1e4 * kMegabyte));
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "zstd");
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/1), "snappy");
+  // Jobs without reported throughput keep the default codec.
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/2), "snappy");
+}
+
+TEST(CompressionPolicyTest, SnappyWhenCpuModeratelyBusy) {
+  CompressionPolicy policy;
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/0:20000", 0.7));
+  TF_ASSERT_OK(policy.ReportClientThroughput(/*job_id=*/0, /*client_id=*/0,
+                                             /*bytes_per_sec=*/kMegabyte));
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "snappy");
+}
+
+TEST(CompressionPolicyTest, CustomThresholds) {
+  CompressionPolicy::Options options;
+  options.high_cpu_utilization = 0.5;
+  CompressionPolicy policy(options);
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/0:20000", 0.7));
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "none");
+}
+
+TEST(CompressionPolicyTest, RemoveWorkerAndClient) {
+  CompressionPolicy policy;
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/0:20000", 0.1));
+  TF_ASSERT_OK(policy.ReportWorkerCpuUtilization("/worker/task/1:20000", 1.0));
+  TF_ASSERT_OK(policy.ReportClientThroughput(/*job_id=*/0, /*client_id=*/0,
+                                             /*bytes_per_sec=*/kMegabyte));
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "snappy");
+  policy.RemoveWorker("/worker/task/1:20000");
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "zstd");
+  policy.RemoveClient(/*client_id=*/0);
+  EXPECT_EQ(policy.GetCodec(/*job_id=*/0), "snappy");
+}
+
+TEST(CompressionPolicyTest, InvalidReports) {
+  CompressionPolicy policy;
+  EXPECT_THAT(policy.ReportWorkerCpuUtilization("/worker/task/0:20000", -1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(policy.ReportClientThroughput(/*job_id=*/0, /*client_id=*/0,
+                                            /*bytes_per_sec=*/-1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
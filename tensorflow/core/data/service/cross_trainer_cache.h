@@ -15,11 +15,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <deque>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -46,6 +48,13 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// Optionally, elements evicted from the in-memory window can be kept in a
+// compressed tier with its own memory budget, so that trainers lagging behind
+// the window can still read them instead of skipping data. The compressed tier
+// only keeps elements that some trainer has not read yet, so its footprint
+// follows the spread between the slowest and fastest trainers. It requires
+// the `CachableSequence` to implement `Compress` and `Uncompress`.
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -89,6 +98,19 @@ class CachableSequence {
 
   // Returns the estimated size of the element in bytes.
   virtual size_t GetElementSizeBytes(const ElementType&) const = 0;
+
+  // Compresses an element evicted from the in-memory window into the
+  // compressed tier. Only called if the cache has a compressed tier.
+  virtual StatusOr<std::string> Compress(const ElementType&) const {
+    return errors::Unimplemented(
+        "This sequence does not support compressed cross-trainer caching.");
+  }
+
+  // Uncompresses an element produced by `Compress`.
+  virtual StatusOr<ElementType> Uncompress(const std::string&) const {
+    return errors::Unimplemented(
+        "This sequence does not support compressed cross-trainer caching.");
+  }
 };
 
 // Sliding-window cache shared across concurrent trainers.
@@ -98,9 +120,14 @@ class CrossTrainerCache {
   // Creates a `CrossTrainerCache` with `max_cache_size_bytes` of memory budget.
   // The cache should be able to hold at least one element, i.e.:
   // REQUIRES: `max_cache_size_bytes >= max(GetElementSizeBytes(*))`
+  //
+  // If `max_compressed_cache_size_bytes` is positive, evicted elements that
+  // some trainer has not read yet are compressed and kept in a compressed tier
+  // of that size.
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
-      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      size_t max_compressed_cache_size_bytes = 0);
   virtual ~CrossTrainerCache() = default;
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
@@ -142,12 +169,27 @@ class CrossTrainerCache {
   StatusOr<std::shared_ptr<const ElementType>> GetElement(
       const std::string& trainer_id);
 
+  // Returns the next element for `trainer_id` if it is in the compressed tier.
+  // The caller uncompresses it without holding `mu_`.
+  std::optional<std::string> GetCompressedElement(
+      const std::string& trainer_id);
+
+  // Returns the smallest element index that some trainer has not read.
+  size_t GetMinTrainerElementIndex() const;
+
   // Reads a new element and writes it into the cache.
   Status ExtendCache();
 
   // Frees old elements to keep the cache size below `max_cache_size_bytes_`.
   // `new_element_size_bytes` is the size of the new element being inserted.
-  void FreeSpace(size_t new_element_size_bytes);
+  // Freed elements are moved to the compressed tier if it is enabled and some
+  // trainer still needs them.
+  Status FreeSpace(size_t new_element_size_bytes);
+
+  // Adds an element evicted from `cache_` to the compressed tier, discarding
+  // compressed elements that all trainers have read or that exceed
+  // `max_compressed_cache_size_bytes_`.
+  Status AddCompressedElement(const ElementType& element);
 
   // Records the cache hit rate and cache size.
   void RecordMetrics(const CacheQueryResult& result);
@@ -155,6 +197,9 @@ class CrossTrainerCache {
   // Maximum cache size in bytes.
   const size_t max_cache_size_bytes_;
 
+  // Maximum compressed tier size in bytes. 0 disables the compressed tier.
+  const size_t max_compressed_cache_size_bytes_;
+
   // The element sequence over which the sliding window cache operates.
   std::unique_ptr<CachableSequence<ElementType>> cachable_sequence_;
 
@@ -170,12 +215,20 @@ class CrossTrainerCache {
   size_t cache_size_bytes_ TF_GUARDED_BY(mu_) = 0;
   size_t cache_start_index_ TF_GUARDED_BY(mu_) = 0;
 
+  // `compressed_cache_` stores the compressed elements evicted from `cache_`,
+  // with indices in [`compressed_cache_start_index_`, `cache_start_index_`).
+  std::deque<std::string> compressed_cache_ TF_GUARDED_BY(mu_);
+  size_t compressed_cache_size_bytes_ TF_GUARDED_BY(mu_) = 0;
+  size_t compressed_cache_start_index_ TF_GUARDED_BY(mu_) = 0;
+
   // True if one thread is extending the cache.
   bool extending_cache_ TF_GUARDED_BY(mu_) = false;
 
   // Maps trainer IDs to element indices. The indices are absolute indices
   // within the dataset. The actual index to use with `cache_` would be
-  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
+  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`, or
+  // `trainer_to_element_index_map_[trainer_id] - compressed_cache_start_index_`
+  // with `compressed_cache_` if it is before `cache_start_index_`.
   absl::flat_hash_map<std::string, size_t> trainer_to_element_index_map_
       TF_GUARDED_BY(mu_);
 };
@@ -183,13 +236,17 @@ class CrossTrainerCache {
 template <class ElementType>
 CrossTrainerCache<ElementType>::CrossTrainerCache(
     size_t max_cache_size_bytes,
-    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence)
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    size_t max_compressed_cache_size_bytes)
     : max_cache_size_bytes_(max_cache_size_bytes),
+      max_compressed_cache_size_bytes_(max_compressed_cache_size_bytes),
       cachable_sequence_(std::move(cachable_sequence)) {
   DCHECK_GT(max_cache_size_bytes, 0)
       << "CrossTrainerCache size must be greater than 0.";
   VLOG(2) << "Initialized tf.data service cross-trainer cache with "
-          << FormatBytes(max_cache_size_bytes) << " of memory.";
+          << FormatBytes(max_cache_size_bytes) << " of memory and "
+          << FormatBytes(max_compressed_cache_size_bytes)
+          << " of compressed memory.";
 }
 
 template <class ElementType>
@@ -212,10 +269,12 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
     const std::string& trainer_id) {
   bool should_extend_cache = false;
   while (true) {
+    std::optional<std::string> compressed_element;
     {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
-      if (IsElementReady(trainer_id)) {
+      compressed_element = GetCompressedElement(trainer_id);
+      if (!compressed_element.has_value() && IsElementReady(trainer_id)) {
         TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
                             GetElement(trainer_id));
         return CacheQueryResult{element,
@@ -225,7 +284,9 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       // Extends the cache or waits for another thread to extend the cache. When
       // concurrent trainers wait for the next element, only one of them should
       // extend the cache.
-      if (extending_cache_) {
+      if (compressed_element.has_value()) {
+        should_extend_cache = false;
+      } else if (extending_cache_) {
         should_extend_cache = false;
         cv_.wait(l);
       } else {
@@ -234,6 +295,16 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       }
     }
 
+    // Elements in the compressed tier are uncompressed without holding the
+    // lock, since lagging trainers should not block the others.
+    if (compressed_element.has_value()) {
+      TF_ASSIGN_OR_RETURN(ElementType element,
+                          cachable_sequence_->Uncompress(*compressed_element));
+      return CacheQueryResult{
+          std::make_shared<const ElementType>(std::move(element)),
+          /*is_cache_hit=*/true};
+    }
+
     if (should_extend_cache) {
       Status s = ExtendCache();
       mutex_lock l(mu_);
@@ -250,6 +321,27 @@ bool CrossTrainerCache<ElementType>::IsElementReady(
   return GetElementIndex(trainer_id) < cache_start_index_ + cache_.size();
 }
 
+template <class ElementType>
+std::optional<std::string> CrossTrainerCache<ElementType>::GetCompressedElement(
+    const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  size_t element_index = GetElementIndex(trainer_id);
+  if (element_index >= cache_start_index_) {
+    return std::nullopt;
+  }
+  trainer_to_element_index_map_[trainer_id] = element_index + 1;
+  return compressed_cache_[element_index - compressed_cache_start_index_];
+}
+
+template <class ElementType>
+size_t CrossTrainerCache<ElementType>::GetMinTrainerElementIndex() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  size_t min_element_index = std::numeric_limits<size_t>::max();
+  for (const auto& [unused, element_index] : trainer_to_element_index_map_) {
+    min_element_index = std::min(min_element_index, element_index);
+  }
+  return min_element_index;
+}
+
 template <class ElementType>
 StatusOr<std::shared_ptr<const ElementType>>
 CrossTrainerCache<ElementType>::GetElement(const std::string& trainer_id)
@@ -271,8 +363,8 @@ template <class ElementType>
 size_t CrossTrainerCache<ElementType>::GetElementIndex(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+  if (element_index < compressed_cache_start_index_) {
+    element_index = compressed_cache_start_index_;
   }
   return element_index;
 }
@@ -291,20 +383,21 @@ Status CrossTrainerCache<ElementType>::ExtendCache() TF_LOCKS_EXCLUDED(mu_) {
 
   mutex_lock l(mu_);
   TF_RETURN_IF_ERROR(status_);
-  FreeSpace(new_element_size_bytes);
+  TF_RETURN_IF_ERROR(FreeSpace(new_element_size_bytes));
   cache_.push_back(std::make_shared<ElementType>(std::move(element)));
   cache_size_bytes_ += new_element_size_bytes;
   return OkStatus();
 }
 
 template <class ElementType>
-void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
-    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+Status CrossTrainerCache<ElementType>::FreeSpace(
+    size_t new_element_size_bytes) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t num_elements_discarded = 0;
   while (!cache_.empty() &&
          cache_size_bytes_ + new_element_size_bytes > max_cache_size_bytes_) {
     size_t free_bytes =
         cachable_sequence_->GetElementSizeBytes(*cache_.front());
+    TF_RETURN_IF_ERROR(AddCompressedElement(*cache_.front()));
     cache_.pop_front();
     cache_size_bytes_ -= free_bytes;
     ++cache_start_index_;
@@ -314,6 +407,35 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
   VLOG(3) << "Freed " << num_elements_discarded << " element(s) from "
           << "tf.data service cross-trainer cache. Memory usage: "
           << FormatBytes(cache_size_bytes_) << ".";
+  return OkStatus();
+}
+
+template <class ElementType>
+Status CrossTrainerCache<ElementType>::AddCompressedElement(
+    const ElementType& element) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  // The evicted element has index `cache_start_index_`. If the compressed tier
+  // is disabled or all trainers have read it, it is not needed anymore.
+  const size_t min_trainer_element_index = GetMinTrainerElementIndex();
+  if (max_compressed_cache_size_bytes_ == 0 ||
+      min_trainer_element_index > cache_start_index_) {
+    compressed_cache_.clear();
+    compressed_cache_size_bytes_ = 0;
+    compressed_cache_start_index_ = cache_start_index_ + 1;
+    return OkStatus();
+  }
+
+  TF_ASSIGN_OR_RETURN(std::string compressed,
+                      cachable_sequence_->Compress(element));
+  compressed_cache_size_bytes_ += compressed.size();
+  compressed_cache_.push_back(std::move(compressed));
+  while (!compressed_cache_.empty() &&
+         (compressed_cache_start_index_ < min_trainer_element_index ||
+          compressed_cache_size_bytes_ > max_compressed_cache_size_bytes_)) {
+    compressed_cache_size_bytes_ -= compressed_cache_.front().size();
+    compressed_cache_.pop_front();
+    ++compressed_cache_start_index_;
+  }
+  return OkStatus();
 }
 
 template <class ElementType>
@@ -343,7 +465,7 @@ void CrossTrainerCache<ElementType>::RecordMetrics(
   size_t cache_size_bytes = 0;
   {
     mutex_lock l(mu_);
-    cache_size_bytes = cache_size_bytes_;
+    cache_size_bytes = cache_size_bytes_ + compressed_cache_size_bytes_;
   }
   metrics::RecordTFDataServiceCrossTrainerCacheSizeBytes(cache_size_bytes);
 }
@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -61,6 +62,21 @@ class InfiniteRange : public CachableSequence<int64_t> {
   int64_t next_ = 0;
 };
 
+// Compresses elements as their decimal representations.
+class CompressibleInfiniteRange : public InfiniteRange {
+ public:
+  StatusOr<std::string> Compress(const int64_t& element) const override {
+    return absl::StrCat(element);
+  }
+  StatusOr<int64_t> Uncompress(const std::string& compressed) const override {
+    int64_t element = 0;
+    if (!absl::SimpleAtoi(compressed, &element)) {
+      return errors::DataLoss("Invalid compressed element: ", compressed);
+    }
+    return element;
+  }
+};
+
 class TensorDataset : public CachableSequence<Tensor> {
  public:
   StatusOr<Tensor> GetNext() override { return Tensor("Test Tensor"); }
@@ -190,6 +206,58 @@ TEST(CrossTrainerCacheTest, SlowTrainersSkipData) {
   EXPECT_THAT(cache.Get("Slow trainer 2"), IsOkAndHolds(Pointee(Gt(94))));
 }
 
+TEST(CrossTrainerCacheTest, SlowTrainersReadCompressedElements) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<CompressibleInfiniteRange>(),
+      /*max_compressed_cache_size_bytes=*/1024);
+  EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(0)));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 1; i < 20; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  // The slow trainer reads the evicted elements from the compressed tier.
+  for (int i = 1; i < 30; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  for (int i = 20; i < 30; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+}
+
+TEST(CrossTrainerCacheTest, CompressedTierIsBounded) {
+  // Holds three two-digit compressed elements.
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<CompressibleInfiniteRange>(),
+      /*max_compressed_cache_size_bytes=*/6);
+  EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(0)));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 1; i < 20; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  // 15 to 19 are in memory, and 12 to 14 are compressed.
+  for (int i = 12; i < 20; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(i)));
+  }
+}
+
+TEST(CrossTrainerCacheTest, CompressionIsUnimplemented) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(),
+      /*max_compressed_cache_size_bytes=*/1024);
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  // 0 is evicted when 5 is cached, but all trainers have read it. 1 is not
+  // read by the slow trainer and needs to be compressed.
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_THAT(cache.Get("Fast trainer"),
+              StatusIs(error::UNIMPLEMENTED,
+                       HasSubstr("does not support compressed")));
+}
+
 TEST(CrossTrainerCacheTest, NewTrainersStartLate) {
   CrossTrainerCache<int64_t> cache(
       /*max_cache_size_bytes=*/5 * sizeof(int64_t),
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_DATA_TRANSFER_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_DATA_TRANSFER_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -28,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/status.h"
 
@@ -78,6 +80,19 @@ class DataTransferClient {
   virtual Status GetElement(const GetElementRequest& req,
                             GetElementResult& result) = 0;
 
+  // Fetches up to `max_elements` next elements, appending them to `results`.
+  // Fetches at least one element, and stops early once the elements reach
+  // `max_bytes` bytes (0 means no limit), at the end of sequence, or at a
+  // skipped round. The default implementation fetches a single element.
+  virtual Status GetElements(const GetElementRequest& req,
+                             int64_t max_elements, int64_t max_bytes,
+                             std::vector<GetElementResult>& results) {
+    GetElementResult result;
+    TF_RETURN_IF_ERROR(GetElement(req, result));
+    results.push_back(std::move(result));
+    return OkStatus();
+  }
+
   // Makes a best effort to cancel all outstanding calls in progress for the
   // client, and causes further calls to return Cancelled status.
   virtual void TryCancel() = 0;
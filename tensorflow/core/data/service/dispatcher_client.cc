@@ -27,6 +27,7 @@ limitations under the License.
 #include "grpcpp/support/channel_arguments.h"
 #include "grpcpp/support/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/credentials_factory.h"
@@ -129,6 +130,7 @@ Status DataServiceDispatcherClient::GetDatasetDef(const std::string& dataset_id,
 Status DataServiceDispatcherClient::GetSplit(int64_t iteration_id,
                                              int64_t repetition,
                                              int64_t split_provider_index,
+                                             const std::string& worker_address,
                                              Tensor& split,
                                              bool& end_of_splits) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
@@ -136,6 +138,7 @@ Status DataServiceDispatcherClient::GetSplit(int64_t iteration_id,
   req.set_iteration_id(iteration_id);
   req.set_repetition(repetition);
   req.set_split_provider_index(split_provider_index);
+  req.set_worker_address(worker_address);
   GetSplitResponse resp;
   grpc::ClientContext client_ctx;
   grpc::Status status = stub_->GetSplit(&client_ctx, req, &resp);
@@ -334,6 +337,21 @@ Status DataServiceDispatcherClient::GetWorkers(
   return OkStatus();
 }
 
+Status DataServiceDispatcherClient::GetNumberOfWorkersEstimate(
+    absl::Duration forecast_horizon,
+    GetNumberOfWorkersEstimateResponse& response) {
+  TF_RETURN_IF_ERROR(EnsureInitialized());
+  GetNumberOfWorkersEstimateRequest request;
+  request.set_forecast_horizon_ms(absl::ToInt64Milliseconds(forecast_horizon));
+  grpc::ClientContext ctx;
+  grpc::Status s = stub_->GetNumberOfWorkersEstimate(&ctx, request, &response);
+  if (!s.ok()) {
+    return grpc_util::WrapError("Failed to get the number of workers estimate",
+                                s);
+  }
+  return OkStatus();
+}
+
 Status DataServiceDispatcherClient::GetDataServiceMetadata(
     const std::string& dataset_id, DataServiceMetadata& metadata) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
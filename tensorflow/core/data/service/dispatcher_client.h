@@ -21,6 +21,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/time/time.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/dispatcher.grpc.pb.h"
@@ -62,9 +63,11 @@ class DataServiceDispatcherClient : public DataServiceClientBase {
   Status GetDatasetDef(const std::string& dataset_id, DatasetDef& dataset_def);
 
   // Gets the next split for the specified iteration id, repetition, and split
-  // provider index.
+  // provider index. `worker_address` is the address of the requesting worker,
+  // or empty if it is not a worker.
   Status GetSplit(int64_t iteration_id, int64_t repetition,
-                  int64_t split_provider_index, Tensor& split,
+                  int64_t split_provider_index,
+                  const std::string& worker_address, Tensor& split,
                   bool& end_of_splits);
 
   // Gets the next split for the specified source of a stream of the snapshot in
@@ -124,6 +127,12 @@ class DataServiceDispatcherClient : public DataServiceClientBase {
   // stored in `workers`.
   Status GetWorkers(std::vector<WorkerInfo>& workers);
 
+  // Queries the dispatcher for the estimated optimal number of workers and the
+  // number of workers forecast to be needed `forecast_horizon` from now.
+  Status GetNumberOfWorkersEstimate(
+      absl::Duration forecast_horizon,
+      GetNumberOfWorkersEstimateResponse& response);
+
   // Returns data service metadata for the registered dataset.
   Status GetDataServiceMetadata(const std::string& dataset_id,
                                 DataServiceMetadata& metadata);
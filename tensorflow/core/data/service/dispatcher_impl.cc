@@ -86,6 +86,9 @@ using ::tensorflow::protobuf::util::MessageDifferencer;
 constexpr char kJournalDir[] = "tf_data_dispatcher_journal";
 // The name of the datasets directory inside the dispatcher's working directory.
 constexpr char kDatasetsDir[] = "datasets";
+// The number of journal updates replayed between releases of `mu_` while
+// restoring the dispatcher state.
+constexpr int64_t kJournalReplayBatchSize = 1000;
 
 // To reduce memory usage, defaults to restricting workers from processing more
 // than two snapshots at a time across all ongoing snapshots. Allowing two
@@ -184,8 +187,10 @@ DataServiceDispatcherImpl::DataServiceDispatcherImpl(
     const DispatcherConfig& config)
     : config_(ApplyConfigDefaults(config)),
       env_(Env::Default()),
+      split_locality_fn_(MakeSplitLocalityFn(config_)),
       snapshot_assignment_manager_(config_.worker_max_concurrent_snapshots()),
-      state_(config_) {
+      state_(config_),
+      auto_scaler_(env_) {
   if (config_.work_dir().empty()) {
     dataset_store_ = std::make_unique<MemoryDatasetStore>();
   } else {
@@ -204,47 +209,63 @@ DataServiceDispatcherImpl::~DataServiceDispatcherImpl() {
 }
 
 Status DataServiceDispatcherImpl::Start() {
+  TF_RETURN_IF_ERROR(RestoreState());
   mutex_lock l(mu_);
   if (config_.job_gc_timeout_ms() >= 0) {
     maintenance_thread_ = absl::WrapUnique(env_->StartThread(
         {}, "maintenance-thread", [&] { MaintenanceThread(); }));
   }
-  if (config_.work_dir().empty()) {
-    if (config_.fault_tolerant_mode()) {
-      return errors::InvalidArgument(
-          "fault_tolerant_mode is True, but no work_dir is configured.");
+  started_ = true;
+  return OkStatus();
+}
+
+Status DataServiceDispatcherImpl::RestoreState() TF_LOCKS_EXCLUDED(mu_) {
+  {
+    mutex_lock l(mu_);
+    if (config_.work_dir().empty()) {
+      if (config_.fault_tolerant_mode()) {
+        return errors::InvalidArgument(
+            "fault_tolerant_mode is True, but no work_dir is configured.");
+      }
+    } else {
+      TF_RETURN_IF_ERROR(
+          env_->RecursivelyCreateDir(DatasetsDir(config_.work_dir())));
     }
-  } else {
-    TF_RETURN_IF_ERROR(
-        env_->RecursivelyCreateDir(DatasetsDir(config_.work_dir())));
-  }
-  if (!config_.fault_tolerant_mode()) {
-    LOG(INFO) << "Running with fault_tolerant_mode=False. The dispatcher will "
-                 "not be able to recover its state on restart.";
-    started_ = true;
-    return OkStatus();
+    if (!config_.fault_tolerant_mode()) {
+      LOG(INFO) << "Running with fault_tolerant_mode=False. The dispatcher "
+                   "will not be able to recover its state on restart.";
+      return OkStatus();
+    }
+    journal_writer_ = std::make_unique<FileJournalWriter>(
+        env_, JournalDir(config_.work_dir()));
   }
-  journal_writer_ =
-      std::make_unique<FileJournalWriter>(env_, JournalDir(config_.work_dir()));
   LOG(INFO) << "Attempting to restore dispatcher state from journal in "
             << JournalDir(config_.work_dir());
-  Update update;
-  bool end_of_journal = false;
-  FileJournalReader reader(env_, JournalDir(config_.work_dir()));
-  Status s = reader.Read(update, end_of_journal);
-  if (errors::IsNotFound(s)) {
-    LOG(INFO) << "No journal found. Starting dispatcher from new state.";
-  } else if (!s.ok()) {
+  int64_t start = env_->NowMicros();
+  int64_t journal_sequence_number = 0;
+  DispatcherStateCheckpoint checkpoint;
+  Status s = ReadLatestDispatcherStateCheckpoint(
+      env_, JournalDir(config_.work_dir()), checkpoint);
+  if (s.ok()) {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(state_.RestoreCheckpoint(checkpoint));
+    journal_sequence_number = checkpoint.journal_sequence_number();
+    LOG(INFO) << "Restored dispatcher state checkpoint with "
+              << checkpoint.updates_size() << " updates.";
+  } else if (!errors::IsNotFound(s)) {
     return s;
+  }
+  TF_ASSIGN_OR_RETURN(int64_t num_replayed_updates,
+                      ReplayJournal(journal_sequence_number));
+  if (num_replayed_updates == 0 && !s.ok()) {
+    LOG(INFO) << "No journal found. Starting dispatcher from new state.";
   } else {
-    int64_t start = env_->NowMicros();
-    while (!end_of_journal) {
-      TF_RETURN_IF_ERROR(ApplyWithoutJournaling(update));
-      TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
-    }
     absl::Duration duration = absl::Microseconds(env_->NowMicros() - start);
-    LOG(INFO) << "Restored from journal in " << duration << ".";
+    LOG(INFO) << "Restored from journal in " << duration << ", replaying "
+              << num_replayed_updates << " updates.";
   }
+
+  mutex_lock l(mu_);
   for (const auto& iteration : state_.ListIterations()) {
     if (IsDynamicShard(iteration->job->processing_mode)) {
       TF_RETURN_IF_ERROR(RestoreSplitProviders(
@@ -260,6 +281,12 @@ Status DataServiceDispatcherImpl::Start() {
   // Initialize the journal writer in `Start` so that we fail fast in case it
   // can't be initialized.
   TF_RETURN_IF_ERROR(journal_writer_.value()->EnsureInitialized());
+  updates_since_checkpoint_ = num_replayed_updates;
+  if (config_.journal_checkpoint_interval_updates() > 0 &&
+      updates_since_checkpoint_ >=
+          config_.journal_checkpoint_interval_updates()) {
+    TF_RETURN_IF_ERROR(CheckpointState());
+  }
 
   for (const auto& path : state_.ListSnapshotPaths()) {
     TF_ASSIGN_OR_RETURN(
@@ -267,11 +294,41 @@ Status DataServiceDispatcherImpl::Start() {
         SnapshotManager::Resume(path, snapshot_assignment_manager_, env_));
     snapshots_.insert({path, std::move(snapshot_manager)});
   }
-
-  started_ = true;
   return OkStatus();
 }
 
+StatusOr<int64_t> DataServiceDispatcherImpl::ReplayJournal(
+    int64_t start_sequence_number) TF_LOCKS_EXCLUDED(mu_) {
+  FileJournalReader reader(env_, JournalDir(config_.work_dir()),
+                           start_sequence_number);
+  int64_t num_updates = 0;
+  bool end_of_journal = false;
+  while (!end_of_journal) {
+    // Reads a batch of updates without holding `mu_`, so that read-only
+    // requests can be served while the journal is replayed.
+    std::vector<Update> updates;
+    while (!end_of_journal &&
+           static_cast<int64_t>(updates.size()) < kJournalReplayBatchSize) {
+      Update update;
+      Status s = reader.Read(update, end_of_journal);
+      if (errors::IsNotFound(s) && num_updates == 0 && updates.empty()) {
+        // There is no journal after the checkpoint.
+        return 0;
+      }
+      TF_RETURN_IF_ERROR(s);
+      if (!end_of_journal) {
+        updates.push_back(std::move(update));
+      }
+    }
+    mutex_lock l(mu_);
+    for (const Update& update : updates) {
+      TF_RETURN_IF_ERROR(ApplyWithoutJournaling(update));
+    }
+    num_updates += updates.size();
+  }
+  return num_updates;
+}
+
 size_t DataServiceDispatcherImpl::NumActiveIterations() TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock l(mu_);
   size_t count = 0;
@@ -424,6 +481,19 @@ Status DataServiceDispatcherImpl::WorkerHeartbeat(
                                                request->active_tasks().end());
     ReportProcessingTimesFromActiveTasks(active_tasks,
                                          request->worker_address());
+    // Workers report no CPU utilization until they have measured it over a
+    // full heartbeat interval.
+    if (config_.adaptive_compression() && request->cpu_utilization() > 0) {
+      Status compression_policy_status =
+          compression_policy_.ReportWorkerCpuUtilization(
+              worker_address, request->cpu_utilization());
+      if (!compression_policy_status.ok()) {
+        LOG_EVERY_N(WARNING, 20)
+            << "Failed to report CPU utilization for worker "
+            << worker_address << " to tf.data service CompressionPolicy: "
+            << compression_policy_status;
+      }
+    }
     TF_RETURN_IF_ERROR(
         FindTasksToDelete(current_tasks, assigned_tasks, response));
     TF_RETURN_IF_ERROR(
@@ -472,10 +542,9 @@ Status DataServiceDispatcherImpl::WorkerUpdate(
 
 Status DataServiceDispatcherImpl::GetDatasetDef(
     const GetDatasetDefRequest* request, GetDatasetDefResponse* response) {
-  TF_RETURN_IF_ERROR(CheckStarted());
   mutex_lock l(mu_);
   std::shared_ptr<const Dataset> dataset;
-  TF_RETURN_IF_ERROR(state_.DatasetFromId(request->dataset_id(), dataset));
+  TF_RETURN_IF_ERROR(DatasetFromIdIfRestored(request->dataset_id(), dataset));
   std::shared_ptr<const DatasetDef> dataset_def;
   TF_RETURN_IF_ERROR(GetDatasetDef(*dataset, dataset_def));
   *response->mutable_dataset_def() = *dataset_def;
@@ -494,6 +563,7 @@ Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   mutex_lock l(get_split_mu_);
   int64_t current_repetition = 0;
   SplitProvider* split_provider = nullptr;
+  std::vector<std::string> worker_tags;
   {
     mutex_lock l(mu_);
     std::shared_ptr<const Iteration> iteration;
@@ -513,23 +583,48 @@ Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
       return OkStatus();
     }
     split_provider = split_providers_[iteration_id][provider_index].get();
+    std::shared_ptr<const Worker> worker;
+    if (!request->worker_address().empty() &&
+        state_.WorkerFromAddress(request->worker_address(), worker).ok()) {
+      worker_tags = worker->tags;
+    }
+  }
+  LocalitySplitAssigner* split_assigner = nullptr;
+  if (UseLocalitySplitAssignment()) {
+    std::vector<std::unique_ptr<LocalitySplitAssigner>>& split_assigners =
+        split_assigners_[iteration_id];
+    if (static_cast<int64_t>(split_assigners.size()) <= provider_index) {
+      split_assigners.resize(provider_index + 1);
+    }
+    if (!split_assigners[provider_index]) {
+      split_assigners[provider_index] = std::make_unique<LocalitySplitAssigner>(
+          split_provider, split_locality_fn_);
+    }
+    split_assigner = split_assigners[provider_index].get();
   }
   if (request->repetition() > current_repetition) {
     // This could happen if an iterator is repeated before reaching end of
     // input, e.g. for the longer input to `Dataset.zip`. In this case we mark
     // the previous repetitions as completed and advance to the requested
     // repetition.
-    TF_RETURN_IF_ERROR(split_provider->Reset());
+    TF_RETURN_IF_ERROR(split_assigner ? split_assigner->Reset()
+                                      : split_provider->Reset());
   }
   Tensor split;
   bool end_of_splits = false;
-  TF_RETURN_IF_ERROR(split_provider->GetNext(&split, &end_of_splits));
+  if (split_assigner) {
+    TF_RETURN_IF_ERROR(
+        split_assigner->GetNext(worker_tags, &split, &end_of_splits));
+  } else {
+    TF_RETURN_IF_ERROR(split_provider->GetNext(&split, &end_of_splits));
+  }
   TF_RETURN_IF_ERROR(RecordSplitProduced(iteration_id, repetition,
                                          provider_index, end_of_splits));
   response->set_end_of_splits(end_of_splits);
   if (end_of_splits) {
     // Reset the split provider to prepare for the next iteration.
-    TF_RETURN_IF_ERROR(split_provider->Reset());
+    TF_RETURN_IF_ERROR(split_assigner ? split_assigner->Reset()
+                                      : split_provider->Reset());
   } else {
     split.AsProtoTensorContent(response->mutable_split());
   }
@@ -538,6 +633,13 @@ Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   return OkStatus();
 }
 
+bool DataServiceDispatcherImpl::UseLocalitySplitAssignment() const {
+  // Restoring split providers from the journal skips the produced splits in
+  // the split provider's order, which assumes they are not reordered.
+  return !config_.split_locality_hints().empty() &&
+         !config_.fault_tolerant_mode();
+}
+
 Status DataServiceDispatcherImpl::MakeSplitProviders(
     const std::string& dataset_id,
     std::vector<std::unique_ptr<SplitProvider>>& split_providers)
@@ -618,12 +720,11 @@ Status DataServiceDispatcherImpl::RegisterDataset(
 Status DataServiceDispatcherImpl::GetDataServiceMetadata(
     const GetDataServiceMetadataRequest* request,
     GetDataServiceMetadataResponse* response) {
-  TF_RETURN_IF_ERROR(CheckStarted());
   std::string dataset_id = request->dataset_id();
   std::shared_ptr<const Dataset> dataset;
 
   mutex_lock l(mu_);
-  TF_RETURN_IF_ERROR(state_.DatasetFromId(dataset_id, dataset));
+  TF_RETURN_IF_ERROR(DatasetFromIdIfRestored(dataset_id, dataset));
   VLOG(3) << "Get the data service metadata for dataset id: " << dataset_id
           << ".";
   *response->mutable_metadata() = dataset->metadata;
@@ -633,7 +734,6 @@ Status DataServiceDispatcherImpl::GetDataServiceMetadata(
 Status DataServiceDispatcherImpl::GetDataServiceConfig(
     const GetDataServiceConfigRequest* request,
     GetDataServiceConfigResponse* response) {
-  TF_RETURN_IF_ERROR(CheckStarted());
   response->mutable_config()->set_deployment_mode(config_.deployment_mode());
   return OkStatus();
 }
@@ -700,6 +800,7 @@ Status DataServiceDispatcherImpl::GetOrCreateIteration(
 
 Status DataServiceDispatcherImpl::MaybeRemoveTask(
     const MaybeRemoveTaskRequest* request, MaybeRemoveTaskResponse* response) {
+  TF_RETURN_IF_ERROR(CheckStarted());
   VLOG(1) << "Attempting to remove task. Request: " << request->DebugString();
   std::shared_ptr<TaskRemover> remover;
   std::shared_ptr<const Task> task;
@@ -765,6 +866,7 @@ Status DataServiceDispatcherImpl::ReleaseIterationClient(
                  << " for Iteration " << iteration->iteration_id
                  << " from tf.data service AutoScaler: " << auto_scaler_status;
   }
+  compression_policy_.RemoveClient(iteration_client_id);
   Update update;
   ReleaseIterationClientUpdate* release_iteration_client =
       update.mutable_release_iteration_client();
@@ -1101,6 +1203,20 @@ Status DataServiceDispatcherImpl::ClientHeartbeat(
         << request->iteration_client_id()
         << " to tf.data service AutoScaler: " << auto_scaler_status;
   }
+  if (config_.adaptive_compression() &&
+      request->received_bytes_per_sec() > 0) {
+    Status compression_policy_status =
+        compression_policy_.ReportClientThroughput(
+            iteration->job->id, request->iteration_client_id(),
+            request->received_bytes_per_sec());
+    if (!compression_policy_status.ok()) {
+      LOG_EVERY_N(WARNING, 20)
+          << "Failed to report receive throughput for consumer ID "
+          << request->iteration_client_id()
+          << " to tf.data service CompressionPolicy: "
+          << compression_policy_status;
+    }
+  }
 
   std::vector<std::shared_ptr<const Task>> tasks;
   TF_RETURN_IF_ERROR(state_.TasksForIteration(iteration->iteration_id, tasks));
@@ -1139,6 +1255,28 @@ Status DataServiceDispatcherImpl::GetWorkers(const GetWorkersRequest* request,
   return OkStatus();
 }
 
+Status DataServiceDispatcherImpl::GetNumberOfWorkersEstimate(
+    const GetNumberOfWorkersEstimateRequest* request,
+    GetNumberOfWorkersEstimateResponse* response) {
+  TF_RETURN_IF_ERROR(CheckStarted());
+  absl::Duration forecast_horizon =
+      request->forecast_horizon_ms() > 0
+          ? absl::Milliseconds(request->forecast_horizon_ms())
+          : kDefaultAutoScalerForecastHorizon;
+  std::optional<int64_t> optimal_number_of_workers =
+      auto_scaler_.GetOptimalNumberOfWorkers();
+  std::optional<int64_t> forecast_number_of_workers =
+      auto_scaler_.GetForecastNumberOfWorkers(forecast_horizon);
+  if (!optimal_number_of_workers.has_value() ||
+      !forecast_number_of_workers.has_value()) {
+    return OkStatus();
+  }
+  response->set_has_estimate(true);
+  response->set_optimal_number_of_workers(*optimal_number_of_workers);
+  response->set_forecast_number_of_workers(*forecast_number_of_workers);
+  return OkStatus();
+}
+
 Status DataServiceDispatcherImpl::Snapshot(const SnapshotRequest* request,
                                            SnapshotResponse* response) {
   TF_RETURN_IF_ERROR(CheckStarted());
@@ -1198,6 +1336,7 @@ Status DataServiceDispatcherImpl::GetSnapshotSplit(
 Status DataServiceDispatcherImpl::DisableCompressionAtRuntime(
     const DisableCompressionAtRuntimeRequest* request,
     DisableCompressionAtRuntimeResponse* response) {
+  TF_RETURN_IF_ERROR(CheckStarted());
   std::shared_ptr<const Dataset> dataset;
   mutex_lock l(mu_);
   TF_RETURN_IF_ERROR(state_.DatasetFromId(request->dataset_id(), dataset));
@@ -1252,6 +1391,16 @@ Status DataServiceDispatcherImpl::PopulateTaskDef(
   std::shared_ptr<const Dataset> dataset;
   TF_RETURN_IF_ERROR(
       state_.DatasetFromId(task->iteration->job->dataset_id, dataset));
+  if (config_.adaptive_compression() &&
+      dataset->metadata.compression() ==
+          DataServiceMetadata::COMPRESSION_SNAPPY &&
+      !state_.CompressionDisabledAtRuntime(dataset->dataset_id)
+           .value_or(false)) {
+    task_def->set_compression_codec(
+        compression_policy_.GetCodec(task->iteration->job->id));
+    VLOG(1) << "Using compression codec " << task_def->compression_codec()
+            << " for task " << task->task_id;
+  }
   if (config_.work_dir().empty()) {
     std::shared_ptr<const DatasetDef> dataset_def;
     TF_RETURN_IF_ERROR(dataset_store_->Get(dataset->dataset_id, dataset_def));
@@ -1272,6 +1421,19 @@ Status DataServiceDispatcherImpl::CheckStarted() TF_LOCKS_EXCLUDED(mu_) {
   return OkStatus();
 }
 
+Status DataServiceDispatcherImpl::DatasetFromIdIfRestored(
+    const std::string& dataset_id, std::shared_ptr<const Dataset>& dataset)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  Status s = state_.DatasetFromId(dataset_id, dataset);
+  if (errors::IsNotFound(s) && !started_) {
+    // Datasets are never unregistered, so datasets found while the journal is
+    // being replayed are up to date. Missing datasets may not have been
+    // replayed yet.
+    return errors::Unavailable("Dispatcher has not started yet.");
+  }
+  return s;
+}
+
 Status DataServiceDispatcherImpl::RecordSplitProduced(
     int64_t iteration_id, int64_t repetition, int64_t split_provider_index,
     bool finished) TF_LOCKS_EXCLUDED(mu_) {
@@ -1295,7 +1457,38 @@ Status DataServiceDispatcherImpl::Apply(const Update& update)
   if (journal_writer_.has_value()) {
     TF_RETURN_IF_ERROR(journal_writer_.value()->Write(update));
   }
-  return state_.Apply(update);
+  TF_RETURN_IF_ERROR(state_.Apply(update));
+  if (journal_writer_.has_value()) {
+    MaybeCheckpointState();
+  }
+  return OkStatus();
+}
+
+void DataServiceDispatcherImpl::MaybeCheckpointState()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  ++updates_since_checkpoint_;
+  if (config_.journal_checkpoint_interval_updates() <= 0 ||
+      updates_since_checkpoint_ <
+          config_.journal_checkpoint_interval_updates()) {
+    return;
+  }
+  // The update has been journaled, so failing to checkpoint only means that
+  // restarts replay more of the journal.
+  Status s = CheckpointState();
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to checkpoint the dispatcher state: " << s;
+  }
+}
+
+Status DataServiceDispatcherImpl::CheckpointState()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  updates_since_checkpoint_ = 0;
+  TF_ASSIGN_OR_RETURN(int64_t journal_sequence_number,
+                      journal_writer_.value()->Rotate());
+  DispatcherStateCheckpoint checkpoint = state_.Checkpoint();
+  checkpoint.set_journal_sequence_number(journal_sequence_number);
+  return WriteDispatcherStateCheckpoint(env_, JournalDir(config_.work_dir()),
+                                        checkpoint);
 }
 
 void DataServiceDispatcherImpl::MaintenanceThread() {
@@ -1350,6 +1543,7 @@ void DataServiceDispatcherImpl::RemoveClientFromAutoScaler(int64_t client_id)
                    << " from tf.data service AutoScaler: "
                    << auto_scaler_status;
     }
+    compression_policy_.RemoveClient(client_id);
   } else {
     LOG(WARNING) << "Could not find Iteration for client with id " << client_id
                  << " in tf.data service dispatcher state: " << s;
@@ -1410,6 +1604,7 @@ void DataServiceDispatcherImpl::DetectMissingWorkers()
         it->second + absl::Milliseconds(config_.worker_timeout_ms())) {
       LOG(INFO) << "Lost worker " << it->first << " due to timeout";
       RemoveWorkerFromAutoScaler(it->first);
+      compression_policy_.RemoveWorker(it->first);
 
       latest_worker_heartbeats_time_.erase(it++);
     } else {
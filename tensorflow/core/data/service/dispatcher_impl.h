@@ -27,10 +27,12 @@ limitations under the License.
 #include "absl/time/time.h"
 #include "tensorflow/core/data/service/auto_scaler.h"
 #include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/compression_policy.h"
 #include "tensorflow/core/data/service/dataset_store.h"
 #include "tensorflow/core/data/service/dispatcher.pb.h"
 #include "tensorflow/core/data/service/dispatcher_state.h"
 #include "tensorflow/core/data/service/export.pb.h"
+#include "tensorflow/core/data/service/locality_split_assigner.h"
 #include "tensorflow/core/data/service/snapshot/snapshot_manager.h"
 #include "tensorflow/core/data/service/task_remover.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
@@ -138,7 +140,8 @@ class DataServiceDispatcherImpl {
   ~DataServiceDispatcherImpl();
 
   // Starts the dispatcher. If there is a journal, this will read from the
-  // journal to restore the dispatcher's state.
+  // journal to restore the dispatcher's state. Read-only requests about
+  // datasets are served while the journal is replayed.
   Status Start();
 
   // Returns the number of active iterations.
@@ -176,6 +179,9 @@ class DataServiceDispatcherImpl {
                          ClientHeartbeatResponse* response);
   Status GetWorkers(const GetWorkersRequest* request,
                     GetWorkersResponse* response);
+  Status GetNumberOfWorkersEstimate(
+      const GetNumberOfWorkersEstimateRequest* request,
+      GetNumberOfWorkersEstimateResponse* response);
   Status Snapshot(const SnapshotRequest* request, SnapshotResponse* response);
   Status GetSnapshotSplit(const GetSnapshotSplitRequest* request,
                           GetSnapshotSplitResponse* response);
@@ -199,6 +205,8 @@ class DataServiceDispatcherImpl {
       const DispatcherState::Iteration& iteration,
       std::vector<std::unique_ptr<SplitProvider>>& restored)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Whether `GetSplit` assigns splits based on the split locality hints.
+  bool UseLocalitySplitAssignment() const;
   // Makes split providers for the specified `dataset_id`, and stores them in
   // `split_providers`.
   Status MakeSplitProviders(
@@ -304,6 +312,25 @@ class DataServiceDispatcherImpl {
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Checks that the dispatcher has started, returning UNAVAILABLE if it hasn't.
   Status CheckStarted() TF_LOCKS_EXCLUDED(mu_);
+  // Gets the dataset with `dataset_id`. Returns UNAVAILABLE instead of
+  // NOT_FOUND until the dispatcher state is restored.
+  Status DatasetFromIdIfRestored(
+      const std::string& dataset_id,
+      std::shared_ptr<const DispatcherState::Dataset>& dataset)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Restores the dispatcher state from the latest checkpoint and the journal
+  // written after it.
+  Status RestoreState() TF_LOCKS_EXCLUDED(mu_);
+  // Replays the journal files from `start_sequence_number` on, returning the
+  // number of replayed updates. Releases `mu_` between batches of updates.
+  StatusOr<int64_t> ReplayJournal(int64_t start_sequence_number)
+      TF_LOCKS_EXCLUDED(mu_);
+  // Checkpoints the dispatcher state if enough updates have been journaled
+  // since the last checkpoint.
+  void MaybeCheckpointState() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Checkpoints the dispatcher state and deletes the journal files covered by
+  // the checkpoint.
+  Status CheckpointState() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Records that a split was produced by a call to `GetSplit`.
   Status RecordSplitProduced(int64_t iteration_id, int64_t repetition,
                              int64_t split_provider_index, bool finished)
@@ -360,6 +387,13 @@ class DataServiceDispatcherImpl {
   // Mapping from iteration id to the split providers for the iteration.
   absl::flat_hash_map<int64_t, std::vector<std::unique_ptr<SplitProvider>>>
       split_providers_ TF_GUARDED_BY(mu_);
+  // Mapping from iteration id to the locality-aware assigners of the splits of
+  // `split_providers_`. Only used if the config has split locality hints.
+  absl::flat_hash_map<int64_t,
+                      std::vector<std::unique_ptr<LocalitySplitAssigner>>>
+      split_assigners_ TF_GUARDED_BY(get_split_mu_);
+  // Computes the locality of splits from the config's split locality hints.
+  const SplitLocalityFn split_locality_fn_;
   // Mapping from round robin iteration id to the round the iteration is
   // currently on. This is based on the data provided by client heartbeats,
   // and may be stale.
@@ -385,11 +419,16 @@ class DataServiceDispatcherImpl {
 
   std::optional<std::unique_ptr<JournalWriter>> journal_writer_
       TF_GUARDED_BY(mu_);
+  // Number of updates journaled since the last state checkpoint.
+  int64_t updates_since_checkpoint_ TF_GUARDED_BY(mu_) = 0;
   DispatcherState state_ TF_GUARDED_BY(mu_);
   // Condition variable for waking up the gc thread.
   condition_variable maintenance_thread_cv_;
   std::unique_ptr<Thread> maintenance_thread_;
   MultipleIterationsAutoScaler auto_scaler_;
+  // Chooses the compression codec of each job when the dispatcher is
+  // configured with `adaptive_compression`.
+  CompressionPolicy compression_policy_;
 
   DataServiceDispatcherImpl(const DataServiceDispatcherImpl&) = delete;
   void operator=(const DataServiceDispatcherImpl&) = delete;
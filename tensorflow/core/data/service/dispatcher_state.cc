@@ -15,11 +15,14 @@ limitations under the License.
 #include "tensorflow/core/data/service/dispatcher_state.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <queue>
 #include <string>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -88,6 +91,9 @@ Status DispatcherState::Apply(const Update& update) {
     case Update::kCompressionDisabledAtRuntime:
       CompressionDisabledAtRuntime(update.compression_disabled_at_runtime());
       break;
+    case Update::kRestoreIteration:
+      RestoreIteration(update.restore_iteration());
+      break;
     case Update::UPDATE_TYPE_NOT_SET:
       return errors::Internal("Update type not set.");
   }
@@ -110,6 +116,7 @@ void DispatcherState::RegisterWorker(
   std::string address = register_worker.worker_address();
   DCHECK(!workers_.contains(address));
   workers_[address] = std::make_shared<Worker>(register_worker);
+  worker_addresses_in_registration_order_.push_back(address);
   tasks_by_worker_[address] =
       absl::flat_hash_map<int64_t, std::shared_ptr<Task>>();
   worker_index_resolver_.AddWorker(address);
@@ -254,7 +261,12 @@ void DispatcherState::CreatePendingTask(
   auto& iteration = iterations_[create_pending_task.iteration_id()];
   DCHECK_NE(iteration, nullptr);
   task = std::make_shared<Task>(create_pending_task, iteration);
-  iteration->pending_tasks.emplace(task, create_pending_task.starting_round());
+  PendingTask& pending_task = iteration->pending_tasks.emplace(
+      task, create_pending_task.starting_round());
+  pending_task.ready_consumers.insert(
+      create_pending_task.ready_consumers().begin(),
+      create_pending_task.ready_consumers().end());
+  pending_task.failures = create_pending_task.failures();
   tasks_by_worker_[create_pending_task.worker_address()][task->task_id] = task;
   next_available_task_id_ = std::max(next_available_task_id_, task_id + 1);
 }
@@ -289,6 +301,7 @@ void DispatcherState::CreateTask(const CreateTaskUpdate& create_task) {
   auto& iteration = iterations_[create_task.iteration_id()];
   DCHECK_NE(iteration, nullptr);
   task = std::make_shared<Task>(create_task, iteration);
+  task->starting_round = create_task.starting_round();
   tasks_by_iteration_[create_task.iteration_id()].push_back(task);
   tasks_by_worker_[create_task.worker_address()][task->task_id] = task;
   next_available_task_id_ = std::max(next_available_task_id_, task_id + 1);
@@ -484,6 +497,203 @@ void DispatcherState::CompressionDisabledAtRuntime(
   });
 }
 
+void DispatcherState::RestoreIteration(
+    const RestoreIterationUpdate& restore_iteration) {
+  std::shared_ptr<Iteration>& iteration =
+      iterations_[restore_iteration.iteration_id()];
+  DCHECK(iteration);
+  if (iteration->distributed_epoch_state.has_value()) {
+    DistributedEpochState& state = iteration->distributed_epoch_state.value();
+    state.repetitions.assign(restore_iteration.split_repetitions().begin(),
+                             restore_iteration.split_repetitions().end());
+    state.indices.assign(restore_iteration.split_indices().begin(),
+                         restore_iteration.split_indices().end());
+  }
+  iteration->last_client_released_micros =
+      restore_iteration.last_client_released_micros();
+  iteration->finished = restore_iteration.finished();
+  iteration->garbage_collected = restore_iteration.garbage_collected();
+}
+
+DispatcherStateCheckpoint DispatcherState::Checkpoint() const {
+  DispatcherStateCheckpoint checkpoint;
+  std::vector<std::string> dataset_ids;
+  for (const auto& [dataset_id, unused] : datasets_by_id_) {
+    dataset_ids.push_back(dataset_id);
+  }
+  absl::c_sort(dataset_ids);
+  for (const std::string& dataset_id : dataset_ids) {
+    const Dataset& dataset = *datasets_by_id_.at(dataset_id);
+    RegisterDatasetUpdate* register_dataset =
+        checkpoint.add_updates()->mutable_register_dataset();
+    register_dataset->set_dataset_id(dataset.dataset_id);
+    *register_dataset->mutable_metadata() = dataset.metadata;
+  }
+
+  for (const std::string& address : worker_addresses_in_registration_order_) {
+    const Worker& worker = *workers_.at(address);
+    RegisterWorkerUpdate* register_worker =
+        checkpoint.add_updates()->mutable_register_worker();
+    register_worker->set_worker_address(worker.address);
+    *register_worker->mutable_transfer_servers() = {
+        worker.transfer_servers.begin(), worker.transfer_servers.end()};
+    *register_worker->mutable_worker_tags() = {worker.tags.begin(),
+                                               worker.tags.end()};
+    register_worker->set_worker_uid(worker.uid);
+  }
+
+  std::vector<int64_t> job_ids;
+  for (const auto& [job_id, unused] : jobs_by_id_) {
+    job_ids.push_back(job_id);
+  }
+  absl::c_sort(job_ids);
+  for (int64_t job_id : job_ids) {
+    const Job& job = *jobs_by_id_.at(job_id);
+    CreateJobUpdate* create_job =
+        checkpoint.add_updates()->mutable_create_job();
+    create_job->set_job_id(job.id);
+    create_job->set_job_name(job.job_name);
+    create_job->set_dataset_id(job.dataset_id);
+    *create_job->mutable_processing_mode_def() = job.processing_mode;
+    if (job.num_consumers.has_value()) {
+      create_job->set_num_consumers(job.num_consumers.value());
+    }
+    create_job->set_target_workers(job.target_workers);
+    create_job->set_use_cross_trainer_cache(job.use_cross_trainer_cache);
+  }
+
+  // Iterations are recreated in id order, so that an iteration replacing a
+  // garbage collected one with the same key is created after it.
+  std::vector<int64_t> iteration_ids;
+  for (const auto& [iteration_id, unused] : iterations_) {
+    iteration_ids.push_back(iteration_id);
+  }
+  absl::c_sort(iteration_ids);
+  for (int64_t iteration_id : iteration_ids) {
+    CheckpointIteration(*iterations_.at(iteration_id), checkpoint);
+  }
+
+  std::vector<int64_t> iteration_client_ids;
+  for (const auto& [iteration_client_id, iteration] :
+       iterations_for_client_ids_) {
+    // `IterationForIterationClientId` leaves null entries for unknown ids.
+    if (iteration) {
+      iteration_client_ids.push_back(iteration_client_id);
+    }
+  }
+  absl::c_sort(iteration_client_ids);
+  for (int64_t iteration_client_id : iteration_client_ids) {
+    AcquireIterationClientUpdate* acquire_iteration_client =
+        checkpoint.add_updates()->mutable_acquire_iteration_client();
+    acquire_iteration_client->set_iteration_id(
+        iterations_for_client_ids_.at(iteration_client_id)->iteration_id);
+    acquire_iteration_client->set_iteration_client_id(iteration_client_id);
+  }
+
+  std::vector<std::string> snapshot_paths(snapshot_paths_.begin(),
+                                          snapshot_paths_.end());
+  absl::c_sort(snapshot_paths);
+  for (const std::string& path : snapshot_paths) {
+    checkpoint.add_updates()->mutable_snapshot()->set_path(path);
+  }
+  for (const auto& [dataset_id, compression_disabled] :
+       compression_disabled_at_runtime_) {
+    CompressionDisabledAtRuntimeUpdate* compression_disabled_at_runtime =
+        checkpoint.add_updates()->mutable_compression_disabled_at_runtime();
+    compression_disabled_at_runtime->set_dataset_id(dataset_id);
+    compression_disabled_at_runtime->set_compression_disabled(
+        compression_disabled);
+  }
+
+  checkpoint.set_next_available_task_id(next_available_task_id_);
+  checkpoint.set_next_available_iteration_client_id(
+      next_available_iteration_client_id_);
+  return checkpoint;
+}
+
+void DispatcherState::CheckpointIteration(
+    const Iteration& iteration, DispatcherStateCheckpoint& checkpoint) const {
+  CreateIterationUpdate* create_iteration =
+      checkpoint.add_updates()->mutable_create_iteration();
+  create_iteration->set_iteration_id(iteration.iteration_id);
+  create_iteration->set_job_id(iteration.job->id);
+  create_iteration->set_repetition(iteration.iteration_key.repetition);
+  if (iteration.distributed_epoch_state.has_value()) {
+    create_iteration->set_num_split_providers(
+        iteration.distributed_epoch_state->indices.size());
+  }
+
+  auto set_task_fields = [](const Task& task, auto* update) {
+    update->set_task_id(task.task_id);
+    update->set_iteration_id(task.iteration->iteration_id);
+    update->set_worker_address(task.worker_address);
+    *update->mutable_transfer_servers() = {task.transfer_servers.begin(),
+                                           task.transfer_servers.end()};
+    *update->mutable_worker_tags() = {task.worker_tags.begin(),
+                                      task.worker_tags.end()};
+    update->set_worker_uid(task.worker_uid);
+  };
+  for (const std::shared_ptr<Task>& task :
+       tasks_by_iteration_.at(iteration.iteration_id)) {
+    CreateTaskUpdate* create_task =
+        checkpoint.add_updates()->mutable_create_task();
+    set_task_fields(*task, create_task);
+    create_task->set_starting_round(task->starting_round);
+    if (task->finished) {
+      checkpoint.add_updates()->mutable_finish_task()->set_task_id(
+          task->task_id);
+    }
+  }
+  std::queue<PendingTask> pending_tasks = iteration.pending_tasks;
+  for (; !pending_tasks.empty(); pending_tasks.pop()) {
+    const PendingTask& pending_task = pending_tasks.front();
+    CreatePendingTaskUpdate* create_pending_task =
+        checkpoint.add_updates()->mutable_create_pending_task();
+    set_task_fields(*pending_task.task, create_pending_task);
+    create_pending_task->set_starting_round(pending_task.target_round);
+    std::vector<int64_t> ready_consumers(pending_task.ready_consumers.begin(),
+                                         pending_task.ready_consumers.end());
+    absl::c_sort(ready_consumers);
+    *create_pending_task->mutable_ready_consumers() = {ready_consumers.begin(),
+                                                       ready_consumers.end()};
+    create_pending_task->set_failures(pending_task.failures);
+  }
+
+  RestoreIterationUpdate* restore_iteration =
+      checkpoint.add_updates()->mutable_restore_iteration();
+  restore_iteration->set_iteration_id(iteration.iteration_id);
+  if (iteration.distributed_epoch_state.has_value()) {
+    const DistributedEpochState& state =
+        iteration.distributed_epoch_state.value();
+    *restore_iteration->mutable_split_repetitions() = {
+        state.repetitions.begin(), state.repetitions.end()};
+    *restore_iteration->mutable_split_indices() = {state.indices.begin(),
+                                                   state.indices.end()};
+  }
+  restore_iteration->set_last_client_released_micros(
+      iteration.last_client_released_micros);
+  restore_iteration->set_finished(iteration.finished);
+  restore_iteration->set_garbage_collected(iteration.garbage_collected);
+}
+
+Status DispatcherState::RestoreCheckpoint(
+    const DispatcherStateCheckpoint& checkpoint) {
+  if (!datasets_by_id_.empty() || !workers_.empty() || !jobs_by_id_.empty()) {
+    return errors::FailedPrecondition(
+        "Dispatcher state checkpoints can only be restored to an empty "
+        "state.");
+  }
+  for (const Update& update : checkpoint.updates()) {
+    TF_RETURN_IF_ERROR(Apply(update));
+  }
+  next_available_task_id_ =
+      std::max(next_available_task_id_, checkpoint.next_available_task_id());
+  next_available_iteration_client_id_ =
+      std::max(next_available_iteration_client_id_,
+               checkpoint.next_available_iteration_client_id());
+  return OkStatus();
+}
+
 std::optional<bool> DispatcherState::CompressionDisabledAtRuntime(
     const std::string& dataset_id) const {
   if (auto it = compression_disabled_at_runtime_.find(dataset_id);
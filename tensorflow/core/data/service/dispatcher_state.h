@@ -73,6 +73,13 @@ class DispatcherState {
   // Applies the given update to the dispatcher's state.
   Status Apply(const Update& update);
 
+  // Returns a checkpoint of the state, made of the fewest updates that recreate
+  // the state when applied to an empty `DispatcherState`.
+  DispatcherStateCheckpoint Checkpoint() const;
+  // Restores the state from `checkpoint`. Must be called before applying any
+  // other updates.
+  Status RestoreCheckpoint(const DispatcherStateCheckpoint& checkpoint);
+
   // A dataset registered with the dispatcher.
   struct Dataset {
     explicit Dataset(const std::string& dataset_id,
@@ -324,6 +331,12 @@ class DispatcherState {
   void Snapshot(const SnapshotUpdate& snapshot);
   void CompressionDisabledAtRuntime(const CompressionDisabledAtRuntimeUpdate&
                                         compression_disabled_at_runtime);
+  void RestoreIteration(const RestoreIterationUpdate& restore_iteration);
+
+  // Appends the updates that recreate `iteration` and its tasks to
+  // `checkpoint`.
+  void CheckpointIteration(const Iteration& iteration,
+                           DispatcherStateCheckpoint& checkpoint) const;
 
   // Updates the next available dataset ID.
   void UpdateNextAvailableDatasetId();
@@ -334,6 +347,9 @@ class DispatcherState {
 
   // Registered workers, keyed by address.
   absl::flat_hash_map<std::string, std::shared_ptr<Worker>> workers_;
+  // Addresses of the registered workers, in registration order. Checkpoints
+  // register the workers in the same order, which keeps their worker indices.
+  std::vector<std::string> worker_addresses_in_registration_order_;
 
   // Assigns an index to each worker according to worker addresses list
   // specified in the dispatcher config.
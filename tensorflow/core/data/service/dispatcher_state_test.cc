@@ -652,5 +652,61 @@ TEST(DispatcherState, GetNumberOfRegisteredWorkers) {
   EXPECT_EQ(state.GetNumberOfRegisteredWorkers(), 2);
 }
 
+TEST(DispatcherState, RestoreCheckpoint) {
+  DispatcherState state;
+  const int64_t iteration_id = 3;
+  TF_ASSERT_OK(RegisterDataset("dataset_id", state));
+  TF_ASSERT_OK(RegisterWorker("worker_a", state));
+  TF_ASSERT_OK(RegisterWorker("worker_b", state));
+  TF_ASSERT_OK(CreateIteration(iteration_id, "dataset_id", state));
+  TF_ASSERT_OK(CreateTask(/*task_id=*/8, iteration_id, "worker_a", state));
+  TF_ASSERT_OK(CreateTask(/*task_id=*/9, iteration_id, "worker_b", state));
+  TF_ASSERT_OK(CreateTask(/*task_id=*/10, iteration_id, "worker_b", state));
+  TF_ASSERT_OK(FinishTask(/*task_id=*/8, state));
+  Update remove_task;
+  remove_task.mutable_remove_task()->set_task_id(10);
+  TF_ASSERT_OK(state.Apply(remove_task));
+  TF_ASSERT_OK(AcquireIterationClientId(iteration_id, /*iteration_client_id=*/5,
+                                        state));
+  TF_ASSERT_OK(AcquireIterationClientId(iteration_id, /*iteration_client_id=*/6,
+                                        state));
+  TF_ASSERT_OK(ReleaseIterationClientId(/*iteration_client_id=*/6,
+                                        /*release_time=*/100, state));
+  TF_ASSERT_OK(Snapshot("snapshot_path", state));
+  DispatcherStateCheckpoint checkpoint = state.Checkpoint();
+
+  DispatcherState restored;
+  TF_ASSERT_OK(restored.RestoreCheckpoint(checkpoint));
+  EXPECT_EQ(restored.Checkpoint().SerializeAsString(),
+            checkpoint.SerializeAsString());
+  EXPECT_EQ(restored.NextAvailableTaskId(), 11);
+  EXPECT_EQ(restored.NextAvailableIterationClientId(), 7);
+  EXPECT_EQ(restored.NextAvailableDatasetId(), state.NextAvailableDatasetId());
+  EXPECT_EQ(restored.GetNumberOfRegisteredWorkers(), 2);
+  EXPECT_EQ(restored.ListSnapshotPaths(), state.ListSnapshotPaths());
+
+  std::shared_ptr<const Iteration> iteration;
+  TF_ASSERT_OK(restored.IterationFromId(iteration_id, iteration));
+  EXPECT_EQ(iteration->num_clients, 1);
+  EXPECT_EQ(iteration->last_client_released_micros, 100);
+  EXPECT_FALSE(iteration->finished);
+  std::vector<std::shared_ptr<const Task>> tasks;
+  TF_ASSERT_OK(restored.TasksForIteration(iteration_id, tasks));
+  EXPECT_THAT(tasks, SizeIs(2));
+  TF_ASSERT_OK(restored.TasksForWorker("worker_a", tasks));
+  EXPECT_THAT(tasks, IsEmpty());
+  TF_ASSERT_OK(restored.TasksForWorker("worker_b", tasks));
+  EXPECT_THAT(tasks, SizeIs(1));
+  EXPECT_THAT(restored.IterationForIterationClientId(6, iteration),
+              StatusIs(error::NOT_FOUND));
+}
+
+TEST(DispatcherState, RestoreCheckpointToNonEmptyState) {
+  DispatcherState state;
+  TF_ASSERT_OK(RegisterDataset("dataset_id", state));
+  EXPECT_THAT(state.RestoreCheckpoint(state.Checkpoint()),
+              StatusIs(error::FAILED_PRECONDITION));
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/url.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -59,6 +60,9 @@ namespace {
 
 using ::tensorflow::data::experimental::AutoShardDatasetOp;
 
+constexpr char kCompressElementOp[] = "CompressElement";
+constexpr char kCodecAttr[] = "codec";
+
 // A dynamic port has form %port% or %port_foo% that is to be replaced with the
 // actual port.
 bool HasDynamicPort(absl::string_view address) {
@@ -124,6 +128,31 @@ RemoveCompressionMapRewriter::GetRewriteConfig() const {
   return config;
 }
 
+StatusOr<GraphDef> CompressionCodecRewriter::ApplyCompressionCodecRewrite(
+    const GraphDef& graph_def) const {
+  GraphDef rewritten_graph = graph_def;
+  int64_t num_changes = 0;
+  auto set_codec = [this, &num_changes](NodeDef& node) {
+    if (node.op() == kCompressElementOp) {
+      (*node.mutable_attr())[kCodecAttr].set_s(codec_);
+      ++num_changes;
+    }
+  };
+  for (NodeDef& node : *rewritten_graph.mutable_node()) {
+    set_codec(node);
+  }
+  // The compression map's function lives in the graph's function library.
+  for (FunctionDef& function :
+       *rewritten_graph.mutable_library()->mutable_function()) {
+    for (NodeDef& node : *function.mutable_node_def()) {
+      set_codec(node);
+    }
+  }
+  VLOG(2) << "Set the compression codec of " << num_changes
+          << " CompressElement ops to " << codec_;
+  return rewritten_graph;
+}
+
 StatusOr<AutoShardRewriter> AutoShardRewriter::Create(const TaskDef& task_def) {
   TF_ASSIGN_OR_RETURN(
       AutoShardPolicy auto_shard_policy,
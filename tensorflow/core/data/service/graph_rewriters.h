@@ -44,6 +44,23 @@ class RemoveCompressionMapRewriter {
   tensorflow::RewriterConfig::CustomGraphOptimizer GetRewriteConfig() const;
 };
 
+// Rewrites the dataset graph so that its compression map compresses elements
+// with a given codec.
+class CompressionCodecRewriter {
+ public:
+  // `codec` is one of the codecs supported by the `CompressElement` op, i.e.
+  // "snappy", "zstd" or "none".
+  explicit CompressionCodecRewriter(absl::string_view codec) : codec_(codec) {}
+
+  // Returns `graph_def` with the codec of its `CompressElement` ops set to the
+  // rewriter's codec. Graphs without `CompressElement` ops are returned as is.
+  StatusOr<GraphDef> ApplyCompressionCodecRewrite(
+      const GraphDef& graph_def) const;
+
+ private:
+  const std::string codec_;
+};
+
 // Rewrites the dataset graph by applying an auto-shard policy.
 class AutoShardRewriter {
  public:
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/test_util.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/function_testlib.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -203,6 +204,36 @@ TEST(AutoShardRewriterTest, WorkerIndexOutOfRange) {
                        "index should be >= 0 and < 2, currently 5"));
 }
 
+GraphDef GraphWithCompressionMap() {
+  GraphDef graph_def;
+  FunctionDef* function = graph_def.mutable_library()->add_function();
+  function->mutable_signature()->set_name("compression_map_fn");
+  NodeDef* compress = function->add_node_def();
+  compress->set_name("compress");
+  compress->set_op("CompressElement");
+  NodeDef* identity = function->add_node_def();
+  identity->set_name("identity");
+  identity->set_op("Identity");
+  return graph_def;
+}
+
+TEST(CompressionCodecRewriterTest, SetCodec) {
+  CompressionCodecRewriter rewriter("zstd");
+  TF_ASSERT_OK_AND_ASSIGN(
+      GraphDef rewritten_graph,
+      rewriter.ApplyCompressionCodecRewrite(GraphWithCompressionMap()));
+  const FunctionDef& function = rewritten_graph.library().function(0);
+  EXPECT_EQ(function.node_def(0).attr().at("codec").s(), "zstd");
+  EXPECT_FALSE(function.node_def(1).attr().contains("codec"));
+}
+
+TEST(CompressionCodecRewriterTest, NoCompressionMap) {
+  CompressionCodecRewriter rewriter("none");
+  DatasetDef dataset = RangeSquareDataset(10);
+  EXPECT_THAT(rewriter.ApplyCompressionCodecRewrite(dataset.graph()),
+              IsOkAndHolds(EqualsProto(dataset.graph())));
+}
+
 TEST(WorkerIndexResolverTest, AddOneWorker) {
   WorkerIndexResolver resolver(std::vector<std::string>{"localhost"});
   EXPECT_THAT(resolver.GetWorkerIndex("localhost:12345"),
@@ -61,6 +61,7 @@ HANDLER(GetOrCreateJob);
 HANDLER(GetOrCreateIteration);
 HANDLER(ClientHeartbeat);
 HANDLER(GetWorkers);
+HANDLER(GetNumberOfWorkersEstimate);
 HANDLER(GetDataServiceMetadata);
 HANDLER(GetDataServiceConfig);
 HANDLER(Snapshot);
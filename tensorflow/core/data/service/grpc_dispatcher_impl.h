@@ -56,6 +56,7 @@ class GrpcDispatcherImpl : public DispatcherService::Service {
   HANDLER(GetOrCreateIteration);
   HANDLER(ClientHeartbeat);
   HANDLER(GetWorkers);
+  HANDLER(GetNumberOfWorkersEstimate);
   HANDLER(GetDataServiceMetadata);
   HANDLER(GetDataServiceConfig);
   HANDLER(Snapshot);
@@ -16,33 +16,54 @@ limitations under the License.
 #include "tensorflow/core/data/service/journal.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/service/journal.pb.h"
+#include "tensorflow/core/data/service/snapshot/file_utils.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/regexp.h"
+#include "tensorflow/core/platform/statusor.h"
 
 namespace tensorflow {
 namespace data {
 
 namespace {
 constexpr StringPiece kJournal = "journal";
+constexpr StringPiece kCheckpoint = "checkpoint";
+
+// Returns whether `file` is named "<prefix>_<n>", storing <n> in
+// `sequence_number`.
+bool ParseSequenceNumber(const std::string& file, StringPiece prefix,
+                         int64_t* sequence_number) {
+  return RE2::FullMatch(file, absl::StrCat(prefix, "_(\\d+)"),
+                        sequence_number);
+}
 
-Status ParseSequenceNumber(const std::string& journal_file,
-                           int64_t* sequence_number) {
-  if (!RE2::FullMatch(journal_file, ".*_(\\d+)", sequence_number)) {
-    return errors::InvalidArgument("Failed to parse journal file name: ",
-                                   journal_file);
+// Returns the largest sequence number of the files named "<prefix>_<n>" in
+// `journal_dir`, or -1 if there are none.
+StatusOr<int64_t> LatestSequenceNumber(Env* env, const std::string& journal_dir,
+                                       StringPiece prefix) {
+  std::vector<std::string> files;
+  TF_RETURN_IF_ERROR(env->GetChildren(journal_dir, &files));
+  int64_t latest_sequence_number = -1;
+  for (const auto& file : files) {
+    int64_t sequence_number;
+    if (ParseSequenceNumber(file, prefix, &sequence_number)) {
+      latest_sequence_number =
+          std::max(latest_sequence_number, sequence_number);
+    }
   }
-  return OkStatus();
+  return latest_sequence_number;
 }
 }  // namespace
 
@@ -52,6 +73,50 @@ std::string DataServiceJournalFile(const std::string& journal_dir,
                       absl::StrCat(kJournal, "_", sequence_number));
 }
 
+std::string DataServiceJournalCheckpointFile(const std::string& journal_dir,
+                                             int64_t sequence_number) {
+  return io::JoinPath(journal_dir,
+                      absl::StrCat(kCheckpoint, "_", sequence_number));
+}
+
+Status WriteDispatcherStateCheckpoint(
+    Env* env, const std::string& journal_dir,
+    const DispatcherStateCheckpoint& checkpoint) {
+  const int64_t sequence_number = checkpoint.journal_sequence_number();
+  TF_RETURN_IF_ERROR(AtomicallyWriteBinaryProto(
+      DataServiceJournalCheckpointFile(journal_dir, sequence_number),
+      checkpoint, env));
+  std::vector<std::string> files;
+  TF_RETURN_IF_ERROR(env->GetChildren(journal_dir, &files));
+  for (const auto& file : files) {
+    int64_t file_sequence_number;
+    if ((ParseSequenceNumber(file, kJournal, &file_sequence_number) ||
+         ParseSequenceNumber(file, kCheckpoint, &file_sequence_number)) &&
+        file_sequence_number < sequence_number) {
+      TF_RETURN_IF_ERROR(env->DeleteFile(io::JoinPath(journal_dir, file)));
+    }
+  }
+  VLOG(1) << "Wrote dispatcher state checkpoint with "
+          << checkpoint.updates_size() << " updates, covering journal files "
+          << "before " << sequence_number;
+  return OkStatus();
+}
+
+Status ReadLatestDispatcherStateCheckpoint(
+    Env* env, const std::string& journal_dir,
+    DispatcherStateCheckpoint& checkpoint) {
+  TF_RETURN_IF_ERROR(env->IsDirectory(journal_dir));
+  TF_ASSIGN_OR_RETURN(int64_t sequence_number,
+                      LatestSequenceNumber(env, journal_dir, kCheckpoint));
+  if (sequence_number < 0) {
+    return errors::NotFound("No dispatcher state checkpoint found in ",
+                            journal_dir);
+  }
+  return ReadBinaryProto(
+      env, DataServiceJournalCheckpointFile(journal_dir, sequence_number),
+      &checkpoint);
+}
+
 FileJournalWriter::FileJournalWriter(Env* env, const std::string& journal_dir)
     : env_(env), journal_dir_(journal_dir) {}
 
@@ -59,19 +124,27 @@ Status FileJournalWriter::EnsureInitialized() {
   if (writer_) {
     return OkStatus();
   }
-  std::vector<std::string> journal_files;
   TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(journal_dir_));
-  TF_RETURN_IF_ERROR(env_->GetChildren(journal_dir_, &journal_files));
-  int64_t latest_sequence_number = -1;
-  for (const auto& file : journal_files) {
-    int64_t sequence_number;
-    TF_RETURN_IF_ERROR(ParseSequenceNumber(file, &sequence_number));
-    latest_sequence_number = std::max(latest_sequence_number, sequence_number);
-  }
+  TF_ASSIGN_OR_RETURN(int64_t latest_sequence_number,
+                      LatestSequenceNumber(env_, journal_dir_, kJournal));
+  return OpenFile(latest_sequence_number + 1);
+}
+
+StatusOr<int64_t> FileJournalWriter::Rotate() {
+  TF_RETURN_IF_ERROR(EnsureInitialized());
+  TF_RETURN_IF_ERROR(writer_->Close());
+  writer_.reset();
+  TF_RETURN_IF_ERROR(file_->Close());
+  TF_RETURN_IF_ERROR(OpenFile(sequence_number_ + 1));
+  return sequence_number_;
+}
+
+Status FileJournalWriter::OpenFile(int64_t sequence_number) {
   std::string journal_file =
-      DataServiceJournalFile(journal_dir_, latest_sequence_number + 1);
+      DataServiceJournalFile(journal_dir_, sequence_number);
   TF_RETURN_IF_ERROR(env_->NewAppendableFile(journal_file, &file_));
   writer_ = std::make_unique<io::RecordWriter>(file_.get());
+  sequence_number_ = sequence_number;
   VLOG(1) << "Created journal writer to write to " << journal_file;
   return OkStatus();
 }
@@ -92,14 +165,17 @@ Status FileJournalWriter::Write(const Update& update) {
   return OkStatus();
 }
 
-FileJournalReader::FileJournalReader(Env* env, StringPiece journal_dir)
-    : env_(env), journal_dir_(journal_dir) {}
+FileJournalReader::FileJournalReader(Env* env, StringPiece journal_dir,
+                                     int64_t start_sequence_number)
+    : env_(env),
+      journal_dir_(journal_dir),
+      sequence_number_(start_sequence_number) {}
 
 Status FileJournalReader::EnsureInitialized() {
   if (reader_) {
     return OkStatus();
   }
-  return UpdateFile(DataServiceJournalFile(journal_dir_, 0));
+  return UpdateFile(DataServiceJournalFile(journal_dir_, sequence_number_));
 }
 
 Status FileJournalReader::Read(Update& update, bool& end_of_journal) {
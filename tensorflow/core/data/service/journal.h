@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_JOURNAL_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_JOURNAL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -23,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/statusor.h"
 
 namespace tensorflow {
 namespace data {
@@ -31,6 +33,23 @@ namespace data {
 std::string DataServiceJournalFile(const std::string& journal_dir,
                                    int64_t sequence_number);
 
+// Returns the location of the dispatcher state checkpoint which covers the
+// journal files before `sequence_number`.
+std::string DataServiceJournalCheckpointFile(const std::string& journal_dir,
+                                             int64_t sequence_number);
+
+// Atomically writes `checkpoint` to the journal directory, then deletes the
+// journal files and older checkpoints it covers.
+Status WriteDispatcherStateCheckpoint(
+    Env* env, const std::string& journal_dir,
+    const DispatcherStateCheckpoint& checkpoint);
+
+// Reads the latest dispatcher state checkpoint in the journal directory.
+// Returns NOT_FOUND if there is no checkpoint.
+Status ReadLatestDispatcherStateCheckpoint(
+    Env* env, const std::string& journal_dir,
+    DispatcherStateCheckpoint& checkpoint);
+
 // Interface for writing to a journal.
 class JournalWriter {
  public:
@@ -39,6 +58,10 @@ class JournalWriter {
   virtual Status Write(const Update& update) = 0;
   // Initializes the writer if it is not yet initialized.
   virtual Status EnsureInitialized() = 0;
+  // Starts writing to a new journal file, so that the journal files before it
+  // can be compacted into a checkpoint. Returns the sequence number of the new
+  // journal file.
+  virtual StatusOr<int64_t> Rotate() = 0;
 };
 
 // FileJournalWriter is not thread-safe, requiring external synchronization when
@@ -57,6 +80,9 @@ class JournalWriter {
 // "journal_0", "journal_1", and "journal_2", the writer will write to
 // "journal_3". The writer will flush updates as they are written, so that they
 // can be stored durably in case of machine failure.
+//
+// The directory may also contain dispatcher state checkpoints, named
+// "checkpoint_<n>", which replace the journal files before "journal_<n>".
 class FileJournalWriter : public JournalWriter {
  public:
   // Creates a journal writer to write to the given journal directory.
@@ -68,10 +94,16 @@ class FileJournalWriter : public JournalWriter {
 
   Status Write(const Update& update) override;
   Status EnsureInitialized() override;
+  StatusOr<int64_t> Rotate() override;
 
  private:
+  // Opens journal file `sequence_number` for writing.
+  Status OpenFile(int64_t sequence_number);
+
   Env* env_;
   const std::string journal_dir_;
+  // Sequence number of current journal file.
+  int64_t sequence_number_ = -1;
   std::unique_ptr<WritableFile> file_;
   std::unique_ptr<io::RecordWriter> writer_;
 };
@@ -89,10 +121,12 @@ class JournalReader {
 // used by multiple threads.
 //
 // The journal reader reads through all journal files in the configured journal
-// directory, in order of their sequence numbers. See FileJournalWriter above.
+// directory starting from `start_sequence_number`, in order of their sequence
+// numbers. See FileJournalWriter above.
 class FileJournalReader : public JournalReader {
  public:
-  explicit FileJournalReader(Env* env, StringPiece journal_dir);
+  explicit FileJournalReader(Env* env, StringPiece journal_dir,
+                             int64_t start_sequence_number = 0);
   FileJournalReader(const FileJournalReader&) = delete;
   FileJournalReader& operator=(const FileJournalReader&) = delete;
 
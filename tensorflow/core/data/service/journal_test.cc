@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/service/journal.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/data_service.pb.h"
 
@@ -68,8 +70,9 @@ Update MakeRegisterDatasetUpdate() {
 }
 
 Status CheckJournalContent(StringPiece journal_dir,
-                           const std::vector<Update>& expected) {
-  FileJournalReader reader(Env::Default(), journal_dir);
+                           const std::vector<Update>& expected,
+                           int64_t start_sequence_number = 0) {
+  FileJournalReader reader(Env::Default(), journal_dir, start_sequence_number);
   for (const auto& update : expected) {
     Update result;
     bool end_of_journal = true;
@@ -115,6 +118,49 @@ TEST(Journal, AppendExistingJournal) {
   TF_EXPECT_OK(CheckJournalContent(journal_dir, updates));
 }
 
+TEST(Journal, Checkpoint) {
+  std::string journal_dir;
+  EXPECT_TRUE(NewJournalDir(journal_dir));
+  FileJournalWriter writer(Env::Default(), journal_dir);
+  TF_ASSERT_OK(writer.Write(MakeCreateIterationUpdate()));
+  TF_ASSERT_OK(writer.Write(MakeRegisterDatasetUpdate()));
+  TF_ASSERT_OK_AND_ASSIGN(int64_t sequence_number, writer.Rotate());
+  EXPECT_EQ(sequence_number, 1);
+  TF_ASSERT_OK(writer.Write(MakeFinishTaskUpdate()));
+
+  DispatcherStateCheckpoint checkpoint;
+  *checkpoint.add_updates() = MakeRegisterDatasetUpdate();
+  checkpoint.set_journal_sequence_number(sequence_number);
+  TF_ASSERT_OK(WriteDispatcherStateCheckpoint(Env::Default(), journal_dir,
+                                              checkpoint));
+  EXPECT_TRUE(absl::IsNotFound(Env::Default()->FileExists(
+      DataServiceJournalFile(journal_dir, /*sequence_number=*/0))));
+
+  DispatcherStateCheckpoint restored;
+  TF_ASSERT_OK(ReadLatestDispatcherStateCheckpoint(Env::Default(),
+                                                   journal_dir, restored));
+  EXPECT_EQ(restored.SerializeAsString(), checkpoint.SerializeAsString());
+  TF_EXPECT_OK(CheckJournalContent(journal_dir, {MakeFinishTaskUpdate()},
+                                   restored.journal_sequence_number()));
+
+  // A new writer appends to the journal after the checkpoint.
+  FileJournalWriter new_writer(Env::Default(), journal_dir);
+  TF_ASSERT_OK(new_writer.Write(MakeCreateIterationUpdate()));
+  TF_EXPECT_OK(CheckJournalContent(
+      journal_dir, {MakeFinishTaskUpdate(), MakeCreateIterationUpdate()},
+      restored.journal_sequence_number()));
+}
+
+TEST(Journal, NoCheckpoint) {
+  std::string journal_dir;
+  EXPECT_TRUE(NewJournalDir(journal_dir));
+  FileJournalWriter writer(Env::Default(), journal_dir);
+  TF_ASSERT_OK(writer.Write(MakeCreateIterationUpdate()));
+  DispatcherStateCheckpoint checkpoint;
+  EXPECT_TRUE(absl::IsNotFound(ReadLatestDispatcherStateCheckpoint(
+      Env::Default(), journal_dir, checkpoint)));
+}
+
 TEST(Journal, MissingFile) {
   std::string journal_dir;
   EXPECT_TRUE(NewJournalDir(journal_dir));
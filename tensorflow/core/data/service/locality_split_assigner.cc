@@ -0,0 +1,125 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/locality_split_assigner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+
+SplitLocalityFn MakeSplitLocalityFn(
+    const experimental::DispatcherConfig& config) {
+  absl::flat_hash_map<std::string, std::string> localities;
+  for (const auto& hint : config.split_locality_hints()) {
+    localities[hint.split_prefix()] = hint.locality();
+  }
+  return [localities = std::move(localities)](const Tensor& split) {
+    if (split.dims() != 0) {
+      return std::string();
+    }
+    if (split.dtype() == DT_INT64) {
+      auto it = localities.find(absl::StrCat(split.scalar<int64_t>()()));
+      return it == localities.end() ? std::string() : it->second;
+    }
+    if (split.dtype() != DT_STRING) {
+      return std::string();
+    }
+    const absl::string_view split_string = split.scalar<tstring>()();
+    size_t longest_prefix = 0;
+    std::string locality;
+    for (const auto& [prefix, prefix_locality] : localities) {
+      if (prefix.size() >= longest_prefix &&
+          absl::StartsWith(split_string, prefix)) {
+        longest_prefix = prefix.size();
+        locality = prefix_locality;
+      }
+    }
+    return locality;
+  };
+}
+
+LocalitySplitAssigner::LocalitySplitAssigner(SplitProvider* split_provider,
+                                             SplitLocalityFn locality_fn,
+                                             int64_t max_lookahead)
+    : split_provider_(split_provider),
+      locality_fn_(std::move(locality_fn)),
+      max_lookahead_(std::max<int64_t>(max_lookahead, 1)) {}
+
+Status LocalitySplitAssigner::GetNext(
+    const std::vector<std::string>& worker_tags, Tensor* split,
+    bool* end_of_splits) {
+  auto is_local = [&worker_tags](const PendingSplit& pending_split) {
+    return !pending_split.locality.empty() &&
+           absl::c_linear_search(worker_tags, pending_split.locality);
+  };
+  *end_of_splits = false;
+
+  auto it = absl::c_find_if(pending_splits_, is_local);
+  if (it != pending_splits_.end()) {
+    *split = std::move(it->split);
+    pending_splits_.erase(it);
+    return OkStatus();
+  }
+
+  while (!provider_end_of_splits_ &&
+         static_cast<int64_t>(pending_splits_.size()) < max_lookahead_) {
+    PendingSplit pending_split;
+    TF_RETURN_IF_ERROR(split_provider_->GetNext(&pending_split.split,
+                                                &provider_end_of_splits_));
+    if (provider_end_of_splits_) {
+      break;
+    }
+    pending_split.locality = locality_fn_(pending_split.split);
+    if (is_local(pending_split)) {
+      *split = std::move(pending_split.split);
+      return OkStatus();
+    }
+    pending_splits_.push_back(std::move(pending_split));
+  }
+
+  // There is no local split. Steals the oldest split so that it is not left
+  // behind by the other workers.
+  if (!pending_splits_.empty()) {
+    *split = std::move(pending_splits_.front().split);
+    pending_splits_.pop_front();
+    return OkStatus();
+  }
+  *end_of_splits = true;
+  return OkStatus();
+}
+
+Status LocalitySplitAssigner::Reset() {
+  pending_splits_.clear();
+  provider_end_of_splits_ = false;
+  return split_provider_->Reset();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,89 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_LOCALITY_SPLIT_ASSIGNER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_LOCALITY_SPLIT_ASSIGNER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+
+// The default number of splits a `LocalitySplitAssigner` reads ahead of the
+// split provider to find splits local to the requesting worker.
+constexpr int64_t kDefaultMaxSplitLookahead = 16;
+
+// Returns the locality of the data of `split`, e.g. the zone or rack where its
+// files are stored, or an empty string if it is unknown.
+using SplitLocalityFn = std::function<std::string(const Tensor& split)>;
+
+// Makes a `SplitLocalityFn` from the `split_locality_hints` of `config`. String
+// splits match the longest hint that is a prefix of the split. Integer splits
+// match the hint equal to their decimal representation.
+SplitLocalityFn MakeSplitLocalityFn(
+    const experimental::DispatcherConfig& config);
+
+// Hands out the splits of a `SplitProvider`, preferring splits whose data is
+// local to the requesting worker. A worker is local to a split if one of its
+// tags is the locality of the split.
+//
+// The assigner reads up to `max_lookahead` splits ahead of the split provider.
+// A worker without local splits takes the oldest split that has not been
+// assigned, so each split is assigned exactly once and workers do not idle
+// while there are splits left.
+//
+// This class is not thread-safe.
+class LocalitySplitAssigner {
+ public:
+  // Does not take ownership of `split_provider`, which must outlive *this.
+  LocalitySplitAssigner(SplitProvider* split_provider,
+                        SplitLocalityFn locality_fn,
+                        int64_t max_lookahead = kDefaultMaxSplitLookahead);
+
+  // Gets the next split for the worker with `worker_tags`. Sets
+  // `end_of_splits` if all splits have been assigned.
+  Status GetNext(const std::vector<std::string>& worker_tags, Tensor* split,
+                 bool* end_of_splits);
+
+  // Resets the split provider and drops the splits that have been read ahead.
+  Status Reset();
+
+ private:
+  struct PendingSplit {
+    Tensor split;
+    std::string locality;
+  };
+
+  SplitProvider* const split_provider_;
+  const SplitLocalityFn locality_fn_;
+  const int64_t max_lookahead_;
+
+  // Splits read from `split_provider_` but not yet assigned, oldest first.
+  std::deque<PendingSplit> pending_splits_;
+  bool provider_end_of_splits_ = false;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_LOCALITY_SPLIT_ASSIGNER_H_
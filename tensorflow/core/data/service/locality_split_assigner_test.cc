@@ -0,0 +1,141 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/locality_split_assigner.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/data/split_utils.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAreArray;
+
+// Even splits are in "zone-a", odd splits are in "zone-b".
+std::string EvenOddLocality(const Tensor& split) {
+  return split.scalar<int64_t>()() % 2 == 0 ? "zone-a" : "zone-b";
+}
+
+StatusOr<int64_t> GetNext(LocalitySplitAssigner& assigner,
+                          const std::vector<std::string>& worker_tags) {
+  Tensor split;
+  bool end_of_splits = false;
+  TF_RETURN_IF_ERROR(assigner.GetNext(worker_tags, &split, &end_of_splits));
+  if (end_of_splits) {
+    return -1;
+  }
+  return split.scalar<int64_t>()();
+}
+
+TEST(LocalitySplitAssignerTest, PrefersLocalSplits) {
+  IndexSplitProvider split_provider(10);
+  LocalitySplitAssigner assigner(&split_provider, EvenOddLocality);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 1);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 3);
+  EXPECT_EQ(GetNext(assigner, {"zone-a"}).value(), 0);
+  EXPECT_EQ(GetNext(assigner, {"COLOCATED", "zone-a"}).value(), 2);
+  EXPECT_EQ(GetNext(assigner, {"zone-a"}).value(), 4);
+}
+
+TEST(LocalitySplitAssignerTest, StealsOldestSplit) {
+  IndexSplitProvider split_provider(10);
+  LocalitySplitAssigner assigner(&split_provider, EvenOddLocality,
+                                 /*max_lookahead=*/4);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 1);
+  // The worker has no local split, so it takes the oldest one.
+  EXPECT_EQ(GetNext(assigner, {"zone-c"}).value(), 0);
+  EXPECT_EQ(GetNext(assigner, {}).value(), 2);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 3);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 5);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 7);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 9);
+  // Once the odd splits run out, the zone-b worker steals the even ones.
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 4);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 6);
+}
+
+TEST(LocalitySplitAssignerTest, AssignsEachSplitOnce) {
+  const int64_t num_splits = 20;
+  IndexSplitProvider split_provider(num_splits);
+  LocalitySplitAssigner assigner(&split_provider, EvenOddLocality,
+                                 /*max_lookahead=*/3);
+  const std::vector<std::vector<std::string>> workers = {
+      {"zone-a"}, {"zone-a"}, {"zone-a"}, {"zone-b"}, {}};
+  std::vector<int64_t> splits;
+  for (int64_t i = 0;; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(int64_t split,
+                            GetNext(assigner, workers[i % workers.size()]));
+    if (split == -1) {
+      break;
+    }
+    splits.push_back(split);
+  }
+
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < num_splits; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_THAT(splits, UnorderedElementsAreArray(expected));
+  EXPECT_EQ(GetNext(assigner, {"zone-a"}).value(), -1);
+}
+
+TEST(LocalitySplitAssignerTest, Reset) {
+  IndexSplitProvider split_provider(3);
+  LocalitySplitAssigner assigner(&split_provider, EvenOddLocality);
+  EXPECT_EQ(GetNext(assigner, {"zone-b"}).value(), 1);
+  TF_ASSERT_OK(assigner.Reset());
+  std::vector<int64_t> splits;
+  for (int i = 0; i < 4; ++i) {
+    splits.push_back(GetNext(assigner, {"zone-c"}).value());
+  }
+  EXPECT_THAT(splits, ElementsAre(0, 1, 2, -1));
+}
+
+TEST(LocalitySplitAssignerTest, SplitLocalityFnFromConfig) {
+  experimental::DispatcherConfig config;
+  auto* hint = config.add_split_locality_hints();
+  hint->set_split_prefix("/data/zone-a/");
+  hint->set_locality("zone-a");
+  hint = config.add_split_locality_hints();
+  hint->set_split_prefix("/data/zone-a/rack-1/");
+  hint->set_locality("rack-1");
+  hint = config.add_split_locality_hints();
+  hint->set_split_prefix("3");
+  hint->set_locality("zone-b");
+  SplitLocalityFn locality_fn = MakeSplitLocalityFn(config);
+
+  EXPECT_EQ(locality_fn(test::AsScalar<tstring>("/data/zone-a/file")),
+            "zone-a");
+  EXPECT_EQ(locality_fn(test::AsScalar<tstring>("/data/zone-a/rack-1/file")),
+            "rack-1");
+  EXPECT_EQ(locality_fn(test::AsScalar<tstring>("/data/zone-c/file")), "");
+  EXPECT_EQ(locality_fn(test::AsScalar<int64_t>(3)), "zone-b");
+  EXPECT_EQ(locality_fn(test::AsScalar<int64_t>(30)), "");
+  EXPECT_EQ(locality_fn(test::AsTensor<int64_t>({3})), "");
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,855 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/shm_data_transfer.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/framework/variant.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tsl/platform/errors.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kSegmentPrefix[] = "/tf_data_service_";
+constexpr uint32_t kControlMagic = 0x74664453;
+constexpr uint32_t kControlVersion = 1;
+// Maximum number of clients that can be connected to a worker at a time.
+constexpr int kMaxClients = 64;
+constexpr size_t kMaxRequestBytes = 4096;
+constexpr size_t kInitialDataBytes = 1 << 20;
+// Interval at which blocked parties wake up to check for cancellation,
+// shutdown, or an unresponsive peer.
+constexpr int64_t kWaitIntervalMs = 100;
+// A worker that has not updated its heartbeat for this long is considered
+// dead.
+constexpr int64_t kHeartbeatTimeoutUs = 10 * 1000 * 1000;
+// Channel ids double as the transfer server port, so they are picked in the
+// range of valid ports.
+constexpr int kMinChannelId = 10000;
+constexpr int kNumChannelIds = 50000;
+constexpr int kMaxCreateAttempts = 100;
+
+enum SlotState : int32_t {
+  // Not claimed by any client.
+  kFree = 0,
+  // Claimed by a client, with no request in flight.
+  kIdle = 1,
+  // The client wrote a request that the worker has not answered yet.
+  kRequestPending = 2,
+  // The worker wrote the response to the latest request.
+  kResponseReady = 3,
+  // The client went away while a request was in flight. The worker frees the
+  // slot once it is done with the request.
+  kAbandoned = 4,
+};
+
+struct Slot {
+  // Signaled whenever `state` changes.
+  pthread_cond_t cv;
+  int32_t state;
+  uint32_t request_bytes;
+  // Incremented each time the worker replaces the data segment of the slot.
+  uint64_t data_generation;
+  uint64_t response_bytes;
+  char request[kMaxRequestBytes];
+};
+
+// The control segment shared by a worker and all of its clients. All fields
+// are guarded by `mu`.
+struct ControlBlock {
+  uint32_t magic;
+  uint32_t version;
+  pthread_mutex_t mu;
+  // Signaled when a client claims a slot or when the worker shuts down.
+  pthread_cond_t cv;
+  int32_t shutdown;
+  int64_t server_heartbeat_us;
+  Slot slots[kMaxClients];
+};
+
+enum ComponentEncoding : int32_t {
+  // The tensor buffer, for types that support memcpy.
+  kRawBuffer = 0,
+  // A serialized `CompressedElement` proto.
+  kCompressedElement = 1,
+  // A serialized `TensorProto`, for all other tensors.
+  kTensorProto = 2,
+};
+
+struct ResponseHeader {
+  int32_t status_code;
+  uint32_t message_bytes;
+  int64_t element_index;
+  uint8_t end_of_sequence;
+  uint8_t skip;
+  uint16_t unused;
+  uint32_t num_components;
+};
+
+struct ComponentHeader {
+  int32_t encoding;
+  int32_t dtype;
+  int32_t rank;
+  int32_t unused;
+  uint64_t payload_bytes;
+};
+
+size_t AlignTo(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+std::string ControlSegmentName(int channel_id) {
+  return absl::StrCat(kSegmentPrefix, channel_id);
+}
+
+std::string DataSegmentName(int channel_id, int slot, uint64_t generation) {
+  return absl::StrCat(kSegmentPrefix, channel_id, "_", slot, "_", generation);
+}
+
+// A memory-mapped POSIX shared memory segment. The process that creates the
+// segment removes its name when the segment is destroyed; existing mappings
+// remain valid until they are unmapped.
+class SharedMemorySegment {
+ public:
+  static StatusOr<std::unique_ptr<SharedMemorySegment>> Create(
+      const std::string& name, size_t size) {
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      return errors::IOError(absl::StrCat("creating shared memory ", name),
+                             errno);
+    }
+    if (ftruncate(fd, size) != 0) {
+      Status s = errors::IOError(
+          absl::StrCat("resizing shared memory ", name, " to ", size), errno);
+      close(fd);
+      shm_unlink(name.c_str());
+      return s;
+    }
+    StatusOr<std::unique_ptr<SharedMemorySegment>> segment =
+        Map(name, fd, size, /*owner=*/true);
+    if (!segment.ok()) {
+      shm_unlink(name.c_str());
+    }
+    return segment;
+  }
+
+  static StatusOr<std::unique_ptr<SharedMemorySegment>> Open(
+      const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      return errors::IOError(absl::StrCat("opening shared memory ", name),
+                             errno);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      Status s =
+          errors::IOError(absl::StrCat("querying shared memory ", name), errno);
+      close(fd);
+      return s;
+    }
+    return Map(name, fd, st.st_size, /*owner=*/false);
+  }
+
+  ~SharedMemorySegment() {
+    munmap(data_, size_);
+    if (owner_) {
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  SharedMemorySegment(std::string name, char* data, size_t size, bool owner)
+      : name_(std::move(name)), data_(data), size_(size), owner_(owner) {}
+
+  // Maps the segment open in `fd` and closes `fd`.
+  static StatusOr<std::unique_ptr<SharedMemorySegment>> Map(
+      const std::string& name, int fd, size_t size, bool owner) {
+    void* data =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int mmap_errno = errno;
+    close(fd);
+    if (data == MAP_FAILED) {
+      return errors::IOError(absl::StrCat("mapping shared memory ", name),
+                             mmap_errno);
+    }
+    return absl::WrapUnique(new SharedMemorySegment(
+        name, static_cast<char*>(data), size, owner));
+  }
+
+  const std::string name_;
+  char* const data_;
+  const size_t size_;
+  const bool owner_;
+};
+
+// Locks a process-shared robust mutex. If a process died while holding the
+// mutex, the state it protects is still usable since every update of the
+// control block is a single field assignment, so the mutex is marked
+// consistent again.
+class ShmMutexLock {
+ public:
+  explicit ShmMutexLock(pthread_mutex_t* mu) : mu_(mu) {
+    if (pthread_mutex_lock(mu_) == EOWNERDEAD) {
+      pthread_mutex_consistent(mu_);
+    }
+  }
+  ~ShmMutexLock() { pthread_mutex_unlock(mu_); }
+
+  ShmMutexLock(const ShmMutexLock&) = delete;
+  ShmMutexLock& operator=(const ShmMutexLock&) = delete;
+
+ private:
+  pthread_mutex_t* const mu_;
+};
+
+// Waits on `cv` for up to `kWaitIntervalMs`. `mu` must be locked.
+void WaitForInterval(pthread_cond_t* cv, pthread_mutex_t* mu) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  int64_t nsec = deadline.tv_nsec + kWaitIntervalMs * 1000 * 1000;
+  deadline.tv_sec += nsec / 1000000000;
+  deadline.tv_nsec = nsec % 1000000000;
+  if (pthread_cond_timedwait(cv, mu, &deadline) == EOWNERDEAD) {
+    pthread_mutex_consistent(mu);
+  }
+}
+
+void InitializeControlBlock(ControlBlock* control) {
+  memset(control, 0, sizeof(ControlBlock));
+  pthread_mutexattr_t mutex_attr;
+  pthread_mutexattr_init(&mutex_attr);
+  pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(&control->mu, &mutex_attr);
+  pthread_mutexattr_destroy(&mutex_attr);
+
+  pthread_condattr_t cv_attr;
+  pthread_condattr_init(&cv_attr);
+  pthread_condattr_setpshared(&cv_attr, PTHREAD_PROCESS_SHARED);
+  pthread_condattr_setclock(&cv_attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&control->cv, &cv_attr);
+  for (Slot& slot : control->slots) {
+    pthread_cond_init(&slot.cv, &cv_attr);
+    slot.state = kFree;
+  }
+  pthread_condattr_destroy(&cv_attr);
+  control->version = kControlVersion;
+  control->magic = kControlMagic;
+}
+
+// A `GetElementResult` (or error) laid out for writing into shared memory.
+class EncodedResponse {
+ public:
+  EncodedResponse(const Status& status, const GetElementResult& result) {
+    if (!status.ok()) {
+      Reset(status);
+      return;
+    }
+    header_.element_index = result.element_index;
+    header_.end_of_sequence = result.end_of_sequence;
+    header_.skip = result.skip;
+    header_.num_components = result.components.size();
+    size_ = AlignTo(sizeof(ResponseHeader), alignof(int64_t));
+    components_.reserve(result.components.size());
+    for (const Tensor& tensor : result.components) {
+      Component& component = components_.emplace_back();
+      component.tensor = &tensor;
+      if (DataTypeCanUseMemcpy(tensor.dtype())) {
+        component.encoding = kRawBuffer;
+        component.payload_bytes = tensor.TotalBytes();
+      } else if (tensor.dtype() == DT_VARIANT && tensor.NumElements() == 1 &&
+                 tensor.scalar<Variant>()().get<CompressedElement>()) {
+        component.encoding = kCompressedElement;
+        component.compressed =
+            tensor.scalar<Variant>()().get<CompressedElement>();
+        component.payload_bytes = component.compressed->ByteSizeLong();
+      } else {
+        component.encoding = kTensorProto;
+        tensor.AsProtoTensorContent(&component.proto);
+        component.payload_bytes = component.proto.ByteSizeLong();
+      }
+      size_ += sizeof(ComponentHeader) + tensor.dims() * sizeof(int64_t);
+      size_ = AlignTo(size_, Allocator::kAllocatorAlignment);
+      component.payload_offset = size_;
+      size_ = AlignTo(size_ + component.payload_bytes, alignof(int64_t));
+    }
+  }
+
+  // Replaces the response with `status`.
+  void Reset(const Status& status) {
+    components_.clear();
+    header_ = ResponseHeader();
+    header_.status_code = static_cast<int32_t>(status.code());
+    message_ = std::string(status.message());
+    header_.message_bytes = message_.size();
+    size_ = sizeof(ResponseHeader) + message_.size();
+  }
+
+  size_t size() const { return size_; }
+
+  // Writes the response to `dst`, which must have room for `size()` bytes.
+  void WriteTo(char* dst) const {
+    memcpy(dst, &header_, sizeof(ResponseHeader));
+    if (!message_.empty()) {
+      memcpy(dst + sizeof(ResponseHeader), message_.data(), message_.size());
+      return;
+    }
+    size_t offset = AlignTo(sizeof(ResponseHeader), alignof(int64_t));
+    for (const Component& component : components_) {
+      ComponentHeader component_header = {};
+      component_header.encoding = component.encoding;
+      component_header.dtype = component.tensor->dtype();
+      component_header.rank = component.tensor->dims();
+      component_header.payload_bytes = component.payload_bytes;
+      memcpy(dst + offset, &component_header, sizeof(ComponentHeader));
+      offset += sizeof(ComponentHeader);
+      for (int64_t dim : component.tensor->shape().dim_sizes()) {
+        memcpy(dst + offset, &dim, sizeof(int64_t));
+        offset += sizeof(int64_t);
+      }
+      char* payload = dst + component.payload_offset;
+      switch (component.encoding) {
+        case kRawBuffer:
+          if (component.payload_bytes > 0) {
+            memcpy(payload, component.tensor->tensor_data().data(),
+                   component.payload_bytes);
+          }
+          break;
+        case kCompressedElement:
+          component.compressed->SerializeToArray(payload,
+                                                 component.payload_bytes);
+          break;
+        case kTensorProto:
+          component.proto.SerializeToArray(payload, component.payload_bytes);
+          break;
+      }
+      offset = AlignTo(component.payload_offset + component.payload_bytes,
+                       alignof(int64_t));
+    }
+  }
+
+ private:
+  struct Component {
+    ComponentEncoding encoding;
+    const Tensor* tensor = nullptr;
+    const CompressedElement* compressed = nullptr;
+    TensorProto proto;
+    size_t payload_bytes = 0;
+    size_t payload_offset = 0;
+  };
+
+  ResponseHeader header_ = {};
+  std::string message_;
+  std::vector<Component> components_;
+  size_t size_ = 0;
+};
+
+// Parses the response written by `EncodedResponse::WriteTo` into `result`.
+Status DecodeResponse(const char* data, size_t size,
+                      GetElementResult& result) {
+  auto check_bounds = [size](size_t offset, size_t bytes) {
+    if (offset > size || bytes > size - offset) {
+      return errors::DataLoss("Truncated shared memory response of ", size,
+                              " bytes.");
+    }
+    return OkStatus();
+  };
+  ResponseHeader header;
+  TF_RETURN_IF_ERROR(check_bounds(0, sizeof(ResponseHeader)));
+  memcpy(&header, data, sizeof(ResponseHeader));
+  if (header.status_code != static_cast<int32_t>(absl::StatusCode::kOk)) {
+    TF_RETURN_IF_ERROR(
+        check_bounds(sizeof(ResponseHeader), header.message_bytes));
+    return Status(static_cast<absl::StatusCode>(header.status_code),
+                  absl::string_view(data + sizeof(ResponseHeader),
+                                    header.message_bytes));
+  }
+  result.element_index = header.element_index;
+  result.end_of_sequence = header.end_of_sequence;
+  result.skip = header.skip;
+  result.components.clear();
+  result.components.reserve(header.num_components);
+  size_t offset = AlignTo(sizeof(ResponseHeader), alignof(int64_t));
+  for (uint32_t i = 0; i < header.num_components; ++i) {
+    ComponentHeader component_header;
+    TF_RETURN_IF_ERROR(check_bounds(offset, sizeof(ComponentHeader)));
+    memcpy(&component_header, data + offset, sizeof(ComponentHeader));
+    offset += sizeof(ComponentHeader);
+    if (component_header.rank < 0 ||
+        component_header.rank > TensorShape::MaxDimensions()) {
+      return errors::DataLoss("Invalid rank ", component_header.rank,
+                              " in shared memory response.");
+    }
+    std::vector<int64_t> dims(component_header.rank);
+    TF_RETURN_IF_ERROR(check_bounds(offset, dims.size() * sizeof(int64_t)));
+    memcpy(dims.data(), data + offset, dims.size() * sizeof(int64_t));
+    offset = AlignTo(offset + dims.size() * sizeof(int64_t),
+                     Allocator::kAllocatorAlignment);
+    TF_RETURN_IF_ERROR(check_bounds(offset, component_header.payload_bytes));
+    const char* payload = data + offset;
+    const DataType dtype = static_cast<DataType>(component_header.dtype);
+    switch (component_header.encoding) {
+      case kRawBuffer: {
+        if (!DataTypeCanUseMemcpy(dtype)) {
+          return errors::DataLoss("Unexpected raw buffer of type ",
+                                  DataTypeString(dtype),
+                                  " in shared memory response.");
+        }
+        TensorShape shape;
+        TF_RETURN_IF_ERROR(TensorShape::BuildTensorShape(dims, &shape));
+        Tensor tensor(dtype, shape);
+        if (tensor.TotalBytes() != component_header.payload_bytes) {
+          return errors::DataLoss(
+              "Expected ", tensor.TotalBytes(), " bytes for tensor of shape ",
+              shape.DebugString(), ", got ", component_header.payload_bytes);
+        }
+        if (component_header.payload_bytes > 0) {
+          memcpy(tensor.data(), payload, component_header.payload_bytes);
+        }
+        result.components.push_back(std::move(tensor));
+        break;
+      }
+      case kCompressedElement: {
+        CompressedElement compressed;
+        if (!compressed.ParseFromArray(payload,
+                                       component_header.payload_bytes)) {
+          return errors::DataLoss("Failed to parse compressed element.");
+        }
+        Tensor tensor(DT_VARIANT, TensorShape{});
+        tensor.scalar<Variant>()() = std::move(compressed);
+        result.components.push_back(std::move(tensor));
+        break;
+      }
+      case kTensorProto: {
+        TensorProto proto;
+        if (!proto.ParseFromArray(payload, component_header.payload_bytes)) {
+          return errors::DataLoss("Failed to parse tensor proto.");
+        }
+        result.components.emplace_back();
+        if (!result.components.back().FromProto(proto)) {
+          return errors::DataLoss("Failed to parse tensor.");
+        }
+        break;
+      }
+      default:
+        return errors::DataLoss("Unknown component encoding ",
+                                component_header.encoding,
+                                " in shared memory response.");
+    }
+    offset = AlignTo(offset + component_header.payload_bytes,
+                     alignof(int64_t));
+  }
+  return OkStatus();
+}
+
+class ShmDataTransferServer : public DataTransferServer {
+ public:
+  explicit ShmDataTransferServer(GetElementT get_element)
+      : get_element_(std::move(get_element)) {}
+
+  ~ShmDataTransferServer() override {
+    if (control_ == nullptr) {
+      return;
+    }
+    {
+      ShmMutexLock l(&control_->mu);
+      control_->shutdown = 1;
+      pthread_cond_broadcast(&control_->cv);
+      for (Slot& slot : control_->slots) {
+        pthread_cond_broadcast(&slot.cv);
+      }
+    }
+    // Joins the threads before unmapping the control segment.
+    accept_thread_.reset();
+    for (auto& thread : slot_threads_) {
+      thread.reset();
+    }
+  }
+
+  Status Start() override {
+    for (int attempt = 0; attempt < kMaxCreateAttempts; ++attempt) {
+      int channel_id = kMinChannelId + random::New64() % kNumChannelIds;
+      StatusOr<std::unique_ptr<SharedMemorySegment>> segment =
+          SharedMemorySegment::Create(ControlSegmentName(channel_id),
+                                      sizeof(ControlBlock));
+      if (absl::IsAlreadyExists(segment.status())) {
+        continue;
+      }
+      TF_RETURN_IF_ERROR(segment.status());
+      control_segment_ = std::move(segment).value();
+      channel_id_ = channel_id;
+      break;
+    }
+    if (control_segment_ == nullptr) {
+      return errors::ResourceExhausted(
+          "Failed to find an unused shared memory channel after ",
+          kMaxCreateAttempts, " attempts.");
+    }
+    control_ = reinterpret_cast<ControlBlock*>(control_segment_->data());
+    InitializeControlBlock(control_);
+    control_->server_heartbeat_us = Env::Default()->NowMicros();
+    accept_thread_ = absl::WrapUnique(Env::Default()->StartThread(
+        {}, "tf_data_shm_accept", [this]() { AcceptLoop(); }));
+    VLOG(1) << "Started shared memory data transfer server on channel "
+            << channel_id_;
+    return OkStatus();
+  }
+
+  int Port() const override { return channel_id_; }
+
+  StatusOr<std::string> GetCompatibilityInfo() const override {
+    return port::Hostname();
+  }
+
+ private:
+  // Starts a thread for each newly claimed slot and keeps the heartbeat fresh.
+  void AcceptLoop() {
+    ShmMutexLock l(&control_->mu);
+    while (!control_->shutdown) {
+      control_->server_heartbeat_us = Env::Default()->NowMicros();
+      for (int i = 0; i < kMaxClients; ++i) {
+        if (control_->slots[i].state == kFree || serving_[i]) {
+          continue;
+        }
+        // A previous thread for this slot has exited, or is about to.
+        slot_threads_[i].reset();
+        serving_[i] = true;
+        slot_threads_[i] = absl::WrapUnique(Env::Default()->StartThread(
+            {}, absl::StrCat("tf_data_shm_slot_", i),
+            [this, i]() { ServeSlot(i); }));
+      }
+      WaitForInterval(&control_->cv, &control_->mu);
+    }
+  }
+
+  // Answers the requests of the client that claimed slot `index` until it
+  // disconnects or the server shuts down.
+  void ServeSlot(int index) {
+    Slot& slot = control_->slots[index];
+    std::unique_ptr<SharedMemorySegment> data;
+    uint64_t generation = 0;
+    // Failures are retried, and reported, once the first response is ready.
+    EnsureCapacity(index, kInitialDataBytes, data, generation).IgnoreError();
+    while (true) {
+      GetElementRequest request;
+      bool parsed;
+      {
+        ShmMutexLock l(&control_->mu);
+        while (!control_->shutdown && slot.state != kRequestPending &&
+               slot.state != kFree) {
+          WaitForInterval(&slot.cv, &control_->mu);
+        }
+        if (control_->shutdown || slot.state == kFree) {
+          break;
+        }
+        parsed = request.ParseFromArray(slot.request, slot.request_bytes);
+      }
+      GetElementResult result;
+      Status status = parsed ? get_element_(&request, &result)
+                             : errors::InvalidArgument(
+                                   "Failed to parse GetElementRequest.");
+      EncodedResponse response(status, result);
+      Status s = EnsureCapacity(index, response.size(), data, generation);
+      if (!s.ok()) {
+        response.Reset(s);
+      }
+      if (data == nullptr) {
+        LOG(ERROR) << "Failed to allocate shared memory for slot " << index
+                   << ": " << s;
+        ShmMutexLock l(&control_->mu);
+        slot.state = kFree;
+        pthread_cond_broadcast(&slot.cv);
+        break;
+      }
+      response.WriteTo(data->data());
+      {
+        ShmMutexLock l(&control_->mu);
+        slot.data_generation = generation;
+        slot.response_bytes = response.size();
+        if (slot.state == kAbandoned) {
+          slot.state = kFree;
+          break;
+        }
+        slot.state = kResponseReady;
+        pthread_cond_broadcast(&slot.cv);
+      }
+    }
+    serving_[index] = false;
+  }
+
+  // Makes sure that `data` has room for `bytes` bytes, replacing it with a
+  // larger segment of the next generation if needed.
+  Status EnsureCapacity(int index, size_t bytes,
+                        std::unique_ptr<SharedMemorySegment>& data,
+                        uint64_t& generation) {
+    if (data != nullptr && data->size() >= bytes) {
+      return OkStatus();
+    }
+    size_t capacity = std::max(bytes, kInitialDataBytes);
+    if (data != nullptr) {
+      capacity = std::max(capacity, 2 * data->size());
+    }
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<SharedMemorySegment> new_data,
+        SharedMemorySegment::Create(
+            DataSegmentName(channel_id_, index, generation + 1), capacity));
+    data = std::move(new_data);
+    ++generation;
+    return OkStatus();
+  }
+
+  const GetElementT get_element_;
+  int channel_id_ = -1;
+  std::unique_ptr<SharedMemorySegment> control_segment_;
+  ControlBlock* control_ = nullptr;
+  std::unique_ptr<Thread> accept_thread_;
+  // Only accessed by the accept thread, and by the destructor after joining
+  // it.
+  std::unique_ptr<Thread> slot_threads_[kMaxClients];
+  std::atomic<bool> serving_[kMaxClients] = {};
+};
+
+class ShmDataTransferClient : public DataTransferClient {
+ public:
+  static StatusOr<std::unique_ptr<ShmDataTransferClient>> Create(
+      absl::string_view address) {
+    int channel_id;
+    size_t port_start = address.rfind(':');
+    if (port_start == absl::string_view::npos ||
+        !absl::SimpleAtoi(address.substr(port_start + 1), &channel_id)) {
+      return errors::InvalidArgument(
+          "Failed to parse shared memory channel from worker address ",
+          address);
+    }
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<SharedMemorySegment> control_segment,
+        SharedMemorySegment::Open(ControlSegmentName(channel_id)));
+    if (control_segment->size() < sizeof(ControlBlock)) {
+      return errors::FailedPrecondition("Shared memory channel ", channel_id,
+                                        " has an unexpected size.");
+    }
+    auto* control = reinterpret_cast<ControlBlock*>(control_segment->data());
+    if (control->magic != kControlMagic ||
+        control->version != kControlVersion) {
+      return errors::FailedPrecondition(
+          "Shared memory channel ", channel_id,
+          " was not created by a compatible tf.data service worker.");
+    }
+    ShmMutexLock l(&control->mu);
+    if (control->shutdown) {
+      return errors::Unavailable("Worker on shared memory channel ",
+                                 channel_id, " has shut down.");
+    }
+    for (int i = 0; i < kMaxClients; ++i) {
+      if (control->slots[i].state == kFree) {
+        control->slots[i].state = kIdle;
+        pthread_cond_broadcast(&control->cv);
+        return absl::WrapUnique(new ShmDataTransferClient(
+            channel_id, std::move(control_segment), i));
+      }
+    }
+    return errors::ResourceExhausted(
+        "All ", kMaxClients, " slots of shared memory channel ", channel_id,
+        " are in use.");
+  }
+
+  ~ShmDataTransferClient() override {
+    ShmMutexLock l(&control_->mu);
+    Slot& slot = control_->slots[slot_index_];
+    slot.state = slot.state == kRequestPending ? kAbandoned : kFree;
+    pthread_cond_broadcast(&slot.cv);
+  }
+
+  Status GetElement(const GetElementRequest& req,
+                    GetElementResult& result) override {
+    VLOG(3) << "GetElement for task " << req.task_id()
+            << " from shared memory worker channel " << channel_id_ << ".";
+    mutex_lock l(mu_);
+    if (cancelled_) {
+      return errors::Cancelled("Client was cancelled.");
+    }
+    const size_t request_bytes = req.ByteSizeLong();
+    if (request_bytes > kMaxRequestBytes) {
+      return errors::InvalidArgument("GetElementRequest of ", request_bytes,
+                                     " bytes exceeds the limit of ",
+                                     kMaxRequestBytes, " bytes.");
+    }
+    int64_t start_time_us = env_->NowMicros();
+    uint64_t generation;
+    size_t response_bytes;
+    {
+      ShmMutexLock sl(&control_->mu);
+      Slot& slot = control_->slots[slot_index_];
+      if (control_->shutdown || slot.state != kIdle) {
+        return errors::Unavailable("Worker on shared memory channel ",
+                                   channel_id_, " is no longer serving.");
+      }
+      req.SerializeToArray(slot.request, kMaxRequestBytes);
+      slot.request_bytes = request_bytes;
+      slot.state = kRequestPending;
+      pthread_cond_broadcast(&slot.cv);
+      while (slot.state == kRequestPending) {
+        if (cancelled_) {
+          return errors::Cancelled("Client was cancelled.");
+        }
+        if (control_->shutdown) {
+          return errors::Unavailable("Worker on shared memory channel ",
+                                     channel_id_, " has shut down.");
+        }
+        if (env_->NowMicros() - control_->server_heartbeat_us >
+            kHeartbeatTimeoutUs) {
+          return errors::Unavailable("Worker on shared memory channel ",
+                                     channel_id_, " is unresponsive.");
+        }
+        WaitForInterval(&slot.cv, &control_->mu);
+      }
+      generation = slot.data_generation;
+      response_bytes = slot.response_bytes;
+      // The worker only writes to the data segment after the next request.
+      slot.state = kIdle;
+    }
+    if (data_segment_ == nullptr || generation != data_generation_) {
+      TF_ASSIGN_OR_RETURN(data_segment_,
+                          SharedMemorySegment::Open(DataSegmentName(
+                              channel_id_, slot_index_, generation)));
+      data_generation_ = generation;
+    }
+    if (response_bytes > data_segment_->size()) {
+      return errors::DataLoss("Shared memory response of ", response_bytes,
+                              " bytes exceeds its segment of ",
+                              data_segment_->size(), " bytes.");
+    }
+    TF_RETURN_IF_ERROR(
+        DecodeResponse(data_segment_->data(), response_bytes, result));
+    metrics::RecordTFDataServiceGetElementDuration(
+        kShmTransferProtocol, env_->NowMicros() - start_time_us);
+    return OkStatus();
+  }
+
+  void TryCancel() override {
+    VLOG(2) << "Cancel ShmDataTransferClient for channel " << channel_id_
+            << ".";
+    cancelled_ = true;
+  }
+
+  StatusOr<std::string> GetCompatibilityInfo() const override {
+    return port::Hostname();
+  }
+
+  Status CheckCompatibility(
+      const std::string& server_compatibility_info) const override {
+    if (server_compatibility_info != port::Hostname()) {
+      return errors::FailedPrecondition(
+          "The shared memory data transfer protocol requires the worker to "
+          "run on the same host as the client, but the worker runs on ",
+          server_compatibility_info, " and the client runs on ",
+          port::Hostname(), ".");
+    }
+    return OkStatus();
+  }
+
+ private:
+  ShmDataTransferClient(int channel_id,
+                        std::unique_ptr<SharedMemorySegment> control_segment,
+                        int slot_index)
+      : channel_id_(channel_id),
+        control_segment_(std::move(control_segment)),
+        control_(reinterpret_cast<ControlBlock*>(control_segment_->data())),
+        slot_index_(slot_index) {
+    VLOG(2) << "Create ShmDataTransferClient for channel " << channel_id_
+            << " using slot " << slot_index_ << ".";
+  }
+
+  const int channel_id_;
+  const std::unique_ptr<SharedMemorySegment> control_segment_;
+  ControlBlock* const control_;
+  const int slot_index_;
+  std::atomic<bool> cancelled_ = false;
+
+  // Serializes requests, since a slot holds one request at a time.
+  mutex mu_;
+  std::unique_ptr<SharedMemorySegment> data_segment_ TF_GUARDED_BY(mu_);
+  uint64_t data_generation_ TF_GUARDED_BY(mu_) = 0;
+};
+
+class ShmTransferRegistrar {
+ public:
+  ShmTransferRegistrar() {
+    DataTransferServer::Register(
+        kShmTransferProtocol,
+        [](DataTransferServer::GetElementT get_element,
+           std::shared_ptr<DataTransferServer>* out) {
+          *out = std::make_shared<ShmDataTransferServer>(std::move(get_element));
+          return OkStatus();
+        });
+    DataTransferClient::Register(
+        kShmTransferProtocol, [](DataTransferClient::Config config,
+                                 std::unique_ptr<DataTransferClient>* out) {
+          TF_ASSIGN_OR_RETURN(*out,
+                              ShmDataTransferClient::Create(config.address));
+          return OkStatus();
+        });
+  }
+};
+static ShmTransferRegistrar shm_transfer_registrar;
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // defined(__linux__)
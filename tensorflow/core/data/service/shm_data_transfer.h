@@ -0,0 +1,39 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_SHM_DATA_TRANSFER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_SHM_DATA_TRANSFER_H_
+
+namespace tensorflow {
+namespace data {
+
+// Data transfer protocol that passes elements between a tf.data service worker
+// and clients running on the same host through POSIX shared memory, avoiding
+// the protobuf serialization and loopback network costs of gRPC.
+//
+// The worker creates a control segment holding one slot per connected client.
+// A client claims a slot, writes its serialized `GetElementRequest` into it,
+// and the worker writes the response into a data segment dedicated to the slot,
+// which grows as needed to fit the largest element. Tensors whose types
+// support memcpy are written as raw buffers, compressed elements are written as
+// serialized `CompressedElement` protos.
+//
+// The protocol is only registered on Linux. Clients fall back to gRPC when the
+// worker runs on a different host.
+constexpr const char kShmTransferProtocol[] = "shm";
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_SHM_DATA_TRANSFER_H_
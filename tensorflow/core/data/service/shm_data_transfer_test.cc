@@ -0,0 +1,186 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/shm_data_transfer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/variant.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tsl::testing::StatusIs;
+
+class ShmDataTransferTest : public ::testing::Test {
+ protected:
+  // Starts a server that answers each request with `get_element`, and
+  // connects a client to it.
+  void StartServer(DataTransferServer::GetElementT get_element) {
+    TF_ASSERT_OK(DataTransferServer::Build(kShmTransferProtocol,
+                                           std::move(get_element), &server_));
+    TF_ASSERT_OK(server_->Start());
+    TF_ASSERT_OK(DataTransferClient::Build(
+        kShmTransferProtocol,
+        {/*protocol=*/"grpc", absl::StrCat("localhost:", server_->Port())},
+        &client_));
+  }
+
+  std::shared_ptr<DataTransferServer> server_;
+  std::unique_ptr<DataTransferClient> client_;
+};
+
+TEST_F(ShmDataTransferTest, GetElements) {
+  StartServer([](const GetElementRequest* request, GetElementResult* result) {
+    result->components.push_back(
+        test::AsTensor<int64_t>({request->task_id(), 2 * request->task_id()}));
+    result->components.push_back(test::AsScalar<tstring>("element"));
+    result->element_index = request->task_id();
+    return OkStatus();
+  });
+  for (int64_t task_id = 0; task_id < 10; ++task_id) {
+    GetElementRequest request;
+    request.set_task_id(task_id);
+    GetElementResult result;
+    TF_ASSERT_OK(client_->GetElement(request, result));
+    EXPECT_FALSE(result.end_of_sequence);
+    EXPECT_EQ(result.element_index, task_id);
+    ASSERT_EQ(result.components.size(), 2);
+    test::ExpectEqual(result.components[0],
+                      test::AsTensor<int64_t>({task_id, 2 * task_id}));
+    test::ExpectEqual(result.components[1], test::AsScalar<tstring>("element"));
+  }
+}
+
+TEST_F(ShmDataTransferTest, EndOfSequence) {
+  StartServer([](const GetElementRequest* request, GetElementResult* result) {
+    result->end_of_sequence = true;
+    return OkStatus();
+  });
+  GetElementResult result;
+  TF_ASSERT_OK(client_->GetElement(GetElementRequest(), result));
+  EXPECT_TRUE(result.end_of_sequence);
+  EXPECT_TRUE(result.components.empty());
+}
+
+TEST_F(ShmDataTransferTest, CompressedElement) {
+  std::vector<Tensor> element = {test::AsTensor<int32_t>({1, 2, 3}),
+                                 test::AsScalar<tstring>("compressed")};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, &compressed));
+  StartServer([&compressed](const GetElementRequest* request,
+                            GetElementResult* result) {
+    Tensor tensor(DT_VARIANT, TensorShape({}));
+    tensor.scalar<Variant>()() = compressed;
+    result->components.push_back(std::move(tensor));
+    return OkStatus();
+  });
+
+  GetElementResult result;
+  TF_ASSERT_OK(client_->GetElement(GetElementRequest(), result));
+  ASSERT_EQ(result.components.size(), 1);
+  const CompressedElement* received =
+      result.components[0].scalar<Variant>()().get<CompressedElement>();
+  ASSERT_NE(received, nullptr);
+  std::vector<Tensor> uncompressed;
+  TF_ASSERT_OK(UncompressElement(*received, &uncompressed));
+  ASSERT_EQ(uncompressed.size(), 2);
+  test::ExpectEqual(uncompressed[0], element[0]);
+  test::ExpectEqual(uncompressed[1], element[1]);
+}
+
+TEST_F(ShmDataTransferTest, ElementsLargerThanSegment) {
+  StartServer([](const GetElementRequest* request, GetElementResult* result) {
+    Tensor tensor(DT_FLOAT, TensorShape({request->task_id(), 1024}));
+    tensor.flat<float>().setConstant(request->task_id());
+    result->components.push_back(std::move(tensor));
+    return OkStatus();
+  });
+  // The elements grow up to 4MB, past the initial segment size.
+  for (int64_t rows : {1, 512, 1024, 16, 1025}) {
+    GetElementRequest request;
+    request.set_task_id(rows);
+    GetElementResult result;
+    TF_ASSERT_OK(client_->GetElement(request, result));
+    ASSERT_EQ(result.components.size(), 1);
+    Tensor expected(DT_FLOAT, TensorShape({rows, 1024}));
+    expected.flat<float>().setConstant(rows);
+    test::ExpectEqual(result.components[0], expected);
+  }
+}
+
+TEST_F(ShmDataTransferTest, PropagatesErrors) {
+  StartServer([](const GetElementRequest* request, GetElementResult* result) {
+    return errors::NotFound("Task ", request->task_id(), " not found.");
+  });
+  GetElementRequest request;
+  request.set_task_id(7);
+  GetElementResult result;
+  EXPECT_THAT(client_->GetElement(request, result),
+              StatusIs(error::NOT_FOUND, HasSubstr("Task 7 not found.")));
+}
+
+TEST_F(ShmDataTransferTest, Cancel) {
+  StartServer([](const GetElementRequest* request, GetElementResult* result) {
+    result->end_of_sequence = true;
+    return OkStatus();
+  });
+  client_->TryCancel();
+  GetElementResult result;
+  EXPECT_THAT(client_->GetElement(GetElementRequest(), result),
+              StatusIs(error::CANCELLED));
+}
+
+TEST_F(ShmDataTransferTest, RequiresSameHost) {
+  StartServer([](const GetElementRequest* request, GetElementResult* result) {
+    result->end_of_sequence = true;
+    return OkStatus();
+  });
+  TF_ASSERT_OK_AND_ASSIGN(std::string server_info,
+                          server_->GetCompatibilityInfo());
+  TF_EXPECT_OK(client_->CheckCompatibility(server_info));
+  EXPECT_THAT(client_->CheckCompatibility(absl::StrCat(port::Hostname(), "-2")),
+              StatusIs(error::FAILED_PRECONDITION));
+}
+
+TEST(ShmDataTransferClientTest, NoServer) {
+  std::unique_ptr<DataTransferClient> client;
+  EXPECT_THAT(DataTransferClient::Build(kShmTransferProtocol,
+                                        {/*protocol=*/"grpc", "localhost:1"},
+                                        &client),
+              StatusIs(error::NOT_FOUND));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -43,6 +43,7 @@ limitations under the License.
 #include "tsl/platform/env.h"
 #include "tsl/platform/mutex.h"
 #include "tsl/platform/path.h"
+#include "tsl/platform/threadpool.h"
 #include "tsl/profiler/lib/traceme.h"
 
 namespace tensorflow {
@@ -51,6 +52,9 @@ namespace {
 
 constexpr int64_t kTFRecordReaderOutputBufferSize = 512 << 20;  // 512MB
 constexpr int64_t kUnknownNumElements = -1;
+// Maximum size of the elements produced by the iterator but not yet written.
+// A single element larger than this is still accepted.
+constexpr int64_t kMaxBufferedBytes = 512 << 20;  // 512MB
 
 // Extracts the index from the `filename` of an uncommitted chunk. The chunk
 // file name is expected to be chunk_<chunk_index>.
@@ -73,6 +77,10 @@ SnapshotStreamWriter::SnapshotStreamWriter(
     : params_(params), iterator_(std::move(iterator)) {
   DCHECK_NE(iterator_.get(), nullptr);
   last_commit_time_ = absl::FromUnixMicros(params_.env->NowMicros());
+  // One thread per chunk write, and one for the commits.
+  thread_pool_ = std::make_unique<tsl::thread::ThreadPool>(
+      params_.env, "tf_data_service_snapshot_chunk_writer",
+      std::max<int64_t>(params_.num_parallel_chunk_writes, 1) + 1);
   snapshot_thread_ = absl::WrapUnique(params_.env->StartThread(
       /*thread_options=*/{}, /*name=*/"tf_data_service_snapshot_thread",
       [this]() { WriteSnapshotAndLog(); }));
@@ -112,11 +120,15 @@ absl::Status SnapshotStreamWriter::WriteSnapshot() TF_LOCKS_EXCLUDED(mu_) {
   // TODO(b/258691097): Write the "LEASE" file periodically.
   TF_RETURN_IF_ERROR(InitializeDirectories());
   TF_RETURN_IF_ERROR(Restore());
-  while (ShouldWriteChunk()) {
-    TF_RETURN_IF_ERROR(WriteChunk());
+  absl::Status status;
+  while (status.ok() && ShouldWriteChunk()) {
+    status = WriteChunk();
   }
+  // Chunk writes and commits always finish before the stream is finalized.
+  status.Update(WaitForChunkWrites());
   mutex_lock l(mu_);
-  return completed_.status();
+  TF_RETURN_IF_ERROR(completed_.status());
+  return status;
 }
 
 bool SnapshotStreamWriter::StreamAlreadyCompleted() const {
@@ -135,7 +147,7 @@ absl::Status SnapshotStreamWriter::InitializeDirectories() {
 
 bool SnapshotStreamWriter::ShouldWriteChunk() const TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock l(mu_);
-  return !end_of_sequence_ && completed_.ok();
+  return !end_of_sequence_ && completed_.ok() && write_status_.ok();
 }
 
 absl::Status SnapshotStreamWriter::WriteChunk() {
@@ -143,16 +155,32 @@ absl::Status SnapshotStreamWriter::WriteChunk() {
             << ", stream " << params_.stream_index << ", chunk " << chunk_index_
             << ".";
 
-  std::string uncommitted_chunk_file_path =
-      tsl::io::JoinPath(params_.UncommittedChunksDirectory(),
-                        absl::StrCat("chunk_", chunk_index_));
-  snapshot_util::TFRecordWriter writer(
-      TranslateFileName(uncommitted_chunk_file_path), params_.compression);
-  TF_RETURN_IF_ERROR(writer.Initialize(params_.env));
-  while (ShouldWriteRecord()) {
-    TF_RETURN_IF_ERROR(WriteRecord(writer));
+  auto chunk_write = std::make_shared<ChunkWrite>();
+  chunk_write->chunk_index = chunk_index_;
+  {
+    mutex_lock l(mu_);
+    while (NumChunkWritesInFlight() >=
+               std::max<int64_t>(params_.num_parallel_chunk_writes, 1) &&
+           completed_.ok() && write_status_.ok()) {
+      cv_.wait(l);
+    }
+    TF_RETURN_IF_ERROR(completed_.status());
+    TF_RETURN_IF_ERROR(write_status_);
+    chunk_writes_[chunk_index_] = chunk_write;
   }
-  TF_RETURN_IF_ERROR(writer.Close());
+  thread_pool_->Schedule(
+      [this, chunk_write]() { RunChunkWrite(*chunk_write); });
+
+  absl::Status status;
+  while (status.ok() && ShouldWriteRecord()) {
+    status = WriteRecord(*chunk_write);
+  }
+  {
+    mutex_lock l(mu_);
+    chunk_write->all_elements_added = true;
+    cv_.notify_all();
+  }
+  TF_RETURN_IF_ERROR(status);
   chunk_file_to_num_elements_[absl::StrCat("chunk_", chunk_index_)] =
       chunk_num_elements_;
   if (ShouldCommit()) {
@@ -165,6 +193,73 @@ absl::Status SnapshotStreamWriter::WriteChunk() {
   return absl::OkStatus();
 }
 
+void SnapshotStreamWriter::RunChunkWrite(ChunkWrite& chunk_write)
+    TF_LOCKS_EXCLUDED(mu_) {
+  absl::Status status = WriteChunkFile(chunk_write);
+  mutex_lock l(mu_);
+  // Drops the elements left after a failure.
+  for (const auto& [unused, size] : chunk_write.elements) {
+    buffered_bytes_ -= size;
+  }
+  chunk_write.elements.clear();
+  chunk_write.done = true;
+  write_status_.Update(status);
+  cv_.notify_all();
+}
+
+absl::Status SnapshotStreamWriter::WriteChunkFile(ChunkWrite& chunk_write)
+    TF_LOCKS_EXCLUDED(mu_) {
+  std::string uncommitted_chunk_file_path =
+      tsl::io::JoinPath(params_.UncommittedChunksDirectory(),
+                        absl::StrCat("chunk_", chunk_write.chunk_index));
+  snapshot_util::TFRecordWriter writer(
+      TranslateFileName(uncommitted_chunk_file_path), params_.compression);
+  TF_RETURN_IF_ERROR(writer.Initialize(params_.env));
+  while (true) {
+    std::vector<Tensor> element;
+    {
+      mutex_lock l(mu_);
+      while (chunk_write.elements.empty() && !chunk_write.all_elements_added &&
+             completed_.ok() && write_status_.ok()) {
+        cv_.wait(l);
+      }
+      TF_RETURN_IF_ERROR(completed_.status());
+      TF_RETURN_IF_ERROR(write_status_);
+      if (chunk_write.elements.empty()) {
+        break;
+      }
+      element = std::move(chunk_write.elements.front().first);
+      buffered_bytes_ -= chunk_write.elements.front().second;
+      chunk_write.elements.pop_front();
+      cv_.notify_all();
+    }
+    tsl::profiler::TraceMe activity("SnapshotWriteRecord",
+                                    tsl::profiler::TraceMeLevel::kInfo);
+    TF_RETURN_IF_ERROR(writer.WriteTensors(element));
+  }
+  return writer.Close();
+}
+
+int64_t SnapshotStreamWriter::NumChunkWritesInFlight() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  int64_t num_chunk_writes = 0;
+  for (const auto& [unused, chunk_write] : chunk_writes_) {
+    if (!chunk_write->done) {
+      ++num_chunk_writes;
+    }
+  }
+  return num_chunk_writes;
+}
+
+absl::Status SnapshotStreamWriter::WaitForChunkWrites()
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  while (commit_in_progress_ || NumChunkWritesInFlight() > 0) {
+    cv_.wait(l);
+  }
+  return write_status_;
+}
+
 bool SnapshotStreamWriter::ShouldCommit() const {
   {
     mutex_lock l(mu_);
@@ -178,57 +273,111 @@ bool SnapshotStreamWriter::ShouldCommit() const {
 }
 
 absl::Status SnapshotStreamWriter::Commit() {
-  // Writes the checkpoint before committing the chunks. If the worker fails in
-  // between, the restarted worker will commit the uncommitted chunks.
-  TF_RETURN_IF_ERROR(Save());
-  TF_ASSIGN_OR_RETURN(
-      std::vector<std::string> uncommitted_chunks,
-      GetChildren(params_.UncommittedChunksDirectory(), params_.env));
-  if (uncommitted_chunks.size() != chunk_file_to_num_elements_.size()) {
-    return absl::InternalError(absl::StrCat(
-        "Failed to write tf.data snapshot: Expected ",
-        chunk_file_to_num_elements_.size(), " uncommitted chunks, but got ",
-        uncommitted_chunks.size(), "."));
-  }
-  // Commits all chunks since the last commit.
-  for (int64_t i = 0; i < uncommitted_chunks.size(); ++i) {
-    const std::string& uncommitted_chunk = uncommitted_chunks[i];
-    TF_ASSIGN_OR_RETURN(int64_t chunk_index,
-                        GetUncommittedChunkIndex(uncommitted_chunk));
-    if (chunk_index <= chunk_index_) {
-      std::string uncommitted_chunk_path = tsl::io::JoinPath(
-          params_.UncommittedChunksDirectory(), uncommitted_chunk);
-      std::string committed_chunk_path = tsl::io::JoinPath(
-          params_.CommittedChunksDirectory(),
-          absl::StrCat("chunk_", params_.stream_index, "_", chunk_index, "_",
-                       chunk_file_to_num_elements_[uncommitted_chunk]));
-      TF_RETURN_IF_ERROR(params_.env->RenameFile(uncommitted_chunk_path,
-                                                 committed_chunk_path));
+  // The iterator state is saved now, since the iterator moves on to the next
+  // chunks while this chunk is being written.
+  TF_ASSIGN_OR_RETURN(std::vector<Tensor> serialized_iterator,
+                      iterator_->Save());
+  {
+    mutex_lock l(mu_);
+    while (commit_in_progress_ && completed_.ok() && write_status_.ok()) {
+      cv_.wait(l);
     }
+    TF_RETURN_IF_ERROR(completed_.status());
+    TF_RETURN_IF_ERROR(write_status_);
+    commit_in_progress_ = true;
   }
+  thread_pool_->Schedule(
+      [this, chunk_index = chunk_index_,
+       chunk_num_elements = chunk_num_elements_,
+       serialized_iterator = std::move(serialized_iterator),
+       chunks = std::move(chunk_file_to_num_elements_)]() {
+        absl::Status status = CommitChunks(chunk_index, chunk_num_elements,
+                                           serialized_iterator, chunks);
+        mutex_lock l(mu_);
+        write_status_.Update(status);
+        commit_in_progress_ = false;
+        cv_.notify_all();
+      });
   last_committed_chunk_ = chunk_index_;
   last_commit_time_ = absl::FromUnixMicros(params_.env->NowMicros());
   chunk_file_to_num_elements_.clear();
   return absl::OkStatus();
 }
 
+absl::Status SnapshotStreamWriter::CommitChunks(
+    int64_t chunk_index, int64_t chunk_num_elements,
+    const std::vector<Tensor>& serialized_iterator,
+    const absl::flat_hash_map<std::string, int64_t>& chunks)
+    TF_LOCKS_EXCLUDED(mu_) {
+  {
+    mutex_lock l(mu_);
+    while (completed_.ok()) {
+      bool chunks_written = true;
+      for (const auto& [index, chunk_write] : chunk_writes_) {
+        if (index <= chunk_index && !chunk_write->done) {
+          chunks_written = false;
+        }
+      }
+      if (chunks_written) {
+        break;
+      }
+      cv_.wait(l);
+    }
+    TF_RETURN_IF_ERROR(completed_.status());
+    TF_RETURN_IF_ERROR(write_status_);
+    absl::erase_if(chunk_writes_, [chunk_index](const auto& chunk_write) {
+      return chunk_write.first <= chunk_index;
+    });
+  }
+
+  // Writes the checkpoint before committing the chunks. If the worker fails in
+  // between, the restarted worker will commit the uncommitted chunks.
+  TF_RETURN_IF_ERROR(
+      Save(chunk_index, chunk_num_elements, serialized_iterator));
+  // Commits all chunks since the last commit. Chunks after `chunk_index` may
+  // be in the uncommitted directory and are committed by the next commit.
+  for (const auto& [uncommitted_chunk, num_elements] : chunks) {
+    TF_ASSIGN_OR_RETURN(int64_t uncommitted_chunk_index,
+                        GetUncommittedChunkIndex(uncommitted_chunk));
+    std::string uncommitted_chunk_path = tsl::io::JoinPath(
+        params_.UncommittedChunksDirectory(), uncommitted_chunk);
+    std::string committed_chunk_path = tsl::io::JoinPath(
+        params_.CommittedChunksDirectory(),
+        absl::StrCat("chunk_", params_.stream_index, "_",
+                     uncommitted_chunk_index, "_", num_elements));
+    TF_RETURN_IF_ERROR(
+        params_.env->RenameFile(uncommitted_chunk_path, committed_chunk_path));
+  }
+  return absl::OkStatus();
+}
+
 bool SnapshotStreamWriter::ShouldWriteRecord() const TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock l(mu_);
   return chunk_size_bytes_ < params_.max_chunk_size_bytes &&
-         !end_of_sequence_ && completed_.ok();
+         !end_of_sequence_ && completed_.ok() && write_status_.ok();
 }
 
-absl::Status SnapshotStreamWriter::WriteRecord(
-    snapshot_util::TFRecordWriter& writer) {
+absl::Status SnapshotStreamWriter::WriteRecord(ChunkWrite& chunk_write) {
   std::vector<Tensor> element;
   TF_RETURN_IF_ERROR(iterator_->GetNext(element, end_of_sequence_));
   if (end_of_sequence_) {
-    return writer.Close();
+    return absl::OkStatus();
   }
-  tsl::profiler::TraceMe activity("SnapshotWriteRecord",
-                                  tsl::profiler::TraceMeLevel::kInfo);
-  TF_RETURN_IF_ERROR(writer.WriteTensors(element));
-  chunk_size_bytes_ += EstimatedSizeBytes(element);
+  const int64_t element_size = EstimatedSizeBytes(element);
+  mutex_lock l(mu_);
+  // Bounds the memory of the elements waiting to be written. Each buffered
+  // element belongs to a chunk write that has a thread, so this makes progress.
+  while (buffered_bytes_ > 0 &&
+         buffered_bytes_ + element_size > kMaxBufferedBytes &&
+         completed_.ok() && write_status_.ok()) {
+    cv_.wait(l);
+  }
+  TF_RETURN_IF_ERROR(completed_.status());
+  TF_RETURN_IF_ERROR(write_status_);
+  chunk_write.elements.emplace_back(std::move(element), element_size);
+  buffered_bytes_ += element_size;
+  cv_.notify_all();
+  chunk_size_bytes_ += element_size;
   ++chunk_num_elements_;
   return absl::OkStatus();
 }
@@ -279,31 +428,31 @@ void SnapshotStreamWriter::Cancel() TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock l(mu_);
   completed_ = absl::CancelledError(
       "The tf.data service snapshot writer has been cancelled.");
+  cv_.notify_all();
 }
 
-absl::Status SnapshotStreamWriter::Save() {
+absl::Status SnapshotStreamWriter::Save(
+    int64_t chunk_index, int64_t chunk_num_elements,
+    const std::vector<Tensor>& serialized_iterator) {
   LOG(INFO) << "Checkpointing distributed tf.data snapshot writer for snapshot "
             << params_.DebugString() << ". Stream " << params_.stream_index
-            << ", chunk " << chunk_index_
-            << ", chunk size in bytes: " << chunk_size_bytes_
-            << ", number of elements in chunk: " << chunk_num_elements_ << ".";
+            << ", chunk " << chunk_index
+            << ", number of elements in chunk: " << chunk_num_elements << ".";
   tsl::profiler::TraceMe activity("SnapshotCheckpoint",
                                   tsl::profiler::TraceMeLevel::kInfo);
   absl::Time start_time = absl::FromUnixMicros(params_.env->NowMicros());
-  std::string checkpoint_path =
-      CheckpointPath(chunk_index_, chunk_num_elements_);
-  TF_ASSIGN_OR_RETURN(std::vector<Tensor> serialized_iterator,
-                      iterator_->Save());
+  std::string checkpoint_path = CheckpointPath(chunk_index, chunk_num_elements);
   TF_RETURN_IF_ERROR(AtomicallyWriteTFRecords(
       checkpoint_path, serialized_iterator, params_.compression, params_.env));
   absl::Time end_time = absl::FromUnixMicros(params_.env->NowMicros());
   LOG(INFO) << "Wrote checkpoint file " << checkpoint_path << ". "
             << "Checkpointing distributed tf.data snapshot writer took "
             << (end_time - start_time);
-  return DeleteOutdatedCheckpoints();
+  return DeleteOutdatedCheckpoints(chunk_index);
 }
 
-absl::Status SnapshotStreamWriter::DeleteOutdatedCheckpoints() {
+absl::Status SnapshotStreamWriter::DeleteOutdatedCheckpoints(
+    int64_t chunk_index) {
   if (params_.test_only_keep_temp_files) {
     return absl::OkStatus();
   }
@@ -322,7 +471,7 @@ absl::Status SnapshotStreamWriter::DeleteOutdatedCheckpoints() {
     TF_ASSIGN_OR_RETURN(auto checkpoint_filename_tokens,
                         ParseCheckpointFilename(checkpoint_filename));
     auto [checkpoint_index, unused] = checkpoint_filename_tokens;
-    if (checkpoint_index < chunk_index_) {
+    if (checkpoint_index < chunk_index) {
       TF_RETURN_IF_ERROR(params_.env->DeleteFile(checkpoint_filepath));
     }
   }
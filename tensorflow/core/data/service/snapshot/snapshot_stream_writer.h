@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -37,12 +38,14 @@ limitations under the License.
 #include "tsl/platform/env.h"
 #include "tsl/platform/mutex.h"
 #include "tsl/platform/thread_annotations.h"
+#include "tsl/platform/threadpool.h"
 
 namespace tensorflow {
 namespace data {
 
 constexpr int64_t kDefaultMaxChunkSizeBytes = 2 * (size_t{1} << 30);  // 2GB
 constexpr absl::Duration kDefaultCheckpointInterval = absl::Minutes(20);
+constexpr int64_t kDefaultNumParallelChunkWrites = 4;
 
 struct SnapshotWriterParams {
   // The directory path of the snapshot. See the comment on SnapshotStreamWriter
@@ -69,6 +72,11 @@ struct SnapshotWriterParams {
   // snapshot. Used only for unit testing.
   bool test_only_keep_temp_files = false;
 
+  // The maximum number of chunks written in parallel. Elements are produced
+  // sequentially, but a chunk is serialized, compressed and written while the
+  // next chunks are being produced, and committed while writing continues.
+  int64_t num_parallel_chunk_writes = kDefaultNumParallelChunkWrites;
+
   std::string StreamDirectory() const {
     return tensorflow::data::StreamDirectory(snapshot_path, stream_index);
   }
@@ -113,6 +121,11 @@ struct SnapshotWriterParams {
 //       - checkpoints
 //         - checkpoint_<chunk_index>_<num_elements>
 //
+// Up to `num_parallel_chunk_writes` chunks are written at a time by a thread
+// pool. A checkpoint for a chunk is only written once the chunk and all chunks
+// before it are fully written, so a restarted writer never commits a partially
+// written chunk.
+//
 // This class is thread-safe.
 class SnapshotStreamWriter {
  public:
@@ -157,16 +170,48 @@ class SnapshotStreamWriter {
   // cancelled.
   bool ShouldWriteChunk() const;
 
-  // Writes the next chunk.
+  // A chunk being written by `thread_pool_`. The snapshot thread adds the
+  // elements produced by the iterator, which are written in the background.
+  struct ChunkWrite {
+    int64_t chunk_index = 0;
+    // Elements not yet written, with their estimated sizes.
+    std::deque<std::pair<std::vector<Tensor>, int64_t>> elements;
+    // True once the snapshot thread has added all the elements of the chunk.
+    bool all_elements_added = false;
+    // True once the chunk file is closed or writing it has failed.
+    bool done = false;
+  };
+
+  // Produces the next chunk and starts writing it in the background.
   absl::Status WriteChunk();
 
+  // Writes `chunk_write` to its uncommitted chunk file. Runs on `thread_pool_`.
+  void RunChunkWrite(ChunkWrite& chunk_write) TF_LOCKS_EXCLUDED(mu_);
+  absl::Status WriteChunkFile(ChunkWrite& chunk_write) TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the number of chunks that are not done writing.
+  int64_t NumChunkWritesInFlight() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Waits for the chunk writes and commits in progress to finish, and returns
+  // the first error of any of them.
+  absl::Status WaitForChunkWrites() TF_LOCKS_EXCLUDED(mu_);
+
   // Whether the current chunks should be committed. This writer performs one
   // commit every ~20 minutes.
   bool ShouldCommit() const;
 
-  // Commits the chunks since the last commit.
+  // Saves the iterator state and starts committing the chunks since the last
+  // commit in the background.
   absl::Status Commit();
 
+  // Waits for the chunks up to `chunk_index` to be written, writes the
+  // iterator checkpoint and then commits `chunks`. Runs on `thread_pool_`.
+  absl::Status CommitChunks(
+      int64_t chunk_index, int64_t chunk_num_elements,
+      const std::vector<Tensor>& serialized_iterator,
+      const absl::flat_hash_map<std::string, int64_t>& chunks)
+      TF_LOCKS_EXCLUDED(mu_);
+
   // Returns the path of the current chunk.
   std::string GetChunkFilePath() const;
   std::string GetCommittedChunkFilePath() const;
@@ -175,8 +220,8 @@ class SnapshotStreamWriter {
   // chunk.
   bool ShouldWriteRecord() const;
 
-  // Writes the next record to the current chunk.
-  absl::Status WriteRecord(snapshot_util::TFRecordWriter& writer);
+  // Adds the next element to `chunk_write`.
+  absl::Status WriteRecord(ChunkWrite& chunk_write) TF_LOCKS_EXCLUDED(mu_);
 
   // Writes a DONE file when the stream is finished. Writes an ERROR file if it
   // failed.
@@ -184,11 +229,14 @@ class SnapshotStreamWriter {
   absl::Status WriteDoneFile();
   absl::Status WriteErrorFile(const absl::Status& status);
 
-  // Saves an iterator checkpoint.
-  absl::Status Save();
+  // Saves an iterator checkpoint taken after `chunk_num_elements` elements of
+  // chunk `chunk_index`.
+  absl::Status Save(int64_t chunk_index, int64_t chunk_num_elements,
+                    const std::vector<Tensor>& serialized_iterator);
 
-  // After committing a checkpoint, deletes the previous checkpoints.
-  absl::Status DeleteOutdatedCheckpoints();
+  // After committing a checkpoint for `chunk_index`, deletes the previous
+  // checkpoints.
+  absl::Status DeleteOutdatedCheckpoints(int64_t chunk_index);
 
   // Deletes all checkpoints.
   absl::Status DeleteCheckpoints();
@@ -243,6 +291,20 @@ class SnapshotStreamWriter {
   // - If the snapshot has not finished, this is false.
   absl::StatusOr<bool> completed_ TF_GUARDED_BY(mu_) = false;
 
+  // Notified when `completed_`, the chunk writes, the buffered elements or the
+  // commits change.
+  condition_variable cv_;
+  // Chunks that are being written or are written but not yet committed.
+  absl::flat_hash_map<int64_t, std::shared_ptr<ChunkWrite>> chunk_writes_
+      TF_GUARDED_BY(mu_);
+  // Estimated size of the elements in `chunk_writes_` not yet written.
+  int64_t buffered_bytes_ TF_GUARDED_BY(mu_) = 0;
+  bool commit_in_progress_ TF_GUARDED_BY(mu_) = false;
+  // The first error of writing or committing a chunk.
+  absl::Status write_status_ TF_GUARDED_BY(mu_);
+
+  // Writes and commits chunks. Destroyed after `snapshot_thread_` has joined.
+  std::unique_ptr<tsl::thread::ThreadPool> thread_pool_;
   std::unique_ptr<Thread> snapshot_thread_;
 };
 
@@ -26,6 +26,7 @@ limitations under the License.
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/snapshot/file_utils.h"
 #include "tensorflow/core/data/service/snapshot/path_utils.h"
 #include "tensorflow/core/data/service/task_runner.h"
 #include "tensorflow/core/data/service/test_util.h"
@@ -232,6 +233,37 @@ TEST_P(SnapshotStreamWriterParameterizedTest, WriteSnapshotChunks) {
   }
 }
 
+TEST_P(SnapshotStreamWriterParameterizedTest, WriteChunksInParallel) {
+  for (int64_t num_parallel_chunk_writes : {1, 3, 16}) {
+    int64_t range = 100;
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
+                            TestIterator(testing::RangeDataset(range)));
+
+    std::string compression = GetParam();
+    TF_ASSERT_OK_AND_ASSIGN(std::string snapshot_path,
+                            CreateSnapshotDirectory());
+    SnapshotWriterParams writer_params{snapshot_path, /*stream_index=*/0,
+                                       compression, Env::Default(),
+                                       /*max_chunk_size_bytes=*/1};
+    writer_params.num_parallel_chunk_writes = num_parallel_chunk_writes;
+    SnapshotStreamWriter snapshot_writer(writer_params, std::move(iterator));
+    EXPECT_THAT(snapshot_writer.Wait(), IsOkAndHolds(true));
+
+    for (int i = 0; i < range; ++i) {
+      EXPECT_THAT(
+          ReadSnapshot<int64_t>(
+              tsl::io::JoinPath(writer_params.CommittedChunksDirectory(),
+                                absl::StrCat("chunk_0_", i, "_1")),
+              compression,
+              /*num_elements=*/1),
+          IsOkAndHolds(ElementsAre(i)));
+    }
+    EXPECT_THAT(GetChildren(writer_params.UncommittedChunksDirectory(),
+                            Env::Default()),
+                IsOkAndHolds(IsEmpty()));
+  }
+}
+
 TEST_P(SnapshotStreamWriterParameterizedTest, WriteDoneFile) {
   int64_t range = 10;
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
@@ -17,9 +17,11 @@ limitations under the License.
 #include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -100,8 +102,10 @@ Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
         worker_config.cross_trainer_cache_size_bytes() > 0
             ? worker_config.cross_trainer_cache_size_bytes()
             : kDefaultCrossTrainerCacheSizeBytes;
-    out = std::make_unique<CachingTaskRunner>(std::move(iterator),
-                                              max_cache_size_bytes);
+    out = std::make_unique<CachingTaskRunner>(
+        std::move(iterator), max_cache_size_bytes,
+        std::max<int64_t>(
+            worker_config.cross_trainer_compressed_cache_size_bytes(), 0));
   } else {
     out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
   }
@@ -174,12 +178,16 @@ std::shared_ptr<model::Model> FirstComeFirstServedTaskRunner::model() const {
 }
 
 CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                                     size_t max_cache_size_bytes)
+                                     size_t max_cache_size_bytes,
+                                     size_t max_compressed_cache_size_bytes)
     : fcfs_task_runner_(std::move(iterator)),
       cache_(max_cache_size_bytes,
-             std::make_unique<GetElementResultSequence>(fcfs_task_runner_)) {
+             std::make_unique<GetElementResultSequence>(fcfs_task_runner_),
+             max_compressed_cache_size_bytes) {
   LOG(INFO) << "Initialized tf.data service cross-trainer cache with "
-            << FormatBytes(max_cache_size_bytes) << " of memory.";
+            << FormatBytes(max_cache_size_bytes) << " of memory and "
+            << FormatBytes(max_compressed_cache_size_bytes)
+            << " of compressed memory.";
 }
 
 CachingTaskRunner::~CachingTaskRunner() { Cancel(); }
@@ -213,6 +221,35 @@ size_t CachingTaskRunner::GetElementResultSequence::GetElementSizeBytes(
   return element.EstimatedMemoryUsageBytes();
 }
 
+StatusOr<std::string> CachingTaskRunner::GetElementResultSequence::Compress(
+    const GetElementResult& element) const {
+  GetElementResponse response;
+  TF_RETURN_IF_ERROR(
+      CompressElement(element.components, response.mutable_compressed()));
+  response.set_element_index(element.element_index);
+  response.set_end_of_sequence(element.end_of_sequence);
+  response.set_skip_task(element.skip);
+  return response.SerializeAsString();
+}
+
+StatusOr<GetElementResult>
+CachingTaskRunner::GetElementResultSequence::Uncompress(
+    const std::string& compressed) const {
+  GetElementResponse response;
+  if (!response.ParseFromString(compressed)) {
+    return errors::DataLoss(
+        "Failed to parse a compressed tf.data service cross-trainer cache "
+        "element.");
+  }
+  GetElementResult result;
+  TF_RETURN_IF_ERROR(
+      UncompressElement(response.compressed(), &result.components));
+  result.element_index = response.element_index();
+  result.end_of_sequence = response.end_of_sequence();
+  result.skip = response.skip_task();
+  return result;
+}
+
 void CachingTaskRunner::Cancel() {
   VLOG(2) << "Cancelling tf.data service cross-trainer cache task.";
   if (!cache_.IsCancelled()) {
@@ -74,6 +74,13 @@ Status DataServiceWorkerClient::GetElement(const GetElementRequest& req,
   return client_->GetElement(req, result);
 }
 
+Status DataServiceWorkerClient::GetElements(
+    const GetElementRequest& req, int64_t max_elements, int64_t max_bytes,
+    std::vector<GetElementResult>& results) {
+  TF_RETURN_IF_ERROR(EnsureInitialized());
+  return client_->GetElements(req, max_elements, max_bytes, results);
+}
+
 Status DataServiceWorkerClient::EnsureInitialized() {
   mutex_lock l(mu_);
   if (client_) {
@@ -114,6 +121,73 @@ class GrpcDataTransferClient : public DataTransferClient {
         return errors::Cancelled("Client was cancelled.");
       }
     }
+    GetElementResponse resp;
+    TF_RETURN_IF_ERROR(Call([&](grpc::ClientContext* ctx) {
+      return stub_->GetElement(ctx, req, &resp);
+    }));
+    return ParseElement(resp, result);
+  }
+
+  Status GetElements(const GetElementRequest& req, int64_t max_elements,
+                     int64_t max_bytes,
+                     std::vector<GetElementResult>& results) override {
+    VLOG(3) << "GetElements for task " << req.task_id() << " from gRPC worker "
+            << "server.";
+    {
+      mutex_lock l(mu_);
+      if (cancelled_) {
+        return errors::Cancelled("Client was cancelled.");
+      }
+      if (!get_elements_supported_) {
+        return DataTransferClient::GetElements(req, max_elements, max_bytes,
+                                               results);
+      }
+    }
+    GetElementsRequest batch_req;
+    *batch_req.mutable_request() = req;
+    batch_req.set_max_elements(max_elements);
+    batch_req.set_max_bytes(max_bytes);
+    GetElementsResponse resp;
+    Status s = Call([&](grpc::ClientContext* ctx) {
+      return stub_->GetElements(ctx, batch_req, &resp);
+    });
+    if (errors::IsUnimplemented(s)) {
+      // The worker predates the GetElements RPC. Falls back to fetching one
+      // element at a time.
+      VLOG(1) << "Worker does not support GetElements, falling back to "
+              << "GetElement: " << s;
+      {
+        mutex_lock l(mu_);
+        get_elements_supported_ = false;
+      }
+      return DataTransferClient::GetElements(req, max_elements, max_bytes,
+                                             results);
+    }
+    TF_RETURN_IF_ERROR(s);
+    if (resp.elements().empty()) {
+      return errors::Internal("GetElements for task ", req.task_id(),
+                              " returned no elements.");
+    }
+    for (GetElementResponse& element : *resp.mutable_elements()) {
+      results.emplace_back();
+      TF_RETURN_IF_ERROR(ParseElement(element, results.back()));
+    }
+    return OkStatus();
+  }
+
+  void TryCancel() override {
+    VLOG(2) << "Cancel GrpcDataTransferClient.";
+    mutex_lock l(mu_);
+    cancelled_ = true;
+    for (const auto& ctx : active_contexts_) {
+      ctx->TryCancel();
+    }
+  }
+
+ private:
+  // Runs the RPC issued by `rpc` with a context that is cancelled by
+  // `TryCancel`, and records its duration.
+  Status Call(std::function<grpc::Status(grpc::ClientContext*)> rpc) {
     grpc::ClientContext ctx;
     gtl::Cleanup<std::function<void()>> cleanup;
     {
@@ -124,15 +198,19 @@ class GrpcDataTransferClient : public DataTransferClient {
         active_contexts_.erase(&ctx);
       });
     }
-    GetElementResponse resp;
     int64_t start_time_us = env_->NowMicros();
-    grpc::Status s = stub_->GetElement(&ctx, req, &resp);
+    grpc::Status s = rpc(&ctx);
     int64_t end_time_us = env_->NowMicros();
     if (!s.ok()) {
       return grpc_util::WrapError("Failed to get element", s);
     }
     metrics::RecordTFDataServiceGetElementDuration(kGrpcTransferProtocol,
                                                    end_time_us - start_time_us);
+    return OkStatus();
+  }
+
+  static Status ParseElement(GetElementResponse& resp,
+                             GetElementResult& result) {
     result.end_of_sequence = resp.end_of_sequence();
     result.skip = resp.skip_task();
     switch (resp.element_case()) {
@@ -156,16 +234,6 @@ class GrpcDataTransferClient : public DataTransferClient {
     return OkStatus();
   }
 
-  void TryCancel() override {
-    VLOG(2) << "Cancel GrpcDataTransferClient.";
-    mutex_lock l(mu_);
-    cancelled_ = true;
-    for (const auto& ctx : active_contexts_) {
-      ctx->TryCancel();
-    }
-  }
-
- private:
   mutex mu_;
   std::unique_ptr<WorkerService::Stub> stub_;
   // Set of all currently active clients contexts. Used to support
@@ -175,6 +243,9 @@ class GrpcDataTransferClient : public DataTransferClient {
   // Indicates that the client has been cancelled, so no further requests should
   // be accepted.
   bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  // Whether the worker supports the GetElements RPC. Cleared the first time
+  // the worker returns UNIMPLEMENTED for it.
+  bool get_elements_supported_ TF_GUARDED_BY(mu_) = true;
 };
 
 class GrpcTransferClientRegistrar {
@@ -18,6 +18,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/substitute.h"
@@ -50,7 +51,9 @@ namespace {
 
 using ::tensorflow::data::testing::RangeSquareDataset;
 using ::tensorflow::testing::StatusIs;
+using ::testing::Le;
 using ::testing::MatchesRegex;
+using ::testing::SizeIs;
 
 constexpr const char kProtocol[] = "grpc";
 
@@ -118,6 +121,17 @@ class WorkerClientTest : public ::testing::Test {
     return result;
   }
 
+  StatusOr<std::vector<GetElementResult>> GetElements(
+      DataServiceWorkerClient& client, const int64_t task_id,
+      const int64_t max_elements) {
+    GetElementRequest request;
+    std::vector<GetElementResult> results;
+    request.set_task_id(task_id);
+    TF_RETURN_IF_ERROR(client.GetElements(request, max_elements,
+                                          /*max_bytes=*/0, results));
+    return results;
+  }
+
   std::string GetDispatcherAddress() const {
     return test_cluster_->DispatcherAddress();
   }
@@ -199,6 +213,33 @@ TEST_F(WorkerClientTest, GrpcRead) {
                        MatchesRegex("Local worker.*is no longer available.*")));
 }
 
+TEST_F(WorkerClientTest, BatchedRead) {
+  const int64_t range = 5;
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id, RegisterDataset(range));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t iteration_client_id,
+                          CreateIteration(dataset_id));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t task_id,
+                          GetTaskToRead(iteration_client_id));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<DataServiceWorkerClient> client,
+                          GetWorkerClient(kGrpcTransferProtocol));
+  int64_t i = 0;
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    TF_ASSERT_OK_AND_ASSIGN(std::vector<GetElementResult> results,
+                            GetElements(*client, task_id, /*max_elements=*/3));
+    ASSERT_THAT(results, SizeIs(Le(3)));
+    for (const GetElementResult& result : results) {
+      ASSERT_FALSE(end_of_sequence);
+      end_of_sequence = result.end_of_sequence;
+      if (!end_of_sequence) {
+        test::ExpectEqual(result.components[0], Tensor(int64_t{i * i}));
+        ++i;
+      }
+    }
+  }
+  EXPECT_EQ(i, range);
+}
+
 TEST_F(WorkerClientTest, LocalServerShutsDown) {
   TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id,
                           RegisterDataset(/*range=*/5));
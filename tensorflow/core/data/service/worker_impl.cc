@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/service/worker_impl.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <ctime>
 #include <memory>
 #include <optional>
 #include <string>
@@ -52,6 +54,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/host_info.h"
@@ -421,6 +424,11 @@ DataServiceWorkerImpl::MakeDataset(const DatasetDef& dataset_def,
     TF_ASSIGN_OR_RETURN(
         graph, remove_compression_map_rewriter.ApplyRemoveCompressionMapRewrite(
                    graph));
+  } else if (!task_def.compression_codec().empty()) {
+    CompressionCodecRewriter compression_codec_rewriter(
+        task_def.compression_codec());
+    TF_ASSIGN_OR_RETURN(
+        graph, compression_codec_rewriter.ApplyCompressionCodecRewrite(graph));
   }
   TF_ASSIGN_OR_RETURN(AutoShardRewriter auto_shard_rewriter,
                       AutoShardRewriter::Create(task_def));
@@ -448,7 +456,8 @@ DataServiceWorkerImpl::MakeDatasetIterator(standalone::Dataset& dataset,
     for (int i = 0; i < task_def.num_split_providers(); ++i) {
       split_providers.push_back(std::make_unique<DataServiceSplitProvider>(
           config_.dispatcher_address(), config_.protocol(),
-          task_def.iteration_id(), i, config_.dispatcher_timeout_ms()));
+          task_def.iteration_id(), i, config_.dispatcher_timeout_ms(),
+          worker_address_));
     }
     TF_RETURN_IF_ERROR(
         dataset.MakeIterator(std::move(split_providers), &iterator));
@@ -488,6 +497,39 @@ Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
   return OkStatus();
 }
 
+Status DataServiceWorkerImpl::GetElements(const GetElementsRequest* request,
+                                          GetElementsResponse* response) {
+  VLOG(3) << "Received GetElements request for task "
+          << request->request().task_id();
+  // Round-robin reads keep consumers in sync one round at a time, so they only
+  // read one element per request.
+  const int64_t max_elements =
+      request->request().has_consumer_index()
+          ? 1
+          : std::max<int64_t>(request->max_elements(), 1);
+  int64_t num_bytes = 0;
+  while (response->elements_size() < max_elements &&
+         (request->max_bytes() <= 0 || num_bytes < request->max_bytes())) {
+    GetElementResponse element;
+    Status s = GetElement(&request->request(), &element);
+    if (!s.ok()) {
+      // Returns the elements read so far. Task runners keep failing after an
+      // error, so the client sees the error on its next request.
+      if (response->elements_size() > 0) {
+        break;
+      }
+      return s;
+    }
+    num_bytes += element.ByteSizeLong();
+    const bool last_element = element.end_of_sequence() || element.skip_task();
+    *response->add_elements() = std::move(element);
+    if (last_element) {
+      break;
+    }
+  }
+  return OkStatus();
+}
+
 Status DataServiceWorkerImpl::GetWorkerTasks(
     const GetWorkerTasksRequest* request, GetWorkerTasksResponse* response) {
   mutex_lock l(mu_);
@@ -588,6 +630,7 @@ void DataServiceWorkerImpl::HeartbeatThread() TF_LOCKS_EXCLUDED(mu_) {
 
 Status DataServiceWorkerImpl::Heartbeat() {
   WorkerHeartbeatRequest request = BuildWorkerHeartbeatRequest();
+  request.set_cpu_utilization(MeasureCpuUtilization());
   TF_ASSIGN_OR_RETURN(WorkerHeartbeatResponse response,
                       dispatcher_->WorkerHeartbeat(request));
   UpdateTasks(response);
@@ -641,6 +684,26 @@ std::vector<int64_t> DataServiceWorkerImpl::GetTaskIds(
   return task_ids;
 }
 
+double DataServiceWorkerImpl::MeasureCpuUtilization() TF_LOCKS_EXCLUDED(mu_) {
+  const std::clock_t cpu_clock = std::clock();
+  const int64_t now_micros = Env::Default()->NowMicros();
+  if (cpu_clock == static_cast<std::clock_t>(-1)) {
+    return 0.0;
+  }
+  mutex_lock l(mu_);
+  double cpu_utilization = 0.0;
+  if (last_cpu_sample_micros_ > 0 && now_micros > last_cpu_sample_micros_) {
+    const double cpu_seconds =
+        static_cast<double>(cpu_clock - last_cpu_clock_) / CLOCKS_PER_SEC;
+    const double wall_seconds = (now_micros - last_cpu_sample_micros_) / 1e6;
+    cpu_utilization =
+        cpu_seconds / (wall_seconds * std::max(port::NumSchedulableCPUs(), 1));
+  }
+  last_cpu_clock_ = cpu_clock;
+  last_cpu_sample_micros_ = now_micros;
+  return cpu_utilization;
+}
+
 WorkerHeartbeatRequest DataServiceWorkerImpl::BuildWorkerHeartbeatRequest()
     const TF_LOCKS_EXCLUDED(mu_) {
   std::vector<ActiveTask> active_tasks = GetActiveTasks();
@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DATA_SERVICE_WORKER_IMPL_H_
 
 #include <cstdint>
+#include <ctime>
 #include <memory>
 #include <string>
 #include <utility>
@@ -80,6 +81,8 @@ class DataServiceWorkerImpl {
   /// Client-facing API.
   Status GetElement(const GetElementRequest* request,
                     GetElementResponse* response);
+  Status GetElements(const GetElementsRequest* request,
+                     GetElementsResponse* response);
   Status GetWorkerTasks(const GetWorkerTasksRequest* request,
                         GetWorkerTasksResponse* response);
   Status GetSnapshotTaskProgresses(
@@ -151,6 +154,9 @@ class DataServiceWorkerImpl {
   // Builds a heartbeat request.
   WorkerHeartbeatRequest BuildWorkerHeartbeatRequest() const
       TF_LOCKS_EXCLUDED(mu_);
+  // Returns the fraction of the host's CPU cores used by this process since the
+  // previous call, or 0 on the first call.
+  double MeasureCpuUtilization() TF_LOCKS_EXCLUDED(mu_);
   // Updates the tasks according to the heartbeat response.
   void UpdateTasks(const WorkerHeartbeatResponse& response)
       TF_LOCKS_EXCLUDED(mu_);
@@ -200,6 +206,9 @@ class DataServiceWorkerImpl {
   condition_variable task_completion_cv_ TF_GUARDED_BY(mu_);
   condition_variable heartbeat_cv_ TF_GUARDED_BY(mu_);
   CancellationManager cancellation_manager_;
+  // Process CPU time and wall time of the last CPU utilization measurement.
+  std::clock_t last_cpu_clock_ TF_GUARDED_BY(mu_) = 0;
+  int64_t last_cpu_sample_micros_ TF_GUARDED_BY(mu_) = 0;
 
   absl::flat_hash_map<SnapshotTask, std::unique_ptr<SnapshotStreamWriter>,
                       absl::Hash<SnapshotTask>>
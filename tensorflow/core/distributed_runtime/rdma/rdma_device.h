@@ -0,0 +1,67 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_DEVICE_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_DEVICE_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+
+namespace tensorflow {
+
+// One end of a reliable connection, which writes to the memory of the other
+// end without involving its CPU.
+class RdmaChannel {
+ public:
+  virtual ~RdmaChannel() {}
+
+  // Identifies this end, to be passed to Connect() on the other end.
+  virtual const RdmaEndpoint& endpoint() const = 0;
+
+  // Connects this end to "remote". Must be called once, before Write().
+  virtual Status Connect(const RdmaEndpoint& remote) = 0;
+
+  // Writes the "size" bytes at "local", which are registered with "lkey",
+  // to "remote_addr" on the other end, which is registered there with
+  // "rkey". Calls "done" once the bytes are in the memory of the other end.
+  virtual void Write(const void* local, uint32 lkey, uint64 remote_addr,
+                     uint32 rkey, size_t size, StatusCallback done) = 0;
+};
+
+// A network adapter that can access the memory of this process directly.
+class RdmaDevice {
+ public:
+  virtual ~RdmaDevice() {}
+
+  // Registers the "size" bytes at "addr" for writes by the device, both
+  // from them and, by the other ends of the channels, to them. Sets the
+  // keys under which channels access the memory.
+  virtual Status RegisterMemory(void* addr, size_t size, uint32* lkey,
+                                uint32* rkey) = 0;
+
+  // Undoes RegisterMemory(addr, ...).
+  virtual void DeregisterMemory(void* addr) = 0;
+
+  // Creates an unconnected channel.
+  virtual Status CreateChannel(std::unique_ptr<RdmaChannel>* channel) = 0;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_DEVICE_H_
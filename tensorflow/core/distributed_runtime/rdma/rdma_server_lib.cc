@@ -0,0 +1,140 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rdma/rdma_server_lib.h"
+
+#include <string>
+#include <utility>
+
+#include "tensorflow/core/common_runtime/process_state.h"
+#include "tensorflow/core/distributed_runtime/rdma/rdma_transport.h"
+#include "tensorflow/core/distributed_runtime/rdma/verbs_device.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service.h"
+#include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
+#include "tensorflow/core/distributed_runtime/server_lib.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+namespace {
+
+class RdmaGrpcWorker : public GrpcWorker {
+ public:
+  RdmaGrpcWorker(WorkerEnv* env, const ConfigProto& config,
+                 RdmaTransport* transport)
+      : GrpcWorker(env, config), transport_(transport) {}
+
+ protected:
+  void EncodeRecvTensorResponseAsync(const RecvTensorRequest& request,
+                                     const Tensor& tensor, bool is_dead,
+                                     bool require_ack,
+                                     ::grpc::ByteBuffer* response,
+                                     StatusCallback done) override {
+    transport_->RespondWithTensor(request, tensor, is_dead, require_ack,
+                                  response, std::move(done));
+  }
+
+ private:
+  RdmaTransport* const transport_;  // Not owned.
+};
+
+Status CreateTransport(RdmaTransport** transport) {
+  std::string name;
+  int64_t port, gid_index;
+  TF_RETURN_IF_ERROR(ReadStringFromEnvVar("TF_RDMA_DEVICE", "", &name));
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_RDMA_PORT", 1, &port));
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_RDMA_GID_INDEX", 0, &gid_index));
+  std::unique_ptr<VerbsDevice> device;
+  TF_RETURN_IF_ERROR(VerbsDevice::Create(name, port, gid_index, &device));
+  *transport = new RdmaTransport(std::move(device));
+  ProcessState::singleton()->AddCPUAllocVisitor((*transport)->alloc_visitor());
+  ProcessState::singleton()->AddCPUFreeVisitor((*transport)->free_visitor());
+  return OkStatus();
+}
+
+// Returns the transport of the process, which lives as long as the CPU
+// allocators whose memory it registered.
+Status GetTransport(RdmaTransport** transport) {
+  static RdmaTransport* const the_transport = [] {
+    RdmaTransport* t = nullptr;
+    Status s = CreateTransport(&t);
+    if (!s.ok()) LOG(ERROR) << "Failed to set up RDMA: " << s;
+    return t;
+  }();
+  if (the_transport == nullptr) {
+    return errors::Unavailable("RDMA is not available, see the logs");
+  }
+  *transport = the_transport;
+  return OkStatus();
+}
+
+}  // namespace
+
+RdmaServer::RdmaServer(const ServerDef& server_def, Env* env)
+    : GrpcServer(server_def, env) {}
+
+/* static */
+Status RdmaServer::Create(const ServerDef& server_def, Env* env,
+                          DeviceMgr* local_device_mgr,
+                          std::unique_ptr<ServerInterface>* out_server) {
+  RdmaTransport* transport;
+  TF_RETURN_IF_ERROR(GetTransport(&transport));
+  std::unique_ptr<RdmaServer> ret(
+      new RdmaServer(server_def, env == nullptr ? Env::Default() : env));
+  GrpcServerOptions options;
+  options.rendezvous_mgr_func = [transport](const WorkerEnv* env) {
+    return new RpcRendezvousMgr(env, transport);
+  };
+  options.worker_func = [transport](WorkerEnv* env, const ConfigProto& config)
+      -> std::unique_ptr<GrpcWorker> {
+    return std::make_unique<RdmaGrpcWorker>(env, config, transport);
+  };
+  options.local_device_mgr = local_device_mgr;
+  Status s = ret->Init(options);
+  if (!s.ok()) {
+    LOG(ERROR) << s;
+    return s;
+  }
+  *out_server = std::move(ret);
+  return OkStatus();
+}
+
+namespace {
+
+class RdmaServerFactory : public ServerFactory {
+ public:
+  bool AcceptsOptions(const ServerDef& server_def) override {
+    return server_def.protocol() == "grpc+rdma";
+  }
+
+  Status NewServer(const ServerDef& server_def, const Options& options,
+                   std::unique_ptr<ServerInterface>* out_server) override {
+    return RdmaServer::Create(server_def, Env::Default(),
+                              options.local_device_mgr, out_server);
+  }
+};
+
+// Registers a `ServerFactory` for `RdmaServer` instances.
+class RdmaServerRegistrar {
+ public:
+  RdmaServerRegistrar() {
+    ServerFactory::Register("RDMA_SERVER", new RdmaServerFactory());
+  }
+};
+static RdmaServerRegistrar registrar;
+
+}  // namespace
+}  // namespace tensorflow
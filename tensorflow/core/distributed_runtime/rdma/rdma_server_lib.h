@@ -0,0 +1,50 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_SERVER_LIB_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_SERVER_LIB_H_
+
+#include <memory>
+
+#include "tensorflow/core/distributed_runtime/rpc/grpc_server_lib.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/tensorflow_server.pb.h"
+
+namespace tensorflow {
+
+class DeviceMgr;
+
+// A GrpcServer whose workers move the contents of the tensors they exchange
+// with RDMA writes, see RdmaTransport. Serves the "grpc+rdma" protocol.
+//
+// The first server of the process must be created before anything uses the
+// CPU allocator of ProcessState, whose memory it registers with the RDMA
+// device. The device is chosen by the TF_RDMA_DEVICE (default: the first),
+// TF_RDMA_PORT (default: 1) and TF_RDMA_GID_INDEX (default: 0) environment
+// variables.
+class RdmaServer : public GrpcServer {
+ public:
+  static Status Create(const ServerDef& server_def, Env* env,
+                       DeviceMgr* local_device_mgr,
+                       std::unique_ptr<ServerInterface>* out_server);
+
+ protected:
+  RdmaServer(const ServerDef& server_def, Env* env);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_SERVER_LIB_H_
@@ -0,0 +1,256 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rdma/rdma_transport.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/strings/escaping.h"
+#include "grpcpp/support/byte_buffer.h"
+#include "grpcpp/support/slice.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+
+namespace tensorflow {
+
+namespace {
+
+std::string EndpointKey(const RdmaEndpoint& endpoint) {
+  return strings::StrCat(endpoint.lid(), ":",
+                         absl::BytesToHexString(endpoint.gid()), ":",
+                         endpoint.qp_num());
+}
+
+// Appends "options" to the encoded RecvTensorResponse in "response", which
+// parses them as its transport_options.
+void AppendTransportOptions(const RdmaRecvTensorResponse& options,
+                            ::grpc::ByteBuffer* response) {
+  RecvTensorResponse extra;
+  extra.mutable_transport_options()->PackFrom(options);
+  const std::string encoded = extra.SerializeAsString();
+  std::vector<::grpc::Slice> slices;
+  if (!response->Dump(&slices).ok()) return;
+  slices.emplace_back(encoded.data(), encoded.size());
+  ::grpc::ByteBuffer tmp(slices.data(), slices.size());
+  response->Swap(&tmp);
+}
+
+}  // namespace
+
+RdmaTransport::RdmaTransport(std::unique_ptr<RdmaDevice> device)
+    : device_(std::move(device)) {}
+
+SubAllocator::Visitor RdmaTransport::alloc_visitor() {
+  return [this](void* ptr, int index, size_t num_bytes) {
+    Region region;
+    region.size = num_bytes;
+    Status s =
+        device_->RegisterMemory(ptr, num_bytes, &region.lkey, &region.rkey);
+    if (!s.ok()) {
+      LOG(WARNING) << "Tensors at " << ptr << " are sent without RDMA: " << s;
+      return;
+    }
+    mutex_lock l(mu_);
+    regions_[reinterpret_cast<uintptr_t>(ptr)] = region;
+  };
+}
+
+SubAllocator::Visitor RdmaTransport::free_visitor() {
+  return [this](void* ptr, int index, size_t num_bytes) {
+    {
+      mutex_lock l(mu_);
+      if (regions_.erase(reinterpret_cast<uintptr_t>(ptr)) == 0) return;
+    }
+    device_->DeregisterMemory(ptr);
+  };
+}
+
+bool RdmaTransport::FindRegion(const void* addr, size_t size,
+                               Region* region) {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+  mutex_lock l(mu_);
+  auto it = regions_.upper_bound(begin);
+  if (it == regions_.begin()) return false;
+  --it;
+  if (begin + size > it->first + it->second.size) return false;
+  *region = it->second;
+  return true;
+}
+
+void RdmaTransport::PrepareRequest(const std::string& src_worker,
+                                   Device* dst_device,
+                                   const AllocatorAttributes& alloc_attrs,
+                                   RecvTensorRequest* request,
+                                   Tensor* buffer) {
+  RdmaRecvTensorRequest options;
+  bool connected;
+  int64_t bytes = 0;
+  {
+    mutex_lock l(mu_);
+    SenderChannel& sender = senders_[src_worker];
+    if (sender.channel == nullptr) {
+      Status s = device_->CreateChannel(&sender.channel);
+      if (!s.ok()) {
+        LOG(WARNING) << "Receiving from " << src_worker
+                     << " without RDMA: " << s;
+        senders_.erase(src_worker);
+        return;
+      }
+    }
+    *options.mutable_endpoint() = sender.channel->endpoint();
+    connected = sender.connected;
+    auto it = recv_bytes_.find(request->rendezvous_key());
+    if (it != recv_bytes_.end()) bytes = it->second;
+  }
+  // Only host memory is registered.
+  const bool on_host =
+      alloc_attrs.on_host() || dst_device->device_type() == DEVICE_CPU;
+  if (connected && bytes > 0 && on_host) {
+    Tensor t(dst_device->GetAllocator(alloc_attrs), DT_INT8,
+             TensorShape({bytes}));
+    Region region;
+    if (t.IsInitialized() && FindRegion(t.data(), bytes, &region)) {
+      options.set_remote_addr(reinterpret_cast<uintptr_t>(t.data()));
+      options.set_rkey(region.rkey);
+      options.set_remote_size(bytes);
+      *buffer = std::move(t);
+    }
+  }
+  request->set_dma_ok(true);
+  request->mutable_transport_options()->PackFrom(options);
+}
+
+Status RdmaTransport::FinishRequest(const std::string& src_worker,
+                                    const RecvTensorRequest& request,
+                                    const RecvTensorResponse& response,
+                                    Tensor* buffer, bool* written) {
+  *written = false;
+  RdmaRecvTensorResponse options;
+  if (!response.has_transport_options() ||
+      !response.transport_options().UnpackTo(&options)) {
+    // The sender does not use the transport.
+    return OkStatus();
+  }
+  TensorShape shape;
+  TF_RETURN_IF_ERROR(TensorShape::BuildTensorShape(options.shape(), &shape));
+  int64_t bytes = 0;
+  if (DataTypeCanUseMemcpy(options.dtype())) {
+    bytes = shape.num_elements() * DataTypeSize(options.dtype());
+  }
+  {
+    mutex_lock l(mu_);
+    recv_bytes_[request.rendezvous_key()] = bytes;
+    auto it = senders_.find(src_worker);
+    if (it != senders_.end() && !it->second.connected) {
+      SenderChannel& sender = it->second;
+      Status s = sender.channel->Connect(options.endpoint());
+      if (s.ok()) {
+        sender.connected = true;
+      } else {
+        LOG(WARNING) << "Receiving from " << src_worker
+                     << " without RDMA: " << s;
+        senders_.erase(it);
+      }
+    }
+  }
+  if (!options.written()) return OkStatus();
+  if (buffer->TotalBytes() != bytes) {
+    return errors::Internal("RDMA write of ", bytes, " bytes into a ",
+                            buffer->TotalBytes(), " bytes buffer");
+  }
+  Tensor t;
+  TF_RETURN_IF_ERROR(t.BitcastFrom(*buffer, options.dtype(), shape));
+  *buffer = std::move(t);
+  *written = true;
+  return OkStatus();
+}
+
+RdmaChannel* RdmaTransport::GetReceiverChannel(const RdmaEndpoint& endpoint) {
+  const std::string key = EndpointKey(endpoint);
+  mutex_lock l(mu_);
+  std::unique_ptr<RdmaChannel>& channel = receivers_[key];
+  if (channel == nullptr) {
+    std::unique_ptr<RdmaChannel> c;
+    Status s = device_->CreateChannel(&c);
+    if (s.ok()) s = c->Connect(endpoint);
+    if (!s.ok()) {
+      LOG(WARNING) << "Sending to " << key << " without RDMA: " << s;
+      receivers_.erase(key);
+      return nullptr;
+    }
+    channel = std::move(c);
+  }
+  return channel.get();
+}
+
+void RdmaTransport::RespondWithTensor(const RecvTensorRequest& request,
+                                      const Tensor& tensor, bool is_dead,
+                                      bool require_ack,
+                                      ::grpc::ByteBuffer* response,
+                                      StatusCallback done) {
+  RdmaRecvTensorRequest options;
+  RdmaChannel* channel = nullptr;
+  if (request.dma_ok() && request.transport_options().UnpackTo(&options)) {
+    channel = GetReceiverChannel(options.endpoint());
+  }
+  if (channel == nullptr) {
+    grpc::EncodeTensorToByteBuffer(is_dead, tensor, require_ack, response);
+    done(OkStatus());
+    return;
+  }
+
+  RdmaRecvTensorResponse reply;
+  *reply.mutable_endpoint() = channel->endpoint();
+  reply.set_dtype(tensor.dtype());
+  tensor.shape().AsProto(reply.mutable_shape());
+  const size_t bytes = tensor.TotalBytes();
+  Region region;
+  if (is_dead || !DataTypeCanUseMemcpy(tensor.dtype()) || bytes == 0 ||
+      options.remote_size() != bytes ||
+      !FindRegion(tensor.data(), bytes, &region)) {
+    grpc::EncodeTensorToByteBuffer(is_dead, tensor, require_ack, response);
+    AppendTransportOptions(reply, response);
+    done(OkStatus());
+    return;
+  }
+
+  const int64_t send_start_micros = Env::Default()->NowMicros();
+  channel->Write(
+      tensor.data(), region.lkey, options.remote_addr(), options.rkey(), bytes,
+      [tensor, reply = std::move(reply), require_ack, send_start_micros,
+       response, done = std::move(done)](const Status& s) mutable {
+        if (!s.ok()) {
+          done(s);
+          return;
+        }
+        reply.set_written(true);
+        RecvTensorResponse meta;
+        meta.set_send_start_micros(send_start_micros);
+        meta.set_require_ack(require_ack);
+        meta.mutable_transport_options()->PackFrom(reply);
+        grpc::EncodeRecvTensorResponseToByteBuffer(meta, response);
+        done(OkStatus());
+      });
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,118 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_TRANSPORT_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_TRANSPORT_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/distributed_runtime/rdma/rdma_device.h"
+#include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace grpc {
+class ByteBuffer;
+}  // namespace grpc
+
+namespace tensorflow {
+
+// Moves the contents of the tensors received by RecvTensor RPCs with
+// one-sided RDMA writes, while the RPCs carry the requests and the metadata.
+//
+// The receiver names a buffer in each request, which is allocated for the
+// size of the tensor last received under the same rendezvous key. If the
+// tensor to send has that size, the sender writes it to the buffer
+// before responding. Otherwise, including before the channel between the two
+// is connected, which takes the first exchange, and when either tensor is
+// not in registered memory, the contents go in the response as usual.
+//
+// Only memory registered through the visitors below can be written from or
+// to, so the tensors received on and sent from GPUs always use the RPCs.
+class RdmaTransport : public RecvTensorTransport {
+ public:
+  explicit RdmaTransport(std::unique_ptr<RdmaDevice> device);
+
+  // Register the memory of a SubAllocator with the device, and deregister
+  // it. The transport must outlive the SubAllocator.
+  SubAllocator::Visitor alloc_visitor();
+  SubAllocator::Visitor free_visitor();
+
+  void PrepareRequest(const std::string& src_worker, Device* dst_device,
+                      const AllocatorAttributes& alloc_attrs,
+                      RecvTensorRequest* request, Tensor* buffer) override;
+
+  Status FinishRequest(const std::string& src_worker,
+                       const RecvTensorRequest& request,
+                       const RecvTensorResponse& response, Tensor* buffer,
+                       bool* written) override;
+
+  // Encodes "tensor" as the response to "request", after writing its
+  // contents to the buffer named by "request" if possible.
+  void RespondWithTensor(const RecvTensorRequest& request, const Tensor& tensor,
+                         bool is_dead, bool require_ack,
+                         ::grpc::ByteBuffer* response, StatusCallback done);
+
+ private:
+  struct Region {
+    size_t size;
+    uint32 lkey;
+    uint32 rkey;
+  };
+
+  struct SenderChannel {
+    std::unique_ptr<RdmaChannel> channel;
+    // Set once a response carries the endpoint of the sender.
+    bool connected = false;
+  };
+
+  // Sets "*region" to the registered region that contains the "size" bytes
+  // at "addr". Returns false if there is none.
+  bool FindRegion(const void* addr, size_t size, Region* region);
+
+  // Returns the channel to "endpoint", which is created and connected on
+  // first use, or nullptr on failure.
+  RdmaChannel* GetReceiverChannel(const RdmaEndpoint& endpoint);
+
+  const std::unique_ptr<RdmaDevice> device_;
+
+  mutex mu_;
+  // Registered regions by their addresses.
+  std::map<uintptr_t, Region> regions_ TF_GUARDED_BY(mu_);
+  // Channels to the workers this one receives from, by name.
+  absl::flat_hash_map<std::string, SenderChannel> senders_ TF_GUARDED_BY(mu_);
+  // Channels to the workers this one sends to, by the endpoints of the
+  // other ends. Never removed once connected, so that writes can use them
+  // without holding mu_.
+  absl::flat_hash_map<std::string, std::unique_ptr<RdmaChannel>> receivers_
+      TF_GUARDED_BY(mu_);
+  // The size of the tensor last received under each rendezvous key.
+  absl::flat_hash_map<std::string, int64_t> recv_bytes_ TF_GUARDED_BY(mu_);
+
+  RdmaTransport(const RdmaTransport&) = delete;
+  void operator=(const RdmaTransport&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_RDMA_TRANSPORT_H_
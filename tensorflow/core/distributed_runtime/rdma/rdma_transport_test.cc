@@ -0,0 +1,218 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rdma/rdma_transport.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "grpcpp/support/byte_buffer.h"
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Numbers the endpoints of the FakeChannels in the process.
+mutex network_mu(LINKER_INITIALIZED);
+uint32 next_qp_num TF_GUARDED_BY(network_mu) = 1;
+
+class FakeChannel : public RdmaChannel {
+ public:
+  FakeChannel() {
+    mutex_lock l(network_mu);
+    endpoint_.set_qp_num(next_qp_num++);
+  }
+
+  const RdmaEndpoint& endpoint() const override { return endpoint_; }
+
+  Status Connect(const RdmaEndpoint& remote) override {
+    connected_ = true;
+    return OkStatus();
+  }
+
+  // The other end is in this process, so its memory is written directly.
+  void Write(const void* local, uint32 lkey, uint64 remote_addr, uint32 rkey,
+             size_t size, StatusCallback done) override {
+    if (!connected_) {
+      done(errors::FailedPrecondition("Unconnected channel"));
+      return;
+    }
+    std::memcpy(reinterpret_cast<void*>(remote_addr), local, size);
+    done(OkStatus());
+  }
+
+ private:
+  RdmaEndpoint endpoint_;
+  bool connected_ = false;
+};
+
+class FakeRdmaDevice : public RdmaDevice {
+ public:
+  Status RegisterMemory(void* addr, size_t size, uint32* lkey,
+                        uint32* rkey) override {
+    *lkey = *rkey = ++num_registered_;
+    return OkStatus();
+  }
+
+  void DeregisterMemory(void* addr) override {}
+
+  Status CreateChannel(std::unique_ptr<RdmaChannel>* channel) override {
+    channel->reset(new FakeChannel);
+    return OkStatus();
+  }
+
+ private:
+  uint32 num_registered_ = 0;
+};
+
+class FakeDevice : public Device {
+ public:
+  explicit FakeDevice(Allocator* allocator)
+      : Device(nullptr, MakeAttributes()), allocator_(allocator) {}
+
+  Status Sync() override { return OkStatus(); }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return allocator_;
+  }
+
+ private:
+  static DeviceAttributes MakeAttributes() {
+    DeviceAttributes attributes;
+    attributes.set_name("/job:worker/replica:0/task:1/device:CPU:0");
+    attributes.set_device_type(DEVICE_CPU);
+    return attributes;
+  }
+
+  Allocator* const allocator_;
+};
+
+// Returns a BFCAllocator whose memory is registered with "transport".
+std::unique_ptr<Allocator> NewRegisteredAllocator(RdmaTransport* transport) {
+  BFCAllocator::Options opts;
+  opts.allow_growth = true;
+  return std::make_unique<BFCAllocator>(
+      std::make_unique<BasicCPUAllocator>(port::kNUMANoAffinity,
+                                          std::vector<SubAllocator::Visitor>{
+                                              transport->alloc_visitor()},
+                                          std::vector<SubAllocator::Visitor>{
+                                              transport->free_visitor()}),
+      1 << 30, "rdma_test", opts);
+}
+
+class RdmaTransportTest : public ::testing::Test {
+ protected:
+  RdmaTransportTest()
+      : sender_(std::make_unique<FakeRdmaDevice>()),
+        receiver_(std::make_unique<FakeRdmaDevice>()),
+        send_allocator_(NewRegisteredAllocator(&sender_)),
+        recv_allocator_(NewRegisteredAllocator(&receiver_)),
+        recv_device_(recv_allocator_.get()) {}
+
+  // Passes "tensor" from sender_ to receiver_ as a RecvTensor RPC would, and
+  // sets "*received" to the tensor received and "*written" to whether its
+  // contents were written to the buffer of the request.
+  void Exchange(const Tensor& tensor, Tensor* received, bool* written) {
+    RecvTensorRequest request;
+    request.set_rendezvous_key("key");
+    Tensor buffer;
+    receiver_.PrepareRequest("/job:worker/replica:0/task:0", &recv_device_,
+                             AllocatorAttributes(), &request, &buffer);
+
+    ::grpc::ByteBuffer encoded;
+    Status status;
+    sender_.RespondWithTensor(request, tensor, /*is_dead=*/false,
+                              /*require_ack=*/false, &encoded,
+                              [&status](const Status& s) { status = s; });
+    TF_ASSERT_OK(status);
+
+    TensorResponse response;
+    response.InitAlloc(&recv_device_, AllocatorAttributes());
+    ASSERT_TRUE(GrpcMaybeParseTensorResponse(&encoded, &response));
+    TF_ASSERT_OK(receiver_.FinishRequest("/job:worker/replica:0/task:0",
+                                         request, response.metadata(),
+                                         &buffer, written));
+    *received = *written ? buffer : response.tensor();
+  }
+
+  RdmaTransport sender_;
+  RdmaTransport receiver_;
+  std::unique_ptr<Allocator> send_allocator_;
+  std::unique_ptr<Allocator> recv_allocator_;
+  FakeDevice recv_device_;
+};
+
+TEST_F(RdmaTransportTest, WritesOnceConnected) {
+  Tensor a(send_allocator_.get(), DT_FLOAT, TensorShape({4, 256}));
+  test::FillIota<float>(&a, 0);
+
+  // The first exchange connects the channel, so the contents are in the
+  // response.
+  Tensor received;
+  bool written;
+  Exchange(a, &received, &written);
+  EXPECT_FALSE(written);
+  test::ExpectTensorEqual<float>(a, received);
+
+  test::FillIota<float>(&a, 1);
+  Exchange(a, &received, &written);
+  EXPECT_TRUE(written);
+  test::ExpectTensorEqual<float>(a, received);
+  EXPECT_NE(a.tensor_data().data(), received.tensor_data().data());
+}
+
+TEST_F(RdmaTransportTest, SendsOtherSizesInResponses) {
+  Tensor a(send_allocator_.get(), DT_FLOAT, TensorShape({4, 256}));
+  test::FillIota<float>(&a, 0);
+  Tensor received;
+  bool written;
+  Exchange(a, &received, &written);
+
+  Tensor b(send_allocator_.get(), DT_FLOAT, TensorShape({8, 256}));
+  test::FillIota<float>(&b, 0);
+  Exchange(b, &received, &written);
+  EXPECT_FALSE(written);
+  test::ExpectTensorEqual<float>(b, received);
+
+  // The next buffer has the size of "b".
+  Exchange(b, &received, &written);
+  EXPECT_TRUE(written);
+  test::ExpectTensorEqual<float>(b, received);
+}
+
+TEST_F(RdmaTransportTest, SendsUnregisteredMemoryInResponses) {
+  Tensor a(cpu_allocator(), DT_FLOAT, TensorShape({4, 256}));
+  test::FillIota<float>(&a, 0);
+  Tensor received;
+  bool written;
+  for (int i = 0; i < 2; ++i) {
+    Exchange(a, &received, &written);
+    EXPECT_FALSE(written);
+    test::ExpectTensorEqual<float>(a, received);
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,380 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rdma/verbs_device.h"
+
+#include <fcntl.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/random.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Writes in flight per channel. A few large writes keep the link busy.
+constexpr int kMaxSendWr = 16;
+constexpr int kMaxCqEntries = 1 << 16;
+// Larger writes are split, which also keeps them under max_msg_sz.
+constexpr size_t kMaxWriteBytes = 1 << 30;
+
+Status VerbsError(const char* what, int error) {
+  return errors::Unavailable("RDMA ", what, " failed: ", strerror(error));
+}
+
+}  // namespace
+
+// Calls "done" once all the work requests of a Write() complete.
+struct VerbsDevice::WriteOp {
+  WriteOp(Channel* channel, int num_chunks, StatusCallback done)
+      : channel(channel), remaining(num_chunks), done(std::move(done)) {}
+
+  void ChunkDone(const Status& s) {
+    {
+      mutex_lock l(mu);
+      status.Update(s);
+      if (--remaining > 0) return;
+    }
+    done(status);
+    delete this;
+  }
+
+  Channel* const channel;
+  mutex mu;
+  int remaining TF_GUARDED_BY(mu);
+  Status status TF_GUARDED_BY(mu);
+  StatusCallback done;
+};
+
+class VerbsDevice::Channel : public RdmaChannel {
+ public:
+  Channel(VerbsDevice* device, ibv_qp* qp, RdmaEndpoint endpoint)
+      : device_(device), qp_(qp), endpoint_(std::move(endpoint)) {}
+
+  ~Channel() override {
+    ibv_destroy_qp(qp_);
+    device_->num_channels_.fetch_sub(1);
+  }
+
+  const RdmaEndpoint& endpoint() const override { return endpoint_; }
+
+  Status Connect(const RdmaEndpoint& remote) override {
+    if (remote.gid().size() != sizeof(ibv_gid)) {
+      return errors::InvalidArgument("Invalid RDMA GID of ",
+                                     remote.gid().size(), " bytes");
+    }
+    ibv_qp_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.qp_state = IBV_QPS_RTR;
+    attr.path_mtu = device_->port_attr_.active_mtu;
+    attr.dest_qp_num = remote.qp_num();
+    attr.rq_psn = remote.psn();
+    attr.max_dest_rd_atomic = 1;
+    attr.min_rnr_timer = 12;
+    attr.ah_attr.dlid = remote.lid();
+    attr.ah_attr.port_num = device_->port_;
+    attr.ah_attr.is_global = 1;
+    memcpy(&attr.ah_attr.grh.dgid, remote.gid().data(), sizeof(ibv_gid));
+    attr.ah_attr.grh.sgid_index = device_->gid_index_;
+    attr.ah_attr.grh.hop_limit = 64;
+    int r = ibv_modify_qp(qp_, &attr,
+                          IBV_QP_STATE | IBV_QP_AV | IBV_QP_PATH_MTU |
+                              IBV_QP_DEST_QPN | IBV_QP_RQ_PSN |
+                              IBV_QP_MAX_DEST_RD_ATOMIC |
+                              IBV_QP_MIN_RNR_TIMER);
+    if (r != 0) return VerbsError("queue pair RTR transition", r);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.qp_state = IBV_QPS_RTS;
+    attr.timeout = 14;
+    attr.retry_cnt = 7;
+    attr.rnr_retry = 7;
+    attr.sq_psn = endpoint_.psn();
+    attr.max_rd_atomic = 1;
+    r = ibv_modify_qp(qp_, &attr,
+                      IBV_QP_STATE | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT |
+                          IBV_QP_RNR_RETRY | IBV_QP_SQ_PSN |
+                          IBV_QP_MAX_QP_RD_ATOMIC);
+    if (r != 0) return VerbsError("queue pair RTS transition", r);
+    return OkStatus();
+  }
+
+  void Write(const void* local, uint32 lkey, uint64 remote_addr, uint32 rkey,
+             size_t size, StatusCallback done) override {
+    if (size == 0) {
+      done(OkStatus());
+      return;
+    }
+    const int num_chunks = (size + kMaxWriteBytes - 1) / kMaxWriteBytes;
+    WriteOp* op = new WriteOp(this, num_chunks, std::move(done));
+    std::vector<Status> failed;
+    {
+      mutex_lock l(mu_);
+      for (size_t offset = 0; offset < size; offset += kMaxWriteBytes) {
+        Chunk chunk;
+        chunk.op = op;
+        chunk.local = reinterpret_cast<uintptr_t>(local) + offset;
+        chunk.lkey = lkey;
+        chunk.remote = remote_addr + offset;
+        chunk.rkey = rkey;
+        chunk.size = std::min(kMaxWriteBytes, size - offset);
+        if (outstanding_ < kMaxSendWr) {
+          Status s = PostLocked(chunk);
+          if (!s.ok()) failed.push_back(s);
+        } else {
+          queued_.push_back(chunk);
+        }
+      }
+    }
+    for (const Status& s : failed) op->ChunkDone(s);
+  }
+
+  // Called by the poller for each completed work request.
+  void OnCompletion() {
+    std::vector<std::pair<WriteOp*, Status>> failed;
+    {
+      mutex_lock l(mu_);
+      --outstanding_;
+      while (outstanding_ < kMaxSendWr && !queued_.empty()) {
+        Chunk chunk = queued_.front();
+        queued_.pop_front();
+        Status s = PostLocked(chunk);
+        if (!s.ok()) failed.emplace_back(chunk.op, s);
+      }
+    }
+    for (auto& f : failed) f.first->ChunkDone(f.second);
+  }
+
+ private:
+  struct Chunk {
+    WriteOp* op;
+    uint64 local;
+    uint32 lkey;
+    uint64 remote;
+    uint32 rkey;
+    uint32 size;
+  };
+
+  Status PostLocked(const Chunk& chunk) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    ibv_sge sge;
+    sge.addr = chunk.local;
+    sge.length = chunk.size;
+    sge.lkey = chunk.lkey;
+    ibv_send_wr wr;
+    memset(&wr, 0, sizeof(wr));
+    wr.wr_id = reinterpret_cast<uint64>(chunk.op);
+    wr.sg_list = &sge;
+    wr.num_sge = 1;
+    wr.opcode = IBV_WR_RDMA_WRITE;
+    wr.send_flags = IBV_SEND_SIGNALED;
+    wr.wr.rdma.remote_addr = chunk.remote;
+    wr.wr.rdma.rkey = chunk.rkey;
+    ibv_send_wr* bad_wr;
+    int r = ibv_post_send(qp_, &wr, &bad_wr);
+    if (r != 0) return VerbsError("write", r);
+    ++outstanding_;
+    return OkStatus();
+  }
+
+  VerbsDevice* const device_;
+  ibv_qp* const qp_;
+  const RdmaEndpoint endpoint_;
+
+  mutex mu_;
+  int outstanding_ TF_GUARDED_BY(mu_) = 0;
+  // Chunks waiting for room in the send queue.
+  std::deque<Chunk> queued_ TF_GUARDED_BY(mu_);
+};
+
+/* static */
+Status VerbsDevice::Create(const std::string& name, int port, int gid_index,
+                           std::unique_ptr<VerbsDevice>* device) {
+  std::unique_ptr<VerbsDevice> d(new VerbsDevice(port, gid_index));
+  int num_devices = 0;
+  ibv_device** devices = ibv_get_device_list(&num_devices);
+  if (devices == nullptr) return VerbsError("device listing", errno);
+  for (int i = 0; i < num_devices && d->context_ == nullptr; ++i) {
+    if (name.empty() || name == ibv_get_device_name(devices[i])) {
+      d->context_ = ibv_open_device(devices[i]);
+    }
+  }
+  ibv_free_device_list(devices);
+  if (d->context_ == nullptr) {
+    return errors::NotFound("No RDMA device ", name);
+  }
+
+  ibv_device_attr device_attr;
+  int r = ibv_query_device(d->context_, &device_attr);
+  if (r != 0) return VerbsError("device query", r);
+  r = ibv_query_port(d->context_, port, &d->port_attr_);
+  if (r != 0) return VerbsError("port query", r);
+  if (d->port_attr_.state != IBV_PORT_ACTIVE) {
+    return errors::Unavailable("RDMA port ", port, " is not active");
+  }
+  r = ibv_query_gid(d->context_, port, gid_index, &d->gid_);
+  if (r != 0) return VerbsError("GID query", r);
+
+  d->pd_ = ibv_alloc_pd(d->context_);
+  if (d->pd_ == nullptr) {
+    return VerbsError("protection domain allocation", errno);
+  }
+  d->comp_channel_ = ibv_create_comp_channel(d->context_);
+  if (d->comp_channel_ == nullptr) {
+    return VerbsError("completion channel creation", errno);
+  }
+  const int flags = fcntl(d->comp_channel_->fd, F_GETFL);
+  if (fcntl(d->comp_channel_->fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    return VerbsError("completion channel setup", errno);
+  }
+  const int cq_entries = std::min(device_attr.max_cqe, kMaxCqEntries);
+  d->cq_ = ibv_create_cq(d->context_, cq_entries, nullptr, d->comp_channel_,
+                         /*comp_vector=*/0);
+  if (d->cq_ == nullptr) return VerbsError("completion queue creation", errno);
+  r = ibv_req_notify_cq(d->cq_, /*solicited_only=*/0);
+  if (r != 0) return VerbsError("completion notification", r);
+  d->max_channels_ = std::min(cq_entries / kMaxSendWr, device_attr.max_qp);
+
+  VerbsDevice* raw = d.get();
+  d->poller_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "rdma_poller", [raw]() { raw->PollCompletions(); }));
+  *device = std::move(d);
+  return OkStatus();
+}
+
+VerbsDevice::~VerbsDevice() {
+  shutdown_.store(true);
+  poller_.reset();
+  {
+    mutex_lock l(mu_);
+    for (auto& region : regions_) ibv_dereg_mr(region.second);
+  }
+  if (cq_ != nullptr) ibv_destroy_cq(cq_);
+  if (comp_channel_ != nullptr) ibv_destroy_comp_channel(comp_channel_);
+  if (pd_ != nullptr) ibv_dealloc_pd(pd_);
+  if (context_ != nullptr) ibv_close_device(context_);
+}
+
+Status VerbsDevice::RegisterMemory(void* addr, size_t size, uint32* lkey,
+                                   uint32* rkey) {
+  ibv_mr* mr = ibv_reg_mr(pd_, addr, size,
+                          IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+  if (mr == nullptr) return VerbsError("memory registration", errno);
+  *lkey = mr->lkey;
+  *rkey = mr->rkey;
+  mutex_lock l(mu_);
+  regions_[addr] = mr;
+  return OkStatus();
+}
+
+void VerbsDevice::DeregisterMemory(void* addr) {
+  ibv_mr* mr;
+  {
+    mutex_lock l(mu_);
+    auto it = regions_.find(addr);
+    if (it == regions_.end()) return;
+    mr = it->second;
+    regions_.erase(it);
+  }
+  ibv_dereg_mr(mr);
+}
+
+Status VerbsDevice::CreateChannel(std::unique_ptr<RdmaChannel>* channel) {
+  if (num_channels_.fetch_add(1) >= max_channels_) {
+    num_channels_.fetch_sub(1);
+    return errors::ResourceExhausted("Too many RDMA channels, the limit is ",
+                                     max_channels_);
+  }
+  ibv_qp_init_attr init_attr;
+  memset(&init_attr, 0, sizeof(init_attr));
+  init_attr.send_cq = cq_;
+  init_attr.recv_cq = cq_;
+  init_attr.qp_type = IBV_QPT_RC;
+  init_attr.cap.max_send_wr = kMaxSendWr;
+  init_attr.cap.max_recv_wr = 1;
+  init_attr.cap.max_send_sge = 1;
+  init_attr.cap.max_recv_sge = 1;
+  ibv_qp* qp = ibv_create_qp(pd_, &init_attr);
+  if (qp == nullptr) {
+    num_channels_.fetch_sub(1);
+    return VerbsError("queue pair creation", errno);
+  }
+
+  RdmaEndpoint endpoint;
+  endpoint.set_lid(port_attr_.lid);
+  endpoint.set_gid(std::string(reinterpret_cast<const char*>(gid_.raw),
+                               sizeof(gid_.raw)));
+  endpoint.set_qp_num(qp->qp_num);
+  endpoint.set_psn(random::New64() & 0xffffff);
+  // Owns "qp" from here on.
+  auto c = std::make_unique<Channel>(this, qp, std::move(endpoint));
+
+  ibv_qp_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.qp_state = IBV_QPS_INIT;
+  attr.pkey_index = 0;
+  attr.port_num = port_;
+  attr.qp_access_flags = IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE;
+  int r = ibv_modify_qp(
+      qp, &attr,
+      IBV_QP_STATE | IBV_QP_PKEY_INDEX | IBV_QP_PORT | IBV_QP_ACCESS_FLAGS);
+  if (r != 0) return VerbsError("queue pair INIT transition", r);
+  *channel = std::move(c);
+  return OkStatus();
+}
+
+void VerbsDevice::PollCompletions() {
+  pollfd pfd;
+  pfd.fd = comp_channel_->fd;
+  pfd.events = POLLIN;
+  ibv_wc wcs[16];
+  while (!shutdown_.load()) {
+    pfd.revents = 0;
+    // Wakes up now and then to notice the shutdown.
+    if (poll(&pfd, 1, /*timeout=*/100) <= 0) continue;
+    ibv_cq* cq;
+    void* cq_context;
+    if (ibv_get_cq_event(comp_channel_, &cq, &cq_context) != 0) continue;
+    ibv_ack_cq_events(cq, 1);
+    // Completions that arrive from here on raise a new event.
+    int r = ibv_req_notify_cq(cq_, /*solicited_only=*/0);
+    if (r != 0) {
+      LOG(ERROR) << VerbsError("completion notification", r);
+    }
+    int n;
+    while ((n = ibv_poll_cq(cq_, 16, wcs)) > 0) {
+      for (int i = 0; i < n; ++i) {
+        WriteOp* op = reinterpret_cast<WriteOp*>(wcs[i].wr_id);
+        Status s = OkStatus();
+        if (wcs[i].status != IBV_WC_SUCCESS) {
+          s = errors::Unavailable("RDMA write failed: ",
+                                  ibv_wc_status_str(wcs[i].status));
+        }
+        op->channel->OnCompletion();
+        op->ChunkDone(s);
+      }
+    }
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,85 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_VERBS_DEVICE_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_VERBS_DEVICE_H_
+
+#include <infiniband/verbs.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/distributed_runtime/rdma/rdma_device.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// An RdmaDevice on libibverbs, for InfiniBand and RoCE adapters. The
+// channels are reliable connected queue pairs, whose completions are
+// processed by a thread of the device.
+class VerbsDevice : public RdmaDevice {
+ public:
+  // Opens the device named "name", or the first one if "name" is empty, and
+  // communicates through its port "port" with the GID at "gid_index".
+  static Status Create(const std::string& name, int port, int gid_index,
+                       std::unique_ptr<VerbsDevice>* device);
+
+  ~VerbsDevice() override;
+
+  Status RegisterMemory(void* addr, size_t size, uint32* lkey,
+                        uint32* rkey) override;
+  void DeregisterMemory(void* addr) override;
+  Status CreateChannel(std::unique_ptr<RdmaChannel>* channel) override;
+
+ private:
+  class Channel;
+  struct WriteOp;
+
+  VerbsDevice(int port, int gid_index) : port_(port), gid_index_(gid_index) {}
+
+  // Runs the callbacks of the completed writes until shutdown_ is set.
+  void PollCompletions();
+
+  const int port_;
+  const int gid_index_;
+  ibv_context* context_ = nullptr;
+  ibv_pd* pd_ = nullptr;
+  ibv_comp_channel* comp_channel_ = nullptr;
+  ibv_cq* cq_ = nullptr;
+  ibv_port_attr port_attr_;
+  ibv_gid gid_;
+  // The most channels whose writes fit in cq_ together.
+  int max_channels_ = 0;
+  std::atomic<int> num_channels_{0};
+
+  std::atomic<bool> shutdown_{false};
+  std::unique_ptr<Thread> poller_;
+
+  mutex mu_;
+  absl::flat_hash_map<void*, ibv_mr*> regions_ TF_GUARDED_BY(mu_);
+
+  VerbsDevice(const VerbsDevice&) = delete;
+  void operator=(const VerbsDevice&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RDMA_VERBS_DEVICE_H_
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_worker.h"
 
 #include <utility>
+#include <vector>
 
 #include "grpcpp/generic/generic_stub.h"
 #include "grpcpp/grpcpp.h"
@@ -66,6 +67,7 @@ class GrpcRemoteWorker : public WorkerInterface {
         instancesource_(Method(GrpcWorkerMethod::kCompleteInstance)),
         getstepsequence_(Method(GrpcWorkerMethod::kGetStepSequence)),
         markrecvfinished_(Method(GrpcWorkerMethod::kMarkRecvFinished)),
+        batchrecvtensor_(Method(GrpcWorkerMethod::kBatchRecvTensor)),
         logger_(logger),
         target_(target) {}
 
@@ -258,6 +260,29 @@ class GrpcRemoteWorker : public WorkerInterface {
     IssueRequest(request, response, recvtensor_, callback, call_opts);
   }
 
+  void BatchRecvTensorAsync(CallOptions* call_opts,
+                            const BatchRecvTensorRequest* request,
+                            std::vector<TensorResponse*>* responses,
+                            StatusCallback done) override {
+    VLOG(1) << "BatchRecvTensorAsync req: " << request->DebugString();
+    auto callback = [this, request, responses, done](Status s) {
+      if (s.ok()) {
+        for (int i = 0; i < request->request_size(); ++i) {
+          if ((*responses)[i]->metadata().require_ack()) {
+            IssueMarkRecvFinishedRequest(request->request(i).request_id());
+          }
+        }
+      }
+      // Note done() can delete this worker object, so we need to call done()
+      // last.
+      done(s);
+    };
+    new RPCState<std::vector<TensorResponse*>>(
+        &stub_, cq_, batchrecvtensor_, *request, responses, std::move(callback),
+        call_opts, callback_threadpool_, MaxRetries(),
+        /*fail_fast=*/true, &target_, GrpcMaybeParseBatchTensorResponse);
+  }
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override {
     IssueRequest(request, response, logging_, done);
@@ -333,6 +358,7 @@ class GrpcRemoteWorker : public WorkerInterface {
   const ::grpc::string instancesource_;
   const ::grpc::string getstepsequence_;
   const ::grpc::string markrecvfinished_;
+  const ::grpc::string batchrecvtensor_;
 
   // Support for logging.
   WorkerCacheLogger* logger_;
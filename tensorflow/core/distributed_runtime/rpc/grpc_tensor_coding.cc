@@ -250,5 +250,27 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
   }
 }
 
+void EncodeBatchRecvTensorResponseToByteBuffer(
+    std::vector<::grpc::ByteBuffer>* responses, ::grpc::ByteBuffer* result) {
+  std::vector<::grpc::Slice> slices;
+  std::vector<::grpc::Slice> response_slices;
+  for (::grpc::ByteBuffer& response : *responses) {
+    // The tag and varint32 length of BatchRecvTensorResponse::response,
+    // followed by the slices of the encoded response.
+    char space[16];
+    io::ProtoEncodeHelper e(space, sizeof(space));
+    e.WriteVarlengthBeginning(BatchRecvTensorResponse::kResponseFieldNumber,
+                              response.Length());
+    slices.emplace_back(e.data(), e.size());
+    response_slices.clear();
+    CHECK(response.Dump(&response_slices).ok());
+    for (::grpc::Slice& slice : response_slices) {
+      slices.push_back(std::move(slice));
+    }
+  }
+  ::grpc::ByteBuffer tmp(slices.data(), slices.size());
+  result->Swap(&tmp);
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
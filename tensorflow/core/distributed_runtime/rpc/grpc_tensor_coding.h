@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_TENSOR_CODING_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_TENSOR_CODING_H_
 
+#include <vector>
+
 #include "grpcpp/impl/codegen/byte_buffer.h"
 
 namespace tensorflow {
@@ -49,6 +51,15 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
                               ::grpc::ByteBuffer* result);
 
+// Encode the RecvTensorResponse protocol buffers in "responses", each
+// encoded by one of the functions above, into a byte buffer in a format that
+// is parseable as a BatchRecvTensorResponse protocol buffer holding them in
+// order. The slices of "responses" are shared rather than copied.
+//
+// Discards original contents of *result.
+void EncodeBatchRecvTensorResponseToByteBuffer(
+    std::vector<::grpc::ByteBuffer>* responses, ::grpc::ByteBuffer* result);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
@@ -17,10 +17,15 @@ limitations under the License.
 
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/device_attributes.pb.h"
+#include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
@@ -100,4 +105,100 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+class DummyDevice : public DeviceBase {
+ public:
+  explicit DummyDevice(Env* env) : DeviceBase(env) {
+    attr_.set_device_type("CPU");
+  }
+
+  const DeviceAttributes& attributes() const override { return attr_; }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return cpu_allocator();
+  }
+
+ private:
+  DeviceAttributes attr_;
+};
+
+TEST_F(GrpcTensorCodingTest, ParseSharesLargeTensorContent) {
+  DummyDevice cpu_device(Env::Default());
+  for (int64_t elems : {16, 1 << 16}) {
+    for (bool gpu_compatible : {false, true}) {
+      Tensor a(DT_FLOAT, TensorShape({elems}));
+      test::FillIota<float>(&a, 0);
+      ::grpc::ByteBuffer buf;
+      grpc::EncodeTensorToByteBuffer(false, a, false, &buf);
+
+      AllocatorAttributes attr;
+      attr.set_gpu_compatible(gpu_compatible);
+      TensorResponse response;
+      response.InitAlloc(&cpu_device, attr);
+      ASSERT_TRUE(GrpcMaybeParseTensorResponse(&buf, &response));
+      buf.Clear();
+      test::ExpectTensorEqual<float>(a, response.tensor());
+      // The large tensor is sent in a slice that points at the data of "a",
+      // which the response can keep using unless it must be pinned.
+      const bool shared =
+          response.tensor().tensor_data().data() == a.tensor_data().data();
+      EXPECT_EQ(shared, elems > 16 && !gpu_compatible);
+    }
+  }
+}
+
+TEST_F(GrpcTensorCodingTest, ParseBatchRecvTensorResponse) {
+  DummyDevice cpu_device(Env::Default());
+  // Small and large numeric tensors, a string tensor and a dead tensor.
+  std::vector<Tensor> tensors;
+  tensors.emplace_back(DT_FLOAT, TensorShape({16}));
+  test::FillIota<float>(&tensors.back(), 0);
+  tensors.emplace_back(DT_INT32, TensorShape({1 << 16}));
+  test::FillIota<int32>(&tensors.back(), 1);
+  tensors.emplace_back(DT_STRING, TensorShape({2}));
+  test::FillValues<tstring>(&tensors.back(), {"a", "bc"});
+  tensors.emplace_back(DT_FLOAT, TensorShape({3}));
+
+  std::vector<::grpc::ByteBuffer> encoded(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const bool is_dead = (i == tensors.size() - 1);
+    grpc::EncodeTensorToByteBuffer(is_dead, tensors[i], false, &encoded[i]);
+  }
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeBatchRecvTensorResponseToByteBuffer(&encoded, &buf);
+
+  std::vector<TensorResponse> responses(tensors.size());
+  std::vector<TensorResponse*> dst;
+  for (TensorResponse& response : responses) {
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    dst.push_back(&response);
+  }
+  ASSERT_TRUE(GrpcMaybeParseBatchTensorResponse(&buf, &dst));
+  test::ExpectTensorEqual<float>(tensors[0], responses[0].tensor());
+  test::ExpectTensorEqual<int32>(tensors[1], responses[1].tensor());
+  test::ExpectTensorEqual<tstring>(tensors[2], responses[2].tensor());
+  EXPECT_FALSE(responses[2].metadata().is_dead());
+  EXPECT_TRUE(responses[3].metadata().is_dead());
+
+  // The protocol buffer parses the same bytes.
+  std::vector<::grpc::Slice> slices;
+  (void)buf.Dump(&slices);
+  string tmp;
+  for (const auto& s : slices) {
+    tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+  }
+  BatchRecvTensorResponse batch;
+  ASSERT_TRUE(batch.ParseFromString(tmp));
+  ASSERT_EQ(batch.response_size(), 4);
+  Tensor t;
+  ASSERT_TRUE(t.FromProto(batch.response(1).tensor()));
+  test::ExpectTensorEqual<int32>(tensors[1], t);
+
+  // Fewer responses than expected, and more, fail to parse.
+  dst.pop_back();
+  EXPECT_FALSE(GrpcMaybeParseBatchTensorResponse(&buf, &dst));
+  dst.push_back(&responses[3]);
+  dst.push_back(&responses[0]);
+  EXPECT_FALSE(GrpcMaybeParseBatchTensorResponse(&buf, &dst));
+}
+
 }  // namespace tensorflow
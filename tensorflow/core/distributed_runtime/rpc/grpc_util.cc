@@ -15,10 +15,102 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "grpcpp/support/slice.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Aliases bytes of a received slice, which it keeps alive.
+class GrpcSliceBuffer : public TensorBuffer {
+ public:
+  GrpcSliceBuffer(::grpc::Slice slice, const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        slice_(std::move(slice)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("grpc_slice");
+  }
+  // The rest of the slice may belong to other messages.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const ::grpc::Slice slice_;
+  const size_t size_;
+};
+
+// Yields the "length" bytes at "offset" in "buffer", which hold one of the
+// responses in a BatchRecvTensorResponse. The first stream it returns reads
+// them from "input", which is positioned at "offset".
+class GrpcByteSubSource : public TensorResponse::Source {
+ public:
+  GrpcByteSubSource(GrpcByteSource* source, ::grpc::ByteBuffer* buffer,
+                    protobuf::io::ZeroCopyInputStream* input, int64_t offset,
+                    uint32 length)
+      : source_(source),
+        buffer_(buffer),
+        input_(input),
+        offset_(offset),
+        length_(length) {}
+
+  protobuf::io::ZeroCopyInputStream* contents() override {
+    stream_.reset();
+    if (input_ != nullptr) {
+      stream_.emplace(input_, length_);
+      input_ = nullptr;
+    } else {
+      // Only reached when ParseFrom() starts over.
+      reader_.emplace(buffer_);
+      reader_->Skip(offset_);
+      stream_.emplace(&*reader_, length_);
+    }
+    return &*stream_;
+  }
+
+  TensorBuffer* ShareBuffer(const char* data, size_t num_bytes) override {
+    return source_->ShareBuffer(data, num_bytes);
+  }
+
+ private:
+  GrpcByteSource* const source_;              // Not owned.
+  ::grpc::ByteBuffer* const buffer_;          // Not owned.
+  protobuf::io::ZeroCopyInputStream* input_;  // Not owned.
+  const int64_t offset_;
+  const uint32 length_;
+  std::optional<::grpc::ProtoBufferReader> reader_;
+  // Destroyed first, since it may back up the stream it reads.
+  std::optional<protobuf::io::LimitingInputStream> stream_;
+};
+
+}  // namespace
+
+TensorBuffer* GrpcByteSource::ShareBuffer(const char* data, size_t num_bytes) {
+  std::vector<::grpc::Slice> slices;
+  if (!buffer_->Dump(&slices).ok()) return nullptr;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data);
+  for (::grpc::Slice& slice : slices) {
+    // Inlined slices are copied by Dump, so they never contain "data".
+    const uintptr_t slice_begin = reinterpret_cast<uintptr_t>(slice.begin());
+    if (slice_begin <= begin &&
+        begin + num_bytes <= slice_begin + slice.size()) {
+      return new GrpcSliceBuffer(std::move(slice), data, num_bytes);
+    }
+  }
+  return nullptr;
+}
+
 bool GrpcMaybeParseTensorResponse(::grpc::ByteBuffer* src,
                                   TensorResponse* dst) {
   ::tensorflow::GrpcByteSource byte_source(src);
@@ -26,4 +118,31 @@ bool GrpcMaybeParseTensorResponse(::grpc::ByteBuffer* src,
   return s.ok();
 }
 
+bool GrpcMaybeParseBatchTensorResponse(::grpc::ByteBuffer* src,
+                                       std::vector<TensorResponse*>* dst) {
+  // The tag of BatchRecvTensorResponse::response, which is length delimited.
+  constexpr uint32 kResponseTag =
+      (BatchRecvTensorResponse::kResponseFieldNumber << 3) | 2;
+  ::tensorflow::GrpcByteSource byte_source(src);
+  protobuf::io::ZeroCopyInputStream* input = byte_source.contents();
+  for (TensorResponse* response : *dst) {
+    uint32 length;
+    {
+      protobuf::io::CodedInputStream coded(input);
+      if (coded.ReadTag() != kResponseTag || !coded.ReadVarint32(&length)) {
+        return false;
+      }
+    }
+    const int64_t offset = input->ByteCount();
+    {
+      GrpcByteSubSource sub_source(&byte_source, src, input, offset, length);
+      if (!response->ParseFrom(&sub_source).ok()) return false;
+    }
+    const int64_t unread = offset + length - input->ByteCount();
+    if (unread > 0 && !input->Skip(unread)) return false;
+  }
+  protobuf::io::CodedInputStream coded(input);
+  return coded.ReadTag() == 0;
+}
+
 }  // namespace tensorflow
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "grpcpp/grpcpp.h"
 #include "grpcpp/impl/codegen/proto_utils.h"
@@ -51,6 +52,10 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  // Shares the received slice that holds the data, unless it was
+  // decompressed into a temporary buffer.
+  TensorBuffer* ShareBuffer(const char* data, size_t num_bytes) override;
+
  private:
   void DeleteStream() {
     if (stream_) {
@@ -68,6 +73,12 @@ inline string GrpcIdKey() { return "tf-rpc"; }
 // Decode a TensorResponse without extra copying. This function is an optimized
 // variant of tsl::GrpcMaybeParseProto.
 bool GrpcMaybeParseTensorResponse(::grpc::ByteBuffer* src, TensorResponse* dst);
+
+// Decode a BatchRecvTensorResponse into one TensorResponse per response, as
+// GrpcMaybeParseTensorResponse does. "dst" must have as many elements as
+// there are responses.
+bool GrpcMaybeParseBatchTensorResponse(::grpc::ByteBuffer* src,
+                                       std::vector<TensorResponse*>* dst);
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_UTIL_H_
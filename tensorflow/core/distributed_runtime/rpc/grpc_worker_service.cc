@@ -158,6 +158,13 @@ class GrpcWorkerServiceThread {
          ++i) {
       EnqueueRecvTensorRequestRaw();
     }
+    for (int i = 0;
+         i < gtl::FindWithDefault(
+                 queue_depth_,
+                 static_cast<int>(GrpcWorkerMethod::kBatchRecvTensor), 100);
+         ++i) {
+      EnqueueBatchRecvTensorRequestRaw();
+    }
 
     void* tag;
     bool ok;
@@ -284,6 +291,26 @@ class GrpcWorkerServiceThread {
     EnqueueRecvTensorRequestRaw();
   }
 
+  void BatchRecvTensorHandlerRaw(
+      WorkerCall<BatchRecvTensorRequest, ::grpc::ByteBuffer>* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+
+      worker_->GrpcBatchRecvTensorAsync(
+          call_opts, &call->request, &call->response,
+          [call, call_opts](const Status& s) {
+            call->ClearCancelCallback();
+            delete call_opts;
+            if (!s.ok()) {
+              VLOG(3) << "Bad response from BatchRecvTensor:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    EnqueueBatchRecvTensorRequestRaw();
+  }
+
   void RecvBufHandler(WorkerCall<RecvBufRequest, RecvBufResponse>* call) {
     Schedule([this, call]() {
       CallOptions* call_opts = new CallOptions;
@@ -353,6 +380,19 @@ class GrpcWorkerServiceThread {
     }
   }
 
+  void EnqueueBatchRecvTensorRequestRaw() {
+    mutex_lock l(shutdown_mu_);
+    if (!is_shutdown_) {
+      tsl::Call<GrpcWorkerServiceThread, grpc::WorkerService::AsyncService,
+                BatchRecvTensorRequest, ::grpc::ByteBuffer>::
+          EnqueueRequestForMethod(
+              worker_service_, cq_.get(),
+              static_cast<int>(GrpcWorkerMethod::kBatchRecvTensor),
+              &GrpcWorkerServiceThread::BatchRecvTensorHandlerRaw,
+              true /* supports cancel*/);
+    }
+  }
+
   GrpcWorker* const worker_ = nullptr;  // Not owned.
   std::unique_ptr<::grpc::ServerCompletionQueue> cq_;
   std::unique_ptr<Thread> thread_;
@@ -447,13 +487,15 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
 
   bool cache_enabled = (response_cache_ != nullptr && request_id != 0);
 
-  auto do_response = [response, done, cache_enabled](const Tensor& tensor,
-                                                     bool is_dead,
-                                                     const Status& status) {
-    if (status.ok()) {
-      grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled, response);
+  auto do_response = [this, request, response, done, cache_enabled](
+                         const Tensor& tensor, bool is_dead,
+                         const Status& status) {
+    if (!status.ok()) {
+      done(status);
+      return;
     }
-    done(status);
+    EncodeRecvTensorResponseAsync(*request, tensor, is_dead, cache_enabled,
+                                  response, done);
   };
 
   // If response cache is enabled and the response cache already contains the
@@ -554,6 +596,63 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
       });
 }
 
+void GrpcWorker::GrpcBatchRecvTensorAsync(
+    CallOptions* opts, const BatchRecvTensorRequest* request,
+    ::grpc::ByteBuffer* response, StatusCallback done) {
+  VLOG(3) << "GrpcBatchRecvTensorAsync req: " << request->DebugString();
+  const int num_requests = request->request_size();
+  if (num_requests == 0) {
+    response->Clear();
+    done(OkStatus());
+    return;
+  }
+
+  // Each tensor is received with its own CallOptions, which are all
+  // cancelled with "opts".
+  struct BatchState {
+    explicit BatchState(int n)
+        : opts(new CallOptions[n]), responses(n), pending(n) {}
+    std::unique_ptr<CallOptions[]> opts;
+    std::vector<::grpc::ByteBuffer> responses;
+    mutex mu;
+    Status status TF_GUARDED_BY(mu);
+    int pending TF_GUARDED_BY(mu);
+  };
+  BatchState* state = new BatchState(num_requests);
+  opts->SetCancelCallback([state, num_requests]() {
+    for (int i = 0; i < num_requests; ++i) {
+      state->opts[i].StartCancel();
+    }
+  });
+  for (int i = 0; i < num_requests; ++i) {
+    GrpcRecvTensorAsync(
+        &state->opts[i], &request->request(i), &state->responses[i],
+        [opts, state, response, done](const Status& s) {
+          Status status;
+          {
+            mutex_lock l(state->mu);
+            state->status.Update(s);
+            if (--state->pending > 0) return;
+            status = state->status;
+          }
+          opts->ClearCancelCallback();
+          if (status.ok()) {
+            grpc::EncodeBatchRecvTensorResponseToByteBuffer(&state->responses,
+                                                           response);
+          }
+          delete state;
+          done(status);
+        });
+  }
+}
+
+void GrpcWorker::EncodeRecvTensorResponseAsync(
+    const RecvTensorRequest& request, const Tensor& tensor, bool is_dead,
+    bool require_ack, ::grpc::ByteBuffer* response, StatusCallback done) {
+  grpc::EncodeTensorToByteBuffer(is_dead, tensor, require_ack, response);
+  done(OkStatus());
+}
+
 namespace {
 // If RecvBufRespExtra.tensor_content is a single large string, then gRPC
 // can stall on the recv side when the string buffer needs to be enlarged,
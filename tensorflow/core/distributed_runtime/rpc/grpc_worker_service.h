@@ -51,6 +51,13 @@ class GrpcWorker : public Worker {
                                    ::grpc::ByteBuffer* response,
                                    StatusCallback done);
 
+  // Receives the tensors of "request->request()" as GrpcRecvTensorAsync
+  // does, into one response that packs theirs.
+  virtual void GrpcBatchRecvTensorAsync(CallOptions* opts,
+                                        const BatchRecvTensorRequest* request,
+                                        ::grpc::ByteBuffer* response,
+                                        StatusCallback done);
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override;
 
@@ -67,6 +74,16 @@ class GrpcWorker : public Worker {
 
   void RemoveCacheEntryForId(int64_t request_id);
 
+ protected:
+  // Encodes "tensor" as the response to "request", and calls "done". A
+  // transport can override this to send the contents of the tensor out of
+  // band.
+  virtual void EncodeRecvTensorResponseAsync(const RecvTensorRequest& request,
+                                             const Tensor& tensor, bool is_dead,
+                                             bool require_ack,
+                                             ::grpc::ByteBuffer* response,
+                                             StatusCallback done);
+
  private:
   std::unique_ptr<RpcResponseCache> response_cache_;
   const int32 recv_buf_max_chunk_;
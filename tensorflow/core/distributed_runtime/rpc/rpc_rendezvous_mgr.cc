@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -31,15 +36,141 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+// Sends the RecvTensor requests to each worker that start within a window of
+// each other in one BatchRecvTensor call.
+class RecvTensorBatcher
+    : public std::enable_shared_from_this<RecvTensorBatcher> {
+ public:
+  RecvTensorBatcher(Env* env, int64_t window_micros, int max_batch_size)
+      : env_(env),
+        window_micros_(window_micros),
+        max_batch_size_(max_batch_size) {}
+
+  // Like wi->RecvTensorAsync(opts, request, response, done), where "wi"
+  // talks to "src_worker". "wi" must stay valid until "done" is called.
+  // Cancelling "opts" cancels the whole batch.
+  void RecvTensorAsync(const string& src_worker, WorkerInterface* wi,
+                       CallOptions* opts, const RecvTensorRequest* request,
+                       TensorResponse* response, StatusCallback done) {
+    std::shared_ptr<Batch> batch;
+    std::shared_ptr<Batch> full;
+    {
+      mutex_lock l(mu_);
+      std::shared_ptr<Batch>& pending = pending_[src_worker];
+      if (pending == nullptr) {
+        pending = std::make_shared<Batch>();
+        pending->wi = wi;
+        batch = pending;
+      }
+      // Before the batch can be sent, so that it outlives the callback.
+      opts->SetCancelCallback([b = pending.get()]() { b->Cancel(); });
+      pending->items.push_back({opts, request, response, std::move(done)});
+      if (pending->items.size() >= max_batch_size_) {
+        full = std::move(pending);
+        pending_.erase(src_worker);
+      }
+    }
+    if (full != nullptr) {
+      Send(std::move(full));
+    } else if (batch != nullptr) {
+      // The first request of the batch starts its window.
+      env_->SchedClosureAfter(
+          window_micros_,
+          [self = shared_from_this(), src_worker, batch = std::move(batch)]() {
+            self->Flush(src_worker, batch);
+          });
+    }
+  }
+
+ private:
+  struct Item {
+    CallOptions* opts;
+    const RecvTensorRequest* request;
+    TensorResponse* response;
+    StatusCallback done;
+  };
+
+  struct Batch {
+    void Cancel() {
+      {
+        mutex_lock l(mu);
+        cancelled = true;
+      }
+      opts.StartCancel();
+    }
+
+    WorkerInterface* wi;  // The one of the first item.
+    std::vector<Item> items;
+    CallOptions opts;
+    BatchRecvTensorRequest request;
+    std::vector<TensorResponse*> responses;
+    mutex mu;
+    bool cancelled TF_GUARDED_BY(mu) = false;
+  };
+
+  // Sends "batch" unless it was sent when it filled up.
+  void Flush(const string& src_worker, const std::shared_ptr<Batch>& batch) {
+    {
+      mutex_lock l(mu_);
+      auto it = pending_.find(src_worker);
+      if (it == pending_.end() || it->second != batch) return;
+      pending_.erase(it);
+    }
+    Send(batch);
+  }
+
+  void Send(std::shared_ptr<Batch> batch) {
+    for (const Item& item : batch->items) {
+      *batch->request.add_request() = *item.request;
+      batch->responses.push_back(item.response);
+    }
+    Batch* b = batch.get();
+    b->wi->BatchRecvTensorAsync(
+        &b->opts, &b->request, &b->responses, [batch](const Status& s) {
+          for (Item& item : batch->items) {
+            item.opts->ClearCancelCallback();
+          }
+          for (Item& item : batch->items) {
+            item.done(s);
+          }
+        });
+    // As in RpcRecvTensorCall::StartRTCall, a cancellation before the call
+    // registered its own callback must be repeated.
+    bool cancelled;
+    {
+      mutex_lock l(b->mu);
+      cancelled = b->cancelled;
+    }
+    if (cancelled) b->opts.StartCancel();
+  }
+
+  Env* const env_;
+  const int64_t window_micros_;
+  const size_t max_batch_size_;
+
+  mutex mu_;
+  // The batch to send next to each worker, by name.
+  absl::flat_hash_map<string, std::shared_ptr<Batch>> pending_
+      TF_GUARDED_BY(mu_);
+
+  RecvTensorBatcher(const RecvTensorBatcher&) = delete;
+  void operator=(const RecvTensorBatcher&) = delete;
+};
+
 namespace {
 
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
-  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id)
-      : BaseRemoteRendezvous(env, step_id) {}
+  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id,
+                      RecvTensorTransport* transport,
+                      RecvTensorBatcher* batcher)
+      : BaseRemoteRendezvous(env, step_id),
+        transport_(transport),
+        batcher_(batcher) {}
 
  protected:
   void RecvFromRemoteAsync(const Rendezvous::ParsedKey& parsed,
@@ -49,6 +180,9 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  private:
   ~RpcRemoteRendezvous() override {}
 
+  RecvTensorTransport* const transport_;  // Not owned, may be nullptr.
+  RecvTensorBatcher* const batcher_;      // Not owned, may be nullptr.
+
   RpcRemoteRendezvous(const RpcRemoteRendezvous&) = delete;
   void operator=(const RpcRemoteRendezvous&) = delete;
 };
@@ -60,8 +194,11 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
 
   void Init(WorkerInterface* wi, int64_t step_id, StringPiece key,
             AllocatorAttributes alloc_attrs, Device* dst_device,
-            const Rendezvous::Args& recv_args, Rendezvous::DoneCallback done) {
+            const Rendezvous::Args& recv_args, Rendezvous::DoneCallback done,
+            RecvTensorTransport* transport, RecvTensorBatcher* batcher) {
     wi_ = wi;
+    transport_ = transport;
+    batcher_ = batcher;
     alloc_attrs_ = alloc_attrs;
     dst_device_ = dst_device;
     recv_args_ = recv_args;
@@ -69,6 +206,10 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
     req_.set_request_id(GetUniqueRequestId());
+    if (transport_ != nullptr) {
+      transport_->PrepareRequest(src_worker_, dst_device_, alloc_attrs_, &req_,
+                                 &buffer_);
+    }
   }
 
   void Reset() {
@@ -79,6 +220,10 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
 
     alloc_attrs_ = AllocatorAttributes();
     dst_device_ = nullptr;
+    transport_ = nullptr;
+    batcher_ = nullptr;
+    buffer_ = Tensor();
+    tensor_in_buffer_ = false;
     // We don't clear opts_ and assume that Init will set up the state for
     // opts_ appropriately.
     req_.Clear();
@@ -122,7 +267,9 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     wi_ = nullptr;
   }
 
-  const Tensor& tensor() const { return resp_.tensor(); }
+  const Tensor& tensor() const {
+    return tensor_in_buffer_ ? buffer_ : resp_.tensor();
+  }
 
   bool is_dead() const { return resp_.metadata().is_dead(); }
 
@@ -142,13 +289,23 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
       // Make sure the Rendezvous abort checking is finished before running the
       // callback, which might destroy the current call object.
       abort_checked->WaitForNotification();
-      if (!s.ok()) {
+      Status status = s;
+      if (status.ok() && transport_ != nullptr) {
+        status = transport_->FinishRequest(src_worker_, req_, resp_.metadata(),
+                                           &buffer_, &tensor_in_buffer_);
+      }
+      if (!status.ok()) {
         mutex_lock l(mu_);
-        status_.Update(s);
+        status_.Update(status);
       }
       recv_done();
     };
-    wi_->RecvTensorAsync(&opts_, &req_, &resp_, std::move(cb));
+    if (batcher_ != nullptr) {
+      batcher_->RecvTensorAsync(src_worker_, wi_, &opts_, &req_, &resp_,
+                                std::move(cb));
+    } else {
+      wi_->RecvTensorAsync(&opts_, &req_, &resp_, std::move(cb));
+    }
 
     // NOTE: Check if the rendezvous was aborted after sending out the RPC. The
     // ordering is important because `StartAbort` could be called right before
@@ -175,6 +332,11 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   CallOptions opts_;
   RecvTensorRequest req_;
   TensorResponse resp_;
+  RecvTensorTransport* transport_ = nullptr;  // Not owned.
+  RecvTensorBatcher* batcher_ = nullptr;      // Not owned.
+  // Where "transport_" may have the contents of the tensor written.
+  Tensor buffer_;
+  bool tensor_in_buffer_ = false;
   Rendezvous::Args recv_args_;
   Rendezvous::DoneCallback done_;
 
@@ -270,7 +432,7 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
   }
 
   call->Init(rwi, step_id_, parsed.FullKey(), recv_args.alloc_attrs, dst_device,
-             recv_args, std::move(done));
+             recv_args, std::move(done), transport_, batcher_);
 
   // Record "call" in calls_ so that it can be aborted cleanly.
   RegisterCall(call, recv_args);
@@ -308,12 +470,26 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
 }  // namespace
 
 RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env)
-    : BaseRendezvousMgr(env) {}
+    : RpcRendezvousMgr(env, nullptr) {}
+
+RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env,
+                                   RecvTensorTransport* transport)
+    : BaseRendezvousMgr(env), transport_(transport) {
+  int64_t window_micros, max_batch_size;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_RPC_RECV_TENSOR_BATCH_WINDOW_MICROS", 0,
+                                  &window_micros));
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_RPC_RECV_TENSOR_MAX_BATCH_SIZE", 128,
+                                  &max_batch_size));
+  if (window_micros > 0 && max_batch_size > 1) {
+    batcher_ = std::make_shared<RecvTensorBatcher>(env->env, window_micros,
+                                                   max_batch_size);
+  }
+}
 
 tsl::core::RefCountPtr<BaseRemoteRendezvous> RpcRendezvousMgr::Create(
     int64_t step_id, const WorkerEnv* worker_env) {
   return tsl::core::RefCountPtr<BaseRemoteRendezvous>(
-      new RpcRemoteRendezvous(worker_env, step_id));
+      new RpcRemoteRendezvous(worker_env, step_id, transport_, batcher_.get()));
 }
 
 }  // end namespace tensorflow
@@ -16,13 +16,45 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RPC_RENDEZVOUS_MGR_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RPC_RENDEZVOUS_MGR_H_
 
+#include <memory>
+#include <string>
+
 #include "tensorflow/core/distributed_runtime/base_rendezvous_mgr.h"
 #include "tensorflow/core/distributed_runtime/worker_env.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace tensorflow {
 
+class Device;
 class DeviceMgr;
+class RecvTensorBatcher;
+
+// Lets a transport move the contents of received tensors outside of the
+// RecvTensor RPC, e.g. with RDMA. The RPC still carries the request and the
+// metadata of the tensor.
+class RecvTensorTransport {
+ public:
+  virtual ~RecvTensorTransport() {}
+
+  // Called before "request" is sent to "src_worker". May set its dma_ok and
+  // transport_options, and a "buffer" for the sender to write the contents
+  // of the tensor to.
+  virtual void PrepareRequest(const std::string& src_worker, Device* dst_device,
+                              const AllocatorAttributes& alloc_attrs,
+                              RecvTensorRequest* request, Tensor* buffer) = 0;
+
+  // Called with the metadata of the response to "request". Sets "*written"
+  // to true, and "*buffer" to the received tensor, if its contents were
+  // written to "buffer" instead of sent in the response.
+  virtual Status FinishRequest(const std::string& src_worker,
+                               const RecvTensorRequest& request,
+                               const RecvTensorResponse& response,
+                               Tensor* buffer, bool* written) = 0;
+};
 
 // RendezvousMgr keeps track of a set of local rendezvous instances.
 // All tensors sent by this worker are buffered in a RendezvousMgr
@@ -42,15 +74,30 @@ class DeviceMgr;
 //
 // Tensors sent and recved through rendezvous managed by this
 // RendezvousMgr must have keys generated by Rendezvous::CreateKey.
+//
+// If TF_RPC_RECV_TENSOR_BATCH_WINDOW_MICROS is set, the tensors received
+// from the same worker within that many microseconds of each other, up to
+// TF_RPC_RECV_TENSOR_MAX_BATCH_SIZE (default 128) of them, are received in
+// one BatchRecvTensor RPC. This trades latency for fewer RPCs when many
+// small tensors are received at once, and needs the workers sent to to
+// support BatchRecvTensor.
 class RpcRendezvousMgr : public BaseRendezvousMgr {
  public:
   explicit RpcRendezvousMgr(const WorkerEnv* env);
 
+  // Receives the tensors through "transport" when possible. "transport" is
+  // not owned, and must outlive the rendezvous manager.
+  RpcRendezvousMgr(const WorkerEnv* env, RecvTensorTransport* transport);
+
  protected:
   tsl::core::RefCountPtr<BaseRemoteRendezvous> Create(
       int64_t step_id, const WorkerEnv* worker_env) override;
 
  private:
+  RecvTensorTransport* const transport_;  // Not owned, may be nullptr.
+  // Shared with its pending timers. nullptr unless batching is enabled.
+  std::shared_ptr<RecvTensorBatcher> batcher_;
+
   RpcRendezvousMgr(const RpcRendezvousMgr&) = delete;
   void operator=(const RpcRendezvousMgr&) = delete;
 };
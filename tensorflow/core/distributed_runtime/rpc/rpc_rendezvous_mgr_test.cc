@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/test_utils.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -22,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
@@ -66,10 +71,31 @@ class DummyWorker : public TestWorkerInterface {
       done(OkStatus());
     });
   }
+
+  void BatchRecvTensorAsync(CallOptions* opts,
+                            const BatchRecvTensorRequest* request,
+                            std::vector<TensorResponse*>* responses,
+                            StatusCallback done) override {
+    {
+      mutex_lock l(mu_);
+      batch_sizes_.push_back(request->request_size());
+    }
+    SchedClosure([done = std::move(done)]() { done(OkStatus()); });
+  }
+
+  std::vector<int> batch_sizes() {
+    mutex_lock l(mu_);
+    return batch_sizes_;
+  }
+
+ private:
+  mutex mu_;
+  std::vector<int> batch_sizes_ TF_GUARDED_BY(mu_);
 };
 
 // Fake cache implementation for WorkerEnv.
 class DummyWorkerCache : public WorkerCacheInterface {
+ public:
   void ListWorkers(std::vector<string>* workers) const override {}
   void ListWorkersInJob(const string& job_name,
                         std::vector<string>* workers) const override {}
@@ -95,6 +121,8 @@ class DummyWorkerCache : public WorkerCacheInterface {
   void GetDeviceLocalityAsync(const string& device, DeviceLocality* locality,
                               StatusCallback done) override {}
 
+  DummyWorker* dummy_remote_worker() { return dummy_remote_worker_; }
+
  private:
   DummyWorker* dummy_remote_worker_ = nullptr;
 };
@@ -342,4 +370,48 @@ TEST_F(RpcRendezvousMgrTest, RemoteRecvAsyncMany) {
   rmgr_.Cleanup(step_id);
 }
 
+TEST_F(RpcRendezvousMgrTest, RemoteRecvAsyncBatched) {
+  setenv("TF_RPC_RECV_TENSOR_BATCH_WINDOW_MICROS", "100000", 1);
+  setenv("TF_RPC_RECV_TENSOR_MAX_BATCH_SIZE", "8", 1);
+  RpcRendezvousMgr rmgr(&env);
+  unsetenv("TF_RPC_RECV_TENSOR_BATCH_WINDOW_MICROS");
+  unsetenv("TF_RPC_RECV_TENSOR_MAX_BATCH_SIZE");
+
+  const int64_t step_id = 123;
+  const int num_requests = 20;
+  {
+    tsl::core::RefCountPtr<RemoteRendezvous> rendez = rmgr.Find(step_id);
+    TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+    Rendezvous::Args args;
+    mutex mu;
+    Status status = OkStatus();
+    BlockingCounter counter(num_requests);
+    for (int i = 0; i < num_requests; i++) {
+      const Rendezvous::ParsedKey key = MakeKey(Rendezvous::CreateKey(
+          "/job:worker/replica:1/task:2/cpu:0", 7890,
+          "/job:mnist/replica:1/task:2/cpu:1", strings::StrCat("foo", i),
+          FrameAndIter(0, 0)));
+      rendez->RecvAsync(
+          key, args,
+          [&mu, &status, &counter](const Status& s, const Rendezvous::Args&,
+                                   const Rendezvous::Args&, const Tensor&,
+                                   const bool) {
+            {
+              mutex_lock l(mu);
+              status.Update(s);
+            }
+            counter.DecrementCount();
+          });
+    }
+    counter.Wait();
+    TF_ASSERT_OK(status);
+  }
+  rmgr.Cleanup(step_id);
+
+  // Two full batches, and the rest once the window closed.
+  std::vector<int> batch_sizes = cache_->dummy_remote_worker()->batch_sizes();
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  EXPECT_EQ(batch_sizes, std::vector<int>({4, 8, 8}));
+}
+
 }  // namespace tensorflow
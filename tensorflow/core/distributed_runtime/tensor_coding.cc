@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <cstdint>
+
 #include "google/protobuf/any.pb.h"
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -141,10 +143,44 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
   return input->DecrementRecursionDepthAndPopLimit(p.first);
 }
 
+// Tensor contents at least this large are shared with the source instead
+// of copied, if the source allows it. Smaller ones are cheap to copy, and
+// would pin parts of the received message that are much larger than them.
+constexpr int kMinSharedTensorBytes = 64 << 10;
+
 }  // namespace
 
+// Sets tensor_ to the "num_bytes" bytes at the current position of "input"
+// without copying them, and skips them. Returns false, leaving "input"
+// untouched, if the bytes have to be copied.
+bool TensorResponse::ShareTensorContent(Source* source,
+                                        protobuf::io::CodedInputStream* input,
+                                        DataType dtype,
+                                        const TensorShape& shape,
+                                        int num_bytes) {
+  // The received bytes are not registered with any device or NIC.
+  if (alloc_attrs_.gpu_compatible() || alloc_attrs_.nic_compatible()) {
+    return false;
+  }
+  if (shape.num_elements() * DataTypeSize(dtype) != num_bytes) return false;
+  const void* data;
+  int size;
+  if (!input->GetDirectBufferPointer(&data, &size) || size < num_bytes ||
+      reinterpret_cast<uintptr_t>(data) % Allocator::kAllocatorAlignment != 0) {
+    return false;
+  }
+  TensorBuffer* buf =
+      source->ShareBuffer(static_cast<const char*>(data), num_bytes);
+  if (buf == nullptr) return false;
+  tensor_ = Tensor(dtype, shape, buf);
+  buf->Unref();
+  // Cannot fail, the bytes are all in the buffer of "input".
+  return input->Skip(num_bytes);
+}
+
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    Source* source, protobuf::io::CodedInputStream* input,
+    TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -195,12 +231,14 @@ bool TensorResponse::ParseTensorSubmessage(
         if (!ReadVarintSizeAsInt(input, &num_bytes)) return false;
         seen_tensor_content = true;
         TensorShape shape(tensor_meta->tensor_shape());
+        if (num_bytes >= kMinSharedTensorBytes &&
+            ShareTensorContent(source, input, tensor_meta->dtype(), shape,
+                               num_bytes)) {
+          break;
+        }
         Tensor t(allocator_, tensor_meta->dtype(), shape);
         StringPiece buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
-        // TODO(jeff,sanjay): Figure out a way to avoid this copy if
-        // the underlying ZeroCopyInputStream data is properly aligned
-        // and compatible with what allocator_ wants.
         if (!input->ReadRaw(const_cast<char*>(buf.data()), num_bytes))
           return false;
         tensor_ = std::move(t);
@@ -233,7 +271,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(source, &input, meta_.mutable_tensor())) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
@@ -63,6 +63,17 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // Returns a buffer that shares the "num_bytes" bytes at "data", which
+    // were yielded by the stream most recently returned by contents(), and
+    // keeps them alive after the stream is gone. The caller owns a
+    // reference to the result.
+    //
+    // Returns nullptr, the default, if the data cannot be shared, in which
+    // case ParseFrom copies it into a newly allocated tensor.
+    virtual TensorBuffer* ShareBuffer(const char* data, size_t num_bytes) {
+      return nullptr;
+    }
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -91,8 +102,13 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
+  bool ShareTensorContent(Source* source,
+                          protobuf::io::CodedInputStream* input,
+                          DataType dtype, const TensorShape& shape,
+                          int num_bytes);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
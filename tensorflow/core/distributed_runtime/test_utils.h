@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TEST_UTILS_H_
 
 #include <unordered_map>
+#include <vector>
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
 #include "tensorflow/core/util/device_name_utils.h"
@@ -84,6 +85,13 @@ class TestWorkerInterface : public WorkerInterface {
     done(errors::Unimplemented("RecvTensorAsync"));
   }
 
+  void BatchRecvTensorAsync(CallOptions* opts,
+                            const BatchRecvTensorRequest* request,
+                            std::vector<TensorResponse*>* responses,
+                            StatusCallback done) override {
+    done(errors::Unimplemented("BatchRecvTensorAsync"));
+  }
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override {
     done(errors::Unimplemented("LoggingAsync"));
@@ -502,4 +502,12 @@ void Worker::RecvTensorAsync(CallOptions* opts,
   done(errors::Unimplemented("Worker::RecvTensorAsync()"));
 }
 
+void Worker::BatchRecvTensorAsync(CallOptions* opts,
+                                  const BatchRecvTensorRequest* request,
+                                  std::vector<TensorResponse*>* responses,
+                                  StatusCallback done) {
+  // Like RecvTensorAsync, this needs a transport-specific implementation.
+  done(errors::Unimplemented("Worker::BatchRecvTensorAsync()"));
+}
+
 }  // namespace tensorflow
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_WORKER_INTERFACE_H_
 
 #include <functional>
+#include <vector>
 
 #include "tensorflow/core/distributed_runtime/call_options.h"
 #include "tensorflow/core/distributed_runtime/message_wrappers.h"
@@ -106,6 +107,13 @@ class WorkerInterface {
                                TensorResponse* response,
                                StatusCallback done) = 0;
 
+  // Receives the tensors of "request->request()" in one call, into the
+  // corresponding elements of "responses".
+  virtual void BatchRecvTensorAsync(CallOptions* opts,
+                                    const BatchRecvTensorRequest* request,
+                                    std::vector<TensorResponse*>* responses,
+                                    StatusCallback done) = 0;
+
   virtual void LoggingAsync(const LoggingRequest* request,
                             LoggingResponse* response, StatusCallback done) = 0;
 
@@ -110,6 +110,11 @@ struct CollImplDetails {
   int max_subdivs_per_device = -1;  // Upper bound on subdivisions per device.
   std::vector<int> subdiv_offsets;
   std::vector<int> subdiv_source_rank;  // rank of source in each subdiv
+  // When ring_segments > 0 each subdivision of a RingReduce chunk is further
+  // split into that many segments, which travel the ring one after another
+  // so that reducing one overlaps transferring the next. When 0 the count is
+  // derived from the tensor size and the link model of ring_reducer.cc.
+  int ring_segments = 0;
   std::vector<int32>
       dependencies;           // collective instances on which this node depends
   string communication_hint;  // user-supplied hint for implementation choice,
@@ -1042,7 +1042,9 @@ Status DatasetBase::DatasetGraphDefBuilder::AddResourceHelper(
 }
 
 DatasetBaseIterator::DatasetBaseIterator(const BaseParams& params)
-    : params_(params) {
+    : params_(params),
+      buffer_pool_client_(model::ElementBufferPool::Global(),
+                          params.dataset->node_name()) {
   params_.dataset->Ref();
   VLOG(2) << prefix() << " constructor";
   strings::StrAppend(&traceme_metadata_, "name=", dataset()->metadata().name());
@@ -1478,25 +1478,45 @@ class DatasetBaseIterator : public IteratorBase {
     }
   }
 
-  // When modeling is enabled, this method records the fact that this iterator
-  // has dequeued an element from an internal buffer.
+  // Records the fact that this iterator has dequeued an element from an
+  // internal buffer, in the model when modeling is enabled and in the
+  // process-wide element buffer pool when it is enabled.
   void RecordBufferDequeue(IteratorContext* ctx,
                            const std::vector<Tensor>& element) {
+    if (!collect_resource_usage(ctx) && !buffer_pool_client_.enabled()) {
+      return;
+    }
+    int64_t num_bytes = GetAllocatedBytes(element);
+    buffer_pool_client_.RecordDequeue(num_bytes);
     if (collect_resource_usage(ctx)) {
-      node_->record_buffer_event(-GetAllocatedBytes(element), -1);
+      node_->record_buffer_event(-num_bytes, -1);
       DCHECK_GE(node_->buffered_elements(), 0);
     }
   }
 
-  // When modeling is enabled, this method records the fact that this iterator
-  // has enqueued an element in an internal buffer.
+  // Records the fact that this iterator has enqueued an element in an internal
+  // buffer, in the model when modeling is enabled and in the process-wide
+  // element buffer pool when it is enabled.
   void RecordBufferEnqueue(IteratorContext* ctx,
                            const std::vector<Tensor>& element) {
+    if (!collect_resource_usage(ctx) && !buffer_pool_client_.enabled()) {
+      return;
+    }
+    int64_t num_bytes = GetAllocatedBytes(element);
+    buffer_pool_client_.RecordEnqueue(num_bytes);
     if (collect_resource_usage(ctx)) {
-      node_->record_buffer_event(GetAllocatedBytes(element), 1);
+      node_->record_buffer_event(num_bytes, 1);
     }
   }
 
+  // Blocks while the process-wide element buffer pool is over its limit and
+  // this iterator holds buffered elements. Threads that fill the internal
+  // buffers of an iterator call this before producing a new element. Returns
+  // `Cancelled` if `cancellation_manager` is cancelled while waiting.
+  Status WaitForBufferCapacity(CancellationManager* cancellation_manager) {
+    return buffer_pool_client_.WaitForCapacity(cancellation_manager);
+  }
+
   // When modeling is enabled, this method records the fact that this iterator
   // has produced an element and its size in bytes.
   void RecordElement(IteratorContext* ctx, std::vector<Tensor>* out_tensors) {
@@ -1541,6 +1561,7 @@ class DatasetBaseIterator : public IteratorBase {
 
   string traceme_metadata_;
   BaseParams params_;
+  model::ElementBufferPool::Client buffer_pool_client_;
 };
 
 // Represents an iterator that is associated with a particular dataset
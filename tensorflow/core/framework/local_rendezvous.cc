@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/local_rendezvous.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -118,6 +119,31 @@ void LocalRendezvous::ItemQueue::push_back(Item* item) {
   }
 }
 
+// A rendezvous slot moves from kEmpty to either kSent (the Send arrived first
+// and parked its tensor) or kWaiting (the Recv arrived first and parked its
+// callback), and then to kConsumed. Whoever moves the slot to kConsumed owns
+// the parked fields: it moves them out before invoking any callback, so the
+// callback may destroy the rendezvous.
+struct LocalRendezvous::Slot {
+  enum State { kEmpty = 0, kSent = 1, kWaiting = 2, kConsumed = 3 };
+
+  std::atomic<int> state{kEmpty};
+
+  // Valid while `state == kSent`.
+  Rendezvous::Args send_args;
+  Tensor value;
+  bool is_dead = false;
+
+  // Valid while `state == kWaiting`.
+  Rendezvous::Args recv_args;
+  Rendezvous::DoneCallback waiter;
+  tsl::core::RefCountPtr<Rendezvous> rc_owner;
+};
+
+struct LocalRendezvous::SlotChunk {
+  Slot slots[kSlotsPerChunk];
+};
+
 LocalRendezvous::~LocalRendezvous() {
   // Before destroying this rendezvous instance, make sure all the done-callback
   // calls have finished and the tensors have been released from the queue.
@@ -138,6 +164,180 @@ LocalRendezvous::~LocalRendezvous() {
   if (table_not_empty) {
     DoAbort(absl::CancelledError("LocalRendezvous deleted"));
   }
+  for (auto& chunk_ptr : slot_chunks_) {
+    SlotChunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (chunk == nullptr) continue;
+    for (Slot& slot : chunk->slots) {
+      CloseSlot(&slot, absl::CancelledError("LocalRendezvous deleted"));
+    }
+    delete chunk;
+  }
+}
+
+LocalRendezvous::Slot* LocalRendezvous::GetSlot(int64_t index) {
+  if (index < 0 || index >= kSlotsPerChunk * kMaxSlotChunks) {
+    return nullptr;
+  }
+  std::atomic<SlotChunk*>& chunk_ptr = slot_chunks_[index / kSlotsPerChunk];
+  SlotChunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+  if (TF_PREDICT_FALSE(chunk == nullptr)) {
+    auto* new_chunk = new SlotChunk;
+    if (chunk_ptr.compare_exchange_strong(chunk, new_chunk)) {
+      chunk = new_chunk;
+    } else {
+      // Another thread installed the chunk first.
+      delete new_chunk;
+    }
+  }
+  return &chunk->slots[index % kSlotsPerChunk];
+}
+
+void LocalRendezvous::CloseSlot(Slot* slot, const Status& status) {
+  int state = slot->state.load(std::memory_order_acquire);
+  while (state != Slot::kConsumed) {
+    if (!slot->state.compare_exchange_weak(state, Slot::kConsumed)) continue;
+    if (state == Slot::kWaiting) {
+      Rendezvous::DoneCallback waiter = std::move(slot->waiter);
+      Rendezvous::Args recv_args = slot->recv_args;
+      tsl::core::RefCountPtr<Rendezvous> rc_owner = std::move(slot->rc_owner);
+      waiter(status, Rendezvous::Args(), recv_args, Tensor(),
+             /*is_dead=*/false);
+      if (recv_args.device_context) {
+        recv_args.device_context->Unref();
+      }
+    } else if (state == Slot::kSent) {
+      if (slot->send_args.device_context) {
+        slot->send_args.device_context->Unref();
+      }
+      slot->value = Tensor();
+    }
+    return;
+  }
+}
+
+Status LocalRendezvous::SendToSlot(Slot* slot,
+                                   const Rendezvous::Args& send_args,
+                                   const Tensor& val, const bool is_dead) {
+  if (TF_PREDICT_FALSE(aborted_.load(std::memory_order_acquire))) {
+    return status();
+  }
+  // Park the message. The fields are only published to the receiver if the
+  // slot is still empty.
+  slot->send_args = send_args;
+  if (send_args.device_context) {
+    send_args.device_context->Ref();
+  }
+  slot->value = val;
+  slot->is_dead = is_dead;
+  int state = Slot::kEmpty;
+  if (slot->state.compare_exchange_strong(state, Slot::kSent)) {
+    return OkStatus();
+  }
+  if (send_args.device_context) {
+    send_args.device_context->Unref();
+  }
+  slot->value = Tensor();
+
+  if (state == Slot::kWaiting &&
+      slot->state.compare_exchange_strong(state, Slot::kConsumed)) {
+    Rendezvous::DoneCallback waiter = std::move(slot->waiter);
+    Rendezvous::Args recv_args = slot->recv_args;
+    // Released last since it may destruct the rendezvous.
+    tsl::core::RefCountPtr<Rendezvous> rc_owner = std::move(slot->rc_owner);
+    waiter(OkStatus(), send_args, recv_args, val, is_dead);
+    if (recv_args.device_context) {
+      recv_args.device_context->Unref();
+    }
+    return OkStatus();
+  }
+  // The receiver was cancelled, or the rendezvous was aborted, so the message
+  // is dropped.
+  return status();
+}
+
+void LocalRendezvous::RecvFromSlot(Slot* slot,
+                                   const Rendezvous::Args& recv_args,
+                                   Rendezvous::DoneCallback done) {
+  if (TF_PREDICT_FALSE(aborted_.load(std::memory_order_acquire))) {
+    done(status(), Rendezvous::Args(), recv_args, Tensor(), false);
+    return;
+  }
+
+  // Consumes the message parked in `slot` by the sender.
+  auto consume_sent = [slot, &recv_args](Rendezvous::DoneCallback& done) {
+    Rendezvous::Args send_args = slot->send_args;
+    Tensor val = std::move(slot->value);
+    done(OkStatus(), send_args, recv_args, val, slot->is_dead);
+    if (send_args.device_context) {
+      send_args.device_context->Unref();
+    }
+  };
+
+  int state = slot->state.load(std::memory_order_acquire);
+  if (state == Slot::kSent &&
+      slot->state.compare_exchange_strong(state, Slot::kConsumed)) {
+    consume_sent(done);
+    return;
+  }
+
+  CancellationManager* cm = recv_args.cancellation_manager;
+  if (cm != nullptr) {
+    CancellationToken token = cm->get_cancellation_token();
+    bool already_cancelled = !cm->RegisterCallback(token, [slot] {
+      CloseSlot(slot, StatusGroup::MakeDerived(
+                          errors::Cancelled("RecvAsync is cancelled.")));
+    });
+    if (already_cancelled) {
+      done(StatusGroup::MakeDerived(
+               errors::Cancelled("RecvAsync is cancelled.")),
+           Rendezvous::Args(), recv_args, Tensor(), /*is_dead=*/false);
+      return;
+    }
+    // The cancellation callback must be deregistered before `done` is called,
+    // because the cancellation manager may no longer be live afterwards.
+    done = [cm, token, done = std::move(done)](
+               const Status& s, const Rendezvous::Args& send_args,
+               const Rendezvous::Args& recv_args, const Tensor& v,
+               bool dead) {
+      cm->TryDeregisterCallback(token);
+      done(s, send_args, recv_args, v, dead);
+    };
+  }
+
+  // Park the callback. The fields are only published to the sender if the
+  // slot is still empty.
+  slot->recv_args = recv_args;
+  if (recv_args.device_context) {
+    recv_args.device_context->Ref();
+  }
+  slot->waiter = std::move(done);
+  slot->rc_owner = tsl::core::GetNewRef(rc_owner_);
+  state = Slot::kEmpty;
+  if (slot->state.compare_exchange_strong(state, Slot::kWaiting)) {
+    // Pairs with the store in DoAbort(): either the abort sweep sees this
+    // waiter, or this check sees the abort.
+    if (TF_PREDICT_FALSE(aborted_.load())) {
+      CloseSlot(slot, status());
+    }
+    return;
+  }
+  done = std::move(slot->waiter);
+  slot->rc_owner.reset();
+  if (recv_args.device_context) {
+    recv_args.device_context->Unref();
+  }
+
+  if (state == Slot::kSent &&
+      slot->state.compare_exchange_strong(state, Slot::kConsumed)) {
+    consume_sent(done);
+    return;
+  }
+  // The slot was closed by cancellation or by an abort.
+  Status s = status();
+  if (s.ok()) {
+    s = StatusGroup::MakeDerived(errors::Cancelled("RecvAsync is cancelled."));
+  }
+  done(s, Rendezvous::Args(), recv_args, Tensor(), /*is_dead=*/false);
 }
 
 namespace {
@@ -147,9 +347,6 @@ uint64 KeyHash(const StringPiece& k) { return Hash64(k.data(), k.size()); }
 Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
                              const Rendezvous::Args& send_args,
                              const Tensor& val, const bool is_dead) {
-  uint64 key_hash = KeyHash(key.FullKey());
-  DVLOG(2) << "Send " << this << " " << key_hash << " " << key.FullKey();
-
   if (is_dead) {
     static auto* rendezvous_dead_values_sent = monitoring::Counter<2>::New(
         "/tensorflow/core/rendezvous_dead_values_sent",
@@ -160,6 +357,13 @@ Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
         ->IncrementBy(1);
   }
 
+  if (Slot* slot = GetSlot(send_args.rendezvous_slot)) {
+    return SendToSlot(slot, send_args, val, is_dead);
+  }
+
+  uint64 key_hash = KeyHash(key.FullKey());
+  DVLOG(2) << "Send " << this << " " << key_hash << " " << key.FullKey();
+
   TF_RETURN_IF_ERROR(status());
 
   int bucket_index = key_hash % num_buckets_;
@@ -226,6 +430,11 @@ Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
 void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
                                 const Rendezvous::Args& recv_args,
                                 Rendezvous::DoneCallback done) {
+  if (Slot* slot = GetSlot(recv_args.rendezvous_slot)) {
+    RecvFromSlot(slot, recv_args, std::move(done));
+    return;
+  }
+
   uint64 key_hash = KeyHash(key.FullKey());
   DVLOG(2) << "Recv " << this << " " << key_hash << " " << key.FullKey();
   tsl::core::RefCountPtr<Rendezvous> rc_keep_alive;
@@ -403,6 +612,15 @@ void LocalRendezvous::DoAbort(const Status& status) {
   }
   LOG(WARNING) << "Local rendezvous is aborting with status: " << status;
 
+  aborted_.store(true);
+  for (auto& chunk_ptr : slot_chunks_) {
+    SlotChunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (chunk == nullptr) continue;
+    for (Slot& slot : chunk->slots) {
+      CloseSlot(&slot, status);
+    }
+  }
+
   // Keeps one Item to make sure the current rendezvous won't be destructed.
   std::unique_ptr<Item> to_delete;
   for (int i = 0; i < num_buckets_; ++i) {
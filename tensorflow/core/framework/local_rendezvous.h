@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_LOCAL_RENDEZVOUS_H_
 #define TENSORFLOW_CORE_FRAMEWORK_LOCAL_RENDEZVOUS_H_
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -46,7 +47,11 @@ class LocalRendezvous {
   explicit LocalRendezvous(Rendezvous* owner, int num_shards)
       : num_buckets_(num_shards > 0 ? num_shards : 1),
         rc_owner_(owner),
-        table_buckets_(std::make_unique<TableBucket[]>(num_buckets_)) {}
+        table_buckets_(std::make_unique<TableBucket[]>(num_buckets_)) {
+    for (auto& chunk : slot_chunks_) {
+      chunk.store(nullptr, std::memory_order_relaxed);
+    }
+  }
   ~LocalRendezvous();
 
   Status Send(const Rendezvous::ParsedKey& key,
@@ -71,6 +76,27 @@ class LocalRendezvous {
 
   struct Item;
 
+  // A preassigned rendezvous slot (see Rendezvous::Args::rendezvous_slot) is
+  // shared by exactly one Send and one Recv, so the pair can be matched with
+  // a single compare-and-swap on the slot state instead of hashing the key
+  // and locking a table bucket. Slots are allocated lazily in chunks.
+  struct Slot;
+  struct SlotChunk;
+  static constexpr int kSlotsPerChunk = 64;
+  static constexpr int kMaxSlotChunks = 64;
+
+  // Returns the slot with `index`, or nullptr if `index` is out of range, in
+  // which case the caller falls back to the keyed table.
+  Slot* GetSlot(int64_t index);
+  Status SendToSlot(Slot* slot, const Rendezvous::Args& send_args,
+                    const Tensor& val, bool is_dead);
+  void RecvFromSlot(Slot* slot, const Rendezvous::Args& recv_args,
+                    Rendezvous::DoneCallback done);
+  // Moves `slot` to its final state unless a Send/Recv pair already matched
+  // in it: a parked receiver is called with `status` and a parked message is
+  // dropped.
+  static void CloseSlot(Slot* slot, const Status& status);
+
   // By invariant, the item queue under each key is of the form
   //   [item.type == kSend]* meaning each item is a sent message.
   // or
@@ -100,6 +126,11 @@ class LocalRendezvous {
 
   // Immutable set of buckets. This uses less memory than std::vector.
   const std::unique_ptr<TableBucket[]> table_buckets_;
+
+  std::atomic<SlotChunk*> slot_chunks_[kMaxSlotChunks];
+  // Set once by DoAbort() before waiting slots are swept, so a receiver that
+  // parks in a slot concurrently can observe the abort.
+  std::atomic<bool> aborted_{false};
   mutex mu_;
   Status status_ TF_GUARDED_BY(mu_);
 
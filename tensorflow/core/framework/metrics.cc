@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/metrics.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -46,6 +47,19 @@ auto* graph_run_time_usecs_histogram = tsl::monitoring::Sampler<0>::New(
     // Power of 2 with bucket count 20 (> 17 minutes)
     {tsl::monitoring::Buckets::Exponential(1000, 2, 20)});
 
+auto* device_transfer_bytes = tsl::monitoring::Counter<1>::New(
+    "/tensorflow/core/device_transfer_bytes",
+    "The number of bytes copied between host and device memory.",
+    "direction");
+
+auto* device_transfer_bandwidth_histogram = tsl::monitoring::Sampler<1>::New(
+    {"/tensorflow/core/device_transfer_bandwidth",
+     "The effective bandwidth in MB/s of sampled copies between host and "
+     "device memory, from enqueueing the copy to its completion.",
+     "direction"},
+    // Power of 2 with bucket count 20 (> 500 GB/s)
+    {tsl::monitoring::Buckets::Exponential(1, 2, 20)});
+
 auto* graph_pending_queue_length_histogram = tsl::monitoring::Sampler<0>::New(
     {"/tensorflow/core/graph_pending_queue_length_histogram",
      "The number of pending (ready but not running) tasks in graph executor."},
@@ -258,6 +272,12 @@ auto* tf_data_service_optimal_number_of_workers =
         "Estimated optimal number of tf.data service workers based on the "
         "current workload.");
 
+auto* tf_data_service_forecast_number_of_workers =
+    monitoring::Gauge<int64_t, 0>::New(
+        "/tensorflow/data/service/forecast_number_of_workers",
+        "Forecast number of tf.data service workers based on the trend of the "
+        "workload.");
+
 auto* tf_data_filename_counter = tsl::monitoring::Counter<2>::New(
     "/tensorflow/data/filename", "The file name read by a tf.data Dataset.",
     "name", "filename");
@@ -266,6 +286,12 @@ auto* tf_data_model_gauge =
     tsl::monitoring::Gauge<std::function<std::string()>, 1>::New(
         "/tensorflow/data/model", "tf.data autotuning model proto.", "id");
 
+auto* tf_data_buffered_bytes = tsl::monitoring::Gauge<int64_t, 1>::New(
+    "/tensorflow/data/buffered_bytes",
+    "The number of bytes held in the internal buffers of the iterators of a "
+    "tf.data dataset.",
+    "name");
+
 auto* tf_data_pipeline_processing_time = tsl::monitoring::Gauge<double, 1>::New(
     "/tensorflow/data/pipeline_processing_time",
     "The total processing time of the slowest stage in the input pipeline "
@@ -297,6 +323,13 @@ auto* tf_data_autotune_stopping_criteria_counter =
         "algorithm stopping criterion is met.",
         "name");
 
+auto* tf_data_autotune_rewrite_recommendation_counter =
+    tsl::monitoring::Counter<1>::New(
+        "/tensorflow/data/autotune_rewrite_recommendation",
+        "The number of times the tf.data autotuner recommended the pipeline "
+        "rewrite implemented by the given optimization.",
+        "optimization");
+
 auto* tf_data_error = tsl::monitoring::Counter<2>::New(
     "/tensorflow/data/error",
     "The number of times an error of this type occurred with this status code.",
@@ -314,6 +347,17 @@ auto* parse_ragged_feature_counter = tsl::monitoring::Counter<0>::New(
     "/tensorflow/data/ragged_feature",
     "The number of ragged features parsed by ops for parsing tf.Example.");
 
+auto* checkpoint_restore_bytes = tsl::monitoring::Counter<1>::New(
+    "/tensorflow/core/checkpoint/restore_bytes",
+    "The number of bytes restored from each data file shard of checkpoints.",
+    "shard");
+
+auto* checkpoint_restore_throughput = tsl::monitoring::Sampler<0>::New(
+    {"/tensorflow/core/checkpoint/restore_throughput",
+     "The throughput of checkpoint restore ops in MB per second."},
+    // Power of 2 with bucket count 16 (> 32 GB/s)
+    {tsl::monitoring::Buckets::Exponential(1, 2, 16)});
+
 auto* build_graph_calls = tsl::monitoring::Counter<0>::New(
     "/tensorflow/core/graph_build_calls",
     "The number of times TensorFlow has created a new client graph. "
@@ -482,6 +526,10 @@ void RecordTFDataBytesFetched(int64_t num_bytes) {
   tf_data_bytes_fetched_counter->GetCell()->IncrementBy(num_bytes);
 }
 
+void RecordTFDataBufferedBytes(const string& name, int64_t num_bytes) {
+  tf_data_buffered_bytes->GetCell(name)->Set(num_bytes);
+}
+
 void RecordTFDataExperiment(const string& name) {
   tf_data_experiment_counter->GetCell(name)->IncrementBy(1);
 }
@@ -640,6 +688,10 @@ void RecordTFDataServiceOptimalNumberOfWorkers(int64_t number_of_workers) {
   tf_data_service_optimal_number_of_workers->GetCell()->Set(number_of_workers);
 }
 
+void RecordTFDataServiceForecastNumberOfWorkers(int64_t number_of_workers) {
+  tf_data_service_forecast_number_of_workers->GetCell()->Set(number_of_workers);
+}
+
 void RecordTFDataFilename(const string& name, const string& filename) {
   tf_data_filename_counter->GetCell(name, filename)->IncrementBy(1);
 }
@@ -666,6 +718,11 @@ void RecordTFDataAutotuneStoppingCriteria(const string& name) {
   tf_data_autotune_stopping_criteria_counter->GetCell(name)->IncrementBy(1);
 }
 
+void RecordTFDataAutotuneRewriteRecommendation(const string& optimization) {
+  tf_data_autotune_rewrite_recommendation_counter->GetCell(optimization)
+      ->IncrementBy(1);
+}
+
 void RecordTFDataError(const string& error_type, const string& status_code) {
   tf_data_error->GetCell(error_type, status_code)->IncrementBy(1);
 }
@@ -700,6 +757,21 @@ void RecordGraphOutputTensors(const size_t size) {
   graph_run_output_tensor_bytes_cell->Add(size);
 }
 
+void RecordCheckpointRestoreBytes(int32_t shard_id, int64_t num_bytes) {
+  checkpoint_restore_bytes->GetCell(absl::StrCat(shard_id))
+      ->IncrementBy(num_bytes);
+}
+
+void RecordCheckpointRestoreThroughput(int64_t num_bytes,
+                                       uint64 duration_usecs) {
+  static auto* checkpoint_restore_throughput_cell =
+      checkpoint_restore_throughput->GetCell();
+  if (duration_usecs == 0) return;
+  // Bytes per microsecond are MB per second.
+  checkpoint_restore_throughput_cell->Add(static_cast<double>(num_bytes) /
+                                          duration_usecs);
+}
+
 void RecordTPUXlaSpmdCoresPerReplica(int64_t cores_per_replica) {
   xla_tpu_spmd_cores_per_replica->GetCell(absl::StrCat(cores_per_replica))
       ->IncrementBy(1);
@@ -717,6 +789,27 @@ void UpdateGraphExecTime(const uint64 running_time_usecs) {
   }
 }
 
+void RecordDeviceTransferBytes(bool host_to_device, int64_t num_bytes) {
+  static auto* host_to_device_cell =
+      device_transfer_bytes->GetCell("host_to_device");
+  static auto* device_to_host_cell =
+      device_transfer_bytes->GetCell("device_to_host");
+  (host_to_device ? host_to_device_cell : device_to_host_cell)
+      ->IncrementBy(num_bytes);
+}
+
+void RecordDeviceTransferDuration(bool host_to_device, int64_t num_bytes,
+                                  uint64 duration_usecs) {
+  static auto* host_to_device_cell =
+      device_transfer_bandwidth_histogram->GetCell("host_to_device");
+  static auto* device_to_host_cell =
+      device_transfer_bandwidth_histogram->GetCell("device_to_host");
+  // Bytes per microsecond are MB/s.
+  const double bandwidth = static_cast<double>(num_bytes) /
+                           std::max<uint64>(duration_usecs, 1);
+  (host_to_device ? host_to_device_cell : device_to_host_cell)->Add(bandwidth);
+}
+
 void UpdateGraphPendingQueueLength(uint64 len) {
   static auto* graph_pending_queue_length_cell =
       graph_pending_queue_length_histogram->GetCell();
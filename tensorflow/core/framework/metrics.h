@@ -80,6 +80,12 @@ monitoring::GaugeCell<std::function<std::string()>>* GetTFDataModelGauge(
 // Records the number of bytes fetched from tf.data.Dataset iterator.
 void RecordTFDataBytesFetched(int64_t num_bytes);
 
+// Records the number of bytes held in the internal buffers of the iterators
+// of a tf.data dataset.
+//
+// The `name` argument identifies the dataset node (e.g. "PrefetchDataset/_3").
+void RecordTFDataBufferedBytes(const string& name, int64_t num_bytes);
+
 // Records the number of times a tf.data experiment was applied.
 void RecordTFDataExperiment(const string& name);
 
@@ -191,6 +197,10 @@ void RecordTFDataServiceSnapshotOp(const std::string& path,
 // Records the current estimated optimal number of tf.data service workers.
 void RecordTFDataServiceOptimalNumberOfWorkers(int64_t number_of_workers);
 
+// Records the number of tf.data service workers forecast to be needed by the
+// current workload trend.
+void RecordTFDataServiceForecastNumberOfWorkers(int64_t number_of_workers);
+
 // Records the file name read by a tf.data Dataset.
 //
 // The `name` argument identifies the Dataset type (e.g. "TFRecordDataset").
@@ -217,6 +227,10 @@ void RecordTFDataAutoShardRewriteBatchSize(
 // criterion is met.
 void RecordTFDataAutotuneStoppingCriteria(const string& name);
 
+// Records the number of times the tf.data autotuner recommended the pipeline
+// rewrite implemented by the given static optimization (e.g. "map_fusion").
+void RecordTFDataAutotuneRewriteRecommendation(const string& optimization);
+
 // Records the number of times an error of this type occurred with this status
 // code.
 void RecordTFDataError(const string& error_type, const string& error_code);
@@ -234,12 +248,30 @@ void RecordParseRaggedFeature(int64_t num_features);
 void RecordGraphInputTensors(const size_t size);
 void RecordGraphOutputTensors(const size_t size);
 
+// Records that a checkpoint restore read `num_bytes` from the data file shard
+// `shard_id`.
+void RecordCheckpointRestoreBytes(int32_t shard_id, int64_t num_bytes);
+
+// Records the throughput of a checkpoint restore op that restored `num_bytes`
+// in `duration_usecs`.
+void RecordCheckpointRestoreThroughput(int64_t num_bytes,
+                                       uint64 duration_usecs);
+
 // Records the number of cores requested by graphs with XLA SPMD enabled.
 void RecordTPUXlaSpmdCoresPerReplica(int64_t cores_per_replica);
 
 void UpdateGraphExecTime(const uint64 running_time_usecs);
 void UpdateGraphPendingQueueLength(uint64 len);
 
+// Records `num_bytes` copied between host and device memory, in the direction
+// given by `host_to_device`.
+void RecordDeviceTransferBytes(bool host_to_device, int64_t num_bytes);
+
+// Records the effective bandwidth of a sampled host-device copy of
+// `num_bytes` that took `duration_usecs` from being enqueued to completing.
+void RecordDeviceTransferDuration(bool host_to_device, int64_t num_bytes,
+                                  uint64 duration_usecs);
+
 // Records that one output of an op of type `op_name` was unused.
 void RecordUnusedOutput(const string& op_name);
 
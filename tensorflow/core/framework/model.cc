@@ -23,6 +23,7 @@ limitations under the License.
 #include <optional>
 #include <queue>
 
+#include "absl/strings/str_join.h"
 #include "absl/time/clock.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -33,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -68,6 +70,24 @@ constexpr char kDataService[] = "DataService";
 constexpr char kFlatMap[] = "FlatMap";
 constexpr char kInterleave[] = "Interleave";
 constexpr char kParallelInterleave[] = "ParallelInterleave";
+constexpr char kBatch[] = "Batch";
+constexpr char kMap[] = "Map";
+constexpr char kParallelMap[] = "ParallelMap";
+
+// Names of the static optimizations implementing the rewrites recommended by
+// `ModelTiming::RecommendRewrites()`.
+constexpr char kMapFusion[] = "map_fusion";
+constexpr char kMapAndBatchFusion[] = "map_and_batch_fusion";
+constexpr char kMapParallelization[] = "map_parallelization";
+// The experiment that enables the computation of rewrite recommendations.
+constexpr char kAutotuneRewritesExperiment[] = "autotune_rewrites";
+// Rewrites are only recommended if they are estimated to save at least this
+// fraction of the time it takes to produce an element at the root.
+constexpr double kMinRewriteRelativeSavings = 0.05;
+// Estimated per-element overhead of a map transformation that is saved by
+// fusing it into an adjacent map transformation (i.e. the cost of an iterator
+// `GetNext()` call and of a function invocation).
+constexpr double kMapStageOverheadNsec = 2000.0;
 
 // A class to prune outliers given a set of points. To use it, instantiate an
 // object and call the `GetCleanPoints()` method.
@@ -2392,6 +2412,31 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
         metrics::RecordPipelineProcessingTime(model_id_,
                                               pipeline_processing_usec);
       }
+      if (experiments_.contains(kAutotuneRewritesExperiment)) {
+        std::vector<RewriteRecommendation> recommendations =
+            model_timing.RecommendRewrites(kMinRewriteRelativeSavings);
+        for (const auto& recommendation : recommendations) {
+          // Only record rewrites that were not recommended by the previous
+          // optimization to avoid inflating the counter.
+          bool is_new = std::none_of(
+              rewrite_recommendations_.begin(), rewrite_recommendations_.end(),
+              [&recommendation](const RewriteRecommendation& r) {
+                return r.optimization == recommendation.optimization &&
+                       r.node_names == recommendation.node_names;
+              });
+          if (is_new) {
+            VLOG(1) << "Recommending " << recommendation.optimization
+                    << " for "
+                    << absl::StrJoin(recommendation.node_names, ", ")
+                    << " (estimated savings: "
+                    << recommendation.estimated_savings_nsec
+                    << " ns per element).";
+            metrics::RecordTFDataAutotuneRewriteRecommendation(
+                recommendation.optimization);
+          }
+        }
+        rewrite_recommendations_ = std::move(recommendations);
+      }
     }
   }
   VLOG(2) << ram_budget_manager.DebugString();
@@ -3444,11 +3489,206 @@ std::vector<std::shared_ptr<Node>> ModelTiming::GetStageRoots() const {
   return roots;
 }
 
+namespace {
+
+bool IsMapNode(const Node& node) {
+  return node.name() == kMap || absl::StartsWith(node.name(), kParallelMap);
+}
+
+bool IsBatchNode(const Node& node) {
+  return absl::StartsWith(node.name(), kBatch);
+}
+
+}  // namespace
+
+std::vector<RewriteRecommendation> ModelTiming::RecommendRewrites(
+    double min_relative_savings) const {
+  std::vector<RewriteRecommendation> recommendations;
+  const NodeTiming* root_timing = GetTiming(root_.get());
+  if (root_timing == nullptr || root_timing->total_time_nsec <= 0) {
+    return recommendations;
+  }
+  const double min_savings_nsec =
+      min_relative_savings * root_timing->total_time_nsec;
+  auto maybe_add = [&](std::string optimization,
+                       std::vector<std::string> node_names,
+                       double savings_nsec) {
+    if (savings_nsec >= min_savings_nsec) {
+      recommendations.push_back(
+          {std::move(optimization), std::move(node_names), savings_nsec});
+    }
+  };
+  auto bfs_nodes = CollectNodes(root_, TraversalOrder::BFS, IsAnyNode);
+  for (const auto& node : bfs_nodes) {
+    if (node->inputs().size() != 1) {
+      continue;
+    }
+    const std::shared_ptr<Node> input = node->inputs().front();
+    const NodeTiming* node_timing = GetTiming(node.get());
+    const NodeTiming* input_timing = GetTiming(input.get());
+    if (node_timing == nullptr || input_timing == nullptr) {
+      continue;
+    }
+    if (IsMapNode(*node) && IsMapNode(*input) &&
+        node->IsAsync() == input->IsAsync()) {
+      // Fusing the two maps saves the per-element overhead of the input map.
+      maybe_add(kMapFusion, {node->long_name(), input->long_name()},
+                input_timing->pipeline_ratio * kMapStageOverheadNsec);
+    } else if (IsBatchNode(*node) && input->IsAsync() && IsMapNode(*input)) {
+      // A fused map and batch writes the map outputs directly into the batch,
+      // which saves the time the batch spends copying its input elements.
+      maybe_add(kMapAndBatchFusion, {node->long_name(), input->long_name()},
+                node_timing->self_time_nsec);
+    }
+  }
+  for (const auto& node : bfs_nodes) {
+    if (node->name() != kMap) {
+      continue;
+    }
+    const NodeTiming* node_timing = GetTiming(node.get());
+    if (node_timing == nullptr) {
+      continue;
+    }
+    // A sequential map whose self time dominates the pipeline would have most
+    // of its self time hidden if it were executed in parallel.
+    maybe_add(kMapParallelization, {node->long_name()},
+              node_timing->self_time_nsec);
+  }
+  std::sort(recommendations.begin(), recommendations.end(),
+            [](const RewriteRecommendation& a, const RewriteRecommendation& b) {
+              return a.estimated_savings_nsec > b.estimated_savings_nsec;
+            });
+  return recommendations;
+}
+
 std::vector<std::shared_ptr<Node>> ModelTiming::GetStageNodes(
     std::shared_ptr<Node> stage_root) const {
   return CollectNodes(stage_root, TraversalOrder::BFS, IsSyncNode);
 }
 
+ElementBufferPool::Client::Client(ElementBufferPool* pool,
+                                  const std::string& node_name)
+    : pool_(pool), node_name_(pool ? node_name : std::string()) {}
+
+ElementBufferPool::Client::~Client() {
+  if (pool_ == nullptr) {
+    return;
+  }
+  int64_t buffered_bytes;
+  {
+    mutex_lock l(pool_->mu_);
+    buffered_bytes = buffered_bytes_;
+  }
+  if (buffered_bytes != 0) {
+    pool_->Update(*this, -buffered_bytes);
+  }
+}
+
+void ElementBufferPool::Client::RecordEnqueue(int64_t bytes) {
+  if (pool_ != nullptr && bytes != 0) {
+    pool_->Update(*this, bytes);
+  }
+}
+
+void ElementBufferPool::Client::RecordDequeue(int64_t bytes) {
+  if (pool_ != nullptr && bytes != 0) {
+    pool_->Update(*this, -bytes);
+  }
+}
+
+Status ElementBufferPool::Client::WaitForCapacity(
+    CancellationManager* cancellation_manager) {
+  if (pool_ == nullptr) {
+    return OkStatus();
+  }
+  auto has_capacity = [this]() TF_SHARED_LOCKS_REQUIRED(pool_->mu_) {
+    return pool_->buffered_bytes_ < pool_->limit_bytes_ ||
+           buffered_bytes_ <= 0;
+  };
+  {
+    tf_shared_lock l(pool_->mu_);
+    if (has_capacity()) {
+      return OkStatus();
+    }
+  }
+
+  CancellationToken token = cancellation_manager->get_cancellation_token();
+  bool registered = cancellation_manager->RegisterCallback(token, [this]() {
+    mutex_lock l(pool_->mu_);
+    pool_->cond_var_.notify_all();
+  });
+  if (!registered) {
+    return errors::Cancelled("Iterator was cancelled");
+  }
+  {
+    mutex_lock l(pool_->mu_);
+    while (!has_capacity() && !cancellation_manager->IsCancelled()) {
+      VLOG(3) << "Waiting for tf.data element buffer capacity for "
+              << node_name_ << ": " << pool_->buffered_bytes_ << " of "
+              << pool_->limit_bytes_ << " bytes are buffered";
+      pool_->cond_var_.wait(l);
+    }
+  }
+  // The callback locks `mu_`, so the lock must be released before waiting for
+  // a running callback to finish.
+  cancellation_manager->DeregisterCallback(token);
+  if (cancellation_manager->IsCancelled()) {
+    return errors::Cancelled("Iterator was cancelled");
+  }
+  return OkStatus();
+}
+
+ElementBufferPool::ElementBufferPool(int64_t limit_bytes)
+    : limit_bytes_(limit_bytes) {
+  DCHECK_GT(limit_bytes, 0);
+}
+
+ElementBufferPool* ElementBufferPool::Global() {
+  static ElementBufferPool* pool = []() -> ElementBufferPool* {
+    int64_t limit_bytes = 0;
+    Status s = ReadInt64FromEnvVar("TF_DATA_ELEMENT_BUFFER_POOL_LIMIT_BYTES",
+                                   /*default_val=*/0, &limit_bytes);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to read the tf.data element buffer pool limit: "
+                   << s;
+      return nullptr;
+    }
+    if (limit_bytes <= 0) {
+      return nullptr;
+    }
+    VLOG(1) << "Limiting the tf.data element buffers to " << limit_bytes
+            << " bytes";
+    return new ElementBufferPool(limit_bytes);
+  }();
+  return pool;
+}
+
+int64_t ElementBufferPool::buffered_bytes() const {
+  tf_shared_lock l(mu_);
+  return buffered_bytes_;
+}
+
+int64_t ElementBufferPool::buffered_bytes(const std::string& node_name) const {
+  tf_shared_lock l(mu_);
+  auto it = node_buffered_bytes_.find(node_name);
+  return it == node_buffered_bytes_.end() ? 0 : it->second;
+}
+
+void ElementBufferPool::Update(Client& client, int64_t delta_bytes) {
+  mutex_lock l(mu_);
+  client.buffered_bytes_ += delta_bytes;
+  buffered_bytes_ += delta_bytes;
+  int64_t& node_buffered_bytes = node_buffered_bytes_[client.node_name_];
+  node_buffered_bytes += delta_bytes;
+  metrics::RecordTFDataBufferedBytes(client.node_name_, node_buffered_bytes);
+  if (node_buffered_bytes == 0) {
+    node_buffered_bytes_.erase(client.node_name_);
+  }
+  if (delta_bytes < 0) {
+    cond_var_.notify_all();
+  }
+}
+
 }  // namespace model
 }  // namespace data
 }  // namespace tensorflow
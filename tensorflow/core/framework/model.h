@@ -252,6 +252,85 @@ class RamBudgetManager {
   int64_t model_allocated_ TF_GUARDED_BY(mu_) = 0;
 };
 
+// Process-wide byte limit for the elements held in the internal buffers of all
+// tf.data iterators, e.g. the buffers of prefetch, parallel map and parallel
+// interleave. Unlike `RamBudgetManager`, which bounds the buffer sizes that
+// the autotuner of a single iterator chooses, it bounds the bytes actually
+// buffered by all iterators in the process, so that concurrent input pipelines
+// cannot together exhaust the host memory when their buffers grow.
+//
+// Each iterator accounts its buffered elements through a `Client`. Producer
+// threads call `Client::WaitForCapacity` before producing a new element and
+// block while the pool is over its limit. A client that holds no buffered
+// elements is never blocked, so that the consumer of every iterator can make
+// progress and free buffer space in the process.
+//
+// For each dataset node, the pool exports the buffered bytes as the
+// /tensorflow/data/buffered_bytes metric.
+//
+// ElementBufferPool is thread-safe.
+class ElementBufferPool {
+ public:
+  // Accounts the buffered elements of an iterator. Releases the bytes it still
+  // holds when destroyed.
+  class Client {
+   public:
+    // Does not take ownership of `pool`, which must outlive *this. If `pool`
+    // is null, the client does nothing.
+    Client(ElementBufferPool* pool, const std::string& node_name);
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    // Returns whether the client accounts buffered elements in a pool.
+    bool enabled() const { return pool_ != nullptr; }
+    // Records that the iterator has enqueued `bytes` in its buffers.
+    void RecordEnqueue(int64_t bytes);
+    // Records that the iterator has dequeued `bytes` from its buffers.
+    void RecordDequeue(int64_t bytes);
+    // Blocks while the pool is over its limit and this client holds buffered
+    // elements. Returns `Cancelled` if `cancellation_manager` is cancelled
+    // while waiting.
+    Status WaitForCapacity(CancellationManager* cancellation_manager);
+
+   private:
+    friend class ElementBufferPool;
+
+    ElementBufferPool* const pool_;
+    const std::string node_name_;
+    // Guarded by `pool_->mu_`.
+    int64_t buffered_bytes_ = 0;
+  };
+
+  // `limit_bytes` must be positive.
+  explicit ElementBufferPool(int64_t limit_bytes);
+
+  // Returns the pool shared by all iterators in the process, with the limit
+  // set by the TF_DATA_ELEMENT_BUFFER_POOL_LIMIT_BYTES environment variable.
+  // Returns null if the variable is not set, in which case buffers are not
+  // limited.
+  static ElementBufferPool* Global();
+
+  // Returns the bytes buffered by all clients.
+  int64_t buffered_bytes() const TF_LOCKS_EXCLUDED(mu_);
+  // Returns the bytes buffered by the clients of `node_name`.
+  int64_t buffered_bytes(const std::string& node_name) const
+      TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  // Adds `delta_bytes` to the bytes buffered by `client`.
+  void Update(Client& client, int64_t delta_bytes) TF_LOCKS_EXCLUDED(mu_);
+
+  const int64_t limit_bytes_;
+  mutable mutex mu_;
+  condition_variable cond_var_;
+  int64_t buffered_bytes_ TF_GUARDED_BY(mu_) = 0;
+  // Bytes buffered by the iterators of each dataset node.
+  absl::flat_hash_map<std::string, int64_t> node_buffered_bytes_
+      TF_GUARDED_BY(mu_);
+};
+
 // Abstract representation of a TensorFlow input pipeline node. It collects
 // information about inputs to this node, processing time spent executing the
 // node logic, number of elements produced by the node, various other
@@ -894,6 +973,19 @@ std::shared_ptr<Node> MakeAsyncUnknownRatioNode(
 // as pass-through between inputs and output.
 std::shared_ptr<Node> MakeUnknownNode(Node::Args args);
 
+// A rewrite of the input pipeline that the measured timing of the model
+// suggests would reduce the time it takes to produce an element.
+struct RewriteRecommendation {
+  // Name of the tf.data static optimization that implements the rewrite.
+  std::string optimization;
+  // Long names of the nodes affected by the rewrite, ordered from output to
+  // input.
+  std::vector<std::string> node_names;
+  // Estimated reduction of the time it takes the pipeline to produce an element
+  // at its root.
+  double estimated_savings_nsec = 0.0;
+};
+
 // Abstract representation of a TensorFlow input pipeline that can be used
 // for collecting runtime information and optimizing performance. It collects
 // runtime information about execution of the input pipeline that is used to
@@ -929,6 +1021,15 @@ class Model {
     experiments_.insert(experiment);
   }
 
+  // Returns the pipeline rewrites recommended by the latest optimization. They
+  // are only computed when the job is part of the "autotune_rewrites"
+  // experiment.
+  std::vector<RewriteRecommendation> GetRewriteRecommendations() const
+      TF_LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    return rewrite_recommendations_;
+  }
+
   // Adds a node with the given name and given parent.
   void AddNode(Node::Factory factory, const string& name,
                std::shared_ptr<Node> parent, std::shared_ptr<Node>* out_node)
@@ -1193,6 +1294,9 @@ class Model {
   std::shared_ptr<Node> snapshot_ TF_GUARDED_BY(mu_);
   // Stores the optimization parameters used by autotune.
   OptimizationParams optimization_params_ TF_GUARDED_BY(mu_);
+  // Stores the pipeline rewrites recommended by the latest optimization.
+  std::vector<RewriteRecommendation> rewrite_recommendations_
+      TF_GUARDED_BY(mu_);
   // Stores the model id in the string format
   std::string model_id_;
 };
@@ -1228,6 +1332,14 @@ class ModelTiming {
   // Computes the total time for a node.
   void ComputeNodeTotalTime(const Node& node);
 
+  // Returns the rewrites of the pipeline that are estimated to reduce the time
+  // it takes to produce an element at its root by at least
+  // `min_relative_savings` of that time, sorted by decreasing savings. This
+  // lets the autotuner revisit the map fusion and parallelization decisions
+  // that are made statically before the pipeline runs.
+  std::vector<RewriteRecommendation> RecommendRewrites(
+      double min_relative_savings) const;
+
  private:
   // Computes the pipeline ratios of all nodes.
   void ComputePipelineRatios(const Node::NodeVector& bfs_nodes);
@@ -23,12 +23,16 @@ limitations under the License.
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -2556,6 +2560,102 @@ TEST_F(BufferSizeTest, OptimizeBuffers_TightMemory) {
   EXPECT_EQ(4, node_4->buffered_elements_high());
 }
 
+TEST_F(ModelTimingTest, RecommendRewrites_MapMap) {
+  ComputeModelTiming(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "Map"
+        autotune: true
+        num_elements: 100
+        processing_time: 100000
+        node_class: KNOWN_RATIO
+        ratio: 1
+        inputs: 2
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "Map"
+        autotune: true
+        num_elements: 100
+        processing_time: 50000
+        node_class: KNOWN_RATIO
+        ratio: 1
+      }
+    }
+    output: 1
+  )pb");
+
+  EXPECT_DOUBLE_EQ(1500, GetNodeTiming(/*node_id=*/1)->total_time_nsec);
+  std::vector<RewriteRecommendation> recommendations =
+      model_timing_->RecommendRewrites(/*min_relative_savings=*/0.5);
+  ASSERT_EQ(2, recommendations.size());
+  EXPECT_EQ("map_fusion", recommendations[0].optimization);
+  EXPECT_THAT(recommendations[0].node_names,
+              ::testing::ElementsAre(GetNode(/*node_id=*/1)->long_name(),
+                                     GetNode(/*node_id=*/2)->long_name()));
+  EXPECT_EQ("map_parallelization", recommendations[1].optimization);
+  EXPECT_THAT(recommendations[1].node_names,
+              ::testing::ElementsAre(GetNode(/*node_id=*/1)->long_name()));
+  EXPECT_DOUBLE_EQ(1000, recommendations[1].estimated_savings_nsec);
+
+  // None of the rewrites save the entire time of the pipeline.
+  EXPECT_TRUE(
+      model_timing_->RecommendRewrites(/*min_relative_savings=*/1.5).empty());
+}
+
+TEST_F(ModelTimingTest, RecommendRewrites_BatchParallelMap) {
+  ComputeModelTiming(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "Batch"
+        autotune: true
+        num_elements: 10
+        processing_time: 10000
+        node_class: KNOWN_RATIO
+        ratio: 10
+        inputs: 2
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 20000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        parameters: {
+          name: "parallelism"
+          value: 4
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    output: 1
+  )pb");
+
+  std::vector<RewriteRecommendation> recommendations =
+      model_timing_->RecommendRewrites(/*min_relative_savings=*/0.0);
+  ASSERT_EQ(1, recommendations.size());
+  EXPECT_EQ("map_and_batch_fusion", recommendations[0].optimization);
+  EXPECT_THAT(recommendations[0].node_names,
+              ::testing::ElementsAre(GetNode(/*node_id=*/1)->long_name(),
+                                     GetNode(/*node_id=*/2)->long_name()));
+  EXPECT_DOUBLE_EQ(GetNodeTiming(/*node_id=*/1)->self_time_nsec,
+                   recommendations[0].estimated_savings_nsec);
+}
+
 TEST_F(ModelTimingTest, OptimizeStageBased_OneStage) {
   BuildModelFromProto(R"pb(
     nodes: {
@@ -3548,6 +3648,85 @@ TEST(RamBudgetManagerTest, RequestAllocationsWithBudgetAdjustment) {
   EXPECT_TRUE(rbm.RequestLegacyPrefetchBytes(4));
 }
 
+TEST(ElementBufferPoolTest, RecordsBufferedBytes) {
+  ElementBufferPool pool(/*limit_bytes=*/100);
+  CellReader<int64_t> cell_reader("/tensorflow/data/buffered_bytes");
+  {
+    ElementBufferPool::Client prefetch(&pool, "test_prefetch");
+    ElementBufferPool::Client prefetch_copy(&pool, "test_prefetch");
+    ElementBufferPool::Client map(&pool, "test_map");
+    prefetch.RecordEnqueue(10);
+    prefetch_copy.RecordEnqueue(20);
+    map.RecordEnqueue(30);
+    map.RecordDequeue(5);
+    EXPECT_EQ(pool.buffered_bytes(), 55);
+    EXPECT_EQ(pool.buffered_bytes("test_prefetch"), 30);
+    EXPECT_EQ(pool.buffered_bytes("test_map"), 25);
+    EXPECT_EQ(cell_reader.Read("test_prefetch"), 30);
+    EXPECT_EQ(cell_reader.Read("test_map"), 25);
+  }
+  // Destroying the clients releases their bytes.
+  EXPECT_EQ(pool.buffered_bytes(), 0);
+  EXPECT_EQ(cell_reader.Read("test_prefetch"), 0);
+  EXPECT_EQ(cell_reader.Read("test_map"), 0);
+}
+
+TEST(ElementBufferPoolTest, DisabledClient) {
+  ElementBufferPool::Client client(/*pool=*/nullptr, "test_disabled");
+  EXPECT_FALSE(client.enabled());
+  client.RecordEnqueue(10);
+  CancellationManager cancellation_manager;
+  TF_EXPECT_OK(client.WaitForCapacity(&cancellation_manager));
+}
+
+TEST(ElementBufferPoolTest, ClientWithoutBufferedElementsIsNotBlocked) {
+  ElementBufferPool pool(/*limit_bytes=*/10);
+  ElementBufferPool::Client full(&pool, "test_full");
+  ElementBufferPool::Client empty(&pool, "test_empty");
+  full.RecordEnqueue(10);
+  CancellationManager cancellation_manager;
+  TF_EXPECT_OK(empty.WaitForCapacity(&cancellation_manager));
+}
+
+TEST(ElementBufferPoolTest, WaitForCapacity) {
+  ElementBufferPool pool(/*limit_bytes=*/10);
+  ElementBufferPool::Client producer(&pool, "test_producer");
+  ElementBufferPool::Client other(&pool, "test_other");
+  producer.RecordEnqueue(4);
+  other.RecordEnqueue(8);
+
+  CancellationManager cancellation_manager;
+  Notification has_capacity;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "wait_for_capacity", [&]() {
+        TF_EXPECT_OK(producer.WaitForCapacity(&cancellation_manager));
+        has_capacity.Notify();
+      }));
+  Env::Default()->SleepForMicroseconds(10000);
+  EXPECT_FALSE(has_capacity.HasBeenNotified());
+  // Dequeuing from another iterator unblocks the producer.
+  other.RecordDequeue(8);
+  has_capacity.WaitForNotification();
+}
+
+TEST(ElementBufferPoolTest, WaitForCapacityCancelled) {
+  ElementBufferPool pool(/*limit_bytes=*/10);
+  ElementBufferPool::Client producer(&pool, "test_producer");
+  producer.RecordEnqueue(20);
+
+  CancellationManager cancellation_manager;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "wait_for_capacity", [&]() {
+        EXPECT_TRUE(errors::IsCancelled(
+            producer.WaitForCapacity(&cancellation_manager)));
+      }));
+  Env::Default()->SleepForMicroseconds(10000);
+  cancellation_manager.StartCancel();
+  thread.reset();
+  EXPECT_TRUE(errors::IsCancelled(
+      producer.WaitForCapacity(&cancellation_manager)));
+}
+
 }  // namespace
 }  // namespace model
 }  // namespace data
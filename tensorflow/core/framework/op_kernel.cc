@@ -819,8 +819,25 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
       op_kernel().name_view().data(), step_id(), "output", type,
       [&shape]() { return shape.DebugString(); });
   auto output_tensor = std::make_unique<Tensor>();
+  StepMemoryArena* arena = attr.value == 0 && attr.scope_id == 0
+                               ? params_->step_memory_arena
+                               : nullptr;
+  if (arena != nullptr && arena->AllocateOutput(params_->op_kernel, index,
+                                                type, shape,
+                                                output_tensor.get())) {
+    if (params_->log_memory) {
+      LogMemory::RecordTensorAllocation(params_->op_kernel->name(),
+                                        params_->step_id, *output_tensor);
+    }
+    outputs_[index] = TensorValue(output_tensor.release());
+    *output = outputs_[index].tensor;
+    return OkStatus();
+  }
   Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
   if (s.ok()) {
+    if (arena != nullptr) {
+      arena->RecordOutput(params_->op_kernel, index, *output_tensor);
+    }
     outputs_[index] = TensorValue(output_tensor.release());
     *output = outputs_[index].tensor;
   }
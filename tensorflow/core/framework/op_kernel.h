@@ -562,6 +562,30 @@ struct GraphCollector {
   }
 };
 
+// Provides preassigned memory for the outputs of the kernels run by one step,
+// in place of the device allocator. See
+// "tensorflow/core/common_runtime/step_memory_planner.h" for an
+// implementation.
+//
+// Only outputs that would otherwise be allocated with the default allocator
+// attributes are passed to the arena. The methods may be called concurrently
+// by the kernels of the step.
+class StepMemoryArena {
+ public:
+  virtual ~StepMemoryArena() = default;
+
+  // Returns true and sets "*tensor" to a tensor with the given type and shape
+  // backed by the arena if output "index" of "kernel" has a slot in the arena
+  // that fits. Otherwise returns false, and the output is allocated as usual.
+  virtual bool AllocateOutput(const OpKernel* kernel, int index, DataType type,
+                              const TensorShape& shape, Tensor* tensor) = 0;
+
+  // Called with "tensor" after output "index" of "kernel" has been allocated
+  // as usual.
+  virtual void RecordOutput(const OpKernel* kernel, int index,
+                            const Tensor& tensor) = 0;
+};
+
 class OpKernelContext {
  public:
   // The first element of a WrappedAllocator is a "base" Allocator and
@@ -649,6 +673,10 @@ class OpKernelContext {
     // The tensor store for this op.
     TensorStore* tensor_store = nullptr;
 
+    // If not nullptr, provides the memory for the outputs of this op that are
+    // allocated with the default allocator attributes.
+    StepMemoryArena* step_memory_arena = nullptr;
+
     // Mechanism used by this op kernel invocation to register a callback
     // for its cancellation.
     CancellationManager* cancellation_manager = nullptr;
@@ -53,6 +53,11 @@ class RendezvousInterface {
     DeviceContext* device_context = nullptr;
     AllocatorAttributes alloc_attrs;
     CancellationManager* cancellation_manager = nullptr;  // not owned.
+    // Index of a preassigned rendezvous slot shared by exactly one Send/Recv
+    // pair, or -1. Only set for root-frame transfers whose slots were
+    // assigned at graph partitioning time; LocalRendezvous uses it to match
+    // the pair without hashing the key or taking a bucket lock.
+    int64_t rendezvous_slot = -1;
   };
 
   // Parses the key constructed by CreateKey and parse src/dst device
@@ -394,6 +394,92 @@ TEST_F(LocalRendezvousTest, AbortThenRecvOrSend) {
   EXPECT_TRUE(absl::IsAborted(rendez_->Recv(KeyFoo(), args, &val, &val_dead)));
 }
 
+TEST_F(LocalRendezvousTest, SlotSendRecv) {
+  Rendezvous::Args args;
+  args.rendezvous_slot = 3;
+  TF_ASSERT_OK(rendez_->Send(KeyFoo(), args, V("hello"), false));
+  Tensor val(DT_STRING);
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(KeyFoo(), args, &val, &is_dead));
+  EXPECT_EQ("hello", V(val));
+}
+
+TEST_F(LocalRendezvousTest, SlotRecvSend) {
+  SchedClosure([this]() {
+    Env::Default()->SleepForMicroseconds(10000);
+    Rendezvous::Args args;
+    args.rendezvous_slot = 100;
+    TF_ASSERT_OK(rendez_->Send(KeyFoo(), args, V("hello"), true));
+  });
+  Tensor val(DT_STRING);
+  bool is_dead = false;
+  Rendezvous::Args args;
+  args.rendezvous_slot = 100;
+  TF_ASSERT_OK(rendez_->Recv(KeyFoo(), args, &val, &is_dead));
+  EXPECT_TRUE(is_dead);
+}
+
+TEST_F(LocalRendezvousTest, SlotsAreIndependentOfKeys) {
+  // Distinct slots never match each other, and a slot out of range falls
+  // back to matching by key.
+  Rendezvous::Args args0;
+  args0.rendezvous_slot = 0;
+  Rendezvous::Args args1;
+  args1.rendezvous_slot = 1;
+  Rendezvous::Args out_of_range;
+  out_of_range.rendezvous_slot = int64_t{1} << 40;
+  TF_ASSERT_OK(rendez_->Send(KeyFoo(), args0, V("zero"), false));
+  TF_ASSERT_OK(rendez_->Send(KeyFoo(), args1, V("one"), false));
+  TF_ASSERT_OK(rendez_->Send(KeyBar(), out_of_range, V("bar"), false));
+  Tensor val(DT_STRING);
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(KeyFoo(), args1, &val, &is_dead));
+  EXPECT_EQ("one", V(val));
+  TF_ASSERT_OK(rendez_->Recv(KeyFoo(), args0, &val, &is_dead));
+  EXPECT_EQ("zero", V(val));
+  TF_ASSERT_OK(rendez_->Recv(KeyBar(), Rendezvous::Args(), &val, &is_dead));
+  EXPECT_EQ("bar", V(val));
+}
+
+TEST_F(LocalRendezvousTest, SlotCancelAfterRecv) {
+  auto* cm = new CancellationManager();
+  Notification n;
+  SchedClosure([cm, &n]() {
+    Env::Default()->SleepForMicroseconds(10000);
+    cm->StartCancel();
+    n.Notify();
+  });
+  Tensor val(DT_STRING);
+  bool is_dead = false;
+  Rendezvous::Args args;
+  args.cancellation_manager = cm;
+  args.rendezvous_slot = 7;
+  auto s = rendez_->Recv(KeyFoo(), args, &val, &is_dead);
+  EXPECT_TRUE(absl::IsCancelled(s));
+  EXPECT_EQ("RecvAsync is cancelled.", s.message());
+  n.WaitForNotification();
+  delete cm;
+  // The late message is dropped.
+  args.cancellation_manager = nullptr;
+  TF_EXPECT_OK(rendez_->Send(KeyFoo(), args, V("hello"), false));
+}
+
+TEST_F(LocalRendezvousTest, SlotRecvAbort) {
+  rendez_->Ref();
+  SchedClosure([this]() {
+    Env::Default()->SleepForMicroseconds(10000);
+    rendez_->StartAbort(errors::Aborted(""));  // abort
+    rendez_->Unref();
+  });
+  Tensor val(DT_STRING);
+  bool val_dead = false;
+  Rendezvous::Args args;
+  args.rendezvous_slot = 70;
+  Status status = rendez_->Recv(KeyFoo(), args, &val, &val_dead);
+  EXPECT_TRUE(absl::IsAborted(status));
+  EXPECT_TRUE(absl::IsAborted(rendez_->Send(KeyFoo(), args, val, val_dead)));
+}
+
 class DummyDeviceContext : public DeviceContext {
  public:
   explicit DummyDeviceContext(int stream_id) : stream_id_(stream_id) {}
@@ -451,6 +537,32 @@ void BM_SendRecv(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_SendRecv);
 
+void BM_SendRecvSlot(::testing::benchmark::State& state) {
+  Rendezvous* rendez = NewLocalRendezvous();
+  Tensor orig = V("val");
+  Tensor val(DT_STRING, TensorShape({}));
+  bool is_dead = false;
+  Rendezvous::Args args;
+
+  // Each slot matches only once per rendezvous, so cycle through the
+  // available slots and then start over with a fresh rendezvous.
+  int64_t slot = 0;
+  for (auto s : state) {
+    args.rendezvous_slot = slot;
+    TF_CHECK_OK(rendez->Send(KeyFoo(), args, orig, is_dead));
+    TF_CHECK_OK(rendez->Recv(KeyFoo(), args, &val, &is_dead));
+    if (++slot == 4096) {
+      rendez->Unref();
+      rendez = NewLocalRendezvous();
+      slot = 0;
+    }
+  }
+  CHECK_EQ(V(val), V(orig));
+
+  rendez->Unref();
+}
+BENCHMARK(BM_SendRecvSlot);
+
 void BM_RecvSend(::testing::benchmark::State& state) {
   Rendezvous* rendez = NewLocalRendezvous();
   Tensor orig = V("val");
@@ -128,6 +128,13 @@ ResourceMgr::ResourceAndName& ResourceMgr::ResourceAndName::operator=(
   return *this;
 }
 
+int ResourceMgr::ShardedMutex::ThisThreadShard() {
+  static std::atomic<int> next_shard(0);
+  static thread_local const int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  return shard;
+}
+
 ResourceMgr::ResourceMgr() : default_container_("localhost") {}
 
 ResourceMgr::ResourceMgr(const string& default_container)
@@ -140,7 +147,7 @@ void ResourceMgr::Clear() {
   // in case any of the destructors access the resource manager.
   absl::flat_hash_map<string, Container*> tmp_containers;
   {
-    mutex_lock l(mu_);
+    ExclusiveLock l(mu_);
     tmp_containers = std::move(containers_);
     containers_.clear();  // reinitialize after move.
   }
@@ -150,7 +157,7 @@ void ResourceMgr::Clear() {
 }
 
 string ResourceMgr::DebugString() const {
-  mutex_lock l(mu_);
+  ExclusiveLock l(mu_);
   struct Line {
     const string* container;
     const string type;
@@ -201,7 +208,7 @@ Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
     resource_and_name.resource = core::RefCountPtr<ResourceBase>(resource);
   } else {
     auto cleanup_fn = [this, container, type, borrowed_name]() {
-      mutex_lock l(mu_);
+      ExclusiveLock l(mu_);
       auto iter = container->find({type.hash_code(), borrowed_name});
       if (iter != container->end()) {
         container->erase(iter);
@@ -225,7 +232,7 @@ Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
 
 Status ResourceMgr::Lookup(const ResourceHandle& handle,
                            ResourceBase** resource) const {
-  tf_shared_lock l(mu_);
+  SharedLock l(mu_);
   return DoLookup(handle.container(), handle.hash_code(),
                   /*type_name=*/"ResourceBase", handle.name(), resource);
 }
@@ -265,7 +272,7 @@ Status ResourceMgr::PopResourceAndName(const string& container,
                                        const string& resource_name,
                                        const string& type_name,
                                        ResourceAndName& resource_and_name) {
-  mutex_lock l(mu_);
+  ExclusiveLock l(mu_);
   Container* b = gtl::FindPtrOrNull(containers_, container);
   if (b == nullptr) {
     return errors::NotFound("Container ", container, " does not exist.");
@@ -310,7 +317,7 @@ Status ResourceMgr::Delete(const ResourceHandle& handle) {
 
 Status ResourceMgr::Cleanup(const string& container) {
   {
-    tf_shared_lock l(mu_);
+    SharedLock l(mu_);
     if (!gtl::FindOrNull(containers_, container)) {
       // Nothing to cleanup.
       return OkStatus();
@@ -318,7 +325,7 @@ Status ResourceMgr::Cleanup(const string& container) {
   }
   Container* b = nullptr;
   {
-    mutex_lock l(mu_);
+    ExclusiveLock l(mu_);
     auto iter = containers_.find(container);
     if (iter == containers_.end()) {
       // Nothing to cleanup, it's OK (concurrent cleanup).
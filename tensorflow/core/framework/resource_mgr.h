@@ -272,8 +272,65 @@ class ResourceMgr {
   typedef absl::flat_hash_map<Key, ResourceAndName, KeyHash, KeyEqual>
       Container;
 
+  // A reader-writer lock that is sharded for readers. A reader locks one of
+  // kNumShards mutexes in shared mode, chosen per thread, so that concurrent
+  // lookups from many threads do not contend on a single reader count. A
+  // writer locks all shards, which makes creating and deleting resources more
+  // expensive; those are rare compared to lookups.
+  class TF_LOCKABLE ShardedMutex {
+   public:
+    void lock() TF_EXCLUSIVE_LOCK_FUNCTION() {
+      for (Shard& shard : shards_) shard.mu.lock();
+    }
+    void unlock() TF_UNLOCK_FUNCTION() {
+      for (int i = kNumShards - 1; i >= 0; --i) shards_[i].mu.unlock();
+    }
+    // Returns the shard that must be passed to `unlock_shared`.
+    int lock_shared() TF_SHARED_LOCK_FUNCTION() {
+      const int shard = ThisThreadShard();
+      shards_[shard].mu.lock_shared();
+      return shard;
+    }
+    void unlock_shared(int shard) TF_UNLOCK_FUNCTION() {
+      shards_[shard].mu.unlock_shared();
+    }
+
+   private:
+    static constexpr int kNumShards = 16;
+    static int ThisThreadShard();
+
+    // Each shard is on its own cache line to avoid false sharing.
+    struct alignas(64) Shard {
+      mutex mu;
+    };
+    Shard shards_[kNumShards];
+  };
+
+  class TF_SCOPED_LOCKABLE ExclusiveLock {
+   public:
+    explicit ExclusiveLock(ShardedMutex& mu) TF_EXCLUSIVE_LOCK_FUNCTION(mu)
+        : mu_(mu) {
+      mu_.lock();
+    }
+    ~ExclusiveLock() TF_UNLOCK_FUNCTION() { mu_.unlock(); }
+
+   private:
+    ShardedMutex& mu_;
+  };
+
+  class TF_SCOPED_LOCKABLE SharedLock {
+   public:
+    explicit SharedLock(ShardedMutex& mu) TF_SHARED_LOCK_FUNCTION(mu)
+        : mu_(mu), shard_(mu.lock_shared()) {}
+    ~SharedLock() TF_UNLOCK_FUNCTION() { mu_.unlock_shared(shard_); }
+
+   private:
+    ShardedMutex& mu_;
+    const int shard_;
+  };
+
   const std::string default_container_;
-  mutable mutex mu_;
+  mutable ShardedMutex mu_;
   absl::flat_hash_map<string, Container*> containers_ TF_GUARDED_BY(mu_);
 
   template <typename T, bool use_dynamic_cast = false>
@@ -640,7 +697,7 @@ Status ResourceMgr::Create(const std::string& container,
                            const std::string& name, T* resource) {
   CheckDeriveFromResourceBase<T>();
   CHECK(resource != nullptr);
-  mutex_lock l(mu_);
+  ExclusiveLock l(mu_);
   return DoCreate(container, TypeIndex::Make<T>(), name, resource,
                   /* owns_resource */ true);
 }
@@ -649,7 +706,7 @@ template <typename T>
 Status ResourceMgr::CreateUnowned(const std::string& container,
                                   const std::string& name, T* resource) {
   CheckDeriveFromResourceBase<T>();
-  mutex_lock l(mu_);
+  ExclusiveLock l(mu_);
   return DoCreate(container, TypeIndex::Make<T>(), name, resource,
                   /* owns_resource */ false);
 }
@@ -658,7 +715,7 @@ template <typename T, bool use_dynamic_cast>
 Status ResourceMgr::Lookup(const std::string& container,
                            const std::string& name, T** resource) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
+  SharedLock l(mu_);
   return LookupInternal<T, use_dynamic_cast>(container, name, resource);
 }
 
@@ -668,7 +725,7 @@ Status ResourceMgr::LookupMany(
         containers_and_names,
     std::vector<core::RefCountPtr<T>>* resources) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
+  SharedLock l(mu_);
   resources->resize(containers_and_names.size());
   for (size_t i = 0; i < containers_and_names.size(); ++i) {
     T* resource;
@@ -715,11 +772,11 @@ Status ResourceMgr::LookupOrCreate(const std::string& container,
   *resource = nullptr;
   Status s;
   {
-    tf_shared_lock l(mu_);
+    SharedLock l(mu_);
     s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
     if (s.ok()) return s;
   }
-  mutex_lock l(mu_);
+  ExclusiveLock l(mu_);
   s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
   if (s.ok()) return s;
   TF_RETURN_IF_ERROR(creator(resource));
@@ -28,9 +28,11 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/regexp.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 
 namespace tensorflow {
@@ -527,4 +529,49 @@ TEST(ResourceHandleTest, DeleteUsingResourceHandle) {
   EXPECT_NE(LookupResource<StubResource>(&ctx, p, &lookup_r).ok(), true);
 }
 
+TEST(ResourceMgrTest, ConcurrentLookupsAndCreates) {
+  ResourceMgr rm;
+  TF_CHECK_OK(rm.Create("container", "shared", new Resource("shared")));
+  thread::ThreadPool threads(Env::Default(), "lookups_and_creates", 8);
+  for (int t = 0; t < 8; ++t) {
+    threads.Schedule([&rm, t]() {
+      for (int i = 0; i < 100; ++i) {
+        Resource* r = nullptr;
+        TF_CHECK_OK(rm.Lookup("container", "shared", &r));
+        EXPECT_EQ("R/shared", r->DebugString());
+        r->Unref();
+        const string name = strings::StrCat("r", t, "_", i);
+        TF_CHECK_OK(rm.Create("container", name, new Resource(name)));
+        TF_CHECK_OK(rm.Delete<Resource>("container", name));
+      }
+    });
+  }
+}
+
+// Measures lookups of a single resource from `state.range(0)` threads.
+void BM_ResourceMgrConcurrentLookup(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  constexpr int kLookupsPerThread = 1000;
+  ResourceMgr rm;
+  TF_CHECK_OK(rm.Create("container", "resource", new Resource("resource")));
+  thread::ThreadPool threads(Env::Default(), "lookups", num_threads);
+  for (auto s : state) {
+    BlockingCounter counter(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.Schedule([&rm, &counter]() {
+        for (int i = 0; i < kLookupsPerThread; ++i) {
+          Resource* r = nullptr;
+          TF_CHECK_OK(rm.Lookup("container", "resource", &r));
+          r->Unref();
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_threads * kLookupsPerThread);
+}
+BENCHMARK(BM_ResourceMgrConcurrentLookup)->Arg(1)->Arg(8)->Arg(64);
+
 }  // end namespace tensorflow
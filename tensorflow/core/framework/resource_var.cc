@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/framework/resource_var.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/framework/resource_handle.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
 
@@ -45,4 +47,46 @@ std::string Var::MakeRefCountingHandleName(int64_t resource_id) const {
   std::string handle_name = absl::StrFormat("%s%d", debug_name_, resource_id);
   return handle_name;
 }
+
+void Var::StartTrackingDirtyRows() {
+  mutex_lock l(dirty_rows_mu_);
+  all_rows_dirty_ = false;
+  dirty_rows_.clear();
+  track_dirty_rows_ = true;
+}
+
+void Var::MarkDirtyRows(const Tensor& indices) {
+  if (!track_dirty_rows_.load(std::memory_order_relaxed)) return;
+  mutex_lock l(dirty_rows_mu_);
+  if (all_rows_dirty_) return;
+  if (indices.dtype() == DT_INT32) {
+    const auto rows = indices.flat<int32_t>();
+    for (int64_t i = 0; i < rows.size(); ++i) dirty_rows_.insert(rows(i));
+  } else if (indices.dtype() == DT_INT64) {
+    const auto rows = indices.flat<int64_t>();
+    for (int64_t i = 0; i < rows.size(); ++i) dirty_rows_.insert(rows(i));
+  } else {
+    all_rows_dirty_ = true;
+    dirty_rows_.clear();
+  }
+}
+
+void Var::MarkAllRowsDirty() {
+  if (!track_dirty_rows_.load(std::memory_order_relaxed)) return;
+  mutex_lock l(dirty_rows_mu_);
+  all_rows_dirty_ = true;
+  dirty_rows_.clear();
+}
+
+bool Var::TakeDirtyRows(bool* all_rows, std::vector<int64_t>* rows) {
+  mutex_lock l(dirty_rows_mu_);
+  if (!track_dirty_rows_) return false;
+  *all_rows = all_rows_dirty_;
+  rows->assign(dirty_rows_.begin(), dirty_rows_.end());
+  std::sort(rows->begin(), rows->end());
+  all_rows_dirty_ = false;
+  dirty_rows_.clear();
+  return true;
+}
+
 }  //  end namespace tensorflow
@@ -16,11 +16,17 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/framework/resource_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 // Forward declarations to avoid introducing a dependency on headers in
 // "tensorflow/core/graph/...".
@@ -110,11 +116,36 @@ class Var : public ResourceBase {
   // so desired.
   std::atomic<bool> copy_on_read_mode{false};
 
+  // Starts recording which rows (indices into the first dimension) of the
+  // variable are updated, for incremental checkpoints, and forgets the rows
+  // recorded so far.
+  void StartTrackingDirtyRows() TF_LOCKS_EXCLUDED(dirty_rows_mu_);
+
+  // Records that the rows at "indices", an int32 or int64 tensor in host
+  // memory, were updated. Does nothing unless tracking was started.
+  void MarkDirtyRows(const Tensor& indices) TF_LOCKS_EXCLUDED(dirty_rows_mu_);
+
+  // Records that any row may have been updated, for dense updates and for
+  // sparse updates whose indices are not in host memory. Does nothing unless
+  // tracking was started.
+  void MarkAllRowsDirty() TF_LOCKS_EXCLUDED(dirty_rows_mu_);
+
+  // Returns whether tracking was started. If so, sets "all_rows" to whether
+  // any row may have been updated, and otherwise sets "rows" to the sorted
+  // updated rows, and forgets the recorded rows.
+  bool TakeDirtyRows(bool* all_rows, std::vector<int64_t>* rows)
+      TF_LOCKS_EXCLUDED(dirty_rows_mu_);
+
  private:
   mutex mu_;
   Tensor tensor_;
   std::string debug_name_;
 
+  std::atomic<bool> track_dirty_rows_{false};
+  mutex dirty_rows_mu_;
+  bool all_rows_dirty_ TF_GUARDED_BY(dirty_rows_mu_) = false;
+  absl::flat_hash_set<int64_t> dirty_rows_ TF_GUARDED_BY(dirty_rows_mu_);
+
   ~Var() override {}
   Var(const Var&) = delete;
   void operator=(const Var&) = delete;
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/framework/resource_var.h"
 
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -34,5 +38,29 @@ TEST(ResourceVarTest, Uninitialize) {
   EXPECT_FALSE(var->is_initialized);
   EXPECT_TRUE(var->tensor()->data() == nullptr);
 }
+
+TEST(ResourceVarTest, TrackDirtyRows) {
+  RefCountPtr<Var> var{new Var(DT_FLOAT)};
+  bool all_rows = false;
+  std::vector<int64_t> rows;
+  var->MarkDirtyRows(test::AsTensor<int32>({1}));
+  EXPECT_FALSE(var->TakeDirtyRows(&all_rows, &rows));
+
+  var->StartTrackingDirtyRows();
+  var->MarkDirtyRows(test::AsTensor<int32>({5, 1}));
+  var->MarkDirtyRows(test::AsTensor<int64_t>({3, 5}));
+  EXPECT_TRUE(var->TakeDirtyRows(&all_rows, &rows));
+  EXPECT_FALSE(all_rows);
+  EXPECT_EQ(rows, std::vector<int64_t>({1, 3, 5}));
+  EXPECT_TRUE(var->TakeDirtyRows(&all_rows, &rows));
+  EXPECT_TRUE(rows.empty());
+
+  var->MarkAllRowsDirty();
+  var->MarkDirtyRows(test::AsTensor<int32>({2}));
+  EXPECT_TRUE(var->TakeDirtyRows(&all_rows, &rows));
+  EXPECT_TRUE(all_rows);
+  EXPECT_TRUE(var->TakeDirtyRows(&all_rows, &rows));
+  EXPECT_FALSE(all_rows);
+}
 }  // namespace core
 }  // namespace tensorflow
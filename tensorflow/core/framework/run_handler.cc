@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool_interface.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/denormal.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/numa.h"
@@ -333,11 +334,20 @@ RunHandlerThreadPool::RunHandlerThreadPool(
           std::vector<double>({0, 0.4}))),
       sub_thread_pool_end_request_percentage_(ParamFromEnvWithDefault(
           "TF_RUN_HANDLER_SUB_THREAD_POOL_END_REQUEST_PERCENTAGE",
-          std::vector<double>({0.4, 1}))) {
+          std::vector<double>({0.4, 1}))),
+      // Core groups are not supported together with sub thread pools, and
+      // each group has at least one blocking thread.
+      num_core_groups_(use_sub_thread_pool_
+                           ? 0
+                           : std::min(num_blocking_threads,
+                                      static_cast<int>(ParamFromEnvWithDefault(
+                                          "TF_RUN_HANDLER_NUM_CORE_GROUPS",
+                                          0)))) {
   thread_data_.resize(num_threads_);
   VLOG(1) << "Creating RunHandlerThreadPool " << name << " with  "
           << num_blocking_threads_ << " blocking threads and "
-          << num_non_blocking_threads_ << " non-blocking threads.";
+          << num_non_blocking_threads_ << " non-blocking threads and "
+          << num_core_groups_ << " core groups.";
 }
 
 RunHandlerThreadPool::~RunHandlerThreadPool() {
@@ -366,12 +376,30 @@ void RunHandlerThreadPool::Start() {
     }
     thread_data_[i].sub_thread_pool_id = sub_thread_pool_id;
     const bool is_blocking_thread = (i < num_blocking_threads) ? true : false;
+    // The CPUs are split into core groups in the order of their ids, which
+    // usually keeps the CPUs of a group on the same L3 cache slice.
+    int first_cpu = 0;
+    int num_cpus = 0;
+    if (num_core_groups_ > 0) {
+      const int num_schedulable_cpus = port::NumSchedulableCPUs();
+      const int core_group = CoreGroupOfThread(i);
+      first_cpu = core_group * num_schedulable_cpus / num_core_groups_;
+      num_cpus = std::max(
+          1, (core_group + 1) * num_schedulable_cpus / num_core_groups_ -
+                 first_cpu);
+    }
     // The blocking threads will handle both inter and intra op workload;
     // non-blocking thread will handle intra op workload only; and the
     // sub thread pool is only provided for blocking threads.
     // Name the threads accordingly.
     thread_data_[i].thread.reset(env_.CreateThread(
-        [this, is_blocking_thread, i, sub_thread_pool_id]() {
+        [this, is_blocking_thread, i, first_cpu, num_cpus]() {
+          if (num_cpus > 0 &&
+              !port::SetCurrentThreadCPUAffinity(first_cpu, num_cpus)) {
+            VLOG(1) << "Could not pin thread " << i << " of " << name_
+                    << " to CPUs [" << first_cpu << ", "
+                    << first_cpu + num_cpus << ")";
+          }
           WorkerLoop(i, is_blocking_thread);
         },
         is_blocking_thread
@@ -472,6 +500,18 @@ int RunHandlerThreadPool::NumNonBlockingThreads() const {
   return num_non_blocking_threads_;
 }
 
+int RunHandlerThreadPool::NumCoreGroups() const { return num_core_groups_; }
+
+int RunHandlerThreadPool::CoreGroupOfThread(int thread_id) const {
+  // The blocking and the non-blocking threads are each split into contiguous
+  // ranges of threads, one per core group.
+  if (thread_id < num_blocking_threads_) {
+    return thread_id * num_core_groups_ / num_blocking_threads_;
+  }
+  return (thread_id - num_blocking_threads_) * num_core_groups_ /
+         num_non_blocking_threads_;
+}
+
 RunHandlerThreadPool::ThreadData::ThreadData()
     : new_version(0),
       current_index(0),
@@ -748,6 +788,11 @@ class RunHandler::Impl {
 
   int64_t priority() { return options_.priority(); }
 
+  // The core group that the handler is assigned to, if the pool uses core
+  // groups.
+  int core_group() const { return core_group_; }
+  void set_core_group(int core_group) { core_group_ = core_group; }
+
  private:
   class ThreadPoolInterfaceWrapper : public thread::ThreadPoolInterface {
    public:
@@ -768,6 +813,7 @@ class RunHandler::Impl {
   std::unique_ptr<thread::ThreadPoolInterface> thread_pool_interface_;
   internal::ThreadWorkSource tws_;
   RunOptions::Experimental::RunHandlerPoolOptions options_;
+  int core_group_ = 0;
 };
 
 // Contains shared state across all run handlers present in the pool. Also
@@ -806,6 +852,8 @@ class RunHandlerPool::Impl {
       queue_waiter.next = &queue_waiter;
       queue_waiter.prev = &queue_waiter;
     }
+    num_handlers_in_core_group_.resize(
+        run_handler_thread_pool_->NumCoreGroups());
     run_handler_thread_pool_->Start();
   }
 
@@ -841,6 +889,7 @@ class RunHandlerPool::Impl {
                     static_cast<int32>(ParamFromEnvWithDefault(
                         "TF_RUN_HANDLER_MAX_CONCURRENT_HANDLERS",
                         kMaxConcurrentHandlers))));
+    thread_local std::vector<int> core_groups;
     uint64 version;
     int num_active_requests;
     RunHandler::Impl* handler_impl;
@@ -870,9 +919,19 @@ class RunHandlerPool::Impl {
       handler_impl = free_handlers_.back();
       handler_impl->Reset(step_id, options);
       free_handlers_.pop_back();
+      if (!num_handlers_in_core_group_.empty()) {
+        // Assign the handler to the core group with the fewest handlers.
+        const int core_group =
+            std::min_element(num_handlers_in_core_group_.begin(),
+                             num_handlers_in_core_group_.end()) -
+            num_handlers_in_core_group_.begin();
+        handler_impl->set_core_group(core_group);
+        ++num_handlers_in_core_group_[core_group];
+      }
 
       num_active_requests = sorted_active_handlers_.size() + 1;
       thread_work_sources->resize(num_active_requests);
+      core_groups.resize(num_active_requests);
       int priority = options.priority();
       auto it = sorted_active_handlers_.cbegin();
       bool new_handler_inserted = false;
@@ -885,11 +944,13 @@ class RunHandlerPool::Impl {
           --it;
         }
         (*thread_work_sources)[i] = (*it)->tws();
+        core_groups[i] = (*it)->core_group();
         ++it;
       }
       version = ++version_;
     }
-    RecomputePoolStats(num_active_requests, version, *thread_work_sources);
+    RecomputePoolStats(num_active_requests, version, *thread_work_sources,
+                       core_groups);
     return std::unique_ptr<RunHandler>(new RunHandler(handler_impl));
   }
 
@@ -916,6 +977,9 @@ class RunHandlerPool::Impl {
     // handlers.
     sorted_active_handlers_.erase(iter);
     free_handlers_.push_back(handler);
+    if (!num_handlers_in_core_group_.empty()) {
+      --num_handlers_in_core_group_[handler->core_group()];
+    }
     DCHECK_LE(free_handlers_.size(), max_handlers_);
     LogInfo();
 
@@ -938,7 +1002,17 @@ class RunHandlerPool::Impl {
   void RecomputePoolStats(
       int num_active_requests, uint64 version,
       const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
-          thread_work_sources);
+          thread_work_sources,
+      const std::vector<int>& core_groups);
+
+  // Like RecomputePoolStats() for a pool with core groups: the threads of
+  // each core group look for work in the requests assigned to their group
+  // first.
+  void RecomputeCoreGroupPoolStats(
+      int num_active_requests, uint64 version,
+      const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
+          thread_work_sources,
+      const std::vector<int>& core_groups);
 
   void LogInfo() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
@@ -961,6 +1035,9 @@ class RunHandlerPool::Impl {
   std::list<RunHandler::Impl*> sorted_active_handlers_ TF_GUARDED_BY(mu_);
   std::vector<RunHandler::Impl*> free_handlers_ TF_GUARDED_BY(mu_);
   std::vector<std::unique_ptr<RunHandler::Impl>> handlers_ TF_GUARDED_BY(mu_);
+  // The number of active handlers assigned to each core group. Empty if the
+  // pool does not use core groups.
+  std::vector<int> num_handlers_in_core_group_ TF_GUARDED_BY(mu_);
 
   // Histogram of elapsed runtime of every handler (in ms).
   histogram::Histogram time_hist_ TF_GUARDED_BY(mu_);
@@ -974,7 +1051,8 @@ class RunHandlerPool::Impl {
 void RunHandlerPool::Impl::RecomputePoolStats(
     int num_active_requests, uint64 version,
     const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
-        thread_work_sources) {
+        thread_work_sources,
+    const std::vector<int>& core_groups) {
   if (num_active_requests == 0) return;
 
   int sub_thread_pool_id = 0;
@@ -991,6 +1069,12 @@ void RunHandlerPool::Impl::RecomputePoolStats(
                                       &waiters_mu_[sub_thread_pool_id]);
   }
 
+  if (run_handler_thread_pool()->NumCoreGroups() > 0) {
+    RecomputeCoreGroupPoolStats(num_active_requests, version,
+                                thread_work_sources, core_groups);
+    return;
+  }
+
   int num_threads = run_handler_thread_pool()->NumThreads();
   int num_blocking_threads = run_handler_thread_pool()->NumBlockingThreads();
   int num_non_blocking_threads = num_threads - num_blocking_threads;
@@ -1015,6 +1099,58 @@ void RunHandlerPool::Impl::RecomputePoolStats(
   }
 }
 
+void RunHandlerPool::Impl::RecomputeCoreGroupPoolStats(
+    int num_active_requests, uint64 version,
+    const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
+        thread_work_sources,
+    const std::vector<int>& core_groups) {
+  internal::RunHandlerThreadPool* pool = run_handler_thread_pool();
+  const int num_blocking_threads = pool->NumBlockingThreads();
+  for (int core_group = 0; core_group < pool->NumCoreGroups(); ++core_group) {
+    // The requests of the group come first, in priority order, followed by
+    // the other requests, from which the threads of the group steal when
+    // there is no work left in their group.
+    Eigen::MaxSizeVector<internal::ThreadWorkSource*> group_work_sources(
+        num_active_requests);
+    for (int i = 0; i < num_active_requests; ++i) {
+      if (core_groups[i] == core_group) {
+        group_work_sources.push_back(thread_work_sources[i]);
+      }
+    }
+    const int num_group_requests = group_work_sources.size();
+    for (int i = 0; i < num_active_requests; ++i) {
+      if (core_groups[i] != core_group) {
+        group_work_sources.push_back(thread_work_sources[i]);
+      }
+    }
+
+    // Spreads the blocking and the non-blocking threads of the group over the
+    // requests of the group.
+    for (const bool is_blocking : {true, false}) {
+      std::vector<int> group_threads;
+      const int begin = is_blocking ? 0 : num_blocking_threads;
+      const int end = is_blocking ? num_blocking_threads : pool->NumThreads();
+      for (int tid = begin; tid < end; ++tid) {
+        if (pool->CoreGroupOfThread(tid) == core_group) {
+          group_threads.push_back(tid);
+        }
+      }
+      std::vector<int> request_idx_list =
+          num_group_requests > 0
+              ? ChooseRequestsWithExponentialDistribution(
+                    num_group_requests, group_threads.size())
+              : std::vector<int>(group_threads.size(), 0);
+      for (int i = 0; i < group_threads.size(); ++i) {
+        VLOG(2) << "Set work for tid=" << group_threads[i]
+                << " in core group " << core_group
+                << " with start_request_idx=" << request_idx_list[i];
+        pool->SetThreadWorkSources(group_threads[i], request_idx_list[i],
+                                   version, group_work_sources);
+      }
+    }
+  }
+}
+
 void RunHandlerPool::Impl::LogInfo() {
   if (iterations_++ % 50000 == 10 && VLOG_IS_ON(1)) {
     int num_active_requests = sorted_active_handlers_.size();
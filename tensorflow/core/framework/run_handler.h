@@ -252,6 +252,14 @@ class RunHandlerThreadPool {
 
   int NumNonBlockingThreads() const;
 
+  // Returns the number of core groups, or 0 if the threads are not split into
+  // core groups.
+  int NumCoreGroups() const;
+
+  // Returns the core group of the thread 'thread_id'. Only valid if
+  // NumCoreGroups() > 0.
+  int CoreGroupOfThread(int thread_id) const;
+
   void WorkerLoop(int thread_id, bool may_steal_blocking_work);
 
   // Search tasks from Requets range searching_range_start to
@@ -306,6 +314,12 @@ class RunHandlerThreadPool {
   // fashion.
   std::vector<double> sub_thread_pool_start_request_percentage_;
   std::vector<double> sub_thread_pool_end_request_percentage_;
+
+  // If positive, the blocking and the non-blocking threads are each split into
+  // this many groups, and the threads of each group are pinned to a contiguous
+  // block of CPUs. Each request is assigned to one group, whose threads look
+  // for the inter-op and intra-op work of the request first.
+  const int num_core_groups_;
 };
 
 }  // namespace internal
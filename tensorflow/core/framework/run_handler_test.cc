@@ -583,6 +583,59 @@ TEST(RunHandlerThreadPool, MultipleSubThreadPool) {
   delete run_handler_thread_pool;
 }
 
+TEST(RunHandlerThreadPool, CoreGroups) {
+  setenv("TF_RUN_HANDLER_USE_SUB_THREAD_POOL", "false", true);
+  setenv("TF_RUN_HANDLER_NUM_CORE_GROUPS", "2", true);
+
+  Eigen::MaxSizeVector<mutex> waiters_mu(1);
+  waiters_mu.resize(1);
+  Eigen::MaxSizeVector<internal::Waiter> waiters(1);
+  waiters.resize(1);
+  auto run_handler_thread_pool =
+      std::make_unique<internal::RunHandlerThreadPool>(
+          /*num_blocking_threads=*/4, /*num_non_blocking_threads=*/2,
+          Env::Default(), ThreadOptions(), "tf_run_handler_pool", &waiters_mu,
+          &waiters);
+  unsetenv("TF_RUN_HANDLER_NUM_CORE_GROUPS");
+
+  ASSERT_EQ(run_handler_thread_pool->NumCoreGroups(), 2);
+  // The blocking and the non-blocking threads are each split into contiguous
+  // ranges.
+  std::vector<int> core_groups;
+  for (int tid = 0; tid < run_handler_thread_pool->NumThreads(); ++tid) {
+    core_groups.push_back(run_handler_thread_pool->CoreGroupOfThread(tid));
+  }
+  EXPECT_EQ(core_groups, std::vector<int>({0, 0, 1, 1, 0, 1}));
+}
+
+TEST(RunHandlerPoolTest, CoreGroups) {
+  setenv("TF_RUN_HANDLER_USE_SUB_THREAD_POOL", "false", true);
+  setenv("TF_RUN_HANDLER_NUM_CORE_GROUPS", "2", true);
+  auto pool = std::make_unique<RunHandlerPool>(/*num_inter_op_threads=*/4,
+                                               /*num_intra_op_threads=*/2);
+  unsetenv("TF_RUN_HANDLER_NUM_CORE_GROUPS");
+
+  // Concurrent requests, which are spread over both core groups, run their
+  // inter-op and intra-op closures.
+  constexpr int kNumHandlers = 5;
+  constexpr int kNumClosures = 100;
+  BlockingCounter counter(kNumHandlers * kNumClosures * 2);
+  std::vector<std::unique_ptr<RunHandler>> handlers;
+  for (int i = 0; i < kNumHandlers; ++i) {
+    handlers.push_back(pool->Get(i));
+  }
+  for (auto& handler : handlers) {
+    for (int i = 0; i < kNumClosures; ++i) {
+      handler->ScheduleInterOpClosure(
+          [&counter]() { counter.DecrementCount(); });
+      handler->AsIntraThreadPoolInterface()->Schedule(
+          [&counter]() { counter.DecrementCount(); });
+    }
+  }
+  counter.Wait();
+  handlers.clear();
+}
+
 SessionOptions DefaultSessionOptions() {
   SessionOptions options;
   (*options.config.mutable_device_count())["CPU"] = 2;
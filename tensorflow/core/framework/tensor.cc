@@ -159,6 +159,67 @@ class Buffer : public BufferBase {
   void operator=(const Buffer&) = delete;
 };
 
+// Tensors of simple types whose data fits in this many bytes may be allocated
+// as an `InlineBuffer` instead of a `Buffer<T>`.
+constexpr size_t kMaxInlineBufferBytes = 64;
+
+// A ref-counted buffer for small tensors of simple types in host memory. The
+// buffer object and the data live in one heap allocation, with the data placed
+// at the next `Allocator::kAllocatorAlignment` boundary after the object, so
+// creating and destroying such a tensor costs a single malloc/free pair instead
+// of one for the `TensorBuffer` and one through the `Allocator`.
+class InlineBuffer : public TensorBuffer {
+ public:
+  // Returns a buffer for `size` bytes of uninitialized data, or nullptr if the
+  // allocation fails.
+  static InlineBuffer* Create(size_t size) {
+    void* mem = port::AlignedMalloc(DataOffset() + size,
+                                    Allocator::kAllocatorAlignment);
+    if (mem == nullptr) return nullptr;
+    return new (mem) InlineBuffer(static_cast<char*>(mem) + DataOffset(), size);
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+
+  bool GetAllocatedBytes(size_t* out_bytes) const override { return false; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size());
+    proto->set_allocator_name("InlineTensorBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+    if (RefCountIsOne()) {
+      proto->set_has_single_reference(true);
+    }
+  }
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return AllocatorMemoryType::kHostPageable;
+  }
+
+  // Override `operator delete` so that calling `delete this` in
+  // `core::RefCounted::Unref()` releases the allocation made in `Create()`.
+  static void operator delete(void* ptr) { port::AlignedFree(ptr); }
+
+  static void operator delete(void*, void*) {
+    // Called if placement `new` throws an exception; `Create()` owns `mem`.
+  }
+
+ private:
+  InlineBuffer(void* data, size_t size) : TensorBuffer(data), size_(size) {}
+  ~InlineBuffer() override = default;
+
+  static size_t DataOffset() {
+    return (sizeof(InlineBuffer) + Allocator::kAllocatorAlignment - 1) /
+           Allocator::kAllocatorAlignment * Allocator::kAllocatorAlignment;
+  }
+
+  const size_t size_;
+
+  InlineBuffer(const InlineBuffer&) = delete;
+  void operator=(const InlineBuffer&) = delete;
+};
+
 void LogUnexpectedSize(int64_t actual, int64_t expected) {
   LOG(ERROR) << "Input size was " << actual << " and expected " << expected;
 }
@@ -964,12 +1025,46 @@ int Tensor::RefCount() const {
   CASES_WITH_DEFAULT(TYPE_ENUM, STMTS, LOG(FATAL) << "Type not set"; \
                      , LOG(FATAL) << "Unexpected type: " << TYPE_ENUM;)
 
+// NOTE(mrry): The default allocator for a Tensor (when none is specified) is
+// the default CPU allocator for NUMA zone 0. Accessing that currently involves
+// acquiring a lock, which guards initialization of the per-NUMA zone
+// allocators, and becomes highly contended.
+//
+// Note also that it would be better if all Tensor allocations required the user
+// to specify an allocator, for purposes of accounting, etc. However, the
+// default allocator is widely used throughout the codebase and in client code.
+static Allocator* get_default_cpu_allocator() {
+  static Allocator* default_cpu_allocator =
+      cpu_allocator(tsl::port::kNUMANoAffinity);
+  return default_cpu_allocator;
+}
+
+// Returns an `InlineBuffer` for `num_elements` elements of `type` if a tensor
+// of that size may skip the allocator `a`, or nullptr otherwise. This is only
+// done for the default CPU allocator, and not while its allocations are being
+// tracked or logged, so that the bypass cannot be observed through allocator
+// statistics.
+static TensorBuffer* MaybeCreateInlineBuffer(Allocator* a, DataType type,
+                                             int64_t num_elements) {
+  if (a != get_default_cpu_allocator() || !DataTypeCanUseMemcpy(type) ||
+      num_elements <= 0 || a->TracksAllocationSizes() ||
+      MemoryLoggingEnabled()) {
+    return nullptr;
+  }
+  const size_t bytes = num_elements * DataTypeSize(type);
+  if (bytes == 0 || bytes > kMaxInlineBufferBytes) return nullptr;
+  return InlineBuffer::Create(bytes);
+}
+
 Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape)
     : shape_(shape), buf_(nullptr) {
   set_dtype(type);
   CHECK_NOTNULL(a);
   if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
-    CASES(type, buf_ = new Buffer<T>(a, shape.num_elements()));
+    buf_ = MaybeCreateInlineBuffer(a, type, shape.num_elements());
+    if (buf_ == nullptr) {
+      CASES(type, buf_ = new Buffer<T>(a, shape.num_elements()));
+    }
   }
   if (MemoryLoggingEnabled() && buf_ != nullptr && buf_->data() != nullptr) {
     LogMemory::RecordTensorAllocation("Unknown", LogMemory::UNKNOWN_STEP_ID,
@@ -983,7 +1078,13 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape,
   set_dtype(type);
   CHECK_NOTNULL(a);
   if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
-    CASES(type, buf_ = new Buffer<T>(a, shape.num_elements(), allocation_attr));
+    if (allocation_attr.freed_by_func == nullptr) {
+      buf_ = MaybeCreateInlineBuffer(a, type, shape.num_elements());
+    }
+    if (buf_ == nullptr) {
+      CASES(type,
+            buf_ = new Buffer<T>(a, shape.num_elements(), allocation_attr));
+    }
   }
   if (MemoryLoggingEnabled() && !allocation_attr.allocation_will_be_logged &&
       buf_ != nullptr && buf_->data() != nullptr) {
@@ -1002,20 +1103,6 @@ Status Tensor::BuildTensor(DataType type, const TensorShape& shape,
   return OkStatus();
 }
 
-// NOTE(mrry): The default allocator for a Tensor (when none is specified) is
-// the default CPU allocator for NUMA zone 0. Accessing that currently involves
-// acquiring a lock, which guards initialization of the per-NUMA zone
-// allocators, and becomes highly contended.
-//
-// Note also that it would be better if all Tensor allocations required the user
-// to specify an allocator, for purposes of accounting, etc. However, the
-// default allocator is widely used throughout the codebase and in client code.
-static Allocator* get_default_cpu_allocator() {
-  static Allocator* default_cpu_allocator =
-      cpu_allocator(tsl::port::kNUMANoAffinity);
-  return default_cpu_allocator;
-}
-
 Tensor::Tensor(DataType type, const TensorShape& shape)
     : Tensor(get_default_cpu_allocator(), type, shape) {}
 
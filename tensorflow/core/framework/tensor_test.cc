@@ -1082,6 +1082,40 @@ TEST(Tensor_HostScalar, Basics) {
   }
 }
 
+TEST(Tensor_SmallInline, Basics) {
+  Tensor t(DT_INT64, TensorShape({2, 4}));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(t.tensor_data().data()) %
+                   Allocator::kAllocatorAlignment);
+  t.flat<int64_t>().setConstant(7);
+  Tensor copy = t;
+  EXPECT_TRUE(copy.SharesBufferWith(t));
+  copy.matrix<int64_t>()(1, 3) = 42;
+  EXPECT_EQ(42, t.matrix<int64_t>()(1, 3));
+  EXPECT_EQ(7, t.matrix<int64_t>()(0, 0));
+  Tensor slice = t.Slice(1, 2);
+  EXPECT_EQ(42, slice.matrix<int64_t>()(0, 3));
+
+  if (cpu_allocator()->TracksAllocationSizes()) return;
+  TensorDescription small;
+  t.FillDescription(&small);
+  EXPECT_EQ("InlineTensorBuffer",
+            small.allocation_description().allocator_name());
+  EXPECT_EQ(64, small.allocation_description().requested_bytes());
+
+  // Larger tensors, and tensors of non-simple types, still go through the
+  // allocator.
+  Tensor large(DT_INT64, TensorShape({2, 5}));
+  TensorDescription large_description;
+  large.FillDescription(&large_description);
+  EXPECT_EQ(cpu_allocator()->Name(),
+            large_description.allocation_description().allocator_name());
+  Tensor strings(DT_STRING, TensorShape({2}));
+  TensorDescription strings_description;
+  strings.FillDescription(&strings_description);
+  EXPECT_EQ(cpu_allocator()->Name(),
+            strings_description.allocation_description().allocator_name());
+}
+
 TEST(Tensor_Float, Reshape_And_Slice_Assignment) {
   // A test to experiment with a way to assign to a subset of a tensor
   Tensor t(DT_FLOAT, TensorShape({10, 4, 3, 2}));
@@ -1955,6 +1989,17 @@ void BM_CreateAndDestroyHostScalarOptimized(
 }
 BENCHMARK(BM_CreateAndDestroyHostScalarOptimized);
 
+// Benchmark creating and destroying a small tensor of `state.range(0)` int32
+// elements. Tensors of up to 16 elements use a single inline allocation.
+void BM_CreateAndDestroySmall(::testing::benchmark::State& state) {
+  TensorShape shape({state.range(0)});
+  for (auto s : state) {
+    Tensor a(DT_INT32, shape);
+    a.flat<int32>()(0) = 37;
+  }
+}
+BENCHMARK(BM_CreateAndDestroySmall)->Arg(1)->Arg(4)->Arg(16)->Arg(17);
+
 void BM_FromProto(::testing::benchmark::State& state) {
   const int size = state.range(0);
 
@@ -994,6 +994,7 @@ Status Partition(const PartitionOptions& opts, Graph* g,
   string dstp;
   std::vector<const Edge*> inputs;
   DupRecvTable dup_recv(3);
+  int64_t next_rendezvous_slot = 0;
   // For a node dst, 'ref_recvs' remembers the recvs introduced by a ref
   // edge to dst. 'ref_control_inputs' remembers the inputs by a non-ref
   // edge to dst. We will add a control edge for every pair in
@@ -1159,6 +1160,14 @@ Status Partition(const PartitionOptions& opts, Graph* g,
                               tensor_name_attr, &status);
       if (!status.ok()) return status;
 
+      if (opts.assign_rendezvous_slots &&
+          DeviceNameUtils::IsSameAddressSpace(src->assigned_device_name(),
+                                              dst->assigned_device_name())) {
+        const int64_t slot = next_rendezvous_slot++;
+        AddNodeAttr("_rendezvous_slot", slot, send);
+        AddNodeAttr("_rendezvous_slot", slot, real_recv);
+      }
+
       // Fix up the control flow edge.
       // NOTE(yuanbyu): 'real_recv' must be the real recv node.
       if (src_graph == dst_graph) {
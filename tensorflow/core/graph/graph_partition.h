@@ -80,6 +80,13 @@ struct PartitionOptions {
   // Optional customized function to compute the "tensor_name" attr value of
   // Send/Recv ops inserted during partitioning.
   std::function<string(const Edge*)> get_tensor_name_attr = nullptr;
+
+  // If true, every Send/Recv pair whose devices share an address space is
+  // given a unique "_rendezvous_slot" attr, which lets a local rendezvous
+  // match the pair through a preallocated slot instead of a keyed table.
+  // Only valid when each partition runs against its own per-step rendezvous
+  // and the slots of all partitions come from a single Partition() call.
+  bool assign_rendezvous_slots = false;
 };
 
 // Partition "input" graph into a set of graphs, one per location.
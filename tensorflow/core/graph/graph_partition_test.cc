@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/graph/graph_partition.h"
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -83,7 +85,8 @@ string DeviceName(const Node* node) {
 }
 
 void Partition(const GraphDef& graph_def,
-               std::unordered_map<string, GraphDef>* partitions) {
+               std::unordered_map<string, GraphDef>* partitions,
+               bool assign_rendezvous_slots = false) {
   Graph g(OpRegistry::Global());
   GraphConstructorOptions opts;
   TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &g));
@@ -103,6 +106,7 @@ void Partition(const GraphDef& graph_def,
   popts.get_incarnation = [](const string& name) {
     return (name[0] - 'A') + 100;
   };
+  popts.assign_rendezvous_slots = assign_rendezvous_slots;
   Status s = Partition(popts, &g, partitions);
   CHECK(s.ok()) << s;
 
@@ -563,6 +567,50 @@ TEST_F(GraphPartitionTest, SetIncarnation) {
   }
 }
 
+TEST_F(GraphPartitionTest, AssignRendezvousSlots) {
+  auto a1 = FloatInput(in_.WithOpName("A1"));
+  auto a2 = FloatInput(in_.WithOpName("A2"));
+  auto b1 = FloatInput(in_.WithOpName("B1"));
+  Combine(in_.WithOpName("B2"), a1, b1);
+  Combine(in_.WithOpName("B3"), a2, a1);
+
+  Partition(ToGraphDef(), &partitions_, /*assign_rendezvous_slots=*/true);
+  EXPECT_EQ(2, partitions_.size());
+
+  // Every pair gets its own slot, shared by its Send and its Recv. The second
+  // use of A1 reuses the existing pair.
+  std::map<string, int64_t> send_slots;
+  std::map<string, int64_t> recv_slots;
+  for (const auto& kv : partitions_) {
+    for (const NodeDef& ndef : kv.second.node()) {
+      if (ndef.op() != "_Send" && ndef.op() != "_Recv") continue;
+      string tensor_name;
+      TF_ASSERT_OK(GetNodeAttr(ndef, "tensor_name", &tensor_name));
+      int64_t slot;
+      TF_ASSERT_OK(GetNodeAttr(ndef, "_rendezvous_slot", &slot));
+      (ndef.op() == "_Send" ? send_slots : recv_slots)[tensor_name] = slot;
+    }
+  }
+  EXPECT_EQ(send_slots.size(), 2);
+  EXPECT_EQ(send_slots, recv_slots);
+  std::set<int64_t> unique_slots;
+  for (const auto& kv : send_slots) unique_slots.insert(kv.second);
+  EXPECT_EQ(unique_slots, (std::set<int64_t>{0, 1}));
+}
+
+TEST_F(GraphPartitionTest, NoRendezvousSlotsByDefault) {
+  auto a1 = FloatInput(in_.WithOpName("A1"));
+  auto b1 = FloatInput(in_.WithOpName("B1"));
+  Combine(in_.WithOpName("B2"), a1, b1);
+
+  Partition(ToGraphDef(), &partitions_);
+  for (const auto& kv : partitions_) {
+    for (const NodeDef& ndef : kv.second.node()) {
+      EXPECT_EQ(ndef.attr().count("_rendezvous_slot"), 0) << ndef.name();
+    }
+  }
+}
+
 TEST_F(GraphPartitionTest, GraphDebugInfo) {
   GraphDef graph_def;
   Output a1 = FloatInput(in_.WithOpName("A1"));
@@ -31,8 +31,11 @@ limitations under the License.
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
@@ -942,6 +945,33 @@ BENCHMARK(BM_GraphCreation)->ArgPair(1 << 9, 16);
 BENCHMARK(BM_GraphCreation)->ArgPair(1 << 12, 16);
 BENCHMARK(BM_GraphCreation)->ArgPair(1 << 15, 16);
 
+void BM_GraphCreationWithThreadPool(::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  const int num_edges_per_node = state.range(1);
+  const GraphDef graph_def =
+      test::CreateGraphDef(num_nodes, num_edges_per_node);
+  const auto registry = OpRegistry::Global();
+  thread::ThreadPool pool(Env::Default(), "graph_creation",
+                          port::MaxParallelism());
+  // Same options as BM_GraphCreation apart from the pool, for comparison.
+  GraphConstructorOptions opts;
+  opts.thread_pool = &pool;
+  // Warmup step.
+  Graph graph(registry);
+  TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph));
+  int64_t sum = 0;
+  for (auto s : state) {
+    Graph graph(registry);
+    TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph));
+    sum += graph.num_node_ids();
+  }
+  VLOG(1) << sum;
+}
+BENCHMARK(BM_GraphCreationWithThreadPool)->ArgPair(1 << 12, 2);
+BENCHMARK(BM_GraphCreationWithThreadPool)->ArgPair(1 << 15, 2);
+BENCHMARK(BM_GraphCreationWithThreadPool)->ArgPair(1 << 18, 2);
+BENCHMARK(BM_GraphCreationWithThreadPool)->ArgPair(1 << 20, 2);
+
 void BM_ToGraphDef(::testing::benchmark::State& state) {
   const int num_nodes = state.range(0);
   const int num_edges_per_node = state.range(1);
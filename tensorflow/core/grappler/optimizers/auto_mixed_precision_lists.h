@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <string>
 
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision_profile.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/util/env_var.h"
@@ -51,7 +52,9 @@ class AutoMixedPrecisionLists {
   virtual gtl::FlatSet<string> ClearList() = 0;
 
  protected:
-  // Adds or removes ops from list if certain environmental variables are set.
+  // Adds or removes ops from list according to the profile named by
+  // TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_PROFILE, then according to certain
+  // other environmental variables if they are set.
   static void UpdateList(const string& list_name, gtl::FlatSet<string>* list) {
     CHECK(list_name == "ALLOWLIST" || list_name == "INFERLIST" ||  // Crash OK.
           list_name == "DENYLIST" || list_name == "CLEARLIST" ||
@@ -62,6 +65,16 @@ class AutoMixedPrecisionLists {
         "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_" + list_name + "_ADD";
     string remove_env_var =
         "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_" + list_name + "_REMOVE";
+    for (const auto& x : str_util::Split(
+             GetAutoMixedPrecisionProfileOverride(list_name + "_ADD"), ",",
+             str_util::SkipEmpty())) {
+      list->insert(x);
+    }
+    for (const auto& x : str_util::Split(
+             GetAutoMixedPrecisionProfileOverride(list_name + "_REMOVE"), ",",
+             str_util::SkipEmpty())) {
+      list->erase(x);
+    }
     string to_add, to_remove;
     TF_CHECK_OK(ReadStringFromEnvVar(add_env_var, "", &to_add));
     TF_CHECK_OK(ReadStringFromEnvVar(remove_env_var, "", &to_remove));
@@ -0,0 +1,162 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision_profile.h"
+
+#include <set>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision_lists.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace grappler {
+
+void AutoMixedPrecisionProfile::RecordStepStats(const GraphDef& graph,
+                                                const StepStats& step_stats,
+                                                bool f16) {
+  absl::flat_hash_map<absl::string_view, absl::string_view> node_to_op;
+  node_to_op.reserve(graph.node_size());
+  for (const NodeDef& node : graph.node()) {
+    node_to_op[node.name()] = node.op();
+  }
+  for (const DeviceStepStats& device_stats : step_stats.dev_stats()) {
+    for (const NodeExecStats& node_stats : device_stats.node_stats()) {
+      auto it = node_to_op.find(node_stats.node_name());
+      if (it == node_to_op.end()) continue;
+      RecordOpTime(string(it->second), f16,
+                   node_stats.op_end_rel_micros() -
+                       node_stats.op_start_rel_micros());
+    }
+  }
+}
+
+void AutoMixedPrecisionProfile::RecordOpTime(const string& op_type, bool f16,
+                                             int64_t micros) {
+  OpTimes& times = op_times_[op_type];
+  (f16 ? times.f16_micros : times.fp32_micros) += micros;
+}
+
+void AutoMixedPrecisionProfile::RecordNonFinite(const string& op_type) {
+  non_finite_ops_.insert(op_type);
+}
+
+AutoMixedPrecisionListOverrides AutoMixedPrecisionProfile::ComputeOverrides(
+    AutoMixedPrecisionLists* lists, double min_speedup) const {
+  const gtl::FlatSet<string> allow_list = lists->AllowList();
+  const gtl::FlatSet<string> infer_list = lists->InferList();
+  const gtl::FlatSet<string> deny_list = lists->DenyList();
+  const gtl::FlatSet<string> clear_list = lists->ClearList();
+
+  // Sorted so that the written profile is deterministic.
+  std::map<string, std::set<string>> changes;
+  for (const string& op : non_finite_ops_) {
+    if (allow_list.count(op)) {
+      changes["ALLOWLIST_REMOVE"].insert(op);
+    } else if (infer_list.count(op)) {
+      changes["INFERLIST_REMOVE"].insert(op);
+    } else if (clear_list.count(op)) {
+      changes["CLEARLIST_REMOVE"].insert(op);
+    } else {
+      continue;
+    }
+    changes["DENYLIST_ADD"].insert(op);
+  }
+  for (const auto& [op, times] : op_times_) {
+    if (non_finite_ops_.count(op) || times.fp32_micros <= 0 ||
+        times.f16_micros <= 0) {
+      continue;
+    }
+    const bool is_faster =
+        times.fp32_micros >= min_speedup * times.f16_micros;
+    if (allow_list.count(op) && !is_faster) {
+      changes["ALLOWLIST_REMOVE"].insert(op);
+      changes["INFERLIST_ADD"].insert(op);
+    } else if (deny_list.count(op)) {
+      changes["DENYLIST_REMOVE"].insert(op);
+      changes["INFERLIST_ADD"].insert(op);
+    }
+  }
+
+  AutoMixedPrecisionListOverrides overrides;
+  for (const auto& [key, ops] : changes) {
+    overrides[key] = absl::StrJoin(ops, ",");
+  }
+  return overrides;
+}
+
+Status AutoMixedPrecisionProfile::WriteToFile(const string& path,
+                                              AutoMixedPrecisionLists* lists,
+                                              double min_speedup) const {
+  string contents;
+  for (const auto& [key, ops] : ComputeOverrides(lists, min_speedup)) {
+    absl::StrAppend(&contents, key, "=", ops, "\n");
+  }
+  return WriteStringToFile(Env::Default(), path, contents);
+}
+
+Status ReadAutoMixedPrecisionListOverrides(
+    const string& path, AutoMixedPrecisionListOverrides* overrides) {
+  string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(Env::Default(), path, &contents));
+  overrides->clear();
+  for (absl::string_view line :
+       absl::StrSplit(contents, '\n', absl::SkipWhitespace())) {
+    std::pair<absl::string_view, absl::string_view> key_and_ops =
+        absl::StrSplit(line, absl::MaxSplits('=', 1));
+    if (key_and_ops.first.empty() || line.find('=') == line.npos) {
+      return errors::InvalidArgument("Malformed line in auto mixed precision ",
+                                     "profile ", path, ": ", line);
+    }
+    (*overrides)[string(key_and_ops.first)] = string(key_and_ops.second);
+  }
+  return OkStatus();
+}
+
+string GetAutoMixedPrecisionProfileOverride(const string& key) {
+  string path;
+  TF_CHECK_OK(ReadStringFromEnvVar(
+      "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_PROFILE", "", &path));
+  if (path.empty()) return "";
+
+  static mutex mu(LINKER_INITIALIZED);
+  static auto* profiles =
+      new absl::flat_hash_map<string, AutoMixedPrecisionListOverrides>();
+  mutex_lock l(mu);
+  auto it = profiles->find(path);
+  if (it == profiles->end()) {
+    AutoMixedPrecisionListOverrides overrides;
+    Status status = ReadAutoMixedPrecisionListOverrides(path, &overrides);
+    if (!status.ok()) {
+      LOG(ERROR) << "Ignoring auto mixed precision profile: " << status;
+      overrides.clear();
+    }
+    it = profiles->emplace(path, std::move(overrides)).first;
+  }
+  auto override_it = it->second.find(key);
+  return override_it == it->second.end() ? "" : override_it->second;
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,101 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_MIXED_PRECISION_PROFILE_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_MIXED_PRECISION_PROFILE_H_
+
+#include <map>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/gtl/flatset.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+class AutoMixedPrecisionLists;
+
+// Model-specific adjustments to the auto mixed precision op lists, keyed like
+// the TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_<key> environment variables (e.g.
+// "ALLOWLIST_REMOVE") and holding a comma-separated list of op types.
+using AutoMixedPrecisionListOverrides = std::map<string, string>;
+
+// Collects per-op-type measurements from calibration steps of a model run once
+// in fp32 and once with auto mixed precision, and derives model-specific list
+// overrides from them:
+//  * Ops that produced non-finite values in f16 are moved to the deny list.
+//  * Allow list ops that don't run at least `min_speedup` times faster in f16
+//    are moved to the infer list, so they only run in f16 when their inputs
+//    already are.
+//  * Deny list ops that were measured in f16 (e.g. by running the f16
+//    calibration with TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_DENYLIST_REMOVE)
+//    without producing non-finite values are moved to the infer list.
+//
+// The overrides are written to a file which the optimizer reads when the
+// TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_PROFILE environment variable points to
+// it. The environment variable overrides are applied after the file.
+//
+// Not thread-safe.
+class AutoMixedPrecisionProfile {
+ public:
+  // Adds the compute time of every node in `step_stats` to the total of its op
+  // type in `graph`. `f16` tells whether the step ran with mixed precision.
+  // Nodes not in `graph` (e.g. inserted casts) are ignored.
+  void RecordStepStats(const GraphDef& graph, const StepStats& step_stats,
+                       bool f16);
+
+  // Adds `micros` of compute time for `op_type`.
+  void RecordOpTime(const string& op_type, bool f16, int64_t micros);
+
+  // Records that an op of type `op_type` produced non-finite values while
+  // running in f16, e.g. as reported by CheckNumerics during calibration.
+  void RecordNonFinite(const string& op_type);
+
+  // Returns the overrides for `lists` derived from the recorded measurements.
+  AutoMixedPrecisionListOverrides ComputeOverrides(
+      AutoMixedPrecisionLists* lists, double min_speedup = 1.1) const;
+
+  // Writes the overrides computed for `lists` to `path`, one "KEY=Op1,Op2"
+  // line per non-empty key.
+  Status WriteToFile(const string& path, AutoMixedPrecisionLists* lists,
+                     double min_speedup = 1.1) const;
+
+ private:
+  struct OpTimes {
+    int64_t fp32_micros = 0;
+    int64_t f16_micros = 0;
+  };
+
+  absl::flat_hash_map<string, OpTimes> op_times_;
+  gtl::FlatSet<string> non_finite_ops_;
+};
+
+// Parses a file written by AutoMixedPrecisionProfile::WriteToFile.
+Status ReadAutoMixedPrecisionListOverrides(
+    const string& path, AutoMixedPrecisionListOverrides* overrides);
+
+// Returns the comma-separated ops stored under `key` (e.g. "ALLOWLIST_ADD") in
+// the file named by TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_PROFILE, or an empty
+// string if the variable is unset. The file is parsed once per path.
+string GetAutoMixedPrecisionProfileOverride(const string& key);
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_MIXED_PRECISION_PROFILE_H_
@@ -0,0 +1,117 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision_profile.h"
+
+#include <string>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision_lists.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+TEST(AutoMixedPrecisionProfileTest, ComputeOverrides) {
+  AutoMixedPrecisionListsCuda lists(/*cuda_version=*/10000,
+                                    /*cudnn_version=*/8000);
+  AutoMixedPrecisionProfile profile;
+  // MatMul is faster in f16, Conv2D is not.
+  profile.RecordOpTime("MatMul", /*f16=*/false, 100);
+  profile.RecordOpTime("MatMul", /*f16=*/true, 40);
+  profile.RecordOpTime("Conv2D", /*f16=*/false, 100);
+  profile.RecordOpTime("Conv2D", /*f16=*/true, 95);
+  // Exp is safe in f16, Relu overflows.
+  profile.RecordOpTime("Exp", /*f16=*/false, 10);
+  profile.RecordOpTime("Exp", /*f16=*/true, 10);
+  profile.RecordOpTime("Relu", /*f16=*/false, 10);
+  profile.RecordOpTime("Relu", /*f16=*/true, 5);
+  profile.RecordNonFinite("Relu");
+
+  AutoMixedPrecisionListOverrides overrides = profile.ComputeOverrides(&lists);
+  EXPECT_EQ(overrides["ALLOWLIST_REMOVE"], "Conv2D");
+  EXPECT_EQ(overrides["INFERLIST_ADD"], "Conv2D,Exp");
+  EXPECT_EQ(overrides["DENYLIST_REMOVE"], "Exp");
+  EXPECT_EQ(overrides["CLEARLIST_REMOVE"], "Relu");
+  EXPECT_EQ(overrides["DENYLIST_ADD"], "Relu");
+  EXPECT_EQ(overrides.size(), 5);
+}
+
+TEST(AutoMixedPrecisionProfileTest, RecordStepStats) {
+  GraphDef graph;
+  NodeDef* node = graph.add_node();
+  node->set_name("matmul");
+  node->set_op("MatMul");
+
+  StepStats step_stats;
+  NodeExecStats* node_stats = step_stats.add_dev_stats()->add_node_stats();
+  node_stats->set_node_name("matmul");
+  node_stats->set_op_start_rel_micros(10);
+  node_stats->set_op_end_rel_micros(110);
+  NodeExecStats* cast_stats = step_stats.mutable_dev_stats(0)->add_node_stats();
+  cast_stats->set_node_name("matmul-0-CastToFp16-AutoMixedPrecision");
+  cast_stats->set_op_end_rel_micros(1000);
+
+  AutoMixedPrecisionProfile profile;
+  profile.RecordStepStats(graph, step_stats, /*f16=*/false);
+  node_stats->set_op_start_rel_micros(105);
+  profile.RecordStepStats(graph, step_stats, /*f16=*/true);
+
+  AutoMixedPrecisionListsCuda lists(/*cuda_version=*/10000,
+                                    /*cudnn_version=*/8000);
+  AutoMixedPrecisionListOverrides overrides = profile.ComputeOverrides(&lists);
+  EXPECT_TRUE(overrides.empty());
+}
+
+TEST(AutoMixedPrecisionProfileTest, WriteReadAndApply) {
+  AutoMixedPrecisionListsCuda lists(/*cuda_version=*/10000,
+                                    /*cudnn_version=*/8000);
+  AutoMixedPrecisionProfile profile;
+  profile.RecordOpTime("Conv2D", /*f16=*/false, 100);
+  profile.RecordOpTime("Conv2D", /*f16=*/true, 100);
+
+  string path;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&path));
+  TF_ASSERT_OK(profile.WriteToFile(path, &lists));
+
+  AutoMixedPrecisionListOverrides overrides;
+  TF_ASSERT_OK(ReadAutoMixedPrecisionListOverrides(path, &overrides));
+  EXPECT_EQ(overrides, profile.ComputeOverrides(&lists));
+
+  ASSERT_EQ(setenv("TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_PROFILE",
+                   path.c_str(), 1),
+            0);
+  EXPECT_FALSE(lists.AllowList().count("Conv2D"));
+  EXPECT_TRUE(lists.InferList().count("Conv2D"));
+  EXPECT_TRUE(lists.AllowList().count("MatMul"));
+  ASSERT_EQ(unsetenv("TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_PROFILE"), 0);
+  EXPECT_TRUE(lists.AllowList().count("Conv2D"));
+}
+
+TEST(AutoMixedPrecisionProfileTest, ReadMalformed) {
+  string path;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&path));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, "ALLOWLIST_ADD\n"));
+  AutoMixedPrecisionListOverrides overrides;
+  EXPECT_FALSE(ReadAutoMixedPrecisionListOverrides(path, &overrides).ok());
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
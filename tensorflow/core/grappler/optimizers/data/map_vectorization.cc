@@ -0,0 +1,264 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kMapDataset[] = "MapDataset";
+constexpr char kParallelMapDataset[] = "ParallelMapDataset";
+constexpr char kParallelMapDatasetV2[] = "ParallelMapDatasetV2";
+constexpr char kBatchDatasetV2[] = "BatchDatasetV2";
+constexpr char kParallelBatchDataset[] = "ParallelBatchDataset";
+constexpr char kOutputShapes[] = "output_shapes";
+constexpr char kOutputTypes[] = "output_types";
+
+bool IsMapNode(const NodeDef& node) {
+  return node.op() == kMapDataset || node.op() == kParallelMapDataset ||
+         node.op() == kParallelMapDatasetV2;
+}
+
+bool IsBatchNode(const NodeDef& node) {
+  return node.op() == kBatchDatasetV2 || node.op() == kParallelBatchDataset;
+}
+
+// Returns true if `op` computes each element of its output from the
+// corresponding elements of its inputs, broadcasting scalars. Applying such an
+// op to a batch is equivalent to applying it to each element of the batch.
+bool IsElementwiseOp(const string& op) {
+  static const auto* const kElementwiseOps = new absl::flat_hash_set<string>{
+      "Abs", "Add", "AddV2", "Cast", "Ceil", "Cos", "Div",
+      "DivNoNan", "Equal", "Erf", "Exp", "Expm1", "Floor", "FloorDiv",
+      "FloorMod", "Greater", "GreaterEqual", "Identity", "IsFinite", "IsInf",
+      "IsNan", "Less", "LessEqual", "Log", "Log1p", "LogicalAnd", "LogicalNot",
+      "LogicalOr", "Maximum", "Minimum", "Mod", "Mul", "MulNoNan", "Neg",
+      "NotEqual", "Pow", "RealDiv", "Reciprocal", "Relu", "Relu6", "Round",
+      "Rsqrt", "Sigmoid", "Sign", "Sin", "Softplus", "Sqrt", "Square",
+      "SquaredDifference", "Sub", "Tanh", "TruncateDiv", "TruncateMod"};
+  return kElementwiseOps->contains(op);
+}
+
+bool IsScalarConst(const NodeDef& node) {
+  if (node.op() != "Const") return false;
+  const AttrValue* value = gtl::FindOrNull(node.attr(), "value");
+  return value != nullptr && value->has_tensor() &&
+         !value->tensor().tensor_shape().unknown_rank() &&
+         value->tensor().tensor_shape().dim_size() == 0;
+}
+
+// Returns the name of the function argument or node that produces `input`,
+// which is formatted as `arg`, `node:output:index`, or `^node`.
+absl::string_view InputSource(absl::string_view input) {
+  return input.substr(0, input.find(':'));
+}
+
+// Returns true if applying `function` to a batch of elements produces the
+// batch of the results of applying it to each element. This is the case when
+// the function only uses element-wise operations, the only constants it uses
+// are scalars, and all of its outputs depend on its arguments.
+bool IsVectorizable(const FunctionDef& function) {
+  const OpDef& signature = function.signature();
+  if (signature.is_stateful() || !function.control_ret().empty()) {
+    return false;
+  }
+  absl::flat_hash_set<string> depends_on_args;
+  for (const auto& arg : signature.input_arg()) {
+    if (!arg.number_attr().empty() || !arg.type_list_attr().empty()) {
+      return false;
+    }
+    depends_on_args.insert(arg.name());
+  }
+  for (const auto& node : function.node_def()) {
+    if (!IsElementwiseOp(node.op()) && !IsScalarConst(node)) {
+      return false;
+    }
+    for (const auto& input : node.input()) {
+      if (IsControlInput(input)) return false;
+    }
+  }
+  // Nodes of a function body are not necessarily topologically sorted, so we
+  // propagate the dependency on the arguments until it no longer changes.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto& node : function.node_def()) {
+      if (depends_on_args.contains(node.name())) continue;
+      for (const auto& input : node.input()) {
+        if (depends_on_args.contains(InputSource(input))) {
+          depends_on_args.insert(node.name());
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  // A function output that does not depend on the arguments would not have a
+  // batch dimension.
+  for (const auto& [unused, output] : function.ret()) {
+    if (!depends_on_args.contains(InputSource(output))) return false;
+  }
+  return !function.ret().empty();
+}
+
+// Returns true if all the components of the elements produced by `node` have a
+// known and identical rank. Element-wise binary operations broadcast operands
+// of the same rank identically with or without a leading batch dimension.
+bool HasUniformRank(const NodeDef& node) {
+  const AttrValue* shapes = gtl::FindOrNull(node.attr(), kOutputShapes);
+  if (shapes == nullptr || shapes->list().shape_size() == 0) return false;
+  const int rank = shapes->list().shape(0).dim_size();
+  for (const auto& shape : shapes->list().shape()) {
+    if (shape.unknown_rank() || shape.dim_size() != rank) return false;
+  }
+  return true;
+}
+
+// Returns the size of the leading dimension of the elements produced by
+// `batch_node`, or `std::nullopt` if it is not known.
+std::optional<int64_t> GetBatchDimension(const NodeDef& batch_node) {
+  const AttrValue* shapes = gtl::FindOrNull(batch_node.attr(), kOutputShapes);
+  if (shapes == nullptr || shapes->list().shape_size() == 0) {
+    return std::nullopt;
+  }
+  const TensorShapeProto& shape = shapes->list().shape(0);
+  if (shape.unknown_rank() || shape.dim_size() == 0) return std::nullopt;
+  return shape.dim(0).size();
+}
+
+bool CanVectorize(const NodeDef& map_node, const NodeDef& input_node,
+                  const NodeDef& batch_node,
+                  const FunctionLibraryDefinition& function_library,
+                  const MutableGraphView& graph) {
+  // The map must only feed the batch, since moving it changes its output.
+  if (graph.GetFanouts(map_node, /*include_controlled_nodes=*/true).size() !=
+      1) {
+    return false;
+  }
+  const AttrValue* other_arguments =
+      gtl::FindOrNull(map_node.attr(), "Targuments");
+  if (other_arguments != nullptr && other_arguments->list().type_size() > 0) {
+    return false;
+  }
+  if (!HasUniformRank(input_node) || !GetBatchDimension(batch_node)) {
+    return false;
+  }
+  DataTypeVector input_types;
+  if (!graph_utils::GetDatasetOutputTypesAttr(input_node, &input_types).ok()) {
+    return false;
+  }
+  const FunctionDef* function =
+      function_library.Find(map_node.attr().at("f").func().name());
+  return function != nullptr &&
+         function->signature().input_arg_size() ==
+             static_cast<int>(input_types.size()) &&
+         IsVectorizable(*function);
+}
+
+NodeDef MakeBatchNode(const NodeDef& batch_node, const NodeDef& input_node,
+                      MutableGraphView* graph) {
+  NodeDef new_batch = batch_node;
+  graph_utils::SetUniqueGraphNodeName(batch_node.op(), graph->graph(),
+                                      &new_batch);
+  new_batch.set_input(0, input_node.name());
+  graph_utils::CopyAttribute(kOutputTypes, input_node, &new_batch);
+  // The new batch produces batches of the elements of the map input.
+  const int64_t batch_dimension = *GetBatchDimension(batch_node);
+  auto* shapes = (*new_batch.mutable_attr())[kOutputShapes].mutable_list();
+  shapes->Clear();
+  for (const auto& shape : input_node.attr().at(kOutputShapes).list().shape()) {
+    TensorShapeProto* batched_shape = shapes->add_shape();
+    batched_shape->add_dim()->set_size(batch_dimension);
+    for (const auto& dim : shape.dim()) {
+      *batched_shape->add_dim() = dim;
+    }
+  }
+  return new_batch;
+}
+
+NodeDef MakeMapNode(const NodeDef& map_node, const NodeDef& batch_node,
+                    const NodeDef& new_batch_node, MutableGraphView* graph) {
+  NodeDef new_map = map_node;
+  graph_utils::SetUniqueGraphNodeName(map_node.op(), graph->graph(), &new_map);
+  new_map.set_input(0, new_batch_node.name());
+  // The new map produces the elements that the batch used to produce.
+  graph_utils::CopyShapesAndTypesAttrs(batch_node, &new_map);
+  return new_map;
+}
+
+}  // namespace
+
+Status MapVectorization::OptimizeAndCollectStats(Cluster* cluster,
+                                                 const GrapplerItem& item,
+                                                 GraphDef* output,
+                                                 OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  absl::flat_hash_set<string> nodes_to_delete;
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+
+  for (const NodeDef& node : item.graph.node()) {
+    if (!IsBatchNode(node)) continue;
+
+    // The inputs of the nodes could have been changed by earlier rewrites, so
+    // we look them up in the modified graph.
+    const NodeDef* batch_node = graph.GetNode(node.name());
+    NodeDef* map_node = graph_utils::GetInputNode(*batch_node, graph);
+    if (map_node == nullptr || !IsMapNode(*map_node)) continue;
+    NodeDef* input_node = graph_utils::GetInputNode(*map_node, graph);
+    if (input_node == nullptr ||
+        !CanVectorize(*map_node, *input_node, *batch_node, function_library,
+                      graph)) {
+      continue;
+    }
+
+    auto* new_batch =
+        graph.AddNode(MakeBatchNode(*batch_node, *input_node, &graph));
+    auto* new_map =
+        graph.AddNode(MakeMapNode(*map_node, *batch_node, *new_batch, &graph));
+    TF_RETURN_IF_ERROR(graph.UpdateFanouts(batch_node->name(), new_map->name()));
+
+    nodes_to_delete.insert(map_node->name());
+    nodes_to_delete.insert(batch_node->name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(MapVectorization, "map_vectorization");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,166 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_test_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+NodeDef MakeRangeNode(StringPiece name, bool known_shapes = true) {
+  if (!known_shapes) {
+    return NDef(name, "RangeDataset", {"start", "stop", "step"},
+                {{"output_shapes", gtl::ArraySlice<PartialTensorShape>{
+                                       PartialTensorShape()}},
+                 {"output_types", gtl::ArraySlice<DataType>{DT_INT64}}});
+  }
+  return NDef(name, "RangeDataset", {"start", "stop", "step"},
+              {{"output_shapes", gtl::ArraySlice<TensorShape>{{}}},
+               {"output_types", gtl::ArraySlice<DataType>{DT_INT64}}});
+}
+
+NodeDef MakeBatchNode(StringPiece name, StringPiece op,
+                      StringPiece input_node_name) {
+  std::vector<string> inputs = {string(input_node_name), "batch_size"};
+  if (op == "ParallelBatchDataset") {
+    inputs.push_back("num_parallel_calls");
+  }
+  inputs.push_back("drop_remainder");
+  return NDef(name, op, inputs,
+              {{"output_shapes",
+                gtl::ArraySlice<PartialTensorShape>{PartialTensorShape({-1})}},
+               {"output_types", gtl::ArraySlice<DataType>{DT_INT64}}});
+}
+
+GrapplerItem MakeItem(const NodeDef& range_node, const NodeDef& map_node,
+                      const NodeDef& batch_node) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT64}}),
+       NDef("batch_size", "Const", {}, {{"value", 5}, {"dtype", DT_INT64}}),
+       NDef("num_parallel_calls", "Const", {},
+            {{"value", 2}, {"dtype", DT_INT64}}),
+       NDef("drop_remainder", "Const", {},
+            {{"value", false}, {"dtype", DT_BOOL}}),
+       range_node, map_node, batch_node, NDef("Sink", "Identity", {"batch"})},
+      // FunctionLib
+      {
+          test::function::XTimesTwo(),
+          test::function::XTimesFour(),
+      });
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+class MapVectorizationTest : public ::testing::TestWithParam<string> {};
+
+TEST_P(MapVectorizationTest, SwapsMapAndBatch) {
+  const string batch_op = GetParam();
+  GrapplerItem item =
+      MakeItem(MakeRangeNode("range"),
+               graph_tests_utils::MakeMapNode("map", "range", "XTimesTwo"),
+               MakeBatchNode("batch", batch_op, "map"));
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("batch", output));
+
+  const NodeDef& new_batch =
+      output.node(graph_utils::FindGraphNodeWithOp(batch_op, output));
+  const NodeDef& new_map =
+      output.node(graph_utils::FindGraphNodeWithOp("MapDataset", output));
+  EXPECT_EQ(new_batch.input(0), "range");
+  EXPECT_EQ(new_map.input(0), new_batch.name());
+  EXPECT_EQ(new_map.attr().at("f").func().name(), "XTimesTwo");
+
+  const NodeDef& sink =
+      output.node(graph_utils::FindGraphNodeWithName("Sink", output));
+  EXPECT_EQ(sink.input(0), new_map.name());
+
+  // The batch produces batches of the (scalar) range elements, and the map
+  // produces the batches that the original batch produced.
+  ASSERT_EQ(new_batch.attr().at("output_shapes").list().shape_size(), 1);
+  PartialTensorShape batch_shape(
+      new_batch.attr().at("output_shapes").list().shape(0));
+  EXPECT_TRUE(batch_shape.IsIdenticalTo(PartialTensorShape({-1})));
+  PartialTensorShape map_shape(
+      new_map.attr().at("output_shapes").list().shape(0));
+  EXPECT_TRUE(map_shape.IsIdenticalTo(PartialTensorShape({-1})));
+}
+
+INSTANTIATE_TEST_SUITE_P(Test, MapVectorizationTest,
+                         ::testing::Values("BatchDatasetV2",
+                                           "ParallelBatchDataset"));
+
+TEST(MapVectorization, FunctionWithNonElementwiseOps) {
+  // `XTimesFour` calls the `XTimesTwo` function.
+  GrapplerItem item =
+      MakeItem(MakeRangeNode("range"),
+               graph_tests_utils::MakeMapNode("map", "range", "XTimesFour"),
+               MakeBatchNode("batch", "BatchDatasetV2", "map"));
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+TEST(MapVectorization, UnknownElementRank) {
+  GrapplerItem item =
+      MakeItem(MakeRangeNode("range", /*known_shapes=*/false),
+               graph_tests_utils::MakeMapNode("map", "range", "XTimesTwo"),
+               MakeBatchNode("batch", "BatchDatasetV2", "map"));
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+TEST(MapVectorization, MapWithOtherConsumers) {
+  GrapplerItem item =
+      MakeItem(MakeRangeNode("range"),
+               graph_tests_utils::MakeMapNode("map", "range", "XTimesTwo"),
+               MakeBatchNode("batch", "BatchDatasetV2", "map"));
+  *item.graph.add_node() = NDef("other_sink", "Identity", {"map"});
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
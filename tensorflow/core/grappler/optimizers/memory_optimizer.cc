@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"  // NOLINT
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
@@ -440,6 +441,18 @@ void RecomputeSubgraph(
   }
 }
 
+// Returns whether "node" is one of the nodes whose inputs we may want to
+// recompute. This matches node names that contain
+// recomputation_targets_name_scope as a name scope, meaning it either begins
+// with or contains the name scope. Defaults to "gradients/" which will match
+// any node names that begins with "gradients/" or contains "/gradients/".
+bool IsRecomputationTarget(const NodeDef& node,
+                           const string& recomputation_targets_name_scope) {
+  return absl::StartsWith(node.name(), recomputation_targets_name_scope) ||
+         static_cast<int>(
+             node.name().find("/" + recomputation_targets_name_scope)) != -1;
+}
+
 void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                                 const string& recomputation_targets_name_scope,
                                 GraphDef* graph, const GrapplerItem& item) {
@@ -461,15 +474,7 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
   }
   std::function<bool(const NodeDef&)> is_target =
       [&recomputation_targets_name_scope](const NodeDef& node) {
-        // Nodes whose inputs we may want to recompute. This matches node names
-        // that contain recomputation_targets_name_scope as a name scope,
-        // meaning it either begins with or contains the name scope.
-        // Defaults to "gradients/" which will match any node names that begins
-        // with "gradients/" or contains "/gradients/".
-        return absl::StartsWith(node.name(),
-                                recomputation_targets_name_scope) ||
-               static_cast<int>(node.name().find(
-                   "/" + recomputation_targets_name_scope)) != -1;
+        return IsRecomputationTarget(node, recomputation_targets_name_scope);
       };
 
   if (optimization_level == RewriterConfig::RECOMPUTATION_HEURISTICS ||
@@ -1270,6 +1275,227 @@ bool SwappingPass(RewriterConfig::MemOptType optimization_level,
   return updated_graph;
 }
 
+// Runs "item" to collect its step stats: on "cluster" when it collects
+// detailed stats, so that they hold the memory each op actually allocated, and
+// on a VirtualCluster with the same devices otherwise.
+Status CollectStepStats(Cluster* cluster, const GrapplerItem& item,
+                        StepStats* step_stats) {
+  RunMetadata metadata;
+  if (cluster->DetailedStatsEnabled()) {
+    TF_RETURN_IF_ERROR(cluster->Initialize(item));
+    TF_RETURN_IF_ERROR(cluster->Run(item, &metadata));
+  } else {
+    VirtualCluster vcluster(cluster->GetDevices());
+    TF_RETURN_IF_ERROR(vcluster.Provision());
+    TF_RETURN_IF_ERROR(vcluster.Initialize(item));
+    // The virtual cluster returns RESOURCE_EXHAUSTED when the graph would run
+    // out of memory, but still fills in the step stats.
+    Status s = vcluster.Run(item, &metadata);
+    if (!s.ok() && s.code() != error::RESOURCE_EXHAUSTED) {
+      return s;
+    }
+  }
+  step_stats->Swap(metadata.mutable_step_stats());
+  return OkStatus();
+}
+
+// A way to free a tensor that is live at the peak memory usage of a device:
+// recompute it for its uses after the peak, or swap it out to the host and
+// back in for them.
+struct MemoryDecision {
+  NodeDef* node;
+  int64_t bytes;
+  Costs::Duration cost;
+  bool recompute;
+  std::vector<MutableGraphView::InputPort> uses_to_swap;
+};
+
+// Picks the recompute and swap decisions that bring the peak memory usage of
+// every device in "step_stats" under "budget", freeing the tensors that are
+// cheapest per byte first, and marks them in the graph with kRecomputeHint
+// and _swap_to_host so that the recomputation and swapping passes apply them.
+// Each freed tensor is assumed to come off the peak, which makes
+// *predicted_peak an estimate. Returns whether the graph changed.
+bool PlanPeakMemoryBudget(Cluster* cluster, int64_t budget,
+                          const string& recomputation_targets_name_scope,
+                          const StepStats& step_stats, GrapplerItem* item,
+                          int64_t* predicted_peak) {
+  GraphMemory memory(*item);
+  memory.InferFromTrace(step_stats);
+
+  std::unordered_map<string, Costs::Duration> start_times;
+  std::unordered_map<string, Costs::Duration> completion_times;
+  std::unordered_map<string, Costs::Duration> run_times;
+  for (const auto& dev_stats : step_stats.dev_stats()) {
+    for (const auto& node_stats : dev_stats.node_stats()) {
+      start_times.emplace(
+          node_stats.node_name(),
+          Costs::MicroSeconds(node_stats.all_start_micros() +
+                              node_stats.op_start_rel_micros()));
+      completion_times.emplace(
+          node_stats.node_name(),
+          Costs::MicroSeconds(node_stats.all_start_micros() +
+                              node_stats.op_end_rel_micros()));
+      run_times.emplace(node_stats.node_name(),
+                        Costs::MicroSeconds(node_stats.op_end_rel_micros() -
+                                            node_stats.op_start_rel_micros()));
+    }
+  }
+  std::unordered_set<string> feeds;
+  for (const auto& feed : item->feed) {
+    feeds.insert(NodeName(feed.first));
+  }
+  const std::unordered_set<string> cheap_to_recompute_ops =
+      GetCheapToRecomputeOps();
+  auto is_target = [&recomputation_targets_name_scope](const NodeDef& node) {
+    return IsRecomputationTarget(node, recomputation_targets_name_scope);
+  };
+
+  MutableGraphView graph(&item->graph);
+  bool updated_graph = false;
+  int num_recomputed = 0;
+  int num_swapped = 0;
+  *predicted_peak = -1;
+  for (const auto& device : cluster->GetDevices()) {
+    const string& name = device.first;
+    const GraphMemory::MemoryUsage& mem_usage = memory.GetPeakMemoryUsage(name);
+    int64_t peak = mem_usage.used_memory;
+    if (peak > budget) {
+      Costs::Duration peak_time = -1;
+      for (const auto& live_tensor : mem_usage.live_tensors) {
+        peak_time = std::max(peak_time, live_tensor.allocation_time);
+      }
+
+      std::vector<MemoryDecision> decisions;
+      for (const auto& live_tensor : mem_usage.live_tensors) {
+        if (live_tensor.memory_used <= 1024) {
+          // Don't bother with small tensors.
+          continue;
+        }
+        MutableGraphView::OutputPort port =
+            graph.GetOutputPort(live_tensor.node, live_tensor.output_id);
+        if (port.node == nullptr) {
+          continue;
+        }
+        // Only the uses after the peak need the tensor to be recomputed or
+        // swapped back in. Between the uses before the peak and the ones
+        // after it, the tensor is idle.
+        std::vector<MutableGraphView::InputPort> later_uses;
+        auto produced = completion_times.find(port.node->name());
+        bool valid = produced != completion_times.end();
+        Costs::Duration idle_start = valid ? produced->second : 0;
+        Costs::Duration idle_end = Costs::Duration::infinity();
+        for (MutableGraphView::InputPort input : graph.GetFanout(port)) {
+          auto it = completion_times.find(input.node->name());
+          if (!valid || it == completion_times.end()) {
+            valid = false;
+            break;
+          }
+          if (it->second > peak_time) {
+            later_uses.push_back(input);
+            idle_end = std::min(idle_end, start_times[input.node->name()]);
+          } else {
+            idle_start = std::max(idle_start, it->second);
+          }
+        }
+        if (!valid || later_uses.empty()) {
+          continue;
+        }
+
+        const NodeDef& node = *port.node;
+        MemoryDecision decision;
+        decision.node = port.node;
+        decision.bytes = live_tensor.memory_used;
+        decision.cost = Costs::Duration::infinity();
+        decision.recompute = false;
+        // The recomputation pass only feeds recomputed tensors to targets.
+        if ((cheap_to_recompute_ops.count(node.op()) > 0 ||
+             node.attr().count(kRecomputeHint) > 0) &&
+            feeds.count(node.name()) == 0 && !is_target(node) &&
+            std::all_of(later_uses.begin(), later_uses.end(),
+                        [&is_target](const MutableGraphView::InputPort& use) {
+                          return is_target(*use.node);
+                        })) {
+          auto it = run_times.find(node.name());
+          decision.cost = std::max<Costs::Duration>(
+              Costs::NanoSeconds(1),
+              it == run_times.end() ? Costs::Duration(0) : it->second);
+          decision.recompute = true;
+        }
+        if (device.second.type() == "GPU" && IsSwappable(graph, port) &&
+            std::all_of(later_uses.begin(), later_uses.end(),
+                        [](const MutableGraphView::InputPort& use) {
+                          return IsSwappable(use) &&
+                                 use.node->attr().count("_swap_to_host") == 0;
+                        })) {
+          // Swap out and back in over PCIe, assumed to run at 16 GBps. The
+          // copies run on their own streams, so only the part of the round
+          // trip that is longer than the idle time delays the computation,
+          // which favors the tensors with long live ranges.
+          const Costs::Duration round_trip =
+              Costs::NanoSeconds(2 * decision.bytes / 16);
+          const Costs::Duration idle_time = idle_end - idle_start;
+          const Costs::Duration swap_cost =
+              Costs::NanoSeconds(1) +
+              std::max<Costs::Duration>(0, round_trip - idle_time);
+          if (swap_cost < decision.cost) {
+            decision.cost = swap_cost;
+            decision.recompute = false;
+            decision.uses_to_swap = std::move(later_uses);
+          }
+        }
+        if (decision.recompute || !decision.uses_to_swap.empty()) {
+          decisions.push_back(std::move(decision));
+        }
+      }
+
+      // Finding the cheapest set of decisions is a knapsack problem, so
+      // greedily take the ones with the lowest cost per byte freed.
+      std::sort(decisions.begin(), decisions.end(),
+                [](const MemoryDecision& a, const MemoryDecision& b) {
+                  return static_cast<double>(a.cost.count()) / a.bytes <
+                         static_cast<double>(b.cost.count()) / b.bytes;
+                });
+      for (const MemoryDecision& decision : decisions) {
+        if (peak <= budget) {
+          break;
+        }
+        if (decision.recompute) {
+          VLOG(1) << "Will recompute " << decision.node->name() << " of size "
+                  << decision.bytes;
+          (*decision.node->mutable_attr())[kRecomputeHint].set_i(0);
+          ++num_recomputed;
+        } else {
+          for (const MutableGraphView::InputPort& use : decision.uses_to_swap) {
+            VLOG(1) << "Will swap fanout " << use.node->name() << ":"
+                    << use.port_id << " of size " << decision.bytes;
+            (*use.node->mutable_attr())["_swap_to_host"]
+                .mutable_list()
+                ->add_i(use.port_id);
+          }
+          ++num_swapped;
+        }
+        peak -= decision.bytes;
+        updated_graph = true;
+      }
+      if (peak > budget) {
+        LOG(WARNING) << "The peak memory usage of " << name << " of "
+                     << mem_usage.used_memory << " bytes does not fit under "
+                     << "the memory optimizer budget of " << budget
+                     << " bytes, only under " << peak << " bytes";
+      }
+    }
+    *predicted_peak = std::max(*predicted_peak, peak);
+  }
+  if (updated_graph) {
+    LOG(INFO) << "Recomputing " << num_recomputed << " and swapping "
+              << num_swapped << " tensors to fit the peak memory usage of "
+              << memory.GetWorstCaseMemoryUsage() << " bytes under "
+              << budget << " bytes";
+  }
+  return updated_graph;
+}
+
 bool CrossesTaskOrCpuGpuBoundary(const NodeDef& node1, const NodeDef& node2) {
   string task1;
   string device1;
@@ -1394,10 +1620,28 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   GrapplerItem optimized_item(item);
   RelaxAssignNodes(nodes_to_relax, &optimized_item.graph);
 
-  if (run_recomputation_pass) {
-    RecomputationRewritingPass(optimization_level_,
-                               recomputation_targets_name_scope_,
-                               &optimized_item.graph, item);
+  // Plan the recompute and swap decisions that fit the peak memory usage
+  // under the budget. The passes below apply them like manual annotations.
+  bool fit_memory_budget = false;
+  int64_t predicted_peak = -1;
+  if (peak_memory_budget_bytes_ > 0 && !item.fetch.empty() &&
+      cluster != nullptr) {
+    StepStats step_stats;
+    Status s = CollectStepStats(cluster, optimized_item, &step_stats);
+    if (s.ok()) {
+      fit_memory_budget = PlanPeakMemoryBudget(
+          cluster, peak_memory_budget_bytes_,
+          recomputation_targets_name_scope_, step_stats, &optimized_item,
+          &predicted_peak);
+    } else {
+      VLOG(1) << "Failed to collect the memory usage: " << s.message();
+    }
+  }
+
+  if (run_recomputation_pass || fit_memory_budget) {
+    RecomputationRewritingPass(
+        run_recomputation_pass ? optimization_level_ : RewriterConfig::MANUAL,
+        recomputation_targets_name_scope_, &optimized_item.graph, item);
   }
 
   std::unordered_set<string> skip_list;
@@ -1426,7 +1670,8 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       if ((optimization_level_ == RewriterConfig::DEFAULT_MEM_OPT ||
            optimization_level_ == RewriterConfig::SWAPPING_HEURISTICS ||
            optimization_level_ == RewriterConfig::HEURISTICS ||
-           optimization_level_ == RewriterConfig::MANUAL) &&
+           optimization_level_ == RewriterConfig::MANUAL ||
+           fit_memory_budget) &&
           cluster != nullptr) {
         if (SwappingPass(optimization_level_, cluster, &memory, &optimized_item,
                          &skip_list)) {
@@ -1438,6 +1683,20 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
     }
   }
 
+  if (fit_memory_budget) {
+    StepStats step_stats;
+    if (CollectStepStats(cluster, optimized_item, &step_stats).ok()) {
+      GraphMemory memory(optimized_item);
+      memory.InferFromTrace(step_stats);
+      LOG(INFO) << "Peak memory usage for the budget of "
+                << peak_memory_budget_bytes_ << " bytes: predicted "
+                << predicted_peak << " bytes, "
+                << (cluster->DetailedStatsEnabled() ? "measured "
+                                                    : "estimated ")
+                << memory.GetWorstCaseMemoryUsage() << " bytes";
+    }
+  }
+
   optimized_graph->Swap(&optimized_item.graph);
   return OkStatus();
 }
@@ -393,6 +393,84 @@ TEST_F(MemoryOptimizerTest, UnswappableInputs) {
 #endif
 }
 
+TEST_F(MemoryOptimizerTest, PeakMemoryBudget) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output v = ops::Variable(s.WithOpName("v").WithDevice("/cpu:0"),
+                           {128, 128, 8}, DT_FLOAT);
+  Output a = ops::Relu(s.WithOpName("a").WithDevice("/cpu:0"), v);
+  Output b = ops::Exp(s.WithOpName("b").WithDevice("/cpu:0"), a);
+  Output c = ops::Exp(s.WithOpName("c").WithDevice("/cpu:0"), b);
+  Output d = ops::AddN(s.WithOpName("gradients/d").WithDevice("/cpu:0"),
+                       {a, c});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"gradients/d"};
+
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+
+  // The graph already fits under a large budget.
+  MemoryOptimizer large_budget(RewriterConfig::MANUAL, "gradients/",
+                               /*peak_memory_budget_bytes=*/1 << 30);
+  GraphDef output;
+  TF_EXPECT_OK(large_budget.Optimize(cluster.get(), item, &output));
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+
+  // Under a tiny budget, the Relu output is recomputed for its gradient since
+  // that is the only way to free it on the CPU.
+  MemoryOptimizer tiny_budget(RewriterConfig::MANUAL, "gradients/",
+                              /*peak_memory_budget_bytes=*/1);
+  TF_EXPECT_OK(tiny_budget.Optimize(cluster.get(), item, &output));
+  NodeMap node_map(&output);
+  EXPECT_NE(node_map.GetNode("Recomputed/a"), nullptr);
+  const NodeDef* new_d = node_map.GetNode("gradients/d");
+  ASSERT_NE(new_d, nullptr);
+  EXPECT_EQ("Recomputed/a", new_d->input(0));
+  EXPECT_EQ("c", new_d->input(1));
+}
+
+TEST_F(MemoryOptimizerTest, PeakMemoryBudgetSwapsLongLivedTensors) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
+                           {128, 128, 8}, DT_FLOAT);
+  Output a = ops::Exp(s.WithOpName("a").WithDevice("/gpu:0"), v);
+  Output b = ops::Exp(s.WithOpName("b").WithDevice("/gpu:0"), a);
+  Output c = ops::Exp(s.WithOpName("c").WithDevice("/gpu:0"), b);
+  Output d = ops::Exp(s.WithOpName("d").WithDevice("/gpu:0"), c);
+  Output e = ops::AddN(s.WithOpName("e").WithDevice("/gpu:0"), {a, d});
+
+  Output constant = ops::Const(s.WithOpName("constant"), 0.0f, {128, 128, 8});
+  Output init = ops::Assign(s.WithOpName("init"), v, constant);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"e"};
+  item.init_ops = {init.name()};
+
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+
+  // The output of a is idle from b to e, so it is swapped out to the host and
+  // prefetched back for e.
+  MemoryOptimizer optimizer(RewriterConfig::MANUAL, "gradients/",
+                            /*peak_memory_budget_bytes=*/1);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(cluster.get(), item, &output));
+  NodeMap node_map(&output);
+  const NodeDef* new_e = node_map.GetNode("e");
+  ASSERT_NE(new_e, nullptr);
+  EXPECT_EQ("swap_in_e_0", new_e->input(0));
+  const NodeDef* swap_out = node_map.GetNode("swap_out_e_0");
+  ASSERT_NE(swap_out, nullptr);
+  EXPECT_EQ("a", swap_out->input(0));
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  auto tensors_expected = EvaluateFetchNodes(item);
+  GrapplerItem optimized = item.WithGraph(std::move(output));
+  auto tensors = EvaluateFetchNodes(optimized);
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+#endif
+}
+
 TEST_F(MemoryOptimizerTest, AccumulationRewrites) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output a = ops::RandomNormal(s.WithOpName("a").WithDevice("/cpu:0"),
@@ -21,6 +21,7 @@ limitations under the License.
 #include <type_traits>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -61,9 +62,13 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/tpu.h"
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
 #include "tensorflow/core/util/xla_config_registry.h"
 
@@ -103,6 +108,15 @@ int NumIterations(const RewriterConfig& cfg) {
              : cfg.meta_optimizer_iterations();
 }
 
+// Sets "*fingerprint" to a fingerprint of "graph". Returns false if "graph"
+// cannot be serialized, e.g. because it is larger than 2GB.
+bool GraphFingerprint(const GraphDef& graph, uint64* fingerprint) {
+  string serialized;
+  if (!SerializeToStringDeterministic(graph, &serialized)) return false;
+  *fingerprint = Fingerprint64(serialized);
+  return true;
+}
+
 // Check if optimizer is allowed to run only once.
 bool IsRunOnceOptimizer(const string& name) {
   return name == "layout" || name == "memory_optimizer" ||
@@ -471,11 +485,14 @@ Status MetaOptimizer::InitializeOptimizers(
     if (cfg_.memory_optimizer_target_node_name_scope().empty()) {
       optimizers->push_back(
           // Use the default target node name prefix "gradients/"
-          std::make_unique<MemoryOptimizer>(cfg_.memory_optimization()));
+          std::make_unique<MemoryOptimizer>(
+              cfg_.memory_optimization(), "gradients/",
+              cfg_.memory_optimizer_peak_budget_bytes()));
     } else {
       optimizers->push_back(std::make_unique<MemoryOptimizer>(
           cfg_.memory_optimization(),
-          cfg_.memory_optimizer_target_node_name_scope()));
+          cfg_.memory_optimizer_target_node_name_scope(),
+          cfg_.memory_optimizer_peak_budget_bytes()));
     }
   }
   if (cfg_.auto_parallel().enable() && PLUGIN_IS_ON(auto_parallel)) {
@@ -808,6 +825,18 @@ Status MetaOptimizer::OptimizeGraph(
     CompressConstants(optimized_graph);
   }
 
+  // With experimental_skip_unchanged_optimizers, maps each optimizer that
+  // left the graph unchanged in its last run to the fingerprint of that graph.
+  // It is not run again until the graph changes.
+  bool skip_unchanged_optimizers =
+      cfg_.experimental_skip_unchanged_optimizers();
+  absl::flat_hash_map<const GraphOptimizer*, uint64> unchanged_fingerprints;
+  uint64 graph_fingerprint = 0;
+  if (skip_unchanged_optimizers) {
+    skip_unchanged_optimizers =
+        GraphFingerprint(*optimized_graph, &graph_fingerprint);
+  }
+
   for (int iteration = 0; iteration < NumIterations(cfg_); ++iteration) {
     // Don't bother optimizing further if the graph is already tiny.
     if (optimized_graph->node_size() < min_graph_nodes) {
@@ -837,6 +866,20 @@ Status MetaOptimizer::OptimizeGraph(
       }
 #endif
 
+      if (skip_unchanged_optimizers) {
+        auto it = unchanged_fingerprints.find(optimizer.get());
+        if (it != unchanged_fingerprints.end() &&
+            it->second == graph_fingerprint) {
+          VLOG(1) << optimizer->name()
+                  << " skipped, the graph is unchanged since it last ran.";
+          optimization_result.results.push_back(
+              {optimizer->name(),
+               "skipped, the graph is unchanged since it last ran.",
+               OkStatus()});
+          continue;
+        }
+      }
+
       TF_RETURN_IF_ERROR(RunOptimizer(optimizer.get(), cluster, &item,
                                       optimized_graph, &optimization_result));
 
@@ -844,6 +887,18 @@ Status MetaOptimizer::OptimizeGraph(
         CompressConstants(optimized_graph);
       }
 
+      if (skip_unchanged_optimizers) {
+        uint64 fingerprint = 0;
+        skip_unchanged_optimizers =
+            GraphFingerprint(*optimized_graph, &fingerprint);
+        if (fingerprint == graph_fingerprint) {
+          unchanged_fingerprints[optimizer.get()] = fingerprint;
+        } else {
+          unchanged_fingerprints.erase(optimizer.get());
+        }
+        graph_fingerprint = fingerprint;
+      }
+
       if (VLOG_IS_ON(4)) {
         DumpGraphDefToFile(
             strings::StrCat("after_MetaOptimizer_iteration_", iteration, "_",
@@ -883,7 +938,10 @@ Status MetaOptimizer::OptimizeGraph(
                                    }) != optimization_result.results.end();
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -1050,7 +1108,10 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       {kGrapplerCategory, "*"});
 
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
-  optimization_results_.clear();
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.clear();
+  }
 
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
@@ -1159,15 +1220,106 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
   // True if this is a TPU graph using the old bridge.
   bool is_tpu_graph = IsLegacyTPUBridgeGraphDef(*optimized_graph);
 
+  // Optimizes the body of "func" into "optimized_func_graph", reading
+  // "func_flib" only so that it can run concurrently for several functions.
+  const auto optimize_function =
+      [&](const FunctionDef& func, const FunctionLibraryDefinition& func_flib,
+          GrapplerFunctionItem* func_item,
+          GraphDef* optimized_func_graph) -> Status {
+    const string& func_name = func.signature().name();
+
+    // Make a GrapplerItem from a FunctionDef.
+    TF_RETURN_IF_ERROR(
+        MakeGrapplerFunctionItem(func, func_flib, producer, func_item));
+
+    // If we need to compute the gradient of optimized function at runtime, we
+    // can't perform non-differentiable rewrites.
+    func_item->optimization_options().allow_non_differentiable_rewrites =
+        !differentiable_functions.contains(func_name);
+
+    // Device set available to the function is defined only by the runtime,
+    // when we instantiate and execute the function. We can't use all devices
+    // available to the main graph, because after partitioning the function
+    // call node might execute on a remote worker.
+    if (!func_item->devices().empty()) {
+      return errors::Internal("GrapplerFunctionItem devices must be empty.");
+    }
+
+    // We are not allowed to prune certain types of ops from the graph
+    // instantiated by the function definition, because we must guarantee
+    // function execution semantics wrt side effects (see
+    // function_optimizer.cc).
+    func_item->optimization_options().allow_pruning_stateful_and_dataset_ops =
+        false;
+
+    // Optimize function body graph.
+    if (is_tpu_graph) {
+      // Skip optimizing functions if this is a TPU graph. Currently, Grappler
+      // passes do not handle TPU functions correctly in a variety of ways
+      // (Note that due to the pre-placement TPU graph rewriting passes, the
+      // TPU-related ops are encapsulated away into functions). For example,
+      // TPU graphs contain TPUReplicateMetadata node that carries relevant
+      // TPU metadata and Grappler passes could prune that away. Grappler
+      // passes could also cause issues around shape inference. Since the
+      // desired and existing behavior is to not optimize TPU functions with
+      // Grappler, this check preserves that. The only exception is
+      // implementation selector what is required to swap in some TPU specific
+      // lowering code and is verified the work correctly on TPUs.
+      ImplementationSelector implementation_selector;
+
+      // Implementation selector needs to have access to valid function
+      // signature and attributes, and it doesn't need actual function body.
+      std::unique_ptr<FunctionDefLibrary> func_item_function_library(
+          func_item->graph.release_library());
+      *func_item->graph.mutable_library() =
+          GetFunctionDefLibraryStub(*func_item_function_library);
+
+      return implementation_selector.Optimize(cluster, *func_item,
+                                              optimized_func_graph);
+    }
+    GrapplerFunctionItem func_item_copy = *func_item;
+    return OptimizeGraph(cluster, std::move(func_item_copy),
+                         optimized_func_graph);
+  };
+
+  // Replaces "func_name" in "flib" by the optimized function.
+  const auto merge_function = [&](const string& func_name,
+                                  GrapplerFunctionItem* func_item,
+                                  GraphDef* optimized_func_graph) -> Status {
+    // Function body optimization might have created new specialized
+    // functions for each instantiation context. Add them to the library.
+    for (const FunctionDef& func_def :
+         optimized_func_graph->library().function()) {
+      if (flib.Find(func_def.signature().name()) == nullptr) {
+        TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+      }
+    }
+
+    // Convert optimized graph back to FunctionDef.
+    FunctionDef optimized_func;
+    func_item->SwapFunctionBody(std::move(*optimized_func_graph));
+    TF_RETURN_IF_ERROR(MakeFunctionDef(*func_item, flib, &optimized_func));
+
+    // Replace optimized function with a new FunctionDef.
+    return flib.ReplaceFunction(func_name, optimized_func);
+  };
+
+  // With more than one thread, the functions of each pass over the library
+  // are optimized concurrently against the library as it was at the start of
+  // the pass, and merged back in library order, so that the result does not
+  // depend on the scheduling. With one thread, each function sees the
+  // functions optimized before it.
+  int64_t num_function_threads;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar(
+      "TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS", 1, &num_function_threads));
+
   // Optimize each function only once.
   absl::flat_hash_set<string> optimized_funcs;
   while (optimize_function_library) {
     optimize_function_library = false;
 
-    int function_idx = 0;
+    std::vector<const FunctionDef*> funcs;
     for (const FunctionDef& func : optimized_graph->library().function()) {
-      GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
-
       const string& func_name = func.signature().name();
 
       // Skip functions that are not reachable from the optimized graph.
@@ -1187,87 +1339,51 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       // and in function instantiation.
       if (data::IsTFDataFunction(func)) continue;
 
-      VLOG(3) << "Optimize function: function=" << func_name << " ["
-              << function_idx++ << " of "
-              << optimized_graph->library().function_size() << "]";
-
       // Function optimization might specialize nested function calls, so we
       // have to reset the flag and do at least one more pass over the library.
       optimize_function_library = true;
       optimized_funcs.insert(func_name);
+      funcs.push_back(&func);
+    }
 
-      // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
-      TF_RETURN_IF_ERROR(
-          MakeGrapplerFunctionItem(func, flib, producer, &func_item));
-
-      // If we need to compute the gradient of optimized function at runtime, we
-      // can't perform non-differentiable rewrites.
-      func_item.optimization_options().allow_non_differentiable_rewrites =
-          !differentiable_functions.contains(func_name);
-
-      // Device set available to the function is defined only by the runtime,
-      // when we instantiate and execute the function. We can't use all devices
-      // available to the main graph, because after partitioning the function
-      // call node might execute on a remote worker.
-      if (!func_item.devices().empty()) {
-        return errors::Internal("GrapplerFunctionItem devices must be empty.");
-      }
-
-      // We are not allowed to prune certain types of ops from the graph
-      // instantiated by the function definition, because we must guarantee
-      // function execution semantics wrt side effects (see
-      // function_optimizer.cc).
-      func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
-          false;
-
-      // Optimize function body graph.
-      GraphDef optimized_func_graph;
-      if (is_tpu_graph) {
-        // Skip optimizing functions if this is a TPU graph. Currently, Grappler
-        // passes do not handle TPU functions correctly in a variety of ways
-        // (Note that due to the pre-placement TPU graph rewriting passes, the
-        // TPU-related ops are encapsulated away into functions). For example,
-        // TPU graphs contain TPUReplicateMetadata node that carries relevant
-        // TPU metadata and Grappler passes could prune that away. Grappler
-        // passes could also cause issues around shape inference. Since the
-        // desired and existing behavior is to not optimize TPU functions with
-        // Grappler, this check preserves that. The only exception is
-        // implementation selector what is required to swap in some TPU specific
-        // lowering code and is verified the work correctly on TPUs.
-        ImplementationSelector implementation_selector;
-
-        // Implementation selector needs to have access to valid function
-        // signature and attributes, and it doesn't need actual function body.
-        std::unique_ptr<FunctionDefLibrary> func_item_function_library(
-            func_item.graph.release_library());
-        *func_item.graph.mutable_library() =
-            GetFunctionDefLibraryStub(*func_item_function_library);
-
-        TF_RETURN_IF_ERROR(implementation_selector.Optimize(
-            cluster, func_item, &optimized_func_graph));
-      } else {
-        GrapplerFunctionItem func_item_copy = func_item;
-        TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(func_item_copy),
-                                         &optimized_func_graph));
+    if (num_function_threads <= 1 || funcs.size() <= 1) {
+      for (int i = 0; i < funcs.size(); ++i) {
+        GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+        VLOG(3) << "Optimize function: function="
+                << funcs[i]->signature().name() << " [" << i << " of "
+                << funcs.size() << "]";
+        GrapplerFunctionItem func_item;
+        GraphDef optimized_func_graph;
+        TF_RETURN_IF_ERROR(
+            optimize_function(*funcs[i], flib, &func_item,
+                              &optimized_func_graph));
+        TF_RETURN_IF_ERROR(merge_function(funcs[i]->signature().name(),
+                                          &func_item, &optimized_func_graph));
       }
-
-      // Function body optimization might have created new specialized
-      // functions for each instantiation context. Add them to the library.
-      for (const FunctionDef& func_def :
-           optimized_func_graph.library().function()) {
-        if (flib.Find(func_def.signature().name()) == nullptr) {
-          TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+    } else {
+      VLOG(3) << "Optimize " << funcs.size() << " functions on "
+              << num_function_threads << " threads";
+      std::vector<GrapplerFunctionItem> func_items(funcs.size());
+      std::vector<GraphDef> optimized_func_graphs(funcs.size());
+      std::vector<Status> statuses(funcs.size());
+      {
+        thread::ThreadPool pool(
+            Env::Default(), "grappler_function_optimization",
+            std::min<int64_t>(num_function_threads, funcs.size()));
+        for (int i = 0; i < funcs.size(); ++i) {
+          pool.Schedule([&, i] {
+            statuses[i] = optimize_function(*funcs[i], flib, &func_items[i],
+                                            &optimized_func_graphs[i]);
+          });
         }
       }
-
-      // Convert optimized graph back to FunctionDef.
-      FunctionDef optimized_func;
-      func_item.SwapFunctionBody(std::move(optimized_func_graph));
-      TF_RETURN_IF_ERROR(MakeFunctionDef(func_item, flib, &optimized_func));
-
-      // Replace optimized function with a new FunctionDef.
-      TF_RETURN_IF_ERROR(flib.ReplaceFunction(func_name, optimized_func));
+      for (int i = 0; i < funcs.size(); ++i) {
+        TF_RETURN_IF_ERROR(statuses[i]);
+        TF_RETURN_IF_ERROR(merge_function(funcs[i]->signature().name(),
+                                          &func_items[i],
+                                          &optimized_func_graphs[i]));
+      }
+      GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
     }
 
     // If optimized at least one function, update the graph library.
@@ -1316,6 +1432,7 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
 
 string MetaOptimizer::GetResultString() const {
   std::string result_string;
+  mutex_lock l(optimization_results_mu_);
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     absl::StrAppend(&result_string,
                     "Optimization results for grappler item: ", graph_result.id,
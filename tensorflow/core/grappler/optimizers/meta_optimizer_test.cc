@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
 
+#include <stdlib.h>
+
 #include <atomic>
 
 #include "absl/strings/match.h"
@@ -89,6 +91,25 @@ class TestOptimizerWithParams : public TestOptimizer {
 
 REGISTER_GRAPH_OPTIMIZER(TestOptimizerWithParams);
 
+// Counts its runs, and leaves the graph unchanged.
+class CountingOptimizer : public TestOptimizer {
+ public:
+  static int num_runs;
+
+  string name() const override { return "counting_optimizer"; }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override {
+    ++num_runs;
+    *optimized_graph = item.graph;
+    return OkStatus();
+  }
+};
+
+int CountingOptimizer::num_runs;
+
+REGISTER_GRAPH_OPTIMIZER(CountingOptimizer);
+
 // Record various properties of the GrapplerItems passed for optimization.
 class GrapplerItemPropertiesAccumulator : public CustomGraphOptimizer {
  public:
@@ -255,6 +276,47 @@ TEST_F(MetaOptimizerTest, RunToggleOptimizersAndCustomGraphOptimizerTwice) {
   EXPECT_TRUE(TestGraphOptimizer::IsOptimized());
 }
 
+TEST_F(MetaOptimizerTest, RerunsUnchangedOptimizersByDefault) {
+  TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {kDevice});
+  GrapplerItem item;
+  ASSERT_TRUE(fake_input.NextItem(&item));
+
+  CountingOptimizer::num_runs = 0;
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.add_optimizers("CountingOptimizer");
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  rewriter_config.set_min_graph_nodes(-1);
+
+  MetaOptimizer optimizer(nullptr, config_proto);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_EQ(CountingOptimizer::num_runs, 2);
+}
+
+TEST_F(MetaOptimizerTest, SkipsUnchangedOptimizers) {
+  TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {kDevice});
+  GrapplerItem item;
+  ASSERT_TRUE(fake_input.NextItem(&item));
+
+  CountingOptimizer::num_runs = 0;
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.add_optimizers("CountingOptimizer");
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  rewriter_config.set_min_graph_nodes(-1);
+  rewriter_config.set_experimental_skip_unchanged_optimizers(true);
+
+  MetaOptimizer optimizer(nullptr, config_proto);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_EQ(CountingOptimizer::num_runs, 1);
+  EXPECT_TRUE(absl::StrContains(optimizer.GetResultString(),
+                                "counting_optimizer: skipped"));
+}
+
 TEST_F(MetaOptimizerTest, OptimizeFunctionLibrary) {
   using test::function::NDef;
 
@@ -420,6 +482,64 @@ TEST_F(MetaOptimizerTest, OptimizeFunctionLibrary) {
   test::ExpectTensorEqual<int>(tensors_expected[1], tensors[1]);
 }
 
+TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryConcurrently) {
+  using test::function::NDef;
+
+  // Independent functions Square<i>(x) = Identity(Identity(x))^2, none of
+  // them inlined.
+  std::vector<FunctionDef> funcs;
+  std::vector<NodeDef> nodes = {
+      NDef("x", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice)};
+  for (int i = 0; i < 8; ++i) {
+    const string name = absl::StrCat("Square", i);
+    funcs.push_back(FunctionDefHelper::Create(
+        name, {"x:float"}, {"z:float"}, {},
+        {{{"a"}, "Identity", {"x"}, {{"T", DT_FLOAT}}},
+         {{"b"}, "Identity", {"a:output:0"}, {{"T", DT_FLOAT}}},
+         {{"mul"}, "Mul", {"b:output:0", "b:output:0"}, {{"T", DT_FLOAT}}}},
+        /*ret_def=*/
+        {{"z", "mul:z:0"}}));
+    (*funcs.back().mutable_attr())["_noinline"].set_b(true);
+    nodes.push_back(NDef(absl::StrCat("square", i), name, {"x"}, {}, kDevice));
+  }
+  GrapplerItem item;
+  item.id = "tf_graph";
+  item.graph = test::function::GDef(nodes, funcs);
+
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_min_graph_nodes(-1);
+
+  GraphDef sequential_output;
+  {
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &sequential_output));
+  }
+  GraphDef concurrent_output;
+  setenv("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS", "4", 1);
+  {
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &concurrent_output));
+  }
+  unsetenv("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS");
+
+  // The functions are independent, so they are optimized the same way.
+  FunctionLibraryDefinition sequential_flib(OpRegistry::Global(),
+                                            sequential_output.library());
+  FunctionLibraryDefinition concurrent_flib(OpRegistry::Global(),
+                                            concurrent_output.library());
+  ASSERT_EQ(sequential_flib.num_functions(), concurrent_flib.num_functions());
+  for (const string& name : sequential_flib.ListFunctionNames()) {
+    const FunctionDef* concurrent_func = concurrent_flib.Find(name);
+    ASSERT_NE(concurrent_func, nullptr) << name;
+    EXPECT_TRUE(FunctionDefsEqual(*sequential_flib.Find(name),
+                                  *concurrent_func))
+        << name;
+  }
+  CompareGraphs(sequential_output, concurrent_output);
+}
+
 TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryPruneUnusedOutputs) {
   using test::function::NDef;
 
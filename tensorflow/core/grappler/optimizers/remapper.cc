@@ -24,6 +24,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/versions.pb.h"
@@ -82,6 +83,14 @@ namespace grappler {
 //
 // _FusedConv2D/_FusedConv3D + <Activation> -> _FusedConv2D/_FusedConv3D
 // Supported Activations: LeakyRelu, Mish
+//
+// Tree of float elementwise ops on CPU -> _FusedElementwise
+//   Only with remapping set to AGGRESSIVE.
+//
+// Gather + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments] on CPU ->
+//   Gather of the ids + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments] of the
+//   gathered params
+// Gather + Segment{Sum,Mean} on CPU -> SparseSegment{Sum,Mean}
 
 namespace {
 
@@ -92,6 +101,7 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kFusedElementwise[] = "_FusedElementwise";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -106,6 +116,9 @@ constexpr char kFill[] = "fill";
 
 constexpr int kMissingIndex = -1;
 
+// The largest number of ops that a _FusedElementwise computes.
+constexpr int kMaxFusedElementwiseOps = 32;
+
 struct RemapperContext {
   explicit RemapperContext(GrapplerItem* item, Status* status,
                            RewriterConfig::CpuLayout cpu_layout_conversion,
@@ -123,6 +136,7 @@ struct RemapperContext {
   bool inferred_graph_properties;
   RewriterConfig::CpuLayout cpu_layout_conversion;
   bool xla_auto_clustering_on;
+  bool fuse_elementwise_trees = false;
 };
 
 // FusedBatchNorm that can be replaced with a cheaper set of primitives.
@@ -167,6 +181,21 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// Tree of elementwise ops that can be replaced with a _FusedElementwise. The
+// intermediate values of the tree have the shape of its root and feed no
+// other nodes.
+struct ElementwiseTree {
+  // The ops of the tree in topological order, ending with the root.
+  std::vector<int> ops;
+};
+
+// Gather along axis 0 whose output only feeds a segment reduction, which
+// can read the rows from the params of the gather instead.
+struct GatherWithSegmentReduction {
+  int gather = kMissingIndex;
+  int reduction = kMissingIndex;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -2612,6 +2641,168 @@ bool FindFusedBatchNormGradEx(const RemapperContext& ctx, int node_index,
   return false;
 }
 
+// Returns the number of inputs of `node` if _FusedElementwise can compute it,
+// or 0.
+int NumFusableElementwiseInputs(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_map<string, int>{
+      {"Abs", 1},
+      {"Ceil", 1},
+      {"Exp", 1},
+      {"Floor", 1},
+      {"Log", 1},
+      {"Neg", 1},
+      {"Reciprocal", 1},
+      {"Relu", 1},
+      {"Rsqrt", 1},
+      {"Sigmoid", 1},
+      {"Sqrt", 1},
+      {"Square", 1},
+      {"Tanh", 1},
+      {"Add", 2},
+      {"AddV2", 2},
+      {"Div", 2},
+      {"RealDiv", 2},
+      {"Maximum", 2},
+      {"Minimum", 2},
+      {"Mul", 2},
+      {"SquaredDifference", 2},
+      {"Sub", 2},
+  };
+  if (!HasDataType(&node, DT_FLOAT)) return 0;
+  auto it = kOps->find(node.op());
+  return it == kOps->end() ? 0 : it->second;
+}
+
+bool IsFusableElementwiseOp(const utils::MutableNodeView& node_view,
+                            const NodeDef& root) {
+  const NodeDef* node_def = node_view.node();
+  const int num_inputs = NumFusableElementwiseInputs(*node_def);
+  return num_inputs > 0 && node_view.NumRegularFanins() == num_inputs &&
+         NodeIsOnCpu(node_def) && node_def->device() == root.device() &&
+         !HasControlFaninOrFanout(node_view);
+}
+
+bool FindElementwiseTree(const RemapperContext& ctx, int node_index,
+                         ElementwiseTree* matched) {
+  const auto* root_view = ctx.graph_view.GetNode(node_index);
+  const NodeDef* root = root_view->node();
+  if (!IsFusableElementwiseOp(*root_view, *root)) return false;
+  const auto& root_props =
+      ctx.graph_properties.GetOutputProperties(root->name());
+  if (root_props.empty() || !ShapeIsSymbolicallyDefined(root_props[0])) {
+    return false;
+  }
+  const TensorShapeProto& shape = root_props[0].shape();
+
+  // Grows the tree breadth first with the producers that only feed it.
+  std::vector<int> ops = {node_index};
+  for (int i = 0; i < ops.size(); ++i) {
+    const auto* node_view = ctx.graph_view.GetNode(ops[i]);
+    const auto& input_props =
+        ctx.graph_properties.GetInputProperties(node_view->GetName());
+    if (input_props.size() != node_view->NumRegularFanins()) return false;
+    for (int j = 0; j < input_props.size(); ++j) {
+      // Scalars are broadcast, other inputs must have the shape of the root.
+      const TensorShapeProto& input_shape = input_props[j].shape();
+      const bool is_scalar =
+          !input_shape.unknown_rank() && input_shape.dim_size() == 0;
+      if (!is_scalar && !ShapesSymbolicallyEqual(input_shape, shape)) {
+        return false;
+      }
+      const auto* fanin_view = node_view->GetRegularFanin(j).node_view();
+      if (!is_scalar && ops.size() < kMaxFusedElementwiseOps &&
+          IsFusableElementwiseOp(*fanin_view, *root) &&
+          HasAtMostOneFanoutAtPort0(*fanin_view) &&
+          !IsInPreserveSet(ctx, fanin_view->node())) {
+        ops.push_back(fanin_view->node_index());
+      }
+    }
+  }
+  if (ops.size() < 2) return false;
+
+  // The graph is sorted topologically, and the root comes after the other
+  // ops of the tree.
+  std::sort(ops.begin(), ops.end());
+  matched->ops = std::move(ops);
+  return true;
+}
+
+// Returns the SparseSegment op that reads the rows of `node` from a table,
+// or nullptr if there is none.
+const char* SparseSegmentReductionOf(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_map<string, string>{
+      {"SegmentSum", "SparseSegmentSum"},
+      {"SegmentMean", "SparseSegmentMean"},
+      {"SparseSegmentSum", "SparseSegmentSum"},
+      {"SparseSegmentMean", "SparseSegmentMean"},
+      {"SparseSegmentSqrtN", "SparseSegmentSqrtN"},
+      {"SparseSegmentSumWithNumSegments", "SparseSegmentSumWithNumSegments"},
+      {"SparseSegmentMeanWithNumSegments", "SparseSegmentMeanWithNumSegments"},
+      {"SparseSegmentSqrtNWithNumSegments",
+       "SparseSegmentSqrtNWithNumSegments"},
+  };
+  auto it = kOps->find(node.op());
+  return it == kOps->end() ? nullptr : it->second.c_str();
+}
+
+bool FindGatherWithSegmentReduction(const RemapperContext& ctx, int node_index,
+                                    GatherWithSegmentReduction* matched) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const NodeDef* node_def = node_view->node();
+  if (SparseSegmentReductionOf(*node_def) == nullptr ||
+      !NodeIsOnCpu(node_def) || HasControlFaninOrFanout(*node_view) ||
+      node_view->NumRegularFanins() < 2) {
+    return false;
+  }
+  // The types of the SparseSegment ops.
+  const DataType dtype = GetDataTypeFromAttr(*node_def, "T");
+  if (dtype != DT_FLOAT && dtype != DT_DOUBLE && dtype != DT_BFLOAT16 &&
+      dtype != DT_HALF) {
+    return false;
+  }
+
+  const auto& fanin = node_view->GetRegularFanin(0);
+  const auto* gather_view = fanin.node_view();
+  const NodeDef* gather = gather_view->node();
+  if (fanin.index() != 0 || !IsGather(*gather) ||
+      gather->op() == "ResourceGather" ||
+      gather->device() != node_def->device() ||
+      HasControlFaninOrFanout(*gather_view) ||
+      !HasAtMostOneFanoutAtPort0(*gather_view) ||
+      IsInPreserveSet(ctx, gather)) {
+    return false;
+  }
+  const DataType index_type = GetDataTypeFromAttr(*gather, "Tindices");
+  if (index_type != DT_INT32 && index_type != DT_INT64) return false;
+
+  // The ids must be a vector, so that each of them gathers one row.
+  const auto& input_props =
+      ctx.graph_properties.GetInputProperties(gather->name());
+  if (input_props.size() < 2 || input_props[1].shape().unknown_rank() ||
+      input_props[1].shape().dim_size() != 1) {
+    return false;
+  }
+  if (gather->op() == "GatherV2") {
+    int batch_dims = 0;
+    if (TryGetNodeAttr(*gather, "batch_dims", &batch_dims) && batch_dims != 0) {
+      return false;
+    }
+    Tensor axis;
+    if (input_props.size() != 3 || !input_props[2].has_value() ||
+        !axis.FromProto(input_props[2].value()) || axis.NumElements() != 1) {
+      return false;
+    }
+    const int64_t axis_value = axis.dtype() == DT_INT32
+                                   ? axis.flat<int32>()(0)
+                                   : axis.flat<int64_t>()(0);
+    if (axis_value != 0) return false;
+  }
+
+  matched->gather = gather_view->node_index();
+  matched->reduction = node_index;
+  return true;
+}
+
 bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
                             TensorToHashBucket* matched) {
   // Root of the pattern must be a StringToHashBucketFast.
@@ -4285,6 +4476,134 @@ Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return OkStatus();
 }
 
+Status AddFusedElementwiseNode(RemapperContext* ctx,
+                               const ElementwiseTree& matched,
+                               std::vector<bool>* invalidated_nodes,
+                               std::vector<bool>* nodes_to_delete) {
+  const NodeDef& root = *ctx->graph_view.GetNode(matched.ops.back())->node();
+  VLOG(2) << "Fuse " << matched.ops.size()
+          << " elementwise ops into _FusedElementwise: root=" << root.name()
+          << " on device=" << root.device();
+
+  // The inputs of the fused node are the inputs of the tree that are not
+  // computed by the tree.
+  absl::flat_hash_map<int, int> step_of_op;
+  for (int i = 0; i < matched.ops.size(); ++i) step_of_op[matched.ops[i]] = i;
+  std::vector<string> inputs;
+  absl::flat_hash_map<string, int> input_index;
+  for (int op : matched.ops) {
+    const auto* node_view = ctx->graph_view.GetNode(op);
+    for (int j = 0; j < node_view->NumRegularFanins(); ++j) {
+      if (step_of_op.contains(node_view->GetRegularFanin(j).node_index())) {
+        continue;
+      }
+      const string& input = node_view->node()->input(j);
+      if (input_index.emplace(input, inputs.size()).second) {
+        inputs.push_back(input);
+      }
+    }
+  }
+
+  std::vector<string> fused_ops;
+  std::vector<int> operands;
+  for (int op : matched.ops) {
+    const auto* node_view = ctx->graph_view.GetNode(op);
+    fused_ops.push_back(node_view->node()->op());
+    for (int j = 0; j < 2; ++j) {
+      if (j >= node_view->NumRegularFanins()) {
+        operands.push_back(-1);
+        continue;
+      }
+      auto step = step_of_op.find(node_view->GetRegularFanin(j).node_index());
+      operands.push_back(step != step_of_op.end()
+                             ? static_cast<int>(inputs.size()) + step->second
+                             : input_index.at(node_view->node()->input(j)));
+    }
+  }
+
+  NodeDef fused_op;
+  fused_op.set_name(root.name());
+  fused_op.set_op(kFusedElementwise);
+  fused_op.set_device(root.device());
+  for (const string& input : inputs) fused_op.add_input(input);
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = root.attr().at("T");
+  SetAttrValue(static_cast<int>(inputs.size()), &(*attr)["N"]);
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+  SetAttrValue(operands, &(*attr)["operands"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.ops.back()] = true;
+  for (int i = 0; i + 1 < matched.ops.size(); ++i) {
+    (*nodes_to_delete)[matched.ops[i]] = true;
+  }
+  return OkStatus();
+}
+
+Status AddGatherSegmentReductionNodes(RemapperContext* ctx,
+                                      const GatherWithSegmentReduction& matched,
+                                      std::vector<bool>* invalidated_nodes,
+                                      std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& gather = graph->node(matched.gather);
+  const NodeDef& reduction = graph->node(matched.reduction);
+  VLOG(2) << "Fuse " << gather.op() << " with " << reduction.op()
+          << ": gather=" << gather.name()
+          << " reduction=" << reduction.name()
+          << " on device=" << reduction.device();
+
+  NodeDef fused_op = reduction;
+  fused_op.set_op(SparseSegmentReductionOf(reduction));
+  fused_op.set_input(0, gather.input(0));
+  auto* attr = fused_op.mutable_attr();
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  if (reduction.op() == "SegmentSum" || reduction.op() == "SegmentMean") {
+    // The ids of the gather are the indices of the SparseSegment op.
+    fused_op.clear_input();
+    fused_op.add_input(gather.input(0));
+    fused_op.add_input(gather.input(1));
+    fused_op.add_input(reduction.input(1));
+    attr->erase("Tindices");
+    (*attr)["Tidx"] = gather.attr().at("Tindices");
+    (*attr)["Tsegmentids"] = reduction.attr().at("Tindices");
+  } else {
+    // The SparseSegment op gathers from the ids what it gathered from the
+    // rows before.
+    NodeDef ids;
+    ids.set_name(AddPrefixToNodeName("GatheredIds", reduction.name()));
+    ids.set_op(gather.op());
+    ids.set_device(gather.device());
+    ids.add_input(gather.input(1));
+    ids.add_input(reduction.input(1));
+    auto* ids_attr = ids.mutable_attr();
+    (*ids_attr)["Tparams"] = gather.attr().at("Tindices");
+    (*ids_attr)["Tindices"] = reduction.attr().at("Tidx");
+    if (gather.op() == "GatherV2") {
+      ids.add_input(gather.input(2));
+      (*ids_attr)["Taxis"] = gather.attr().at("Taxis");
+    } else if (gather.attr().count("validate_indices")) {
+      (*ids_attr)["validate_indices"] = gather.attr().at("validate_indices");
+    }
+    fused_op.set_input(1, ids.name());
+    (*attr)["Tidx"] = gather.attr().at("Tindices");
+    mutation->AddNode(std::move(ids), &status);
+    TF_RETURN_IF_ERROR(status);
+  }
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.reduction] = true;
+  (*nodes_to_delete)[matched.gather] = true;
+  return OkStatus();
+}
+
 Status AddFusedBatchMatMul(RemapperContext* ctx,
                            const std::map<string, int>& matched_nodes_map,
                            const std::set<int>& remove_node_indices,
@@ -4755,17 +5074,39 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index,
     return true;
   };
 
+  // Candidate for an elementwise tree fusion.
+  const auto is_elementwise_tree_candidate = [&]() -> bool {
+    if (!ctx.fuse_elementwise_trees ||
+        NumFusableElementwiseInputs(*node_def) == 0) {
+      return false;
+    }
+    for (int i = 0; i < node_view->NumRegularFanins(); ++i) {
+      const auto* fanin_def = node_view->GetRegularFanin(i).node_view()->node();
+      if (NumFusableElementwiseInputs(*fanin_def) > 0) return true;
+    }
+    return false;
+  };
+
+  // Candidate for a Gather + segment reduction fusion.
+  const auto is_gather_segment_reduction_candidate = [&]() -> bool {
+    if (SparseSegmentReductionOf(*node_def) == nullptr) return false;
+    if (node_view->NumRegularFanins() < 1) return false;
+    return IsGather(*node_view->GetRegularFanin(0).node_view()->node());
+  };
+
   if (IsMKLEnabled())
     return is_batch_norm_candidate() || is_batch_norm_fusion_candidate() ||
            IsContractionWithAdd(ctx, node_index) ||
            is_act_biasadd_conv_candidate() || IsBiasAdd(*node_def) ||
-           IsTranspose(*node_def);
+           IsTranspose(*node_def) || is_elementwise_tree_candidate() ||
+           is_gather_segment_reduction_candidate();
 
   return is_act_biasadd_conv_candidate() || is_batch_norm_candidate() ||
          is_batch_norm_fusion_candidate() ||
          is_batch_norm_grad_fusion_candidate() ||
          is_matmul_gelu_exact_fusion_candidate() ||
-         is_act_biasadd_matmul_candidate();
+         is_act_biasadd_matmul_candidate() || is_elementwise_tree_candidate() ||
+         is_gather_segment_reduction_candidate();
 }
 }  // namespace
 
@@ -4776,6 +5117,10 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
   RemapperContext ctx(&mutable_item, &status, cpu_layout_conversion_,
                       xla_auto_clustering_on_);
   TF_RETURN_IF_ERROR(status);
+  // XLA fuses elementwise ops by itself.
+  ctx.fuse_elementwise_trees =
+      opt_level_ == RewriterConfig::AGGRESSIVE && !xla_auto_clustering_on_ &&
+      item.optimization_options().allow_non_differentiable_rewrites;
   // Processing graph in reverse-topological sorted order allows to remap
   // longer chains of dependent ops in one pass.
   TF_RETURN_IF_ERROR(
@@ -5108,6 +5453,27 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap trees of elementwise ops into _FusedElementwise, which keeps the
+    // intermediate values in cache.
+    ElementwiseTree elementwise_tree;
+    if (ctx.fuse_elementwise_trees &&
+        FindElementwiseTree(ctx, i, &elementwise_tree)) {
+      TF_RETURN_IF_ERROR(AddFusedElementwiseNode(
+          &ctx, elementwise_tree, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
+    // Remap Gather+SegmentReduction into a SparseSegment reduction of the
+    // gathered params, which does not materialize the gathered rows.
+    GatherWithSegmentReduction gather_with_segment_reduction;
+    if (FindGatherWithSegmentReduction(ctx, i,
+                                       &gather_with_segment_reduction)) {
+      TF_RETURN_IF_ERROR(AddGatherSegmentReductionNodes(
+          &ctx, gather_with_segment_reduction, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
@@ -1764,6 +1764,154 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+TEST_F(RemapperTest, FuseElementwiseTree) {
+  using ::tensorflow::ops::Placeholder;
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto shape = ops::Placeholder::Shape({8, 16});
+  auto x = Placeholder(s.WithOpName("x"), DT_FLOAT, shape);
+  auto y = Placeholder(s.WithOpName("y"), DT_FLOAT, shape);
+  auto two = ops::Const(s.WithOpName("two"), 2.0f, {});
+  auto mul = ops::Mul(s.WithOpName("mul"), x, two);
+  auto add = ops::AddV2(s.WithOpName("add"), mul, y);
+  auto tanh = ops::Tanh(s.WithOpName("tanh"), add);
+  auto square = ops::Square(s.WithOpName("square"), y);
+  auto sub = ops::Sub(s.WithOpName("sub"), tanh, square);
+  // "exp" also feeds another node, so it stays out of the tree.
+  auto exp = ops::Exp(s.WithOpName("exp"), x);
+  auto root = ops::Mul(s.WithOpName("root"), sub, exp);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), root);
+  auto exp_fetch = ops::Identity(s.WithOpName("exp_fetch"), exp);
+
+  auto x_t = GenerateRandomTensor<DT_FLOAT>({8, 16});
+  auto y_t = GenerateRandomTensor<DT_FLOAT>({8, 16});
+  GrapplerItem item;
+  item.fetch = {"fetch", "exp_fetch"};
+  item.feed = {{"x", x_t}, {"y", y_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  // The fusion is only enabled in the aggressive mode.
+  {
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+    for (const NodeDef& node : output.node()) {
+      EXPECT_NE(node.op(), "_FusedElementwise");
+    }
+  }
+
+  Remapper optimizer(RewriterConfig::AGGRESSIVE);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "mul");
+    EXPECT_NE(node.name(), "tanh");
+    EXPECT_NE(node.name(), "sub");
+    if (node.name() == "root") {
+      EXPECT_EQ(node.op(), "_FusedElementwise");
+      EXPECT_THAT(node.input(),
+                  ::testing::UnorderedElementsAre("x", "two", "y", "exp"));
+      EXPECT_EQ(node.attr().at("N").i(), 4);
+      EXPECT_EQ(node.attr().at("fused_ops").list().s_size(), 6);
+      EXPECT_EQ(node.attr().at("fused_ops").list().s(5), "Mul");
+      found++;
+    } else if (node.name() == "exp") {
+      EXPECT_EQ(node.op(), "Exp");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 2);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 2);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 2);
+  test::ExpectClose(tensors[0], tensors_expected[0], 1e-6);
+  test::ExpectClose(tensors[1], tensors_expected[1], 1e-6);
+}
+
+TEST_F(RemapperTest, FuseGatherWithSegmentReduction) {
+  using ::tensorflow::ops::Placeholder;
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto table = Placeholder(s.WithOpName("table"), DT_FLOAT,
+                           ops::Placeholder::Shape({16, 8}));
+  auto ids = ops::Const(s.WithOpName("ids"), {3, 7, 7, 0, 15, 2}, {6});
+  auto axis = ops::Const(s.WithOpName("axis"), 0, {});
+  // A sparse reduction of the gathered rows.
+  auto gather = ops::GatherV2(s.WithOpName("gather"), table, ids, axis);
+  auto indices = ops::Const(s.WithOpName("indices"), {5, 0, 1, 1}, {4});
+  auto sparse_segments =
+      ops::Const(s.WithOpName("sparse_segments"), {0, 0, 1, 2}, {4});
+  auto mean = ops::SparseSegmentMean(s.WithOpName("mean"), gather, indices,
+                                     sparse_segments);
+  // A dense reduction of the gathered rows.
+  auto gather_ids = ops::Const<int64_t>(s.WithOpName("gather_ids"),
+                                       {1, 4, 4, 9, 0, 12}, {6});
+  auto gather_dense = ops::GatherV2(s.WithOpName("gather_dense"), table,
+                                    gather_ids, axis);
+  auto segments = ops::Const(s.WithOpName("segments"), {0, 0, 1, 1, 1, 3}, {6});
+  auto sum = ops::SegmentSum(s.WithOpName("sum"), gather_dense, segments);
+  auto fetch_mean = ops::Identity(s.WithOpName("fetch_mean"), mean);
+  auto fetch_sum = ops::Identity(s.WithOpName("fetch_sum"), sum);
+
+  auto table_t = GenerateRandomTensor<DT_FLOAT>({16, 8});
+  GrapplerItem item;
+  item.fetch = {"fetch_mean", "fetch_sum"};
+  item.feed = {{"table", table_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "gather");
+    EXPECT_NE(node.name(), "gather_dense");
+    if (node.name() == "mean") {
+      EXPECT_EQ(node.op(), "SparseSegmentMean");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "table");
+      EXPECT_EQ(node.input(1), "mean/GatheredIds");
+      EXPECT_EQ(node.input(2), "sparse_segments");
+      EXPECT_EQ(node.attr().at("Tidx").type(), DT_INT32);
+      found++;
+    } else if (node.name() == "mean/GatheredIds") {
+      EXPECT_EQ(node.op(), "GatherV2");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "ids");
+      EXPECT_EQ(node.input(1), "indices");
+      found++;
+    } else if (node.name() == "sum") {
+      EXPECT_EQ(node.op(), "SparseSegmentSum");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "table");
+      EXPECT_EQ(node.input(1), "gather_ids");
+      EXPECT_EQ(node.input(2), "segments");
+      EXPECT_EQ(node.attr().at("Tidx").type(), DT_INT64);
+      EXPECT_EQ(node.attr().at("Tsegmentids").type(), DT_INT32);
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 3);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 2);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 2);
+  test::ExpectClose(tensors[0], tensors_expected[0], 1e-6);
+  test::ExpectClose(tensors[1], tensors_expected[1], 1e-6);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
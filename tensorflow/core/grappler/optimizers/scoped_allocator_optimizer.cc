@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/grappler_item.h"
@@ -136,6 +137,11 @@ Status CheckTypesAndGetShapes(const GraphProperties& graph_properties,
   return OkStatus();
 }
 
+// Returns true if `shape` has a known rank and no unknown dimensions.
+bool IsFullyDefined(const TensorShapeProto& shape) {
+  return !shape.unknown_rank() && TensorShape::IsValid(shape);
+}
+
 // Describes an existing input edge in the graph.
 struct InputDesc {
   NodeDef* from_node_def;
@@ -524,7 +530,8 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
     sa_builder.Attr("id", sa_id);
     sa_builder.Attr("shapes", input_shapes);
     sa_builder.Attr("shape", sa_shape);
-    sa_builder.Attr("expected_call_count", static_cast<int64_t>(ops.size()));
+    sa_builder.Attr("expected_call_count",
+                    static_cast<int64_t>(inputs.size()));
     NodeDef* sa_node = graph->add_node();
     LOG_WARNING_AND_RETURN_IF_ERROR(sa_builder.Finalize(sa_node));
     node_map->AddNode(sa_name, sa_node);
@@ -889,12 +896,191 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
   }
 };
 
+// Rewrites ConcatV2 along dimension 0 so that the producers of its inputs
+// allocate their outputs directly in consecutive fields of one
+// ScopedAllocator backing tensor.  The concat is replaced by a
+// ScopedAllocatorConcat that just outputs the backing tensor reshaped to the
+// concat output shape, removing the copy.  The original node becomes an
+// Identity of it so that its consumers and fetches are unaffected.
+//
+// Because ScopedAllocator pads every field to kAllocatorAlignment, this only
+// applies when every input's size in bytes is a multiple of it.  Concats that
+// don't qualify are left alone rather than abandoning the whole pass.
+class ConcatRewriter : public UnaryElementwiseRewriter {
+ public:
+  ~ConcatRewriter() override {}
+
+  size_t MinGroupSize() const override { return 1; }
+
+  Status Rewrite(ScopedAllocatorOptimizer* sa_opti, int64_t invocation_count,
+                 GraphDef* graph, const string& op_name,
+                 const std::vector<NodeDef*>& ops, bool* applied) override {
+    for (NodeDef* op : ops) {
+      bool op_applied = false;
+      TF_RETURN_IF_ERROR(
+          RewriteConcat(sa_opti, invocation_count, graph, op, &op_applied));
+      *applied |= op_applied;
+    }
+    return OkStatus();
+  }
+
+ private:
+  // Returns OK and fills in the producers of the concatenated inputs of `op`
+  // if they can all be allocated from a single ScopedAllocator, or an error
+  // explaining why not.
+  Status AnalyzeConcat(ScopedAllocatorOptimizer* sa_opti, NodeDef* op,
+                       DataType* dtype, TensorShape* output_shape,
+                       std::vector<TensorShape>* input_shapes,
+                       std::vector<InputDesc>* inputs) {
+    NodeMap* node_map = sa_opti->node_map();
+    int num_inputs;
+    TF_RETURN_IF_ERROR(GetNodeAttr(*op, "T", dtype));
+    TF_RETURN_IF_ERROR(GetNodeAttr(*op, "N", &num_inputs));
+    if (op->device().empty()) {
+      return errors::Aborted("Concat ", op->name(), " is not placed");
+    }
+    if (op->input_size() < num_inputs + 1 ||
+        IsControlInput(op->input(num_inputs))) {
+      return errors::Aborted("Concat ", op->name(), " has too few inputs");
+    }
+
+    const NodeDef* axis_node = node_map->GetNode(op->input(num_inputs));
+    Tensor axis;
+    if (axis_node == nullptr || !IsConstant(*axis_node) ||
+        !axis.FromProto(axis_node->attr().at("value").tensor()) ||
+        axis.NumElements() != 1 ||
+        (axis.dtype() == DT_INT32 ? axis.flat<int32>()(0)
+                                  : axis.flat<int64_t>()(0)) != 0) {
+      return errors::Aborted("Concat ", op->name(),
+                             " is not along a constant dimension 0");
+    }
+
+    const std::vector<OpInfo::TensorProperties>& output_props =
+        graph_properties_->GetOutputProperties(op->name());
+    if (output_props.size() != 1 || !IsFullyDefined(output_props[0].shape())) {
+      return errors::Aborted("Complete shape not known for ", op->name());
+    }
+    *output_shape = TensorShape(output_props[0].shape());
+
+    const int64_t type_size = DataTypeSize(*dtype);
+    if (type_size == 0 || Allocator::kAllocatorAlignment % type_size != 0) {
+      return errors::Aborted("Unsupported type ", DataTypeString(*dtype));
+    }
+    absl::flat_hash_set<string> seen_inputs;
+    for (int i = 0; i < num_inputs; ++i) {
+      const string& input_name = op->input(i);
+      int output_slot = 0;
+      ParseNodeName(input_name, &output_slot);
+      NodeDef* input = node_map->GetNode(input_name);
+      if (input == nullptr) {
+        return errors::Internal("Did not find node ", input_name);
+      }
+      // Each producer output can live in only one field of one
+      // ScopedAllocator, and some ops don't allocate their outputs or must
+      // stay in their own frame.
+      if (!seen_inputs.insert(input_name).second ||
+          sa_opti->repeated_outputs().contains(input_name) ||
+          IsConstant(*input) || IsArg(*input) || ModifiesFrameInfo(*input) ||
+          IsMerge(*input) || IsSwitch(*input) ||
+          input->device() != op->device()) {
+        return errors::Aborted("Input ", input_name, " of ", op->name(),
+                               " cannot be scope allocated");
+      }
+      const std::vector<OpInfo::TensorProperties>& input_props =
+          graph_properties_->GetOutputProperties(input->name());
+      if (output_slot < 0 ||
+          output_slot >= static_cast<int>(input_props.size()) ||
+          input_props[output_slot].dtype() != *dtype ||
+          !IsFullyDefined(input_props[output_slot].shape())) {
+        return errors::Aborted("Complete shape not known for ", input_name);
+      }
+      TensorShape input_shape(input_props[output_slot].shape());
+      if (input_shape.num_elements() * type_size %
+              Allocator::kAllocatorAlignment !=
+          0) {
+        return errors::Aborted("Input ", input_name, " of ", op->name(),
+                               " would be padded in the backing tensor");
+      }
+      input_shapes->push_back(input_shape);
+      inputs->emplace_back(input, output_slot, op);
+    }
+    return CheckExistingScopedAllocator(*inputs);
+  }
+
+  Status RewriteConcat(ScopedAllocatorOptimizer* sa_opti,
+                       int64_t invocation_count, GraphDef* graph, NodeDef* op,
+                       bool* applied) {
+    DataType dtype;
+    TensorShape output_shape;
+    std::vector<TensorShape> input_shapes;
+    std::vector<InputDesc> inputs;
+    Status status = AnalyzeConcat(sa_opti, op, &dtype, &output_shape,
+                                  &input_shapes, &inputs);
+    if (!status.ok()) {
+      VLOG(1) << "Not rewriting " << op->name() << ": " << status;
+      return OkStatus();
+    }
+    NodeMap* node_map = sa_opti->node_map();
+    const string device_name = op->device();
+
+    int sa_id = sa_opti->NewScopedAllocatorId(input_shapes.size());
+    string sa_name =
+        strings::StrCat("scoped_allocator_", sa_id, "_", invocation_count);
+    TensorShape sa_shape({output_shape.num_elements()});
+    TF_RETURN_IF_ERROR(ConstructScopedAllocatorNode(
+        sa_opti, graph, node_map, {op}, device_name, dtype, sa_id, sa_name,
+        input_shapes, inputs, sa_shape));
+
+    string sac_name = strings::StrCat("scoped_allocator_concat_", sa_id, "_",
+                                      invocation_count);
+    std::vector<NodeDefBuilder::NodeOut> sac_inputs;
+    for (const InputDesc& input : inputs) {
+      sac_inputs.emplace_back(input.from_node_def->name(), input.output_slot,
+                              dtype);
+    }
+    NodeDefBuilder sac_builder(sac_name, "_ScopedAllocatorConcat");
+    sac_builder.Device(device_name);
+    sac_builder.Attr("sa_name", sa_name);
+    sac_builder.Attr("id", sa_id);
+    sac_builder.Attr("T", dtype);
+    sac_builder.Attr("shape", output_shape);
+    sac_builder.Attr("reshape", true);
+    sac_builder.Attr("N", static_cast<int>(sac_inputs.size()));
+    sac_builder.Input(NodeDefBuilder::NodeOut(sa_name, 0, dtype));
+    sac_builder.Input(sac_inputs);
+    for (const string& input_name : op->input()) {
+      if (IsControlInput(input_name)) {
+        sac_builder.ControlInput(NodeName(input_name));
+      }
+    }
+    NodeDef* sac_node = graph->add_node();
+    LOG_WARNING_AND_RETURN_IF_ERROR(sac_builder.Finalize(sac_node));
+    node_map->AddNode(sac_name, sac_node);
+    for (const string& input_name : sac_node->input()) {
+      node_map->AddOutput(NodeName(input_name), sac_name);
+    }
+
+    VLOG(1) << "Replacing " << op->name() << " with " << sac_name;
+    node_map->RemoveInputs(op->name());
+    op->set_op("Identity");
+    op->clear_input();
+    op->add_input(sac_name);
+    op->clear_attr();
+    AddNodeAttr("T", dtype, op);
+    node_map->AddOutput(sac_name, op->name());
+    *applied = true;
+    return OkStatus();
+  }
+};
+
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
     RewriterConfig::Toggle opt_level, const ScopedAllocatorOptions& opts)
     : opt_level_(opt_level) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
   Rewriter* r = new UnaryElementwiseRewriter();
   to_delete_.push_back(r);
+  Rewriter* concat_rewriter = new ConcatRewriter();
+  to_delete_.push_back(concat_rewriter);
   if (opts.enable_op_size() == 0) {
     // Opts handled by default:
     for (const auto& op_name : {"CollectiveReduce"}) {
@@ -904,7 +1090,7 @@ ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
   } else {
     for (const auto& op_name : opts.enable_op()) {
       op_name_set_.insert(op_name);
-      rewriters_[op_name] = r;
+      rewriters_[op_name] = op_name == "ConcatV2" ? concat_rewriter : r;
     }
   }
 }
@@ -1127,11 +1313,11 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
                                          &op_name, invocation_count](Tree* t) {
           VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                   << t->depth_ << " of size " << t->nodes_.size();
-          if (t->nodes_.size() > 1) {
+          if (t->nodes_.size() >= rewriter->MinGroupSize()) {
             std::vector<std::vector<NodeDef*>> loop_groups;
             PartitionByLoopStructure(frame_view, t->nodes_, &loop_groups);
             for (auto& lg : loop_groups) {
-              if (lg.size() > 1) {
+              if (lg.size() >= rewriter->MinGroupSize()) {
                 bool applied = false;
                 Status s = OrderNodeSet(&lg);
                 TF_RETURN_IF_ERROR(s);
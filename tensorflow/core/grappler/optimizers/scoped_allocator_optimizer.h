@@ -93,6 +93,9 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
                            const std::vector<NodeDef*>& nodes,
                            bool* applied) = 0;
 
+    // Groups of nodes smaller than this are not passed to Rewrite.
+    virtual size_t MinGroupSize() const { return 2; }
+
     void SetGraphProperties(const GraphProperties& graph_properties) {
       graph_properties_ = &graph_properties;
       CHECK(graph_properties_);
@@ -267,6 +267,44 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     TF_CHECK_OK(s.ToGraphDef(graph_def));
   }
 
+  // Constructs the following graph, where every Const is a float tensor of
+  // shape `input_shape`.
+  //
+  // The intended optimization is to have s1 and s2 allocate from a new
+  // ScopedAllocator whose backing tensor is the output of concat.
+  /*
+        a    b    c
+         \  / \  /
+          s1   s2
+           \   /
+           concat
+             |
+             r
+  */
+  void BuildConcatGraph(GraphDef* graph_def, const TensorShape& input_shape) {
+    Scope s = Scope::NewRootScope();
+    s = s.WithDevice("/job:localhost/replica:0/task:0/device:CPU:0");
+
+    const int64_t n = input_shape.num_elements();
+    std::vector<float> a_values(n), b_values(n), c_values(n);
+    for (int64_t i = 0; i < n; ++i) {
+      a_values[i] = i;
+      b_values[i] = 1.0;
+      c_values[i] = -i;
+    }
+    Output a = ops::Const(s.WithOpName("a"),
+                          test::AsTensor<float>(a_values, input_shape));
+    Output b = ops::Const(s.WithOpName("b"),
+                          test::AsTensor<float>(b_values, input_shape));
+    Output c = ops::Const(s.WithOpName("c"),
+                          test::AsTensor<float>(c_values, input_shape));
+    Output s1 = ops::Add(s.WithOpName("s1"), a, b);
+    Output s2 = ops::Add(s.WithOpName("s2"), b, c);
+    Output concat = ops::Concat(s.WithOpName("concat"), {s1, s2}, 0);
+    Output r = ops::Reshape(s.WithOpName("r"), concat, {-1});
+    TF_CHECK_OK(s.ToGraphDef(graph_def));
+  }
+
   void SetShapes(GraphDef* graph_def) {
     TensorShapeProto shape_proto;
     shape_proto.add_dim()->set_size(2);
@@ -283,7 +321,8 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
   // returns the outputs specified by `output_names` in `outputs`.
   void ExecuteGraph(const GraphDef& graph_def,
                     const std::vector<string>& output_names,
-                    std::vector<Tensor>* outputs) {
+                    std::vector<Tensor>* outputs,
+                    const string& enable_op = "Abs") {
     // Turn off all optimization except the ScopedAllocatorOptimizer
     // to avoid anything that would alter the expected graph input/output,
     // e.g. by constant folding away all calculations.
@@ -297,7 +336,7 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     RewriterConfig* rwcfg = gopt->mutable_rewrite_options();
     rwcfg->clear_optimizers();
     (*rwcfg->add_optimizers()) = "scoped_allocator";
-    rwcfg->mutable_scoped_allocator_opts()->add_enable_op("Abs");
+    rwcfg->mutable_scoped_allocator_opts()->add_enable_op(enable_op);
     std::unique_ptr<Session> session(CreateSession(graph_def, config));
 
     std::vector<std::pair<string, Tensor>> inputs;
@@ -596,6 +635,68 @@ TEST_F(ScopedAllocatorOptimizerTest, ConstInput) {
   }
   EXPECT_EQ(num_identity_ops, 2);
 }
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatRewriteOnly) {
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph, TensorShape({4, 4}));
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("ConcatV2");
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+
+  NodeMap node_map(&optimized_graph);
+  NodeDef* sa_node = ValidateSAControlInput(&optimized_graph, &node_map, "s1");
+  EXPECT_EQ(ValidateSAControlInput(&optimized_graph, &node_map, "s2"),
+            sa_node);
+  NodeDef* concat = nullptr;
+  GetNode(&node_map, "concat", &concat);
+  EXPECT_EQ(concat->op(), "Identity");
+  ASSERT_EQ(concat->input_size(), 1);
+  NodeDef* sac_node = nullptr;
+  GetNode(&node_map, concat->input(0), &sac_node);
+  EXPECT_EQ(sac_node->op(), "_ScopedAllocatorConcat");
+  ASSERT_EQ(sac_node->input_size(), 3);
+  EXPECT_EQ(sac_node->input(0), sa_node->name());
+  EXPECT_EQ(sac_node->input(1), "s1");
+  EXPECT_EQ(sac_node->input(2), "s2");
+}
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatExecute) {
+  GraphDef graph_def;
+  BuildConcatGraph(&graph_def, TensorShape({4, 4}));
+  std::vector<Tensor> outputs;
+  ExecuteGraph(graph_def, /*output_names=*/{"r:0"}, &outputs,
+               /*enable_op=*/"ConcatV2");
+  std::vector<float> expected(32);
+  for (int i = 0; i < 16; ++i) {
+    expected[i] = i + 1;       // a + b
+    expected[16 + i] = 1 - i;  // b + c
+  }
+  ValidateValues(outputs, /*expected=*/{expected});
+}
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatWithPaddedInputsNotRewritten) {
+  // 2x2 floats is smaller than the ScopedAllocator field alignment, so the
+  // backing tensor would not be a plain concatenation of the inputs.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph, TensorShape({2, 2}));
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("ConcatV2");
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+  for (const NodeDef& node : optimized_graph.node()) {
+    EXPECT_NE(node.op(), "_ScopedAllocator");
+    if (node.name() == "concat") {
+      EXPECT_EQ(node.op(), "ConcatV2");
+    }
+  }
+}
 #endif  // ENABLE_MKL
 
 }  // namespace
@@ -25,6 +25,8 @@ limitations under the License.
 #include "absl/base/call_once.h"
 #include "absl/container/fixed_array.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/concat_split_util.h"
 #include "tensorflow/core/kernels/batching_util/input_split_metadata.h"
@@ -65,6 +67,9 @@ class BatchInputTaskHandle : public BatchTask {
   // Returns the size of this task.
   size_t size() const override { return task_size_; }
 
+  // Returns the deadline of the input task.
+  absl::optional<absl::Time> deadline() const override;
+
  private:
   template <typename T>
   friend class internal::BatchInputTaskHandleTestAccess;
@@ -177,6 +182,7 @@ class BatchInputTask
   std::unique_ptr<TaskType> input_task_;
 
   const int input_task_size_ = 0;
+  const absl::optional<absl::Time> input_task_deadline_;
   const int open_batch_remaining_slot_;
 
   const int batch_size_limit_;
@@ -211,6 +217,11 @@ std::unique_ptr<TaskType> BatchInputTaskHandle<TaskType>::GetSplitTask() {
   return batch_input_task_->GetSplitTask(split_id_);
 }
 
+template <typename TaskType>
+absl::optional<absl::Time> BatchInputTaskHandle<TaskType>::deadline() const {
+  return batch_input_task_->input_task_deadline_;
+}
+
 template <typename TaskType>
 BatchInputTask<TaskType>::BatchInputTask(std::unique_ptr<TaskType> input_task,
                                          int open_batch_remaining_slot,
@@ -218,6 +229,7 @@ BatchInputTask<TaskType>::BatchInputTask(std::unique_ptr<TaskType> input_task,
                                          SplitInputFunc split_input_func)
     : input_task_(std::move(input_task)),
       input_task_size_(input_task_->size()),
+      input_task_deadline_(input_task_->deadline()),
       open_batch_remaining_slot_(open_batch_remaining_slot),
       batch_size_limit_(batch_size_limit),
       split_func_(split_input_func),
@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <optional>
 #include <sstream>
@@ -41,7 +42,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/request_cost_accessor_registry.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/ops_util.h"
+#include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/batching_util/batch_timeout_tuner.h"
 #include "tensorflow/core/kernels/batching_util/concat_split_util.h"
 #include "tensorflow/core/kernels/batching_util/warmup.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -62,6 +65,12 @@ namespace tensorflow {
 namespace serving {
 namespace {
 
+// The weight of a new measurement in the moving average of batch costs.
+constexpr double kBatchCostSmoothingFactor = 0.1;
+
+// How often the batch timeout is tuned if batch timeout tuning is enabled.
+constexpr absl::Duration kBatchTimeoutTuningInterval = absl::Seconds(1);
+
 // TODO(b/181883417): Replace with RecordPaddingSizeV2.
 void RecordPaddingSize(int32_t padding_size, const string& model_name,
                        int32_t execution_batch_size, const string& op_name) {
@@ -195,6 +204,15 @@ void RecordBatchDelayUsV2(int64_t batch_delay_us, const string& model_name,
       ->Add(static_cast<double>(batch_delay_us));
 }
 
+void RecordExpiredTask(const string& model_name, const string& op_name) {
+  static auto* cell = monitoring::Counter<2>::New(
+      "/tensorflow/serving/batching/expired_tasks",
+      "Tracks the number of batch tasks dropped because their deadline passed "
+      "before they were processed, by model_name and op_name (if available).",
+      "model_name", "op_name");
+  cell->GetCell(model_name, op_name)->IncrementBy(1);
+}
+
 void RecordBatchParamBatchTimeoutMicros(int64_t batch_timeout_micros,
                                         const string& model_name,
                                         const string& op_name) {
@@ -205,6 +223,17 @@ void RecordBatchParamBatchTimeoutMicros(int64_t batch_timeout_micros,
   cell->GetCell(model_name, op_name)->Set(batch_timeout_micros);
 }
 
+void RecordTunedBatchTimeoutMicros(int64_t batch_timeout_micros,
+                                   const string& model_name,
+                                   const string& op_name) {
+  static auto* cell = monitoring::Gauge<int64_t, 2>::New(
+      "/tensorflow/serving/batching/tuned_batch_timeout_micros",
+      "Tracks the batch timeout picked by batch timeout tuning, by model_name "
+      "(if available) and op_name.",
+      "model_name", "op_name");
+  cell->GetCell(model_name, op_name)->Set(batch_timeout_micros);
+}
+
 void RecordBatchParamMaxBatchSize(int64_t max_batch_size,
                                   const string& model_name,
                                   const string& op_name) {
@@ -258,6 +287,42 @@ const string& GetModelName(OpKernelContext* ctx) {
   return ctx->session_metadata()->name();
 }
 
+// Returns true if every dimension-0 slice of 'tensor' is aligned, so that the
+// slices can share the buffer of 'tensor'.
+bool CanSliceWithoutCopy(const Tensor& tensor) {
+  if (!tensor.IsAligned()) {
+    return false;
+  }
+  switch (tensor.dtype()) {
+#define CASE(T)                  \
+  case DataTypeToEnum<T>::value: \
+    return IsInnerDimsSizeAligned<T>(tensor.shape());
+    TF_CALL_ALL_TYPES(CASE);
+#undef CASE
+    default:
+      return false;
+  }
+}
+
+// Splits 'tensor' along dimension 0 into pieces of 'sizes'. The pieces are
+// slices that share the buffer of 'tensor' when they are aligned, and copies
+// otherwise. Shared pieces keep the whole buffer alive until all of them are
+// released.
+Status SplitBatchedTensor(const Tensor& tensor,
+                          const std::vector<int64_t>& sizes,
+                          std::vector<Tensor>* pieces) {
+  if (!CanSliceWithoutCopy(tensor)) {
+    return tensor::Split(tensor, sizes, pieces);
+  }
+  pieces->reserve(sizes.size());
+  int64_t position = 0;
+  for (const int64_t size : sizes) {
+    pieces->push_back(tensor.Slice(position, position + size));
+    position += size;
+  }
+  return OkStatus();
+}
+
 }  // namespace
 
 std::unique_ptr<BatchResourceBase::BatchTask>
@@ -276,7 +341,9 @@ BatchResourceBase::BatchTask::CreateSplitTask(
   task->status = this->status;
   task->is_partial = true;
   task->start_time = this->start_time;
+  task->request_deadline = this->request_deadline;
   task->request_cost = this->request_cost;
+  task->criticality_val = this->criticality_val;
 
   return task;
 }
@@ -327,11 +394,12 @@ Status BatchResourceBase::RegisterInput(
   TF_ASSIGN_OR_RETURN(std::unique_ptr<BatchTask> batch_components,
                       create_batch_task_fn());
   batch_components->start_time = EnvTime::NowNanos();
+  batch_components->request_deadline = context->deadline();
   batch_components->guid = guid;
   batch_components->propagated_context = Context(ContextKind::kThread);
 
   if (batcher_queue_options_.enable_priority_queue) {
-    batch_components->criticality = tsl::criticality::GetCriticality();
+    batch_components->criticality_val = tsl::criticality::GetCriticality();
   }
 
   OpInputList tensors;
@@ -419,8 +487,9 @@ Status BatchResourceBase::RegisterInput(
   }
 
   BatcherQueueT* batcher_queue;
-  TF_RETURN_IF_ERROR(
-      LookupOrCreateBatcherQueue(batcher_queue_name, &batcher_queue));
+  TF_RETURN_IF_ERROR(LookupOrCreateBatcherQueue(
+      LengthBucketQueueName(batcher_queue_name, *batch_components),
+      &batcher_queue));
 
   if (!session_metadata().name().empty()) {
     absl::MutexLock lock(&outstanding_batch_mu_);
@@ -434,6 +503,8 @@ Status BatchResourceBase::RegisterInput(
     }
     num_outstanding_batched_items_ += batch_components->size();
   }
+  num_registered_tasks_.fetch_add(batch_components->size(),
+                                  std::memory_order_relaxed);
 
   return batcher_queue->Schedule(&batch_components);
 }
@@ -561,6 +632,45 @@ BatchResourceBase::GetAdaptiveBatcherQueueOptions(
   return OkStatus();
 }
 
+/*static*/ std::unique_ptr<BatchResourceBase::BatchT>
+BatchResourceBase::DropExpiredTasks(std::unique_ptr<BatchT> batch) {
+  const absl::Time now = absl::Now();
+  auto is_expired = [now](const BatchTask& task) {
+    return task.request_deadline.has_value() && *task.request_deadline <= now;
+  };
+  bool has_expired_task = false;
+  for (int i = 0; i < batch->num_tasks(); ++i) {
+    if (is_expired(batch->task(i))) {
+      has_expired_task = true;
+      break;
+    }
+  }
+  if (!has_expired_task) {
+    return batch;
+  }
+
+  auto unexpired_batch = std::make_unique<BatchT>(batch->traceme_context_id());
+  for (std::unique_ptr<BatchTask>& task : batch->RemoveAllTasks()) {
+    if (!is_expired(*task)) {
+      unexpired_batch->AddTask(std::move(task));
+      continue;
+    }
+    RecordExpiredTask(GetModelName(task->context),
+                      task->context->op_kernel().name());
+    const Status status = errors::DeadlineExceeded(
+        "The deadline of the request passed before its batch was processed.");
+    WithContext wc(task->propagated_context);
+    if (task->is_partial) {
+      task->status->Update(status);
+    } else {
+      task->context->SetStatus(status);
+    }
+    task->done_callback();
+  }
+  unexpired_batch->Close();
+  return unexpired_batch;
+}
+
 // Returns the smallest entry in 'allowed_batch_sizes_' that is greater than
 // or equal to 'batch_size'. If 'allowed_batch_sizes_' is empty, simply
 // returns 'batch_size'.
@@ -614,6 +724,46 @@ Status BatchResourceBase::ConcatInputTensors(
   const int num_inputs = batch.task(0).inputs.size();
   concatenated_tensors->reserve(num_inputs);
 
+  // With length bucketing, the tasks of a batch may differ in dimension 1 of
+  // their inputs; pads them to the longest task of the batch.
+  std::vector<std::vector<Tensor>> padded_inputs(batch.num_tasks());
+  if (!length_bucket_boundaries_.empty() && !just_for_warmup) {
+    for (int task_idx = 0; task_idx < batch.num_tasks(); ++task_idx) {
+      padded_inputs[task_idx] = batch.task(task_idx).inputs;
+    }
+    for (int i = 0; i < num_inputs; ++i) {
+      if (batch.task(0).inputs.at(i).dims() < 2) {
+        continue;
+      }
+      int64_t max_length = 0;
+      for (int task_idx = 0; task_idx < batch.num_tasks(); ++task_idx) {
+        const Tensor& input = batch.task(task_idx).inputs.at(i);
+        if (input.dims() < 2) {
+          return errors::InvalidArgument(
+              "Batching inputs must have the same rank when length bucketing "
+              "is enabled. (Input ",
+              i, " got shape ", input.shape().DebugString(), ".)");
+        }
+        max_length = std::max(max_length, input.dim_size(1));
+      }
+      for (int task_idx = 0; task_idx < batch.num_tasks(); ++task_idx) {
+        Tensor& input = padded_inputs[task_idx][i];
+        if (input.dim_size(1) < max_length) {
+          Tensor padded_input;
+          TF_RETURN_IF_ERROR(
+              PadSequenceLength(input, max_length, &padded_input));
+          input = std::move(padded_input);
+        }
+      }
+    }
+  }
+  auto task_input = [&](int task_idx, int i) -> const Tensor& {
+    if (!padded_inputs[task_idx].empty()) {
+      return padded_inputs[task_idx][i];
+    }
+    return batch.task(task_idx).inputs.at(i);
+  };
+
   // Process each input one at a time (the typical case has just one). When
   // `just_for_warmup` is true, the real data is not added. Otherwise, the real
   // data is added to the front of each `concatenated_tensor`.
@@ -625,14 +775,14 @@ Status BatchResourceBase::ConcatInputTensors(
     } else {
       to_concatenate.reserve(batch.num_tasks() + padding_amount);
       for (int task_idx = 0; task_idx < batch.num_tasks(); ++task_idx) {
-        to_concatenate.push_back(batch.task(task_idx).inputs.at(i));
+        to_concatenate.push_back(task_input(task_idx, i));
       }
     }
 
     // Add padding as needed if padding is allowed. Use the first row of the
     // first task's tensor as the data for padding.
     if (padding_amount != 0) {
-      const Tensor& padding_source = batch.task(0).inputs.at(i);
+      const Tensor& padding_source = task_input(0, i);
       Tensor padding;
       if (padding_source.shape().dim_size(0) == 0) {
         return errors::InvalidArgument(
@@ -659,6 +809,43 @@ Status BatchResourceBase::ConcatInputTensors(
   return OkStatus();
 }
 
+/*static*/ Status BatchResourceBase::PadSequenceLength(const Tensor& input,
+                                                      int64_t length,
+                                                      Tensor* output) {
+  if (input.dims() < 2 || input.dim_size(1) > length) {
+    return errors::InvalidArgument("Cannot pad input of shape ",
+                                   input.shape().DebugString(),
+                                   " to sequence length ", length, ".");
+  }
+  TensorShape output_shape = input.shape();
+  output_shape.set_dim(1, length);
+  *output = Tensor(input.dtype(), output_shape);
+  const int64_t rows = input.dim_size(0);
+  const int64_t input_length = input.dim_size(1);
+  int64_t inner_size = 1;
+  for (int d = 2; d < input.dims(); ++d) {
+    inner_size *= input.dim_size(d);
+  }
+  switch (input.dtype()) {
+#define CASE(T)                                                           \
+  case DataTypeToEnum<T>::value: {                                        \
+    auto padded = output->shaped<T, 3>({rows, length, inner_size});       \
+    padded.setConstant(T());                                              \
+    const Eigen::DSizes<Eigen::DenseIndex, 3> offsets(0, 0, 0);           \
+    const Eigen::DSizes<Eigen::DenseIndex, 3> extents(rows, input_length, \
+                                                      inner_size);        \
+    padded.slice(offsets, extents) =                                      \
+        input.shaped<T, 3>({rows, input_length, inner_size});             \
+    return OkStatus();                                                    \
+  }
+    TF_CALL_ALL_TYPES(CASE);
+#undef CASE
+    default:
+      return errors::InvalidArgument("Unsupported data type for padding: ",
+                                     DataTypeString(input.dtype()));
+  }
+}
+
 /*static*/ Status BatchResourceBase::SplitInputTask(
     std::unique_ptr<BatchTask>* input_task_ptr, int open_batch_remaining_slot,
     int max_batch_size, std::vector<std::unique_ptr<BatchTask>>* output_tasks) {
@@ -797,7 +984,7 @@ Status BatchResourceBase::SplitOutputTensors(
     }
 
     std::vector<Tensor> split_tensor;
-    const Status split_status = tensor::Split(
+    const Status split_status = SplitBatchedTensor(
         output_tensor, task_sizes_plus_optional_padding, &split_tensor);
     DCHECK(split_status.ok()) << split_status;
     if (!split_status.ok()) {
@@ -828,6 +1015,9 @@ Status BatchResourceBase::SplitOutputTensors(
 }
 
 void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
+  if (batcher_ && batcher_queue_options_.enable_deadline_aware_batching) {
+    batch = DropExpiredTasks(std::move(batch));
+  }
   if (batch->empty()) {
     return;
   }
@@ -857,6 +1047,8 @@ void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
     if (cleanup_done) {
       return;
     }
+    RecordBatchCost(processed_size, batch_cost_measurements);
+    MaybeTuneBatchTimeout(model_name, last_task_context->op_kernel().name());
     SplitBatchCostsAndRecordMetrics(model_name, batch_cost_measurements,
                                     processed_size, *batch);
     // Clear the measurements before unblocking the batch task, as measurements
@@ -932,6 +1124,9 @@ void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
 
 // Processes a batch of one or more BatchTask entries.
 void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
+  if (batcher_ && batcher_queue_options_.enable_deadline_aware_batching) {
+    batch = DropExpiredTasks(std::move(batch));
+  }
   if (batch->empty()) {
     return;
   }
@@ -956,6 +1151,8 @@ void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
   const std::string& model_name = GetModelName(last_task_context);
 
   auto batch_cost_cleanup = gtl::MakeCleanup([&] {
+    RecordBatchCost(processed_size, batch_cost_measurements);
+    MaybeTuneBatchTimeout(model_name, last_task_context->op_kernel().name());
     SplitBatchCostsAndRecordMetrics(model_name, batch_cost_measurements,
                                     processed_size, *batch);
   });
@@ -1039,6 +1236,21 @@ void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
 
 // Looks up the batcher queue for 'queue_name'. If it didn't previously exist,
 // creates it.
+string BatchResourceBase::LengthBucketQueueName(const string& queue_name,
+                                               const BatchTask& task) const {
+  if (length_bucket_boundaries_.empty() || task.inputs.empty() ||
+      task.inputs[0].dims() < 2) {
+    return queue_name;
+  }
+  const int64_t length = task.inputs[0].dim_size(1);
+  auto it = std::lower_bound(length_bucket_boundaries_.begin(),
+                             length_bucket_boundaries_.end(), length);
+  if (it == length_bucket_boundaries_.end()) {
+    --it;
+  }
+  return absl::StrCat(queue_name, "/length_bucket_", *it);
+}
+
 Status BatchResourceBase::LookupOrCreateBatcherQueue(const string& queue_name,
                                                      BatcherQueueT** queue) {
   mutex_lock l(batcher_queues_mu_);
@@ -1062,8 +1274,19 @@ Status BatchResourceBase::LookupOrCreateBatcherQueue(const string& queue_name,
     }
   };
   if (batcher_) {
-    TF_RETURN_IF_ERROR(batcher_->AddQueue(batcher_queue_options_,
-                                          process_batch_callback, &new_queue));
+    BatcherT::QueueOptions queue_options = batcher_queue_options_;
+    if (!queue_options.batch_cost_fn) {
+      queue_options.batch_cost_fn = [this](size_t batch_size) {
+        return EstimatedBatchCostMicros(batch_size);
+      };
+    }
+    if (batch_timeout_tuning_options_.has_value()) {
+      queue_options.batch_timeout_micros_fn = [this]() -> int64_t {
+        return tuned_batch_timeout_micros_.load(std::memory_order_relaxed);
+      };
+    }
+    TF_RETURN_IF_ERROR(
+        batcher_->AddQueue(queue_options, process_batch_callback, &new_queue));
   } else if (adaptive_batcher_) {
     TF_RETURN_IF_ERROR(adaptive_batcher_->AddQueue(
         adaptive_batcher_queue_options_, process_batch_callback, &new_queue));
@@ -1075,6 +1298,91 @@ Status BatchResourceBase::LookupOrCreateBatcherQueue(const string& queue_name,
   return OkStatus();
 }
 
+void BatchResourceBase::RecordBatchCost(
+    int64_t processed_size,
+    const std::vector<std::unique_ptr<CostMeasurement>>&
+        batch_cost_measurements) const {
+  for (const auto& batch_cost_measurement : batch_cost_measurements) {
+    const absl::Duration total_cost = batch_cost_measurement->GetTotalCost();
+    if (total_cost <= absl::ZeroDuration()) {
+      continue;
+    }
+    const double cost_micros = absl::ToDoubleMicroseconds(total_cost);
+    mutex_lock l(batch_costs_mu_);
+    auto [it, inserted] =
+        batch_costs_micros_.emplace(processed_size, cost_micros);
+    if (!inserted) {
+      it->second += kBatchCostSmoothingFactor * (cost_micros - it->second);
+    }
+    // Only the first cost type with a measurement is used.
+    return;
+  }
+}
+
+double BatchResourceBase::EstimatedBatchCostMicros(size_t batch_size) const {
+  const int64_t padded_batch_size = RoundToLowestAllowedBatchSize(batch_size);
+  mutex_lock l(batch_costs_mu_);
+  return EstimateBatchCostMicros(batch_costs_micros_, padded_batch_size)
+      .value_or(static_cast<double>(padded_batch_size));
+}
+
+void BatchResourceBase::EnableBatchTimeoutTuning(
+    int64_t latency_target_micros, int64_t max_batch_timeout_micros) {
+  BatchTimeoutTuningOptions options;
+  options.latency_target_micros = latency_target_micros;
+  options.max_batch_timeout_micros = max_batch_timeout_micros;
+  options.max_batch_size =
+      batcher_queue_options_.enable_large_batch_splitting
+          ? batcher_queue_options_.max_execution_batch_size
+          : batcher_queue_options_.input_batch_size_limit;
+  if (!batcher_queue_options_.disable_padding) {
+    options.allowed_batch_sizes.assign(allowed_batch_sizes_.begin(),
+                                       allowed_batch_sizes_.end());
+  }
+  batch_timeout_tuning_options_ = std::move(options);
+  tuned_batch_timeout_micros_.store(batcher_queue_options_.batch_timeout_micros,
+                                    std::memory_order_relaxed);
+  mutex_lock l(batch_timeout_tuning_mu_);
+  last_batch_timeout_tuning_time_ = absl::Now();
+  num_registered_tasks_at_last_tuning_ = num_registered_tasks_.load();
+}
+
+void BatchResourceBase::MaybeTuneBatchTimeout(const string& model_name,
+                                              const string& op_name) const {
+  if (!batch_timeout_tuning_options_.has_value()) {
+    return;
+  }
+  const absl::Time now = absl::Now();
+  double arrival_rate_per_micro;
+  {
+    mutex_lock l(batch_timeout_tuning_mu_);
+    const absl::Duration elapsed = now - last_batch_timeout_tuning_time_;
+    if (elapsed < kBatchTimeoutTuningInterval) {
+      return;
+    }
+    const int64_t num_registered_tasks = num_registered_tasks_.load();
+    arrival_rate_per_micro =
+        (num_registered_tasks - num_registered_tasks_at_last_tuning_) /
+        absl::ToDoubleMicroseconds(elapsed);
+    last_batch_timeout_tuning_time_ = now;
+    num_registered_tasks_at_last_tuning_ = num_registered_tasks;
+  }
+  std::map<int64_t, double> batch_costs_micros;
+  {
+    mutex_lock l(batch_costs_mu_);
+    batch_costs_micros = batch_costs_micros_;
+  }
+  const std::optional<int64_t> batch_timeout_micros = ChooseBatchTimeoutMicros(
+      *batch_timeout_tuning_options_, arrival_rate_per_micro,
+      batch_costs_micros);
+  if (!batch_timeout_micros.has_value()) {
+    return;
+  }
+  tuned_batch_timeout_micros_.store(*batch_timeout_micros,
+                                    std::memory_order_relaxed);
+  RecordTunedBatchTimeoutMicros(*batch_timeout_micros, model_name, op_name);
+}
+
 void BatchResourceBase::SplitBatchCostsAndRecordMetrics(
     const std::string& model_name,
     const std::vector<std::unique_ptr<CostMeasurement>>&
@@ -16,16 +16,21 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_RESOURCE_BASE_H_
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_RESOURCE_BASE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/strings/str_join.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "tensorflow/core/common_runtime/cost_measurement_registry.h"
 #include "tensorflow/core/common_runtime/request_cost.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -34,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/batching_util/adaptive_shared_batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_timeout_tuner.h"
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/threadsafe_status.h"
 #include "tensorflow/core/platform/context.h"
@@ -95,8 +101,15 @@ class BatchResourceBase : public ResourceBase {
 
     uint64 start_time;
 
+    // The deadline of the request this task belongs to, if any.
+    absl::optional<absl::Time> request_deadline;
+
     size_t size() const override { return inputs[0].shape().dim_size(0); }
 
+    absl::optional<absl::Time> deadline() const override {
+      return request_deadline;
+    }
+
     // Create a split task from this one. The caller needs to setup the inputs
     // of the new task
     std::unique_ptr<BatchTask> CreateSplitTask(
@@ -113,7 +126,12 @@ class BatchResourceBase : public ResourceBase {
     // this task's processing costs.
     RequestCost* request_cost = nullptr;
 
-    tsl::criticality::Criticality criticality;
+    tsl::criticality::Criticality criticality_val =
+        tsl::criticality::Criticality::kCritical;
+
+    tsl::criticality::Criticality criticality() const override {
+      return criticality_val;
+    }
 
     // If nonzero, make a batch of this size entirely out of padding. This
     // batch is processed, but is not propagated to the kernel outputs.
@@ -160,6 +178,31 @@ class BatchResourceBase : public ResourceBase {
 
   const SessionMetadata& session_metadata() const { return session_metadata_; }
 
+  // Enables online tuning of the batch timeout of the queues of this resource.
+  // Must be called before the first input is registered, and only applies to
+  // resources that use a `SharedBatchScheduler`.
+  //
+  // Periodically, the timeout is set to the one that maximizes throughput
+  // while keeping the worst-case latency of a task within
+  // 'latency_target_micros', based on the measured cost of processing each
+  // padded batch size and the rate at which tasks arrive (see
+  // `ChooseBatchTimeoutMicros`). The configured timeout is used until a batch
+  // cost has been measured.
+  void EnableBatchTimeoutTuning(int64_t latency_target_micros,
+                                int64_t max_batch_timeout_micros);
+
+  // Enables length bucketing for variable-length inputs. Each task is enqueued
+  // to a sub-queue of its batcher queue keyed by the smallest boundary that is
+  // greater than or equal to the size of dimension 1 of its first input (or
+  // the largest boundary if there is none), so tasks of similar lengths are
+  // batched together. Within a batch, dimension 1 of every input is padded
+  // with zeros to the longest task of the batch, and outputs keep the padded
+  // length. An empty 'boundaries' disables bucketing.
+  void set_length_bucket_boundaries(std::vector<int64_t> boundaries) {
+    std::sort(boundaries.begin(), boundaries.end());
+    length_bucket_boundaries_ = std::move(boundaries);
+  }
+
   using CreateBatchTaskFn =
       std::function<StatusOr<std::unique_ptr<BatchTask>>()>;
 
@@ -244,6 +287,11 @@ class BatchResourceBase : public ResourceBase {
           batch_cost_measurements,
       int64_t processed_size, BatchT& batch);
 
+  // Pads dimension 1 of 'input' with zeros up to 'length'. REQUIRES: 'input'
+  // has rank 2 or more and dimension 1 is no larger than 'length'.
+  static Status PadSequenceLength(const Tensor& input, int64_t length,
+                                  Tensor* output);
+
  private:
   // Implementation of calling the process batch function.
   virtual void ProcessFuncBatchImpl(
@@ -255,6 +303,11 @@ class BatchResourceBase : public ResourceBase {
   // Assumes the batch is non-empty.
   static Status ValidateBatch(const BatchT& batch);
 
+  // Fails the tasks of 'batch' whose deadline has passed with a
+  // DEADLINE_EXCEEDED error, and returns a batch of the remaining tasks.
+  static std::unique_ptr<BatchT> DropExpiredTasks(
+      std::unique_ptr<BatchT> batch);
+
   // Returns the smallest entry in 'allowed_batch_sizes_' that is greater than
   // or equal to 'batch_size'. If 'allowed_batch_sizes_' is empty, simply
   // returns 'batch_size'.
@@ -286,8 +339,33 @@ class BatchResourceBase : public ResourceBase {
   Status LookupOrCreateBatcherQueue(const string& queue_name,
                                     BatcherQueueT** queue);
 
+  // Records the measured cost of processing a batch of 'processed_size' tasks
+  // (including padding) in 'batch_costs_micros_'.
+  void RecordBatchCost(int64_t processed_size,
+                       const std::vector<std::unique_ptr<CostMeasurement>>&
+                           batch_cost_measurements) const;
+
+  // Returns the estimated cost of processing a batch of 'batch_size' tasks, in
+  // microseconds. Used as the batch cost for weighted fair queuing. Falls back
+  // to the padded batch size until a cost has been measured.
+  double EstimatedBatchCostMicros(size_t batch_size) const;
+
+  // Tunes the batch timeout if batch timeout tuning is enabled and it has not
+  // been tuned for a while.
+  void MaybeTuneBatchTimeout(const string& model_name,
+                             const string& op_name) const;
+
+  // Returns the name of the sub-queue of 'queue_name' for the length bucket of
+  // 'task', or 'queue_name' if length bucketing is disabled.
+  string LengthBucketQueueName(const string& queue_name,
+                               const BatchTask& task) const;
+
   SessionMetadata session_metadata_;
 
+  // Sorted boundaries of the length buckets. Empty if length bucketing is
+  // disabled.
+  std::vector<int64_t> length_bucket_boundaries_;
+
   absl::Mutex outstanding_batch_mu_;
   int num_outstanding_batched_items_ TF_GUARDED_BY(outstanding_batch_mu_) = 0;
 
@@ -301,6 +379,24 @@ class BatchResourceBase : public ResourceBase {
   std::shared_ptr<AdaptiveBatcherT> adaptive_batcher_;
   AdaptiveBatcherT::QueueOptions adaptive_batcher_queue_options_;
 
+  // Moving averages of the measured cost of processing a batch, in
+  // microseconds, keyed on the batch size after padding.
+  mutable mutex batch_costs_mu_;
+  mutable std::map<int64_t, double> batch_costs_micros_
+      TF_GUARDED_BY(batch_costs_mu_);
+
+  // Set iff batch timeout tuning is enabled.
+  std::optional<BatchTimeoutTuningOptions> batch_timeout_tuning_options_;
+  // The batch timeout of the queues if batch timeout tuning is enabled.
+  mutable std::atomic<int64_t> tuned_batch_timeout_micros_{0};
+  // The total size of the tasks registered with this resource.
+  std::atomic<int64_t> num_registered_tasks_{0};
+  mutable mutex batch_timeout_tuning_mu_;
+  mutable absl::Time last_batch_timeout_tuning_time_
+      TF_GUARDED_BY(batch_timeout_tuning_mu_);
+  mutable int64_t num_registered_tasks_at_last_tuning_
+      TF_GUARDED_BY(batch_timeout_tuning_mu_) = 0;
+
   // A collection of batcher queues, keyed on queue name.
   // TODO(olston): Garbage-collect unused queues (perhaps simply remove empty
   // ones (with a time delay?); it's okay if they get recreated later).
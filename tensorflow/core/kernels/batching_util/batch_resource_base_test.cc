@@ -28,7 +28,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/request_cost.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 
 namespace tensorflow {
 namespace serving {
@@ -241,6 +243,34 @@ TEST(SplitBatchCostsAndRecordMetricsTest, SplitOnlyNonZeroCostTypes) {
           UnorderedElementsAre(Pair("test_tpu", absl::Milliseconds(100))))));
 }
 
+TEST(PadSequenceLengthTest, PadsDimensionOneWithZeros) {
+  Tensor input = test::AsTensor<float>({1, 2, 3, 4, 5, 6, 7, 8},
+                                       TensorShape({2, 2, 2}));
+  Tensor padded;
+  TF_ASSERT_OK(BatchResourceBase::PadSequenceLength(input, 3, &padded));
+  test::ExpectTensorEqual<float>(
+      padded, test::AsTensor<float>({1, 2, 3, 4, 0, 0, 5, 6, 7, 8, 0, 0},
+                                    TensorShape({2, 3, 2})));
+}
+
+TEST(PadSequenceLengthTest, PadsEmptySequences) {
+  Tensor input(DT_INT64, TensorShape({2, 0}));
+  Tensor padded;
+  TF_ASSERT_OK(BatchResourceBase::PadSequenceLength(input, 2, &padded));
+  test::ExpectTensorEqual<int64_t>(
+      padded, test::AsTensor<int64_t>({0, 0, 0, 0}, TensorShape({2, 2})));
+}
+
+TEST(PadSequenceLengthTest, InvalidLength) {
+  Tensor padded;
+  EXPECT_FALSE(BatchResourceBase::PadSequenceLength(
+                   Tensor(DT_FLOAT, TensorShape({2, 3})), 2, &padded)
+                   .ok());
+  EXPECT_FALSE(BatchResourceBase::PadSequenceLength(
+                   Tensor(DT_FLOAT, TensorShape({2})), 2, &padded)
+                   .ok());
+}
+
 }  // namespace
 }  // namespace serving
 }  // namespace tensorflow
@@ -34,6 +34,8 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
@@ -42,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tsl/platform/criticality.h"
 
 namespace tensorflow {
 namespace serving {
@@ -64,6 +67,17 @@ class BatchTask {
   // Returns the size of the task, in terms of how much it contributes to the
   // size of a batch. (A batch's size is the sum of its task sizes.)
   virtual size_t size() const = 0;
+
+  // Returns the time by which the task should be processed, or nullopt if the
+  // task has no deadline. Schedulers configured to batch by deadline use it to
+  // decide when to close a batch.
+  virtual absl::optional<absl::Time> deadline() const { return absl::nullopt; }
+
+  // Returns the criticality of the request the task belongs to. Schedulers
+  // configured with priority lanes batch sheddable tasks at a lower priority.
+  virtual tsl::criticality::Criticality criticality() const {
+    return tsl::criticality::Criticality::kCritical;
+  }
 };
 
 // A thread-safe collection of BatchTasks, to be executed together in some
@@ -0,0 +1,124 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_timeout_tuner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+int64_t PaddedBatchSize(const BatchTimeoutTuningOptions& options,
+                        int64_t batch_size) {
+  for (const int32_t allowed_size : options.allowed_batch_sizes) {
+    if (allowed_size >= batch_size) {
+      return allowed_size;
+    }
+  }
+  return batch_size;
+}
+
+// Returns the batch sizes worth considering: every allowed batch size, or the
+// powers of two if batches are not padded, and the maximum batch size.
+std::set<int64_t> CandidateBatchSizes(
+    const BatchTimeoutTuningOptions& options) {
+  std::set<int64_t> batch_sizes = {1, options.max_batch_size};
+  if (options.allowed_batch_sizes.empty()) {
+    for (int64_t size = 2; size < options.max_batch_size; size *= 2) {
+      batch_sizes.insert(size);
+    }
+  }
+  for (const int32_t allowed_size : options.allowed_batch_sizes) {
+    if (allowed_size <= options.max_batch_size) {
+      batch_sizes.insert(allowed_size);
+    }
+  }
+  return batch_sizes;
+}
+
+}  // namespace
+
+std::optional<double> EstimateBatchCostMicros(
+    const std::map<int64_t, double>& batch_costs_micros,
+    int64_t padded_batch_size) {
+  if (batch_costs_micros.empty()) {
+    return std::nullopt;
+  }
+  auto it = batch_costs_micros.lower_bound(padded_batch_size);
+  if (it == batch_costs_micros.end()) {
+    --it;
+  }
+  if (it->first == padded_batch_size || it->first == 0) {
+    return it->second;
+  }
+  return it->second * padded_batch_size / it->first;
+}
+
+std::optional<int64_t> ChooseBatchTimeoutMicros(
+    const BatchTimeoutTuningOptions& options, double arrival_rate_per_micro,
+    const std::map<int64_t, double>& batch_costs_micros) {
+  if (batch_costs_micros.empty()) {
+    return std::nullopt;
+  }
+  const int64_t max_batch_size = std::max<int64_t>(options.max_batch_size, 1);
+  const int64_t max_timeout_micros =
+      std::max<int64_t>(options.max_batch_timeout_micros, 0);
+
+  // (Timeout, expected batch size) pairs to evaluate.
+  std::map<int64_t, int64_t> candidates = {{0, 1}};
+  if (arrival_rate_per_micro > 0) {
+    for (const int64_t batch_size : CandidateBatchSizes(options)) {
+      const double timeout_micros =
+          std::ceil((batch_size - 1) / arrival_rate_per_micro);
+      if (timeout_micros <= max_timeout_micros) {
+        candidates.emplace(static_cast<int64_t>(timeout_micros), batch_size);
+      }
+    }
+    // The longest timeout may not fill any of the candidate batch sizes.
+    const double batch_size_at_max_timeout =
+        std::floor(1 + arrival_rate_per_micro * max_timeout_micros);
+    candidates.emplace(
+        max_timeout_micros,
+        static_cast<int64_t>(std::min<double>(batch_size_at_max_timeout,
+                                              max_batch_size)));
+  }
+
+  int64_t best_timeout_micros = 0;
+  double best_throughput = -1;
+  for (const auto& [timeout_micros, batch_size] : candidates) {
+    const double cost_micros = std::max(
+        *EstimateBatchCostMicros(batch_costs_micros,
+                                 PaddedBatchSize(options, batch_size)),
+        1.0);
+    if (timeout_micros + cost_micros > options.latency_target_micros) {
+      continue;
+    }
+    const double throughput = batch_size / cost_micros;
+    if (throughput > best_throughput) {
+      best_throughput = throughput;
+      best_timeout_micros = timeout_micros;
+    }
+  }
+  return best_timeout_micros;
+}
+
+}  // namespace serving
+}  // namespace tensorflow
@@ -0,0 +1,71 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_TIMEOUT_TUNER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_TIMEOUT_TUNER_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace tensorflow {
+namespace serving {
+
+struct BatchTimeoutTuningOptions {
+  // The target latency of a task, from its arrival until its batch has been
+  // processed, in microseconds.
+  int64_t latency_target_micros = 0;
+
+  // The largest batch timeout the tuner may pick, in microseconds.
+  int64_t max_batch_timeout_micros = 0;
+
+  // The largest batch the queue forms.
+  int64_t max_batch_size = 0;
+
+  // The sizes batches are padded to, in increasing order. If empty, batches
+  // are not padded.
+  std::vector<int32_t> allowed_batch_sizes;
+};
+
+// Returns the estimated cost of processing a batch of `padded_batch_size`
+// tasks from `batch_costs_micros`, which maps measured padded batch sizes to
+// their processing costs. Sizes that have not been measured are scaled
+// linearly from the closest measured size that is at least as large, or from
+// the largest measured size if there is none. Returns `nullopt` if
+// `batch_costs_micros` is empty.
+std::optional<double> EstimateBatchCostMicros(
+    const std::map<int64_t, double>& batch_costs_micros,
+    int64_t padded_batch_size);
+
+// Picks the batch timeout that maximizes the throughput of a queue whose tasks
+// arrive at `arrival_rate_per_micro`, given the measured costs of processing
+// batches in `batch_costs_micros` (see `EstimateBatchCostMicros`).
+//
+// A timeout of T is expected to form batches of about 1 + rate * T tasks
+// (capped at `max_batch_size`), whose first task waits for T plus the time to
+// process the padded batch. The tuner picks the timeout with the highest
+// number of tasks processed per microsecond of batch processing among those
+// whose worst-case latency meets `latency_target_micros`, preferring shorter
+// timeouts on ties. If no timeout meets the target, returns 0 to minimize
+// latency. Returns `nullopt` if no cost has been measured yet.
+std::optional<int64_t> ChooseBatchTimeoutMicros(
+    const BatchTimeoutTuningOptions& options, double arrival_rate_per_micro,
+    const std::map<int64_t, double>& batch_costs_micros);
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_TIMEOUT_TUNER_H_
@@ -0,0 +1,103 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_timeout_tuner.h"
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+BatchTimeoutTuningOptions TuningOptions(int64_t latency_target_micros) {
+  BatchTimeoutTuningOptions options;
+  options.latency_target_micros = latency_target_micros;
+  options.max_batch_timeout_micros = 1000;
+  options.max_batch_size = 32;
+  options.allowed_batch_sizes = {1, 8, 32};
+  return options;
+}
+
+const std::map<int64_t, double>& BatchCosts() {
+  static const auto* costs =
+      new std::map<int64_t, double>({{1, 100}, {8, 120}, {32, 200}});
+  return *costs;
+}
+
+TEST(BatchTimeoutTunerTest, EstimateBatchCostMicros) {
+  EXPECT_EQ(EstimateBatchCostMicros({}, 8), std::nullopt);
+  EXPECT_EQ(EstimateBatchCostMicros(BatchCosts(), 8), 120);
+  // Scaled from the cost of a batch of 8.
+  EXPECT_EQ(EstimateBatchCostMicros(BatchCosts(), 4), 60);
+  // Scaled from the cost of the largest batch.
+  EXPECT_EQ(EstimateBatchCostMicros(BatchCosts(), 64), 400);
+}
+
+TEST(BatchTimeoutTunerTest, NoMeasuredCosts) {
+  EXPECT_EQ(ChooseBatchTimeoutMicros(TuningOptions(500),
+                                     /*arrival_rate_per_micro=*/0.125, {}),
+            std::nullopt);
+}
+
+TEST(BatchTimeoutTunerTest, PicksLargestBatchWithinLatencyTarget) {
+  // Batches of 8 take 56us to fill and batches of 32 take 248us.
+  EXPECT_EQ(ChooseBatchTimeoutMicros(TuningOptions(500),
+                                     /*arrival_rate_per_micro=*/0.125,
+                                     BatchCosts()),
+            248);
+  EXPECT_EQ(ChooseBatchTimeoutMicros(TuningOptions(400),
+                                     /*arrival_rate_per_micro=*/0.125,
+                                     BatchCosts()),
+            56);
+}
+
+TEST(BatchTimeoutTunerTest, UnreachableLatencyTarget) {
+  EXPECT_EQ(ChooseBatchTimeoutMicros(TuningOptions(50),
+                                     /*arrival_rate_per_micro=*/0.125,
+                                     BatchCosts()),
+            0);
+}
+
+TEST(BatchTimeoutTunerTest, NoTraffic) {
+  EXPECT_EQ(ChooseBatchTimeoutMicros(TuningOptions(500),
+                                     /*arrival_rate_per_micro=*/0,
+                                     BatchCosts()),
+            0);
+}
+
+TEST(BatchTimeoutTunerTest, ObeysMaxBatchTimeout) {
+  BatchTimeoutTuningOptions options = TuningOptions(10000);
+  options.max_batch_timeout_micros = 100;
+  // At most 1 + 0.125 * 100 = 13 tasks arrive within the timeout. They would
+  // be padded to a batch of 32, which processes fewer tasks per microsecond
+  // than a full batch of 8.
+  EXPECT_EQ(ChooseBatchTimeoutMicros(options,
+                                     /*arrival_rate_per_micro=*/0.125,
+                                     BatchCosts()),
+            56);
+  options.allowed_batch_sizes.clear();
+  EXPECT_EQ(ChooseBatchTimeoutMicros(options,
+                                     /*arrival_rate_per_micro=*/0.125,
+                                     BatchCosts()),
+            100);
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
@@ -18,14 +18,19 @@ limitations under the License.
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <deque>
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "tensorflow/core/kernels/batching_util/batch_input_task.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
@@ -41,6 +46,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/connected_traceme.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
+#include "tsl/platform/criticality.h"
 
 namespace tensorflow {
 namespace serving {
@@ -81,6 +87,14 @@ namespace serving {
 // BasicBatchScheduler instance, in the sense that it has maximum batch size and
 // timeout parameters, which govern when a batch is eligible to be processed.
 //
+// Alternatively, with `Options::enable_weighted_fair_queuing`, the batch
+// threads serve the queues by weighted fair queuing: each queue is charged the
+// estimated cost of the batches it runs (see `QueueOptions::batch_cost_fn`)
+// divided by its `QueueOptions::scheduling_weight`, and the next batch comes
+// from the queue with the smallest charge that has a batch ready. So a queue
+// with twice the weight of another gets about twice the batch thread time when
+// both are backlogged, regardless of how expensive their batches are.
+//
 // Each queue is independently configured with a maximum size (in terms of the
 // maximum number of batches worth of enqueued tasks). For online serving, it is
 // recommended that the queue sizes be configured such that the sum of the sizes
@@ -97,10 +111,6 @@ namespace serving {
 // For bulk processing jobs and throughput-oriented benchmarks, you may want to
 // set the maximum queue size to a large value.
 //
-// TODO(b/26539183): Support queue servicing policies other than round-robin.
-// E.g. let each queue specify a "share" (an int >= 1), so e.g. with queues A
-// and B having shares 1 and 2 respectively, the servicing pattern is ABBABB...
-//
 //
 // PERFORMANCE TUNING: See README.md.
 //
@@ -125,6 +135,10 @@ class SharedBatchScheduler
     // The environment to use.
     // (Typically only overridden by test code.)
     Env* env = Env::Default();
+
+    // If true, the queues are served by weighted fair queuing instead of
+    // round-robin. See the class documentation above.
+    bool enable_weighted_fair_queuing = false;
   };
   // Ownership is shared between the caller of Create() and any queues created
   // via AddQueue().
@@ -162,6 +176,25 @@ class SharedBatchScheduler
     // avoid latency spikes.
     int64_t batch_timeout_micros = 0;
 
+    // If set, overrides `batch_timeout_micros` with its return value, so that
+    // the timeout can be tuned while the queue is in use. Called with the lock
+    // of the queue held, so it must be cheap and must not call back into the
+    // queue.
+    std::function<int64_t()> batch_timeout_micros_fn;
+
+    // If true, the open batch is closed when its most urgent task runs out of
+    // slack, instead of when `batch_timeout_micros` has elapsed. The slack of a
+    // task is the time left until its deadline (see `BatchTask::deadline()`)
+    // minus `expected_batch_processing_micros`. So a batch closes early if one
+    // of its tasks is about to miss its deadline, and stays open past
+    // `batch_timeout_micros` while all of its tasks have slack. Tasks without a
+    // deadline still close the batch `batch_timeout_micros` after it started.
+    bool enable_deadline_aware_batching = false;
+
+    // The expected time to process a batch, in microseconds. Used iff
+    // `enable_deadline_aware_batching` is true.
+    int64_t expected_batch_processing_micros = 0;
+
     // The maximum allowable number of enqueued (accepted by Schedule() but
     // not yet being processed on a batch thread) tasks in terms of batches.
     // If this limit is reached, Schedule() will return an UNAVAILABLE error.
@@ -224,7 +257,12 @@ class SharedBatchScheduler
     bool disable_padding = false;
 
     // If true, queue implementation would split high priority and low priority
-    // inputs into two sub queues.
+    // inputs into two sub queues. Tasks whose `criticality()` is sheddable are
+    // low priority. Low priority tasks first fill the padding of high priority
+    // batches (see `allowed_batch_sizes`), and form batches of their own only
+    // when no high priority batch is schedulable.
+    //
+    // Not supported, and ignored, if `enable_lazy_split` is true.
     bool enable_priority_queue = false;
 
     // A separate set of queue options for different priority inputs.
@@ -241,8 +279,23 @@ class SharedBatchScheduler
     };
     // A subset of queue options for high priority input.
     PriorityQueueOptions high_priority_queue_options;
-    // A subset of queue options for low priority input.
+    // A subset of queue options for low priority input. Fields left at zero
+    // fall back to the corresponding queue options.
     PriorityQueueOptions low_priority_queue_options;
+
+    // The share of the batch threads the queue gets relative to the other
+    // queues. Must be positive. Used iff
+    // `Options::enable_weighted_fair_queuing` is true.
+    double scheduling_weight = 1.0;
+
+    // Returns the estimated cost of processing a batch of `batch_size` tasks,
+    // e.g. its processing time. The costs of all queues of a scheduler must be
+    // in the same unit. If unset, the cost of a batch is its size. Used iff
+    // `Options::enable_weighted_fair_queuing` is true.
+    //
+    // Called by the scheduler with its lock held, so it must be cheap and must
+    // not call back into the scheduler.
+    std::function<double(size_t batch_size)> batch_cost_fn;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -256,6 +309,13 @@ class SharedBatchScheduler
                               BatchUniquePtr* batch_to_process_out)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // A variant of `GetNextWorkItem_Locked` used iff
+  // `Options::enable_weighted_fair_queuing` is true. Asks the queues for a
+  // batch in the order of their virtual start times.
+  void GetNextWorkItemWeighted_Locked(
+      internal::Queue<TaskType>** queue_for_batch_out,
+      BatchUniquePtr* batch_to_process_out) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // The code executed in 'batch_threads_'. Obtains a batch to process from the
   // queue pointed to by 'next_queue_to_schedule_', and processes it. If that
   // queue declines to provide a batch to process, moves onto the next queue. If
@@ -271,6 +331,9 @@ class SharedBatchScheduler
 
   static bool BatchExists(const BatchUniquePtr& batch_to_process);
 
+  // Returns the total size of the tasks in `batch_to_process`.
+  static size_t BatchSize(const BatchUniquePtr& batch_to_process);
+
   const Options options_;
 
   mutex mu_;
@@ -289,6 +352,17 @@ class SharedBatchScheduler
   // available batch thread should grab work.
   typename QueueList::iterator next_queue_to_schedule_ TF_GUARDED_BY(mu_);
 
+  // The virtual time of weighted fair queuing, i.e. the virtual start time of
+  // the last batch handed to a batch thread. Used iff
+  // `Options::enable_weighted_fair_queuing` is true.
+  double virtual_time_ TF_GUARDED_BY(mu_) = 0;
+
+  // The virtual finish time of the last batch of each queue, i.e. its virtual
+  // start time plus its cost divided by the weight of the queue. Used iff
+  // `Options::enable_weighted_fair_queuing` is true.
+  absl::flat_hash_map<const internal::Queue<TaskType>*, double>
+      virtual_finish_times_ TF_GUARDED_BY(mu_);
+
   // Used by idle batch threads to wait for work to enter the system. Notified
   // whenever a batch becomes schedulable.
   condition_variable schedulable_batch_cv_;
@@ -370,6 +444,17 @@ class Queue {
   // size that's provided by caller of batch scheduler.
   size_t max_execution_batch_size() const { return max_execution_batch_size_; }
 
+  // Returns the weight of the queue in weighted fair queuing.
+  double scheduling_weight() const { return options_.scheduling_weight; }
+
+  // Returns the estimated cost of processing a batch of `batch_size` tasks.
+  double EstimatedBatchCost(size_t batch_size) const {
+    if (options_.batch_cost_fn) {
+      return options_.batch_cost_fn(batch_size);
+    }
+    return static_cast<double>(batch_size);
+  }
+
   // Called by a thread that is ready to process a batch, to request one from
   // this queue. Either returns a batch that is ready to be processed, or
   // nullptr if the queue declines to schedule a batch at this time. If it
@@ -416,6 +501,30 @@ class Queue {
   // fresh open batch behind it.
   void StartNewBatch() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Returns true if `task` goes to the low priority sub queue.
+  bool IsLowPriorityTask(const TaskType& task) const;
+
+  // Enqueues `task` to the low priority sub queue.
+  Status ScheduleLowPriorityTask(std::unique_ptr<TaskType>* task);
+
+  // The effective low priority queue options. See
+  // `QueueOptions.low_priority_queue_options`.
+  size_t low_priority_max_execution_batch_size() const;
+  size_t low_priority_max_enqueued_batches() const;
+
+  // Adds the oldest low priority tasks to `batch`, as long as they fit in its
+  // padding, i.e. up to the smallest allowed batch size that is at least the
+  // size of `batch`.
+  void FillPaddingWithLowPriorityTasks(Batch<TaskType>* batch)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Determines whether the low priority tasks can form a batch now.
+  bool IsLowPriorityBatchSchedulable() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Forms a closed batch of the oldest low priority tasks.
+  std::unique_ptr<Batch<TaskType>> FormLowPriorityBatch()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Split `input task` into `output_tasks` according to 'task_sizes'.
   Status SplitInputBatchIntoSubtasks(
       std::unique_ptr<TaskType>* input_task,
@@ -431,6 +540,18 @@ class Queue {
   bool IsOpenBatchSchedulableAfterEagerSplit() const
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Returns the current batch timeout of the queue, in microseconds.
+  int64_t BatchTimeoutMicros() const;
+
+  // Returns the time at which the open batch should be closed even if it is
+  // not full.
+  uint64 OpenBatchCloseTimeMicros() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Accounts for the deadline of `task`, which is being added to the open
+  // batch, in `open_batch_close_time_micros_`.
+  void UpdateOpenBatchCloseTime(const BatchTask& task)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Same as SchedulingCapacity(), but assumes the caller already holds a
   // lock on 'mu_'.
   size_t SchedulingCapacityInternal() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -489,14 +610,17 @@ class Queue {
   std::deque<std::unique_ptr<Batch<BatchInputTaskHandle<TaskType>>>>
       task_handle_batches_ TF_GUARDED_BY(mu_);
 
-  // The enqueued batches for low priority input.
-  // Each element corresponds to a task to be dequeued and processed by
-  // `Queue<TaskType>::ProcessBatch`.
+  // The enqueued low priority tasks, oldest first, each with the time at which
+  // it was enqueued.
   //
-  // Used iff `QueueOptions.enable_lazy_split` is false.
-  std::deque<std::unique_ptr<Batch<TaskType>>> low_priority_batches_
+  // Used iff `QueueOptions.enable_priority_queue` is true and
+  // `QueueOptions.enable_lazy_split` is false.
+  std::deque<std::pair<std::unique_ptr<TaskType>, uint64>> low_priority_tasks_
       TF_GUARDED_BY(mu_);
 
+  // The sum of the sizes of the tasks in `low_priority_tasks_`.
+  size_t low_priority_tasks_size_ TF_GUARDED_BY(mu_) = 0;
+
   // The enqueued batches for high priority input.
   // Each element corresponds to a task to be dequeued and processed by
   // `Queue<TaskType>::ProcessBatch`.
@@ -513,6 +637,12 @@ class Queue {
   // task.
   uint64 open_batch_start_time_micros_ TF_GUARDED_BY(mu_);
 
+  // The time at which the open batch must be closed so that none of its tasks
+  // misses its deadline. Used iff `QueueOptions.enable_deadline_aware_batching`
+  // is true, and valid iff the open batch contains at least one task.
+  uint64 open_batch_close_time_micros_ TF_GUARDED_BY(mu_) =
+      std::numeric_limits<uint64>::max();
+
   // Whether this queue contains a batch that is eligible to be scheduled.
   // Used to keep track of when to call 'schedulable_batch_callback_'.
   bool schedulable_batch_ TF_GUARDED_BY(mu_) = false;
@@ -634,6 +764,15 @@ Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  if (options.expected_batch_processing_micros < 0) {
+    return errors::InvalidArgument(
+        "expected_batch_processing_micros must be non-negative; was ",
+        options.expected_batch_processing_micros);
+  }
+  if (!(options.scheduling_weight > 0)) {
+    return errors::InvalidArgument("scheduling_weight must be positive; was ",
+                                   options.scheduling_weight);
+  }
 
   if (options.enable_large_batch_splitting &&
       options.split_input_task_func == nullptr) {
@@ -705,10 +844,23 @@ bool SharedBatchScheduler<TaskType>::BatchExists(
   return absl::get<BatchTaskHandleUniquePtr>(batch_to_process) != nullptr;
 }
 
+template <typename TaskType>
+size_t SharedBatchScheduler<TaskType>::BatchSize(
+    const BatchUniquePtr& batch_to_process) {
+  if (absl::holds_alternative<BatchTaskUniqueptr>(batch_to_process)) {
+    return absl::get<BatchTaskUniqueptr>(batch_to_process)->size();
+  }
+  return absl::get<BatchTaskHandleUniquePtr>(batch_to_process)->size();
+}
+
 template <typename TaskType>
 void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     internal::Queue<TaskType>** queue_for_batch_out,
     BatchUniquePtr* batch_to_process_out) {
+  if (options_.enable_weighted_fair_queuing) {
+    GetNextWorkItemWeighted_Locked(queue_for_batch_out, batch_to_process_out);
+    return;
+  }
   BatchUniquePtr batch_to_process;
   internal::Queue<TaskType>* queue_for_batch = nullptr;
   const int num_queues = queues_.size();
@@ -748,6 +900,58 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
   *batch_to_process_out = std::move(batch_to_process);
 }
 
+template <typename TaskType>
+void SharedBatchScheduler<TaskType>::GetNextWorkItemWeighted_Locked(
+    internal::Queue<TaskType>** queue_for_batch_out,
+    BatchUniquePtr* batch_to_process_out) {
+  // The virtual start time of the next batch of a queue is the virtual finish
+  // time of its last batch, or the current virtual time if the queue has been
+  // idle since. (The latter keeps an idle queue from saving up credit.)
+  std::vector<std::pair<double, typename QueueList::iterator>> candidates;
+  candidates.reserve(queues_.size());
+  for (auto it = queues_.begin(); it != queues_.end(); ++it) {
+    auto finish_time = virtual_finish_times_.find(it->get());
+    candidates.emplace_back(finish_time == virtual_finish_times_.end()
+                                ? virtual_time_
+                                : std::max(finish_time->second, virtual_time_),
+                            it);
+  }
+  std::stable_sort(
+      candidates.begin(), candidates.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  BatchUniquePtr batch_to_process;
+  internal::Queue<TaskType>* queue_for_batch = nullptr;
+  for (const auto& [start_time, it] : candidates) {
+    // See `GetNextWorkItem_Locked` for why closedness is checked first.
+    const bool queue_closed = (*it)->closed();
+    batch_to_process = (*it)->ScheduleBatch();
+    if (BatchExists(batch_to_process)) {
+      queue_for_batch = it->get();
+      virtual_time_ = start_time;
+      virtual_finish_times_[queue_for_batch] =
+          start_time +
+          queue_for_batch->EstimatedBatchCost(BatchSize(batch_to_process)) /
+              queue_for_batch->scheduling_weight();
+      break;
+    }
+    if (queue_closed && (*it)->IsEmpty()) {
+      // We've encountered a closed queue with no work to do. Drop it.
+      virtual_finish_times_.erase(it->get());
+      if (next_queue_to_schedule_ == it) {
+        next_queue_to_schedule_ = queues_.erase(it);
+      } else {
+        queues_.erase(it);
+      }
+      if (next_queue_to_schedule_ == queues_.end()) {
+        next_queue_to_schedule_ = queues_.begin();
+      }
+    }
+  }
+  *queue_for_batch_out = queue_for_batch;
+  *batch_to_process_out = std::move(batch_to_process);
+}
+
 template <typename TaskType>
 void SharedBatchScheduler<TaskType>::ThreadLogic() {
   // A batch to process next (or nullptr if no work to do).
@@ -845,9 +1049,86 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
   if (options_.enable_lazy_split) {
     return ScheduleWithLazySplit(std::move(task));
   }
+  if (IsLowPriorityTask(**task)) {
+    return ScheduleLowPriorityTask(task);
+  }
   return ScheduleWithoutOrEagerSplit(std::move(task));
 }
 
+template <typename TaskType>
+bool Queue<TaskType>::IsLowPriorityTask(const TaskType& task) const {
+  if (!options_.enable_priority_queue) {
+    return false;
+  }
+  const tsl::criticality::Criticality criticality = task.criticality();
+  return criticality == tsl::criticality::Criticality::kSheddable ||
+         criticality == tsl::criticality::Criticality::kSheddablePlus;
+}
+
+template <typename TaskType>
+size_t Queue<TaskType>::low_priority_max_execution_batch_size() const {
+  const size_t max_execution_batch_size =
+      options_.low_priority_queue_options.max_execution_batch_size;
+  return max_execution_batch_size > 0 ? max_execution_batch_size
+                                      : max_execution_batch_size_;
+}
+
+template <typename TaskType>
+size_t Queue<TaskType>::low_priority_max_enqueued_batches() const {
+  const size_t max_enqueued_batches =
+      options_.low_priority_queue_options.max_enqueued_batches;
+  return max_enqueued_batches > 0 ? max_enqueued_batches
+                                  : options_.max_enqueued_batches;
+}
+
+template <typename TaskType>
+Status Queue<TaskType>::ScheduleLowPriorityTask(
+    std::unique_ptr<TaskType>* task) {
+  profiler::TraceMe trace_me([task] {
+    return profiler::TraceMeEncode(
+        "ScheduleLowPriorityTask",
+        {{"batching_input_task_size", (*task)->size()}});
+  });
+
+  bool notify_of_schedulable_batch = false;
+  {
+    mutex_lock l(mu_);
+
+    DCHECK(!closed_);
+
+    const size_t max_batch_size = low_priority_max_execution_batch_size();
+    const size_t task_size = (*task)->size();
+    if (task_size > max_batch_size) {
+      return errors::InvalidArgument(
+          "Low priority task size ", task_size,
+          " is larger than maximum low priority batch size ", max_batch_size);
+    }
+    if (low_priority_tasks_size_ + task_size >
+        low_priority_max_enqueued_batches() * max_batch_size) {
+      return errors::Unavailable(
+          "The low priority batch scheduling queue to which this task was "
+          "submitted is full; ",
+          low_priority_tasks_.size(), " tasks of total size ",
+          low_priority_tasks_size_,
+          " are enqueued and max_enqueued_batches is ",
+          low_priority_max_enqueued_batches());
+    }
+    low_priority_tasks_size_ += task_size;
+    low_priority_tasks_.emplace_back(std::move(*task), env_->NowMicros());
+
+    if (!schedulable_batch_ && IsLowPriorityBatchSchedulable()) {
+      schedulable_batch_ = true;
+      notify_of_schedulable_batch = true;
+    }
+  }
+
+  if (notify_of_schedulable_batch) {
+    schedulable_batch_callback_();
+  }
+
+  return OkStatus();
+}
+
 template <typename TaskType>
 Status Queue<TaskType>::ScheduleWithLazySplit(std::unique_ptr<TaskType>* task) {
   profiler::TraceMe trace_me([task] {
@@ -883,7 +1164,9 @@ Status Queue<TaskType>::ScheduleWithLazySplit(std::unique_ptr<TaskType>* task) {
       }
       if (task_handle_batches_.back()->empty()) {
         open_batch_start_time_micros_ = env_->NowMicros();
+        open_batch_close_time_micros_ = std::numeric_limits<uint64>::max();
       }
+      UpdateOpenBatchCloseTime(*task_handles[i]);
       profiler::TraceMeProducer trace_me(
           [&task_handles, i] {
             return profiler::TraceMeEncode("ScheduleOutputTask",
@@ -961,7 +1244,9 @@ Status Queue<TaskType>::ScheduleWithoutOrEagerSplit(
       }
       if (batches.back()->empty()) {
         open_batch_start_time_micros_ = env_->NowMicros();
+        open_batch_close_time_micros_ = std::numeric_limits<uint64>::max();
       }
+      UpdateOpenBatchCloseTime(*output_tasks[i]);
       profiler::TraceMeProducer trace_me(
           [&output_tasks, i] {
             return profiler::TraceMeEncode("ScheduleOutputTask",
@@ -1001,7 +1286,7 @@ size_t Queue<TaskType>::NumEnqueuedTasks() const {
   for (const auto& batch : GetBatches()) {
     num_enqueued_tasks += batch->num_tasks();
   }
-  return num_enqueued_tasks;
+  return num_enqueued_tasks + low_priority_tasks_.size();
 }
 
 template <typename TaskType>
@@ -1086,6 +1371,11 @@ Queue<TaskType>::ScheduleBatchWithEagerSplit() {
       ++num_batches_being_processed_;
       batch_to_schedule = std::move(batches.front());
       batches.pop_front();
+    } else if (IsLowPriorityBatchSchedulable()) {
+      // Low priority tasks are batched only if there is no high priority
+      // batch to schedule.
+      ++num_batches_being_processed_;
+      batch_to_schedule = FormLowPriorityBatch();
     } else {
       schedulable_batch_ = false;
     }
@@ -1178,7 +1468,7 @@ bool Queue<TaskType>::IsEmptyInternal() const {
   }
   const std::deque<std::unique_ptr<Batch<TaskType>>>& batches = GetBatches();
   return num_batches_being_processed_ == 0 && batches.size() == 1 &&
-         batches.back()->empty();
+         batches.back()->empty() && low_priority_tasks_.empty();
 }
 
 template <typename TaskType>
@@ -1190,10 +1480,62 @@ void Queue<TaskType>::StartNewBatch() {
     return;
   }
   std::deque<std::unique_ptr<Batch<TaskType>>>& batches = GetBatches();
+  FillPaddingWithLowPriorityTasks(batches.back().get());
   batches.back()->Close();
   batches.emplace_back(new Batch<TaskType>(++traceme_context_id_counter_));
 }
 
+template <typename TaskType>
+void Queue<TaskType>::FillPaddingWithLowPriorityTasks(Batch<TaskType>* batch) {
+  if (low_priority_tasks_.empty() || batch->empty() ||
+      options_.disable_padding) {
+    return;
+  }
+  size_t padded_batch_size = batch->size();
+  for (const int32 allowed_batch_size : options_.allowed_batch_sizes) {
+    if (allowed_batch_size >= batch->size()) {
+      padded_batch_size = std::min<size_t>(allowed_batch_size,
+                                           max_execution_batch_size());
+      break;
+    }
+  }
+  while (!low_priority_tasks_.empty() &&
+         batch->size() + low_priority_tasks_.front().first->size() <=
+             padded_batch_size) {
+    low_priority_tasks_size_ -= low_priority_tasks_.front().first->size();
+    batch->AddTask(std::move(low_priority_tasks_.front().first));
+    low_priority_tasks_.pop_front();
+  }
+}
+
+template <typename TaskType>
+bool Queue<TaskType>::IsLowPriorityBatchSchedulable() const {
+  if (low_priority_tasks_.empty()) {
+    return false;
+  }
+  return closed_ ||
+         low_priority_tasks_size_ >= low_priority_max_execution_batch_size() ||
+         env_->NowMicros() >=
+             low_priority_tasks_.front().second +
+                 options_.low_priority_queue_options.batch_timeout_micros;
+}
+
+template <typename TaskType>
+std::unique_ptr<Batch<TaskType>> Queue<TaskType>::FormLowPriorityBatch() {
+  auto batch =
+      std::make_unique<Batch<TaskType>>(++traceme_context_id_counter_);
+  const size_t max_batch_size = low_priority_max_execution_batch_size();
+  while (!low_priority_tasks_.empty() &&
+         batch->size() + low_priority_tasks_.front().first->size() <=
+             max_batch_size) {
+    low_priority_tasks_size_ -= low_priority_tasks_.front().first->size();
+    batch->AddTask(std::move(low_priority_tasks_.front().first));
+    low_priority_tasks_.pop_front();
+  }
+  batch->Close();
+  return batch;
+}
+
 template <typename TaskType>
 Status Queue<TaskType>::SplitInputBatchIntoSubtasks(
     std::unique_ptr<TaskType>* input_task,
@@ -1212,8 +1554,7 @@ bool Queue<TaskType>::IsOpenBatchSchedulableAfterEagerSplit() const {
     return false;
   }
   return closed_ || open_batch->size() >= max_execution_batch_size() ||
-         env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+         env_->NowMicros() >= OpenBatchCloseTimeMicros();
 }
 
 template <typename TaskType>
@@ -1227,8 +1568,43 @@ bool Queue<TaskType>::IsOpenBatchSchedulable() const {
     return false;
   }
   return closed_ || open_batch->size() >= max_execution_batch_size() ||
-         env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+         env_->NowMicros() >= OpenBatchCloseTimeMicros();
+}
+
+template <typename TaskType>
+uint64 Queue<TaskType>::OpenBatchCloseTimeMicros() const {
+  if (options_.enable_deadline_aware_batching) {
+    return open_batch_close_time_micros_;
+  }
+  return open_batch_start_time_micros_ + BatchTimeoutMicros();
+}
+
+template <typename TaskType>
+int64_t Queue<TaskType>::BatchTimeoutMicros() const {
+  if (options_.batch_timeout_micros_fn) {
+    return std::max<int64_t>(options_.batch_timeout_micros_fn(), 0);
+  }
+  return options_.batch_timeout_micros;
+}
+
+template <typename TaskType>
+void Queue<TaskType>::UpdateOpenBatchCloseTime(const BatchTask& task) {
+  if (!options_.enable_deadline_aware_batching) {
+    return;
+  }
+  uint64 task_close_time_micros =
+      open_batch_start_time_micros_ + BatchTimeoutMicros();
+  const absl::optional<absl::Time> deadline = task.deadline();
+  if (deadline.has_value()) {
+    // The latest time at which processing can start without missing the
+    // deadline.
+    task_close_time_micros = std::max<int64_t>(
+        absl::ToUnixMicros(*deadline) -
+            options_.expected_batch_processing_micros,
+        0);
+  }
+  open_batch_close_time_micros_ =
+      std::min(open_batch_close_time_micros_, task_close_time_micros);
 }
 
 template <typename TaskType>
@@ -15,26 +15,31 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT(build/c++11)
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "absl/base/call_once.h"
 #include "absl/container/fixed_array.h"
 #include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "tensorflow/core/kernels/batching_util/fake_clock_env.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
+#include "tsl/platform/criticality.h"
 
 namespace tensorflow {
 namespace serving {
@@ -44,14 +49,26 @@ using ::testing::HasSubstr;
 
 class FakeTask : public BatchTask {
  public:
-  explicit FakeTask(size_t size) : size_(size) {}
+  explicit FakeTask(size_t size,
+                    absl::optional<absl::Time> deadline = absl::nullopt,
+                    tsl::criticality::Criticality criticality =
+                        tsl::criticality::Criticality::kCritical)
+      : size_(size), deadline_(deadline), criticality_(criticality) {}
 
   ~FakeTask() override = default;
 
   size_t size() const override { return size_; }
 
+  absl::optional<absl::Time> deadline() const override { return deadline_; }
+
+  tsl::criticality::Criticality criticality() const override {
+    return criticality_;
+  }
+
  private:
   const size_t size_;
+  const absl::optional<absl::Time> deadline_;
+  const tsl::criticality::Criticality criticality_;
 
   FakeTask(const FakeTask&) = delete;
   void operator=(const FakeTask&) = delete;
@@ -75,6 +92,28 @@ Status ScheduleTask(size_t task_size, BatchScheduler<FakeTask>* scheduler) {
   return status;
 }
 
+// Like `ScheduleTask`, but the task has a deadline `deadline_micros` on the
+// clock of `env`.
+Status ScheduleTaskWithDeadline(size_t task_size, uint64 deadline_micros,
+                                BatchScheduler<FakeTask>* scheduler) {
+  std::unique_ptr<FakeTask> task(
+      new FakeTask(task_size, absl::FromUnixMicros(deadline_micros)));
+  Status status = scheduler->Schedule(&task);
+  CHECK_EQ(status.ok(), task == nullptr);
+  return status;
+}
+
+// Like `ScheduleTask`, but the task is sheddable.
+Status ScheduleSheddableTask(size_t task_size,
+                             BatchScheduler<FakeTask>* scheduler) {
+  std::unique_ptr<FakeTask> task(
+      new FakeTask(task_size, /*deadline=*/absl::nullopt,
+                   tsl::criticality::Criticality::kSheddable));
+  Status status = scheduler->Schedule(&task);
+  CHECK_EQ(status.ok(), task == nullptr);
+  return status;
+}
+
 // Creates a thread that waits on 'start' and then advances the fake clock in
 // 'env' in a loop until 'stop' is notified. Useful for allowing objects that
 // use the clock to be destroyed.
@@ -399,6 +438,44 @@ TEST_P(SharedBatchSchedulerTest, ObeysTimeout) {
   stop_teardown.Notify();
 }
 
+TEST_P(SharedBatchSchedulerTest, ObeysBatchTimeoutFn) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Notification batch_processed;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      batch_processed.Notify();
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    QueueOptions options =
+        CreateQueueOptions(/*max_execution_batch_size=*/4,
+                           /*input_batch_size_limit=*/4,
+                           /*batch_timeout_micros=*/10,
+                           /*max_enqueued_batches=*/2);
+    std::atomic<int64_t> batch_timeout_micros{100};
+    options.batch_timeout_micros_fn = [&batch_timeout_micros]() -> int64_t {
+      return batch_timeout_micros.load();
+    };
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    // The timeout returned by `batch_timeout_micros_fn` overrides the
+    // configured one, and takes effect while the batch is open.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    env.AdvanceByMicroseconds(20);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(batch_processed.HasBeenNotified());
+    batch_timeout_micros = 20;
+    batch_processed.WaitForNotification();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
 TEST_P(SharedBatchSchedulerTest, ObeysTimeoutWithRealClock) {
   Notification first_batch_processed, second_batch_processed;
   auto callback = [&first_batch_processed, &second_batch_processed](
@@ -480,6 +557,93 @@ TEST_P(SharedBatchSchedulerTest,
   stop_teardown.Notify();
 }
 
+TEST_P(SharedBatchSchedulerTest, DeadlineAwareBatchingClosesBatchEarly) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Notification batch_processed;
+    bool expect_batch = false;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      EXPECT_TRUE(expect_batch) << "Batch closed too early";
+      EXPECT_EQ(batch->size(), 2);
+      batch_processed.Notify();
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    QueueOptions options =
+        CreateQueueOptions(/*max_execution_batch_size=*/10,
+                           /*input_batch_size_limit=*/10,
+                           /*batch_timeout_micros=*/1000,
+                           /*max_enqueued_batches=*/2);
+    options.enable_deadline_aware_batching = true;
+    options.expected_batch_processing_micros = 5;
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    // The second task has the earliest deadline, so its slack runs out at
+    // time 15.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    TF_ASSERT_OK(
+        ScheduleTaskWithDeadline(1, env.NowMicros() + 20, queue.get()));
+    env.AdvanceByMicroseconds(14);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(batch_processed.HasBeenNotified());
+    expect_batch = true;
+    env.AdvanceByMicroseconds(1);
+    batch_processed.WaitForNotification();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, DeadlineAwareBatchingLingersWithSlack) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Notification batch_processed;
+    bool expect_batch = false;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      EXPECT_TRUE(expect_batch) << "Batch closed too early";
+      EXPECT_EQ(batch->size(), 3);
+      batch_processed.Notify();
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    QueueOptions options =
+        CreateQueueOptions(/*max_execution_batch_size=*/10,
+                           /*input_batch_size_limit=*/10,
+                           /*batch_timeout_micros=*/10,
+                           /*max_enqueued_batches=*/2);
+    options.enable_deadline_aware_batching = true;
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    // All tasks have slack well past the batch timeout, so the batch keeps
+    // accumulating tasks until the earliest deadline.
+    const uint64 start_micros = env.NowMicros();
+    TF_ASSERT_OK(ScheduleTaskWithDeadline(1, start_micros + 100, queue.get()));
+    env.AdvanceByMicroseconds(50);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    TF_ASSERT_OK(ScheduleTaskWithDeadline(2, start_micros + 200, queue.get()));
+    env.AdvanceByMicroseconds(49);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(batch_processed.HasBeenNotified());
+    expect_batch = true;
+    env.AdvanceByMicroseconds(1);
+    batch_processed.WaitForNotification();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
 TEST_P(SharedBatchSchedulerTest, Fairness) {
   test_util::FakeClockEnv env(Env::Default());
   Notification start_teardown, stop_teardown;
@@ -547,6 +711,189 @@ TEST_P(SharedBatchSchedulerTest, Fairness) {
   stop_teardown.Notify();
 }
 
+TEST_P(SharedBatchSchedulerTest, WeightedFairQueuing) {
+  mutex mu;
+  std::vector<std::string> processed_batches;
+  Notification first_batch_scheduled, first_batch_proceed;
+  auto make_callback = [&](const std::string& label) {
+    return [&, label](std::unique_ptr<Batch<FakeTask>> batch) {
+      {
+        mutex_lock l(mu);
+        processed_batches.push_back(label);
+      }
+      if (!first_batch_scheduled.HasBeenNotified()) {
+        first_batch_scheduled.Notify();
+        first_batch_proceed.WaitForNotification();
+      }
+    };
+  };
+
+  {
+    Scheduler::Options options;
+    options.num_batch_threads = 1;
+    options.enable_weighted_fair_queuing = true;
+    std::shared_ptr<Scheduler> scheduler;
+    TF_ASSERT_OK(Scheduler::Create(options, &scheduler));
+
+    QueueOptions queue_options =
+        CreateQueueOptions(/*max_execution_batch_size=*/1,
+                           /*input_batch_size_limit=*/1,
+                           /*batch_timeout_micros=*/0,
+                           /*max_enqueued_batches=*/10);
+    queue_options.scheduling_weight = 2;
+    std::unique_ptr<Queue> queue_a =
+        CreateQueue(scheduler, queue_options, make_callback("a"));
+    queue_options.scheduling_weight = 1;
+    std::unique_ptr<Queue> queue_b =
+        CreateQueue(scheduler, queue_options, make_callback("b"));
+
+    // Blocks the only batch thread so that both queues are backlogged.
+    TF_ASSERT_OK(ScheduleTask(1, queue_a.get()));
+    first_batch_scheduled.WaitForNotification();
+    for (int i = 0; i < 3; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, queue_a.get()));
+      TF_ASSERT_OK(ScheduleTask(1, queue_b.get()));
+    }
+    first_batch_proceed.Notify();
+  }
+
+  // Queue "a" has twice the weight of queue "b", so it runs two batches for
+  // each batch of queue "b" while both are backlogged.
+  EXPECT_THAT(processed_batches,
+              testing::ElementsAre("a", "b", "a", "a", "b", "a", "b"));
+}
+
+TEST_P(SharedBatchSchedulerTest, WeightedFairQueuingUsesBatchCosts) {
+  mutex mu;
+  std::vector<std::string> processed_batches;
+  Notification first_batch_scheduled, first_batch_proceed;
+  auto make_callback = [&](const std::string& label) {
+    return [&, label](std::unique_ptr<Batch<FakeTask>> batch) {
+      {
+        mutex_lock l(mu);
+        processed_batches.push_back(label);
+      }
+      if (!first_batch_scheduled.HasBeenNotified()) {
+        first_batch_scheduled.Notify();
+        first_batch_proceed.WaitForNotification();
+      }
+    };
+  };
+
+  {
+    Scheduler::Options options;
+    options.num_batch_threads = 1;
+    options.enable_weighted_fair_queuing = true;
+    std::shared_ptr<Scheduler> scheduler;
+    TF_ASSERT_OK(Scheduler::Create(options, &scheduler));
+
+    QueueOptions queue_options =
+        CreateQueueOptions(/*max_execution_batch_size=*/1,
+                           /*input_batch_size_limit=*/1,
+                           /*batch_timeout_micros=*/0,
+                           /*max_enqueued_batches=*/10);
+    // The batches of queue "a" are three times as expensive as those of queue
+    // "b", so queue "b" runs three batches for each batch of queue "a".
+    queue_options.batch_cost_fn = [](size_t batch_size) {
+      return 3.0 * batch_size;
+    };
+    std::unique_ptr<Queue> queue_a =
+        CreateQueue(scheduler, queue_options, make_callback("a"));
+    queue_options.batch_cost_fn = nullptr;
+    std::unique_ptr<Queue> queue_b =
+        CreateQueue(scheduler, queue_options, make_callback("b"));
+
+    TF_ASSERT_OK(ScheduleTask(1, queue_a.get()));
+    first_batch_scheduled.WaitForNotification();
+    for (int i = 0; i < 4; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, queue_b.get()));
+    }
+    TF_ASSERT_OK(ScheduleTask(1, queue_a.get()));
+    first_batch_proceed.Notify();
+  }
+
+  EXPECT_THAT(processed_batches,
+              testing::ElementsAre("a", "b", "b", "b", "a", "b"));
+}
+
+TEST_P(SharedBatchSchedulerTest, LowPriorityTasksFillPadding) {
+  if (enable_lazy_split()) {
+    GTEST_SKIP() << "Priority queues are not supported with lazy split.";
+  }
+  mutex mu;
+  std::vector<std::pair<size_t, int>> processed_batches;
+  auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+    mutex_lock l(mu);
+    processed_batches.emplace_back(batch->size(), batch->num_tasks());
+  };
+
+  {
+    auto scheduler = CreateSharedBatchScheduler(1);
+    QueueOptions options =
+        CreateQueueOptions(/*max_execution_batch_size=*/8,
+                           /*input_batch_size_limit=*/8,
+                           /*batch_timeout_micros=*/0,
+                           /*max_enqueued_batches=*/2);
+    options.allowed_batch_sizes = {4, 8};
+    options.enable_priority_queue = true;
+    options.low_priority_queue_options.batch_timeout_micros =
+        absl::ToInt64Microseconds(absl::Hours(1));
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    for (int i = 0; i < 3; ++i) {
+      TF_ASSERT_OK(ScheduleSheddableTask(1, queue.get()));
+    }
+    // The high priority task is padded to a batch of 4 with two of the
+    // sheddable tasks. The last one is batched when the queue closes.
+    TF_ASSERT_OK(ScheduleTask(2, queue.get()));
+  }
+
+  EXPECT_THAT(processed_batches, testing::ElementsAre(testing::Pair(4, 3),
+                                                     testing::Pair(1, 1)));
+}
+
+TEST_P(SharedBatchSchedulerTest, HighPriorityBatchesScheduledFirst) {
+  if (enable_lazy_split()) {
+    GTEST_SKIP() << "Priority queues are not supported with lazy split.";
+  }
+  mutex mu;
+  std::vector<tsl::criticality::Criticality> processed_batches;
+  Notification first_batch_scheduled, first_batch_proceed;
+  auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+    {
+      mutex_lock l(mu);
+      processed_batches.push_back(batch->task(0).criticality());
+    }
+    if (!first_batch_scheduled.HasBeenNotified()) {
+      first_batch_scheduled.Notify();
+      first_batch_proceed.WaitForNotification();
+    }
+  };
+
+  {
+    auto scheduler = CreateSharedBatchScheduler(1);
+    QueueOptions options =
+        CreateQueueOptions(/*max_execution_batch_size=*/2,
+                           /*input_batch_size_limit=*/2,
+                           /*batch_timeout_micros=*/0,
+                           /*max_enqueued_batches=*/2);
+    options.enable_priority_queue = true;
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    // Blocks the only batch thread while both sub queues fill up.
+    TF_ASSERT_OK(ScheduleTask(2, queue.get()));
+    first_batch_scheduled.WaitForNotification();
+    TF_ASSERT_OK(ScheduleSheddableTask(2, queue.get()));
+    TF_ASSERT_OK(ScheduleTask(2, queue.get()));
+    first_batch_proceed.Notify();
+  }
+
+  EXPECT_THAT(processed_batches,
+              testing::ElementsAre(tsl::criticality::Criticality::kCritical,
+                                   tsl::criticality::Criticality::kCritical,
+                                   tsl::criticality::Criticality::kSheddable));
+}
+
 TEST_P(SharedBatchSchedulerTest, ConstMethods) {
   for (const int max_enqueued_batches : {1, 2, 5}) {
     Notification processing, proceed;
@@ -735,6 +1082,45 @@ TEST_P(SharedBatchSchedulerTest, QueueDestructorBlocksUntilAllTasksProcessed) {
 
 // Tests that `enable_lazy_split` could be enabled only if
 // `enable_large_batch_splitting` is enabled.
+TEST_P(SharedBatchSchedulerTest, InvalidExpectedBatchProcessingMicros) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(2);
+  QueueOptions options =
+      CreateQueueOptions(/*max_execution_batch_size=*/10,
+                         /*input_batch_size_limit=*/10,
+                         /*batch_timeout_micros=*/10,
+                         /*max_enqueued_batches=*/2);
+  options.enable_deadline_aware_batching = true;
+  options.expected_batch_processing_micros = -1;
+  std::unique_ptr<Queue> queue;
+  EXPECT_THAT(
+      scheduler->AddQueue(options, callback, &queue),
+      testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          "expected_batch_processing_micros must be non-negative; was -1"));
+}
+
+TEST_P(SharedBatchSchedulerTest, InvalidSchedulingWeight) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(2);
+  QueueOptions options =
+      CreateQueueOptions(/*max_execution_batch_size=*/10,
+                         /*input_batch_size_limit=*/10,
+                         /*batch_timeout_micros=*/10,
+                         /*max_enqueued_batches=*/2);
+  options.scheduling_weight = 0;
+  std::unique_ptr<Queue> queue;
+  EXPECT_THAT(scheduler->AddQueue(options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                "scheduling_weight must be positive; was 0"));
+}
+
 TEST_P(SharedBatchSchedulerTest, InvalidLazySplitOptions) {
   auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
     // do nothing.
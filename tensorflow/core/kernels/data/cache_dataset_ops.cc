@@ -50,6 +50,7 @@ namespace data {
 /* static */ constexpr const char* const CacheDatasetOp::kFileName;
 /* static */ constexpr const char* const CacheDatasetOp::kOutputTypes;
 /* static */ constexpr const char* const CacheDatasetOp::kOutputShapes;
+/* static */ constexpr const char* const CacheDatasetOp::kRamBudget;
 
 namespace {
 
@@ -730,10 +731,14 @@ class CacheDatasetOp::FileDatasetV2 : public CacheDatasetOp::FileDatasetBase {
 class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
  public:
   explicit MemoryDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
-                             std::shared_ptr<MemoryCache> cache)
+                             std::shared_ptr<MemoryCache> cache,
+                             int64_t ram_budget, tstring spill_filename)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
-        cache_(std::move(cache)) {
+        cache_(std::move(cache)),
+        ram_budget_(ram_budget),
+        spill_filename_(std::move(spill_filename)),
+        env_(ctx->env()) {
     input_->Ref();
   }
 
@@ -796,6 +801,22 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
   }
 
  protected:
+  // Adds the graph inputs and attributes that configure the memory budget of
+  // the cache to `inputs` and `attrs`.
+  Status AddMemoryCacheConfig(
+      DatasetGraphDefBuilder* b, std::vector<Node*>* inputs,
+      std::vector<std::pair<StringPiece, AttrValue>>* attrs) const {
+    Node* filename_node = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(spill_filename_, &filename_node));
+    inputs->push_back(filename_node);
+    if (ram_budget_ > 0) {
+      AttrValue ram_budget_attr;
+      b->BuildAttrValue(ram_budget_, &ram_budget_attr);
+      attrs->emplace_back(kRamBudget, ram_budget_attr);
+    }
+    return OkStatus();
+  }
+
   class MemoryIterator : public DatasetIterator<MemoryDatasetBase> {
    public:
     explicit MemoryIterator(const Params& params, MemoryCache* cache)
@@ -874,16 +895,15 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         if (*end_of_sequence) {
           if (!cache_->IsCompleted()) {
             VLOG(2) << "Finalizing the cache because EOF has been reached.";
-            cache_->Complete(std::move(temp_cache_));
+            TF_RETURN_IF_ERROR(CompleteCache());
           }
           return OkStatus();
         }
-        RecordBufferEnqueue(ctx, *out_tensors);
-        temp_cache_.emplace_back(*out_tensors);
+        TF_RETURN_IF_ERROR(AddToTempCache(ctx, *out_tensors));
         if (temp_cache_.size() == dataset()->input_->Cardinality()) {
           VLOG(2) << "Finalizing the cache because its size matches the "
                      "expected input cardinality.";
-          cache_->Complete(std::move(temp_cache_));
+          TF_RETURN_IF_ERROR(CompleteCache());
         }
         return OkStatus();
       }
@@ -899,8 +919,20 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                           IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
         if (!cache_->IsCompleted()) {
-          TF_RETURN_IF_ERROR(
-              WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+          if (spill_file_) {
+            // Spilled elements are represented by placeholders in
+            // `temp_cache_`, so read them back to checkpoint the full cache.
+            std::vector<std::vector<Tensor>> elements = temp_cache_;
+            for (int64_t i = 0; i < spilled_positions_.size(); ++i) {
+              TF_RETURN_IF_ERROR(
+                  spill_file_->Read(i, &elements[spilled_positions_[i]]));
+            }
+            TF_RETURN_IF_ERROR(
+                WriteElementsToCheckpoint(writer, prefix(), elements));
+          } else {
+            TF_RETURN_IF_ERROR(
+                WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+          }
         }
         return SaveInput(ctx, writer, input_impl_);
       }
@@ -909,17 +941,78 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                              IteratorStateReader* reader) override {
         mutex_lock l(mu_);
         if (!reader->Contains(prefix(), kCacheCompleted)) {
+          std::vector<std::vector<Tensor>> elements;
           TF_RETURN_IF_ERROR(
-              ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache_));
+              ReadElementsFromCheckpoint(ctx, reader, prefix(), &elements));
+          temp_cache_.clear();
+          temp_cache_bytes_ = 0;
+          spilled_positions_.clear();
+          spill_file_.reset();
+          for (const auto& element : elements) {
+            TF_RETURN_IF_ERROR(AddToTempCache(ctx, element));
+          }
         }
         return RestoreInput(ctx, reader, input_impl_);
       }
 
      private:
+      // Adds `element` to the temporary cache. Once the elements held in
+      // memory exceed the RAM budget of the dataset, subsequent elements are
+      // appended to the spill file instead and a placeholder is kept in their
+      // place.
+      Status AddToTempCache(IteratorContext* ctx,
+                            const std::vector<Tensor>& element)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const int64_t ram_budget = dataset()->ram_budget_;
+        const int64_t element_bytes = GetAllocatedBytes(element);
+        if (ram_budget > 0 && !dataset()->spill_filename_.empty() &&
+            temp_cache_bytes_ + element_bytes > ram_budget &&
+            CacheSpillFile::CanSpill(element)) {
+          if (!spill_file_) {
+            VLOG(2) << "Spilling cache elements to disk because the cache "
+                       "exceeds its RAM budget of "
+                    << ram_budget << " bytes.";
+            TF_RETURN_IF_ERROR(CacheSpillFile::Create(
+                dataset()->env_, dataset()->spill_filename_, &spill_file_));
+          }
+          int64_t index;
+          TF_RETURN_IF_ERROR(spill_file_->Append(element, &index));
+          DCHECK_EQ(index, spilled_positions_.size());
+          spilled_positions_.push_back(temp_cache_.size());
+          temp_cache_.emplace_back();
+          return OkStatus();
+        }
+        RecordBufferEnqueue(ctx, element);
+        temp_cache_bytes_ += element_bytes;
+        temp_cache_.emplace_back(element);
+        return OkStatus();
+      }
+
+      // Replaces the placeholders of the spilled elements with views over the
+      // memory-mapped spill file and marks the cache as completed.
+      Status CompleteCache() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (spill_file_) {
+          TF_RETURN_IF_ERROR(spill_file_->Finalize());
+          for (int64_t i = 0; i < spilled_positions_.size(); ++i) {
+            TF_RETURN_IF_ERROR(
+                spill_file_->GetView(i, &temp_cache_[spilled_positions_[i]]));
+          }
+        }
+        spilled_positions_.clear();
+        cache_->Complete(std::move(temp_cache_), std::move(spill_file_));
+        return OkStatus();
+      }
+
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
       std::vector<std::vector<Tensor>> temp_cache_ TF_GUARDED_BY(mu_);
+      // Number of bytes of the elements of `temp_cache_` held in memory.
+      int64_t temp_cache_bytes_ TF_GUARDED_BY(mu_) = 0;
+      // Holds the elements that do not fit in the RAM budget.
+      std::unique_ptr<CacheSpillFile> spill_file_ TF_GUARDED_BY(mu_);
+      // Positions in `temp_cache_` of the elements in `spill_file_`.
+      std::vector<size_t> spilled_positions_ TF_GUARDED_BY(mu_);
     };  // MemoryWriterIterator
 
     class MemoryReaderIterator : public DatasetIterator<MemoryDatasetBase> {
@@ -1019,6 +1112,11 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
   mutable mutex mu_;
   const DatasetBase* const input_;
   const std::shared_ptr<MemoryCache> cache_;
+  // If positive, elements beyond this many bytes are spilled to a
+  // memory-mapped file whose name starts with `spill_filename_`.
+  const int64_t ram_budget_;
+  const tstring spill_filename_;
+  Env* const env_;
   mutable std::unique_ptr<PartialCache> partial_cache_ TF_GUARDED_BY(mu_);
 };  // MemoryDatasetBase
 
@@ -1028,8 +1126,10 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
 class CacheDatasetOp::MemoryDataset : public CacheDatasetOp::MemoryDatasetBase {
  public:
   MemoryDataset(OpKernelContext* ctx, const DatasetBase* input,
-                MemoryCacheManager* manager, ResourceHandle&& resource_handle)
-      : MemoryDatasetBase(ctx, input, manager->get()),
+                MemoryCacheManager* manager, ResourceHandle&& resource_handle,
+                int64_t ram_budget, tstring spill_filename)
+      : MemoryDatasetBase(ctx, input, manager->get(), ram_budget,
+                          std::move(spill_filename)),
         manager_(manager),
         resource_handle_(std::move(resource_handle)),
         resource_mgr_(ctx->resource_manager()) {}
@@ -1049,10 +1149,10 @@ class CacheDatasetOp::MemoryDataset : public CacheDatasetOp::MemoryDatasetBase {
                             Node** output) const override {
     Node* input_node = nullptr;
     TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_node));
-    Node* filename_node = nullptr;
-    TF_RETURN_IF_ERROR(b->AddScalar(tstring(""), &filename_node));
-    TF_RETURN_IF_ERROR(
-        b->AddDataset(this, {input_node, filename_node}, output));
+    std::vector<Node*> inputs = {input_node};
+    std::vector<std::pair<StringPiece, AttrValue>> attrs;
+    TF_RETURN_IF_ERROR(AddMemoryCacheConfig(b, &inputs, &attrs));
+    TF_RETURN_IF_ERROR(b->AddDataset(this, inputs, attrs, output));
     return OkStatus();
   }
 
@@ -1070,8 +1170,10 @@ class CacheDatasetOp::MemoryDatasetV2
  public:
   MemoryDatasetV2(OpKernelContext* ctx, const DatasetBase* input,
                   MemoryCacheManager* manager, ResourceHandle&& resource_handle,
-                  bool owns_resource)
-      : MemoryDatasetBase(ctx, input, manager->get()),
+                  bool owns_resource, int64_t ram_budget,
+                  tstring spill_filename)
+      : MemoryDatasetBase(ctx, input, manager->get(), ram_budget,
+                          std::move(spill_filename)),
         manager_(manager),
         owns_resource_(owns_resource),
         resource_handle_(std::move(resource_handle)),
@@ -1094,14 +1196,15 @@ class CacheDatasetOp::MemoryDatasetV2
                             Node** output) const override {
     Node* input_node = nullptr;
     TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_node));
-    Node* filename_node = nullptr;
-    TF_RETURN_IF_ERROR(b->AddScalar(tstring(""), &filename_node));
+    std::vector<Node*> inputs = {input_node};
+    std::vector<std::pair<StringPiece, AttrValue>> attrs;
+    TF_RETURN_IF_ERROR(AddMemoryCacheConfig(b, &inputs, &attrs));
     Node* resource_handle_node = nullptr;
     Tensor handle(DT_RESOURCE, TensorShape({}));
     handle.scalar<ResourceHandle>()() = resource_handle_;
     TF_RETURN_IF_ERROR(b->AddTensor(handle, &resource_handle_node));
-    TF_RETURN_IF_ERROR(b->AddDataset(
-        this, {input_node, filename_node, resource_handle_node}, output));
+    inputs.push_back(resource_handle_node);
+    TF_RETURN_IF_ERROR(b->AddDataset(this, inputs, attrs, output));
     return OkStatus();
   }
 
@@ -1114,14 +1217,20 @@ class CacheDatasetOp::MemoryDatasetV2
 
 CacheDatasetOp::CacheDatasetOp(OpKernelConstruction* ctx)
     : UnaryDatasetOpKernel(ctx),
-      op_version_(ctx->def().op() == kCacheDataset ? 1 : 2) {}
+      op_version_(ctx->def().op() == kCacheDataset ? 1 : 2) {
+  if (ctx->HasAttr(kRamBudget)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kRamBudget, &ram_budget_));
+  }
+}
 
 void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
                                  DatasetBase** output) {
   // Parse out the filenames tensor.
   tstring filename;
   OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, kFileName, &filename));
-  if (filename.empty()) {
+  // With a RAM budget, the elements are cached in memory and `filename` only
+  // determines the location of the elements that are spilled to disk.
+  if (filename.empty() || ram_budget_ > 0) {
     static std::atomic<int64_t> resource_id_counter(0);
     const string& container = ctx->resource_manager()->default_container();
     auto name = strings::StrCat(ctx->op_kernel().name(), "/", kMemoryCache, "_",
@@ -1147,7 +1256,7 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
       }
       // Ownership of manager is transferred onto `MemoryDatasetV2`.
       *output = new MemoryDatasetV2(ctx, input, manager, std::move(handle),
-                                    owns_resource);
+                                    owns_resource, ram_budget_, filename);
     } else {
       MemoryCacheManager* manager;
       OP_REQUIRES_OK(
@@ -1159,7 +1268,8 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
       auto handle =
           MakeResourceHandle<MemoryCacheManager>(ctx, container, name);
       // Ownership of manager is transferred onto `MemoryDataset`.
-      *output = new MemoryDataset(ctx, input, manager, std::move(handle));
+      *output = new MemoryDataset(ctx, input, manager, std::move(handle),
+                                  ram_budget_, filename);
     }
   } else {
     if (op_version_ == 2) {
@@ -17,6 +17,7 @@ limitations under the License.
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/platform/path.h"
 
 namespace tensorflow {
@@ -33,10 +34,11 @@ class CacheDatasetParams : public DatasetParams {
   CacheDatasetParams(T input_dataset_params, string filename,
                      DataTypeVector output_dtypes,
                      std::vector<PartialTensorShape> output_shapes,
-                     string node_name)
+                     string node_name, int64_t ram_budget = 0)
       : DatasetParams(std::move(output_dtypes), std::move(output_shapes),
                       std::move(node_name)),
-        filename_(filename) {
+        filename_(filename),
+        ram_budget_(ram_budget) {
     input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
     iterator_prefix_ =
         name_utils::IteratorPrefix(input_dataset_params.dataset_type(),
@@ -57,7 +59,8 @@ class CacheDatasetParams : public DatasetParams {
   Status GetAttributes(AttributeVector* attr_vector) const override {
     *attr_vector = {{"output_types", output_dtypes_},
                     {"output_shapes", output_shapes_},
-                    {"metadata", ""}};
+                    {"metadata", ""},
+                    {"ram_budget", ram_budget_}};
     return OkStatus();
   }
 
@@ -67,6 +70,7 @@ class CacheDatasetParams : public DatasetParams {
 
  private:
   string filename_;
+  int64_t ram_budget_;
 };
 
 class CacheDatasetOpTest : public DatasetOpsTestBase {
@@ -150,6 +154,21 @@ CacheDatasetParams CacheDatasetParams4() {
                             kNodeName);
 }
 
+// Test case 5: cache data in memory up to a RAM budget of one element and spill
+// the remaining elements to a file.
+CacheDatasetParams CacheDatasetParams5() {
+  auto tensor_slice_dataset_params = TensorSliceDatasetParams(
+      /*components=*/{CreateTensor<int64_t>(TensorShape{3, 3, 1},
+                                            {0, 1, 2, 3, 4, 5, 6, 7, 8})},
+      /*node_name=*/"tensor_slice");
+  return CacheDatasetParams(
+      std::move(tensor_slice_dataset_params),
+      /*filename=*/io::JoinPath(testing::TmpDir(), "cache_spill_data"),
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({3, 1})}, kNodeName,
+      /*ram_budget=*/3 * sizeof(int64_t));
+}
+
 std::vector<GetNextTestCase<CacheDatasetParams>> GetNextTestCases() {
   return {{/*dataset_params=*/CacheDatasetParams1(),
            /*expected_outputs=*/
@@ -162,7 +181,11 @@ std::vector<GetNextTestCase<CacheDatasetParams>> GetNextTestCases() {
            CreateTensors<int64_t>(TensorShape({3, 1}),
                                   {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}})},
           {/*dataset_params=*/CacheDatasetParams4(),
-           /*expected_outputs=*/{}}};
+           /*expected_outputs=*/{}},
+          {/*dataset_params=*/CacheDatasetParams5(),
+           /*expected_outputs=*/
+           CreateTensors<int64_t>(TensorShape({3, 1}),
+                                  {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}})}};
 }
 
 class ParameterizedGetNextTest : public CacheDatasetOpTest,
@@ -303,7 +326,12 @@ IteratorSaveAndRestoreTestCases() {
                                   {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}})},
           {/*dataset_params=*/CacheDatasetParams4(),
            /*breakpoints=*/{0, 2, 4, 11},
-           /*expected_outputs=*/{}}};
+           /*expected_outputs=*/{}},
+          {/*dataset_params=*/CacheDatasetParams5(),
+           /*breakpoints=*/{0, 2, 4, 11},
+           /*expected_outputs=*/
+           CreateTensors<int64_t>(TensorShape({3, 1}),
+                                  {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}})}};
 }
 
 class ParameterizedIteratorSaveAndRestoreTest
@@ -366,6 +394,45 @@ TEST_P(ParameterizedIteratorSaveAndRestoreTest, SaveAndRestore) {
   }
 }
 
+TEST_F(CacheDatasetOpTest, SpilledElementsAreDiskBacked) {
+  auto dataset_params = CacheDatasetParams5();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+  }
+  std::vector<string> spill_files;
+  TF_ASSERT_OK(device_->env()->GetMatchingPaths(
+      strings::StrCat(dataset_params.filename(), "*"), &spill_files));
+  EXPECT_EQ(spill_files.size(), 1);
+
+  // Read the completed cache and check that only the elements beyond the RAM
+  // budget are served from the memory-mapped spill file.
+  TF_ASSERT_OK(dataset_->MakeIterator(iterator_ctx_.get(), /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  std::vector<string> allocator_names;
+  end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+    if (!end_of_sequence) {
+      ASSERT_EQ(next.size(), 1);
+      TensorDescription description;
+      next[0].FillDescription(&description);
+      allocator_names.push_back(
+          description.allocation_description().allocator_name());
+    }
+  }
+  ASSERT_EQ(allocator_names.size(), 3);
+  EXPECT_NE(allocator_names[0], "CacheSpillFile");
+  EXPECT_EQ(allocator_names[1], "CacheSpillFile");
+  EXPECT_EQ(allocator_names[2], "CacheSpillFile");
+}
+
 INSTANTIATE_TEST_CASE_P(CacheDatasetOpTest,
                         ParameterizedIteratorSaveAndRestoreTest,
                         ::testing::ValuesIn(IteratorSaveAndRestoreTestCases()));
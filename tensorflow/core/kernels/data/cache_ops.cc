@@ -14,11 +14,20 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_ops.h"
 
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
@@ -28,9 +37,187 @@ namespace data {
 namespace {
 
 constexpr char kMemoryCache[] = "MemoryCache";
+constexpr char kSpillFileSuffix[] = ".spill";
+
+// Components are aligned in the spill file so that the mapped tensors satisfy
+// the alignment requirements of the kernels consuming them.
+constexpr uint64_t kSpillAlignment = Allocator::kAllocatorAlignment;
+
+// A tensor buffer referencing a region of a memory-mapped spill file. The
+// buffer keeps the mapping alive and reports that it does not own its memory
+// so that kernels never forward it as an output and write into the read-only
+// pages.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     const void* data, size_t size)
+      : TensorBuffer(const_cast<void*>(data)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name("CacheSpillFile");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
 
 }  // namespace
 
+Status CacheSpillFile::Create(Env* env, const std::string& filename,
+                              std::unique_ptr<CacheSpillFile>* out) {
+  std::string spill_filename =
+      strings::StrCat(filename, kSpillFileSuffix, "_", random::New64());
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(spill_filename, &file));
+  out->reset(new CacheSpillFile(env, std::move(spill_filename),
+                                std::move(file)));
+  return OkStatus();
+}
+
+CacheSpillFile::~CacheSpillFile() {
+  if (file_) {
+    file_->Close().IgnoreError();
+  }
+  read_file_.reset();
+  // Tensors returned by `GetView` share ownership of `region_`, so the mapping
+  // outlives the file on platforms that support unlinking mapped files.
+  Status s = env_->DeleteFile(filename_);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete cache spill file " << filename_ << ": "
+                 << s;
+  }
+}
+
+bool CacheSpillFile::CanSpill(const std::vector<Tensor>& element) {
+  for (const Tensor& tensor : element) {
+    if (!DataTypeCanUseMemcpy(tensor.dtype()) || !tensor.IsInitialized()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status CacheSpillFile::Append(const std::vector<Tensor>& element,
+                              int64_t* index) {
+  if (!file_) {
+    return errors::FailedPrecondition("Cache spill file ", filename_,
+                                      " has already been finalized.");
+  }
+  static const char kPadding[kSpillAlignment] = {};
+  std::vector<Component> components;
+  components.reserve(element.size());
+  for (const Tensor& tensor : element) {
+    const uint64_t padding =
+        (kSpillAlignment - offset_ % kSpillAlignment) % kSpillAlignment;
+    if (padding > 0) {
+      TF_RETURN_IF_ERROR(file_->Append(StringPiece(kPadding, padding)));
+      offset_ += padding;
+    }
+    StringPiece data = tensor.tensor_data();
+    TF_RETURN_IF_ERROR(file_->Append(data));
+    components.push_back({tensor.dtype(), tensor.shape(), offset_,
+                          static_cast<uint64_t>(data.size())});
+    offset_ += data.size();
+  }
+  *index = elements_.size();
+  elements_.push_back(std::move(components));
+  return OkStatus();
+}
+
+Status CacheSpillFile::Read(int64_t index, std::vector<Tensor>* element) {
+  if (index < 0 || index >= elements_.size()) {
+    return errors::OutOfRange("Spilled element index ", index,
+                              " is out of range [0, ", elements_.size(), ").");
+  }
+  if (!file_) {
+    std::vector<Tensor> views;
+    TF_RETURN_IF_ERROR(GetView(index, &views));
+    element->reserve(element->size() + views.size());
+    for (const Tensor& view : views) {
+      element->push_back(tensor::DeepCopy(view));
+    }
+    return OkStatus();
+  }
+  TF_RETURN_IF_ERROR(file_->Flush());
+  if (!read_file_) {
+    TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(filename_, &read_file_));
+  }
+  for (const Component& component : elements_[index]) {
+    Tensor tensor(component.dtype, component.shape);
+    char* scratch = const_cast<char*>(tensor.tensor_data().data());
+    StringPiece result;
+    TF_RETURN_IF_ERROR(read_file_->Read(component.offset, component.size,
+                                        &result, scratch));
+    if (result.size() != component.size) {
+      return errors::DataLoss("Unexpected end of cache spill file ", filename_,
+                              ": expected ", component.size,
+                              " bytes at offset ", component.offset,
+                              " but got ", result.size());
+    }
+    if (result.data() != scratch) {
+      std::memcpy(scratch, result.data(), result.size());
+    }
+    element->push_back(std::move(tensor));
+  }
+  return OkStatus();
+}
+
+Status CacheSpillFile::Finalize() {
+  if (!file_) {
+    return OkStatus();
+  }
+  TF_RETURN_IF_ERROR(file_->Close());
+  file_.reset();
+  read_file_.reset();
+  if (offset_ == 0) {
+    // Empty files cannot be mapped; all spilled components are empty.
+    return OkStatus();
+  }
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_RETURN_IF_ERROR(env_->NewReadOnlyMemoryRegionFromFile(filename_, &region));
+  if (region->length() != offset_) {
+    return errors::DataLoss("Cache spill file ", filename_, " has ",
+                            region->length(), " bytes, expected ", offset_);
+  }
+  region_ = std::move(region);
+  return OkStatus();
+}
+
+Status CacheSpillFile::GetView(int64_t index,
+                               std::vector<Tensor>* element) const {
+  if (index < 0 || index >= elements_.size()) {
+    return errors::OutOfRange("Spilled element index ", index,
+                              " is out of range [0, ", elements_.size(), ").");
+  }
+  if (file_) {
+    return errors::FailedPrecondition("Cache spill file ", filename_,
+                                      " has not been finalized.");
+  }
+  for (const Component& component : elements_[index]) {
+    if (component.size == 0) {
+      element->emplace_back(component.dtype, component.shape);
+      continue;
+    }
+    const char* data = static_cast<const char*>(region_->data());
+    auto* buffer =
+        new MappedTensorBuffer(region_, data + component.offset, component.size);
+    element->emplace_back(component.dtype, component.shape, buffer);
+    buffer->Unref();
+  }
+  return OkStatus();
+}
+
 string MemoryCacheManager::DebugString() const { return kMemoryCache; }
 
 void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
@@ -41,6 +228,16 @@ void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
   }
 }
 
+void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache,
+                           std::unique_ptr<CacheSpillFile> spill_file) {
+  mutex_lock l(mu_);
+  if (!completed_) {
+    cache_ = std::move(cache);
+    spill_file_ = std::move(spill_file);
+    completed_ = true;
+  }
+}
+
 bool MemoryCache::IsCompleted() {
   tf_shared_lock l(mu_);
   return completed_;
@@ -50,6 +247,7 @@ void MemoryCache::Reset() {
   mutex_lock l(mu_);
   completed_ = false;
   cache_.clear();
+  spill_file_.reset();
 }
 
 const std::vector<Tensor>& MemoryCache::at(int64_t index) {
@@ -16,12 +16,82 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
 
 namespace tensorflow {
 namespace data {
 
+// An append-only file holding the dataset elements of a `MemoryCache` that do
+// not fit in its RAM budget.
+//
+// Elements are appended while the cache is being populated. Once the cache is
+// complete, the file is finalized and memory-mapped, and the spilled elements
+// are served as tensors that reference the mapped pages directly (i.e. without
+// copying them into the heap). The pages can be reclaimed by the OS under
+// memory pressure, which bounds the resident memory of the cache.
+//
+// Only elements whose components can be copied with `memcpy` are spilled; see
+// `CanSpill`. The file is deleted when this object is destroyed; tensors
+// obtained from `GetView` remain valid after that.
+class CacheSpillFile {
+ public:
+  // Creates a spill file with a unique name that starts with `filename`.
+  static Status Create(Env* env, const std::string& filename,
+                       std::unique_ptr<CacheSpillFile>* out);
+
+  ~CacheSpillFile();
+
+  // Returns whether all components of `element` can be spilled.
+  static bool CanSpill(const std::vector<Tensor>& element);
+
+  // Appends `element` to the file, returning its index in `index`.
+  Status Append(const std::vector<Tensor>& element, int64_t* index);
+
+  // Reads a copy of the element at `index` into `element`. Can be used both
+  // before and after the file is finalized.
+  Status Read(int64_t index, std::vector<Tensor>* element);
+
+  // Closes the file for writing and memory-maps its contents.
+  Status Finalize();
+
+  // Returns tensors referencing the mapped contents of the element at `index`.
+  // Must only be called after `Finalize`.
+  Status GetView(int64_t index, std::vector<Tensor>* element) const;
+
+  // Returns the number of elements in the file.
+  size_t size() const { return elements_.size(); }
+
+  // Returns the number of bytes written to the file.
+  uint64_t bytes() const { return offset_; }
+
+ private:
+  struct Component {
+    DataType dtype;
+    TensorShape shape;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  CacheSpillFile(Env* env, std::string filename,
+                 std::unique_ptr<WritableFile> file)
+      : env_(env), filename_(std::move(filename)), file_(std::move(file)) {}
+
+  Env* const env_;
+  const std::string filename_;
+  std::unique_ptr<WritableFile> file_;
+  std::unique_ptr<RandomAccessFile> read_file_;
+  std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  uint64_t offset_ = 0;
+  std::vector<std::vector<Component>> elements_;
+};
+
 // A thread-safe data structure for caching dataset elements.
 //
 // The expected use is that a single `MemoryWriterIterator` populates the
@@ -34,6 +104,11 @@ class MemoryCache {
   // Marks the cache as completed.
   void Complete(std::vector<std::vector<Tensor>>&& cache);
 
+  // Marks the cache as completed, taking ownership of the file holding the
+  // elements of `cache` that have been spilled to disk.
+  void Complete(std::vector<std::vector<Tensor>>&& cache,
+                std::unique_ptr<CacheSpillFile> spill_file);
+
   // Returns whether the cache is completed.
   bool IsCompleted();
 
@@ -55,6 +130,7 @@ class MemoryCache {
   // Determines whether all elements of the dataset have been cached.
   bool completed_ TF_GUARDED_BY(mu_) = false;
   std::vector<std::vector<Tensor>> cache_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<CacheSpillFile> spill_file_ TF_GUARDED_BY(mu_);
 };
 
 // A resource wrapping a shared instance of a memory cache.
@@ -0,0 +1,407 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/columnar_dataset_op.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/data/columnar_format.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/utils.h"
+#include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+
+/* static */ constexpr const char* const ColumnarDatasetOp::kDatasetType;
+/* static */ constexpr const char* const ColumnarDatasetOp::kFileNames;
+/* static */ constexpr const char* const ColumnarDatasetOp::kColumns;
+/* static */ constexpr const char* const ColumnarDatasetOp::kFilterColumn;
+/* static */ constexpr const char* const ColumnarDatasetOp::kFilterLower;
+/* static */ constexpr const char* const ColumnarDatasetOp::kFilterUpper;
+/* static */ constexpr const char* const ColumnarDatasetOp::kNumParallelReads;
+/* static */ constexpr const char* const ColumnarDatasetOp::kOutputTypes;
+/* static */ constexpr const char* const ColumnarDatasetOp::kOutputShapes;
+
+constexpr char kCurrentFileIndex[] = "current_file_index";
+constexpr char kRowGroup[] = "row_group";
+
+class ColumnarDatasetOp::Dataset : public DatasetBase {
+ public:
+  Dataset(OpKernelContext* ctx, std::vector<string> filenames,
+          std::vector<string> columns, string filter_column,
+          double filter_lower, double filter_upper, int64_t num_parallel_reads,
+          const DataTypeVector& output_types,
+          const std::vector<PartialTensorShape>& output_shapes)
+      : DatasetBase(DatasetContext(ctx)),
+        filenames_(std::move(filenames)),
+        columns_(std::move(columns)),
+        filter_column_(std::move(filter_column)),
+        filter_lower_(filter_lower),
+        filter_upper_(filter_upper),
+        num_parallel_reads_(num_parallel_reads),
+        output_types_(output_types),
+        output_shapes_(output_shapes) {}
+
+  std::unique_ptr<IteratorBase> MakeIteratorInternal(
+      const string& prefix) const override {
+    return std::make_unique<Iterator>(Iterator::Params{
+        this, name_utils::IteratorPrefix(kDatasetType, prefix)});
+  }
+
+  const DataTypeVector& output_dtypes() const override {
+    return output_types_;
+  }
+
+  const std::vector<PartialTensorShape>& output_shapes() const override {
+    return output_shapes_;
+  }
+
+  string DebugString() const override {
+    return name_utils::DatasetDebugString(kDatasetType);
+  }
+
+  Status InputDatasets(std::vector<const DatasetBase*>* inputs) const override {
+    return OkStatus();
+  }
+
+  Status CheckExternalState() const override { return OkStatus(); }
+
+ protected:
+  Status AsGraphDefInternal(SerializationContext* ctx,
+                            DatasetGraphDefBuilder* b,
+                            Node** output) const override {
+    Node* filenames = nullptr;
+    TF_RETURN_IF_ERROR(b->AddVector(filenames_, &filenames));
+    Node* columns = nullptr;
+    TF_RETURN_IF_ERROR(b->AddVector(columns_, &columns));
+    Node* filter_column = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(filter_column_, &filter_column));
+    Node* filter_lower = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(filter_lower_, &filter_lower));
+    Node* filter_upper = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(filter_upper_, &filter_upper));
+    Node* num_parallel_reads = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(num_parallel_reads_, &num_parallel_reads));
+    return b->AddDataset(this,
+                         {filenames, columns, filter_column, filter_lower,
+                          filter_upper, num_parallel_reads},
+                         output);
+  }
+
+ private:
+  class Iterator : public DatasetIterator<Dataset> {
+   public:
+    explicit Iterator(const Params& params)
+        : DatasetIterator<Dataset>(params) {}
+
+    bool SymbolicCheckpointCompatible() const override { return true; }
+
+    Status GetNextInternal(IteratorContext* ctx,
+                           std::vector<Tensor>* out_tensors,
+                           bool* end_of_sequence) override {
+      mutex_lock l(mu_);
+      do {
+        // We are currently processing a file, so return the next row group.
+        if (reader_) {
+          if (buffered_row_groups_.empty()) {
+            ReadRowGroupsLocked(ctx);
+          }
+          if (!buffered_row_groups_.empty()) {
+            BufferedRowGroup row_group =
+                std::move(buffered_row_groups_.front());
+            buffered_row_groups_.pop_front();
+            TF_RETURN_IF_ERROR(row_group.status);
+            static monitoring::CounterCell* bytes_counter =
+                metrics::GetTFDataBytesReadCounter(kDatasetType);
+            for (const Tensor& column : row_group.columns) {
+              bytes_counter->IncrementBy(column.TotalBytes());
+            }
+            *out_tensors = std::move(row_group.columns);
+            *end_of_sequence = false;
+            return OkStatus();
+          }
+
+          // We have reached the end of the current file, so maybe move on to
+          // next file.
+          ResetStreamsLocked();
+          ++current_file_index_;
+        }
+
+        // Iteration ends when there are no more files to process.
+        if (current_file_index_ == dataset()->filenames_.size()) {
+          *end_of_sequence = true;
+          return OkStatus();
+        }
+
+        Status s = SetupStreamsLocked(ctx->env());
+        if (!s.ok()) {
+          // Move on to the next file so that this works with ignore_errors.
+          ResetStreamsLocked();
+          ++current_file_index_;
+          return s;
+        }
+      } while (true);
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeSourceNode(std::move(args));
+    }
+
+    Status SaveInternal(SerializationContext* ctx,
+                        IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCurrentFileIndex,
+                                             current_file_index_));
+      if (reader_) {
+        // Restoring starts reading at the first buffered row group.
+        const int64_t row_group = buffered_row_groups_.empty()
+                                      ? next_row_group_
+                                      : buffered_row_groups_.front().index;
+        TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kRowGroup, row_group));
+      }
+      return OkStatus();
+    }
+
+    Status RestoreInternal(IteratorContext* ctx,
+                           IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      ResetStreamsLocked();
+      int64_t current_file_index;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kCurrentFileIndex, &current_file_index));
+      current_file_index_ = size_t(current_file_index);
+      if (reader->Contains(prefix(), kRowGroup)) {
+        int64_t row_group;
+        TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kRowGroup, &row_group));
+        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        next_row_group_ = row_group;
+      }
+      return OkStatus();
+    }
+
+   private:
+    struct BufferedRowGroup {
+      int64_t index = 0;
+      std::vector<Tensor> columns;
+      Status status;
+    };
+
+    // Opens the file at `current_file_index_` and finds the projected columns.
+    Status SetupStreamsLocked(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (current_file_index_ >= dataset()->filenames_.size()) {
+        return errors::InvalidArgument(
+            "current_file_index_:", current_file_index_,
+            " >= filenames_.size():", dataset()->filenames_.size());
+      }
+      const string& filename = dataset()->filenames_[current_file_index_];
+      TF_ASSIGN_OR_RETURN(reader_, ColumnarReader::Open(
+                                       env, TranslateFileName(filename)));
+      column_indices_.clear();
+      for (size_t i = 0; i < dataset()->columns_.size(); ++i) {
+        const string& name = dataset()->columns_[i];
+        const int column = reader_->FindColumn(name);
+        if (column < 0) {
+          return errors::InvalidArgument("Column ", name, " not found in ",
+                                         filename);
+        }
+        if (reader_->columns()[column].dtype != dataset()->output_types_[i]) {
+          return errors::InvalidArgument(
+              "Column ", name, " in ", filename, " has type ",
+              DataTypeString(reader_->columns()[column].dtype), ", expected ",
+              DataTypeString(dataset()->output_types_[i]));
+        }
+        column_indices_.push_back(column);
+      }
+      filter_column_index_ = -1;
+      if (!dataset()->filter_column_.empty()) {
+        filter_column_index_ = reader_->FindColumn(dataset()->filter_column_);
+        if (filter_column_index_ < 0) {
+          return errors::InvalidArgument("Filter column ",
+                                         dataset()->filter_column_,
+                                         " not found in ", filename);
+        }
+      }
+      next_row_group_ = 0;
+      return OkStatus();
+    }
+
+    // Reads up to `num_parallel_reads_` of the next row groups of the current
+    // file that are not filtered out, reading all of their columns in
+    // parallel.
+    void ReadRowGroupsLocked(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      while (buffered_row_groups_.size() <
+                 static_cast<size_t>(dataset()->num_parallel_reads_) &&
+             next_row_group_ < reader_->num_row_groups()) {
+        const int64_t row_group = next_row_group_++;
+        if (filter_column_index_ >= 0 &&
+            !reader_->MayContain(row_group, filter_column_index_,
+                                 dataset()->filter_lower_,
+                                 dataset()->filter_upper_)) {
+          VLOG(3) << "Skipping row group " << row_group << " of "
+                  << dataset()->filenames_[current_file_index_];
+          continue;
+        }
+        BufferedRowGroup buffered;
+        buffered.index = row_group;
+        buffered.columns.resize(column_indices_.size());
+        buffered_row_groups_.push_back(std::move(buffered));
+      }
+      if (buffered_row_groups_.empty()) {
+        return;
+      }
+
+      const size_t num_columns = column_indices_.size();
+      std::vector<Status> statuses(buffered_row_groups_.size() * num_columns);
+      BlockingCounter counter(statuses.size());
+      const ColumnarReader* reader = reader_.get();
+      Allocator* allocator = ctx->allocator({});
+      for (size_t i = 0; i < buffered_row_groups_.size(); ++i) {
+        BufferedRowGroup* row_group = &buffered_row_groups_[i];
+        for (size_t c = 0; c < num_columns; ++c) {
+          const int column = column_indices_[c];
+          Status* status = &statuses[i * num_columns + c];
+          (*ctx->runner())([reader, row_group, c, column, status, allocator,
+                            &counter]() {
+            *status = reader->ReadColumn(row_group->index, column, allocator,
+                                         &row_group->columns[c]);
+            counter.DecrementCount();
+          });
+        }
+      }
+      counter.Wait();
+      for (size_t i = 0; i < buffered_row_groups_.size(); ++i) {
+        for (size_t c = 0; c < num_columns; ++c) {
+          buffered_row_groups_[i].status.Update(statuses[i * num_columns + c]);
+        }
+      }
+    }
+
+    // Resets the reader and drops the buffered row groups.
+    void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      buffered_row_groups_.clear();
+      reader_.reset();
+      column_indices_.clear();
+      filter_column_index_ = -1;
+      next_row_group_ = 0;
+    }
+
+    mutex mu_;
+    size_t current_file_index_ TF_GUARDED_BY(mu_) = 0;
+    std::unique_ptr<ColumnarReader> reader_ TF_GUARDED_BY(mu_);
+    // Indices in the current file of the projected columns and of the filter
+    // column, or -1 if there is no filter.
+    std::vector<int> column_indices_ TF_GUARDED_BY(mu_);
+    int filter_column_index_ TF_GUARDED_BY(mu_) = -1;
+    // Index of the next row group of the current file to read.
+    int64_t next_row_group_ TF_GUARDED_BY(mu_) = 0;
+    // Row groups that have been read but not returned yet, in file order.
+    std::deque<BufferedRowGroup> buffered_row_groups_ TF_GUARDED_BY(mu_);
+  };
+
+  const std::vector<string> filenames_;
+  const std::vector<string> columns_;
+  const string filter_column_;
+  const double filter_lower_;
+  const double filter_upper_;
+  const int64_t num_parallel_reads_;
+  const DataTypeVector output_types_;
+  const std::vector<PartialTensorShape> output_shapes_;
+};
+
+ColumnarDatasetOp::ColumnarDatasetOp(OpKernelConstruction* ctx)
+    : DatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputTypes, &output_types_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputShapes, &output_shapes_));
+}
+
+void ColumnarDatasetOp::MakeDataset(OpKernelContext* ctx,
+                                    DatasetBase** output) {
+  const Tensor* filenames_tensor;
+  OP_REQUIRES_OK(ctx, ctx->input(kFileNames, &filenames_tensor));
+  OP_REQUIRES(
+      ctx, filenames_tensor->dims() <= 1,
+      errors::InvalidArgument("`filenames` must be a scalar or a vector."));
+  std::vector<string> filenames;
+  filenames.reserve(filenames_tensor->NumElements());
+  for (int i = 0; i < filenames_tensor->NumElements(); ++i) {
+    filenames.push_back(filenames_tensor->flat<tstring>()(i));
+    metrics::RecordTFDataFilename(kDatasetType, filenames[i]);
+  }
+
+  std::vector<tstring> column_names;
+  OP_REQUIRES_OK(ctx,
+                 ParseVectorArgument<tstring>(ctx, kColumns, &column_names));
+  OP_REQUIRES(ctx, column_names.size() == output_types_.size(),
+              errors::InvalidArgument(
+                  "Expected as many `columns` as `output_types`, got ",
+                  column_names.size(), " columns and ", output_types_.size(),
+                  " output types."));
+  std::vector<string> columns(column_names.begin(), column_names.end());
+  for (const PartialTensorShape& shape : output_shapes_) {
+    OP_REQUIRES(ctx, shape.IsCompatibleWith(PartialTensorShape({-1})),
+                errors::InvalidArgument(
+                    "Each output shape must be compatible with a vector, got ",
+                    shape.DebugString()));
+  }
+
+  tstring filter_column;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, kFilterColumn,
+                                                   &filter_column));
+  double filter_lower;
+  OP_REQUIRES_OK(
+      ctx, ParseScalarArgument<double>(ctx, kFilterLower, &filter_lower));
+  double filter_upper;
+  OP_REQUIRES_OK(
+      ctx, ParseScalarArgument<double>(ctx, kFilterUpper, &filter_upper));
+
+  int64_t num_parallel_reads;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kNumParallelReads,
+                                                   &num_parallel_reads));
+  if (num_parallel_reads == model::kAutotune) {
+    num_parallel_reads = port::MaxParallelism();
+  }
+  OP_REQUIRES(ctx, num_parallel_reads > 0,
+              errors::InvalidArgument(
+                  "`num_parallel_reads` must be greater than zero or ",
+                  model::kAutotune, ", got ", num_parallel_reads));
+
+  *output = new Dataset(ctx, std::move(filenames), std::move(columns),
+                        filter_column, filter_lower, filter_upper,
+                        num_parallel_reads, output_types_, output_shapes_);
+}
+
+namespace {
+
+REGISTER_KERNEL_BUILDER(Name("ColumnarDataset").Device(DEVICE_CPU),
+                        ColumnarDatasetOp);
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
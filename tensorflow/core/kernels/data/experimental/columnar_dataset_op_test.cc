@@ -0,0 +1,213 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/columnar_dataset_op.h"
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/columnar_format.h"
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/platform/path.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "columnar_dataset";
+
+class ColumnarDatasetParams : public DatasetParams {
+ public:
+  ColumnarDatasetParams(std::vector<tstring> filenames,
+                        std::vector<tstring> columns, DataTypeVector dtypes,
+                        tstring filter_column, double filter_lower,
+                        double filter_upper, int64_t num_parallel_reads,
+                        string node_name)
+      : DatasetParams(dtypes,
+                      std::vector<PartialTensorShape>(dtypes.size(), {-1}),
+                      std::move(node_name)),
+        filenames_(std::move(filenames)),
+        columns_(std::move(columns)),
+        filter_column_(std::move(filter_column)),
+        filter_lower_(filter_lower),
+        filter_upper_(filter_upper),
+        num_parallel_reads_(num_parallel_reads) {}
+
+  std::vector<Tensor> GetInputTensors() const override {
+    int64_t num_files = filenames_.size();
+    int64_t num_columns = columns_.size();
+    return {CreateTensor<tstring>(TensorShape({num_files}), filenames_),
+            CreateTensor<tstring>(TensorShape({num_columns}), columns_),
+            CreateTensor<tstring>(TensorShape({}), {filter_column_}),
+            CreateTensor<double>(TensorShape({}), {filter_lower_}),
+            CreateTensor<double>(TensorShape({}), {filter_upper_}),
+            CreateTensor<int64_t>(TensorShape({}), {num_parallel_reads_})};
+  }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    *input_names = {
+        ColumnarDatasetOp::kFileNames,    ColumnarDatasetOp::kColumns,
+        ColumnarDatasetOp::kFilterColumn, ColumnarDatasetOp::kFilterLower,
+        ColumnarDatasetOp::kFilterUpper,  ColumnarDatasetOp::kNumParallelReads};
+    return OkStatus();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {{ColumnarDatasetOp::kOutputTypes, output_dtypes_},
+                    {ColumnarDatasetOp::kOutputShapes, output_shapes_},
+                    {"metadata", ""}};
+    return OkStatus();
+  }
+
+  string dataset_type() const override {
+    return ColumnarDatasetOp::kDatasetType;
+  }
+
+ private:
+  std::vector<tstring> filenames_;
+  std::vector<tstring> columns_;
+  tstring filter_column_;
+  double filter_lower_;
+  double filter_upper_;
+  int64_t num_parallel_reads_;
+};
+
+class ColumnarDatasetOpTest : public DatasetOpsTestBase {
+ protected:
+  void SetUp() override {
+    filename_ = io::JoinPath(testing::TmpDir(), "columnar_dataset_op_test");
+    std::unique_ptr<WritableFile> file;
+    TF_ASSERT_OK(Env::Default()->NewWritableFile(filename_, &file));
+    ColumnarWriter writer(
+        file.get(), {{"id", DT_INT64}, {"label", DT_STRING}, {"x", DT_FLOAT}});
+    // Row group `i` has ids in [10 * i, 10 * i + 1].
+    for (int64_t i = 0; i < 4; ++i) {
+      TF_ASSERT_OK(writer.WriteRowGroup(
+          {CreateTensor<int64_t>(TensorShape({2}), {10 * i, 10 * i + 1}),
+           CreateTensor<tstring>(TensorShape({2}),
+                                 {absl::StrCat("a", i), absl::StrCat("b", i)}),
+           CreateTensor<float>(TensorShape({2}), {1.0f * i, 2.0f * i})}));
+    }
+    TF_ASSERT_OK(writer.Finish());
+    TF_ASSERT_OK(file->Close());
+  }
+
+  ColumnarDatasetParams Params(std::vector<tstring> columns,
+                               DataTypeVector dtypes, tstring filter_column,
+                               double filter_lower, double filter_upper,
+                               int64_t num_parallel_reads = 2) {
+    return ColumnarDatasetParams({filename_}, std::move(columns),
+                                 std::move(dtypes), std::move(filter_column),
+                                 filter_lower, filter_upper,
+                                 num_parallel_reads, kNodeName);
+  }
+
+  std::vector<Tensor> LabelsAndIds(std::vector<int64_t> row_groups) {
+    std::vector<Tensor> outputs;
+    for (int64_t i : row_groups) {
+      outputs.push_back(CreateTensor<tstring>(
+          TensorShape({2}), {absl::StrCat("a", i), absl::StrCat("b", i)}));
+      outputs.push_back(
+          CreateTensor<int64_t>(TensorShape({2}), {10 * i, 10 * i + 1}));
+    }
+    return outputs;
+  }
+
+  std::string filename_;
+};
+
+TEST_F(ColumnarDatasetOpTest, ProjectsColumns) {
+  for (int64_t num_parallel_reads : {1, 3, 8}) {
+    auto params =
+        Params({"label", "id"}, {DT_STRING, DT_INT64}, /*filter_column=*/"",
+               /*filter_lower=*/0, /*filter_upper=*/0, num_parallel_reads);
+    TF_ASSERT_OK(Initialize(params));
+    TF_EXPECT_OK(CheckIteratorGetNext(LabelsAndIds({0, 1, 2, 3}),
+                                      /*compare_order=*/true));
+  }
+}
+
+TEST_F(ColumnarDatasetOpTest, SkipsRowGroupsOutsideOfFilter) {
+  auto params = Params({"label", "id"}, {DT_STRING, DT_INT64},
+                       /*filter_column=*/"id", /*filter_lower=*/5,
+                       /*filter_upper=*/20);
+  TF_ASSERT_OK(Initialize(params));
+  TF_EXPECT_OK(CheckIteratorGetNext(LabelsAndIds({1, 2}),
+                                    /*compare_order=*/true));
+}
+
+TEST_F(ColumnarDatasetOpTest, FilterOnUnprojectedColumn) {
+  auto params =
+      Params({"label", "id"}, {DT_STRING, DT_INT64}, /*filter_column=*/"x",
+             /*filter_lower=*/5,
+             /*filter_upper=*/std::numeric_limits<double>::infinity());
+  TF_ASSERT_OK(Initialize(params));
+  TF_EXPECT_OK(CheckIteratorGetNext(LabelsAndIds({3}),
+                                    /*compare_order=*/true));
+}
+
+TEST_F(ColumnarDatasetOpTest, SaveAndRestore) {
+  auto params = Params({"label", "id"}, {DT_STRING, DT_INT64},
+                       /*filter_column=*/"id", /*filter_lower=*/5,
+                       /*filter_upper=*/100);
+  TF_ASSERT_OK(Initialize(params));
+  TF_EXPECT_OK(CheckIteratorSaveAndRestore(
+      name_utils::IteratorPrefix(ColumnarDatasetOp::kDatasetType,
+                                 params.iterator_prefix()),
+      LabelsAndIds({1, 2, 3}), /*breakpoints=*/{0, 1, 2, 4},
+      /*compare_order=*/true));
+}
+
+TEST_F(ColumnarDatasetOpTest, MissingColumn) {
+  auto params = Params({"label", "missing"}, {DT_STRING, DT_INT64},
+                       /*filter_column=*/"", /*filter_lower=*/0,
+                       /*filter_upper=*/0);
+  TF_ASSERT_OK(Initialize(params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  EXPECT_EQ(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence)
+          .code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(ColumnarDatasetOpTest, MismatchedColumnType) {
+  auto params = Params({"id"}, {DT_FLOAT}, /*filter_column=*/"",
+                       /*filter_lower=*/0, /*filter_upper=*/0);
+  TF_ASSERT_OK(Initialize(params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  EXPECT_EQ(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence)
+          .code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(ColumnarDatasetOpTest, InvalidNumParallelReads) {
+  auto params = Params({"id"}, {DT_INT64}, /*filter_column=*/"",
+                       /*filter_lower=*/0, /*filter_upper=*/0,
+                       /*num_parallel_reads=*/0);
+  EXPECT_EQ(Initialize(params).code(), absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
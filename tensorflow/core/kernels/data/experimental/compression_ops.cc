@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/experimental/compression_ops.h"
 
 #include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/platform/errors.h"
@@ -23,9 +24,29 @@ limitations under the License.
 namespace tensorflow {
 namespace data {
 namespace experimental {
+namespace {
+
+// Elements larger than this are compressed in chunks which are compressed and
+// uncompressed in parallel on the device's CPU worker threads.
+constexpr size_t kCompressionChunkSizeBytes = 4 << 20;  // 4MB
+
+thread::ThreadPool* CpuWorkerThreads(OpKernelContext* ctx) {
+  const DeviceBase::CpuWorkerThreads* worker_threads =
+      ctx->device()->tensorflow_cpu_worker_threads();
+  return worker_threads != nullptr ? worker_threads->workers : nullptr;
+}
+
+}  // namespace
 
 CompressElementOp::CompressElementOp(OpKernelConstruction* ctx)
-    : OpKernel(ctx) {}
+    : OpKernel(ctx) {
+  std::string codec;
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kCodec, &codec));
+  StatusOr<CompressedElement::Codec> parsed_codec =
+      ParseCompressionCodec(codec);
+  OP_REQUIRES_OK(ctx, parsed_codec.status());
+  codec_ = *parsed_codec;
+}
 
 void CompressElementOp::Compute(OpKernelContext* ctx) {
   std::vector<Tensor> components;
@@ -33,7 +54,11 @@ void CompressElementOp::Compute(OpKernelContext* ctx) {
     components.push_back(ctx->input(i));
   }
   CompressedElement compressed;
-  OP_REQUIRES_OK(ctx, CompressElement(components, &compressed));
+  CompressElementOptions options;
+  options.codec = codec_;
+  options.chunk_size_bytes = kCompressionChunkSizeBytes;
+  options.thread_pool = CpuWorkerThreads(ctx);
+  OP_REQUIRES_OK(ctx, CompressElement(components, options, &compressed));
 
   Tensor* output;
   OP_REQUIRES_OK(ctx, ctx->allocate_output(0, TensorShape({}), &output));
@@ -67,7 +92,8 @@ void UncompressElementOp::Compute(OpKernelContext* ctx) {
           tensor.DebugString()));
 
   std::vector<Tensor> components;
-  OP_REQUIRES_OK(ctx, UncompressElement(*compressed, &components));
+  OP_REQUIRES_OK(ctx, UncompressElement(*compressed, CpuWorkerThreads(ctx),
+                                        &components));
   OP_REQUIRES(ctx, components.size() == output_types_.size(),
               errors::FailedPrecondition("Expected ", output_types_.size(),
                                          " outputs from uncompress, but got ",
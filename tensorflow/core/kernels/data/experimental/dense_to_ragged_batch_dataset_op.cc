@@ -0,0 +1,329 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/dense_to_ragged_batch_dataset_op.h"
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/framework/variant.h"
+#include "tensorflow/core/kernels/ragged_tensor_variant.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+
+/* static */ constexpr const char* const
+    DenseToRaggedBatchDatasetOp::kDatasetType;
+/* static */ constexpr const char* const
+    DenseToRaggedBatchDatasetOp::kInputDataset;
+/* static */ constexpr const char* const
+    DenseToRaggedBatchDatasetOp::kBatchSize;
+/* static */ constexpr const char* const
+    DenseToRaggedBatchDatasetOp::kDropRemainder;
+/* static */ constexpr const char* const DenseToRaggedBatchDatasetOp::kTsplits;
+/* static */ constexpr const char* const
+    DenseToRaggedBatchDatasetOp::kOutputTypes;
+/* static */ constexpr const char* const
+    DenseToRaggedBatchDatasetOp::kOutputShapes;
+
+namespace {
+
+constexpr char kInputImplEmpty[] = "input_impl_empty";
+
+// Writes the row splits `[0, n_0, n_0 + n_1, ...]` of `rows` to `splits`, where
+// `n_i` is the size of the first dimension of `rows[i]`.
+template <typename SPLITS_TYPE>
+Status FillRowSplits(const std::vector<Tensor>& rows, Tensor* splits) {
+  auto splits_vec = splits->vec<SPLITS_TYPE>();
+  int64_t offset = 0;
+  splits_vec(0) = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    offset += rows[i].dim_size(0);
+    if (offset > std::numeric_limits<SPLITS_TYPE>::max()) {
+      return errors::InvalidArgument(
+          "Batch has ", offset, " values, which does not fit in row splits of "
+          "type ", DataTypeString(splits->dtype()), ".");
+    }
+    splits_vec(i + 1) = static_cast<SPLITS_TYPE>(offset);
+  }
+  return OkStatus();
+}
+
+// Checks that `row` has the same shape as `first_row` in all but the first
+// dimension, so that the two can be concatenated.
+Status CheckRowShape(const Tensor& row, const Tensor& first_row,
+                     int component) {
+  bool compatible = row.dims() == first_row.dims();
+  for (int i = 1; compatible && i < row.dims(); ++i) {
+    compatible = row.dim_size(i) == first_row.dim_size(i);
+  }
+  if (!compatible) {
+    return errors::InvalidArgument(
+        "Cannot batch component ", component, " into a ragged tensor because "
+        "its elements differ in a dimension other than the first: ",
+        first_row.shape().DebugString(), " vs. ", row.shape().DebugString(),
+        ".");
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+class DenseToRaggedBatchDatasetOp::Dataset : public DatasetBase {
+ public:
+  Dataset(OpKernelContext* ctx, int64_t batch_size, bool drop_remainder,
+          DataType splits_dtype, const DatasetBase* input)
+      : DatasetBase(DatasetContext(ctx)),
+        batch_size_(batch_size),
+        drop_remainder_(drop_remainder),
+        splits_dtype_(splits_dtype),
+        input_(input),
+        output_dtypes_(input->output_dtypes().size(), DT_VARIANT),
+        output_shapes_(input->output_shapes().size(), PartialTensorShape({})) {
+    input_->Ref();
+  }
+
+  ~Dataset() override { input_->Unref(); }
+
+  std::unique_ptr<IteratorBase> MakeIteratorInternal(
+      const string& prefix) const override {
+    return std::make_unique<Iterator>(Iterator::Params{
+        this, name_utils::IteratorPrefix(kDatasetType, prefix)});
+  }
+
+  const DataTypeVector& output_dtypes() const override {
+    return output_dtypes_;
+  }
+
+  const std::vector<PartialTensorShape>& output_shapes() const override {
+    return output_shapes_;
+  }
+
+  string DebugString() const override {
+    name_utils::DatasetDebugStringParams params;
+    params.set_args(batch_size_);
+    return name_utils::DatasetDebugString(kDatasetType, params);
+  }
+
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    int64_t n = input_->Cardinality(options);
+    if (n == kInfiniteCardinality || n == kUnknownCardinality) {
+      return n;
+    }
+    return n / batch_size_ + (n % batch_size_ == 0 || drop_remainder_ ? 0 : 1);
+  }
+
+  Status InputDatasets(std::vector<const DatasetBase*>* inputs) const override {
+    inputs->push_back(input_);
+    return OkStatus();
+  }
+
+  Status CheckExternalState() const override {
+    return input_->CheckExternalState();
+  }
+
+ protected:
+  Status AsGraphDefInternal(SerializationContext* ctx,
+                            DatasetGraphDefBuilder* b,
+                            Node** output) const override {
+    Node* input_graph_node = nullptr;
+    TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph_node));
+    Node* batch_size = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size));
+    Node* drop_remainder = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(drop_remainder_, &drop_remainder));
+    AttrValue splits_dtype;
+    b->BuildAttrValue(splits_dtype_, &splits_dtype);
+    TF_RETURN_IF_ERROR(
+        b->AddDataset(this, {input_graph_node, batch_size, drop_remainder},
+                      {{kTsplits, splits_dtype}}, output));
+    return OkStatus();
+  }
+
+ private:
+  class Iterator : public DatasetIterator<Dataset> {
+   public:
+    explicit Iterator(const Params& params)
+        : DatasetIterator<Dataset>(params) {}
+
+    bool SymbolicCheckpointCompatible() const override { return true; }
+
+    Status Initialize(IteratorContext* ctx) override {
+      return dataset()->input_->MakeIterator(ctx, this, prefix(), &input_impl_);
+    }
+
+    Status GetNextInternal(IteratorContext* ctx,
+                           std::vector<Tensor>* out_tensors,
+                           bool* end_of_sequence) override {
+      std::vector<std::vector<Tensor>> batch_elements;
+      {
+        mutex_lock l(mu_);
+        if (!input_impl_) {
+          *end_of_sequence = true;
+          return OkStatus();
+        }
+        batch_elements.reserve(dataset()->batch_size_);
+        *end_of_sequence = false;
+        for (int i = 0; i < dataset()->batch_size_ && !*end_of_sequence; ++i) {
+          std::vector<Tensor> batch_element_tuple;
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, &batch_element_tuple, end_of_sequence));
+          if (!*end_of_sequence) {
+            batch_elements.emplace_back(std::move(batch_element_tuple));
+          } else {
+            input_impl_.reset();
+          }
+        }
+      }
+
+      if (batch_elements.empty()) {
+        DCHECK(*end_of_sequence);
+        return OkStatus();
+      }
+
+      if (dataset()->drop_remainder_ &&
+          batch_elements.size() < dataset()->batch_size_) {
+        *end_of_sequence = true;
+        return OkStatus();
+      }
+
+      // Each component of the batch is copied once into a contiguous values
+      // tensor. The row splits are derived from the element lengths.
+      const int64_t num_rows = batch_elements.size();
+      const size_t num_components = batch_elements.front().size();
+      out_tensors->reserve(num_components);
+      for (size_t component = 0; component < num_components; ++component) {
+        std::vector<Tensor> rows;
+        rows.reserve(num_rows);
+        for (auto& element : batch_elements) {
+          Tensor& row = element[component];
+          if (row.dims() == 0) {
+            return errors::InvalidArgument(
+                "Cannot batch component ", component,
+                " into a ragged tensor because it is a scalar.");
+          }
+          if (!rows.empty()) {
+            TF_RETURN_IF_ERROR(CheckRowShape(row, rows.front(), component));
+          }
+          rows.push_back(std::move(row));
+        }
+
+        Tensor splits(ctx->allocator({}), dataset()->splits_dtype_,
+                      TensorShape({num_rows + 1}));
+        if (dataset()->splits_dtype_ == DT_INT32) {
+          TF_RETURN_IF_ERROR(FillRowSplits<int32>(rows, &splits));
+        } else {
+          TF_RETURN_IF_ERROR(FillRowSplits<int64_t>(rows, &splits));
+        }
+        Tensor values;
+        TF_RETURN_IF_ERROR(tensor::Concat(rows, &values));
+
+        Tensor ragged(DT_VARIANT, TensorShape({}));
+        ragged.scalar<Variant>()() =
+            RaggedTensorVariant(std::move(values), {std::move(splits)});
+        out_tensors->push_back(std::move(ragged));
+      }
+
+      *end_of_sequence = false;
+      return OkStatus();
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeKnownRatioNode(std::move(args), dataset()->batch_size_);
+    }
+
+    Status SaveInternal(SerializationContext* ctx,
+                        IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          prefix(), kInputImplEmpty, static_cast<int64_t>(!input_impl_)));
+      if (input_impl_) {
+        TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
+      }
+      return OkStatus();
+    }
+
+    Status RestoreInternal(IteratorContext* ctx,
+                           IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      int64_t input_empty;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kInputImplEmpty, &input_empty));
+      if (!static_cast<bool>(input_empty)) {
+        TF_RETURN_IF_ERROR(RestoreInput(ctx, reader, input_impl_));
+      } else {
+        input_impl_.reset();
+      }
+      return OkStatus();
+    }
+
+   private:
+    mutex mu_;
+    std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
+  };
+
+  const int64_t batch_size_;
+  const bool drop_remainder_;
+  const DataType splits_dtype_;
+  const DatasetBase* const input_;
+  const DataTypeVector output_dtypes_;
+  const std::vector<PartialTensorShape> output_shapes_;
+};
+
+DenseToRaggedBatchDatasetOp::DenseToRaggedBatchDatasetOp(
+    OpKernelConstruction* ctx)
+    : UnaryDatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kTsplits, &splits_dtype_));
+}
+
+void DenseToRaggedBatchDatasetOp::MakeDataset(OpKernelContext* ctx,
+                                              DatasetBase* input,
+                                              DatasetBase** output) {
+  int64_t batch_size = 0;
+  OP_REQUIRES_OK(ctx,
+                 ParseScalarArgument<int64_t>(ctx, kBatchSize, &batch_size));
+  OP_REQUIRES(ctx, batch_size > 0,
+              errors::InvalidArgument("Batch size must be greater than zero."));
+
+  bool drop_remainder = false;
+  OP_REQUIRES_OK(
+      ctx, ParseScalarArgument<bool>(ctx, kDropRemainder, &drop_remainder));
+
+  for (const PartialTensorShape& shape : input->output_shapes()) {
+    OP_REQUIRES(ctx, shape.unknown_rank() || shape.dims() > 0,
+                errors::InvalidArgument(
+                    "DenseToRaggedBatchDataset requires input components with "
+                    "at least one dimension, but got a scalar component."));
+  }
+
+  *output = new Dataset(ctx, batch_size, drop_remainder, splits_dtype_, input);
+}
+
+namespace {
+REGISTER_KERNEL_BUILDER(Name("DenseToRaggedBatchDataset").Device(DEVICE_CPU),
+                        DenseToRaggedBatchDatasetOp);
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,231 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/dense_to_ragged_batch_dataset_op.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/kernels/ragged_tensor_variant.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "dense_to_ragged_batch_dataset";
+
+// Parameters of a `ListDataset` whose elements are the given `rows`. The
+// dimensions of the rows are left unknown so that their shapes may differ.
+class RowListDatasetParams : public DatasetParams {
+ public:
+  RowListDatasetParams(std::vector<Tensor> rows, string node_name)
+      : DatasetParams({rows.front().dtype()},
+                      {PartialTensorShape(std::vector<int64_t>(
+                          rows.front().dims(), -1))},
+                      std::move(node_name)),
+        rows_(std::move(rows)) {}
+
+  std::vector<Tensor> GetInputTensors() const override { return rows_; }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    input_names->clear();
+    for (int i = 0; i < rows_.size(); ++i) {
+      input_names->emplace_back(absl::StrCat("tensors_", i));
+    }
+    return OkStatus();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {
+        {"Tinput_types", DataTypeVector(rows_.size(), output_dtypes_[0])},
+        {"output_types", output_dtypes_},
+        {"output_shapes", output_shapes_},
+        {"metadata", ""}};
+    return OkStatus();
+  }
+
+  string dataset_type() const override { return "List"; }
+
+ private:
+  std::vector<Tensor> rows_;
+};
+
+class DenseToRaggedBatchDatasetParams : public DatasetParams {
+ public:
+  DenseToRaggedBatchDatasetParams(RowListDatasetParams input_dataset_params,
+                                  int64_t batch_size, bool drop_remainder,
+                                  DataType splits_dtype, string node_name)
+      : DatasetParams({DT_VARIANT}, {PartialTensorShape({})},
+                      std::move(node_name)),
+        batch_size_(batch_size),
+        drop_remainder_(drop_remainder),
+        splits_dtype_(splits_dtype) {
+    iterator_prefix_ =
+        name_utils::IteratorPrefix(input_dataset_params.dataset_type(),
+                                   input_dataset_params.iterator_prefix());
+    input_dataset_params_.push_back(std::make_unique<RowListDatasetParams>(
+        std::move(input_dataset_params)));
+  }
+
+  std::vector<Tensor> GetInputTensors() const override {
+    return {CreateTensor<int64_t>(TensorShape({}), {batch_size_}),
+            CreateTensor<bool>(TensorShape({}), {drop_remainder_})};
+  }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    *input_names = {DenseToRaggedBatchDatasetOp::kInputDataset,
+                    DenseToRaggedBatchDatasetOp::kBatchSize,
+                    DenseToRaggedBatchDatasetOp::kDropRemainder};
+    return OkStatus();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {
+        {DenseToRaggedBatchDatasetOp::kTsplits, splits_dtype_},
+        {DenseToRaggedBatchDatasetOp::kOutputTypes, output_dtypes_},
+        {DenseToRaggedBatchDatasetOp::kOutputShapes, output_shapes_},
+        {"metadata", ""}};
+    return OkStatus();
+  }
+
+  string dataset_type() const override {
+    return DenseToRaggedBatchDatasetOp::kDatasetType;
+  }
+
+ private:
+  int64_t batch_size_;
+  bool drop_remainder_;
+  DataType splits_dtype_;
+};
+
+class DenseToRaggedBatchDatasetOpTest : public DatasetOpsTestBase {
+ protected:
+  // Reads all batches from the iterator, decoding each of them.
+  Status GetBatches(std::vector<RaggedTensorVariant>* batches) {
+    bool end_of_sequence = false;
+    while (!end_of_sequence) {
+      std::vector<Tensor> out_tensors;
+      TF_RETURN_IF_ERROR(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                            &end_of_sequence));
+      if (!end_of_sequence) {
+        EXPECT_EQ(out_tensors.size(), 1);
+        const auto* ragged =
+            out_tensors[0].scalar<Variant>()().get<RaggedTensorVariant>();
+        if (ragged == nullptr) {
+          return errors::Internal("Output is not a RaggedTensorVariant.");
+        }
+        batches->push_back(*ragged);
+      }
+    }
+    return OkStatus();
+  }
+};
+
+RowListDatasetParams VariableLengthRows() {
+  return RowListDatasetParams(
+      {CreateTensor<int64_t>(TensorShape({3}), {1, 2, 3}),
+       CreateTensor<int64_t>(TensorShape({1}), {4}),
+       CreateTensor<int64_t>(TensorShape({0}), {}),
+       CreateTensor<int64_t>(TensorShape({2}), {5, 6}),
+       CreateTensor<int64_t>(TensorShape({1}), {7})},
+      "list_dataset");
+}
+
+TEST_F(DenseToRaggedBatchDatasetOpTest, BatchesVariableLengthRows) {
+  auto params = DenseToRaggedBatchDatasetParams(
+      VariableLengthRows(), /*batch_size=*/2, /*drop_remainder=*/false,
+      DT_INT64, kNodeName);
+  TF_ASSERT_OK(Initialize(params));
+  TF_ASSERT_OK(CheckDatasetCardinality(3));
+
+  std::vector<RaggedTensorVariant> batches;
+  TF_ASSERT_OK(GetBatches(&batches));
+  ASSERT_EQ(batches.size(), 3);
+  for (const auto& batch : batches) {
+    ASSERT_EQ(batch.ragged_rank(), 1);
+  }
+  test::ExpectEqual(batches[0].values(),
+                    CreateTensor<int64_t>(TensorShape({4}), {1, 2, 3, 4}));
+  test::ExpectEqual(batches[0].splits(0),
+                    CreateTensor<int64_t>(TensorShape({3}), {0, 3, 4}));
+  test::ExpectEqual(batches[1].values(),
+                    CreateTensor<int64_t>(TensorShape({2}), {5, 6}));
+  test::ExpectEqual(batches[1].splits(0),
+                    CreateTensor<int64_t>(TensorShape({3}), {0, 0, 2}));
+  test::ExpectEqual(batches[2].values(),
+                    CreateTensor<int64_t>(TensorShape({1}), {7}));
+  test::ExpectEqual(batches[2].splits(0),
+                    CreateTensor<int64_t>(TensorShape({2}), {0, 1}));
+}
+
+TEST_F(DenseToRaggedBatchDatasetOpTest, DropRemainder) {
+  auto params = DenseToRaggedBatchDatasetParams(
+      VariableLengthRows(), /*batch_size=*/2, /*drop_remainder=*/true,
+      DT_INT64, kNodeName);
+  TF_ASSERT_OK(Initialize(params));
+  TF_ASSERT_OK(CheckDatasetCardinality(2));
+
+  std::vector<RaggedTensorVariant> batches;
+  TF_ASSERT_OK(GetBatches(&batches));
+  EXPECT_EQ(batches.size(), 2);
+}
+
+TEST_F(DenseToRaggedBatchDatasetOpTest, InnerDimensionsAndInt32Splits) {
+  auto params = DenseToRaggedBatchDatasetParams(
+      RowListDatasetParams(
+          {CreateTensor<float>(TensorShape({1, 2}), {1, 2}),
+           CreateTensor<float>(TensorShape({2, 2}), {3, 4, 5, 6})},
+          "list_dataset"),
+      /*batch_size=*/2, /*drop_remainder=*/false, DT_INT32, kNodeName);
+  TF_ASSERT_OK(Initialize(params));
+
+  std::vector<RaggedTensorVariant> batches;
+  TF_ASSERT_OK(GetBatches(&batches));
+  ASSERT_EQ(batches.size(), 1);
+  test::ExpectEqual(
+      batches[0].values(),
+      CreateTensor<float>(TensorShape({3, 2}), {1, 2, 3, 4, 5, 6}));
+  test::ExpectEqual(batches[0].splits(0),
+                    CreateTensor<int32>(TensorShape({3}), {0, 1, 3}));
+}
+
+TEST_F(DenseToRaggedBatchDatasetOpTest, MismatchedInnerDimensions) {
+  auto params = DenseToRaggedBatchDatasetParams(
+      RowListDatasetParams(
+          {CreateTensor<float>(TensorShape({1, 2}), {1, 2}),
+           CreateTensor<float>(TensorShape({1, 3}), {3, 4, 5})},
+          "list_dataset"),
+      /*batch_size=*/2, /*drop_remainder=*/false, DT_INT64, kNodeName);
+  TF_ASSERT_OK(Initialize(params));
+
+  std::vector<RaggedTensorVariant> batches;
+  EXPECT_EQ(GetBatches(&batches).code(), absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(DenseToRaggedBatchDatasetOpTest, InvalidBatchSize) {
+  auto params = DenseToRaggedBatchDatasetParams(
+      VariableLengthRows(), /*batch_size=*/0, /*drop_remainder=*/false,
+      DT_INT64, kNodeName);
+  EXPECT_EQ(Initialize(params).code(), absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
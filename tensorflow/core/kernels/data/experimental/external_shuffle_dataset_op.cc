@@ -0,0 +1,472 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/external_shuffle_dataset_op.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/snapshot_utils.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/io/compression.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+
+/* static */ constexpr const char* const ExternalShuffleDatasetOp::kDatasetType;
+/* static */ constexpr const char* const
+    ExternalShuffleDatasetOp::kInputDataset;
+/* static */ constexpr const char* const ExternalShuffleDatasetOp::kDirectory;
+/* static */ constexpr const char* const ExternalShuffleDatasetOp::kNumBuckets;
+/* static */ constexpr const char* const ExternalShuffleDatasetOp::kSeed;
+/* static */ constexpr const char* const ExternalShuffleDatasetOp::kSeed2;
+/* static */ constexpr const char* const ExternalShuffleDatasetOp::kOutputTypes;
+/* static */ constexpr const char* const
+    ExternalShuffleDatasetOp::kOutputShapes;
+
+namespace {
+
+// Number of input elements that are read before they are written to their
+// buckets in parallel. Bounds the memory used by the first pass.
+constexpr int64_t kScatterChunkSize = 1024;
+
+constexpr char kScattered[] = "scattered";
+constexpr char kRunDirectory[] = "run_directory";
+constexpr char kBucketOrder[] = "bucket_order";
+constexpr char kNextBucket[] = "next_bucket";
+constexpr char kBufferPosition[] = "buffer_position";
+constexpr char kBucketStartSamples[] = "bucket_start_samples";
+constexpr char kNumRandomSamples[] = "num_random_samples";
+constexpr char kSeed[] = "seed";
+constexpr char kSeed2[] = "seed2";
+
+std::string BucketFilename(const std::string& run_directory, int64_t bucket) {
+  return io::JoinPath(run_directory, absl::StrCat("bucket_", bucket));
+}
+
+}  // namespace
+
+class ExternalShuffleDatasetOp::Dataset : public DatasetBase {
+ public:
+  Dataset(OpKernelContext* ctx, std::string directory, int64_t num_buckets,
+          int64_t seed, int64_t seed2, const DatasetBase* input)
+      : DatasetBase(DatasetContext(ctx)),
+        directory_(std::move(directory)),
+        num_buckets_(num_buckets),
+        seeds_(seed, seed2),
+        input_(input) {
+    input_->Ref();
+  }
+
+  ~Dataset() override { input_->Unref(); }
+
+  std::unique_ptr<IteratorBase> MakeIteratorInternal(
+      const string& prefix) const override {
+    return std::make_unique<Iterator>(
+        Iterator::Params{this,
+                         name_utils::IteratorPrefix(kDatasetType, prefix)},
+        seeds_.first, seeds_.second);
+  }
+
+  const DataTypeVector& output_dtypes() const override {
+    return input_->output_dtypes();
+  }
+
+  const std::vector<PartialTensorShape>& output_shapes() const override {
+    return input_->output_shapes();
+  }
+
+  string DebugString() const override {
+    name_utils::DatasetDebugStringParams params;
+    params.set_args(num_buckets_, seeds_.first, seeds_.second);
+    return name_utils::DatasetDebugString(kDatasetType, params);
+  }
+
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    return input_->Cardinality(options);
+  }
+
+  Status InputDatasets(std::vector<const DatasetBase*>* inputs) const override {
+    inputs->push_back(input_);
+    return OkStatus();
+  }
+
+  Status CheckExternalState() const override {
+    return input_->CheckExternalState();
+  }
+
+ protected:
+  Status AsGraphDefInternal(SerializationContext* ctx,
+                            DatasetGraphDefBuilder* b,
+                            Node** output) const override {
+    Node* input_graph_node = nullptr;
+    TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph_node));
+    Node* directory = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(directory_, &directory));
+    Node* num_buckets = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(num_buckets_, &num_buckets));
+    Node* seed = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(seeds_.first, &seed));
+    Node* seed2 = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(seeds_.second, &seed2));
+    TF_RETURN_IF_ERROR(b->AddDataset(
+        this, {input_graph_node, directory, num_buckets, seed, seed2}, output));
+    return OkStatus();
+  }
+
+ private:
+  class Iterator : public DatasetIterator<Dataset> {
+   public:
+    Iterator(const Params& params, int64_t seed, int64_t seed2)
+        : DatasetIterator<Dataset>(params),
+          seeds_(MaybeOverrideSeeds({seed, seed2})),
+          parent_generator_(seeds_.first, seeds_.second),
+          generator_(&parent_generator_) {}
+
+    ~Iterator() override {
+      mutex_lock l(mu_);
+      // The buckets of a checkpointed iterator are kept, so that the
+      // checkpoint can be restored after this iterator is gone.
+      if (!checkpointed_) {
+        DeleteBuckets(Env::Default());
+      }
+    }
+
+    Status Initialize(IteratorContext* ctx) override {
+      return dataset()->input_->MakeIterator(ctx, this, prefix(), &input_impl_);
+    }
+
+    Status GetNextInternal(IteratorContext* ctx,
+                           std::vector<Tensor>* out_tensors,
+                           bool* end_of_sequence) override {
+      mutex_lock l(mu_);
+      if (!scattered_) {
+        TF_RETURN_IF_ERROR(ScatterInput(ctx));
+      }
+      while (buffer_position_ == buffer_.size()) {
+        if (next_bucket_ == bucket_order_.size()) {
+          DeleteBuckets(ctx->env());
+          *end_of_sequence = true;
+          return OkStatus();
+        }
+        TF_RETURN_IF_ERROR(LoadBucket(ctx, next_bucket_++));
+      }
+      *out_tensors = std::move(buffer_[buffer_position_++]);
+      *end_of_sequence = false;
+      return OkStatus();
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeKnownRatioNode(std::move(args), /*ratio=*/1);
+    }
+
+    Status SaveInternal(SerializationContext* ctx,
+                        IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kSeed, seeds_.first));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kSeed2, seeds_.second));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kScattered,
+                                             static_cast<int64_t>(scattered_)));
+      if (!scattered_) {
+        return SaveInput(ctx, writer, input_impl_);
+      }
+      checkpointed_ = true;
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(prefix(), kRunDirectory, run_directory_));
+      const int64_t num_buckets = bucket_order_.size();
+      Tensor bucket_order(DT_INT64, TensorShape({num_buckets}));
+      std::copy(bucket_order_.begin(), bucket_order_.end(),
+                bucket_order.vec<int64_t>().data());
+      TF_RETURN_IF_ERROR(
+          writer->WriteTensor(prefix(), kBucketOrder, bucket_order));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          prefix(), kNextBucket, static_cast<int64_t>(next_bucket_)));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          prefix(), kBufferPosition, static_cast<int64_t>(buffer_position_)));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kBucketStartSamples,
+                                             bucket_start_samples_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kNumRandomSamples,
+                                             num_random_samples_));
+      return OkStatus();
+    }
+
+    Status RestoreInternal(IteratorContext* ctx,
+                           IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kSeed, &seeds_.first));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kSeed2, &seeds_.second));
+      int64_t scattered;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kScattered, &scattered));
+      scattered_ = static_cast<bool>(scattered);
+      buffer_.clear();
+      buffer_position_ = 0;
+      if (!scattered_) {
+        num_random_samples_ = 0;
+        ResetRngs();
+        return RestoreInput(ctx, reader, input_impl_);
+      }
+      input_impl_.reset();
+      // The buckets may be restored from the same checkpoint again, so they
+      // are only deleted once this iterator reaches the end of its input.
+      checkpointed_ = true;
+      tstring run_directory;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kRunDirectory, &run_directory));
+      run_directory_ = run_directory;
+      Tensor bucket_order;
+      TF_RETURN_IF_ERROR(
+          reader->ReadTensor(prefix(), kBucketOrder, &bucket_order));
+      auto bucket_order_vec = bucket_order.vec<int64_t>();
+      bucket_order_.assign(bucket_order_vec.data(),
+                           bucket_order_vec.data() + bucket_order_vec.size());
+      int64_t next_bucket;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kNextBucket, &next_bucket));
+      int64_t buffer_position;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kBufferPosition, &buffer_position));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kBucketStartSamples,
+                                            &bucket_start_samples_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kNumRandomSamples,
+                                            &num_random_samples_));
+      next_bucket_ = next_bucket;
+      // The buckets are deleted once the second pass is done.
+      if (next_bucket_ == 0 || run_directory_.empty()) {
+        ResetRngs();
+        return OkStatus();
+      }
+      // Reload the current bucket, replaying the random samples that were
+      // used to shuffle it.
+      num_random_samples_ = bucket_start_samples_;
+      ResetRngs();
+      TF_RETURN_IF_ERROR(LoadBucket(ctx, next_bucket_ - 1));
+      if (buffer_position > buffer_.size()) {
+        return errors::DataLoss("Bucket ", bucket_order_[next_bucket_ - 1],
+                                " in ", run_directory_, " has fewer elements "
+                                "than the checkpoint expects.");
+      }
+      buffer_position_ = buffer_position;
+      return OkStatus();
+    }
+
+   private:
+    // Writes all input elements to randomly chosen buckets, then picks the
+    // order in which the buckets are read.
+    Status ScatterInput(IteratorContext* ctx) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      const int64_t num_buckets = dataset()->num_buckets_;
+      run_directory_ = io::JoinPath(
+          dataset()->directory_,
+          absl::StrCat("external_shuffle_", random::New64()));
+      TF_RETURN_IF_ERROR(ctx->env()->RecursivelyCreateDir(run_directory_));
+      std::vector<std::unique_ptr<snapshot_util::TFRecordWriter>> writers;
+      writers.reserve(num_buckets);
+      for (int64_t bucket = 0; bucket < num_buckets; ++bucket) {
+        writers.push_back(std::make_unique<snapshot_util::TFRecordWriter>(
+            BucketFilename(run_directory_, bucket), io::compression::kNone));
+        TF_RETURN_IF_ERROR(writers.back()->Initialize(ctx->env()));
+      }
+
+      // Each shard writes to a disjoint set of buckets, so that the shards
+      // can write in parallel without synchronization.
+      const int64_t num_shards = std::min<int64_t>(
+          num_buckets, std::max(1, port::MaxParallelism()));
+      bool end_of_input = false;
+      while (!end_of_input) {
+        std::vector<std::vector<Tensor>> chunk;
+        std::vector<std::vector<int64_t>> shard_elements(num_shards);
+        while (chunk.size() < kScatterChunkSize) {
+          std::vector<Tensor> element;
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, &element, &end_of_input));
+          if (end_of_input) {
+            break;
+          }
+          chunk.push_back(std::move(element));
+          int64_t bucket = Random() % num_buckets;
+          shard_elements[bucket % num_shards].push_back(bucket);
+          shard_elements[bucket % num_shards].push_back(chunk.size() - 1);
+        }
+
+        std::vector<Status> statuses(num_shards);
+        BlockingCounter counter(num_shards);
+        for (int64_t shard = 0; shard < num_shards; ++shard) {
+          (*ctx->runner())([&writers, &chunk, &shard_elements, &statuses,
+                            &counter, shard]() {
+            const std::vector<int64_t>& elements = shard_elements[shard];
+            for (size_t i = 0; i < elements.size() && statuses[shard].ok();
+                 i += 2) {
+              statuses[shard] =
+                  writers[elements[i]]->WriteTensors(chunk[elements[i + 1]]);
+            }
+            counter.DecrementCount();
+          });
+        }
+        counter.Wait();
+        for (const Status& status : statuses) {
+          TF_RETURN_IF_ERROR(status);
+        }
+      }
+      for (auto& writer : writers) {
+        TF_RETURN_IF_ERROR(writer->Close());
+      }
+      input_impl_.reset();
+
+      bucket_order_.resize(num_buckets);
+      for (int64_t i = 0; i < num_buckets; ++i) {
+        bucket_order_[i] = i;
+      }
+      Shuffle(&bucket_order_);
+      next_bucket_ = 0;
+      scattered_ = true;
+      return OkStatus();
+    }
+
+    // Reads the `index`-th bucket in the bucket order into `buffer_` and
+    // shuffles it.
+    Status LoadBucket(IteratorContext* ctx, size_t index)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      buffer_.clear();
+      buffer_position_ = 0;
+      snapshot_util::TFRecordReader reader(
+          BucketFilename(run_directory_, bucket_order_[index]),
+          io::compression::kNone, dataset()->output_dtypes());
+      TF_RETURN_IF_ERROR(reader.Initialize(ctx->env()));
+      while (true) {
+        std::vector<Tensor> element;
+        Status status = reader.ReadTensors(&element);
+        if (errors::IsOutOfRange(status)) {
+          break;
+        }
+        TF_RETURN_IF_ERROR(status);
+        buffer_.push_back(std::move(element));
+      }
+      bucket_start_samples_ = num_random_samples_;
+      Shuffle(&buffer_);
+      return OkStatus();
+    }
+
+    void DeleteBuckets(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (run_directory_.empty()) {
+        return;
+      }
+      int64_t undeleted_files, undeleted_dirs;
+      Status status = env->DeleteRecursively(run_directory_, &undeleted_files,
+                                             &undeleted_dirs);
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to delete the shuffle buckets in "
+                     << run_directory_ << ": " << status;
+      }
+      run_directory_.clear();
+    }
+
+    // Shuffles `values` in place with the Fisher-Yates algorithm.
+    template <typename T>
+    void Shuffle(std::vector<T>* values) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      for (size_t i = values->size(); i > 1; --i) {
+        std::swap((*values)[i - 1], (*values)[Random() % i]);
+      }
+    }
+
+    void ResetRngs() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      parent_generator_ = random::PhiloxRandom(seeds_.first, seeds_.second);
+      generator_ =
+          random::SingleSampleAdapter<random::PhiloxRandom>(&parent_generator_);
+      generator_.Skip(num_random_samples_);
+    }
+
+    random::SingleSampleAdapter<random::PhiloxRandom>::ResultType Random()
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      num_random_samples_++;
+      return generator_();
+    }
+
+    mutex mu_;
+    std::pair<int64_t, int64_t> seeds_ TF_GUARDED_BY(mu_);
+    random::PhiloxRandom parent_generator_ TF_GUARDED_BY(mu_);
+    random::SingleSampleAdapter<random::PhiloxRandom> generator_
+        TF_GUARDED_BY(mu_);
+    int64_t num_random_samples_ TF_GUARDED_BY(mu_) = 0;
+    std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
+
+    // Whether the first pass has written all input elements to buckets.
+    bool scattered_ TF_GUARDED_BY(mu_) = false;
+    // Whether a checkpoint refers to the buckets in `run_directory_`.
+    bool checkpointed_ TF_GUARDED_BY(mu_) = false;
+    std::string run_directory_ TF_GUARDED_BY(mu_);
+    std::vector<int64_t> bucket_order_ TF_GUARDED_BY(mu_);
+    // Index into `bucket_order_` of the next bucket to load.
+    size_t next_bucket_ TF_GUARDED_BY(mu_) = 0;
+    // Value of `num_random_samples_` before the current bucket was shuffled.
+    int64_t bucket_start_samples_ TF_GUARDED_BY(mu_) = 0;
+    // The shuffled elements of the current bucket.
+    std::vector<std::vector<Tensor>> buffer_ TF_GUARDED_BY(mu_);
+    size_t buffer_position_ TF_GUARDED_BY(mu_) = 0;
+  };
+
+  const std::string directory_;
+  const int64_t num_buckets_;
+  const std::pair<int64_t, int64_t> seeds_;
+  const DatasetBase* const input_;
+};
+
+ExternalShuffleDatasetOp::ExternalShuffleDatasetOp(OpKernelConstruction* ctx)
+    : UnaryDatasetOpKernel(ctx) {}
+
+void ExternalShuffleDatasetOp::MakeDataset(OpKernelContext* ctx,
+                                           DatasetBase* input,
+                                           DatasetBase** output) {
+  tstring directory;
+  OP_REQUIRES_OK(ctx,
+                 ParseScalarArgument<tstring>(ctx, kDirectory, &directory));
+  OP_REQUIRES(ctx, !directory.empty(),
+              errors::InvalidArgument("`directory` must not be empty."));
+  int64_t num_buckets = 0;
+  OP_REQUIRES_OK(ctx,
+                 ParseScalarArgument<int64_t>(ctx, kNumBuckets, &num_buckets));
+  OP_REQUIRES(
+      ctx, num_buckets > 0,
+      errors::InvalidArgument("`num_buckets` must be greater than zero."));
+  int64_t seed;
+  int64_t seed2;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kSeed, &seed));
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kSeed2, &seed2));
+
+  *output = new Dataset(ctx, directory, num_buckets, seed, seed2, input);
+}
+
+namespace {
+REGISTER_KERNEL_BUILDER(Name("ExternalShuffleDataset").Device(DEVICE_CPU),
+                        ExternalShuffleDatasetOp);
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
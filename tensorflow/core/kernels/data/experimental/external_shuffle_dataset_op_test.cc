@@ -0,0 +1,193 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/external_shuffle_dataset_op.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/platform/path.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "external_shuffle_dataset";
+constexpr int64_t kNumElements = 100;
+
+class ExternalShuffleDatasetParams : public DatasetParams {
+ public:
+  template <typename T>
+  ExternalShuffleDatasetParams(T input_dataset_params, tstring directory,
+                               int64_t num_buckets, int64_t seed,
+                               int64_t seed2, DataTypeVector output_dtypes,
+                               std::vector<PartialTensorShape> output_shapes,
+                               string node_name)
+      : DatasetParams(std::move(output_dtypes), std::move(output_shapes),
+                      std::move(node_name)),
+        directory_(std::move(directory)),
+        num_buckets_(num_buckets),
+        seed_(seed),
+        seed2_(seed2) {
+    input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
+    iterator_prefix_ =
+        name_utils::IteratorPrefix(input_dataset_params.dataset_type(),
+                                   input_dataset_params.iterator_prefix());
+  }
+
+  std::vector<Tensor> GetInputTensors() const override {
+    return {CreateTensor<tstring>(TensorShape({}), {directory_}),
+            CreateTensor<int64_t>(TensorShape({}), {num_buckets_}),
+            CreateTensor<int64_t>(TensorShape({}), {seed_}),
+            CreateTensor<int64_t>(TensorShape({}), {seed2_})};
+  }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    *input_names = {ExternalShuffleDatasetOp::kInputDataset,
+                    ExternalShuffleDatasetOp::kDirectory,
+                    ExternalShuffleDatasetOp::kNumBuckets,
+                    ExternalShuffleDatasetOp::kSeed,
+                    ExternalShuffleDatasetOp::kSeed2};
+    return OkStatus();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {{ExternalShuffleDatasetOp::kOutputTypes, output_dtypes_},
+                    {ExternalShuffleDatasetOp::kOutputShapes, output_shapes_},
+                    {"metadata", ""}};
+    return OkStatus();
+  }
+
+  string dataset_type() const override {
+    return ExternalShuffleDatasetOp::kDatasetType;
+  }
+
+ private:
+  tstring directory_;
+  int64_t num_buckets_;
+  int64_t seed_;
+  int64_t seed2_;
+};
+
+class ExternalShuffleDatasetOpTest : public DatasetOpsTestBase {
+ protected:
+  void SetUp() override {
+    directory_ = io::JoinPath(testing::TmpDir(), "external_shuffle_test");
+    TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(directory_));
+  }
+
+  ExternalShuffleDatasetParams Params(int64_t num_buckets, int64_t seed = 1,
+                                      int64_t seed2 = 2) {
+    return ExternalShuffleDatasetParams(
+        RangeDatasetParams(0, kNumElements, 1), directory_, num_buckets, seed,
+        seed2, {DT_INT64}, {PartialTensorShape({})}, kNodeName);
+  }
+
+  // Returns the values produced by the iterator, in order.
+  Status GetValues(std::vector<int64_t>* values) {
+    bool end_of_sequence = false;
+    while (!end_of_sequence) {
+      std::vector<Tensor> out_tensors;
+      TF_RETURN_IF_ERROR(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                            &end_of_sequence));
+      if (!end_of_sequence) {
+        values->push_back(out_tensors[0].scalar<int64_t>()());
+      }
+    }
+    return OkStatus();
+  }
+
+  std::string directory_;
+};
+
+TEST_F(ExternalShuffleDatasetOpTest, ProducesPermutationOfInput) {
+  for (int64_t num_buckets : {1, 4, 7, 256}) {
+    TF_ASSERT_OK(Initialize(Params(num_buckets)));
+    std::vector<int64_t> values;
+    TF_ASSERT_OK(GetValues(&values));
+    ASSERT_EQ(values.size(), kNumElements);
+    EXPECT_FALSE(std::is_sorted(values.begin(), values.end()));
+    std::sort(values.begin(), values.end());
+    for (int64_t i = 0; i < kNumElements; ++i) {
+      EXPECT_EQ(values[i], i);
+    }
+  }
+}
+
+TEST_F(ExternalShuffleDatasetOpTest, SameSeedsProduceSameOrder) {
+  std::vector<int64_t> first;
+  TF_ASSERT_OK(Initialize(Params(/*num_buckets=*/4)));
+  TF_ASSERT_OK(GetValues(&first));
+  std::vector<int64_t> second;
+  TF_ASSERT_OK(Initialize(Params(/*num_buckets=*/4)));
+  TF_ASSERT_OK(GetValues(&second));
+  EXPECT_EQ(first, second);
+
+  std::vector<int64_t> other_seed;
+  TF_ASSERT_OK(Initialize(Params(/*num_buckets=*/4, /*seed=*/3)));
+  TF_ASSERT_OK(GetValues(&other_seed));
+  EXPECT_NE(first, other_seed);
+}
+
+TEST_F(ExternalShuffleDatasetOpTest, DeletesBucketsAtEnd) {
+  std::vector<string> children_before;
+  TF_ASSERT_OK(Env::Default()->GetChildren(directory_, &children_before));
+  TF_ASSERT_OK(Initialize(Params(/*num_buckets=*/4)));
+  std::vector<Tensor> out_tensors;
+  bool end_of_sequence = false;
+  TF_ASSERT_OK(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence));
+  std::vector<string> children;
+  TF_ASSERT_OK(Env::Default()->GetChildren(directory_, &children));
+  EXPECT_EQ(children.size(), children_before.size() + 1);
+
+  std::vector<int64_t> values;
+  TF_ASSERT_OK(GetValues(&values));
+  children.clear();
+  TF_ASSERT_OK(Env::Default()->GetChildren(directory_, &children));
+  EXPECT_EQ(children.size(), children_before.size());
+}
+
+TEST_F(ExternalShuffleDatasetOpTest, SaveAndRestore) {
+  auto params = Params(/*num_buckets=*/4);
+  TF_ASSERT_OK(Initialize(params));
+  std::vector<int64_t> values;
+  TF_ASSERT_OK(GetValues(&values));
+  std::vector<Tensor> expected_outputs;
+  for (int64_t value : values) {
+    expected_outputs.push_back(CreateTensor<int64_t>(TensorShape({}), {value}));
+  }
+
+  TF_ASSERT_OK(Initialize(params));
+  TF_EXPECT_OK(CheckIteratorSaveAndRestore(
+      name_utils::IteratorPrefix(ExternalShuffleDatasetOp::kDatasetType,
+                                 params.iterator_prefix()),
+      expected_outputs, /*breakpoints=*/{0, 1, 30, 64, kNumElements},
+      /*compare_order=*/true));
+}
+
+TEST_F(ExternalShuffleDatasetOpTest, InvalidNumBuckets) {
+  EXPECT_EQ(Initialize(Params(/*num_buckets=*/0)).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
@@ -197,6 +197,8 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
          it++) {
       it->second = i++;
     }
+    // Builds the feature name lookup once instead of for every input batch.
+    OP_REQUIRES_OK(ctx, example::CompileFastParseExampleConfig(&config));
 
     *output = new Dataset(
         ctx, input, dense_defaults, sparse_keys_, dense_keys_,
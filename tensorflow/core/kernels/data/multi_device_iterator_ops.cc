@@ -16,7 +16,9 @@ limitations under the License.
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/time/time.h"
 #include "tensorflow/core/common_runtime/input_colocation_exemption_registry.h"
@@ -29,10 +31,12 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/function_handle_cache.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/data/iterator_ops.h"
+#include "tensorflow/core/kernels/data/prefetch_autotuner.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -171,6 +175,12 @@ class MultiDeviceIterator : public ResourceBase {
  private:
   // A private class that uses a background thread to keep a per device buffer
   // full.
+  //
+  // If `max_buffer_size` is `model::kAutotune`, the size of each per device
+  // buffer is tuned independently by a `PrefetchAutotuner`: it starts at one
+  // element and grows whenever the shard's consumer finds its buffer empty
+  // after the buffer had been filled, i.e. when the shard consumes faster than
+  // a buffer of the current size can absorb.
   class MultiDeviceBuffer {
    public:
     MultiDeviceBuffer(size_t size, int64_t max_buffer_size,
@@ -182,7 +192,16 @@ class MultiDeviceIterator : public ResourceBase {
           max_buffer_size_(max_buffer_size),
           incarnation_id_(incarnation_id),
           host_iterator_(std::move(host_iterator)),
-          parent_(parent) {}
+          parent_(parent) {
+      if (max_buffer_size_ == model::kAutotune) {
+        auto_tuners_.reserve(size_);
+        for (int i = 0; i < size_; ++i) {
+          auto_tuners_.push_back(std::make_unique<PrefetchAutotuner>(
+              model::kAutotune, /*buffer_size_min=*/1,
+              /*ram_budget_manager=*/nullptr));
+        }
+      }
+    }
 
     ~MultiDeviceBuffer() {
       {
@@ -236,10 +255,14 @@ class MultiDeviceIterator : public ResourceBase {
 
         if (!buffer_[shard_num].data.empty()) {
           produced_output = true;
+          if (!auto_tuners_.empty()) {
+            auto_tuners_[shard_num]->RecordConsumption(
+                buffer_[shard_num].data.size());
+          }
           std::swap(elem, buffer_[shard_num].data.front());
           buffer_[shard_num].data.pop_front();
           // Wake up background thread if it is blocked on this element.
-          if (buffer_[shard_num].data.size() == max_buffer_size_ - 1) {
+          if (buffer_[shard_num].data.size() == BufferLimit(shard_num) - 1) {
             buffer_[shard_num].cond_var.notify_all();
           }
         } else {
@@ -247,6 +270,11 @@ class MultiDeviceIterator : public ResourceBase {
             produced_output = true;
             elem.end_of_sequence = true;
           } else {
+            if (!auto_tuners_.empty()) {
+              // The consumer of this shard is blocked; this may grow the
+              // shard's buffer limit.
+              auto_tuners_[shard_num]->RecordEmpty();
+            }
             auto callback_container =
                 std::make_shared<HostBuffer::CallbackContainer>(
                     std::move(callback));
@@ -280,6 +308,14 @@ class MultiDeviceIterator : public ResourceBase {
     }
 
    private:
+    // Returns the number of elements to keep in the buffer of `shard_num`.
+    int64_t BufferLimit(int shard_num) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!auto_tuners_.empty()) {
+        return auto_tuners_[shard_num]->buffer_limit();
+      }
+      return max_buffer_size_;
+    }
+
     void EnsureBackgroundThreadStarted(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (!background_thread_) {
@@ -354,7 +390,8 @@ class MultiDeviceIterator : public ResourceBase {
         {
           mutex_lock l(mu_);
           while (!cancellation_manager_.IsCancelled() &&
-                 buffer_[shard_to_fetch].data.size() >= max_buffer_size_ &&
+                 buffer_[shard_to_fetch].data.size() >=
+                     BufferLimit(shard_to_fetch) &&
                  buffer_[shard_to_fetch].callbacks.empty()) {
             buffer_[shard_to_fetch].cond_var.wait(l);
           }
@@ -392,6 +429,12 @@ class MultiDeviceIterator : public ResourceBase {
               }
             }
           } else {
+            if (!auto_tuners_.empty() &&
+                !auto_tuners_[shard_to_fetch]->HasElementSize() &&
+                elem.status.ok() && !elem.end_of_sequence) {
+              auto_tuners_[shard_to_fetch]->SetElementSize(
+                  GetAllocatedBytes(elem.value));
+            }
             buffer_[shard_to_fetch].data.push_back(std::move(elem));
             elem = HostBufferElement();
           }
@@ -447,6 +490,9 @@ class MultiDeviceIterator : public ResourceBase {
 
     const size_t size_;
     const int64_t max_buffer_size_;
+    // One autotuner per shard if `max_buffer_size_` is `model::kAutotune`.
+    std::vector<std::unique_ptr<PrefetchAutotuner>> auto_tuners_
+        TF_GUARDED_BY(mu_);
     const int64_t incarnation_id_;
     CancellationManager cancellation_manager_;
     const std::unique_ptr<IteratorBase> host_iterator_;
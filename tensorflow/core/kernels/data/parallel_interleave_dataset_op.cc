@@ -81,6 +81,8 @@ namespace data {
     ParallelInterleaveDatasetOp::kOutputShapes;
 /* static */ constexpr const char* const
     ParallelInterleaveDatasetOp::kDeterministic;
+/* static */ constexpr const char* const
+    ParallelInterleaveDatasetOp::kReorderWindow;
 /* static */ constexpr const char* const ParallelInterleaveDatasetOp::kSloppy;
 
 namespace {
@@ -102,6 +104,7 @@ constexpr char kIdSuffix[] = ".id";
 constexpr char kSizeSuffix[] = ".size";
 constexpr char kInputsSuffix[] = ".inputs";
 constexpr char kIsReadySuffix[] = ".is_ready";
+constexpr char kEarlyResultsSuffix[] = ".early_results";
 constexpr char kElementUninitialized[] = "element_uninitialized";
 constexpr char kRestoreIterator[] = "restore_iterator";
 
@@ -201,7 +204,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           std::unique_ptr<CapturedFunction> captured_func, int64_t cycle_length,
           int64_t block_length, int64_t buffer_output_elements,
           int64_t prefetch_input_elements, int64_t num_parallel_calls,
-          DeterminismPolicy deterministic, const DataTypeVector& output_types,
+          DeterminismPolicy deterministic, int64_t reorder_window,
+          const DataTypeVector& output_types,
           const std::vector<PartialTensorShape>& output_shapes, int op_version)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
@@ -215,6 +219,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
             prefetch_input_elements, cycle_length_)),
         num_parallel_calls_(num_parallel_calls),
         deterministic_(deterministic),
+        reorder_window_(reorder_window),
         output_types_(output_types),
         output_shapes_(output_shapes),
         op_version_(op_version),
@@ -232,7 +237,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
                               static_cast<long long>(buffer_output_elements_))},
              {"prefetch_input_elements",
               strings::Printf(
-                  "%lld", static_cast<long long>(prefetch_input_elements_))}}) {
+                  "%lld", static_cast<long long>(prefetch_input_elements_))},
+             {"reorder_window",
+              strings::Printf("%lld",
+                              static_cast<long long>(reorder_window))}}) {
     input_->Ref();
   }
 
@@ -349,6 +357,11 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       b->BuildAttrValue(deterministic_.String(), &deterministic_attr);
       attrs.emplace_back(kDeterministic, deterministic_attr);
     }
+    if (op_version_ >= 4) {
+      AttrValue reorder_window_attr;
+      b->BuildAttrValue(reorder_window_, &reorder_window_attr);
+      attrs.emplace_back(kReorderWindow, reorder_window_attr);
+    }
 
     TF_RETURN_IF_ERROR(b->AddDataset(this, inputs, list_inputs, attrs, output));
     return OkStatus();
@@ -370,7 +383,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     ~ParallelInterleaveIterator() override { CancelThreads(/*wait=*/true); }
 
     bool SymbolicCheckpointCompatible() const override {
-      return deterministic_;
+      return deterministic_ && dataset()->reorder_window_ == 0;
     }
 
     // TODO(jsimsa): Register cancellation callback once the implementation is
@@ -428,7 +441,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         EnsureThreadsStarted(ctx);
         while (!cancelled_ && !Consume(ctx, &result)) {
           RecordStop(ctx);
-          if (deterministic_) {
+          if (deterministic_ && dataset()->reorder_window_ == 0) {
             VLOG(3) << "Blocked waiting for element "
                     << current_elements_[cycle_index_]->id;
             current_elements_[cycle_index_]->cond_var.wait(l);
@@ -665,6 +678,11 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       // Whether we tried to initialize the element, but the input iterator
       // was exhausted so we could produce no inputs.
       bool no_input TF_GUARDED_BY(&ParallelInterleaveIterator::mu_) = false;
+      // The number of results of the element that have been consumed ahead of
+      // their turn in the interleave cycle. The interleave cycle skips this
+      // many positions of the element before consuming its next result.
+      int64_t early_results TF_GUARDED_BY(&ParallelInterleaveIterator::mu_) =
+          0;
       // Condition variable for communicating between current worker threads
       // and GetNext.
       condition_variable cond_var;
@@ -673,9 +691,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           TF_EXCLUSIVE_LOCKS_REQUIRED(&ParallelInterleaveIterator::mu_) {
         return absl::StrFormat(
             "Element(id: %d, iterator_null: %d, results_size: %d, "
-            "cycle_index: %d, active: %d, initialized: %d, no_input: %d)",
+            "cycle_index: %d, active: %d, initialized: %d, no_input: %d, "
+            "early_results: %d)",
             id, iterator == nullptr, results.size(), cycle_index, active,
-            initialized, no_input);
+            initialized, no_input, early_results);
       }
     };
 
@@ -757,7 +776,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     bool Consume(IteratorContext* ctx, std::shared_ptr<Result>* result)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (deterministic_) {
-        return ConsumeHelper(ctx, result);
+        return ConsumeHelper(ctx, result) || ConsumeAheadOfTurn(result);
       }
       // If we are allowed to be nondeterministic (i.e. return results out of
       // order), try to find an element in the cycle that has a result
@@ -771,6 +790,38 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       return false;
     }
 
+    // Consumes a result of a current cycle element other than the one at the
+    // current position in the cycle, returning an indication of whether a
+    // result was consumed. Used by deterministic iterators with a reorder
+    // window to avoid blocking on a slow element. At most `reorder_window`
+    // results are consumed ahead of their turn, so every prefix of `n` outputs
+    // contains the first `n - reorder_window` outputs of the deterministic
+    // order.
+    bool ConsumeAheadOfTurn(std::shared_ptr<Result>* result)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (last_valid_current_element_ == -1 ||
+          num_early_results_ >= dataset()->reorder_window_) {
+        return false;
+      }
+      for (int64_t i = 1; i < (last_valid_current_element_ + 1); ++i) {
+        int64_t index = (cycle_index_ + i) % (last_valid_current_element_ + 1);
+        std::shared_ptr<Element> element = current_elements_[index];
+        if (!element || element->results.empty()) {
+          continue;
+        }
+        std::swap(*result, element->results.front());
+        element->results.pop_front();
+        ++element->early_results;
+        ++num_early_results_;
+        if (!element->active) {
+          elements_to_process_.push_back(index);
+          current_workers_cond_var_.notify_one();
+        }
+        return true;
+      }
+      return false;
+    }
+
     // Consumes a result (if available), returning an indication of whether
     // a result is available. If `true` is returned, `result` either
     // points to a valid result or is null if end of input has been reached.
@@ -794,6 +845,13 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         }
         DCHECK(current_elements_[cycle_index_]);
         std::shared_ptr<Element> element = current_elements_[cycle_index_];
+        if (element->early_results > 0) {
+          // The result for this position has already been consumed.
+          --element->early_results;
+          --num_early_results_;
+          AdvancePosition();
+          continue;
+        }
         if (!element->results.empty()) {
           // We found a result.
           std::swap(*result, element->results.front());
@@ -1033,6 +1091,19 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
               current_workers_cond_var_.notify_one();
             }
           }
+        }
+        // Future elements are only prefetched, so stop creating them while the
+        // element buffers of all iterators in the process are over the buffer
+        // pool limit. Current workers are not blocked, since the consumer
+        // waits for the elements of the current cycle. This only fails if we
+        // are cancelled.
+        if (!WaitForBufferCapacity(cancellation_manager_.get()).ok()) {
+          mutex_lock l(*mu_);
+          done();
+          return;
+        }
+        {
+          mutex_lock l(*mu_);
           while (!cancelled_ && (future_elements_.size() >=
                                      dataset()->prefetch_input_elements_ ||
                                  wait_for_checkpoint_)) {
@@ -1184,7 +1255,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
 
     void NotifyElementUpdate(Element& element)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-      if (deterministic_) {
+      if (deterministic_ && dataset()->reorder_window_ == 0) {
         element.cond_var.notify_one();
       } else {
         any_element_available_cond_var_.notify_one();
@@ -1336,6 +1407,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         TF_RETURN_IF_ERROR(writer->WriteScalar(key_prefix, kRestoreIterator,
                                                static_cast<int64_t>(false)));
       }
+      if (element->early_results > 0) {
+        TF_RETURN_IF_ERROR(writer->WriteScalar(key_prefix, kEarlyResultsSuffix,
+                                               element->early_results));
+      }
       if (ctx->symbolic_checkpoint()) {
         return writer->WriteScalar(
             key_prefix, absl::StrCat(kResultsSuffix, kSizeSuffix), 0);
@@ -1438,6 +1513,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           RecordBufferEnqueue(ctx, result->return_values);
           element->results[i] = std::move(result);
         }
+        if (reader->Contains(key_prefix, kEarlyResultsSuffix)) {
+          TF_RETURN_IF_ERROR(reader->ReadScalar(
+              key_prefix, kEarlyResultsSuffix, &element->early_results));
+        }
         int64_t restore_iterator;
         TF_RETURN_IF_ERROR(reader->ReadScalar(key_prefix, kRestoreIterator,
                                               &restore_iterator));
@@ -1507,8 +1586,12 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       for (auto& element : current_elements_) {
         DCHECK(element == nullptr);
       }
+      num_early_results_ = 0;
       for (int idx = 0; idx < size; ++idx) {
         current_elements_[idx] = std::move(elements[idx]);
+        if (current_elements_[idx]) {
+          num_early_results_ += current_elements_[idx]->early_results;
+        }
       }
       return OkStatus();
     }
@@ -1663,12 +1746,17 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     int num_current_workers_ TF_GUARDED_BY(mu_) = 0;
 
     // Condition variable to signal that a result has been produced by some
-    // element thread. Only used when `deterministic` is false.
+    // element thread. Only used when `deterministic` is false or the dataset
+    // has a reorder window.
     condition_variable any_element_available_cond_var_;
 
     // Determines whether outputs can be produced in deterministic order.
     const bool deterministic_;
 
+    // The number of results of current cycle elements that have been consumed
+    // ahead of their turn. Bounded by the reorder window of the dataset.
+    int64_t num_early_results_ TF_GUARDED_BY(mu_) = 0;
+
     // Controls cancellation of `input_impl_`. Must be ordered before
     // `input_impl_` so that `input_impl_` is destroyed first.
     std::unique_ptr<CancellationManager> cancellation_manager_;
@@ -1744,6 +1832,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
   const int64_t prefetch_input_elements_;
   const int64_t num_parallel_calls_;
   const DeterminismPolicy deterministic_;
+  const int64_t reorder_window_;
   const DataTypeVector output_types_;
   const std::vector<PartialTensorShape> output_shapes_;
   const int op_version_;
@@ -1774,6 +1863,9 @@ ParallelInterleaveDatasetOp::ParallelInterleaveDatasetOp(
     OP_REQUIRES_OK(
         ctx, DeterminismPolicy::FromString(deterministic, &deterministic_));
   }
+  if (op_version_ >= 4) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kReorderWindow, &reorder_window_));
+  }
 }
 
 void ParallelInterleaveDatasetOp::MakeDataset(OpKernelContext* ctx,
@@ -1840,7 +1932,8 @@ void ParallelInterleaveDatasetOp::MakeDataset(OpKernelContext* ctx,
   *output = new Dataset(
       ctx, input, std::move(captured_func), cycle_length, block_length,
       buffer_output_elements, prefetch_input_elements, num_parallel_calls,
-      deterministic_, output_types_, output_shapes_, op_version_);
+      deterministic_, reorder_window_, output_types_, output_shapes_,
+      op_version_);
 }
 
 namespace {
@@ -39,6 +39,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
   static constexpr const char* const kOutputTypes = "output_types";
   static constexpr const char* const kOutputShapes = "output_shapes";
   static constexpr const char* const kDeterministic = "deterministic";
+  static constexpr const char* const kReorderWindow = "reorder_window";
   static constexpr const char* const kSloppy = "sloppy";
 
   explicit ParallelInterleaveDatasetOp(OpKernelConstruction* ctx);
@@ -54,6 +55,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
   DataTypeVector output_types_;
   std::vector<PartialTensorShape> output_shapes_;
   DeterminismPolicy deterministic_;
+  int64_t reorder_window_ = 0;
 };
 
 }  // namespace data
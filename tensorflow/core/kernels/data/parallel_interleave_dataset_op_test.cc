@@ -36,7 +36,8 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
       std::vector<FunctionDef> func_lib, DataTypeVector type_arguments,
       const DataTypeVector& output_dtypes,
       const std::vector<PartialTensorShape>& output_shapes,
-      const std::string& deterministic, const std::string& node_name)
+      const std::string& deterministic, const std::string& node_name,
+      int64_t reorder_window = 0)
       : DatasetParams(std::move(output_dtypes), std::move(output_shapes),
                       std::move(node_name)),
         other_arguments_(std::move(other_arguments)),
@@ -48,7 +49,8 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
         func_(std::move(func)),
         func_lib_(std::move(func_lib)),
         type_arguments_(std::move(type_arguments)),
-        deterministic_(deterministic) {
+        deterministic_(deterministic),
+        reorder_window_(reorder_window) {
     input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
     op_version_ = kOpVersion;
     name_utils::IteratorPrefixParams params;
@@ -92,6 +94,7 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
   Status GetAttributes(AttributeVector* attr_vector) const override {
     *attr_vector = {{"f", func_},
                     {"deterministic", deterministic_},
+                    {"reorder_window", reorder_window_},
                     {"Targuments", type_arguments_},
                     {"output_shapes", output_shapes_},
                     {"output_types", output_dtypes_},
@@ -116,6 +119,7 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
   std::vector<FunctionDef> func_lib_;
   DataTypeVector type_arguments_;
   std::string deterministic_;
+  int64_t reorder_window_;
 };
 
 class ParallelInterleaveDatasetOpTest : public DatasetOpsTestBase {};
@@ -559,6 +563,32 @@ ParallelInterleaveDatasetParamsWithInvalidPrefetchInputElements() {
       /*node_name=*/kNodeName);
 }
 
+ParallelInterleaveDatasetParams ReorderWindowParams() {
+  auto tensor_slice_dataset_params = TensorSliceDatasetParams(
+      /*components=*/{CreateTensor<int64_t>(TensorShape{3, 3, 1},
+                                            {0, 1, 2, 3, 4, 5, 6, 7, 8})},
+      /*node_name=*/"tensor_slice");
+  return ParallelInterleaveDatasetParams(
+      tensor_slice_dataset_params,
+      /*other_arguments=*/{},
+      /*cycle_length=*/3,
+      /*block_length=*/1,
+      /*buffer_output_elements=*/1,
+      /*prefetch_input_elements=*/0,
+      /*num_parallel_calls=*/3,
+      /*func=*/
+      MakeTensorSliceDatasetFunc(
+          DataTypeVector({DT_INT64}),
+          std::vector<PartialTensorShape>({PartialTensorShape({1})})),
+      /*func_lib=*/{test::function::MakeTensorSliceDataset()},
+      /*type_arguments=*/{},
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({1})},
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*node_name=*/kNodeName,
+      /*reorder_window=*/2);
+}
+
 std::vector<GetNextTestCase<ParallelInterleaveDatasetParams>>
 GetNextTestCases() {
   return {{/*dataset_params=*/ParallelInterleaveDatasetParams1(),
@@ -628,7 +658,12 @@ GetNextTestCases() {
            CreateTensors<tstring>(
                TensorShape{1},
                {{"a"}, {"d"}, {"g"}, {"b"}, {"e"}, {"h"}, {"c"}, {"f"}, {"i"}}),
-           /*compare_order=*/true}};
+           /*compare_order=*/true},
+          {/*dataset_params=*/ReorderWindowParams(),
+           /*expected_outputs=*/
+           CreateTensors<int64_t>(
+               TensorShape{1}, {{0}, {3}, {6}, {1}, {4}, {7}, {2}, {5}, {8}}),
+           /*compare_order=*/false}};
 }
 
 ITERATOR_GET_NEXT_TEST_P(ParallelInterleaveDatasetOpTest,
@@ -878,6 +913,12 @@ IteratorSaveAndRestoreTestCases() {
            CreateTensors<tstring>(
                TensorShape{1},
                {{"a"}, {"b"}, {"c"}, {"d"}, {"e"}, {"f"}, {"g"}, {"h"}, {"i"}}),
+           /*compare_order=*/false},
+          {/*dataset_params=*/ReorderWindowParams(),
+           /*breakpoints=*/{0, 4, 11},
+           /*expected_outputs=*/
+           CreateTensors<int64_t>(
+               TensorShape{1}, {{0}, {3}, {6}, {1}, {4}, {7}, {2}, {5}, {8}}),
            /*compare_order=*/false}};
 }
 
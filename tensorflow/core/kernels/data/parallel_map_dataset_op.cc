@@ -506,27 +506,34 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
         // In this case, the function will be executed using single-threaded
         // executor. We schedule it using `ctx->runner()` to enable concurrent
         // application of the function over different input elements.
-        auto fn = std::bind(
-            [this, ctx, result](std::vector<Tensor> input_element) {
-              return instantiated_captured_func_->Run(
-                  ctx.get(), std::move(input_element), &result->return_values,
-                  model_node());
-            },
-            std::move(input_element));
-        (*ctx->runner())(
-            [this, ctx, fn = std::move(fn), done = std::move(done)]() {
-              Status s;
-              // Check whether we are already recording to prevent invalid
-              // nesting of `RecordStart` calls.
-              if (IsRecording(ctx.get())) {
-                s = fn();
-              } else {
-                RecordStart(ctx.get());
-                s = fn();
-                RecordStop(ctx.get());
-              }
-              done(s);
-            });
+        //
+        // NOTE: The input element is moved into the closure and from there
+        // into the function, so that its tensors are handed off without
+        // copying the vector or touching the tensor buffer refcounts. The
+        // closure only needs raw pointers to `ctx` and `result` because `done`
+        // (which is moved into the same closure) keeps both alive.
+        IteratorContext* raw_ctx = ctx.get();
+        InvocationResult* raw_result = result.get();
+        auto fn = [this, raw_ctx, raw_result,
+                   input_element = std::move(input_element)]() mutable {
+          return instantiated_captured_func_->Run(
+              raw_ctx, std::move(input_element), &raw_result->return_values,
+              model_node());
+        };
+        (*ctx->runner())([this, raw_ctx, fn = std::move(fn),
+                          done = std::move(done)]() mutable {
+          Status s;
+          // Check whether we are already recording to prevent invalid
+          // nesting of `RecordStart` calls.
+          if (IsRecording(raw_ctx)) {
+            s = fn();
+          } else {
+            RecordStart(raw_ctx);
+            s = fn();
+            RecordStop(raw_ctx);
+          }
+          done(s);
+        });
       }
     }
 
@@ -575,6 +582,11 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
                invocation_results_.size() >= num_parallel_calls;
       };
       while (true) {
+        // Wait while the element buffers of all iterators in the process are
+        // over the buffer pool limit. This only fails if we are cancelled.
+        if (!WaitForBufferCapacity(cancellation_manager_.get()).ok()) {
+          return;
+        }
         {
           mutex_lock l(*mu_);
           while (!cancelled_ && busy()) {
@@ -520,6 +520,15 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
           }
         }
 
+        // Wait while the element buffers of all iterators in the process are
+        // over the buffer pool limit. This only fails if we are cancelled.
+        if (!WaitForBufferCapacity(cancellation_manager_.get()).ok()) {
+          mutex_lock l(*mu_);
+          prefetch_thread_finished_ = true;
+          cond_var_->notify_all();
+          return;
+        }
+
         if (dataset()->slack_period_ > 0 &&
             num_produced % dataset()->slack_period_ == 0) {
           // For the first element in the "burst", sleep for a bit if there is
@@ -14,6 +14,12 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -45,6 +51,58 @@ constexpr char kGcsFsPrefix[] = "gs://";
 constexpr char kS3FsPrefix[] = "s3://";
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64_t kS3BlockSize = kCloudTpuBlockSize;
+constexpr char kTFRecordReadaheadExperiment[] = "tfrecord_readahead";
+constexpr char kTFRecordStringViewsExperiment[] = "tfrecord_string_views";
+// With readahead, each file keeps about kReadaheadBytes in flight, which is as
+// much memory as the buffer used for GCS and S3 without readahead, in blocks of
+// at least kMinReadaheadBlockSize.
+constexpr int64_t kReadaheadBytes = 128LL << 20;       // 128MB.
+constexpr int64_t kMinReadaheadBlockSize = 8LL << 20;  // 8MB.
+constexpr int64_t kMinReadaheadBlocks = 2;
+// Records are read in batches of kReadBatchSize, so that their checksums are
+// verified together.
+constexpr int kReadBatchSize = 6;
+
+// The data of a batch of records, which the string tensors of the records
+// view.
+class RecordBlock : public core::RefCounted {
+ public:
+  tstring data;
+};
+
+// The buffer of a scalar string tensor whose string is a view of a record in
+// a block, which the buffer keeps alive. The buffer does not own its memory
+// so that kernels never forward it as an output.
+//
+// Copies of the string are views as well, which do not keep the block alive,
+// so consumers that copy the strings of elements into other tensors must
+// copy the data of views, as `batch_util` does.
+class RecordViewBuffer : public TensorBuffer {
+ public:
+  RecordViewBuffer(RecordBlock* block, StringPiece record)
+      : TensorBuffer(&record_), block_(block) {
+    block_->Ref();
+    record_.assign_as_view(record);
+  }
+
+  ~RecordViewBuffer() override { block_->Unref(); }
+
+  size_t size() const override { return sizeof(tstring); }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(sizeof(tstring));
+    proto->set_allocator_name("RecordBlock");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  tstring record_;
+  RecordBlock* const block_;
+};
 
 bool is_cloud_tpu_gcs_fs() {
 #if (defined(PLATFORM_CLOUD_TPU) && defined(TPU_GCS_FS)) || \
@@ -58,17 +116,20 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
                    const string& compression_type, int64_t buffer_size,
-                   std::vector<int64_t> byte_offsets, int op_version)
+                   int readahead_blocks, std::vector<int64_t> byte_offsets,
+                   bool string_views, int op_version)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
             compression_type)),
         byte_offsets_(std::move(byte_offsets)),
+        string_views_(string_views),
         op_version_(op_version) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
+    options_.readahead_blocks = readahead_blocks;
   }
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
@@ -135,19 +196,32 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       do {
         // We are currently processing a file, so try to read the next record.
         if (reader_) {
-          out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
-                                    TensorShape({}));
-          Status s =
-              reader_->ReadRecord(&out_tensors->back().scalar<tstring>()());
-          if (s.ok()) {
+          if (buffered_records_.empty() && buffered_status_.ok()) {
+            ReadRecordsLocked();
+          }
+          if (!buffered_records_.empty()) {
+            if (buffered_block_) {
+              // The buffered records are views of `buffered_block_`.
+              auto* buffer = new RecordViewBuffer(buffered_block_.get(),
+                                                  buffered_records_.front());
+              out_tensors->emplace_back(DT_STRING, TensorShape({}), buffer);
+              buffer->Unref();
+            } else {
+              out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
+                                        TensorShape({}));
+              out_tensors->back().scalar<tstring>()() =
+                  std::move(buffered_records_.front());
+            }
+            const tstring& record = out_tensors->back().scalar<tstring>()();
+            buffered_records_.pop_front();
             static monitoring::CounterCell* bytes_counter =
                 metrics::GetTFDataBytesReadCounter(kDatasetType);
-            bytes_counter->IncrementBy(
-                out_tensors->back().scalar<tstring>()().size());
+            bytes_counter->IncrementBy(record.size());
             *end_of_sequence = false;
             return OkStatus();
           }
-          out_tensors->pop_back();
+          // The records before the error have all been returned.
+          Status s = buffered_status_;
           if (!errors::IsOutOfRange(s)) {
             // In case of other errors e.g., DataLoss, we still move forward
             // the file index so that it works with ignore_errors.
@@ -181,11 +255,18 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
         // We are currently processing a file, so try to skip reading
         // the next (num_to_skip - *num_skipped) record.
         if (reader_) {
-          int last_num_skipped;
-          Status s = reader_->SkipRecords(num_to_skip - *num_skipped,
-                                          &last_num_skipped);
-          *num_skipped += last_num_skipped;
-          if (s.ok()) {
+          while (!buffered_records_.empty() && *num_skipped < num_to_skip) {
+            buffered_records_.pop_front();
+            ++*num_skipped;
+          }
+          Status s = buffered_status_;
+          if (s.ok() && *num_skipped < num_to_skip) {
+            int last_num_skipped;
+            s = reader_->SkipRecords(num_to_skip - *num_skipped,
+                                     &last_num_skipped);
+            *num_skipped += last_num_skipped;
+          }
+          if (s.ok() || *num_skipped == num_to_skip) {
             *end_of_sequence = false;
             return OkStatus();
           }
@@ -227,8 +308,13 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
                                              current_file_index_));
 
       if (reader_) {
-        TF_RETURN_IF_ERROR(
-            writer->WriteScalar(prefix(), kOffset, reader_->TellOffset()));
+        // Restoring starts reading at the first buffered record.
+        uint64 offset = reader_->TellOffset();
+        for (const tstring& record : buffered_records_) {
+          offset -= io::RecordReader::kHeaderSize + record.size() +
+                    io::RecordReader::kFooterSize;
+        }
+        TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kOffset, offset));
       }
       return OkStatus();
     }
@@ -272,8 +358,36 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       return OkStatus();
     }
 
+    // Reads the next batch of records into `buffered_records_`. With string
+    // views, the records share the data of one block instead of each
+    // allocating their own, and the block is reserved at the size of the
+    // previous one.
+    void ReadRecordsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!dataset()->string_views_) {
+        std::vector<tstring> records;
+        buffered_status_ = reader_->ReadRecords(kReadBatchSize, &records);
+        for (tstring& record : records) {
+          buffered_records_.push_back(std::move(record));
+        }
+        return;
+      }
+      buffered_block_.reset(new RecordBlock);
+      buffered_block_->data.reserve(last_block_size_);
+      std::vector<StringPiece> records;
+      buffered_status_ = reader_->ReadRecords(
+          kReadBatchSize, &buffered_block_->data, &records);
+      last_block_size_ = buffered_block_->data.size();
+      for (StringPiece record : records) {
+        buffered_records_.emplace_back();
+        buffered_records_.back().assign_as_view(record);
+      }
+    }
+
     // Resets all reader streams.
     void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      buffered_block_.reset();
+      buffered_records_.clear();
+      buffered_status_ = OkStatus();
       reader_.reset();
       file_.reset();
     }
@@ -285,12 +399,22 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // we must destroy `reader_` before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+    // Records read from `reader_` that have not been returned yet, and the
+    // status of reading the record after them.
+    std::deque<tstring> buffered_records_ TF_GUARDED_BY(mu_);
+    Status buffered_status_ TF_GUARDED_BY(mu_);
+    // With string views, the block that `buffered_records_` view, and the
+    // size of the last block.
+    core::RefCountPtr<RecordBlock> buffered_block_ TF_GUARDED_BY(mu_);
+    size_t last_block_size_ TF_GUARDED_BY(mu_) = 0;
   };
 
   const std::vector<string> filenames_;
   const tstring compression_type_;
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
+  // Whether the records are returned as views of blocks of records.
+  const bool string_views_;
   const int op_version_;
 };
 
@@ -308,6 +432,7 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
 
   bool is_gcs_fs = true;
   bool is_s3_fs = true;
+  bool is_remote_fs = true;
   std::vector<string> filenames;
   filenames.reserve(filenames_tensor->NumElements());
   for (int i = 0; i < filenames_tensor->NumElements(); ++i) {
@@ -315,6 +440,8 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
     filenames.push_back(filenames_tensor->flat<tstring>()(i));
     is_gcs_fs &= absl::StartsWith(filenames[i], kGcsFsPrefix);
     is_s3_fs &= absl::StartsWith(filenames[i], kS3FsPrefix);
+    is_remote_fs &= absl::StrContains(filenames[i], "://") &&
+                    !absl::StartsWith(filenames[i], "file://");
     metrics::RecordTFDataFilename(kDatasetType, filenames[i]);
   }
 
@@ -345,7 +472,21 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
     }
   }
 
-  if (is_gcs_fs && is_cloud_tpu_gcs_fs() && buffer_size < kCloudTpuBlockSize) {
+  int readahead_blocks = 0;
+  if (is_remote_fs && !filenames.empty() &&
+      GetExperiments().contains(kTFRecordReadaheadExperiment)) {
+    // Many smaller reads in flight hide the per-request latency of remote
+    // filesystems better than one large buffered read at a time, so the
+    // buffer size overrides below do not apply.
+    buffer_size = std::max(buffer_size, kMinReadaheadBlockSize);
+    readahead_blocks =
+        std::max(kMinReadaheadBlocks, kReadaheadBytes / buffer_size);
+    VLOG(2) << "Reading TFRecords with " << readahead_blocks
+            << " blocks of readahead of " << buffer_size << " bytes.";
+  }
+
+  if (readahead_blocks == 0 && is_gcs_fs && is_cloud_tpu_gcs_fs() &&
+      buffer_size < kCloudTpuBlockSize) {
     VLOG(2) << "User buffer size is too small for reading Cloud TPU "
             << "TFRecords stored in GCS. Overriding " << buffer_size
             << " to the minimum recommended buffer_size = "
@@ -353,15 +494,21 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
     buffer_size = kCloudTpuBlockSize;
   }
 
-  if (is_s3_fs && buffer_size < kS3BlockSize) {
+  if (readahead_blocks == 0 && is_s3_fs && buffer_size < kS3BlockSize) {
     VLOG(2) << "User buffer size is too small for reading "
             << "TFRecords stored in S3. Overriding " << buffer_size
             << " to the minimum recommended buffer_size = " << kS3BlockSize;
     buffer_size = kS3BlockSize;
   }
 
+  // String views save allocating each record, but the strings of the
+  // elements are then only valid while their tensors are.
+  const bool string_views =
+      GetExperiments().contains(kTFRecordStringViewsExperiment);
+
   *output = new Dataset(ctx, std::move(filenames), compression_type,
-                        buffer_size, std::move(byte_offsets), op_version_);
+                        buffer_size, readahead_blocks, std::move(byte_offsets),
+                        string_views, op_version_);
 }
 
 namespace {
@@ -15,9 +15,12 @@ limitations under the License.
 #include <string>
 
 #include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/util/batch_util.h"
 
 namespace tensorflow {
 namespace data {
@@ -333,6 +336,41 @@ TEST_F(TFRecordDatasetOpTest, InvalidByteOffsetsToSeek) {
       absl::StatusCode::kDataLoss);
 }
 
+// With string views, the records are views of the data read from the file,
+// and batching them copies their data.
+TEST_F(TFRecordDatasetOpTest, StringViews) {
+  setenv("TF_JOB_NAME", "test_job", /*overwrite=*/1);
+  setenv("TF_TASK_ID", "0", /*overwrite=*/1);
+  setenv("TF_DATA_EXPERIMENT_OPT_IN", "tfrecord_string_views",
+         /*overwrite=*/1);
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  const bool string_views =
+      GetExperiments().contains("tfrecord_string_views");
+
+  Tensor batch(DT_STRING, TensorShape({6}));
+  for (int i = 0; i < 6; ++i) {
+    bool end_of_sequence = false;
+    std::vector<Tensor> out_tensors;
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+    ASSERT_FALSE(end_of_sequence);
+    ASSERT_EQ(out_tensors.size(), 1);
+    EXPECT_EQ(out_tensors[0].scalar<tstring>()().type() == tstring::VIEW,
+              string_views);
+    TF_ASSERT_OK(
+        batch_util::CopyElementToSlice(std::move(out_tensors[0]), &batch, i));
+  }
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_NE(batch.flat<tstring>()(i).type(), tstring::VIEW);
+  }
+  test::ExpectTensorEqual<tstring>(
+      batch, test::AsTensor<tstring>({"1", "22", "333", "a", "bb", "ccc"}));
+  unsetenv("TF_JOB_NAME");
+  unsetenv("TF_TASK_ID");
+  unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
+}
+
 std::vector<IteratorSaveAndRestoreTestCase<TFRecordDatasetParams>>
 IteratorSaveAndRestoreTestCases() {
   return {
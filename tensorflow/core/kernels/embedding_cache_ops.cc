@@ -0,0 +1,244 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/embedding_cache_ops.h"
+
+#include <algorithm>
+
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+
+Status EmbeddingCache::ParsePolicy(const std::string& name, Policy* policy) {
+  if (name == "lru") {
+    *policy = Policy::kLru;
+  } else if (name == "lfu") {
+    *policy = Policy::kLfu;
+  } else {
+    return errors::InvalidArgument(
+        "EmbeddingCache policy must be lru or lfu, not ", name);
+  }
+  return OkStatus();
+}
+
+EmbeddingCache::EmbeddingCache(int64_t capacity, Policy policy)
+    : capacity_(capacity), policy_(policy) {
+  slots_.resize(capacity);
+  free_slots_.reserve(capacity);
+  // Slot 0 is used first.
+  for (int64_t i = capacity - 1; i >= 0; --i) free_slots_.push_back(i);
+}
+
+std::string EmbeddingCache::DebugString() const {
+  tf_shared_lock l(mu_);
+  return strings::StrCat("EmbeddingCache of ", slot_of_id_.size(), " of ",
+                         capacity_, " rows");
+}
+
+EmbeddingCache::EvictionKey EmbeddingCache::GetEvictionKey(int32 slot) const {
+  const Slot& s = slots_[slot];
+  if (policy_ == Policy::kLfu) {
+    return EvictionKey(s.num_uses, s.last_use, slot);
+  }
+  return EvictionKey(s.last_use, 0, slot);
+}
+
+Status EmbeddingCache::Lookup(absl::Span<const int64_t> ids, Update* update) {
+  mutex_lock l(mu_);
+  const uint64_t previous_lookup = num_lookups_;
+  const uint64_t lookup = num_lookups_ + 1;
+
+  // Checks that there are enough slots before changing anything. The slots
+  // of the previous lookup and the hits of this one cannot be evicted.
+  absl::flat_hash_set<int64_t> misses;
+  absl::flat_hash_set<int32> other_hits;
+  for (int64_t id : ids) {
+    auto iter = slot_of_id_.find(id);
+    if (iter == slot_of_id_.end()) {
+      misses.insert(id);
+    } else if (slots_[iter->second].last_use != previous_lookup) {
+      other_hits.insert(iter->second);
+    }
+  }
+  const int64_t num_evictable = free_slots_.size() + slot_of_id_.size() -
+                                num_previous_slots_ - other_hits.size();
+  if (misses.size() > num_evictable) {
+    return errors::ResourceExhausted(
+        "EmbeddingCache with ", capacity_, " rows cannot cache the ",
+        misses.size(), " missing ids of a lookup, as only ", num_evictable,
+        " rows are not used by it or by the previous lookup");
+  }
+
+  update->slots.resize(ids.size());
+  update->miss_ids.clear();
+  update->miss_slots.clear();
+  update->evicted_ids.clear();
+  update->evicted_slots.clear();
+  int64_t num_slots = 0;
+  for (int64_t i = 0; i < ids.size(); ++i) {
+    const int64_t id = ids[i];
+    auto iter = slot_of_id_.find(id);
+    if (iter != slot_of_id_.end()) {
+      const int32 slot = iter->second;
+      update->slots[i] = slot;
+      Slot& s = slots_[slot];
+      if (s.last_use != lookup) {
+        ++num_slots;
+        eviction_order_.erase(GetEvictionKey(slot));
+        s.last_use = lookup;
+        ++s.num_uses;
+        eviction_order_.insert(GetEvictionKey(slot));
+      }
+      continue;
+    }
+    int32 slot;
+    if (!free_slots_.empty()) {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    } else {
+      auto victim = eviction_order_.begin();
+      while (slots_[std::get<2>(*victim)].last_use >= previous_lookup) {
+        ++victim;
+      }
+      slot = std::get<2>(*victim);
+      eviction_order_.erase(victim);
+      update->evicted_ids.push_back(slots_[slot].id);
+      update->evicted_slots.push_back(slot);
+      slot_of_id_.erase(slots_[slot].id);
+    }
+    Slot& s = slots_[slot];
+    s.id = id;
+    s.used = true;
+    s.last_use = lookup;
+    s.num_uses = 1;
+    eviction_order_.insert(GetEvictionKey(slot));
+    slot_of_id_[id] = slot;
+    ++num_slots;
+    update->slots[i] = slot;
+    update->miss_ids.push_back(id);
+    update->miss_slots.push_back(slot);
+  }
+  num_lookups_ = lookup;
+  num_previous_slots_ = num_slots;
+  return OkStatus();
+}
+
+void EmbeddingCache::Entries(std::vector<int64_t>* ids,
+                             std::vector<int32>* slots) const {
+  tf_shared_lock l(mu_);
+  ids->clear();
+  slots->clear();
+  for (int32 slot = 0; slot < slots_.size(); ++slot) {
+    if (!slots_[slot].used) continue;
+    ids->push_back(slots_[slot].id);
+    slots->push_back(slot);
+  }
+}
+
+namespace {
+
+template <typename T>
+Status SetVectorOutput(OpKernelContext* ctx, int index,
+                       const std::vector<T>& values) {
+  Tensor* output = nullptr;
+  const int64_t size = values.size();
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_output(index, TensorShape({size}), &output));
+  std::copy(values.begin(), values.end(), output->flat<T>().data());
+  return OkStatus();
+}
+
+class EmbeddingCacheLookupOp : public OpKernel {
+ public:
+  explicit EmbeddingCacheLookupOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("capacity", &capacity_));
+    OP_REQUIRES(ctx, capacity_ > 0 && capacity_ <= kint32max,
+                errors::InvalidArgument(
+                    "EmbeddingCache capacity must be in [1, 2^31), not ",
+                    capacity_));
+    std::string policy;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("policy", &policy));
+    OP_REQUIRES_OK(ctx, EmbeddingCache::ParsePolicy(policy, &policy_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    core::RefCountPtr<EmbeddingCache> cache;
+    OP_REQUIRES_OK(ctx, LookupOrCreateResource<EmbeddingCache>(
+                            ctx, HandleFromInput(ctx, 0), &cache,
+                            [this](EmbeddingCache** cache) {
+                              *cache = new EmbeddingCache(capacity_, policy_);
+                              return OkStatus();
+                            }));
+    OP_REQUIRES(ctx,
+                cache->capacity() == capacity_ && cache->policy() == policy_,
+                errors::InvalidArgument(
+                    "The capacity of ", capacity_, " or the policy of ", name(),
+                    " differ from those of its EmbeddingCache, which has a "
+                    "capacity of ",
+                    cache->capacity()));
+    const Tensor& ids = ctx->input(1);
+    const auto ids_flat = ids.flat<int64_t>();
+    EmbeddingCache::Update update;
+    OP_REQUIRES_OK(ctx, cache->Lookup(absl::MakeConstSpan(ids_flat.data(),
+                                                          ids_flat.size()),
+                                      &update));
+
+    Tensor* slots = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, ids.shape(), &slots));
+    std::copy(update.slots.begin(), update.slots.end(),
+              slots->flat<int32>().data());
+    OP_REQUIRES_OK(ctx, SetVectorOutput(ctx, 1, update.miss_ids));
+    OP_REQUIRES_OK(ctx, SetVectorOutput(ctx, 2, update.miss_slots));
+    OP_REQUIRES_OK(ctx, SetVectorOutput(ctx, 3, update.evicted_ids));
+    OP_REQUIRES_OK(ctx, SetVectorOutput(ctx, 4, update.evicted_slots));
+  }
+
+ private:
+  int64_t capacity_;
+  EmbeddingCache::Policy policy_;
+};
+
+class EmbeddingCacheEntriesOp : public OpKernel {
+ public:
+  explicit EmbeddingCacheEntriesOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    core::RefCountPtr<EmbeddingCache> cache;
+    OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &cache));
+    std::vector<int64_t> ids;
+    std::vector<int32> slots;
+    cache->Entries(&ids, &slots);
+    OP_REQUIRES_OK(ctx, SetVectorOutput(ctx, 0, ids));
+    OP_REQUIRES_OK(ctx, SetVectorOutput(ctx, 1, slots));
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("EmbeddingCacheHandleOp").Device(DEVICE_CPU),
+                        ResourceHandleOp<EmbeddingCache>);
+REGISTER_KERNEL_BUILDER(Name("EmbeddingCacheLookup").Device(DEVICE_CPU),
+                        EmbeddingCacheLookupOp);
+REGISTER_KERNEL_BUILDER(Name("EmbeddingCacheEntries").Device(DEVICE_CPU),
+                        EmbeddingCacheEntriesOp);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,115 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_EMBEDDING_CACHE_OPS_H_
+#define TENSORFLOW_CORE_KERNELS_EMBEDDING_CACHE_OPS_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/resource_base.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// The ids in the rows of a cache variable, which holds the hot rows of a
+// large embedding table. The cache only maps ids to rows ("slots"); the rows
+// themselves are moved by ResourceGather and ResourceScatterUpdate, so that
+// they can be copied between a host table and a device cache like any other
+// tensors, and updated in the cache by the sparse apply ops.
+//
+// The rows used by the last two lookups are never evicted, so that the next
+// batch can be looked up (and its missing rows copied in) while the current
+// batch still uses its rows.
+class EmbeddingCache : public ResourceBase {
+ public:
+  enum class Policy {
+    // Evicts the least recently used row.
+    kLru,
+    // Evicts the least frequently used row, and of those the least recently
+    // used one.
+    kLfu,
+  };
+
+  static Status ParsePolicy(const std::string& name, Policy* policy);
+
+  // What a lookup changed, and what has to be copied for it.
+  struct Update {
+    // The slot of each looked up id.
+    std::vector<int32> slots;
+    // The ids that were not cached, and the slots that their rows have to be
+    // copied to from the table.
+    std::vector<int64_t> miss_ids;
+    std::vector<int32> miss_slots;
+    // The ids that were evicted, and the slots that their rows have to be
+    // written back from before the rows of the misses overwrite them.
+    std::vector<int64_t> evicted_ids;
+    std::vector<int32> evicted_slots;
+  };
+
+  EmbeddingCache(int64_t capacity, Policy policy);
+
+  std::string DebugString() const override;
+
+  int64_t capacity() const { return capacity_; }
+  Policy policy() const { return policy_; }
+
+  // Assigns a slot to each of "ids", evicting other ids as needed. Fails with
+  // ResourceExhausted if the capacity is too small for the distinct ids of
+  // this and the previous lookup, in which case the cache is unchanged.
+  Status Lookup(absl::Span<const int64_t> ids, Update* update)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the cached ids and their slots, ordered by slot.
+  void Entries(std::vector<int64_t>* ids, std::vector<int32>* slots) const
+      TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct Slot {
+    int64_t id = 0;
+    bool used = false;
+    // The lookup that last used the slot.
+    uint64_t last_use = 0;
+    // The number of lookups that used the slot since it was filled.
+    uint64_t num_uses = 0;
+  };
+
+  // Orders slots by how soon they should be evicted.
+  typedef std::tuple<uint64_t, uint64_t, int32> EvictionKey;
+  EvictionKey GetEvictionKey(int32 slot) const TF_SHARED_LOCKS_REQUIRED(mu_);
+
+  const int64_t capacity_;
+  const Policy policy_;
+  mutable mutex mu_;
+  uint64_t num_lookups_ TF_GUARDED_BY(mu_) = 0;
+  // The number of distinct slots that the last lookup used.
+  int64_t num_previous_slots_ TF_GUARDED_BY(mu_) = 0;
+  std::vector<Slot> slots_ TF_GUARDED_BY(mu_);
+  std::vector<int32> free_slots_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<int64_t, int32> slot_of_id_ TF_GUARDED_BY(mu_);
+  std::set<EvictionKey> eviction_order_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_EMBEDDING_CACHE_OPS_H_
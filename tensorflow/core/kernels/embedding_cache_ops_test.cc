@@ -0,0 +1,125 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/embedding_cache_ops.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(EmbeddingCacheTest, LruEvictsLeastRecentlyUsed) {
+  EmbeddingCache cache(4, EmbeddingCache::Policy::kLru);
+  EmbeddingCache::Update update;
+  TF_ASSERT_OK(cache.Lookup({10, 11, 10}, &update));
+  EXPECT_THAT(update.slots, ElementsAre(0, 1, 0));
+  EXPECT_THAT(update.miss_ids, ElementsAre(10, 11));
+  EXPECT_THAT(update.miss_slots, ElementsAre(0, 1));
+  EXPECT_THAT(update.evicted_ids, IsEmpty());
+
+  TF_ASSERT_OK(cache.Lookup({12, 13}, &update));
+  EXPECT_THAT(update.slots, ElementsAre(2, 3));
+  TF_ASSERT_OK(cache.Lookup({11}, &update));
+  EXPECT_THAT(update.miss_ids, IsEmpty());
+  EXPECT_THAT(update.slots, ElementsAre(1));
+
+  // 10 is the least recently used id, then 12.
+  TF_ASSERT_OK(cache.Lookup({14}, &update));
+  EXPECT_THAT(update.slots, ElementsAre(0));
+  EXPECT_THAT(update.evicted_ids, ElementsAre(10));
+  EXPECT_THAT(update.evicted_slots, ElementsAre(0));
+  TF_ASSERT_OK(cache.Lookup({15}, &update));
+  EXPECT_THAT(update.evicted_ids, ElementsAre(12));
+
+  std::vector<int64_t> ids;
+  std::vector<int32> slots;
+  cache.Entries(&ids, &slots);
+  EXPECT_THAT(ids, ElementsAre(14, 11, 15, 13));
+  EXPECT_THAT(slots, ElementsAre(0, 1, 2, 3));
+}
+
+TEST(EmbeddingCacheTest, LfuEvictsLeastFrequentlyUsed) {
+  EmbeddingCache cache(3, EmbeddingCache::Policy::kLfu);
+  EmbeddingCache::Update update;
+  TF_ASSERT_OK(cache.Lookup({10, 11}, &update));
+  TF_ASSERT_OK(cache.Lookup({10, 12}, &update));
+  TF_ASSERT_OK(cache.Lookup({10}, &update));
+  TF_ASSERT_OK(cache.Lookup({10}, &update));
+  // 11 and 12 were used once, and 11 less recently.
+  TF_ASSERT_OK(cache.Lookup({13}, &update));
+  EXPECT_THAT(update.evicted_ids, ElementsAre(11));
+  EXPECT_THAT(update.slots, ElementsAre(1));
+}
+
+TEST(EmbeddingCacheTest, FailsWithoutChangesWhenTooSmall) {
+  EmbeddingCache cache(3, EmbeddingCache::Policy::kLru);
+  EmbeddingCache::Update update;
+  TF_ASSERT_OK(cache.Lookup({10, 11}, &update));
+  // Only one row is not used by the previous lookup.
+  EXPECT_TRUE(errors::IsResourceExhausted(cache.Lookup({12, 13}, &update)));
+  TF_ASSERT_OK(cache.Lookup({11, 12}, &update));
+  EXPECT_THAT(update.slots, ElementsAre(1, 2));
+  EXPECT_THAT(update.evicted_ids, IsEmpty());
+}
+
+class EmbeddingCacheLookupOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(int64_t capacity) {
+    TF_ASSERT_OK(NodeDefBuilder("lookup", "EmbeddingCacheLookup")
+                     .Input(FakeInput(DT_RESOURCE))
+                     .Input(FakeInput(DT_INT64))
+                     .Attr("capacity", capacity)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(EmbeddingCacheLookupOpTest, Lookup) {
+  MakeOp(2);
+  AddResourceInput("", "cache",
+                   new EmbeddingCache(2, EmbeddingCache::Policy::kLru));
+  AddInputFromArray<int64_t>(TensorShape({2, 2}), {7, 8, 8, 7});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int32>(
+      *GetOutput(0), test::AsTensor<int32>({0, 1, 1, 0}, TensorShape({2, 2})));
+  test::ExpectTensorEqual<int64_t>(*GetOutput(1),
+                                   test::AsTensor<int64_t>({7, 8}));
+  test::ExpectTensorEqual<int32>(*GetOutput(2), test::AsTensor<int32>({0, 1}));
+  EXPECT_EQ(GetOutput(3)->NumElements(), 0);
+  EXPECT_EQ(GetOutput(4)->NumElements(), 0);
+}
+
+TEST_F(EmbeddingCacheLookupOpTest, CapacityMismatch) {
+  MakeOp(3);
+  AddResourceInput("", "cache",
+                   new EmbeddingCache(2, EmbeddingCache::Policy::kLru));
+  AddInputFromArray<int64_t>(TensorShape({1}), {7});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -17,10 +17,14 @@ limitations under the License.
 
 // See docs in ../ops/fft_ops.cc.
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -35,11 +39,12 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if (defined(GOOGLE_CUDA) && GOOGLE_CUDA) || \
     (defined(TENSORFLOW_USE_ROCM) && TENSORFLOW_USE_ROCM)
-#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/util/env_var.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -146,6 +151,153 @@ absl::Status DuccFftImpl(const Eigen::ThreadPoolDevice& device,
   return absl::OkStatus();
 }
 
+// Process-wide cache of 1-D DUCC plans keyed by transform length. Plans are
+// immutable, so a cached plan can be used by any number of kernels at once.
+template <typename Plan>
+class CpuFftPlanCache {
+ public:
+  using Factory = std::unique_ptr<const Plan> (*)(size_t length);
+
+  // Capacity is somewhat arbitrary; it bounds the twiddle tables kept alive
+  // for workloads that see many distinct lengths.
+  static constexpr size_t kCapacity = 256;
+
+  explicit CpuFftPlanCache(Factory factory) : factory_(factory) {}
+
+  // Returns the plan for `length`, creating it if it isn't cached yet.
+  std::shared_ptr<const Plan> Get(size_t length) {
+    {
+      tf_shared_lock lock(mu_);
+      auto it = plans_.find(length);
+      if (it != plans_.end()) return it->second;
+    }
+    std::shared_ptr<const Plan> plan = factory_(length);
+    mutex_lock lock(mu_);
+    if (plans_.size() >= kCapacity) return plan;
+    return plans_.try_emplace(length, std::move(plan)).first->second;
+  }
+
+ private:
+  const Factory factory_;
+  mutex mu_;
+  absl::flat_hash_map<size_t, std::shared_ptr<const Plan>> plans_
+      TF_GUARDED_BY(mu_);
+};
+
+template <typename RealScalar>
+std::shared_ptr<const ducc0::google::C2CPlan1D<RealScalar>> GetC2CPlan1D(
+    size_t length) {
+  static auto* cache =
+      new CpuFftPlanCache<ducc0::google::C2CPlan1D<RealScalar>>(
+          ducc0::google::MakeC2CPlan1D<RealScalar>);
+  return cache->Get(length);
+}
+
+template <typename RealScalar>
+std::shared_ptr<const ducc0::google::RealPlan1D<RealScalar>> GetRealPlan1D(
+    size_t length) {
+  static auto* cache =
+      new CpuFftPlanCache<ducc0::google::RealPlan1D<RealScalar>>(
+          ducc0::google::MakeRealPlan1D<RealScalar>);
+  return cache->Get(length);
+}
+
+// Calls `fn(in, in_distance, out, out_distance, num_rows)` on ranges of the
+// rows of the innermost dimension of `in` and `out`, sharded over the intra-op
+// thread pool.
+template <typename InT, typename OutT, typename Fn>
+void ShardFft1DRows(OpKernelContext* ctx, const Tensor& in, Tensor* out,
+                    uint64_t fft_length, Fn fn) {
+  const int64_t in_distance = in.dim_size(in.dims() - 1);
+  const int64_t out_distance = out->dim_size(out->dims() - 1);
+  const int64_t num_rows = out->NumElements() / out_distance;
+  const InT* input = in.flat<InT>().data();
+  OutT* output = out->flat<OutT>().data();
+
+  // Roughly 5 n log2(n) flops per transform.
+  const int64_t cost_per_row = static_cast<int64_t>(
+      5 * fft_length * std::max(1.0, std::log2(fft_length)));
+  auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+        cost_per_row, [&](int64_t start, int64_t limit) {
+          fn(input + start * in_distance, in_distance,
+             output + start * out_distance, out_distance, limit - start);
+        });
+}
+
+// 1-D transform over the innermost dimension using cached plans. Unlike
+// DuccFftImpl, which sets up a DUCC transform on every call, this reuses the
+// plan across calls and parallelizes over the batch with the work sharder,
+// which suits many short transforms.
+absl::Status DuccFft1DImpl(OpKernelContext* ctx, const Tensor& in, Tensor* out,
+                           uint64_t fft_length, bool forward) {
+  if (out->NumElements() == 0) return absl::OkStatus();
+  const double scale = forward ? 1.0 : 1.0 / fft_length;
+
+  if (in.dtype() == DT_COMPLEX128 && out->dtype() == DT_COMPLEX128) {
+    auto plan = GetC2CPlan1D<double>(fft_length);
+    ShardFft1DRows<complex128, complex128>(
+        ctx, in, out, fft_length,
+        [&](const complex128* src, int64_t src_distance, complex128* dst,
+            int64_t dst_distance, int64_t num_rows) {
+          plan->c2c(src, src_distance, dst, dst_distance, num_rows, forward,
+                    scale);
+        });
+  } else if (in.dtype() == DT_COMPLEX64 && out->dtype() == DT_COMPLEX64) {
+    auto plan = GetC2CPlan1D<float>(fft_length);
+    ShardFft1DRows<complex64, complex64>(
+        ctx, in, out, fft_length,
+        [&](const complex64* src, int64_t src_distance, complex64* dst,
+            int64_t dst_distance, int64_t num_rows) {
+          plan->c2c(src, src_distance, dst, dst_distance, num_rows, forward,
+                    static_cast<float>(scale));
+        });
+  } else if (in.dtype() == DT_DOUBLE && out->dtype() == DT_COMPLEX128 &&
+             forward) {
+    auto plan = GetRealPlan1D<double>(fft_length);
+    ShardFft1DRows<double, complex128>(
+        ctx, in, out, fft_length,
+        [&](const double* src, int64_t src_distance, complex128* dst,
+            int64_t dst_distance, int64_t num_rows) {
+          plan->r2c(src, src_distance, dst, dst_distance, num_rows, scale);
+        });
+  } else if (in.dtype() == DT_FLOAT && out->dtype() == DT_COMPLEX64 &&
+             forward) {
+    auto plan = GetRealPlan1D<float>(fft_length);
+    ShardFft1DRows<float, complex64>(
+        ctx, in, out, fft_length,
+        [&](const float* src, int64_t src_distance, complex64* dst,
+            int64_t dst_distance, int64_t num_rows) {
+          plan->r2c(src, src_distance, dst, dst_distance, num_rows,
+                    static_cast<float>(scale));
+        });
+  } else if (in.dtype() == DT_COMPLEX128 && out->dtype() == DT_DOUBLE &&
+             !forward) {
+    auto plan = GetRealPlan1D<double>(fft_length);
+    ShardFft1DRows<complex128, double>(
+        ctx, in, out, fft_length,
+        [&](const complex128* src, int64_t src_distance, double* dst,
+            int64_t dst_distance, int64_t num_rows) {
+          plan->c2r(src, src_distance, dst, dst_distance, num_rows, scale);
+        });
+  } else if (in.dtype() == DT_COMPLEX64 && out->dtype() == DT_FLOAT &&
+             !forward) {
+    auto plan = GetRealPlan1D<float>(fft_length);
+    ShardFft1DRows<complex64, float>(
+        ctx, in, out, fft_length,
+        [&](const complex64* src, int64_t src_distance, float* dst,
+            int64_t dst_distance, int64_t num_rows) {
+          plan->c2r(src, src_distance, dst, dst_distance, num_rows,
+                    static_cast<float>(scale));
+        });
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid FFT parameters, in.dtype=", in.dtype(),
+                     ", out->dtype=", out->dtype(), ", forward=", forward));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 class FFTBase : public OpKernel {
@@ -392,6 +544,11 @@ class FFTCPU : public FFTBase {
 
   void DoFFT(OpKernelContext* ctx, const Tensor& in, uint64* fft_shape,
              Tensor* out) override {
+    if (FFTRank == 1) {
+      OP_REQUIRES_OK(ctx, DuccFft1DImpl(ctx, in, out, fft_shape[0], Forward));
+      return;
+    }
+
     std::vector<size_t> axes(Rank());
     int batch_dims = in.dims() - FFTRank;
 
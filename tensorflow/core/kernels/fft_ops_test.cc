@@ -0,0 +1,208 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+// Naive DFT of the first `length` values of `x`. The inverse transform is
+// scaled by 1 / length, like the IFFT ops.
+std::vector<complex128> NaiveDft(const std::vector<complex128>& x, int length,
+                                 bool forward) {
+  std::vector<complex128> result(length);
+  const double sign = forward ? -1.0 : 1.0;
+  for (int k = 0; k < length; ++k) {
+    for (int j = 0; j < length; ++j) {
+      result[k] += x[j] * std::polar(1.0, sign * 2.0 * M_PI * j * k / length);
+    }
+    if (!forward) result[k] /= length;
+  }
+  return result;
+}
+
+class FFTOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& op, DataType input_type, bool real) {
+    NodeDefBuilder builder("fft_op", op);
+    builder.Input(FakeInput(input_type));
+    if (real) builder.Input(FakeInput(DT_INT32));
+    TF_ASSERT_OK(builder.Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    inputs_.clear();
+  }
+};
+
+TEST_F(FFTOpTest, BatchedFFTMatchesNaiveDft) {
+  for (bool forward : {true, false}) {
+    for (int length : {1, 5, 8, 12}) {
+      MakeOp(forward ? "FFT" : "IFFT", DT_COMPLEX64, /*real=*/false);
+      const int batch = 7;
+      std::vector<complex64> input(batch * length);
+      for (int i = 0; i < input.size(); ++i) {
+        input[i] = complex64(std::sin(i * 0.7f), std::cos(i * 1.3f));
+      }
+      AddInputFromArray<complex64>(TensorShape({batch, length}), input);
+      TF_ASSERT_OK(RunOpKernel());
+
+      Tensor expected(allocator(), DT_COMPLEX64, TensorShape({batch, length}));
+      auto expected_flat = expected.flat<complex64>();
+      for (int b = 0; b < batch; ++b) {
+        std::vector<complex128> row(input.begin() + b * length,
+                                    input.begin() + (b + 1) * length);
+        std::vector<complex128> dft = NaiveDft(row, length, forward);
+        for (int k = 0; k < length; ++k) {
+          expected_flat(b * length + k) = complex64(dft[k]);
+        }
+      }
+      test::ExpectClose(expected, *GetOutput(0), /*atol=*/1e-4);
+    }
+  }
+}
+
+TEST_F(FFTOpTest, BatchedRFFTMatchesNaiveDft) {
+  for (int length : {1, 2, 7, 16}) {
+    MakeOp("RFFT", DT_FLOAT, /*real=*/true);
+    const int batch = 5;
+    // The input rows are longer than the FFT; the tail is ignored.
+    const int row_length = length + 3;
+    std::vector<float> input(batch * row_length);
+    for (int i = 0; i < input.size(); ++i) {
+      input[i] = std::sin(i * 0.37f);
+    }
+    AddInputFromArray<float>(TensorShape({batch, row_length}), input);
+    AddInputFromArray<int32>(TensorShape({1}), {length});
+    TF_ASSERT_OK(RunOpKernel());
+
+    const int inner = length / 2 + 1;
+    Tensor expected(allocator(), DT_COMPLEX64, TensorShape({batch, inner}));
+    auto expected_flat = expected.flat<complex64>();
+    for (int b = 0; b < batch; ++b) {
+      std::vector<complex128> row(input.begin() + b * row_length,
+                                  input.begin() + b * row_length + length);
+      std::vector<complex128> dft = NaiveDft(row, length, /*forward=*/true);
+      for (int k = 0; k < inner; ++k) {
+        expected_flat(b * inner + k) = complex64(dft[k]);
+      }
+    }
+    test::ExpectClose(expected, *GetOutput(0), /*atol=*/1e-4);
+  }
+}
+
+TEST_F(FFTOpTest, BatchedIRFFTInvertsRFFT) {
+  for (int length : {1, 2, 7, 16}) {
+    const int batch = 3;
+    const int inner = length / 2 + 1;
+    // Build the spectrum of a known real signal.
+    std::vector<double> signal(batch * length);
+    std::vector<complex128> spectrum(batch * inner);
+    for (int b = 0; b < batch; ++b) {
+      std::vector<complex128> row(length);
+      for (int j = 0; j < length; ++j) {
+        signal[b * length + j] = std::cos((b * length + j) * 0.51);
+        row[j] = signal[b * length + j];
+      }
+      std::vector<complex128> dft = NaiveDft(row, length, /*forward=*/true);
+      std::copy_n(dft.begin(), inner, spectrum.begin() + b * inner);
+    }
+
+    MakeOp("IRFFT", DT_COMPLEX128, /*real=*/true);
+    AddInputFromArray<complex128>(TensorShape({batch, inner}), spectrum);
+    AddInputFromArray<int32>(TensorShape({1}), {length});
+    TF_ASSERT_OK(RunOpKernel());
+
+    Tensor expected(allocator(), DT_DOUBLE, TensorShape({batch, length}));
+    test::FillValues<double>(&expected, signal);
+    test::ExpectClose(expected, *GetOutput(0), /*atol=*/1e-10);
+  }
+}
+
+Graph* BatchedRFFT(int batch, int length) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DT_FLOAT, TensorShape({batch, length}));
+  input.flat<float>().setRandom();
+  Tensor fft_length(DT_INT32, TensorShape({1}));
+  fft_length.flat<int32>()(0) = length;
+  Node* rfft;
+  TF_CHECK_OK(NodeBuilder(g->NewName("rfft"), "RFFT")
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, fft_length))
+                  .Finalize(g, &rfft));
+  return g;
+}
+
+Graph* BatchedFFT(int batch, int length) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DT_COMPLEX64, TensorShape({batch, length}));
+  input.flat<complex64>().setRandom();
+  Node* fft;
+  TF_CHECK_OK(NodeBuilder(g->NewName("fft"), "FFT")
+                  .Input(test::graph::Constant(g, input))
+                  .Finalize(g, &fft));
+  return g;
+}
+
+void BM_BatchedRFFT(::testing::benchmark::State& state) {
+  const int batch = state.range(0);
+  const int length = state.range(1);
+  test::Benchmark("cpu", BatchedRFFT(batch, length),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * batch);
+}
+BENCHMARK(BM_BatchedRFFT)
+    ->UseRealTime()
+    ->ArgPair(1, 512)
+    ->ArgPair(256, 256)
+    ->ArgPair(256, 512)
+    ->ArgPair(4096, 256)
+    ->ArgPair(4096, 512)
+    ->ArgPair(4096, 400)
+    ->ArgPair(64, 16384);
+
+void BM_BatchedFFT(::testing::benchmark::State& state) {
+  const int batch = state.range(0);
+  const int length = state.range(1);
+  test::Benchmark("cpu", BatchedFFT(batch, length),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * batch);
+}
+BENCHMARK(BM_BatchedFFT)
+    ->UseRealTime()
+    ->ArgPair(1, 512)
+    ->ArgPair(256, 512)
+    ->ArgPair(4096, 256)
+    ->ArgPair(4096, 512)
+    ->ArgPair(64, 16384);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,286 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Implements _FusedElementwise, which Grappler's remapper creates for trees of
+// elementwise ops on CPU. The ops run block by block, so that the
+// intermediate values of a block stay in cache instead of being written to
+// memory as whole tensors.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+enum class FusedOp {
+  kAbs,
+  kCeil,
+  kExp,
+  kFloor,
+  kLog,
+  kNeg,
+  kReciprocal,
+  kRelu,
+  kRsqrt,
+  kSigmoid,
+  kSqrt,
+  kSquare,
+  kTanh,
+  // Binary ops follow.
+  kAdd,
+  kDiv,
+  kMaximum,
+  kMinimum,
+  kMul,
+  kSquaredDifference,
+  kSub,
+};
+
+bool IsBinary(FusedOp op) { return op >= FusedOp::kAdd; }
+
+Status ParseFusedOp(const string& name, FusedOp* op) {
+  static const auto* const kOps = new std::vector<std::pair<string, FusedOp>>{
+      {"Abs", FusedOp::kAbs},
+      {"Ceil", FusedOp::kCeil},
+      {"Exp", FusedOp::kExp},
+      {"Floor", FusedOp::kFloor},
+      {"Log", FusedOp::kLog},
+      {"Neg", FusedOp::kNeg},
+      {"Reciprocal", FusedOp::kReciprocal},
+      {"Relu", FusedOp::kRelu},
+      {"Rsqrt", FusedOp::kRsqrt},
+      {"Sigmoid", FusedOp::kSigmoid},
+      {"Sqrt", FusedOp::kSqrt},
+      {"Square", FusedOp::kSquare},
+      {"Tanh", FusedOp::kTanh},
+      {"Add", FusedOp::kAdd},
+      {"AddV2", FusedOp::kAdd},
+      {"Div", FusedOp::kDiv},
+      {"RealDiv", FusedOp::kDiv},
+      {"Maximum", FusedOp::kMaximum},
+      {"Minimum", FusedOp::kMinimum},
+      {"Mul", FusedOp::kMul},
+      {"SquaredDifference", FusedOp::kSquaredDifference},
+      {"Sub", FusedOp::kSub},
+  };
+  for (const auto& entry : *kOps) {
+    if (entry.first == name) {
+      *op = entry.second;
+      return OkStatus();
+    }
+  }
+  return errors::InvalidArgument("_FusedElementwise does not support ", name);
+}
+
+// The number of elements that each step computes at a time. The values of a
+// block for 20 steps take 80KB.
+constexpr int64_t kBlockSize = 1024;
+
+typedef Eigen::Map<Eigen::ArrayXf> ArrayMap;
+typedef Eigen::Map<const Eigen::ArrayXf> ConstArrayMap;
+
+void ComputeStep(FusedOp op, const float* x, const float* y, int64_t n,
+                 float* out) {
+  ConstArrayMap a(x, n);
+  ArrayMap z(out, n);
+  if (IsBinary(op)) {
+    ConstArrayMap b(y, n);
+    switch (op) {
+      case FusedOp::kAdd:
+        z = a + b;
+        return;
+      case FusedOp::kDiv:
+        z = a / b;
+        return;
+      case FusedOp::kMaximum:
+        z = a.template max<Eigen::PropagateNaN>(b);
+        return;
+      case FusedOp::kMinimum:
+        z = a.template min<Eigen::PropagateNaN>(b);
+        return;
+      case FusedOp::kMul:
+        z = a * b;
+        return;
+      case FusedOp::kSquaredDifference:
+        z = (a - b).square();
+        return;
+      case FusedOp::kSub:
+        z = a - b;
+        return;
+      default:
+        break;
+    }
+  }
+  switch (op) {
+    case FusedOp::kAbs:
+      z = a.abs();
+      return;
+    case FusedOp::kCeil:
+      z = a.ceil();
+      return;
+    case FusedOp::kExp:
+      z = a.exp();
+      return;
+    case FusedOp::kFloor:
+      z = a.floor();
+      return;
+    case FusedOp::kLog:
+      z = a.log();
+      return;
+    case FusedOp::kNeg:
+      z = -a;
+      return;
+    case FusedOp::kReciprocal:
+      z = a.inverse();
+      return;
+    case FusedOp::kRelu:
+      z = a.template max<Eigen::PropagateNaN>(0.0f);
+      return;
+    case FusedOp::kRsqrt:
+      z = a.rsqrt();
+      return;
+    case FusedOp::kSigmoid:
+      z = a.logistic();
+      return;
+    case FusedOp::kSqrt:
+      z = a.sqrt();
+      return;
+    case FusedOp::kSquare:
+      z = a.square();
+      return;
+    case FusedOp::kTanh:
+      z = a.tanh();
+      return;
+    default:
+      return;
+  }
+}
+
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    int num_inputs;
+    OP_REQUIRES_OK(context, context->GetAttr("N", &num_inputs));
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES_OK(context, context->GetAttr("operands", &operands_));
+    OP_REQUIRES(context, !fused_ops.empty(),
+                errors::InvalidArgument("_FusedElementwise has no fused ops"));
+    OP_REQUIRES(
+        context, operands_.size() == 2 * fused_ops.size(),
+        errors::InvalidArgument("_FusedElementwise needs 2 operands per fused "
+                                "op, not ",
+                                operands_.size(), " for ", fused_ops.size()));
+    ops_.resize(fused_ops.size());
+    for (int i = 0; i < fused_ops.size(); ++i) {
+      OP_REQUIRES_OK(context, ParseFusedOp(fused_ops[i], &ops_[i]));
+      // Step i can use the inputs and the results of the steps before it.
+      const int num_values = num_inputs + i;
+      const int x = operands_[2 * i];
+      const int y = operands_[2 * i + 1];
+      OP_REQUIRES(context,
+                  x >= 0 && x < num_values &&
+                      (IsBinary(ops_[i]) ? y >= 0 && y < num_values : y == -1),
+                  errors::InvalidArgument("Invalid operands ", x, " and ", y,
+                                          " for step ", i, " (", fused_ops[i],
+                                          ") of _FusedElementwise"));
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const int num_inputs = context->num_inputs();
+    TensorShape shape;
+    bool has_non_scalar_input = false;
+    for (int i = 0; i < num_inputs; ++i) {
+      const Tensor& input = context->input(i);
+      if (TensorShapeUtils::IsScalar(input.shape())) continue;
+      if (!has_non_scalar_input) {
+        shape = input.shape();
+        has_non_scalar_input = true;
+      }
+      OP_REQUIRES(context, input.shape() == shape,
+                  errors::InvalidArgument(
+                      "_FusedElementwise inputs must be scalars or have the "
+                      "same shape, but input ",
+                      i, " has shape ", input.shape().DebugString(),
+                      " instead of ", shape.DebugString()));
+    }
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, shape, &output));
+    const int64_t n = shape.num_elements();
+    if (n == 0) return;
+
+    const int num_steps = ops_.size();
+    auto compute_blocks = [&](int64_t begin_block, int64_t end_block) {
+      // Holds the values of all steps but the last for a block, then the
+      // scalar inputs broadcast to a block.
+      std::vector<float> scratch((num_steps - 1 + num_inputs) * kBlockSize);
+      float* broadcast = scratch.data() + (num_steps - 1) * kBlockSize;
+      for (int i = 0; i < num_inputs; ++i) {
+        const Tensor& input = context->input(i);
+        if (!TensorShapeUtils::IsScalar(input.shape())) continue;
+        std::fill_n(broadcast + i * kBlockSize, kBlockSize,
+                    input.scalar<float>()());
+      }
+      std::vector<const float*> values(num_inputs + num_steps);
+      float* out = output->flat<float>().data();
+      for (int64_t block = begin_block; block < end_block; ++block) {
+        const int64_t offset = block * kBlockSize;
+        const int64_t size = std::min(kBlockSize, n - offset);
+        for (int i = 0; i < num_inputs; ++i) {
+          const Tensor& input = context->input(i);
+          values[i] = TensorShapeUtils::IsScalar(input.shape())
+                          ? broadcast + i * kBlockSize
+                          : input.flat<float>().data() + offset;
+        }
+        for (int step = 0; step < num_steps; ++step) {
+          float* result = step == num_steps - 1
+                              ? out + offset
+                              : scratch.data() + step * kBlockSize;
+          const int y = operands_[2 * step + 1];
+          ComputeStep(ops_[step], values[operands_[2 * step]],
+                      y == -1 ? nullptr : values[y], size, result);
+          values[num_inputs + step] = result;
+        }
+      }
+    };
+    const int64_t num_blocks = (n + kBlockSize - 1) / kBlockSize;
+    const int64_t cost_per_block = kBlockSize * num_steps * 10;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+          cost_per_block, compute_blocks);
+  }
+
+ private:
+  std::vector<FusedOp> ops_;
+  std::vector<int> operands_;
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("_FusedElementwise").Device(DEVICE_CPU).TypeConstraint<float>("T"),
+    FusedElementwiseOp);
+
+}  // namespace
+}  // namespace tensorflow
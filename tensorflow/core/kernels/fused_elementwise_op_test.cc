@@ -0,0 +1,89 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedElementwiseOpTest : public OpsTestBase {
+ protected:
+  Status Init(int num_inputs, const std::vector<string>& fused_ops,
+              const std::vector<int>& operands) {
+    TF_CHECK_OK(NodeDefBuilder("op", "_FusedElementwise")
+                    .Input(FakeInput(num_inputs, DT_FLOAT))
+                    .Attr("fused_ops", fused_ops)
+                    .Attr("operands", operands)
+                    .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(FusedElementwiseOpTest, TreeWithScalarInput) {
+  // tanh(x * 2 + b) - square(b), over several blocks.
+  TF_ASSERT_OK(Init(3, {"Mul", "AddV2", "Tanh", "Square", "Sub"},
+                    {0, 1, 3, 2, 4, -1, 2, -1, 5, 6}));
+  const int n = 3000;
+  std::vector<float> x(n), b(n), expected(n);
+  for (int i = 0; i < n; ++i) {
+    x[i] = (i % 100) / 50.0f - 1;
+    b[i] = (i % 7) / 7.0f;
+    expected[i] = std::tanh(x[i] * 2 + b[i]) - b[i] * b[i];
+  }
+  AddInputFromArray<float>(TensorShape({3, n / 3}), x);
+  AddInputFromArray<float>(TensorShape({}), {2});
+  AddInputFromArray<float>(TensorShape({3, n / 3}), b);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectClose(test::AsTensor<float>(expected, TensorShape({3, n / 3})),
+                    *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, PropagatesNaN) {
+  TF_ASSERT_OK(Init(2, {"Maximum", "Relu"}, {0, 1, 2, -1}));
+  AddInputFromArray<float>(TensorShape({3}), {NAN, -1, 3});
+  AddInputFromArray<float>(TensorShape({3}), {0, -2, NAN});
+  TF_ASSERT_OK(RunOpKernel());
+  const auto output = GetOutput(0)->flat<float>();
+  EXPECT_TRUE(std::isnan(output(0)));
+  EXPECT_EQ(output(1), 0);
+  EXPECT_TRUE(std::isnan(output(2)));
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsLaterOperands) {
+  EXPECT_FALSE(Init(1, {"Neg", "Exp"}, {2, -1, 0, -1}).ok());
+  EXPECT_FALSE(Init(1, {"Neg"}, {0, 0}).ok());
+  EXPECT_FALSE(Init(1, {"MatMul"}, {0, 0}).ok());
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsMismatchedShapes) {
+  TF_ASSERT_OK(Init(2, {"Add"}, {0, 1}));
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  EXPECT_FALSE(RunOpKernel().ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,11 +15,13 @@ limitations under the License.
 
 // See docs in ../ops/image_ops.cc
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #define EIGEN_USE_THREADS
 
@@ -42,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/stringpiece.h"
 #include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "tsl/util/byte_swap_array.h"
 
 namespace tensorflow {
@@ -749,5 +752,222 @@ void DecodeImageV2Op::DecodeBMP(const uint8* input, const int row_size,
   }
 }
 
+// Resizes an interleaved uint8 image bilinearly with half pixel centers. This
+// computes what ResizeBilinear with `half_pixel_centers` computes for the
+// image cast to float.
+void ResizeBilinearHalfPixelCenters(const uint8* input, int in_height,
+                                    int in_width, int channels, int out_height,
+                                    int out_width, float* output) {
+  struct Weight {
+    int64_t lower;
+    int64_t upper;
+    float lerp;
+  };
+  auto compute_weights = [](int out_size, int in_size) {
+    std::vector<Weight> weights(out_size);
+    const float scale = static_cast<float>(in_size) / out_size;
+    for (int i = 0; i < out_size; ++i) {
+      const float in = (static_cast<float>(i) + 0.5f) * scale - 0.5f;
+      const float in_floor = std::floor(in);
+      weights[i].lower =
+          std::max(static_cast<int64_t>(in_floor), static_cast<int64_t>(0));
+      weights[i].upper = std::min(static_cast<int64_t>(std::ceil(in)),
+                                  static_cast<int64_t>(in_size - 1));
+      weights[i].lerp = in - in_floor;
+    }
+    return weights;
+  };
+  const std::vector<Weight> ys = compute_weights(out_height, in_height);
+  const std::vector<Weight> xs = compute_weights(out_width, in_width);
+  const int64_t in_row_size = static_cast<int64_t>(in_width) * channels;
+  for (int y = 0; y < out_height; ++y) {
+    const uint8* top_row = input + ys[y].lower * in_row_size;
+    const uint8* bottom_row = input + ys[y].upper * in_row_size;
+    const float y_lerp = ys[y].lerp;
+    for (int x = 0; x < out_width; ++x) {
+      const int64_t left = xs[x].lower * channels;
+      const int64_t right = xs[x].upper * channels;
+      const float x_lerp = xs[x].lerp;
+      for (int c = 0; c < channels; ++c) {
+        const float top_left = top_row[left + c];
+        const float top_right = top_row[right + c];
+        const float bottom_left = bottom_row[left + c];
+        const float bottom_right = bottom_row[right + c];
+        const float top = top_left + (top_right - top_left) * x_lerp;
+        const float bottom =
+            bottom_left + (bottom_right - bottom_left) * x_lerp;
+        *output++ = top + (bottom - top) * y_lerp;
+      }
+    }
+  }
+}
+
+// Decodes a batch of JPEG images, crops each to its window and resizes the
+// crops bilinearly into one batch, as DecodeAndCropJpeg and ResizeBilinear
+// with `half_pixel_centers` would one image at a time. The images are decoded
+// in parallel, and libjpeg decodes only the scanlines and MCU columns of each
+// crop window. With `downscale_in_decode`, a crop that is at least twice as
+// large as the output is also downscaled by the inverse DCT, by the largest
+// factor of 2, 4 or 8 that keeps it at least as large as the output.
+class BatchDecodeAndCropJpegOp : public OpKernel {
+ public:
+  explicit BatchDecodeAndCropJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &flags_.components));
+    OP_REQUIRES(context, flags_.components == 1 || flags_.components == 3,
+                errors::InvalidArgument("channels must be 1 or 3, got ",
+                                        flags_.components));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        errors::InvalidArgument("dct_method must be one of "
+                                "{'', 'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    flags_.crop = true;
+    OP_REQUIRES_OK(context, context->GetAttr("downscale_in_decode",
+                                             &downscale_in_decode_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    const Tensor& crop_windows = context->input(1);
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(contents.shape()),
+                errors::InvalidArgument("contents must be 1-D, got shape ",
+                                        contents.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsMatrix(crop_windows.shape()) &&
+                    crop_windows.dim_size(0) == contents.dim_size(0) &&
+                    crop_windows.dim_size(1) == 4,
+                errors::InvalidArgument(
+                    "crop_windows must have the shape [", contents.dim_size(0),
+                    ", 4], got ", crop_windows.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(size.shape()) &&
+                    size.NumElements() == 2,
+                errors::InvalidArgument("size must have two elements, got ",
+                                        size.shape().DebugString()));
+    const int height = size.vec<int32>()(0);
+    const int width = size.vec<int32>()(1);
+    OP_REQUIRES(context, height > 0 && width > 0,
+                errors::InvalidArgument("size must be positive, got ", height,
+                                        " x ", width));
+
+    const int64_t batch_size = contents.dim_size(0);
+    const int channels = flags_.components;
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({batch_size, height, width, channels}),
+                       &output));
+    const int64_t image_size = static_cast<int64_t>(height) * width * channels;
+    const auto contents_vec = contents.vec<tstring>();
+    const auto windows = crop_windows.matrix<int32>();
+    float* output_data = output->flat<float>().data();
+    std::vector<Status> statuses(batch_size);
+    auto decode = [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        statuses[i] = DecodeAndResize(
+            contents_vec(i), windows(i, 0), windows(i, 1), windows(i, 2),
+            windows(i, 3), height, width, output_data + i * image_size);
+      }
+    };
+    // Decoding dominates, and costs far more than the copy of each output
+    // value, so each image is a shard of its own.
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, batch_size,
+          kCostPerImage, decode);
+    for (int64_t i = 0; i < batch_size; ++i) {
+      OP_REQUIRES_OK(context, statuses[i]);
+    }
+  }
+
+ private:
+  static constexpr int64_t kCostPerImage = 1 << 20;
+
+  Status DecodeAndResize(StringPiece input, int crop_y, int crop_x,
+                         int crop_height, int crop_width, int height,
+                         int width, float* output) const {
+    if (!absl::StartsWith(input, kJpegMagicBytes)) {
+      return errors::InvalidArgument(
+          "BatchDecodeAndCropJpeg can decode JPEG only, but got an image of "
+          "another format");
+    }
+    jpeg::UncompressFlags flags = flags_;
+    flags.crop_y = crop_y;
+    flags.crop_x = crop_x;
+    flags.crop_height = crop_height;
+    flags.crop_width = crop_width;
+    if (downscale_in_decode_) {
+      int image_width = 0;
+      int image_height = 0;
+      if (!jpeg::GetImageInfo(input.data(), input.size(), &image_width,
+                              &image_height, nullptr)) {
+        return errors::InvalidArgument("Invalid JPEG data");
+      }
+      if (crop_y < 0 || crop_x < 0 || crop_height <= 0 || crop_width <= 0 ||
+          static_cast<int64_t>(crop_y) + crop_height > image_height ||
+          static_cast<int64_t>(crop_x) + crop_width > image_width) {
+        return errors::InvalidArgument(
+            "Crop window [", crop_y, ", ", crop_x, ", ", crop_height, ", ",
+            crop_width, "] is not within the image of ", image_height, " x ",
+            image_width);
+      }
+      int ratio = 1;
+      while (ratio < 8 && crop_height / (2 * ratio) >= height &&
+             crop_width / (2 * ratio) >= width) {
+        ratio *= 2;
+      }
+      if (ratio > 1) {
+        // libjpeg rounds the scaled image size up, and the scaled window
+        // covers all the scaled pixels that the window overlaps.
+        const int scaled_height = (image_height + ratio - 1) / ratio;
+        const int scaled_width = (image_width + ratio - 1) / ratio;
+        flags.ratio = ratio;
+        flags.crop_y = crop_y / ratio;
+        flags.crop_x = crop_x / ratio;
+        flags.crop_height =
+            std::min((crop_y + crop_height + ratio - 1) / ratio,
+                     scaled_height) -
+            flags.crop_y;
+        flags.crop_width =
+            std::min((crop_x + crop_width + ratio - 1) / ratio, scaled_width) -
+            flags.crop_x;
+      }
+    }
+
+    std::unique_ptr<uint8[]> buffer;
+    int decoded_height = 0;
+    int decoded_width = 0;
+    const uint8* image = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr /* nwarn */,
+        [&](int w, int h, int c) -> uint8* {
+          decoded_height = h;
+          decoded_width = w;
+          buffer.reset(new uint8[static_cast<int64_t>(h) * w * c]);
+          return buffer.get();
+        });
+    if (image == nullptr) {
+      return errors::InvalidArgument(
+          "jpeg::Uncompress failed. Invalid JPEG data or crop window.");
+    }
+    ResizeBilinearHalfPixelCenters(image, decoded_height, decoded_width,
+                                   flags.components, height, width, output);
+    return OkStatus();
+  }
+
+  jpeg::UncompressFlags flags_;
+  bool downscale_in_decode_ = false;
+};
+
+REGISTER_KERNEL_BUILDER(Name("BatchDecodeAndCropJpeg").Device(DEVICE_CPU),
+                        BatchDecodeAndCropJpegOp);
+
 }  // namespace
 }  // namespace tensorflow
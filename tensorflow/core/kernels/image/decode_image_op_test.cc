@@ -0,0 +1,137 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Encodes a `height` x `width` image whose pixels are `value(y, x, c)`.
+template <typename Value>
+tstring EncodeJpeg(int height, int width, int channels, Value value) {
+  std::vector<uint8> pixels;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      for (int c = 0; c < channels; ++c) pixels.push_back(value(y, x, c));
+    }
+  }
+  jpeg::CompressFlags flags;
+  flags.format = channels == 1 ? jpeg::FORMAT_GRAYSCALE : jpeg::FORMAT_RGB;
+  flags.quality = 100;
+  flags.chroma_downsampling = false;
+  return jpeg::Compress(pixels.data(), width, height, flags);
+}
+
+class BatchDecodeAndCropJpegOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(int channels, bool downscale_in_decode) {
+    TF_ASSERT_OK(NodeDefBuilder("decode", "BatchDecodeAndCropJpeg")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("channels", channels)
+                     .Attr("downscale_in_decode", downscale_in_decode)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(BatchDecodeAndCropJpegOpTest, CropsAtOutputSize) {
+  MakeOp(/*channels=*/3, /*downscale_in_decode=*/false);
+  const tstring image = EncodeJpeg(48, 64, 3, [](int y, int x, int c) {
+    return c == 0 ? 2 * x : c == 1 ? 3 * y : x + y;
+  });
+  AddInputFromArray<tstring>(TensorShape({2}), {image, image});
+  AddInputFromArray<int32>(TensorShape({2, 4}),
+                           {8, 16, 24, 32, 0, 30, 24, 32});
+  AddInputFromArray<int32>(TensorShape({2}), {24, 32});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Without a resize, the crops are those of DecodeAndCropJpeg.
+  Tensor expected(DT_FLOAT, TensorShape({2, 24, 32, 3}));
+  auto expected_flat = expected.flat<float>();
+  const int windows[2][2] = {{8, 16}, {0, 30}};
+  for (int i = 0; i < 2; ++i) {
+    jpeg::UncompressFlags flags;
+    flags.components = 3;
+    flags.dct_method = JDCT_IFAST;
+    flags.crop = true;
+    flags.crop_y = windows[i][0];
+    flags.crop_x = windows[i][1];
+    flags.crop_height = 24;
+    flags.crop_width = 32;
+    std::unique_ptr<uint8[]> crop(jpeg::Uncompress(
+        image.data(), image.size(), flags, nullptr, nullptr, nullptr,
+        nullptr));
+    ASSERT_NE(crop, nullptr);
+    for (int j = 0; j < 24 * 32 * 3; ++j) {
+      expected_flat(i * 24 * 32 * 3 + j) = crop[j];
+    }
+  }
+  test::ExpectTensorEqual<float>(*GetOutput(0), expected);
+}
+
+TEST_F(BatchDecodeAndCropJpegOpTest, DownscalesInDecode) {
+  MakeOp(/*channels=*/1, /*downscale_in_decode=*/true);
+  const tstring image = EncodeJpeg(
+      64, 64, 1, [](int y, int x, int c) { return 2 * x + y; });
+  AddInputFromArray<tstring>(TensorShape({2}), {image, image});
+  AddInputFromArray<int32>(TensorShape({2, 4}), {0, 0, 64, 64, 8, 16, 32, 32});
+  AddInputFromArray<int32>(TensorShape({2}), {16, 16});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // The first crop is decoded at a quarter and the second at half of its
+  // size, so each output pixel is about the mean of the pixels it covers.
+  auto output = GetOutput(0)->tensor<float, 4>();
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 16; ++x) {
+      EXPECT_NEAR(output(0, y, x, 0), 2 * (4 * x + 1.5) + 4 * y + 1.5, 4);
+      EXPECT_NEAR(output(1, y, x, 0), 2 * (16 + 2 * x + 0.5) + 8 + 2 * y + 0.5,
+                  4);
+    }
+  }
+}
+
+TEST_F(BatchDecodeAndCropJpegOpTest, InvalidCropWindow) {
+  MakeOp(/*channels=*/1, /*downscale_in_decode=*/true);
+  const tstring image = EncodeJpeg(
+      16, 16, 1, [](int y, int x, int c) { return x + y; });
+  AddInputFromArray<tstring>(TensorShape({1}), {image});
+  AddInputFromArray<int32>(TensorShape({1, 4}), {8, 0, 16, 16});
+  AddInputFromArray<int32>(TensorShape({2}), {4, 4});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+TEST_F(BatchDecodeAndCropJpegOpTest, MismatchedCropWindows) {
+  MakeOp(/*channels=*/3, /*downscale_in_decode=*/false);
+  AddInputFromArray<tstring>(TensorShape({2}), {"", ""});
+  AddInputFromArray<int32>(TensorShape({1, 4}), {0, 0, 1, 1});
+  AddInputFromArray<int32>(TensorShape({2}), {1, 1});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
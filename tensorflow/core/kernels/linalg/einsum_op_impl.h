@@ -416,6 +416,19 @@ struct EinsumHelper {
     return OkStatus();
   }
 
+  // Returns true if the output lists a free label of the second operand before
+  // any free label of the first. Contracting with swapped operands then places
+  // the free dimensions of the result closer to the output order.
+  static bool ShouldSwapOperands(const OperandLabels& free_labels,
+                                 const Labels& output_labels) {
+    if (free_labels[0].empty() || free_labels[1].empty()) return false;
+    for (int label : output_labels) {
+      if (absl::c_linear_search(free_labels[0], label)) return false;
+      if (absl::c_linear_search(free_labels[1], label)) return true;
+    }
+    return false;
+  }
+
   // Reshapes a Tensor of shape [b0,b1...bk,N,M] to [prod(b0,b1...bk),N,M].
   static Status ReshapeToRank3(const Tensor& input, int batch_size,
                                Tensor* output) {
@@ -427,7 +440,9 @@ struct EinsumHelper {
 
   // Contracts the inputs along the last axis (or the second last if the
   // corresponding value of swap_free_and_contract is true). The batch
-  // dimensions are broadcast to the output shape.
+  // dimensions are broadcast to the output shape. If swap_operands is true, the
+  // second input is used as the lhs of the BatchMatMul so that the free
+  // dimensions of the result appear as [free shape 1] + [free shape 0].
   // TODO(anudhyan): BatchMatMul might devolve into a component-wise
   // multiplication when the matrix shape is [1,1]; in this case BatchMatMul
   // functor would be very inefficient. The functor should detect if this is the
@@ -436,29 +451,33 @@ struct EinsumHelper {
   static Status ContractOperands(OpKernelContext* ctx,
                                  absl::Span<const Tensor> inputs,
                                  absl::Span<const bool> swap_free_and_contract,
-                                 Tensor* output) {
+                                 Tensor* output, bool swap_operands = false) {
     if (inputs.size() == 1)
       return CopyFrom(inputs[0], inputs[0].shape(), output);
-    MatMulBCast bcast(inputs[0].shape().dim_sizes(),
-                      inputs[1].shape().dim_sizes());
+    // Computing (A * B^T)^T as B * A^T yields the transposed result without
+    // materializing a transpose; only the operand roles and flags change.
+    const int x = swap_operands ? 1 : 0;
+    const int y = 1 - x;
+    MatMulBCast bcast(inputs[x].shape().dim_sizes(),
+                      inputs[y].shape().dim_sizes());
     if (!bcast.IsValid()) {
       return errors::InvalidArgument(
           "Invalid broadcasting dimensions: ", inputs[0].shape().DebugString(),
           " vs. ", inputs[1].shape().DebugString());
     }
     Tensor lhs;
-    TF_RETURN_IF_ERROR(ReshapeToRank3(inputs[0], bcast.x_batch_size(), &lhs));
+    TF_RETURN_IF_ERROR(ReshapeToRank3(inputs[x], bcast.x_batch_size(), &lhs));
     Tensor rhs;
-    TF_RETURN_IF_ERROR(ReshapeToRank3(inputs[1], bcast.y_batch_size(), &rhs));
+    TF_RETURN_IF_ERROR(ReshapeToRank3(inputs[y], bcast.y_batch_size(), &rhs));
     TensorShape output_shape = bcast.output_batch_shape();
-    for (int i = 0; i < inputs.size(); ++i) {
+    for (int i : {x, y}) {
       const int64_t free_axis =
           inputs[i].dims() - (swap_free_and_contract[i] ? 1 : 2);
       TF_RETURN_IF_ERROR(
           output_shape.AddDimWithStatus(inputs[i].dim_size(free_axis)));
     }
-    bool trans_x = swap_free_and_contract[0];
-    bool trans_y = !swap_free_and_contract[1];
+    bool trans_x = swap_free_and_contract[x];
+    bool trans_y = !swap_free_and_contract[y];
     TF_RETURN_IF_ERROR(
         ctx->allocate_temp(DataTypeToEnum<T>::value, output_shape, output));
     if (lhs.NumElements() == 0 || rhs.NumElements() == 0) {
@@ -525,11 +544,16 @@ class EinsumOp : public OpKernel {
 
     // After reduction, the inputs should be reshaped to Tensors suitable for
     // contraction. If num_inputs is 1, the reduced input is simply forwarded to
-    // the output.
+    // the output. When the output lists the free dimensions of the second
+    // input first, the operands are swapped so that the contraction result is
+    // already (closer to) the output layout and the final transpose is avoided.
+    const bool swap_operands =
+        num_inputs == 2 &&
+        EinsumHelper::ShouldSwapOperands(free_labels, output_labels);
     Tensor contraction_output_reshaped;
     OP_REQUIRES_OK(ctx, EinsumHelper::ContractOperands<Device, T>(
                             ctx, inputs_reduced, swap_free_and_contract,
-                            &contraction_output_reshaped));
+                            &contraction_output_reshaped, swap_operands));
 
     // Copy the batch labels from the contraction output. Recover the batch
     // shape, which may have been broadcasted.
@@ -548,7 +572,8 @@ class EinsumOp : public OpKernel {
       if (label_types[label] == EinsumDimensionType::kBatch)
         result_labels.push_back(label);
     }
-    for (int i = 0; i < num_inputs; ++i) {
+    for (int j = 0; j < num_inputs; ++j) {
+      const int i = swap_operands ? num_inputs - 1 - j : j;
       for (int label : free_labels[i]) {
         result_labels.push_back(label);
         OP_REQUIRES_OK(
@@ -557,7 +582,8 @@ class EinsumOp : public OpKernel {
     }
 
     // Reshape the contraction (or reduction) result to its expanded shape:
-    // [(broadcasted) batch shape] + [free shape 0] + [free shape 1].
+    // [(broadcasted) batch shape] + [free shape 0] + [free shape 1], with the
+    // free shapes in the opposite order if the operands were swapped.
     Tensor contraction_output;
     OP_REQUIRES_OK(
         ctx, EinsumHelper::CopyFrom(contraction_output_reshaped, result_shape,
@@ -15,11 +15,15 @@ limitations under the License.
 
 // Tests kernels of lookup ops.
 
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
@@ -100,5 +104,131 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+class MutableHashTableTest : public OpsTestBase,
+                             public ::testing::WithParamInterface<string> {
+ protected:
+  // Creates an int64 to int64 table with the kernel of the given label, which
+  // stays alive until the test ends.
+  lookup::LookupInterface* CreateTable() {
+    TF_CHECK_OK(NodeDefBuilder("table", "AnonymousMutableHashTable")
+                    .Attr("key_dtype", DT_INT64)
+                    .Attr("value_dtype", DT_INT64)
+                    .Attr("_kernel", GetParam())
+                    .Finalize(node_def()));
+    TF_CHECK_OK(InitOp());
+    TF_CHECK_OK(RunOpKernel());
+    return GetOutput(0)
+        ->scalar<ResourceHandle>()()
+        .GetResource<lookup::LookupInterface>()
+        .value();
+  }
+
+  Tensor Find(lookup::LookupInterface* table, const Tensor& keys) {
+    Tensor values(DT_INT64, keys.shape());
+    TF_CHECK_OK(table->Find(nullptr, keys, &values,
+                            test::AsScalar<int64_t>(-1)));
+    return values;
+  }
+};
+
+TEST_P(MutableHashTableTest, InsertFindRemove) {
+  lookup::LookupInterface* table = CreateTable();
+  TF_ASSERT_OK(table->Insert(nullptr, test::AsTensor<int64_t>({1, 2, 3}),
+                             test::AsTensor<int64_t>({10, 20, 30})));
+  TF_ASSERT_OK(table->Insert(nullptr, test::AsTensor<int64_t>({3, 4}),
+                             test::AsTensor<int64_t>({31, 40})));
+  EXPECT_EQ(table->size(), 4);
+  test::ExpectTensorEqual<int64_t>(
+      Find(table, test::AsTensor<int64_t>({4, 3, 5, 1})),
+      test::AsTensor<int64_t>({40, 31, -1, 10}));
+
+  TF_ASSERT_OK(table->Remove(nullptr, test::AsTensor<int64_t>({1, 5})));
+  EXPECT_EQ(table->size(), 3);
+  test::ExpectTensorEqual<int64_t>(
+      Find(table, test::AsTensor<int64_t>({1, 2})),
+      test::AsTensor<int64_t>({-1, 20}));
+}
+
+TEST_P(MutableHashTableTest, ImportReplacesEntries) {
+  lookup::LookupInterface* table = CreateTable();
+  TF_ASSERT_OK(table->Insert(nullptr, test::AsTensor<int64_t>({1, 2}),
+                             test::AsTensor<int64_t>({10, 20})));
+  TF_ASSERT_OK(table->ImportValues(nullptr, test::AsTensor<int64_t>({2, 3}),
+                                   test::AsTensor<int64_t>({21, 30})));
+  EXPECT_EQ(table->size(), 2);
+  test::ExpectTensorEqual<int64_t>(
+      Find(table, test::AsTensor<int64_t>({1, 2, 3})),
+      test::AsTensor<int64_t>({-1, 21, 30}));
+}
+
+TEST_P(MutableHashTableTest, ConcurrentInsertAndFind) {
+  lookup::LookupInterface* table = CreateTable();
+  constexpr int kNumThreads = 8;
+  constexpr int kKeysPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([this, table, t] {
+      std::vector<int64_t> keys(kKeysPerThread);
+      for (int i = 0; i < kKeysPerThread; ++i) {
+        keys[i] = t * kKeysPerThread + i;
+      }
+      const Tensor key_tensor = test::AsTensor<int64_t>(keys);
+      TF_CHECK_OK(table->Insert(nullptr, key_tensor, key_tensor));
+      // A thread sees its own inserts.
+      test::ExpectTensorEqual<int64_t>(Find(table, key_tensor), key_tensor);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  EXPECT_EQ(table->size(), kNumThreads * kKeysPerThread);
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, MutableHashTableTest,
+                         ::testing::Values("", "sharded"));
+
+TEST_F(LookupOpsTest, MutableDenseHashTableFind) {
+  TF_ASSERT_OK(NodeDefBuilder("table", "AnonymousMutableDenseHashTable")
+                   .Input(FakeInput(DT_INT64))
+                   .Input(FakeInput(DT_INT64))
+                   .Attr("key_dtype", DT_INT64)
+                   .Attr("value_dtype", DT_INT64)
+                   .Attr("initial_num_buckets", 16)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<int64_t>(TensorShape({}), {-1});
+  AddInputFromArray<int64_t>(TensorShape({}), {-2});
+  TF_ASSERT_OK(RunOpKernel());
+  auto table_or = GetOutput(0)
+                      ->scalar<ResourceHandle>()()
+                      .GetResource<lookup::LookupInterface>();
+  TF_ASSERT_OK(table_or.status());
+  lookup::LookupInterface* table = table_or.value();
+
+  // Enough keys for the table to grow, and batches both shorter and longer
+  // than the distance that Find prefetches at.
+  std::vector<int64_t> keys(1000);
+  std::vector<int64_t> values(keys.size());
+  for (int i = 0; i < keys.size(); ++i) {
+    keys[i] = 3 * i;
+    values[i] = i;
+  }
+  TF_ASSERT_OK(table->Insert(context_.get(), test::AsTensor<int64_t>(keys),
+                             test::AsTensor<int64_t>(values)));
+  for (int n : {1, 3, 1000}) {
+    std::vector<int64_t> find_keys(2 * n);
+    std::vector<int64_t> expected(2 * n);
+    for (int i = 0; i < n; ++i) {
+      find_keys[2 * i] = keys[keys.size() - 1 - i];
+      expected[2 * i] = values[keys.size() - 1 - i];
+      find_keys[2 * i + 1] = 3 * i + 1;
+      expected[2 * i + 1] = -7;
+    }
+    Tensor found(DT_INT64, TensorShape({2 * n}));
+    TF_ASSERT_OK(table->Find(context_.get(),
+                             test::AsTensor<int64_t>(find_keys), &found,
+                             test::AsTensor<int64_t>({-7})));
+    test::ExpectTensorEqual<int64_t>(found, test::AsTensor<int64_t>(expected));
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -16,9 +16,13 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
@@ -26,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/platform/random.h"
 
 namespace tensorflow {
@@ -212,6 +217,250 @@ class MutableHashTableOfScalars final : public LookupInterface {
   std::unordered_map<K, V> table_ TF_GUARDED_BY(mu_);
 };
 
+// Behaves like MutableHashTableOfScalars, but splits the table into shards
+// with a lock each, so that concurrent ops on the same table rarely contend.
+// An op locks each shard that its keys fall into once, for all of those keys.
+// Unlike with MutableHashTableOfScalars, a Find that runs concurrently with an
+// Insert may see some but not all of the inserted keys.
+//
+// Registered with the "sharded" kernel label, which a node selects through
+// its "_kernel" attribute.
+template <class K, class V>
+class ShardedMutableHashTableOfScalars final : public LookupInterface {
+ public:
+  ShardedMutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
+
+  size_t size() const override {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      size += shard.table.size();
+    }
+    return size;
+  }
+
+  Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+              const Tensor& default_value) override {
+    const auto key_values = key.flat<K>();
+    auto value_values = value->flat<V>();
+    const auto default_flat = default_value.flat<V>();
+
+    int64_t total = value_values.size();
+    int64_t default_total = default_flat.size();
+    bool is_full_size_default = (total == default_total);
+
+    const KeysByShard keys_by_shard(key_values);
+    for (int s = 0; s < kNumShards; ++s) {
+      if (keys_by_shard.empty(s)) {
+        continue;
+      }
+      const Shard& shard = shards_[s];
+      tf_shared_lock l(shard.mu);
+      for (const int64_t* i = keys_by_shard.begin(s);
+           i != keys_by_shard.end(s); ++i) {
+        value_values(*i) = gtl::FindWithDefault(
+            shard.table, SubtleMustCopyIfIntegral(key_values(*i)),
+            is_full_size_default ? default_flat(*i) : default_flat(0));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status DoInsert(bool clear, const Tensor& keys, const Tensor& values) {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat<V>();
+
+    const KeysByShard keys_by_shard(key_values);
+    for (int s = 0; s < kNumShards; ++s) {
+      if (!clear && keys_by_shard.empty(s)) {
+        continue;
+      }
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      if (clear) {
+        shard.table.clear();
+      }
+      for (const int64_t* i = keys_by_shard.begin(s);
+           i != keys_by_shard.end(s); ++i) {
+        gtl::InsertOrUpdate(&shard.table,
+                            SubtleMustCopyIfIntegral(key_values(*i)),
+                            SubtleMustCopyIfIntegral(value_values(*i)));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                const Tensor& values) override {
+    return DoInsert(false, keys, values);
+  }
+
+  Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    const auto key_values = keys.flat<K>();
+
+    const KeysByShard keys_by_shard(key_values);
+    for (int s = 0; s < kNumShards; ++s) {
+      if (keys_by_shard.empty(s)) {
+        continue;
+      }
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      for (const int64_t* i = keys_by_shard.begin(s);
+           i != keys_by_shard.end(s); ++i) {
+        shard.table.erase(SubtleMustCopyIfIntegral(key_values(*i)));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    return DoInsert(true, keys, values);
+  }
+
+  Status ExportValues(OpKernelContext* ctx) override {
+    const std::vector<std::pair<K, V>> entries = Snapshot();
+    const int64_t size = entries.size();
+
+    Tensor* keys;
+    Tensor* values;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("keys", TensorShape({size}), &keys));
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("values", TensorShape({size}), &values));
+    ExportKeysAndValues(entries, keys, values);
+    return OkStatus();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return TensorShape(); }
+
+  int64_t MemoryUsed() const override {
+    int64_t ret = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      for (unsigned i = 0; i < shard.table.bucket_count(); ++i) {
+        size_t bucket_size = shard.table.bucket_size(i);
+        if (bucket_size == 0) {
+          ret++;
+        } else {
+          ret += bucket_size;
+        }
+      }
+    }
+    return sizeof(ShardedMutableHashTableOfScalars) + ret;
+  }
+
+  Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
+    const std::vector<std::pair<K, V>> entries = Snapshot();
+    const int64_t size = entries.size();
+    Tensor keys(key_dtype(), TensorShape({size}));
+    Tensor values(value_dtype(), TensorShape({size}));
+    ExportKeysAndValues(entries, &keys, &values);
+
+    // See MutableHashTableOfScalars::AsGraphDef.
+    Node* table = ops::SourceOp(
+        "MutableHashTableV2",
+        builder->opts()
+            .WithName(UniqueNodeName("MutableHashTableFromGraphDef"))
+            .WithAttr("use_node_name_sharing", true)
+            .WithAttr("key_dtype", key_dtype())
+            .WithAttr("value_dtype", value_dtype())
+            .WithAttr("_kernel", "sharded"));
+    Node* keys_node = ops::SourceOp(
+        "Const",
+        builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
+    Node* values_node =
+        ops::SourceOp("Const", builder->opts()
+                                   .WithAttr("dtype", value_dtype())
+                                   .WithAttr("value", values));
+    Node* import_table =
+        ops::TernaryOp("LookupTableImportV2", table, keys_node, values_node,
+                       builder->opts()
+                           .WithAttr("Tin", key_dtype())
+                           .WithAttr("Tout", value_dtype()));
+    *out = ops::UnaryOp("Identity", table,
+                        builder->opts().WithControlInput(import_table));
+    return OkStatus();
+  }
+
+ private:
+  static constexpr int kNumShards = 32;
+
+  static int ShardOf(const K& key) {
+    // Takes the top bits of the product with 2^64 / phi, since std::hash of
+    // an integer is the integer itself on some platforms.
+    return (static_cast<uint64>(std::hash<K>()(key)) * 0x9E3779B97F4A7C15ull) >>
+           (64 - 5);
+  }
+
+  // The indices of keys ordered by shard, by counting sort.
+  class KeysByShard {
+   public:
+    explicit KeysByShard(typename TTypes<K>::ConstFlat keys)
+        : indices_(keys.size()) {
+      std::vector<int8> shards(keys.size());
+      std::array<int64_t, kNumShards> next = {};
+      for (int64_t i = 0; i < keys.size(); ++i) {
+        shards[i] = ShardOf(SubtleMustCopyIfIntegral(keys(i)));
+        ++next[shards[i]];
+      }
+      begin_[0] = 0;
+      for (int s = 0; s < kNumShards; ++s) {
+        begin_[s + 1] = begin_[s] + next[s];
+        next[s] = begin_[s];
+      }
+      for (int64_t i = 0; i < keys.size(); ++i) {
+        indices_[next[shards[i]]++] = i;
+      }
+    }
+
+    bool empty(int shard) const { return begin_[shard] == begin_[shard + 1]; }
+    const int64_t* begin(int shard) const {
+      return indices_.data() + begin_[shard];
+    }
+    const int64_t* end(int shard) const {
+      return indices_.data() + begin_[shard + 1];
+    }
+
+   private:
+    std::vector<int64_t> indices_;
+    std::array<int64_t, kNumShards + 1> begin_;
+  };
+
+  // The entries of all shards, each shard being locked in turn.
+  std::vector<std::pair<K, V>> Snapshot() const {
+    std::vector<std::pair<K, V>> entries;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      entries.insert(entries.end(), shard.table.begin(), shard.table.end());
+    }
+    return entries;
+  }
+
+  static void ExportKeysAndValues(const std::vector<std::pair<K, V>>& entries,
+                                  Tensor* keys, Tensor* values) {
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->flat<V>();
+    for (int64_t i = 0; i < entries.size(); ++i) {
+      keys_data(i) = entries[i].first;
+      values_data(i) = entries[i].second;
+    }
+  }
+
+  // Each shard is on its own cache lines.
+  struct alignas(64) Shard {
+    mutable mutex mu;
+    std::unordered_map<K, V> table TF_GUARDED_BY(mu);
+  };
+  std::array<Shard, kNumShards> shards_;
+};
+
 // Lookup table that wraps an unordered_map. Behaves identical to
 // MutableHashTableOfScalars except that each value must be a vector.
 template <class K, class V>
@@ -520,9 +769,28 @@ class MutableDenseHashTable final : public LookupInterface {
     const auto deleted_key_matrix =
         deleted_key_.template shaped<K, 2>({1, key_size});
     const int64_t bit_mask = num_buckets_ - 1;
+    // Lookups in a large table mostly wait for memory, so the first buckets
+    // of the keys kPrefetchDistance ahead are prefetched while probing for
+    // the current key. The ring buffer keeps their hashes.
+    uint64 key_hashes[kPrefetchDistance];
+    auto hash_and_prefetch = [&](int64_t i) {
+      const uint64 key_hash = HashKey(key_matrix, i);
+      key_hashes[i % kPrefetchDistance] = key_hash;
+      const int64_t bucket_index = key_hash & bit_mask;
+      port::prefetch<port::PREFETCH_HINT_T0>(key_buckets_matrix.data() +
+                                             bucket_index * key_size);
+      port::prefetch<port::PREFETCH_HINT_T0>(value_buckets_matrix.data() +
+                                             bucket_index * value_size);
+    };
+    for (int64_t i = 0; i < std::min(kPrefetchDistance, num_elements); ++i) {
+      hash_and_prefetch(i);
+    }
     // TODO(andreasst): parallelize using work_sharder
     for (int64_t i = 0; i < num_elements; ++i) {
-      const uint64 key_hash = HashKey(key_matrix, i);
+      const uint64 key_hash = key_hashes[i % kPrefetchDistance];
+      if (i + kPrefetchDistance < num_elements) {
+        hash_and_prefetch(i + kPrefetchDistance);
+      }
       if (empty_key_hash_ == key_hash &&
           IsEqualKey(empty_key_matrix, 0, key_matrix, i)) {
         return errors::InvalidArgument(
@@ -840,6 +1108,9 @@ class MutableDenseHashTable final : public LookupInterface {
     return DoInsert(ctx, old_key_buckets, old_value_buckets, true);
   }
 
+  // How many keys ahead Find prefetches buckets.
+  static constexpr int64_t kPrefetchDistance = 8;
+
   uint64 HashKey(typename TTypes<K>::ConstMatrix key, int64_t index) const {
     if (key_shape_.num_elements() == 1) {
       return HashScalar(key(index, 0));
@@ -1141,6 +1412,33 @@ REGISTER_KERNEL(tstring, tstring);
           .TypeConstraint<value_dtype>("value_dtype"),                         \
       AnonymousLookupTableOp<                                                  \
           lookup::MutableHashTableOfScalars<key_dtype, value_dtype>,           \
+          key_dtype, value_dtype>)                                             \
+  REGISTER_KERNEL_BUILDER(                                                     \
+      Name("MutableHashTable")                                                 \
+          .Device(DEVICE_CPU)                                                  \
+          .TypeConstraint<key_dtype>("key_dtype")                              \
+          .TypeConstraint<value_dtype>("value_dtype")                          \
+          .Label("sharded"),                                                   \
+      LookupTableOp<                                                           \
+          lookup::ShardedMutableHashTableOfScalars<key_dtype, value_dtype>,    \
+          key_dtype, value_dtype>)                                             \
+  REGISTER_KERNEL_BUILDER(                                                     \
+      Name("MutableHashTableV2")                                               \
+          .Device(DEVICE_CPU)                                                  \
+          .TypeConstraint<key_dtype>("key_dtype")                              \
+          .TypeConstraint<value_dtype>("value_dtype")                          \
+          .Label("sharded"),                                                   \
+      LookupTableOp<                                                           \
+          lookup::ShardedMutableHashTableOfScalars<key_dtype, value_dtype>,    \
+          key_dtype, value_dtype>)                                             \
+  REGISTER_KERNEL_BUILDER(                                                     \
+      Name("AnonymousMutableHashTable")                                        \
+          .Device(DEVICE_CPU)                                                  \
+          .TypeConstraint<key_dtype>("key_dtype")                              \
+          .TypeConstraint<value_dtype>("value_dtype")                          \
+          .Label("sharded"),                                                   \
+      AnonymousLookupTableOp<                                                  \
+          lookup::ShardedMutableHashTableOfScalars<key_dtype, value_dtype>,    \
           key_dtype, value_dtype>)
 
 REGISTER_KERNEL(int32, double);
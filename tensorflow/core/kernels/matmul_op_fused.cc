@@ -70,6 +70,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/scoped_annotation.h"
 #include "tensorflow/core/protobuf/autotuning.pb.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.h"
+#include "tensorflow/core/util/autotune_maps/matmul_autotune_maps.h"
 #include "tensorflow/core/util/proto/proto_utils.h"
 #include "tensorflow/core/util/use_cudnn.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -329,14 +330,6 @@ StatusOr<std::vector<xla::AutotuneResult>> AutotuneMatMulImpl(
   return results;
 }
 
-struct FusedMatmulAutotuneGroup {
-  static string name() { return "FusedMatmul"; }
-};
-
-typedef AutotuneSingleton<FusedMatmulAutotuneGroup, MatmulParameters,
-                          AutotuneEntry<se::dnn::FusedMatmulOp>>
-    FusedMatmulAutotuneMap;
-
 template <typename T>
 StatusOr<AutotuneEntry<se::dnn::FusedMatmulOp>> AutotuneFusedMatmul(
     bool cudnn_use_autotune,
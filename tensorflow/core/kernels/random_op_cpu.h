@@ -27,9 +27,11 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/random_op.h"
+#include "tensorflow/core/kernels/random_op_philox_simd.h"
 #include "tensorflow/core/kernels/random_ops_util.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/lib/random/random_distributions_utils.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/guarded_philox_random.h"
@@ -72,6 +74,45 @@ struct FillPhiloxRandom {
   }
 };
 
+// Fills whole output groups of a distribution that consumes exactly one
+// Philox block per group from a batch of generated blocks, see
+// FillPhiloxBlocks. Distributions without a specialization are sampled one
+// group at a time.
+template <class Distribution>
+struct FillPhiloxRandomGroups {
+  static constexpr bool kEnabled = false;
+};
+
+template <>
+struct FillPhiloxRandomGroups<
+    random::UniformDistribution<PhiloxRandom, float>> {
+  static constexpr bool kEnabled = true;
+  static void Run(PhiloxRandom* gen, float* data, int64_t num_groups) {
+    FillPhiloxUniformFloat(gen, data, num_groups);
+  }
+};
+
+template <>
+struct FillPhiloxRandomGroups<
+    random::NormalDistribution<PhiloxRandom, float>> {
+  static constexpr bool kEnabled = true;
+  static void Run(PhiloxRandom* gen, float* data, int64_t num_groups) {
+    constexpr int64_t kBlocksPerBatch = 256;
+    constexpr int kGroupSize = PhiloxRandom::kResultElementCount;
+    uint32 samples[kBlocksPerBatch * kGroupSize];
+    while (num_groups > 0) {
+      const int64_t batch = std::min(num_groups, kBlocksPerBatch);
+      FillPhiloxBlocks(gen, samples, batch);
+      for (int64_t i = 0; i < batch * kGroupSize; i += 2) {
+        random::BoxMullerFloat(samples[i], samples[i + 1], &data[i],
+                               &data[i + 1]);
+      }
+      data += batch * kGroupSize;
+      num_groups -= batch;
+    }
+  }
+};
+
 // A class to fill a specified range of random groups
 template <class Distribution, bool VariableSamplesPerOutput>
 struct FillPhiloxRandomTask;
@@ -90,7 +131,16 @@ struct FillPhiloxRandomTask<Distribution, false> {
 
     // First fill all the full-size groups
     int64_t limit_group_full = std::min(limit_group, size / kGroupSize);
-    for (int64_t index = start_group; index < limit_group_full; ++index) {
+    int64_t index = start_group;
+    if constexpr (FillPhiloxRandomGroups<Distribution>::kEnabled) {
+      if (limit_group_full > index) {
+        FillPhiloxRandomGroups<Distribution>::Run(&gen, data + offset,
+                                                  limit_group_full - index);
+        offset += (limit_group_full - index) * kGroupSize;
+        index = limit_group_full;
+      }
+    }
+    for (; index < limit_group_full; ++index) {
       auto samples = dist(&gen);
       std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
       offset += kGroupSize;
@@ -0,0 +1,250 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/random_op_philox_simd.h"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/random_distributions_utils.h"
+#include "tensorflow/core/platform/cpu_info.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TF_PHILOX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace tensorflow {
+namespace functor {
+namespace {
+
+using random::PhiloxRandom;
+
+// The round constants of random::PhiloxRandom.
+constexpr uint32_t kPhiloxW32A = 0x9E3779B9;
+constexpr uint32_t kPhiloxW32B = 0xBB67AE85;
+constexpr uint32_t kPhiloxM4x32A = 0xD2511F53;
+constexpr uint32_t kPhiloxM4x32B = 0xCD9E8D57;
+
+constexpr int kPhiloxRounds = 10;
+
+template <typename T>
+inline T Convert(uint32_t x) {
+  if constexpr (std::is_same_v<T, float>) {
+    return random::Uint32ToFloat(x);
+  } else {
+    return x;
+  }
+}
+
+template <typename T>
+void FillBlocksScalar(PhiloxRandom* gen, T* output, int64_t num_blocks) {
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    const PhiloxRandom::ResultType block = (*gen)();
+    for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+      output[i * PhiloxRandom::kResultElementCount + j] = Convert<T>(block[j]);
+    }
+  }
+}
+
+#ifdef TF_PHILOX_X86_SIMD
+
+// Runs blocks of `kLanes` consecutive counters through `Kernel`, which holds
+// one 32-bit word of each counter per vector lane. Batches whose lowest
+// counter word would wrap around, and the trailing blocks, take the scalar
+// path, so the counter arithmetic matches PhiloxRandom::Skip exactly.
+template <int kLanes, typename T, typename Kernel>
+inline void FillBlocksVectorized(PhiloxRandom* gen, T* output,
+                                 int64_t num_blocks, Kernel kernel) {
+  constexpr int kElements = PhiloxRandom::kResultElementCount;
+  int64_t i = 0;
+  while (num_blocks - i >= kLanes) {
+    const PhiloxRandom::ResultType& counter = gen->counter();
+    if (counter[0] > std::numeric_limits<uint32_t>::max() - (kLanes - 1)) {
+      FillBlocksScalar(gen, output + i * kElements, 1);
+      ++i;
+      continue;
+    }
+    kernel(counter, gen->key(), output + i * kElements);
+    gen->Skip(kLanes);
+    i += kLanes;
+  }
+  FillBlocksScalar(gen, output + i * kElements, num_blocks - i);
+}
+
+// Upper halves of the 32x32->64 bit products of the lanes of `a` and `b`.
+__attribute__((target("avx2"))) inline __m256i MulHiAvx2(__m256i a,
+                                                          __m256i b) {
+  const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32),
+                                       _mm256_srli_epi64(b, 32));
+  return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void PhiloxKernelAvx2(
+    const PhiloxRandom::ResultType& counter, const PhiloxRandom::Key& key,
+    T* output) {
+  constexpr int kLanes = 8;
+  const __m256i m_a = _mm256_set1_epi32(kPhiloxM4x32A);
+  const __m256i m_b = _mm256_set1_epi32(kPhiloxM4x32B);
+  __m256i x0 = _mm256_add_epi32(_mm256_set1_epi32(counter[0]),
+                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  __m256i x1 = _mm256_set1_epi32(counter[1]);
+  __m256i x2 = _mm256_set1_epi32(counter[2]);
+  __m256i x3 = _mm256_set1_epi32(counter[3]);
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (int round = 0; round < kPhiloxRounds; ++round) {
+    const __m256i lo0 = _mm256_mullo_epi32(m_a, x0);
+    const __m256i hi0 = MulHiAvx2(m_a, x0);
+    const __m256i lo1 = _mm256_mullo_epi32(m_b, x2);
+    const __m256i hi1 = MulHiAvx2(m_b, x2);
+    x0 = _mm256_xor_si256(_mm256_xor_si256(hi1, x1), _mm256_set1_epi32(k0));
+    x1 = lo1;
+    x2 = _mm256_xor_si256(_mm256_xor_si256(hi0, x3), _mm256_set1_epi32(k1));
+    x3 = lo0;
+    k0 += kPhiloxW32A;
+    k1 += kPhiloxW32B;
+  }
+
+  alignas(32) T words[4][kLanes];
+  const __m256i results[4] = {x0, x1, x2, x3};
+  for (int w = 0; w < 4; ++w) {
+    if constexpr (std::is_same_v<T, float>) {
+      // Uint32ToFloat: 23 random mantissa bits with a zero exponent, minus 1.
+      const __m256i bits = _mm256_or_si256(
+          _mm256_and_si256(results[w], _mm256_set1_epi32(0x7fffff)),
+          _mm256_set1_epi32(127 << 23));
+      _mm256_store_ps(words[w], _mm256_sub_ps(_mm256_castsi256_ps(bits),
+                                              _mm256_set1_ps(1.0f)));
+    } else {
+      _mm256_store_si256(reinterpret_cast<__m256i*>(words[w]), results[w]);
+    }
+  }
+  for (int lane = 0; lane < kLanes; ++lane) {
+    for (int w = 0; w < 4; ++w) {
+      output[lane * 4 + w] = words[w][lane];
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) inline __m512i MulHiAvx512(__m512i a,
+                                                               __m512i b) {
+  const __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(a, b), 32);
+  const __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32),
+                                       _mm512_srli_epi64(b, 32));
+  return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+}
+
+template <typename T>
+__attribute__((target("avx512f"))) void PhiloxKernelAvx512(
+    const PhiloxRandom::ResultType& counter, const PhiloxRandom::Key& key,
+    T* output) {
+  constexpr int kLanes = 16;
+  const __m512i m_a = _mm512_set1_epi32(kPhiloxM4x32A);
+  const __m512i m_b = _mm512_set1_epi32(kPhiloxM4x32B);
+  __m512i x0 = _mm512_add_epi32(
+      _mm512_set1_epi32(counter[0]),
+      _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  __m512i x1 = _mm512_set1_epi32(counter[1]);
+  __m512i x2 = _mm512_set1_epi32(counter[2]);
+  __m512i x3 = _mm512_set1_epi32(counter[3]);
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (int round = 0; round < kPhiloxRounds; ++round) {
+    const __m512i lo0 = _mm512_mullo_epi32(m_a, x0);
+    const __m512i hi0 = MulHiAvx512(m_a, x0);
+    const __m512i lo1 = _mm512_mullo_epi32(m_b, x2);
+    const __m512i hi1 = MulHiAvx512(m_b, x2);
+    x0 = _mm512_xor_si512(_mm512_xor_si512(hi1, x1), _mm512_set1_epi32(k0));
+    x1 = lo1;
+    x2 = _mm512_xor_si512(_mm512_xor_si512(hi0, x3), _mm512_set1_epi32(k1));
+    x3 = lo0;
+    k0 += kPhiloxW32A;
+    k1 += kPhiloxW32B;
+  }
+
+  alignas(64) T words[4][kLanes];
+  const __m512i results[4] = {x0, x1, x2, x3};
+  for (int w = 0; w < 4; ++w) {
+    if constexpr (std::is_same_v<T, float>) {
+      const __m512i bits = _mm512_or_si512(
+          _mm512_and_si512(results[w], _mm512_set1_epi32(0x7fffff)),
+          _mm512_set1_epi32(127 << 23));
+      _mm512_store_ps(words[w], _mm512_sub_ps(_mm512_castsi512_ps(bits),
+                                              _mm512_set1_ps(1.0f)));
+    } else {
+      _mm512_store_si512(words[w], results[w]);
+    }
+  }
+  for (int lane = 0; lane < kLanes; ++lane) {
+    for (int w = 0; w < 4; ++w) {
+      output[lane * 4 + w] = words[w][lane];
+    }
+  }
+}
+
+#endif  // TF_PHILOX_X86_SIMD
+
+enum class PhiloxIsa { kScalar, kAvx2, kAvx512 };
+
+PhiloxIsa GetPhiloxIsa() {
+  static const PhiloxIsa isa = [] {
+#ifdef TF_PHILOX_X86_SIMD
+    if (port::TestCPUFeature(port::CPUFeature::AVX512F)) {
+      return PhiloxIsa::kAvx512;
+    }
+    if (port::TestCPUFeature(port::CPUFeature::AVX2)) {
+      return PhiloxIsa::kAvx2;
+    }
+#endif
+    return PhiloxIsa::kScalar;
+  }();
+  return isa;
+}
+
+template <typename T>
+void FillBlocks(PhiloxRandom* gen, T* output, int64_t num_blocks) {
+  switch (GetPhiloxIsa()) {
+#ifdef TF_PHILOX_X86_SIMD
+    case PhiloxIsa::kAvx512:
+      FillBlocksVectorized<16>(gen, output, num_blocks, PhiloxKernelAvx512<T>);
+      return;
+    case PhiloxIsa::kAvx2:
+      FillBlocksVectorized<8>(gen, output, num_blocks, PhiloxKernelAvx2<T>);
+      return;
+#endif
+    default:
+      FillBlocksScalar(gen, output, num_blocks);
+  }
+}
+
+}  // namespace
+
+void FillPhiloxBlocks(PhiloxRandom* gen, uint32_t* output,
+                      int64_t num_blocks) {
+  FillBlocks(gen, output, num_blocks);
+}
+
+void FillPhiloxUniformFloat(PhiloxRandom* gen, float* output,
+                            int64_t num_blocks) {
+  FillBlocks(gen, output, num_blocks);
+}
+
+}  // namespace functor
+}  // namespace tensorflow
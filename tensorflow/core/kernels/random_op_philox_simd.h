@@ -0,0 +1,43 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_RANDOM_OP_PHILOX_SIMD_H_
+#define TENSORFLOW_CORE_KERNELS_RANDOM_OP_PHILOX_SIMD_H_
+
+#include <cstdint>
+
+#include "tensorflow/core/lib/random/philox_random.h"
+
+namespace tensorflow {
+namespace functor {
+
+// Writes the results of `num_blocks` consecutive invocations of `(*gen)()` to
+// `output`, four elements per invocation, and advances `*gen` past them.
+//
+// On x86 CPUs with AVX-512F or AVX2 the Philox rounds run on 16 or 8 counters
+// at once. The results are bit-identical to the scalar generator on every
+// platform.
+void FillPhiloxBlocks(random::PhiloxRandom* gen, uint32_t* output,
+                      int64_t num_blocks);
+
+// Same as FillPhiloxBlocks, but converts every element to a float in [0, 1)
+// the way random::UniformDistribution<PhiloxRandom, float> does.
+void FillPhiloxUniformFloat(random::PhiloxRandom* gen, float* output,
+                            int64_t num_blocks);
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_RANDOM_OP_PHILOX_SIMD_H_
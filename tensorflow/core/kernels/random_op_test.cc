@@ -14,11 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include <random>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/random_op_philox_simd.h"
 #include "tensorflow/core/lib/math/math_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
@@ -37,6 +40,48 @@ Tensor VecShape(int64_t v) {
   }
 }
 
+TEST(FillPhiloxBlocksTest, MatchesScalarGenerator) {
+  random::PhiloxRandom::ResultType counter;
+  random::PhiloxRandom::Key key;
+  key[0] = 0x12345;
+  key[1] = 0x6789a;
+  // Start close to the wrap-around of the lowest counter word so the carry
+  // into the higher words is exercised.
+  counter[0] = 0xfffffff0u;
+  counter[1] = 0xffffffffu;
+  for (int64_t num_blocks : {0, 1, 7, 8, 17, 100, 1000}) {
+    random::PhiloxRandom gen(counter, key);
+    random::PhiloxRandom expected_gen(counter, key);
+    std::vector<uint32> blocks(num_blocks * 4);
+    functor::FillPhiloxBlocks(&gen, blocks.data(), num_blocks);
+    for (int64_t i = 0; i < num_blocks; ++i) {
+      auto expected = expected_gen();
+      for (int j = 0; j < 4; ++j) {
+        ASSERT_EQ(expected[j], blocks[i * 4 + j]) << i << " " << j;
+      }
+    }
+    EXPECT_EQ(gen.counter()[0], expected_gen.counter()[0]);
+    EXPECT_EQ(gen.counter()[1], expected_gen.counter()[1]);
+    EXPECT_EQ(gen.counter()[2], expected_gen.counter()[2]);
+  }
+}
+
+TEST(FillPhiloxBlocksTest, UniformFloatMatchesDistribution) {
+  const int64_t num_blocks = 1001;
+  random::PhiloxRandom gen(0x12345, 0x6789a);
+  random::PhiloxRandom expected_gen = gen;
+  std::vector<float> data(num_blocks * 4);
+  functor::FillPhiloxUniformFloat(&gen, data.data(), num_blocks);
+
+  random::UniformDistribution<random::PhiloxRandom, float> dist;
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    auto expected = dist(&expected_gen);
+    for (int j = 0; j < 4; ++j) {
+      ASSERT_EQ(expected[j], data[i * 4 + j]) << i << " " << j;
+    }
+  }
+}
+
 Graph* RandomUniform(int64_t n) {
   Graph* g = new Graph(OpRegistry::Global());
   test::graph::RandomUniform(g, test::graph::Constant(g, VecShape(n)),
@@ -116,6 +161,20 @@ void BM_PhiloxRandom(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_PhiloxRandom);
 
+void BM_FillPhiloxUniformFloat(::testing::benchmark::State& state) {
+  // Fill 2M random numbers
+  int count = 2 << 20;
+  random::PhiloxRandom gen(0x12345);
+  std::vector<float> data(count);
+
+  for (auto s : state) {
+    functor::FillPhiloxUniformFloat(&gen, data.data(), count / 4);
+    tensorflow::testing::DoNotOptimize(data.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_FillPhiloxUniformFloat);
+
 void BM_StdMTRandom(::testing::benchmark::State& state) {
   // Fill 2M random numbers
   int count = 2 << 20;
@@ -475,6 +475,7 @@ class AssignVariableOp : public OpKernel {
       *variable->tensor() = value;
     }
     variable->is_initialized = true;
+    variable->MarkAllRowsDirty();
   }
 
  private:
@@ -529,6 +530,7 @@ class AssignVariableOp<Device, Variant> : public OpKernel {
                     DataTypeString(variable->tensor()->dtype()), " got ",
                     DataTypeString(DT_VARIANT)));
     variable->is_initialized = true;
+    variable->MarkAllRowsDirty();
     *variable->tensor() = Tensor(DT_VARIANT, value.shape());
 
     if (input_alias) {
@@ -627,6 +629,7 @@ class AssignUpdateVariableOp : public OpKernel {
     functor::DenseUpdate<Device, T, Op> update_functor;
     update_functor(context->eigen_device<Device>(), var_tensor->flat<T>(),
                    value.flat<T>());
+    variable->MarkAllRowsDirty();
   }
 };
 
@@ -1183,6 +1186,11 @@ class ResourceScatterUpdateOp : public OpKernel {
     if (N > 0) {
       OP_REQUIRES_OK(
           c, DoScatter<Device, T, Index, op>(c, params, indices, updates, N));
+      if (isCPUDevice<Device>()) {
+        v->MarkDirtyRows(indices);
+      } else {
+        v->MarkAllRowsDirty();
+      }
     }
   }
 };
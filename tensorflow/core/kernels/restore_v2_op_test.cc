@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <complex>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <string>
@@ -26,14 +27,17 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/public/version.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
 namespace {
@@ -356,5 +360,48 @@ TEST_F(RestoreV2OpTest, RestoreAfterSaveV2) { RunTest("SaveV2"); }
 TEST_F(RestoreV2OpTest, RestoreAfterSaveSlicesV1) { RunTest("SaveSlices"); }
 TEST_F(RestoreV2OpTest, RestoreAfterSaveV1) { RunTest("Save"); }
 
+TEST_F(RestoreV2OpTest, RestoreInParallel) {
+  const string prefix =
+      io::JoinPath(testing::TmpDir(), "tensor_restore_in_parallel");
+  const int kNumTensors = 20;
+  auto make_tensor = [](int i) {
+    return MakeInput<float>(TensorShape({i + 1}), [i](int x) -> float {
+      return 100 * i + x;
+    });
+  };
+  {
+    BundleWriter writer(Env::Default(), prefix);
+    for (int i = 0; i < kNumTensors; ++i) {
+      TF_ASSERT_OK(writer.Add(strings::StrCat("tensor_", i), make_tensor(i)));
+    }
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  TF_ASSERT_OK(NodeDefBuilder("myop", "RestoreV2")
+                   .Input(FakeInput())
+                   .Input(FakeInput())
+                   .Input(FakeInput())
+                   .Attr("dtypes", std::vector<DataType>(kNumTensors, DT_FLOAT))
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<tstring>(TensorShape({}), {prefix});
+  // Restores the tensors in the reverse of their order in the data file.
+  std::vector<tstring> tensor_names;
+  for (int i = kNumTensors - 1; i >= 0; --i) {
+    tensor_names.push_back(strings::StrCat("tensor_", i));
+  }
+  AddInputFromArray<tstring>(TensorShape({kNumTensors}), tensor_names);
+  AddInputFromArray<tstring>(TensorShape({kNumTensors}),
+                             std::vector<tstring>(kNumTensors, ""));
+  setenv("TF_CHECKPOINT_RESTORE_THREADS", "4", 1);
+  const Status status = RunOpKernel();
+  unsetenv("TF_CHECKPOINT_RESTORE_THREADS");
+  TF_ASSERT_OK(status);
+  for (int j = 0; j < kNumTensors; ++j) {
+    test::ExpectTensorEqual<float>(*GetOutput(j),
+                                   make_tensor(kNumTensors - 1 - j));
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
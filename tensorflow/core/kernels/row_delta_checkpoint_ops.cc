@@ -0,0 +1,328 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/io_ops.cc.
+//
+// A row delta checkpoint is a tensor bundle that holds, for each variable,
+// either its full value under its name, or only the rows updated since the
+// previous checkpoint, as the int64 row indices under
+// "<name>/.ROW_DELTA_INDICES" and the rows under "<name>/.ROW_DELTA_VALUES".
+// A variable with no updated rows is not stored. Restoring starts from a full
+// checkpoint and applies the deltas in order.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kRowDeltaIndicesSuffix[] = "/.ROW_DELTA_INDICES";
+constexpr char kRowDeltaValuesSuffix[] = "/.ROW_DELTA_VALUES";
+
+Status ValidateScalarAndVector(const Tensor& prefix, const Tensor& names,
+                               int64_t num_names) {
+  if (!TensorShapeUtils::IsScalar(prefix.shape())) {
+    return errors::InvalidArgument("prefix must be a scalar, got shape ",
+                                   prefix.shape().DebugString());
+  }
+  if (!TensorShapeUtils::IsVector(names.shape()) ||
+      names.NumElements() != num_names) {
+    return errors::InvalidArgument("tensor_names must be a vector of ",
+                                   num_names, " names, got shape ",
+                                   names.shape().DebugString());
+  }
+  return OkStatus();
+}
+
+// Copies "rows" of "value" into a new tensor of shape [rows.size(), ...].
+// Returns false if a row is out of range.
+bool GatherRows(const Tensor& value, const std::vector<int64_t>& rows,
+                Tensor* out) {
+  const int64_t num_rows = value.dim_size(0);
+  const size_t row_bytes = num_rows == 0 ? 0 : value.TotalBytes() / num_rows;
+  TensorShape shape = value.shape();
+  shape.set_dim(0, rows.size());
+  *out = Tensor(value.dtype(), shape);
+  const char* src = value.tensor_data().data();
+  char* dst = const_cast<char*>(out->tensor_data().data());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (rows[i] < 0 || rows[i] >= num_rows) return false;
+    std::memcpy(dst + i * row_bytes, src + rows[i] * row_bytes, row_bytes);
+  }
+  return true;
+}
+
+// Applies the rows that "reader" stores for "name" to "val". Requires that
+// the reader does not hold the full value of "name".
+Status ApplyRowDelta(BundleReader* reader, const std::string& name,
+                     Tensor* val) {
+  const std::string indices_key = strings::StrCat(name, kRowDeltaIndicesSuffix);
+  if (!reader->Contains(indices_key)) return OkStatus();
+  if (val->dims() == 0 || !DataTypeCanUseMemcpy(val->dtype())) {
+    return errors::DataLoss("Row delta of ", name, " cannot update a ",
+                            DataTypeString(val->dtype()), " ",
+                            val->shape().DebugString(), " tensor");
+  }
+  const std::string values_key = strings::StrCat(name, kRowDeltaValuesSuffix);
+
+  DataType dtype;
+  TensorShape shape;
+  TF_RETURN_IF_ERROR(reader->LookupDtypeAndShape(indices_key, &dtype, &shape));
+  if (dtype != DT_INT64 || shape.dims() != 1) {
+    return errors::DataLoss("Invalid row delta indices of ", name, ": ",
+                            DataTypeString(dtype), " ", shape.DebugString());
+  }
+  Tensor indices(DT_INT64, shape);
+  TF_RETURN_IF_ERROR(reader->Lookup(indices_key, &indices));
+
+  TF_RETURN_IF_ERROR(reader->LookupDtypeAndShape(values_key, &dtype, &shape));
+  TensorShape expected_shape = val->shape();
+  expected_shape.set_dim(0, indices.NumElements());
+  if (dtype != val->dtype() || shape != expected_shape) {
+    return errors::DataLoss("Row delta values of ", name, " are ",
+                            DataTypeString(dtype), " ", shape.DebugString(),
+                            " instead of ", DataTypeString(val->dtype()), " ",
+                            expected_shape.DebugString());
+  }
+  Tensor values(dtype, shape);
+  TF_RETURN_IF_ERROR(reader->Lookup(values_key, &values));
+
+  const int64_t num_rows = val->dim_size(0);
+  const size_t row_bytes = num_rows == 0 ? 0 : val->TotalBytes() / num_rows;
+  const char* src = values.tensor_data().data();
+  char* dst = const_cast<char*>(val->tensor_data().data());
+  const auto rows = indices.vec<int64_t>();
+  for (int64_t i = 0; i < rows.size(); ++i) {
+    if (rows(i) < 0 || rows(i) >= num_rows) {
+      return errors::DataLoss("Row delta of ", name, " updates row ", rows(i),
+                              " of ", num_rows);
+    }
+    std::memcpy(dst + rows(i) * row_bytes, src + i * row_bytes, row_bytes);
+  }
+  return OkStatus();
+}
+
+class StartDirtyRowTrackingOp : public OpKernel {
+ public:
+  explicit StartDirtyRowTrackingOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      core::RefCountPtr<Var> var;
+      OP_REQUIRES_OK(
+          context, LookupResource(context, HandleFromInput(context, i), &var));
+      var->StartTrackingDirtyRows();
+    }
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("StartDirtyRowTracking").Device(DEVICE_CPU),
+                        StartDirtyRowTrackingOp);
+
+class SaveDirtyRowsOp : public OpKernel {
+ public:
+  explicit SaveDirtyRowsOp(OpKernelConstruction* context) : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& prefix = context->input(0);
+    const Tensor& tensor_names = context->input(1);
+    const int num_vars = context->num_inputs() - 2;
+    OP_REQUIRES_OK(context,
+                   ValidateScalarAndVector(prefix, tensor_names, num_vars));
+    const auto names = tensor_names.flat<tstring>();
+
+    std::vector<core::RefCountPtr<Var>> vars(num_vars);
+    for (int i = 0; i < num_vars; ++i) {
+      OP_REQUIRES_OK(context, LookupResource(context,
+                                             HandleFromInput(context, i + 2),
+                                             &vars[i]));
+      tf_shared_lock l(*vars[i]->mu());
+      OP_REQUIRES(context, vars[i]->is_initialized,
+                  errors::FailedPrecondition(
+                      "Attempting to save uninitialized variable ", names(i)));
+    }
+    // The recorded rows are forgotten once they are taken, so all rows are
+    // marked again if the delta cannot be written.
+    auto mark_all_rows = [&vars]() {
+      for (auto& var : vars) var->MarkAllRowsDirty();
+    };
+
+    BundleWriter writer(Env::Default(), prefix.scalar<tstring>()());
+    OP_REQUIRES_OK(context, writer.status());
+    for (int i = 0; i < num_vars; ++i) {
+      Var* var = vars[i].get();
+      Tensor full;
+      Tensor indices;
+      Tensor rows;
+      {
+        // Sparse updates hold at least a shared lock, so the rows cannot
+        // change while they are taken and copied.
+        mutex_lock l(*var->mu());
+        const Tensor& value = *var->tensor();
+        bool all_rows = true;
+        std::vector<int64_t> dirty_rows;
+        const bool tracked = var->TakeDirtyRows(&all_rows, &dirty_rows);
+        if (tracked && !all_rows && dirty_rows.empty()) continue;
+        if (!tracked || all_rows || value.dims() == 0 ||
+            !DataTypeCanUseMemcpy(value.dtype()) ||
+            !GatherRows(value, dirty_rows, &rows)) {
+          full = tensor::DeepCopy(value);
+        } else {
+          indices = Tensor(DT_INT64, TensorShape({static_cast<int64_t>(
+                                         dirty_rows.size())}));
+          std::copy(dirty_rows.begin(), dirty_rows.end(),
+                    indices.vec<int64_t>().data());
+        }
+      }
+      Status s;
+      if (full.IsInitialized()) {
+        s = writer.Add(names(i), full);
+      } else {
+        s = writer.Add(strings::StrCat(names(i), kRowDeltaIndicesSuffix),
+                       indices);
+        if (s.ok()) {
+          s = writer.Add(strings::StrCat(names(i), kRowDeltaValuesSuffix),
+                         rows);
+        }
+      }
+      if (!s.ok()) mark_all_rows();
+      OP_REQUIRES_OK(context, s);
+    }
+    Status s = writer.Finish();
+    if (!s.ok()) mark_all_rows();
+    OP_REQUIRES_OK(context, s);
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("SaveDirtyRows").Device(DEVICE_CPU),
+                        SaveDirtyRowsOp);
+
+class RestoreWithRowDeltasOp : public OpKernel {
+ public:
+  explicit RestoreWithRowDeltasOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("dtypes", &dtypes_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& base_prefix = context->input(0);
+    const Tensor& delta_prefixes = context->input(1);
+    const Tensor& tensor_names = context->input(2);
+    const int num_tensors = dtypes_.size();
+    OP_REQUIRES_OK(context, ValidateScalarAndVector(base_prefix, tensor_names,
+                                                    num_tensors));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(delta_prefixes.shape()),
+                errors::InvalidArgument(
+                    "delta_prefixes must be a vector, got shape ",
+                    delta_prefixes.shape().DebugString()));
+    const auto names = tensor_names.flat<tstring>();
+
+    // Bundle 0 is the base checkpoint, and bundle d is delta d - 1.
+    std::vector<std::string> prefixes = {base_prefix.scalar<tstring>()()};
+    const auto deltas = delta_prefixes.flat<tstring>();
+    for (int64_t i = 0; i < deltas.size(); ++i) prefixes.push_back(deltas(i));
+    std::vector<std::unique_ptr<BundleReader>> readers;
+    for (const std::string& prefix : prefixes) {
+      readers.push_back(std::make_unique<BundleReader>(Env::Default(), prefix));
+      OP_REQUIRES_OK(context, readers.back()->status());
+    }
+
+    const int num_bundles = readers.size();
+
+    // Each tensor is restored from the last bundle that holds its full value,
+    // followed by the row deltas of the later bundles.
+    std::vector<int> first_bundle(num_tensors);
+    for (int i = 0; i < num_tensors; ++i) {
+      const std::string name = names(i);
+      int bundle = num_bundles - 1;
+      while (bundle > 0 && !readers[bundle]->Contains(name)) --bundle;
+      first_bundle[i] = bundle;
+      DataType dtype;
+      TensorShape shape;
+      OP_REQUIRES_OK(context, readers[bundle]->LookupDtypeAndShape(
+                                  name, &dtype, &shape));
+      OP_REQUIRES(context, dtype == dtypes_[i],
+                  errors::InvalidArgument(
+                      "tensor_name = ", name, "; expected dtype ",
+                      DataTypeString(dtypes_[i]), " does not equal stored ",
+                      DataTypeString(dtype)));
+      Tensor* output;
+      OP_REQUIRES_OK(context, context->allocate_output(i, shape, &output));
+    }
+
+    // Each block of tensors is restored with readers of its own.
+    std::vector<Status> statuses(num_tensors);
+    auto restore = [&](int64_t start, int64_t limit) {
+      std::vector<std::unique_ptr<BundleReader>> block_readers(num_bundles);
+      for (int64_t i = start; i < limit; ++i) {
+        const std::string name = names(i);
+        Tensor* output = context->mutable_output(i);
+        for (int bundle = first_bundle[i]; bundle < num_bundles; ++bundle) {
+          auto& reader = block_readers[bundle];
+          if (reader == nullptr) {
+            reader = std::make_unique<BundleReader>(Env::Default(),
+                                                    prefixes[bundle]);
+          }
+          Status& s = statuses[i];
+          s = reader->status();
+          if (s.ok()) {
+            s = bundle == first_bundle[i] ? reader->Lookup(name, output)
+                                          : ApplyRowDelta(reader.get(), name,
+                                                          output);
+          }
+          if (!s.ok()) break;
+        }
+      }
+    };
+    int64_t total_bytes = 0;
+    for (int i = 0; i < num_tensors; ++i) {
+      total_bytes += context->mutable_output(i)->TotalBytes();
+    }
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_tensors,
+          total_bytes / num_tensors + 1, restore);
+    for (const Status& s : statuses) {
+      OP_REQUIRES_OK(context, s);
+    }
+  }
+
+ private:
+  DataTypeVector dtypes_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("RestoreWithRowDeltas").Device(DEVICE_CPU),
+                        RestoreWithRowDeltasOp);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,188 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/type_index.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+class RowDeltaCheckpointOpsTest : public OpsTestBase {
+ protected:
+  void SetUp() override {
+    var_ = new Var(DT_FLOAT);
+    *var_->tensor() = test::AsTensor<float>({0, 0, 1, 1, 2, 2, 3, 3},
+                                            TensorShape({4, 2}));
+    var_->is_initialized = true;
+    ResourceMgr* rm = device_->resource_manager();
+    TF_ASSERT_OK(rm->Create(rm->default_container(), "var", var_));
+  }
+
+  string Prefix(const string& name) {
+    return io::JoinPath(testing::TmpDir(), name);
+  }
+
+  void AddVarInput() {
+    AddResourceInputInternal(device_->resource_manager()->default_container(),
+                             "var", TypeIndex::Make<Var>());
+  }
+
+  // Sets "row" of the variable to "value", as a sparse update would.
+  void UpdateRow(int64_t row, float value) {
+    auto matrix = var_->tensor()->matrix<float>();
+    matrix(row, 0) = value;
+    matrix(row, 1) = value;
+    var_->MarkDirtyRows(test::AsTensor<int64_t>({row}));
+  }
+
+  void StartTracking() {
+    inputs_.clear();
+    TF_ASSERT_OK(NodeDefBuilder("start", "StartDirtyRowTracking")
+                     .Input(FakeInput(1, DT_RESOURCE))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddVarInput();
+    TF_ASSERT_OK(RunOpKernel());
+  }
+
+  void SaveDirtyRows(const string& prefix) {
+    inputs_.clear();
+    TF_ASSERT_OK(NodeDefBuilder("save", "SaveDirtyRows")
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Input(FakeInput(1, DT_RESOURCE))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddInputFromArray<tstring>(TensorShape({}), {prefix});
+    AddInputFromArray<tstring>(TensorShape({1}), {"var"});
+    AddVarInput();
+    TF_ASSERT_OK(RunOpKernel());
+  }
+
+  void ExpectRestored(const string& base,
+                      const std::vector<tstring>& deltas) {
+    inputs_.clear();
+    TF_ASSERT_OK(NodeDefBuilder("restore", "RestoreWithRowDeltas")
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Attr("dtypes", {DT_FLOAT})
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddInputFromArray<tstring>(TensorShape({}), {base});
+    AddInputFromArray<tstring>(
+        TensorShape({static_cast<int64_t>(deltas.size())}), deltas);
+    AddInputFromArray<tstring>(TensorShape({1}), {"var"});
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectTensorEqual<float>(*GetOutput(0), *var_->tensor());
+  }
+
+  Var* var_;
+};
+
+TEST_F(RowDeltaCheckpointOpsTest, SavesUpdatedRows) {
+  const string base = Prefix("rows_base");
+  SaveDirtyRows(base);
+  StartTracking();
+  UpdateRow(3, 30);
+  UpdateRow(1, 10);
+  UpdateRow(3, 31);
+  const string delta1 = Prefix("rows_delta1");
+  SaveDirtyRows(delta1);
+  UpdateRow(0, 40);
+  const string delta2 = Prefix("rows_delta2");
+  SaveDirtyRows(delta2);
+  const string delta3 = Prefix("rows_delta3");
+  SaveDirtyRows(delta3);
+
+  {
+    // The base is saved in full, since the variable was not tracked.
+    BundleReader reader(Env::Default(), base);
+    TF_ASSERT_OK(reader.status());
+    EXPECT_TRUE(reader.Contains("var"));
+  }
+  {
+    BundleReader reader(Env::Default(), delta1);
+    TF_ASSERT_OK(reader.status());
+    EXPECT_FALSE(reader.Contains("var"));
+    Tensor indices(DT_INT64, TensorShape({2}));
+    TF_ASSERT_OK(reader.Lookup("var/.ROW_DELTA_INDICES", &indices));
+    test::ExpectTensorEqual<int64_t>(indices, test::AsTensor<int64_t>({1, 3}));
+  }
+  {
+    BundleReader reader(Env::Default(), delta3);
+    TF_ASSERT_OK(reader.status());
+    EXPECT_FALSE(reader.Contains("var/.ROW_DELTA_INDICES"));
+  }
+  ExpectRestored(base, {delta1, delta2, delta3});
+}
+
+TEST_F(RowDeltaCheckpointOpsTest, SavesAllRowsAfterDenseUpdate) {
+  const string base = Prefix("dense_base");
+  SaveDirtyRows(base);
+  StartTracking();
+  UpdateRow(2, 20);
+  const string delta1 = Prefix("dense_delta1");
+  SaveDirtyRows(delta1);
+  *var_->tensor() = test::AsTensor<float>({5, 6, 7, 8, 9, 10},
+                                          TensorShape({3, 2}));
+  var_->MarkAllRowsDirty();
+  const string delta2 = Prefix("dense_delta2");
+  SaveDirtyRows(delta2);
+  UpdateRow(1, 50);
+  const string delta3 = Prefix("dense_delta3");
+  SaveDirtyRows(delta3);
+
+  {
+    BundleReader reader(Env::Default(), delta2);
+    TF_ASSERT_OK(reader.status());
+    EXPECT_TRUE(reader.Contains("var"));
+  }
+  ExpectRestored(base, {delta1, delta2, delta3});
+}
+
+TEST_F(RowDeltaCheckpointOpsTest, RestoreFailsOnMissingDelta) {
+  const string base = Prefix("missing_base");
+  SaveDirtyRows(base);
+  inputs_.clear();
+  TF_ASSERT_OK(NodeDefBuilder("restore", "RestoreWithRowDeltas")
+                   .Input(FakeInput())
+                   .Input(FakeInput())
+                   .Input(FakeInput())
+                   .Attr("dtypes", {DT_FLOAT})
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<tstring>(TensorShape({}), {base});
+  AddInputFromArray<tstring>(TensorShape({1}), {Prefix("missing_delta")});
+  AddInputFromArray<tstring>(TensorShape({1}), {"var"});
+  EXPECT_FALSE(RunOpKernel().ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
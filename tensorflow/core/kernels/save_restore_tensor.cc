@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <unordered_map>
@@ -22,6 +23,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
@@ -33,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -250,6 +253,14 @@ namespace {
 // Tensors larger than this threshold will be restored from a thread-pool.
 const int64_t kLargeShapeThreshold = 16 << 20;  // 16M
 
+// If set to more than 1, the number of threads that restore all the tensors
+// of a RestoreV2 op. See RunRestoreOpsInParallel().
+constexpr char kRestoreThreadsEnvVar[] = "TF_CHECKPOINT_RESTORE_THREADS";
+
+// If true, full tensors are restored as read-only memory mappings of the data
+// files where possible. See BundleReader::LookupMapped().
+constexpr char kRestoreMmapEnvVar[] = "TF_CHECKPOINT_RESTORE_MMAP";
+
 // A restore operation for a single tensor.  Small tensors may be restored
 // directly from the op thread to improve read locality.  Large tensors can be
 // restored from a thread pool: this requires creating a separate BundleReader
@@ -301,7 +312,13 @@ struct RestoreOp {
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
-    if (shape_and_slice.empty()) {
+    Tensor mapped_tensor;
+    if (shape_and_slice.empty() && mapped) {
+      // Lookup the full tensor as a mapping, which is only read when used.
+      TF_RETURN_IF_ERROR(reader->LookupMapped(tensor_name, &mapped_tensor));
+      context->set_output(idx, mapped_tensor);
+      restored_tensor = &mapped_tensor;
+    } else if (shape_and_slice.empty()) {
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
           context->allocate_output(idx, restored_full_shape, &restored_tensor));
@@ -355,10 +372,65 @@ struct RestoreOp {
   string shape_and_slice;
   string reader_prefix;
   DataType dtype;
+  // The data file shard of the tensor and the bytes stored for it there, or
+  // 0 for a partitioned tensor, whose slices are stored under other keys.
+  int32_t shard_id = 0;
+  int64_t stored_bytes = 0;
+  // The number of bytes to restore.
+  int64_t num_bytes = 0;
+  // Whether a full tensor is restored as a memory mapping.
+  bool mapped = false;
 
   ::tensorflow::Status status;
 };
 
+// Restores `restore_ops`, which are sorted by their location in the data
+// files, from `num_threads` threads. The ops are split into contiguous runs
+// of about the same number of bytes, each restored with its own BundleReader,
+// so that the data files are read concurrently but each run sequentially.
+Status RunRestoreOpsInParallel(int64_t num_threads,
+                               std::vector<RestoreOp>& restore_ops) {
+  if (restore_ops.empty()) return OkStatus();
+  int64_t total_bytes = 0;
+  for (const RestoreOp& restore_op : restore_ops) {
+    total_bytes += restore_op.num_bytes;
+  }
+  std::vector<std::pair<size_t, size_t>> runs;
+  size_t run_begin = 0;
+  int64_t num_bytes = 0;
+  for (size_t i = 0; i < restore_ops.size(); ++i) {
+    num_bytes += restore_ops[i].num_bytes;
+    // Ends the run once the runs so far have their share of the bytes.
+    if (num_bytes * num_threads >= total_bytes * (runs.size() + 1) ||
+        i + 1 == restore_ops.size()) {
+      runs.emplace_back(run_begin, i + 1);
+      run_begin = i + 1;
+    }
+  }
+
+  std::vector<Status> statuses(runs.size());
+  {
+    thread::ThreadPool pool(
+        Env::Default(), "restore_tensors",
+        std::min(num_threads, static_cast<int64_t>(runs.size())));
+    for (size_t r = 0; r < runs.size(); ++r) {
+      pool.Schedule([&restore_ops, &runs, &statuses, r]() {
+        BundleReader reader(Env::Default(),
+                            restore_ops[runs[r].first].reader_prefix);
+        statuses[r] = reader.status();
+        for (size_t i = runs[r].first; i < runs[r].second && statuses[r].ok();
+             ++i) {
+          statuses[r] = restore_ops[i].run(&reader);
+        }
+      });
+    }
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return OkStatus();
+}
+
 }  // namespace
 
 Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
@@ -383,12 +455,22 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
   TF_RETURN_IF_ERROR(default_reader.SortForSequentialAccess<RestoreOp>(
       restore_ops, [](const RestoreOp& op) { return op.tensor_name; }));
 
+  bool use_mmap = false;
+  TF_RETURN_IF_ERROR(ReadBoolFromEnvVar(kRestoreMmapEnvVar, false, &use_mmap));
   std::vector<string> mismatched_errors;
-  for (const RestoreOp& restore_op : restore_ops) {
+  for (RestoreOp& restore_op : restore_ops) {
+    restore_op.mapped = use_mmap;
     TensorShape restored_full_shape;
     DataType original_dtype;
     TF_RETURN_IF_ERROR(default_reader.LookupDtypeAndShape(
         restore_op.tensor_name, &original_dtype, &restored_full_shape));
+    TF_RETURN_IF_ERROR(default_reader.LookupDataLocation(
+        restore_op.tensor_name, &restore_op.shard_id,
+        &restore_op.stored_bytes));
+    restore_op.num_bytes =
+        restore_op.stored_bytes > 0
+            ? restore_op.stored_bytes
+            : restored_full_shape.num_elements() * DataTypeSize(original_dtype);
     if (restore_op.dtype != original_dtype) {
       string error_msg = strings::StrCat(
           "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
@@ -402,17 +484,25 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     return errors::InvalidArgument(error_msg);
   }
 
+  int64_t num_threads = 0;
+  TF_RETURN_IF_ERROR(
+      ReadInt64FromEnvVar(kRestoreThreadsEnvVar, 0, &num_threads));
+  const uint64 start_time_usecs = Env::Default()->NowMicros();
   std::vector<RestoreOp*> pool_restore_ops;
   std::vector<RestoreOp*> direct_restore_ops;
-  for (RestoreOp& restore_op : restore_ops) {
-    if (restore_op.should_run_in_pool(&default_reader)) {
-      pool_restore_ops.push_back(&restore_op);
-    } else {
-      direct_restore_ops.push_back(&restore_op);
+  if (num_threads > 1) {
+    TF_RETURN_IF_ERROR(RunRestoreOpsInParallel(num_threads, restore_ops));
+  } else {
+    for (RestoreOp& restore_op : restore_ops) {
+      // Mapping a large tensor does not read it, so it is not worth a thread.
+      if (!restore_op.mapped &&
+          restore_op.should_run_in_pool(&default_reader)) {
+        pool_restore_ops.push_back(&restore_op);
+      } else {
+        direct_restore_ops.push_back(&restore_op);
+      }
     }
-  }
 
-  {
     // Schedule any threaded operations first, skipping thread pool creation if
     // we don't have any expensive operations.
     std::unique_ptr<thread::ThreadPool> reader_pool;
@@ -435,6 +525,17 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     TF_RETURN_IF_ERROR(op->status);
   }
 
+  int64_t total_bytes = 0;
+  for (const RestoreOp& restore_op : restore_ops) {
+    total_bytes += restore_op.num_bytes;
+    if (restore_op.stored_bytes > 0) {
+      metrics::RecordCheckpointRestoreBytes(restore_op.shard_id,
+                                            restore_op.stored_bytes);
+    }
+  }
+  metrics::RecordCheckpointRestoreThroughput(
+      total_bytes, Env::Default()->NowMicros() - start_time_usecs);
+
   for (const RestoreOp& restore_op : restore_ops) {
     if (restore_op.dtype != context->mutable_output(restore_op.idx)->dtype()) {
       return errors::InvalidArgument(
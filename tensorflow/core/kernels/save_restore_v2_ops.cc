@@ -16,10 +16,16 @@ limitations under the License.
 // See docs in ../ops/io_ops.cc.
 
 #include <cstddef>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/span.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -29,10 +35,14 @@ limitations under the License.
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"  // IWYU pragma: keep
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
@@ -90,6 +100,165 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Writes the tensors of a SaveV2 op to the bundle at `prefix`.
+Status SaveTensors(const string& prefix, const std::vector<string>& names,
+                   const std::vector<string>& shape_and_slices,
+                   const std::vector<Tensor>& tensors) {
+  BundleWriter writer(Env::Default(), prefix);
+  TF_RETURN_IF_ERROR(writer.status());
+  VLOG(1) << "BundleWriter, prefix_string: " << prefix;
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const string& tensor_name = names[i];
+    const Tensor& tensor = tensors[i];
+    VLOG(2) << "Starting save of " << tensor_name;
+
+    if (!shape_and_slices[i].empty()) {
+      const string& shape_spec = shape_and_slices[i];
+      TensorShape shape;
+      TensorSlice slice(tensor.dims());
+      TensorShape slice_shape;
+
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(shape_spec, &shape,
+                                                        &slice, &slice_shape));
+      if (!slice_shape.IsSameSize(tensor.shape())) {
+        return errors::InvalidArgument(
+            "Slice in shape_and_slice "
+            "specification does not match the "
+            "shape of the tensor to  save: ",
+            shape_spec, ", tensor: ", tensor.shape().DebugString());
+      }
+
+      TF_RETURN_IF_ERROR(writer.AddSlice(tensor_name, shape, slice, tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(tensor_name, tensor));
+    }
+
+    if (VLOG_IS_ON(5)) {
+      if (tensor.dtype() == DT_FLOAT) {
+        const float* t_data = tensor.flat<float>().data();
+        float min = std::numeric_limits<float>::infinity();
+        float max = -std::numeric_limits<float>::infinity();
+        double avg = 0.0;
+        for (int i = 0; i < tensor.NumElements(); ++i) {
+          if (t_data[i] < min) min = t_data[i];
+          if (t_data[i] > max) max = t_data[i];
+          avg += t_data[i];
+        }
+        VLOG(5) << " min " << min << " max " << max << " avg "
+                << avg / tensor.NumElements() << " total elts "
+                << tensor.NumElements();
+      }
+    }
+
+    VLOG(2) << "Done save of " << tensor_name;
+  }
+  TF_RETURN_IF_ERROR(writer.Finish());
+  VLOG(1) << "Done BundleWriter, prefix_string: " << prefix;
+  return OkStatus();
+}
+
+// If set to more than 0, SaveV2 ops write their bundles on that many
+// background threads, and return once they hold references to the tensors
+// to save. Resource variables copy their buffers before updating them while
+// the buffers are shared, so the referenced tensors keep the values at the
+// time of the save.
+constexpr char kAsyncSaveThreadsEnvVar[] = "TF_CHECKPOINT_ASYNC_SAVE_THREADS";
+
+// Runs the saves of SaveV2 ops in the background. A save waits while as
+// many saves as there are threads are pending, so that a checkpoint waits
+// for the previous one to be written. MergeV2Checkpoints and RestoreV2 wait
+// for the saves of the prefixes that they read.
+class AsyncBundleSaver {
+ public:
+  explicit AsyncBundleSaver(int num_threads)
+      : num_threads_(num_threads),
+        pool_(Env::Default(), "async_checkpoint_save", num_threads) {}
+
+  // Returns the saver, or nullptr if SaveV2 ops save synchronously.
+  static AsyncBundleSaver* Get() {
+    static AsyncBundleSaver* saver = []() -> AsyncBundleSaver* {
+      int64_t num_threads = 0;
+      TF_CHECK_OK(
+          ReadInt64FromEnvVar(kAsyncSaveThreadsEnvVar, 0, &num_threads));
+      if (num_threads <= 0) return nullptr;
+      return new AsyncBundleSaver(num_threads);
+    }();
+    return saver;
+  }
+
+  // Schedules `save` of `prefix`. Returns instead the error of an earlier
+  // save that nothing waited for, if there is one.
+  Status Schedule(const string& prefix, std::function<Status()> save)
+      TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    while (pending_.size() >= num_threads_ || pending_.contains(prefix)) {
+      cv_.wait(l);
+    }
+    if (!errors_.empty()) {
+      const Status status = errors_.begin()->second;
+      errors_.erase(errors_.begin());
+      return status;
+    }
+    pending_.insert(prefix);
+    pool_.Schedule([this, prefix, save = std::move(save)]() {
+      const Status status = save();
+      mutex_lock l(mu_);
+      pending_.erase(prefix);
+      if (!status.ok()) errors_[prefix] = status;
+      cv_.notify_all();
+    });
+    return OkStatus();
+  }
+
+  // Waits for the save of `prefix`, if one is pending, and returns its
+  // status.
+  Status Wait(const string& prefix) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    while (pending_.contains(prefix)) {
+      cv_.wait(l);
+    }
+    auto error = errors_.find(prefix);
+    if (error == errors_.end()) return OkStatus();
+    const Status status = error->second;
+    errors_.erase(error);
+    return status;
+  }
+
+ private:
+  const size_t num_threads_;
+  thread::ThreadPool pool_;
+  mutex mu_;
+  condition_variable cv_;
+  absl::flat_hash_set<string> pending_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<string, Status> errors_ TF_GUARDED_BY(mu_);
+};
+
+// Waits for the pending async saves of `prefixes`.
+Status WaitForAsyncSaves(absl::Span<const tstring> prefixes) {
+  AsyncBundleSaver* saver = AsyncBundleSaver::Get();
+  if (saver == nullptr) return OkStatus();
+  for (const tstring& prefix : prefixes) {
+    TF_RETURN_IF_ERROR(saver->Wait(prefix));
+  }
+  return OkStatus();
+}
+
+Status GetCheckpointCallbackManager(
+    OpKernelContext* context,
+    checkpoint::CheckpointCallbackManager** checkpoint_callback_manager) {
+  ResourceMgr* resource_manager = context->resource_manager();
+  return resource_manager->LookupOrCreate<
+      checkpoint::CheckpointCallbackManager>(
+      resource_manager->default_container(),
+      std::string(checkpoint::kCheckpointCallbackManagerResourceName),
+      checkpoint_callback_manager,
+      [](checkpoint::CheckpointCallbackManager** out) {
+        *out = new checkpoint::CheckpointCallbackManager();
+        return OkStatus();
+      });
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
@@ -110,76 +279,40 @@ class SaveV2 : public OpKernel {
     const string& prefix_string = prefix.scalar<tstring>()();
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
-
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    std::vector<string> names(num_tensors);
+    std::vector<string> slices(num_tensors);
+    std::vector<Tensor> tensors(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
-
-      if (!shape_and_slices_flat(i).empty()) {
-        const string& shape_spec = shape_and_slices_flat(i);
-        TensorShape shape;
-        TensorSlice slice(tensor.dims());
-        TensorShape slice_shape;
-
-        OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
-        OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
-                    errors::InvalidArgument("Slice in shape_and_slice "
-                                            "specification does not match the "
-                                            "shape of the tensor to  save: ",
-                                            shape_spec, ", tensor: ",
-                                            tensor.shape().DebugString()));
-
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
-      }
-
-      if (VLOG_IS_ON(5)) {
-        if (tensor.dtype() == DT_FLOAT) {
-          const float* t_data = tensor.flat<float>().data();
-          float min = std::numeric_limits<float>::infinity();
-          float max = -std::numeric_limits<float>::infinity();
-          double avg = 0.0;
-          for (int i = 0; i < tensor.NumElements(); ++i) {
-            if (t_data[i] < min) min = t_data[i];
-            if (t_data[i] > max) max = t_data[i];
-            avg += t_data[i];
-          }
-          VLOG(5) << " min " << min << " max " << max << " avg "
-                  << avg / tensor.NumElements() << " total elts "
-                  << tensor.NumElements();
-        }
-      }
-
-      VLOG(2) << "Done save of " << tensor_name;
+      names[i] = tensor_names_flat(i);
+      slices[i] = shape_and_slices_flat(i);
+      tensors[i] = context->input(i + kFixedInputs);
     }
-    OP_REQUIRES_OK(context, writer.Finish());
-    VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
 
-    ResourceMgr* resource_manager = context->resource_manager();
-    if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
-      OP_REQUIRES_OK(
-          context,
-          resource_manager
-              ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
-                  resource_manager->default_container(),
-                  std::string(
-                      checkpoint::kCheckpointCallbackManagerResourceName),
-                  &checkpoint_callback_manager,
-                  [](checkpoint::CheckpointCallbackManager** out) {
-                    *out = new checkpoint::CheckpointCallbackManager();
-                    return OkStatus();
-                  }));
-      checkpoint_callback_manager->Save(prefix_string);
-      checkpoint_callback_manager->Unref();
+    std::shared_ptr<checkpoint::CheckpointCallbackManager>
+        checkpoint_callback_manager;
+    if (context->resource_manager() != nullptr) {
+      checkpoint::CheckpointCallbackManager* manager;
+      OP_REQUIRES_OK(context, GetCheckpointCallbackManager(context, &manager));
+      checkpoint_callback_manager.reset(
+          manager, [](checkpoint::CheckpointCallbackManager* manager) {
+            manager->Unref();
+          });
+    }
+    auto save = [prefix_string, names = std::move(names),
+                 slices = std::move(slices), tensors = std::move(tensors),
+                 checkpoint_callback_manager]() {
+      TF_RETURN_IF_ERROR(SaveTensors(prefix_string, names, slices, tensors));
+      if (checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Save(prefix_string);
+      }
+      return OkStatus();
+    };
+
+    AsyncBundleSaver* saver = AsyncBundleSaver::Get();
+    if (saver != nullptr) {
+      OP_REQUIRES_OK(context, saver->Schedule(prefix_string, std::move(save)));
+    } else {
+      OP_REQUIRES_OK(context, save());
     }
   }
 };
@@ -205,6 +338,8 @@ class RestoreV2 : public OpKernel {
     if (!context->status().ok()) return;
 
     const string& prefix_string = prefix.scalar<tstring>()();
+    OP_REQUIRES_OK(context,
+                   WaitForAsyncSaves({prefix.scalar<tstring>()()}));
 
     VLOG(2) << "Started Restore at prefix: " << prefix_string;
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
@@ -287,6 +422,7 @@ class MergeV2Checkpoints : public OpKernel {
         gtl::ArraySlice<tstring>(checkpoint_prefixes.flat<tstring>());
     Env* env = Env::Default();
     const string& merged_prefix = destination_prefix.scalar<tstring>()();
+    OP_REQUIRES_OK(context, WaitForAsyncSaves(input_prefixes));
     OP_REQUIRES_OK(context,
                    tensorflow::MergeBundles(env, input_prefixes, merged_prefix,
                                             allow_missing_files_));
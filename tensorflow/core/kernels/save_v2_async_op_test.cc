@@ -0,0 +1,118 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+// SaveV2 reads the environment variable when it first saves, so all the
+// tests of this file save asynchronously.
+class AsyncSaveV2OpTest : public OpsTestBase {
+ protected:
+  void SetUp() override {
+    setenv("TF_CHECKPOINT_ASYNC_SAVE_THREADS", "2", 1);
+  }
+
+  void Save(const string& prefix, const string& name, float value) {
+    inputs_.clear();
+    TF_ASSERT_OK(NodeDefBuilder("save", "SaveV2")
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Input(FakeInput({DT_FLOAT}))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddInputFromArray<tstring>(TensorShape({}), {prefix});
+    AddInputFromArray<tstring>(TensorShape({1}), {name});
+    AddInputFromArray<tstring>(TensorShape({1}), {""});
+    AddInputFromArray<float>(TensorShape({1000}),
+                             std::vector<float>(1000, value));
+    TF_ASSERT_OK(RunOpKernel());
+  }
+};
+
+TEST_F(AsyncSaveV2OpTest, RestoreWaitsForSave) {
+  const int kNumSaves = 5;
+  for (int i = 0; i < kNumSaves; ++i) {
+    Save(io::JoinPath(testing::TmpDir(), strings::StrCat("async_save_", i)),
+         "tensor", i);
+  }
+  for (int i = 0; i < kNumSaves; ++i) {
+    inputs_.clear();
+    TF_ASSERT_OK(NodeDefBuilder("restore", "RestoreV2")
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Input(FakeInput())
+                     .Attr("dtypes", {DT_FLOAT})
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddInputFromArray<tstring>(
+        TensorShape({}),
+        {io::JoinPath(testing::TmpDir(), strings::StrCat("async_save_", i))});
+    AddInputFromArray<tstring>(TensorShape({1}), {"tensor"});
+    AddInputFromArray<tstring>(TensorShape({1}), {""});
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectTensorEqual<float>(
+        *GetOutput(0), test::AsTensor<float>(std::vector<float>(1000, i)));
+  }
+}
+
+TEST_F(AsyncSaveV2OpTest, MergeWaitsForSaves) {
+  const string dir = io::JoinPath(testing::TmpDir(), "async_save_merge");
+  const std::vector<tstring> prefixes = {io::JoinPath(dir, "part_0"),
+                                         io::JoinPath(dir, "part_1")};
+  Save(prefixes[0], "tensor_0", 0);
+  Save(prefixes[1], "tensor_1", 1);
+
+  inputs_.clear();
+  TF_ASSERT_OK(NodeDefBuilder("merge", "MergeV2Checkpoints")
+                   .Input(FakeInput())
+                   .Input(FakeInput())
+                   .Attr("delete_old_dirs", false)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<tstring>(TensorShape({2}), prefixes);
+  const string merged_prefix = io::JoinPath(dir, "merged");
+  AddInputFromArray<tstring>(TensorShape({}), {merged_prefix});
+  TF_ASSERT_OK(RunOpKernel());
+
+  BundleReader reader(Env::Default(), merged_prefix);
+  TF_ASSERT_OK(reader.status());
+  for (int i = 0; i < 2; ++i) {
+    Tensor tensor(DT_FLOAT, TensorShape({1000}));
+    TF_ASSERT_OK(reader.Lookup(strings::StrCat("tensor_", i), &tensor));
+    test::ExpectTensorEqual<float>(
+        tensor, test::AsTensor<float>(std::vector<float>(1000, i)));
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -18,7 +18,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_SEGMENT_REDUCTION_OPS_IMPL_H_
 #define TENSORFLOW_CORE_KERNELS_SEGMENT_REDUCTION_OPS_IMPL_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "tensorflow/core/framework/op_requires.h"
 #include "tensorflow/core/platform/types.h"
@@ -391,6 +393,25 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
     // Nothing to reduce. All output values equal to `InitialValueF()`.
     if (num_reductions == 0) return;
 
+    // Parallelizing by segment leaves a thread alone with a segment that has
+    // many of the rows, so then each thread reduces a range of rows into its
+    // own partial output instead. The partial outputs take at most as much
+    // memory as the input.
+    const int num_threads = cpu_device.numThreads();
+    const int64_t max_segment_size =
+        *std::max_element(row_counter.begin(), row_counter.end());
+    if (num_threads > 1 && N * inner_dim >= kMinElementsToPartitionRows &&
+        max_segment_size * num_threads > 2 * num_real_segment &&
+        !OpDeterminismRequired()) {
+      const int64_t num_partitions =
+          std::min<int64_t>(num_threads, N / num_segments);
+      if (num_partitions > 1) {
+        ReduceRowRanges(ctx, num_partitions, row_counter, segment_ids, data,
+                        output);
+        return;
+      }
+    }
+
     // Parallelize by `num_segments`. It's simple, efficient and safe
     // (no data dependency):
     //
@@ -422,6 +443,75 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
     const Eigen::TensorOpCost cost(input_bytes, output_bytes, compute_cycles);
     cpu_device.parallelFor(num_segments, cost, reductionWorker);
   }
+
+ private:
+  static constexpr int64_t kMinElementsToPartitionRows = 1 << 15;
+
+  // Reduces `num_partitions` ranges of rows in parallel, the first one into
+  // `output` and the others into partial outputs, which are then reduced into
+  // `output` by segment.
+  static void ReduceRowRanges(OpKernelContext* ctx, int64_t num_partitions,
+                              const std::vector<Index>& row_counter,
+                              typename TTypes<Index>::ConstFlat segment_ids,
+                              typename TTypes<T, 2>::ConstTensor data,
+                              typename TTypes<T, 2>::Tensor output) {
+    auto cpu_device = ctx->eigen_cpu_device();
+    const int64_t N = segment_ids.dimension(0);
+    const int64_t num_segments = output.dimension(0);
+    const int64_t inner_dim = data.dimension(1);
+    const int64_t partial_size = num_segments * inner_dim;
+    ReductionF reduction;
+
+    Tensor partials;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
+                            DataTypeToEnum<T>::value,
+                            TensorShape({(num_partitions - 1) * partial_size}),
+                            &partials));
+    auto partials_flat = partials.flat<T>();
+    partials_flat.device(cpu_device) =
+        partials_flat.constant(InitialValueF()());
+
+    auto reduce_rows = [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        typename TTypes<T, 2>::Tensor partial(
+            p == 0 ? output.data()
+                   : partials_flat.data() + (p - 1) * partial_size,
+            num_segments, inner_dim);
+        for (int64_t i = N * p / num_partitions;
+             i < N * (p + 1) / num_partitions; ++i) {
+          Index j = internal::SubtleMustCopy(segment_ids(i));
+          if (j >= 0 && j < num_segments) {
+            reduction(data.template chip<0>(i), partial.template chip<0>(j));
+          }
+        }
+      }
+    };
+    const int64_t rows_per_partition = N / num_partitions;
+    cpu_device.parallelFor(
+        num_partitions,
+        Eigen::TensorOpCost(sizeof(T) * inner_dim * rows_per_partition,
+                            sizeof(T) * inner_dim * rows_per_partition,
+                            5 * inner_dim * rows_per_partition),
+        reduce_rows);
+
+    auto combine = [&](int64_t begin, int64_t end) {
+      for (int64_t j = begin; j < end; ++j) {
+        if (row_counter[j] == 0) continue;
+        for (int64_t p = 1; p < num_partitions; ++p) {
+          const typename TTypes<T, 2>::ConstTensor partial(
+              partials_flat.data() + (p - 1) * partial_size, num_segments,
+              inner_dim);
+          reduction(partial.template chip<0>(j), output.template chip<0>(j));
+        }
+      }
+    };
+    cpu_device.parallelFor(
+        num_segments,
+        Eigen::TensorOpCost(sizeof(T) * inner_dim * num_partitions,
+                            sizeof(T) * inner_dim,
+                            5 * inner_dim * (num_partitions - 1)),
+        combine);
+  }
 };
 
 template <typename T>
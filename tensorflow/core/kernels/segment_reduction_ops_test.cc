@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <functional>
+#include <random>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -31,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/public/session_options.h"
@@ -38,9 +40,22 @@ limitations under the License.
 
 namespace tensorflow {
 
+// Returns a segment id in [0, num_segments) for each of num_rows rows, with
+// the probability of id k proportional to 1 / (k + 1).
+static std::vector<int> ZipfianSegmentIds(int num_rows, int num_segments) {
+  std::vector<double> weights(num_segments);
+  for (int k = 0; k < num_segments; ++k) weights[k] = 1.0 / (k + 1);
+  std::discrete_distribution<int> distribution(weights.begin(), weights.end());
+  std::mt19937 generator(/*seed=*/7);
+  std::vector<int> ids(num_rows);
+  for (int& id : ids) id = distribution(generator);
+  return ids;
+}
+
 static void BM_UnsortedSegmentReduction(::testing::benchmark::State& state,
                                         const string& reduction, int num_rows,
-                                        int num_cols, int segment_size) {
+                                        int num_cols, int segment_size,
+                                        bool zipfian = false) {
   std::unique_ptr<Device> device(
       DeviceFactory::NewDevice("CPU", {}, "/job:a/replica:0/task:0"));
 
@@ -53,8 +68,14 @@ static void BM_UnsortedSegmentReduction(::testing::benchmark::State& state,
 
   TensorShape shape2({num_rows});
   Tensor indices(DT_INT32, shape2);
-  test::FillFn<int>(&indices,
-                    [&segment_size](int i) -> int { return i % segment_size; });
+  if (zipfian) {
+    const std::vector<int> ids = ZipfianSegmentIds(num_rows, segment_size);
+    test::FillFn<int>(&indices, [&ids](int i) -> int { return ids[i]; });
+  } else {
+    test::FillFn<int>(&indices, [&segment_size](int i) -> int {
+      return i % segment_size;
+    });
+  }
   reduction_inputs.push_back({nullptr, &indices});
 
   Tensor num_segments(DT_INT32, TensorShape({}));
@@ -106,6 +127,49 @@ static void BM_UnsortedSegmentReduction(::testing::benchmark::State& state,
 BM_UnsortedReduce_Arg(4096, 1024, 1);
 BM_UnsortedReduce_Arg(4096, 1024, 128);
 
+#define BM_UnsortedReduceZipfian(O, R, C, S)                          \
+  static void BM_##O##_Zipfian_##R##_##C##_##S(                        \
+      ::testing::benchmark::State& state) {                            \
+    BM_UnsortedSegmentReduction(state, #O, R, C, S, /*zipfian=*/true); \
+  }                                                                    \
+  BENCHMARK(BM_##O##_Zipfian_##R##_##C##_##S);
+
+BM_UnsortedReduce_Arg(65536, 128, 4);
+BM_UnsortedReduceZipfian(UnsortedSegmentSum, 65536, 128, 128);
+BM_UnsortedReduceZipfian(UnsortedSegmentSum, 65536, 128, 65536);
+
+class UnsortedSegmentSumTest : public OpsTestBase {};
+
+// Enough rows in one segment for the rows to be reduced by range.
+TEST_F(UnsortedSegmentSumTest, HotSegment) {
+  constexpr int kNumRows = 4096;
+  constexpr int kNumCols = 16;
+  TF_ASSERT_OK(NodeDefBuilder("sum", "UnsortedSegmentSum")
+                   .Input(FakeInput(DT_INT32))
+                   .Input(FakeInput(DT_INT32))
+                   .Input(FakeInput(DT_INT32))
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  std::vector<int> data(kNumRows * kNumCols);
+  std::vector<int> ids(kNumRows);
+  std::vector<int> expected(4 * kNumCols, 0);
+  for (int i = 0; i < kNumRows; ++i) {
+    // Most rows are in segment 1, segment 2 is empty and row 5 is dropped.
+    ids[i] = i == 5 ? -1 : (i % 8 == 0 ? 3 : (i % 8 == 1 ? 0 : 1));
+    for (int j = 0; j < kNumCols; ++j) {
+      data[i * kNumCols + j] = i + j;
+      if (ids[i] >= 0) expected[ids[i] * kNumCols + j] += i + j;
+    }
+  }
+  AddInputFromArray<int>(TensorShape({kNumRows, kNumCols}), data);
+  AddInputFromArray<int>(TensorShape({kNumRows}), ids);
+  AddInputFromArray<int>(TensorShape({}), {4});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int>(
+      *GetOutput(0),
+      test::AsTensor<int>(expected, TensorShape({4, kNumCols})));
+}
+
 template <typename Index>
 static void BM_SegmentReduction(::testing::benchmark::State& state,
                                 const string& reduction, Index num_rows,
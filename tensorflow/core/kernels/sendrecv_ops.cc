@@ -77,6 +77,9 @@ SendOp::SendOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
   if (!ctx->GetAttr("_hostmem_sendrecv", &hostmem_sendrecv_).ok()) {
     hostmem_sendrecv_ = false;
   }
+  if (!ctx->GetAttr("_rendezvous_slot", &rendezvous_slot_).ok()) {
+    rendezvous_slot_ = -1;
+  }
 }
 
 void SendOp::Compute(OpKernelContext* ctx) {
@@ -94,6 +97,8 @@ void SendOp::Compute(OpKernelContext* ctx) {
 
   FrameAndIter frame_iter = GetFrameAndIter(ctx, hostmem_sendrecv_);
   if (frame_iter == FrameAndIter(0, 0)) {
+    // Slots are only unique per step in the root frame.
+    args.rendezvous_slot = rendezvous_slot_;
     // Use the cached rendezvous key.
     VLOG(2) << "Send " << parsed_key_.buf_ << " using "
             << reinterpret_cast<uintptr_t>(ctx->rendezvous());
@@ -158,6 +163,9 @@ RecvOp::RecvOp(OpKernelConstruction* ctx) : AsyncOpKernel(ctx) {
   if (!ctx->GetAttr("_hostmem_sendrecv", &hostmem_sendrecv_).ok()) {
     hostmem_sendrecv_ = false;
   }
+  if (!ctx->GetAttr("_rendezvous_slot", &rendezvous_slot_).ok()) {
+    rendezvous_slot_ = -1;
+  }
 }
 
 string RecvOp::TraceString(const OpKernelContext& ctx, bool verbose) const {
@@ -206,6 +214,7 @@ void RecvOp::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
 
   FrameAndIter frame_iter = GetFrameAndIter(ctx, hostmem_sendrecv_);
   if (frame_iter == FrameAndIter(0, 0)) {
+    args.rendezvous_slot = rendezvous_slot_;
     VLOG(2) << "Recv " << parsed_key_.buf_ << " using "
             << reinterpret_cast<uintptr_t>(ctx->rendezvous());
     ctx->rendezvous()->RecvAsync(parsed_key_, args,
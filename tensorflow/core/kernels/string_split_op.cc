@@ -15,6 +15,7 @@ limitations under the License.
 
 // See docs in ../ops/string_ops.cc.
 
+#include <bitset>
 #include <string>
 
 #include "tensorflow/core/framework/kernel_def_builder.h"
@@ -56,16 +57,18 @@ std::vector<StringPiece> SplitOnChar(const tstring& str, const char delim,
 // Split input string `str` based on a set of character delimiters.
 // Returns a vector of StringPieces which are valid as long as input `str`
 // is valid.
-// Based on str_util::Split.
+// Based on str_util::Split, with a table lookup per character instead of a
+// search of the delimiters.
 template <typename Predicate>
 std::vector<StringPiece> SplitOnCharSet(const tstring& str,
                                         const tstring& delim_set, Predicate p) {
   std::vector<StringPiece> result;
   StringPiece text(str);
-  StringPiece delims(delim_set);
+  std::bitset<256> is_delim;
+  for (const char c : delim_set) is_delim.set(static_cast<uint8>(c));
   size_t token_start = 0;
   for (size_t i = 0; i < text.size() + 1; i++) {
-    if ((i == text.size()) || (delims.find(text[i]) != StringPiece::npos)) {
+    if ((i == text.size()) || is_delim[static_cast<uint8>(text[i])]) {
       StringPiece token(text.data() + token_start, i - token_start);
       if (p(token)) {
         result.emplace_back(token);
@@ -139,7 +142,16 @@ std::vector<StringPiece> SplitV2(const tstring& str, StringPiece sep,
     }
     return result;
   }
-  auto p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
+  // A single character separator is found with memchr rather than a
+  // generic search.
+  auto find_sep = [&text, sep]() {
+    if (sep.size() == 1) {
+      const size_t f = text.find(sep[0]);
+      return f == StringPiece::npos ? text.end() : text.begin() + f;
+    }
+    return std::search(text.begin(), text.end(), sep.begin(), sep.end());
+  };
+  auto p = find_sep();
   int split = 0;
   while (p != text.end()) {
     StringPiece token = text.substr(0, p - text.begin());
@@ -151,7 +163,7 @@ std::vector<StringPiece> SplitV2(const tstring& str, StringPiece sep,
       result.push_back(StringPiece(text));
       return result;
     }
-    p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
+    p = find_sep();
   }
   result.push_back(text);
   return result;
@@ -64,10 +64,46 @@ Tensor GetTestTensor(int batch) {
   return t;
 }
 
-Graph* SetupStringSplitGraph(const Tensor& input) {
+class StringSplitOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const char* op) {
+    TF_ASSERT_OK(NodeDefBuilder("split", op)
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_STRING))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(StringSplitOpTest, CharSet) {
+  MakeOp("StringSplit");
+  AddInputFromArray<tstring>(TensorShape({2}), {"a,b;;c", ";d\xff,"});
+  AddInputFromArray<tstring>(TensorShape({}), {",;"});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>({0, 0, 0, 1, 0, 2, 1, 0}, TensorShape({4, 2})));
+  test::ExpectTensorEqual<tstring>(
+      *GetOutput(1), test::AsTensor<tstring>({"a", "b", "c", "d\xff"}));
+}
+
+TEST_F(StringSplitOpTest, V2SingleCharSeparator) {
+  MakeOp("StringSplitV2");
+  AddInputFromArray<tstring>(TensorShape({2}), {"1,,2", ""});
+  AddInputFromArray<tstring>(TensorShape({}), {","});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>({0, 0, 0, 1, 0, 2, 1, 0}, TensorShape({4, 2})));
+  test::ExpectTensorEqual<tstring>(*GetOutput(1),
+                                   test::AsTensor<tstring>({"1", "", "2", ""}));
+}
+
+Graph* SetupStringSplitGraph(const Tensor& input,
+                             const char* delimiter = " ") {
   Graph* g = new Graph(OpRegistry::Global());
   Tensor delim(DT_STRING, TensorShape({}));
-  delim.flat<tstring>().setConstant(" ");
+  delim.flat<tstring>().setConstant(delimiter);
 
   TF_CHECK_OK(NodeBuilder("string_split_op", "StringSplit")
                   .Input(test::graph::Constant(g, input))
@@ -95,6 +131,21 @@ BENCHMARK(BM_StringSplit)
     ->Arg(128)
     ->Arg(256);
 
+static void BM_StringSplitCharSet(::testing::benchmark::State& state) {
+  const int batch_size = state.range(0);
+
+  Tensor input = GetTestTensor(batch_size);
+  Graph* g = SetupStringSplitGraph(input, " ,.");
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_StringSplitCharSet)
+    ->UseRealTime()
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256);
+
 Graph* SetupStringSplitV2Graph(const Tensor& input) {
   Graph* g = new Graph(OpRegistry::Global());
   Tensor sep(DT_STRING, TensorShape({}));
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -44,18 +45,44 @@ class StringToHashBucketOp : public OpKernel {
                                             &output_tensor));
     auto output_flat = output_tensor->flat<int64_t>();
 
-    typedef decltype(input_flat.size()) Index;
-    for (Index i = 0; i < input_flat.size(); ++i) {
-      const uint64 input_hash = hash(input_flat(i));
-      const uint64 bucket_id = input_hash % num_buckets_;
-      // The number of buckets is always in the positive range of int64 so is
-      // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
-      // safe.
-      output_flat(i) = static_cast<int64_t>(bucket_id);
+    const int64_t num_elements = input_flat.size();
+    int64_t num_bytes = 0;
+    for (int64_t i = 0; i < num_elements; ++i) {
+      num_bytes += input_flat(i).size();
     }
+    // The number of buckets is always in the positive range of int64 so is
+    // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
+    // safe. A power of two number of buckets takes the bucket from the low
+    // bits of the hash, which is the same as the modulo but much cheaper.
+    const uint64 num_buckets = num_buckets_;
+    const bool power_of_two = (num_buckets & (num_buckets - 1)) == 0;
+    auto hash_range = [&](int64_t begin, int64_t end) {
+      if (power_of_two) {
+        const uint64 mask = num_buckets - 1;
+        for (int64_t i = begin; i < end; ++i) {
+          output_flat(i) = static_cast<int64_t>(hash(input_flat(i)) & mask);
+        }
+      } else {
+        for (int64_t i = begin; i < end; ++i) {
+          output_flat(i) =
+              static_cast<int64_t>(hash(input_flat(i)) % num_buckets);
+        }
+      }
+    };
+    // Hashing takes about a cycle per byte, plus the modulo and the loads of
+    // each string.
+    const int64_t cost_per_element =
+        kCostPerElement +
+        (num_elements > 0 ? num_bytes / num_elements : 0) * kCostPerByte;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_elements,
+          cost_per_element, hash_range);
   }
 
  private:
+  static constexpr int64_t kCostPerElement = 50;
+  static constexpr int64_t kCostPerByte = 1;
+
   int64_t num_buckets_;
 
   StringToHashBucketOp(const StringToHashBucketOp&) = delete;
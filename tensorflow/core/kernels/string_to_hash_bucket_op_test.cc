@@ -0,0 +1,103 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+class StringToHashBucketFastOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(int64_t num_buckets) {
+    TF_ASSERT_OK(NodeDefBuilder("hash", "StringToHashBucketFast")
+                     .Input(FakeInput(DT_STRING))
+                     .Attr("num_buckets", num_buckets)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void ExpectBuckets(int64_t num_buckets, int64_t num_elements) {
+    MakeOp(num_buckets);
+    std::vector<tstring> input;
+    std::vector<int64_t> expected;
+    for (int64_t i = 0; i < num_elements; ++i) {
+      input.push_back(strings::StrCat("feature_value_", i));
+      expected.push_back(Fingerprint64(input.back()) % num_buckets);
+    }
+    AddInputFromArray<tstring>(TensorShape({num_elements}), input);
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectTensorEqual<int64_t>(*GetOutput(0),
+                                     test::AsTensor<int64_t>(expected));
+  }
+};
+
+TEST_F(StringToHashBucketFastOpTest, PowerOfTwoBuckets) {
+  ExpectBuckets(1 << 20, 10000);
+}
+
+TEST_F(StringToHashBucketFastOpTest, OtherBuckets) {
+  ExpectBuckets(1000003, 10000);
+}
+
+TEST_F(StringToHashBucketFastOpTest, OneBucket) { ExpectBuckets(1, 100); }
+
+static Graph* StringToHashBucketFast(int batch_size, int64_t num_buckets) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DT_STRING, TensorShape({batch_size}));
+  auto input_flat = input.flat<tstring>();
+  for (int i = 0; i < batch_size; ++i) {
+    input_flat(i) = strings::StrCat("feature_value_", i);
+  }
+  TF_CHECK_OK(NodeBuilder(g->NewName("hash"), "StringToHashBucketFast")
+                  .Input(test::graph::Constant(g, input))
+                  .Attr("num_buckets", num_buckets)
+                  .Finalize(g, nullptr /* node */));
+  return g;
+}
+
+static void BM_StringToHashBucketFast(::testing::benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int64_t num_buckets = state.range(1);
+  test::Benchmark("cpu", StringToHashBucketFast(batch_size, num_buckets),
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          batch_size);
+}
+
+BENCHMARK(BM_StringToHashBucketFast)
+    ->UseRealTime()
+    ->ArgPair(128, 1000003)
+    ->ArgPair(128, 1 << 20)
+    ->ArgPair(65536, 1000003)
+    ->ArgPair(65536, 1 << 20)
+    ->ArgPair(1 << 20, 1000003)
+    ->ArgPair(1 << 20, 1 << 20);
+
+}  // namespace
+}  // namespace tensorflow
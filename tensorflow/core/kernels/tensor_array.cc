@@ -16,6 +16,8 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 #include "tensorflow/core/kernels/tensor_array.h"
 
+#include <cstring>
+
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor_util.h"
@@ -114,4 +116,62 @@ Status TensorArray::CopyShapesFrom(TensorArray* rhs,
   return OkStatus();
 }
 
+bool TensorArray::LockedCopyToStorage(OpKernelContext* ctx,
+                                      const int32_t index, const Tensor& value,
+                                      Tensor* element) {
+  if (dynamic_size_ || multiple_writes_aggregate_ || is_grad_ ||
+      tensors_.size() < 2 || !DataTypeCanUseMemcpy(dtype_) ||
+      !element_shape_.IsFullyDefined() || value.NumElements() == 0) {
+    return false;
+  }
+  // Views into the storage are handed out to arbitrary kernels, so every
+  // element must start at an aligned address.
+  const size_t element_bytes = value.TotalBytes();
+  if (element_bytes % EIGEN_MAX_ALIGN_BYTES != 0) return false;
+
+  if (!storage_.IsInitialized()) {
+    TensorShape storage_shape(value.shape());
+    storage_shape.InsertDim(0, tensors_.size());
+    if (!ctx->allocate_temp(dtype_, storage_shape, &storage_).ok()) {
+      storage_ = Tensor();
+      return false;
+    }
+  }
+  TensorShape storage_element_shape(storage_.shape());
+  storage_element_shape.RemoveDim(0);
+  if (value.shape() != storage_element_shape) return false;
+
+  Tensor slice = storage_.Slice(index, index + 1);
+  std::memcpy(slice.data(), value.data(), element_bytes);
+  return element->CopyFrom(slice, value.shape());
+}
+
+bool TensorArray::StackedView(const std::vector<int32>& indices,
+                              const std::vector<Tensor>& values,
+                              Tensor* stacked) {
+  mutex_lock l(mu_);
+  if (!storage_.IsInitialized() || indices.empty() ||
+      indices.size() != values.size()) {
+    return false;
+  }
+  const int64_t begin = indices[0];
+  const int64_t end = begin + indices.size();
+  if (begin < 0 || end > storage_.dim_size(0)) return false;
+
+  Tensor view = storage_.Slice(begin, end);
+  const size_t element_bytes = view.TotalBytes() / indices.size();
+  const char* base = static_cast<const char*>(view.data());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    // Elements that were never written are read as separately allocated
+    // zeros, so also check that each value still aliases its slice.
+    if (indices[i] != begin + static_cast<int64_t>(i) ||
+        values[i].data() != base + i * element_bytes ||
+        values[i].TotalBytes() != element_bytes) {
+      return false;
+    }
+  }
+  *stacked = view;
+  return true;
+}
+
 }  // namespace tensorflow
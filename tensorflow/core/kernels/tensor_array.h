@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <limits.h>
 
+#include <type_traits>
 #include <vector>
 
 #include "tensorflow/core/framework/op_kernel.h"
@@ -107,14 +108,26 @@ TF_CALL_COMPLEX_TYPES(TENSOR_ARRAY_SET_ZERO_GPU);
 //     multiple_writes_aggregate allow multiple writes to the same
 //     index.  In this case, the writes are summed.
 //   * Multiple reads are supported.
-//   * Deep copies of Tensors are rarely made.  The only time they are made is
-//     when WriteOrAggregate is called at least twice on the same index with the
-//     flag multiple_writes_aggregate = True.
+//   * Deep copies of Tensors are rarely made.  They are made when
+//     WriteOrAggregate is called at least twice on the same index with the
+//     flag multiple_writes_aggregate = True, and when a fixed-size CPU
+//     TensorArray with a fully defined element shape copies written elements
+//     into its contiguous storage (see below).
 //   * Reading and Writing to the array is protected by a mutex.
 //     All operations on a TensorArray are thread-safe.
 //   * A TensorArray may be preemptively closed, which releases all
 //     memory associated with it.
 //
+// Contiguous storage:
+//   A TensorArray that cannot grow, does not aggregate writes and whose
+//   element shape is fully defined at the time of its first CPU write keeps
+//   its elements in one preallocated [N] + element_shape buffer.  Each single
+//   write copies the value into its slice of the buffer, and stacking or
+//   gathering a run of consecutive elements returns a view of the buffer
+//   instead of concatenating them into a new tensor.  This is only done when
+//   every element starts at an aligned address, so that the views may be
+//   passed to any kernel.
+//
 // These properties together allow the TensorArray to work as a
 // functional object and makes gradient computation easy.  For
 // example:
@@ -188,9 +201,13 @@ class TensorArray : public ResourceBase {
   Status WriteOrAggregate(OpKernelContext* ctx, const int32_t index,
                           const Tensor* value) {
     mutex_lock l(mu_);
-    return LockedWriteOrAggregate<Device, T>(ctx, index, value);
+    return LockedWriteOrAggregate<Device, T>(ctx, index, value,
+                                             /*copy_to_storage=*/true);
   }
 
+  // Unlike WriteOrAggregate(), never copies into the contiguous storage: the
+  // values written here are freshly split from a larger tensor, and keeping
+  // references to them is cheaper than copying them again.
   template <typename Device, typename T>
   Status WriteOrAggregateMany(OpKernelContext* ctx,
                               const std::vector<int32>& indices,
@@ -198,7 +215,8 @@ class TensorArray : public ResourceBase {
     mutex_lock l(mu_);
     int32_t i = 0;
     for (const int32_t ix : indices) {
-      Status s = LockedWriteOrAggregate<Device, T>(ctx, ix, &(*values)[i]);
+      Status s = LockedWriteOrAggregate<Device, T>(ctx, ix, &(*values)[i],
+                                                   /*copy_to_storage=*/false);
       ++i;
       TF_RETURN_IF_ERROR(s);
     }
@@ -334,10 +352,18 @@ class TensorArray : public ResourceBase {
   // to the rhs to access its mutex.
   Status CopyShapesFrom(TensorArray* rhs, const TensorShape* shape_to_prepend);
 
+  // If `values`, as returned by ReadMany() for `indices`, are consecutive
+  // elements of the contiguous storage, sets `*stacked` to a view of them
+  // stacked along a new leading dimension and returns true.  Otherwise
+  // returns false, and the values have to be concatenated by the caller.
+  bool StackedView(const std::vector<int32>& indices,
+                   const std::vector<Tensor>& values, Tensor* stacked);
+
   // Clear the TensorArray, including any Tensor references, and mark as closed.
   void ClearAndMarkClosed() {
     mutex_lock l(mu_);
     tensors_.clear();
+    storage_ = Tensor();
     closed_ = true;
   }
 
@@ -355,13 +381,21 @@ class TensorArray : public ResourceBase {
 
   template <typename Device, typename T>
   Status LockedWriteOrAggregate(OpKernelContext* ctx, const int32_t index,
-                                const Tensor* value)
+                                const Tensor* value, bool copy_to_storage)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   template <typename Device, typename T>
   Status LockedRead(OpKernelContext* ctx, const int32_t index, Tensor* value)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Copies the first write of `value` at `index` into the contiguous storage,
+  // allocating it if needed, and sets `*element` to the view of its slice.
+  // Returns false, leaving `*element` untouched, if this TensorArray does not
+  // use contiguous storage for `value`.
+  bool LockedCopyToStorage(OpKernelContext* ctx, const int32_t index,
+                           const Tensor& value, Tensor* element)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   Status LockedReturnIfClosed() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     if (closed_) {
       return errors::InvalidArgument("TensorArray ", handle_.vec<tstring>()(1),
@@ -435,12 +469,17 @@ class TensorArray : public ResourceBase {
   };
   // The list of underlying Tensors and states.
   std::vector<TensorAndState> tensors_ TF_GUARDED_BY(mu_);
+
+  // The contiguous storage of the elements, with shape [N] + element_shape_,
+  // or an uninitialized Tensor if elements are stored as separate Tensors.
+  Tensor storage_ TF_GUARDED_BY(mu_);
 };
 
 template <typename Device, typename T>
 Status TensorArray::LockedWriteOrAggregate(OpKernelContext* ctx,
                                            const int32_t index,
-                                           const Tensor* value) {
+                                           const Tensor* value,
+                                           bool copy_to_storage) {
   TF_RETURN_IF_ERROR(LockedReturnIfClosed());
   size_t index_size = static_cast<size_t>(index);
   if (index < 0 || (!dynamic_size_ && index_size >= tensors_.size())) {
@@ -532,7 +571,10 @@ Status TensorArray::LockedWriteOrAggregate(OpKernelContext* ctx,
     // TensorArray.
     gradients_disallowed_ = true;
   } else {
-    t.tensor = *value;
+    if (!copy_to_storage || !std::is_same<Device, CPUDevice>::value ||
+        !LockedCopyToStorage(ctx, index, *value, &t.tensor)) {
+      t.tensor = *value;
+    }
     t.shape = value->shape();
     t.written = true;
   }
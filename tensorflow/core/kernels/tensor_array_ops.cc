@@ -718,6 +718,14 @@ class TensorArrayPackOrGatherOp : public OpKernel {
                                 " which does not match the Tensor at index 0: ",
                                 value_0_t->shape().DebugString()));
 
+    // Elements kept in the TensorArray's contiguous storage may already be
+    // laid out as the stacked result.
+    Tensor stacked;
+    if (tensor_array->StackedView(indices, values, &stacked)) {
+      ctx->set_output(0, stacked);
+      return;
+    }
+
     TensorShape output_shape(value_0_t->shape());
     output_shape.InsertDim(0, num_indices);
 
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/topk_op.h"
 
 #include <algorithm>
+#include <functional>
 #include <numeric>
 #include <vector>
 
@@ -29,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/bits.h"
 #include "tensorflow/core/lib/gtl/top_n.h"
 #include "tensorflow/core/util/work_sharder.h"
 
@@ -248,11 +250,133 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
                                    ? kint64max
                                    : static_cast<int64_t>(total_cost);
     auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    if (k >= kMinSelectK && k < num_cols && num_cols >= kMinSelectCols) {
+      SelectRows(worker_threads, sorted, k, input, values, indices,
+                 SortIndices);
+      return OkStatus();
+    }
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
     return OkStatus();
   }
+
+ private:
+  // Rows with at least this many columns are selected from rather than
+  // pushed through a heap, for at least this k.
+  static constexpr int64_t kMinSelectCols = 1 << 14;
+  static constexpr int kMinSelectK = 128;
+
+  // Orders the columns of a row by decreasing value and then increasing
+  // index, which is the order of the outputs.
+  static bool Precedes(const T* data, Tidx a, Tidx b) {
+    if (data[b] < data[a]) return true;
+    if (data[a] < data[b]) return false;
+    return a < b;
+  }
+
+  // Keeps the `k` of the increasing `columns` that precede the others, in
+  // increasing order, by selecting the k-th largest value of the columns in
+  // linear time.
+  static void SelectTopK(const T* data, int k, std::vector<Tidx>* columns,
+                         std::vector<T>* scratch) {
+    if (columns->size() <= k) return;
+    scratch->resize(columns->size());
+    std::transform(columns->begin(), columns->end(), scratch->begin(),
+                   [data](Tidx c) { return data[c]; });
+    std::nth_element(scratch->begin(), scratch->begin() + (k - 1),
+                     scratch->end(), std::greater<T>());
+    const T kth = (*scratch)[k - 1];
+    // The columns of the k-th largest value are kept by increasing index.
+    int64_t num_kth = k - std::count_if(scratch->begin(),
+                                        scratch->begin() + (k - 1),
+                                        [kth](T v) { return kth < v; });
+    int64_t num_kept = 0;
+    for (Tidx c : *columns) {
+      if (kth < data[c] || (!(data[c] < kth) && num_kth-- > 0)) {
+        (*columns)[num_kept++] = c;
+      }
+    }
+    columns->resize(num_kept);
+  }
+
+  // Computes the top k of every row by selection. Rows are split into parts
+  // when there are fewer rows than threads, and the top k of a row is then
+  // selected from the top k of its parts. Rows with NaNs, which have no
+  // k-th largest value, are left to `sort_rows`.
+  template <typename SortRowsFn>
+  static void SelectRows(const DeviceBase::CpuWorkerThreads& worker_threads,
+                         bool sorted, int k,
+                         const typename TTypes<T, 2>::ConstTensor& input,
+                         typename TTypes<T, 2>::Tensor values,
+                         typename TTypes<Tidx, 2>::Tensor indices,
+                         const SortRowsFn& sort_rows) {
+    const int64_t num_rows = input.dimension(0);
+    const int64_t num_cols = input.dimension(1);
+    const int64_t num_parts = std::max<int64_t>(
+        1, std::min<int64_t>(
+               (worker_threads.num_threads + num_rows - 1) / num_rows,
+               num_cols / (4 * k)));
+    std::vector<std::vector<Tidx>> part_columns(num_rows * num_parts);
+    std::vector<uint8> part_has_nan(num_rows * num_parts, 0);
+
+    auto select_parts = [&](int64_t start, int64_t limit) {
+      std::vector<T> scratch;
+      for (int64_t i = start; i < limit; ++i) {
+        const int64_t b = i / num_parts;
+        const int64_t part = i % num_parts;
+        const int64_t begin = num_cols * part / num_parts;
+        const int64_t end = num_cols * (part + 1) / num_parts;
+        const T* data = &input(b, 0);
+        if (std::any_of(data + begin, data + end,
+                        [](T v) { return Eigen::numext::isnan(v); })) {
+          part_has_nan[i] = 1;
+          continue;
+        }
+        std::vector<Tidx>& columns = part_columns[i];
+        columns.resize(end - begin);
+        std::iota(columns.begin(), columns.end(), static_cast<Tidx>(begin));
+        SelectTopK(data, k, &columns, &scratch);
+      }
+    };
+    const int64_t part_cost =
+        12 * Eigen::TensorOpCost::AddCost<T>() * num_cols / num_parts;
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          num_rows * num_parts, part_cost, select_parts);
+
+    auto select_rows = [&](int64_t start, int64_t limit) {
+      std::vector<T> scratch;
+      std::vector<Tidx> columns;
+      for (int64_t b = start; b < limit; ++b) {
+        if (std::any_of(part_has_nan.begin() + b * num_parts,
+                        part_has_nan.begin() + (b + 1) * num_parts,
+                        [](uint8 has_nan) { return has_nan != 0; })) {
+          sort_rows(b, b + 1);
+          continue;
+        }
+        const T* data = &input(b, 0);
+        columns.clear();
+        for (int64_t part = 0; part < num_parts; ++part) {
+          const std::vector<Tidx>& top = part_columns[b * num_parts + part];
+          columns.insert(columns.end(), top.begin(), top.end());
+        }
+        SelectTopK(data, k, &columns, &scratch);
+        if (sorted) {
+          std::sort(columns.begin(), columns.end(), [data](Tidx a, Tidx b) {
+            return Precedes(data, a, b);
+          });
+        }
+        for (int i = 0; i < k; ++i) {
+          indices(b, i) = columns[i];
+          values(b, i) = data[columns[i]];
+        }
+      }
+    };
+    const int64_t row_cost = Eigen::TensorOpCost::AddCost<T>() *
+                             (12 * num_parts * k + 4 * k * Log2Ceiling(k));
+    Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+          row_cost, select_rows);
+  }
 };
 
 }  // namespace functor
@@ -0,0 +1,102 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class TopKOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(bool sorted) {
+    TF_ASSERT_OK(NodeDefBuilder("top_k", "TopKV2")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("sorted", sorted)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+// Large enough rows and k for the top k to be selected, with many equal
+// values.
+TEST_F(TopKOpTest, LargeRows) {
+  MakeOp(/*sorted=*/true);
+  const int num_rows = 3;
+  const int num_cols = 40000;
+  const int k = 500;
+  std::vector<float> input(num_rows * num_cols);
+  for (float& value : input) value = std::rand() % 1000;
+
+  std::vector<float> expected_values;
+  std::vector<int32> expected_indices;
+  for (int r = 0; r < num_rows; ++r) {
+    const float* row = &input[r * num_cols];
+    std::vector<int32> order(num_cols);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [row](int32 a, int32 b) { return row[b] < row[a]; });
+    for (int i = 0; i < k; ++i) {
+      expected_indices.push_back(order[i]);
+      expected_values.push_back(row[order[i]]);
+    }
+  }
+
+  AddInputFromArray<float>(TensorShape({num_rows, num_cols}), input);
+  AddInputFromArray<int32>(TensorShape({}), {k});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<float>(
+      *GetOutput(0),
+      test::AsTensor<float>(expected_values, TensorShape({num_rows, k})));
+  test::ExpectTensorEqual<int32>(
+      *GetOutput(1),
+      test::AsTensor<int32>(expected_indices, TensorShape({num_rows, k})));
+}
+
+TEST_F(TopKOpTest, LargeRowUnsorted) {
+  MakeOp(/*sorted=*/false);
+  const int num_cols = 20000;
+  const int k = 200;
+  std::vector<float> input(num_cols);
+  for (int c = 0; c < num_cols; ++c) input[c] = (c * 7919) % num_cols;
+
+  AddInputFromArray<float>(TensorShape({num_cols}), input);
+  AddInputFromArray<int32>(TensorShape({}), {k});
+  TF_ASSERT_OK(RunOpKernel());
+  // The values are distinct, so the top k are the values from
+  // num_cols - k on, in any order.
+  auto values = GetOutput(0)->flat<float>();
+  auto indices = GetOutput(1)->flat<int32>();
+  std::vector<float> sorted_values(values.data(), values.data() + k);
+  std::sort(sorted_values.begin(), sorted_values.end());
+  for (int i = 0; i < k; ++i) {
+    EXPECT_EQ(sorted_values[i], num_cols - k + i);
+    EXPECT_EQ(values(i), input[indices(i)]);
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -273,6 +273,7 @@ Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
     }
     TF_RETURN_IF_ERROR(PrepareToUpdateVariable<Device, T>(
         ctx, var->tensor(), var->copy_on_read_mode.load()));
+    var->MarkAllRowsDirty();
     *out = *var->tensor();
     return OkStatus();
   }
@@ -280,6 +281,22 @@ Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
   return OkStatus();
 }
 
+// Records that a sparse update changed the rows at `indices` of the resource
+// variable passed as input `input`, for incremental checkpoints. Indices that
+// are not in host memory mark all rows of the variable.
+template <typename Device>
+void MarkVariableRowsDirty(OpKernelContext* ctx, int input,
+                           const Tensor& indices) {
+  if (ctx->input_dtype(input) != DT_RESOURCE) return;
+  core::RefCountPtr<Var> var;
+  if (!LookupResource(ctx, HandleFromInput(ctx, input), &var).ok()) return;
+  if (std::is_same<Device, Eigen::ThreadPoolDevice>::value) {
+    var->MarkDirtyRows(indices);
+  } else {
+    var->MarkAllRowsDirty();
+  }
+}
+
 }  // end namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_KERNELS_TRAINING_OP_HELPERS_H_
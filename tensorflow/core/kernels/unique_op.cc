@@ -13,9 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -26,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace {
@@ -68,6 +72,140 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// Inputs with at least this many elements are uniquified in parallel.
+constexpr int64_t kMinParallelUniqueSize = 1 << 16;
+
+// Uniquifies the integers of `input` with `num_partitions` threads, giving
+// the same outputs as the sequential implementation. The elements are
+// partitioned by the hash of their value, so that each thread uniquifies the
+// elements of one partition; the positions of the first occurrences then
+// give the indices of the unique elements. Also outputs the counts if the op
+// has them.
+template <typename T, typename TIndex>
+Status ParallelUnique(OpKernelContext* context,
+                      typename TTypes<T>::ConstFlat input,
+                      TensorShape output_shape, int64_t axis,
+                      int num_partitions, typename TTypes<TIndex>::Flat idx) {
+  const int64_t N = input.size();
+  thread::ThreadPool* workers =
+      context->device()->tensorflow_cpu_worker_threads()->workers;
+  auto partition_of = [num_partitions](T value) {
+    return static_cast<int>(
+        ((static_cast<uint64>(value) * 0x9E3779B97F4A7C15ull) >> 32) %
+        num_partitions);
+  };
+  auto parallel_for = [&](int64_t cost_per_partition, auto fn) {
+    workers->ParallelFor(num_partitions, cost_per_partition,
+                         [&fn](int64_t begin, int64_t end) {
+                           for (int64_t p = begin; p < end; ++p) fn(p);
+                         });
+  };
+  const int64_t chunk_cost = 10 * N / num_partitions;
+  auto chunk_begin = [N, num_partitions](int64_t c) {
+    return N * c / num_partitions;
+  };
+
+  // Sorts the positions of the elements by partition, and within each
+  // partition by position. `counts` holds the number of elements of each
+  // partition in each chunk of the input, and then where they go.
+  std::vector<int64_t> counts(num_partitions * num_partitions);
+  parallel_for(chunk_cost, [&](int64_t c) {
+    int64_t* chunk_counts = &counts[c * num_partitions];
+    for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+      ++chunk_counts[partition_of(input(i))];
+    }
+  });
+  std::vector<int64_t> partition_begin(num_partitions + 1);
+  int64_t offset = 0;
+  for (int p = 0; p < num_partitions; ++p) {
+    partition_begin[p] = offset;
+    for (int c = 0; c < num_partitions; ++c) {
+      const int64_t count = counts[c * num_partitions + p];
+      counts[c * num_partitions + p] = offset;
+      offset += count;
+    }
+  }
+  partition_begin[num_partitions] = offset;
+  std::vector<int32> positions(N);
+  parallel_for(chunk_cost, [&](int64_t c) {
+    int64_t* chunk_offsets = &counts[c * num_partitions];
+    for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+      positions[chunk_offsets[partition_of(input(i))]++] = i;
+    }
+  });
+
+  // Uniquifies each partition, numbering its unique elements in the order
+  // in which they first occur.
+  std::vector<int32> local_idx(N);
+  std::vector<std::vector<int32>> first_positions(num_partitions);
+  std::vector<uint8> is_first(N, 0);
+  parallel_for(5 * chunk_cost, [&](int64_t p) {
+    typename UniqueOpHashMap<T, int32>::map_type uniq;
+    uniq.reserve(partition_begin[p + 1] - partition_begin[p]);
+    for (int64_t k = partition_begin[p]; k < partition_begin[p + 1]; ++k) {
+      const int32 i = positions[k];
+      auto it = uniq.emplace(input(i),
+                             static_cast<int32>(first_positions[p].size()));
+      local_idx[k] = it.first->second;
+      if (it.second) {
+        first_positions[p].push_back(i);
+        is_first[i] = 1;
+      }
+    }
+  });
+
+  // Numbers the first occurrences by position, in `idx`.
+  std::vector<int64_t> chunk_firsts(num_partitions + 1, 0);
+  parallel_for(chunk_cost, [&](int64_t c) {
+    chunk_firsts[c + 1] =
+        std::count(is_first.begin() + chunk_begin(c),
+                   is_first.begin() + chunk_begin(c + 1), 1);
+  });
+  for (int c = 0; c < num_partitions; ++c) {
+    chunk_firsts[c + 1] += chunk_firsts[c];
+  }
+  const int64_t uniq_size = chunk_firsts[num_partitions];
+  parallel_for(chunk_cost, [&](int64_t c) {
+    TIndex j = chunk_firsts[c];
+    for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+      if (is_first[i]) idx(i) = j++;
+    }
+  });
+
+  output_shape.set_dim(axis, uniq_size);
+  Tensor* output = nullptr;
+  TF_RETURN_IF_ERROR(context->allocate_output(0, output_shape, &output));
+  auto Tout = output->flat<T>();
+  const bool with_counts = context->num_outputs() > 2;
+  Tensor* count_output = nullptr;
+  if (with_counts) {
+    TF_RETURN_IF_ERROR(context->allocate_output(2, TensorShape({uniq_size}),
+                                                &count_output));
+    count_output->flat<TIndex>().setZero();
+  }
+
+  // Every element of a partition takes the index of its first occurrence.
+  parallel_for(5 * chunk_cost, [&](int64_t p) {
+    std::vector<TIndex> global_idx(first_positions[p].size());
+    for (int64_t l = 0; l < global_idx.size(); ++l) {
+      const int32 i = first_positions[p][l];
+      global_idx[l] = idx(i);
+      Tout(global_idx[l]) = input(i);
+    }
+    for (int64_t k = partition_begin[p]; k < partition_begin[p + 1]; ++k) {
+      idx(positions[k]) = global_idx[local_idx[k]];
+    }
+    // The partitions have distinct unique elements, and so distinct counts.
+    if (with_counts) {
+      auto count_output_vec = count_output->flat<TIndex>();
+      for (int64_t k = partition_begin[p]; k < partition_begin[p + 1]; ++k) {
+        ++count_output_vec(global_idx[local_idx[k]]);
+      }
+    }
+  });
+  return OkStatus();
+}
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -150,6 +288,19 @@ class UniqueOp : public OpKernel {
       auto Tin = input.flat<T>();
       const int64_t N = static_cast<int64_t>(Tin.size());
 
+      // Integers are uniquified in parallel when there are many of them.
+      if constexpr (std::is_integral<T>::value &&
+                    !std::is_same<T, bool>::value) {
+        const int num_threads =
+            context->device()->tensorflow_cpu_worker_threads()->num_threads;
+        if (num_threads > 1 && N >= kMinParallelUniqueSize) {
+          OP_REQUIRES_OK(context, ParallelUnique<T, TIndex>(
+                                      context, input.flat<T>(), input.shape(),
+                                      axis, num_threads, idx_vec));
+          return;
+        }
+      }
+
       typename UniqueOpHashMap<T, TIndex>::map_type uniq;
       uniq.reserve(2 * N);
       for (Eigen::Index i = 0, j = 0; i < N; ++i) {
@@ -15,11 +15,16 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
@@ -37,6 +42,45 @@ namespace {
 
 const int kMaxStrLen = 40;
 
+class UniqueOpTest : public OpsTestBase {};
+
+// Large enough to be uniquified in parallel.
+TEST_F(UniqueOpTest, LargeInt64WithCounts) {
+  TF_ASSERT_OK(NodeDefBuilder("unique", "UniqueWithCounts")
+                   .Input(FakeInput(DT_INT64))
+                   .Attr("out_idx", DT_INT32)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  const int n = 1 << 18;
+  std::vector<int64_t> x(n);
+  for (int i = 0; i < n; ++i) {
+    x[i] = (std::rand() % 5000) * (i % 2 == 0 ? 1 : -1000003);
+  }
+  std::vector<int64_t> expected_y;
+  std::vector<int32> expected_idx(n);
+  std::vector<int32> expected_count;
+  absl::flat_hash_map<int64_t, int32> index_of;
+  for (int i = 0; i < n; ++i) {
+    auto it = index_of.emplace(x[i], expected_y.size());
+    if (it.second) {
+      expected_y.push_back(x[i]);
+      expected_count.push_back(0);
+    }
+    expected_idx[i] = it.first->second;
+    ++expected_count[it.first->second];
+  }
+
+  AddInputFromArray<int64_t>(TensorShape({n}), x);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(*GetOutput(0),
+                                   test::AsTensor<int64_t>(expected_y));
+  test::ExpectTensorEqual<int32>(*GetOutput(1),
+                                 test::AsTensor<int32>(expected_idx));
+  test::ExpectTensorEqual<int32>(*GetOutput(2),
+                                 test::AsTensor<int32>(expected_count));
+}
+
 TensorProto GetRandomInt32TensorProto(int dim, int max_int) {
   TensorProto tensor_proto;
   tensor_proto.set_dtype(DT_INT32);
@@ -305,6 +305,7 @@ REGISTER_OP("ParallelInterleaveDatasetV4")
     .Attr("f: func")
     // "true", "false", or "default".
     .Attr("deterministic: string = 'default'")
+    .Attr("reorder_window: int >= 0 = 0")
     .Attr("Targuments: list(type) >= 0")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
@@ -731,6 +732,7 @@ REGISTER_OP("CacheDataset")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
     .Attr("metadata: string = ''")
+    .Attr("ram_budget: int = 0")
     // TODO(mdan): Should these use type inference instead?
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
@@ -749,6 +751,7 @@ REGISTER_OP("CacheDatasetV2")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
     .Attr("metadata: string = ''")
+    .Attr("ram_budget: int = 0")
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -147,6 +147,44 @@ REGISTER_OP("MergeV2Checkpoints")
       return OkStatus();
     });
 
+REGISTER_OP("StartDirtyRowTracking")
+    .Input("resources: N * resource")
+    .Attr("N: int >= 1")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+REGISTER_OP("SaveDirtyRows")
+    .Input("prefix: string")
+    .Input("tensor_names: string")
+    .Input("resources: N * resource")
+    .Attr("N: int >= 1")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      ShapeHandle s;
+      DimensionHandle unused_dim;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &s));
+      TF_RETURN_IF_ERROR(
+          c->WithValue(c->Dim(s, 0), c->num_inputs() - 2, &unused_dim));
+      return OkStatus();
+    });
+
+REGISTER_OP("RestoreWithRowDeltas")
+    .Input("base_prefix: string")
+    .Input("delta_prefixes: string")
+    .Input("tensor_names: string")
+    .Output("tensors: dtypes")
+    .Attr("dtypes: list(type) >= 1")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      return UnknownShape(c);
+    });
+
 REGISTER_OP("Save")
     .Input("filename: string")
     .Input("tensor_names: string")
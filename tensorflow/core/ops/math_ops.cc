@@ -1157,6 +1157,44 @@ _FusedConv2D output.
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_FusedElementwise")
+    .Input("inputs: N * T")
+    .Output("output: T")
+    .Attr("T: {float}")
+    .Attr("N: int >= 1")
+    .Attr("fused_ops: list(string)")
+    .Attr("operands: list(int)")
+    .SetShapeFn([](InferenceContext* c) {
+      // Scalar inputs are broadcast, all the other inputs have the shape of
+      // the output.
+      ShapeHandle out = c->Scalar();
+      bool has_non_scalar_input = false;
+      for (int i = 0; i < c->num_inputs(); ++i) {
+        if (c->RankKnown(c->input(i)) && c->Rank(c->input(i)) == 0) continue;
+        if (!has_non_scalar_input) {
+          out = c->input(i);
+          has_non_scalar_input = true;
+        } else {
+          TF_RETURN_IF_ERROR(c->Merge(out, c->input(i), &out));
+        }
+      }
+      c->set_output(0, out);
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Computes a tree of elementwise ops in one pass over the inputs.
+
+Step i applies `fused_ops[i]`, a TF op name such as "Mul" or "Tanh", to the
+values `operands[2 * i]` and `operands[2 * i + 1]`, where value j < N is input
+j and value N + k is the result of step k < i. Unary ops have -1 as their
+second operand. The output is the result of the last step.
+
+Scalar inputs are broadcast; all other inputs must have the same shape.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
 // --------------------------------------------------------------------------
 
 // For operations where the output is a reduction function along some
@@ -439,4 +439,45 @@ REGISTER_OP("DisableCopyOnRead")
     .Input("resource: resource")
     .SetShapeFn(shape_inference::NoOutputs);
 
+REGISTER_OP("EmbeddingCacheHandleOp")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .Output("resource: resource")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("EmbeddingCacheLookup")
+    .Input("cache: resource")
+    .Input("ids: int64")
+    .Output("slots: int32")
+    .Output("miss_ids: int64")
+    .Output("miss_slots: int32")
+    .Output("evicted_ids: int64")
+    .Output("evicted_slots: int32")
+    .Attr("capacity: int >= 1")
+    .Attr("policy: {'lru', 'lfu'} = 'lru'")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      c->set_output(0, c->input(1));
+      for (int i = 1; i < 5; ++i) {
+        c->set_output(i, c->Vector(InferenceContext::kUnknownDim));
+      }
+      return OkStatus();
+    });
+
+REGISTER_OP("EmbeddingCacheEntries")
+    .Input("cache: resource")
+    .Output("ids: int64")
+    .Output("slots: int32")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      c->set_output(0, c->Vector(InferenceContext::kUnknownDim));
+      c->set_output(1, c->output(0));
+      return OkStatus();
+    });
+
 }  // namespace tensorflow
@@ -85,6 +85,7 @@ using tsl::port::SSE3;
 using tsl::port::SSE4_1;
 using tsl::port::SSE4_2;
 using tsl::port::SSSE3;
+using tsl::port::SetCurrentThreadCPUAffinity;
 using tsl::port::TestAarch64CPU;
 using tsl::port::TestCPUFeature;
 
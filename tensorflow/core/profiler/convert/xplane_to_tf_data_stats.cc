@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -43,6 +44,9 @@ const int64_t kSlowCallThresholdPs = 50 * 1000000;
 
 namespace {
 
+// Maximum number of bottleneck candidates reported per input pipeline.
+constexpr size_t kMaxBottleneckCandidates = 5;
+
 // Returns true if the given iterator event is for a root iterator.
 bool IsRootIteratorEvent(const XEventVisitor& iterator_event) {
   std::vector<absl::string_view> split_result =
@@ -262,6 +266,25 @@ void ProcessInputPipelines(
   }
 }
 
+// Returns the blocking iterators of `input_pipeline_stat`, ranked by self time.
+std::vector<std::pair<int64_t, int64_t>> RankBlockingIterators(
+    const InputPipelineStat& input_pipeline_stat) {
+  std::vector<std::pair<int64_t, int64_t>> ranked;
+  for (const auto& [id, iterator_stat] : input_pipeline_stat.iterator_stats()) {
+    if (iterator_stat.is_blocking() && iterator_stat.self_time_ps() > 0) {
+      ranked.emplace_back(id, iterator_stat.self_time_ps());
+    }
+  }
+  absl::c_sort(ranked, [](const auto& lhs, const auto& rhs) {
+    return lhs.second != rhs.second ? lhs.second > rhs.second
+                                    : lhs.first < rhs.first;
+  });
+  if (ranked.size() > kMaxBottleneckCandidates) {
+    ranked.resize(kMaxBottleneckCandidates);
+  }
+  return ranked;
+}
+
 void SetBottleneckAnalysis(CombinedTfDataStats* combined_tf_data_stats) {
   struct InputPipeline {
     InputPipeline(absl::string_view host_name,
@@ -281,6 +304,7 @@ void SetBottleneckAnalysis(CombinedTfDataStats* combined_tf_data_stats) {
     absl::string_view iterator_name;
     absl::string_view iterator_long_name;
     int64_t iterator_latency_ps;
+    std::vector<TfDataBottleneckCandidate> candidates;
 
     bool operator<(const InputPipeline& rhs) const {
       return max_latency_ps > rhs.max_latency_ps;
@@ -304,15 +328,25 @@ void SetBottleneckAnalysis(CombinedTfDataStats* combined_tf_data_stats) {
           input_pipeline_stats.stats(0);
       const IteratorMetadata& metadata = tf_data_stats.iterator_metadata().at(
           input_pipeline_stat.bottleneck_iterator_id());
-      slow_input_pipelines.emplace_back(
+      InputPipeline& input_pipeline = slow_input_pipelines.emplace_back(
           host_name, input_pipeline_stats.metadata().name(),
           input_pipeline_stats.max_latency_ps(), metadata.name(),
           metadata.long_name(),
           input_pipeline_stat.bottleneck_iterator_latency_ps());
+      for (const auto& [id, self_time_ps] :
+           RankBlockingIterators(input_pipeline_stat)) {
+        auto it = tf_data_stats.iterator_metadata().find(id);
+        if (it == tf_data_stats.iterator_metadata().end()) continue;
+        TfDataBottleneckCandidate& candidate =
+            input_pipeline.candidates.emplace_back();
+        candidate.set_iterator_name(it->second.name());
+        candidate.set_iterator_long_name(it->second.long_name());
+        candidate.set_estimated_savings_ps(self_time_ps);
+      }
     }
   }
   std::sort(slow_input_pipelines.begin(), slow_input_pipelines.end());
-  for (const auto& input_pipeline : slow_input_pipelines) {
+  for (auto& input_pipeline : slow_input_pipelines) {
     TfDataBottleneckAnalysis* bottleneck_analysis =
         combined_tf_data_stats->add_bottleneck_analysis();
     bottleneck_analysis->set_host(input_pipeline.host_name.data(),
@@ -328,6 +362,9 @@ void SetBottleneckAnalysis(CombinedTfDataStats* combined_tf_data_stats) {
         input_pipeline.iterator_long_name.size());
     bottleneck_analysis->set_iterator_latency_ps(
         input_pipeline.iterator_latency_ps);
+    for (TfDataBottleneckCandidate& candidate : input_pipeline.candidates) {
+      *bottleneck_analysis->add_candidates() = std::move(candidate);
+    }
   }
 }
 
@@ -416,6 +453,11 @@ void SetSuggestion(CombinedTfDataStats* combined_tf_data_stats) {
        *combined_tf_data_stats->mutable_bottleneck_analysis()) {
     bottleneck_analysis.set_suggestion(
         GetSuggestion(GetBottleneckType(bottleneck_analysis.iterator_name())));
+    for (TfDataBottleneckCandidate& candidate :
+         *bottleneck_analysis.mutable_candidates()) {
+      candidate.set_suggestion(
+          GetSuggestion(GetBottleneckType(candidate.iterator_name())));
+    }
   }
 }
 
@@ -87,6 +87,18 @@ TEST(XPlaneToTfDataStatsTest, HostInputPipeline) {
           iterator_long_name: "Iterator::Prefetch::Range"
           iterator_latency_ps: 80000000
           suggestion: "See <a href=\"https://www.tensorflow.org/guide/data_performance_analysis\" target=\"_blank\">this</a> for suggestions."
+          candidates: {
+            iterator_name: "Range"
+            iterator_long_name: "Iterator::Prefetch::Range"
+            estimated_savings_ps: 80000000
+            suggestion: "See <a href=\"https://www.tensorflow.org/guide/data_performance_analysis\" target=\"_blank\">this</a> for suggestions."
+          }
+          candidates: {
+            iterator_name: "Prefetch"
+            iterator_long_name: "Iterator::Prefetch"
+            estimated_savings_ps: 20000000
+            suggestion: "See <a href=\"https://www.tensorflow.org/guide/data_performance_analysis\" target=\"_blank\">this</a> for suggestions."
+          }
         }
         tf_data_stats: {
           key: "host1"
@@ -345,6 +357,18 @@ TEST(XPlaneToTfDataStatsTest, MapAndBatch) {
           iterator_long_name: "Iterator::MapAndBatch::Range"
           iterator_latency_ps: 60000000
           suggestion: "See <a href=\"https://www.tensorflow.org/guide/data_performance_analysis\" target=\"_blank\">this</a> for suggestions."
+          candidates: {
+            iterator_name: "Range"
+            iterator_long_name: "Iterator::MapAndBatch::Range"
+            estimated_savings_ps: 60000000
+            suggestion: "See <a href=\"https://www.tensorflow.org/guide/data_performance_analysis\" target=\"_blank\">this</a> for suggestions."
+          }
+          candidates: {
+            iterator_name: "MapAndBatch"
+            iterator_long_name: "Iterator::MapAndBatch"
+            estimated_savings_ps: 40000000
+            suggestion: "See <a href=\"https://www.tensorflow.org/guide/data_performance_analysis\" target=\"_blank\">this</a> for suggestions."
+          }
         }
         tf_data_stats: {
           key: "host1"
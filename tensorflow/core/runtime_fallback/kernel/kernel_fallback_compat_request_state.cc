@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/platform/threadpool_interface.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/tfrt/fallback/device_with_custom_allocator.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/tfrt/utils/fallback_tensor.h"
 #include "tfrt/host_context/resource_context.h"  // from @tf_runtime
@@ -141,6 +142,16 @@ KernelFallbackCompatRequestState::KernelFallbackCompatRequestState(
           runner_table, resource_array, user_intra_op_threadpool,
           model_metadata, pflr) {}
 
+void KernelFallbackCompatRequestState::set_cpu_allocator(
+    std::shared_ptr<tensorflow::Allocator> allocator) {
+  DCHECK(allocator);
+  cpu_allocator_ = std::move(allocator);
+  cpu_device_with_custom_allocator_ =
+      std::make_unique<tfrt_stub::DeviceWithCustomAllocator>(
+          cpu_device_, cpu_allocator_.get());
+  cpu_device_ = cpu_device_with_custom_allocator_.get();
+}
+
 static std::function<void(std::function<void()>)>* GetDefaultRunner() {
   static auto* const default_runner =
       new std::function<void(std::function<void()>)>(
@@ -112,6 +112,11 @@ class KernelFallbackCompatRequestState {
   }
 
   tensorflow::Device* cpu_device() const { return cpu_device_; }
+
+  // Makes the ops on `cpu_device()` allocate their tensors from `allocator`,
+  // e.g. a per-request arena. `allocator` is kept alive at least as long as
+  // this request state. It must be called before any op is run.
+  void set_cpu_allocator(std::shared_ptr<tensorflow::Allocator> allocator);
   tensorflow::FunctionLibraryRuntime* cpu_function_library_runtime() const {
     return cpu_function_library_runtime_;
   }
@@ -190,6 +195,8 @@ class KernelFallbackCompatRequestState {
                       std::unique_ptr<tensorflow::Device>>
       custom_device_;
   std::unique_ptr<tensorflow::Device> custom_cpu_device_;
+  std::shared_ptr<tensorflow::Allocator> cpu_allocator_;
+  std::unique_ptr<tensorflow::Device> cpu_device_with_custom_allocator_;
   tensorflow::Device* cpu_device_ = nullptr;
   tensorflow::FunctionLibraryRuntime* cpu_function_library_runtime_ = nullptr;
   std::unique_ptr<CollectiveExecutor::Handle> collective_executor_handle_;
@@ -14,7 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/summary/summary_file_writer.h"
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -25,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/summary/summary_converter.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/events_writer.h"
 
 namespace tensorflow {
@@ -32,11 +36,13 @@ namespace {
 
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
-  SummaryFileWriter(int max_queue, int flush_millis, Env* env)
+  SummaryFileWriter(int max_queue, int flush_millis, bool background_flush,
+                    Env* env)
       : SummaryWriterInterface(),
         is_initialized_(false),
         max_queue_(max_queue),
         flush_millis_(flush_millis),
+        background_flush_(background_flush),
         env_(env) {}
 
   Status Initialize(const string& logdir, const string& filename_suffix) {
@@ -55,14 +61,23 @@ class SummaryFileWriter : public SummaryWriterInterface {
     string sep = absl::StartsWith(filename_suffix, ".") ? "" : ".";
     const string uniquified_filename_suffix = absl::StrCat(
         ".", pid, ".", file_id_counter.fetch_add(1), sep, filename_suffix);
-    mutex_lock ml(mu_);
-    events_writer_ =
-        std::make_unique<EventsWriter>(io::JoinPath(logdir, "events"));
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(
-        events_writer_->InitWithSuffix(uniquified_filename_suffix),
-        "Could not initialize events writer.");
-    last_flush_ = env_->NowMicros();
-    is_initialized_ = true;
+    {
+      mutex_lock ml(mu_);
+      {
+        mutex_lock wl(writer_mu_);
+        events_writer_ =
+            std::make_unique<EventsWriter>(io::JoinPath(logdir, "events"));
+        TF_RETURN_WITH_CONTEXT_IF_ERROR(
+            events_writer_->InitWithSuffix(uniquified_filename_suffix),
+            "Could not initialize events writer.");
+      }
+      last_flush_ = env_->NowMicros();
+      is_initialized_ = true;
+    }
+    if (background_flush_) {
+      flush_thread_.reset(env_->StartThread(
+          ThreadOptions(), "summary_file_writer", [this]() { FlushLoop(); }));
+    }
     return OkStatus();
   }
 
@@ -71,10 +86,20 @@ class SummaryFileWriter : public SummaryWriterInterface {
     if (!is_initialized_) {
       return errors::FailedPrecondition("Class was not properly initialized.");
     }
-    return InternalFlush();
+    Status status = TakeBackgroundStatus();
+    status.Update(InternalFlush(ml));
+    return status;
   }
 
   ~SummaryFileWriter() override {
+    if (flush_thread_ != nullptr) {
+      {
+        mutex_lock ml(mu_);
+        shutdown_ = true;
+      }
+      cv_.notify_all();
+      flush_thread_.reset();  // Joins the thread.
+    }
     (void)Flush();  // Ignore errors.
   }
 
@@ -152,10 +177,22 @@ class SummaryFileWriter : public SummaryWriterInterface {
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
     mutex_lock ml(mu_);
+    if (background_flush_) {
+      // Bound the memory held while storage is slow: one batch is being
+      // written, and at most one more may be queued behind it.
+      while (flushing_ && queue_.size() > max_queue_) {
+        cv_.wait(ml);
+      }
+    }
     queue_.emplace_back(std::move(event));
     if (queue_.size() > max_queue_ ||
         env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+      if (background_flush_) {
+        flush_requested_ = true;
+        cv_.notify_all();
+        return TakeBackgroundStatus();
+      }
+      return InternalFlush(ml);
     }
     return OkStatus();
   }
@@ -167,37 +204,107 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
-      events_writer_->WriteEvent(*e);
+  // Writes and flushes the queued events. `mu_` is released while the events
+  // are written so that WriteEvent() calls are not blocked on storage. Only
+  // one flush runs at a time, which keeps the events in order.
+  Status InternalFlush(mutex_lock& ml) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    while (flushing_) {
+      cv_.wait(ml);
     }
-    queue_.clear();
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
-                                    "Could not flush events file.");
+    std::vector<std::unique_ptr<Event>> events;
+    events.swap(queue_);
+    flushing_ = true;
+    flush_requested_ = false;
     last_flush_ = env_->NowMicros();
+    mu_.unlock();
+    Status status;
+    {
+      mutex_lock wl(writer_mu_);
+      for (const std::unique_ptr<Event>& e : events) {
+        events_writer_->WriteEvent(*e);
+      }
+      status = events_writer_->Flush();
+    }
+    mu_.lock();
+    flushing_ = false;
+    cv_.notify_all();
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(status, "Could not flush events file.");
     return OkStatus();
   }
 
+  // Body of the background thread: flushes when requested by WriteEvent() or
+  // every flush_millis_, until the writer is destroyed.
+  void FlushLoop() {
+    mutex_lock ml(mu_);
+    while (!shutdown_) {
+      if (!flush_requested_) {
+        if (flush_millis_ > 0) {
+          cv_.wait_for(ml, std::chrono::milliseconds(flush_millis_));
+        } else {
+          cv_.wait(ml);
+        }
+        if (shutdown_) break;
+      }
+      if (queue_.empty()) {
+        flush_requested_ = false;
+        continue;
+      }
+      Status status = InternalFlush(ml);
+      if (!status.ok() && background_status_.ok()) {
+        LOG(WARNING) << "Background flush of summaries failed: " << status;
+        background_status_ = status;
+      }
+    }
+  }
+
+  Status TakeBackgroundStatus() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return std::exchange(background_status_, OkStatus());
+  }
+
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
+  const bool background_flush_;
   uint64 last_flush_;
   Env* env_;
   mutex mu_;
+  condition_variable cv_;
   std::vector<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
+  // True while a batch of events is being written.
+  bool flushing_ TF_GUARDED_BY(mu_) = false;
+  bool flush_requested_ TF_GUARDED_BY(mu_) = false;
+  bool shutdown_ TF_GUARDED_BY(mu_) = false;
+  // The first error from a background flush not yet returned to a caller.
+  Status background_status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> flush_thread_;
+  // Held while writing events; acquired after `mu_` is released.
+  mutex writer_mu_;
   // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(writer_mu_);
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
 };
 
 }  // namespace
 
-Status CreateSummaryFileWriter(int max_queue, int flush_millis,
-                               const string& logdir,
-                               const string& filename_suffix, Env* env,
-                               SummaryWriterInterface** result) {
-  SummaryFileWriter* w = new SummaryFileWriter(max_queue, flush_millis, env);
+namespace {
+
+bool UseBackgroundFlush() {
+  static const bool background_flush = []() {
+    bool value = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SUMMARY_FILE_WRITER_BACKGROUND_FLUSH",
+                                   /*default_val=*/false, &value));
+    return value;
+  }();
+  return background_flush;
+}
+
+Status CreateSummaryFileWriterImpl(int max_queue, int flush_millis,
+                                   bool background_flush, const string& logdir,
+                                   const string& filename_suffix, Env* env,
+                                   SummaryWriterInterface** result) {
+  SummaryFileWriter* w =
+      new SummaryFileWriter(max_queue, flush_millis, background_flush, env);
   const Status s = w->Initialize(logdir, filename_suffix);
   if (!s.ok()) {
     w->Unref();
@@ -208,4 +315,25 @@ Status CreateSummaryFileWriter(int max_queue, int flush_millis,
   return OkStatus();
 }
 
+}  // namespace
+
+Status CreateSummaryFileWriter(int max_queue, int flush_millis,
+                               const string& logdir,
+                               const string& filename_suffix, Env* env,
+                               SummaryWriterInterface** result) {
+  return CreateSummaryFileWriterImpl(max_queue, flush_millis,
+                                     UseBackgroundFlush(), logdir,
+                                     filename_suffix, env, result);
+}
+
+Status CreateBackgroundSummaryFileWriter(int max_queue, int flush_millis,
+                                         const string& logdir,
+                                         const string& filename_suffix,
+                                         Env* env,
+                                         SummaryWriterInterface** result) {
+  return CreateSummaryFileWriterImpl(max_queue, flush_millis,
+                                     /*background_flush=*/true, logdir,
+                                     filename_suffix, env, result);
+}
+
 }  // namespace tensorflow
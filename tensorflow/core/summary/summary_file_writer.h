@@ -33,11 +33,30 @@ namespace tensorflow {
 /// filename_suffix. The caller owns a reference to result if the
 /// returned status is ok. The Env object must not be destroyed until
 /// after the returned writer.
+///
+/// If the environment variable TF_SUMMARY_FILE_WRITER_BACKGROUND_FLUSH is set
+/// to true, this behaves like CreateBackgroundSummaryFileWriter.
 Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                const string& logdir,
                                const string& filename_suffix, Env* env,
                                SummaryWriterInterface** result);
 
+/// \brief Like CreateSummaryFileWriter, but writes queued summaries from a
+/// background thread.
+///
+/// Writing a summary only enqueues it; a full queue or the flush_millis
+/// interval wakes a background thread that writes and flushes the queued
+/// events, so summary ops do not wait on storage. While a flush is in
+/// progress, at most max_queue further summaries are buffered before writes
+/// block, which bounds memory use when storage is slow. Errors from
+/// background flushes are returned by the next write or Flush(). Flush()
+/// writes all queued summaries synchronously.
+Status CreateBackgroundSummaryFileWriter(int max_queue, int flush_millis,
+                                         const string& logdir,
+                                         const string& filename_suffix,
+                                         Env* env,
+                                         SummaryWriterInterface** result);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_SUMMARY_SUMMARY_FILE_WRITER_H_
@@ -259,6 +259,48 @@ TEST_F(SummaryFileWriterTest, WallTime) {
       [](const Event& e) { EXPECT_EQ(e.wall_time(), 7.023); }));
 }
 
+TEST_F(SummaryFileWriterTest, BackgroundFlushKeepsAllEventsInOrder) {
+  // Keep unique with all other test names in this file.
+  const string test_name = "background_flush_test";
+  constexpr int kNumEvents = 100;
+  SummaryWriterInterface* writer;
+  TF_CHECK_OK(CreateBackgroundSummaryFileWriter(
+      /*max_queue=*/4, /*flush_millis=*/1, testing::TmpDir(), test_name, &env_,
+      &writer));
+  {
+    core::ScopedUnref deleter(writer);
+    for (int step = 0; step < kNumEvents; ++step) {
+      std::unique_ptr<Event> e{new Event};
+      e->set_step(step);
+      TF_CHECK_OK(writer->WriteEvent(std::move(e)));
+    }
+    TF_CHECK_OK(writer->Flush());
+  }
+
+  std::vector<string> files;
+  TF_CHECK_OK(env_.GetChildren(testing::TmpDir(), &files));
+  files.erase(std::remove_if(files.begin(), files.end(),
+                             [test_name](const string& f) {
+                               return !absl::StrContains(f, test_name);
+                             }),
+              files.end());
+  ASSERT_EQ(files.size(), 1);
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env_.NewRandomAccessFile(
+      io::JoinPath(testing::TmpDir(), files[0]), &read_file));
+  io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+  tstring record;
+  uint64 offset = 0;
+  TF_CHECK_OK(reader.ReadRecord(&offset, &record));  // The version event.
+  for (int step = 0; step < kNumEvents; ++step) {
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    Event e;
+    ASSERT_TRUE(e.ParseFromString(record));
+    EXPECT_EQ(e.step(), step);
+  }
+  EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+}
+
 TEST_F(SummaryFileWriterTest, AvoidFilenameCollision) {
   // Keep unique with all other test names in this file.
   string test_name = "avoid_filename_collision_test";
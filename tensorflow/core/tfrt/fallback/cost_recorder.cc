@@ -51,6 +51,19 @@ uint64_t CostRecorder::GetCost(int64_t op_key) const {
   return r;
 }
 
+void CostRecorder::RecordCosts(const CostRecorder& other) {
+  absl::flat_hash_map<int64_t, uint64_t> avg_op_costs;
+  {
+    tf_shared_lock l(other.op_cost_map_mutex_);
+    for (const auto& [op_key, op_cost] : other.op_cost_map_) {
+      avg_op_costs[op_key] = op_cost.first / op_cost.second;
+    }
+  }
+  for (const auto& [op_key, avg_op_cost] : avg_op_costs) {
+    RecordCost(op_key, avg_op_cost);
+  }
+}
+
 Status CostRecorder::WriteToFile() const {
   OpCostMapProto op_cost_map_proto;
   {
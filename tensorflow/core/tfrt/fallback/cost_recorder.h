@@ -42,6 +42,12 @@ class CostRecorder {
   // otherwise adding op costs would cause overflow.
   uint64_t GetCost(int64_t op_key) const;
 
+  // Records the average execution duration of each op in `other` as a single
+  // execution, so that the costs measured in an earlier period carry over to
+  // ops that don't run again, e.g. in rarely taken branches, and are blended
+  // with the durations recorded afterwards.
+  void RecordCosts(const CostRecorder& other);
+
   // Writes the op cost map (in format of `OpCostMapProto`) to a file specified
   // by the env var name `MesuredCostPathEnvVarName()`.
   // TODO(b/263837451): Fix the op_key unstableness during serialization.
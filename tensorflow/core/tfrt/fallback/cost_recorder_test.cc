@@ -56,6 +56,21 @@ TEST(CostRecorderTest, GetCostDefaultValueTest) {
             std::numeric_limits<uint32_t>::max());
 }
 
+TEST(CostRecorderTest, RecordCostsTest) {
+  CostRecorder previous_recorder;
+  previous_recorder.RecordCost(kTestOpKey, kTestCost);
+  previous_recorder.RecordCost(kTestOpKey, 2 * kTestCost);
+  previous_recorder.RecordCost(kTestOpKey + 1, kTestCost);
+
+  CostRecorder recorder;
+  recorder.RecordCost(kTestOpKey, 3 * kTestCost);
+  recorder.RecordCosts(previous_recorder);
+
+  EXPECT_EQ(recorder.size(), 2);
+  EXPECT_EQ(recorder.GetCost(kTestOpKey), (kTestAvgCost + 3 * kTestCost) / 2);
+  EXPECT_EQ(recorder.GetCost(kTestOpKey + 1), kTestCost);
+}
+
 TEST(CostRecorderTest, WriteToFileTest) {
   CostRecorder recorder;
   ASSERT_EQ(recorder.size(), 0);
@@ -32,19 +32,20 @@ StatusOr<OpKernelRunner*> OpKernelRunnerCache::GetOrCreate(
     const tensorflow::ProcessFunctionLibraryRuntime&
         process_function_library_runtime) {
   OpLocationKey key(loc);
+  auto& shard = GetShard(key);
   {
-    tf_shared_lock lock(mu_);
-    auto it = map_.find(key);
-    if (it != map_.end()) {
+    tf_shared_lock lock(shard.mu);
+    auto it = shard.map.find(key);
+    if (it != shard.map.end()) {
       DCHECK_EQ(it->second->op_kernel()->def().op(), op_name);
       return it->second.get();
     }
   }
 
-  mutex_lock lock(mu_);
+  mutex_lock lock(shard.mu);
 
-  auto it = map_.find(key);
-  if (it != map_.end()) {
+  auto it = shard.map.find(key);
+  if (it != shard.map.end()) {
     DCHECK_EQ(it->second->op_kernel()->def().op(), op_name);
     return it->second.get();
   }
@@ -63,7 +64,7 @@ StatusOr<OpKernelRunner*> OpKernelRunnerCache::GetOrCreate(
   auto runner_uptr = std::make_unique<OpKernelRunner>(std::move(runner));
 
   auto* runner_ptr = runner_uptr.get();
-  auto r = map_.emplace(key, std::move(runner_uptr)).second;
+  auto r = shard.map.emplace(key, std::move(runner_uptr)).second;
   DCHECK(r);
 
   return runner_ptr;
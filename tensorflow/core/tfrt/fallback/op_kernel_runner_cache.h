@@ -15,9 +15,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_TFRT_FALLBACK_OP_KERNEL_RUNNER_CACHE_H_
 #define TENSORFLOW_CORE_TFRT_FALLBACK_OP_KERNEL_RUNNER_CACHE_H_
 
+#include <array>
 #include <functional>
 #include <memory>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/tfrt/fallback/op_kernel_runner.h"
 #include "tfrt/host_context/location.h"  // from @tf_runtime
@@ -46,7 +49,10 @@ class OpLocationKey {
   tfrt::Location loc_;
 };
 
-// OpKernelRunnerCache is similar to OpKernelRunnerTable but thread-safe.
+// OpKernelRunnerCache is similar to OpKernelRunnerTable but thread-safe. The
+// runners are spread over shards with their own locks, so that concurrent
+// lookups don't contend on one lock, and kernels at different locations can be
+// created in parallel.
 class OpKernelRunnerCache {
  public:
   OpKernelRunnerCache() = default;
@@ -60,9 +66,19 @@ class OpKernelRunnerCache {
           process_function_library_runtime);
 
  private:
-  mutable mutex mu_;
-  absl::flat_hash_map<OpLocationKey, std::unique_ptr<OpKernelRunner>> map_
-      TF_GUARDED_BY(mu_);
+  static constexpr int kNumShards = 16;
+
+  struct Shard {
+    mutable mutex mu;
+    absl::flat_hash_map<OpLocationKey, std::unique_ptr<OpKernelRunner>> map
+        TF_GUARDED_BY(mu);
+  };
+
+  Shard& GetShard(const OpLocationKey& key) {
+    return shards_[absl::Hash<OpLocationKey>{}(key) % kNumShards];
+  }
+
+  std::array<Shard, kNumShards> shards_;
 };
 
 }  // namespace tfrt_stub
@@ -0,0 +1,108 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tsl/framework/allocator.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+namespace {
+
+// Allocations larger than a quarter of a block would waste too much of it, so
+// they are forwarded to the base allocator instead.
+constexpr size_t kMaxArenaAllocationFraction = 4;
+
+}  // namespace
+
+std::shared_ptr<RequestArenaAllocator> RequestArenaAllocator::Create(
+    tsl::Allocator* base, size_t block_size) {
+  DCHECK(base);
+  return std::shared_ptr<RequestArenaAllocator>(
+      new RequestArenaAllocator(base, block_size),
+      [](RequestArenaAllocator* allocator) { allocator->Unref(); });
+}
+
+RequestArenaAllocator::RequestArenaAllocator(tsl::Allocator* base,
+                                             size_t block_size)
+    : base_(base), block_size_(block_size) {}
+
+RequestArenaAllocator::~RequestArenaAllocator() {
+  DCHECK(large_allocations_.empty());
+  for (void* block : blocks_) {
+    base_->DeallocateRaw(block);
+  }
+}
+
+void* RequestArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  alignment = std::max(alignment, sizeof(void*));
+  void* ptr = nullptr;
+  if (num_bytes + alignment > block_size_ / kMaxArenaAllocationFraction) {
+    ptr = base_->AllocateRaw(alignment, num_bytes);
+    if (ptr == nullptr) return nullptr;
+    mutex_lock lock(mu_);
+    large_allocations_.insert(ptr);
+  } else {
+    mutex_lock lock(mu_);
+    auto align = [alignment](char* p) {
+      return reinterpret_cast<char*>(
+          (reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(alignment - 1));
+    };
+    char* aligned = next_ == nullptr ? nullptr : align(next_);
+    if (aligned == nullptr || aligned + num_bytes > end_) {
+      void* block = base_->AllocateRaw(Allocator::kAllocatorAlignment,
+                                       block_size_);
+      if (block == nullptr) return nullptr;
+      blocks_.push_back(block);
+      next_ = static_cast<char*>(block);
+      end_ = next_ + block_size_;
+      aligned = align(next_);
+    }
+    next_ = aligned + num_bytes;
+    ptr = aligned;
+  }
+  refs_.fetch_add(1, std::memory_order_relaxed);
+  return ptr;
+}
+
+void RequestArenaAllocator::DeallocateRaw(void* ptr) {
+  {
+    mutex_lock lock(mu_);
+    if (large_allocations_.erase(ptr) > 0) {
+      base_->DeallocateRaw(ptr);
+    }
+  }
+  Unref();
+}
+
+size_t RequestArenaAllocator::num_blocks() const {
+  mutex_lock lock(mu_);
+  return blocks_.size();
+}
+
+void RequestArenaAllocator::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+}  // namespace tfrt_stub
+}  // namespace tensorflow
@@ -0,0 +1,87 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_TFRT_FALLBACK_REQUEST_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_TFRT_FALLBACK_REQUEST_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tsl/framework/allocator.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+
+// Thread-safe.
+// A bump allocator that backs the host tensors of a single request. Small
+// allocations are carved out of large blocks obtained from `base`, and
+// deallocating them is a no-op; the blocks are returned to `base` all at once.
+// Allocations larger than a fraction of the block size are forwarded to
+// `base`.
+//
+// The blocks are freed when the request releases the allocator and every
+// allocation from it has been deallocated, so tensors that outlive the
+// request, e.g. its outputs, stay valid but keep all the blocks alive.
+class RequestArenaAllocator : public tsl::Allocator {
+ public:
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  // Creates an allocator whose blocks come from `base`, which must outlive it.
+  // Dropping the returned pointer releases the request's reference.
+  static std::shared_ptr<RequestArenaAllocator> Create(
+      tsl::Allocator* base, size_t block_size = kDefaultBlockSize);
+
+  std::string Name() override { return "request_arena"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+
+  tsl::AllocatorMemoryType GetMemoryType() const override {
+    return base_->GetMemoryType();
+  }
+
+  // Returns the number of blocks obtained from the base allocator so far.
+  size_t num_blocks() const;
+
+ private:
+  RequestArenaAllocator(tsl::Allocator* base, size_t block_size);
+  ~RequestArenaAllocator() override;
+
+  // Drops a reference, and deletes the allocator if it was the last one.
+  void Unref();
+
+  tsl::Allocator* const base_;
+  const size_t block_size_;
+
+  // One reference for the request plus one for each live allocation.
+  std::atomic<int64_t> refs_{1};
+
+  mutable tensorflow::mutex mu_;
+  std::vector<void*> blocks_ TF_GUARDED_BY(mu_);
+  char* next_ TF_GUARDED_BY(mu_) = nullptr;
+  char* end_ TF_GUARDED_BY(mu_) = nullptr;
+  absl::flat_hash_set<void*> large_allocations_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tfrt_stub
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_TFRT_FALLBACK_REQUEST_ARENA_ALLOCATOR_H_
@@ -0,0 +1,101 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "tsl/framework/allocator.h"
+#include "tensorflow/core/platform/mem.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+namespace {
+
+// Forwards to the system allocator and counts the live allocations.
+class CountingAllocator : public tsl::Allocator {
+ public:
+  std::string Name() override { return "counting"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations_;
+    ++num_live_;
+    return port::AlignedMalloc(num_bytes, alignment);
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    --num_live_;
+    port::AlignedFree(ptr);
+  }
+
+  int num_allocations_ = 0;
+  int num_live_ = 0;
+};
+
+TEST(RequestArenaAllocatorTest, SmallAllocationsShareBlocks) {
+  CountingAllocator base;
+  {
+    auto arena = RequestArenaAllocator::Create(&base, /*block_size=*/4096);
+    void* ptrs[16];
+    for (int i = 0; i < 16; ++i) {
+      ptrs[i] = arena->AllocateRaw(tsl::Allocator::kAllocatorAlignment, 100);
+      ASSERT_NE(ptrs[i], nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(ptrs[i]) %
+                    tsl::Allocator::kAllocatorAlignment,
+                0);
+    }
+    // 16 allocations of 128 bytes after alignment fit in one block.
+    EXPECT_EQ(arena->num_blocks(), 1);
+    EXPECT_EQ(base.num_allocations_, 1);
+
+    for (void* ptr : ptrs) arena->DeallocateRaw(ptr);
+    EXPECT_EQ(base.num_live_, 1);
+  }
+  EXPECT_EQ(base.num_live_, 0);
+}
+
+TEST(RequestArenaAllocatorTest, LargeAllocationsAreForwarded) {
+  CountingAllocator base;
+  auto arena = RequestArenaAllocator::Create(&base, /*block_size=*/4096);
+  void* ptr = arena->AllocateRaw(tsl::Allocator::kAllocatorAlignment, 4096);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(arena->num_blocks(), 0);
+  EXPECT_EQ(base.num_live_, 1);
+
+  arena->DeallocateRaw(ptr);
+  EXPECT_EQ(base.num_live_, 0);
+}
+
+TEST(RequestArenaAllocatorTest, AllocationsOutliveRequest) {
+  CountingAllocator base;
+  auto arena = RequestArenaAllocator::Create(&base, /*block_size=*/4096);
+  tsl::Allocator* allocator = arena.get();
+  void* ptr = allocator->AllocateRaw(tsl::Allocator::kAllocatorAlignment, 8);
+  ASSERT_NE(ptr, nullptr);
+
+  // The request completes while the allocation is still alive.
+  arena.reset();
+  EXPECT_EQ(base.num_live_, 1);
+
+  allocator->DeallocateRaw(ptr);
+  EXPECT_EQ(base.num_live_, 0);
+}
+
+}  // namespace
+}  // namespace tfrt_stub
+}  // namespace tensorflow
@@ -125,6 +125,7 @@ std::ostream& operator<<(std::ostream& os,
             << ", enable_tfrt_gpu = " << options.enable_tfrt_gpu
             << ", runtime = " << options.runtime
             << ", model_metadata = " << options.model_metadata.DebugString()
+            << ", enable_request_arena = " << options.enable_request_arena
             << ", compile_options = " << options.compile_options << "}";
 }
 
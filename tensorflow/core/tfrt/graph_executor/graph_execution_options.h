@@ -104,6 +104,12 @@ struct GraphExecutionOptions {
   // This option is experimental.
   bool enable_mlrt = false;
 
+  // If true, the host tensors allocated by the ops of each request are carved
+  // out of a per-request arena instead of the global allocator, and the arena
+  // is freed in bulk when the request and its outputs are done. This reduces
+  // malloc contention under high concurrency. This option is experimental.
+  bool enable_request_arena = false;
+
   tensorflow::TfrtCompileOptions compile_options;
 };
 
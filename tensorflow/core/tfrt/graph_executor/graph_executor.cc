@@ -65,6 +65,7 @@ limitations under the License.
 #include "tensorflow/core/runtime_fallback/kernel/kernel_fallback_utils.h"
 #include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
 #include "tensorflow/core/tfrt/graph_executor/executable_context.h"
 #include "tensorflow/core/tfrt/graph_executor/export_mlir.h"
 #include "tensorflow/core/tfrt/graph_executor/graph_execution_options.h"
@@ -252,6 +253,10 @@ StatusOr<std::unique_ptr<RequestInfo>> CreateRequestInfo(
   fallback_request_state.set_runtime_config(&options.runtime_config);
   fallback_request_state.set_cancellation_manager(
       &request_info->cancellation_manager);
+  if (options.enable_request_arena) {
+    fallback_request_state.set_cpu_allocator(RequestArenaAllocator::Create(
+        fallback_request_state.cpu_device()->GetAllocator({})));
+  }
 
   // Set priority in the builder.
   tfrt::RequestOptions request_options;
@@ -1097,8 +1102,12 @@ void GraphExecutor::LoadedClientGraph::UpdateCostAnalysisData(
     cost_analysis_data_.tf_mlir_with_op_keys = nullptr;
     cost_analysis_data_.cost_recorder = nullptr;
   } else {
-    // Update cost analysis data.
-    cost_analysis_data_.cost_recorder = std::make_unique<CostRecorder>();
+    // Update cost analysis data. The costs of the last period carry over, so
+    // that ops that don't run in the next period keep their measured costs
+    // instead of being treated as expensive by the next recompilation.
+    auto cost_recorder = std::make_unique<CostRecorder>();
+    cost_recorder->RecordCosts(*cost_analysis_data_.cost_recorder);
+    cost_analysis_data_.cost_recorder = std::move(cost_recorder);
     cost_analysis_data_.is_available = true;
     cost_analysis_data_.start_time = now;
     cost_analysis_data_.num_cost_updates = 0;
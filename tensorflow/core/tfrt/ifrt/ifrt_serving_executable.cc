@@ -351,9 +351,9 @@ absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
                           absl::MakeSpan(args),
                           /*options=*/{.untuple_result = true}, std::nullopt));
 
-  auto status = execution_result.status.Await();
-  TF_RETURN_IF_ERROR(status);
-
+  // The copies of the outputs to host are enqueued right behind the execution
+  // instead of after waiting for it, so that they start as soon as the outputs
+  // are ready, and this thread blocks only once.
   std::vector<tensorflow::Tensor> outputs;
   std::vector<xla::ifrt::Future<absl::Status>> output_futures;
   output_futures.reserve(execution_result.outputs.size());
@@ -414,10 +414,18 @@ absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
     outputs.push_back(std::move(tensor));
   }
 
+  // Report the failure of the execution rather than that of the copies of its
+  // outputs.
+  TF_RETURN_IF_ERROR(execution_result.status.Await());
   TF_RETURN_IF_ERROR(
       xla::ifrt::JoinFutures(absl::MakeSpan(output_futures)).Await());
   return outputs;
 }
 
+absl::Status IfrtServingExecutable::Precompile(
+    absl::Span<const tensorflow::Tensor> inputs) {
+  return LookUpOrCreateExecutable(inputs).Await().status();
+}
+
 }  // namespace ifrt_serving
 }  // namespace tensorflow
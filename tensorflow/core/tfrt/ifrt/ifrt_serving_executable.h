@@ -24,6 +24,7 @@ limitations under the License.
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -73,6 +74,12 @@ class IfrtServingExecutable {
   absl::StatusOr<std::vector<tensorflow::Tensor>> Execute(
       absl::Span<const tensorflow::Tensor> inputs);
 
+  // Compiles the program for the shape signature of `inputs` unless it is
+  // compiled already, so that requests of that signature don't pay for the
+  // compilation, e.g. for the expected batch sizes at model load. Only the
+  // shapes and dtypes of `inputs` are used.
+  absl::Status Precompile(absl::Span<const tensorflow::Tensor> inputs);
+
   int num_executables() const {
     absl::MutexLock lock(&mutex_);
     return executable_bundles_.size();
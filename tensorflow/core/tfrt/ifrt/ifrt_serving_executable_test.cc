@@ -43,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/platform/resource_loader.h"
 #include "tensorflow/core/platform/test.h"
+#include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/statusor.h"
 
 namespace tensorflow {
@@ -150,6 +151,56 @@ TEST(IfrtServingExecutableTest, MultipleShapes) {
   EXPECT_THAT(outputs2, ElementsAre(TensorEq(expected_out2)));
 }
 
+TEST(IfrtServingExecutableTest, Precompile) {
+  // Create test input module
+  constexpr absl::string_view kDataDirectory =
+      "tensorflow/core/tfrt/ifrt/testdata";
+  std::string mlir_module_path = tensorflow::GetDataDependencyFilepath(
+      absl::StrCat(kDataDirectory, "/executable.mlir"));
+
+  mlir::DialectRegistry registry;
+  mlir::registerAllDialects(registry);
+  mlir::RegisterAllTensorFlowDialects(registry);
+
+  mlir::MLIRContext context(registry);
+
+  mlir::OwningOpRef<mlir::ModuleOp> mlir_module =
+      mlir::parseSourceFile<mlir::ModuleOp>(mlir_module_path, &context);
+
+  ASSERT_TRUE(mlir_module);
+
+  // Create contexts required for the compiler execution.
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<xla::ifrt::Client> client,
+                          xla::ifrt::test_util::GetClient());
+
+  IfrtServingExecutable executable("test", "main", std::move(mlir_module),
+                                   client,
+                                   tensorflow::IdentityShapeRepresentationFn());
+
+  // Only the shapes and dtypes of the inputs matter for compilation.
+  std::vector<tensorflow::Tensor> shapes{
+      tensorflow::Tensor(DT_INT32, tensorflow::TensorShape({1, 3})),
+      tensorflow::Tensor(DT_INT32, tensorflow::TensorShape({3, 1}))};
+  TF_ASSERT_OK(executable.Precompile(absl::MakeSpan(shapes)));
+  ASSERT_EQ(executable.num_executables(), 1);
+
+  auto x = tensorflow::test::AsTensor<int32_t>({1, 2, 3},
+                                               tensorflow::TensorShape({1, 3}));
+  auto y = tensorflow::test::AsTensor<int32_t>({1, 2, 3},
+                                               tensorflow::TensorShape({3, 1}));
+  std::vector<tensorflow::Tensor> inputs{x, y};
+
+  TF_ASSERT_OK_AND_ASSIGN(auto result,
+                          executable.Execute(absl::MakeSpan(inputs)));
+
+  // The request reuses the precompiled executable.
+  EXPECT_EQ(executable.num_executables(), 1);
+
+  const auto expected_out = tensorflow::test::AsTensor<int32_t>(
+      {14}, tensorflow::TensorShape({1, 1}));
+  EXPECT_THAT(result, ElementsAre(TensorEq(expected_out)));
+}
+
 TEST(IfrtServingExecutableTest, Spmd) {
   // Create test input module
   constexpr absl::string_view kDataDirectory =
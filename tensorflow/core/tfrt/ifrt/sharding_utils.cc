@@ -67,6 +67,15 @@ absl::StatusOr<xla::ifrt::DType> ToIfrtDType(
   return xla::ifrt::ToDType(primitive_type);
 }
 
+// Returns true if only the major-most axis is partitioned.
+bool IsSplitOnlyAlongMajorAxis(
+    const std::vector<int32_t>& num_partitions_per_axis) {
+  for (int axis = 1; axis < num_partitions_per_axis.size(); ++axis) {
+    if (num_partitions_per_axis[axis] != 1) return false;
+  }
+  return true;
+}
+
 // Shard the given `input_tensor` into equal shapes of slices.
 //
 // `num_paritions_per_axis` specifies the number of partitions along
@@ -122,6 +131,15 @@ SplitAndCreateArraysFromHostBuffer(
           "Rank 0 tensor only expects 1 slice but got ", split_tensors.size()));
     }
     split_tensors[0] = input_tensor;
+  } else if (IsSplitOnlyAlongMajorAxis(num_partitions_per_axis)) {
+    // Fast path for sharding along the batch dimension. Each slice is a
+    // contiguous range of the input buffer, so it is transferred in place
+    // instead of being copied out on the host first.
+    const int64_t slice_size = input_tensor.dim_size(0) / num_slices;
+    for (int i = 0; i < num_slices; ++i) {
+      split_tensors[i] =
+          input_tensor.Slice(i * slice_size, (i + 1) * slice_size);
+    }
   } else {
     switch (input_tensor.dtype()) {
 #define CASE(type)                                                             \
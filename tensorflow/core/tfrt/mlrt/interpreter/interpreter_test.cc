@@ -3100,7 +3100,9 @@ TEST(KernelTest, PromiseReturnNotScheduleImmediately) {
 }
 
 void BM_SequentialAdd(::testing::benchmark::State& state) {
-  auto buffer = CreateSequentialAddExecutable(99);
+  // The number of kernels dispatched per call is `num_add` plus the return.
+  const int num_add = state.range(0);
+  auto buffer = CreateSequentialAddExecutable(num_add);
 
   bc::Executable executable(buffer.data());
 
@@ -3128,7 +3130,7 @@ void BM_SequentialAdd(::testing::benchmark::State& state) {
 
   Execute(execution_context);
   notification.WaitForNotification();
-  CHECK_EQ(result.Get<int32_t>(), 100);
+  CHECK_EQ(result.Get<int32_t>(), num_add + 1);
 
   for (auto s : state) {
     absl::Notification notification;
@@ -3141,11 +3143,15 @@ void BM_SequentialAdd(::testing::benchmark::State& state) {
     Execute(execution_context);
     notification.WaitForNotification();
   }
+  // Items are kernel dispatches, so that the per-kernel overhead can be read
+  // off directly and the fixed per-call cost shows up in the smaller args.
+  state.SetItemsProcessed(state.iterations() * (num_add + 1));
 }
-BENCHMARK(BM_SequentialAdd);
+BENCHMARK(BM_SequentialAdd)->Arg(1)->Arg(9)->Arg(99);
 
 void BM_SequentialAddAttributes(::testing::benchmark::State& state) {
-  auto buffer = CreateSequentialAddAttributesExecutable(99);
+  const int num_add = state.range(0);
+  auto buffer = CreateSequentialAddAttributesExecutable(num_add);
 
   bc::Executable executable(buffer.data());
 
@@ -3172,7 +3178,7 @@ void BM_SequentialAddAttributes(::testing::benchmark::State& state) {
                          absl::Span<Value>(&result, 1));
   Execute(execution_context);
   notification.WaitForNotification();
-  CHECK_EQ(result.Get<int32_t>(), 100);
+  CHECK_EQ(result.Get<int32_t>(), num_add + 1);
 
   for (auto s : state) {
     absl::Notification notification;
@@ -3186,8 +3192,9 @@ void BM_SequentialAddAttributes(::testing::benchmark::State& state) {
     Execute(execution_context);
     notification.WaitForNotification();
   }
+  state.SetItemsProcessed(state.iterations() * (num_add + 1));
 }
-BENCHMARK(BM_SequentialAddAttributes);
+BENCHMARK(BM_SequentialAddAttributes)->Arg(1)->Arg(9)->Arg(99);
 
 }  // namespace
 }  // namespace mlrt
@@ -944,6 +944,26 @@ void PromiseTensor(mlrt::KernelFrame frame) {
   frame.arguments()[0].Destroy<mlrt::Promise>();
 }
 
+// Fused tf_mlrt.promise ops. The first half of the arguments are the promises
+// and the second half the tensors.
+void PromiseAllTensor(mlrt::KernelFrame frame) {
+  tsl::profiler::TraceMe trace_me("tf_mlrt.promise_all");
+  const int num_promises = frame.arguments().size() / 2;
+  for (int i = 0; i < num_promises; ++i) {
+    auto& promise = frame.arguments()[i].Get<mlrt::Promise>();
+    auto& tensor = frame.arguments()[num_promises + i]
+                       .Get<tensorflow::tfrt_stub::FallbackTensor>();
+    if (frame.last_uses()[num_promises + i]) {
+      std::move(promise).Set<tensorflow::tfrt_stub::FallbackTensor>(
+          std::move(tensor));
+    } else {
+      std::move(promise).Set<tensorflow::tfrt_stub::FallbackTensor>(tensor);
+    }
+
+    frame.arguments()[i].Destroy<mlrt::Promise>();
+  }
+}
+
 void PromiseFuture(mlrt::KernelFrame frame) {
   tsl::profiler::TraceMe trace_me("tf_mlrt.promise_future");
   auto& promise = frame.arguments()[0].Get<mlrt::Promise>();
@@ -1006,6 +1026,7 @@ void RegisterTfMlrtKernels(mlrt::KernelRegistry& registry) {
   registry.Register("tf_mlrt.await_all", &AwaitAllTensor);
   registry.Register<MapFnOp>();
   registry.Register("tf_mlrt.promise", &PromiseTensor);
+  registry.Register("tf_mlrt.promise_all", &PromiseAllTensor);
   registry.Register("tf_mlrt.promise_future", &PromiseFuture);
   registry.Register<PromiseReturnOp>();
 
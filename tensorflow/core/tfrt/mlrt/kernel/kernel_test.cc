@@ -2440,6 +2440,91 @@ TEST(KernelTest, PromiseReturn) {
       output.Get<tfrt_stub::FallbackTensor>().tensor(), expected);
 }
 
+mlrt::bc::Buffer CreatePromiseAllExecutable() {
+  mlrt::bc::Buffer buffer;
+  mlrt::bc::Allocator allocator(&buffer);
+
+  auto executable_ctor = mlrt::bc::New<mlrt::bc::Executable>(&allocator);
+
+  mlrt::testing::SymbolTable kernels;
+  std::vector<std::string> names = {"tf_mlrt.promise_all", "return"};
+  executable_ctor.construct_kernel_names(2).Assign(names);
+  kernels.Def(names);
+
+  auto functions_ctor = executable_ctor.construct_functions(1);
+  {
+    auto function_ctor = functions_ctor.ConstructAt(0);
+    function_ctor.construct_name("producer");
+
+    mlrt::testing::SymbolTable regs;
+
+    function_ctor.construct_input_regs(3).Assign(
+        {regs.Def("promise0"), regs.Def("promise1"), regs.Def("value")});
+
+    auto kernels_ctor = function_ctor.construct_kernels(2);
+
+    {
+      // promise_all
+      auto kernel_ctor = kernels_ctor.ConstructAt(0);
+      kernel_ctor.set_code(kernels.Use("tf_mlrt.promise_all"));
+      kernel_ctor.construct_arguments(4).Assign(
+          {regs.Use("promise0"), regs.Use("promise1"), regs.Use("value"),
+           regs.Use("value")});
+      kernel_ctor.construct_last_uses(4).Assign({true, true, false, true});
+    }
+
+    {
+      // Return
+      auto kernel_ctor = kernels_ctor.ConstructAt(1);
+      kernel_ctor.set_code(kernels.Use("return"));
+    }
+
+    function_ctor.set_num_regs(regs.size());
+  }
+
+  return buffer;
+}
+
+TEST(KernelTest, PromiseAll) {
+  auto buffer = CreatePromiseAllExecutable();
+
+  mlrt::bc::Executable executable(buffer.data());
+
+  mlrt::KernelRegistry registry;
+  RegisterTfMlrtKernels(registry);
+
+  mlrt::LoadedExecutable loaded_executable(executable, registry);
+
+  auto promise0 =
+      mlrt::Promise::Allocate<tensorflow::tfrt_stub::FallbackTensor>();
+  auto promise1 =
+      mlrt::Promise::Allocate<tensorflow::tfrt_stub::FallbackTensor>();
+  auto future0 = promise0.GetFuture();
+  auto future1 = promise1.GetFuture();
+  tensorflow::Tensor expected(static_cast<int32_t>(100));
+
+  {
+    mlrt::Value inputs[3];
+    inputs[0].Set(std::move(promise0));
+    inputs[1].Set(std::move(promise1));
+    inputs[2].Set(tensorflow::tfrt_stub::FallbackTensor(expected));
+
+    mlrt::ExecutionContext producer_context(&loaded_executable);
+    std::vector<uint8_t> last_uses = {true, true, true};
+    producer_context.Call(loaded_executable.GetFunction("producer"), last_uses,
+                          absl::Span<mlrt::Value>(inputs),
+                          absl::Span<mlrt::Value>());
+    mlrt::Execute(producer_context);
+  }
+
+  ASSERT_TRUE(future0.IsReady());
+  ASSERT_TRUE(future1.IsReady());
+  tensorflow::test::ExpectEqual(
+      future0.Get<tensorflow::tfrt_stub::FallbackTensor>().tensor(), expected);
+  tensorflow::test::ExpectEqual(
+      future1.Get<tensorflow::tfrt_stub::FallbackTensor>().tensor(), expected);
+}
+
 // A function body for AsyncWhile.
 void TestAsyncWhileFnBody(mlrt::KernelFrame frame) {
   ASSERT_EQ(frame.arguments().size(), 4);
@@ -16,20 +16,28 @@ limitations under the License.
 // For Google-internal use only.
 #include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
 
+#include <cstdlib>
 #include <map>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/base/call_once.h"
+#include "absl/strings/str_cat.h"
 #include "xla/status_macros.h"
 #include "xla/stream_executor/dnn.h"
 #include "xla/stream_executor/gpu/gpu_init.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/str_util.h"
 #include "tensorflow/core/util/activation_mode.h"
 #include "tensorflow/core/util/autotune_maps/autotune_map.pb.h"
 #include "tensorflow/core/util/autotune_maps/conv_autotune_maps.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.pb.h"
+#include "tensorflow/core/util/autotune_maps/matmul_autotune_maps.h"
 #include "tsl/lib/strings/proto_serialization.h"
 #include "tsl/protobuf/dnn.pb.h"
 
@@ -42,26 +50,26 @@ using stream_executor::dnn::AlgorithmConfigProto;
 using stream_executor::dnn::AlgorithmDesc;
 using stream_executor::dnn::AlgorithmProto;
 
-template <typename Op>
-StatusOr<ConvMapProto> ConvMapToProto(
-    const AutotuneMap<ConvParameters, AutotuneEntry<Op>> &autotune_map) {
-  ConvMapProto proto;
+template <typename MapProto, typename Parameters, typename Op>
+StatusOr<MapProto> AutotuneMapToProto(
+    const AutotuneMap<Parameters, AutotuneEntry<Op>> &autotune_map) {
+  MapProto proto;
 
   // Deterministically sort the entries in autotune maps
-  // according to the serialized string of ConvParametersProto in order to
+  // according to the serialized string of the parameters proto in order to
   // enable deterministic serialization. The actual order is meaningless.
   //
   // This step also filters out duplicate entries (only device_id's are
-  // different) in the autotune maps. So that there is only one entry for a
-  // convolution operation with a specific GPU device type.
-  std::map<string, ConvMapProto::Entry> sorted_map;
+  // different) in the autotune maps. So that there is only one entry for an
+  // operation with a specific GPU device type.
+  std::map<string, typename MapProto::Entry> sorted_map;
 
   for (auto const &p : autotune_map.GetMap()) {
-    const ConvParameters &params = p.first;
-    const ConvParametersProto &params_proto = params.proto();
+    const Parameters &params = p.first;
+    const auto &params_proto = params.proto();
     VLOG(1) << "Reading: " << params.ToString();
 
-    ConvMapProto::Entry kv;
+    typename MapProto::Entry kv;
     *kv.mutable_key() = params_proto;
 
     if (p.second.is_algorithm_config()) {
@@ -83,16 +91,21 @@ StatusOr<ConvMapProto> ConvMapToProto(
   }
 
   for (auto const &p : sorted_map) {
-    ConvMapProto::Entry *kv = proto.add_kv_pairs();
+    typename MapProto::Entry *kv = proto.add_kv_pairs();
     *kv = p.second;
   }
   return proto;
 }
 
-template <typename Op>
-Status PopulateConvMap(
-    const ConvMapProto &m,
-    AutotuneMap<ConvParameters, AutotuneEntry<Op>> *autotune_map) {
+// Inserts the entries of "m" into "autotune_map" for each visible device of
+// the model the entries were collected on. "make_params" builds the key for
+// a device ordinal from the parameters proto.
+template <typename MapProto, typename Parameters, typename Op,
+          typename MakeParams>
+Status PopulateAutotuneMap(
+    const MapProto &m,
+    AutotuneMap<Parameters, AutotuneEntry<Op>> *autotune_map,
+    MakeParams make_params) {
   if (m.kv_pairs().size() == 0) {
     return OkStatus();
   }
@@ -109,20 +122,18 @@ Status PopulateConvMap(
   }
 
   std::set<std::string> unmatched_device_descs;
-  for (const ConvMapProto::Entry &kv : m.kv_pairs()) {
-    const ConvParametersProto &params_proto = kv.key();
+  for (const typename MapProto::Entry &kv : m.kv_pairs()) {
+    const auto &params_proto = kv.key();
     // Abort the loading process whenever there is an entry whose version number
     // doesn't match runtime version because the autotune results may be
     // incorrect.
-    if (params_proto.version() != ConvParameters::kVersion) {
-      VLOG(1) << "ConvParametersProto with the incompatible version:"
+    if (params_proto.version() != Parameters::kVersion) {
+      VLOG(1) << "Parameters proto with the incompatible version:"
               << params_proto.DebugString();
       return errors::Aborted(
-          "Aborted because the loaded autotune results for convolution "
-          "operations have a version different "
-          "from runtime's version. Expected version: ",
-          ConvParameters::kVersion,
-          ". Actual version: ", params_proto.version());
+          "Aborted because the loaded autotune results have a version "
+          "different from runtime's version. Expected version: ",
+          Parameters::kVersion, ". Actual version: ", params_proto.version());
     }
 
     const AlgorithmConfigProto &algorithm_config_proto = kv.value();
@@ -151,7 +162,9 @@ Status PopulateConvMap(
       entry = AutotuneEntry<Op>(primary, fallback);
 #endif
 
-      autotune_map->Insert(ConvParameters(ordinal, params_proto), entry);
+      TF_ASSIGN_OR_RETURN(Parameters params,
+                          make_params(platform, ordinal, params_proto));
+      autotune_map->Insert(params, entry);
     }
 
     if (!devices_matched) {
@@ -169,16 +182,89 @@ Status PopulateConvMap(
   return OkStatus();
 }
 
+StatusOr<ConvParameters> MakeConvParameters(
+    se::Platform *platform, int ordinal, const ConvParametersProto &proto) {
+  return ConvParameters(ordinal, proto);
+}
+
+StatusOr<MatmulParameters> MakeMatmulParameters(
+    se::Platform *platform, int ordinal, const MatmulParametersProto &proto) {
+  TF_ASSIGN_OR_RETURN(se::StreamExecutor * stream_exec,
+                      platform->ExecutorForDevice(ordinal));
+  return MatmulParameters(stream_exec, proto);
+}
+
 }  // namespace
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
+namespace {
+
+// Adds the entries of "from" to "to", replacing entries of "to" with the same
+// key. The result is sorted by key, so that it serializes deterministically.
+template <typename MapProto>
+Status MergeMapProto(const MapProto &from, MapProto *to) {
+  std::map<string, typename MapProto::Entry> sorted_map;
+  for (const MapProto *m : {static_cast<const MapProto *>(to), &from}) {
+    for (const auto &kv : m->kv_pairs()) {
+      std::string serialized_key;
+      TF_RET_CHECK(
+          tsl::SerializeToStringDeterministic(kv.key(), &serialized_key));
+      sorted_map[serialized_key] = kv;
+    }
+  }
+  to->clear_kv_pairs();
+  for (const auto &p : sorted_map) {
+    *to->add_kv_pairs() = p.second;
+  }
+  return OkStatus();
+}
+
+Status MergeAutotuneMaps(const AutotuneMapsProto &from,
+                         AutotuneMapsProto *to) {
+  TF_RETURN_IF_ERROR(MergeMapProto(from.conv_map(), to->mutable_conv_map()));
+  TF_RETURN_IF_ERROR(
+      MergeMapProto(from.fused_conv_map(), to->mutable_fused_conv_map()));
+  return MergeMapProto(from.fused_matmul_map(),
+                       to->mutable_fused_matmul_map());
+}
+
+bool SameEnvironment(const AutotuneEnvironmentProto &a,
+                     const AutotuneEnvironmentProto &b) {
+  return a.driver_version() == b.driver_version() &&
+         a.runtime_version() == b.runtime_version() &&
+         a.dnn_version() == b.dnn_version();
+}
+
+Status ReadAutotuneDatabase(Env *env, const std::string &path,
+                            AutotuneDatabaseProto *database) {
+  const Status exists = env->FileExists(path);
+  if (errors::IsNotFound(exists)) {
+    database->Clear();
+    return OkStatus();
+  }
+  TF_RETURN_IF_ERROR(exists);
+  std::string serialized;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, path, &serialized));
+  if (!database->ParseFromString(serialized)) {
+    return errors::DataLoss("Can't parse the autotune database ", path);
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
 Status SerializeAutotuneMaps(std::string *output) {
   AutotuneMapsProto proto;
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
-  TF_ASSIGN_OR_RETURN(*proto.mutable_conv_map(),
-                      ConvMapToProto(*ConvAutotuneMap::GetInstance()));
-  TF_ASSIGN_OR_RETURN(*proto.mutable_fused_conv_map(),
-                      ConvMapToProto(*FusedConvAutotuneMap::GetInstance()));
+  TF_ASSIGN_OR_RETURN(
+      *proto.mutable_conv_map(),
+      AutotuneMapToProto<ConvMapProto>(*ConvAutotuneMap::GetInstance()));
+  TF_ASSIGN_OR_RETURN(
+      *proto.mutable_fused_conv_map(),
+      AutotuneMapToProto<ConvMapProto>(*FusedConvAutotuneMap::GetInstance()));
+  TF_ASSIGN_OR_RETURN(*proto.mutable_fused_matmul_map(),
+                      AutotuneMapToProto<MatmulMapProto>(
+                          *FusedMatmulAutotuneMap::GetInstance()));
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   TF_RET_CHECK(tsl::SerializeToStringDeterministic(proto, output));
   return OkStatus();
@@ -194,10 +280,15 @@ Status LoadSerializedAutotuneMaps(absl::string_view s) {
     return errors::InvalidArgument(
         "Failed to parse the autotune maps from string.");
   }
-  TF_RETURN_IF_ERROR(
-      PopulateConvMap(proto.conv_map(), ConvAutotuneMap::GetInstance()));
-  TF_RETURN_IF_ERROR(PopulateConvMap(proto.fused_conv_map(),
-                                     FusedConvAutotuneMap::GetInstance()));
+  TF_RETURN_IF_ERROR(PopulateAutotuneMap(proto.conv_map(),
+                                         ConvAutotuneMap::GetInstance(),
+                                         MakeConvParameters));
+  TF_RETURN_IF_ERROR(PopulateAutotuneMap(proto.fused_conv_map(),
+                                         FusedConvAutotuneMap::GetInstance(),
+                                         MakeConvParameters));
+  TF_RETURN_IF_ERROR(PopulateAutotuneMap(proto.fused_matmul_map(),
+                                         FusedMatmulAutotuneMap::GetInstance(),
+                                         MakeMatmulParameters));
   // TODO(b/189530096): Populate autotune maps for more ops.
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   return OkStatus();
@@ -207,7 +298,102 @@ void ResetAutotuneMaps() {
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   ConvAutotuneMap::GetInstance()->ClearMap();
   FusedConvAutotuneMap::GetInstance()->ClearMap();
+  FusedMatmulAutotuneMap::GetInstance()->ClearMap();
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
+Status GetAutotuneEnvironment(AutotuneEnvironmentProto *environment) {
+  environment->Clear();
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  TF_ASSIGN_OR_RETURN(
+      se::Platform * platform,
+      se::MultiPlatformManager::PlatformWithName(se::GpuPlatformName()));
+  if (platform->VisibleDeviceCount() == 0) {
+    return OkStatus();
+  }
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<se::DeviceDescription> device_desc,
+                      platform->DescriptionForDevice(0));
+  environment->set_driver_version(device_desc->driver_version());
+  environment->set_runtime_version(device_desc->runtime_version());
+  TF_ASSIGN_OR_RETURN(se::StreamExecutor * stream_exec,
+                      platform->ExecutorForDevice(0));
+  if (se::dnn::DnnSupport *dnn = stream_exec->AsDnn()) {
+    const auto version = dnn->GetVersion();
+    if (version.ok()) {
+      environment->set_dnn_version(absl::StrCat(
+          version->major_version(), ".", version->minor_version(), ".",
+          version->patch()));
+    }
+  }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  return OkStatus();
+}
+
+Status LoadAutotuneDatabase(Env *env, const std::string &path) {
+  AutotuneDatabaseProto database;
+  TF_RETURN_IF_ERROR(ReadAutotuneDatabase(env, path, &database));
+  AutotuneEnvironmentProto environment;
+  TF_RETURN_IF_ERROR(GetAutotuneEnvironment(&environment));
+  for (const auto &entry : database.entries()) {
+    if (SameEnvironment(entry.environment(), environment)) {
+      std::string serialized;
+      TF_RET_CHECK(
+          tsl::SerializeToStringDeterministic(entry.maps(), &serialized));
+      return LoadSerializedAutotuneMaps(serialized);
+    }
+  }
+  VLOG(1) << "No autotune results for " << environment.ShortDebugString()
+          << " in " << path;
+  return OkStatus();
+}
+
+Status UpdateAutotuneDatabase(Env *env, const std::string &path) {
+  AutotuneDatabaseProto database;
+  TF_RETURN_IF_ERROR(ReadAutotuneDatabase(env, path, &database));
+  AutotuneEnvironmentProto environment;
+  TF_RETURN_IF_ERROR(GetAutotuneEnvironment(&environment));
+  std::string serialized;
+  TF_RETURN_IF_ERROR(SerializeAutotuneMaps(&serialized));
+  AutotuneMapsProto maps;
+  TF_RET_CHECK(maps.ParseFromString(serialized));
+
+  AutotuneDatabaseProto::Entry *target = nullptr;
+  for (auto &entry : *database.mutable_entries()) {
+    if (SameEnvironment(entry.environment(), environment)) {
+      target = &entry;
+      break;
+    }
+  }
+  if (target == nullptr) {
+    target = database.add_entries();
+    *target->mutable_environment() = environment;
+  }
+  TF_RETURN_IF_ERROR(MergeAutotuneMaps(maps, target->mutable_maps()));
+
+  // Renaming a fully written temporary file replaces the database atomically,
+  // so that concurrent readers never see a partial file.
+  TF_RET_CHECK(tsl::SerializeToStringDeterministic(database, &serialized));
+  const std::string tmp_path =
+      absl::StrCat(path, ".tmp", env->NowMicros(), "_", random::New64());
+  TF_RETURN_IF_ERROR(WriteStringToFile(env, tmp_path, serialized));
+  const Status renamed = env->RenameFile(tmp_path, path);
+  if (!renamed.ok()) {
+    env->DeleteFile(tmp_path).IgnoreError();
+  }
+  return renamed;
+}
+
+void MaybeLoadAutotuneDatabaseFromEnv() {
+  static absl::once_flag once;
+  absl::call_once(once, []() {
+    const char *path = std::getenv("TF_AUTOTUNE_DATABASE");
+    if (path == nullptr || *path == '\0') return;
+    const Status status = LoadAutotuneDatabase(Env::Default(), path);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to load the autotune database " << path << ": "
+                   << status;
+    }
+  });
+}
+
 }  // namespace tensorflow
@@ -27,7 +27,9 @@ limitations under the License.
 
 #include <string>
 
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/util/autotune_maps/autotune_map.pb.h"
 
 namespace tensorflow {
 
@@ -43,6 +45,25 @@ Status SerializeAutotuneMaps(std::string* output);
 // Resets all autotune maps. For test use only.
 void ResetAutotuneMaps();
 
+// Fills "environment" with the versions of the GPU driver and libraries the
+// autotune results of this process depend on.
+Status GetAutotuneEnvironment(AutotuneEnvironmentProto* environment);
+
+// Loads the autotune results collected with the same environment from the
+// AutotuneDatabaseProto in "path" into the runtime autotune maps. A missing
+// database, or one without results for this environment, is not an error.
+Status LoadAutotuneDatabase(Env* env, const std::string& path);
+
+// Merges the runtime autotune maps into the entry of the database in "path"
+// for this environment, creating the database if needed. The file is
+// replaced atomically, so the workers of a job can share it. Results written
+// concurrently by another process may be dropped, until its next update.
+Status UpdateAutotuneDatabase(Env* env, const std::string& path);
+
+// Loads the database named by the TF_AUTOTUNE_DATABASE environment variable,
+// once per process. Failures are logged and otherwise ignored.
+void MaybeLoadAutotuneDatabaseFromEnv();
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_UTIL_AUTOTUNE_MAPS_AUTOTUNE_SERIALIZE_H_
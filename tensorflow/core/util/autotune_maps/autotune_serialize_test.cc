@@ -19,8 +19,12 @@ limitations under the License.
 #include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
 #include "xla/stream_executor/gpu/gpu_driver.h"
 #include "xla/stream_executor/gpu/gpu_init.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/autotune_maps/autotune_map.pb.h"
 #include "tensorflow/core/util/autotune_maps/conv_autotune_maps.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.pb.h"
@@ -180,6 +184,65 @@ TEST(AutotuneSerializeTest, VersionControl) {
                HasSubstr("Aborted because the loaded autotune results")));
   EXPECT_EQ(ConvAutotuneMap::GetInstance()->GetMap().size(), 0);
 }
+
+// Tests that the database keeps the results of other environments, and only
+// loads the results of the current one.
+TEST(AutotuneSerializeTest, Database) {
+  TF_CHECK_OK(GpuDriver::Init());
+  ResetAutotuneMaps();
+  Env* env = Env::Default();
+  const std::string path =
+      io::JoinPath(testing::TmpDir(), "autotune_database.pb");
+  env->DeleteFile(path).IgnoreError();
+
+  // Results collected with another driver.
+  AutotuneDatabaseProto database;
+  AutotuneDatabaseProto::Entry* other = database.add_entries();
+  other->mutable_environment()->set_driver_version("other driver");
+  other->mutable_maps()->mutable_conv_map()->add_kv_pairs();
+  std::string serialized;
+  ASSERT_TRUE(database.SerializeToString(&serialized));
+  TF_ASSERT_OK(WriteStringToFile(env, path, serialized));
+
+  ConvParameters conv_params = {GetStreamExec(),
+                                /*batch=*/1,
+                                /*in_depths=*/1,
+                                /*in=*/{{1, 1}},
+                                /*data_format=*/TensorFormat::FORMAT_NCHW,
+                                /*out_depths=*/1,
+                                /*filter=*/{{1, 1}},
+                                /*dilation=*/{{1, 1}},
+                                /*stride=*/{{1, 1}},
+                                /*padding=*/{{1, 1}},
+                                /*dtype=*/DataType::DT_INT8,
+                                /*group_count=*/1};
+  AlgorithmDesc algorithm(/*algo_id=*/1, /*use_tensor_ops=*/true);
+  AutotuneEntry<se::dnn::ConvOp> example(algorithm, algorithm);
+  ConvAutotuneMap::GetInstance()->Insert(conv_params, example);
+  TF_ASSERT_OK(UpdateAutotuneDatabase(env, path));
+
+  TF_ASSERT_OK(ReadFileToString(env, path, &serialized));
+  ASSERT_TRUE(database.ParseFromString(serialized));
+  ASSERT_EQ(database.entries_size(), 2);
+  EXPECT_EQ(database.entries(0).environment().driver_version(),
+            "other driver");
+  AutotuneEnvironmentProto environment;
+  TF_ASSERT_OK(GetAutotuneEnvironment(&environment));
+  EXPECT_EQ(database.entries(1).environment().driver_version(),
+            environment.driver_version());
+  EXPECT_EQ(database.entries(1).maps().conv_map().kv_pairs_size(), 1);
+
+  ResetAutotuneMaps();
+  TF_ASSERT_OK(LoadAutotuneDatabase(env, path));
+  EXPECT_EQ(ConvAutotuneMap::GetInstance()->GetMap().size(), 1);
+  AutotuneEntry<se::dnn::ConvOp> entry;
+  EXPECT_TRUE(ConvAutotuneMap::GetInstance()->Find(conv_params, &entry));
+  EXPECT_EQ(entry, example);
+
+  // A missing database is not an error.
+  TF_EXPECT_OK(LoadAutotuneDatabase(
+      env, io::JoinPath(testing::TmpDir(), "missing_autotune_database.pb")));
+}
 }  // namespace
 }  // namespace tensorflow
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -0,0 +1,45 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// For Google-internal use only.
+//
+// This file defines the map data structure for storing autotuning results for
+// fused matmuls, so that they can be serialized with the convolution maps.
+
+#ifndef TENSORFLOW_CORE_UTIL_AUTOTUNE_MAPS_MATMUL_AUTOTUNE_MAPS_H_
+#define TENSORFLOW_CORE_UTIL_AUTOTUNE_MAPS_MATMUL_AUTOTUNE_MAPS_H_
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include <string>
+
+#include "tensorflow/core/kernels/gpu_utils.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/util/autotune_maps/conv_parameters.h"
+
+namespace tensorflow {
+
+// A dummy type to group fused matmul autotune results together.
+struct FusedMatmulAutotuneGroup {
+  static string name() { return "FusedMatmul"; }
+};
+
+using FusedMatmulAutotuneMap =
+    AutotuneSingleton<FusedMatmulAutotuneGroup, MatmulParameters,
+                      AutotuneEntry<se::dnn::FusedMatmulOp>>;
+
+}  // namespace tensorflow
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#endif  // TENSORFLOW_CORE_UTIL_AUTOTUNE_MAPS_MATMUL_AUTOTUNE_MAPS_H_
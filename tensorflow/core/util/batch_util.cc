@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/util/batch_util.h"
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 
 #include "tensorflow/core/framework/register_types.h"
@@ -54,16 +55,28 @@ Status HandleElementToSlice(const Tensor& /* element */, T* src, T* dest,
   return OkStatus();
 }
 
+// Copying a view copies the view, which can then outlive the element that
+// keeps its data alive, so views copied from elements are replaced with copies
+// of their data.
+void CopyDataOfViews(tstring* values, int64_t num_values) {
+  for (int64_t i = 0; i < num_values; ++i) {
+    if (values[i].type() == tstring::VIEW) {
+      values[i] = tstring(values[i].data(), values[i].size());
+    }
+  }
+}
+
 template <>
 Status HandleElementToSlice<tstring>(const Tensor& element, tstring* src,
                                      tstring* dest, int64_t num_values) {
   if (element.RefCountIsOne()) {
     for (int64_t i = 0; i < num_values; ++i) {
-      *dest++ = std::move(*src++);
+      dest[i] = std::move(src[i]);
     }
   } else {
     std::copy_n(src, num_values, dest);
   }
+  CopyDataOfViews(dest, num_values);
   return OkStatus();
 }
 
@@ -352,6 +365,11 @@ Status HandleElementToLargerSlice(const Tensor& element, Tensor* parent,
     slice_size[i] = element_t.dimension(i - 1);
   }
   parent_t.slice(slice_indices, slice_size) = element_t.reshape(slice_size);
+  if constexpr (std::is_same<T, tstring>::value) {
+    const int64_t num_values = parent->NumElements() / parent->dim_size(0);
+    CopyDataOfViews(parent->flat<tstring>().data() + index * num_values,
+                    num_values);
+  }
   return OkStatus();
 }
 
@@ -15,13 +15,18 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <utility>
 #include <vector>
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/numeric/bits.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -35,9 +40,10 @@ limitations under the License.
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/byte_order.h"
+#include "tensorflow/core/platform/hash.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
-#include "tensorflow/core/util/presized_cuckoo_map.h"
+#include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 
 namespace tensorflow {
@@ -117,6 +123,65 @@ constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
 
+// Returns the number of varints that end in data[0, size), i.e. the number of
+// bytes with the high bit clear, counting 8 bytes at a time.
+inline size_t CountVarints(const uint8* data, size_t size) {
+  constexpr uint64 kHighBits = 0x8080808080808080ull;
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64) <= size; i += sizeof(uint64)) {
+    uint64 word;
+    memcpy(&word, data + i, sizeof(word));
+    count += absl::popcount(~word & kHighBits);
+  }
+  for (; i < size; ++i) {
+    count += data[i] < 0x80;
+  }
+  return count;
+}
+
+// Decodes the varint at `p`, which must end before `end`. Returns the end of
+// the varint, or nullptr if it is longer than 10 bytes.
+inline const uint8* DecodeVarint64(const uint8* p, const uint8* end,
+                                   uint64* value) {
+  if (*p < 0x80) {
+    *value = *p;
+    return p + 1;
+  }
+  uint64 result = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    const uint8 byte = *p++;
+    result |= static_cast<uint64>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      *value = result;
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+// Appends the packed varints in data[0, size) to `int64_list`, which is resized
+// once. Like push_back(), writes past the end of a LimitedArraySlice only
+// change its EndDistance(). Returns false if the data is malformed.
+template <typename Result>
+bool DecodePackedVarints(const uint8* data, size_t size, Result* int64_list) {
+  const uint8* const end = data + size;
+  if (size > 0 && end[-1] >= 0x80) return false;  // Truncated last varint.
+  const size_t initial_size = int64_list->size();
+  const size_t num_values = CountVarints(data, size);
+  int64_list->resize(initial_size + num_values);
+  // `size()` may be less than requested for a LimitedArraySlice.
+  const size_t num_stored = int64_list->size() - initial_size;
+  int64_t* out = int64_list->data() + initial_size;
+  for (size_t i = 0; i < num_values; ++i) {
+    uint64 value;
+    data = DecodeVarint64(data, end, &value);
+    if (data == nullptr) return false;
+    if (i < num_stored) out[i] = static_cast<int64_t>(value);
+  }
+  return true;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -305,6 +370,18 @@ class Feature {
         if (!stream.ReadVarint32(&packed_length)) return false;
         auto packed_limit = stream.PushLimit(packed_length);
 
+        const void* packed_data;
+        int packed_size;
+        if (stream.GetDirectBufferPointer(&packed_data, &packed_size) &&
+            static_cast<uint32>(packed_size) >= packed_length) {
+          // All the values are in the buffer, so decode them directly into
+          // the result, sized once from the number of values.
+          if (!DecodePackedVarints(static_cast<const uint8*>(packed_data),
+                                   packed_length, int64_list)) {
+            return false;
+          }
+          if (!stream.Skip(packed_length)) return false;
+        }
         while (!stream.ExpectAtEnd()) {
           protobuf_uint64 n;  // There is no API for int64
           if (!stream.ReadVarint64(&n)) return false;
@@ -539,10 +616,179 @@ void ParallelFor(const std::function<void(size_t)>& f, size_t n,
   }
 }
 
-// Enumeration for distinguishing feature types.
-// Note: FastParseSequenceExample constructs a map that includes Type values,
-// and relies on the fact that they are default-initialized to Dense.
-enum class Type { Dense, Sparse, Ragged };
+}  // namespace
+
+// A perfect hash of the feature names of a config: each name is hashed to a
+// bucket, and each bucket has a displacement chosen so that the names in all
+// buckets map to distinct slots. Looking up a name hashes it once and compares
+// it with the single name in its slot.
+class FeatureNameIndex {
+ public:
+  // Enumeration for distinguishing feature types.
+  // Note: FastParseSequenceExample constructs a map that includes Type values,
+  // and relies on the fact that they are default-initialized to Dense.
+  enum class Type { Dense, Sparse, Ragged };
+
+  struct Entry {
+    tstring feature_name;
+    // Index of the feature in `Config::dense`, `::sparse` or `::ragged`.
+    size_t index;
+    Type type;
+  };
+
+  static StatusOr<std::shared_ptr<const FeatureNameIndex>> Build(
+      const Config& config) {
+    auto index = std::make_shared<FeatureNameIndex>();
+    index->num_dense_ = config.dense.size();
+    index->num_sparse_ = config.sparse.size();
+    index->num_ragged_ = config.ragged.size();
+    for (size_t d = 0; d < config.dense.size(); ++d) {
+      index->entries_.push_back({config.dense[d].feature_name, d, Type::Dense});
+    }
+    for (size_t d = 0; d < config.sparse.size(); ++d) {
+      index->entries_.push_back(
+          {config.sparse[d].feature_name, d, Type::Sparse});
+    }
+    for (size_t d = 0; d < config.ragged.size(); ++d) {
+      index->entries_.push_back(
+          {config.ragged[d].feature_name, d, Type::Ragged});
+    }
+    absl::flat_hash_set<StringPiece> feature_names;
+    for (const Entry& entry : index->entries_) {
+      if (!feature_names.insert(entry.feature_name).second) {
+        return errors::InvalidArgument("Duplicate feature name: ",
+                                       entry.feature_name);
+      }
+    }
+    for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+      if (index->TryBuild()) return index;
+      ++index->seed_;
+    }
+    return errors::Internal(
+        "Could not build a perfect hash of the feature names. This should not "
+        "happen.");
+  }
+
+  // Returns the entry of `feature_name`, or nullptr if it is not a feature of
+  // the config.
+  const Entry* Find(StringPiece feature_name) const {
+    if (entries_.empty()) return nullptr;
+    const uint64 h = Hash64(feature_name.data(), feature_name.size(), seed_);
+    const int32 e = slots_[Slot(h, displacements_[h & bucket_mask_])];
+    if (e < 0 || entries_[e].feature_name != feature_name) return nullptr;
+    return &entries_[e];
+  }
+
+  // Returns true if the index may have been built from `config`.
+  bool Matches(const Config& config) const {
+    return num_dense_ == config.dense.size() &&
+           num_sparse_ == config.sparse.size() &&
+           num_ragged_ == config.ragged.size();
+  }
+
+ private:
+  static constexpr int kMaxAttempts = 100;
+  static constexpr uint32 kMaxDisplacement = 1 << 16;
+
+  uint64 Slot(uint64 h, uint32 displacement) const {
+    return (((h >> 32) ^ (displacement * 0x9E3779B97F4A7C15ull)) *
+            0xFF51AFD7ED558CCDull) >>
+           slot_shift_;
+  }
+
+  // Tries to find displacements that map all names to distinct slots with the
+  // current seed.
+  bool TryBuild() {
+    // Use about 4 names per bucket and twice as many slots as names.
+    size_t num_buckets = 1;
+    while (num_buckets * 4 < entries_.size()) num_buckets *= 2;
+    int slot_bits = 1;
+    while ((size_t{1} << slot_bits) < 2 * entries_.size()) ++slot_bits;
+    bucket_mask_ = num_buckets - 1;
+    slot_shift_ = 64 - slot_bits;
+    displacements_.assign(num_buckets, 0);
+    slots_.assign(size_t{1} << slot_bits, -1);
+
+    std::vector<uint64> hashes(entries_.size());
+    std::vector<std::vector<int32>> buckets(num_buckets);
+    for (int32 e = 0; e < static_cast<int32>(entries_.size()); ++e) {
+      const tstring& name = entries_[e].feature_name;
+      hashes[e] = Hash64(name.data(), name.size(), seed_);
+      buckets[hashes[e] & bucket_mask_].push_back(e);
+    }
+    // Place the largest buckets first, while most slots are free.
+    std::vector<size_t> bucket_order(num_buckets);
+    std::iota(bucket_order.begin(), bucket_order.end(), 0);
+    std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                     [&buckets](size_t a, size_t b) {
+                       return buckets[a].size() > buckets[b].size();
+                     });
+    std::vector<uint64> bucket_slots;
+    for (size_t b : bucket_order) {
+      const std::vector<int32>& bucket = buckets[b];
+      if (bucket.empty()) break;
+      bool placed = false;
+      for (uint32 displacement = 0;
+           !placed && displacement < kMaxDisplacement; ++displacement) {
+        bucket_slots.clear();
+        placed = true;
+        for (int32 e : bucket) {
+          const uint64 slot = Slot(hashes[e], displacement);
+          if (slots_[slot] >= 0 ||
+              std::find(bucket_slots.begin(), bucket_slots.end(), slot) !=
+                  bucket_slots.end()) {
+            placed = false;
+            break;
+          }
+          bucket_slots.push_back(slot);
+        }
+        if (placed) {
+          displacements_[b] = displacement;
+          for (size_t i = 0; i < bucket.size(); ++i) {
+            slots_[bucket_slots[i]] = bucket[i];
+          }
+        }
+      }
+      if (!placed) return false;
+    }
+    return true;
+  }
+
+  std::vector<Entry> entries_;
+  size_t num_dense_ = 0;
+  size_t num_sparse_ = 0;
+  size_t num_ragged_ = 0;
+  uint64 seed_ = 0xDECAFCAFFE;
+  uint64 bucket_mask_ = 0;
+  int slot_shift_ = 63;
+  std::vector<uint32> displacements_;
+  // Index in `entries_` of the name in each slot, or -1 for empty slots.
+  std::vector<int32> slots_;
+};
+
+Status CompileFastParseExampleConfig(FastParseExampleConfig* config) {
+  TF_ASSIGN_OR_RETURN(config->feature_name_index,
+                      FeatureNameIndex::Build(*config));
+  return OkStatus();
+}
+
+namespace {
+
+using Type = FeatureNameIndex::Type;
+
+// Returns the index of the features of `config`, building one if the config
+// was not compiled.
+StatusOr<std::shared_ptr<const FeatureNameIndex>> GetFeatureNameIndex(
+    const Config& config) {
+  if (config.feature_name_index == nullptr) {
+    return FeatureNameIndex::Build(config);
+  }
+  if (!config.feature_name_index->Matches(config)) {
+    return errors::InvalidArgument(
+        "The features of the config changed since it was compiled.");
+  }
+  return config.feature_name_index;
+}
 
 // Note: We use SparseBuffer for sparse, ragged, and dense_varlen features.
 struct SparseBuffer {
@@ -558,13 +804,6 @@ struct SparseBuffer {
   std::vector<size_t> example_end_indices;
 };
 
-struct SeededHasher {
-  uint64 operator()(StringPiece s) const {
-    return Hash64(s.data(), s.size(), seed);
-  }
-  uint64 seed{0xDECAFCAFFE};
-};
-
 void LogDenseFeatureDataLoss(StringPiece feature_name) {
   LOG(WARNING) << "Data loss! Feature '" << feature_name
                << "' is present in multiple concatenated "
@@ -590,8 +829,8 @@ void LogSparseFeatureDataLoss(StringPiece feature_name) {
 Status FastParseSerializedExample(
     const tstring& serialized_example, const tstring& example_name,
     const size_t example_index, const Config& config,
-    const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
-    SeededHasher hasher, std::vector<Tensor>* output_dense,
+    const FeatureNameIndex& feature_name_index,
+    std::vector<Tensor>* output_dense,
     std::vector<SparseBuffer>* output_varlen_dense,
     std::vector<SparseBuffer>* output_sparse,
     std::vector<SparseBuffer>* output_ragged,
@@ -627,23 +866,13 @@ Status FastParseSerializedExample(
     const StringPiece feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    const FeatureNameIndex::Entry* entry =
+        feature_name_index.Find(feature_name);
+    if (entry == nullptr) continue;
 
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
-    bool is_ragged = d_and_type.second == Type::Ragged;
-
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_ragged ? config.ragged[d].feature_name
-                                : config.sparse[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
+    size_t d = entry->index;
+    bool is_dense = entry->type == Type::Dense;
+    bool is_ragged = entry->type == Type::Ragged;
 
     auto example_error = [&](StringPiece suffix) {
       return errors::InvalidArgument("Name: ", example_name,
@@ -1143,36 +1372,9 @@ Status FastParseExample(const Config& config,
     result->feature_stats.resize(serialized.size());
   }
 
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return errors::Internal(
-        "Could not avoid collision. This should not happen.");
-  }
+  TF_ASSIGN_OR_RETURN(
+      std::shared_ptr<const FeatureNameIndex> feature_name_index,
+      GetFeatureNameIndex(config));
 
   // Allocate dense output for fixed length dense values
   // (variable-length dense and sparse and ragged have to be buffered).
@@ -1243,7 +1445,7 @@ Status FastParseExample(const Config& config,
       status_of_minibatch[minibatch] = FastParseSerializedExample(
           serialized[e],
           (!example_names.empty() ? example_names[e] : "<unknown>"), e, config,
-          config_index, hasher, &fixed_dense_values,
+          *feature_name_index, &fixed_dense_values,
           &varlen_dense_buffers[minibatch], &sparse_buffers[minibatch],
           &ragged_buffers[minibatch], stats);
       if (!status_of_minibatch[minibatch].ok()) break;
@@ -1457,37 +1659,9 @@ Status FastParseSingleExample(const Config& config, StringPiece serialized,
     stats = &result->feature_stats.back();
   }
 
-  // TODO(mrry): Cache the construction of this map at Op construction time.
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return errors::Internal(
-        "Could not avoid collision. This should not happen.");
-  }
+  TF_ASSIGN_OR_RETURN(
+      std::shared_ptr<const FeatureNameIndex> feature_name_index,
+      GetFeatureNameIndex(config));
 
   result->sparse_indices.reserve(config.sparse.size());
   result->sparse_values.reserve(config.sparse.size());
@@ -1556,23 +1730,13 @@ Status FastParseSingleExample(const Config& config, StringPiece serialized,
     const StringPiece feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    const FeatureNameIndex::Entry* entry =
+        feature_name_index->Find(feature_name);
+    if (entry == nullptr) continue;
 
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
-    bool is_sparse = d_and_type.second == Type::Sparse;
-
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_sparse ? config.sparse[d].feature_name
-                                : config.ragged[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
+    size_t d = entry->index;
+    bool is_dense = entry->type == Type::Dense;
+    bool is_sparse = entry->type == Type::Sparse;
 
     auto example_error = [feature_name](StringPiece suffix) {
       return errors::InvalidArgument("Key: ", feature_name, ".  ", suffix);
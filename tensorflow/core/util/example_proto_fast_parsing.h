@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_EXAMPLE_PROTO_FAST_PARSING_H_
 #define TENSORFLOW_CORE_UTIL_EXAMPLE_PROTO_FAST_PARSING_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -35,6 +36,9 @@ limitations under the License.
 namespace tensorflow {
 namespace example {
 
+// Index from the feature names of a FastParseExampleConfig to the features.
+class FeatureNameIndex;
+
 // FastParseExampleConfig defines how to parse features in Example.
 // Each sub-config is responsible for one feature identified with feature_name.
 // FastParseExampleConfig can't have two sub-configs with the same feature_name.
@@ -96,8 +100,19 @@ struct FastParseExampleConfig {
   // If `true`, `Result::feature_stats` will contain one
   // `PerExampleFeatureStats` for each serialized example in the input.
   bool collect_feature_stats = false;
+
+  // If set by CompileFastParseExampleConfig(), `FastParse[Single]Example()`
+  // look up the features of each example in this index instead of building
+  // one on every call.
+  std::shared_ptr<const FeatureNameIndex> feature_name_index;
 };
 
+// Compiles `config` for parsing many batches: builds a perfect hash of its
+// feature names into `config->feature_name_index`. Must be called again after
+// the features of `config` change. Returns an error if a feature name appears
+// more than once.
+Status CompileFastParseExampleConfig(FastParseExampleConfig* config);
+
 // Statistics about the features in each example passed to
 // `FastParse[Single]Example()`.
 //
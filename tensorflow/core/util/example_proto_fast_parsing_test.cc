@@ -15,12 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
+#include <limits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/protobuf.h"
@@ -327,6 +329,94 @@ TEST(FastParse, StatsCollection) {
   }
 }
 
+TEST(FastParse, PackedLargeAndNegativeInt64) {
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["int64_list"]
+          .mutable_int64_list();
+  for (int64_t value : {int64_t{0}, int64_t{-1}, int64_t{127}, int64_t{128},
+                        int64_t{86942}, std::numeric_limits<int64_t>::max(),
+                        std::numeric_limits<int64_t>::min(), int64_t{1} << 35,
+                        int64_t{-300}}) {
+    int64_list->add_value(value);
+  }
+  TestCorrectness(Serialize(example));
+
+  const std::vector<tstring> serialized = {Serialize(example)};
+  FastParseExampleConfig config;
+  AddDenseFeature("int64_list", DT_INT64, {9}, false, 9, &config);
+  Result result;
+  TF_ASSERT_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  ASSERT_EQ(1, result.dense_values.size());
+  auto values = result.dense_values[0].flat<int64_t>();
+  ASSERT_EQ(int64_list->value_size(), values.size());
+  for (int i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(int64_list->value(i), values(i));
+  }
+
+  // A fixed-length feature with too many values is still rejected.
+  config.dense[0].shape = PartialTensorShape({3});
+  config.dense[0].elements_per_stride = 3;
+  EXPECT_FALSE(FastParseExample(config, serialized, {}, nullptr, &result).ok());
+}
+
+TEST(FastParse, CompiledConfig) {
+  std::vector<tstring> serialized(3, ExampleWithSomeFeatures());
+
+  FastParseExampleConfig config;
+  AddDenseFeature("bytes_list", DT_STRING, {2}, false, 2, &config);
+  AddDenseFeature("int64_list", DT_INT64, {-1}, true, 1, &config);
+  AddSparseFeature("float_list", DT_FLOAT, &config);
+  AddSparseFeature("missing", DT_INT64, &config);
+
+  FastParseExampleConfig compiled_config = config;
+  TF_ASSERT_OK(CompileFastParseExampleConfig(&compiled_config));
+  EXPECT_NE(nullptr, compiled_config.feature_name_index);
+
+  Result result;
+  Result compiled_result;
+  TF_ASSERT_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  TF_ASSERT_OK(FastParseExample(compiled_config, serialized, {}, nullptr,
+                                &compiled_result));
+  ASSERT_EQ(result.dense_values.size(), compiled_result.dense_values.size());
+  for (int i = 0; i < result.dense_values.size(); ++i) {
+    EXPECT_EQ(result.dense_values[i].DebugString(/*num_values=*/-1),
+              compiled_result.dense_values[i].DebugString(-1));
+  }
+  ASSERT_EQ(result.sparse_values.size(), compiled_result.sparse_values.size());
+  for (int i = 0; i < result.sparse_values.size(); ++i) {
+    EXPECT_EQ(result.sparse_values[i].DebugString(-1),
+              compiled_result.sparse_values[i].DebugString(-1));
+    EXPECT_EQ(result.sparse_indices[i].DebugString(-1),
+              compiled_result.sparse_indices[i].DebugString(-1));
+  }
+
+  Result single_result;
+  TF_ASSERT_OK(
+      FastParseSingleExample(compiled_config, serialized[0], &single_result));
+  ASSERT_EQ(2, single_result.dense_values.size());
+  EXPECT_EQ(3, single_result.dense_values[1].NumElements());
+}
+
+TEST(FastParse, CompileConfigWithDuplicateName) {
+  FastParseExampleConfig config;
+  AddDenseFeature("int64_list", DT_INT64, {-1}, true, 1, &config);
+  AddSparseFeature("int64_list", DT_INT64, &config);
+  EXPECT_TRUE(
+      errors::IsInvalidArgument(CompileFastParseExampleConfig(&config)));
+}
+
+TEST(FastParse, ConfigChangedAfterCompile) {
+  FastParseExampleConfig config;
+  AddDenseFeature("int64_list", DT_INT64, {-1}, true, 1, &config);
+  TF_ASSERT_OK(CompileFastParseExampleConfig(&config));
+  AddSparseFeature("float_list", DT_FLOAT, &config);
+  const std::vector<tstring> serialized = {ExampleWithSomeFeatures()};
+  Result result;
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      FastParseExample(config, serialized, {}, nullptr, &result)));
+}
+
 string RandStr(random::SimplePhilox* rng) {
   static const char key_char_lookup[] =
       "0123456789{}~`!@#$%^&*()"
@@ -14,13 +14,20 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/util/memmapped_file_system.h"
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/util/memmapped_file_system.pb.h"
 
@@ -36,6 +43,21 @@ uint64 DecodeUint64LittleEndian(const uint8* buffer) {
   return result;
 }
 
+// Pages are touched at this stride. Touching more often than the real page
+// size is harmless.
+constexpr uint64 kPretouchStride = 4096;
+
+// Passes "advice" for the mapping to the kernel where supported. Failures
+// are ignored, since the region may not be mmapped by every Env.
+void AdviseMemory(const void* data, uint64 length, int advice) {
+#if defined(__linux__)
+  if (madvise(const_cast<void*>(data), length, advice) != 0) {
+    VLOG(1) << "madvise(" << advice << ") failed for the memmapped package: "
+            << strerror(errno);
+  }
+#endif
+}
+
 }  // namespace
 
 namespace {
@@ -91,6 +113,8 @@ class RandomAccessFileFromMemmapped : public RandomAccessFile {
 
 MemmappedFileSystem::MemmappedFileSystem() = default;
 
+MemmappedFileSystem::~MemmappedFileSystem() { StopWarmup(); }
+
 Status MemmappedFileSystem::FileExists(const string& fname,
                                        TransactionToken* token) {
   if (!mapped_memory_) {
@@ -213,6 +237,7 @@ constexpr const char MemmappedFileSystem::kMemmappedPackageDefaultGraphDef[];
 
 Status MemmappedFileSystem::InitializeFromFile(Env* env,
                                                const string& filename) {
+  StopWarmup();
   TF_RETURN_IF_ERROR(
       env->NewReadOnlyMemoryRegionFromFile(filename, &mapped_memory_));
   directory_.clear();
@@ -259,6 +284,66 @@ Status MemmappedFileSystem::InitializeFromFile(Env* env,
   return OkStatus();
 }
 
+Status MemmappedFileSystem::InitializeFromFile(Env* env,
+                                               const string& filename,
+                                               const WarmupOptions& options) {
+  TF_RETURN_IF_ERROR(InitializeFromFile(env, filename));
+  return Warmup(env, options);
+}
+
+Status MemmappedFileSystem::Warmup(Env* env, const WarmupOptions& options) {
+  if (!mapped_memory_) {
+    return errors::FailedPrecondition("MemmappedEnv is not initialized");
+  }
+  StopWarmup();
+#if defined(__linux__)
+  if (options.huge_pages) {
+    AdviseMemory(mapped_memory_->data(), mapped_memory_->length(),
+                 MADV_HUGEPAGE);
+  }
+  if (options.prefetch) {
+    AdviseMemory(mapped_memory_->data(), mapped_memory_->length(),
+                 MADV_WILLNEED);
+  }
+#endif
+  if (!options.pretouch) {
+    return OkStatus();
+  }
+  if (!options.background) {
+    PretouchPages(options.numa_node);
+    return OkStatus();
+  }
+  const int numa_node = options.numa_node;
+  warmup_thread_.reset(env->StartThread(
+      ThreadOptions(), "TF_memmapped_warmup",
+      [this, numa_node]() { PretouchPages(numa_node); }));
+  return OkStatus();
+}
+
+void MemmappedFileSystem::PretouchPages(int numa_node) {
+  if (numa_node != port::kNUMANoAffinity && port::NUMAEnabled()) {
+    port::NUMASetThreadNodeAffinity(numa_node);
+  }
+  const volatile uint8* data =
+      reinterpret_cast<const volatile uint8*>(mapped_memory_->data());
+  const uint64 length = mapped_memory_->length();
+  uint8 sum = 0;
+  for (uint64 offset = 0; offset < length; offset += kPretouchStride) {
+    if (cancel_warmup_.load(std::memory_order_relaxed)) break;
+    sum += data[offset];
+  }
+  VLOG(2) << "Pre-touched the memmapped package, checksum "
+          << static_cast<int>(sum);
+}
+
+void MemmappedFileSystem::StopWarmup() {
+  if (!warmup_thread_) return;
+  cancel_warmup_.store(true, std::memory_order_relaxed);
+  // Deleting the thread joins it.
+  warmup_thread_.reset();
+  cancel_warmup_.store(false, std::memory_order_relaxed);
+}
+
 bool MemmappedFileSystem::IsMemmappedPackageFilename(const string& filename) {
   return absl::StartsWith(filename, kMemmappedPackagePrefix);
 }
@@ -310,9 +395,16 @@ Status MemmappedEnv::GetRegisteredFileSystemSchemes(
 }
 
 Status MemmappedEnv::InitializeFromFile(const string& package_filename) {
+  return InitializeFromFile(package_filename,
+                            MemmappedFileSystem::WarmupOptions());
+}
+
+Status MemmappedEnv::InitializeFromFile(
+    const string& package_filename,
+    const MemmappedFileSystem::WarmupOptions& options) {
   std::unique_ptr<MemmappedFileSystem> file_system_ptr(new MemmappedFileSystem);
   const auto status =
-      file_system_ptr->InitializeFromFile(target(), package_filename);
+      file_system_ptr->InitializeFromFile(target(), package_filename, options);
   if (status.ok()) {
     memmapped_file_system_ = std::move(file_system_ptr);
   }
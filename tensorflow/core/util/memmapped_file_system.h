@@ -16,12 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_MEMMAPPED_FILE_SYSTEM_H_
 #define TENSORFLOW_CORE_UTIL_MEMMAPPED_FILE_SYSTEM_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/numa.h"
 
 namespace tensorflow {
 
@@ -59,8 +61,27 @@ class MemmappedFileSystem : public FileSystem {
   static constexpr const char kMemmappedPackageDefaultGraphDef[] =
       "memmapped_package://.";
 
+  // Controls how the pages of a package are brought into memory, so that the
+  // first requests using the constants don't pay for the page faults.
+  struct WarmupOptions {
+    // Asks the kernel to start reading the whole package ahead.
+    bool prefetch = false;
+    // Reads one byte of every page of the package, so that all pages are
+    // resident and mapped before the first use.
+    bool pretouch = false;
+    // Pre-touches the pages from a background thread instead of blocking
+    // InitializeFromFile.
+    bool background = false;
+    // Asks the kernel to back the mapping with transparent huge pages. This is
+    // only advice, and is ignored where not supported.
+    bool huge_pages = false;
+    // NUMA node of the thread pre-touching the pages. Under the default first
+    // touch policy this places the pages on that node.
+    int numa_node = port::kNUMANoAffinity;
+  };
+
   MemmappedFileSystem();
-  ~MemmappedFileSystem() override = default;
+  ~MemmappedFileSystem() override;
 
   TF_USE_FILESYSTEM_METHODS_WITH_NO_TRANSACTION_SUPPORT;
 
@@ -97,6 +118,12 @@ class MemmappedFileSystem : public FileSystem {
 
   // Initializes filesystem from a file in memmapped format.
   Status InitializeFromFile(Env* env, const string& filename);
+  Status InitializeFromFile(Env* env, const string& filename,
+                            const WarmupOptions& options);
+
+  // Applies "options" to the already mapped package. A background pre-touch
+  // started by a previous call is stopped first.
+  Status Warmup(Env* env, const WarmupOptions& options);
 
   // Checks if the filename has a correct prefix.
   static bool IsMemmappedPackageFilename(const string& filename);
@@ -115,8 +142,16 @@ class MemmappedFileSystem : public FileSystem {
 
   const void* GetMemoryWithOffset(uint64 offset) const;
 
+  // Touches the pages of the package until done or cancelled.
+  void PretouchPages(int numa_node);
+  void StopWarmup();
+
   std::unique_ptr<ReadOnlyMemoryRegion> mapped_memory_;
   DirectoryType directory_;
+  // Declared after mapped_memory_, so that the thread is joined before the
+  // package is unmapped.
+  std::atomic<bool> cancel_warmup_{false};
+  std::unique_ptr<Thread> warmup_thread_;
 
   MemmappedFileSystem(const MemmappedFileSystem&) = delete;
   void operator=(const MemmappedFileSystem&) = delete;
@@ -130,6 +165,9 @@ class MemmappedEnv : public EnvWrapper {
                               FileSystem** result) override;
   Status GetRegisteredFileSystemSchemes(std::vector<string>* schemes) override;
   Status InitializeFromFile(const string& filename);
+  Status InitializeFromFile(
+      const string& filename,
+      const MemmappedFileSystem::WarmupOptions& options);
 
  protected:
   std::unique_ptr<MemmappedFileSystem> memmapped_file_system_;
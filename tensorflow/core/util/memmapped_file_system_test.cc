@@ -116,6 +116,40 @@ TEST(MemmappedFileSystemTest, SimpleTest) {
             memmapped_env.FileExists("bla-bla-bla").code());
 }
 
+TEST(MemmappedFileSystemTest, Warmup) {
+  Tensor test_tensor(DT_FLOAT, {100, 200});
+  const string filename =
+      io::JoinPath(testing::TmpDir(), "memmapped_env_warmup_test");
+  TF_ASSERT_OK(CreateMemmappedFileSystemFile(filename, false, &test_tensor));
+
+  MemmappedFileSystem::WarmupOptions options;
+  options.prefetch = true;
+  options.pretouch = true;
+  options.huge_pages = true;
+  MemmappedEnv memmapped_env(Env::Default());
+  TF_ASSERT_OK(memmapped_env.InitializeFromFile(filename, options));
+  std::unique_ptr<ReadOnlyMemoryRegion> memory_region;
+  TF_ASSERT_OK(memmapped_env.NewReadOnlyMemoryRegionFromFile(kTensor2FileName,
+                                                             &memory_region));
+  EXPECT_EQ(test_tensor.tensor_data(),
+            StringPiece(static_cast<const char*>(memory_region->data()),
+                        test_tensor.TotalBytes()));
+
+  // The file system can be destroyed or reinitialized while pre-touching in
+  // the background.
+  options.background = true;
+  MemmappedFileSystem memmapped_file_system;
+  TF_ASSERT_OK(memmapped_file_system.InitializeFromFile(Env::Default(),
+                                                        filename, options));
+  TF_ASSERT_OK(memmapped_file_system.InitializeFromFile(Env::Default(),
+                                                        filename, options));
+  TF_EXPECT_OK(memmapped_file_system.FileExists(kTensor2FileName, nullptr));
+
+  MemmappedFileSystem uninitialized;
+  EXPECT_EQ(error::FAILED_PRECONDITION,
+            uninitialized.Warmup(Env::Default(), options).code());
+}
+
 TEST(MemmappedFileSystemTest, NotInitialized) {
   MemmappedEnv memmapped_env(Env::Default());
   std::unique_ptr<ReadOnlyMemoryRegion> memory_region;
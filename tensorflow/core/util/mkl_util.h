@@ -1868,10 +1868,10 @@ class LRUCache {
       return nullptr;
     }
 
-    // Move to the front of LRU list as the most recently accessed.
-    lru_list_.erase(it->second.lru_iterator);
-    lru_list_.push_front(it->first);
-    it->second.lru_iterator = lru_list_.begin();
+    // Move to the front of LRU list as the most recently accessed. Splicing
+    // relinks the existing node, so a cache hit neither allocates nor copies
+    // the key, and the entry's iterator stays valid.
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second.lru_iterator);
     return it->second.op;
   }
 
@@ -2069,7 +2069,10 @@ class MklPrimitiveFactory {
 
  private:
   static inline LRUCache<MklPrimitive>& GetLRUCache() {
-    static const int kCapacity = 1024;  // cache capacity
+    // Cache capacity, configurable with TF_ONEDNN_PRIMITIVE_CACHE_CAPACITY.
+    // The cache is per thread, so serving processes with many inter-op threads
+    // may want a smaller bound to limit the memory held by cached primitives.
+    static const size_t kCapacity = PrimitiveCacheCapacity();
 #if !defined(DNNL_AARCH64_USE_ACL) || !defined(ENABLE_ONEDNN_OPENMP)
     static thread_local LRUCache<MklPrimitive> lru_cache_(kCapacity);
 #else
@@ -120,6 +120,30 @@ TEST(MklUtilTest, LRUCacheTest) {
   }
 }
 
+TEST(MklUtilTest, LRUCacheGetOpRefreshesRecency) {
+  LRUCache<int> lru_cache(3);
+  lru_cache.SetOp("0", new int(0));
+  lru_cache.SetOp("1", new int(1));
+  lru_cache.SetOp("2", new int(2));
+
+  // Accessing "0" makes "1" the least recently accessed object.
+  ASSERT_NE(nullptr, lru_cache.GetOp("0"));
+  lru_cache.SetOp("3", new int(3));
+  EXPECT_EQ(nullptr, lru_cache.GetOp("1"));
+
+  // Repeated hits keep returning the same object.
+  for (int i = 0; i < 3; ++i) {
+    int* int_ptr = lru_cache.GetOp("0");
+    ASSERT_NE(nullptr, int_ptr);
+    EXPECT_EQ(0, *int_ptr);
+  }
+  lru_cache.SetOp("4", new int(4));
+  EXPECT_EQ(nullptr, lru_cache.GetOp("2"));
+  EXPECT_NE(nullptr, lru_cache.GetOp("0"));
+  EXPECT_NE(nullptr, lru_cache.GetOp("3"));
+  EXPECT_NE(nullptr, lru_cache.GetOp("4"));
+}
+
 }  // namespace
 }  // namespace tensorflow
 
@@ -63,5 +63,16 @@ std::string FPMathModeSetting() {
 
   return math_mode_setting;
 }
+
+int64_t PrimitiveCacheCapacity() {
+  static int64_t capacity = 1024;
+  static absl::once_flag once;
+  absl::call_once(once, [&] {
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_ONEDNN_PRIMITIVE_CACHE_CAPACITY",
+                                    /*default_val*/ 1024, &capacity));
+    if (capacity < 1) capacity = 1;
+  });
+  return capacity;
+}
 }  // namespace tensorflow
 #endif  // INTEL_MKL
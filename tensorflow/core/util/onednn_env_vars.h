@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_UTIL_ONEDNN_ENV_VARS_H_
 #ifdef INTEL_MKL
 
+#include <cstdint>
 #include <string>
 
 namespace tensorflow {
@@ -28,6 +29,10 @@ bool UseSystemAlloc();
 bool ThreadPoolUseCallerThread();
 
 std::string FPMathModeSetting();
+
+// Returns the number of oneDNN primitives each primitive cache holds before
+// evicting the least recently used one.
+int64_t PrimitiveCacheCapacity();
 }  // namespace tensorflow
 #endif  // INTEL_MKL
 #endif  // TENSORFLOW_CORE_UTIL_ONEDNN_ENV_VARS_H_
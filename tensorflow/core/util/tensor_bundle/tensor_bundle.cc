@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -422,6 +423,34 @@ Status PadAlignment(tsl::BufferedWritableFile* out, int alignment,
   return status;
 }
 
+// A read-only buffer in a memory mapped data file, which is kept mapped for
+// as long as a tensor uses the buffer. It does not own its memory, so that
+// variables copy it before updating it in place.
+class MappedDataTensorBuffer : public TensorBuffer {
+ public:
+  MappedDataTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                         const void* data, size_t size)
+      : TensorBuffer(const_cast<void*>(data)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name("MappedTensorBundle");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
 }  // namespace
 
 BundleWriter::BundleWriter(Env* env, StringPiece prefix, const Options& options)
@@ -1024,6 +1053,57 @@ Status BundleReader::Lookup(StringPiece key, Tensor* val) {
   }
 }
 
+Status BundleReader::LookupMapped(StringPiece key, Tensor* val) {
+  CHECK(val != nullptr);
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  const TensorShape shape(entry.shape());
+  auto lookup_copy = [&]() {
+    *val = Tensor(entry.dtype(), shape);
+    if (entry.slices().empty()) return GetValue(entry, val);
+    return GetSliceValue(key, entry, TensorSlice(shape.dims()), val);
+  };
+  if (!entry.slices().empty() || !DataTypeCanUseMemcpy(entry.dtype()) ||
+      need_to_swap_bytes_ || entry.size() == 0) {
+    return lookup_copy();
+  }
+
+  const size_t expected_size =
+      shape.num_elements() * DataTypeSize(entry.dtype());
+  if (entry.size() != expected_size) {
+    return errors::DataLoss("Invalid size in bundle entry: key ", key,
+                            "; stored size ", entry.size(),
+                            "; expected size ", expected_size);
+  }
+  std::shared_ptr<ReadOnlyMemoryRegion>& region =
+      mapped_data_[entry.shard_id()];
+  if (region == nullptr) {
+    std::unique_ptr<ReadOnlyMemoryRegion> new_region;
+    Status s = env_->NewReadOnlyMemoryRegionFromFile(
+        DataFilename(prefix_, entry.shard_id(), num_shards_), &new_region);
+    if (errors::IsUnimplemented(s)) {
+      mapped_data_.erase(entry.shard_id());
+      return lookup_copy();
+    }
+    TF_RETURN_IF_ERROR(s);
+    region = std::move(new_region);
+  }
+  if (entry.offset() < 0 || entry.offset() + entry.size() > region->length()) {
+    return errors::DataLoss("TensorBundle at ", prefix_, " shard ",
+                            entry.shard_id(), " is too short for key ", key,
+                            " at offset ", entry.offset(), " of ",
+                            entry.size(), " bytes");
+  }
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+  if (reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    return lookup_copy();
+  }
+  auto* buffer = new MappedDataTensorBuffer(region, data, entry.size());
+  *val = Tensor(entry.dtype(), shape, buffer);
+  buffer->Unref();
+  return OkStatus();
+}
+
 Status BundleReader::ReadCurrent(Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1198,6 +1278,15 @@ Status BundleReader::LookupTensorShape(StringPiece key, TensorShape* shape) {
   return LookupDtypeAndShape(key, &ignored, shape);
 }
 
+Status BundleReader::LookupDataLocation(StringPiece key, int32_t* shard_id,
+                                        int64_t* size) {
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  *shard_id = entry.shard_id();
+  *size = entry.slices().empty() ? entry.size() : 0;
+  return OkStatus();
+}
+
 string BundleReader::DebugString() {
   // Format used below emulates that of TensorSliceReader::DebugString().
   string shape_str;
@@ -237,6 +237,13 @@ class BundleReader {
   Status LookupTensorShape(absl::string_view key,
                            TensorShape* shape) TF_MUST_USE_RESULT;
 
+  // Looks up the data file shard and the stored size in bytes of the tensor
+  // keyed by "key". A partitioned tensor stores its slices under other keys,
+  // so its size is 0.
+  // REQUIRES: status().ok()
+  Status LookupDataLocation(absl::string_view key, int32_t* shard_id,
+                            int64_t* size) TF_MUST_USE_RESULT;
+
   // Looks up the tensor keyed by "key".  If "key" refers to a partitioned
   // tensor, attempts to look up the full contents using all stored slices.
   //
@@ -251,6 +258,20 @@ class BundleReader {
   // REQUIRES: status().ok()
   Status Lookup(absl::string_view key, Tensor* val) TF_MUST_USE_RESULT;
 
+  // Like "Lookup()", but sets "val" to a read-only tensor backed by a memory
+  // mapping of the data file, so that its pages are only read when they are
+  // first used. "val" is allocated by this method, and keeps the mapping alive
+  // after this reader is destroyed.
+  //
+  // Falls back to a copy for partitioned tensors, for dtypes that cannot be
+  // memcpy-ed, for bundles of a different endianness, for data that is not
+  // aligned for Eigen, and for file systems that cannot map files.
+  //
+  // Does not validate the crc32c checksum of mapped tensors, since that would
+  // read all of their pages.
+  // REQUIRES: status().ok()
+  Status LookupMapped(absl::string_view key, Tensor* val) TF_MUST_USE_RESULT;
+
   // Looks up the tensor pointed to by the internal iterator.
   //
   // On error, "val" may contain nonsense data.
@@ -327,6 +348,9 @@ class BundleReader {
   table::Iterator* iter_;
   // Owned the InputBuffer objects and their underlying RandomAccessFile's.
   std::unordered_map<int32_t, io::InputBuffer*> data_;
+  // The memory mappings of the data files used by "LookupMapped()".
+  std::unordered_map<int32_t, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
 
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
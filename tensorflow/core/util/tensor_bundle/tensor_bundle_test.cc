@@ -648,6 +648,45 @@ TEST(TensorBundleTest, PartitionedVariables) {
   }
 }
 
+TEST(TensorBundleTest, LookupMapped) {
+  const TensorShape kFullShape({5, 10});
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(Env::Default(), Prefix("mapped"), opts);
+    TF_ASSERT_OK(writer.Add("float", Constant_100x100<float>(1.5)));
+    TF_ASSERT_OK(writer.Add("int", Constant_2x3<int32>(7)));
+    TF_ASSERT_OK(writer.Add("string", Constant_2x3<tstring>("foo")));
+    TF_ASSERT_OK(writer.AddSlice("sliced", kFullShape,
+                                 TensorSlice::ParseOrDie("-:-"),
+                                 Constant<float>(2., kFullShape)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  Tensor float_val;
+  Tensor int_val;
+  Tensor string_val;
+  Tensor sliced_val;
+  {
+    BundleReader reader(Env::Default(), Prefix("mapped"));
+    TF_ASSERT_OK(reader.status());
+    TF_ASSERT_OK(reader.LookupMapped("float", &float_val));
+    TF_ASSERT_OK(reader.LookupMapped("int", &int_val));
+    TF_ASSERT_OK(reader.LookupMapped("string", &string_val));
+    TF_ASSERT_OK(reader.LookupMapped("sliced", &sliced_val));
+    EXPECT_TRUE(errors::IsNotFound(reader.LookupMapped("missing", &int_val)));
+  }
+  // The mapped tensors outlive the reader, and are not updated in place.
+  test::ExpectTensorEqual<float>(float_val, Constant_100x100<float>(1.5));
+  EXPECT_FALSE(float_val.RefCountIsOne());
+  test::ExpectTensorEqual<int32>(int_val, Constant_2x3<int32>(7));
+  EXPECT_FALSE(int_val.RefCountIsOne());
+  // Strings and partitioned tensors are copied.
+  test::ExpectTensorEqual<tstring>(string_val, Constant_2x3<tstring>("foo"));
+  EXPECT_TRUE(string_val.RefCountIsOne());
+  test::ExpectTensorEqual<float>(sliced_val, Constant<float>(2., kFullShape));
+  EXPECT_TRUE(sliced_val.RefCountIsOne());
+}
+
 TEST(TensorBundleTest, EquivalentSliceTest) {
   const TensorShape kFullShape({5, 10});
   const Tensor kExpected(Constant<float>(1., kFullShape));
@@ -16,10 +16,20 @@ limitations under the License.
 #include "tensorflow/core/util/work_sharder.h"
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/platform/abi.h"
 #include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tsl/profiler/lib/traceme.h"
 #include "tsl/util/env_var.h"
 
@@ -43,8 +53,124 @@ bool UseEigenParallelFor() {
   return result;
 }
 
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
+#define TF_WORK_SHARDER_HAS_RTTI 1
+#endif
+
+std::atomic<bool>& AdaptiveShardingEnabled() {
+  static std::atomic<bool>* enabled = []() {
+    bool result = false;
+    if (!tsl::ReadBoolFromEnvVar("TF_WORK_SHARDER_ADAPTIVE_COST",
+                                 /*default_val=*/false, &result)
+             .ok()) {
+      result = false;
+    }
+    return new std::atomic<bool>(result);
+  }();
+  return *enabled;
+}
+
+// Measurements of a single Shard() call site. The fields are updated without
+// a lock; a lost update merely delays convergence.
+struct CallSiteCost {
+  explicit CallSiteCost(std::string name) : call_site(std::move(name)) {}
+
+  const std::string call_site;
+  std::atomic<int64_t> num_calls{0};
+  std::atomic<int64_t> cost_per_unit_hint{0};
+  // Moving average of the measured nanoseconds per unit of work; 0 until the
+  // first measurement.
+  std::atomic<int64_t> measured_cost_per_unit{0};
+
+  void Record(int64_t total, int64_t nanos) {
+    const int64_t cost = std::max<int64_t>(1, nanos / total);
+    const int64_t previous =
+        measured_cost_per_unit.load(std::memory_order_relaxed);
+    // Weigh the new measurement by 1/4 so a single outlier (e.g. a descheduled
+    // shard) does not swing the estimate, while still tracking real changes
+    // within a handful of calls.
+    measured_cost_per_unit.store(
+        previous == 0 ? cost : previous + (cost - previous) / 4,
+        std::memory_order_relaxed);
+    num_calls.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+class CallSiteCostRegistry {
+ public:
+  static CallSiteCostRegistry* Global() {
+    static CallSiteCostRegistry* registry = new CallSiteCostRegistry;
+    return registry;
+  }
+
+  CallSiteCost* Get(std::type_index key) {
+    {
+      tf_shared_lock l(mu_);
+      auto it = costs_.find(key);
+      if (it != costs_.end()) return it->second.get();
+    }
+    mutex_lock l(mu_);
+    auto& cost = costs_[key];
+    if (cost == nullptr) {
+      cost = std::make_unique<CallSiteCost>(port::MaybeAbiDemangle(key.name()));
+    }
+    return cost.get();
+  }
+
+  std::vector<AdaptiveShardStats> Stats() {
+    std::vector<AdaptiveShardStats> stats;
+    tf_shared_lock l(mu_);
+    stats.reserve(costs_.size());
+    for (const auto& [key, cost] : costs_) {
+      AdaptiveShardStats s;
+      s.call_site = cost->call_site;
+      s.num_calls = cost->num_calls.load(std::memory_order_relaxed);
+      s.cost_per_unit_hint =
+          cost->cost_per_unit_hint.load(std::memory_order_relaxed);
+      s.measured_cost_per_unit =
+          cost->measured_cost_per_unit.load(std::memory_order_relaxed);
+      stats.push_back(std::move(s));
+    }
+    return stats;
+  }
+
+  // Resets the measurements. Entries are kept alive since concurrent Shard()
+  // calls may still hold pointers to them.
+  void Reset() {
+    tf_shared_lock l(mu_);
+    for (const auto& [key, cost] : costs_) {
+      cost->num_calls.store(0, std::memory_order_relaxed);
+      cost->cost_per_unit_hint.store(0, std::memory_order_relaxed);
+      cost->measured_cost_per_unit.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  mutex mu_;
+  absl::flat_hash_map<std::type_index, std::unique_ptr<CallSiteCost>> costs_
+      TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
 
+void EnableAdaptiveSharding(bool enabled) {
+  AdaptiveShardingEnabled().store(enabled, std::memory_order_relaxed);
+}
+
+bool IsAdaptiveShardingEnabled() {
+#ifdef TF_WORK_SHARDER_HAS_RTTI
+  return AdaptiveShardingEnabled().load(std::memory_order_relaxed);
+#else
+  return false;
+#endif
+}
+
+std::vector<AdaptiveShardStats> GetAdaptiveShardStats() {
+  return CallSiteCostRegistry::Global()->Stats();
+}
+
+void ResetAdaptiveShardStats() { CallSiteCostRegistry::Global()->Reset(); }
+
 /* ABSL_CONST_INIT */ thread_local int per_thread_max_parallelism = 1000000;
 
 void SetPerThreadMaxParallelism(int max_parallelism) {
@@ -66,6 +192,36 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
     work(0, total);
     return;
   }
+#ifdef TF_WORK_SHARDER_HAS_RTTI
+  if (IsAdaptiveShardingEnabled()) {
+    CallSiteCost* site = CallSiteCostRegistry::Global()->Get(
+        std::type_index(work.target_type()));
+    site->cost_per_unit_hint.store(cost_per_unit, std::memory_order_relaxed);
+    const int64_t measured =
+        site->measured_cost_per_unit.load(std::memory_order_relaxed);
+    if (measured > 0) cost_per_unit = measured;
+    // Sum the time spent in all shards, which approximates the single-threaded
+    // cost of the work regardless of how it was split.
+    std::atomic<int64_t> work_nanos{0};
+    std::function<void(int64_t, int64_t)> measured_work =
+        [&work, &work_nanos](int64_t start, int64_t limit) {
+          const uint64_t start_nanos = EnvTime::NowNanos();
+          work(start, limit);
+          work_nanos.fetch_add(EnvTime::NowNanos() - start_nanos,
+                               std::memory_order_relaxed);
+        };
+    if (UseEigenParallelFor() && max_parallelism >= workers->NumThreads()) {
+      workers->ParallelFor(total, cost_per_unit, measured_work);
+    } else {
+      Sharder::Do(
+          total, cost_per_unit, measured_work,
+          [&workers](Sharder::Closure c) { workers->Schedule(c); },
+          max_parallelism);
+    }
+    site->Record(total, work_nanos.load(std::memory_order_relaxed));
+    return;
+  }
+#endif  // TF_WORK_SHARDER_HAS_RTTI
   if (UseEigenParallelFor() && max_parallelism >= workers->NumThreads()) {
     tsl::profiler::TraceMe trace_me([=, num_threads = workers->NumThreads()]() {
       return tsl::profiler::TraceMeEncode("ParallelFor",
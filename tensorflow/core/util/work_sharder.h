@@ -17,6 +17,8 @@ limitations under the License.
 #define TENSORFLOW_CORE_UTIL_WORK_SHARDER_H_
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/types.h"
@@ -59,6 +61,33 @@ namespace tensorflow {
 void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
            int64_t cost_per_unit, std::function<void(int64_t, int64_t)> work);
 
+// Adaptive sharding. Kernels often pass a "cost_per_unit" that is off by an
+// order of magnitude. When adaptive sharding is enabled, Shard() measures the
+// time spent per unit of work for each call site, identified by the type of
+// the "work" callable, and uses the measured cost instead of "cost_per_unit"
+// on subsequent calls from that call site. The measurement is a moving
+// average, so it follows changes in input sizes.
+//
+// Adaptive sharding is disabled by default. It can be enabled by setting the
+// environment variable TF_WORK_SHARDER_ADAPTIVE_COST=1 or by calling
+// EnableAdaptiveSharding(true). It requires RTTI; without RTTI it is a no-op.
+void EnableAdaptiveSharding(bool enabled);
+bool IsAdaptiveShardingEnabled();
+
+// Per call site statistics collected by adaptive sharding, for debugging.
+struct AdaptiveShardStats {
+  // The (demangled) type name of the "work" callable.
+  std::string call_site;
+  // Number of Shard() calls that recorded a measurement.
+  int64_t num_calls = 0;
+  // The "cost_per_unit" passed by the most recent call.
+  int64_t cost_per_unit_hint = 0;
+  // The measured cost per unit of work in nanoseconds.
+  int64_t measured_cost_per_unit = 0;
+};
+std::vector<AdaptiveShardStats> GetAdaptiveShardStats();
+void ResetAdaptiveShardStats();
+
 // Each thread has an associated option to express the desired maximum
 // parallelism. Its default is a very large quantity.
 //
@@ -93,6 +93,37 @@ TEST(Shard, OverflowTest) {
   }
 }
 
+TEST(Shard, AdaptiveCostPerUnit) {
+  thread::ThreadPool threads(Env::Default(), "test", 4);
+  EnableAdaptiveSharding(true);
+  if (!IsAdaptiveShardingEnabled()) {
+    GTEST_SKIP() << "Adaptive sharding requires RTTI.";
+  }
+  ResetAdaptiveShardStats();
+  constexpr int64_t kTotal = 64;
+  constexpr int kNumCalls = 5;
+  for (int i = 0; i < kNumCalls; ++i) {
+    std::atomic<int64_t> num_elements(0);
+    // The hinted cost of 1 underestimates the ~10us spent per unit.
+    Shard(4, &threads, kTotal, /*cost_per_unit=*/1,
+          [&num_elements](int64_t start, int64_t limit) {
+            Env::Default()->SleepForMicroseconds(10 * (limit - start));
+            num_elements += limit - start;
+          });
+    EXPECT_EQ(num_elements.load(), kTotal);
+  }
+  EnableAdaptiveSharding(false);
+
+  const std::vector<AdaptiveShardStats> stats = GetAdaptiveShardStats();
+  auto it = std::find_if(stats.begin(), stats.end(),
+                         [](const AdaptiveShardStats& s) {
+                           return s.num_calls == kNumCalls;
+                         });
+  ASSERT_NE(it, stats.end());
+  EXPECT_EQ(it->cost_per_unit_hint, 1);
+  EXPECT_GE(it->measured_cost_per_unit, 10000);
+}
+
 void BM_Sharding(::testing::benchmark::State& state) {
   const int arg = state.range(0);
 
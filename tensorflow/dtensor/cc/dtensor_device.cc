@@ -35,6 +35,7 @@ limitations under the License.
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/types/span.h"
 #include "llvm/Support/Casting.h"
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/OwningOpRef.h"  // from @llvm-project
@@ -485,6 +486,14 @@ class DTensorDevice {
       const TFE_OpAttrs* attributes, int* num_outputs,
       std::vector<TensorHandlePtr>& outputs, TF_Status* status);
 
+  // Same as `ExecuteSingleDeviceOperation`, but `inputs` must not contain
+  // tensors on the DTensor device.
+  void ExecuteUnwrappedOperation(
+      TFE_Context* context, absl::Span<TFE_TensorHandle* const> inputs,
+      const std::string& operation_name, const std::string& device_name,
+      const TFE_OpAttrs* attributes, int* num_outputs,
+      std::vector<TensorHandlePtr>& outputs, TF_Status* status);
+
   // Helper that calls `ExecuteSingleDeviceOperation` with the right parameters.
   void ExecuteEagerOperation(
       TFE_Context* context, const TFE_OpAttrs* attributes,
@@ -1843,17 +1852,25 @@ void DTensorDevice::ExecuteMultiDeviceOperation(
     const std::vector<TensorWithLayoutTf*>& inputs,
     std::vector<std::unique_ptr<TensorWithLayout>>& outputs,
     TF_Status* status) {
+  // The function takes the component tensors of every input, which are never
+  // on the DTensor device, so they are passed through without inspection.
+  size_t num_eager_inputs = 0;
+  for (TensorWithLayoutTf* input : inputs) {
+    num_eager_inputs += input->num_tensors();
+  }
   std::vector<TFE_TensorHandle*> eager_inputs;
+  eager_inputs.reserve(num_eager_inputs);
   for (TensorWithLayoutTf* input : inputs) {
-    std::vector<TFE_TensorHandle*> tensors(input->tensors());
-    eager_inputs.insert(eager_inputs.end(), tensors.begin(), tensors.end());
+    for (size_t i = 0; i < input->num_tensors(); ++i) {
+      eager_inputs.push_back(input->get_tensor(i));
+    }
   }
 
   int num_outputs = function.local_output_shapes.size();
   int num_output_layouts = function.output_layouts.size();
 
   std::vector<TensorHandlePtr> eager_outputs(num_outputs);
-  ExecuteSingleDeviceOperation(
+  ExecuteUnwrappedOperation(
       context, eager_inputs, function.translated_function_name,
       /*device_name=*/"", attributes, &num_outputs, eager_outputs, status);
   if (TF_GetCode(status) != TF_OK) return;
@@ -1886,22 +1903,9 @@ void DTensorDevice::ExecuteSingleDeviceOperation(
     const std::string& operation_name, const std::string& device_name,
     const TFE_OpAttrs* attributes, int* num_outputs,
     std::vector<TensorHandlePtr>& outputs, TF_Status* status) {
-  std::unique_ptr<tensorflow::EagerOperation> new_op(
-      reinterpret_cast<EagerOperation*>(
-          tensorflow::unwrap(context)->CreateOperation()));
-
-  // TODO(b/274647196): don't forget setting step id when this is moved after
-  // rewrite.
-  Set_TF_Status_from_Status(
-      status, new_op->Reset(operation_name.c_str(),
-                            /*device_name=*/device_name.c_str(),
-                            /*remote=*/false, eager_executor_.get()));
-  if (TF_GetCode(status) != TF_OK) return;
-  if (attributes) {
-    new_op->AddAttrs(tensorflow::unwrap(attributes));
-  }
-  for (int input_index = 0; input_index < inputs.size(); ++input_index) {
-    auto input = inputs[input_index];
+  std::vector<TFE_TensorHandle*> unwrapped_inputs;
+  unwrapped_inputs.reserve(inputs.size());
+  for (TFE_TensorHandle* input : inputs) {
     const char* input_device = TFE_TensorHandleDeviceName(input, status);
     if (TF_GetCode(status) != TF_OK) return;
     if (input_device == name_) {
@@ -1919,6 +1923,33 @@ void DTensorDevice::ExecuteSingleDeviceOperation(
       }
       input = t->get_tensor(0);
     }
+    unwrapped_inputs.push_back(input);
+  }
+  ExecuteUnwrappedOperation(context, unwrapped_inputs, operation_name,
+                            device_name, attributes, num_outputs, outputs,
+                            status);
+}
+
+void DTensorDevice::ExecuteUnwrappedOperation(
+    TFE_Context* context, absl::Span<TFE_TensorHandle* const> inputs,
+    const std::string& operation_name, const std::string& device_name,
+    const TFE_OpAttrs* attributes, int* num_outputs,
+    std::vector<TensorHandlePtr>& outputs, TF_Status* status) {
+  std::unique_ptr<tensorflow::EagerOperation> new_op(
+      reinterpret_cast<EagerOperation*>(
+          tensorflow::unwrap(context)->CreateOperation()));
+
+  // TODO(b/274647196): don't forget setting step id when this is moved after
+  // rewrite.
+  Set_TF_Status_from_Status(
+      status, new_op->Reset(operation_name.c_str(),
+                            /*device_name=*/device_name.c_str(),
+                            /*remote=*/false, eager_executor_.get()));
+  if (TF_GetCode(status) != TF_OK) return;
+  if (attributes) {
+    new_op->AddAttrs(tensorflow::unwrap(attributes));
+  }
+  for (TFE_TensorHandle* input : inputs) {
     Set_TF_Status_from_Status(status,
                               new_op->AddInput(tensorflow::unwrap(input)));
     if (TF_GetCode(status) != TF_OK) return;
@@ -2107,35 +2138,39 @@ void DTensorDevice::ExecuteRegularOperation(
     inputs_tf.push_back(llvm::cast<TensorWithLayoutTf>(input));
   }
 
+  const bool multi_device_mode = EnableMultiDeviceMode();
+
   // Extract the global parallel inputs and flatten SparseTensors
-  // into the three component tensors.
+  // into the three component tensors. A multi-device function takes the
+  // component tensors directly, so this is skipped in multi-device mode.
   std::vector<std::vector<TFE_TensorHandle*>> global_parallel_inputs;
   std::vector<std::vector<TFE_TensorHandle*>> global_parallel_sparse_inputs;
   absl::flat_hash_set<int> global_sparse_input_indices;
-  for (auto input : inputs_tf) {
-    if (auto* sparse_input = llvm::dyn_cast<SparseTensorWithLayout>(input);
-        sparse_input) {
-      global_parallel_sparse_inputs.emplace_back(
-          sparse_input->indices()->tensors());
-      global_parallel_sparse_inputs.emplace_back(
-          sparse_input->dense_shapes()->tensors());
-      global_parallel_sparse_inputs.emplace_back(
-          sparse_input->values()->tensors());
-    } else {
-      global_parallel_inputs.push_back(input->tensors());
+  if (!multi_device_mode) {
+    for (auto input : inputs_tf) {
+      if (auto* sparse_input = llvm::dyn_cast<SparseTensorWithLayout>(input);
+          sparse_input) {
+        global_parallel_sparse_inputs.emplace_back(
+            sparse_input->indices()->tensors());
+        global_parallel_sparse_inputs.emplace_back(
+            sparse_input->dense_shapes()->tensors());
+        global_parallel_sparse_inputs.emplace_back(
+            sparse_input->values()->tensors());
+      } else {
+        global_parallel_inputs.push_back(input->tensors());
+      }
     }
+    // Insert SparseTensor components to the end, this is because
+    // in the MLIR handling of SparseTensors, we place SparseTensor components
+    // to the end of the main func arguments for a fixed ordering.
+    global_parallel_inputs.insert(global_parallel_inputs.end(),
+                                  global_parallel_sparse_inputs.begin(),
+                                  global_parallel_sparse_inputs.end());
   }
-  // Insert SparseTensor components to the end, this is because
-  // in the MLIR handling of SparseTensors, we place SparseTensor components
-  // to the end of the main func arguments for a fixed ordering.
-  global_parallel_inputs.insert(global_parallel_inputs.end(),
-                                global_parallel_sparse_inputs.begin(),
-                                global_parallel_sparse_inputs.end());
 
   // Calculate the number of global outputs.
   const std::vector<TranslatedFunction>& function_list =
       execution_functions->function_list;
-  const bool multi_device_mode = EnableMultiDeviceMode();
   if (multi_device_mode && function_list.size() != 1) {
     Set_TF_Status_from_Status(
         status,
@@ -2187,11 +2222,7 @@ void DTensorDevice::ExecuteRegularOperation(
     if (excluded_fn_names.contains(function.translated_function_name)) {
       continue;
     }
-    const Mesh mesh = function.function_mesh;
-
-    ASSIGN_OR_RETURN_C_STATUS(
-        const parallel_device::ParallelDevice* parallel_device,
-        GetParallelDevice(mesh, /*strict=*/false), status);
+    const Mesh& mesh = function.function_mesh;
 
     std::vector<std::unique_ptr<TensorWithLayout>> output_with_layout;
     output_with_layout.reserve(function.output_index_map.size());
@@ -2216,6 +2247,11 @@ void DTensorDevice::ExecuteRegularOperation(
         output_with_layout.push_back(std::move(remote_output));
       }
     } else {
+      // Looking up the parallel device hashes the mesh, so it is only done
+      // when the per-device results have to be joined.
+      ASSIGN_OR_RETURN_C_STATUS(
+          const parallel_device::ParallelDevice* parallel_device,
+          GetParallelDevice(mesh, /*strict=*/false), status);
       auto result = parallel_device->Join(function.local_output_shapes, status);
 
       if (TF_GetCode(status) == TF_OK) {
@@ -109,6 +109,11 @@ CreateDTensorAllReduceLoweringPass();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 CreateDTensorAllToAllLoweringPass();
 
+// Creates a pass that moves lowered collectives right after the producers of
+// their operands so that they overlap with independent compute.
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+CreateDTensorScheduleCollectivesEarly();
+
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 CreateDTensorReduceScatterLoweringPass();
 
@@ -277,6 +277,12 @@ void CreateDTensorMLIRPass(const mlir::TF::StandardPipelineOptions &options,
 
   pm->addPass(CreateDTensorAllToAllLoweringPass());
 
+  // Issue the lowered collectives as early as their operands allow so that the
+  // communication of relayouts overlaps with the compute that does not
+  // depend on it.
+  pm->addNestedPass<mlir::func::FuncOp>(
+      CreateDTensorScheduleCollectivesEarly());
+
   // Group together multiple device clusters assigned to the same mesh. Repeat
   // this for every mesh to support multi-mesh. Collective lowering may have
   // created multiple CPU mesh clusters for executing collective operations on
@@ -0,0 +1,131 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/IR/Block.h"  // from @llvm-project
+#include "mlir/IR/Matchers.h"  // from @llvm-project
+#include "mlir/IR/Operation.h"  // from @llvm-project
+#include "mlir/IR/Value.h"  // from @llvm-project
+#include "mlir/Interfaces/SideEffectInterfaces.h"  // from @llvm-project
+#include "mlir/Pass/Pass.h"  // from @llvm-project
+#include "tensorflow/compiler/mlir/tensorflow/ir/tf_ops.h"
+#include "tensorflow/dtensor/mlir/dtensor_mlir_passes.h"
+
+namespace tensorflow {
+namespace dtensor {
+
+namespace {
+#define GEN_PASS_DEF_DTENSORSCHEDULECOLLECTIVESEARLY
+#include "tensorflow/dtensor/mlir/dtensor_passes.h.inc"
+
+// Returns true if `op` is a physical collective emitted by the DTensor
+// collective lowering passes.
+bool IsLoweredCollective(mlir::Operation* op) {
+  return llvm::isa<mlir::TF::CollectiveReduceV2Op,
+                   mlir::TF::CollectiveGatherV2Op,
+                   mlir::TF::CollectiveAllToAllV2Op,
+                   mlir::TF::CollectivePermuteOp, mlir::TF::XlaAllReduceOp,
+                   mlir::TF::XlaReduceScatterOp, mlir::TF::AllToAllOp>(op);
+}
+
+// Returns true if `op` is a constant with no operands which may be moved
+// together with the collective consuming it.
+bool IsMovableConstant(mlir::Operation* op) {
+  return op->getNumOperands() == 0 &&
+         mlir::matchPattern(op, mlir::m_Constant());
+}
+
+// Moves `op` right after `insert_after`, or to the front of its block if
+// `insert_after` is null.
+void MoveAfter(mlir::Operation* op, mlir::Operation* insert_after) {
+  if (insert_after == op) return;
+  if (insert_after != nullptr) {
+    op->moveAfter(insert_after);
+  } else if (&op->getBlock()->front() != op) {
+    op->moveBefore(&op->getBlock()->front());
+  }
+}
+
+// Moves every collective in `block` right after the last op it has to follow:
+// the producers of its operands, the previous collective and the previous op
+// with side effects. Constant operands produced after that point are moved
+// along with the collective.
+void ScheduleCollectivesEarly(mlir::Block& block) {
+  mlir::Operation* barrier = nullptr;
+  for (mlir::Operation& op : llvm::make_early_inc_range(block)) {
+    if (!IsLoweredCollective(&op)) {
+      if (!mlir::isMemoryEffectFree(&op)) barrier = &op;
+      continue;
+    }
+
+    mlir::Operation* insert_after = barrier;
+    llvm::SmallVector<mlir::Operation*, 4> constants;
+    for (mlir::Value operand : op.getOperands()) {
+      mlir::Operation* producer = operand.getDefiningOp();
+      if (producer == nullptr || producer->getBlock() != &block) continue;
+      if (IsMovableConstant(producer)) {
+        if (!llvm::is_contained(constants, producer))
+          constants.push_back(producer);
+        continue;
+      }
+      if (insert_after == nullptr || insert_after->isBeforeInBlock(producer))
+        insert_after = producer;
+    }
+
+    for (mlir::Operation* constant : constants) {
+      if (insert_after != nullptr && constant->isBeforeInBlock(insert_after))
+        continue;
+      MoveAfter(constant, insert_after);
+      insert_after = constant;
+    }
+
+    MoveAfter(&op, insert_after);
+    barrier = &op;
+  }
+}
+
+// Hoists lowered collectives as early in their block as their operands allow,
+// so that the communication of a relayout is issued before the compute that
+// does not depend on it.
+struct DTensorScheduleCollectivesEarly
+    : public impl::DTensorScheduleCollectivesEarlyBase<
+          DTensorScheduleCollectivesEarly> {
+  void runOnOperation() override {
+    mlir::func::FuncOp function = getOperation();
+    llvm::SmallVector<mlir::Block*, 4> blocks;
+    function.walk([&](mlir::Operation* op) {
+      if (IsLoweredCollective(op)) blocks.push_back(op->getBlock());
+    });
+    llvm::SmallPtrSet<mlir::Block*, 4> visited;
+    for (mlir::Block* block : blocks) {
+      if (visited.insert(block).second) ScheduleCollectivesEarly(*block);
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+CreateDTensorScheduleCollectivesEarly() {
+  return std::make_unique<DTensorScheduleCollectivesEarly>();
+}
+
+}  // namespace dtensor
+}  // namespace tensorflow
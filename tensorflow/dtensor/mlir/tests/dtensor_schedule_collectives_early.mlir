@@ -0,0 +1,54 @@
+// RUN: dtensor-opt %s -split-input-file -dtensor-schedule-collectives-early | FileCheck %s
+
+// Check that a collective is hoisted above compute it does not depend on,
+// together with its constant operands.
+// CHECK-LABEL: func @hoist_above_independent_compute
+func.func @hoist_above_independent_compute(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32>, tensor<4xf32>) {
+  // CHECK:      %[[GROUP_SIZE:.*]] = "tf.Const"
+  // CHECK-NEXT: %[[GROUP_KEY:.*]] = "tf.Const"
+  // CHECK-NEXT: %[[INSTANCE_KEY:.*]] = "tf.Const"
+  // CHECK-NEXT: %[[REDUCE:.*]] = "tf.CollectiveReduceV2"(%arg0, %[[GROUP_SIZE]], %[[GROUP_KEY]], %[[INSTANCE_KEY]])
+  // CHECK-NEXT: %[[MUL:.*]] = "tf.Mul"(%arg1, %arg1)
+  // CHECK-NEXT: %[[ADD:.*]] = "tf.AddV2"(%[[MUL]], %arg1)
+  %0 = "tf.Mul"(%arg1, %arg1) : (tensor<4xf32>, tensor<4xf32>) -> tensor<4xf32>
+  %1 = "tf.AddV2"(%0, %arg1) : (tensor<4xf32>, tensor<4xf32>) -> tensor<4xf32>
+  %2 = "tf.Const"() {value = dense<2> : tensor<i32>} : () -> tensor<i32>
+  %3 = "tf.Const"() {value = dense<0> : tensor<i32>} : () -> tensor<i32>
+  %4 = "tf.Const"() {value = dense<1> : tensor<i32>} : () -> tensor<i32>
+  %5 = "tf.CollectiveReduceV2"(%arg0, %2, %3, %4) {final_op = "Id", merge_op = "Add"} : (tensor<4xf32>, tensor<i32>, tensor<i32>, tensor<i32>) -> tensor<4xf32>
+  func.return %5, %1 : tensor<4xf32>, tensor<4xf32>
+}
+
+// -----
+
+// Check that a collective stays after the producer of its input and that the
+// relative order of collectives is preserved.
+// CHECK-LABEL: func @keep_data_and_collective_order
+func.func @keep_data_and_collective_order(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32>, tensor<4xf32>, tensor<4xf32>) {
+  // CHECK:      %[[FIRST:.*]] = "tf.XlaAllReduce"(%arg0
+  // CHECK-NEXT: %[[NEG:.*]] = "tf.Neg"(%arg1)
+  // CHECK-NEXT: %[[SECOND:.*]] = "tf.XlaAllReduce"(%[[NEG]]
+  // CHECK-NEXT: "tf.Mul"
+  %group_assignment = "tf.Const"() {value = dense<[[0, 1]]> : tensor<1x2xi32>} : () -> tensor<1x2xi32>
+  %0 = "tf.Neg"(%arg1) : (tensor<4xf32>) -> tensor<4xf32>
+  %1 = "tf.XlaAllReduce"(%arg0, %group_assignment) {mode = "CrossReplica", reduce_op = "Add"} : (tensor<4xf32>, tensor<1x2xi32>) -> tensor<4xf32>
+  %2 = "tf.Mul"(%0, %0) : (tensor<4xf32>, tensor<4xf32>) -> tensor<4xf32>
+  %3 = "tf.XlaAllReduce"(%0, %group_assignment) {mode = "CrossReplica", reduce_op = "Add"} : (tensor<4xf32>, tensor<1x2xi32>) -> tensor<4xf32>
+  func.return %1, %2, %3 : tensor<4xf32>, tensor<4xf32>, tensor<4xf32>
+}
+
+// -----
+
+// Check that a collective is not moved above an op with side effects.
+// CHECK-LABEL: func @keep_side_effect_order
+func.func @keep_side_effect_order(%arg0: tensor<4xf32>, %arg1: tensor<!tf_type.resource<tensor<4xf32>>>) -> tensor<4xf32> {
+  // CHECK:      "tf.AssignVariableOp"
+  // CHECK-NEXT: "tf.Const"
+  // CHECK-NEXT: "tf.XlaAllReduce"
+  "tf.AssignVariableOp"(%arg1, %arg0) : (tensor<!tf_type.resource<tensor<4xf32>>>, tensor<4xf32>) -> ()
+  %0 = "tf.Neg"(%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  %group_assignment = "tf.Const"() {value = dense<[[0, 1]]> : tensor<1x2xi32>} : () -> tensor<1x2xi32>
+  %1 = "tf.XlaAllReduce"(%arg0, %group_assignment) {mode = "CrossReplica", reduce_op = "Add"} : (tensor<4xf32>, tensor<1x2xi32>) -> tensor<4xf32>
+  %2 = "tf.AddV2"(%0, %1) : (tensor<4xf32>, tensor<4xf32>) -> tensor<4xf32>
+  func.return %2 : tensor<4xf32>
+}
@@ -95,6 +95,12 @@ class MMAPAllocation : public Allocation {
     return offset_of_buffer_in_file_;
   }
 
+  /// Asks the OS to start reading the `length` bytes at `offset` of this
+  /// allocation from the file in the background, so that they are resident
+  /// when they are first used. Returns false if the range is invalid or the
+  /// hint failed; the data can still be used in that case.
+  bool Prefetch(size_t offset, size_t length) const;
+
   static bool IsSupported();
 
  protected:
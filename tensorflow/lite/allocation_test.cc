@@ -52,6 +52,23 @@ TEST(MMAPAllocation, TestValidFile) {
   EXPECT_NE(allocation.base(), nullptr);
 }
 
+TEST(MMAPAllocation, TestPrefetch) {
+  if (!MMAPAllocation::IsSupported()) {
+    return;
+  }
+
+  TestErrorReporter error_reporter;
+  MMAPAllocation allocation(
+      "tensorflow/lite/testdata/empty_model.bin", &error_reporter);
+  ASSERT_TRUE(allocation.valid());
+
+  EXPECT_TRUE(allocation.Prefetch(/*offset=*/0, allocation.bytes()));
+  EXPECT_TRUE(allocation.Prefetch(/*offset=*/1, /*length=*/1));
+  EXPECT_FALSE(allocation.Prefetch(/*offset=*/0, /*length=*/0));
+  EXPECT_FALSE(allocation.Prefetch(/*offset=*/1, allocation.bytes()));
+  EXPECT_FALSE(allocation.Prefetch(allocation.bytes() + 1, /*length=*/1));
+}
+
 #if defined(__linux__)
 TEST(MMAPAllocation, TestInvalidFileDescriptor) {
   if (!MMAPAllocation::IsSupported()) {
@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -34,6 +35,116 @@ constexpr int32_t kLastActiveNodeUndefined =
 constexpr int32_t kNodeNotAssigned = std::numeric_limits<int32_t>::max();
 constexpr int32_t kScalarTensorBytes = 4;
 
+// Version of the format written by ArenaPlanner::SerializePlans().
+constexpr uint32_t kArenaPlansVersion = 1;
+
+namespace {
+
+// Unsigned values are serialized as protobuf varints, in chunks of 7 bits.
+constexpr int kVarintMod = (1 << 7);
+
+void Serialize(std::string* out, uint64_t value) {
+  for (; value >= kVarintMod; value /= kVarintMod) {
+    out->push_back(value % kVarintMod + kVarintMod);
+  }
+  out->push_back(value);
+}
+
+bool Parse(const char** data, size_t* size, uint64_t* out) {
+  *out = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*size == 0) return false;
+    const unsigned char byte = **data;
+    ++*data;
+    --*size;
+    *out |= static_cast<uint64_t>(byte % kVarintMod) << shift;
+    if (byte < kVarintMod) return true;
+  }
+  return false;
+}
+
+// Signed values are zigzag-encoded, [..., -2, -1, 0, 1, 2, ...] ->
+// [..., 3, 1, 0, 2, 4, ...].
+void Serialize(std::string* out, int32_t value) {
+  Serialize(out, value < 0 ? static_cast<uint64_t>(-(value + 1)) * 2 + 1
+                           : static_cast<uint64_t>(value) * 2);
+}
+
+bool Parse(const char** data, size_t* size, int32_t* out) {
+  uint64_t value = 0;
+  if (!Parse(data, size, &value) || value / 2 > INT32_MAX) return false;
+  const int32_t magnitude = value / 2;
+  *out = (value % 2) ? (-magnitude - 1) : magnitude;
+  return true;
+}
+
+void Serialize(std::string* out, const ArenaPlan& plan) {
+  Serialize(out, static_cast<uint64_t>(plan.allocs.size()));
+  for (size_t i = 0; i < plan.allocs.size(); ++i) {
+    const ArenaAllocWithUsageInterval& alloc = plan.allocs[i];
+    Serialize(out, static_cast<int32_t>(plan.allocation_types[i]));
+    Serialize(out, static_cast<uint64_t>(plan.tensor_bytes[i]));
+    Serialize(out, static_cast<uint64_t>(alloc.offset));
+    Serialize(out, static_cast<uint64_t>(alloc.size));
+    Serialize(out, alloc.tensor);
+    Serialize(out, alloc.first_node);
+    Serialize(out, alloc.last_node);
+  }
+  Serialize(out, static_cast<uint64_t>(plan.shared_tensors.size()));
+  for (const auto& shared : plan.shared_tensors) {
+    Serialize(out, shared.first);
+    Serialize(out, shared.second);
+  }
+}
+
+// Parses a plan for a graph with `num_tensors` tensors.
+bool Parse(const char** data, size_t* size, size_t num_tensors,
+           ArenaPlan* plan) {
+  uint64_t num_allocs = 0;
+  if (!Parse(data, size, &num_allocs) || num_allocs != num_tensors) {
+    return false;
+  }
+  plan->allocation_types.resize(num_tensors);
+  plan->tensor_bytes.resize(num_tensors);
+  plan->allocs.resize(num_tensors);
+  auto is_tensor = [num_tensors](int32_t tensor) {
+    return tensor >= 0 && tensor < static_cast<int32_t>(num_tensors);
+  };
+  for (size_t i = 0; i < num_tensors; ++i) {
+    ArenaAllocWithUsageInterval& alloc = plan->allocs[i];
+    int32_t allocation_type = 0;
+    uint64_t bytes = 0, offset = 0, alloc_size = 0;
+    if (!Parse(data, size, &allocation_type) || !Parse(data, size, &bytes) ||
+        !Parse(data, size, &offset) || !Parse(data, size, &alloc_size) ||
+        !Parse(data, size, &alloc.tensor) ||
+        !Parse(data, size, &alloc.first_node) ||
+        !Parse(data, size, &alloc.last_node)) {
+      return false;
+    }
+    if (alloc.tensor != -1 && !is_tensor(alloc.tensor)) return false;
+    plan->allocation_types[i] =
+        static_cast<TfLiteAllocationType>(allocation_type);
+    plan->tensor_bytes[i] = bytes;
+    alloc.offset = offset;
+    alloc.size = alloc_size;
+  }
+  uint64_t num_shared = 0;
+  if (!Parse(data, size, &num_shared) || num_shared > num_tensors) {
+    return false;
+  }
+  plan->shared_tensors.resize(num_shared);
+  for (auto& shared : plan->shared_tensors) {
+    if (!Parse(data, size, &shared.first) ||
+        !Parse(data, size, &shared.second) || !is_tensor(shared.first) ||
+        !is_tensor(shared.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 ArenaPlanner::ArenaPlanner(TfLiteContext* context,
                            std::unique_ptr<GraphInfo> graph_info,
                            bool preserve_all_tensors, int tensor_alignment,
@@ -197,10 +308,38 @@ void ArenaPlanner::IdentifyInPlaceTensors() {
   }
 }
 
+TfLiteStatus ArenaPlanner::SetConcurrentStages(
+    const std::vector<int>& stage_ends) {
+  stage_first_node_.clear();
+  stage_last_node_.clear();
+  cached_plans_.clear();
+  int stage_begin = 0;
+  for (int stage_end : stage_ends) {
+    TF_LITE_ENSURE(context_, stage_end > stage_begin);
+    stage_first_node_.resize(stage_end, stage_begin);
+    stage_last_node_.resize(stage_end, stage_end - 1);
+    stage_begin = stage_end;
+  }
+  return ResetAllocations();
+}
+
+int32_t ArenaPlanner::StageFirstNode(int32_t node) const {
+  return node >= 0 && node < static_cast<int32_t>(stage_first_node_.size())
+             ? stage_first_node_[node]
+             : node;
+}
+
+int32_t ArenaPlanner::StageLastNode(int32_t node) const {
+  return node >= 0 && node < static_cast<int32_t>(stage_last_node_.size())
+             ? stage_last_node_[node]
+             : node;
+}
+
 TfLiteStatus ArenaPlanner::PlanAllocations() {
   // Invalidate any existing data.
   const size_t num_tensors = graph_info_->num_tensors();
   TF_LITE_ENSURE_STATUS(ResetAllocations());
+  cached_plans_.clear();
   // Maybe other verb instead of 'Assigned'
   alloc_node_.assign(num_tensors, kNodeNotAssigned);
   dealloc_node_.assign(num_tensors, kNodeNotAssigned);
@@ -356,14 +495,28 @@ TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
     }
   }
 
+  // Plans covering the whole graph only depend on the tensor sizes, and are
+  // reused when the same sizes come back.
+  const bool plans_whole_graph =
+      first_node == 0 && last_node >= num_execution_nodes - 1;
+  const ArenaPlan* cached_plan =
+      plans_whole_graph ? FindCachedPlan() : nullptr;
   std::vector<int32_t> tensors_allocated;
-  TF_LITE_ENSURE_STATUS(
-      CalculateAllocations(first_node, last_node, &tensors_allocated));
+  if (cached_plan != nullptr) {
+    RestorePlan(*cached_plan);
+    last_active_node_ = last_node;
+  } else {
+    TF_LITE_ENSURE_STATUS(
+        CalculateAllocations(first_node, last_node, &tensors_allocated));
+    if (plans_whole_graph) {
+      CacheCurrentPlan();
+    }
+  }
   bool arena_reallocated = false;
   TF_LITE_ENSURE_STATUS(Commit(&arena_reallocated));
 
   TfLiteTensor* tensors = graph_info_->tensors();
-  if (arena_reallocated) {
+  if (arena_reallocated || cached_plan != nullptr) {
     for (int i = 0; i < static_cast<int>(num_tensors); ++i) {
       TF_LITE_ENSURE_STATUS(ResolveTensorAllocation(i, tensors));
     }
@@ -377,6 +530,92 @@ TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   return kTfLiteOk;
 }
 
+const ArenaPlan* ArenaPlanner::FindCachedPlan() const {
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  const size_t num_tensors = graph_info_->num_tensors();
+  for (auto it = cached_plans_.rbegin(); it != cached_plans_.rend(); ++it) {
+    if (it->allocs.size() != num_tensors) continue;
+    bool matches = true;
+    for (size_t i = 0; i < num_tensors && matches; ++i) {
+      matches = it->allocation_types[i] == tensors[i].allocation_type &&
+                it->tensor_bytes[i] == tensors[i].bytes;
+      // Plans read from the model must have been made for the same schedule.
+      const ArenaAllocWithUsageInterval& alloc = it->allocs[i];
+      if (matches && alloc.size > 0 &&
+          tensors[i].allocation_type == kTfLiteArenaRw) {
+        matches = alloc.first_node == StageFirstNode(alloc_node_[i]) &&
+                  alloc.last_node == StageLastNode(dealloc_node_[i]);
+      }
+    }
+    if (matches) return &*it;
+  }
+  return nullptr;
+}
+
+void ArenaPlanner::CacheCurrentPlan() {
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  const size_t num_tensors = graph_info_->num_tensors();
+  ArenaPlan plan;
+  plan.allocation_types.reserve(num_tensors);
+  plan.tensor_bytes.reserve(num_tensors);
+  for (size_t i = 0; i < num_tensors; ++i) {
+    plan.allocation_types.push_back(tensors[i].allocation_type);
+    plan.tensor_bytes.push_back(tensors[i].bytes);
+  }
+  plan.allocs = allocs_;
+  plan.shared_tensors.assign(actual_tensor_id_.begin(),
+                             actual_tensor_id_.end());
+  if (static_cast<int>(cached_plans_.size()) >= kMaxCachedPlans) {
+    cached_plans_.erase(cached_plans_.begin());
+  }
+  cached_plans_.push_back(std::move(plan));
+}
+
+void ArenaPlanner::RestorePlan(const ArenaPlan& plan) {
+  allocs_ = plan.allocs;
+  actual_tensor_id_.clear();
+  actual_tensor_id_.insert(plan.shared_tensors.begin(),
+                           plan.shared_tensors.end());
+  std::vector<ArenaAllocWithUsageInterval> arena_allocs;
+  std::vector<ArenaAllocWithUsageInterval> persistent_allocs;
+  for (size_t i = 0; i < plan.allocs.size(); ++i) {
+    if (plan.allocation_types[i] == kTfLiteArenaRw) {
+      arena_allocs.push_back(plan.allocs[i]);
+    } else if (plan.allocation_types[i] == kTfLiteArenaRwPersistent) {
+      persistent_allocs.push_back(plan.allocs[i]);
+    }
+  }
+  arena_.RestoreAllocs(arena_allocs);
+  persistent_arena_.RestoreAllocs(persistent_allocs);
+}
+
+std::string ArenaPlanner::SerializePlans() const {
+  std::string out;
+  Serialize(&out, static_cast<uint64_t>(kArenaPlansVersion));
+  Serialize(&out, static_cast<uint64_t>(cached_plans_.size()));
+  for (const ArenaPlan& plan : cached_plans_) {
+    Serialize(&out, plan);
+  }
+  return out;
+}
+
+TfLiteStatus ArenaPlanner::RestorePlans(const char* data, size_t size) {
+  uint64_t version = 0;
+  uint64_t num_plans = 0;
+  if (!Parse(&data, &size, &version) || version != kArenaPlansVersion ||
+      !Parse(&data, &size, &num_plans)) {
+    return kTfLiteError;
+  }
+  std::vector<ArenaPlan> plans(std::min<uint64_t>(num_plans, kMaxCachedPlans));
+  for (ArenaPlan& plan : plans) {
+    if (!Parse(&data, &size, graph_info_->num_tensors(), &plan)) {
+      return kTfLiteError;
+    }
+  }
+  cached_plans_ = std::move(plans);
+  return kTfLiteOk;
+}
+
 TfLiteStatus ArenaPlanner::ReleaseNonPersistentMemory() {
   // Clear non-persistent arena's buffer.
   TF_LITE_ENSURE_STATUS(arena_.ReleaseBuffer());
@@ -537,10 +776,12 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
     if (tensor.allocation_type == kTfLiteArenaRw) {
-      TF_LITE_ENSURE_STATUS(
-          arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
-                          tensor_index, alloc_node_[tensor_index],
-                          dealloc_node_[tensor_index], &allocs_[tensor_index]));
+      // Nodes of a concurrent stage may touch their tensors in any order, so
+      // the tensor is live during the whole stages it is used in.
+      TF_LITE_ENSURE_STATUS(arena_.Allocate(
+          context_, tensor_alignment_, tensor.bytes, tensor_index,
+          StageFirstNode(alloc_node_[tensor_index]),
+          StageLastNode(dealloc_node_[tensor_index]), &allocs_[tensor_index]));
     }
     // Check allocs_[].size to prevent from reallocation of persistent tensors.
     // Only allocate ArenaRwPersistent tensors which own their buffer.
@@ -18,8 +18,10 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/lite/core/c/common.h"
@@ -32,6 +34,19 @@ namespace tflite {
 
 constexpr const int kDefaultArenaAlignment = 64;
 
+// The arena allocations of all tensors of a graph, computed for a given set of
+// tensor sizes. Reused instead of planning again when the sizes repeat, e.g.
+// when alternating between a few input shapes.
+struct ArenaPlan {
+  // Allocation type and size of every tensor when the plan was computed.
+  std::vector<TfLiteAllocationType> allocation_types;
+  std::vector<size_t> tensor_bytes;
+  // Allocation of every tensor in its arena.
+  std::vector<ArenaAllocWithUsageInterval> allocs;
+  // Tensors sharing the buffer of another tensor, as (tensor, owner) pairs.
+  std::vector<std::pair<int32_t, int32_t>> shared_tensors;
+};
+
 // A memory planner that makes all the allocations using arenas.
 //
 // Before a model is executed by the interpreter, this class determines when
@@ -60,6 +75,7 @@ class ArenaPlanner : public MemoryPlanner {
 
   TfLiteStatus ResetAllocations() override;
   TfLiteStatus ResetAllocationsAfter(int node) override;
+  TfLiteStatus SetConcurrentStages(const std::vector<int>& stage_ends) override;
   TfLiteStatus PlanAllocations() override;
   TfLiteStatus ExecuteAllocations(int first_node, int last_node) override;
   TfLiteStatus ReleaseNonPersistentMemory() override;
@@ -68,6 +84,15 @@ class ArenaPlanner : public MemoryPlanner {
   void DumpDebugInfo(const std::vector<int>& execution_plan) const override;
   void GetAllocInfo(size_t* arena_size,
                     size_t* arena_persist_size) const override;
+  std::string SerializePlans() const override;
+  TfLiteStatus RestorePlans(const char* data, size_t size) override;
+
+  // Maximum number of plans kept for reuse. The oldest one is dropped first.
+  static constexpr int kMaxCachedPlans = 16;
+
+  // Plans of previous ExecuteAllocations() calls covering the whole graph,
+  // from oldest to newest.
+  const std::vector<ArenaPlan>& cached_plans() const { return cached_plans_; }
 
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
@@ -120,6 +145,21 @@ class ArenaPlanner : public MemoryPlanner {
   // Return the index of the tensor owing `tensor_index's` buffer.
   int FindSharedTensor(int tensor_index);
 
+  // Returns the cached plan computed for the current tensor allocation types
+  // and sizes, or nullptr.
+  const ArenaPlan* FindCachedPlan() const;
+
+  // Caches the current allocations of all tensors.
+  void CacheCurrentPlan();
+
+  // Uses `plan` as the current allocations of all tensors.
+  void RestorePlan(const ArenaPlan& plan);
+
+  // Returns the first (last) node of the concurrent stage containing `node`,
+  // or `node` itself if no stages were set.
+  int32_t StageFirstNode(int32_t node) const;
+  int32_t StageLastNode(int32_t node) const;
+
   TfLiteContext* context_;
   std::unique_ptr<GraphInfo> graph_info_;
 
@@ -166,6 +206,15 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Store number of references to each tensor.
   std::vector<int> refcounts_;
+
+  // First and last node of the concurrent stage containing each node. A
+  // tensor used by any node of a stage is kept alive during the whole stage.
+  std::vector<int32_t> stage_first_node_;
+  std::vector<int32_t> stage_last_node_;
+
+  // Plans reused when the tensor sizes of an earlier ExecuteAllocations()
+  // call of the whole graph repeat. Cleared by PlanAllocations().
+  std::vector<ArenaPlan> cached_plans_;
 };
 
 }  // namespace tflite
@@ -22,6 +22,7 @@ limitations under the License.
 #include <initializer_list>
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -411,6 +412,92 @@ TEST_F(ArenaPlannerTest, SimpleGraphWithTemporary) {
   EXPECT_EQ(GetOffset(1), 4);
 }
 
+TEST_F(ArenaPlannerTest, ConcurrentStagesDontShareMemory) {
+  TestGraph graph({0},
+                  {
+                      /* in, out, tmp */
+                      {{0}, {1}, {3}},    // First op
+                      {{0}, {2}, {4}},    // Second op, independent of first
+                      {{1, 2}, {5}, {}},  // Third op
+                  },
+                  {5});
+  SetGraph(&graph);
+  ASSERT_EQ(planner_->SetConcurrentStages({2, 3}), kTfLiteOk);
+  Execute(0, graph.nodes().size() - 1);
+
+  // The first two ops run concurrently, so none of their tensors may overlap.
+  const std::vector<int> stage_tensors = {0, 1, 2, 3, 4};
+  for (int a : stage_tensors) {
+    for (int b : stage_tensors) {
+      if (a == b) continue;
+      EXPECT_TRUE(GetOffsetAfter(a) <= GetOffset(b) ||
+                  GetOffsetAfter(b) <= GetOffset(a))
+          << "tensors " << a << " and " << b << " overlap";
+    }
+  }
+}
+
+TEST_F(ArenaPlannerTest, ReusesPlanForRepeatedTensorSizes) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},   // First op
+                      {{2, 0}, {4}, {5}},  // Second op, with temporary
+                      {{4}, {3}, {}}       // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+  const std::ptrdiff_t offset4 = GetOffset(4);
+  const std::ptrdiff_t offset5 = GetOffset(5);
+  EXPECT_EQ(planner_->cached_plans().size(), 1);
+
+  (*graph.tensors())[5].bytes = 100;
+  ResetAllocations();
+  Execute(0, graph.nodes().size() - 1);
+  EXPECT_EQ(planner_->cached_plans().size(), 2);
+
+  (*graph.tensors())[5].bytes = 18;
+  ResetAllocations();
+  Execute(0, graph.nodes().size() - 1);
+  EXPECT_EQ(planner_->cached_plans().size(), 2);
+  EXPECT_EQ(GetOffset(4), offset4);
+  EXPECT_EQ(GetOffset(5), offset5);
+
+  // Partial allocations are never cached.
+  ResetAllocationsAfter(0);
+  Execute(1, graph.nodes().size() - 1);
+  EXPECT_EQ(planner_->cached_plans().size(), 2);
+}
+
+TEST_F(ArenaPlannerTest, RestoresSerializedPlans) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},   // First op
+                      {{2, 0}, {4}, {5}},  // Second op, with temporary
+                      {{4}, {3}, {}}       // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+  const std::string plans = planner_->SerializePlans();
+  const std::ptrdiff_t offset2 = GetOffset(2);
+  const std::ptrdiff_t offset4 = GetOffset(4);
+
+  SetGraph(&graph);
+  ASSERT_EQ(planner_->RestorePlans(plans.data(), plans.size()), kTfLiteOk);
+  ASSERT_EQ(planner_->cached_plans().size(), 1);
+  Execute(0, graph.nodes().size() - 1);
+  // The restored plan was used instead of computing a new one.
+  EXPECT_EQ(planner_->cached_plans().size(), 1);
+  EXPECT_EQ(GetOffset(2), offset2);
+  EXPECT_EQ(GetOffset(4), offset4);
+
+  EXPECT_EQ(planner_->RestorePlans(plans.data(), plans.size() - 1),
+            kTfLiteError);
+}
+
 TEST_F(ArenaPlannerTest, SimpleGraphWithInplaceReshape) {
   TestGraph graph(
       {0, 1},
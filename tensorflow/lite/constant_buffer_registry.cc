@@ -0,0 +1,91 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/constant_buffer_registry.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <new>
+
+namespace tflite {
+namespace {
+
+// Hashes the contents of a buffer eight bytes at a time.
+uint64_t HashBuffer(const char* data, size_t size) {
+  constexpr uint64_t kMultiplier = 0x9ddfea08eb382d69ULL;
+  uint64_t hash = size * kMultiplier;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 47;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * kMultiplier;
+  }
+  return hash ^ (hash >> 47);
+}
+
+void FreeBuffer(const char* buffer) {
+  ::operator delete(const_cast<char*>(buffer),
+                    std::align_val_t(ConstantBufferRegistry::kAlignment));
+}
+
+}  // namespace
+
+ConstantBufferRegistry* ConstantBufferRegistry::Get() {
+  static ConstantBufferRegistry* registry = new ConstantBufferRegistry();
+  return registry;
+}
+
+std::shared_ptr<const char> ConstantBufferRegistry::Share(const char* data,
+                                                         size_t size) {
+  const uint64_t hash = HashBuffer(data, size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    std::shared_ptr<const char> buffer = it->second.buffer.lock();
+    if (!buffer) {
+      it = entries_.erase(it);
+      continue;
+    }
+    if (it->second.size == size && memcmp(buffer.get(), data, size) == 0) {
+      return buffer;
+    }
+    ++it;
+  }
+
+  char* copy = static_cast<char*>(
+      ::operator new(size > 0 ? size : 1, std::align_val_t(kAlignment)));
+  memcpy(copy, data, size);
+  std::shared_ptr<const char> buffer(copy, FreeBuffer);
+  entries_.insert({hash, {size, buffer}});
+  return buffer;
+}
+
+size_t ConstantBufferRegistry::NumBuffers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t num_buffers = 0;
+  for (const auto& entry : entries_) {
+    if (!entry.second.buffer.expired()) ++num_buffers;
+  }
+  return num_buffers;
+}
+
+}  // namespace tflite
@@ -0,0 +1,64 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/// \file
+///
+/// Sharing of the constant buffers of models loaded in one process.
+#ifndef TENSORFLOW_LITE_CONSTANT_BUFFER_REGISTRY_H_
+#define TENSORFLOW_LITE_CONSTANT_BUFFER_REGISTRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <unordered_map>
+
+namespace tflite {
+
+/// A registry of read-only buffers keyed by their contents, so that models
+/// with identical constant tensors, e.g. variants of one base model, hold a
+/// single copy of them.
+///
+/// WARNING: This is an experimental API and subject to change.
+class ConstantBufferRegistry {
+ public:
+  /// The alignment of the shared buffers.
+  static constexpr size_t kAlignment = 64;
+
+  /// Returns the registry of the process.
+  static ConstantBufferRegistry* Get();
+
+  /// Returns a buffer holding the `size` bytes at `data`. If a buffer with
+  /// the same contents is still held by another caller, that buffer is
+  /// returned, otherwise a copy of `data` is made. Buffers are freed when
+  /// their last holder releases them. Thread-safe.
+  std::shared_ptr<const char> Share(const char* data, size_t size);
+
+  /// Returns the number of buffers currently held.
+  size_t NumBuffers() const;
+
+ private:
+  struct Entry {
+    size_t size;
+    std::weak_ptr<const char> buffer;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_multimap<uint64_t, Entry> entries_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CONSTANT_BUFFER_REGISTRY_H_
@@ -0,0 +1,72 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/constant_buffer_registry.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace {
+
+TEST(ConstantBufferRegistryTest, SharesIdenticalBuffers) {
+  ConstantBufferRegistry registry;
+  const std::vector<char> a(4096, 1);
+  const std::vector<char> b(4096, 1);
+  const std::shared_ptr<const char> shared_a = registry.Share(a.data(), 4096);
+  const std::shared_ptr<const char> shared_b = registry.Share(b.data(), 4096);
+  EXPECT_EQ(shared_a.get(), shared_b.get());
+  EXPECT_NE(shared_a.get(), a.data());
+  EXPECT_EQ(memcmp(shared_a.get(), a.data(), a.size()), 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(shared_a.get()) %
+                ConstantBufferRegistry::kAlignment,
+            0);
+  EXPECT_EQ(registry.NumBuffers(), 1);
+}
+
+TEST(ConstantBufferRegistryTest, DoesNotShareDifferentBuffers) {
+  ConstantBufferRegistry registry;
+  std::vector<char> a(4096, 1);
+  std::vector<char> b(4096, 1);
+  b.back() = 2;
+  const std::shared_ptr<const char> shared_a = registry.Share(a.data(), 4096);
+  const std::shared_ptr<const char> shared_b = registry.Share(b.data(), 4096);
+  const std::shared_ptr<const char> shared_prefix =
+      registry.Share(a.data(), 4095);
+  EXPECT_NE(shared_a.get(), shared_b.get());
+  EXPECT_NE(shared_a.get(), shared_prefix.get());
+  EXPECT_EQ(registry.NumBuffers(), 3);
+}
+
+TEST(ConstantBufferRegistryTest, FreesReleasedBuffers) {
+  ConstantBufferRegistry registry;
+  const std::vector<char> a(4096, 1);
+  std::shared_ptr<const char> shared_a = registry.Share(a.data(), 4096);
+  std::shared_ptr<const char> shared_b = registry.Share(a.data(), 4096);
+  shared_a.reset();
+  EXPECT_EQ(registry.NumBuffers(), 1);
+  shared_b.reset();
+  EXPECT_EQ(registry.NumBuffers(), 0);
+
+  shared_a = registry.Share(a.data(), 4096);
+  EXPECT_EQ(memcmp(shared_a.get(), a.data(), a.size()), 0);
+  EXPECT_EQ(registry.NumBuffers(), 1);
+}
+
+}  // namespace
+}  // namespace tflite
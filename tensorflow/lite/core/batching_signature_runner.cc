@@ -0,0 +1,143 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/batching_signature_runner.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstring>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/signature_runner.h"
+
+namespace tflite {
+namespace impl {
+
+BatchingSignatureRunner::BatchingSignatureRunner(SignatureRunner* runner,
+                                                 const Options& options)
+    : runner_(runner), options_(options) {}
+
+TfLiteStatus BatchingSignatureRunner::Invoke(
+    const std::vector<const void*>& inputs, const std::vector<void*>& outputs) {
+  if (inputs.size() != runner_->input_size() ||
+      outputs.size() != runner_->output_size()) {
+    return kTfLiteError;
+  }
+  const size_t max_batch_size = std::max(options_.max_batch_size, 1);
+
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = &outputs;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_.push_back(&request);
+  // Wakes up a leader waiting for its batch to fill up.
+  cv_.notify_all();
+  while (!request.done) {
+    if (has_leader_) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    // Become the leader: run the oldest pending requests, which may or may
+    // not include this one, and hand off to another caller afterwards.
+    has_leader_ = true;
+    if (options_.batch_timeout_micros > 0) {
+      cv_.wait_for(lock,
+                   std::chrono::microseconds(options_.batch_timeout_micros),
+                   [this, max_batch_size] {
+                     return pending_.size() >= max_batch_size;
+                   });
+    }
+    std::vector<Request*> batch;
+    while (!pending_.empty() && batch.size() < max_batch_size) {
+      batch.push_back(pending_.front());
+      pending_.pop_front();
+    }
+
+    lock.unlock();
+    const TfLiteStatus status = RunBatch(batch);
+    lock.lock();
+
+    for (Request* batched_request : batch) {
+      batched_request->status = status;
+      batched_request->done = true;
+    }
+    has_leader_ = false;
+    cv_.notify_all();
+  }
+  return request.status;
+}
+
+TfLiteStatus BatchingSignatureRunner::RunBatch(
+    const std::vector<Request*>& batch) {
+  const int batch_size = static_cast<int>(batch.size());
+  if (batch_size != allocated_batch_size_) {
+    allocated_batch_size_ = 0;
+    TF_LITE_ENSURE_STATUS(ResizeInputs(batch_size));
+    TF_LITE_ENSURE_STATUS(runner_->AllocateTensors());
+    allocated_batch_size_ = batch_size;
+  }
+
+  const std::vector<const char*>& input_names = runner_->input_names();
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    TfLiteTensor* tensor = runner_->input_tensor(input_names[i]);
+    if (tensor == nullptr || tensor->data.raw == nullptr) {
+      return kTfLiteError;
+    }
+    const size_t example_bytes = tensor->bytes / batch_size;
+    for (int b = 0; b < batch_size; ++b) {
+      std::memcpy(tensor->data.raw + b * example_bytes,
+                  (*batch[b]->inputs)[i], example_bytes);
+    }
+  }
+
+  TF_LITE_ENSURE_STATUS(runner_->Invoke());
+
+  const std::vector<const char*>& output_names = runner_->output_names();
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    const TfLiteTensor* tensor = runner_->output_tensor(output_names[i]);
+    if (tensor == nullptr || tensor->type == kTfLiteString ||
+        tensor->dims->size == 0 || tensor->dims->data[0] != batch_size) {
+      return kTfLiteError;
+    }
+    const size_t example_bytes = tensor->bytes / batch_size;
+    for (int b = 0; b < batch_size; ++b) {
+      std::memcpy((*batch[b]->outputs)[i], tensor->data.raw + b * example_bytes,
+                  example_bytes);
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BatchingSignatureRunner::ResizeInputs(int batch_size) {
+  for (const char* input_name : runner_->input_names()) {
+    const TfLiteTensor* tensor = runner_->input_tensor(input_name);
+    if (tensor == nullptr || tensor->type == kTfLiteString ||
+        tensor->dims->size == 0) {
+      return kTfLiteError;
+    }
+    std::vector<int> dims(tensor->dims->data,
+                          tensor->dims->data + tensor->dims->size);
+    dims[0] = batch_size;
+    TF_LITE_ENSURE_STATUS(runner_->ResizeInputTensor(input_name, dims));
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace impl
+}  // namespace tflite
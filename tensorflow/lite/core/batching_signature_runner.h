@@ -0,0 +1,121 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_CORE_BATCHING_SIGNATURE_RUNNER_H_
+#define TENSORFLOW_LITE_CORE_BATCHING_SIGNATURE_RUNNER_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/signature_runner.h"
+
+namespace tflite {
+namespace impl {
+
+/// Coalesces concurrent single-example invocations of a SignatureRunner into
+/// batched invocations, to raise throughput when serving many requests on the
+/// CPU.
+///
+/// All inputs and outputs of the signature must have the batch as their first
+/// dimension. Each call to `Invoke` provides the data of one example (one
+/// element along the batch dimension) for every input, and receives the data
+/// of one example for every output. Requests that arrive while a batch is
+/// running, or within `batch_timeout_micros` of the first request of a batch,
+/// are run together: their inputs are stacked into input tensors resized to
+/// the batch size, and the outputs are scattered back to the callers.
+///
+/// Usage:
+///
+/// <pre><code>
+/// BatchingSignatureRunner::Options options;
+/// options.max_batch_size = 16;
+/// BatchingSignatureRunner batching_runner(runner, options);
+///
+/// // From any number of threads:
+/// float input[kInputSize];
+/// float output[kOutputSize];
+/// if (batching_runner.Invoke({input}, {output}) != kTfLiteOk) {
+///   // Return failure.
+/// }
+/// </code></pre>
+///
+/// `Invoke` is thread-safe. The wrapped SignatureRunner (and the interpreter
+/// owning it) must not be used by anything else while the
+/// BatchingSignatureRunner exists, and must outlive it.
+///
+/// String inputs and outputs are not supported.
+///
+/// WARNING: This is an experimental API and subject to change.
+class BatchingSignatureRunner {
+ public:
+  struct Options {
+    /// Maximum number of requests run in one invocation.
+    int max_batch_size = 8;
+    /// How long the first request of a batch waits for more requests to
+    /// arrive before the batch is run. With 0, a batch is formed from the
+    /// requests that queued up while the previous batch was running.
+    int64_t batch_timeout_micros = 0;
+  };
+
+  BatchingSignatureRunner(SignatureRunner* runner, const Options& options);
+
+  /// Runs the signature on one example and blocks until its outputs are
+  /// written. `inputs` and `outputs` are in the order of the signature's
+  /// `input_names()` and `output_names()`, and each points to the bytes of one
+  /// example of the corresponding tensor.
+  ///
+  /// Returns kTfLiteError if the arguments don't match the signature, or if
+  /// the batch the request was part of failed.
+  TfLiteStatus Invoke(const std::vector<const void*>& inputs,
+                      const std::vector<void*>& outputs);
+
+ private:
+  struct Request {
+    const std::vector<const void*>* inputs;
+    const std::vector<void*>* outputs;
+    bool done = false;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  // Runs `batch` as one invocation of the runner. Must be called by the
+  // current leader only, without holding `mutex_`.
+  TfLiteStatus RunBatch(const std::vector<Request*>& batch);
+
+  // Resizes the inputs of the runner to `batch_size` examples.
+  TfLiteStatus ResizeInputs(int batch_size);
+
+  SignatureRunner* const runner_;
+  const Options options_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Requests waiting to be part of a batch, in arrival order.
+  std::deque<Request*> pending_;
+  // Whether a caller is forming or running a batch. The caller doing so (the
+  // leader) hands off to a waiting caller once it's done.
+  bool has_leader_ = false;
+
+  // Batch size the runner's tensors are currently allocated for, 0 if none.
+  int allocated_batch_size_ = 0;
+};
+
+}  // namespace impl
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CORE_BATCHING_SIGNATURE_RUNNER_H_
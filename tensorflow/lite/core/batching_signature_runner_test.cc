@@ -0,0 +1,99 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/batching_signature_runner.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/core/signature_runner.h"
+#include "tensorflow/lite/testing/util.h"
+
+namespace tflite {
+namespace impl {
+namespace {
+
+class BatchingSignatureRunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = FlatBufferModel::BuildFromFile(
+        "tensorflow/lite/testdata/multi_signatures.bin", &reporter_);
+    ASSERT_TRUE(model_);
+    ops::builtin::BuiltinOpResolver resolver;
+    ASSERT_EQ(InterpreterBuilder(*model_, resolver)(&interpreter_), kTfLiteOk);
+    // The "add" signature adds 2 to its input "x".
+    runner_ = interpreter_->GetSignatureRunner("add");
+    ASSERT_NE(runner_, nullptr);
+  }
+
+  TestErrorReporter reporter_;
+  std::unique_ptr<FlatBufferModel> model_;
+  std::unique_ptr<Interpreter> interpreter_;
+  SignatureRunner* runner_ = nullptr;
+};
+
+TEST_F(BatchingSignatureRunnerTest, SingleRequest) {
+  BatchingSignatureRunner batching_runner(runner_, {});
+  const float input = 3;
+  float output = 0;
+  ASSERT_EQ(batching_runner.Invoke({&input}, {&output}), kTfLiteOk);
+  EXPECT_EQ(output, 5);
+}
+
+TEST_F(BatchingSignatureRunnerTest, RejectsMismatchingArguments) {
+  BatchingSignatureRunner batching_runner(runner_, {});
+  const float input = 3;
+  float output = 0;
+  EXPECT_EQ(batching_runner.Invoke({}, {&output}), kTfLiteError);
+  EXPECT_EQ(batching_runner.Invoke({&input}, {}), kTfLiteError);
+}
+
+TEST_F(BatchingSignatureRunnerTest, ConcurrentRequests) {
+  BatchingSignatureRunner::Options options;
+  options.max_batch_size = 4;
+  options.batch_timeout_micros = 1000;
+  BatchingSignatureRunner batching_runner(runner_, options);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumRequestsPerThread = 50;
+  std::vector<std::thread> threads;
+  std::vector<int> num_errors(kNumThreads, 0);
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&batching_runner, &num_errors, t] {
+      for (int i = 0; i < kNumRequestsPerThread; ++i) {
+        const float input = t * kNumRequestsPerThread + i;
+        float output = 0;
+        if (batching_runner.Invoke({&input}, {&output}) != kTfLiteOk ||
+            output != input + 2) {
+          ++num_errors[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kNumThreads; ++t) {
+    EXPECT_EQ(num_errors[t], 0) << "thread " << t;
+  }
+}
+
+}  // namespace
+}  // namespace impl
+}  // namespace tflite
@@ -552,6 +552,17 @@ class Interpreter {
   /// non-null, remains owned by the caller.
   void SetCancellationFunction(void* data, bool (*check_cancelled_func)(void*));
 
+  /// \warning This is an experimental API and subject to change. \n
+  /// \brief Runs independent nodes of the primary subgraph concurrently
+  /// through `parallel_for`, which must call `task(0)`, ...,
+  /// `task(num_tasks - 1)` and return once all of them have finished. Kernels
+  /// invoked concurrently share the interpreter's external contexts, so this
+  /// must only be used with kernels that are safe to invoke concurrently.
+  /// May increase the memory used by tensors. Must be called before
+  /// `AllocateTensors()`; an empty function restores sequential execution.
+  /// See `Subgraph::SetParallelInvoke` for details.
+  void SetParallelInvoke(Subgraph::ParallelForFunction parallel_for);
+
   /// \warning This is an experimental API and subject to change. \n
   /// \brief  Attempts to cancel in flight invocation if any.
   /// This will not affect `Invoke`s that happends after the cancellation.
@@ -937,6 +948,10 @@ class Interpreter {
   // nullptr if necessary.
   std::unique_ptr<ExternalCpuBackendContext> own_external_cpu_backend_context_;
 
+  // The constant buffers of the model shared with other models through the
+  // ConstantBufferRegistry. They must outlive the subgraphs that read them.
+  std::vector<std::shared_ptr<const char>> shared_constant_buffers_;
+
   // Subgraphs
   std::vector<std::unique_ptr<Subgraph>> subgraphs_;
 
@@ -27,6 +27,8 @@ limitations under the License.
 #include <vector>
 
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/constant_buffer_registry.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/flatbuffer_conversions.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
@@ -35,8 +37,11 @@ limitations under the License.
 #include "tensorflow/lite/core/macros.h"
 #include "tensorflow/lite/core/model_builder.h"
 #include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/experimental/remat/graph_rematerializer.h"
+#include "tensorflow/lite/experimental/remat/metadata_util.h"
 #include "tensorflow/lite/internal/signature_def.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/minimal_logging.h"
 #include "tensorflow/lite/profiling/platform_profiler.h"
 #include "tensorflow/lite/profiling/telemetry/c/telemetry_setting_internal.h"
 #include "tensorflow/lite/schema/conversion_metadata_generated.h"
@@ -79,6 +84,8 @@ namespace {
 
 constexpr char kConversionMetadataKey[] = "CONVERSION_METADATA";
 constexpr char kTelemetryBuilderEventName[] = "InterpreterBuilder::operator()";
+// Smaller constant buffers aren't worth hashing and copying to be shared.
+constexpr size_t kMinSharedConstantBufferSize = 1024;
 
 // Ensure that ErrorReporter is non-null.
 ErrorReporter* ValidateErrorReporter(ErrorReporter* e) {
@@ -327,18 +334,135 @@ class MallocDataAllocator : public BuiltinDataAllocator {
   void Deallocate(void* data) override { free(data); }
 };
 
+// Returns true if the operator must not be run a second time, because it has
+// side effects, state or results that differ between runs.
+bool IsStatefulOperator(const Operator* op, const TfLiteRegistration* op_reg,
+                        const Subgraph& subgraph) {
+  if (op_reg == nullptr ||
+      (op->intermediates() && op->intermediates()->size() > 0)) {
+    return true;
+  }
+  switch (op_reg->builtin_code) {
+    case BuiltinOperator_CALL_ONCE:
+    case BuiltinOperator_CUSTOM:
+    case BuiltinOperator_IF:
+    case BuiltinOperator_MULTINOMIAL:
+    case BuiltinOperator_RANDOM_STANDARD_NORMAL:
+    case BuiltinOperator_RANDOM_UNIFORM:
+    case BuiltinOperator_STABLEHLO_WHILE:
+    case BuiltinOperator_WHILE:
+      return true;
+    default:
+      break;
+  }
+  for (const auto* tensors : {op->inputs(), op->outputs()}) {
+    if (tensors == nullptr) continue;
+    for (const int tensor_index : *tensors) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      if (tensor_index < 0 || tensor_index >= subgraph.tensors_size()) {
+        return true;
+      }
+      const TfLiteTensor* tensor = subgraph.tensor(tensor_index);
+      if (tensor->is_variable || tensor->type == kTfLiteResource ||
+          tensor->type == kTfLiteVariant) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
+TfLiteStatus InterpreterBuilder::RematerializeNodes(
+    const flatbuffers::Vector<flatbuffers::Offset<Operator>>* operators,
+    const flatbuffers::Vector<flatbuffers::Offset<Tensor>>* tensors,
+    Subgraph* subgraph, std::vector<RematNode>* nodes) {
+  const int num_tensors = subgraph->tensors_size();
+  std::vector<int64_t> tensor_sizes(num_tensors);
+  for (int i = 0; i < num_tensors; ++i) {
+    const TfLiteTensor* tensor = subgraph->tensor(i);
+    // Constant tensors are not allocated in the arena.
+    tensor_sizes[i] = tensor->allocation_type == kTfLiteMmapRo ? 0
+                                                               : tensor->bytes;
+  }
+  std::vector<RematOperator> remat_operators(operators->size());
+  for (int i = 0; i < operators->size(); ++i) {
+    const auto* op = operators->Get(i);
+    const int index = op->opcode_index();
+    const TfLiteRegistration* registration =
+        index >= 0 && index < flatbuffer_op_index_to_registration_.size()
+            ? flatbuffer_op_index_to_registration_[index]
+            : nullptr;
+    remat_operators[i].inputs = FlatBufferIntArrayToVector(op->inputs());
+    remat_operators[i].outputs = FlatBufferIntArrayToVector(op->outputs());
+    remat_operators[i].is_stateful =
+        IsStatefulOperator(op, registration, *subgraph);
+  }
+
+  RematGraph graph = RematerializeGraph(
+      tensor_sizes, remat_operators, subgraph->inputs(), subgraph->outputs(),
+      options_.GetRematerializationBudget());
+  *nodes = std::move(graph.nodes);
+  if (graph.tensor_copies.empty()) return kTfLiteOk;
+
+  TF_LITE_ENSURE_STATUS(subgraph->AddTensors(graph.tensor_copies.size()));
+  for (int i = 0; i < graph.tensor_copies.size(); ++i) {
+    const int original_index = graph.tensor_copies[i];
+    const TfLiteTensor* original = subgraph->tensor(original_index);
+    const auto* src_tensor = tensors->Get(original_index);
+    std::vector<int> dims(original->dims->data,
+                          original->dims->data + original->dims->size);
+    std::vector<int> dims_signature;
+    if (src_tensor->shape_signature()) {
+      dims_signature =
+          FlatBufferIntArrayToVector(src_tensor->shape_signature());
+    }
+    TfLiteQuantization quantization;
+    TF_LITE_ENSURE_STATUS(
+        ParseQuantization(src_tensor->quantization(), &quantization, dims));
+    TF_LITE_ENSURE_STATUS(subgraph->SetTensorParametersReadWrite(
+        num_tensors + i, original->type, original->name, dims, quantization,
+        /*is_variable=*/false, dims_signature));
+  }
+  TFLITE_LOG_PROD(TFLITE_LOG_INFO,
+                  "Rematerialization runs %d operators again, which lowers the "
+                  "estimated peak size of the arena from %lld to %lld bytes.",
+                  graph.num_recomputed_ops,
+                  static_cast<long long>(graph.peak_bytes_before),
+                  static_cast<long long>(graph.peak_bytes_after));
+  return kTfLiteOk;
+}
+
 TfLiteStatus InterpreterBuilder::ParseNodes(
     const flatbuffers::Vector<flatbuffers::Offset<Operator>>* operators,
+    const flatbuffers::Vector<flatbuffers::Offset<Tensor>>* tensors,
     Subgraph* subgraph) {
   TfLiteStatus status = kTfLiteOk;
 
+  // The nodes are added in the order of the operators, unless
+  // rematerialization runs some of them again. Models with control
+  // dependencies rely on the order of their operators.
+  std::vector<RematNode> nodes;
+  if (options_.GetRematerializationBudget() > 0 &&
+      metadata_.find(kModelControlDependenciesMetadataKey) ==
+          metadata_.end()) {
+    TF_LITE_ENSURE_STATUS(
+        RematerializeNodes(operators, tensors, subgraph, &nodes));
+  } else {
+    nodes.reserve(operators->size());
+    for (int i = 0; i < operators->size(); ++i) {
+      const auto* op = operators->Get(i);
+      nodes.push_back({i, FlatBufferIntArrayToVector(op->inputs()),
+                       FlatBufferIntArrayToVector(op->outputs())});
+    }
+  }
+
   // Reduce the number of redundant allocations
-  subgraph->ReserveNodes(operators->size());
+  subgraph->ReserveNodes(nodes.size());
 
-  for (int i = 0; i < operators->size(); ++i) {
-    const auto* op = operators->Get(i);
+  for (const RematNode& node : nodes) {
+    const auto* op = operators->Get(node.op_index);
     int index = op->opcode_index();
     if (index < 0 || index >= flatbuffer_op_index_to_registration_.size()) {
       TF_LITE_REPORT_ERROR(error_reporter_,
@@ -368,8 +492,7 @@ TfLiteStatus InterpreterBuilder::ParseNodes(
     if (op_type == BuiltinOperator_CUSTOM) {
       if (op->custom_options()) {
         subgraph->AddNodeWithParameters(
-            FlatBufferIntArrayToVector(op->inputs()),
-            FlatBufferIntArrayToVector(op->outputs()),
+            node.inputs, node.outputs,
             FlatBufferIntArrayToVector(op->intermediates()),
             reinterpret_cast<const char*>(op->custom_options()->data()),
             op->custom_options()->size(), nullptr, registration);
@@ -385,16 +508,14 @@ TfLiteStatus InterpreterBuilder::ParseNodes(
         }
         // If the custom op is storing payloads outside of flatbuffers
         subgraph->AddNodeWithParameters(
-            FlatBufferIntArrayToVector(op->inputs()),
-            FlatBufferIntArrayToVector(op->outputs()),
+            node.inputs, node.outputs,
             FlatBufferIntArrayToVector(op->intermediates()),
             reinterpret_cast<const char*>(allocation_->base()) +
                 op->large_custom_options_offset(),
             op->large_custom_options_size(), nullptr, registration);
       } else {
         subgraph->AddNodeWithParameters(
-            FlatBufferIntArrayToVector(op->inputs()),
-            FlatBufferIntArrayToVector(op->outputs()),
+            node.inputs, node.outputs,
             FlatBufferIntArrayToVector(op->intermediates()), nullptr, 0,
             nullptr, registration);
       }
@@ -404,8 +525,7 @@ TfLiteStatus InterpreterBuilder::ParseNodes(
       TF_LITE_ENSURE_STATUS(ParseOpData(op, op_type, error_reporter_,
                                         &malloc_allocator, &builtin_data));
       subgraph->AddNodeWithParameters(
-          FlatBufferIntArrayToVector(op->inputs()),
-          FlatBufferIntArrayToVector(op->outputs()),
+          node.inputs, node.outputs,
           FlatBufferIntArrayToVector(op->intermediates()), nullptr, 0,
           builtin_data, registration);
     }
@@ -613,6 +733,14 @@ TfLiteStatus InterpreterBuilder::ParseTensors(
     subgraph_info->quantizations.resize(tensors->size());
   }
 
+  // The data of constant tensors in a memory-mapped model is read from the
+  // file on the first access unless it is prefetched.
+  const MMAPAllocation* prefetch_allocation = nullptr;
+  if (options_.GetPrefetchConstantTensors() && allocation_ &&
+      allocation_->type() == Allocation::Type::kMMap) {
+    prefetch_allocation = static_cast<const MMAPAllocation*>(allocation_);
+  }
+
   num_fp32_tensors_ = 0;
   for (int i = 0; i < tensors->size(); ++i) {
     const auto* tensor = tensors->Get(i);
@@ -665,6 +793,21 @@ TfLiteStatus InterpreterBuilder::ParseTensors(
     size_t buffer_size = 0;
     const char* buffer_ptr;
     TF_LITE_ENSURE_STATUS(get_readonly_data(&buffer_ptr, &buffer_size));
+    if (buffer_ptr && prefetch_allocation) {
+      const char* base = static_cast<const char*>(allocation_->base());
+      if (buffer_ptr >= base && buffer_ptr < base + allocation_->bytes()) {
+        prefetch_allocation->Prefetch(buffer_ptr - base, buffer_size);
+      }
+    }
+    // Shared buffers live outside of the allocation of the model.
+    const Allocation* buffer_allocation = allocation_;
+    if (buffer_ptr && options_.GetShareConstantBuffers() &&
+        buffer_size >= kMinSharedConstantBufferSize) {
+      shared_constant_buffers_.push_back(
+          ConstantBufferRegistry::Get()->Share(buffer_ptr, buffer_size));
+      buffer_ptr = shared_constant_buffers_.back().get();
+      buffer_allocation = nullptr;
+    }
 
     const auto* src_quantization = tensor->quantization();
     TfLiteQuantization quantization;
@@ -701,7 +844,7 @@ TfLiteStatus InterpreterBuilder::ParseTensors(
 
       if (subgraph->SetTensorParametersReadOnly(
               i, type, get_name(tensor), dims, quantization, buffer_ptr,
-              buffer_size, allocation_, sparsity) != kTfLiteOk) {
+              buffer_size, buffer_allocation, sparsity) != kTfLiteOk) {
         TF_LITE_REPORT_ERROR(error_reporter_,
                              "Tensor %d is invalidly specified in schema.\n",
                              i);
@@ -868,7 +1011,8 @@ TfLiteStatus InterpreterBuilder::operator()(
     if (ParseTensors(buffers, tensors, modified_subgraph, subgraph_info) !=
         kTfLiteOk)
       return cleanup_and_error();
-    if (operators && ParseNodes(operators, modified_subgraph) != kTfLiteOk)
+    if (operators &&
+        ParseNodes(operators, tensors, modified_subgraph) != kTfLiteOk)
       return cleanup_and_error();
 
     std::vector<int> variables;
@@ -884,6 +1028,10 @@ TfLiteStatus InterpreterBuilder::operator()(
     }
   }
 
+  (*interpreter)->shared_constant_buffers_ =
+      std::move(shared_constant_buffers_);
+  shared_constant_buffers_.clear();
+
   if (ParseSignatureDefs(model_->signature_defs(), interpreter->get()) !=
       kTfLiteOk) {
     return cleanup_and_error();
@@ -46,6 +46,8 @@ limitations under the License.
 
 namespace tflite {
 
+struct RematNode;
+
 /// Build an interpreter capable of interpreting `model`.
 ///
 /// * `model`: A model whose lifetime must be at least as long as any
@@ -131,7 +133,15 @@ class InterpreterBuilder {
   TfLiteStatus BuildLocalIndexToRegistrationMapping();
   TfLiteStatus ParseNodes(
       const flatbuffers::Vector<flatbuffers::Offset<Operator>>* operators,
+      const flatbuffers::Vector<flatbuffers::Offset<Tensor>>* tensors,
       Subgraph* subgraph);
+  // Chooses the order in which the nodes are added to `subgraph` when
+  // rematerialization is enabled, and adds the tensors of the nodes that are
+  // run again.
+  TfLiteStatus RematerializeNodes(
+      const flatbuffers::Vector<flatbuffers::Offset<Operator>>* operators,
+      const flatbuffers::Vector<flatbuffers::Offset<Tensor>>* tensors,
+      Subgraph* subgraph, std::vector<RematNode>* nodes);
   TfLiteStatus ParseTensors(
       const flatbuffers::Vector<flatbuffers::Offset<Buffer>>* buffers,
       const flatbuffers::Vector<flatbuffers::Offset<Tensor>>* tensors,
@@ -162,6 +172,8 @@ class InterpreterBuilder {
   std::vector<TfLiteRegistration> unresolved_custom_ops_;
   std::vector<BuiltinOperator> flatbuffer_op_index_to_registration_types_;
   const Allocation* allocation_ = nullptr;
+  // The constant buffers shared with other models, handed to the interpreter.
+  std::vector<std::shared_ptr<const char>> shared_constant_buffers_;
 
   bool has_flex_op_ = false;
   int num_fp32_tensors_ = 0;
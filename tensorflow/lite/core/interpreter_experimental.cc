@@ -78,6 +78,11 @@ void Interpreter::SetCancellationFunction(void* data,
   }
 }
 
+void Interpreter::SetParallelInvoke(
+    Subgraph::ParallelForFunction parallel_for) {
+  primary_subgraph().SetParallelInvoke(std::move(parallel_for));
+}
+
 bool Interpreter::IsCancelled() { return primary_subgraph().IsCancelled(); }
 
 TfLiteStatus Interpreter::ModifyGraphWithDelegate(TfLiteDelegate* delegate) {
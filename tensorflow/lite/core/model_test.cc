@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/lite/core/interpreter_builder.h"
 #include "tensorflow/lite/core/kernels/register.h"
 #include "tensorflow/lite/core/model_builder.h"
+#include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/interpreter_test_util.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow/lite/string_type.h"
@@ -268,6 +269,30 @@ TEST(BasicFlatBufferModel, TestModelInInterpreter) {
   }
 }
 
+TEST(BasicFlatBufferModel, TestPrefetchConstantTensors) {
+  auto model = FlatBufferModel::BuildFromFile(
+      "tensorflow/lite/testdata/test_model.bin");
+  ASSERT_TRUE(model);
+  std::unique_ptr<Interpreter> expected;
+  ASSERT_EQ(InterpreterBuilder(*model, TrivialResolver(&dummy_reg))(&expected),
+            kTfLiteOk);
+
+  InterpreterOptions options;
+  options.SetPrefetchConstantTensors();
+  std::unique_ptr<Interpreter> interpreter;
+  ASSERT_EQ(InterpreterBuilder(*model, TrivialResolver(&dummy_reg),
+                               &options)(&interpreter),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter->tensors_size(), expected->tensors_size());
+  ASSERT_EQ(interpreter->nodes_size(), expected->nodes_size());
+  const TfLiteTensor* constant = interpreter->tensor(0);
+  ASSERT_EQ(constant->allocation_type, kTfLiteMmapRo);
+  ASSERT_EQ(constant->bytes, expected->tensor(0)->bytes);
+  EXPECT_EQ(memcmp(constant->data.raw, expected->tensor(0)->data.raw,
+                   constant->bytes),
+            0);
+}
+
 TEST(BasicFlatBufferModel, TestWithNumThreads) {
   TestErrorReporter reporter;
   auto model = FlatBufferModel::BuildFromFile(
@@ -24,6 +24,7 @@ limitations under the License.
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -40,6 +41,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/c_api_types.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
 #include "tensorflow/lite/graph_info.h"
 #include "tensorflow/lite/memory_planner.h"
 #include "tensorflow/lite/minimal_logging.h"
@@ -68,6 +70,24 @@ struct TfLiteQuantizationDeleter {
 using ScopedTfLiteQuantization =
     std::unique_ptr<TfLiteQuantization, TfLiteQuantizationDeleter>;
 
+// Keeps a CPU backend context leased from a pool (see
+// ExternalCpuBackendContext) until the outermost subgraph call is done, and
+// then returns it so that other interpreters sharing the pool can use it.
+class ScopedCpuBackendContextLease {
+ public:
+  explicit ScopedCpuBackendContextLease(TfLiteContext* context)
+      : external_context_(static_cast<ExternalCpuBackendContext*>(
+            context->GetExternalContext(context, kTfLiteCpuBackendContext))) {
+    if (external_context_ != nullptr) external_context_->EnterLeaseScope();
+  }
+  ~ScopedCpuBackendContextLease() {
+    if (external_context_ != nullptr) external_context_->ExitLeaseScope();
+  }
+
+ private:
+  ExternalCpuBackendContext* const external_context_;
+};
+
 struct TfLiteSparsityDeleter {
   void operator()(TfLiteSparsity* s) {
     if (s) TfLiteSparsityFree(s);
@@ -131,6 +151,53 @@ bool HasDynamicTensor(const TfLiteContext& context,
                               dynamic_tensor_index);
 }
 
+// Returns true if the node has side effects beyond writing its outputs, or
+// may depend on such effects of other nodes, and must not run concurrently
+// with any other node.
+bool MustRunAlone(const TfLiteContext& context, const TfLiteNode& node,
+                  const TfLiteRegistration& registration) {
+  switch (registration.builtin_code) {
+    case kTfLiteBuiltinCall:
+    case kTfLiteBuiltinCallOnce:
+    case kTfLiteBuiltinCustom:
+    case kTfLiteBuiltinDelegate:
+    case kTfLiteBuiltinIf:
+    case kTfLiteBuiltinWhile:
+    case kTfLiteBuiltinStablehloWhile:
+    case kTfLiteBuiltinVarHandle:
+    case kTfLiteBuiltinReadVariable:
+    case kTfLiteBuiltinAssignVariable:
+      return true;
+    default:
+      break;
+  }
+  for (int i : TfLiteIntArrayView(node.inputs)) {
+    if (i == kTfLiteOptionalTensor) continue;
+    const TfLiteTensor& tensor = context.tensors[i];
+    if (tensor.is_variable || tensor.type == kTfLiteResource ||
+        tensor.type == kTfLiteVariant) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the shapes of the given input tensors.
+std::vector<std::vector<int>> GetInputDims(const TfLiteContext& context,
+                                           const std::vector<int>& inputs) {
+  std::vector<std::vector<int>> input_dims;
+  input_dims.reserve(inputs.size());
+  for (int i : inputs) {
+    if (i == kTfLiteOptionalTensor) {
+      input_dims.emplace_back();
+      continue;
+    }
+    const TfLiteIntArray* dims = context.tensors[i].dims;
+    input_dims.emplace_back(dims->data, dims->data + dims->size);
+  }
+  return input_dims;
+}
+
 // Gets the legacy TfLiteQuantizationParams from the current TfLiteQuantization.
 TfLiteQuantizationParams GetLegacyQuantization(
     const TfLiteQuantization& quantization) {
@@ -286,6 +353,7 @@ Subgraph::Subgraph(ErrorReporter* error_reporter,
 }
 
 Subgraph::~Subgraph() {
+  ClearPreparedStates();
   for (int node_index = 0; node_index < nodes_and_registration_.size();
        ++node_index) {
     CleanupNode(node_index);
@@ -964,6 +1032,7 @@ std::vector<int> Subgraph::GetInputTensorsCount() {
 }
 
 TfLiteStatus Subgraph::AllocateTensors() {
+  ScopedCpuBackendContextLease lease(&context_);
   if (!consistent_) {
     ReportError("AllocateTensors() called on inconsistent model.");
     return kTfLiteError;
@@ -1000,14 +1069,26 @@ TfLiteStatus Subgraph::AllocateTensors() {
   // Profile "AllocateTensors" only when memory planning is needed.
   TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_.get(), "AllocateTensors");
 
+  bool prepared_state_restored = false;
+  TF_LITE_ENSURE_STATUS(SwitchPreparedState(&prepared_state_restored));
+
   next_execution_plan_index_to_prepare_ = 0;
   next_execution_plan_index_to_plan_allocation_ = 0;
   next_original_execution_plan_index_to_prepare_ = 0;
   if (memory_planner_) {
     TF_LITE_ENSURE_STATUS(memory_planner_->ResetAllocations());
   }
+  if (prepared_state_restored) {
+    // The ops are already prepared for these input shapes, only the memory
+    // has to be allocated again.
+    next_execution_plan_index_to_prepare_ = execution_plan_.size();
+    has_dynamic_tensors_ = false;
+  }
 
   TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
+  if (PreparedStateCacheSize() > 0 && CanCachePreparedState()) {
+    prepared_input_dims_ = GetInputDims(context_, inputs_);
+  }
 
   state_ = kStateInvokable;
 
@@ -1511,7 +1592,8 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
         last_original_exec_plan_index_prepared + 1;
   }
 
-  int last_exec_plan_index_prepared = 0;
+  int last_exec_plan_index_prepared =
+      std::max(next_execution_plan_index_to_prepare_ - 1, 0);
   TF_LITE_ENSURE_STATUS(
       PrepareOpsStartingAt(next_execution_plan_index_to_prepare_,
                            execution_plan_, &last_exec_plan_index_prepared));
@@ -1525,7 +1607,25 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
         &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
         kDefaultTensorAlignment, subgraph_index_);
 #endif
+    if (parallel_for_ && delegates_applied_.empty() && !has_dynamic_tensors_ &&
+        next_execution_plan_index_to_prepare_ == execution_plan_.size()) {
+      PlanConcurrentStages();
+      if (!concurrent_stage_ends_.empty() &&
+          memory_planner_->SetConcurrentStages(concurrent_stage_ends_) !=
+              kTfLiteOk) {
+        concurrent_stage_ends_.clear();
+      }
+    }
     memory_planner_->PlanAllocations();
+
+    const char* plans = nullptr;
+    size_t plans_bytes = 0;
+    if (GetModelMetadata(MemoryPlansMetadataKey(subgraph_index_).c_str(),
+                         &plans, &plans_bytes) == kTfLiteOk &&
+        memory_planner_->RestorePlans(plans, plans_bytes) != kTfLiteOk) {
+      TFLITE_LOG(TFLITE_LOG_WARNING,
+                 "Ignoring invalid memory plans in the model metadata.");
+    }
   }
 
   // Execute arena allocations.
@@ -1564,6 +1664,240 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   return kTfLiteOk;
 }
 
+void Subgraph::PlanConcurrentStages() {
+  // A node goes in the stage after the latest one producing its inputs, but
+  // never before a node that has to run alone.
+  std::vector<int> tensor_stage(tensors_.size(), -1);
+  std::vector<int> node_stage(execution_plan_.size());
+  int num_stages = 0;
+  int first_stage = 0;
+  for (int i = 0; i < execution_plan_.size(); ++i) {
+    const TfLiteNode& node = nodes_and_registration_[execution_plan_[i]].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[execution_plan_[i]].second;
+    const bool run_alone = MustRunAlone(context_, node, registration);
+    int stage = run_alone ? num_stages : first_stage;
+    for (int t : TfLiteIntArrayView(node.inputs)) {
+      if (t == kTfLiteOptionalTensor) continue;
+      stage = std::max(stage, tensor_stage[t] + 1);
+    }
+    for (int t : TfLiteIntArrayView(node.outputs)) {
+      if (t != kTfLiteOptionalTensor) tensor_stage[t] = stage;
+    }
+    if (node.intermediates) {
+      for (int t : TfLiteIntArrayView(node.intermediates)) {
+        if (t != kTfLiteOptionalTensor) tensor_stage[t] = stage;
+      }
+    }
+    node_stage[i] = stage;
+    num_stages = std::max(num_stages, stage + 1);
+    if (run_alone) first_stage = stage + 1;
+  }
+  if (num_stages == execution_plan_.size()) return;
+
+  // Stages are never empty, so the stable sort keeps a topological order.
+  std::vector<int> order(execution_plan_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return node_stage[a] < node_stage[b];
+  });
+  std::vector<int> plan;
+  plan.reserve(order.size());
+  for (int i : order) plan.push_back(execution_plan_[i]);
+  execution_plan_ = std::move(plan);
+
+  concurrent_stage_ends_.assign(num_stages, 0);
+  for (int stage : node_stage) ++concurrent_stage_ends_[stage];
+  std::partial_sum(concurrent_stage_ends_.begin(), concurrent_stage_ends_.end(),
+                   concurrent_stage_ends_.begin());
+}
+
+bool Subgraph::CanInvokeConcurrently() const {
+  return parallel_for_ && !concurrent_stage_ends_.empty() &&
+         concurrent_stage_ends_.back() == execution_plan_.size() &&
+         delegates_applied_.empty() && !has_dynamic_tensors_ && !profiler_ &&
+         next_execution_plan_index_to_prepare_ == execution_plan_.size();
+}
+
+TfLiteStatus Subgraph::InvokeConcurrentStages() {
+  std::vector<TfLiteStatus> statuses;
+  int stage_begin = 0;
+  for (int stage_end : concurrent_stage_ends_) {
+    if (check_cancelled_func_ != nullptr &&
+        check_cancelled_func_(cancellation_data_)) {
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteError;
+    }
+    if (continue_invocation_ && !continue_invocation_->test_and_set()) {
+      // `Cancel` is called and cancellation flag is flipped.
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteCancelled;
+    }
+
+    EnsureTensorsVectorCapacity();
+    const int num_nodes = stage_end - stage_begin;
+    statuses.assign(num_nodes, kTfLiteOk);
+    auto invoke_node = [&](int i) {
+      auto& node_and_registration =
+          nodes_and_registration_[execution_plan_[stage_begin + i]];
+      statuses[i] = OpInvoke(node_and_registration.second,
+                             &node_and_registration.first);
+    };
+    if (num_nodes == 1) {
+      invoke_node(0);
+    } else {
+      parallel_for_(num_nodes, invoke_node);
+    }
+
+    for (int i = 0; i < num_nodes; ++i) {
+      if (statuses[i] == kTfLiteOk) continue;
+      const int node_index = execution_plan_[stage_begin + i];
+      auto err = ReportOpError(
+          &context_, nodes_and_registration_[node_index].first,
+          nodes_and_registration_[node_index].second, node_index,
+          "failed to invoke");
+      return statuses[i] == kTfLiteCancelled ? statuses[i] : err;
+    }
+    stage_begin = stage_end;
+  }
+  return kTfLiteOk;
+}
+
+bool Subgraph::CanCachePreparedState() const {
+  if (!delegates_applied_.empty() || has_dynamic_tensors_ ||
+      !custom_allocations_.empty()) {
+    return false;
+  }
+  // Persistent arena tensors may hold data computed once by the ops, which
+  // wouldn't survive planning the arena for other shapes.
+  for (const TfLiteTensor& tensor : tensors_) {
+    if (tensor.allocation_type == kTfLiteArenaRwPersistent) return false;
+  }
+  // Control flow ops prepare other subgraphs, whose state isn't cached.
+  for (int node_index : execution_plan_) {
+    switch (nodes_and_registration_[node_index].second.builtin_code) {
+      case kTfLiteBuiltinCall:
+      case kTfLiteBuiltinCallOnce:
+      case kTfLiteBuiltinDelegate:
+      case kTfLiteBuiltinIf:
+      case kTfLiteBuiltinWhile:
+      case kTfLiteBuiltinStablehloWhile:
+        return false;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+TfLiteStatus Subgraph::SwitchPreparedState(bool* restored) {
+  *restored = false;
+  const int cache_size = PreparedStateCacheSize();
+  if (cache_size <= 0 || !CanCachePreparedState()) {
+    ClearPreparedStates();
+    prepared_input_dims_.clear();
+    return kTfLiteOk;
+  }
+  std::vector<std::vector<int>> input_dims = GetInputDims(context_, inputs_);
+  if (prepared_input_dims_.empty() || prepared_input_dims_ == input_dims) {
+    return kTfLiteOk;
+  }
+
+  // Move the current state to the cache. The inputs were already resized, but
+  // the ops and the other tensors still match `prepared_input_dims_`.
+  PreparedState current;
+  current.input_dims = std::move(prepared_input_dims_);
+  prepared_input_dims_.clear();
+  for (auto& node_and_registration : nodes_and_registration_) {
+    TfLiteNode& node = node_and_registration.first;
+    current.user_data.push_back(node.user_data);
+    current.temporaries.push_back(node.temporaries);
+    node.user_data = nullptr;
+    node.temporaries = nullptr;
+  }
+  std::vector<bool> is_input(tensors_.size(), false);
+  for (int i : inputs_) {
+    if (i != kTfLiteOptionalTensor) is_input[i] = true;
+  }
+  current.tensor_dims.assign(tensors_.size(), nullptr);
+  current.tensor_bytes.assign(tensors_.size(), 0);
+  for (int i = 0; i < tensors_.size(); ++i) {
+    if (tensors_[i].allocation_type != kTfLiteArenaRw || is_input[i]) continue;
+    current.tensor_dims[i] = TfLiteIntArrayCopy(tensors_[i].dims);
+    current.tensor_bytes[i] = tensors_[i].bytes;
+  }
+
+  auto cached = std::find_if(
+      prepared_states_.begin(), prepared_states_.end(),
+      [&](const PreparedState& state) { return state.input_dims == input_dims; });
+  if (cached != prepared_states_.end()) {
+    PreparedState state = std::move(*cached);
+    prepared_states_.erase(cached);
+    // Nodes may have been added since the state was cached.
+    if (state.user_data.size() == nodes_and_registration_.size()) {
+      for (int i = 0; i < nodes_and_registration_.size(); ++i) {
+        TfLiteNode& node = nodes_and_registration_[i].first;
+        node.user_data = state.user_data[i];
+        node.temporaries = state.temporaries[i];
+        state.user_data[i] = nullptr;
+        state.temporaries[i] = nullptr;
+      }
+      for (int i = 0; i < state.tensor_dims.size(); ++i) {
+        if (state.tensor_dims[i] == nullptr) continue;
+        TfLiteIntArrayFree(tensors_[i].dims);
+        tensors_[i].dims = state.tensor_dims[i];
+        tensors_[i].bytes = state.tensor_bytes[i];
+        state.tensor_dims[i] = nullptr;
+      }
+      *restored = true;
+    }
+    FreePreparedState(&state);
+  }
+  if (!*restored) {
+    // Ops keep their shape dependent state in their op data, so the new
+    // shapes get their own.
+    for (auto& node_and_registration : nodes_and_registration_) {
+      TfLiteNode& node = node_and_registration.first;
+      const TfLiteRegistration& registration = node_and_registration.second;
+      node.user_data =
+          node.custom_initial_data
+              ? OpInit(registration,
+                       static_cast<const char*>(node.custom_initial_data),
+                       node.custom_initial_data_size)
+              : OpInit(registration,
+                       static_cast<const char*>(node.builtin_data), 0);
+      node.temporaries = TfLiteIntArrayCreate(0);
+    }
+  }
+
+  prepared_states_.push_back(std::move(current));
+  while (prepared_states_.size() > cache_size) {
+    FreePreparedState(&prepared_states_.front());
+    prepared_states_.erase(prepared_states_.begin());
+  }
+  return kTfLiteOk;
+}
+
+void Subgraph::FreePreparedState(PreparedState* state) {
+  for (int i = 0; i < state->user_data.size(); ++i) {
+    if (state->user_data[i] != nullptr && i < nodes_and_registration_.size()) {
+      OpFree(nodes_and_registration_[i].second, state->user_data[i]);
+    }
+    TfLiteIntArrayFree(state->temporaries[i]);
+  }
+  for (TfLiteIntArray* dims : state->tensor_dims) {
+    TfLiteIntArrayFree(dims);
+  }
+  *state = PreparedState();
+}
+
+void Subgraph::ClearPreparedStates() {
+  for (PreparedState& state : prepared_states_) {
+    FreePreparedState(&state);
+  }
+  prepared_states_.clear();
+}
+
 TfLiteStatus Subgraph::RemoveUnusedInputs() {
   std::vector<int> input_tensors_count = GetInputTensorsCount();
   // Mark unused inputs as kTfLiteOptionalTensor.
@@ -1578,6 +1912,7 @@ TfLiteStatus Subgraph::RemoveUnusedInputs() {
 }
 
 TfLiteStatus Subgraph::Invoke() {
+  ScopedCpuBackendContextLease lease(&context_);
   auto status = InvokeImpl();
   telemetry::TelemetryReportEvent(&context_, "Invoke", status);
   return status;
@@ -1602,6 +1937,14 @@ TfLiteStatus Subgraph::InvokeImpl() {
       tflite::OnTfLiteSubgraphInvoke(name_.c_str(), subgraph_index_);
 #endif  // TF_LITE_TENSORFLOW_PROFILER
 
+  if (CanInvokeConcurrently()) {
+    status = InvokeConcurrentStages();
+#ifdef TF_LITE_TENSORFLOW_PROFILER
+    tflite::OnTfLiteSubgraphInvokeEnd(trace_subgraph);
+#endif  // TF_LITE_TENSORFLOW_PROFILER
+    return status;
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
@@ -1955,6 +2298,7 @@ TfLiteStatus Subgraph::SetExecutionPlan(const std::vector<int>& new_plan) {
                                   node_index < nodes_and_registration_.size());
   }
   execution_plan_ = new_plan;
+  concurrent_stage_ends_.clear();
   return kTfLiteOk;
 }
 
@@ -2376,6 +2720,15 @@ void Subgraph::DumpMemoryPlannerDebugInfo() const {
   memory_planner_->DumpDebugInfo(execution_plan());
 }
 
+std::string Subgraph::SerializeMemoryPlans() const {
+  if (memory_planner_ == nullptr) return "";
+  return memory_planner_->SerializePlans();
+}
+
+std::string Subgraph::MemoryPlansMetadataKey(int subgraph_index) {
+  return "arena_memory_plans_" + std::to_string(subgraph_index);
+}
+
 void Subgraph::GetMemoryAllocInfo(SubgraphAllocInfo* alloc_info) const {
   memset(alloc_info, 0, sizeof(SubgraphAllocInfo));
   if (memory_planner_ == nullptr) return;
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -319,6 +320,28 @@ class Subgraph {
   // WARNING: This is an experimental API and subject to change.
   void SetCancellationFunction(void* data, bool (*check_cancelled_func)(void*));
 
+  // Runs `task(0)`, ..., `task(num_tasks - 1)`, possibly concurrently, and
+  // returns once all of them have finished.
+  using ParallelForFunction =
+      std::function<void(int num_tasks, const std::function<void(int)>& task)>;
+
+  // Enables executing independent nodes concurrently through `parallel_for`.
+  // When tensors are allocated, the execution plan is reordered into stages
+  // of nodes that don't depend on each other, and the memory planner keeps the
+  // tensors of a stage from sharing memory (which may grow the arena). Invoke()
+  // then runs the nodes of each stage with a single `parallel_for` call.
+  // Control flow, resource and custom ops, and ops updating variable tensors
+  // always run alone. Graphs with dynamic tensors, delegates or a profiler
+  // are invoked sequentially.
+  // Kernels running concurrently share the subgraph's external contexts (e.g.
+  // the CPU backend context), so this must only be used with kernels that
+  // are safe to invoke concurrently. Passing an empty function disables it.
+  // Must be called before AllocateTensors().
+  // WARNING: This is an experimental API and subject to change.
+  void SetParallelInvoke(ParallelForFunction parallel_for) {
+    parallel_for_ = std::move(parallel_for);
+  }
+
   // Ensure the data in `tensor.data` is readable. In case delegate is used,
   // it might require to copy the data from delegate buffer to raw memory.
   // WARNING: This is an experimental API and subject to change.
@@ -428,6 +451,19 @@ class Subgraph {
   // Returns memory allocation status.
   void GetMemoryAllocInfo(SubgraphAllocInfo* alloc_info) const;
 
+  // WARNING: This is an experimental API and subject to change.
+  // Returns the memory plans computed so far for the tensor sizes seen by
+  // AllocateTensors() and Invoke(), serialized to be stored in the model
+  // metadata under `MemoryPlansMetadataKey(subgraph_index)`. When the model
+  // carries them, matching tensor sizes reuse the stored plan instead of
+  // computing offsets again. Returns an empty string if tensors were never
+  // allocated or the memory planner doesn't support it.
+  std::string SerializeMemoryPlans() const;
+
+  // Name of the model metadata holding the serialized memory plans of the
+  // subgraph with the given index.
+  static std::string MemoryPlansMetadataKey(int subgraph_index);
+
   // WARNING: This is an experimental API and subject to change.
   // Set the given `InterpreterOptions` object.
   void SetOptions(InterpreterOptions* options) { options_ = options; }
@@ -474,6 +510,13 @@ class Subgraph {
     return (options_ && options_->GetDisableDelegateClustering());
   }
 
+  // WARNING: This is an experimental API and subject to change.
+  // Number of prepared states kept for other input shapes. See
+  // `InterpreterOptions::SetPreparedStateCacheSize`.
+  int PreparedStateCacheSize() const {
+    return options_ ? options_->GetPreparedStateCacheSize() : 0;
+  }
+
   // Retrieves the corresponding TfLiteContext of a subgraph given a subgraph
   // index and switches to the delegate context for this subgraph. If an invalid
   // subgraph index is given, returns kTfLiteError.
@@ -658,6 +701,45 @@ class Subgraph {
   // Invoke the operator represented by 'node'.
   TfLiteStatus OpInvoke(const TfLiteRegistration& op_reg, TfLiteNode* node);
 
+  // Reorders the execution plan into stages of mutually independent nodes and
+  // fills `concurrent_stage_ends_`. Leaves both untouched if no stage has more
+  // than one node.
+  void PlanConcurrentStages();
+
+  // True if the nodes of each concurrent stage can be invoked concurrently.
+  bool CanInvokeConcurrently() const;
+
+  // The state ops leave behind when prepared for given input shapes.
+  struct PreparedState {
+    std::vector<std::vector<int>> input_dims;
+    // Per node. The state owns the op data and the arrays.
+    std::vector<void*> user_data;
+    std::vector<TfLiteIntArray*> temporaries;
+    // Per arena tensor, indexed by tensor. Null for other tensors.
+    std::vector<TfLiteIntArray*> tensor_dims;
+    std::vector<size_t> tensor_bytes;
+  };
+
+  // True if the prepared state of the graph only lives in its nodes and
+  // arena tensors, so it can be cached and restored.
+  bool CanCachePreparedState() const;
+
+  // Called by AllocateTensors() when the input shapes changed. Caches the
+  // current prepared state and replaces it with the one cached for the new
+  // input shapes if any, in which case `*restored` is set and the ops don't
+  // need to be prepared. Otherwise the ops get fresh op data.
+  TfLiteStatus SwitchPreparedState(bool* restored);
+
+  // Releases the op data and arrays owned by `state`.
+  void FreePreparedState(PreparedState* state);
+
+  // Drops all cached prepared states.
+  void ClearPreparedStates();
+
+  // Invokes the execution plan stage by stage, running the nodes of a stage
+  // through `parallel_for_`.
+  TfLiteStatus InvokeConcurrentStages();
+
   // Call OpPrepare() for as many ops as possible, allocating memory for their
   // tensors. If an op containing dynamic tensors is found, preparation will be
   // postponed until this function is called again. This allows the interpreter
@@ -1091,6 +1173,20 @@ class Subgraph {
   // `check_cancelled_func_`.
   void* cancellation_data_ = nullptr;
 
+  // Runs independent nodes concurrently if set. See `SetParallelInvoke`.
+  ParallelForFunction parallel_for_;
+
+  // Exclusive end indices in `execution_plan_` of the stages whose nodes may
+  // run concurrently. Empty if nodes have to run one after the other.
+  std::vector<int> concurrent_stage_ends_;
+
+  // Prepared states for other input shapes, from least to most recently used.
+  std::vector<PreparedState> prepared_states_;
+
+  // Input shapes the ops are currently prepared for, if cached states are
+  // enabled. Empty if unknown.
+  std::vector<std::vector<int>> prepared_input_dims_;
+
   // A map of resources. Owned by interpreter and shared by multiple subgraphs.
   resource::ResourceMap* resources_ = nullptr;
 
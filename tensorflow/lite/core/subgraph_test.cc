@@ -17,15 +17,19 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <numeric>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
 #include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/stderr_reporter.h"
 #include "tensorflow/lite/util.h"
 
@@ -35,6 +39,7 @@ namespace ops {
 namespace builtin {
 TfLiteRegistration* Register_PADV2();
 TfLiteRegistration* Register_NEG();
+TfLiteRegistration* Register_ADD();
 }  // namespace builtin
 }  // namespace ops
 
@@ -123,6 +128,138 @@ TEST(MarkSubgraphAsDelegationSkippable, MarkSubgraphAsDelegationSkippable) {
   ASSERT_TRUE(subgraphs[1]->IsDelegationSkippable());
 }
 
+TEST(ParallelInvoke, RunsIndependentNodesConcurrently) {
+  Interpreter interpreter;
+  auto& subgraph = interpreter.primary_subgraph();
+  subgraph.AddTensors(5);
+  subgraph.SetInputs({0});
+  subgraph.SetOutputs({4});
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(subgraph.SetTensorParametersReadWrite(
+                  i, kTfLiteFloat32, "", {2}, TfLiteQuantization()),
+              kTfLiteOk);
+  }
+  auto add_params = [] {
+    auto* params =
+        reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+    params->activation = kTfLiteActNone;
+    params->pot_scale_int16 = false;
+    return params;
+  };
+  TfLiteRegistration* neg_op = tflite::ops::builtin::Register_NEG();
+  TfLiteRegistration* add_op = tflite::ops::builtin::Register_ADD();
+  // 1 = -x, 2 = -1 = x, 3 = x + x, 4 = 2 + 3 = 3x
+  subgraph.AddNodeWithParameters({0}, {1}, {}, nullptr, 0, nullptr, neg_op);
+  subgraph.AddNodeWithParameters({1}, {2}, {}, nullptr, 0, nullptr, neg_op);
+  subgraph.AddNodeWithParameters({0, 0}, {3}, {}, nullptr, 0, add_params(),
+                                 add_op);
+  subgraph.AddNodeWithParameters({2, 3}, {4}, {}, nullptr, 0, add_params(),
+                                 add_op);
+
+  std::vector<int> parallel_for_tasks;
+  subgraph.SetParallelInvoke(
+      [&](int num_tasks, const std::function<void(int)>& task) {
+        parallel_for_tasks.push_back(num_tasks);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_tasks; ++i) threads.emplace_back(task, i);
+        for (auto& thread : threads) thread.join();
+      });
+  ASSERT_EQ(subgraph.AllocateTensors(), kTfLiteOk);
+  // The two independent chains are interleaved into stages.
+  EXPECT_THAT(subgraph.execution_plan(), ElementsAreArray({0, 2, 1, 3}));
+
+  float* input = subgraph.tensor(0)->data.f;
+  input[0] = 1;
+  input[1] = 2;
+  ASSERT_EQ(subgraph.Invoke(), kTfLiteOk);
+  EXPECT_THAT(parallel_for_tasks, ElementsAreArray({2}));
+  const float* output = subgraph.tensor(4)->data.f;
+  EXPECT_EQ(output[0], 3);
+  EXPECT_EQ(output[1], 6);
+}
+
+// An op negating its input, which counts how often it is prepared and keeps
+// the number of elements it was prepared for in its op data.
+int num_negate_prepares = 0;
+
+int ElementCount(const TfLiteIntArray* dims) {
+  return std::accumulate(dims->data, dims->data + dims->size, 1,
+                         std::multiplies<int>());
+}
+
+TfLiteRegistration* GetCountingNegateRegistration() {
+  static TfLiteRegistration registration = [] {
+    TfLiteRegistration r{};
+    r.init = [](TfLiteContext*, const char*, size_t) -> void* {
+      return new int(0);
+    };
+    r.free = [](TfLiteContext*, void* buffer) {
+      delete static_cast<int*>(buffer);
+    };
+    r.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+      ++num_negate_prepares;
+      const TfLiteTensor& input = context->tensors[node->inputs->data[0]];
+      *static_cast<int*>(node->user_data) = ElementCount(input.dims);
+      return context->ResizeTensor(
+          context, &context->tensors[node->outputs->data[0]],
+          TfLiteIntArrayCopy(input.dims));
+    };
+    r.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+      const float* input = context->tensors[node->inputs->data[0]].data.f;
+      float* output = context->tensors[node->outputs->data[0]].data.f;
+      for (int i = 0; i < *static_cast<int*>(node->user_data); ++i) {
+        output[i] = -input[i];
+      }
+      return kTfLiteOk;
+    };
+    r.builtin_code = kTfLiteBuiltinNeg;
+    return r;
+  }();
+  return &registration;
+}
+
+TEST(PreparedStateCache, SwitchesBetweenInputShapesWithoutPreparing) {
+  InterpreterOptions options;
+  options.SetPreparedStateCacheSize(1);
+  Interpreter interpreter;
+  auto& subgraph = interpreter.primary_subgraph();
+  subgraph.SetOptions(&options);
+  subgraph.AddTensors(3);
+  subgraph.SetInputs({0});
+  subgraph.SetOutputs({2});
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(subgraph.SetTensorParametersReadWrite(
+                  i, kTfLiteFloat32, "", {1}, TfLiteQuantization()),
+              kTfLiteOk);
+  }
+  TfLiteRegistration* negate = GetCountingNegateRegistration();
+  subgraph.AddNodeWithParameters({0}, {1}, {}, nullptr, 0, nullptr, negate);
+  subgraph.AddNodeWithParameters({1}, {2}, {}, nullptr, 0, nullptr, negate);
+
+  auto run = [&](int size) {
+    EXPECT_EQ(subgraph.ResizeInputTensor(0, {size}), kTfLiteOk);
+    EXPECT_EQ(subgraph.AllocateTensors(), kTfLiteOk);
+    for (int i = 0; i < size; ++i) subgraph.tensor(0)->data.f[i] = i;
+    EXPECT_EQ(subgraph.Invoke(), kTfLiteOk);
+    EXPECT_EQ(ElementCount(subgraph.tensor(2)->dims), size);
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(subgraph.tensor(2)->data.f[i], i);
+    }
+  };
+  num_negate_prepares = 0;
+  run(2);
+  run(3);
+  EXPECT_EQ(num_negate_prepares, 4);
+  // Both shapes are cached now.
+  run(2);
+  run(3);
+  EXPECT_EQ(num_negate_prepares, 4);
+  // The least recently used shape is dropped.
+  run(4);
+  run(2);
+  EXPECT_EQ(num_negate_prepares, 8);
+}
+
 // Helper to get the minimal buffer size to allocate for a buffer of given
 // shape.
 size_t BytesFor(const TfLiteType type, const int* const data,
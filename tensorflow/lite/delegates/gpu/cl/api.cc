@@ -36,6 +36,7 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/cl/inference_context.h"
 #include "tensorflow/lite/delegates/gpu/cl/kernels/converter.h"
 #include "tensorflow/lite/delegates/gpu/cl/opencl_wrapper.h"
+#include "tensorflow/lite/delegates/gpu/cl/program_binary_disk_cache.h"
 #include "tensorflow/lite/delegates/gpu/cl/tensor.h"
 #include "tensorflow/lite/delegates/gpu/cl/tensor_type_util.h"
 #include "tensorflow/lite/delegates/gpu/common/data_type.h"
@@ -925,6 +926,12 @@ class InferenceEnvironmentImpl : public InferenceEnvironment {
         CreateProfilingCommandQueue(device, context, &profiling_queue));
     environment_ = Environment(std::move(device), std::move(context),
                                std::move(queue), std::move(profiling_queue));
+    if (!options_.program_cache_dir.empty()) {
+      environment_.program_cache()->SetDiskCache(
+          std::make_unique<ProgramBinaryDiskCache>(
+              options_.program_cache_dir,
+              options_.program_cache_max_size_bytes));
+    }
     return environment_.Init();
   }
 
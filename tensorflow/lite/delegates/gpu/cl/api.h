@@ -24,6 +24,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "absl/types/span.h"
 #include "tensorflow/lite/delegates/gpu/api.h"
@@ -129,6 +130,15 @@ struct InferenceEnvironmentOptions {
   // incompatible when GPU driver is updated.
   absl::Span<const uint8_t> serialized_binary_cache;
 
+  // If set, compiled programs are cached in this directory, keyed by program
+  // code, compiler options, device and driver version. Unlike
+  // serialized_binary_cache it needs no management by the caller: the
+  // directory can be shared by all models and processes, and its size is
+  // bounded by program_cache_max_size_bytes (0 for the default) by evicting
+  // the least recently used programs.
+  std::string program_cache_dir;
+  uint64_t program_cache_max_size_bytes = 0;
+
   bool IsGlAware() const {
     return egl_context != EGL_NO_CONTEXT && egl_display != EGL_NO_DISPLAY;
   }
@@ -0,0 +1,167 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/cl/program_binary_disk_cache.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif  // defined(_WIN32)
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+
+namespace tflite {
+namespace gpu {
+namespace cl {
+namespace {
+
+constexpr char kBinarySuffix[] = ".bin";
+
+int GetProcessId() {
+#if defined(_WIN32)
+  return _getpid();
+#else
+  return getpid();
+#endif  // defined(_WIN32)
+}
+
+}  // namespace
+
+ProgramBinaryDiskCache::ProgramBinaryDiskCache(std::string dir,
+                                               uint64_t max_size_bytes)
+    : dir_(std::move(dir)),
+      max_size_bytes_(max_size_bytes == 0 ? kDefaultMaxSizeBytes
+                                          : max_size_bytes) {}
+
+std::string ProgramBinaryDiskCache::GetPath(uint64_t key) const {
+  return absl::StrCat(dir_, "/", absl::Hex(key, absl::kZeroPad16),
+                      kBinarySuffix);
+}
+
+bool ProgramBinaryDiskCache::Load(uint64_t key,
+                                  std::vector<uint8_t>* binary) const {
+  const std::string path = GetPath(key);
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = std::fseek(file, 0, SEEK_END) == 0;
+  const long size = ok ? std::ftell(file) : -1;  // NOLINT(runtime/int)
+  ok = size > 0 && std::fseek(file, 0, SEEK_SET) == 0;
+  if (ok) {
+    binary->resize(size);
+    ok = std::fread(binary->data(), 1, size, file) == static_cast<size_t>(size);
+  }
+  std::fclose(file);
+  if (!ok) {
+    return false;
+  }
+#if !defined(_WIN32)
+  // Marks the binary as recently used for eviction.
+  utime(path.c_str(), nullptr);
+#endif  // !defined(_WIN32)
+  return true;
+}
+
+bool ProgramBinaryDiskCache::Store(uint64_t key,
+                                   absl::Span<const uint8_t> binary) const {
+  const std::string path = GetPath(key);
+  const std::string temp_path = absl::StrCat(path, ".", GetProcessId(), ".tmp");
+  FILE* file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = std::fwrite(binary.data(), 1, binary.size(), file) == binary.size();
+  ok = std::fclose(file) == 0 && ok;
+  // rename is atomic, so other processes either see the whole binary or none.
+  if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  Evict(path);
+  return true;
+}
+
+void ProgramBinaryDiskCache::Remove(uint64_t key) const {
+  std::remove(GetPath(key).c_str());
+}
+
+void ProgramBinaryDiskCache::Evict(const std::string& keep_path) const {
+#if !defined(_WIN32)
+  DIR* dir = opendir(dir_.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  struct Entry {
+    std::string path;
+    uint64_t size;
+    time_t last_use;
+  };
+  std::vector<Entry> entries;
+  uint64_t total_size = 0;
+  while (const dirent* dir_entry = readdir(dir)) {
+    if (!absl::EndsWith(dir_entry->d_name, kBinarySuffix)) {
+      continue;
+    }
+    std::string path = absl::StrCat(dir_, "/", dir_entry->d_name);
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) != 0) {
+      continue;
+    }
+    total_size += file_stat.st_size;
+    if (path == keep_path) {
+      continue;
+    }
+    entries.push_back({std::move(path),
+                       static_cast<uint64_t>(file_stat.st_size),
+                       file_stat.st_mtime});
+  }
+  closedir(dir);
+  if (total_size <= max_size_bytes_) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) {
+              return a.last_use < b.last_use;
+            });
+  for (const Entry& entry : entries) {
+    if (total_size <= max_size_bytes_) {
+      break;
+    }
+    // Another process may have evicted the same binary already.
+    std::remove(entry.path.c_str());
+    total_size -= entry.size;
+  }
+#endif  // !defined(_WIN32)
+}
+
+}  // namespace cl
+}  // namespace gpu
+}  // namespace tflite
@@ -0,0 +1,71 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_DELEGATES_GPU_CL_PROGRAM_BINARY_DISK_CACHE_H_
+#define TENSORFLOW_LITE_DELEGATES_GPU_CL_PROGRAM_BINARY_DISK_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+
+namespace tflite {
+namespace gpu {
+namespace cl {
+
+// Directory of compiled program binaries, one file per program named after its
+// key. Keys are content addressed (see ProgramCache), so the directory can be
+// shared by all models and by concurrent processes: files are written under a
+// temporary name and renamed into place.
+//
+// The total size of the directory is bounded by evicting the least recently
+// used binaries after each store. Loading a binary refreshes its modification
+// time, which serves as its last use time.
+class ProgramBinaryDiskCache {
+ public:
+  static constexpr uint64_t kDefaultMaxSizeBytes = 64 * 1024 * 1024;
+
+  // `max_size_bytes` of 0 selects kDefaultMaxSizeBytes.
+  ProgramBinaryDiskCache(std::string dir, uint64_t max_size_bytes);
+
+  // Returns false if there is no binary for `key`.
+  bool Load(uint64_t key, std::vector<uint8_t>* binary) const;
+
+  // Returns false if the binary couldn't be written.
+  bool Store(uint64_t key, absl::Span<const uint8_t> binary) const;
+
+  // Removes the binary for `key`, e.g. after the driver rejected it.
+  void Remove(uint64_t key) const;
+
+  const std::string& dir() const { return dir_; }
+  uint64_t max_size_bytes() const { return max_size_bytes_; }
+
+ private:
+  std::string GetPath(uint64_t key) const;
+
+  // Deletes the least recently used binaries other than `keep_path` until the
+  // directory fits in max_size_bytes_.
+  void Evict(const std::string& keep_path) const;
+
+  const std::string dir_;
+  const uint64_t max_size_bytes_;
+};
+
+}  // namespace cl
+}  // namespace gpu
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_GPU_CL_PROGRAM_BINARY_DISK_CACHE_H_
@@ -0,0 +1,76 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/cl/program_binary_disk_cache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace gpu {
+namespace cl {
+namespace {
+
+std::string TempDir() {
+  const char* dir = std::getenv("TEST_TMPDIR");
+  return dir != nullptr ? dir : "/tmp";
+}
+
+TEST(ProgramBinaryDiskCacheTest, StoresAndLoadsBinaries) {
+  ProgramBinaryDiskCache cache(TempDir(), 0);
+  const std::vector<uint8_t> binary = {1, 2, 3, 4, 5};
+  cache.Remove(0x1234);
+
+  std::vector<uint8_t> loaded;
+  EXPECT_FALSE(cache.Load(0x1234, &loaded));
+  ASSERT_TRUE(cache.Store(0x1234, binary));
+  ASSERT_TRUE(cache.Load(0x1234, &loaded));
+  EXPECT_EQ(loaded, binary);
+
+  cache.Remove(0x1234);
+  EXPECT_FALSE(cache.Load(0x1234, &loaded));
+}
+
+#if !defined(_WIN32)
+TEST(ProgramBinaryDiskCacheTest, EvictsToMaxSize) {
+  const std::string dir = TempDir() + "/program_binary_disk_cache_evicts";
+  std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+  ProgramBinaryDiskCache cache(dir, 250);
+  const std::vector<uint8_t> binary(100, 7);
+
+  ASSERT_TRUE(cache.Store(1, binary));
+  ASSERT_TRUE(cache.Store(2, binary));
+  ASSERT_TRUE(cache.Store(3, binary));
+
+  // Only two binaries fit in the directory.
+  std::vector<uint8_t> loaded;
+  int num_cached = 0;
+  for (uint64_t key : {1, 2, 3}) {
+    num_cached += cache.Load(key, &loaded) ? 1 : 0;
+  }
+  EXPECT_EQ(num_cached, 2);
+  EXPECT_TRUE(cache.Load(3, &loaded));
+}
+#endif  // !defined(_WIN32)
+
+}  // namespace
+}  // namespace cl
+}  // namespace gpu
+}  // namespace tflite
@@ -18,10 +18,12 @@ limitations under the License.
 #include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/delegates/gpu/cl/cl_program.h"
 #include "tensorflow/lite/delegates/gpu/cl/compiled_program_cache_generated.h"
+#include "tensorflow/lite/delegates/gpu/cl/program_binary_disk_cache.h"
 #include "tensorflow/lite/delegates/gpu/cl/util.h"
 #include "tensorflow/lite/delegates/gpu/common/status.h"
 #include <farmhash.h>
@@ -67,11 +69,13 @@ ProgramCache::ProgramDescriptor::ProgramDescriptor(uint64_t fingerprints)
     : fingerprint(fingerprints) {}
 
 ProgramCache::ProgramCache(ProgramCache&& program_cache)
-    : programs_(std::move(program_cache.programs_)) {}
+    : programs_(std::move(program_cache.programs_)),
+      disk_cache_(std::move(program_cache.disk_cache_)) {}
 
 ProgramCache& ProgramCache::operator=(ProgramCache&& program_cache) {
   if (this != &program_cache) {
     programs_ = std::move(program_cache.programs_);
+    disk_cache_ = std::move(program_cache.disk_cache_);
   }
   return *this;
 }
@@ -93,7 +97,12 @@ absl::Status ProgramCache::GetOrCreateCLKernel(
   }
 
   CLProgram program;
-  RETURN_IF_ERROR(CreateCLProgram(code, options, context, device, &program));
+  if (disk_cache_) {
+    RETURN_IF_ERROR(GetOrCreateProgramWithDiskCache(
+        code, options, desc.fingerprint, context, device, &program));
+  } else {
+    RETURN_IF_ERROR(CreateCLProgram(code, options, context, device, &program));
+  }
   RETURN_IF_ERROR(result->CreateFromProgram(program, function_name));
   programs_.insert(std::make_pair(std::move(desc), std::move(program)));
   return absl::OkStatus();
@@ -109,6 +118,33 @@ absl::Status ProgramCache::GetOrCreateCLKernel(const std::string& code,
                              kernel_fingerprint);
 }
 
+absl::Status ProgramCache::GetOrCreateProgramWithDiskCache(
+    const std::string& code, const std::string& options, uint64_t fingerprint,
+    const CLContext& context, const CLDevice& device, CLProgram* program) {
+  // Binaries are only valid for the device and driver that compiled them.
+  const uint64_t key = CombineFingerprints(
+      fingerprint,
+      ::util::Fingerprint64(GetDriverVersion(device) + "_" +
+                            device.GetInfo().opencl_info.device_name));
+  std::vector<uint8_t> binary;
+  if (disk_cache_->Load(key, &binary)) {
+    if (CreateCLProgramFromBinary(context, device, binary, program).ok()) {
+      return absl::OkStatus();
+    }
+    // Corrupted or rejected by the driver, replace it below.
+    disk_cache_->Remove(key);
+  }
+
+  RETURN_IF_ERROR(CreateCLProgram(code, options, context, device, program));
+  binary.clear();
+  if (program->GetBinary(&binary).ok()) {
+    // The cache is best effort, failing to store a binary only costs a
+    // recompilation later.
+    disk_cache_->Store(key, binary);
+  }
+  return absl::OkStatus();
+}
+
 absl::Status ProgramCache::GetKernel(uint64_t fingerprint,
                                      const std::string& function_name,
                                      CLKernel* result) const {
@@ -17,7 +17,9 @@ limitations under the License.
 #define TENSORFLOW_LITE_DELEGATES_GPU_CL_PROGRAM_CACHE_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -26,6 +28,7 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/cl/cl_device.h"
 #include "tensorflow/lite/delegates/gpu/cl/cl_kernel.h"
 #include "tensorflow/lite/delegates/gpu/cl/cl_program.h"
+#include "tensorflow/lite/delegates/gpu/cl/program_binary_disk_cache.h"
 #include "tensorflow/lite/delegates/gpu/common/status.h"
 
 namespace tflite {
@@ -41,6 +44,13 @@ class ProgramCache {
   ProgramCache(const ProgramCache&) = delete;
   ProgramCache& operator=(const ProgramCache&) = delete;
 
+  // Makes programs that aren't in memory yet be looked up in, and added to,
+  // `disk_cache` before compiling them. Binaries are keyed by the program's
+  // code, compiler options, device and driver version.
+  void SetDiskCache(std::unique_ptr<ProgramBinaryDiskCache> disk_cache) {
+    disk_cache_ = std::move(disk_cache);
+  }
+
   absl::Status GetOrCreateCLKernel(
       const std::string& code, const std::string& function_name,
       const std::vector<CompilerOptions>& compiler_options,
@@ -89,9 +99,18 @@ class ProgramCache {
     }
   };
 
+  // Loads the program from disk_cache_ or compiles it and stores it there.
+  absl::Status GetOrCreateProgramWithDiskCache(const std::string& code,
+                                               const std::string& options,
+                                               uint64_t fingerprint,
+                                               const CLContext& context,
+                                               const CLDevice& device,
+                                               CLProgram* program);
+
   absl::flat_hash_map<ProgramDescriptor, CLProgram, ProgramDescriptorHasher,
                       ProgramDescriptorEqual>
       programs_;
+  std::unique_ptr<ProgramBinaryDiskCache> disk_cache_;
 };
 
 }  // namespace cl
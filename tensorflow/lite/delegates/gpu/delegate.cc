@@ -459,6 +459,12 @@ absl::Status DelegateKernelCore::InitializeOpenClApi(
 
   // OpenCL initialization is parameterized by these InferenceOptions.
   auto delegate_options = delegate_->options();
+  if (delegate_options.experimental_program_cache_dir) {
+    env_options.program_cache_dir =
+        delegate_options.experimental_program_cache_dir;
+    env_options.program_cache_max_size_bytes =
+        delegate_options.experimental_program_cache_max_size_bytes;
+  }
   cl::InferenceOptions options;
   // If is_precision_loss_allowed == -1, then just use priorities instead
   // of paying attention to is_precision_loss_allowed value.
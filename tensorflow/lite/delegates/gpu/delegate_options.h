@@ -137,6 +137,22 @@ typedef struct {
   // delegate will not try serialization.
   const char* model_token;
 
+  // The nul-terminated directory to cache compiled GPU programs in. Unlike
+  // serialization_dir, it needs no model_token: programs are keyed by their
+  // code, compiler options, GPU and driver version, so the directory can be
+  // shared by all models and processes of the app. Only used by the OpenCL
+  // backend.
+  // Set to nullptr in TfLiteGpuDelegateOptionsV2Default(), which disables the
+  // cache.
+  //
+  // NOTE: Users should ensure that this directory is private to the app.
+  const char* experimental_program_cache_dir;
+
+  // Maximum total size of experimental_program_cache_dir in bytes. The least
+  // recently used programs are evicted beyond it. 0 selects a default of
+  // 64 MiB.
+  int64_t experimental_program_cache_max_size_bytes;
+
 #ifdef TFLITE_DEBUG_DELEGATE
   // This sets the index of the first node that could be delegated.
   int first_delegate_node_index;
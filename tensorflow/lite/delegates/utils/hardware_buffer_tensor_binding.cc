@@ -0,0 +1,114 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/delegates/utils/hardware_buffer_tensor_binding.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/delegates/gpu/android_hardware_buffer.h"
+#include "tensorflow/lite/minimal_logging.h"
+
+namespace tflite::delegates::utils {
+namespace {
+
+// Values of AHARDWAREBUFFER_FORMAT_BLOB and AHARDWAREBUFFER_USAGE_CPU_*_OFTEN,
+// which are only defined when building for Android.
+constexpr uint32_t kFormatBlob = 0x21;
+constexpr uint64_t kUsageCpuReadOften = 3;
+constexpr uint64_t kUsageCpuWriteOften = 3 << 4;
+
+void CloseFence(int fence_fd) {
+  if (fence_fd >= 0) {
+    close(fence_fd);
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<HardwareBufferTensorBinding> HardwareBufferTensorBinding::Bind(
+    Interpreter* interpreter, int tensor_index, AHardwareBuffer* buffer,
+    int fence_fd) {
+  auto& ahwb = gpu::OptionalAndroidHardwareBuffer::Instance();
+  if (!ahwb.Supported()) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "AHardwareBuffer is not supported.");
+    CloseFence(fence_fd);
+    return nullptr;
+  }
+  const TfLiteTensor* tensor = interpreter->tensor(tensor_index);
+  if (tensor == nullptr) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "Invalid tensor index %d.",
+                    tensor_index);
+    CloseFence(fence_fd);
+    return nullptr;
+  }
+  AHardwareBuffer_Desc desc;
+  ahwb.Describe(buffer, &desc);
+  // The size of a BLOB buffer is its width.
+  if (desc.format != kFormatBlob || desc.width < tensor->bytes) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR,
+                    "Tensor %d of %zu bytes can't be bound to a buffer of "
+                    "format %u and width %u.",
+                    tensor_index, tensor->bytes, desc.format, desc.width);
+    CloseFence(fence_fd);
+    return nullptr;
+  }
+
+  const std::vector<int>& inputs = interpreter->inputs();
+  const bool is_input =
+      std::find(inputs.begin(), inputs.end(), tensor_index) != inputs.end();
+  void* data = nullptr;
+  // Locking waits for the fence and takes ownership of it.
+  if (ahwb.Lock(buffer, is_input ? kUsageCpuReadOften : kUsageCpuWriteOften,
+                fence_fd, /*rect=*/nullptr, &data) != 0) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "Failed to lock AHardwareBuffer.");
+    return nullptr;
+  }
+  std::unique_ptr<HardwareBufferTensorBinding> binding(
+      new HardwareBufferTensorBinding(buffer, data));
+
+  // Fails if the mapping is misaligned.
+  TfLiteCustomAllocation allocation = {data, desc.width};
+  if (interpreter->SetCustomAllocationForTensor(tensor_index, allocation) !=
+      kTfLiteOk) {
+    return nullptr;
+  }
+  return binding;
+}
+
+HardwareBufferTensorBinding::~HardwareBufferTensorBinding() {
+  CloseFence(Release());
+}
+
+int HardwareBufferTensorBinding::Release() {
+  if (!locked_) {
+    return -1;
+  }
+  locked_ = false;
+  int32_t fence_fd = -1;
+  if (gpu::OptionalAndroidHardwareBuffer::Instance().Unlock(buffer_,
+                                                            &fence_fd) != 0) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "Failed to unlock AHardwareBuffer.");
+    return -1;
+  }
+  return fence_fd;
+}
+
+}  // namespace tflite::delegates::utils
@@ -0,0 +1,84 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_DELEGATES_UTILS_HARDWARE_BUFFER_TENSOR_BINDING_H_
+#define TENSORFLOW_LITE_DELEGATES_UTILS_HARDWARE_BUFFER_TENSOR_BINDING_H_
+
+#include <memory>
+
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/delegates/gpu/android_hardware_buffer.h"
+
+namespace tflite::delegates::utils {
+
+// Binds the CPU mapping of an AHardwareBuffer BLOB (e.g. a camera frame or a
+// decoder output) as the data of an interpreter tensor, so that CPU kernels
+// and the XNNPack delegate read and write the buffer in place instead of
+// copying it from or to an arena tensor.
+//
+// The buffer is locked for CPU access when bound, which waits for the producer
+// fence, and unlocked on Release(), which returns the fence to hand to the
+// consumer of an output. Binding goes through
+// Interpreter::SetCustomAllocationForTensor, so the mapping must be aligned to
+// kDefaultTensorAlignment and hold at least the tensor's bytes.
+//
+// Usage, per frame:
+//
+//   auto input = HardwareBufferTensorBinding::Bind(
+//       interpreter, interpreter->inputs()[0], frame, frame_fence_fd);
+//   auto output = HardwareBufferTensorBinding::Bind(
+//       interpreter, interpreter->outputs()[0], result, /*fence_fd=*/-1);
+//   // On the first frame only, or after resizing inputs:
+//   interpreter->AllocateTensors();
+//   interpreter->Invoke();
+//   input->Release();
+//   int result_fence_fd = output->Release();
+//
+// The buffers must stay alive until they are released, and be bound again
+// before the next invocation.
+//
+// WARNING: This is an experimental API and subject to change.
+class HardwareBufferTensorBinding {
+ public:
+  // Locks `buffer` for CPU access once `fence_fd` is signalled (-1 if there is
+  // no fence) and binds it to tensor `tensor_index` of `interpreter`. Inputs
+  // of the interpreter are locked for reading, other tensors for writing.
+  // Takes ownership of `fence_fd`. Returns nullptr on error, e.g. if hardware
+  // buffers are not supported or the buffer is too small or misaligned.
+  static std::unique_ptr<HardwareBufferTensorBinding> Bind(
+      Interpreter* interpreter, int tensor_index, AHardwareBuffer* buffer,
+      int fence_fd);
+
+  // Unlocks the buffer if it wasn't released yet, without waiting.
+  ~HardwareBufferTensorBinding();
+
+  // Unlocks the buffer. Returns a fence that is signalled once the CPU writes
+  // are visible to other users of the buffer, or -1 if they already are. The
+  // caller owns the returned fence.
+  int Release();
+
+  void* data() const { return data_; }
+
+ private:
+  HardwareBufferTensorBinding(AHardwareBuffer* buffer, void* data)
+      : buffer_(buffer), data_(data) {}
+
+  AHardwareBuffer* buffer_;
+  void* data_;
+  bool locked_ = true;
+};
+
+}  // namespace tflite::delegates::utils
+
+#endif  // TENSORFLOW_LITE_DELEGATES_UTILS_HARDWARE_BUFFER_TENSOR_BINDING_H_
@@ -0,0 +1,73 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/delegates/utils/hardware_buffer_tensor_binding.h"
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter.h"
+
+namespace tflite::delegates::utils {
+namespace {
+
+#ifndef __ANDROID__
+
+TEST(HardwareBufferTensorBindingTest, FailsWithoutHardwareBufferSupport) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(1), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  EXPECT_EQ(HardwareBufferTensorBinding::Bind(&interpreter, 0,
+                                              /*buffer=*/nullptr,
+                                              /*fence_fd=*/-1),
+            nullptr);
+}
+
+#else  // defined(__ANDROID__)
+
+TEST(HardwareBufferTensorBindingTest, BindsInputInPlace) {
+  auto& ahwb = gpu::OptionalAndroidHardwareBuffer::Instance();
+  ASSERT_TRUE(ahwb.Supported());
+  AHardwareBuffer_Desc description{};
+  description.width = 4 * sizeof(float);
+  description.height = 1;
+  description.layers = 1;
+  description.format = AHARDWAREBUFFER_FORMAT_BLOB;
+  description.usage = AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN |
+                      AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN;
+  AHardwareBuffer* buffer = nullptr;
+  ASSERT_EQ(ahwb.Allocate(&description, &buffer), 0);
+
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(1), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(0, kTfLiteFloat32, "",
+                                                     {4}, TfLiteQuantization()),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  auto binding = HardwareBufferTensorBinding::Bind(&interpreter, 0, buffer,
+                                                   /*fence_fd=*/-1);
+  ASSERT_NE(binding, nullptr);
+  EXPECT_EQ(interpreter.tensor(0)->data.data, binding->data());
+  EXPECT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+  // Unlocks the buffer.
+  binding.reset();
+  ahwb.Release(buffer);
+}
+
+#endif  // defined(__ANDROID__)
+
+}  // namespace
+}  // namespace tflite::delegates::utils
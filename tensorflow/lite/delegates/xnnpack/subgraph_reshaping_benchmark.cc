@@ -0,0 +1,87 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/delegates/xnnpack/conv_2d_tester.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+// Measures resizing the input to sequence lengths 8, 16, ... up to
+// state.range(0) in turn, each followed by an inference, like a speech model
+// fed with utterances of variable length. state.range(1) selects between
+// reshaping the XNNPACK runtime and TFLite redoing the delegation.
+void BM_ResizeAndInvoke(benchmark::State& state) {
+  const int max_length = state.range(0);
+  Conv2DTester tester;
+  tester.BatchSize(1)
+      .InputHeight(8)
+      .InputWidth(1)
+      .InputChannels(256)
+      .OutputChannels(256)
+      .KernelHeight(3)
+      .KernelWidth(1)
+      .SamePadding();
+  std::vector<char> buffer = tester.CreateTfLiteModel();
+  const Model* model = GetModel(buffer.data());
+
+  std::unique_ptr<Interpreter> interpreter;
+  InterpreterBuilder(
+      model,
+      ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+      &interpreter);
+  TfLiteXNNPackDelegateOptions delegate_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  if (state.range(1) != 0) {
+    delegate_options.flags |=
+        TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING;
+  }
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      delegate(TfLiteXNNPackDelegateCreate(&delegate_options),
+               TfLiteXNNPackDelegateDelete);
+  interpreter->ModifyGraphWithDelegate(delegate.get());
+
+  for (auto _ : state) {
+    for (int length = 8; length <= max_length; length *= 2) {
+      interpreter->ResizeInputTensor(interpreter->inputs()[0],
+                                     {1, length, 1, 256});
+      interpreter->AllocateTensors();
+      interpreter->Invoke();
+    }
+  }
+}
+BENCHMARK(BM_ResizeAndInvoke)
+    ->ArgPair(64, 0)
+    ->ArgPair(64, 1)
+    ->ArgPair(1024, 0)
+    ->ArgPair(1024, 1);
+
+}  // namespace
+}  // namespace xnnpack
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
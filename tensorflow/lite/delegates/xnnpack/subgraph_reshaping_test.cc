@@ -0,0 +1,121 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/delegates/xnnpack/conv_2d_tester.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+
+namespace tflite {
+namespace xnnpack {
+
+TEST(XNNPACK_SUBGRAPH_RESHAPING, ConvolutionOverVariableHeight) {
+  Conv2DTester tester;
+  tester.BatchSize(1)
+      .InputHeight(8)
+      .InputWidth(1)
+      .InputChannels(5)
+      .OutputChannels(7)
+      .KernelHeight(3)
+      .KernelWidth(1)
+      .SamePadding();
+  std::vector<char> buffer = tester.CreateTfLiteModel();
+  const Model* model = GetModel(buffer.data());
+
+  std::unique_ptr<Interpreter> delegate_interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &delegate_interpreter),
+      kTfLiteOk);
+  std::unique_ptr<Interpreter> default_interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &default_interpreter),
+      kTfLiteOk);
+  ASSERT_EQ(delegate_interpreter->AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(default_interpreter->AllocateTensors(), kTfLiteOk);
+
+  TfLiteXNNPackDelegateOptions delegate_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  delegate_options.flags |=
+      TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING;
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      delegate(TfLiteXNNPackDelegateCreate(&delegate_options),
+               TfLiteXNNPackDelegateDelete);
+  ASSERT_EQ(delegate_interpreter->ModifyGraphWithDelegate(delegate.get()),
+            kTfLiteOk);
+  ASSERT_EQ(delegate_interpreter->execution_plan().size(), 1);
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto input_rng =
+      std::bind(std::uniform_real_distribution<float>(), std::ref(rng));
+
+  for (int height : {8, 3, 17, 8, 1}) {
+    const std::vector<int> input_shape = {1, height, 1, 5};
+    ASSERT_EQ(delegate_interpreter->ResizeInputTensor(
+                  delegate_interpreter->inputs()[0], input_shape),
+              kTfLiteOk);
+    ASSERT_EQ(default_interpreter->ResizeInputTensor(
+                  default_interpreter->inputs()[0], input_shape),
+              kTfLiteOk);
+    ASSERT_EQ(delegate_interpreter->AllocateTensors(), kTfLiteOk);
+    ASSERT_EQ(default_interpreter->AllocateTensors(), kTfLiteOk);
+
+    // The whole graph stays delegated after the resize.
+    ASSERT_EQ(delegate_interpreter->execution_plan().size(), 1);
+
+    float* default_input_data =
+        default_interpreter->typed_input_tensor<float>(0);
+    std::generate_n(default_input_data, height * 5, input_rng);
+    std::copy_n(default_input_data, height * 5,
+                delegate_interpreter->typed_input_tensor<float>(0));
+
+    ASSERT_EQ(default_interpreter->Invoke(), kTfLiteOk);
+    ASSERT_EQ(delegate_interpreter->Invoke(), kTfLiteOk);
+
+    const TfLiteTensor* delegate_output = delegate_interpreter->output_tensor(0);
+    ASSERT_EQ(delegate_output->dims->size, 4);
+    EXPECT_EQ(delegate_output->dims->data[1], height);
+    EXPECT_EQ(delegate_output->dims->data[3], 7);
+
+    const float* default_output_data =
+        default_interpreter->typed_output_tensor<float>(0);
+    const float* delegate_output_data =
+        delegate_interpreter->typed_output_tensor<float>(0);
+    for (int i = 0; i < height * 7; i++) {
+      ASSERT_NEAR(default_output_data[i], delegate_output_data[i],
+                  std::abs(default_output_data[i]) * 3.0e-6f)
+          << "height " << height << ", element " << i;
+    }
+  }
+}
+
+}  // namespace xnnpack
+}  // namespace tflite
@@ -0,0 +1,122 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/xnnpack/unpacked_weights_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/stderr_reporter.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+constexpr char kMagic[8] = {'T', 'F', 'L', 'X', 'N', 'N', 'U', 'W'};
+
+struct Header {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t reserved;
+  uint64_t fingerprint;
+  uint64_t data_size;
+};
+static_assert(sizeof(Header) <= UnpackedWeightsFile::kDataOffset,
+              "header doesn't fit before the data");
+
+bool WriteAll(FILE* file, const void* data, size_t size) {
+  return size == 0 || std::fwrite(data, 1, size, file) == size;
+}
+
+}  // namespace
+
+std::unique_ptr<UnpackedWeightsFile> UnpackedWeightsFile::Load(
+    const char* path, uint64_t fingerprint, size_t size) {
+  if (!MMAPAllocation::IsSupported()) {
+    return nullptr;
+  }
+  // A missing file is the common case on the first load, don't let the
+  // allocation report it as an error.
+  FILE* file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  std::fclose(file);
+
+  auto allocation =
+      std::make_unique<MMAPAllocation>(path, DefaultErrorReporter());
+  if (!allocation->valid() ||
+      allocation->bytes() < kDataOffset + size + kTrailingPadding) {
+    return nullptr;
+  }
+  Header header;
+  std::memcpy(&header, allocation->base(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.format_version != kFormatVersion ||
+      header.fingerprint != fingerprint || header.data_size != size) {
+    return nullptr;
+  }
+  return std::unique_ptr<UnpackedWeightsFile>(
+      new UnpackedWeightsFile(std::move(allocation)));
+}
+
+bool UnpackedWeightsFile::Save(const char* path, uint64_t fingerprint,
+                               const char* data, size_t size) {
+  const std::string temp_path = std::string(path) + ".tmp";
+  FILE* file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char header_bytes[kDataOffset] = {};
+  Header header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format_version = kFormatVersion;
+  header.fingerprint = fingerprint;
+  header.data_size = size;
+  std::memcpy(header_bytes, &header, sizeof(header));
+  const char padding[kTrailingPadding] = {};
+
+  bool ok = WriteAll(file, header_bytes, sizeof(header_bytes)) &&
+            WriteAll(file, data, size) &&
+            WriteAll(file, padding, sizeof(padding));
+  ok = std::fclose(file) == 0 && ok;
+  if (ok && std::rename(temp_path.c_str(), path) != 0) {
+    // Some platforms don't replace an existing file on rename.
+    std::remove(path);
+    ok = std::rename(temp_path.c_str(), path) == 0;
+  }
+  if (!ok) {
+    std::remove(temp_path.c_str());
+  }
+  return ok;
+}
+
+void WeightsFingerprint::Update(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash_ ^= bytes[i];
+    hash_ *= 0x100000001b3ull;
+  }
+}
+
+}  // namespace xnnpack
+}  // namespace tflite
@@ -0,0 +1,91 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_DELEGATES_XNNPACK_UNPACKED_WEIGHTS_FILE_H_
+#define TENSORFLOW_LITE_DELEGATES_XNNPACK_UNPACKED_WEIGHTS_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "tensorflow/lite/allocation.h"
+
+namespace tflite {
+namespace xnnpack {
+
+// File holding the weights that the delegate unpacks from static tensors
+// (dequantized FP16/INT8 weights, densified sparse weights), so that later
+// loads of the same model can memory-map them instead of unpacking again.
+//
+// The file starts with a fixed-size header recording the format version, a
+// fingerprint of the model tensors the data was unpacked from and the data
+// size. A file whose header doesn't match is ignored and can be overwritten.
+class UnpackedWeightsFile {
+ public:
+  // Bumped whenever the header layout or the way the delegate unpacks weights
+  // changes, which invalidates all existing files.
+  static constexpr uint32_t kFormatVersion = 1;
+  // Offset of the data in the file. Keeps the mapped data aligned for any
+  // tensor type.
+  static constexpr size_t kDataOffset = 64;
+  // Zero bytes written after the data, as XNNPACK may read past the end of
+  // static tensors.
+  static constexpr size_t kTrailingPadding = 64;
+
+  // Maps `path` and checks that it was written for `fingerprint` and holds
+  // `size` bytes of data. Returns nullptr if the file doesn't exist, can't be
+  // mapped or doesn't match.
+  static std::unique_ptr<UnpackedWeightsFile> Load(const char* path,
+                                                   uint64_t fingerprint,
+                                                   size_t size);
+
+  // Writes `size` bytes of `data` to `path` tagged with `fingerprint`. The
+  // file is written under a temporary name and renamed, so concurrent loads
+  // never see a partially written file. Returns false on error.
+  static bool Save(const char* path, uint64_t fingerprint, const char* data,
+                   size_t size);
+
+  const char* data() const {
+    return static_cast<const char*>(allocation_->base()) + kDataOffset;
+  }
+
+ private:
+  explicit UnpackedWeightsFile(std::unique_ptr<Allocation> allocation)
+      : allocation_(std::move(allocation)) {}
+
+  std::unique_ptr<Allocation> allocation_;
+};
+
+// Incrementally computes the fingerprint of the tensors that are unpacked,
+// using 64-bit FNV-1a.
+class WeightsFingerprint {
+ public:
+  void Update(const void* data, size_t size);
+  template <typename T>
+  void Update(const T& value) {
+    Update(&value, sizeof(value));
+  }
+
+  uint64_t value() const { return hash_; }
+
+ private:
+  uint64_t hash_ = 0xcbf29ce484222325ull;
+};
+
+}  // namespace xnnpack
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_XNNPACK_UNPACKED_WEIGHTS_FILE_H_
@@ -0,0 +1,98 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/xnnpack/unpacked_weights_file.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/allocation.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+std::string TempPath(const char* name) {
+  const char* dir = std::getenv("TEST_TMPDIR");
+  return std::string(dir != nullptr ? dir : "/tmp") + "/" + name;
+}
+
+TEST(UnpackedWeightsFileTest, LoadsSavedData) {
+  if (!MMAPAllocation::IsSupported()) {
+    GTEST_SKIP();
+  }
+  const std::string path = TempPath("unpacked_weights_loads_saved_data");
+  std::remove(path.c_str());
+  const std::vector<char> data = {1, 2, 3, 4, 5, 6, 7};
+
+  EXPECT_EQ(UnpackedWeightsFile::Load(path.c_str(), 42, data.size()),
+            nullptr);
+  ASSERT_TRUE(
+      UnpackedWeightsFile::Save(path.c_str(), 42, data.data(), data.size()));
+
+  std::unique_ptr<UnpackedWeightsFile> file =
+      UnpackedWeightsFile::Load(path.c_str(), 42, data.size());
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(std::memcmp(file->data(), data.data(), data.size()), 0);
+  std::remove(path.c_str());
+}
+
+TEST(UnpackedWeightsFileTest, RejectsMismatchingFile) {
+  if (!MMAPAllocation::IsSupported()) {
+    GTEST_SKIP();
+  }
+  const std::string path = TempPath("unpacked_weights_rejects_mismatch");
+  const std::vector<char> data(100, 7);
+  ASSERT_TRUE(
+      UnpackedWeightsFile::Save(path.c_str(), 42, data.data(), data.size()));
+
+  EXPECT_EQ(UnpackedWeightsFile::Load(path.c_str(), 43, data.size()),
+            nullptr);
+  EXPECT_EQ(UnpackedWeightsFile::Load(path.c_str(), 42, data.size() + 1),
+            nullptr);
+
+  // Overwriting replaces the stale file.
+  ASSERT_TRUE(UnpackedWeightsFile::Save(path.c_str(), 43, data.data(),
+                                        data.size() / 2));
+  EXPECT_EQ(UnpackedWeightsFile::Load(path.c_str(), 42, data.size()),
+            nullptr);
+  EXPECT_NE(UnpackedWeightsFile::Load(path.c_str(), 43, data.size() / 2),
+            nullptr);
+  std::remove(path.c_str());
+}
+
+TEST(UnpackedWeightsFileTest, FingerprintDependsOnData) {
+  const float a[] = {1.0f, 2.0f};
+  const float b[] = {1.0f, 3.0f};
+  WeightsFingerprint fingerprint_a;
+  fingerprint_a.Update(a, sizeof(a));
+  WeightsFingerprint fingerprint_b;
+  fingerprint_b.Update(b, sizeof(b));
+  WeightsFingerprint fingerprint_a_again;
+  fingerprint_a_again.Update(a[0]);
+  fingerprint_a_again.Update(a[1]);
+
+  EXPECT_NE(fingerprint_a.value(), fingerprint_b.value());
+  EXPECT_EQ(fingerprint_a.value(), fingerprint_a_again.value());
+}
+
+}  // namespace
+}  // namespace xnnpack
+}  // namespace tflite
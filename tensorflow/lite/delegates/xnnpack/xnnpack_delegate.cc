@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/builtin_op_data.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/delegates/xnnpack/quantization_util.h"
+#include "tensorflow/lite/delegates/xnnpack/unpacked_weights_file.h"
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -499,6 +500,11 @@ class Delegate {
 
     options_ =
         options != nullptr ? *options : TfLiteXNNPackDelegateOptionsDefault();
+    if (enable_subgraph_reshaping()) {
+      // Input resizes are handled by the delegate kernels, so TFLite doesn't
+      // need to undo and redo the delegation.
+      delegate_.flags |= kTfLiteDelegateFlagsAllowDynamicTensors;
+    }
     workspace_.reset(workspace);
   }
 
@@ -555,6 +561,11 @@ class Delegate {
     return false;
   }
 
+  bool enable_subgraph_reshaping() const {
+    return (options_.flags &
+            TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING) != 0;
+  }
+
   bool transient_indirection_buffer() const {
     return (options_.flags &
             TFLITE_XNNPACK_DELEGATE_FLAG_TRANSIENT_INDIRECTION_BUFFER) != 0;
@@ -629,6 +640,19 @@ class Delegate {
   TfLiteXNNPackDelegateOptions options() const { return options_; }
 
  private:
+  const char* static_unpacked_data() const {
+    return unpacked_weights_file_ != nullptr ? unpacked_weights_file_->data()
+                                             : static_unpacked_data_.data();
+  }
+
+  // Computes the fingerprint and the total size of the quasi-static tensors
+  // `tensors_to_unpack`, which identify the unpacked data in
+  // `experimental_unpacked_weights_file_path`.
+  void FingerprintUnpackedData(
+      TfLiteContext* context, const std::vector<int>& tensors_to_unpack,
+      std::unordered_map<int, int>& quasi_static_tensors_producers,
+      uint64_t* fingerprint, size_t* size) const;
+
   TfLiteDelegate delegate_ = {
       reinterpret_cast<void*>(this),             // .data_
       DelegatePrepare,                           // .Prepare
@@ -641,6 +665,9 @@ class Delegate {
   // Unpacked data for quasi-static tensors, i.e. tensors produced by
   // dequantizing or unpacking static buffers.
   std::vector<char> static_unpacked_data_;
+  // Unpacked data mapped from `experimental_unpacked_weights_file_path`. When
+  // set, it replaces static_unpacked_data_.
+  std::unique_ptr<UnpackedWeightsFile> unpacked_weights_file_;
   // Mapping from a tensor index for a quasi-static tensor to the offset to
   // its unpacked data within static_unpacked_data_.
   std::unordered_map<int, size_t> static_unpacked_data_map_;
@@ -927,7 +954,7 @@ class Subgraph {
         // Check for quasi-static data.
         const auto it = delegate.static_unpacked_data_map_.find(t);
         if (it != delegate.static_unpacked_data_map_.end()) {
-          data = delegate.static_unpacked_data_.data() + it->second;
+          data = delegate.static_unpacked_data() + it->second;
         }
       }
       if (inputs.count(t) != 0) {
@@ -1061,11 +1088,65 @@ class Subgraph {
       return nullptr;
     }
 
-    return new Subgraph(delegate, runtime_ptr, externals,
+    return new Subgraph(context, delegate, runtime_ptr, externals, outputs,
                         tflite_tensor_to_xnnpack);
   }
 
-  TfLiteStatus Prepare(TfLiteContext* context) { return kTfLiteOk; }
+  TfLiteStatus Prepare(TfLiteContext* context) {
+    if (!reshape_on_resize_) {
+      return kTfLiteOk;
+    }
+
+    // Propagate resized inputs through the existing runtime. XNNPACK keeps the
+    // packed weights and only recomputes shapes and workspace requirements.
+    bool any_shape_changed = false;
+    for (std::pair<const int, std::vector<size_t>>& input : input_dims_) {
+      const TfLiteIntArray* dims = context->tensors[input.first].dims;
+      if (std::equal(input.second.begin(), input.second.end(), dims->data,
+                     dims->data + dims->size)) {
+        continue;
+      }
+      input.second.assign(dims->data, dims->data + dims->size);
+      const xnn_status status = xnn_reshape_external_value(
+          runtime_.get(), tflite_tensor_to_xnnpack_[input.first],
+          input.second.size(), input.second.data());
+      if (status != xnn_status_success) {
+        TF_LITE_KERNEL_LOG(context, "failed to reshape XNNPACK input tensor %d",
+                           input.first);
+        return kTfLiteError;
+      }
+      any_shape_changed = true;
+    }
+    if (!any_shape_changed) {
+      return kTfLiteOk;
+    }
+
+    xnn_status status = xnn_reshape_runtime(runtime_.get());
+    if (status != xnn_status_success) {
+      TF_LITE_KERNEL_LOG(context, "failed to reshape XNNPACK runtime");
+      return kTfLiteError;
+    }
+    for (int t : outputs_) {
+      size_t num_dims = 0;
+      std::array<size_t, XNN_MAX_TENSOR_DIMS> dims;
+      status = xnn_get_external_value_shape(
+          runtime_.get(), tflite_tensor_to_xnnpack_[t], &num_dims, dims.data());
+      if (status != xnn_status_success) {
+        TF_LITE_KERNEL_LOG(context,
+                           "failed to get shape of XNNPACK output tensor %d",
+                           t);
+        return kTfLiteError;
+      }
+      TfLiteIntArray* output_dims = TfLiteIntArrayCreate(num_dims);
+      std::copy_n(dims.begin(), num_dims, output_dims->data);
+      TF_LITE_ENSURE_OK(context, context->ResizeTensor(
+                                     context, &context->tensors[t], output_dims));
+    }
+    // The runtime must be set up again after reshaping, even if the data
+    // pointers of the externals don't change.
+    needs_setup_ = true;
+    return kTfLiteOk;
+  }
 
   TfLiteStatus Invoke(TfLiteContext* context) {
     bool any_pointers_changed = false;
@@ -1090,7 +1171,8 @@ class Subgraph {
 
     // Even with no externals, we need to setup the runtime if there are
     // variables.
-    if (any_pointers_changed || NeedToSetUpVariableTensors()) {
+    if (any_pointers_changed || needs_setup_ ||
+        NeedToSetUpVariableTensors()) {
       std::vector<xnn_external_value> external_values;
       for (std::pair<int, void*> io_info : externals_) {
         xnn_external_value value = {0};
@@ -1107,6 +1189,7 @@ class Subgraph {
         return kTfLiteError;
       }
       variables_set_up_ = true;
+      needs_setup_ = false;
     }
 
     xnn_status status = xnn_invoke_runtime(runtime_.get());
@@ -6358,8 +6441,9 @@ class Subgraph {
   }
 
  private:
-  Subgraph(const Delegate& delegate, xnn_runtime_t runtime,
-           const std::unordered_set<int>& externals,
+  Subgraph(TfLiteContext* context, const Delegate& delegate,
+           xnn_runtime_t runtime, const std::unordered_set<int>& externals,
+           const std::unordered_set<int>& outputs,
            std::unordered_map<int, uint32_t>& tflite_tensor_to_xnnpack)
       : runtime_(runtime, &xnn_delete_runtime) {
     for (int t : externals) {
@@ -6367,6 +6451,17 @@ class Subgraph {
     }
     tflite_tensor_to_xnnpack_ = tflite_tensor_to_xnnpack;
     has_variables_ = !delegate.GetAllVariableTensors().empty();
+    reshape_on_resize_ = delegate.enable_subgraph_reshaping();
+    if (reshape_on_resize_) {
+      for (int t : externals) {
+        if (outputs.count(t) != 0) {
+          outputs_.push_back(t);
+        } else {
+          const TfLiteIntArray* dims = context->tensors[t].dims;
+          input_dims_[t].assign(dims->data, dims->data + dims->size);
+        }
+      }
+    }
   }
 
   // XNNPACK Runtime (subgraph + workspace) with smart-pointer for lifetime
@@ -6387,12 +6482,23 @@ class Subgraph {
   // calls.
   bool has_variables_ = false;
   bool variables_set_up_ = false;
+  // Whether resized inputs are handled by reshaping the runtime, see
+  // TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING.
+  bool reshape_on_resize_ = false;
+  // Shapes of the external inputs the runtime is currently reshaped for.
+  std::unordered_map<int, std::vector<size_t>> input_dims_;
+  // External outputs, which are resized after reshaping the runtime.
+  std::vector<int> outputs_;
+  // Set when the runtime was reshaped and has to be set up before the next
+  // invocation.
+  bool needs_setup_ = false;
 };
 
 TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
   // Clear previous data, in case the delegate is reused without re-creation.
   static_unpacked_data_map_.clear();
   static_unpacked_data_.clear();
+  unpacked_weights_file_.reset();
   static_unpack_nodes_.clear();
   static_sparse_weights_.clear();
   variable_holder_.ClearTensorIdToGlobalId();
@@ -6559,7 +6665,24 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
                      quasi_static_tensors_producers[t2];
             });
 
+  // Reuse the data unpacked by a previous load of the same model, if any.
+  const char* unpacked_weights_file_path =
+      options_.experimental_unpacked_weights_file_path;
+  uint64_t unpacked_data_fingerprint = 0;
+  if (unpacked_weights_file_path != nullptr &&
+      !sorted_quasi_static_tensors_to_unpack.empty()) {
+    size_t expected_unpacked_data_size = 0;
+    FingerprintUnpackedData(context, sorted_quasi_static_tensors_to_unpack,
+                            quasi_static_tensors_producers,
+                            &unpacked_data_fingerprint,
+                            &expected_unpacked_data_size);
+    unpacked_weights_file_ = UnpackedWeightsFile::Load(
+        unpacked_weights_file_path, unpacked_data_fingerprint,
+        expected_unpacked_data_size);
+  }
+
   // Unpack static data of all tensors
+  size_t unpacked_data_size = 0;
   for (int t : sorted_quasi_static_tensors_to_unpack) {
     const int producer_index = quasi_static_tensors_producers[t];
     // Check if TFLite nodes can be delegated to XNNPACK
@@ -6634,11 +6757,16 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
     }
 
     // Align to XNN_EXTRA_BYTES bytes
-    while (static_unpacked_data_.size() % XNN_EXTRA_BYTES != 0) {
-      static_unpacked_data_.push_back(0);
+    const size_t tensor_offset =
+        (unpacked_data_size + XNN_EXTRA_BYTES - 1) / XNN_EXTRA_BYTES *
+        XNN_EXTRA_BYTES;
+    unpacked_data_size = tensor_offset + context->tensors[t].bytes;
+    if (unpacked_weights_file_ != nullptr) {
+      // Already unpacked in the mapped file.
+      static_unpacked_data_map_[t] = tensor_offset;
+      continue;
     }
-    const size_t tensor_offset = static_unpacked_data_.size();
-    static_unpacked_data_.resize(tensor_offset + context->tensors[t].bytes);
+    static_unpacked_data_.resize(unpacked_data_size);
 
     char* unpacked_data = static_unpacked_data_.data() + tensor_offset;
     const char* packed_data =
@@ -6752,6 +6880,26 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
     static_unpacked_data_map_[t] = tensor_offset;
   }
 
+  // Persist freshly unpacked data for the next load, and serve it from the
+  // file mapping from now on so that the heap copy can be released.
+  if (unpacked_weights_file_path != nullptr &&
+      unpacked_weights_file_ == nullptr && !static_unpacked_data_.empty()) {
+    if (UnpackedWeightsFile::Save(
+            unpacked_weights_file_path, unpacked_data_fingerprint,
+            static_unpacked_data_.data(), static_unpacked_data_.size())) {
+      unpacked_weights_file_ = UnpackedWeightsFile::Load(
+          unpacked_weights_file_path, unpacked_data_fingerprint,
+          static_unpacked_data_.size());
+      if (unpacked_weights_file_ != nullptr) {
+        std::vector<char>().swap(static_unpacked_data_);
+      }
+    } else {
+      TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                      "Failed to write XNNPACK unpacked weights file %s.",
+                      unpacked_weights_file_path);
+    }
+  }
+
   // Add nodes that unpack static data consumed by delegated nodes.
   // Note: this is done purely to avoid the overhead of running these nodes
   // again in TFLite interpreter which would allocate memory for their outputs.
@@ -6779,6 +6927,80 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
   return nodes_to_delegate;
 }
 
+void Delegate::FingerprintUnpackedData(
+    TfLiteContext* context, const std::vector<int>& tensors_to_unpack,
+    std::unordered_map<int, int>& quasi_static_tensors_producers,
+    uint64_t* fingerprint, size_t* size) const {
+  WeightsFingerprint hash;
+  hash.Update(UnpackedWeightsFile::kFormatVersion);
+  hash.Update(static_cast<uint64_t>(XNN_EXTRA_BYTES));
+  auto update_array = [&hash](const TfLiteIntArray* array) {
+    if (array != nullptr) {
+      hash.Update(array->data, array->size * sizeof(int));
+    }
+  };
+  // Everything the unpacked data is computed from: the producer, the shape and
+  // type of its input and output, the input's quantization and sparsity
+  // parameters, and the input data unless it is itself unpacked.
+  size_t unpacked_data_size = 0;
+  for (int t : tensors_to_unpack) {
+    TfLiteNode* node = nullptr;
+    TfLiteRegistration* registration = nullptr;
+    if (context->GetNodeAndRegistration(context,
+                                        quasi_static_tensors_producers[t],
+                                        &node, &registration) != kTfLiteOk ||
+        node->inputs->size != 1) {
+      // Reported as an error when unpacking.
+      continue;
+    }
+    const int input = node->inputs->data[0];
+    const TfLiteTensor& input_tensor = context->tensors[input];
+    const TfLiteTensor& output_tensor = context->tensors[t];
+    hash.Update(t);
+    hash.Update(input);
+    hash.Update(registration->builtin_code);
+    hash.Update(output_tensor.type);
+    hash.Update(output_tensor.bytes);
+    update_array(output_tensor.dims);
+    hash.Update(input_tensor.type);
+    hash.Update(input_tensor.bytes);
+    update_array(input_tensor.dims);
+    hash.Update(input_tensor.params);
+    if (input_tensor.quantization.type == kTfLiteAffineQuantization) {
+      const auto* quant_params = static_cast<const TfLiteAffineQuantization*>(
+          input_tensor.quantization.params);
+      if (quant_params != nullptr) {
+        if (quant_params->scale != nullptr) {
+          hash.Update(quant_params->scale->data,
+                      quant_params->scale->size * sizeof(float));
+        }
+        update_array(quant_params->zero_point);
+        hash.Update(quant_params->quantized_dimension);
+      }
+    }
+    if (const TfLiteSparsity* sparsity = input_tensor.sparsity) {
+      update_array(sparsity->traversal_order);
+      update_array(sparsity->block_map);
+      for (int i = 0; i < sparsity->dim_metadata_size; i++) {
+        const TfLiteDimensionMetadata& dim = sparsity->dim_metadata[i];
+        hash.Update(dim.format);
+        hash.Update(dim.dense_size);
+        update_array(dim.array_segments);
+        update_array(dim.array_indices);
+      }
+    }
+    if (input_tensor.allocation_type == kTfLiteMmapRo &&
+        input_tensor.data.raw_const != nullptr) {
+      hash.Update(input_tensor.data.raw_const, input_tensor.bytes);
+    }
+    unpacked_data_size = (unpacked_data_size + XNN_EXTRA_BYTES - 1) /
+                             XNN_EXTRA_BYTES * XNN_EXTRA_BYTES +
+                         output_tensor.bytes;
+  }
+  *fingerprint = hash.value();
+  *size = unpacked_data_size;
+}
+
 void* SubgraphInit(TfLiteContext* context, const char* buffer, size_t length) {
   const TfLiteDelegateParams* params =
       reinterpret_cast<const TfLiteDelegateParams*>(buffer);
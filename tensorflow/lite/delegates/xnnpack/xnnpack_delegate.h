@@ -42,6 +42,11 @@ extern "C" {
 // Enable the latest XNNPACK operators and features in the delegate which have
 // not yet been enabled by default.
 #define TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_LATEST_OPERATORS 0x00000040
+// Handle input tensor resizes by reshaping the XNNPACK runtimes in place,
+// keeping their packed weights, instead of undoing and redoing the delegation.
+// Fails in AllocateTensors if the delegated operators can't be reshaped to the
+// new input shapes.
+#define TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING 0x00000080
 
 struct TfLiteXNNPackDelegateWeightsCache;
 
@@ -57,6 +62,7 @@ typedef struct {
   // - TFLITE_XNNPACK_DELEGATE_FLAG_VARIABLE_OPERATORS
   // - TFLITE_XNNPACK_DELEGATE_FLAG_TRANSIENT_INDIRECTION_BUFFER
   // - TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_LATEST_OPERATORS
+  // - TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING
   uint32_t flags;
   // Cache for packed weights, can be shared between multiple instances of
   // delegates.
@@ -66,6 +72,15 @@ typedef struct {
   bool handle_variable_ops;
   // Enable adaptive optimization for AVX CPUs.
   bool experimental_adaptive_avx_optimization;
+  // Path of a file in which the delegate keeps the weights it unpacks from
+  // static tensors (dequantized FP16/INT8 weights and densified sparse
+  // weights). If the file matches the model, it is memory-mapped instead of
+  // unpacking the weights again; otherwise it is rewritten. Packing done by
+  // XNNPACK itself is not persisted, see `weights_cache` for sharing it within
+  // a process. The string must stay valid for the lifetime of the delegate.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  const char* experimental_unpacked_weights_file_path;
 } TfLiteXNNPackDelegateOptions;
 
 // Returns a structure with the default XNNPack delegate options.
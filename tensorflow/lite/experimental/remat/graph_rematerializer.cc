@@ -0,0 +1,141 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/remat/graph_rematerializer.h"
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/compiler/mlir/lite/experimental/remat/rematerializer.h"
+
+namespace tflite {
+namespace {
+
+// The longest sequence of operators that is run again at once.
+constexpr int kMaxBlockLength = 8;
+// The smallest peak size reduction worth running operators again.
+constexpr int64_t kMinSavingsBytes = 1;
+
+// Mirrors the rematerializations chosen by the Rematerializer on a RematGraph.
+class GraphRematerializer : public mlir::TFL::Rematerializer {
+ public:
+  GraphRematerializer(const std::vector<int64_t>& tensor_sizes,
+                      const std::vector<RematOperator>& operators,
+                      const std::vector<int>& graph_inputs,
+                      const std::vector<int>& graph_outputs)
+      : num_tensors_(tensor_sizes.size()) {
+    for (const int64_t size : tensor_sizes) {
+      AddTensor(size);
+    }
+    // The graph inputs are produced before the first operator and the graph
+    // outputs consumed after the last one, by stateful operations that keep
+    // them alive.
+    const int entry = AddOperation(/*is_stateful=*/true);
+    AddUses(entry, graph_inputs);
+    std::vector<bool> is_graph_output(num_tensors_, false);
+    for (const int tensor : graph_outputs) {
+      if (tensor >= 0) is_graph_output[tensor] = true;
+    }
+    for (int i = 0; i < operators.size(); ++i) {
+      const RematOperator& op = operators[i];
+      // The graph outputs must keep their indices.
+      bool is_stateful = op.is_stateful;
+      for (const int tensor : op.outputs) {
+        if (tensor >= 0 && is_graph_output[tensor]) is_stateful = true;
+      }
+      const int operation = AddOperation(is_stateful);
+      AddUses(operation, op.inputs);
+      AddUses(operation, op.outputs);
+      graph_.nodes.push_back({i, op.inputs, op.outputs});
+    }
+    AddUses(AddOperation(/*is_stateful=*/true), graph_outputs);
+  }
+
+  void ApplyRemat(const RematSpec& remat) override {
+    // The operation indices include the entry operation.
+    const int begin = remat.begin - 1;
+    const int end = remat.end - 1;
+    const int insert = remat.insert - 1;
+
+    std::map<int, int> copies;
+    std::vector<RematNode> block(graph_.nodes.begin() + begin,
+                                 graph_.nodes.begin() + end);
+    for (RematNode& node : block) {
+      Rename(copies, &node.inputs);
+      for (int& tensor : node.outputs) {
+        if (tensor < 0) continue;
+        const int copy = num_tensors_ + graph_.tensor_copies.size();
+        graph_.tensor_copies.push_back(GetOriginal(tensor));
+        copies[tensor] = copy;
+        tensor = copy;
+      }
+    }
+    graph_.nodes.insert(graph_.nodes.begin() + insert, block.begin(),
+                        block.end());
+    for (int i = insert + block.size(); i < graph_.nodes.size(); ++i) {
+      Rename(copies, &graph_.nodes[i].inputs);
+    }
+    graph_.num_recomputed_ops += block.size();
+  }
+
+  RematGraph Release() { return std::move(graph_); }
+
+ private:
+  void AddUses(int operation, const std::vector<int>& tensors) {
+    for (const int tensor : tensors) {
+      if (tensor >= 0) AddUse(operation, tensor);
+    }
+  }
+
+  static void Rename(const std::map<int, int>& copies,
+                     std::vector<int>* tensors) {
+    for (int& tensor : *tensors) {
+      const auto copy = copies.find(tensor);
+      if (copy != copies.end()) tensor = copy->second;
+    }
+  }
+
+  int GetOriginal(int tensor) const {
+    return tensor < num_tensors_ ? tensor
+                                 : graph_.tensor_copies[tensor - num_tensors_];
+  }
+
+  const int num_tensors_;
+  RematGraph graph_;
+};
+
+}  // namespace
+
+RematGraph RematerializeGraph(const std::vector<int64_t>& tensor_sizes,
+                              const std::vector<RematOperator>& operators,
+                              const std::vector<int>& graph_inputs,
+                              const std::vector<int>& graph_outputs,
+                              int max_recomputed_ops) {
+  GraphRematerializer rematerializer(tensor_sizes, operators, graph_inputs,
+                                     graph_outputs);
+  const int64_t peak_bytes_before = rematerializer.GetPeakMemory().size;
+  if (max_recomputed_ops > 0) {
+    rematerializer.RunGreedyAlgorithm(max_recomputed_ops, kMaxBlockLength,
+                                      kMinSavingsBytes);
+  }
+  const int64_t peak_bytes_after = rematerializer.GetPeakMemory().size;
+  RematGraph graph = rematerializer.Release();
+  graph.peak_bytes_before = peak_bytes_before;
+  graph.peak_bytes_after = peak_bytes_after;
+  return graph;
+}
+
+}  // namespace tflite
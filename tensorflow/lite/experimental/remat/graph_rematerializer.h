@@ -0,0 +1,76 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/// \file
+///
+/// Functions for rematerializing the operators of a graph when it is built:
+/// some operators with small inputs and large outputs are run again before
+/// the later uses of their outputs, instead of keeping the outputs alive,
+/// which lowers the peak size of the arena at the cost of extra compute.
+///
+
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_REMAT_GRAPH_REMATERIALIZER_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_REMAT_GRAPH_REMATERIALIZER_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace tflite {
+
+/// An operator of the graph to rematerialize.
+struct RematOperator {
+  std::vector<int> inputs;
+  std::vector<int> outputs;
+  /// Stateful operators, e.g. the ones accessing variables or producing random
+  /// numbers, are never run again.
+  bool is_stateful = false;
+};
+
+/// An operator of a rematerialized graph: operator `op_index` of the original
+/// graph, reading and writing the given tensors.
+struct RematNode {
+  int op_index;
+  std::vector<int> inputs;
+  std::vector<int> outputs;
+};
+
+/// A rematerialized graph.
+struct RematGraph {
+  /// The operators in execution order.
+  std::vector<RematNode> nodes;
+  /// The tensors added by rematerialization, which get indices starting at
+  /// the number of tensors of the original graph. Element `i` is the index of
+  /// the original tensor that tensor `num_tensors + i` is a copy of.
+  std::vector<int> tensor_copies;
+  /// The number of operators that are run again.
+  int num_recomputed_ops = 0;
+  /// The estimated peak size of the tensors alive at the same time, in bytes.
+  int64_t peak_bytes_before = 0;
+  int64_t peak_bytes_after = 0;
+};
+
+/// Rematerializes the graph of `operators`, in execution order, over tensors
+/// of `tensor_sizes` bytes, running at most `max_recomputed_ops` operators
+/// again. Constant tensors, which don't live in the arena, should have a size
+/// of 0. Optional tensors are -1. Tensors in `graph_inputs` and
+/// `graph_outputs` stay alive for the whole execution.
+RematGraph RematerializeGraph(const std::vector<int64_t>& tensor_sizes,
+                              const std::vector<RematOperator>& operators,
+                              const std::vector<int>& graph_inputs,
+                              const std::vector<int>& graph_outputs,
+                              int max_recomputed_ops);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_REMAT_GRAPH_REMATERIALIZER_H_
@@ -0,0 +1,92 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/remat/graph_rematerializer.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// A graph whose large tensor %1 is kept alive across another large tensor %3:
+//   %1 = op0(%0)
+//   %2 = op1(%1)
+//   %3 = op2(%2)
+//   %4 = op3(%3)
+//   %5 = op4(%1, %4)
+class GraphRematerializerTest : public ::testing::Test {
+ protected:
+  std::vector<int64_t> tensor_sizes_ = {1, 100, 1, 100, 1, 1};
+  std::vector<RematOperator> operators_ = {
+      {{0}, {1}}, {{1}, {2}}, {{2}, {3}}, {{3}, {4}}, {{1, 4}, {5}},
+  };
+  std::vector<int> inputs_ = {0};
+  std::vector<int> outputs_ = {5};
+};
+
+TEST_F(GraphRematerializerTest, RecomputesLargeOutput) {
+  const RematGraph graph = RematerializeGraph(tensor_sizes_, operators_,
+                                              inputs_, outputs_,
+                                              /*max_recomputed_ops=*/4);
+  ASSERT_EQ(graph.nodes.size(), 6);
+  EXPECT_EQ(graph.nodes[4].op_index, 0);
+  EXPECT_THAT(graph.nodes[4].inputs, ElementsAre(0));
+  EXPECT_THAT(graph.nodes[4].outputs, ElementsAre(6));
+  EXPECT_EQ(graph.nodes[5].op_index, 4);
+  EXPECT_THAT(graph.nodes[5].inputs, ElementsAre(6, 4));
+  EXPECT_THAT(graph.tensor_copies, ElementsAre(1));
+  EXPECT_EQ(graph.num_recomputed_ops, 1);
+  EXPECT_LT(graph.peak_bytes_after, graph.peak_bytes_before);
+}
+
+TEST_F(GraphRematerializerTest, KeepsStatefulOperators) {
+  operators_[0].is_stateful = true;
+  const RematGraph graph = RematerializeGraph(tensor_sizes_, operators_,
+                                              inputs_, outputs_,
+                                              /*max_recomputed_ops=*/4);
+  ASSERT_EQ(graph.nodes.size(), 5);
+  EXPECT_THAT(graph.tensor_copies, IsEmpty());
+  EXPECT_EQ(graph.num_recomputed_ops, 0);
+  EXPECT_EQ(graph.peak_bytes_after, graph.peak_bytes_before);
+}
+
+TEST_F(GraphRematerializerTest, KeepsGraphOutputs) {
+  outputs_ = {1, 5};
+  const RematGraph graph = RematerializeGraph(tensor_sizes_, operators_,
+                                              inputs_, outputs_,
+                                              /*max_recomputed_ops=*/4);
+  EXPECT_EQ(graph.nodes.size(), 5);
+  EXPECT_EQ(graph.num_recomputed_ops, 0);
+}
+
+TEST_F(GraphRematerializerTest, ZeroBudget) {
+  const RematGraph graph = RematerializeGraph(tensor_sizes_, operators_,
+                                              inputs_, outputs_,
+                                              /*max_recomputed_ops=*/0);
+  ASSERT_EQ(graph.nodes.size(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(graph.nodes[i].op_index, i);
+  }
+  EXPECT_EQ(graph.num_recomputed_ops, 0);
+}
+
+}  // namespace
+}  // namespace tflite
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/external_cpu_backend_context.h"
 
+#include <mutex>  // NOLINT(build/c++11)
+
 #include "tensorflow/lite/core/c/common.h"
 
 namespace tflite {
@@ -22,7 +24,9 @@ namespace {
 TfLiteStatus RefreshExternalCpuBackendContext(TfLiteContext* context) {
   auto* const external_context = static_cast<ExternalCpuBackendContext*>(
       context->GetExternalContext(context, kTfLiteCpuBackendContext));
-  if (external_context && external_context->internal_backend_context() &&
+  // Contexts leased from a pool keep the number of threads set by the pool.
+  if (external_context && external_context->pool() == nullptr &&
+      external_context->internal_backend_context() &&
       context->recommended_num_threads != -1) {
     external_context->internal_backend_context()->SetMaxNumThreads(
         context->recommended_num_threads);
@@ -37,4 +41,43 @@ ExternalCpuBackendContext::ExternalCpuBackendContext()
   this->Refresh = RefreshExternalCpuBackendContext;
 }
 
+ExternalCpuBackendContext::ExternalCpuBackendContext(
+    TfLiteInternalBackendContextPool* pool)
+    : internal_backend_context_(nullptr), pool_(pool) {
+  this->type = kTfLiteCpuBackendContext;
+  this->Refresh = RefreshExternalCpuBackendContext;
+}
+
+TfLiteInternalBackendContext* ExternalCpuBackendContext::AcquireFromPool() {
+  std::lock_guard<std::mutex> lock(lease_mutex_);
+  if (leased_backend_context_ == nullptr) {
+    leased_backend_context_ = pool_->Acquire();
+  }
+  return leased_backend_context_;
+}
+
+void ExternalCpuBackendContext::ReleaseToPool() {
+  if (pool_ == nullptr) return;
+  std::lock_guard<std::mutex> lock(lease_mutex_);
+  if (leased_backend_context_ != nullptr) {
+    pool_->Release(leased_backend_context_);
+    leased_backend_context_ = nullptr;
+  }
+}
+
+void ExternalCpuBackendContext::EnterLeaseScope() {
+  if (pool_ == nullptr) return;
+  std::lock_guard<std::mutex> lock(lease_mutex_);
+  ++lease_scope_depth_;
+}
+
+void ExternalCpuBackendContext::ExitLeaseScope() {
+  if (pool_ == nullptr) return;
+  std::lock_guard<std::mutex> lock(lease_mutex_);
+  if (--lease_scope_depth_ == 0 && leased_backend_context_ != nullptr) {
+    pool_->Release(leased_backend_context_);
+    leased_backend_context_ = nullptr;
+  }
+}
+
 }  // namespace tflite
@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_LITE_EXTERNAL_CPU_BACKEND_CONTEXT_H_
 
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <utility>
 
 #include "tensorflow/lite/core/c/common.h"
@@ -40,6 +41,29 @@ class TfLiteInternalBackendContext {
   virtual void ClearCaches() = 0;
 };
 
+// A set of internal backend contexts shared by interpreters that may be invoked
+// concurrently, e.g. many models served by one process. Instead of each
+// interpreter owning a backend context (with its own thread pool and scratch
+// memory), an interpreter leases one of the pool's contexts while it runs
+// kernels, so thread and memory usage are bounded by the number of concurrent
+// invocations rather than the number of interpreters.
+//
+// See ExternalCpuBackendContext(TfLiteInternalBackendContextPool*) for how an
+// interpreter uses a pool.
+//
+// WARNING: This is an experimental API and subject to change.
+class TfLiteInternalBackendContextPool {
+ public:
+  virtual ~TfLiteInternalBackendContextPool() {}
+
+  // Blocks until a context is available and returns it. Implementations should
+  // serve waiting callers in order so that no interpreter starves.
+  virtual TfLiteInternalBackendContext* Acquire() = 0;
+
+  // Returns a context obtained from Acquire() to the pool.
+  virtual void Release(TfLiteInternalBackendContext* context) = 0;
+};
+
 // This TfLiteExternalContext-derived class is the default
 // 'kTfLiteCpuBackendContext'-typed context that's used internally in TF Lite
 // framework. The primary purpose of having this class is to allow the same cpu
@@ -78,24 +102,62 @@ class TfLiteInternalBackendContext {
 // context if/when the interpreter no longer needs the shared context.
 // See, e.g., TFLiteInterpreter destructor clears caches in the case of a
 // shared ExternalCpuBackendContext.
+//
+// Alternatively, interpreters that are invoked concurrently can share a
+// TfLiteInternalBackendContextPool. Each of them gets its own
+// ExternalCpuBackendContext created from the pool:
+//
+//  CpuBackendContextPool pool(/*num_contexts=*/4, /*num_threads=*/2);
+//  ExternalCpuBackendContext ctxt1(&pool);
+//  interpreter1->SetExternalContext(kTfLiteCpuBackendContext, &ctxt1);
+//  ExternalCpuBackendContext ctxt2(&pool);
+//  interpreter2->SetExternalContext(kTfLiteCpuBackendContext, &ctxt2);
+//
+// A context is then leased from the pool when a kernel first needs it, and
+// returned when the interpreter is done allocating tensors or invoking. The
+// number of threads is set by the pool, 'SetNumThreads' has no effect on it.
 class ExternalCpuBackendContext : public TfLiteExternalContext {
  public:
   ExternalCpuBackendContext();
-  ~ExternalCpuBackendContext() {}
+  explicit ExternalCpuBackendContext(TfLiteInternalBackendContextPool* pool);
+  ~ExternalCpuBackendContext() { ReleaseToPool(); }
 
   void set_internal_backend_context(
       std::unique_ptr<TfLiteInternalBackendContext> internal_backend_context) {
     internal_backend_context_ = std::move(internal_backend_context);
   }
 
+  // When using a pool, returns the leased context, or nullptr if none is
+  // leased.
   TfLiteInternalBackendContext* internal_backend_context() const {
-    return internal_backend_context_.get();
+    return pool_ != nullptr ? leased_backend_context_
+                            : internal_backend_context_.get();
   }
 
+  TfLiteInternalBackendContextPool* pool() const { return pool_; }
+
+  // Leases a context from the pool unless one is already leased, and returns
+  // it. Thread-safe, so that kernels invoked concurrently share the lease.
+  TfLiteInternalBackendContext* AcquireFromPool();
+
+  // Returns the leased context, if any, to the pool.
+  void ReleaseToPool();
+
+  // Subgraphs bracket allocating tensors and invoking with these calls, so
+  // that the leased context is returned to the pool once the outermost call
+  // is done (control flow kernels allocate and invoke nested subgraphs).
+  void EnterLeaseScope();
+  void ExitLeaseScope();
+
  private:
   // Note the actual internal backend context object is lazily initialized.
   std::unique_ptr<TfLiteInternalBackendContext> internal_backend_context_;
 
+  TfLiteInternalBackendContextPool* const pool_ = nullptr;
+  std::mutex lease_mutex_;
+  TfLiteInternalBackendContext* leased_backend_context_ = nullptr;
+  int lease_scope_depth_ = 0;
+
   ExternalCpuBackendContext(const ExternalCpuBackendContext&) = delete;
   ExternalCpuBackendContext& operator=(const ExternalCpuBackendContext&) =
       delete;
@@ -29,7 +29,11 @@ class InterpreterOptions {
       : experimental_preserve_all_tensors_(false),
         experimental_ensure_dynamic_tensors_are_released_(false),
         experimental_optimize_memory_for_large_tensors_(0),
-        experimental_disable_delegate_clustering_(false) {}
+        experimental_disable_delegate_clustering_(false),
+        experimental_prepared_state_cache_size_(0),
+        experimental_rematerialization_budget_(0),
+        experimental_prefetch_constant_tensors_(false),
+        experimental_share_constant_buffers_(false) {}
 
   /// Preserving all intermediates tensors for debugging.
   /// WARNING: This is an experimental API and subject to change.
@@ -93,11 +97,84 @@ class InterpreterOptions {
     experimental_disable_delegate_clustering_ = value;
   }
 
+  /// Keeps the prepared state of the graph (op data, temporaries and tensor
+  /// shapes) for up to `value` input shapes besides the current one, so that
+  /// `AllocateTensors` doesn't prepare the ops again when the inputs are
+  /// resized back to one of them. Each cached state holds its own copy of the
+  /// op data. Graphs with delegates, control flow ops, dynamic or persistent
+  /// arena tensors, or custom allocations are always prepared again.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetPreparedStateCacheSize(int value) {
+    experimental_prepared_state_cache_size_ = value;
+  }
+
+  /// Returns the number of prepared states cached for other input shapes.
+  /// WARNING: This is an experimental API and subject to change.
+  int GetPreparedStateCacheSize() {
+    return experimental_prepared_state_cache_size_;
+  }
+
+  /// Runs up to `value` operators of each subgraph a second time, right
+  /// before the later uses of their outputs, where this lowers the peak size
+  /// of the arena. The operators are chosen when the interpreter is built and
+  /// the extra compute is logged. Stateful operators and the ones producing
+  /// subgraph outputs are never run again. Models with control dependencies
+  /// metadata are left unchanged.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetRematerializationBudget(int value) {
+    experimental_rematerialization_budget_ = value;
+  }
+
+  /// Returns the maximum number of operators run again per subgraph. It
+  /// returns zero if the feature is not enabled.
+  /// WARNING: This is an experimental API and subject to change.
+  int GetRematerializationBudget() {
+    return experimental_rematerialization_budget_;
+  }
+
+  /// Asks the OS to read the data of the constant tensors of memory-mapped
+  /// models in the background while the interpreter is built, so that the
+  /// first inference doesn't wait for page faults. This overlaps the reads of
+  /// large models with parsing, kernel initialization and delegate
+  /// application. It has no effect on models that aren't memory-mapped.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetPrefetchConstantTensors(bool value = true) {
+    experimental_prefetch_constant_tensors_ = value;
+  }
+
+  /// Returns if the `experimental_prefetch_constant_tensors_` feature is
+  /// enabled.
+  /// WARNING: This is an experimental API and subject to change.
+  bool GetPrefetchConstantTensors() {
+    return experimental_prefetch_constant_tensors_;
+  }
+
+  /// Shares the large constant tensors of the model with the other models of
+  /// the process, built with this option, whose constant tensors have the
+  /// same contents, e.g. variants of one base model. Each shared tensor is
+  /// copied once into memory that is freed with the last interpreter using
+  /// it, instead of each model keeping its own copy resident. The tensors are
+  /// hashed and copied when the interpreter is built.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetShareConstantBuffers(bool value = true) {
+    experimental_share_constant_buffers_ = value;
+  }
+
+  /// Returns if the `experimental_share_constant_buffers_` feature is enabled.
+  /// WARNING: This is an experimental API and subject to change.
+  bool GetShareConstantBuffers() {
+    return experimental_share_constant_buffers_;
+  }
+
  private:
   bool experimental_preserve_all_tensors_;
   bool experimental_ensure_dynamic_tensors_are_released_;
   int experimental_optimize_memory_for_large_tensors_;
   bool experimental_disable_delegate_clustering_;
+  int experimental_prepared_state_cache_size_;
+  int experimental_rematerialization_budget_;
+  bool experimental_prefetch_constant_tensors_;
+  bool experimental_share_constant_buffers_;
 };
 
 }  // namespace tflite
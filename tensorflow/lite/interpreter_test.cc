@@ -1261,6 +1261,58 @@ TEST_F(InterpreterTest, ExternalBackendContextClearsCachesOnDelete) {
   EXPECT_EQ(cpu_backend_context->num_calls, 1);
 }
 
+struct TestCpuBackendContextPool : public TfLiteInternalBackendContextPool {
+  TfLiteInternalBackendContext* Acquire() override {
+    ++num_acquires;
+    return &context;
+  }
+  void Release(TfLiteInternalBackendContext* released) override {
+    EXPECT_EQ(released, &context);
+    ++num_releases;
+  }
+  TestCpuBackendContext context;
+  int num_acquires = 0;
+  int num_releases = 0;
+};
+
+TEST_F(InterpreterTest, ExternalBackendContextLeasesFromPoolPerInvoke) {
+  TestCpuBackendContextPool pool;
+  ExternalCpuBackendContext external_cpu_context(&pool);
+  interpreter_->SetExternalContext(kTfLiteCpuBackendContext,
+                                   &external_cpu_context);
+
+  // Like CpuBackendContext::GetFromContext, asks for the context twice, which
+  // must only lease it once.
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    auto* external_context = static_cast<ExternalCpuBackendContext*>(
+        context->GetExternalContext(context, kTfLiteCpuBackendContext));
+    TfLiteInternalBackendContext* first = external_context->AcquireFromPool();
+    TfLiteInternalBackendContext* second = external_context->AcquireFromPool();
+    return first != nullptr && first == second ? kTfLiteOk : kTfLiteError;
+  };
+  ASSERT_EQ(interpreter_->AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(interpreter_->SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter_->SetOutputs({1}), kTfLiteOk);
+  TfLiteQuantizationParams quant;
+  interpreter_->SetTensorParametersReadWrite(0, kTfLiteFloat32, "", {3}, quant);
+  interpreter_->SetTensorParametersReadWrite(1, kTfLiteFloat32, "", {3}, quant);
+  ASSERT_EQ(interpreter_->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                                &reg),
+            kTfLiteOk);
+
+  // Nothing asks for the context while allocating tensors.
+  ASSERT_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(pool.num_acquires, 0);
+
+  for (int i = 1; i <= 3; ++i) {
+    ASSERT_EQ(interpreter_->Invoke(), kTfLiteOk);
+    EXPECT_EQ(pool.num_acquires, i);
+    EXPECT_EQ(pool.num_releases, i);
+    EXPECT_EQ(external_cpu_context.internal_backend_context(), nullptr);
+  }
+}
+
 // Test fixture that allows playing with execution plans. It creates a two
 // node graph that can be executed in either [0,1] order or [1,0] order.
 // The CopyOp records when it is invoked in the class member run_order_
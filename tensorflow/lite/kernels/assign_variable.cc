@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/lite/experimental/resource/resource_variable.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/variable_update_util.h"
 
 namespace tflite {
 namespace ops {
@@ -29,6 +30,19 @@ namespace assign_variable {
 constexpr int kInputVariableId = 0;
 constexpr int kInputValue = 1;
 
+struct OpData {
+  // See FindInPlaceVariableUpdate().
+  int in_place_update_resource_id = -1;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  return new OpData();
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  delete reinterpret_cast<OpData*>(buffer);
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 2);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 0);
@@ -40,6 +54,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                            input_resource_id_tensor->type == kTfLiteInt32));
   TF_LITE_ENSURE_EQ(context, NumElements(input_resource_id_tensor), 1);
 
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  op_data->in_place_update_resource_id =
+      FindInPlaceVariableUpdate(context, node);
+
   return kTfLiteOk;
 }
 
@@ -53,6 +71,14 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_OK(
       context, GetInputSafe(context, node, kInputValue, &input_value_tensor));
 
+  // DYNAMIC_UPDATE_SLICE already updated the variable.
+  const OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  if (op_data->in_place_update_resource_id >= 0 &&
+      GetInPlaceUpdatableVariable(context, input_resource_id_tensor,
+                                  input_value_tensor)) {
+    return kTfLiteOk;
+  }
+
   int resource_id = input_resource_id_tensor->data.i32[0];
   auto& resources = subgraph->resources();
   resource::CreateResourceVariableIfNotAvailable(&resources, resource_id);
@@ -66,7 +92,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace assign_variable
 
 TfLiteRegistration* Register_ASSIGN_VARIABLE() {
-  static TfLiteRegistration r = {nullptr, nullptr, assign_variable::Prepare,
+  static TfLiteRegistration r = {assign_variable::Init, assign_variable::Free,
+                                 assign_variable::Prepare,
                                  assign_variable::Eval};
   return &r;
 }
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 #include "tensorflow/lite/kernels/internal/optimized/batch_matmul.h"
 #include "tensorflow/lite/kernels/internal/optimized/optimized_ops.h"
+#include "tensorflow/lite/kernels/internal/optimized/sparse_ops/fully_connected.h"
 #include "tensorflow/lite/kernels/internal/reference/reference_ops.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -45,6 +46,7 @@ static const int kOutputTensor = 0;
 
 static const int kNumTempTensorsForAdjoints = 2;
 static const int kNumTempTensorsForHybrid = 5;
+static const int kNumTempTensorsForInt4 = 1;
 
 // This file has two implementations of Transpose.
 enum KernelType {
@@ -64,6 +66,10 @@ struct OpData {
   // The index of the temporary tensors where we store transposed LHS/RHS.
   int scratch_tensor_index;
   bool rhs_transposed;
+  // If the RHS is constant int4, we only unpack it to int8 once.
+  bool rhs_unpacked = false;
+  // The RHS is 1x4 block sparse, see IsSparseWeight1x4().
+  bool has_sparse_rhs = false;
   bool compute_row_sums = false;
 };
 
@@ -87,7 +93,8 @@ void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   // Creates the temp tensors to store the transposed LHS and/or RHS, and
   // extra buffers for the quantized case.
   context->AddTensors(context,
-                      kNumTempTensorsForAdjoints + kNumTempTensorsForHybrid,
+                      kNumTempTensorsForAdjoints + kNumTempTensorsForHybrid +
+                          kNumTempTensorsForInt4,
                       &op_data->scratch_tensor_index);
   return op_data;
 }
@@ -132,10 +139,17 @@ TfLiteStatus InitializeTemporaries(TfLiteContext* context, TfLiteNode* node,
   TfLiteIntArrayFree(node->temporaries);
   // For "hybrid" quantization, we impose the constraint that the LHS
   // is float (typically an activation from a prior layer) and the RHS
-  // is quantized int8.
-  bool is_hybrid =
-      (op_context->lhs->type == kTfLiteFloat32 && rhs->type == kTfLiteInt8);
-  if (is_hybrid) {
+  // is quantized int8 or int4. Int4 weights are unpacked to int8 first.
+  bool is_hybrid = (op_context->lhs->type == kTfLiteFloat32 &&
+                    (rhs->type == kTfLiteInt8 || rhs->type == kTfLiteInt4));
+  const bool is_int4 = is_hybrid && rhs->type == kTfLiteInt4;
+  // The type of the RHS once unpacked.
+  const TfLiteType rhs_type = is_int4 ? kTfLiteInt8 : rhs->type;
+  if (is_int4) {
+    node->temporaries =
+        TfLiteIntArrayCreate(kNumTempTensorsForAdjoints +
+                             kNumTempTensorsForHybrid + kNumTempTensorsForInt4);
+  } else if (is_hybrid) {
     node->temporaries = TfLiteIntArrayCreate(kNumTempTensorsForAdjoints +
                                              kNumTempTensorsForHybrid);
   } else {
@@ -196,7 +210,7 @@ TfLiteStatus InitializeTemporaries(TfLiteContext* context, TfLiteNode* node,
     } else {
       scratch_buffer->allocation_type = kTfLiteArenaRw;
     }
-    scratch_buffer->type = op_context->rhs->type;
+    scratch_buffer->type = rhs_type;
     TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, scratch_buffer,
                                                      scratch_buffer_size));
   }
@@ -222,7 +236,7 @@ TfLiteStatus InitializeTemporaries(TfLiteContext* context, TfLiteNode* node,
     TfLiteTensor* input_quantized;
     TF_LITE_ENSURE_OK(context, GetTemporarySafe(context, node, /*index=*/2,
                                                 &input_quantized));
-    input_quantized->type = op_context->rhs->type;
+    input_quantized->type = rhs_type;
     input_quantized->allocation_type = kTfLiteArenaRw;
 
     TfLiteIntArray* input_quantized_size =
@@ -288,6 +302,23 @@ TfLiteStatus InitializeTemporaries(TfLiteContext* context, TfLiteNode* node,
     }
   }
 
+  // Temp tensor for the RHS unpacked from int4 to int8.
+  if (is_int4) {
+    node->temporaries->data[7] = op_data->scratch_tensor_index + 7;
+    TfLiteTensor* unpacked_rhs;
+    TF_LITE_ENSURE_OK(
+        context, GetTemporarySafe(context, node, /*index=*/7, &unpacked_rhs));
+    unpacked_rhs->type = kTfLiteInt8;
+    if (IsConstantTensor(rhs)) {
+      unpacked_rhs->allocation_type = kTfLiteArenaRwPersistent;
+    } else {
+      unpacked_rhs->allocation_type = kTfLiteArenaRw;
+    }
+    TF_LITE_ENSURE_OK(context,
+                      context->ResizeTensor(context, unpacked_rhs,
+                                            TfLiteIntArrayCopy(rhs->dims)));
+  }
+
   return kTfLiteOk;
 }
 
@@ -345,12 +376,28 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                               lhs_data->type == kTfLiteInt16);
   TF_LITE_ENSURE(context, rhs_data->type == kTfLiteFloat32 ||
                               rhs_data->type == kTfLiteInt8 ||
-                              rhs_data->type == kTfLiteInt16);
-  // Either we have a hybrid quantization with a float32 and an int8 input,
-  // otherwise both inputs should be of the same type.
+                              rhs_data->type == kTfLiteInt16 ||
+                              rhs_data->type == kTfLiteInt4);
+  // Either we have a hybrid quantization with a float32 and an int8 or int4
+  // input, otherwise both inputs should be of the same type.
   TF_LITE_ENSURE(context, (lhs_data->type == kTfLiteFloat32 &&
-                           rhs_data->type == kTfLiteInt8) ||
+                           (rhs_data->type == kTfLiteInt8 ||
+                            rhs_data->type == kTfLiteInt4)) ||
                               lhs_data->type == rhs_data->type);
+  // A sparse RHS is supported as the float weights of a matmul with adj_y,
+  // which runs on the block sparse kernel of fully_connected.
+  if (rhs_data->sparsity != nullptr) {
+    TF_LITE_ENSURE_TYPES_EQ(context, lhs_data->type, kTfLiteFloat32);
+    TF_LITE_ENSURE_TYPES_EQ(context, rhs_data->type, kTfLiteFloat32);
+    TF_LITE_ENSURE_EQ(context, NumDimensions(rhs_data), 2);
+    TF_LITE_ENSURE(context, adj_y && !adj_x);
+    if (!optimized_ops::IsSparseWeight1x4(*rhs_data->sparsity,
+                                          *rhs_data->dims)) {
+      TF_LITE_KERNEL_LOG(context, "Unsupported sparse RHS format.");
+      return kTfLiteError;
+    }
+    op_data->has_sparse_rhs = true;
+  }
   // Support dimensions between 2 and 5, inclusive.
   TF_LITE_ENSURE(context, NumDimensions(lhs_data) >= 2);
   TF_LITE_ENSURE(context, NumDimensions(lhs_data) <= 5);
@@ -663,6 +710,28 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+// Multiplies by a 1x4 block sparse [N, K] RHS with adj_y, as a fully_connected
+// whose weights are the RHS. There is no separate reference kernel.
+TfLiteStatus EvalSparseFloat(TfLiteContext* context, const TfLiteTensor* lhs,
+                             const TfLiteTensor* rhs, TfLiteTensor* output) {
+  const int accum_depth = SizeOfDimension(rhs, 1);
+  const int output_depth = SizeOfDimension(rhs, 0);
+  const int batches = NumElements(lhs) / accum_depth;
+  FullyConnectedParams op_params;
+  op_params.float_activation_min = std::numeric_limits<float>::lowest();
+  op_params.float_activation_max = std::numeric_limits<float>::max();
+  TfLiteDimensionMetadata dim_metadata[3];
+  const TfLiteSparsity sparsity =
+      optimized_ops::GetSparseWeight1x4Matrix(*rhs->sparsity, dim_metadata);
+  optimized_ops::FullyConnectedSparseWeight1x4(
+      sparsity, op_params, RuntimeShape({batches, accum_depth}),
+      GetTensorData<float>(lhs), RuntimeShape({output_depth, accum_depth}),
+      GetTensorData<float>(rhs), RuntimeShape(), nullptr,
+      RuntimeShape({batches, output_depth}), GetTensorData<float>(output),
+      CpuBackendContext::GetFromContext(context));
+  return kTfLiteOk;
+}
+
 TfLiteTensor* GetTempRhs(TfLiteContext* context, TfLiteNode* node,
                          const TfLiteTensor* rhs) {
   TfLiteTensor* transposed_rhs = GetTemporary(context, node, 1);
@@ -717,6 +786,24 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteTensor* output;
   TF_LITE_ENSURE_OK(context,
                     GetOutputSafe(context, node, kOutputTensor, &output));
+  if (op_data->has_sparse_rhs) {
+    return EvalSparseFloat(context, lhs, rhs, output);
+  }
+  const bool rhs_is_constant = IsConstantTensor(rhs);
+  if (rhs->type == kTfLiteInt4) {
+    // Unpack the weights to int8 and run them through the int8 hybrid path.
+    TfLiteTensor* unpacked_rhs;
+    TF_LITE_ENSURE_OK(
+        context, GetTemporarySafe(context, node, /*index=*/7, &unpacked_rhs));
+    if (!(rhs_is_constant && op_data->rhs_unpacked)) {
+      tensor_utils::UnpackDenseInt4IntoInt8(GetTensorData<int8_t>(rhs),
+                                            NumElements(rhs),
+                                            GetTensorData<int8_t>(unpacked_rhs));
+      op_data->rhs_unpacked = true;
+    }
+    unpacked_rhs->params = rhs->params;
+    rhs = unpacked_rhs;
+  }
   RuntimeShape orig_lhs_shape = GetTensorShape(lhs);
   RuntimeShape orig_rhs_shape = GetTensorShape(rhs);
 
@@ -760,7 +847,7 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   if (!adj_y && !implicit_transpose_possible) {
     // TODO(b/154760341) Constant tensors should already be transposed, but
     // we transpose once if necessary for now.
-    if (!(IsConstantTensor(rhs) && op_data->rhs_transposed)) {
+    if (!(rhs_is_constant && op_data->rhs_transposed)) {
       TransposeRowsColumns(context, rhs, GetTemporary(context, node, 1));
       op_data->rhs_transposed = true;
     }
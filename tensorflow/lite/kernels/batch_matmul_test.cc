@@ -416,6 +416,62 @@ TEST(ConstRHSBatchMatMulOpModel, RHSNotAdjoint) {
   EXPECT_THAT(model.GetOutputShape(), ElementsAreArray({1, 6, 3}));
 }
 
+// The RHS is a constant float matrix stored in a sparse format.
+class SparseRHSBatchMatMulOpModel : public SingleOpModel {
+ public:
+  SparseRHSBatchMatMulOpModel(TfLiteRegistration* registration,
+                              const TensorData& lhs, const TensorData& rhs,
+                              const std::vector<float>& rhs_data) {
+    lhs_id_ = AddInput(lhs);
+    rhs_id_ = AddConstSparseInput(rhs, rhs_data);
+    output_id_ = AddOutput(TensorType_FLOAT32);
+    SetBuiltinOp(BuiltinOperator_BATCH_MATMUL,
+                 BuiltinOptions_BatchMatMulOptions,
+                 CreateBatchMatMulOptions(builder_, /*adj_x=*/false,
+                                          /*adj_y=*/true)
+                     .Union());
+    resolver_ = std::make_unique<SingleOpResolver>(
+        BuiltinOperator_BATCH_MATMUL, registration);
+    BuildInterpreter({GetShape(lhs_id_), GetShape(rhs_id_)},
+                     /*num_threads=*/-1, /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/false);
+  }
+
+  int lhs() const { return lhs_id_; }
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_id_); }
+  std::vector<int32_t> GetOutputShape() { return GetTensorShape(output_id_); }
+
+ protected:
+  int lhs_id_;
+  int rhs_id_;
+  int output_id_;
+};
+
+TEST_P(BatchMatMulOpTest, Float32Test_SparseRHS1x4) {
+  TensorData rhs = {TensorType_FLOAT32, {3, 8}};
+  rhs.traversal_order = {0, 1, 2};
+  rhs.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  rhs.block_map = {1};
+  rhs.block_size = {4};
+  SparseRHSBatchMatMulOpModel model(GetRegistration(),
+                                    {TensorType_FLOAT32, {2, 2, 8}}, rhs,
+                                    {
+                                        1, 2, 3, 4, 0, 0, 0, 0,   // n = 0
+                                        0, 0, 0, 0, 0, 0, 0, 0,   // n = 1
+                                        0, 0, 0, 0, 1, -1, 1, -1  // n = 2
+                                    });
+  model.PopulateTensor<float>(model.lhs(), {
+                                               1, 1, 1, 1, 1, 2, 3, 4,  //
+                                               1, 2, 3, 4, 1, 1, 1, 1,  //
+                                               2, 2, 2, 2, 0, 0, 0, 0,  //
+                                               0, 0, 0, 0, 4, 3, 2, 1,  //
+                                           });
+  ASSERT_EQ(model.Invoke(), kTfLiteOk);
+  EXPECT_THAT(model.GetOutput(),
+              ElementsAreArray({10, 0, -2, 30, 0, 0, 20, 0, 0, 0, 0, 2}));
+  EXPECT_THAT(model.GetOutputShape(), ElementsAreArray({2, 2, 3}));
+}
+
 // In the hybrid model the weights are quantized int8. But the input
 // and output are expected to be in float precision.
 class HybridBatchMatMulOpModel : public SingleOpModel {
@@ -452,6 +508,10 @@ class HybridBatchMatMulOpModel : public SingleOpModel {
     SignedSymmetricQuantizeAndPopulate(rhs_id_, f);
   }
 
+  void SetSignedWeights4Bit(std::initializer_list<float> f) {
+    SignedSymmetricQuantizeAndPopulate4Bit(rhs_id_, f);
+  }
+
   void SetInput(const std::vector<float>& f) { PopulateTensor(lhs_id_, f); }
   std::vector<float> GetOutput() { return ExtractVector<float>(output_id_); }
   std::vector<int> GetOutputShape() { return GetTensorShape(output_id_); }
@@ -510,6 +570,38 @@ TEST_P(HybridAsymmetricBatchMatMulOpTest, SimpleTestQuantizedInt8) {
   EXPECT_THAT(m.GetOutputShape(), ElementsAreArray({2, 3}));
 }
 
+// The weights are quantized to {1, 1, 2, 3, 4, 4, 5, 6, 6, 7} * 10 / 7.
+TEST_P(HybridAsymmetricBatchMatMulOpTest, SimpleTestQuantizedInt4) {
+  HybridBatchMatMulOpModel m(
+      /*units=*/3, /*batches=*/2,
+      /*lhs=*/{TensorType_FLOAT32, {2, 10}},
+      /*rhs=*/{TensorType_INT4, {10, 3}, 0, 0, 10.0 / 7.0, 0});
+
+  m.SetSignedWeights4Bit({
+      1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5,  5,  5,
+      6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 10,
+  });
+
+  m.SetInput({
+      11, 12, 13, 14, 15, 16, 17, 18,  -19, -20,  // batch 1, 0
+      11, 12, 13, 14, 15, 16, 17, -18, 19,  -20,  // batch 1, 1
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear(
+                                 {
+                                     220,
+                                     220,
+                                     220,
+                                     236.4,
+                                     236.4,
+                                     236.4,
+                                 },
+                                 /*max_abs_error=*/0.64f)));
+  EXPECT_THAT(m.GetOutputShape(), ElementsAreArray({2, 3}));
+}
+
 TEST_P(HybridAsymmetricBatchMatMulOpTest, MultipleNumBatchQuantizedInt8) {
   // need 4 scale factors
   HybridBatchMatMulOpModel m(
@@ -38,6 +38,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/optimized/multithreaded_conv.h"
 #endif
 #include "tensorflow/lite/kernels/internal/optimized/optimized_ops.h"
+#include "tensorflow/lite/kernels/internal/optimized/sparse_ops/fully_connected.h"
 #include "tensorflow/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/lite/kernels/internal/reference/conv.h"
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
@@ -117,6 +118,8 @@ struct OpData {
 
   bool supports_multithreaded_kernel = false;
   bool is_hybrid_per_channel = false;
+  // The filter is 1x4 block sparse, see IsSparseWeight1x4().
+  bool has_sparse_filter = false;
   bool compute_hybrid_row_sums = true;
 
   // Number of convolution groups.
@@ -373,6 +376,21 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
     }
   }
 
+  // Sparse filters are supported for float pointwise convolutions, which run
+  // on the block sparse kernel of fully_connected.
+  if (filter->sparsity != nullptr) {
+    TF_LITE_ENSURE_TYPES_EQ(context, input_type, kTfLiteFloat32);
+    TF_LITE_ENSURE_TYPES_EQ(context, filter->type, kTfLiteFloat32);
+    TF_LITE_ENSURE_EQ(context, data->groups, 1);
+    TF_LITE_ENSURE_EQ(context, params->stride_width, 1);
+    TF_LITE_ENSURE_EQ(context, params->stride_height, 1);
+    if (!optimized_ops::IsSparseWeight1x4(*filter->sparsity, *filter->dims)) {
+      TF_LITE_KERNEL_LOG(context, "Unsupported sparse filter format.");
+      return kTfLiteError;
+    }
+    data->has_sparse_filter = true;
+  }
+
   const TfLiteTensor* bias = nullptr;
 
   // TODO(ahentz): At this point the optimized versions require 'bias'. We can
@@ -439,7 +457,8 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
       (context->recommended_num_threads != 1) && !is_hybrid &&
       (params->dilation_width_factor == 1) &&
       (params->dilation_height_factor == 1) &&
-      (filter->allocation_type != kTfLiteArenaRw) && !IsDynamicTensor(filter);
+      (filter->allocation_type != kTfLiteArenaRw) && !IsDynamicTensor(filter) &&
+      !data->has_sparse_filter;
 
   int channels_in = filter->dims->data[3];
   int channels_out = filter->dims->data[0];
@@ -902,6 +921,30 @@ void EvalQuantizedPerChannel16x8(TfLiteContext* context, TfLiteNode* node,
   }
 }
 
+// Runs a pointwise convolution with a 1x4 block sparse filter as a
+// fully_connected over all the pixels of the input.
+void EvalSparseFloat(TfLiteContext* context, const TfLiteTensor* input,
+                     const TfLiteTensor* filter, const TfLiteTensor* bias,
+                     float output_activation_min, float output_activation_max,
+                     TfLiteTensor* output) {
+  const int input_depth = SizeOfDimension(filter, 3);
+  const int output_depth = SizeOfDimension(filter, 0);
+  const int num_pixels = NumElements(input) / input_depth;
+  FullyConnectedParams op_params;
+  op_params.float_activation_min = output_activation_min;
+  op_params.float_activation_max = output_activation_max;
+  TfLiteDimensionMetadata dim_metadata[3];
+  const TfLiteSparsity sparsity =
+      optimized_ops::GetSparseWeight1x4Matrix(*filter->sparsity, dim_metadata);
+  optimized_ops::FullyConnectedSparseWeight1x4(
+      sparsity, op_params, RuntimeShape({num_pixels, input_depth}),
+      GetTensorData<float>(input), RuntimeShape({output_depth, input_depth}),
+      GetTensorData<float>(filter), GetTensorShape(bias),
+      GetTensorData<float>(bias), RuntimeShape({num_pixels, output_depth}),
+      GetTensorData<float>(output),
+      CpuBackendContext::GetFromContext(context));
+}
+
 template <KernelType kernel_type>
 void EvalFloat(TfLiteContext* context, TfLiteNode* node,
                TfLiteConvParams* params, OpData* data,
@@ -911,6 +954,12 @@ void EvalFloat(TfLiteContext* context, TfLiteNode* node,
   float output_activation_min, output_activation_max;
   CalculateActivationRange(params->activation, &output_activation_min,
                            &output_activation_max);
+  // There is no separate reference kernel for sparse filters.
+  if (data->has_sparse_filter) {
+    EvalSparseFloat(context, input, filter, bias, output_activation_min,
+                    output_activation_max, output);
+    return;
+  }
   KernelType effective_kernel_type = kernel_type;
   // Fall back to the optimized path if multi-threaded conv is unsupported.
   if ((kernel_type == kMultithreadOptimized) &&
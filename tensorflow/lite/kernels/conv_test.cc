@@ -140,6 +140,44 @@ class ConvolutionOpModel : public BaseConvolutionOpModel<float> {
   std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
 };
 
+// A float convolution with a constant filter stored in a sparse format.
+class SparseConvolutionOpModel : public SingleOpModel {
+ public:
+  SparseConvolutionOpModel(TfLiteRegistration* registration,
+                           const TensorData& input, const TensorData& filter,
+                           const std::vector<float>& filter_data,
+                           int stride_width = 1, int stride_height = 1) {
+    input_ = AddInput(input);
+    filter_ = AddConstSparseInput(filter, filter_data);
+    bias_ = AddInput({TensorType_FLOAT32, {filter.shape[0]}});
+    output_ = AddOutput({TensorType_FLOAT32, {}});
+
+    SetBuiltinOp(BuiltinOperator_CONV_2D, BuiltinOptions_Conv2DOptions,
+                 CreateConv2DOptions(builder_, Padding_VALID, stride_width,
+                                     stride_height, ActivationFunctionType_NONE)
+                     .Union());
+    resolver_ = std::make_unique<SingleOpResolver>(BuiltinOperator_CONV_2D,
+                                                   registration);
+    BuildInterpreter({GetShape(input_), GetShape(filter_), GetShape(bias_)},
+                     /*num_threads=*/-1, /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/false,
+                     /*allocate_and_delegate=*/false);
+  }
+
+  TfLiteStatus AllocateTensors() { return interpreter_->AllocateTensors(); }
+  void SetBias(std::initializer_list<float> f) { PopulateTensor(bias_, f); }
+  void SetInput(std::initializer_list<float> data) {
+    PopulateTensor(input_, data);
+  }
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+
+ private:
+  int input_;
+  int filter_;
+  int bias_;
+  int output_;
+};
+
 const auto kKernelMap = new std::map<string, TfLiteRegistration*>({
     {"Reference", ops::builtin::Register_CONVOLUTION_REF()},
     {"GenericOptimized", ops::builtin::Register_CONVOLUTION_GENERIC_OPT()},
@@ -505,6 +543,50 @@ TEST_P(ConvolutionOpTest, DISABLED_PointwiseMultifilterFloat32) {
               }));
 }
 
+TEST_P(ConvolutionOpTest, PointwiseSparse1x4Float32) {
+  TensorData filter = {TensorType_FLOAT32, {3, 1, 1, 8}};
+  filter.traversal_order = {0, 1, 2, 3, 4};
+  filter.format = {kTfLiteDimDense, kTfLiteDimDense, kTfLiteDimDense,
+                   kTfLiteDimSparseCSR};
+  filter.block_map = {3};
+  filter.block_size = {4};
+  SparseConvolutionOpModel m(GetRegistration(),
+                             {TensorType_FLOAT32, {1, 1, 2, 8}}, filter,
+                             {
+                                 1, 2, 3, 4, 0, 0, 0, 0,   // first filter
+                                 0, 0, 0, 0, 0, 0, 0, 0,   // second filter
+                                 0, 0, 0, 0, 1, -1, 1, -1  // third filter
+                             });
+  ASSERT_EQ(m.AllocateTensors(), kTfLiteOk);
+
+  m.SetInput({
+      1, 1, 1, 1, 1, 2, 3, 4,  // column = 1
+      1, 2, 3, 4, 1, 1, 1, 1,  // column = 2
+  });
+  m.SetBias({1, 2, 3});
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray({
+                                 11, 2, 1,  // column = 1
+                                 31, 2, 3,  // column = 2
+                             }));
+}
+
+TEST_P(ConvolutionOpTest, SparseFilterWithStrideNotSupported) {
+  TensorData filter = {TensorType_FLOAT32, {1, 1, 1, 4}};
+  filter.traversal_order = {0, 1, 2, 3, 4};
+  filter.format = {kTfLiteDimDense, kTfLiteDimDense, kTfLiteDimDense,
+                   kTfLiteDimSparseCSR};
+  filter.block_map = {3};
+  filter.block_size = {4};
+  SparseConvolutionOpModel m(GetRegistration(),
+                             {TensorType_FLOAT32, {1, 2, 2, 4}}, filter,
+                             {1, 2, 3, 4}, /*stride_width=*/2,
+                             /*stride_height=*/2);
+  EXPECT_NE(m.AllocateTensors(), kTfLiteOk);
+}
+
 TEST_P(ConvolutionOpTest, SimpleTestFloat32WithAnisotropicStrides) {
   ConvolutionOpModel m(GetRegistration(), {TensorType_FLOAT32, {1, 3, 6, 1}},
                        {TensorType_FLOAT32, {1, 2, 2, 1}},
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 
 #include "pthreadpool.h"  // from @pthreadpool
 
@@ -110,6 +111,13 @@ CpuBackendContext* CpuBackendContext::GetFromContext(TfLiteContext* context) {
         "interpreter initialization.");
   }
 
+  if (external_context->pool() != nullptr) {
+    // The lease is returned to the pool by the subgraph once it is done
+    // running kernels.
+    return static_cast<CpuBackendContext*>(
+        external_context->AcquireFromPool());
+  }
+
   auto* cpu_backend_context = static_cast<CpuBackendContext*>(
       external_context->internal_backend_context());
   if (cpu_backend_context == nullptr) {
@@ -168,6 +176,46 @@ bool CpuBackendContext::PreferGemmlowpOnX86() {
   return use_gemmlowp_on_x86 || !RuyHasAvxOrAbove();
 }
 
+CpuBackendContextPool::CpuBackendContextPool(int num_contexts, int num_threads)
+    : num_threads_(num_threads), contexts_(num_contexts > 0 ? num_contexts : 1) {
+  for (int i = static_cast<int>(contexts_.size()) - 1; i >= 0; --i) {
+    free_contexts_.push_back(i);
+  }
+}
+
+TfLiteInternalBackendContext* CpuBackendContextPool::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const uint64_t ticket = next_ticket_++;
+  context_released_.wait(lock, [this, ticket] {
+    return ticket == now_serving_ && !free_contexts_.empty();
+  });
+  ++now_serving_;
+  const int index = free_contexts_.back();
+  free_contexts_.pop_back();
+  std::unique_ptr<CpuBackendContext>& context = contexts_[index];
+  if (context == nullptr) {
+    context = std::make_unique<CpuBackendContext>();
+    context->SetMaxNumThreads(num_threads_);
+  }
+  lock.unlock();
+  // Let the next caller in line take a remaining context, if any.
+  context_released_.notify_all();
+  return context.get();
+}
+
+void CpuBackendContextPool::Release(TfLiteInternalBackendContext* context) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < num_contexts(); ++i) {
+      if (contexts_[i].get() == context) {
+        free_contexts_.push_back(i);
+        break;
+      }
+    }
+  }
+  context_released_.notify_all();
+}
+
 bool CpuBackendContext::RuyHasAvxOrAbove() {
   // TODO(b/183178387): Use a proper query to detect AVX/optimized paths.
 #if RUY_PLATFORM_X86_ENHANCEMENTS
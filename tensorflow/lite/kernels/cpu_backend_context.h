@@ -21,7 +21,11 @@ limitations under the License.
 #define TFLITE_X86_PLATFORM
 #endif
 
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
 
 #include "public/gemmlowp.h"
 #include "pthreadpool.h"  // from @pthreadpool
@@ -126,6 +130,44 @@ class CpuBackendContext final : public TfLiteInternalBackendContext {
   CpuBackendContext(const CpuBackendContext&) = delete;
 };
 
+// Process-wide pool of CpuBackendContexts for interpreters that are invoked
+// concurrently, see TfLiteInternalBackendContextPool. `num_contexts` bounds the
+// number of interpreters running kernels at the same time, and each context
+// uses up to `num_threads` threads, so the process uses at most
+// num_contexts * num_threads threads for TFLite kernels and as many scratch
+// arenas as num_contexts, however many interpreters share the pool.
+//
+// Interpreters waiting for a context are served first come, first served.
+//
+// WARNING: This is an experimental API and subject to change.
+class CpuBackendContextPool final : public TfLiteInternalBackendContextPool {
+ public:
+  CpuBackendContextPool(int num_contexts, int num_threads);
+
+  TfLiteInternalBackendContext* Acquire() override;
+  void Release(TfLiteInternalBackendContext* context) override;
+
+  int num_contexts() const { return static_cast<int>(contexts_.size()); }
+  int num_threads() const { return num_threads_; }
+
+ private:
+  const int num_threads_;
+  // Contexts are created on first use.
+  std::vector<std::unique_ptr<CpuBackendContext>> contexts_;
+
+  std::mutex mutex_;
+  std::condition_variable context_released_;
+  // Indices into contexts_ of the contexts that are not leased.
+  std::vector<int> free_contexts_;
+  // Tickets implementing the first come, first served order: a caller takes
+  // the next ticket, and gets a context once all earlier tickets are served.
+  uint64_t next_ticket_ = 0;
+  uint64_t now_serving_ = 0;
+
+  CpuBackendContextPool(const CpuBackendContextPool&) = delete;
+  CpuBackendContextPool& operator=(const CpuBackendContextPool&) = delete;
+};
+
 }  // namespace tflite
 
 #endif  // TENSORFLOW_LITE_KERNELS_CPU_BACKEND_CONTEXT_H_
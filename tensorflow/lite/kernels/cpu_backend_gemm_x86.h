@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/cpu_backend_gemm_gemmlowp.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_ruy.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_x86_int8.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 
 namespace tflite {
@@ -91,11 +92,27 @@ struct GemmImplX86<std::int8_t, std::int8_t, std::int32_t, DstScalar,
     : detail::GemmImplUsingRuy<std::int8_t, std::int8_t, std::int32_t,
                                DstScalar, quantization_flavor> {};
 
+// The int8 fully_connected and conv Gemm uses the AVX-512 VNNI or AMX
+// kernels when the CPU has them, otherwise ruy.
 template <QuantizationFlavor quantization_flavor>
 struct GemmImplX86<std::int8_t, std::int8_t, std::int32_t, std::int8_t,
-                   quantization_flavor>
-    : detail::GemmImplUsingRuy<std::int8_t, std::int8_t, std::int32_t,
-                               std::int8_t, quantization_flavor> {};
+                   quantization_flavor> {
+  static void Run(
+      const MatrixParams<std::int8_t>& lhs_params, const std::int8_t* lhs_data,
+      const MatrixParams<std::int8_t>& rhs_params, const std::int8_t* rhs_data,
+      const MatrixParams<std::int8_t>& dst_params, std::int8_t* dst_data,
+      const GemmParams<std::int32_t, std::int8_t, quantization_flavor>& params,
+      CpuBackendContext* context) {
+    if (X86Int8Gemm(lhs_params, lhs_data, rhs_params, rhs_data, dst_params,
+                    dst_data, params, context)) {
+      return;
+    }
+    GemmImplUsingRuy<std::int8_t, std::int8_t, std::int32_t, std::int8_t,
+                     quantization_flavor>::Run(lhs_params, lhs_data, rhs_params,
+                                               rhs_data, dst_params, dst_data,
+                                               params, context);
+  }
+};
 #endif  // not GEMMLOWP_NEON
 }  // namespace detail
 }  // namespace cpu_backend_gemm
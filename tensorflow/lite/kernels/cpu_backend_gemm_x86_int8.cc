@@ -0,0 +1,651 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/kernels/cpu_backend_gemm_x86_int8.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ruy/profiler/instrumentation.h"  // from @ruy
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/kernels/internal/optimized/cpu_check.h"
+
+// The kernels are compiled with function-level target attributes, so that the
+// rest of the build doesn't need AVX-512 or AMX flags. AMX intrinsics need
+// GCC 11 or Clang 12.
+#if defined(__x86_64__) && !defined(_MSC_VER) &&   \
+    ((defined(__clang__) && __clang_major__ >= 12) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 11))
+#define TFLITE_X86_INT8_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace tflite {
+namespace cpu_backend_gemm {
+namespace detail {
+namespace {
+
+#ifdef TFLITE_X86_INT8_KERNELS
+
+#define TFLITE_AVX512_VNNI_TARGET \
+  __attribute__((target("avx512f,avx512bw,avx512vnni")))
+#define TFLITE_AMX_TARGET \
+  __attribute__((target("avx512f,avx512bw,avx512vnni,amx-tile,amx-int8")))
+
+// Stores the destination value at (row, col), given the raw sum of products
+// sum(lhs * rhs) for it and the sum of the lhs row. The zero points are
+// applied as
+//   sum((lhs - lhs_zp) * (rhs - rhs_zp)) = sum(lhs * rhs) - rhs_zp * row_sum
+//       - lhs_zp * col_sum + depth * lhs_zp * rhs_zp
+// and the result is requantized like in the reference kernels.
+inline void StoreResult(const X86Int8GemmArgs& args, int row, int col,
+                        std::int32_t raw, std::int32_t row_sum,
+                        const std::int32_t* col_sums) {
+  std::int32_t acc = raw - args.rhs_zero_point * row_sum;
+  if (args.lhs_zero_point != 0) {
+    acc += args.lhs_zero_point *
+           (args.depth * args.rhs_zero_point - col_sums[col]);
+  }
+  if (args.bias) {
+    acc += args.bias[row];
+  }
+  if (args.multiplier_fixedpoint_perchannel) {
+    acc = MultiplyByQuantizedMultiplier(
+        acc, args.multiplier_fixedpoint_perchannel[row],
+        args.multiplier_exponent_perchannel[row]);
+  } else {
+    acc = MultiplyByQuantizedMultiplier(acc, args.multiplier_fixedpoint,
+                                        args.multiplier_exponent);
+  }
+  acc += args.dst_zero_point;
+  acc = std::max(acc, args.clamp_min);
+  acc = std::min(acc, args.clamp_max);
+  args.dst[col * args.rows + row] = static_cast<std::int8_t>(acc);
+}
+
+// Sums of the columns of rhs, only needed for a nonzero lhs zero point.
+std::vector<std::int32_t> ComputeColSums(const X86Int8GemmArgs& args) {
+  std::vector<std::int32_t> col_sums(args.cols, 0);
+  for (int col = 0; col < args.cols; ++col) {
+    const std::int8_t* rhs = args.rhs + col * args.depth;
+    for (int d = 0; d < args.depth; ++d) {
+      col_sums[col] += rhs[d];
+    }
+  }
+  return col_sums;
+}
+
+// Vector versions of the requantization in StoreResult, on 16 accumulators
+// with their own multipliers and shifts.
+
+#if TFLITE_SINGLE_ROUNDING
+TFLITE_AVX512_VNNI_TARGET inline __m512i MultiplyByQuantizedMultiplier16(
+    __m512i x, __m512i quantized_multiplier, __m512i shift) {
+  const __m512i total_shift = _mm512_sub_epi32(_mm512_set1_epi32(31), shift);
+  const __m512i low_mask = _mm512_set1_epi64(0xffffffff);
+  const __m512i one = _mm512_set1_epi64(1);
+  // Even lanes are the low halves of 64-bit lanes, odd lanes the high halves.
+  const __m512i even_shift = _mm512_and_si512(total_shift, low_mask);
+  const __m512i odd_shift = _mm512_srli_epi64(total_shift, 32);
+  const __m512i even = _mm512_srav_epi64(
+      _mm512_add_epi64(_mm512_mul_epi32(x, quantized_multiplier),
+                       _mm512_sllv_epi64(one, _mm512_sub_epi64(even_shift,
+                                                               one))),
+      even_shift);
+  const __m512i odd = _mm512_srav_epi64(
+      _mm512_add_epi64(
+          _mm512_mul_epi32(_mm512_srli_epi64(x, 32),
+                           _mm512_srli_epi64(quantized_multiplier, 32)),
+          _mm512_sllv_epi64(one, _mm512_sub_epi64(odd_shift, one))),
+      odd_shift);
+  return _mm512_mask_blend_epi32(0xaaaa, even, _mm512_slli_epi64(odd, 32));
+}
+#else
+// SaturatingRoundingDoublingHighMul on 64-bit products, which can't saturate
+// as multipliers are nonnegative.
+TFLITE_AVX512_VNNI_TARGET inline __m512i RoundingDoublingHighMul(
+    __m512i product) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __mmask8 negative = _mm512_cmplt_epi64_mask(product, zero);
+  const __m512i nudge =
+      _mm512_mask_blend_epi64(negative, _mm512_set1_epi64(1 << 30),
+                              _mm512_set1_epi64(1 - (1 << 30)));
+  const __m512i sum = _mm512_add_epi64(product, nudge);
+  // The division by 2^31 rounds toward zero.
+  const __mmask8 round_up =
+      _mm512_cmplt_epi64_mask(sum, zero) &
+      _mm512_test_epi64_mask(sum, _mm512_set1_epi64(0x7fffffff));
+  const __m512i quotient = _mm512_srai_epi64(sum, 31);
+  return _mm512_mask_add_epi64(quotient, round_up, quotient,
+                               _mm512_set1_epi64(1));
+}
+
+TFLITE_AVX512_VNNI_TARGET inline __m512i MultiplyByQuantizedMultiplier16(
+    __m512i x, __m512i quantized_multiplier, __m512i shift) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i left_shift = _mm512_max_epi32(shift, zero);
+  const __m512i right_shift = _mm512_max_epi32(_mm512_sub_epi32(zero, shift),
+                                               zero);
+  x = _mm512_sllv_epi32(x, left_shift);
+  // Even lanes are the low halves of 64-bit lanes, odd lanes the high halves.
+  const __m512i even =
+      RoundingDoublingHighMul(_mm512_mul_epi32(x, quantized_multiplier));
+  const __m512i odd = RoundingDoublingHighMul(
+      _mm512_mul_epi32(_mm512_srli_epi64(x, 32),
+                       _mm512_srli_epi64(quantized_multiplier, 32)));
+  x = _mm512_mask_blend_epi32(0xaaaa, even, _mm512_slli_epi64(odd, 32));
+  // RoundingDivideByPOT.
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i mask = _mm512_sub_epi32(_mm512_sllv_epi32(one, right_shift),
+                                        one);
+  const __m512i remainder = _mm512_and_si512(x, mask);
+  const __m512i half = _mm512_srai_epi32(mask, 1);
+  const __m512i threshold = _mm512_mask_add_epi32(
+      half, _mm512_cmplt_epi32_mask(x, zero), half, one);
+  const __mmask16 round_up = _mm512_cmpgt_epi32_mask(remainder, threshold);
+  x = _mm512_srav_epi32(x, right_shift);
+  return _mm512_mask_add_epi32(x, round_up, x, one);
+}
+#endif  // TFLITE_SINGLE_ROUNDING
+
+// Requantizes accumulators that already include the zero point corrections
+// and the bias.
+TFLITE_AVX512_VNNI_TARGET inline __m128i Requantize16(
+    const X86Int8GemmArgs& args, __m512i acc, __m512i quantized_multiplier,
+    __m512i shift) {
+  acc = MultiplyByQuantizedMultiplier16(acc, quantized_multiplier, shift);
+  acc = _mm512_add_epi32(acc, _mm512_set1_epi32(args.dst_zero_point));
+  acc = _mm512_max_epi32(acc, _mm512_set1_epi32(args.clamp_min));
+  acc = _mm512_min_epi32(acc, _mm512_set1_epi32(args.clamp_max));
+  return _mm512_cvtepi32_epi8(acc);
+}
+
+// AVX-512 VNNI kernel.
+//
+// vpdpbusd multiplies unsigned bytes by signed bytes, so the rhs values are
+// offset by 128 (flipping their sign bit) and 128 * row_sum is subtracted from
+// the result. The depth is processed 64 values at a time, with masked loads
+// for the remainder.
+
+constexpr int kVnniKernelRows = 4;
+constexpr int kVnniKernelCols = 4;
+
+TFLITE_AVX512_VNNI_TARGET inline __mmask64 VnniDepthMask(int remaining) {
+  return remaining >= 64 ? ~__mmask64{0}
+                         : (__mmask64{1} << remaining) - 1;
+}
+
+TFLITE_AVX512_VNNI_TARGET void VnniRowSums(const X86Int8GemmArgs& args,
+                                           int row_start, int row_end,
+                                           std::int32_t* row_sums) {
+  const __m512i ones = _mm512_set1_epi8(1);
+  for (int row = row_start; row < row_end; ++row) {
+    const std::int8_t* lhs = args.lhs + row * args.depth;
+    __m512i acc = _mm512_setzero_si512();
+    for (int d = 0; d < args.depth; d += 64) {
+      const __mmask64 mask = VnniDepthMask(args.depth - d);
+      acc = _mm512_dpbusd_epi32(acc, ones,
+                                _mm512_maskz_loadu_epi8(mask, lhs + d));
+    }
+    row_sums[row - row_start] = _mm512_reduce_add_epi32(acc);
+  }
+}
+
+// Returns the vector whose lane i is the sum of the lanes of v[i].
+TFLITE_AVX512_VNNI_TARGET inline __m512i ReduceAdd16(const __m512i* v) {
+  // Each step halves the number of vectors by adding pairs of interleaved
+  // halves, first within 128-bit blocks, then across them.
+  __m512i x[8];
+  for (int i = 0; i < 8; ++i) {
+    x[i] = _mm512_add_epi32(_mm512_unpacklo_epi32(v[2 * i], v[2 * i + 1]),
+                            _mm512_unpackhi_epi32(v[2 * i], v[2 * i + 1]));
+  }
+  __m512i y[4];
+  for (int i = 0; i < 4; ++i) {
+    y[i] = _mm512_add_epi32(_mm512_unpacklo_epi64(x[2 * i], x[2 * i + 1]),
+                            _mm512_unpackhi_epi64(x[2 * i], x[2 * i + 1]));
+  }
+  __m512i z[2];
+  for (int i = 0; i < 2; ++i) {
+    z[i] = _mm512_add_epi32(
+        _mm512_shuffle_i32x4(y[2 * i], y[2 * i + 1], _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm512_shuffle_i32x4(y[2 * i], y[2 * i + 1], _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  return _mm512_add_epi32(
+      _mm512_shuffle_i32x4(z[0], z[1], _MM_SHUFFLE(2, 0, 2, 0)),
+      _mm512_shuffle_i32x4(z[0], z[1], _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+// Returns the 4 values at `data` repeated in each 128-bit block.
+TFLITE_AVX512_VNNI_TARGET inline __m512i Broadcast4(const void* data) {
+  return _mm512_broadcast_i32x4(
+      _mm_loadu_si128(static_cast<const __m128i*>(data)));
+}
+
+// Vector version of StoreResult for the 4x4 block of dst at (row, col), with
+// the value for (row + r, col + c) in lane 4 * c + r of `raw_u8`, the sums of
+// products with the offset rhs.
+TFLITE_AVX512_VNNI_TARGET void StoreResults4x4(const X86Int8GemmArgs& args,
+                                               int row, int col,
+                                               __m512i raw_u8,
+                                               const std::int32_t* row_sums,
+                                               const std::int32_t* col_sums) {
+  const __m512i row_sum = Broadcast4(row_sums);
+  __m512i acc = _mm512_sub_epi32(raw_u8, _mm512_slli_epi32(row_sum, 7));
+  acc = _mm512_sub_epi32(
+      acc, _mm512_mullo_epi32(_mm512_set1_epi32(args.rhs_zero_point),
+                              row_sum));
+  if (args.lhs_zero_point != 0) {
+    const __m512i col_sum = _mm512_permutexvar_epi32(
+        _mm512_set_epi32(3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0),
+        _mm512_castsi128_si512(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(col_sums + col))));
+    acc = _mm512_add_epi32(
+        acc, _mm512_mullo_epi32(
+                 _mm512_set1_epi32(args.lhs_zero_point),
+                 _mm512_sub_epi32(
+                     _mm512_set1_epi32(args.depth * args.rhs_zero_point),
+                     col_sum)));
+  }
+  if (args.bias) {
+    acc = _mm512_add_epi32(acc, Broadcast4(args.bias + row));
+  }
+  __m512i multiplier, shift;
+  if (args.multiplier_fixedpoint_perchannel) {
+    multiplier = Broadcast4(args.multiplier_fixedpoint_perchannel + row);
+    shift = Broadcast4(args.multiplier_exponent_perchannel + row);
+  } else {
+    multiplier = _mm512_set1_epi32(args.multiplier_fixedpoint);
+    shift = _mm512_set1_epi32(args.multiplier_exponent);
+  }
+  alignas(16) std::int8_t values[16];
+  _mm_store_si128(reinterpret_cast<__m128i*>(values),
+                  Requantize16(args, acc, multiplier, shift));
+  for (int c = 0; c < 4; ++c) {
+    std::memcpy(args.dst + (col + c) * args.rows + row, values + 4 * c, 4);
+  }
+}
+
+// Computes a kRows x kCols block of dst starting at (row, col). `row_sums`
+// points to the sum of lhs row `row`.
+template <int kRows, int kCols>
+TFLITE_AVX512_VNNI_TARGET void VnniKernel(const X86Int8GemmArgs& args,
+                                          const std::int32_t* row_sums,
+                                          const std::int32_t* col_sums,
+                                          int row, int col) {
+  const int depth = args.depth;
+  const std::int8_t* lhs = args.lhs + row * depth;
+  const std::int8_t* rhs = args.rhs + col * depth;
+  const __m512i sign_flip = _mm512_set1_epi8(static_cast<char>(0x80));
+
+  __m512i acc[kRows][kCols];
+  for (int r = 0; r < kRows; ++r) {
+    for (int c = 0; c < kCols; ++c) {
+      acc[r][c] = _mm512_setzero_si512();
+    }
+  }
+  for (int d = 0; d < depth; d += 64) {
+    const __mmask64 mask = VnniDepthMask(depth - d);
+    __m512i rhs_u8[kCols];
+    for (int c = 0; c < kCols; ++c) {
+      rhs_u8[c] = _mm512_xor_si512(
+          _mm512_maskz_loadu_epi8(mask, rhs + c * depth + d), sign_flip);
+    }
+    for (int r = 0; r < kRows; ++r) {
+      const __m512i lhs_s8 = _mm512_maskz_loadu_epi8(mask, lhs + r * depth + d);
+      for (int c = 0; c < kCols; ++c) {
+        acc[r][c] = _mm512_dpbusd_epi32(acc[r][c], rhs_u8[c], lhs_s8);
+      }
+    }
+  }
+  if (kRows == kVnniKernelRows && kCols == kVnniKernelCols) {
+    // Full blocks are reduced and requantized as one vector, with the value
+    // for (row + r, col + c) in lane 4 * c + r.
+    __m512i sums[16];
+    for (int r = 0; r < kRows; ++r) {
+      for (int c = 0; c < kCols; ++c) {
+        sums[4 * c + r] = acc[r][c];
+      }
+    }
+    StoreResults4x4(args, row, col, ReduceAdd16(sums), row_sums, col_sums);
+    return;
+  }
+  for (int r = 0; r < kRows; ++r) {
+    for (int c = 0; c < kCols; ++c) {
+      const std::int32_t raw =
+          _mm512_reduce_add_epi32(acc[r][c]) - 128 * row_sums[r];
+      StoreResult(args, row + r, col + c, raw, row_sums[r], col_sums);
+    }
+  }
+}
+
+using VnniKernelFn = void (*)(const X86Int8GemmArgs&, const std::int32_t*,
+                              const std::int32_t*, int, int);
+
+// Kernels indexed by [rows - 1][cols - 1], for the remainders of the matrices.
+constexpr VnniKernelFn kVnniKernels[kVnniKernelRows][kVnniKernelCols] = {
+    {&VnniKernel<1, 1>, &VnniKernel<1, 2>, &VnniKernel<1, 3>,
+     &VnniKernel<1, 4>},
+    {&VnniKernel<2, 1>, &VnniKernel<2, 2>, &VnniKernel<2, 3>,
+     &VnniKernel<2, 4>},
+    {&VnniKernel<3, 1>, &VnniKernel<3, 2>, &VnniKernel<3, 3>,
+     &VnniKernel<3, 4>},
+    {&VnniKernel<4, 1>, &VnniKernel<4, 2>, &VnniKernel<4, 3>,
+     &VnniKernel<4, 4>},
+};
+
+void RunVnniRows(const X86Int8GemmArgs& args, const std::int32_t* col_sums,
+                 int row_start, int row_end) {
+  std::vector<std::int32_t> row_sums(row_end - row_start);
+  VnniRowSums(args, row_start, row_end, row_sums.data());
+  for (int row = row_start; row < row_end; row += kVnniKernelRows) {
+    const int rows = std::min(kVnniKernelRows, row_end - row);
+    for (int col = 0; col < args.cols; col += kVnniKernelCols) {
+      const int cols = std::min(kVnniKernelCols, args.cols - col);
+      kVnniKernels[rows - 1][cols - 1](
+          args, row_sums.data() + (row - row_start), col_sums, row, col);
+    }
+  }
+}
+
+// AMX kernel.
+//
+// tdpbssd multiplies a 16x64 tile of int8 lhs values by a 64x16 block of int8
+// rhs values stored as a 16x64 tile, where tile row k holds depths 4k..4k+3 of
+// each of the 16 columns. The rhs is packed into such tiles once per Gemm,
+// while lhs tiles are loaded in place, except at the bottom and right edges of
+// lhs where they are copied to a zero padded buffer. Two 16x16 int32
+// accumulator tiles are computed at a time, sharing the lhs tile.
+//
+// Accumulator tile rows correspond to lhs rows, hence to a single multiplier,
+// so they are requantized with AVX-512 which all AMX CPUs have.
+
+constexpr int kAmxTileRows = 16;
+constexpr int kAmxTileDepth = 64;
+constexpr int kAmxTileBytes = kAmxTileRows * kAmxTileDepth;
+
+// Layout of the operand of ldtilecfg for palette 1.
+struct AmxTileConfig {
+  std::uint8_t palette_id;
+  std::uint8_t start_row;
+  std::uint8_t reserved[14];
+  std::uint16_t colsb[16];
+  std::uint8_t rows[16];
+};
+
+int CeilDiv(int a, int b) { return (a + b - 1) / b; }
+
+// Packs rhs into tiles, indexed by [col / 16][depth / 64].
+std::vector<std::int8_t> PackAmxRhs(const X86Int8GemmArgs& args) {
+  const int depth_tiles = CeilDiv(args.depth, kAmxTileDepth);
+  const int col_tiles = CeilDiv(args.cols, kAmxTileRows);
+  std::vector<std::int8_t> packed(col_tiles * depth_tiles * kAmxTileBytes, 0);
+  for (int col = 0; col < args.cols; ++col) {
+    const std::int8_t* rhs = args.rhs + col * args.depth;
+    std::int8_t* packed_col = packed.data() +
+                              (col / kAmxTileRows) * depth_tiles *
+                                  kAmxTileBytes +
+                              (col % kAmxTileRows) * 4;
+    // Groups of 4 depths are contiguous in both layouts, and consecutive
+    // groups are one tile row apart, including across tiles.
+    for (int d = 0; d < args.depth; d += 4) {
+      std::memcpy(packed_col + d * kAmxTileRows, rhs + d,
+                  std::min(4, args.depth - d));
+    }
+  }
+  return packed;
+}
+
+// Copies the part of lhs rows [row, row + rows) and depths
+// [depth, depth + 64) that exists into a zero padded tile.
+void PackAmxLhsTile(const X86Int8GemmArgs& args, int row, int rows, int depth,
+                    std::int8_t* tile) {
+  std::memset(tile, 0, kAmxTileBytes);
+  const int size = std::min(kAmxTileDepth, args.depth - depth);
+  for (int r = 0; r < rows; ++r) {
+    std::memcpy(tile + r * kAmxTileDepth,
+                args.lhs + (row + r) * args.depth + depth, size);
+  }
+}
+
+// Vector version of StoreResult for the `cols` (up to 16) destination values
+// of `row` starting at `col`.
+TFLITE_AVX512_VNNI_TARGET void StoreResults16(const X86Int8GemmArgs& args,
+                                              int row, int col, int cols,
+                                              const std::int32_t* raw,
+                                              std::int32_t row_sum,
+                                              const std::int32_t* col_sums) {
+  const __mmask16 col_mask = (1u << cols) - 1;
+  __m512i acc = _mm512_sub_epi32(_mm512_loadu_si512(raw),
+                                 _mm512_set1_epi32(args.rhs_zero_point *
+                                                   row_sum));
+  if (args.lhs_zero_point != 0) {
+    const __m512i col_sum = _mm512_maskz_loadu_epi32(col_mask, col_sums + col);
+    acc = _mm512_add_epi32(
+        acc, _mm512_mullo_epi32(
+                 _mm512_set1_epi32(args.lhs_zero_point),
+                 _mm512_sub_epi32(
+                     _mm512_set1_epi32(args.depth * args.rhs_zero_point),
+                     col_sum)));
+  }
+  if (args.bias) {
+    acc = _mm512_add_epi32(acc, _mm512_set1_epi32(args.bias[row]));
+  }
+  const bool per_channel = args.multiplier_fixedpoint_perchannel;
+  const __m512i multiplier = _mm512_set1_epi32(
+      per_channel ? args.multiplier_fixedpoint_perchannel[row]
+                  : args.multiplier_fixedpoint);
+  const __m512i shift = _mm512_set1_epi32(
+      per_channel ? args.multiplier_exponent_perchannel[row]
+                  : args.multiplier_exponent);
+  alignas(16) std::int8_t values[16];
+  _mm_store_si128(reinterpret_cast<__m128i*>(values),
+                  Requantize16(args, acc, multiplier, shift));
+  std::int8_t* dst = args.dst + col * args.rows + row;
+  for (int c = 0; c < cols; ++c) {
+    dst[c * args.rows] = values[c];
+  }
+}
+
+TFLITE_AMX_TARGET void RunAmxRows(const X86Int8GemmArgs& args,
+                                  const std::int8_t* packed_rhs,
+                                  const std::int32_t* col_sums, int row_start,
+                                  int row_end) {
+  const int depth_tiles = CeilDiv(args.depth, kAmxTileDepth);
+  const int full_depth_tiles = args.depth / kAmxTileDepth;
+  const int col_tiles = CeilDiv(args.cols, kAmxTileRows);
+  std::vector<std::int8_t> packed_lhs(depth_tiles * kAmxTileBytes);
+  std::vector<std::int32_t> row_sums(row_end - row_start);
+  VnniRowSums(args, row_start, row_end, row_sums.data());
+  alignas(64) std::int32_t result[2][kAmxTileRows][kAmxTileRows];
+
+  // Tiles 0 and 1 are accumulators, 2 is lhs, 3 and 4 are rhs.
+  AmxTileConfig config = {};
+  config.palette_id = 1;
+  for (int i = 0; i < 5; ++i) {
+    config.rows[i] = kAmxTileRows;
+    config.colsb[i] = kAmxTileDepth;
+  }
+  _tile_loadconfig(&config);
+
+  for (int row = row_start; row < row_end; row += kAmxTileRows) {
+    const int rows = std::min(kAmxTileRows, row_end - row);
+    // Depth tiles before this one are loaded in place.
+    const int first_packed_tile =
+        rows == kAmxTileRows ? full_depth_tiles : 0;
+    for (int depth_tile = first_packed_tile; depth_tile < depth_tiles;
+         ++depth_tile) {
+      PackAmxLhsTile(args, row, rows, depth_tile * kAmxTileDepth,
+                     packed_lhs.data() + depth_tile * kAmxTileBytes);
+    }
+    const std::int8_t* lhs = args.lhs + row * args.depth;
+
+    for (int col_tile = 0; col_tile < col_tiles; col_tile += 2) {
+      const bool has_second_tile = col_tile + 1 < col_tiles;
+      const std::int8_t* rhs_tiles =
+          packed_rhs + col_tile * depth_tiles * kAmxTileBytes;
+      _tile_zero(0);
+      _tile_zero(1);
+      for (int depth_tile = 0; depth_tile < depth_tiles; ++depth_tile) {
+        if (depth_tile < first_packed_tile) {
+          _tile_loadd(2, lhs + depth_tile * kAmxTileDepth, args.depth);
+        } else {
+          _tile_loadd(2, packed_lhs.data() + depth_tile * kAmxTileBytes,
+                      kAmxTileDepth);
+        }
+        _tile_loadd(3, rhs_tiles + depth_tile * kAmxTileBytes, kAmxTileDepth);
+        _tile_dpbssd(0, 2, 3);
+        if (has_second_tile) {
+          _tile_loadd(
+              4, rhs_tiles + (depth_tiles + depth_tile) * kAmxTileBytes,
+              kAmxTileDepth);
+          _tile_dpbssd(1, 2, 4);
+        }
+      }
+      _tile_stored(0, result[0], kAmxTileDepth);
+      if (has_second_tile) {
+        _tile_stored(1, result[1], kAmxTileDepth);
+      }
+      for (int t = 0; t < (has_second_tile ? 2 : 1); ++t) {
+        const int col = (col_tile + t) * kAmxTileRows;
+        const int cols = std::min(kAmxTileRows, args.cols - col);
+        for (int r = 0; r < rows; ++r) {
+          StoreResults16(args, row + r, col, cols, result[t][r],
+                         row_sums[row - row_start + r], col_sums);
+        }
+      }
+    }
+  }
+  _tile_release();
+}
+
+#endif  // TFLITE_X86_INT8_KERNELS
+
+class X86Int8GemmTask : public cpu_backend_threadpool::Task {
+ public:
+  X86Int8GemmTask(X86Int8Kernel kernel, const X86Int8GemmArgs& args,
+                  const std::int8_t* packed_rhs, const std::int32_t* col_sums,
+                  int row_start, int row_end)
+      : kernel_(kernel),
+        args_(args),
+        packed_rhs_(packed_rhs),
+        col_sums_(col_sums),
+        row_start_(row_start),
+        row_end_(row_end) {}
+
+  void Run() override {
+#ifdef TFLITE_X86_INT8_KERNELS
+    if (kernel_ == X86Int8Kernel::kAmx) {
+      RunAmxRows(args_, packed_rhs_, col_sums_, row_start_, row_end_);
+    } else {
+      RunVnniRows(args_, col_sums_, row_start_, row_end_);
+    }
+#endif  // TFLITE_X86_INT8_KERNELS
+  }
+
+ private:
+  X86Int8Kernel kernel_;
+  const X86Int8GemmArgs& args_;
+  const std::int8_t* packed_rhs_;
+  const std::int32_t* col_sums_;
+  int row_start_;
+  int row_end_;
+};
+
+}  // namespace
+
+bool IsX86Int8KernelSupported(X86Int8Kernel kernel) {
+#ifdef TFLITE_X86_INT8_KERNELS
+  switch (kernel) {
+    case X86Int8Kernel::kNone:
+      return true;
+    case X86Int8Kernel::kAvx512Vnni:
+      return DetectX86Avx512Vnni();
+    case X86Int8Kernel::kAmx:
+      // The AMX kernel also uses AVX-512 VNNI.
+      return DetectX86AmxInt8() && DetectX86Avx512Vnni();
+  }
+  return false;
+#else
+  return kernel == X86Int8Kernel::kNone;
+#endif  // TFLITE_X86_INT8_KERNELS
+}
+
+X86Int8Kernel SelectX86Int8Kernel(int rows, int depth, int cols) {
+  // AMX tiles need enough rows and columns to be filled, below that the
+  // packing overhead isn't amortized.
+  if (rows >= 16 && cols >= 16 &&
+      IsX86Int8KernelSupported(X86Int8Kernel::kAmx)) {
+    return X86Int8Kernel::kAmx;
+  }
+  if (IsX86Int8KernelSupported(X86Int8Kernel::kAvx512Vnni)) {
+    return X86Int8Kernel::kAvx512Vnni;
+  }
+  return X86Int8Kernel::kNone;
+}
+
+void RunX86Int8Gemm(X86Int8Kernel kernel, const X86Int8GemmArgs& args,
+                    CpuBackendContext* context) {
+  TFLITE_DCHECK(kernel != X86Int8Kernel::kNone);
+  TFLITE_DCHECK(IsX86Int8KernelSupported(kernel));
+#ifdef TFLITE_X86_INT8_KERNELS
+  ruy::profiler::ScopeLabel label(kernel == X86Int8Kernel::kAmx
+                                      ? "cpu_backend_gemm::Gemm: x86 AMX"
+                                      : "cpu_backend_gemm::Gemm: x86 VNNI");
+  std::vector<std::int32_t> col_sums;
+  if (args.lhs_zero_point != 0) {
+    col_sums = ComputeColSums(args);
+  }
+  std::vector<std::int8_t> packed_rhs;
+  int kernel_rows = kVnniKernelRows;
+  int thread_count;
+  if (kernel == X86Int8Kernel::kAmx) {
+    packed_rhs = PackAmxRhs(args);
+    kernel_rows = kAmxTileRows;
+    thread_count = LegacyHowManyThreads<kAmxTileRows>(
+        context->max_num_threads(), args.rows, args.cols, args.depth);
+  } else {
+    thread_count = LegacyHowManyThreads<kVnniKernelRows>(
+        context->max_num_threads(), args.rows, args.cols, args.depth);
+  }
+
+  if (thread_count == 1) {
+    X86Int8GemmTask(kernel, args, packed_rhs.data(), col_sums.data(), 0,
+                    args.rows)
+        .Run();
+    return;
+  }
+  std::vector<X86Int8GemmTask> tasks;
+  tasks.reserve(thread_count);
+  const int rows_per_thread =
+      CeilDiv(CeilDiv(args.rows, thread_count), kernel_rows) * kernel_rows;
+  for (int row_start = 0; row_start < args.rows;
+       row_start += rows_per_thread) {
+    const int row_end = std::min(args.rows, row_start + rows_per_thread);
+    tasks.emplace_back(kernel, args, packed_rhs.data(), col_sums.data(),
+                       row_start, row_end);
+  }
+  cpu_backend_threadpool::Execute(tasks.size(), tasks.data(), context);
+#endif  // TFLITE_X86_INT8_KERNELS
+}
+
+}  // namespace detail
+}  // namespace cpu_backend_gemm
+}  // namespace tflite
@@ -0,0 +1,120 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Int8 GEMM kernels for x86 server CPUs, using the AVX-512 VNNI (vpdpbusd) and
+// AMX (tdpbssd) instructions. They cover the int8 x int8 -> int8 Gemm behind
+// the quantized fully_connected and conv ops, with the same requantization as
+// the reference kernels, and are selected at run time based on the CPU.
+//
+// Like the rest of cpu_backend_gemm, only (row-major lhs) * (col-major rhs) =
+// (col-major dst) is handled.
+
+#ifndef TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_X86_INT8_H_
+#define TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_X86_INT8_H_
+
+#include <cstdint>
+
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+
+namespace tflite {
+namespace cpu_backend_gemm {
+namespace detail {
+
+enum class X86Int8Kernel {
+  kNone,
+  kAvx512Vnni,
+  kAmx,
+};
+
+// Returns true if the kernel was compiled in and the CPU supports it.
+bool IsX86Int8KernelSupported(X86Int8Kernel kernel);
+
+// Returns the kernel to use for a Gemm of the given shape, or kNone if the
+// CPU supports none of them.
+X86Int8Kernel SelectX86Int8Kernel(int rows, int depth, int cols);
+
+// Type-erased arguments of an int8 x int8 -> int8 Gemm. `lhs` is a row-major
+// rows x depth matrix, `rhs` a col-major depth x cols matrix and `dst` a
+// col-major rows x cols matrix.
+struct X86Int8GemmArgs {
+  int rows = 0;
+  int depth = 0;
+  int cols = 0;
+  const std::int8_t* lhs = nullptr;
+  std::int32_t lhs_zero_point = 0;
+  const std::int8_t* rhs = nullptr;
+  std::int32_t rhs_zero_point = 0;
+  std::int8_t* dst = nullptr;
+  std::int32_t dst_zero_point = 0;
+  // Same meaning as the GemmParams fields of the same names.
+  const std::int32_t* bias = nullptr;
+  std::int32_t multiplier_fixedpoint = 0;
+  int multiplier_exponent = 0;
+  const std::int32_t* multiplier_fixedpoint_perchannel = nullptr;
+  const int* multiplier_exponent_perchannel = nullptr;
+  std::int32_t clamp_min = -128;
+  std::int32_t clamp_max = 127;
+};
+
+// Runs the Gemm with `kernel`, which must be supported, using up to
+// context->max_num_threads() threads.
+void RunX86Int8Gemm(X86Int8Kernel kernel, const X86Int8GemmArgs& args,
+                    CpuBackendContext* context);
+
+// Performs the Gemm and returns true if the CPU has one of the kernels,
+// otherwise immediately returns false.
+template <QuantizationFlavor quantization_flavor>
+bool X86Int8Gemm(const MatrixParams<std::int8_t>& lhs_params,
+                 const std::int8_t* lhs_data,
+                 const MatrixParams<std::int8_t>& rhs_params,
+                 const std::int8_t* rhs_data,
+                 const MatrixParams<std::int8_t>& dst_params,
+                 std::int8_t* dst_data,
+                 const GemmParams<std::int32_t, std::int8_t,
+                                  quantization_flavor>& params,
+                 CpuBackendContext* context) {
+  const X86Int8Kernel kernel = SelectX86Int8Kernel(
+      lhs_params.rows, lhs_params.cols, rhs_params.cols);
+  if (kernel == X86Int8Kernel::kNone) {
+    return false;
+  }
+  X86Int8GemmArgs args;
+  args.rows = lhs_params.rows;
+  args.depth = lhs_params.cols;
+  args.cols = rhs_params.cols;
+  args.lhs = lhs_data;
+  args.lhs_zero_point = lhs_params.zero_point;
+  args.rhs = rhs_data;
+  args.rhs_zero_point = rhs_params.zero_point;
+  args.dst = dst_data;
+  args.dst_zero_point = dst_params.zero_point;
+  args.bias = params.bias;
+  args.multiplier_fixedpoint = params.multiplier_fixedpoint;
+  args.multiplier_exponent = params.multiplier_exponent;
+  args.multiplier_fixedpoint_perchannel =
+      params.multiplier_fixedpoint_perchannel;
+  args.multiplier_exponent_perchannel = params.multiplier_exponent_perchannel;
+  args.clamp_min = params.clamp_min;
+  args.clamp_max = params.clamp_max;
+  RunX86Int8Gemm(kernel, args, context);
+  return true;
+}
+
+}  // namespace detail
+}  // namespace cpu_backend_gemm
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_X86_INT8_H_
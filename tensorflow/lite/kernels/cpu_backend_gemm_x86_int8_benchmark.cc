@@ -0,0 +1,126 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_ruy.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_x86_int8.h"
+
+namespace tflite {
+namespace cpu_backend_gemm {
+namespace detail {
+namespace {
+
+// Measures the int8 Gemm of a fully_connected op with state.range(0) output
+// channels, state.range(1) input channels and a batch of state.range(2),
+// using ruy (state.range(3) == 0) or the given X86Int8Kernel.
+void BM_FullyConnectedInt8(benchmark::State& state) {
+  const int rows = state.range(0);
+  const int depth = state.range(1);
+  const int cols = state.range(2);
+  const auto kernel = static_cast<X86Int8Kernel>(state.range(3));
+  if (!IsX86Int8KernelSupported(kernel)) {
+    state.SkipWithError("Kernel not supported on this CPU.");
+    return;
+  }
+
+  std::vector<std::int8_t> lhs(rows * depth);
+  std::vector<std::int8_t> rhs(depth * cols);
+  std::vector<std::int8_t> dst(rows * cols);
+  std::vector<std::int32_t> bias(rows);
+  for (size_t i = 0; i < lhs.size(); ++i) lhs[i] = i * 7 % 255 - 127;
+  for (size_t i = 0; i < rhs.size(); ++i) rhs[i] = i * 13 % 255 - 127;
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = i * 31 % 1000 - 500;
+
+  MatrixParams<std::int8_t> lhs_params;
+  lhs_params.order = Order::kRowMajor;
+  lhs_params.rows = rows;
+  lhs_params.cols = depth;
+  MatrixParams<std::int8_t> rhs_params;
+  rhs_params.order = Order::kColMajor;
+  rhs_params.rows = depth;
+  rhs_params.cols = cols;
+  rhs_params.zero_point = -3;
+  MatrixParams<std::int8_t> dst_params;
+  dst_params.order = Order::kColMajor;
+  dst_params.rows = rows;
+  dst_params.cols = cols;
+  GemmParams<std::int32_t, std::int8_t> params;
+  params.bias = bias.data();
+  params.multiplier_fixedpoint = 1 << 30;
+  params.multiplier_exponent = -10;
+
+  X86Int8GemmArgs args;
+  args.rows = rows;
+  args.depth = depth;
+  args.cols = cols;
+  args.lhs = lhs.data();
+  args.rhs = rhs.data();
+  args.rhs_zero_point = rhs_params.zero_point;
+  args.dst = dst.data();
+  args.bias = params.bias;
+  args.multiplier_fixedpoint = params.multiplier_fixedpoint;
+  args.multiplier_exponent = params.multiplier_exponent;
+
+  CpuBackendContext context;
+  for (auto _ : state) {
+    if (kernel == X86Int8Kernel::kNone) {
+      GemmImplUsingRuy<std::int8_t, std::int8_t, std::int32_t, std::int8_t,
+                       QuantizationFlavor::kIntegerWithUniformMultiplier>::
+          Run(lhs_params, lhs.data(), rhs_params, rhs.data(), dst_params,
+              dst.data(), params, &context);
+    } else {
+      RunX86Int8Gemm(kernel, args, &context);
+    }
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.counters["GOPS"] = benchmark::Counter(
+      2.0 * rows * depth * cols, benchmark::Counter::kIsIterationInvariantRate,
+      benchmark::Counter::kIs1000);
+}
+
+void FullyConnectedShapes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"out", "in", "batch", "kernel"});
+  const int kShapes[][2] = {
+      {1024, 1024}, {4096, 1024}, {1024, 4096}, {768, 768}, {3072, 768},
+  };
+  for (const auto& shape : kShapes) {
+    for (int batch : {1, 8, 32, 128}) {
+      for (X86Int8Kernel kernel :
+           {X86Int8Kernel::kNone, X86Int8Kernel::kAvx512Vnni,
+            X86Int8Kernel::kAmx}) {
+        benchmark->Args(
+            {shape[0], shape[1], batch, static_cast<int>(kernel)});
+      }
+    }
+  }
+}
+BENCHMARK(BM_FullyConnectedInt8)->Apply(FullyConnectedShapes);
+
+}  // namespace
+}  // namespace detail
+}  // namespace cpu_backend_gemm
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
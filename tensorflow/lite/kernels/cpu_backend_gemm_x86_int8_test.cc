@@ -0,0 +1,236 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/kernels/cpu_backend_gemm_x86_int8.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+
+namespace tflite {
+namespace cpu_backend_gemm {
+namespace detail {
+namespace {
+
+struct Shape {
+  int rows;
+  int depth;
+  int cols;
+};
+
+// Operands of a Gemm with random data, and its expected result computed like
+// the reference fully_connected kernel.
+class TestGemm {
+ public:
+  TestGemm(const Shape& shape, std::int32_t lhs_zero_point,
+           std::int32_t rhs_zero_point, bool per_channel, bool with_bias)
+      : lhs_(shape.rows * shape.depth),
+        rhs_(shape.depth * shape.cols),
+        dst_(shape.rows * shape.cols),
+        bias_(shape.rows),
+        multipliers_(shape.rows),
+        exponents_(shape.rows) {
+    std::mt19937 random_engine(shape.rows * 7919 + shape.depth * 31 +
+                               shape.cols);
+    std::uniform_int_distribution<int> int8_distribution(-128, 127);
+    std::uniform_int_distribution<int> bias_distribution(-5000, 5000);
+    std::uniform_int_distribution<std::int32_t> multiplier_distribution(
+        1 << 30, std::numeric_limits<std::int32_t>::max());
+    // Keeps most results within the clamp range as the depth grows.
+    const int max_exponent =
+        -7 - static_cast<int>(std::log2(shape.depth) / 2);
+    std::uniform_int_distribution<int> exponent_distribution(max_exponent - 2,
+                                                             max_exponent);
+    for (std::int8_t& value : lhs_) value = int8_distribution(random_engine);
+    for (std::int8_t& value : rhs_) value = int8_distribution(random_engine);
+    for (int row = 0; row < shape.rows; ++row) {
+      bias_[row] = bias_distribution(random_engine);
+      multipliers_[row] = multiplier_distribution(random_engine);
+      exponents_[row] = exponent_distribution(random_engine);
+    }
+
+    args_.rows = shape.rows;
+    args_.depth = shape.depth;
+    args_.cols = shape.cols;
+    args_.lhs = lhs_.data();
+    args_.lhs_zero_point = lhs_zero_point;
+    args_.rhs = rhs_.data();
+    args_.rhs_zero_point = rhs_zero_point;
+    args_.dst = dst_.data();
+    args_.dst_zero_point = 3;
+    args_.bias = with_bias ? bias_.data() : nullptr;
+    args_.multiplier_fixedpoint = multipliers_[0];
+    args_.multiplier_exponent = exponents_[0];
+    if (per_channel) {
+      args_.multiplier_fixedpoint_perchannel = multipliers_.data();
+      args_.multiplier_exponent_perchannel = exponents_.data();
+    }
+    args_.clamp_min = -100;
+    args_.clamp_max = 120;
+  }
+
+  const X86Int8GemmArgs& args() const { return args_; }
+  const std::vector<std::int8_t>& dst() const { return dst_; }
+
+  std::vector<std::int8_t> Expected() const {
+    std::vector<std::int8_t> expected(dst_.size());
+    for (int col = 0; col < args_.cols; ++col) {
+      for (int row = 0; row < args_.rows; ++row) {
+        std::int32_t acc = 0;
+        for (int d = 0; d < args_.depth; ++d) {
+          acc += (lhs_[row * args_.depth + d] - args_.lhs_zero_point) *
+                 (rhs_[col * args_.depth + d] - args_.rhs_zero_point);
+        }
+        if (args_.bias) {
+          acc += args_.bias[row];
+        }
+        const bool per_channel = args_.multiplier_fixedpoint_perchannel;
+        acc = MultiplyByQuantizedMultiplier(
+            acc, per_channel ? multipliers_[row] : multipliers_[0],
+            per_channel ? exponents_[row] : exponents_[0]);
+        acc += args_.dst_zero_point;
+        acc = std::min(std::max(acc, args_.clamp_min), args_.clamp_max);
+        expected[col * args_.rows + row] = acc;
+      }
+    }
+    return expected;
+  }
+
+ private:
+  std::vector<std::int8_t> lhs_;
+  std::vector<std::int8_t> rhs_;
+  std::vector<std::int8_t> dst_;
+  std::vector<std::int32_t> bias_;
+  std::vector<std::int32_t> multipliers_;
+  std::vector<int> exponents_;
+  X86Int8GemmArgs args_;
+};
+
+const Shape kShapes[] = {
+    {1, 1, 1},     {3, 5, 2},       {4, 64, 4},      {7, 65, 5},
+    {16, 16, 16},  {17, 100, 15},   {33, 130, 31},   {64, 256, 48},
+    {100, 300, 1}, {128, 1024, 64}, {257, 777, 33},
+};
+
+class X86Int8KernelTest : public testing::TestWithParam<X86Int8Kernel> {
+ protected:
+  void SetUp() override {
+    if (!IsX86Int8KernelSupported(GetParam())) {
+      GTEST_SKIP() << "Kernel not supported on this CPU.";
+    }
+  }
+
+  void CheckAllShapes(std::int32_t lhs_zero_point, std::int32_t rhs_zero_point,
+                      bool per_channel, bool with_bias, int num_threads) {
+    CpuBackendContext context;
+    context.SetMaxNumThreads(num_threads);
+    for (const Shape& shape : kShapes) {
+      SCOPED_TRACE(testing::Message() << shape.rows << "x" << shape.depth
+                                      << "x" << shape.cols);
+      TestGemm gemm(shape, lhs_zero_point, rhs_zero_point, per_channel,
+                    with_bias);
+      RunX86Int8Gemm(GetParam(), gemm.args(), &context);
+      EXPECT_EQ(gemm.dst(), gemm.Expected());
+    }
+  }
+};
+
+TEST_P(X86Int8KernelTest, PerTensor) {
+  CheckAllShapes(/*lhs_zero_point=*/0, /*rhs_zero_point=*/-7,
+                 /*per_channel=*/false, /*with_bias=*/true, /*num_threads=*/1);
+}
+
+TEST_P(X86Int8KernelTest, PerChannel) {
+  CheckAllShapes(/*lhs_zero_point=*/0, /*rhs_zero_point=*/12,
+                 /*per_channel=*/true, /*with_bias=*/true, /*num_threads=*/1);
+}
+
+TEST_P(X86Int8KernelTest, NoBias) {
+  CheckAllShapes(/*lhs_zero_point=*/0, /*rhs_zero_point=*/0,
+                 /*per_channel=*/true, /*with_bias=*/false, /*num_threads=*/1);
+}
+
+TEST_P(X86Int8KernelTest, LhsZeroPoint) {
+  CheckAllShapes(/*lhs_zero_point=*/-3, /*rhs_zero_point=*/5,
+                 /*per_channel=*/false, /*with_bias=*/true, /*num_threads=*/1);
+}
+
+TEST_P(X86Int8KernelTest, MultiThreaded) {
+  CheckAllShapes(/*lhs_zero_point=*/0, /*rhs_zero_point=*/-7,
+                 /*per_channel=*/true, /*with_bias=*/true, /*num_threads=*/4);
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, X86Int8KernelTest,
+                         testing::Values(X86Int8Kernel::kAvx512Vnni,
+                                         X86Int8Kernel::kAmx));
+
+// Checks the public entry point, whichever kernel it ends up using.
+TEST(X86Int8GemmTest, GemmMatchesReference) {
+  CpuBackendContext context;
+  for (const Shape& shape : kShapes) {
+    SCOPED_TRACE(testing::Message() << shape.rows << "x" << shape.depth << "x"
+                                    << shape.cols);
+    TestGemm gemm(shape, /*lhs_zero_point=*/0, /*rhs_zero_point=*/-7,
+                  /*per_channel=*/true, /*with_bias=*/true);
+    const X86Int8GemmArgs& args = gemm.args();
+    MatrixParams<std::int8_t> lhs_params;
+    lhs_params.order = Order::kRowMajor;
+    lhs_params.rows = args.rows;
+    lhs_params.cols = args.depth;
+    lhs_params.zero_point = args.lhs_zero_point;
+    MatrixParams<std::int8_t> rhs_params;
+    rhs_params.order = Order::kColMajor;
+    rhs_params.rows = args.depth;
+    rhs_params.cols = args.cols;
+    rhs_params.zero_point = args.rhs_zero_point;
+    MatrixParams<std::int8_t> dst_params;
+    dst_params.order = Order::kColMajor;
+    dst_params.rows = args.rows;
+    dst_params.cols = args.cols;
+    dst_params.zero_point = args.dst_zero_point;
+    GemmParams<std::int32_t, std::int8_t,
+               QuantizationFlavor::kIntegerWithPerRowMultiplier>
+        params;
+    params.bias = args.bias;
+    params.multiplier_fixedpoint_perchannel =
+        args.multiplier_fixedpoint_perchannel;
+    params.multiplier_exponent_perchannel = args.multiplier_exponent_perchannel;
+    params.clamp_min = args.clamp_min;
+    params.clamp_max = args.clamp_max;
+    std::vector<std::int8_t> dst(args.rows * args.cols);
+    Gemm(lhs_params, args.lhs, rhs_params, args.rhs, dst_params, dst.data(),
+         params, &context);
+    // Other backends may round ties differently when requantizing.
+    const std::vector<std::int8_t> expected = gemm.Expected();
+    for (size_t i = 0; i < dst.size(); ++i) {
+      EXPECT_NEAR(dst[i], expected[i], 1) << "at " << i;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace detail
+}  // namespace cpu_backend_gemm
+}  // namespace tflite
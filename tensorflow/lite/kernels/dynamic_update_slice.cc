@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/variable_update_util.h"
 
 namespace tflite {
 namespace ops {
@@ -36,6 +37,19 @@ constexpr int kUpdateTensor = 1;
 constexpr int kStartIndicesTensor = 2;
 constexpr int kOutputTensor = 0;
 
+struct OpData {
+  // See FindInPlaceVariableUpdate().
+  int in_place_update_resource_id = -1;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  return new OpData();
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  delete reinterpret_cast<OpData*>(buffer);
+}
+
 // TFLite DynamicUpdateSlice op follows the semantics of XLA DynamicUpdateSlice
 // op. See https://www.tensorflow.org/xla/operation_semantics#dynamicupdateslice
 // for details.
@@ -72,6 +86,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_TYPES_EQ(context, operand->type, update->type);
   TF_LITE_ENSURE_TYPES_EQ(context, start_indices->type, kTfLiteInt32);
 
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  op_data->in_place_update_resource_id =
+      FindInPlaceVariableUpdate(context, node);
+
   output->type = operand->type;
   TfLiteIntArray* output_size = TfLiteIntArrayCopy(operand->dims);
   return context->ResizeTensor(context, output, output_size);
@@ -158,6 +176,19 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_OK(context,
                     GetOutputSafe(context, node, kOutputTensor, &output));
 
+  // Updates the variable which READ_VARIABLE and ASSIGN_VARIABLE don't copy,
+  // as both the operand and the output.
+  const OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  if (op_data->in_place_update_resource_id >= 0) {
+    auto* variable = GetInPlaceUpdatableVariable(
+        context, &context->tensors[op_data->in_place_update_resource_id],
+        operand);
+    if (variable != nullptr) {
+      output = variable->GetTensor();
+      operand = output;
+    }
+  }
+
   switch (operand->type) {
     case kTfLiteFloat32:
       DynamicUpdateSlice<float>(operand, update, indice, output);
@@ -188,8 +219,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace dynamic_update_slice
 
 TfLiteRegistration* Register_DYNAMIC_UPDATE_SLICE() {
-  static TfLiteRegistration r = {/*init=*/nullptr,
-                                 /*free=*/nullptr,
+  static TfLiteRegistration r = {dynamic_update_slice::Init,
+                                 dynamic_update_slice::Free,
                                  dynamic_update_slice::Prepare,
                                  dynamic_update_slice::Eval,
                                  /*profiling_string=*/nullptr,
@@ -25,7 +25,8 @@ limitations under the License.
 //   Output.dim[0] == Tensor[0].dim[0], num of lookups
 //   Output.dim[1] == Tensor[1].dim[1],  num of items per row
 //   Each item in output is a raw bytes copy of the corresponding item in input,
-//   or a dequantized value in the case of a uint8 input.
+//   or a dequantized value in the case of a uint8, int8 or int4 input. Int4
+//   inputs are densely packed and may have one scale per row.
 //   When indices are out of bound, the ops will not succeed.
 //
 
@@ -55,6 +56,19 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, 1, &value));
   TF_LITE_ENSURE(context, NumDimensions(value) >= 2);
 
+  // Quantized values may have one scale per row.
+  if (value->quantization.type == kTfLiteAffineQuantization) {
+    const auto* affine_quantization =
+        reinterpret_cast<const TfLiteAffineQuantization*>(
+            value->quantization.params);
+    if (affine_quantization && affine_quantization->scale &&
+        affine_quantization->scale->size > 1) {
+      TF_LITE_ENSURE_EQ(context, affine_quantization->quantized_dimension, 0);
+      TF_LITE_ENSURE_EQ(context, affine_quantization->scale->size,
+                        SizeOfDimension(value, 0));
+    }
+  }
+
   TfLiteTensor* output;
   TF_LITE_ENSURE_OK(context, GetOutputSafe(context, node, 0, &output));
   TfLiteIntArray* outputSize = TfLiteIntArrayCreate(NumDimensions(value));
@@ -97,11 +111,27 @@ TfLiteStatus EvalSimple(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+// Returns element `i` of densely packed int4 `data`, where even elements are
+// stored in the low nibble of each byte.
+inline int8_t GetInt4Value(const int8_t* data, int i) {
+  const int8_t byte = data[i / 2];
+  return (i % 2 == 0) ? static_cast<int8_t>(byte << 4) >> 4 : byte >> 4;
+}
+
 TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
                         const TfLiteTensor* lookup, const TfLiteTensor* value,
                         TfLiteTensor* output) {
   const int row_size = SizeOfDimension(value, 0);
-  const double scaling_factor = value->params.scale;
+  const TfLiteFloatArray* per_row_scales = nullptr;
+  if (value->quantization.type == kTfLiteAffineQuantization) {
+    const auto* affine_quantization =
+        reinterpret_cast<const TfLiteAffineQuantization*>(
+            value->quantization.params);
+    if (affine_quantization && affine_quantization->scale &&
+        affine_quantization->scale->size > 1) {
+      per_row_scales = affine_quantization->scale;
+    }
+  }
 
   // col_size after we flatten tensor into 2D.
   int col_size = 1;
@@ -125,9 +155,20 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
       // Dequantize embedding values.
       // TODO(alanchiao): refactor scalar multiply into separate function
       // for ease of adding a neon equivalent if ever necessary.
-      for (int j = 0; j < col_size; j++) {
-        output_ptr[j + i * col_size] =
-            value_ptr[j + idx * col_size] * scaling_factor;
+      const double scaling_factor = per_row_scales
+                                        ? per_row_scales->data[idx]
+                                        : value->params.scale;
+      if (value->type == kTfLiteInt4) {
+        // Only the looked up rows are unpacked.
+        for (int j = 0; j < col_size; j++) {
+          output_ptr[j + i * col_size] =
+              GetInt4Value(value_ptr, j + idx * col_size) * scaling_factor;
+        }
+      } else {
+        for (int j = 0; j < col_size; j++) {
+          output_ptr[j + i * col_size] =
+              value_ptr[j + idx * col_size] * scaling_factor;
+        }
       }
     }
   }
@@ -152,6 +193,9 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       } else {
         return EvalSimple(context, node, lookup, value, output);
       }
+    case kTfLiteInt4:
+      TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteFloat32);
+      return EvalHybrid(context, node, lookup, value, output);
     default:
       TF_LITE_KERNEL_LOG(context, "Type not currently supported.");
       return kTfLiteError;
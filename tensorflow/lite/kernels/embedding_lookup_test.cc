@@ -101,6 +101,33 @@ class HybridEmbeddingLookupOpModel : public BaseEmbeddingLookupOpModel {
   }
 };
 
+class Int4EmbeddingLookupOpModel : public SingleOpModel {
+ public:
+  Int4EmbeddingLookupOpModel(std::initializer_list<int> index_shape,
+                             const TensorData& weight) {
+    input_ = AddInput(TensorType_INT32);
+    weight_ = AddInput(weight);
+    output_ = AddOutput(TensorType_FLOAT32);
+    SetBuiltinOp(BuiltinOperator_EMBEDDING_LOOKUP, BuiltinOptions_NONE, 0);
+    BuildInterpreter({index_shape, weight.shape});
+  }
+
+  void SetInput(std::initializer_list<int> data) {
+    PopulateTensor(input_, data);
+  }
+
+  void SetWeight(const std::vector<float>& data) {
+    PerChannelSymmetricQuantizeAndPopulate(weight_, data);
+  }
+
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+
+ private:
+  int input_;
+  int weight_;
+  int output_;
+};
+
 // TODO(ahentz): write more tests that exercise the details of the op, such as
 // lookup errors and variable input shapes.
 TEST(EmbeddingLookupOpTest, SimpleTest) {
@@ -245,6 +272,73 @@ TEST(HybridEmbeddingLookupHybridOpTest, Simple4DTestInt8) {
                   kTestTolerance)));
 }
 
+TEST(HybridEmbeddingLookupHybridOpTest, Simple2DTestInt4) {
+  Int4EmbeddingLookupOpModel m({3}, {TensorType_INT4, {3, 8}, 0, 0, 0.5, 0});
+  m.SetInput({1, 0, 2});
+  m.SetWeight({
+      0.0,  0.5,  1.0,  1.5,  2.0,  2.5,  3.0,  3.5,   // Row 0
+      -0.5, -1.0, -1.5, -2.0, -2.5, -3.0, -3.5, 0.0,   // Row 1
+      3.5,  -3.5, 3.0,  -3.0, 2.5,  -2.5, 2.0,  -2.0,  // Row 2
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(),
+              ElementsAreArray(ArrayFloatNear({
+                  -0.5, -1.0, -1.5, -2.0, -2.5, -3.0, -3.5, 0.0,   // Row 1
+                  0.0,  0.5,  1.0,  1.5,  2.0,  2.5,  3.0,  3.5,   // Row 0
+                  3.5,  -3.5, 3.0,  -3.0, 2.5,  -2.5, 2.0,  -2.0,  // Row 2
+              })));
+}
+
+// Rows of an odd number of values don't start on a byte boundary.
+TEST(HybridEmbeddingLookupHybridOpTest, OddRowSizeTestInt4) {
+  Int4EmbeddingLookupOpModel m({4}, {TensorType_INT4, {3, 5}, 0, 0, 1.0, 0});
+  m.SetInput({1, 2, 0, 1});
+  m.SetWeight({
+      0,  1,  2,  3,  4,  // Row 0
+      -1, -2, -3, -4, 5,  // Row 1
+      7,  -7, 6,  -6, 0,  // Row 2
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear({
+                                 -1, -2, -3, -4, 5,  // Row 1
+                                 7,  -7, 6,  -6, 0,  // Row 2
+                                 0,  1,  2,  3,  4,  // Row 0
+                                 -1, -2, -3, -4, 5,  // Row 1
+                             })));
+}
+
+TEST(HybridEmbeddingLookupHybridOpTest, PerRowScalesTestInt4) {
+  Int4EmbeddingLookupOpModel m(
+      {3}, {TensorType_INT4,
+            {3, 2, 2},
+            0,
+            0,
+            0,
+            0,
+            /*per_channel_quantization=*/true,
+            /*per_channel_quantization_scales=*/{0.01, 0.1, 1.0},
+            /*per_channel_quantization_offsets=*/{0, 0, 0},
+            /*channel_index=*/0});
+  m.SetInput({2, 0, 1});
+  m.SetWeight({
+      0.01, 0.02, -0.03, 0.07,  // Row 0
+      0.1,  -0.5, 0.6,   -0.7,  // Row 1
+      -7.0, 3.0,  2.0,   1.0,   // Row 2
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear({
+                                 -7.0, 3.0,  2.0,   1.0,   // Row 2
+                                 0.01, 0.02, -0.03, 0.07,  // Row 0
+                                 0.1,  -0.5, 0.6,   -0.7,  // Row 1
+                             })));
+}
+
 TEST(EmbeddingLookupHybridOpTest, Simple3DTestQuantized) {
   EmbeddingLookupOpModel m({3}, {3, 2, 4}, TensorType_UINT8, TensorType_INT8);
   m.SetInput({1, 0, 2});
@@ -19,6 +19,17 @@ limitations under the License.
 #include <sys/auxv.h>
 #endif
 
+#if defined __x86_64__ && (defined __GNUC__ || defined __clang__)
+#define TFLITE_CPU_CHECK_X86_CPUID
+#include <cpuid.h>
+
+#include <cstdint>
+#if defined __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
 namespace tflite {
 
 namespace {
@@ -37,6 +48,67 @@ bool DetectDotprodByLinuxAuxvMethod() {
 }
 #endif
 
+#if defined TFLITE_CPU_CHECK_X86_CPUID
+// Returns the bits of the XCR0 register, i.e. the register states enabled by
+// the OS, or 0 if the OS doesn't support XSAVE.
+uint64_t GetXcr0() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE)) {
+    return 0;
+  }
+  // xgetbv is spelled out to avoid requiring the xsave target feature.
+  uint32_t xcr0_low, xcr0_high;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+  return (static_cast<uint64_t>(xcr0_high) << 32) | xcr0_low;
+}
+
+bool GetCpuidLeaf7(unsigned int* ebx, unsigned int* ecx, unsigned int* edx) {
+  unsigned int eax;
+  return __get_cpuid_count(7, 0, &eax, ebx, ecx, edx);
+}
+
+bool DetectAvx512VnniByCpuid() {
+  unsigned int ebx, ecx, edx;
+  if (!GetCpuidLeaf7(&ebx, &ecx, &edx)) {
+    return false;
+  }
+  const unsigned int kAvx512F = 1u << 16;
+  const unsigned int kAvx512BW = 1u << 30;
+  const unsigned int kAvx512Vnni = 1u << 11;
+  // SSE, AVX, opmask, ZMM0-15 upper halves and ZMM16-31 states.
+  const uint64_t kAvx512States = 0xe6;
+  return (ebx & kAvx512F) && (ebx & kAvx512BW) && (ecx & kAvx512Vnni) &&
+         (GetXcr0() & kAvx512States) == kAvx512States;
+}
+
+bool DetectAmxInt8ByCpuid() {
+  unsigned int ebx, ecx, edx;
+  if (!GetCpuidLeaf7(&ebx, &ecx, &edx)) {
+    return false;
+  }
+  const unsigned int kAmxTile = 1u << 24;
+  const unsigned int kAmxInt8 = 1u << 25;
+  // TILECFG and TILEDATA states.
+  const uint64_t kAmxStates = (1ull << 17) | (1ull << 18);
+  if (!(edx & kAmxTile) || !(edx & kAmxInt8) ||
+      (GetXcr0() & kAmxStates) != kAmxStates) {
+    return false;
+  }
+#if defined __linux__
+  // Linux only lets processes use the (large) tile data state after asking
+  // for it. These are the values of ARCH_REQ_XCOMP_PERM and
+  // XFEATURE_XTILEDATA in recent Linux headers, which we can't rely on yet.
+  const int kLocalArchReqXcompPerm = 0x1023;
+  const int kLocalXfeatureXtiledata = 18;
+  if (syscall(SYS_arch_prctl, kLocalArchReqXcompPerm,
+              kLocalXfeatureXtiledata) != 0) {
+    return false;
+  }
+#endif
+  return true;
+}
+#endif
+
 }  // namespace
 
 bool DetectArmNeonDotprod() {
@@ -47,4 +119,22 @@ bool DetectArmNeonDotprod() {
   return false;
 }
 
+bool DetectX86Avx512Vnni() {
+#if defined TFLITE_CPU_CHECK_X86_CPUID
+  static const bool has_avx512_vnni = DetectAvx512VnniByCpuid();
+  return has_avx512_vnni;
+#else
+  return false;
+#endif
+}
+
+bool DetectX86AmxInt8() {
+#if defined TFLITE_CPU_CHECK_X86_CPUID
+  static const bool has_amx_int8 = DetectAmxInt8ByCpuid();
+  return has_amx_int8;
+#else
+  return false;
+#endif
+}
+
 }  // namespace tflite
@@ -27,12 +27,27 @@ namespace tflite {
 // On other architectures, returns false unconditionally.
 bool DetectArmNeonDotprod();
 
+// On x86-64, returns true if AVX-512 with the VNNI extension (vpdpbusd) is
+// present and enabled by the OS.
+// On other architectures, returns false unconditionally.
+bool DetectX86Avx512Vnni();
+
+// On x86-64, returns true if the AMX tile and int8 extensions are present and
+// the process is allowed to use them. On Linux this requests permission to use
+// the AMX tile data state for the process the first time it's called.
+// On other architectures, returns false unconditionally.
+bool DetectX86AmxInt8();
+
 struct CpuFlags {
   bool neon_dotprod = false;
+  bool avx512_vnni = false;
+  bool amx_int8 = false;
 };
 
 inline void GetCpuFlags(CpuFlags* cpu_flags) {
   cpu_flags->neon_dotprod = DetectArmNeonDotprod();
+  cpu_flags->avx512_vnni = DetectX86Avx512Vnni();
+  cpu_flags->amx_int8 = DetectX86AmxInt8();
 }
 
 }  // namespace tflite
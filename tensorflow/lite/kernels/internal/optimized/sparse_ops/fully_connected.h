@@ -30,6 +30,53 @@ limitations under the License.
 namespace tflite {
 namespace optimized_ops {
 
+// Returns true if `sparsity` encodes a float weights tensor of shape `dims`,
+// whose dimensions other than the first and the last are 1, as 1x4 blocks
+// along the last dimension: dense leading dimensions, then a CSR dimension of
+// blocks and a dense block dimension of size 4. Such a tensor is a
+// [dims[0], dims[rank - 1]] matrix that FullyConnectedSparseWeight1x4 can use,
+// e.g. the filter of a pointwise convolution.
+inline bool IsSparseWeight1x4(const TfLiteSparsity& sparsity,
+                              const TfLiteIntArray& dims) {
+  const int rank = dims.size;
+  if (rank < 2 || sparsity.dim_metadata_size != rank + 1) return false;
+  if (dims.data[rank - 1] % 4 != 0) return false;
+  for (int i = 1; i < rank - 1; ++i) {
+    if (dims.data[i] != 1) return false;
+  }
+  if (sparsity.block_map == nullptr || sparsity.block_map->size != 1 ||
+      sparsity.block_map->data[0] != rank - 1) {
+    return false;
+  }
+  if (sparsity.traversal_order != nullptr) {
+    for (int i = 0; i < sparsity.traversal_order->size; ++i) {
+      if (sparsity.traversal_order->data[i] != i) return false;
+    }
+  }
+  for (int i = 0; i < rank - 1; ++i) {
+    if (sparsity.dim_metadata[i].format != kTfLiteDimDense) return false;
+  }
+  return sparsity.dim_metadata[rank - 1].format == kTfLiteDimSparseCSR &&
+         sparsity.dim_metadata[rank].format == kTfLiteDimDense &&
+         sparsity.dim_metadata[rank].dense_size == 4;
+}
+
+// Returns the two-dimensional encoding of a tensor for which
+// IsSparseWeight1x4() is true, in the format of the sparsity of the weights
+// of fully_connected. `dim_metadata` must have room for 3 elements and outlive
+// the result, which shares the segments and indices of `sparsity`.
+inline TfLiteSparsity GetSparseWeight1x4Matrix(
+    const TfLiteSparsity& sparsity, TfLiteDimensionMetadata* dim_metadata) {
+  const int rank = sparsity.dim_metadata_size - 1;
+  dim_metadata[0] = sparsity.dim_metadata[0];
+  dim_metadata[1] = sparsity.dim_metadata[rank - 1];
+  dim_metadata[2] = sparsity.dim_metadata[rank];
+  TfLiteSparsity matrix_sparsity = {};
+  matrix_sparsity.dim_metadata = dim_metadata;
+  matrix_sparsity.dim_metadata_size = 3;
+  return matrix_sparsity;
+}
+
 inline void FullyConnectedSparseWeight(
     const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
     const RuntimeShape& input_shape, const float* input_data,
@@ -86,7 +86,6 @@ static inline int32_t ReduceInt32x4(__m128i acc) {
   return _mm_cvtsi128_si32(acc);
 }
 
-#ifdef __AVX2__
 // Horizontally add 4 float values stored in a single XMM register to float.
 static inline float ReduceFloat32x4(__m128 acc) {
   __m128 shuffle = _mm_movehdup_ps(acc);
@@ -96,6 +95,7 @@ static inline float ReduceFloat32x4(__m128 acc) {
   return _mm_cvtss_f32(acc);
 }
 
+#ifdef __AVX2__
 // Horizontally add 8 float values stored in a single XMM register to float.
 static inline float ReduceFloat32x8(__m256 acc) {
   __m128 low = _mm256_extractf128_ps(acc, 0);
@@ -617,6 +617,106 @@ void SseSparseMatrixBatchVectorMultiplyAccumulate(
   }  // for batch
 }
 
+namespace {
+
+// Implements 1x4 block sparse-matrix - vector multiply-accumulate for float
+// values. Each block of the matrix is exactly one XMM register.
+inline void SseSparseMatrixVectorMultiplyAccumulate1x4(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, const int m_rows,
+    const float* __restrict__ vector, float* __restrict__ result) {
+  static const std::intptr_t kBlockSize = 4;
+  for (std::intptr_t row = 0; row < m_rows; ++row) {
+    __m128 dotprod_fx4 = _mm_setzero_ps();
+    for (std::intptr_t i = segments[row]; i < segments[row + 1]; ++i) {
+      const std::intptr_t col_index = indices[i] * kBlockSize;
+      const __m128 vec_fx4 = _mm_loadu_ps(vector + col_index);
+      const __m128 row_fx4 = _mm_loadu_ps(matrix);
+      dotprod_fx4 = _mm_add_ps(dotprod_fx4, _mm_mul_ps(vec_fx4, row_fx4));
+      matrix += kBlockSize;
+    }  // for col
+    result[row] += ReduceFloat32x4(dotprod_fx4);
+  }  // for row
+}
+
+// Implements 1x4 block sparse-matrix - batch-of-4-vectors multiply-accumulate
+// for float values, loading each block of the matrix once for the 4 vectors.
+// The stride between vectors is m_cols and between results m_rows.
+inline void SseSparseMatrix4VectorsMultiplyAccumulate1x4(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, const int m_rows, const int m_cols,
+    const float* __restrict__ const vectors, float* __restrict__ const results) {
+  static const std::intptr_t kBlockSize = 4;
+  const float* __restrict__ vector0 = vectors + 0 * m_cols;
+  const float* __restrict__ vector1 = vectors + 1 * m_cols;
+  const float* __restrict__ vector2 = vectors + 2 * m_cols;
+  const float* __restrict__ vector3 = vectors + 3 * m_cols;
+  float* __restrict__ result0 = results + 0 * m_rows;
+  float* __restrict__ result1 = results + 1 * m_rows;
+  float* __restrict__ result2 = results + 2 * m_rows;
+  float* __restrict__ result3 = results + 3 * m_rows;
+
+  for (std::intptr_t row = 0; row < m_rows; ++row) {
+    __m128 dp0_fx4 = _mm_setzero_ps();
+    __m128 dp1_fx4 = _mm_setzero_ps();
+    __m128 dp2_fx4 = _mm_setzero_ps();
+    __m128 dp3_fx4 = _mm_setzero_ps();
+    for (std::intptr_t i = segments[row]; i < segments[row + 1]; ++i) {
+      const std::intptr_t col_index = indices[i] * kBlockSize;
+      const __m128 row_fx4 = _mm_loadu_ps(matrix);
+      // dpN are for different batches
+      dp0_fx4 = _mm_add_ps(
+          dp0_fx4, _mm_mul_ps(_mm_loadu_ps(vector0 + col_index), row_fx4));
+      dp1_fx4 = _mm_add_ps(
+          dp1_fx4, _mm_mul_ps(_mm_loadu_ps(vector1 + col_index), row_fx4));
+      dp2_fx4 = _mm_add_ps(
+          dp2_fx4, _mm_mul_ps(_mm_loadu_ps(vector2 + col_index), row_fx4));
+      dp3_fx4 = _mm_add_ps(
+          dp3_fx4, _mm_mul_ps(_mm_loadu_ps(vector3 + col_index), row_fx4));
+      matrix += kBlockSize;
+    }  // for col
+
+    // Horizontally add the 4 intermediate values of each batch, so that
+    // element N holds the dot product of batch N.
+    _MM_TRANSPOSE4_PS(dp0_fx4, dp1_fx4, dp2_fx4, dp3_fx4);
+    const __m128 dp_fx4 = _mm_add_ps(_mm_add_ps(dp0_fx4, dp1_fx4),
+                                     _mm_add_ps(dp2_fx4, dp3_fx4));
+    __m128 result_fx4 =
+        _mm_set_ps(result3[row], result2[row], result1[row], result0[row]);
+    result_fx4 = _mm_add_ps(result_fx4, dp_fx4);
+    result0[row] = GetFloatVectorElement<0>(result_fx4);
+    result1[row] = GetFloatVectorElement<1>(result_fx4);
+    result2[row] = GetFloatVectorElement<2>(result_fx4);
+    result3[row] = GetFloatVectorElement<3>(result_fx4);
+  }  // for row
+}
+
+}  // namespace
+
+void SseSparseMatrixBatchVectorMultiplyAccumulate1x4(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const float* __restrict__ vector, int n_batch, float* __restrict__ result) {
+  TFLITE_DCHECK_EQ(m_cols % 4, 0);
+  int batch = 0;
+  const int kBatchSize4 = 4;
+  const int n_batch_rounddown_to_batchsize_4 = n_batch & ~(kBatchSize4 - 1);
+  while (batch < n_batch_rounddown_to_batchsize_4) {
+    SseSparseMatrix4VectorsMultiplyAccumulate1x4(
+        matrix, segments, indices, m_rows, m_cols, vector, result);
+    batch += kBatchSize4;
+    vector += kBatchSize4 * m_cols;
+    result += kBatchSize4 * m_rows;
+  }  // for batch
+  while (batch < n_batch) {
+    SseSparseMatrixVectorMultiplyAccumulate1x4(matrix, segments, indices,
+                                               m_rows, vector, result);
+    ++batch;
+    vector += m_cols;
+    result += m_rows;
+  }  // for batch
+}
+
 void SseReductionSumVector(const int8_t* input_vector, int32_t* output_vector,
                            const int output_size, const int reduction_size) {
   static constexpr std::intptr_t kBlockSize = 16;
@@ -995,6 +995,131 @@ inline void LstmStepFloat(
 // LINT.ThenChange(../tools/optimize/calibration/builtin_logging_ops/lstm.cc,\
 //                 ../experimental/kernels/fp16/lstm_eval.cc)
 
+// Packs the input and recurrent weights of the gates into the rows of a
+// matrix of size 'n_gates * n_cell' x 'n_input + n_output', followed by the
+// gate biases and room for the concatenated input and output state of a step.
+// The gates are in the order of the scratch buffers of EvalFloat: input
+// (unless CIFG), cell, forget and output. With layer norm, the biases are
+// added after normalization and the packed ones are zeros.
+void PackFusedWeights(
+    const float* input_to_input_weights, const float* input_to_forget_weights,
+    const float* input_to_cell_weights, const float* input_to_output_weights,
+    const float* recurrent_to_input_weights,
+    const float* recurrent_to_forget_weights,
+    const float* recurrent_to_cell_weights,
+    const float* recurrent_to_output_weights, const float* input_gate_bias,
+    const float* forget_gate_bias, const float* cell_gate_bias,
+    const float* output_gate_bias, bool use_layer_norm, int n_cell,
+    int n_input, int n_output, float* fused_weights) {
+  const bool use_cifg = (input_to_input_weights == nullptr);
+  const float* input_weights[] = {input_to_input_weights, input_to_cell_weights,
+                                  input_to_forget_weights,
+                                  input_to_output_weights};
+  const float* recurrent_weights[] = {
+      recurrent_to_input_weights, recurrent_to_cell_weights,
+      recurrent_to_forget_weights, recurrent_to_output_weights};
+  const float* biases[] = {input_gate_bias, cell_gate_bias, forget_gate_bias,
+                           output_gate_bias};
+  const int n_gates = use_cifg ? 3 : 4;
+  const int n_cols = n_input + n_output;
+  float* row = fused_weights;
+  float* bias = fused_weights + n_gates * n_cell * n_cols;
+  for (int gate = use_cifg ? 1 : 0; gate < 4; ++gate) {
+    for (int cell = 0; cell < n_cell; ++cell) {
+      std::copy_n(input_weights[gate] + cell * n_input, n_input, row);
+      std::copy_n(recurrent_weights[gate] + cell * n_output, n_output,
+                  row + n_input);
+      row += n_cols;
+    }
+    if (use_layer_norm) {
+      std::fill_n(bias, n_cell, 0.0f);
+    } else {
+      std::copy_n(biases[gate], n_cell, bias);
+    }
+    bias += n_cell;
+  }
+}
+
+// Applies the peephole connection, layer normalization and activation to a
+// gate of a single batch whose matrix products are already in `gate`.
+inline void FinishLstmGateFloat(const float* cell_state,
+                                const float* cell_to_gate_weights,
+                                const float* layer_norm_coefficients,
+                                const float* gate_bias, int n_cell,
+                                TfLiteFusedActivation activation, float* gate) {
+  if (cell_to_gate_weights != nullptr) {
+    tensor_utils::VectorBatchVectorCwiseProductAccumulate(
+        cell_to_gate_weights, n_cell, cell_state, /*n_batch=*/1, gate);
+  }
+  if (layer_norm_coefficients != nullptr) {
+    tensor_utils::MeanStddevNormalization(gate, gate, n_cell, /*n_batch=*/1);
+    tensor_utils::VectorBatchVectorCwiseProduct(layer_norm_coefficients, n_cell,
+                                                gate, /*n_batch=*/1, gate);
+    tensor_utils::VectorBatchVectorAdd(gate_bias, n_cell, /*n_batch=*/1, gate);
+  }
+  tensor_utils::ApplyActivationToVector(gate, n_cell, activation, gate);
+}
+
+// Same as LstmStepFloat for a single batch, with the weights packed by
+// PackFusedWeights(). The gates are computed by a single matrix multiplication
+// into the gate scratch buffers, which must be contiguous and in the order of
+// the packed weights.
+inline void LstmStepFloatFused(
+    const float* input_ptr, float* fused_weights_ptr,
+    const float* cell_to_input_weights_ptr,
+    const float* cell_to_forget_weights_ptr,
+    const float* cell_to_output_weights_ptr,
+    const float* input_layer_norm_coefficients_ptr,
+    const float* forget_layer_norm_coefficients_ptr,
+    const float* cell_layer_norm_coefficients_ptr,
+    const float* output_layer_norm_coefficients_ptr,
+    const float* input_gate_bias_ptr, const float* forget_gate_bias_ptr,
+    const float* cell_gate_bias_ptr, const float* output_gate_bias_ptr,
+    const float* projection_weights_ptr, const float* projection_bias_ptr,
+    const TfLiteLSTMParams* params, bool use_cifg, int n_cell, int n_input,
+    int n_output, float* output_state_ptr, float* cell_state_ptr,
+    float* input_gate_scratch, float* forget_gate_scratch,
+    float* cell_gate_scratch, float* output_gate_scratch,
+    float* accumulation_scratch_buffer, float* output_ptr,
+    CpuBackendContext* context) {
+  ruy::profiler::ScopeLabel label("LstmStepFloatFused");
+  const int n_gates = use_cifg ? 3 : 4;
+  const int n_cols = n_input + n_output;
+  const float* bias = fused_weights_ptr + n_gates * n_cell * n_cols;
+  float* step_input = fused_weights_ptr + n_gates * n_cell * (n_cols + 1);
+  std::copy_n(input_ptr, n_input, step_input);
+  std::copy_n(output_state_ptr, n_output, step_input + n_input);
+  MatrixBatchVectorMultiplyAccumulate(
+      fused_weights_ptr, step_input, bias,
+      use_cifg ? cell_gate_scratch : input_gate_scratch, n_gates * n_cell,
+      n_cols, /*n_batch=*/1, context);
+
+  if (!use_cifg) {
+    FinishLstmGateFloat(cell_state_ptr, cell_to_input_weights_ptr,
+                        input_layer_norm_coefficients_ptr, input_gate_bias_ptr,
+                        n_cell, kTfLiteActSigmoid, input_gate_scratch);
+  }
+  FinishLstmGateFloat(cell_state_ptr, cell_to_forget_weights_ptr,
+                      forget_layer_norm_coefficients_ptr, forget_gate_bias_ptr,
+                      n_cell, kTfLiteActSigmoid, forget_gate_scratch);
+  FinishLstmGateFloat(/*cell_state=*/nullptr, /*cell_to_gate_weights=*/nullptr,
+                      cell_layer_norm_coefficients_ptr, cell_gate_bias_ptr,
+                      n_cell, params->activation, cell_gate_scratch);
+  UpdateLstmCellFloat(/*n_batch=*/1, n_cell, cell_state_ptr, input_gate_scratch,
+                      forget_gate_scratch, cell_gate_scratch, use_cifg,
+                      params->cell_clip);
+  FinishLstmGateFloat(cell_state_ptr, cell_to_output_weights_ptr,
+                      output_layer_norm_coefficients_ptr, output_gate_bias_ptr,
+                      n_cell, kTfLiteActSigmoid, output_gate_scratch);
+  CalculateLstmOutputFloat(/*n_batch=*/1, n_cell, n_output, cell_state_ptr,
+                           output_gate_scratch, params->activation,
+                           projection_weights_ptr, projection_bias_ptr,
+                           params->proj_clip, output_state_ptr,
+                           cell_gate_scratch, accumulation_scratch_buffer,
+                           context);
+  std::copy_n(output_state_ptr, n_output, output_ptr);
+}
+
 // Same as above but with quantized weight matrices. In detail:
 // Input of size 'n_batch * n_input':
 //   input_ptr
@@ -1819,7 +1944,8 @@ TfLiteStatus EvalFloat(
     TfLiteTensor* cell_state, TfLiteTensor* output,
     bool recurrent_to_input_is_diag, bool recurrent_to_forget_is_diag,
     bool recurrent_to_cell_is_diag, bool recurrent_to_output_is_diag,
-    CpuBackendContext* context) {
+    CpuBackendContext* context, TfLiteTensor* fused_weights,
+    bool* pack_fused_weights) {
   TF_LITE_ASSERT(input->dims->size >= 2 && input->dims->size <= 3);
 
   int max_time, n_batch;
@@ -1866,7 +1992,61 @@ TfLiteStatus EvalFloat(
 
   const int output_batch_leading_dim =
       output->dims->data[output->dims->size - 1];
-  if (time_major) {
+
+  // The gate scratch buffers of a step are only contiguous with one batch.
+  const bool use_fused_weights =
+      fused_weights != nullptr && n_batch == 1 && aux_input == nullptr;
+  if (use_fused_weights && *pack_fused_weights) {
+    PackFusedWeights(GetTensorData<float>(input_to_input_weights),
+                     GetTensorData<float>(input_to_forget_weights),
+                     GetTensorData<float>(input_to_cell_weights),
+                     GetTensorData<float>(input_to_output_weights),
+                     GetTensorData<float>(recurrent_to_input_weights),
+                     GetTensorData<float>(recurrent_to_forget_weights),
+                     GetTensorData<float>(recurrent_to_cell_weights),
+                     GetTensorData<float>(recurrent_to_output_weights),
+                     GetTensorData<float>(input_gate_bias),
+                     GetTensorData<float>(forget_gate_bias),
+                     GetTensorData<float>(cell_gate_bias),
+                     GetTensorData<float>(output_gate_bias),
+                     /*use_layer_norm=*/forget_layer_norm_coefficients !=
+                         nullptr,
+                     n_cell, n_input, n_output,
+                     GetTensorData<float>(fused_weights));
+    *pack_fused_weights = false;
+  }
+
+  if (use_fused_weights) {
+    const int input_step = n_input;
+    const int output_step = output_batch_leading_dim;
+    for (int t = 0; t < max_time; t++) {
+      // If this is the forward_sequence, step forward, otherwise step
+      // backwards.
+      const int t_rel = forward_sequence ? t : max_time - t - 1;
+      LstmStepFloatFused(
+          GetTensorData<float>(input) + t_rel * input_step,
+          GetTensorData<float>(fused_weights),
+          GetTensorData<float>(cell_to_input_weights),
+          GetTensorData<float>(cell_to_forget_weights),
+          GetTensorData<float>(cell_to_output_weights),
+          GetTensorData<float>(input_layer_norm_coefficients),
+          GetTensorData<float>(forget_layer_norm_coefficients),
+          GetTensorData<float>(cell_layer_norm_coefficients),
+          GetTensorData<float>(output_layer_norm_coefficients),
+          GetTensorData<float>(input_gate_bias),
+          GetTensorData<float>(forget_gate_bias),
+          GetTensorData<float>(cell_gate_bias),
+          GetTensorData<float>(output_gate_bias),
+          GetTensorData<float>(projection_weights),
+          GetTensorData<float>(projection_bias), params, use_cifg, n_cell,
+          n_input, n_output, GetTensorData<float>(output_state),
+          GetTensorData<float>(cell_state), input_gate_scratch,
+          forget_gate_scratch, cell_gate_scratch, output_gate_scratch,
+          accumulation_scratch_buffer,
+          GetTensorData<float>(output) + t_rel * output_step + output_offset,
+          context);
+    }
+  } else if (time_major) {
     // Loop through the sequence.
     const int input_step = n_batch * n_input;
     const int output_step = n_batch * output_batch_leading_dim;
@@ -1984,6 +2164,13 @@ TfLiteStatus EvalFloat(
 }
 // LINT.ThenChange(//tensorflow/lite/tools/optimize/calibration/builtin_logging_ops/lstm.cc)
 
+int GetFusedWeightsSize(bool use_cifg, int n_cell, int n_input, int n_output) {
+  const int n_gates = use_cifg ? 3 : 4;
+  const int n_cols = n_input + n_output;
+  // The weights, the biases and the input of a step.
+  return n_gates * n_cell * n_cols + n_gates * n_cell + n_cols;
+}
+
 TfLiteStatus EvalHybrid(
     const TfLiteTensor* input, const TfLiteTensor* input_to_input_weights,
     const TfLiteTensor* input_to_input_weights_ledger,
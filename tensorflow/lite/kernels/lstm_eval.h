@@ -124,7 +124,16 @@ TfLiteStatus EvalFloat(
     TfLiteTensor* cell_state, TfLiteTensor* output,
     bool recurrent_to_input_is_diag, bool recurrent_to_forget_is_diag,
     bool recurrent_to_cell_is_diag, bool recurrent_to_output_is_diag,
-    CpuBackendContext* context);
+    CpuBackendContext* context, TfLiteTensor* fused_weights = nullptr,
+    bool* pack_fused_weights = nullptr);
+
+// Returns the number of floats of the `fused_weights` of EvalFloat, which
+// packs the input and recurrent weights and the biases of all the gates into a
+// single matrix so that each step of a single batch runs one matrix
+// multiplication. The weights and biases must be constant and the recurrent
+// weights must not be diagonal. The weights are packed when
+// `*pack_fused_weights` is true, which is then reset.
+int GetFusedWeightsSize(bool use_cifg, int n_cell, int n_input, int n_output);
 
 TfLiteStatus EvalHybrid(
     const TfLiteTensor* input, const TfLiteTensor* input_to_input_weights,
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/lite/experimental/resource/resource_variable.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/variable_update_util.h"
 
 namespace tflite {
 namespace ops {
@@ -30,6 +31,19 @@ namespace read_variable {
 constexpr int kInputVariableId = 0;
 constexpr int kOutputValue = 0;
 
+struct OpData {
+  // See FindInPlaceVariableUpdate().
+  int in_place_update_resource_id = -1;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  return new OpData();
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  delete reinterpret_cast<OpData*>(buffer);
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, node->inputs->size, 1);
   TF_LITE_ENSURE_EQ(context, node->outputs->size, 1);
@@ -52,6 +66,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     SetTensorToDynamic(output);
   }
 
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  op_data->in_place_update_resource_id =
+      FindInPlaceVariableUpdate(context, node);
+
   return kTfLiteOk;
 }
 
@@ -78,6 +96,12 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
                                    context, output,
                                    TfLiteIntArrayCopy(variable_tensor->dims)));
   }
+  // DYNAMIC_UPDATE_SLICE updates the variable without reading the output.
+  const OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  if (op_data->in_place_update_resource_id >= 0 &&
+      GetInPlaceUpdatableVariable(context, input_resource_id_tensor, output)) {
+    return kTfLiteOk;
+  }
   memcpy(output->data.raw, variable_tensor->data.raw, output->bytes);
 
   return kTfLiteOk;
@@ -86,8 +110,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace read_variable
 
 TfLiteRegistration* Register_READ_VARIABLE() {
-  static TfLiteRegistration r = {nullptr, nullptr, read_variable::Prepare,
-                                 read_variable::Eval};
+  static TfLiteRegistration r = {read_variable::Init, read_variable::Free,
+                                 read_variable::Prepare, read_variable::Eval};
   return &r;
 }
 
@@ -42,6 +42,11 @@ struct OpData {
   // The scratch tensor index.
   int scratch_tensor_index;
   bool compute_row_sums = false;
+  // The tensor into which the float kernel packs the constant input and
+  // recurrent weights of all the gates, see lstm_eval::GetFusedWeightsSize().
+  int fused_weights_index;
+  bool use_fused_weights = false;
+  bool pack_fused_weights = false;
 
   bool recurrent_to_input_is_diag = false;
   bool recurrent_to_forget_is_diag = false;
@@ -388,6 +393,40 @@ TfLiteStatus PopulateQuantizedLstmParams8x8_16(
   return kTfLiteOk;
 }
 
+// Returns true if the input and recurrent weights and the gate biases are
+// constant and the recurrent weights are full matrices, so that the float
+// kernel can pack them once for all the gates.
+bool CanUseFusedWeights(TfLiteContext* context, TfLiteNode* node) {
+  const int kPackedTensors[] = {
+      lstm::full::kInputToInputWeightsTensor,
+      lstm::full::kInputToForgetWeightsTensor,
+      lstm::full::kInputToCellWeightsTensor,
+      lstm::full::kInputToOutputWeightsTensor,
+      lstm::full::kRecurrentToInputWeightsTensor,
+      lstm::full::kRecurrentToForgetWeightsTensor,
+      lstm::full::kRecurrentToCellWeightsTensor,
+      lstm::full::kRecurrentToOutputWeightsTensor,
+      lstm::full::kInputGateBiasTensor,
+      lstm::full::kForgetGateBiasTensor,
+      lstm::full::kCellGateBiasTensor,
+      lstm::full::kOutputGateBiasTensor,
+  };
+  for (const int index : kPackedTensors) {
+    const TfLiteTensor* tensor = GetOptionalInputTensor(context, node, index);
+    // The input gate tensors are missing with CIFG.
+    if (tensor == nullptr) continue;
+    if (!IsConstantTensor(tensor)) return false;
+  }
+  for (const int index : {lstm::full::kRecurrentToInputWeightsTensor,
+                          lstm::full::kRecurrentToForgetWeightsTensor,
+                          lstm::full::kRecurrentToCellWeightsTensor,
+                          lstm::full::kRecurrentToOutputWeightsTensor}) {
+    const TfLiteTensor* tensor = GetOptionalInputTensor(context, node, index);
+    if (tensor != nullptr && tensor->dims->size != 2) return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 // Temporary tensors
@@ -407,10 +446,14 @@ enum TemporaryTensor {
   kNumTemporaryTensors = 12,
 };
 
+// The float kernel only uses the scratch buffer and the fused weights.
+constexpr int kFusedWeights = 1;
+
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   auto* op_data = new OpData();
   context->AddTensors(context, kNumTemporaryTensors,
                       &op_data->scratch_tensor_index);
+  context->AddTensors(context, 1, &op_data->fused_weights_index);
   return op_data;
 }
 
@@ -984,11 +1027,17 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     TF_LITE_ENSURE(context, num_intermediate_tensors == 5);
   }
 
+  op_data->use_fused_weights =
+      input_to_output_weights->type == kTfLiteFloat32 && n_batch == 1 &&
+      CanUseFusedWeights(context, node);
+
   TfLiteIntArrayFree(node->temporaries);
   if (IsHybridOp(input, input_to_output_weights)) {
     node->temporaries = TfLiteIntArrayCreate(kNumTemporaryTensors);
   } else if (is_integer) {
     node->temporaries = TfLiteIntArrayCreate(6);
+  } else if (op_data->use_fused_weights) {
+    node->temporaries = TfLiteIntArrayCreate(2);
   } else {
     node->temporaries = TfLiteIntArrayCreate(1);
   }
@@ -1019,6 +1068,25 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, scratch_buffer,
                                                    scratch_buffer_size));
 
+  if (op_data->use_fused_weights) {
+    node->temporaries->data[kFusedWeights] = op_data->fused_weights_index;
+    TfLiteTensor* fused_weights;
+    TF_LITE_ENSURE_OK(context, GetTemporarySafe(context, node, kFusedWeights,
+                                                &fused_weights));
+    fused_weights->type = kTfLiteFloat32;
+    fused_weights->allocation_type = kTfLiteArenaRwPersistent;
+    const int fused_weights_dims[1] = {
+        lstm_eval::GetFusedWeightsSize(use_cifg, n_cell, n_input, n_output)};
+    if (!TfLiteIntArrayEqualsArray(fused_weights->dims, 1,
+                                   fused_weights_dims)) {
+      TfLiteIntArray* fused_weights_size = TfLiteIntArrayCreate(1);
+      fused_weights_size->data[0] = fused_weights_dims[0];
+      TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, fused_weights,
+                                                       fused_weights_size));
+    }
+    op_data->pack_fused_weights = true;
+  }
+
   if (IsHybridOp(input, input_to_output_weights)) {
     op_data->compute_row_sums = true;
     // Allocate temporary tensors to store quantized values of input,
@@ -1366,6 +1434,12 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       TfLiteTensor* scratch_buffer;
       TF_LITE_ENSURE_OK(context, GetTemporarySafe(context, node, kScratchBuffer,
                                                   &scratch_buffer));
+      TfLiteTensor* fused_weights = nullptr;
+      if (op_data->use_fused_weights) {
+        TF_LITE_ENSURE_OK(context, GetTemporarySafe(context, node,
+                                                    kFusedWeights,
+                                                    &fused_weights));
+      }
       return lstm_eval::EvalFloat(
           input, input_to_input_weights, input_to_forget_weights,
           input_to_cell_weights, input_to_output_weights,
@@ -1392,7 +1466,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
           (recurrent_to_cell_weights->dims->size == 1),
           /*recurrent_to_output_is_diag=*/
           (recurrent_to_output_weights->dims->size == 1),
-          CpuBackendContext::GetFromContext(context));
+          CpuBackendContext::GetFromContext(context), fused_weights,
+          &op_data->pack_fused_weights);
     }
     case kTfLiteUInt8:
     case kTfLiteInt8: {
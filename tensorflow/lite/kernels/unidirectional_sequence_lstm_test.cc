@@ -30,6 +30,66 @@ namespace {
 
 using ::testing::ElementsAreArray;
 
+// A float model whose weights and biases are constant, so that the kernel
+// packs the weights of all the gates once.
+class ConstWeightsUnidirectionalLSTMOpModel : public SingleOpModel {
+ public:
+  // `weights` holds the tensors between the input and the output state, in
+  // the order of the inputs of the op. Empty ones are optional tensors.
+  ConstWeightsUnidirectionalLSTMOpModel(
+      int n_batch, int n_input, int n_cell, int n_output, int sequence_length,
+      bool time_major, const std::vector<std::vector<float>>& weights)
+      : n_input_(n_input), n_output_(n_output) {
+    input_ = AddInput(TensorType_FLOAT32);
+    const std::vector<std::vector<int>> weights_shapes = {
+        {n_cell, n_input},  {n_cell, n_input},  {n_cell, n_input},
+        {n_cell, n_input},  {n_cell, n_output}, {n_cell, n_output},
+        {n_cell, n_output}, {n_cell, n_output}, {n_cell},
+        {n_cell},           {n_cell},           {n_cell},
+        {n_cell},           {n_cell},           {n_cell},
+        {n_output, n_cell}, {n_output},
+    };
+    for (int i = 0; i < weights_shapes.size(); ++i) {
+      if (weights[i].empty()) {
+        AddNullInput();
+      } else {
+        AddConstInput(TensorData{TensorType_FLOAT32, weights_shapes[i]},
+                      weights[i]);
+      }
+    }
+    AddVariableInput(TensorData{TensorType_FLOAT32, {n_output * n_batch}});
+    AddVariableInput(TensorData{TensorType_FLOAT32, {n_cell * n_batch}});
+    output_ = AddOutput(TensorType_FLOAT32);
+
+    SetBuiltinOp(BuiltinOperator_UNIDIRECTIONAL_SEQUENCE_LSTM,
+                 BuiltinOptions_UnidirectionalSequenceLSTMOptions,
+                 CreateUnidirectionalSequenceLSTMOptions(
+                     builder_, ActivationFunctionType_TANH, /*cell_clip=*/0.0,
+                     /*proj_clip=*/0.0, time_major)
+                     .Union());
+    BuildInterpreter({time_major
+                          ? std::vector<int>{sequence_length, n_batch, n_input}
+                          : std::vector<int>{n_batch, sequence_length,
+                                             n_input}});
+  }
+
+  void SetInput(int offset, const float* begin, const float* end) {
+    PopulateTensor(input_, offset, const_cast<float*>(begin),
+                   const_cast<float*>(end));
+  }
+
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+
+  int num_inputs() { return n_input_; }
+  int num_outputs() { return n_output_; }
+
+ private:
+  int input_;
+  int output_;
+  int n_input_;
+  int n_output_;
+};
+
 class BaseUnidirectionalLstmTest : public ::testing::TestWithParam<bool> {
  protected:
   // Weights of the LSTM model. Some are optional.
@@ -56,10 +116,24 @@ class BaseUnidirectionalLstmTest : public ::testing::TestWithParam<bool> {
   // LSTM output is stored as num_batch x num_outputs vector.
   std::vector<std::vector<float>> lstm_golden_output_;
 
+  // Returns the weights and biases in the order of the inputs of the op.
+  std::vector<std::vector<float>> GetWeights() const {
+    return {input_to_input_weights_,      input_to_forget_weights_,
+            input_to_cell_weights_,       input_to_output_weights_,
+            recurrent_to_input_weights_,  recurrent_to_forget_weights_,
+            recurrent_to_cell_weights_,   recurrent_to_output_weights_,
+            cell_to_input_weights_,       cell_to_forget_weights_,
+            cell_to_output_weights_,      input_gate_bias_,
+            forget_gate_bias_,            cell_gate_bias_,
+            output_gate_bias_,            projection_weights_,
+            projection_bias_};
+  }
+
   // Compares output up to tolerance to the result of the lstm given the input.
+  template <typename OpModel>
   void VerifyGoldens(const std::vector<std::vector<float>>& input,
                      const std::vector<std::vector<float>>& output,
-                     UnidirectionalLSTMOpModel* lstm, float tolerance = 1e-5,
+                     OpModel* lstm, float tolerance = 1e-5,
                      bool time_major = true) {
     const int num_batches = input.size();
     EXPECT_GT(num_batches, 0);
@@ -422,6 +496,25 @@ TEST_P(NoCifgNoPeepholeNoProjectionNoClippingUnidirectionalLstmTest,
                 /*tolerance=*/0.0157651);
 }
 
+TEST_F(NoCifgNoPeepholeNoProjectionNoClippingUnidirectionalLstmTest,
+       LstmBlackBoxTestConstWeights) {
+  ConstWeightsUnidirectionalLSTMOpModel lstm(
+      /*n_batch=*/1, /*n_input=*/2, /*n_cell=*/4, /*n_output=*/4,
+      /*sequence_length=*/3, /*time_major=*/true, GetWeights());
+
+  VerifyGoldens(lstm_input_, lstm_golden_output_, &lstm);
+}
+
+TEST_F(NoCifgNoPeepholeNoProjectionNoClippingUnidirectionalLstmTest,
+       LstmBlackBoxTestConstWeightsBatchMajor) {
+  ConstWeightsUnidirectionalLSTMOpModel lstm(
+      /*n_batch=*/1, /*n_input=*/2, /*n_cell=*/4, /*n_output=*/4,
+      /*sequence_length=*/3, /*time_major=*/false, GetWeights());
+
+  VerifyGoldens(lstm_input_, lstm_golden_output_, &lstm, /*tolerance=*/1e-5,
+                /*time_major=*/false);
+}
+
 class CifgPeepholeNoProjectionNoClippingUnidirectionalLstmTest
     : public BaseUnidirectionalLstmTest {
   void SetUp() override {
@@ -532,6 +625,15 @@ TEST_F(CifgPeepholeNoProjectionNoClippingUnidirectionalLstmTest,
   VerifyGoldens(lstm_input_, lstm_golden_output_, &lstm);
 }
 
+TEST_F(CifgPeepholeNoProjectionNoClippingUnidirectionalLstmTest,
+       LstmBlackBoxTestConstWeights) {
+  ConstWeightsUnidirectionalLSTMOpModel lstm(
+      /*n_batch=*/1, /*n_input=*/2, /*n_cell=*/4, /*n_output=*/4,
+      /*sequence_length=*/3, /*time_major=*/true, GetWeights());
+
+  VerifyGoldens(lstm_input_, lstm_golden_output_, &lstm);
+}
+
 TEST_P(CifgPeepholeNoProjectionNoClippingUnidirectionalLstmTest,
        HybridLstmBlackBoxTestUint8) {
   const int n_batch = 1;
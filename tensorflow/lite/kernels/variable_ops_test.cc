@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 #include "flatbuffers/flexbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/core/c/builtin_op_data.h"
 #include "tensorflow/lite/core/interpreter.h"
 #include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
@@ -140,6 +141,79 @@ class VariableOpsTest : public ::testing::Test {
                                         read_registration_, &node_index);
   }
 
+  // Constructs a graph updating a slice of a variable:
+  //   Input: %0, %1, %2
+  //   Output: %6, and %4 if `read_value_is_output`
+  //   %3 = var_handle()
+  //   variable_assign(%3, %0)
+  //   %4 = read(%3)
+  //   %5 = dynamic_update_slice(%4, %1, %2)
+  //   variable_assign(%3, %5)
+  //   %6 = read(%3)
+  // The update is done in place unless %4 has another use.
+  void ConstructSliceUpdateGraph(bool read_value_is_output) {
+    interpreter_ = std::make_unique<Interpreter>();
+    // Only registrations with builtin codes take part in in-place updates.
+    TfLiteRegistration assign = *assign_registration_;
+    assign.builtin_code = kTfLiteBuiltinAssignVariable;
+    TfLiteRegistration read = *read_registration_;
+    read.builtin_code = kTfLiteBuiltinReadVariable;
+    TfLiteRegistration update =
+        *::tflite::ops::builtin::Register_DYNAMIC_UPDATE_SLICE();
+    update.builtin_code = kTfLiteBuiltinDynamicUpdateSlice;
+
+    int first_new_tensor_index;
+    ASSERT_EQ(interpreter_->AddTensors(7, &first_new_tensor_index), kTfLiteOk);
+    ASSERT_EQ(interpreter_->SetInputs({0, 1, 2}), kTfLiteOk);
+    if (read_value_is_output) {
+      ASSERT_EQ(interpreter_->SetOutputs({6, 4}), kTfLiteOk);
+    } else {
+      ASSERT_EQ(interpreter_->SetOutputs({6}), kTfLiteOk);
+    }
+    for (int i : {0, 4, 5, 6}) {
+      interpreter_->SetTensorParametersReadWrite(i, kTfLiteFloat32, "", {4},
+                                                 TfLiteQuantization());
+    }
+    interpreter_->SetTensorParametersReadWrite(1, kTfLiteFloat32, "", {1},
+                                               TfLiteQuantization());
+    interpreter_->SetTensorParametersReadWrite(2, kTfLiteInt32, "", {1},
+                                               TfLiteQuantization());
+    interpreter_->SetTensorParametersReadWrite(3, kTfLiteResource, "", 0,
+                                               nullptr, {}, false);
+    int node_index;
+
+    TfLiteVarHandleParams* var_handle_params = GetVarHandleParams();
+    interpreter_->AddNodeWithParameters({}, {3}, nullptr, 0, var_handle_params,
+                                        var_handle_registration_, &node_index);
+    interpreter_->AddNodeWithParameters({3, 0}, {}, nullptr, 0, nullptr,
+                                        &assign, &node_index);
+    interpreter_->AddNodeWithParameters({3}, {4}, nullptr, 0, nullptr, &read,
+                                        &node_index);
+    interpreter_->AddNodeWithParameters({4, 1, 2}, {5}, nullptr, 0, nullptr,
+                                        &update, &node_index);
+    interpreter_->AddNodeWithParameters({3, 5}, {}, nullptr, 0, nullptr,
+                                        &assign, &node_index);
+    interpreter_->AddNodeWithParameters({3}, {6}, nullptr, 0, nullptr, &read,
+                                        &node_index);
+  }
+
+  // Runs the graph of ConstructSliceUpdateGraph() and checks its result.
+  void CheckSliceUpdate() {
+    ASSERT_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+    for (int start : {2, 0, 3}) {
+      float* value = GetTensorData<float>(interpreter_->tensor(0));
+      for (int i = 0; i < 4; ++i) value[i] = i + 1;
+      GetTensorData<float>(interpreter_->tensor(1))[0] = 10;
+      GetTensorData<int32_t>(interpreter_->tensor(2))[0] = start;
+      ASSERT_EQ(interpreter_->Invoke(), kTfLiteOk);
+
+      const float* output = GetTensorData<float>(interpreter_->tensor(6));
+      for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(output[i], i == start ? 10 : i + 1);
+      }
+    }
+  }
+
   TfLiteRegistration* assign_registration_;
   TfLiteRegistration* read_registration_;
   TfLiteRegistration* var_handle_registration_;
@@ -221,5 +295,21 @@ TEST_F(VariableOpsTest, TestReassignToDifferentSize) {
   }
 }
 
+TEST_F(VariableOpsTest, TestUpdateVariableSliceInPlace) {
+  ConstructSliceUpdateGraph(/*read_value_is_output=*/false);
+  CheckSliceUpdate();
+}
+
+TEST_F(VariableOpsTest, TestUpdateVariableSliceWithOtherUse) {
+  ConstructSliceUpdateGraph(/*read_value_is_output=*/true);
+  CheckSliceUpdate();
+
+  // The value read before the update is unchanged.
+  const float* value = GetTensorData<float>(interpreter_->tensor(4));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(value[i], i + 1);
+  }
+}
+
 }  // namespace
 }  // namespace tflite
@@ -0,0 +1,171 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/kernels/variable_update_util.h"
+
+#include <vector>
+
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/experimental/resource/resource_variable.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+
+namespace tflite {
+namespace ops {
+namespace builtin {
+namespace {
+
+const TfLiteNode& GetNode(const Subgraph& subgraph, int plan_index) {
+  return subgraph.node_and_registration(subgraph.execution_plan()[plan_index])
+      ->first;
+}
+
+int GetBuiltinCode(const Subgraph& subgraph, int plan_index) {
+  return subgraph.node_and_registration(subgraph.execution_plan()[plan_index])
+      ->second.builtin_code;
+}
+
+// Returns the execution plan index of `node`, or -1.
+int GetPlanIndex(const Subgraph& subgraph, const TfLiteNode* node) {
+  const std::vector<int>& plan = subgraph.execution_plan();
+  for (int i = 0; i < plan.size(); ++i) {
+    if (&GetNode(subgraph, i) == node) return i;
+  }
+  return -1;
+}
+
+// Returns the execution plan index of the node producing `tensor`, or -1.
+int GetProducer(const Subgraph& subgraph, int tensor) {
+  const std::vector<int>& plan = subgraph.execution_plan();
+  for (int i = 0; i < plan.size(); ++i) {
+    const TfLiteIntArray* outputs = GetNode(subgraph, i).outputs;
+    for (int j = 0; j < outputs->size; ++j) {
+      if (outputs->data[j] == tensor) return i;
+    }
+  }
+  return -1;
+}
+
+// Returns the execution plan index of the only use of `tensor`, or -1 if it
+// has no use, several ones or is an output of the subgraph.
+int GetOnlyConsumer(const Subgraph& subgraph, int tensor) {
+  for (int output : subgraph.outputs()) {
+    if (output == tensor) return -1;
+  }
+  int consumer = -1;
+  const std::vector<int>& plan = subgraph.execution_plan();
+  for (int i = 0; i < plan.size(); ++i) {
+    const TfLiteIntArray* inputs = GetNode(subgraph, i).inputs;
+    for (int j = 0; j < inputs->size; ++j) {
+      if (inputs->data[j] != tensor) continue;
+      if (consumer != -1) return -1;
+      consumer = i;
+    }
+  }
+  return consumer;
+}
+
+// Returns true if the op may read or write variables, directly or by running
+// other subgraphs.
+bool MayAccessVariables(int builtin_code) {
+  switch (builtin_code) {
+    case kTfLiteBuiltinReadVariable:
+    case kTfLiteBuiltinAssignVariable:
+    case kTfLiteBuiltinCallOnce:
+    case kTfLiteBuiltinIf:
+    case kTfLiteBuiltinWhile:
+    case kTfLiteBuiltinStablehloWhile:
+    case kTfLiteBuiltinCustom:
+    case kTfLiteBuiltinDelegate:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+int FindInPlaceVariableUpdate(TfLiteContext* context, const TfLiteNode* node) {
+  const Subgraph& subgraph = *reinterpret_cast<Subgraph*>(context->impl_);
+  const int index = GetPlanIndex(subgraph, node);
+  if (index < 0) return -1;
+
+  int update_index = -1;
+  switch (GetBuiltinCode(subgraph, index)) {
+    case kTfLiteBuiltinReadVariable:
+      update_index = GetOnlyConsumer(subgraph, node->outputs->data[0]);
+      break;
+    case kTfLiteBuiltinDynamicUpdateSlice:
+      update_index = index;
+      break;
+    case kTfLiteBuiltinAssignVariable:
+      update_index = GetProducer(subgraph, node->inputs->data[1]);
+      break;
+    default:
+      return -1;
+  }
+  if (update_index < 0 || GetBuiltinCode(subgraph, update_index) !=
+                              kTfLiteBuiltinDynamicUpdateSlice) {
+    return -1;
+  }
+  const TfLiteNode& update = GetNode(subgraph, update_index);
+  const int value = update.inputs->data[0];
+  const int updated = update.outputs->data[0];
+  const int read_index = GetProducer(subgraph, value);
+  const int assign_index = GetOnlyConsumer(subgraph, updated);
+  if (read_index < 0 || assign_index < 0 ||
+      GetBuiltinCode(subgraph, read_index) != kTfLiteBuiltinReadVariable ||
+      GetBuiltinCode(subgraph, assign_index) != kTfLiteBuiltinAssignVariable ||
+      GetOnlyConsumer(subgraph, value) != update_index) {
+    return -1;
+  }
+  const int resource_id = GetNode(subgraph, read_index).inputs->data[0];
+  const TfLiteNode& assign = GetNode(subgraph, assign_index);
+  if (assign.inputs->data[0] != resource_id ||
+      assign.inputs->data[1] != updated) {
+    return -1;
+  }
+  // Dynamic tensors get their shape at run time, after this was decided.
+  if (IsDynamicTensor(&context->tensors[value]) ||
+      IsDynamicTensor(&context->tensors[updated])) {
+    return -1;
+  }
+  if (read_index > update_index || update_index > assign_index) return -1;
+  for (int i = read_index + 1; i < assign_index; ++i) {
+    if (i != update_index && MayAccessVariables(GetBuiltinCode(subgraph, i))) {
+      return -1;
+    }
+  }
+  return resource_id;
+}
+
+resource::ResourceVariable* GetInPlaceUpdatableVariable(
+    TfLiteContext* context, const TfLiteTensor* resource_id,
+    const TfLiteTensor* value) {
+  Subgraph* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  auto* variable = resource::GetResourceVariable(&subgraph->resources(),
+                                                 resource_id->data.i32[0]);
+  if (variable == nullptr) return nullptr;
+  const TfLiteTensor* tensor = variable->GetTensor();
+  if (tensor == nullptr || tensor->type != value->type ||
+      !TfLiteIntArrayEqual(tensor->dims, value->dims)) {
+    return nullptr;
+  }
+  return variable;
+}
+
+}  // namespace builtin
+}  // namespace ops
+}  // namespace tflite
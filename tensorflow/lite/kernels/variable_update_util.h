@@ -0,0 +1,53 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_KERNELS_VARIABLE_UPDATE_UTIL_H_
+#define TENSORFLOW_LITE_KERNELS_VARIABLE_UPDATE_UTIL_H_
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/experimental/resource/resource_variable.h"
+
+namespace tflite {
+namespace ops {
+namespace builtin {
+
+// Returns whether `node` is part of an update of a slice of a variable
+//
+//   %value = READ_VARIABLE(%resource_id)
+//   %updated = DYNAMIC_UPDATE_SLICE(%value, %update, %start_indices)
+//   ASSIGN_VARIABLE(%resource_id, %updated)
+//
+// that can be done in place: %value and %updated are static tensors with no
+// other uses and no other op that may access variables runs in between. The
+// update is then written directly into the buffer of the variable, and
+// READ_VARIABLE and ASSIGN_VARIABLE don't copy the whole variable, so that
+// appending to e.g. the KV cache of a decoder costs the same for any cache
+// size.
+//
+// Returns the index of the %resource_id tensor, or -1 if `node` isn't part of
+// such an update.
+int FindInPlaceVariableUpdate(TfLiteContext* context, const TfLiteNode* node);
+
+// Returns the variable of an update found by FindInPlaceVariableUpdate() if it
+// can be updated in place at this time, i.e. it is initialized with the type
+// and shape of `value`, or nullptr if the ops must fall back to copies.
+resource::ResourceVariable* GetInPlaceUpdatableVariable(
+    TfLiteContext* context, const TfLiteTensor* resource_id,
+    const TfLiteTensor* value);
+
+}  // namespace builtin
+}  // namespace ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_VARIABLE_UPDATE_UTIL_H_
@@ -15,6 +15,8 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MEMORY_PLANNER_H_
 #define TENSORFLOW_LITE_MEMORY_PLANNER_H_
 
+#include <cstddef>
+#include <string>
 #include <vector>
 
 #include "tensorflow/lite/core/c/common.h"
@@ -44,6 +46,16 @@ class MemoryPlanner {
   // Invalidates allocations after the given node execution.
   virtual TfLiteStatus ResetAllocationsAfter(int node) = 0;
 
+  // Declares that the nodes within each stage of the execution plan may be
+  // executed concurrently. Stage `i` covers the nodes in
+  // [stage_ends[i - 1], stage_ends[i]), the first one starting at node 0.
+  // Tensors used by nodes of the same stage must then never share memory.
+  // Planners that can't honor this return an error, in which case nodes must
+  // be executed one after the other. Invalidates allocations made earlier.
+  virtual TfLiteStatus SetConcurrentStages(const std::vector<int>& stage_ends) {
+    return kTfLiteError;
+  }
+
   // NOTE: The following two methods modify the data pointers for all tensors on
   // the non-persistent arena (inputs, outputs, intermediates). If the user has
   // manually set the pointers for any of these, they would need to be set
@@ -69,6 +81,17 @@ class MemoryPlanner {
   // Returns a map of allocation information. It's only used for debugging.
   virtual void GetAllocInfo(size_t *arena_size,
                             size_t *arena_persist_size) const = 0;
+
+  // Serializes the memory plans computed so far, e.g. to store them in the
+  // model metadata. Returns an empty string if the planner doesn't support it.
+  virtual std::string SerializePlans() const { return ""; }
+
+  // Restores plans serialized by SerializePlans() for the same graph, so that
+  // they don't have to be computed again when the tensor sizes match. Must be
+  // called after PlanAllocations(), which discards them.
+  virtual TfLiteStatus RestorePlans(const char* data, size_t size) {
+    return kTfLiteError;
+  }
 };
 
 }  // namespace tflite
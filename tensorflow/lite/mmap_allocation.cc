@@ -129,6 +129,26 @@ size_t MMAPAllocation::bytes() const { return buffer_size_bytes_; }
 
 bool MMAPAllocation::valid() const { return mmapped_buffer_ != MAP_FAILED; }
 
+bool MMAPAllocation::Prefetch(size_t offset, size_t length) const {
+  if (!valid() || length == 0 || offset > buffer_size_bytes_ ||
+      length > buffer_size_bytes_ - offset) {
+    return false;
+  }
+#ifdef __ANDROID__
+  static int pagesize = getpagesize();
+#else
+  static int pagesize = sysconf(_SC_PAGE_SIZE);
+#endif
+  // madvise() requires a page-aligned address, and the mapping starts at a
+  // page boundary.
+  const size_t begin = offset_in_buffer_ + offset;
+  const size_t aligned_begin = begin - begin % pagesize;
+  char* address =
+      const_cast<char*>(reinterpret_cast<const char*>(mmapped_buffer_)) +
+      aligned_begin;
+  return madvise(address, begin + length - aligned_begin, MADV_WILLNEED) == 0;
+}
+
 bool MMAPAllocation::IsSupported() { return true; }
 
 }  // namespace tflite
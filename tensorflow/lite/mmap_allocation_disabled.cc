@@ -45,6 +45,10 @@ size_t MMAPAllocation::bytes() const { return 0; }
 
 bool MMAPAllocation::valid() const { return false; }
 
+bool MMAPAllocation::Prefetch(size_t offset, size_t length) const {
+  return false;
+}
+
 bool MMAPAllocation::IsSupported() { return false; }
 
 }  // namespace tflite
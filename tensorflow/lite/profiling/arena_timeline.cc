@@ -0,0 +1,155 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/arena_timeline.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/simple_memory_arena.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+bool IsLive(const ArenaAllocWithUsageInterval& alloc, int node_index) {
+  return node_index >= alloc.first_node && node_index <= alloc.last_node;
+}
+
+std::string Escape(const std::string& str) {
+  std::string escaped;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+}  // namespace
+
+ArenaTimeline ComputeArenaTimeline(
+    const std::vector<int>& execution_plan, size_t arena_size,
+    const std::vector<ArenaAllocWithUsageInterval>& allocs) {
+  ArenaTimeline timeline;
+  timeline.arena_size = arena_size;
+  timeline.steps.resize(execution_plan.size());
+  for (int i = 0; i < execution_plan.size(); ++i) {
+    ArenaTimelineStep& step = timeline.steps[i];
+    step.node_index = execution_plan[i];
+    for (const ArenaAllocWithUsageInterval& alloc : allocs) {
+      if (!IsLive(alloc, step.node_index)) continue;
+      step.live_bytes += alloc.size;
+      step.used_bytes = std::max(step.used_bytes, alloc.offset + alloc.size);
+      step.live_tensors.push_back(alloc.tensor);
+    }
+    std::sort(step.live_tensors.begin(), step.live_tensors.end());
+    if (timeline.peak_step < 0 ||
+        step.used_bytes > timeline.steps[timeline.peak_step].used_bytes) {
+      timeline.peak_step = i;
+    }
+  }
+  return timeline;
+}
+
+void AppendChromeTraceEvents(
+    const std::string& name, int pid, const ArenaTimeline& timeline,
+    const std::vector<ArenaAllocWithUsageInterval>& allocs,
+    std::string* trace) {
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+           "\"args\":{\"name\":\"",
+           pid);
+  *trace += buffer;
+  *trace += Escape(name);
+  snprintf(buffer, sizeof(buffer),
+           " (%zu bytes)\"}},\n"
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+           "\"args\":{\"name\":\"nodes\"}},\n",
+           timeline.arena_size, pid);
+  *trace += buffer;
+
+  for (int i = 0; i < timeline.steps.size(); ++i) {
+    const ArenaTimelineStep& step = timeline.steps[i];
+    snprintf(buffer, sizeof(buffer),
+             "{\"name\":\"arena\",\"ph\":\"C\",\"pid\":%d,\"ts\":%d,"
+             "\"args\":{\"live_bytes\":%zu,\"used_bytes\":%zu}},\n"
+             "{\"name\":\"fragmentation\",\"ph\":\"C\",\"pid\":%d,\"ts\":%d,"
+             "\"args\":{\"fragmentation\":%.4f}},\n",
+             pid, i, step.live_bytes, step.used_bytes, pid, i,
+             step.Fragmentation());
+    *trace += buffer;
+    snprintf(buffer, sizeof(buffer),
+             "{\"name\":\"Node %d%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,"
+             "\"ts\":%d,\"dur\":1,\"args\":{\"live_bytes\":%zu,"
+             "\"used_bytes\":%zu,\"live_tensors\":[",
+             step.node_index, i == timeline.peak_step ? " (peak)" : "", pid,
+             i, step.live_bytes, step.used_bytes);
+    *trace += buffer;
+    for (int j = 0; j < step.live_tensors.size(); ++j) {
+      if (j > 0) *trace += ",";
+      *trace += std::to_string(step.live_tensors[j]);
+    }
+    *trace += "]}},\n";
+  }
+
+  // Tensors are put on the first track, in order of offset, that is free for
+  // their whole lifetime, so that the tracks look like the arena.
+  std::vector<const ArenaAllocWithUsageInterval*> sorted_allocs;
+  for (const ArenaAllocWithUsageInterval& alloc : allocs) {
+    sorted_allocs.push_back(&alloc);
+  }
+  std::stable_sort(sorted_allocs.begin(), sorted_allocs.end(),
+                   [](const ArenaAllocWithUsageInterval* a,
+                      const ArenaAllocWithUsageInterval* b) {
+                     return a->offset < b->offset;
+                   });
+  // The step after the last tensor of each track.
+  std::vector<int> track_ends;
+  for (const ArenaAllocWithUsageInterval* alloc : sorted_allocs) {
+    int first_step = -1;
+    int last_step = -1;
+    for (int i = 0; i < timeline.steps.size(); ++i) {
+      if (!IsLive(*alloc, timeline.steps[i].node_index)) continue;
+      if (first_step < 0) first_step = i;
+      last_step = i;
+    }
+    if (first_step < 0) continue;
+    int track = 0;
+    while (track < track_ends.size() && track_ends[track] > first_step) {
+      ++track;
+    }
+    if (track == track_ends.size()) {
+      track_ends.push_back(0);
+      snprintf(buffer, sizeof(buffer),
+               "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+               "\"tid\":%d,\"args\":{\"name\":\"tensors %d\"}},\n",
+               pid, track + 1, track);
+      *trace += buffer;
+    }
+    track_ends[track] = last_step + 1;
+    snprintf(buffer, sizeof(buffer),
+             "{\"name\":\"Tensor %d\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+             "\"ts\":%d,\"dur\":%d,\"args\":{\"offset\":%zu,\"size\":%zu}},\n",
+             alloc->tensor, pid, track + 1, first_step,
+             last_step - first_step + 1, alloc->offset, alloc->size);
+    *trace += buffer;
+  }
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,79 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_ARENA_TIMELINE_H_
+#define TENSORFLOW_LITE_PROFILING_ARENA_TIMELINE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/simple_memory_arena.h"
+
+namespace tflite {
+namespace profiling {
+
+// The state of a memory arena while one node of the execution plan runs.
+struct ArenaTimelineStep {
+  int node_index = -1;
+  // The total size of the tensors alive during the node.
+  size_t live_bytes = 0;
+  // The end of the highest tensor alive during the node, i.e. the size the
+  // arena needs for this node alone.
+  size_t used_bytes = 0;
+  // The indices of the tensors alive during the node, in increasing order.
+  std::vector<int> live_tensors;
+
+  // Returns the share of the used bytes that no live tensor occupies.
+  float Fragmentation() const {
+    return used_bytes == 0 ? 0.f
+                           : 1.f - static_cast<float>(live_bytes) / used_bytes;
+  }
+};
+
+// The state of a memory arena over the execution plan.
+struct ArenaTimeline {
+  size_t arena_size = 0;
+  // One step per node of the execution plan, in execution order.
+  std::vector<ArenaTimelineStep> steps;
+  // The step with the largest used bytes, whose live tensors determine the
+  // peak size of the arena, or -1 if there are no steps.
+  int peak_step = -1;
+};
+
+// Computes the timeline of an arena of `arena_size` bytes holding `allocs`
+// over `execution_plan`, from the arguments of tflite::DumpArenaInfo().
+ArenaTimeline ComputeArenaTimeline(
+    const std::vector<int>& execution_plan, size_t arena_size,
+    const std::vector<ArenaAllocWithUsageInterval>& allocs);
+
+// Appends the events of `timeline` to `trace` in the Chrome trace event
+// format, which chrome://tracing and Perfetto load, as process `pid` named
+// `name`. Each node of the execution plan takes one microsecond. The process
+// has:
+//  * counters for the live bytes, used bytes and fragmentation of the arena,
+//  * a track of the nodes, whose events list their live tensors,
+//  * tracks of the tensors, ordered by offset, whose events give the offset
+//    and size of each tensor.
+// Every event is followed by ",\n"; a trace is a "[" followed by the events
+// of any number of timelines with different `pid`s.
+void AppendChromeTraceEvents(
+    const std::string& name, int pid, const ArenaTimeline& timeline,
+    const std::vector<ArenaAllocWithUsageInterval>& allocs,
+    std::string* trace);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_ARENA_TIMELINE_H_
@@ -0,0 +1,79 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/arena_timeline_dump.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/minimal_logging.h"
+#include "tensorflow/lite/profiling/arena_timeline.h"
+#include "tensorflow/lite/simple_memory_arena.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+struct TraceFile {
+  std::mutex mutex;
+  std::string path;
+  // The number of arenas written to the file, which is the pid of the next.
+  int num_arenas = 0;
+};
+
+TraceFile* GetTraceFile() {
+  static TraceFile* trace_file = new TraceFile();
+  return trace_file;
+}
+
+}  // namespace
+
+void SetArenaTimelineTraceFile(const std::string& path) {
+  TraceFile* trace_file = GetTraceFile();
+  std::lock_guard<std::mutex> lock(trace_file->mutex);
+  trace_file->path = path;
+  trace_file->num_arenas = 0;
+}
+
+}  // namespace profiling
+
+// Corresponding weak declaration found in lite/simple_memory_arena.cc
+void DumpArenaInfo(const std::string& name,
+                   const std::vector<int>& execution_plan, size_t arena_size,
+                   const std::vector<ArenaAllocWithUsageInterval>& allocs) {
+  profiling::TraceFile* trace_file = profiling::GetTraceFile();
+  std::lock_guard<std::mutex> lock(trace_file->mutex);
+  if (trace_file->path.empty() || execution_plan.empty()) return;
+
+  std::string trace = trace_file->num_arenas == 0 ? "[\n" : "";
+  profiling::AppendChromeTraceEvents(
+      name, trace_file->num_arenas,
+      profiling::ComputeArenaTimeline(execution_plan, arena_size, allocs),
+      allocs, &trace);
+  FILE* file =
+      fopen(trace_file->path.c_str(), trace_file->num_arenas == 0 ? "w" : "a");
+  if (file == nullptr) {
+    TFLITE_LOG(TFLITE_LOG_ERROR, "Failed to open %s.",
+               trace_file->path.c_str());
+    return;
+  }
+  fwrite(trace.data(), 1, trace.size(), file);
+  fclose(file);
+  ++trace_file->num_arenas;
+}
+
+}  // namespace tflite
@@ -0,0 +1,36 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_ARENA_TIMELINE_DUMP_H_
+#define TENSORFLOW_LITE_PROFILING_ARENA_TIMELINE_DUMP_H_
+
+#include <string>
+
+namespace tflite {
+namespace profiling {
+
+// Sets the file that the timelines of the memory arenas are written to, in the
+// Chrome trace event format, when they are dumped, e.g. by
+// tflite::PrintInterpreterState(). The file is truncated by the first dump and
+// every arena of every subgraph then gets its own process in the trace.
+//
+// Linking "//tensorflow/lite/profiling:arena_timeline_dump" provides a strong
+// definition of tflite::DumpArenaInfo(), like
+// "//tensorflow/lite:simple_memory_arena_debug_dump" which it replaces.
+void SetArenaTimelineTraceFile(const std::string& path);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_ARENA_TIMELINE_DUMP_H_
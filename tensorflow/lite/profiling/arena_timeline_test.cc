@@ -0,0 +1,111 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/arena_timeline.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/lite/simple_memory_arena.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+ArenaAllocWithUsageInterval Alloc(int tensor, size_t offset, size_t size,
+                                  int first_node, int last_node) {
+  ArenaAllocWithUsageInterval alloc;
+  alloc.tensor = tensor;
+  alloc.offset = offset;
+  alloc.size = size;
+  alloc.first_node = first_node;
+  alloc.last_node = last_node;
+  return alloc;
+}
+
+// Tensor 1 is freed after node 1 and tensor 3 reuses its space after tensor 2,
+// leaving a hole at node 2.
+class ArenaTimelineTest : public ::testing::Test {
+ protected:
+  std::vector<int> execution_plan_ = {0, 1, 2};
+  std::vector<ArenaAllocWithUsageInterval> allocs_ = {
+      Alloc(/*tensor=*/0, /*offset=*/0, /*size=*/64, 0, 0),
+      Alloc(/*tensor=*/1, /*offset=*/0, /*size=*/32, 0, 1),
+      Alloc(/*tensor=*/2, /*offset=*/64, /*size=*/64, 1, 2),
+      Alloc(/*tensor=*/3, /*offset=*/128, /*size=*/32, 2, 2),
+  };
+};
+
+TEST_F(ArenaTimelineTest, ComputesLiveTensors) {
+  const ArenaTimeline timeline =
+      ComputeArenaTimeline(execution_plan_, /*arena_size=*/160, allocs_);
+  EXPECT_EQ(timeline.arena_size, 160);
+  ASSERT_EQ(timeline.steps.size(), 3);
+
+  EXPECT_THAT(timeline.steps[0].live_tensors, ElementsAre(0, 1));
+  EXPECT_EQ(timeline.steps[0].live_bytes, 96);
+  EXPECT_EQ(timeline.steps[0].used_bytes, 64);
+
+  EXPECT_THAT(timeline.steps[1].live_tensors, ElementsAre(1, 2));
+  EXPECT_EQ(timeline.steps[1].live_bytes, 96);
+  EXPECT_EQ(timeline.steps[1].used_bytes, 128);
+  EXPECT_FLOAT_EQ(timeline.steps[1].Fragmentation(), 0.25f);
+
+  EXPECT_THAT(timeline.steps[2].live_tensors, ElementsAre(2, 3));
+  EXPECT_EQ(timeline.steps[2].used_bytes, 160);
+  EXPECT_FLOAT_EQ(timeline.steps[2].Fragmentation(), 0.4f);
+  EXPECT_EQ(timeline.peak_step, 2);
+}
+
+TEST_F(ArenaTimelineTest, EmptyExecutionPlan) {
+  const ArenaTimeline timeline =
+      ComputeArenaTimeline(/*execution_plan=*/{}, /*arena_size=*/160, allocs_);
+  EXPECT_TRUE(timeline.steps.empty());
+  EXPECT_EQ(timeline.peak_step, -1);
+}
+
+TEST_F(ArenaTimelineTest, AppendsChromeTraceEvents) {
+  const ArenaTimeline timeline =
+      ComputeArenaTimeline(execution_plan_, /*arena_size=*/160, allocs_);
+  std::string trace;
+  AppendChromeTraceEvents("arena", /*pid=*/3, timeline, allocs_, &trace);
+
+  EXPECT_THAT(trace, HasSubstr("\"args\":{\"name\":\"arena (160 bytes)\"}"));
+  EXPECT_THAT(trace, HasSubstr("{\"name\":\"Node 2 (peak)\",\"ph\":\"X\","
+                               "\"pid\":3,\"tid\":0,\"ts\":2,\"dur\":1,"
+                               "\"args\":{\"live_bytes\":96,"
+                               "\"used_bytes\":160,\"live_tensors\":[2,3]}}"));
+  // Tensors 0 and 1 share offset 0, so tensor 1 goes to the second track,
+  // which tensor 2 then reuses.
+  EXPECT_THAT(trace, HasSubstr("{\"name\":\"Tensor 0\",\"ph\":\"X\","
+                               "\"pid\":3,\"tid\":1,\"ts\":0,\"dur\":1,"
+                               "\"args\":{\"offset\":0,\"size\":64}}"));
+  EXPECT_THAT(trace, HasSubstr("{\"name\":\"Tensor 1\",\"ph\":\"X\","
+                               "\"pid\":3,\"tid\":2,\"ts\":0,\"dur\":2,"
+                               "\"args\":{\"offset\":0,\"size\":32}}"));
+  EXPECT_THAT(trace, HasSubstr("{\"name\":\"Tensor 2\",\"ph\":\"X\","
+                               "\"pid\":3,\"tid\":1,\"ts\":1,\"dur\":2,"
+                               "\"args\":{\"offset\":64,\"size\":64}}"));
+  EXPECT_THAT(trace, HasSubstr("\"fragmentation\":0.4000"));
+  EXPECT_EQ(trace.substr(trace.size() - 2), ",\n");
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
@@ -142,6 +142,11 @@ class SimpleMemoryArena {
                         int32_t tensor, int32_t first_node, int32_t last_node,
                         ArenaAllocWithUsageInterval* new_alloc);
 
+  // Replaces the allocations made so far by `allocs`, which were computed
+  // earlier for the same usage intervals, e.g. by Allocate() calls for the
+  // same tensor sizes. Commit() then sizes the buffer to fit all of them.
+  void RestoreAllocs(const std::vector<ArenaAllocWithUsageInterval>& allocs);
+
   TfLiteStatus Commit(bool* arena_reallocated);
 
   TfLiteStatus ResolveAlloc(TfLiteContext* context,
@@ -178,6 +183,8 @@ class SimpleMemoryArena {
   // program, calling this function will output information of this memory arena
   // about tenosrs and ops, such as memory arena utilization rate, live tensors
   // at each op etc.
+  // "lite/profiling:arena_timeline_dump" instead writes the timeline of the
+  // arena, with the offsets of the live tensors at each op, as a Chrome trace.
   void DumpDebugInfo(const std::string& name,
                      const std::vector<int>& execution_plan) const;
 
@@ -49,6 +49,7 @@ limitations under the License.
 #include "tensorflow/lite/string_util.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_utils.h"
 #include "tensorflow/lite/tools/benchmark/profiling_listener.h"
+#include "tensorflow/lite/tools/benchmark/roofline_listener.h"
 #include "tensorflow/lite/tools/delegates/delegate_provider.h"
 #include "tensorflow/lite/tools/logging.h"
 #include "tensorflow/lite/tools/model_loader.h"
@@ -370,6 +371,16 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("profiling_output_csv_file",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("roofline_output_prefix",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("roofline_peak_gflops",
+                          BenchmarkParam::Create<float>(0.0f));
+  default_params.AddParam("roofline_peak_gbps",
+                          BenchmarkParam::Create<float>(0.0f));
+  default_params.AddParam("roofline_baseline_csv_file",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("roofline_regression_threshold",
+                          BenchmarkParam::Create<float>(0.1f));
 
   default_params.AddParam("print_preinvoke_state",
                           BenchmarkParam::Create<bool>(false));
@@ -452,6 +463,23 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "profiling_output_csv_file", &params_,
           "File path to export profile data as CSV, if not set "
           "prints to stdout."),
+      CreateFlag<std::string>(
+          "roofline_output_prefix", &params_,
+          "If set, writes a per-op roofline report (measured time combined "
+          "with the estimated FLOPs and bytes of each op) to <prefix>.csv and "
+          "<prefix>.json."),
+      CreateFlag<float>("roofline_peak_gflops", &params_,
+                        "Peak compute of the hardware in GFLOP/s, used to "
+                        "report the distance of each op to the roofline."),
+      CreateFlag<float>("roofline_peak_gbps", &params_,
+                        "Peak memory bandwidth of the hardware in GB/s, used "
+                        "to report the distance of each op to the roofline."),
+      CreateFlag<std::string>(
+          "roofline_baseline_csv_file", &params_,
+          "CSV roofline report of an earlier run to compare op times with."),
+      CreateFlag<float>("roofline_regression_threshold", &params_,
+                        "Relative slowdown of an op against the baseline that "
+                        "is reported as a regression."),
       CreateFlag<bool>(
           "print_preinvoke_state", &params_,
           "print out the interpreter internals just before calling Invoke. The "
@@ -518,6 +546,16 @@ void BenchmarkTfLiteModel::LogParams() {
                       verbose);
   LOG_BENCHMARK_PARAM(std::string, "profiling_output_csv_file",
                       "CSV File to export profiling data to", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "roofline_output_prefix",
+                      "Roofline report file prefix", verbose);
+  LOG_BENCHMARK_PARAM(float, "roofline_peak_gflops", "Roofline peak GFLOP/s",
+                      verbose);
+  LOG_BENCHMARK_PARAM(float, "roofline_peak_gbps", "Roofline peak GB/s",
+                      verbose);
+  LOG_BENCHMARK_PARAM(std::string, "roofline_baseline_csv_file",
+                      "Roofline baseline CSV file", verbose);
+  LOG_BENCHMARK_PARAM(float, "roofline_regression_threshold",
+                      "Roofline regression threshold", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_preinvoke_state",
                       "Print pre-invoke interpreter state", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_postinvoke_state",
@@ -775,6 +813,7 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
   }
 
   AddOwnedListener(MayCreateProfilingListener());
+  AddOwnedListener(MayCreateRooflineListener());
   AddOwnedListener(std::unique_ptr<BenchmarkListener>(
       new InterpreterStatePrinter(interpreter_.get())));
 
@@ -960,6 +999,25 @@ BenchmarkTfLiteModel::MayCreateProfilingListener() const {
           !params_.Get<std::string>("profiling_output_csv_file").empty())));
 }
 
+std::unique_ptr<BenchmarkListener>
+BenchmarkTfLiteModel::MayCreateRooflineListener() const {
+  if (params_.Get<std::string>("roofline_output_prefix").empty()) {
+    return nullptr;
+  }
+
+  RooflineOptions options;
+  options.output_prefix = params_.Get<std::string>("roofline_output_prefix");
+  options.peak_gflops = params_.Get<float>("roofline_peak_gflops");
+  options.peak_gbps = params_.Get<float>("roofline_peak_gbps");
+  options.baseline_csv_file =
+      params_.Get<std::string>("roofline_baseline_csv_file");
+  options.regression_threshold =
+      params_.Get<float>("roofline_regression_threshold");
+  return std::unique_ptr<BenchmarkListener>(new RooflineListener(
+      interpreter_.get(), params_.Get<int32_t>("max_profiling_buffer_entries"),
+      options));
+}
+
 TfLiteStatus BenchmarkTfLiteModel::RunImpl() { return interpreter_->Invoke(); }
 
 }  // namespace benchmark
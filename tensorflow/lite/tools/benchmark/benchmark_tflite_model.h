@@ -103,6 +103,10 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   // necessary.
   virtual std::unique_ptr<BenchmarkListener> MayCreateProfilingListener() const;
 
+  // Create a BenchmarkListener that writes a per-op roofline report if
+  // requested.
+  std::unique_ptr<BenchmarkListener> MayCreateRooflineListener() const;
+
   void CleanUp();
 
   utils::InputTensorData LoadInputTensorData(
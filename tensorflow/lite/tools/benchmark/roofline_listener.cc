@@ -0,0 +1,370 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/tools/benchmark/roofline_listener.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/profiling/profile_buffer.h"
+#include "tensorflow/lite/tools/logging.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite {
+namespace benchmark {
+namespace {
+
+double NumElements(const TfLiteTensor* tensor) {
+  if (tensor == nullptr || tensor->dims == nullptr) return 0;
+  double num_elements = 1;
+  for (int i = 0; i < tensor->dims->size; ++i) {
+    num_elements *= tensor->dims->data[i];
+  }
+  return num_elements;
+}
+
+// Row of the report for one node.
+struct OpReport {
+  int subgraph_index;
+  int node_index;
+  std::string name;
+  std::string op;
+  int64_t count;
+  double avg_us;
+  OpCost cost;
+  double gflops_per_s;
+  double gbytes_per_s;
+  double intensity;
+  // Only set with hardware peaks.
+  std::string bound;
+  double peak_fraction = -1;
+  // Only set with a baseline.
+  double baseline_avg_us = -1;
+};
+
+std::string GetKey(int subgraph_index, int node_index) {
+  return std::to_string(subgraph_index) + ":" + std::to_string(node_index);
+}
+
+// Commas and quotes would break both the CSV and the JSON output.
+std::string Sanitize(std::string name) {
+  std::replace(name.begin(), name.end(), ',', ';');
+  std::replace(name.begin(), name.end(), '"', '\'');
+  return name;
+}
+
+// Reads the average op times of an earlier CSV report, keyed by GetKey().
+bool ReadBaseline(const std::string& path,
+                  std::map<std::string, double>* avg_us) {
+  std::ifstream file(path);
+  std::string line;
+  if (!file.good() || !std::getline(file, line)) return false;
+  std::vector<std::string> header;
+  std::stringstream header_stream(line);
+  for (std::string column; std::getline(header_stream, column, ',');) {
+    header.push_back(column);
+  }
+  const auto column_index = [&header](const std::string& name) -> int {
+    auto it = std::find(header.begin(), header.end(), name);
+    return it == header.end() ? -1 : it - header.begin();
+  };
+  const int subgraph_column = column_index("subgraph");
+  const int node_column = column_index("node");
+  const int avg_us_column = column_index("avg_us");
+  if (subgraph_column < 0 || node_column < 0 || avg_us_column < 0) {
+    return false;
+  }
+  while (std::getline(file, line)) {
+    std::vector<std::string> fields;
+    std::stringstream line_stream(line);
+    for (std::string field; std::getline(line_stream, field, ',');) {
+      fields.push_back(field);
+    }
+    // getline drops a trailing empty field.
+    if (fields.size() > header.size()) continue;
+    fields.resize(header.size());
+    if (fields[avg_us_column].empty()) continue;
+    (*avg_us)[fields[subgraph_column] + ":" + fields[node_column]] =
+        std::stod(fields[avg_us_column]);
+  }
+  return true;
+}
+
+}  // namespace
+
+OpCost EstimateOpCost(Interpreter* interpreter, int subgraph_index,
+                      int node_index) {
+  OpCost cost;
+  const auto* node_and_registration =
+      interpreter->node_and_registration(subgraph_index, node_index);
+  if (node_and_registration == nullptr) return cost;
+  const TfLiteNode& node = node_and_registration->first;
+  const TfLiteRegistration& registration = node_and_registration->second;
+  Subgraph* subgraph = interpreter->subgraph(subgraph_index);
+
+  if (registration.builtin_code == kTfLiteBuiltinDelegate) {
+    const auto* params =
+        static_cast<const TfLiteDelegateParams*>(node.builtin_data);
+    if (params == nullptr || params->nodes_to_replace == nullptr) return cost;
+    for (int i = 0; i < params->nodes_to_replace->size; ++i) {
+      const OpCost replaced_cost = EstimateOpCost(
+          interpreter, subgraph_index, params->nodes_to_replace->data[i]);
+      cost.flops += replaced_cost.flops;
+      cost.bytes += replaced_cost.bytes;
+    }
+    return cost;
+  }
+
+  const auto input = [&](int i) -> const TfLiteTensor* {
+    if (i >= node.inputs->size || node.inputs->data[i] < 0) return nullptr;
+    return subgraph->tensor(node.inputs->data[i]);
+  };
+  const auto output = [&](int i) -> const TfLiteTensor* {
+    if (i >= node.outputs->size || node.outputs->data[i] < 0) return nullptr;
+    return subgraph->tensor(node.outputs->data[i]);
+  };
+  for (int i = 0; i < node.inputs->size; ++i) {
+    if (const TfLiteTensor* tensor = input(i)) cost.bytes += tensor->bytes;
+  }
+  for (int i = 0; i < node.outputs->size; ++i) {
+    if (const TfLiteTensor* tensor = output(i)) cost.bytes += tensor->bytes;
+  }
+
+  // Number of multiply-accumulates per output element.
+  double macs_per_output = 0;
+  const TfLiteTensor* weights = input(1);
+  const TfLiteIntArray* weight_dims =
+      weights != nullptr ? weights->dims : nullptr;
+  switch (registration.builtin_code) {
+    case kTfLiteBuiltinConv2d:
+      // Filter is [output_channels, height, width, input_channels].
+      if (weight_dims != nullptr && weight_dims->size == 4) {
+        macs_per_output = static_cast<double>(weight_dims->data[1]) *
+                          weight_dims->data[2] * weight_dims->data[3];
+      }
+      break;
+    case kTfLiteBuiltinDepthwiseConv2d:
+      // Filter is [1, height, width, output_channels].
+      if (weight_dims != nullptr && weight_dims->size == 4) {
+        macs_per_output =
+            static_cast<double>(weight_dims->data[1]) * weight_dims->data[2];
+      }
+      break;
+    case kTfLiteBuiltinFullyConnected:
+      // Weights are [units, input_size].
+      if (weight_dims != nullptr && weight_dims->size == 2) {
+        macs_per_output = weight_dims->data[1];
+      }
+      break;
+    case kTfLiteBuiltinBatchMatmul: {
+      const TfLiteTensor* lhs = input(0);
+      const auto* params =
+          static_cast<const TfLiteBatchMatMulParams*>(node.builtin_data);
+      if (lhs != nullptr && lhs->dims->size >= 2) {
+        const int rank = lhs->dims->size;
+        macs_per_output = lhs->dims->data[params != nullptr && params->adj_x
+                                              ? rank - 2
+                                              : rank - 1];
+      }
+      break;
+    }
+    case kTfLiteBuiltinTransposeConv:
+      // Every input element is multiplied with a [height, width] window of
+      // every output channel of the [output_channels, height, width,
+      // input_channels] filter.
+      if (weight_dims != nullptr && weight_dims->size == 4) {
+        cost.flops = 2 * NumElements(input(2)) * weight_dims->data[0] *
+                     weight_dims->data[1] * weight_dims->data[2];
+        return cost;
+      }
+      break;
+    default:
+      break;
+  }
+  const double output_elements = NumElements(output(0));
+  cost.flops = macs_per_output > 0 ? 2 * macs_per_output * output_elements
+                                   : output_elements;
+  return cost;
+}
+
+RooflineListener::RooflineListener(Interpreter* interpreter,
+                                   uint32_t max_num_entries,
+                                   const RooflineOptions& options)
+    : interpreter_(interpreter),
+      options_(options),
+      profiler_(max_num_entries, /*allow_dynamic_buffer_increase=*/true) {
+  TFLITE_TOOLS_CHECK(interpreter);
+  interpreter_->AddProfiler(&profiler_);
+}
+
+void RooflineListener::OnSingleRunStart(RunType run_type) {
+  profiling_ = run_type == REGULAR;
+  if (profiling_) {
+    profiler_.Reset();
+    profiler_.StartProfiling();
+  }
+}
+
+void RooflineListener::OnSingleRunEnd() {
+  if (!profiling_) return;
+  profiler_.StopProfiling();
+  for (const profiling::ProfileEvent* event : profiler_.GetProfileEvents()) {
+    if (event->event_type != Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+      continue;
+    }
+    OpTime& op_time = op_times_[{static_cast<int>(event->extra_event_metadata),
+                                 static_cast<int>(event->event_metadata)}];
+    ++op_time.count;
+    op_time.total_us += event->elapsed_time;
+  }
+}
+
+void RooflineListener::OnBenchmarkEnd(const BenchmarkResults& results) {
+  if (op_times_.empty()) {
+    TFLITE_LOG(WARN) << "No op was profiled, skipping the roofline report.";
+    return;
+  }
+  const bool has_peaks = options_.peak_gflops > 0 && options_.peak_gbps > 0;
+  std::map<std::string, double> baseline;
+  if (!options_.baseline_csv_file.empty() &&
+      !ReadBaseline(options_.baseline_csv_file, &baseline)) {
+    TFLITE_LOG(ERROR) << "Failed to read roofline baseline "
+                      << options_.baseline_csv_file;
+  }
+
+  std::vector<OpReport> reports;
+  for (const auto& [index, op_time] : op_times_) {
+    const auto [subgraph_index, node_index] = index;
+    const auto* node_and_registration =
+        interpreter_->node_and_registration(subgraph_index, node_index);
+    if (node_and_registration == nullptr) continue;
+    OpReport report;
+    report.subgraph_index = subgraph_index;
+    report.node_index = node_index;
+    const TfLiteNode& node = node_and_registration->first;
+    const TfLiteTensor* first_output =
+        node.outputs->size > 0 && node.outputs->data[0] >= 0
+            ? interpreter_->subgraph(subgraph_index)
+                  ->tensor(node.outputs->data[0])
+            : nullptr;
+    report.name = Sanitize(first_output != nullptr && first_output->name
+                               ? first_output->name
+                               : "");
+    report.op =
+        Sanitize(GetOpNameByRegistration(node_and_registration->second));
+    report.count = op_time.count;
+    report.avg_us = static_cast<double>(op_time.total_us) / op_time.count;
+    report.cost = EstimateOpCost(interpreter_, subgraph_index, node_index);
+    // Ops faster than the profiler resolution are assumed to take 1us.
+    const double avg_ns = std::max(report.avg_us, 1.0) * 1e3;
+    report.gflops_per_s = report.cost.flops / avg_ns;
+    report.gbytes_per_s = report.cost.bytes / avg_ns;
+    report.intensity =
+        report.cost.bytes > 0 ? report.cost.flops / report.cost.bytes : 0;
+    if (has_peaks) {
+      const double memory_roof = report.intensity * options_.peak_gbps;
+      report.bound = memory_roof < options_.peak_gflops ? "memory" : "compute";
+      report.peak_fraction =
+          report.gflops_per_s / std::min(memory_roof, options_.peak_gflops);
+    }
+    auto baseline_it = baseline.find(GetKey(subgraph_index, node_index));
+    if (baseline_it != baseline.end()) {
+      report.baseline_avg_us = baseline_it->second;
+    }
+    reports.push_back(std::move(report));
+  }
+
+  std::ofstream csv(options_.output_prefix + ".csv");
+  std::ofstream json(options_.output_prefix + ".json");
+  if (!csv.good() || !json.good()) {
+    TFLITE_LOG(ERROR) << "Failed to open roofline report files with prefix "
+                      << options_.output_prefix;
+    return;
+  }
+  csv << "subgraph,node,name,op,count,avg_us,flops,bytes,gflops_per_s,"
+         "gbytes_per_s,intensity,bound,peak_fraction,baseline_avg_us,change\n";
+  json << "{\n  \"peak_gflops\": " << options_.peak_gflops
+       << ",\n  \"peak_gbps\": " << options_.peak_gbps
+       << ",\n  \"inference_avg_us\": " << results.inference_time_us().avg()
+       << ",\n  \"ops\": [";
+  int num_regressions = 0;
+  for (size_t i = 0; i < reports.size(); ++i) {
+    const OpReport& report = reports[i];
+    const bool has_baseline = report.baseline_avg_us > 0;
+    const double change =
+        has_baseline ? report.avg_us / report.baseline_avg_us - 1 : 0;
+    csv << report.subgraph_index << "," << report.node_index << ","
+        << report.name << "," << report.op << "," << report.count << ","
+        << report.avg_us << "," << report.cost.flops << ","
+        << report.cost.bytes << "," << report.gflops_per_s << ","
+        << report.gbytes_per_s << "," << report.intensity << ","
+        << report.bound << ",";
+    if (has_peaks) csv << report.peak_fraction;
+    csv << ",";
+    if (has_baseline) csv << report.baseline_avg_us;
+    csv << ",";
+    if (has_baseline) csv << change;
+    csv << "\n";
+
+    json << (i == 0 ? "\n" : ",\n") << "    {\"subgraph\": "
+         << report.subgraph_index << ", \"node\": " << report.node_index
+         << ", \"name\": \"" << report.name << "\", \"op\": \"" << report.op
+         << "\", \"count\": " << report.count
+         << ", \"avg_us\": " << report.avg_us
+         << ", \"flops\": " << report.cost.flops
+         << ", \"bytes\": " << report.cost.bytes
+         << ", \"gflops_per_s\": " << report.gflops_per_s
+         << ", \"gbytes_per_s\": " << report.gbytes_per_s
+         << ", \"intensity\": " << report.intensity;
+    if (has_peaks) {
+      json << ", \"bound\": \"" << report.bound
+           << "\", \"peak_fraction\": " << report.peak_fraction;
+    }
+    if (has_baseline) {
+      json << ", \"baseline_avg_us\": " << report.baseline_avg_us
+           << ", \"change\": " << change;
+    }
+    json << "}";
+
+    if (has_baseline && change > options_.regression_threshold) {
+      ++num_regressions;
+      TFLITE_LOG(WARN) << "Roofline regression: " << report.op << " (node "
+                       << GetKey(report.subgraph_index, report.node_index)
+                       << ", " << report.name << ") " << report.baseline_avg_us
+                       << "us -> " << report.avg_us << "us";
+    }
+  }
+  json << "\n  ],\n  \"num_regressions\": " << num_regressions << "\n}\n";
+  TFLITE_LOG(INFO) << "Wrote roofline report for " << reports.size()
+                   << " ops to " << options_.output_prefix << ".{csv,json}";
+  if (!baseline.empty()) {
+    TFLITE_LOG(INFO) << num_regressions << " ops regressed by more than "
+                     << options_.regression_threshold * 100
+                     << "% against the baseline.";
+  }
+}
+
+}  // namespace benchmark
+}  // namespace tflite
@@ -0,0 +1,92 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_ROOFLINE_LISTENER_H_
+#define TENSORFLOW_LITE_TOOLS_BENCHMARK_ROOFLINE_LISTENER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/profiling/buffered_profiler.h"
+#include "tensorflow/lite/tools/benchmark/benchmark_model.h"
+
+namespace tflite {
+namespace benchmark {
+
+// Cost of running a node once, estimated from its tensor shapes.
+struct OpCost {
+  // Floating point (or integer) operations, counting a multiply-accumulate as
+  // two. Ops without a specific estimate count one per output element.
+  double flops = 0;
+  // Bytes of all input (including weights) and output tensors.
+  double bytes = 0;
+};
+
+// Estimates the cost of node `node_index` of subgraph `subgraph_index`. For a
+// delegate kernel, this is the total cost of the nodes it replaced.
+OpCost EstimateOpCost(Interpreter* interpreter, int subgraph_index,
+                      int node_index);
+
+struct RooflineOptions {
+  // Prefix of the report files: writes <prefix>.csv and <prefix>.json.
+  std::string output_prefix;
+  // Peak compute (GFLOP/s) and memory bandwidth (GB/s) of the hardware. When
+  // both are set, the report includes the fraction of the attainable
+  // performance each op achieves and whether it is compute or memory bound.
+  double peak_gflops = 0;
+  double peak_gbps = 0;
+  // CSV report of an earlier run to compare against, and the relative slowdown
+  // of an op that is reported as a regression.
+  std::string baseline_csv_file;
+  double regression_threshold = 0.1;
+};
+
+// Combines the measured time of each op over the regular benchmark runs with
+// its estimated cost into a roofline report: achieved FLOP/s and bytes/s,
+// arithmetic intensity and, given the hardware peaks, the distance to the
+// roofline. Optionally compares op times with the report of an earlier run to
+// track kernel and delegate regressions.
+class RooflineListener : public BenchmarkListener {
+ public:
+  RooflineListener(Interpreter* interpreter, uint32_t max_num_entries,
+                   const RooflineOptions& options);
+
+  void OnSingleRunStart(RunType run_type) override;
+
+  void OnSingleRunEnd() override;
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override;
+
+ private:
+  struct OpTime {
+    int64_t count = 0;
+    uint64_t total_us = 0;
+  };
+
+  Interpreter* interpreter_;
+  const RooflineOptions options_;
+  profiling::BufferedProfiler profiler_;
+  bool profiling_ = false;
+  // Keyed by (subgraph index, node index).
+  std::map<std::pair<int, int>, OpTime> op_times_;
+};
+
+}  // namespace benchmark
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_TOOLS_BENCHMARK_ROOFLINE_LISTENER_H_
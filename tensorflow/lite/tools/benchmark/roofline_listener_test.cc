@@ -0,0 +1,79 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/tools/benchmark/roofline_listener.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+
+namespace tflite {
+namespace benchmark {
+namespace {
+
+// Builds a single node graph with the given op and tensor shapes.
+void BuildGraph(Interpreter* interpreter, int builtin_code,
+                const std::vector<std::vector<int>>& input_shapes,
+                const std::vector<int>& output_shape) {
+  const int num_inputs = input_shapes.size();
+  ASSERT_EQ(interpreter->AddTensors(num_inputs + 1), kTfLiteOk);
+  std::vector<int> inputs;
+  for (int i = 0; i < num_inputs; ++i) {
+    ASSERT_EQ(interpreter->SetTensorParametersReadWrite(
+                  i, kTfLiteFloat32, "", input_shapes[i], TfLiteQuantization()),
+              kTfLiteOk);
+    inputs.push_back(i);
+  }
+  ASSERT_EQ(interpreter->SetTensorParametersReadWrite(
+                num_inputs, kTfLiteFloat32, "", output_shape,
+                TfLiteQuantization()),
+            kTfLiteOk);
+  TfLiteRegistration registration = {nullptr, nullptr, nullptr, nullptr};
+  registration.builtin_code = builtin_code;
+  ASSERT_EQ(interpreter->AddNodeWithParameters(inputs, {num_inputs}, nullptr,
+                                               0, nullptr, &registration),
+            kTfLiteOk);
+}
+
+TEST(RooflineListenerTest, EstimatesFullyConnectedCost) {
+  Interpreter interpreter;
+  BuildGraph(&interpreter, kTfLiteBuiltinFullyConnected, {{2, 16}, {8, 16}},
+             {2, 8});
+  const OpCost cost = EstimateOpCost(&interpreter, 0, 0);
+  EXPECT_EQ(cost.flops, 2 * 2 * 8 * 16);
+  EXPECT_EQ(cost.bytes, (2 * 16 + 8 * 16 + 2 * 8) * sizeof(float));
+}
+
+TEST(RooflineListenerTest, EstimatesConvolutionCost) {
+  Interpreter interpreter;
+  BuildGraph(&interpreter, kTfLiteBuiltinConv2d,
+             {{1, 8, 8, 3}, {4, 3, 3, 3}, {4}}, {1, 8, 8, 4});
+  const OpCost cost = EstimateOpCost(&interpreter, 0, 0);
+  EXPECT_EQ(cost.flops, 2.0 * (8 * 8 * 4) * (3 * 3 * 3));
+}
+
+TEST(RooflineListenerTest, CountsOutputElementsForOtherOps) {
+  Interpreter interpreter;
+  BuildGraph(&interpreter, kTfLiteBuiltinAdd, {{4, 5}, {4, 5}}, {4, 5});
+  const OpCost cost = EstimateOpCost(&interpreter, 0, 0);
+  EXPECT_EQ(cost.flops, 20);
+  EXPECT_EQ(cost.bytes, 3 * 20 * sizeof(float));
+}
+
+}  // namespace
+}  // namespace benchmark
+}  // namespace tflite
@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/core/c/common.h"
@@ -136,20 +137,25 @@ KernelEvalFuncPtr Calibrator::GetKernelInvoke(const TfLiteNode* node) const {
 //
 // This way the kernel invoke functions can get the access to the Calibrator
 // object associated with the |TfLiteContext|.
+// Logging interpreters built from the same model may be built, invoked and
+// destroyed on different threads, so the registry is guarded by a mutex.
 class GlobalCalibratorRegistry {
  public:
   // Get the |Calibrator| associated with given context, returns null if no
   // calibrator is associated with the given context.
   Calibrator* GetCalibrator(const TfLiteNode* node) const {
-    if (node_to_calibrator_.find(node) == node_to_calibrator_.cend()) {
+    absl::ReaderMutexLock lock(&mutex_);
+    auto it = node_to_calibrator_.find(node);
+    if (it == node_to_calibrator_.cend()) {
       return nullptr;
     }
-    return node_to_calibrator_.at(node);
+    return it->second;
   }
 
   // Removes the association between calibrator and context.
   // Note: This deletes the calibrator as well.
   void RemoveCalibrator(const TfLiteContext* context) {
+    absl::MutexLock lock(&mutex_);
     Calibrator* calibrator = calibrator_registry_.at(context).get();
     auto nodes = calibrator->GetNodesUnderCalibration();
     for (auto node : nodes) {
@@ -166,6 +172,7 @@ class GlobalCalibratorRegistry {
       const std::unordered_map<const TfLiteNode*, OperatorInfo>& node_to_opinfo,
       std::unique_ptr<LoggingOpResolver> logging_op_resolver,
       Calibrator** calibrator_ptr, ErrorReporter* reporter) {
+    absl::MutexLock lock(&mutex_);
     if (calibrator_registry_.find(context) != calibrator_registry_.cend()) {
       reporter->Report(
           "Failed to create calibrator, context already registered.");
@@ -182,9 +189,11 @@ class GlobalCalibratorRegistry {
   }
 
  private:
+  mutable absl::Mutex mutex_;
   absl::flat_hash_map<const TfLiteContext*, std::unique_ptr<Calibrator>>
-      calibrator_registry_;
-  absl::flat_hash_map<const TfLiteNode*, Calibrator*> node_to_calibrator_;
+      calibrator_registry_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<const TfLiteNode*, Calibrator*> node_to_calibrator_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 GlobalCalibratorRegistry* GetCalibratorRegistry() {
@@ -54,6 +54,11 @@ namespace calibration {
 // calibration_reader->AddCalibrationToModel(original_floating_point_model,
 // false);
 //
+// Several logging interpreters can be built from the same model and invoked
+// in parallel on separate threads, each on a part of the calibration dataset.
+// Each one logs into its own |calibration_reader|; the statistics are merged
+// by adding all of them to the same model with "update" set to true.
+//
 TfLiteStatus BuildLoggingInterpreter(
     const FlatBufferModel& model, const OpResolver& op_resolver,
     std::unique_ptr<Interpreter>* interpreter,
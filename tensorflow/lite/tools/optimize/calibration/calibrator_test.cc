@@ -16,7 +16,9 @@ limitations under the License.
 
 #include <cstring>
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -282,6 +284,57 @@ TEST(CalibratorTest, UpdateMinMax) {
   }
 }
 
+TEST(CalibratorTest, ParallelCalibration) {
+  auto flatbuffer_model = ReadModel("multi_add.bin");
+  ASSERT_TRUE(flatbuffer_model);
+  auto readonly_model = flatbuffer_model->GetModel();
+  tflite::ModelT model;
+  readonly_model->UnPackTo(&model);
+
+  // Each interpreter calibrates on its own sample, in which input i is filled
+  // with (i + 1) * (sample + 1).
+  constexpr int kNumSamples = 2;
+  std::vector<std::unique_ptr<Interpreter>> interpreters(kNumSamples);
+  std::vector<std::unique_ptr<CalibrationReader>> readers(kNumSamples);
+  std::vector<TfLiteStatus> statuses(kNumSamples, kTfLiteError);
+  std::vector<std::thread> threads;
+  for (int sample = 0; sample < kNumSamples; ++sample) {
+    threads.emplace_back([&, sample]() {
+      std::unique_ptr<Interpreter>& interpreter = interpreters[sample];
+      if (BuildLoggingInterpreter(
+              *flatbuffer_model, ops::builtin::BuiltinOpResolver{},
+              &interpreter, &readers[sample]) != kTfLiteOk ||
+          interpreter->AllocateTensors() != kTfLiteOk) {
+        return;
+      }
+      for (size_t i = 0; i < interpreter->inputs().size(); i++) {
+        TfLiteTensor* tensor = interpreter->tensor(interpreter->inputs()[i]);
+        for (size_t j = 0; j < tensor->bytes / sizeof(float); j++) {
+          tensor->data.f[j] = (i + 1) * (sample + 1);
+        }
+      }
+      statuses[sample] = interpreter->Invoke();
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int sample = 0; sample < kNumSamples; ++sample) {
+    ASSERT_EQ(kTfLiteOk, statuses[sample]);
+    ASSERT_EQ(kTfLiteOk,
+              readers[sample]->AddCalibrationToModel(&model, /*update=*/true));
+  }
+
+  const float eps = 1e-6f;
+  const float expected_min[7] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 9.0f};
+  for (int tensor_idx = 0; tensor_idx < 7; tensor_idx++) {
+    EXPECT_NEAR(model.subgraphs[0]->tensors[tensor_idx]->quantization->min[0],
+                expected_min[tensor_idx], eps);
+    EXPECT_NEAR(model.subgraphs[0]->tensors[tensor_idx]->quantization->max[0],
+                kNumSamples * expected_min[tensor_idx], eps);
+  }
+}
+
 TEST(CalibratorTest, HandleNanValues) {
   auto flatbuffer_model = ReadModel("multi_add.bin");
   ASSERT_TRUE(flatbuffer_model);
@@ -803,6 +803,11 @@ int GetBuiltinOperatorVersion(const OpSignature& op_sig) {
       return 1;
 
     case BuiltinOperator_BATCH_MATMUL: {
+      // In case of float and int4 inputs, the version is 5.
+      if (op_sig.inputs.at(0).type == kTfLiteFloat32 &&
+          op_sig.inputs.at(1).type == kTfLiteInt4) {
+        return 5;
+      }
       // In case of int16 inputs, the version is 3.
       if (op_sig.inputs.at(0).type == kTfLiteInt16) {
         return 3;
@@ -824,6 +829,12 @@ int GetBuiltinOperatorVersion(const OpSignature& op_sig) {
       return 1;
     }
 
+    case BuiltinOperator_EMBEDDING_LOOKUP:
+      if (op_sig.inputs.at(1).type == kTfLiteInt4) {
+        return 4;
+      }
+      return 1;
+
     case BuiltinOperator_PAD:
     case BuiltinOperator_PADV2:
       if (op_sig.inputs.at(0).dims.size() > 4) {
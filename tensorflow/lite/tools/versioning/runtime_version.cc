@@ -61,6 +61,7 @@ std::string FindMinimumRuntimeVersionForOp(tflite::BuiltinOperator op_code,
            {{BuiltinOperator_BATCH_MATMUL, 2}, "2.3.0"},
            {{BuiltinOperator_BATCH_MATMUL, 3}, "2.4.0"},
            {{BuiltinOperator_BATCH_MATMUL, 4}, "2.5.0"},
+           {{BuiltinOperator_BATCH_MATMUL, 5}, "2.17.0"},
            // The version one of broadcast to op won't be not supported since
            // the version one was rollbacked and the builtin op code number
            // has been changed because of builtin op code shortage problem.
@@ -118,6 +119,7 @@ std::string FindMinimumRuntimeVersionForOp(tflite::BuiltinOperator op_code,
            {{BuiltinOperator_EMBEDDING_LOOKUP, 1}, "1.13.0"},
            {{BuiltinOperator_EMBEDDING_LOOKUP, 2}, "1.14.0"},
            {{BuiltinOperator_EMBEDDING_LOOKUP, 3}, "1.14.0"},
+           {{BuiltinOperator_EMBEDDING_LOOKUP, 4}, "2.17.0"},
            {{BuiltinOperator_EMBEDDING_LOOKUP_SPARSE, 1}, "1.5.0"},
            {{BuiltinOperator_FAKE_QUANT, 1}, "1.5.0"},
            {{BuiltinOperator_FAKE_QUANT, 2}, "1.10.0"},
@@ -15,6 +15,7 @@
 """Benchmarks for `tf.data.Dataset.prefetch()`."""
 from tensorflow.python.data.benchmarks import benchmark_base
 from tensorflow.python.data.ops import dataset_ops
+from tensorflow.python.data.ops import map_op
 
 
 class PrefetchBenchmark(benchmark_base.DatasetBenchmarkBase):
@@ -35,6 +36,37 @@ class PrefetchBenchmark(benchmark_base.DatasetBenchmarkBase):
           },
           name="prefetch_{}".format(prefetch_buffer))
 
+  def benchmark_parallel_map_then_prefetch(self):
+    """Measures the handoff of map outputs into the prefetch buffer.
+
+    The map function is the identity over a wide tuple so that the cost is
+    dominated by passing elements from the `ParallelMapDataset` results into
+    the `PrefetchDataset` buffer rather than by running the function.
+    """
+    num_elements = 100000
+    for fan_out in [1, 10, 100]:
+      for use_inter_op_parallelism in [True, False]:
+        dataset = dataset_ops.Dataset.from_tensors(
+            tuple(0 for _ in range(fan_out))).repeat(num_elements)
+        dataset = map_op._ParallelMapDataset(  # pylint: disable=protected-access
+            dataset,
+            lambda *xs: xs,
+            num_parallel_calls=dataset_ops.AUTOTUNE,
+            deterministic=True,
+            use_inter_op_parallelism=use_inter_op_parallelism)
+        dataset = dataset.prefetch(dataset_ops.AUTOTUNE)
+        label = "" if use_inter_op_parallelism else "_single_threaded"
+
+        self.run_and_report_benchmark(
+            dataset,
+            num_elements=num_elements,
+            extras={
+                "model_name": "prefetch.benchmark.2",
+                "parameters": "%d%s" % (fan_out, label),
+            },
+            name="parallel_map_then_prefetch_fan_out_{}{}".format(
+                fan_out, label))
+
 
 if __name__ == "__main__":
   benchmark_base.test.main()
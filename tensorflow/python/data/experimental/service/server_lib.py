@@ -55,6 +55,7 @@ class DispatcherConfig(
             "job_gc_timeout_ms",
             "worker_timeout_ms",
             "worker_max_concurrent_snapshots",
+            "adaptive_compression",
         ],
     )
 ):
@@ -94,6 +95,12 @@ class DispatcherConfig(
       default.
     worker_max_concurrent_snapshots: The maximum number of snapshots a worker
       can concurrently process.
+    adaptive_compression: Whether to choose the compression codec of each job
+      at runtime, based on the CPU utilization of the workers and the receive
+      throughput of the clients. Saturated workers send elements uncompressed,
+      and workers with spare CPU whose clients are network-bound compress with
+      zstd instead of snappy. Only applies to datasets registered with
+      compression.
   """
 
   def __new__(
@@ -107,6 +114,7 @@ class DispatcherConfig(
       job_gc_timeout_ms=None,
       worker_timeout_ms=None,
       worker_max_concurrent_snapshots=0,
+      adaptive_compression=False,
   ):
     if protocol is None:
       protocol = _pywrap_utils.TF_DATA_DefaultProtocol()
@@ -124,6 +132,7 @@ class DispatcherConfig(
         job_gc_timeout_ms,
         worker_timeout_ms,
         worker_max_concurrent_snapshots,
+        adaptive_compression,
     )
 
 
@@ -199,7 +208,8 @@ class DispatchServer:
           job_gc_check_interval_ms=config.job_gc_check_interval_ms,
           job_gc_timeout_ms=config.job_gc_timeout_ms,
           worker_timeout_ms=config.worker_timeout_ms,
-          worker_max_concurrent_snapshots=config.worker_max_concurrent_snapshots
+          worker_max_concurrent_snapshots=config.worker_max_concurrent_snapshots,
+          adaptive_compression=config.adaptive_compression,
       )
     self._server = _pywrap_server_lib.TF_DATA_NewDispatchServer(
         config_proto.SerializeToString())
@@ -165,6 +165,27 @@ class MultiDeviceIteratorTest(test_base.DatasetTestBase,
       self.evaluate(elem_on_1)
       self.evaluate(elem_on_2)
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          combinations.combine(prefetch_buffer_size=[0, 1, 10])))
+  def testAutotuneMaxBufferSize(self, prefetch_buffer_size):
+    dataset = dataset_ops.Dataset.range(100)
+    multi_device_iterator = multi_device_iterator_ops.MultiDeviceIterator(
+        dataset, [self._devices[1], self._devices[2]],
+        max_buffer_size=dataset_ops.AUTOTUNE,
+        prefetch_buffer_size=prefetch_buffer_size)
+
+    self.evaluate(multi_device_iterator.initializer)
+    for i in range(0, 100, 2):
+      elem_on_1, elem_on_2 = multi_device_iterator.get_next()
+      self.assertEqual(i, self.evaluate(elem_on_1))
+      self.assertEqual(i + 1, self.evaluate(elem_on_2))
+    with self.assertRaises(errors.OutOfRangeError):
+      elem_on_1, elem_on_2 = multi_device_iterator.get_next()
+      self.evaluate(elem_on_1)
+      self.evaluate(elem_on_2)
+
   @combinations.generate(test_base.default_test_combinations())
   def testOneOnSameDevice(self):
     dataset = dataset_ops.Dataset.range(12)
@@ -20,6 +20,7 @@ from tensorflow.python.data.kernel_tests import test_base
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.util import nest
 from tensorflow.python.framework import combinations
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import errors
 from tensorflow.python.framework import ops
 from tensorflow.python.framework import sparse_tensor
@@ -167,5 +168,31 @@ class RaggedBatchTest(test_base.DatasetTestBase, parameterized.TestCase):
       self.assertAllEqual(result['sparse'].dense_shape, [4, 100])
 
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          combinations.combine(
+              row_splits_dtype=[dtypes.int32, dtypes.int64],
+              drop_remainder=[True, False])))
+  def testVaryingFirstDimension(self, row_splits_dtype, drop_remainder):
+    dataset = _make_matrix_ds1(10).ragged_batch(
+        4, drop_remainder=drop_remainder, row_splits_dtype=row_splits_dtype)
+    spec = dataset.element_spec
+    self.assertEqual(spec.shape.as_list(),
+                     [4 if drop_remainder else None, None, 2])
+    self.assertEqual(spec.ragged_rank, 1)
+    self.assertEqual(spec.row_splits_dtype, row_splits_dtype)
+
+    get_next = self.getNext(dataset)
+    for start_row in range(0, 8 if drop_remainder else 10, 4):
+      result = self.evaluate(get_next())
+      rows = range(start_row, min(start_row + 4, 10))
+      self.assertAllEqual(result, [[[r, r]] * r for r in rows])
+      self.assertEqual(result.row_splits.dtype,
+                       row_splits_dtype.as_numpy_dtype)
+    with self.assertRaises(errors.OutOfRangeError):
+      self.evaluate(get_next())
+
+
 if __name__ == '__main__':
   test.main()
@@ -29,8 +29,17 @@ def _cache(input_dataset, filename, name):  # pylint: disable=unused-private-nam
 class CacheDataset(dataset_ops.UnaryUnchangedStructureDataset):
   """A `Dataset` that caches elements of its input."""
 
-  def __init__(self, input_dataset, filename, name=None):
-    """See `Dataset.cache()` for details."""
+  def __init__(self, input_dataset, filename, name=None, ram_budget=0):
+    """See `Dataset.cache()` for details.
+
+    Args:
+      input_dataset: The input dataset.
+      filename: The name of the file used to cache the elements.
+      name: (Optional.) A name for the tf.data operation.
+      ram_budget: (Optional.) If positive, the elements are cached in memory up
+        to this many bytes and the remaining elements are spilled to a
+        memory-mapped file whose name starts with `filename`.
+    """
     self._input_dataset = input_dataset
     self._filename = ops.convert_to_tensor(
         filename, dtype=dtypes.string, name="filename")
@@ -40,10 +49,12 @@ class CacheDataset(dataset_ops.UnaryUnchangedStructureDataset):
           input_dataset._variant_tensor,  # pylint: disable=protected-access
           filename=self._filename,
           cache=gen_dataset_ops.dummy_memory_cache(),
+          ram_budget=ram_budget,
           **self._common_args)
     else:
       variant_tensor = gen_dataset_ops.cache_dataset(
           input_dataset._variant_tensor,  # pylint: disable=protected-access
           filename=self._filename,
+          ram_budget=ram_budget,
           **self._common_args)
     super().__init__(input_dataset, variant_tensor)
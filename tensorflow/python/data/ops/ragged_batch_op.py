@@ -17,7 +17,11 @@ from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import structured_function
 from tensorflow.python.data.util import nest
 from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import ops
 from tensorflow.python.framework import tensor
+from tensorflow.python.framework import tensor_shape
+from tensorflow.python.framework import tensor_util
+from tensorflow.python.ops import gen_experimental_dataset_ops as ged_ops
 from tensorflow.python.ops.ragged import ragged_tensor
 
 
@@ -26,10 +30,77 @@ def _ragged_batch(input_dataset,
                   drop_remainder=False,
                   row_splits_dtype=dtypes.int64,
                   name=None):
+  if _can_batch_as_rows(input_dataset.element_spec):
+    return _DenseToRaggedBatchDataset(input_dataset, batch_size,
+                                      drop_remainder, row_splits_dtype, name)
   ragged_dataset = _DenseToRaggedDataset(input_dataset, row_splits_dtype, name)
   return ragged_dataset.batch(batch_size, drop_remainder)
 
 
+def _can_batch_as_rows(element_spec):
+  """Returns whether `element_spec` can be batched by concatenating rows.
+
+  This holds when every component is a `tf.Tensor` whose only unknown
+  dimension is the first one, in which case each batched component is a
+  `tf.RaggedTensor` with `ragged_rank=1`.
+  """
+  for spec in nest.flatten(element_spec):
+    if (not isinstance(spec, tensor.TensorSpec) or
+        spec.shape.rank is None or
+        spec.shape.rank == 0 or
+        spec.shape[0] is not None or
+        not spec.shape[1:].is_fully_defined()):
+      return False
+  return True
+
+
+class _DenseToRaggedBatchDataset(dataset_ops.UnaryDataset):
+  """A `Dataset` that batches dense rows of varying length as ragged tensors.
+
+  The values of each batch are concatenated in a single copy and its row
+  splits are computed from the row lengths, without encoding every input
+  element as a ragged tensor first.
+  """
+
+  def __init__(self,
+               input_dataset,
+               batch_size,
+               drop_remainder,
+               row_splits_dtype,
+               name=None):
+    self._input_dataset = input_dataset
+    self._batch_size = ops.convert_to_tensor(
+        batch_size, dtype=dtypes.int64, name="batch_size")
+    self._drop_remainder = ops.convert_to_tensor(
+        drop_remainder, dtype=dtypes.bool, name="drop_remainder")
+
+    batch_dim = None
+    if tensor_util.constant_value(self._drop_remainder):
+      batch_dim = tensor_util.constant_value(self._batch_size)
+
+    def to_batched_ragged_spec(spec):
+      return ragged_tensor.RaggedTensorSpec(
+          shape=tensor_shape.TensorShape([batch_dim]).concatenate(spec.shape),
+          dtype=spec.dtype,
+          ragged_rank=1,
+          row_splits_dtype=row_splits_dtype)
+
+    self._structure = nest.map_structure(to_batched_ragged_spec,
+                                         input_dataset.element_spec)
+    self._name = name
+    variant_tensor = ged_ops.dense_to_ragged_batch_dataset(
+        input_dataset._variant_tensor,  # pylint: disable=protected-access
+        batch_size=self._batch_size,
+        drop_remainder=self._drop_remainder,
+        Tsplits=row_splits_dtype,
+        **self._common_args)
+    super().__init__(input_dataset, variant_tensor)
+
+  @property
+  def element_spec(self):
+    return self._structure
+
+
 class _DenseToRaggedDataset(dataset_ops.UnaryDataset):
   """A `Dataset` that encodes dense inputs as ragged (w/ ragged_rank=0).
 
@@ -130,6 +130,33 @@ class TensorArrayTest(test.TestCase):
   def testTensorArrayWritePack(self):
     self._testTensorArrayWritePackMaybeLegacy()
 
+  def testTensorArrayWriteStackGatherFixedElementShape(self):
+    # Fixed-size TensorArrays with a known element shape may keep their
+    # elements in contiguous storage and return stacked views of it.
+    with self.cached_session():
+      ta = tensor_array_ops.TensorArray(
+          dtype=dtypes.float32, size=4, element_shape=[16],
+          clear_after_read=False)
+      values = np.arange(64, dtype=np.float32).reshape(4, 16)
+      for i in range(4):
+        ta = ta.write(i, values[i])
+
+      stacked, gathered, reversed_gathered, r1 = self.evaluate(
+          [ta.stack(), ta.gather([1, 2]), ta.gather([2, 1]), ta.read(1)])
+      self.assertAllEqual(values, stacked)
+      self.assertAllEqual(values[1:3], gathered)
+      self.assertAllEqual(values[[2, 1]], reversed_gathered)
+      self.assertAllEqual(values[1], r1)
+
+  def testTensorArrayStackWithUnwrittenElementsFixedElementShape(self):
+    with self.cached_session():
+      ta = tensor_array_ops.TensorArray(
+          dtype=dtypes.float32, size=3, element_shape=[16])
+      ta = ta.write(0, array_ops.ones([16]))
+      ta = ta.write(2, array_ops.ones([16]))
+      self.assertAllEqual([[1.0] * 16, [0.0] * 16, [1.0] * 16],
+                          self.evaluate(ta.stack()))
+
   def testEmptyTensorArrayPack(self):
     with self.session():
       ta = tensor_array_ops.TensorArray(
@@ -105,6 +105,18 @@ class EinsumOpTest(test.TestCase):
     # Based on https://github.com/google/jax/issues/37#issuecomment-448572187
     self._check('sa,shb->shab', (2, 1), (2, 3, 4))
 
+  def testBinaryOutputFreeDimsOfSecondOperandFirst(self):
+    # These contract with swapped operands to avoid transposing the output.
+    self._check('ij,jk->ki', (3, 4), (4, 5))
+    self._check('ij,kj->ki', (3, 4), (5, 4))
+    self._check('ji,jk->ki', (4, 3), (4, 5))
+    self._check('bij,bjk->bki', (2, 3, 4), (2, 4, 5))
+    self._check('abc,cde->deab', (2, 3, 4), (4, 5, 6))
+    self._check('abc,cde->daeb', (2, 3, 4), (4, 5, 6))
+    self._check('...ij,...jk->...ki', (5, 2, 3), (3, 4))
+    self._check('...ij,...jk->...ki', (2, 3), (1, 3, 4))
+    self._check('ij,jkk->ki', (3, 4), (4, 5, 5))
+
   def testReducedIndices(self):
     self._check('ba,b->', (3, 2), (3,))
     self._check('ab,ab->', (3, 4), (3, 4))
@@ -401,6 +413,8 @@ class EinsumBenchmark(test.Benchmark):
       ['abc,cba->', 100],
       ['bij,bjk->bik', 100],
       ['bji,bjk->bki', 100],
+      ['ij,jk->ki', 1000],
+      ['bij,bjk->bki', 100],
       ['ikl,kji->kl', 100],
       ['klj,lki->ij', 100],
       ['ijk,ilj->kli', 100],
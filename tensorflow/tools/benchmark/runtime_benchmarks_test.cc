@@ -0,0 +1,419 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A single benchmark target covering the runtime hot paths that a release
+// should not regress: executor step overhead, eager op dispatch, tf.data
+// throughput, batch scheduler latency, BFC allocator throughput, RecvTensor
+// transfer and checkpoint bandwidth. See README.md for how to run it and
+// collect machine-readable results.
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "grpcpp/support/byte_buffer.h"
+#include "tensorflow/c/eager/c_api.h"
+#include "tensorflow/c/eager/c_api_test_util.h"
+#include "tensorflow/c/tf_status.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+#include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/control_flow.h"
+#include "tensorflow/core/framework/device_attributes.pb.h"
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/batching_util/basic_batch_scheduler.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+// Executor step overhead: runs a chain of `state.range(0)` Identity nodes
+// through a DirectSession callable, so the time is dominated by per-step and
+// per-node executor costs rather than kernels.
+void BM_ExecutorStep(::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  Scope root = Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output x = ops::Const(root.WithOpName("x_0"), 1.0f);
+  for (int i = 1; i <= num_nodes; ++i) {
+    x = ops::Identity(root.WithOpName(strings::StrCat("x_", i)), x);
+  }
+  GraphDef graph_def;
+  TF_CHECK_OK(root.ToGraphDef(&graph_def));
+
+  SessionOptions options;
+  options.config.mutable_graph_options()
+      ->mutable_optimizer_options()
+      ->set_opt_level(OptimizerOptions::L0);
+  options.config.mutable_graph_options()
+      ->mutable_rewrite_options()
+      ->set_disable_meta_optimizer(true);
+  std::unique_ptr<Session> session(NewSession(options));
+  TF_CHECK_OK(session->Create(graph_def));
+  CallableOptions callable_options;
+  callable_options.add_fetch(strings::StrCat("x_", num_nodes, ":0"));
+  Session::CallableHandle handle;
+  TF_CHECK_OK(session->MakeCallable(callable_options, &handle));
+
+  std::vector<Tensor> outputs;
+  for (auto s : state) {
+    outputs.clear();
+    TF_CHECK_OK(session->RunCallable(handle, {}, &outputs, nullptr));
+  }
+  state.SetItemsProcessed(state.iterations() * (num_nodes + 1));
+  TF_CHECK_OK(session->ReleaseCallable(handle));
+  TF_CHECK_OK(session->Close());
+}
+BENCHMARK(BM_ExecutorStep)->Arg(1)->Arg(16)->Arg(256);
+
+// Eager op dispatch: executes a scalar Identity through the C API, with
+// `state.range(0)` selecting sync (0) or async (1) execution.
+void BM_EagerOpDispatch(::testing::benchmark::State& state) {
+  const int async = state.range(0);
+  state.SetLabel(async ? "ExecuteAsync" : "Execute");
+  TF_Status* status = TF_NewStatus();
+  TFE_ContextOptions* opts = TFE_NewContextOptions();
+  TFE_ContextOptionsSetAsync(opts, static_cast<unsigned char>(async));
+  TFE_Context* ctx = TFE_NewContext(opts, status);
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TFE_DeleteContextOptions(opts);
+
+  TFE_TensorHandle* x = TestScalarTensorHandle(ctx, 1.0f);
+  TFE_Op* identity = TFE_NewOp(ctx, "Identity", status);
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  for (auto s : state) {
+    TFE_OpReset(identity, "Identity", nullptr, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_OpAddInput(identity, x, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_TensorHandle* retval;
+    int num_retvals = 1;
+    TFE_Execute(identity, &retval, &num_retvals, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_DeleteTensorHandle(retval);
+  }
+  if (async) {
+    TFE_Executor* executor = TFE_ContextGetExecutorForThread(ctx);
+    TFE_ExecutorWaitForAllPendingNodes(executor, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_DeleteExecutor(executor);
+  }
+  TFE_DeleteOp(identity);
+  TFE_DeleteTensorHandle(x);
+  TFE_DeleteContext(ctx);
+  TF_DeleteStatus(status);
+}
+BENCHMARK(BM_EagerOpDispatch)->Arg(0)->Arg(1);
+
+constexpr int kDataBatchSize = 32;
+
+void AddInt64Const(const string& name, int64_t value, GraphDef* graph_def) {
+  TF_CHECK_OK(NodeDefBuilder(name, "Const")
+                  .Attr("dtype", DT_INT64)
+                  .Attr("value", Tensor(value))
+                  .Finalize(graph_def->add_node()));
+}
+
+void AddBoolConst(const string& name, bool value, GraphDef* graph_def) {
+  TF_CHECK_OK(NodeDefBuilder(name, "Const")
+                  .Attr("dtype", DT_BOOL)
+                  .Attr("value", Tensor(value))
+                  .Finalize(graph_def->add_node()));
+}
+
+// Returns the graph of an endless tf.data pipeline:
+//  0: range()
+//  1: range().batch(kDataBatchSize, drop_remainder=True)
+//  2: range().batch(kDataBatchSize, drop_remainder=True).prefetch(AUTOTUNE)
+GraphDef MakeDatasetGraph(int pipeline) {
+  GraphDef graph_def;
+  AddInt64Const("start", 0, &graph_def);
+  AddInt64Const("stop", std::numeric_limits<int64_t>::max(), &graph_def);
+  AddInt64Const("step", 1, &graph_def);
+  TF_CHECK_OK(NodeDefBuilder("range", "RangeDataset")
+                  .Input("start", 0, DT_INT64)
+                  .Input("stop", 0, DT_INT64)
+                  .Input("step", 0, DT_INT64)
+                  .Attr("output_types", {DT_INT64})
+                  .Attr("output_shapes", {PartialTensorShape({})})
+                  .Finalize(graph_def.add_node()));
+  string dataset = "range";
+  if (pipeline >= 1) {
+    AddInt64Const("batch_size", kDataBatchSize, &graph_def);
+    AddBoolConst("drop_remainder", true, &graph_def);
+    TF_CHECK_OK(NodeDefBuilder("batch", "BatchDatasetV2")
+                    .Input(dataset, 0, DT_VARIANT)
+                    .Input("batch_size", 0, DT_INT64)
+                    .Input("drop_remainder", 0, DT_BOOL)
+                    .Attr("output_types", {DT_INT64})
+                    .Attr("output_shapes",
+                          {PartialTensorShape({kDataBatchSize})})
+                    .Finalize(graph_def.add_node()));
+    dataset = "batch";
+  }
+  if (pipeline >= 2) {
+    AddInt64Const("buffer_size", /*AUTOTUNE=*/-1, &graph_def);
+    TF_CHECK_OK(NodeDefBuilder("prefetch", "PrefetchDataset")
+                    .Input(dataset, 0, DT_VARIANT)
+                    .Input("buffer_size", 0, DT_INT64)
+                    .Attr("output_types", {DT_INT64})
+                    .Attr("output_shapes",
+                          {PartialTensorShape({kDataBatchSize})})
+                    .Finalize(graph_def.add_node()));
+    dataset = "prefetch";
+  }
+  TF_CHECK_OK(NodeDefBuilder("dataset", "_Retval")
+                  .Input(dataset, 0, DT_VARIANT)
+                  .Attr("T", DT_VARIANT)
+                  .Attr("index", 0)
+                  .Finalize(graph_def.add_node()));
+  return graph_def;
+}
+
+// tf.data throughput of the standard pipelines built by MakeDatasetGraph,
+// reported as dataset elements per second.
+void BM_DatasetElements(::testing::benchmark::State& state) {
+  const int pipeline = state.range(0);
+  std::unique_ptr<data::standalone::Dataset> dataset;
+  TF_CHECK_OK(data::standalone::Dataset::FromGraph(
+      {}, MakeDatasetGraph(pipeline), &dataset));
+  std::unique_ptr<data::standalone::Iterator> iterator;
+  TF_CHECK_OK(dataset->MakeIterator(&iterator));
+
+  std::vector<Tensor> outputs;
+  bool end_of_input = false;
+  for (auto s : state) {
+    outputs.clear();
+    TF_CHECK_OK(iterator->GetNext(&outputs, &end_of_input));
+    CHECK(!end_of_input);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          (pipeline >= 1 ? kDataBatchSize : 1));
+}
+BENCHMARK(BM_DatasetElements)->Arg(0)->Arg(1)->Arg(2);
+
+class LatencyTask : public serving::BatchTask {
+ public:
+  explicit LatencyTask(Notification* done) : done_(done) {}
+
+  size_t size() const override { return 1; }
+
+  void Done() const { done_->Notify(); }
+
+ private:
+  Notification* const done_;
+};
+
+// Batch scheduler latency: a single client schedules one task at a time and
+// waits until its batch is processed, with a batch timeout of
+// `state.range(0)` microseconds.
+void BM_BatchSchedulerLatency(::testing::benchmark::State& state) {
+  serving::BasicBatchScheduler<LatencyTask>::Options options;
+  options.max_batch_size = 8;
+  options.batch_timeout_micros = state.range(0);
+  options.num_batch_threads = 1;
+  std::unique_ptr<serving::BasicBatchScheduler<LatencyTask>> scheduler;
+  TF_CHECK_OK(serving::BasicBatchScheduler<LatencyTask>::Create(
+      options,
+      [](std::unique_ptr<serving::Batch<LatencyTask>> batch) {
+        for (int i = 0; i < batch->num_tasks(); ++i) {
+          batch->task(i).Done();
+        }
+      },
+      &scheduler));
+
+  for (auto s : state) {
+    Notification done;
+    auto task = std::make_unique<LatencyTask>(&done);
+    TF_CHECK_OK(scheduler->Schedule(&task));
+    done.WaitForNotification();
+  }
+}
+BENCHMARK(BM_BatchSchedulerLatency)->Arg(0)->Arg(100)->UseRealTime();
+
+// BFC allocator throughput: allocates and frees batches of
+// `state.range(0)`-byte chunks, with `state.range(1)` bytes of thread cache.
+void BM_BFCAllocator(::testing::benchmark::State& state) {
+  const size_t chunk_bytes = state.range(0);
+  BFCAllocator::Options opts;
+  opts.allow_growth = true;
+  opts.thread_cache_bytes = state.range(1);
+  BFCAllocator allocator(
+      std::make_unique<BasicCPUAllocator>(port::kNUMANoAffinity,
+                                          /*alloc_visitors=*/{},
+                                          /*free_visitors=*/{}),
+      /*total_memory=*/size_t{1} << 32, "runtime_benchmarks_bfc", opts);
+
+  constexpr int kChunksPerIteration = 16;
+  std::vector<void*> chunks(kChunksPerIteration);
+  for (auto s : state) {
+    for (void*& chunk : chunks) {
+      chunk = allocator.AllocateRaw(Allocator::kAllocatorAlignment,
+                                    chunk_bytes);
+    }
+    for (void* chunk : chunks) {
+      allocator.DeallocateRaw(chunk);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kChunksPerIteration);
+}
+BENCHMARK(BM_BFCAllocator)
+    ->ArgPair(256, 0)
+    ->ArgPair(256, 1 << 20)
+    ->ArgPair(64 << 10, 0)
+    ->ArgPair(64 << 10, 1 << 20)
+    ->ArgPair(4 << 20, 0);
+
+Rendezvous::ParsedKey MakeRendezvousKey() {
+  Rendezvous::ParsedKey key;
+  TF_CHECK_OK(Rendezvous::ParseKey(
+      Rendezvous::CreateKey("/job:localhost/replica:0/task:0/cpu:0", 1,
+                            "/job:localhost/replica:0/task:0/cpu:0", "tensor",
+                            FrameAndIter(0, 0)),
+      &key));
+  return key;
+}
+
+// In-process RecvTensor throughput through a local rendezvous, for float
+// tensors of `state.range(0)` elements.
+void BM_LocalRecvTensor(::testing::benchmark::State& state) {
+  Tensor val(DT_FLOAT, TensorShape({state.range(0)}));
+  val.flat<float>().setConstant(1.0f);
+  Rendezvous* rendez = NewLocalRendezvous();
+  Rendezvous::ParsedKey key = MakeRendezvousKey();
+  Rendezvous::Args args;
+  Tensor received;
+  bool is_dead = false;
+  for (auto s : state) {
+    TF_CHECK_OK(rendez->Send(key, args, val, is_dead));
+    TF_CHECK_OK(rendez->Recv(key, args, &received, &is_dead));
+  }
+  state.SetBytesProcessed(state.iterations() * val.TotalBytes());
+  rendez->Unref();
+}
+BENCHMARK(BM_LocalRecvTensor)->Arg(1)->Arg(1 << 10)->Arg(1 << 20);
+
+class CpuDevice : public DeviceBase {
+ public:
+  explicit CpuDevice(Env* env) : DeviceBase(env) {
+    attr_.set_device_type("CPU");
+  }
+
+  const DeviceAttributes& attributes() const override { return attr_; }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return cpu_allocator();
+  }
+
+ private:
+  DeviceAttributes attr_;
+};
+
+// Remote RecvTensor throughput of the wire format: encodes a float tensor of
+// `state.range(0)` elements into a gRPC response and decodes it again, as the
+// worker service and the remote rendezvous do for every transfer.
+void BM_GrpcRecvTensorCoding(::testing::benchmark::State& state) {
+  Tensor val(DT_FLOAT, TensorShape({state.range(0)}));
+  val.flat<float>().setConstant(1.0f);
+  CpuDevice cpu_device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  for (auto s : state) {
+    ::grpc::ByteBuffer buf;
+    grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, val,
+                                   /*require_ack=*/false, &buf);
+    response.ClearTensor();
+    CHECK(GrpcMaybeParseTensorResponse(&buf, &response));
+  }
+  state.SetBytesProcessed(state.iterations() * val.TotalBytes());
+}
+BENCHMARK(BM_GrpcRecvTensorCoding)->Arg(1)->Arg(1 << 10)->Arg(1 << 20);
+
+// Checkpoint save and restore bandwidth for `state.range(0)` float variables
+// of `state.range(1)` elements each, through the tensor bundle format used by
+// SaveV2 and RestoreV2.
+void BM_CheckpointSave(::testing::benchmark::State& state) {
+  const int num_tensors = state.range(0);
+  Tensor val(DT_FLOAT, TensorShape({state.range(1)}));
+  val.flat<float>().setConstant(1.0f);
+  const string prefix =
+      io::JoinPath(testing::TmpDir(), "runtime_benchmarks_save");
+  for (auto s : state) {
+    BundleWriter writer(Env::Default(), prefix);
+    for (int i = 0; i < num_tensors; ++i) {
+      TF_CHECK_OK(writer.Add(strings::StrCat("var_", i), val));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+  state.SetBytesProcessed(state.iterations() * num_tensors * val.TotalBytes());
+}
+BENCHMARK(BM_CheckpointSave)
+    ->ArgPair(1000, 1 << 8)
+    ->ArgPair(16, 1 << 20)
+    ->UseRealTime();
+
+void BM_CheckpointRestore(::testing::benchmark::State& state) {
+  const int num_tensors = state.range(0);
+  Tensor val(DT_FLOAT, TensorShape({state.range(1)}));
+  val.flat<float>().setConstant(1.0f);
+  const string prefix =
+      io::JoinPath(testing::TmpDir(), "runtime_benchmarks_restore");
+  {
+    BundleWriter writer(Env::Default(), prefix);
+    for (int i = 0; i < num_tensors; ++i) {
+      TF_CHECK_OK(writer.Add(strings::StrCat("var_", i), val));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+  Tensor restored(DT_FLOAT, val.shape());
+  for (auto s : state) {
+    BundleReader reader(Env::Default(), prefix);
+    TF_CHECK_OK(reader.status());
+    for (int i = 0; i < num_tensors; ++i) {
+      TF_CHECK_OK(reader.Lookup(strings::StrCat("var_", i), &restored));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * num_tensors * val.TotalBytes());
+}
+BENCHMARK(BM_CheckpointRestore)
+    ->ArgPair(1000, 1 << 8)
+    ->ArgPair(16, 1 << 20)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace tensorflow
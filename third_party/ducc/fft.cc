@@ -14,11 +14,13 @@ limitations under the License.
 ==============================================================================*/
 #include "ducc/google/fft.h"
 
+#include <algorithm>
 #include <complex>
 #include <cstddef>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <memory>
 #include <ostream>
 #include <vector>
 
@@ -123,6 +125,128 @@ void c2r(const std::complex<RealScalar>* in, const Shape& in_shape,
   }
 }
 
+namespace {
+
+template <typename RealScalar>
+class C2CPlan1DImpl : public C2CPlan1D<RealScalar> {
+ public:
+  explicit C2CPlan1DImpl(std::size_t length) : plan_(length) {}
+
+  std::size_t length() const override { return plan_.length(); }
+
+  void c2c(const std::complex<RealScalar>* in, std::ptrdiff_t in_distance,
+           std::complex<RealScalar>* out, std::ptrdiff_t out_distance,
+           std::size_t num_rows, bool forward,
+           RealScalar scale) const override {
+    const std::size_t n = plan_.length();
+    try {
+      for (std::size_t row = 0; row < num_rows; ++row) {
+        // Transform in place in the output row.
+        auto* data = reinterpret_cast<ducc0::Cmplx<RealScalar>*>(
+            out + row * out_distance);
+        std::copy_n(reinterpret_cast<const ducc0::Cmplx<RealScalar>*>(
+                        in + row * in_distance),
+                    n, data);
+        plan_.exec(data, scale, forward);
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << "DUCC FFT c2c failed: " << ex.what() << std::endl;
+      std::abort();
+    }
+  }
+
+ private:
+  ducc0::detail_fft::pocketfft_c<RealScalar> plan_;
+};
+
+template <typename RealScalar>
+class RealPlan1DImpl : public RealPlan1D<RealScalar> {
+ public:
+  explicit RealPlan1DImpl(std::size_t length) : plan_(length) {}
+
+  std::size_t length() const override { return plan_.length(); }
+
+  // The real plan works on rows in FFTPACK halfcomplex order:
+  // r0, r1, i1, r2, i2, ..., with a trailing r(n/2) if n is even.
+  void r2c(const RealScalar* in, std::ptrdiff_t in_distance,
+           std::complex<RealScalar>* out, std::ptrdiff_t out_distance,
+           std::size_t num_rows, RealScalar scale) const override {
+    const std::size_t n = plan_.length();
+    std::vector<RealScalar> buffer(n);
+    try {
+      for (std::size_t row = 0; row < num_rows; ++row) {
+        std::copy_n(in + row * in_distance, n, buffer.data());
+        plan_.exec(buffer.data(), scale, /*fwd=*/true);
+        std::complex<RealScalar>* out_row = out + row * out_distance;
+        out_row[0] = {buffer[0], 0};
+        std::size_t i = 1, k = 1;
+        for (; i + 1 < n; i += 2, ++k) {
+          out_row[k] = {buffer[i], buffer[i + 1]};
+        }
+        if (i < n) {
+          out_row[k] = {buffer[i], 0};
+        }
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << "DUCC FFT r2c failed: " << ex.what() << std::endl;
+      std::abort();
+    }
+  }
+
+  void c2r(const std::complex<RealScalar>* in, std::ptrdiff_t in_distance,
+           RealScalar* out, std::ptrdiff_t out_distance, std::size_t num_rows,
+           RealScalar scale) const override {
+    const std::size_t n = plan_.length();
+    try {
+      for (std::size_t row = 0; row < num_rows; ++row) {
+        const std::complex<RealScalar>* in_row = in + row * in_distance;
+        // Transform in place in the output row.
+        RealScalar* data = out + row * out_distance;
+        data[0] = in_row[0].real();
+        std::size_t i = 1, k = 1;
+        for (; i + 1 < n; i += 2, ++k) {
+          data[i] = in_row[k].real();
+          data[i + 1] = in_row[k].imag();
+        }
+        if (i < n) {
+          data[i] = in_row[k].real();
+        }
+        plan_.exec(data, scale, /*fwd=*/false);
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << "DUCC FFT c2r failed: " << ex.what() << std::endl;
+      std::abort();
+    }
+  }
+
+ private:
+  ducc0::detail_fft::pocketfft_r<RealScalar> plan_;
+};
+
+}  // namespace
+
+template <typename RealScalar>
+std::unique_ptr<const C2CPlan1D<RealScalar>> MakeC2CPlan1D(
+    std::size_t length) {
+  try {
+    return std::make_unique<C2CPlan1DImpl<RealScalar>>(length);
+  } catch (const std::exception& ex) {
+    std::cerr << "DUCC FFT plan creation failed: " << ex.what() << std::endl;
+    std::abort();
+  }
+}
+
+template <typename RealScalar>
+std::unique_ptr<const RealPlan1D<RealScalar>> MakeRealPlan1D(
+    std::size_t length) {
+  try {
+    return std::make_unique<RealPlan1DImpl<RealScalar>>(length);
+  } catch (const std::exception& ex) {
+    std::cerr << "DUCC FFT plan creation failed: " << ex.what() << std::endl;
+    std::abort();
+  }
+}
+
 #define FFT_DEFINITIONS(RealScalar)                                            \
   template void c2c<RealScalar>(                                               \
       const std::complex<RealScalar>* in, const Shape& in_shape,               \
@@ -139,7 +263,11 @@ void c2r(const std::complex<RealScalar>* in, const Shape& in_shape,
                     const Stride& in_stride, RealScalar* out,                  \
                     const Shape& out_shape, const Stride& out_stride,          \
                     const Shape& axes, bool forward, RealScalar scale,         \
-                    Eigen::ThreadPoolInterface* thread_pool)
+                    Eigen::ThreadPoolInterface* thread_pool);                  \
+  template std::unique_ptr<const C2CPlan1D<RealScalar>>                        \
+  MakeC2CPlan1D<RealScalar>(std::size_t length);                               \
+  template std::unique_ptr<const RealPlan1D<RealScalar>>                       \
+  MakeRealPlan1D<RealScalar>(std::size_t length)
 FFT_DEFINITIONS(float);
 FFT_DEFINITIONS(double);
 #undef FFT_DEFINITIONS
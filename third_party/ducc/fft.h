@@ -21,6 +21,7 @@ limitations under the License.
 
 #include <complex>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "unsupported/Eigen/CXX11/ThreadPool"
@@ -50,6 +51,55 @@ void c2r(const std::complex<RealScalar>* in, const Shape& in_shape,
          const Stride& out_stride, const Shape& axes, bool forward,
          RealScalar scale, Eigen::ThreadPoolInterface* thread_pool);
 
+// A reusable plan for complex 1-D transforms of a fixed length, applied to
+// batches of rows. Plans are immutable once created and can be shared between
+// threads. Each call runs on the calling thread only.
+template <typename RealScalar>
+class C2CPlan1D {
+ public:
+  virtual ~C2CPlan1D() = default;
+
+  virtual std::size_t length() const = 0;
+
+  // Transforms `num_rows` rows of length() values. Row `i` is read from
+  // `in + i * in_distance` and written to `out + i * out_distance`.
+  virtual void c2c(const std::complex<RealScalar>* in,
+                   std::ptrdiff_t in_distance, std::complex<RealScalar>* out,
+                   std::ptrdiff_t out_distance, std::size_t num_rows,
+                   bool forward, RealScalar scale) const = 0;
+};
+
+// A reusable plan for real 1-D transforms of a fixed length, applied to
+// batches of rows. The complex side of a transform holds length() / 2 + 1
+// values per row. Same sharing rules as C2CPlan1D.
+template <typename RealScalar>
+class RealPlan1D {
+ public:
+  virtual ~RealPlan1D() = default;
+
+  virtual std::size_t length() const = 0;
+
+  // Forward transform of `num_rows` real rows.
+  virtual void r2c(const RealScalar* in, std::ptrdiff_t in_distance,
+                   std::complex<RealScalar>* out, std::ptrdiff_t out_distance,
+                   std::size_t num_rows, RealScalar scale) const = 0;
+
+  // Backward transform of `num_rows` rows of complex values. The imaginary
+  // parts of the first value, and of the last value if length() is even, are
+  // ignored.
+  virtual void c2r(const std::complex<RealScalar>* in,
+                   std::ptrdiff_t in_distance, RealScalar* out,
+                   std::ptrdiff_t out_distance, std::size_t num_rows,
+                   RealScalar scale) const = 0;
+};
+
+// Creates plans for transforms of `length` > 0 values.
+template <typename RealScalar>
+std::unique_ptr<const C2CPlan1D<RealScalar>> MakeC2CPlan1D(std::size_t length);
+template <typename RealScalar>
+std::unique_ptr<const RealPlan1D<RealScalar>> MakeRealPlan1D(
+    std::size_t length);
+
 #define FFT_DECLARATIONS(RealScalar)                                        \
   extern template void c2c<RealScalar>(                                     \
       const std::complex<RealScalar>* in, const Shape& in_shape,            \
@@ -66,7 +116,11 @@ void c2r(const std::complex<RealScalar>* in, const Shape& in_shape,
       const std::complex<RealScalar>* in, const Shape& in_shape,            \
       const Stride& in_stride, RealScalar* out, const Shape& out_shape,     \
       const Stride& out_stride, const Shape& axes, bool forward,            \
-      RealScalar scale, Eigen::ThreadPoolInterface* thread_pool)
+      RealScalar scale, Eigen::ThreadPoolInterface* thread_pool);           \
+  extern template std::unique_ptr<const C2CPlan1D<RealScalar>>              \
+  MakeC2CPlan1D<RealScalar>(std::size_t length);                            \
+  extern template std::unique_ptr<const RealPlan1D<RealScalar>>             \
+  MakeRealPlan1D<RealScalar>(std::size_t length)
 FFT_DECLARATIONS(float);
 FFT_DECLARATIONS(double);
 #undef FFT_DECLARATIONS
@@ -20,6 +20,7 @@ limitations under the License.
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -487,8 +488,12 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
 
 void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
   {
-    mutex_lock l(kv_mu_);
-    for (const auto& [key, get_kv_callbacks] : get_cb_) {
+    absl::flat_hash_map<std::string, std::vector<StatusOrValueCallback>> get_cb;
+    {
+      mutex_lock l(kv_mu_);
+      get_cb.swap(get_cb_);
+    }
+    for (const auto& [key, get_kv_callbacks] : get_cb) {
       for (const auto& get_kv_callback : get_kv_callbacks) {
         get_kv_callback(errors::Cancelled(
             absl::StrCat("Coordination service is shutting down. Cancelling "
@@ -496,7 +501,6 @@ void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
                          key)));
       }
     }
-    get_cb_.clear();
   }
   {
     mutex_lock l(state_mu_);
@@ -908,18 +912,24 @@ Status CoordinationServiceStandaloneImpl::InsertKeyValue(
     const std::string& key, const std::string& value) {
   VLOG(3) << "InsertKeyValue(): " << key << ": " << value;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  if (kv_store_.find(norm_key) != kv_store_.end()) {
-    return MakeCoordinationError(
-        errors::AlreadyExists("Config key ", key, " already exists."));
-  }
-  kv_store_.emplace(norm_key, value);
-  auto iter = get_cb_.find(norm_key);
-  if (iter != get_cb_.end()) {
-    for (const auto& cb : iter->second) {
-      cb(value);
+  std::vector<StatusOrValueCallback> callbacks;
+  {
+    mutex_lock l(kv_mu_);
+    if (kv_store_.find(norm_key) != kv_store_.end()) {
+      return MakeCoordinationError(
+          errors::AlreadyExists("Config key ", key, " already exists."));
+    }
+    kv_store_.emplace(norm_key, value);
+    auto iter = get_cb_.find(norm_key);
+    if (iter != get_cb_.end()) {
+      callbacks = std::move(iter->second);
+      get_cb_.erase(iter);
     }
-    get_cb_.erase(iter);
+  }
+  // Callbacks respond to RPCs from possibly thousands of waiting tasks, so
+  // they run without blocking other key-value calls.
+  for (const auto& cb : callbacks) {
+    cb(value);
   }
   return OkStatus();
 }
@@ -928,25 +938,32 @@ void CoordinationServiceStandaloneImpl::GetKeyValueAsync(
     const std::string& key, StatusOrValueCallback done) {
   VLOG(3) << "GetKeyValue(): " << key;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  const auto& iter = kv_store_.find(norm_key);
-  if (iter != kv_store_.end()) {
-    done(iter->second);
-    return;
+  std::optional<std::string> value;
+  {
+    tf_shared_lock l(kv_mu_);
+    const auto& iter = kv_store_.find(norm_key);
+    if (iter != kv_store_.end()) {
+      value = iter->second;
+    }
   }
-  auto cb_iter = get_cb_.find(norm_key);
-  if (cb_iter == get_cb_.end()) {
-    cb_iter =
-        get_cb_.emplace(norm_key, std::vector<StatusOrValueCallback>()).first;
+  if (!value.has_value()) {
+    mutex_lock l(kv_mu_);
+    // The key may have been inserted after the shared lock was released.
+    const auto& iter = kv_store_.find(norm_key);
+    if (iter == kv_store_.end()) {
+      get_cb_[norm_key].emplace_back(std::move(done));
+      return;
+    }
+    value = iter->second;
   }
-  cb_iter->second.emplace_back(std::move(done));
+  done(*std::move(value));
 }
 
 StatusOr<std::string> CoordinationServiceStandaloneImpl::TryGetKeyValue(
     const std::string& key) {
   VLOG(3) << "TryGetKeyValue(): " << key;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
+  tf_shared_lock l(kv_mu_);
   const auto& iter = kv_store_.find(norm_key);
   if (iter == kv_store_.end()) {
     return errors::NotFound("Config key ", key, " not found.");
@@ -961,10 +978,10 @@ std::vector<KeyValueEntry> CoordinationServiceStandaloneImpl::GetKeyValueDir(
   const std::string norm_key = NormalizeKey(directory_key);
   const std::string dir = absl::StrCat(norm_key, "/");
 
-  mutex_lock l(kv_mu_);
+  tf_shared_lock l(kv_mu_);
   // Find first key in ordered map that has the directory prefix.
   auto begin = kv_store_.lower_bound(dir);
-  std::map<std::string, std::string>::iterator it;
+  std::map<std::string, std::string>::const_iterator it;
   // Iterate through key range that match directory prefix.
   for (it = begin; it != kv_store_.end(); ++it) {
     // Stop once the next key does not have the directory prefix. Since keys are
@@ -568,6 +568,34 @@ TEST(CoordinationServiceTest, TryGetKeyValue) {
   EXPECT_TRUE(absl::IsNotFound(result.status()));
 }
 
+TEST_F(CoordinateTwoTasksTest, GetKeyValueCallbackCanAccessKeyValueStore) {
+  EnableCoordinationService();
+
+  // The pending callback inserts another key once `key0` becomes available,
+  // which requires the store not to be locked while callbacks run.
+  absl::Notification n;
+  coord_service_->GetKeyValueAsync(
+      "key0", [&](const StatusOr<std::string>& status_or_value) {
+        TF_EXPECT_OK(status_or_value.status());
+        TF_EXPECT_OK(coord_service_->InsertKeyValue("key1", "value1"));
+        n.Notify();
+      });
+  TF_ASSERT_OK(coord_service_->InsertKeyValue("key0", "value0"));
+  n.WaitForNotification();
+
+  // Same for a key that is already available.
+  StatusOr<std::string> ret;
+  absl::Notification n2;
+  coord_service_->GetKeyValueAsync(
+      "key1", [&](const StatusOr<std::string>& status_or_value) {
+        ret = coord_service_->TryGetKeyValue("key0");
+        n2.Notify();
+      });
+  n2.WaitForNotification();
+  TF_ASSERT_OK(ret.status());
+  EXPECT_EQ(ret.value(), "value0");
+}
+
 TEST_F(CoordinateTwoTasksTest, GetKeyValueDir_SingleValueInDirectory) {
   EnableCoordinationService();
   KeyValueEntry kv = CreateKv("dir/path", "value0");
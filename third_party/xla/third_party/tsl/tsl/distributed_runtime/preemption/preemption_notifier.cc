@@ -19,6 +19,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
@@ -106,26 +107,34 @@ StatusOr<absl::Time> PreemptionNotifier::WillBePreemptedAt() {
 }
 
 void PreemptionNotifier::WillBePreemptedAtAsync(PreemptTimeCallback callback) {
-  mutex_lock l(mu_);
-  if (death_time_ == kUnsetDeathTime) {
-    // Did not receive preemption notice yet.
-    callbacks_.push_back(std::move(callback));
-  } else {
-    // Already received preemption notice, respond immediately.
-    callback(death_time_);
+  absl::Time death_time;
+  {
+    mutex_lock l(mu_);
+    if (death_time_ == kUnsetDeathTime) {
+      // Did not receive preemption notice yet.
+      callbacks_.push_back(std::move(callback));
+      return;
+    }
+    death_time = death_time_;
   }
+  // Already received preemption notice, respond immediately.
+  callback(death_time);
 }
 
 void PreemptionNotifier::NotifyRegisteredListeners(
     StatusOr<absl::Time> death_time) {
-  mutex_lock l(mu_);
-  if (death_time.ok()) {
-    death_time_ = death_time.value();
+  std::vector<PreemptTimeCallback> callbacks;
+  {
+    mutex_lock l(mu_);
+    if (death_time.ok()) {
+      death_time_ = death_time.value();
+      preempted_.store(true, std::memory_order_release);
+    }
+    callbacks.swap(callbacks_);
   }
-  for (const auto& callback : callbacks_) {
+  for (const auto& callback : callbacks) {
     callback(death_time);
   }
-  callbacks_.clear();
 }
 
 REGISTER_PREEMPTION_NOTIFIER(
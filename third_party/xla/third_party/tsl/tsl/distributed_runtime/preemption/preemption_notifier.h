@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_DISTRIBUTED_RUNTIME_PREEMPTION_PREEMPTION_NOTIFIER_H_
 #define TENSORFLOW_TSL_DISTRIBUTED_RUNTIME_PREEMPTION_PREEMPTION_NOTIFIER_H_
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -118,10 +119,19 @@ class PreemptionNotifier {
   // receives the preemption notification.
   // If no death time is specified, absl::Now() is specified as input.
   // Note: callback should be kept as simple and fast as possible (e.g. simply
-  // retrieve result). It should not wait for work done by another callback, and
-  // invoke ahy PreemptionNotifier method (e.g. Reset(), destructor).
+  // retrieve result or schedule an emergency save on another thread). It should
+  // not wait for work done by another callback, or destroy the notifier.
+  // Callbacks run without holding the notifier's lock, so they may call
+  // IsPreempted() and WillBePreemptedAtAsync().
   void WillBePreemptedAtAsync(PreemptTimeCallback callback);
 
+  // Returns true once the preemption notice has been received. Does not block
+  // or take a lock, so that long-running loops (e.g. training steps) can poll
+  // it to stop cooperatively and save their state before the death time.
+  bool IsPreempted() const {
+    return preempted_.load(std::memory_order_acquire);
+  }
+
  protected:
   Env* GetEnv() { return env_; }
   // Invokes all pending callbacks upon receipt of preemption notice with death
@@ -139,6 +149,8 @@ class PreemptionNotifier {
   Env* env_;  // Not owned.
   mutex mu_;
   absl::Time death_time_ TF_GUARDED_BY(mu_) = absl::InfinitePast();
+  // Set together with death_time_, readable without mu_.
+  std::atomic<bool> preempted_{false};
   std::vector<PreemptTimeCallback> callbacks_ TF_GUARDED_BY(mu_);
 };
 
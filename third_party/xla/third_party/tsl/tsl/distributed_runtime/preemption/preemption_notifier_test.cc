@@ -128,6 +128,44 @@ TEST_F(PreemptNotifierTest, WillBePreemptedAtAsync_SameResultForAllCallbacks) {
   EXPECT_EQ(preempt_time.value(), preempt_time_2.value());
 }
 
+TEST_F(PreemptNotifierTest, IsPreempted) {
+  auto env = Env::Default();
+  std::unique_ptr<PreemptionNotifier> preempt_notifier =
+      PreemptionNotifier::CreatePreemptionNotifier("sigterm", env);
+  EXPECT_FALSE(preempt_notifier->IsPreempted());
+
+  std::raise(SIGTERM);
+  TF_CHECK_OK(preempt_notifier->WillBePreemptedAt().status());
+  EXPECT_TRUE(preempt_notifier->IsPreempted());
+}
+
+TEST_F(PreemptNotifierTest, WillBePreemptedAtAsync_CallbackCanUseNotifier) {
+  auto env = Env::Default();
+  std::unique_ptr<PreemptionNotifier> preempt_notifier =
+      PreemptionNotifier::CreatePreemptionNotifier("sigterm", env);
+  env->SchedClosureAfter(/*micros=*/absl::ToInt64Microseconds(absl::Seconds(1)),
+                         []() { std::raise(SIGTERM); });
+
+  // The callback queries the notifier again, e.g. as an emergency save that is
+  // kicked off on preemption would.
+  bool preempted = false;
+  StatusOr<absl::Time> nested_result;
+  absl::Notification n;
+  preempt_notifier->WillBePreemptedAtAsync(
+      [&](StatusOr<absl::Time> result) {
+        preempted = preempt_notifier->IsPreempted();
+        preempt_notifier->WillBePreemptedAtAsync(
+            [&](StatusOr<absl::Time> nested) {
+              nested_result = nested;
+              n.Notify();
+            });
+      });
+  n.WaitForNotification();
+
+  EXPECT_TRUE(preempted);
+  TF_CHECK_OK(nested_result.status());
+}
+
 TEST_F(PreemptNotifierTest, Reset_TwoDifferentPreemptTimesRecorded) {
   auto env = Env::Default();
   std::unique_ptr<PreemptionNotifier> preempt_notifier =
@@ -407,6 +407,11 @@ class SubAllocator {
   // returned by this allocator.
   virtual bool SupportsCoalescing() const = 0;
 
+  // Returns the granularity of the ranges that Free() can release out of the
+  // memory returned by Alloc(): any range whose bounds are multiples of it.
+  // Returns 0 if Free() can only release whole allocations.
+  virtual size_t ReleaseGranularity() const { return 0; }
+
   // Returns the type of the memory allocated by this SubAllocator.
   virtual AllocatorMemoryType GetMemoryType() const {
     return AllocatorMemoryType::kUnknown;
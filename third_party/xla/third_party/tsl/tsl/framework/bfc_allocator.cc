@@ -17,12 +17,17 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "tsl/framework/allocator_retry.h"
+#include "tsl/framework/metrics.h"
 #include "tsl/lib/core/bits.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/file_system.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/mutex.h"
@@ -33,6 +38,7 @@ limitations under the License.
 #include "tsl/platform/types.h"
 #include "tsl/profiler/lib/scoped_memory_debug_annotation.h"
 #include "tsl/profiler/lib/traceme.h"
+#include "tsl/profiler/protobuf/profile.pb.h"
 #include "tsl/protobuf/bfc_memory_map.pb.h"
 
 namespace tsl {
@@ -66,6 +72,10 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
   memory_limit_ = total_memory;
   stats_.bytes_limit = static_cast<int64_t>(total_memory);
 
+  if (opts.thread_cache_bytes > 0 && !opts.record_allocation_sites) {
+    thread_caches_.reset(new ThreadCache[kNumThreadCaches]);
+  }
+
   // Create a bunch of bins of various good sizes.
 
   // We create bins to fit all possible ranges that cover the
@@ -230,6 +240,9 @@ void BFCAllocator::DeallocateChunk(ChunkHandle h) {
   Chunk* c = ChunkFromHandle(h);
   c->allocation_id = -1;
   c->bin_num = kInvalidBinNum;
+  c->freed_on_stream = nullptr;
+  c->stream_event.reset();
+  c->allocation_site = -1;
   c->next = free_chunks_list_;
   free_chunks_list_ = h;
 }
@@ -264,6 +277,18 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                 const AllocationAttributes& allocation_attr) {
   VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes;
+  if (allocation_attr.freed_by_func == nullptr) {
+    void* result = AllocateFromThreadCache(num_bytes);
+    if (result != nullptr) {
+      VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes << " " << result
+              << " from thread cache";
+      return result;
+    }
+  }
+  const uint64 call_index =
+      num_allocate_calls_.fetch_add(1, std::memory_order_relaxed);
+  const bool sample_metrics = call_index % kMetricsSamplingPeriod == 0;
+  const uint64 start_us = sample_metrics ? Env::Default()->NowMicros() : 0;
   void* result = [&] {
     if (!opts_.allow_retry_on_failure || !allocation_attr.retry_on_failure) {
       // If we have globally disabled retry-on-failure and fail to allocate an
@@ -310,10 +335,24 @@ void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                           allocation_attr);
     }
   }();
+  if (sample_metrics) {
+    RecordSampledMetrics(Env::Default()->NowMicros() - start_us);
+  }
   VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes << " " << result;
   return result;
 }
 
+void BFCAllocator::RecordSampledMetrics(uint64 latency_usecs) {
+  metrics::UpdateBfcAllocatorAllocationLatency(name_, latency_usecs);
+  mutex_lock l(lock_);
+  const int64_t pool_bytes = *stats_.pool_bytes;
+  // GetFragmentation() is undefined while nothing is free.
+  const double fragmentation =
+      pool_bytes > stats_.bytes_in_use ? GetFragmentation() : 0.0;
+  metrics::UpdateBfcAllocatorMemoryStats(name_, stats_.bytes_in_use,
+                                         pool_bytes, fragmentation);
+}
+
 // static
 size_t BFCAllocator::RoundedBytes(size_t bytes) {
   size_t rounded_bytes =
@@ -338,7 +377,8 @@ bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes)
     bool any_use = false;
     while (h != kInvalidChunkHandle) {
       const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
+      // A chunk freed on a stream may still be used by the stream.
+      if (c->in_use() || c->stream_event != nullptr) {
         any_use = true;
         break;
       }
@@ -407,6 +447,16 @@ void BFCAllocator::DeallocateRegions(
       DeleteChunk(h_to_delete);
     }
 
+    // Forget the chunks of the region that were freed on a stream.
+    for (auto& [stream, ptrs] : stream_pending_chunks_) {
+      ptrs.erase(std::remove_if(ptrs.begin(), ptrs.end(),
+                                [&it](const void* ptr) {
+                                  return ptr >= it->ptr() &&
+                                         ptr < it->end_ptr();
+                                }),
+                 ptrs.end());
+    }
+
     // Deallocate the memory.
     sub_allocator_->Free(it->ptr(), it->memory_size());
     *stats_.pool_bytes -= it->memory_size();
@@ -414,6 +464,94 @@ void BFCAllocator::DeallocateRegions(
   }
 }
 
+bool BFCAllocator::ReleaseFreePages(size_t rounded_bytes) {
+  const size_t page_size = sub_allocator_->ReleaseGranularity();
+  if (!opts_.defragmentation || page_size == 0) {
+    return false;
+  }
+
+  // Find the free chunks that cover whole pages. The chunks that the GPU may
+  // still use are skipped.
+  struct PageRange {
+    ChunkHandle h;
+    std::uintptr_t begin;
+    std::uintptr_t end;
+  };
+  std::vector<PageRange> ranges;
+  size_t releasable_bytes = 0;
+  for (BinNum b = 0; b < kNumBins; b++) {
+    for (const ChunkHandle h : BinFromIndex(b)->free_chunks) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->freed_at_count > 0 || c->stream_event != nullptr) {
+        continue;
+      }
+      const std::uintptr_t ptr = reinterpret_cast<std::uintptr_t>(c->ptr);
+      const std::uintptr_t begin =
+          (ptr + page_size - 1) / page_size * page_size;
+      const std::uintptr_t end = (ptr + c->size) / page_size * page_size;
+      if (begin < end) {
+        ranges.push_back({h, begin, end});
+        releasable_bytes += end - begin;
+      }
+    }
+  }
+
+  // Only release pages if the allocation then fits.
+  const size_t available_bytes = memory_limit_ - *stats_.pool_bytes;
+  if (ranges.empty() || rounded_bytes > available_bytes + releasable_bytes) {
+    return false;
+  }
+
+  // Release the largest ranges first, to split as few regions as possible.
+  std::sort(ranges.begin(), ranges.end(),
+            [](const PageRange& a, const PageRange& b) {
+              return a.end - a.begin > b.end - b.begin;
+            });
+  size_t released_bytes = 0;
+  for (const PageRange& range : ranges) {
+    if (rounded_bytes <= memory_limit_ - *stats_.pool_bytes) {
+      break;
+    }
+    void* begin = reinterpret_cast<void*>(range.begin);
+    const size_t size = range.end - range.begin;
+
+    // Split off the parts of the chunk outside of the pages.
+    ChunkHandle h = range.h;
+    RemoveFreeChunkFromBin(h);
+    const std::uintptr_t chunk_ptr =
+        reinterpret_cast<std::uintptr_t>(ChunkFromHandle(h)->ptr);
+    if (range.begin > chunk_ptr) {
+      SplitChunk(h, range.begin - chunk_ptr);
+      InsertFreeChunkIntoBin(h);
+      h = ChunkFromHandle(h)->next;
+      RemoveFreeChunkFromBin(h);
+    }
+    if (ChunkFromHandle(h)->size > size) {
+      SplitChunk(h, size);
+    }
+
+    // Unlink the chunk from its neighbors, which end up in different regions.
+    Chunk* c = ChunkFromHandle(h);
+    if (c->prev != kInvalidChunkHandle) {
+      ChunkFromHandle(c->prev)->next = kInvalidChunkHandle;
+    }
+    if (c->next != kInvalidChunkHandle) {
+      ChunkFromHandle(c->next)->prev = kInvalidChunkHandle;
+    }
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRange(begin, size);
+
+    sub_allocator_->Free(begin, size);
+    *stats_.pool_bytes -= size;
+    released_bytes += size;
+  }
+
+  VLOG(1) << "Released " << strings::HumanReadableNumBytes(released_bytes)
+          << " of free pages for " << Name() << " to allocate "
+          << strings::HumanReadableNumBytes(rounded_bytes) << ".";
+  return true;
+}
+
 void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
                                         size_t num_bytes,
                                         bool dump_log_on_failure,
@@ -435,6 +573,9 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     // Merge timestamped chunks whose counts have become safe for general use.
     MergeTimestampedChunks(0);
   }
+  if (!stream_pending_chunks_.empty()) {
+    PollStreamEvents();
+  }
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
   if (ptr != nullptr) {
     AddTraceMe("MemoryAllocation", ptr);
@@ -450,6 +591,16 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     }
   }
 
+  // Take back the free chunks held by the thread caches, which may coalesce
+  // into a chunk that fits.
+  if (FlushThreadCaches()) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      AddTraceMe("MemoryAllocation", ptr);
+      return ptr;
+    }
+  }
+
   if ((freed_before == 0) && (!timestamped_chunks_.empty())) {
     // We're unable to satisfy an allocation request without a specific
     // timestamp requirement.  Rather than fail, try merging any held-out
@@ -477,6 +628,18 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     }
   }
 
+  // The free memory may be enough but too fragmented. Give back the pages of
+  // the free chunks, so that the sub allocator maps them again behind a new
+  // region that fits.
+  if (ReleaseFreePages(rounded_bytes) &&
+      Extend(unused_alignment, rounded_bytes)) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      AddTraceMe("MemoryAllocation", ptr);
+      return ptr;
+    }
+  }
+
   // We searched all bins for an existing free chunk to use and
   // couldn't find one.  This means we must have run out of memory,
   // Dump the memory log for analysis.
@@ -556,7 +719,8 @@ void BFCAllocator::AddTraceMe(absl::string_view traceme_name,
 }
 
 void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
-                                 size_t num_bytes, uint64 freed_before) {
+                                 size_t num_bytes, uint64 freed_before,
+                                 const void* stream) {
   // First identify the first bin that could satisfy rounded_bytes.
   for (; bin_num < kNumBins; bin_num++) {
     // Start searching from the first bin for the smallest chunk that fits
@@ -570,6 +734,9 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
       if (freed_before > 0 && freed_before < chunk->freed_at_count) {
         continue;
       }
+      if (chunk->stream_event != nullptr && chunk->freed_on_stream != stream) {
+        continue;
+      }
       if (chunk->size >= rounded_bytes) {
         // We found an existing chunk that fits us that wasn't in use, so remove
         // it from the free bin structure prior to using.
@@ -591,6 +758,11 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
           chunk = ChunkFromHandle(h);  // Update chunk pointer in case it moved
         }
 
+        // The stream runs the work of the new user after that of the
+        // previous one.
+        chunk->freed_on_stream = nullptr;
+        chunk->stream_event.reset();
+
         // The requested size of the returned chunk is what the user
         // has allocated.
         chunk->requested_size = num_bytes;
@@ -609,6 +781,18 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
             std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
         stats_.largest_alloc_size =
             std::max<std::size_t>(stats_.largest_alloc_size, chunk->size);
+        if (thread_caches_ != nullptr) {
+          AddLiveBytes(chunk->size);
+        }
+        if (opts_.record_allocation_sites) {
+          chunk->allocation_site = CurrentAllocationSite();
+          AllocationSite& site = allocation_sites_[chunk->allocation_site];
+          site.live_bytes += chunk->size;
+          ++site.live_chunks;
+          if (stats_.bytes_in_use == stats_.peak_bytes_in_use) {
+            allocation_sites_at_peak_ = true;
+          }
+        }
 
 #ifdef TENSORFLOW_MEM_DEBUG
         if (ShouldRecordOpName()) {
@@ -665,6 +849,14 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
   // It inherits the freed time.
   new_chunk->freed_at_count = c->freed_at_count;
 
+  // And the stream it was freed on.
+  new_chunk->freed_on_stream = c->freed_on_stream;
+  new_chunk->stream_event = c->stream_event;
+  if (new_chunk->stream_event != nullptr) {
+    stream_pending_chunks_[new_chunk->freed_on_stream].push_back(
+        new_chunk->ptr);
+  }
+
   // Maintain the pointers.
   // c <-> c_neighbor becomes
   // c <-> new_chunk <-> c_neighbor
@@ -684,11 +876,93 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(3) << "DeallocateRaw " << Name() << " "
           << (ptr ? RequestedSize(ptr) : 0);
-  DeallocateRawInternal(ptr);
+  if (!DeallocateToThreadCache(ptr)) {
+    DeallocateRawInternal(ptr, /*stream=*/nullptr, /*event=*/nullptr);
+  }
   retry_helper_.NotifyDealloc();
 }
 
-void BFCAllocator::DeallocateRawInternal(void* ptr) {
+void* BFCAllocator::AllocateRawOnStream(
+    size_t unused_alignment, size_t num_bytes, const void* stream,
+    const AllocationAttributes& allocation_attr) {
+  CHECK(stream != nullptr);
+  if (num_bytes > 0) {
+    const size_t rounded_bytes = RoundedBytes(num_bytes);
+    uint64 freed_by_count = 0;
+    if (allocation_attr.freed_by_func != nullptr) {
+      freed_by_count = (*allocation_attr.freed_by_func)();
+    }
+    mutex_lock l(lock_);
+    if (!stream_pending_chunks_.empty()) {
+      PollStreamEvents();
+    }
+    // Only the chunks still pending on the stream need a dedicated search,
+    // AllocateRaw looks at the others.
+    if (stream_pending_chunks_.contains(stream)) {
+      void* ptr = FindChunkPtr(BinNumForSize(rounded_bytes), rounded_bytes,
+                               num_bytes, freed_by_count, stream);
+      if (ptr != nullptr) {
+        AddTraceMe("MemoryAllocation", ptr);
+        VLOG(3) << "AllocateRawOnStream " << Name() << "  " << num_bytes << " "
+                << ptr;
+        return ptr;
+      }
+    }
+  }
+  return AllocateRaw(unused_alignment, num_bytes, allocation_attr);
+}
+
+void BFCAllocator::DeallocateRawOnStream(void* ptr, const void* stream,
+                                         std::unique_ptr<StreamEvent> event) {
+  CHECK(stream != nullptr);
+  if (event == nullptr || event->IsComplete()) {
+    DeallocateRaw(ptr);
+    return;
+  }
+  VLOG(3) << "DeallocateRawOnStream " << Name() << " "
+          << (ptr ? RequestedSize(ptr) : 0);
+  if (ptr != nullptr) {
+    UntrackThreadCachedChunk(ptr);
+  }
+  DeallocateRawInternal(ptr, stream, std::move(event));
+  retry_helper_.NotifyDealloc();
+}
+
+void BFCAllocator::PollStreamEvents() {
+  for (auto it = stream_pending_chunks_.begin();
+       it != stream_pending_chunks_.end();) {
+    const void* stream = it->first;
+    std::deque<void*>& ptrs = it->second;
+    while (!ptrs.empty()) {
+      // The chunk may have been reused on its stream, and freed again, since.
+      ChunkHandle h = region_manager_.get_handle(ptrs.front());
+      if (h != kInvalidChunkHandle) {
+        Chunk* c = ChunkFromHandle(h);
+        if (!c->in_use() && c->stream_event != nullptr &&
+            c->freed_on_stream == stream) {
+          // The events of a stream complete in order, so the chunks freed
+          // after this one are still pending too.
+          if (!c->stream_event->IsComplete()) {
+            break;
+          }
+          c->freed_on_stream = nullptr;
+          c->stream_event.reset();
+          RemoveFreeChunkFromBin(h);
+          InsertFreeChunkIntoBin(TryToCoalesce(h, false));
+        }
+      }
+      ptrs.pop_front();
+    }
+    if (ptrs.empty()) {
+      stream_pending_chunks_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void BFCAllocator::DeallocateRawInternal(void* ptr, const void* stream,
+                                         std::shared_ptr<StreamEvent> event) {
   if (ptr == nullptr) {
     VLOG(2) << "tried to deallocate nullptr";
     return;
@@ -704,10 +978,24 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   int64_t req_bytes = chunk->requested_size;
   int64_t alloc_bytes = chunk->size;
 
+  if (thread_caches_ != nullptr) {
+    AddLiveBytes(-alloc_bytes);
+  }
+  if (event == nullptr && CacheFreedChunk(h)) {
+    return;
+  }
+
   MarkFree(h);
 
   // Consider coalescing it.
-  if (timing_counter_) {
+  if (event != nullptr) {
+    // Stays apart until the stream is done with it.
+    chunk = ChunkFromHandle(h);
+    chunk->freed_on_stream = stream;
+    chunk->stream_event = std::move(event);
+    InsertFreeChunkIntoBin(h);
+    stream_pending_chunks_[stream].push_back(chunk_ptr);
+  } else if (timing_counter_) {
     InsertFreeChunkIntoBin(h);
     timestamped_chunks_.push_back(h);
   } else {
@@ -723,6 +1011,190 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   }
 }
 
+BFCAllocator::ThreadCache* BFCAllocator::HomeThreadCache() const {
+  // Spreads the threads over the caches in the order they first get here.
+  static std::atomic<int> next_cache{0};
+  thread_local const int cache =
+      next_cache.fetch_add(1, std::memory_order_relaxed) % kNumThreadCaches;
+  return &thread_caches_[cache];
+}
+
+BFCAllocator::ThreadCache* BFCAllocator::OwnerThreadCache(
+    const void* ptr) const {
+  return &thread_caches_[(reinterpret_cast<uintptr_t>(ptr) >>
+                          kMinAllocationBits) %
+                         kNumThreadCaches];
+}
+
+bool BFCAllocator::FindThreadCachedChunk(const void* ptr,
+                                         CachedChunkInfo* info) const {
+  if (thread_caches_ == nullptr) {
+    return false;
+  }
+  ThreadCache* owner = OwnerThreadCache(ptr);
+  mutex_lock l(owner->mu);
+  auto it = owner->chunks.find(ptr);
+  if (it == owner->chunks.end()) {
+    return false;
+  }
+  *info = it->second;
+  return true;
+}
+
+bool BFCAllocator::PushThreadCachedChunk(void* ptr, size_t size) {
+  ThreadCache* home = HomeThreadCache();
+  mutex_lock l(home->mu);
+  if (home->free_bytes + size > opts_.thread_cache_bytes) {
+    return false;
+  }
+  home->free_chunks[BinNumForSize(size)].push_back({ptr, size});
+  home->free_bytes += size;
+  return true;
+}
+
+void* BFCAllocator::AllocateFromThreadCache(size_t num_bytes) {
+  if (!ThreadCacheEnabled() || num_bytes == 0) {
+    return nullptr;
+  }
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  if (rounded_bytes > kMaxThreadCachedChunkBytes) {
+    return nullptr;
+  }
+  CachedChunk chunk;
+  {
+    ThreadCache* home = HomeThreadCache();
+    mutex_lock l(home->mu);
+    std::vector<CachedChunk>& free_chunks =
+        home->free_chunks[BinNumForSize(rounded_bytes)];
+    // Prefers the most recently freed chunks, which are likely still in the
+    // cache of the CPU.
+    auto it = std::find_if(free_chunks.rbegin(), free_chunks.rend(),
+                           [rounded_bytes](const CachedChunk& c) {
+                             return c.size >= rounded_bytes;
+                           });
+    if (it == free_chunks.rend()) {
+      return nullptr;
+    }
+    chunk = *it;
+    free_chunks.erase(std::next(it).base());
+    home->free_bytes -= chunk.size;
+  }
+  {
+    ThreadCache* owner = OwnerThreadCache(chunk.ptr);
+    mutex_lock l(owner->mu);
+    auto it = owner->chunks.find(chunk.ptr);
+    CHECK(it != owner->chunks.end());
+    it->second.requested_size = num_bytes;
+    it->second.allocation_id = next_allocation_id_++;
+  }
+  num_thread_cache_allocs_.fetch_add(1, std::memory_order_relaxed);
+  AddLiveBytes(chunk.size);
+  return chunk.ptr;
+}
+
+bool BFCAllocator::DeallocateToThreadCache(void* ptr) {
+  if (ptr == nullptr || !ThreadCacheEnabled()) {
+    return false;
+  }
+  ThreadCache* owner = OwnerThreadCache(ptr);
+  size_t size;
+  {
+    mutex_lock l(owner->mu);
+    auto it = owner->chunks.find(ptr);
+    if (it == owner->chunks.end()) {
+      // DeallocateRawInternal may still hand it to the thread caches.
+      return false;
+    }
+    size = it->second.size;
+  }
+  if (PushThreadCachedChunk(ptr, size)) {
+    AddLiveBytes(-static_cast<int64_t>(size));
+    return true;
+  }
+  // The thread cache is full, so the chunk goes back to the bins.
+  UntrackThreadCachedChunk(ptr);
+  return false;
+}
+
+void BFCAllocator::UntrackThreadCachedChunk(const void* ptr) {
+  if (thread_caches_ == nullptr) {
+    return;
+  }
+  ThreadCache* owner = OwnerThreadCache(ptr);
+  mutex_lock l(owner->mu);
+  owner->chunks.erase(ptr);
+}
+
+bool BFCAllocator::CacheFreedChunk(ChunkHandle h) {
+  const Chunk* chunk = ChunkFromHandle(h);
+  if (!ThreadCacheEnabled() || chunk->size > kMaxThreadCachedChunkBytes) {
+    return false;
+  }
+  // The chunk must be known to the owner before another thread can take it
+  // from the free chunks of the home cache.
+  ThreadCache* owner = OwnerThreadCache(chunk->ptr);
+  {
+    mutex_lock l(owner->mu);
+    owner->chunks[chunk->ptr] = {chunk->size, chunk->requested_size,
+                                 chunk->allocation_id};
+  }
+  if (PushThreadCachedChunk(chunk->ptr, chunk->size)) {
+    return true;
+  }
+  mutex_lock l(owner->mu);
+  owner->chunks.erase(chunk->ptr);
+  return false;
+}
+
+bool BFCAllocator::FlushThreadCaches() {
+  if (thread_caches_ == nullptr) {
+    return false;
+  }
+  std::vector<CachedChunk> flushed;
+  for (int i = 0; i < kNumThreadCaches; ++i) {
+    ThreadCache& cache = thread_caches_[i];
+    mutex_lock l(cache.mu);
+    for (std::vector<CachedChunk>& free_chunks : cache.free_chunks) {
+      flushed.insert(flushed.end(), free_chunks.begin(), free_chunks.end());
+      free_chunks.clear();
+    }
+    cache.free_bytes = 0;
+  }
+  for (const CachedChunk& c : flushed) {
+    {
+      ThreadCache* owner = OwnerThreadCache(c.ptr);
+      mutex_lock l(owner->mu);
+      owner->chunks.erase(c.ptr);
+    }
+    // Cached chunks are in use, so they were neither split nor merged.
+    BFCAllocator::ChunkHandle h = region_manager_.get_handle(c.ptr);
+    CHECK(h != kInvalidChunkHandle);
+    MarkFree(h);
+    if (timing_counter_) {
+      InsertFreeChunkIntoBin(h);
+      timestamped_chunks_.push_back(h);
+    } else {
+      InsertFreeChunkIntoBin(TryToCoalesce(h, false));
+    }
+  }
+  if (flushed.empty()) {
+    return false;
+  }
+  VLOG(1) << "Flushed " << flushed.size() << " chunks of the thread caches of "
+          << Name();
+  return true;
+}
+
+void BFCAllocator::AddLiveBytes(int64_t bytes) {
+  const int64_t live_bytes =
+      live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = peak_live_bytes_.load(std::memory_order_relaxed);
+  while (live_bytes > peak &&
+         !peak_live_bytes_.compare_exchange_weak(peak, live_bytes,
+                                                 std::memory_order_relaxed)) {
+  }
+}
+
 // Merges h1 and h2 when Chunk(h1)->next is h2 and Chunk(h2)->prev is c1.
 // We merge Chunk(h2) into Chunk(h1).
 void BFCAllocator::Merge(BFCAllocator::ChunkHandle h1,
@@ -805,6 +1277,13 @@ void BFCAllocator::MarkFree(BFCAllocator::ChunkHandle h) {
   }
 
   // Updates the stats.
+  if (c->allocation_site != -1) {
+    MaybeRecordPeakAllocationSites();
+    AllocationSite& site = allocation_sites_[c->allocation_site];
+    site.live_bytes -= c->size;
+    --site.live_chunks;
+    c->allocation_site = -1;
+  }
   stats_.bytes_in_use -= c->size;
 
 #ifdef TENSORFLOW_MEM_DEBUG
@@ -820,12 +1299,16 @@ BFCAllocator::ChunkHandle BFCAllocator::TryToCoalesce(ChunkHandle h,
                                                       bool ignore_freed_at) {
   Chunk* c = ChunkFromHandle(h);
   if ((!ignore_freed_at) && c->freed_at_count > 0) return h;
+  // The chunks freed on a stream are never merged, even by an unsafe merge,
+  // since another stream could get their memory.
+  if (c->stream_event != nullptr) return h;
   ChunkHandle coalesced_chunk = h;
 
   // If the next chunk is free, merge it into c and delete it.
   if (c->next != kInvalidChunkHandle && !ChunkFromHandle(c->next)->in_use()) {
     Chunk* n = ChunkFromHandle(c->next);
-    if ((n->freed_at_count == 0) || ignore_freed_at) {
+    if (((n->freed_at_count == 0) || ignore_freed_at) &&
+        n->stream_event == nullptr) {
       VLOG(4) << "Merging c->next " << n->ptr << " with c " << c->ptr;
       RemoveFreeChunkFromBin(c->next);
       Merge(h, c->next);
@@ -835,7 +1318,8 @@ BFCAllocator::ChunkHandle BFCAllocator::TryToCoalesce(ChunkHandle h,
   // If the previous chunk is free, merge c into it and delete c.
   if (c->prev != kInvalidChunkHandle && !ChunkFromHandle(c->prev)->in_use()) {
     Chunk* n = ChunkFromHandle(c->prev);
-    if ((n->freed_at_count == 0) || ignore_freed_at) {
+    if (((n->freed_at_count == 0) || ignore_freed_at) &&
+        n->stream_event == nullptr) {
       VLOG(4) << "Merging c " << c->ptr << " into c->prev " << n->ptr;
       coalesced_chunk = c->prev;
       RemoveFreeChunkFromBin(c->prev);
@@ -937,6 +1421,10 @@ bool BFCAllocator::TracksAllocationSizes() const { return true; }
 
 size_t BFCAllocator::RequestedSize(const void* ptr) const {
   CHECK(ptr);
+  CachedChunkInfo info;
+  if (FindThreadCachedChunk(ptr, &info)) {
+    return info.requested_size;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -955,6 +1443,10 @@ size_t BFCAllocator::AllocatedSize(const void* ptr) const {
 }
 
 int64_t BFCAllocator::AllocationId(const void* ptr) const {
+  CachedChunkInfo info;
+  if (FindThreadCachedChunk(ptr, &info)) {
+    return info.allocation_id;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -1106,6 +1598,23 @@ void BFCAllocator::DumpMemoryLog(size_t num_bytes) {
   }
   LOG(INFO) << "Sum Total of in-use chunks: "
             << strings::HumanReadableNumBytes(total_bytes);
+  if (opts_.record_allocation_sites) {
+    constexpr int kMaxSitesToLog = 10;
+    std::vector<const AllocationSite*> sites;
+    for (const AllocationSite& site : allocation_sites_) {
+      if (site.live_chunks > 0) sites.push_back(&site);
+    }
+    std::sort(sites.begin(), sites.end(),
+              [](const AllocationSite* a, const AllocationSite* b) {
+                return a->live_bytes > b->live_bytes;
+              });
+    LOG(INFO) << "     Top allocation sites of in-use Chunks: ";
+    for (int i = 0; i < std::min<int>(sites.size(), kMaxSitesToLog); ++i) {
+      LOG(INFO) << strings::HumanReadableNumBytes(sites[i]->live_bytes)
+                << " in " << sites[i]->live_chunks << " Chunks allocated by "
+                << sites[i]->op_name << " for " << sites[i]->region_type;
+    }
+  }
   LOG(INFO) << "Total bytes in pool: " << *stats_.pool_bytes
             << " memory_limit_: " << memory_limit_
             << " available bytes: " << (memory_limit_ - *stats_.pool_bytes)
@@ -1131,7 +1640,106 @@ void BFCAllocator::MaybeWriteMemoryMap() {
       LOG(ERROR) << "Error on writing to file " << gpu_memory_map_file << ": "
                  << status;
     }
+    if (opts_.record_allocation_sites) {
+      file_name = strings::StrCat(gpu_memory_map_file, "_", Name(),
+                                  "_allocation_sites.",
+                                  Env::Default()->NowMicros(), ".pb");
+      status = Env::Default()->NewWritableFile(file_name, &dump_file);
+      if (status.ok()) {
+        status = dump_file->Append(
+            RecordAllocationSiteProfileInternal().SerializeAsString());
+      }
+      if (!status.ok()) {
+        LOG(ERROR) << "Error on writing to file " << file_name << ": "
+                   << status;
+      }
+    }
+  }
+}
+
+tensorflow::tfprof::pprof::Profile BFCAllocator::RecordAllocationSiteProfile() {
+  mutex_lock l(lock_);
+  return RecordAllocationSiteProfileInternal();
+}
+
+int BFCAllocator::CurrentAllocationSite() {
+  const auto& annotation =
+      tsl::profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation();
+  const char* op_name =
+      annotation.pending_op_name ? annotation.pending_op_name : "(null)";
+  const char* region_type =
+      annotation.pending_region_type ? annotation.pending_region_type
+                                     : "(null)";
+  allocation_site_key_.clear();
+  strings::StrAppend(&allocation_site_key_, op_name, "\n", region_type);
+  auto it = allocation_site_index_.find(allocation_site_key_);
+  if (it != allocation_site_index_.end()) {
+    return it->second;
+  }
+  const int index = allocation_sites_.size();
+  allocation_sites_.push_back({op_name, region_type});
+  allocation_site_index_.emplace(allocation_site_key_, index);
+  return index;
+}
+
+void BFCAllocator::MaybeRecordPeakAllocationSites() {
+  if (!allocation_sites_at_peak_) return;
+  for (AllocationSite& site : allocation_sites_) {
+    site.peak_bytes = site.live_bytes;
+    site.peak_chunks = site.live_chunks;
+  }
+  allocation_sites_at_peak_ = false;
+}
+
+tensorflow::tfprof::pprof::Profile
+BFCAllocator::RecordAllocationSiteProfileInternal() {
+  MaybeRecordPeakAllocationSites();
+  tensorflow::tfprof::pprof::Profile profile;
+  absl::flat_hash_map<std::string, int64_t> string_ids;
+  auto string_id = [&](const std::string& str) {
+    auto [it, inserted] =
+        string_ids.try_emplace(str, profile.string_table_size());
+    if (inserted) profile.add_string_table(str);
+    return it->second;
+  };
+  // The string table starts with the empty string.
+  string_id("");
+  auto add_sample_type = [&](const std::string& type,
+                             const std::string& unit) {
+    auto* sample_type = profile.add_sample_type();
+    sample_type->set_type(string_id(type));
+    sample_type->set_unit(string_id(unit));
+  };
+  add_sample_type("inuse_space", "bytes");
+  add_sample_type("inuse_objects", "count");
+
+  // Each frame gets one function, at one location of the same id.
+  absl::flat_hash_map<int64_t, uint64> location_ids;
+  auto location_id = [&](const std::string& frame) {
+    const int64_t name = string_id(frame);
+    const uint64 id = location_ids.size() + 1;
+    auto [it, inserted] = location_ids.try_emplace(name, id);
+    if (inserted) {
+      auto* function = profile.add_function();
+      function->set_id(it->second);
+      function->set_name(name);
+      auto* location = profile.add_location();
+      location->set_id(it->second);
+      location->add_line()->set_function_id(it->second);
+    }
+    return it->second;
+  };
+  for (const AllocationSite& site : allocation_sites_) {
+    if (site.peak_chunks == 0) continue;
+    auto* sample = profile.add_sample();
+    // From the leaf to the root.
+    sample->add_location_id(location_id(site.region_type));
+    sample->add_location_id(location_id(site.op_name));
+    sample->add_location_id(location_id(name_));
+    sample->add_value(site.peak_bytes);
+    sample->add_value(site.peak_chunks);
   }
+  return profile;
 }
 
 MemoryDump BFCAllocator::RecordMemoryMap() {
@@ -1207,7 +1815,15 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
-  return stats_;
+  AllocatorStats stats = stats_;
+  if (thread_caches_ != nullptr) {
+    stats.num_allocs +=
+        num_thread_cache_allocs_.load(std::memory_order_relaxed);
+    stats.bytes_in_use = live_bytes_.load(std::memory_order_relaxed);
+    stats.peak_bytes_in_use =
+        peak_live_bytes_.load(std::memory_order_relaxed);
+  }
+  return stats;
 }
 
 bool BFCAllocator::ClearStats() {
@@ -1215,6 +1831,10 @@ bool BFCAllocator::ClearStats() {
   stats_.num_allocs = 0;
   stats_.peak_bytes_in_use = stats_.bytes_in_use;
   stats_.largest_alloc_size = 0;
+  num_thread_cache_allocs_.store(0, std::memory_order_relaxed);
+  peak_live_bytes_.store(live_bytes_.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+  allocation_sites_at_peak_ = opts_.record_allocation_sites;
   return true;
 }
 
@@ -16,13 +16,17 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_FRAMEWORK_BFC_ALLOCATOR_H_
 #define TENSORFLOW_TSL_FRAMEWORK_BFC_ALLOCATOR_H_
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <deque>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "tsl/framework/allocator.h"
 #include "tsl/framework/allocator_retry.h"
@@ -36,7 +40,12 @@ limitations under the License.
 
 namespace tensorflow {
 class MemoryDump;
-}
+namespace tfprof {
+namespace pprof {
+class Profile;
+}  // namespace pprof
+}  // namespace tfprof
+}  // namespace tensorflow
 namespace tsl {
 using tensorflow::MemoryDump;
 
@@ -68,6 +77,27 @@ class BFCAllocator : public Allocator {
     // Controls when a chunk should be split, if its size exceeds the requested
     // allocation size.
     double fragmentation_fraction = 0;
+
+    // If non-zero, the freed chunks of up to 64KiB are kept in per-thread
+    // caches of up to this many bytes each, and handed out again to the
+    // threads of the cache without taking the allocator lock. The caches are
+    // flushed back to the allocator when it runs out of memory. The caches
+    // are bypassed while a timing counter is set.
+    size_t thread_cache_bytes = 0;
+
+    // If true and the sub allocator can release parts of its allocations (see
+    // SubAllocator::ReleaseGranularity), the allocator gives back the pages
+    // covered by free chunks when it runs out of memory, so that the sub
+    // allocator can map them again behind a new region. Large allocations
+    // can then succeed even if the free memory is fragmented.
+    bool defragmentation = false;
+
+    // If true, the chunks in use are tagged with the op name and region type
+    // of the ScopedMemoryDebugAnnotation of their allocation, and the bytes
+    // in use by each of these allocation sites at the peak of bytes in use
+    // are tracked, see RecordAllocationSiteProfile. Disables the thread
+    // caches.
+    bool record_allocation_sites = false;
   };
   BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator, size_t total_memory,
                const string& name, const Options& opts);
@@ -85,6 +115,32 @@ class BFCAllocator : public Allocator {
 
   void DeallocateRaw(void* ptr) override;
 
+  // Tells whether the work that a stream enqueued before the event was
+  // recorded has completed.
+  class StreamEvent {
+   public:
+    virtual ~StreamEvent() = default;
+    // Must not block.
+    virtual bool IsComplete() = 0;
+  };
+
+  // Stream-ordered versions of AllocateRaw and DeallocateRaw, like
+  // cudaMallocAsync and cudaFreeAsync. `stream` is an opaque, non-null handle
+  // of the stream that uses the memory.
+  //
+  // DeallocateRawOnStream may be called as soon as the last use of ptr is
+  // enqueued on `stream`, with an event recorded on `stream` after it.
+  // Allocations on the same stream may reuse the chunk right away, since the
+  // stream runs their work after that of the previous user. Other allocations
+  // only reuse it once the event is complete, and the chunk is not coalesced
+  // with its neighbors until then. A null or complete event makes the chunk
+  // reusable by any allocation, as with DeallocateRaw.
+  void* AllocateRawOnStream(size_t alignment, size_t num_bytes,
+                            const void* stream,
+                            const AllocationAttributes& allocation_attr);
+  void DeallocateRawOnStream(void* ptr, const void* stream,
+                             std::unique_ptr<StreamEvent> event);
+
   bool TracksAllocationSizes() const override;
 
   size_t RequestedSize(const void* ptr) const override;
@@ -107,6 +163,13 @@ class BFCAllocator : public Allocator {
 
   MemoryDump RecordMemoryMap();
 
+  // Returns the bytes and chunks in use by each allocation site at the peak
+  // of bytes in use since the last ClearStats, as a pprof profile. The stack
+  // of each sample is the allocator name, the op name and the region type,
+  // from the root, so that it renders as a flame graph. Empty unless
+  // Options::record_allocation_sites is set.
+  tensorflow::tfprof::pprof::Profile RecordAllocationSiteProfile();
+
  private:
   struct Bin;
 
@@ -118,7 +181,20 @@ class BFCAllocator : public Allocator {
       size_t alignment, size_t num_bytes,
       const AllocationAttributes& allocation_attr);
 
-  void DeallocateRawInternal(void* ptr);
+  void DeallocateRawInternal(void* ptr, const void* stream,
+                             std::shared_ptr<StreamEvent> event);
+
+  // Makes the chunks freed on a stream whose event is complete reusable by
+  // all allocations, and coalesces them.
+  void PollStreamEvents() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns a chunk of the thread cache of the calling thread that fits
+  // num_bytes, or nullptr if there is none.
+  void* AllocateFromThreadCache(size_t num_bytes);
+
+  // Returns true if ptr, which was allocated from a thread cache, was put
+  // back into the thread cache of the calling thread.
+  bool DeallocateToThreadCache(void* ptr);
 
   // Chunks whose freed_at_count is later than the safe frontier value are kept
   // on a special list and not subject to merging immediately upon being freed.
@@ -208,6 +284,16 @@ class BFCAllocator : public Allocator {
     // Optional count when this chunk was most recently made free.
     uint64 freed_at_count = 0;
 
+    // If stream_event is not null, the chunk was freed by
+    // DeallocateRawOnStream, and only allocations on freed_on_stream may use
+    // it until the event is complete.
+    const void* freed_on_stream = nullptr;
+    std::shared_ptr<StreamEvent> stream_event;
+
+    // The index in allocation_sites_ of the site that allocated the chunk, or
+    // -1 if the chunk is free or the sites are not recorded.
+    int allocation_site = -1;
+
     bool in_use() const { return allocation_id != -1; }
 
 #ifdef TENSORFLOW_MEM_DEBUG
@@ -326,6 +412,15 @@ class BFCAllocator : public Allocator {
     void set_handle(const void* p, ChunkHandle h) { handles_[IndexFor(p)] = h; }
     void erase(const void* p) { set_handle(p, kInvalidChunkHandle); }
 
+    // Returns a region for [ptr, ptr + memory_size), which must be inside of
+    // this region, with the same chunk handles.
+    AllocationRegion Subregion(void* ptr, size_t memory_size) const {
+      AllocationRegion region(ptr, memory_size);
+      auto begin = handles_.begin() + IndexFor(ptr);
+      std::copy(begin, begin + region.handles_.size(), region.handles_.begin());
+      return region;
+    }
+
    private:
     void Swap(AllocationRegion* other) {
       std::swap(ptr_, other->ptr_);
@@ -409,6 +504,31 @@ class BFCAllocator : public Allocator {
       return regions_.erase(it);
     }
 
+    // Removes [ptr, ptr + memory_size) from the region that contains it,
+    // which is split in two if the range is in its middle.
+    void RemoveAllocationRange(void* ptr, size_t memory_size) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      CHECK(entry != regions_.end() && entry->ptr() <= ptr)
+          << "Could not find Region for " << ptr;
+      char* begin = static_cast<char*>(ptr);
+      char* end = begin + memory_size;
+      char* region_begin = static_cast<char*>(entry->ptr());
+      char* region_end = static_cast<char*>(entry->end_ptr());
+      DCHECK_LE(end, region_end);
+      std::vector<AllocationRegion> pieces;
+      if (begin > region_begin) {
+        pieces.push_back(
+            entry->Subregion(region_begin, begin - region_begin));
+      }
+      if (end < region_end) {
+        pieces.push_back(entry->Subregion(end, region_end - end));
+      }
+      entry = regions_.erase(entry);
+      regions_.insert(entry, std::make_move_iterator(pieces.begin()),
+                      std::make_move_iterator(pieces.end()));
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -462,14 +582,24 @@ class BFCAllocator : public Allocator {
   // found and freed; false otherwise.
   bool DeallocateFreeRegions(size_t rounded_bytes);
 
+  // Gives back to the sub allocator the pages covered by free chunks, if
+  // Options::defragmentation is set and enough pages can be released for an
+  // allocation of 'rounded_bytes' to fit under the memory limit. The regions
+  // are split around the released pages. Returns true if any page was
+  // released.
+  bool ReleaseFreePages(size_t rounded_bytes)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Helper function to deallocate regions.
   void DeallocateRegions(const absl::flat_hash_set<void*>& region_ptrs)
       TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   // Returns a pointer to an underlying allocated chunk of size
-  // 'rounded_bytes'.
+  // 'rounded_bytes'. The chunks freed on another stream than 'stream' whose
+  // event is not complete are skipped.
   void* FindChunkPtr(BinNum bin_num, size_t rounded_bytes, size_t num_bytes,
-                     uint64 freed_before) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+                     uint64 freed_before, const void* stream = nullptr)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   // Splits the chunk specified by 'h' into two chunks, one at least
   // of size 'num_bytes'.
@@ -502,6 +632,26 @@ class BFCAllocator : public Allocator {
       TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void MaybeWriteMemoryMap() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // The memory in use by the chunks allocated under the same op name and
+  // region type.
+  struct AllocationSite {
+    std::string op_name;
+    std::string region_type;
+    int64_t live_bytes = 0;
+    int64_t live_chunks = 0;
+    // At the last recorded peak of bytes in use.
+    int64_t peak_bytes = 0;
+    int64_t peak_chunks = 0;
+  };
+  // Returns the index in allocation_sites_ of the site of the current
+  // ScopedMemoryDebugAnnotation, adding it if needed.
+  int CurrentAllocationSite() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Records the live bytes of the sites as those at the peak, if the bytes in
+  // use have reached a new peak since the last time.
+  void MaybeRecordPeakAllocationSites() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  tensorflow::tfprof::pprof::Profile RecordAllocationSiteProfileInternal()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   ChunkHandle AllocateChunk() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void DeallocateChunk(ChunkHandle h) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
@@ -518,6 +668,10 @@ class BFCAllocator : public Allocator {
   // size over total free memory, and returns a value within [0, 1].
   double GetFragmentation() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Exports the latency of a sampled allocation and the current memory usage
+  // to the metrics registry.
+  void RecordSampledMetrics(uint64 latency_usecs) TF_LOCKS_EXCLUDED(lock_);
+
   // Information about a Bin that is useful for debugging.
   struct BinDebugInfo {
     size_t total_bytes_in_use = 0;
@@ -531,6 +685,70 @@ class BFCAllocator : public Allocator {
   std::array<BinDebugInfo, kNumBins> get_bin_debug_info()
       TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // The largest chunk kept by the thread caches, and the number of bins of
+  // the chunks up to that size.
+  static constexpr size_t kMaxThreadCachedChunkBytes = 64 << 10;
+  static constexpr int kNumThreadCachedBins = 9;
+  // The threads are spread over this many caches.
+  static constexpr int kNumThreadCaches = 16;
+
+  // A chunk of a thread cache. It is in use as far as the bins and stats_ are
+  // concerned until the cache is flushed.
+  struct CachedChunk {
+    void* ptr = nullptr;
+    size_t size = 0;
+  };
+
+  // The up-to-date allocation info of a chunk owned by the thread caches,
+  // which replaces the one of the Chunk while the cache hands it out.
+  struct CachedChunkInfo {
+    size_t size = 0;
+    size_t requested_size = 0;
+    int64_t allocation_id = -1;
+  };
+
+  struct ThreadCache {
+    mutex mu;
+    // The free chunks of the threads of this cache, by bin.
+    std::array<std::vector<CachedChunk>, kNumThreadCachedBins> free_chunks
+        TF_GUARDED_BY(mu);
+    size_t free_bytes TF_GUARDED_BY(mu) = 0;
+    // The chunks owned by the thread caches whose pointer maps to this cache,
+    // whether they are free or in use.
+    absl::flat_hash_map<const void*, CachedChunkInfo> chunks TF_GUARDED_BY(mu);
+  };
+
+  bool ThreadCacheEnabled() const {
+    return thread_caches_ != nullptr && timing_counter_ == nullptr;
+  }
+
+  // The cache of the free chunks of the calling thread.
+  ThreadCache* HomeThreadCache() const;
+  // The cache that holds the allocation info of ptr.
+  ThreadCache* OwnerThreadCache(const void* ptr) const;
+
+  // Returns true and fills *info if ptr is owned by the thread caches.
+  bool FindThreadCachedChunk(const void* ptr, CachedChunkInfo* info) const;
+
+  // Adds the free chunk to the thread cache of the calling thread. Returns
+  // false if it is full.
+  bool PushThreadCachedChunk(void* ptr, size_t size);
+
+  // Makes the thread caches forget ptr, which goes back to the bins.
+  void UntrackThreadCachedChunk(const void* ptr);
+
+  // Hands the chunk h, which is being deallocated, to the thread caches
+  // instead of the bins if it is small enough and the cache has room.
+  bool CacheFreedChunk(ChunkHandle h) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns all the free chunks of the thread caches to the bins. Returns
+  // true if there was any.
+  bool FlushThreadCaches() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Accounts for bytes handed out to (or, if negative, returned by) the
+  // callers, which excludes the chunks of the thread caches.
+  void AddLiveBytes(int64_t bytes);
+
   AllocatorRetry retry_helper_;
 
   // Structures immutable after construction
@@ -603,15 +821,44 @@ class BFCAllocator : public Allocator {
 
   std::vector<Chunk> chunks_ TF_GUARDED_BY(lock_);
 
+  // The pointers of the chunks freed on each stream whose event may not be
+  // complete, in the order they were freed.
+  absl::flat_hash_map<const void*, std::deque<void*>> stream_pending_chunks_
+      TF_GUARDED_BY(lock_);
+
   // Pointer to head of linked list of free Chunks
   ChunkHandle free_chunks_list_ TF_GUARDED_BY(lock_);
 
   // Counter containing the next unique identifier to assign to a
-  // newly-created chunk.
-  int64_t next_allocation_id_ TF_GUARDED_BY(lock_);
+  // newly-created chunk. Atomic so that the thread caches can hand out chunks
+  // without the lock.
+  std::atomic<int64_t> next_allocation_id_;
 
   // Stats.
   AllocatorStats stats_ TF_GUARDED_BY(lock_);
+
+  // Null unless Options::thread_cache_bytes is set.
+  std::unique_ptr<ThreadCache[]> thread_caches_;
+  // When the thread caches are enabled, stats_ counts their free chunks as in
+  // use, and these track the allocations the way the caller sees them.
+  std::atomic<int64_t> live_bytes_{0};
+  std::atomic<int64_t> peak_live_bytes_{0};
+  std::atomic<int64_t> num_thread_cache_allocs_{0};
+
+  // One in kMetricsSamplingPeriod allocations that miss the thread cache is
+  // timed and refreshes the exported memory usage.
+  static constexpr int kMetricsSamplingPeriod = 64;
+  std::atomic<uint64> num_allocate_calls_{0};
+
+  // Empty unless Options::record_allocation_sites is set.
+  std::vector<AllocationSite> allocation_sites_ TF_GUARDED_BY(lock_);
+  absl::flat_hash_map<std::string, int> allocation_site_index_
+      TF_GUARDED_BY(lock_);
+  // Reused to look up allocation_site_index_ without allocating.
+  std::string allocation_site_key_ TF_GUARDED_BY(lock_);
+  // Whether the bytes in use are at a peak that the sites have not recorded.
+  // The peak ends at the next deallocation, which records it.
+  bool allocation_sites_at_peak_ TF_GUARDED_BY(lock_) = false;
 #ifdef TENSORFLOW_MEM_DEBUG
   int64 action_counter_ TF_GUARDED_BY(lock_) = 0;
 #define MEM_DEBUG_SIZE_HISTORY_SIZE 4096
@@ -0,0 +1,517 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/framework/bfc_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "tsl/framework/allocator.h"
+#include "tsl/lib/monitoring/cell_reader.h"
+#include "tsl/lib/monitoring/test_utils.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/mem.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
+#include "tsl/platform/threadpool.h"
+#include "tsl/profiler/lib/scoped_memory_debug_annotation.h"
+#include "tsl/profiler/protobuf/profile.pb.h"
+
+namespace tsl {
+namespace {
+
+class HostSubAllocator : public SubAllocator {
+ public:
+  HostSubAllocator() : SubAllocator({}, {}) {}
+
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override {
+    *bytes_received = num_bytes;
+    return port::AlignedMalloc(num_bytes, Allocator::kAllocatorAlignment);
+  }
+  void Free(void* ptr, size_t num_bytes) override { port::AlignedFree(ptr); }
+  bool SupportsCoalescing() const override { return false; }
+};
+
+std::unique_ptr<BFCAllocator> NewAllocator(size_t total_memory,
+                                           size_t thread_cache_bytes) {
+  BFCAllocator::Options opts;
+  opts.allow_growth = false;
+  opts.allow_retry_on_failure = false;
+  opts.thread_cache_bytes = thread_cache_bytes;
+  return std::make_unique<BFCAllocator>(std::make_unique<HostSubAllocator>(),
+                                        total_memory, "bfc_test", opts);
+}
+
+TEST(BFCAllocatorThreadCacheTest, ReusesFreedChunk) {
+  std::unique_ptr<BFCAllocator> a = NewAllocator(1 << 20, 64 << 10);
+  void* p1 = a->AllocateRaw(1, 1000);
+  ASSERT_NE(p1, nullptr);
+  const int64_t id1 = a->AllocationId(p1);
+  a->DeallocateRaw(p1);
+
+  // A smaller request of the same bin gets the cached chunk.
+  void* p2 = a->AllocateRaw(1, 800);
+  EXPECT_EQ(p2, p1);
+  EXPECT_EQ(a->RequestedSize(p2), 800);
+  EXPECT_EQ(a->AllocatedSize(p2), 1024);
+  EXPECT_GT(a->AllocationId(p2), id1);
+
+  absl::optional<AllocatorStats> stats = a->GetStats();
+  EXPECT_EQ(stats->num_allocs, 2);
+  EXPECT_EQ(stats->bytes_in_use, 1024);
+  EXPECT_EQ(stats->peak_bytes_in_use, 1024);
+
+  a->DeallocateRaw(p2);
+  stats = a->GetStats();
+  EXPECT_EQ(stats->bytes_in_use, 0);
+  EXPECT_EQ(stats->peak_bytes_in_use, 1024);
+
+  // Too large for the chunk.
+  void* p3 = a->AllocateRaw(1, 1500);
+  EXPECT_NE(p3, p1);
+  a->DeallocateRaw(p3);
+
+  EXPECT_TRUE(a->ClearStats());
+  stats = a->GetStats();
+  EXPECT_EQ(stats->num_allocs, 0);
+  EXPECT_EQ(stats->peak_bytes_in_use, 0);
+}
+
+TEST(BFCAllocatorThreadCacheTest, LimitsCachedBytes) {
+  std::unique_ptr<BFCAllocator> a = NewAllocator(1 << 20, 1024);
+  void* p1 = a->AllocateRaw(1, 1024);
+  void* p2 = a->AllocateRaw(1, 1024);
+  a->DeallocateRaw(p1);
+  // The cache is full, so p2 goes back to the bins and coalesces with the
+  // free space after it.
+  a->DeallocateRaw(p2);
+  EXPECT_EQ(a->GetStats()->bytes_in_use, 0);
+  EXPECT_EQ(a->AllocateRaw(1, 1024), p1);
+  void* p3 = a->AllocateRaw(1, 1024);
+  EXPECT_EQ(p3, p2);
+  a->DeallocateRaw(p1);
+  a->DeallocateRaw(p3);
+}
+
+TEST(BFCAllocatorThreadCacheTest, FlushesUnderMemoryPressure) {
+  // 64KiB is the largest chunk in the caches.
+  std::unique_ptr<BFCAllocator> a = NewAllocator(256 << 10, 256 << 10);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; ++i) {
+    ptrs.push_back(a->AllocateRaw(1, 64 << 10));
+    ASSERT_NE(ptrs.back(), nullptr);
+  }
+  for (void* ptr : ptrs) {
+    a->DeallocateRaw(ptr);
+  }
+  EXPECT_EQ(a->GetStats()->bytes_in_use, 0);
+  // Only fits once the cached chunks are coalesced.
+  void* large = a->AllocateRaw(1, 256 << 10);
+  EXPECT_NE(large, nullptr);
+  EXPECT_EQ(a->GetStats()->bytes_in_use, 256 << 10);
+  a->DeallocateRaw(large);
+}
+
+TEST(BFCAllocatorThreadCacheTest, SharedAcrossThreads) {
+  std::unique_ptr<BFCAllocator> a = NewAllocator(64 << 20, 64 << 10);
+  {
+    thread::ThreadPool pool(Env::Default(), "bfc_test", 8);
+    for (int t = 0; t < 8; ++t) {
+      pool.Schedule([&a, t] {
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 1000; ++i) {
+          const size_t num_bytes = 256 * (1 + (i + t) % 32);
+          void* ptr = a->AllocateRaw(1, num_bytes);
+          ASSERT_NE(ptr, nullptr);
+          EXPECT_EQ(a->RequestedSize(ptr), num_bytes);
+          ptrs.push_back(ptr);
+          if (ptrs.size() > 16) {
+            a->DeallocateRaw(ptrs.front());
+            ptrs.erase(ptrs.begin());
+          }
+        }
+        for (void* ptr : ptrs) {
+          a->DeallocateRaw(ptr);
+        }
+      });
+    }
+  }
+  absl::optional<AllocatorStats> stats = a->GetStats();
+  EXPECT_EQ(stats->num_allocs, 8000);
+  EXPECT_EQ(stats->bytes_in_use, 0);
+}
+
+// A stream whose work completes when the test says so.
+class FakeStream {
+ public:
+  class Event : public BFCAllocator::StreamEvent {
+   public:
+    Event(const FakeStream* stream, int64_t count)
+        : stream_(stream), count_(count) {}
+    bool IsComplete() override { return stream_->completed_ >= count_; }
+
+   private:
+    const FakeStream* const stream_;
+    const int64_t count_;
+  };
+
+  // Returns an event recorded after the work enqueued so far.
+  std::unique_ptr<Event> RecordEvent() {
+    return std::make_unique<Event>(this, ++recorded_);
+  }
+  int64_t recorded() const { return recorded_; }
+  // Completes the work enqueued before the `count`-th event.
+  void Complete(int64_t count) { completed_ = count; }
+  void CompleteAll() { completed_ = recorded_; }
+
+ private:
+  int64_t recorded_ = 0;
+  int64_t completed_ = 0;
+};
+
+void* AllocateOnStream(BFCAllocator* a, size_t num_bytes, FakeStream* stream) {
+  AllocationAttributes attr;
+  attr.retry_on_failure = false;
+  return a->AllocateRawOnStream(1, num_bytes, stream, attr);
+}
+
+TEST(BFCAllocatorStreamOrderedTest, ReusesChunkOnSameStream) {
+  std::unique_ptr<BFCAllocator> a = NewAllocator(1 << 20, 0);
+  FakeStream s1, s2;
+  void* p1 = AllocateOnStream(a.get(), 1024, &s1);
+  a->DeallocateRawOnStream(p1, &s1, s1.RecordEvent());
+  EXPECT_EQ(a->GetStats()->bytes_in_use, 0);
+
+  // Other streams must wait for the event.
+  void* p2 = AllocateOnStream(a.get(), 1024, &s2);
+  EXPECT_NE(p2, p1);
+  void* p3 = a->AllocateRaw(1, 1024);
+  EXPECT_NE(p3, p1);
+  // The stream that freed it does not.
+  void* p4 = AllocateOnStream(a.get(), 1024, &s1);
+  EXPECT_EQ(p4, p1);
+
+  a->DeallocateRawOnStream(p4, &s1, s1.RecordEvent());
+  s1.CompleteAll();
+  void* p5 = AllocateOnStream(a.get(), 1024, &s2);
+  EXPECT_EQ(p5, p1);
+
+  a->DeallocateRaw(p2);
+  a->DeallocateRaw(p3);
+  a->DeallocateRawOnStream(p5, &s2, nullptr);
+  EXPECT_EQ(a->GetStats()->bytes_in_use, 0);
+}
+
+TEST(BFCAllocatorStreamOrderedTest, CoalescesOnceEventIsComplete) {
+  std::unique_ptr<BFCAllocator> a = NewAllocator(1 << 20, 0);
+  FakeStream s1, s2;
+  void* p1 = AllocateOnStream(a.get(), 512 << 10, &s1);
+  void* p2 = AllocateOnStream(a.get(), 512 << 10, &s2);
+  ASSERT_NE(p1, nullptr);
+  ASSERT_NE(p2, nullptr);
+  a->DeallocateRawOnStream(p1, &s1, s1.RecordEvent());
+  a->DeallocateRawOnStream(p2, &s2, s2.RecordEvent());
+  // Neither stream may use the chunk of the other yet.
+  EXPECT_EQ(AllocateOnStream(a.get(), 1 << 20, &s1), nullptr);
+
+  s1.CompleteAll();
+  s2.CompleteAll();
+  void* p3 = AllocateOnStream(a.get(), 1 << 20, &s1);
+  EXPECT_EQ(p3, p1 < p2 ? p1 : p2);
+  a->DeallocateRaw(p3);
+}
+
+TEST(BFCAllocatorStreamOrderedTest, SplitChunkStaysOnStream) {
+  std::unique_ptr<BFCAllocator> a = NewAllocator(1 << 20, 0);
+  FakeStream s1, s2;
+  void* p1 = AllocateOnStream(a.get(), 4096, &s1);
+  void* guard = a->AllocateRaw(1, 1024);
+  a->DeallocateRawOnStream(p1, &s1, s1.RecordEvent());
+
+  // Takes the first half of the chunk, the other half is still pending.
+  void* p2 = AllocateOnStream(a.get(), 2048, &s1);
+  EXPECT_EQ(p2, p1);
+  void* p3 = AllocateOnStream(a.get(), 2048, &s2);
+  EXPECT_NE(p3, static_cast<char*>(p1) + 2048);
+  void* p4 = AllocateOnStream(a.get(), 2048, &s1);
+  EXPECT_EQ(p4, static_cast<char*>(p1) + 2048);
+
+  a->DeallocateRaw(p2);
+  a->DeallocateRaw(p3);
+  a->DeallocateRaw(p4);
+  a->DeallocateRaw(guard);
+  EXPECT_EQ(a->GetStats()->bytes_in_use, 0);
+}
+
+// Hands out the pages of a reserved range of host memory, first fit, like a
+// sub allocator mapping physical pages behind a virtual address space.
+class PagedSubAllocator : public SubAllocator {
+ public:
+  static constexpr size_t kPageSize = 64 << 10;
+
+  explicit PagedSubAllocator(size_t num_pages)
+      : SubAllocator({}, {}),
+        base_(static_cast<char*>(
+            port::AlignedMalloc(num_pages * kPageSize, kPageSize))),
+        mapped_(num_pages, false) {}
+  ~PagedSubAllocator() override { port::AlignedFree(base_); }
+
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override {
+    const size_t num_pages = (num_bytes + kPageSize - 1) / kPageSize;
+    size_t run = 0;
+    for (size_t i = 0; i < mapped_.size(); ++i) {
+      run = mapped_[i] ? 0 : run + 1;
+      if (run == num_pages) {
+        const size_t first = i + 1 - num_pages;
+        std::fill(mapped_.begin() + first, mapped_.begin() + i + 1, true);
+        *bytes_received = num_pages * kPageSize;
+        return base_ + first * kPageSize;
+      }
+    }
+    return nullptr;
+  }
+  void Free(void* ptr, size_t num_bytes) override {
+    const size_t offset = static_cast<char*>(ptr) - base_;
+    CHECK_EQ(offset % kPageSize, 0);
+    CHECK_EQ(num_bytes % kPageSize, 0);
+    for (size_t i = 0; i < num_bytes / kPageSize; ++i) {
+      CHECK(mapped_[offset / kPageSize + i]);
+      mapped_[offset / kPageSize + i] = false;
+    }
+  }
+  bool SupportsCoalescing() const override { return true; }
+  size_t ReleaseGranularity() const override { return kPageSize; }
+
+  size_t mapped_bytes() const {
+    return std::count(mapped_.begin(), mapped_.end(), true) * kPageSize;
+  }
+
+ private:
+  char* base_;
+  std::vector<bool> mapped_;
+};
+
+class BFCAllocatorDefragmentationTest : public ::testing::TestWithParam<bool> {
+ protected:
+  static constexpr size_t kPageSize = PagedSubAllocator::kPageSize;
+  static constexpr size_t kNumPages = 16;
+
+  BFCAllocatorDefragmentationTest() {
+    auto sub_allocator = std::make_unique<PagedSubAllocator>(4 * kNumPages);
+    sub_allocator_ = sub_allocator.get();
+    BFCAllocator::Options opts;
+    opts.allow_growth = false;
+    opts.allow_retry_on_failure = false;
+    opts.defragmentation = GetParam();
+    allocator_ = std::make_unique<BFCAllocator>(
+        std::move(sub_allocator), kNumPages * kPageSize, "bfc_test", opts);
+  }
+
+  PagedSubAllocator* sub_allocator_;
+  std::unique_ptr<BFCAllocator> allocator_;
+};
+
+TEST_P(BFCAllocatorDefragmentationTest, AllocatesInFragmentedMemory) {
+  std::vector<void*> ptrs;
+  for (int i = 0; i < kNumPages; ++i) {
+    ptrs.push_back(allocator_->AllocateRaw(1, kPageSize));
+    ASSERT_NE(ptrs.back(), nullptr);
+  }
+  // Half of the memory is free, in chunks of one page.
+  for (int i = 0; i < kNumPages; i += 2) {
+    allocator_->DeallocateRaw(ptrs[i]);
+  }
+
+  void* large = allocator_->AllocateRaw(1, 4 * kPageSize);
+  if (!GetParam()) {
+    EXPECT_EQ(large, nullptr);
+    for (int i = 1; i < kNumPages; i += 2) {
+      allocator_->DeallocateRaw(ptrs[i]);
+    }
+    return;
+  }
+  ASSERT_NE(large, nullptr);
+  absl::optional<AllocatorStats> stats = allocator_->GetStats();
+  EXPECT_EQ(stats->bytes_in_use, (kNumPages / 2 + 4) * kPageSize);
+  EXPECT_LE(stats->pool_bytes, kNumPages * kPageSize);
+  EXPECT_EQ(sub_allocator_->mapped_bytes(), stats->pool_bytes);
+
+  // The chunks around the released pages are still usable.
+  for (int i = 1; i < kNumPages; i += 2) {
+    EXPECT_EQ(allocator_->RequestedSize(ptrs[i]), kPageSize);
+    allocator_->DeallocateRaw(ptrs[i]);
+  }
+  allocator_->DeallocateRaw(large);
+  EXPECT_EQ(allocator_->GetStats()->bytes_in_use, 0);
+
+  // Whole free regions are released as well when an allocation needs them.
+  void* larger = allocator_->AllocateRaw(1, (kNumPages - 2) * kPageSize);
+  ASSERT_NE(larger, nullptr);
+  EXPECT_LE(allocator_->GetStats()->pool_bytes, kNumPages * kPageSize);
+  allocator_->DeallocateRaw(larger);
+}
+
+INSTANTIATE_TEST_SUITE_P(BFCAllocatorDefragmentationTestSuite,
+                         BFCAllocatorDefragmentationTest, ::testing::Bool());
+
+// Returns the bytes of the samples of `profile` by stack, from the root, in
+// the folded format of flame graphs.
+std::map<std::string, int64_t> FoldedStacks(
+    const tensorflow::tfprof::pprof::Profile& profile) {
+  std::map<uint64_t, std::string> frames;
+  for (const auto& function : profile.function()) {
+    frames[function.id()] = profile.string_table(function.name());
+  }
+  std::map<std::string, int64_t> stacks;
+  for (const auto& sample : profile.sample()) {
+    std::vector<std::string> stack;
+    for (auto it = sample.location_id().rbegin();
+         it != sample.location_id().rend(); ++it) {
+      stack.push_back(frames[*it]);
+    }
+    stacks[absl::StrJoin(stack, ";")] = sample.value(0);
+  }
+  return stacks;
+}
+
+TEST(BFCAllocatorMetricsTest, ExportsSampledMemoryStats) {
+  monitoring::testing::CellReader<int64_t> bytes_in_use(
+      "/tensorflow/core/bfc_allocator/bytes_in_use");
+  monitoring::testing::CellReader<monitoring::testing::Histogram> latency(
+      "/tensorflow/core/bfc_allocator/allocation_latency");
+  BFCAllocator::Options opts;
+  opts.allow_growth = false;
+  BFCAllocator a(std::make_unique<HostSubAllocator>(), 1 << 20,
+                 "bfc_metrics_test", opts);
+
+  // The first allocation is always sampled.
+  void* p = a.AllocateRaw(1, 1024);
+  EXPECT_EQ(bytes_in_use.Read("bfc_metrics_test"), 1024);
+  EXPECT_EQ(latency.Delta("bfc_metrics_test").num(), 1);
+  a.DeallocateRaw(p);
+}
+
+TEST(BFCAllocatorAllocationSiteTest, RecordsPeakBreakdown) {
+  BFCAllocator::Options opts;
+  opts.allow_growth = false;
+  opts.record_allocation_sites = true;
+  BFCAllocator a(std::make_unique<HostSubAllocator>(), 1 << 20, "bfc_test",
+                 opts);
+  EXPECT_TRUE(FoldedStacks(a.RecordAllocationSiteProfile()).empty());
+
+  void* a1;
+  void* a2;
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation("op_a");
+    a1 = a.AllocateRaw(1, 1024);
+    a2 = a.AllocateRaw(1, 1000);
+  }
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation(
+        "op_b", /*step_id=*/1, "output", /*data_type=*/0, [] { return ""; });
+    a.DeallocateRaw(a.AllocateRaw(1, 4096));
+  }
+  void* a3;
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation("op_a");
+    a3 = a.AllocateRaw(1, 1024);
+  }
+
+  tensorflow::tfprof::pprof::Profile profile = a.RecordAllocationSiteProfile();
+  ASSERT_EQ(profile.sample_type_size(), 2);
+  EXPECT_EQ(profile.string_table(profile.sample_type(0).type()),
+            "inuse_space");
+  EXPECT_EQ(profile.string_table(0), "");
+  EXPECT_THAT(FoldedStacks(profile),
+              ::testing::UnorderedElementsAre(
+                  ::testing::Pair("bfc_test;op_a;(null)", 2048),
+                  ::testing::Pair("bfc_test;op_b;output", 4096)));
+
+  // The current usage is the new peak.
+  EXPECT_TRUE(a.ClearStats());
+  EXPECT_THAT(FoldedStacks(a.RecordAllocationSiteProfile()),
+              ::testing::UnorderedElementsAre(
+                  ::testing::Pair("bfc_test;op_a;(null)", 3072)));
+
+  a.DeallocateRaw(a1);
+  a.DeallocateRaw(a2);
+  a.DeallocateRaw(a3);
+}
+
+// Each step allocates `state.range(0)` buffers, enqueues work on them, and
+// frees them. The work of a step completes `kLag` steps later. With
+// state.range(1) == 0 the buffers are only freed once their work is complete,
+// the way an event manager defers the frees, otherwise they are freed right
+// away on the stream.
+void BM_StreamOrderedPeakMemory(::testing::benchmark::State& state) {
+  const int num_buffers = state.range(0);
+  const bool stream_ordered = state.range(1) != 0;
+  constexpr int kLag = 4;
+  constexpr size_t kBufferBytes = 64 << 10;
+  std::unique_ptr<BFCAllocator> a = NewAllocator(size_t{1} << 30, 0);
+  FakeStream stream;
+  // The last event of each step whose work is not complete, and the buffers
+  // to free once it is.
+  std::deque<std::pair<int64_t, std::vector<void*>>> in_flight;
+  for (auto s : state) {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < num_buffers; ++i) {
+      ptrs.push_back(stream_ordered
+                         ? AllocateOnStream(a.get(), kBufferBytes, &stream)
+                         : a->AllocateRaw(1, kBufferBytes));
+    }
+    if (stream_ordered) {
+      for (void* ptr : ptrs) {
+        a->DeallocateRawOnStream(ptr, &stream, stream.RecordEvent());
+      }
+      ptrs.clear();
+    } else {
+      stream.RecordEvent();
+    }
+    in_flight.emplace_back(stream.recorded(), std::move(ptrs));
+    if (in_flight.size() > kLag) {
+      stream.Complete(in_flight.front().first);
+      for (void* ptr : in_flight.front().second) {
+        a->DeallocateRaw(ptr);
+      }
+      in_flight.pop_front();
+    }
+  }
+  for (const auto& step : in_flight) {
+    for (void* ptr : step.second) {
+      a->DeallocateRaw(ptr);
+    }
+  }
+  state.SetLabel(absl::StrCat("peak_bytes_in_use=",
+                              a->GetStats()->peak_bytes_in_use));
+}
+BENCHMARK(BM_StreamOrderedPeakMemory)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 1)
+    ->ArgPair(256, 0)
+    ->ArgPair(256, 1);
+
+}  // namespace
+}  // namespace tsl
@@ -16,8 +16,12 @@ limitations under the License.
 #include "tsl/framework/metrics.h"
 
 #include <cstdint>
+#include <string>
 
+#include "absl/strings/string_view.h"
 #include "tsl/lib/monitoring/counter.h"
+#include "tsl/lib/monitoring/gauge.h"
+#include "tsl/lib/monitoring/sampler.h"
 
 namespace tsl {
 namespace metrics {
@@ -28,6 +32,28 @@ auto* bfc_allocator_delay =
                                 "The total time spent running each graph "
                                 "optimization pass in microseconds.");
 
+auto* bfc_allocator_allocation_latency = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/bfc_allocator/allocation_latency",
+     "Latency of sampled BFC allocator allocations in microseconds.",
+     "allocator"},
+    // Power of 2 buckets from 1 microsecond to about 1 second.
+    {monitoring::Buckets::Exponential(1, 2, 20)});
+
+auto* bfc_allocator_bytes_in_use = monitoring::Gauge<int64_t, 1>::New(
+    "/tensorflow/core/bfc_allocator/bytes_in_use",
+    "Bytes allocated from the BFC allocator.", "allocator");
+
+auto* bfc_allocator_pool_bytes = monitoring::Gauge<int64_t, 1>::New(
+    "/tensorflow/core/bfc_allocator/pool_bytes",
+    "Bytes the BFC allocator has obtained from the underlying allocator.",
+    "allocator");
+
+auto* bfc_allocator_fragmentation = monitoring::Gauge<double, 1>::New(
+    "/tensorflow/core/bfc_allocator/fragmentation",
+    "Fraction of the free bytes of the BFC allocator that are not in its "
+    "largest free chunk.",
+    "allocator");
+
 }  // namespace
 
 void UpdateBfcAllocatorDelayTime(const uint64_t delay_usecs) {
@@ -37,5 +63,20 @@ void UpdateBfcAllocatorDelayTime(const uint64_t delay_usecs) {
   }
 }
 
+void UpdateBfcAllocatorAllocationLatency(absl::string_view allocator_name,
+                                         const uint64_t latency_usecs) {
+  bfc_allocator_allocation_latency->GetCell(std::string(allocator_name))
+      ->Add(latency_usecs);
+}
+
+void UpdateBfcAllocatorMemoryStats(absl::string_view allocator_name,
+                                   int64_t bytes_in_use, int64_t pool_bytes,
+                                   double fragmentation) {
+  const std::string name(allocator_name);
+  bfc_allocator_bytes_in_use->GetCell(name)->Set(bytes_in_use);
+  bfc_allocator_pool_bytes->GetCell(name)->Set(pool_bytes);
+  bfc_allocator_fragmentation->GetCell(name)->Set(fragmentation);
+}
+
 }  // namespace metrics
 }  // namespace tsl
@@ -18,12 +18,23 @@ limitations under the License.
 
 #include <cstdint>
 
+#include "absl/strings/string_view.h"
+
 namespace tsl {
 namespace metrics {
 
 // Updates the metrics stored about time BFC allocator spents during delay.
 void UpdateBfcAllocatorDelayTime(const uint64_t delay_usecs);
 
+// Records the latency of a sampled allocation by the named BFC allocator.
+void UpdateBfcAllocatorAllocationLatency(absl::string_view allocator_name,
+                                         const uint64_t latency_usecs);
+
+// Updates the memory usage gauges of the named BFC allocator.
+void UpdateBfcAllocatorMemoryStats(absl::string_view allocator_name,
+                                   int64_t bytes_in_use, int64_t pool_bytes,
+                                   double fragmentation);
+
 }  // namespace metrics
 }  // namespace tsl
 
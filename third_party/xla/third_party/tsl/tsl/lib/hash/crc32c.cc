@@ -26,6 +26,8 @@ namespace crc32c {
 
 extern bool CanAccelerate();
 extern uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size);
+extern void AcceleratedValue3(const char *const *bufs, const size_t *sizes,
+                              uint32_t *crcs);
 
 static const uint32 table0_[256] = {
     0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
@@ -263,6 +265,20 @@ uint32 Extend(uint32 crc, const char *buf, size_t size) {
   return l ^ 0xffffffffu;
 }
 
+void ValueMultiple(const char *const *data, const size_t *sizes, size_t n,
+                   uint32 *crcs) {
+  static bool can_accelerate = CanAccelerate();
+  size_t i = 0;
+  if (can_accelerate) {
+    for (; i + 3 <= n; i += 3) {
+      AcceleratedValue3(data + i, sizes + i, crcs + i);
+    }
+  }
+  for (; i < n; ++i) {
+    crcs[i] = Value(data[i], sizes[i]);
+  }
+}
+
 #if defined(TF_CORD_SUPPORT)
 uint32 Extend(uint32 crc, const absl::Cord &cord) {
   for (absl::string_view fragment : cord.Chunks()) {
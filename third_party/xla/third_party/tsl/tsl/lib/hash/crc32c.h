@@ -41,6 +41,13 @@ inline uint32 Value(const char* data, size_t n) { return Extend(0, data, n); }
 inline uint32 Value(const absl::Cord& cord) { return Extend(0, cord); }
 #endif
 
+// Computes crcs[i] = Value(data[i], sizes[i]) for i in [0, n). On CPUs with
+// CRC instructions, the CRCs of three buffers at a time are computed in one
+// pass that interleaves their instructions, which hides the latency of each
+// instruction and is faster than calling Value() on each buffer.
+extern void ValueMultiple(const char* const* data, const size_t* sizes,
+                          size_t n, uint32* crcs);
+
 static const uint32 kMaskDelta = 0xa282ead8ul;
 
 // Return a masked representation of crc.
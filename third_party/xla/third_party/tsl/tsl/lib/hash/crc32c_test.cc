@@ -16,6 +16,7 @@ limitations under the License.
 #include "tsl/lib/hash/crc32c.h"
 
 #include <string>
+#include <vector>
 
 #include "tsl/platform/logging.h"
 #include "tsl/platform/test.h"
@@ -73,6 +74,27 @@ TEST(CRC, Mask) {
   ASSERT_EQ(crc, Unmask(Unmask(Mask(Mask(crc)))));
 }
 
+TEST(CRC, ValueMultiple) {
+  std::string input;
+  for (int i = 0; i < 1000; ++i) {
+    input.push_back(static_cast<char>(i * 7));
+  }
+  // Buffers of different sizes and alignments.
+  std::vector<const char*> data;
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i < 10; ++i) {
+    data.push_back(input.data() + i * 13);
+    sizes.push_back((i * 97) % 200);
+  }
+  for (size_t n = 0; n <= data.size(); ++n) {
+    std::vector<uint32> crcs(n);
+    ValueMultiple(data.data(), sizes.data(), n, crcs.data());
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(Value(data[i], sizes[i]), crcs[i]) << "n: " << n << " i: " << i;
+    }
+  }
+}
+
 #if defined(PLATFORM_GOOGLE)
 TEST(CRC, ValuesWithCord) {
   ASSERT_NE(Value(absl::Cord("a")), Value(absl::Cord("foo")));
@@ -96,5 +118,23 @@ static void BM_CRC(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_CRC)->Range(1, 256 * 1024);
 
+static void BM_CRCMultiple(::testing::benchmark::State& state) {
+  const int len = state.range(0);
+  constexpr int kNumBuffers = 6;
+  std::string input(len * kNumBuffers, 'x');
+  std::vector<const char*> data;
+  std::vector<size_t> sizes(kNumBuffers, len);
+  for (int i = 0; i < kNumBuffers; ++i) {
+    data.push_back(input.data() + i * len);
+  }
+  std::vector<uint32> crcs(kNumBuffers);
+  for (auto s : state) {
+    ValueMultiple(data.data(), sizes.data(), kNumBuffers, crcs.data());
+  }
+  state.SetBytesProcessed(state.iterations() * len * kNumBuffers);
+  VLOG(1) << crcs[0];
+}
+BENCHMARK(BM_CRCMultiple)->Range(1, 256 * 1024);
+
 }  // namespace crc32c
 }  // namespace tsl
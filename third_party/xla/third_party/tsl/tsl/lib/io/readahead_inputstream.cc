@@ -0,0 +1,185 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/lib/io/readahead_inputstream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+
+namespace tsl {
+namespace io {
+
+ReadaheadInputStream::ReadaheadInputStream(RandomAccessFile* file,
+                                           int64_t block_size, int num_blocks,
+                                           thread::ThreadPool* thread_pool)
+    : file_(file),
+      block_size_(block_size),
+      num_blocks_(num_blocks),
+      thread_pool_(thread_pool) {
+  DCHECK_GT(block_size_, 0);
+  DCHECK_GT(num_blocks_, 0);
+}
+
+ReadaheadInputStream::~ReadaheadInputStream() {
+  mutex_lock l(mu_);
+  while (outstanding_reads_ > 0) {
+    cv_.wait(l);
+  }
+}
+
+void ReadaheadInputStream::ScheduleReads() {
+  while (blocks_.size() < static_cast<size_t>(num_blocks_) &&
+         (file_size_ < 0 || next_read_offset_ < file_size_)) {
+    auto block = std::make_shared<Block>(next_read_offset_);
+    next_read_offset_ += block_size_;
+    blocks_.push_back(block);
+    ++outstanding_reads_;
+    thread_pool_->Schedule([this, block, generation = generation_]() {
+      block->data.resize_uninitialized(block_size_);
+      char* scratch = &block->data[0];
+      StringPiece data;
+      Status s = file_->Read(block->offset, block_size_, &data, scratch);
+      if (data.data() != scratch) {
+        memmove(scratch, data.data(), data.size());
+      }
+      block->data.resize(data.size());
+
+      mutex_lock l(mu_);
+      // A short read means the end of the file was reached, which some
+      // filesystems report as OUT_OF_RANGE.
+      block->status = errors::IsOutOfRange(s) ? OkStatus() : s;
+      if (block->status.ok() &&
+          data.size() < static_cast<size_t>(block_size_) &&
+          generation == generation_) {
+        const int64_t file_size = block->offset + data.size();
+        file_size_ =
+            file_size_ < 0 ? file_size : std::min(file_size_, file_size);
+      }
+      block->done = true;
+      --outstanding_reads_;
+      cv_.notify_all();
+    });
+  }
+}
+
+void ReadaheadInputStream::RestartAt(int64_t offset) {
+  blocks_.clear();
+  next_read_offset_ = offset;
+  ++generation_;
+}
+
+Status ReadaheadInputStream::Consume(int64_t bytes_to_read, tstring* result) {
+  while (bytes_to_read > 0) {
+    std::shared_ptr<Block> block;
+    {
+      mutex_lock l(mu_);
+      if (file_size_ >= 0 && pos_ >= file_size_) {
+        return errors::OutOfRange("reached end of file");
+      }
+      ScheduleReads();
+      if (blocks_.empty()) {
+        return errors::Internal("No readahead block at offset ", pos_);
+      }
+      block = blocks_.front();
+      while (!block->done) {
+        cv_.wait(l);
+      }
+    }
+    TF_RETURN_IF_ERROR(block->status);
+
+    const int64_t block_pos = pos_ - block->offset;
+    const int64_t available =
+        static_cast<int64_t>(block->data.size()) - block_pos;
+    if (available <= 0) {
+      return errors::OutOfRange("reached end of file");
+    }
+    const int64_t n = std::min(available, bytes_to_read);
+    if (result != nullptr) {
+      result->append(block->data.data() + block_pos, n);
+    }
+    pos_ += n;
+    bytes_to_read -= n;
+    if (pos_ == block->offset + block_size_) {
+      mutex_lock l(mu_);
+      blocks_.pop_front();
+    }
+  }
+  return OkStatus();
+}
+
+Status ReadaheadInputStream::ReadNBytes(int64_t bytes_to_read,
+                                        tstring* result) {
+  if (bytes_to_read < 0) {
+    return errors::InvalidArgument("Cannot read negative number of bytes");
+  }
+  result->clear();
+  result->reserve(bytes_to_read);
+  return Consume(bytes_to_read, result);
+}
+
+Status ReadaheadInputStream::SkipNBytes(int64_t bytes_to_skip) {
+  if (bytes_to_skip < 0) {
+    return errors::InvalidArgument("Can't skip a negative number of bytes");
+  }
+  if (bytes_to_skip == 0) {
+    return OkStatus();
+  }
+  const int64_t target = pos_ + bytes_to_skip;
+  bool within_readahead_window;
+  {
+    mutex_lock l(mu_);
+    within_readahead_window = target < next_read_offset_ + block_size_;
+    if (!within_readahead_window && file_size_ >= 0) {
+      pos_ = std::min(target, file_size_);
+      RestartAt(pos_);
+      return target <= file_size_ ? OkStatus()
+                                  : errors::OutOfRange("reached end of file");
+    }
+  }
+  // Skips within the readahead window consume blocks already requested.
+  if (within_readahead_window) {
+    return Consume(bytes_to_skip, /*result=*/nullptr);
+  }
+
+  // Try to read the last skipped byte. If that succeeds, the end of the file
+  // is not reached and readahead restarts at the target position.
+  char scratch;
+  StringPiece data;
+  Status s = file_->Read(target - 1, 1, &data, &scratch);
+  if ((s.ok() || errors::IsOutOfRange(s)) && data.size() == 1) {
+    mutex_lock l(mu_);
+    pos_ = target;
+    RestartAt(pos_);
+    return OkStatus();
+  }
+  return Consume(bytes_to_skip, /*result=*/nullptr);
+}
+
+int64_t ReadaheadInputStream::Tell() const { return pos_; }
+
+Status ReadaheadInputStream::Reset() {
+  mutex_lock l(mu_);
+  pos_ = 0;
+  file_size_ = -1;
+  RestartAt(0);
+  return OkStatus();
+}
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,110 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_TSL_LIB_IO_READAHEAD_INPUTSTREAM_H_
+#define TENSORFLOW_TSL_LIB_IO_READAHEAD_INPUTSTREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "tsl/lib/io/inputstream_interface.h"
+#include "tsl/platform/file_system.h"
+#include "tsl/platform/mutex.h"
+#include "tsl/platform/thread_annotations.h"
+#include "tsl/platform/threadpool.h"
+
+namespace tsl {
+namespace io {
+
+// Wraps a RandomAccessFile in an InputStreamInterface that keeps up to
+// `num_blocks` reads of `block_size` bytes in flight ahead of the current
+// position. The reads run on `thread_pool`, so on filesystems with high
+// per-request latency (e.g. GCS or S3) a single sequential reader can keep
+// several requests outstanding while the caller decodes the data already
+// received.
+//
+// Skipping past the readahead window drops the blocks read so far and
+// restarts readahead at the new position.
+//
+// A given instance of ReadaheadInputStream is NOT safe for concurrent use by
+// multiple threads.
+class ReadaheadInputStream : public InputStreamInterface {
+ public:
+  // Does not take ownership of `file` or `thread_pool`, which must outlive
+  // *this. Requires `block_size` > 0 and `num_blocks` > 0.
+  ReadaheadInputStream(RandomAccessFile* file, int64_t block_size,
+                       int num_blocks, thread::ThreadPool* thread_pool);
+
+  // Blocks until all reads in flight have completed.
+  ~ReadaheadInputStream() override;
+
+  Status ReadNBytes(int64_t bytes_to_read, tstring* result) override;
+
+  Status SkipNBytes(int64_t bytes_to_skip) override;
+
+  int64_t Tell() const override;
+
+  Status Reset() override;
+
+ private:
+  struct Block {
+    explicit Block(int64_t offset) : offset(offset) {}
+
+    const int64_t offset;
+    tstring data;
+    Status status;
+    bool done = false;
+  };
+
+  // Consumes `bytes_to_read` bytes from the readahead blocks, appending them
+  // to `result` unless it is null.
+  Status Consume(int64_t bytes_to_read, tstring* result);
+
+  // Schedules reads until `num_blocks_` blocks are queued or the end of the
+  // file is known to be reached.
+  void ScheduleReads() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Drops the queued blocks and restarts readahead at `offset`.
+  void RestartAt(int64_t offset) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  RandomAccessFile* const file_;           // Not owned.
+  const int64_t block_size_;
+  const int num_blocks_;
+  thread::ThreadPool* const thread_pool_;  // Not owned.
+  int64_t pos_ = 0;                        // Tracks where we are in the file.
+
+  mutex mu_;
+  condition_variable cv_;
+  // Blocks in file order. The front block contains `pos_`, if any.
+  std::deque<std::shared_ptr<Block>> blocks_ TF_GUARDED_BY(mu_);
+  // Offset of the next block to read.
+  int64_t next_read_offset_ TF_GUARDED_BY(mu_) = 0;
+  // Size of the file, or -1 if a read has not yet reached the end of the file.
+  int64_t file_size_ TF_GUARDED_BY(mu_) = -1;
+  // Incremented when the queued blocks are dropped, so that reads scheduled
+  // before do not update `file_size_`.
+  int64_t generation_ TF_GUARDED_BY(mu_) = 0;
+  // Number of reads in flight, including those of dropped blocks.
+  int64_t outstanding_reads_ TF_GUARDED_BY(mu_) = 0;
+
+  ReadaheadInputStream(const ReadaheadInputStream&) = delete;
+  void operator=(const ReadaheadInputStream&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // TENSORFLOW_TSL_LIB_IO_READAHEAD_INPUTSTREAM_H_
@@ -0,0 +1,159 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/lib/io/readahead_inputstream.h"
+
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+// Fails every read that covers `failing_offset`.
+class FailingRandomAccessFile : public RandomAccessFile {
+ public:
+  FailingRandomAccessFile(RandomAccessFile* file, int64_t failing_offset)
+      : file_(file), failing_offset_(failing_offset) {}
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    if (offset <= failing_offset_ && failing_offset_ < offset + n) {
+      return errors::Unavailable("Injected read failure");
+    }
+    return file_->Read(offset, n, result, scratch);
+  }
+
+ private:
+  RandomAccessFile* const file_;
+  const uint64 failing_offset_;
+};
+
+class ReadaheadInputStreamTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Env* env = Env::Default();
+    string fname = testing::TmpDir() + "/readahead_inputstream_test";
+    TF_ASSERT_OK(WriteStringToFile(env, fname, "0123456789"));
+    TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_));
+  }
+
+  thread::ThreadPool thread_pool_{Env::Default(), "readahead_test",
+                                  /*num_threads=*/4};
+  std::unique_ptr<RandomAccessFile> file_;
+};
+
+TEST_F(ReadaheadInputStreamTest, ReadNBytes) {
+  for (int64_t block_size : {1, 2, 3, 4, 10, 20}) {
+    for (int num_blocks : {1, 2, 8}) {
+      tstring read;
+      ReadaheadInputStream in(file_.get(), block_size, num_blocks,
+                              &thread_pool_);
+      TF_ASSERT_OK(in.ReadNBytes(3, &read));
+      EXPECT_EQ(read, "012");
+      EXPECT_EQ(3, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(0, &read));
+      EXPECT_EQ(read, "");
+      EXPECT_EQ(3, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(5, &read));
+      EXPECT_EQ(read, "34567");
+      EXPECT_EQ(8, in.Tell());
+      EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(20, &read)));
+      EXPECT_EQ(read, "89");
+      EXPECT_EQ(10, in.Tell());
+      EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(1, &read)));
+      EXPECT_EQ(read, "");
+      EXPECT_EQ(10, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(0, &read));
+      EXPECT_EQ(read, "");
+    }
+  }
+}
+
+TEST_F(ReadaheadInputStreamTest, SkipNBytes) {
+  for (int64_t block_size : {1, 2, 3, 4, 10, 20}) {
+    for (int num_blocks : {1, 2, 8}) {
+      tstring read;
+      ReadaheadInputStream in(file_.get(), block_size, num_blocks,
+                              &thread_pool_);
+      TF_ASSERT_OK(in.SkipNBytes(3));
+      EXPECT_EQ(3, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(2, &read));
+      EXPECT_EQ(read, "34");
+      TF_ASSERT_OK(in.SkipNBytes(0));
+      EXPECT_EQ(5, in.Tell());
+      TF_ASSERT_OK(in.SkipNBytes(4));
+      EXPECT_EQ(9, in.Tell());
+      TF_ASSERT_OK(in.ReadNBytes(1, &read));
+      EXPECT_EQ(read, "9");
+      EXPECT_EQ(10, in.Tell());
+      EXPECT_TRUE(errors::IsOutOfRange(in.SkipNBytes(5)));
+      EXPECT_EQ(10, in.Tell());
+      EXPECT_TRUE(errors::IsInvalidArgument(in.SkipNBytes(-1)));
+    }
+  }
+}
+
+TEST_F(ReadaheadInputStreamTest, SkipPastEndOfFile) {
+  for (int64_t block_size : {1, 3, 20}) {
+    ReadaheadInputStream in(file_.get(), block_size, /*num_blocks=*/2,
+                            &thread_pool_);
+    EXPECT_TRUE(errors::IsOutOfRange(in.SkipNBytes(15)));
+    EXPECT_EQ(10, in.Tell());
+
+    tstring read;
+    TF_ASSERT_OK(in.Reset());
+    TF_ASSERT_OK(in.SkipNBytes(10));
+    EXPECT_EQ(10, in.Tell());
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(1, &read)));
+    EXPECT_EQ(read, "");
+  }
+}
+
+TEST_F(ReadaheadInputStreamTest, Reset) {
+  ReadaheadInputStream in(file_.get(), /*block_size=*/3, /*num_blocks=*/2,
+                          &thread_pool_);
+  tstring read;
+  TF_ASSERT_OK(in.ReadNBytes(4, &read));
+  EXPECT_EQ(read, "0123");
+  EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(20, &read)));
+  EXPECT_EQ(read, "456789");
+  TF_ASSERT_OK(in.Reset());
+  EXPECT_EQ(0, in.Tell());
+  TF_ASSERT_OK(in.ReadNBytes(10, &read));
+  EXPECT_EQ(read, "0123456789");
+}
+
+TEST_F(ReadaheadInputStreamTest, ReadError) {
+  FailingRandomAccessFile failing_file(file_.get(), /*failing_offset=*/4);
+  ReadaheadInputStream in(&failing_file, /*block_size=*/2, /*num_blocks=*/8,
+                          &thread_pool_);
+  tstring read;
+  TF_ASSERT_OK(in.ReadNBytes(4, &read));
+  EXPECT_EQ(read, "0123");
+  EXPECT_TRUE(errors::IsUnavailable(in.ReadNBytes(2, &read)));
+  // Skipping past the failed block restarts readahead after it.
+  TF_ASSERT_OK(in.Reset());
+  TF_ASSERT_OK(in.SkipNBytes(6));
+  TF_ASSERT_OK(in.ReadNBytes(4, &read));
+  EXPECT_EQ(read, "6789");
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl
@@ -17,13 +17,17 @@ limitations under the License.
 
 #include <limits.h>
 
+#include <vector>
+
 #include "tsl/lib/hash/crc32c.h"
 #include "tsl/lib/io/buffered_inputstream.h"
 #include "tsl/lib/io/compression.h"
 #include "tsl/lib/io/random_inputstream.h"
+#include "tsl/lib/io/readahead_inputstream.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/raw_coding.h"
+#include "tsl/platform/threadpool.h"
 
 namespace tsl {
 namespace io {
@@ -54,12 +58,30 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
   return options;
 }
 
+namespace {
+// Number of threads shared by all readers to read blocks ahead.
+constexpr int kReadaheadThreads = 32;
+
+thread::ThreadPool* ReadaheadThreadPool() {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      Env::Default(), "record_reader_readahead", kReadaheadThreads);
+  return pool;
+}
+}  // namespace
+
 RecordReader::RecordReader(RandomAccessFile* file,
                            const RecordReaderOptions& options)
     : options_(options),
       input_stream_(new RandomAccessInputStream(file)),
       last_read_failed_(false) {
-  if (options.buffer_size > 0) {
+  if (options.readahead_blocks > 0) {
+    const int64_t block_size =
+        options.buffer_size > 0
+            ? options.buffer_size
+            : RecordReaderOptions::kDefaultReadaheadBlockSize;
+    input_stream_.reset(new ReadaheadInputStream(
+        file, block_size, options.readahead_blocks, ReadaheadThreadPool()));
+  } else if (options.buffer_size > 0) {
     input_stream_.reset(new BufferedInputStream(input_stream_.release(),
                                                 options.buffer_size, true));
   }
@@ -102,6 +124,19 @@ inline const char* GetChecksumErrorSuffix(uint64 offset) {
 // a reminder about the file format is added, because TFRecord files
 // contain no explicit format marker.
 Status RecordReader::ReadChecksummed(uint64 offset, size_t n, tstring* result) {
+  uint32 masked_crc;
+  TF_RETURN_IF_ERROR(ReadUnverified(offset, n, result, &masked_crc));
+  if (crc32c::Unmask(masked_crc) != crc32c::Value(result->data(), n)) {
+    return errors::DataLoss("corrupted record at ", offset,
+                            GetChecksumErrorSuffix(offset));
+  }
+  return OkStatus();
+}
+
+// Like ReadChecksummed(), but stores the checksum in *masked_crc instead of
+// verifying it.
+Status RecordReader::ReadUnverified(uint64 offset, size_t n, tstring* result,
+                                    uint32* masked_crc) {
   if (n >= SIZE_MAX - sizeof(uint32)) {
     return errors::DataLoss("record size too large",
                             GetChecksumErrorSuffix(offset));
@@ -119,15 +154,33 @@ Status RecordReader::ReadChecksummed(uint64 offset, size_t n, tstring* result) {
     }
   }
 
-  const uint32 masked_crc = core::DecodeFixed32(result->data() + n);
-  if (crc32c::Unmask(masked_crc) != crc32c::Value(result->data(), n)) {
-    return errors::DataLoss("corrupted record at ", offset,
-                            GetChecksumErrorSuffix(offset));
-  }
+  *masked_crc = core::DecodeFixed32(result->data() + n);
   result->resize(n);
   return OkStatus();
 }
 
+// Reads the record at offset into *record, verifying the checksum of its
+// header but not of its data, whose checksum is stored in *masked_crc.
+Status RecordReader::ReadRecordUnverified(uint64 offset, tstring* record,
+                                          uint32* masked_crc) {
+  // Read header data.
+  TF_RETURN_IF_ERROR(ReadChecksummed(offset, sizeof(uint64), record));
+  const uint64 length = core::DecodeFixed64(record->data());
+
+  // Read data
+  Status s = ReadUnverified(offset + kHeaderSize, length, record, masked_crc);
+  if (errors::IsOutOfRange(s)) {
+    s = errors::DataLoss("truncated record at ", offset, "' failed with ",
+                         s.message());
+  }
+  return s;
+}
+
+bool RecordReader::ShouldVerifyDataChecksum() {
+  const int64_t n = options_.verify_checksum_every_n;
+  return n > 0 && num_records_read_++ % n == 0;
+}
+
 Status RecordReader::GetMetadata(Metadata* md) {
   if (!md) {
     return errors::InvalidArgument(
@@ -199,26 +252,151 @@ Status RecordReader::PositionInputStream(uint64 offset) {
 Status RecordReader::ReadRecord(uint64* offset, tstring* record) {
   TF_RETURN_IF_ERROR(PositionInputStream(*offset));
 
-  // Read header data.
-  Status s = ReadChecksummed(*offset, sizeof(uint64), record);
+  uint32 masked_crc;
+  Status s = ReadRecordUnverified(*offset, record, &masked_crc);
+  if (s.ok() && ShouldVerifyDataChecksum() &&
+      crc32c::Unmask(masked_crc) !=
+          crc32c::Value(record->data(), record->size())) {
+    s = errors::DataLoss("corrupted record at ", *offset + kHeaderSize);
+  }
   if (!s.ok()) {
     last_read_failed_ = true;
     return s;
   }
-  const uint64 length = core::DecodeFixed64(record->data());
 
-  // Read data
-  s = ReadChecksummed(*offset + kHeaderSize, length, record);
+  *offset += kHeaderSize + record->size() + kFooterSize;
+  DCHECK_EQ(*offset, input_stream_->Tell());
+  return OkStatus();
+}
+
+Status RecordReader::ReadRecords(uint64* offset, int num_records,
+                                 std::vector<tstring>* records) {
+  records->clear();
+  TF_RETURN_IF_ERROR(PositionInputStream(*offset));
+
+  // Read the records and the checksums of their data.
+  records->reserve(num_records);
+  std::vector<uint64> offsets;
+  offsets.reserve(num_records);
+  std::vector<size_t> to_verify;
+  std::vector<uint32> masked_crcs;
+  Status s;
+  uint64 record_offset = *offset;
+  for (int i = 0; i < num_records; ++i) {
+    tstring record;
+    uint32 masked_crc;
+    s = ReadRecordUnverified(record_offset, &record, &masked_crc);
+    if (!s.ok()) {
+      break;
+    }
+    if (ShouldVerifyDataChecksum()) {
+      to_verify.push_back(records->size());
+      masked_crcs.push_back(masked_crc);
+    }
+    offsets.push_back(record_offset);
+    record_offset += kHeaderSize + record.size() + kFooterSize;
+    records->push_back(std::move(record));
+  }
+
+  // Verify the checksums of the data of the records at once.
+  std::vector<const char*> data;
+  std::vector<size_t> sizes;
+  data.reserve(to_verify.size());
+  sizes.reserve(to_verify.size());
+  for (size_t i : to_verify) {
+    data.push_back((*records)[i].data());
+    sizes.push_back((*records)[i].size());
+  }
+  std::vector<uint32> crcs(to_verify.size());
+  crc32c::ValueMultiple(data.data(), sizes.data(), data.size(), crcs.data());
+  for (size_t j = 0; j < to_verify.size(); ++j) {
+    if (crc32c::Unmask(masked_crcs[j]) != crcs[j]) {
+      const size_t i = to_verify[j];
+      s = errors::DataLoss("corrupted record at ", offsets[i] + kHeaderSize);
+      records->resize(i);
+      record_offset = offsets[i];
+      break;
+    }
+  }
+
+  *offset = record_offset;
   if (!s.ok()) {
     last_read_failed_ = true;
-    if (errors::IsOutOfRange(s)) {
-      s = errors::DataLoss("truncated record at ", *offset, "' failed with ",
-                           s.message());
-    }
     return s;
   }
+  DCHECK_EQ(*offset, input_stream_->Tell());
+  return OkStatus();
+}
+
+Status RecordReader::ReadRecords(uint64* offset, int num_records,
+                                 tstring* data,
+                                 std::vector<StringPiece>* records) {
+  records->clear();
+  TF_RETURN_IF_ERROR(PositionInputStream(*offset));
+
+  // Read the records one at a time into `record`, whose buffer is reused, and
+  // append them to *data.
+  std::vector<uint64> offsets;
+  offsets.reserve(num_records);
+  std::vector<size_t> ends;
+  ends.reserve(num_records);
+  std::vector<bool> verify;
+  verify.reserve(num_records);
+  std::vector<uint32> masked_crcs;
+  masked_crcs.reserve(num_records);
+  Status s;
+  uint64 record_offset = *offset;
+  const size_t data_begin = data->size();
+  tstring record;
+  for (int i = 0; i < num_records; ++i) {
+    uint32 masked_crc;
+    s = ReadRecordUnverified(record_offset, &record, &masked_crc);
+    if (!s.ok()) {
+      break;
+    }
+    verify.push_back(ShouldVerifyDataChecksum());
+    masked_crcs.push_back(masked_crc);
+    offsets.push_back(record_offset);
+    record_offset += kHeaderSize + record.size() + kFooterSize;
+    data->append(record);
+    ends.push_back(data->size());
+  }
 
-  *offset += kHeaderSize + length + kFooterSize;
+  // *data no longer moves, so the views of the records can be taken and
+  // their checksums verified at once.
+  records->reserve(ends.size());
+  size_t begin = data_begin;
+  for (size_t end : ends) {
+    records->emplace_back(data->data() + begin, end - begin);
+    begin = end;
+  }
+  std::vector<const char*> to_verify_data;
+  std::vector<size_t> to_verify_sizes;
+  std::vector<size_t> to_verify;
+  for (size_t i = 0; i < records->size(); ++i) {
+    if (!verify[i]) continue;
+    to_verify.push_back(i);
+    to_verify_data.push_back((*records)[i].data());
+    to_verify_sizes.push_back((*records)[i].size());
+  }
+  std::vector<uint32> crcs(to_verify.size());
+  crc32c::ValueMultiple(to_verify_data.data(), to_verify_sizes.data(),
+                        to_verify.size(), crcs.data());
+  for (size_t j = 0; j < to_verify.size(); ++j) {
+    const size_t i = to_verify[j];
+    if (crc32c::Unmask(masked_crcs[i]) != crcs[j]) {
+      s = errors::DataLoss("corrupted record at ", offsets[i] + kHeaderSize);
+      records->resize(i);
+      record_offset = offsets[i];
+      break;
+    }
+  }
+
+  *offset = record_offset;
+  if (!s.ok()) {
+    last_read_failed_ = true;
+    return s;
+  }
   DCHECK_EQ(*offset, input_stream_->Tell());
   return OkStatus();
 }
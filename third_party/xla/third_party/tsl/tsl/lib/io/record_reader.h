@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_LIB_IO_RECORD_READER_H_
 #define TENSORFLOW_TSL_LIB_IO_RECORD_READER_H_
 
+#include <vector>
+
 #include "tsl/lib/io/inputstream_interface.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/stringpiece.h"
@@ -46,6 +48,20 @@ struct RecordReaderOptions {
   // compressed files.) Consider using SequentialRecordReader.
   int64_t buffer_size = 0;
 
+  // If readahead_blocks is non-zero, the reader keeps up to readahead_blocks
+  // reads of buffer_size bytes (or kDefaultReadaheadBlockSize if buffer_size is
+  // zero) in flight ahead of the current position, so that records are decoded
+  // while the next blocks are read. This helps on filesystems with high
+  // per-request latency. Reads must be sequential, as with buffer_size.
+  int readahead_blocks = 0;
+  static constexpr int64_t kDefaultReadaheadBlockSize = 4 << 20;  // 4MB
+
+  // Data checksums are verified for one in every verify_checksum_every_n
+  // records read, or for no records if it is 0. Header checksums, which protect
+  // the record lengths, are always verified. Verifying only a sample of the
+  // records saves CPU time when reading trusted files, e.g. local caches.
+  int64_t verify_checksum_every_n = 1;
+
   static RecordReaderOptions CreateRecordReaderOptions(
       const string& compression_type);
 
@@ -96,6 +112,21 @@ class RecordReader {
   // OUT_OF_RANGE for end of file, or something else for an error.
   Status ReadRecord(uint64* offset, tstring* record);
 
+  // Read num_records records starting at "*offset" into *records and update
+  // *offset to point to the offset of the next record. The data checksums of
+  // the records are verified together, which is faster than verifying them
+  // one record at a time. Returns OK on success, OUT_OF_RANGE for end of file,
+  // or something else for an error. On failure, *records holds the records
+  // before the one that failed and *offset points to the failed record.
+  Status ReadRecords(uint64* offset, int num_records,
+                     std::vector<tstring>* records);
+
+  // Like ReadRecords() above, but appends the data of the records to *data,
+  // so that they can share one allocation, and sets *records to views of
+  // *data. Reserving the capacity of *data beforehand avoids reallocating it.
+  Status ReadRecords(uint64* offset, int num_records, tstring* data,
+                     std::vector<StringPiece>* records);
+
   // Skip num_to_skip record starting at "*offset" and update *offset
   // to point to the offset of the next num_to_skip + 1 record.
   // Return OK on success, OUT_OF_RANGE for end of file, or something
@@ -116,11 +147,17 @@ class RecordReader {
 
  private:
   Status ReadChecksummed(uint64 offset, size_t n, tstring* result);
+  Status ReadUnverified(uint64 offset, size_t n, tstring* result,
+                        uint32* masked_crc);
+  Status ReadRecordUnverified(uint64 offset, tstring* record,
+                              uint32* masked_crc);
+  bool ShouldVerifyDataChecksum();
   Status PositionInputStream(uint64 offset);
 
   RecordReaderOptions options_;
   std::unique_ptr<InputStreamInterface> input_stream_;
   bool last_read_failed_;
+  int64_t num_records_read_ = 0;
 
   std::unique_ptr<Metadata> cached_metadata_;
 
@@ -147,6 +184,20 @@ class SequentialRecordReader {
     return underlying_.ReadRecord(&offset_, record);
   }
 
+  // Read the next num_records records in the file into *records. Returns OK
+  // on success, OUT_OF_RANGE for end of file, or something else for an error.
+  // On failure, *records holds the records read before the failure.
+  Status ReadRecords(int num_records, std::vector<tstring>* records) {
+    return underlying_.ReadRecords(&offset_, num_records, records);
+  }
+
+  // Append the next num_records records in the file to *data, and set
+  // *records to views of them. See RecordReader::ReadRecords().
+  Status ReadRecords(int num_records, tstring* data,
+                     std::vector<StringPiece>* records) {
+    return underlying_.ReadRecords(&offset_, num_records, data, records);
+  }
+
   // Skip the next num_to_skip record in the file. Return OK on success,
   // OUT_OF_RANGE for end of file, or something else for an error.
   // "*num_skipped" records the number of records that are actually skipped.
@@ -233,6 +233,214 @@ TEST(RecordReaderWriterTest, TestSkipOutOfRange) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestReadahead) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_readahead_test";
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriter writer(file.get());
+    for (int i = 0; i < 100; ++i) {
+      TF_EXPECT_OK(writer.WriteRecord(strings::StrCat("record_", i)));
+    }
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  for (auto buf_size : {0, 1, 7, 64, 4096}) {
+    for (int readahead_blocks : {1, 4}) {
+      std::unique_ptr<RandomAccessFile> read_file;
+      TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+      io::RecordReaderOptions options;
+      options.buffer_size = buf_size;
+      options.readahead_blocks = readahead_blocks;
+      io::SequentialRecordReader reader(read_file.get(), options);
+      tstring record;
+      int num_skipped;
+      TF_CHECK_OK(reader.SkipRecords(10, &num_skipped));
+      EXPECT_EQ(10, num_skipped);
+      for (int i = 10; i < 100; ++i) {
+        TF_CHECK_OK(reader.ReadRecord(&record));
+        EXPECT_EQ(strings::StrCat("record_", i), record);
+      }
+      EXPECT_EQ(error::OUT_OF_RANGE, reader.ReadRecord(&record).code());
+    }
+  }
+}
+
+TEST(RecordReaderWriterTest, TestReadRecords) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_read_records_test";
+
+  for (auto buf_size : BufferSizes()) {
+    {
+      std::unique_ptr<WritableFile> file;
+      TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+      io::RecordWriterOptions options;
+      options.zlib_options.output_buffer_size = buf_size;
+      io::RecordWriter writer(file.get(), options);
+      for (int i = 0; i < 10; ++i) {
+        TF_EXPECT_OK(writer.WriteRecord(strings::StrCat("record_", i)));
+      }
+      TF_CHECK_OK(writer.Flush());
+    }
+
+    {
+      std::unique_ptr<RandomAccessFile> read_file;
+      TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+      io::RecordReaderOptions options;
+      options.zlib_options.input_buffer_size = buf_size;
+      io::SequentialRecordReader reader(read_file.get(), options);
+      std::vector<tstring> records;
+      TF_CHECK_OK(reader.ReadRecords(4, &records));
+      ASSERT_EQ(4, records.size());
+      for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(strings::StrCat("record_", i), records[i]);
+      }
+      tstring record;
+      TF_CHECK_OK(reader.ReadRecord(&record));
+      EXPECT_EQ("record_4", record);
+      Status s = reader.ReadRecords(10, &records);
+      EXPECT_EQ(error::OUT_OF_RANGE, s.code());
+      ASSERT_EQ(5, records.size());
+      for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(strings::StrCat("record_", i + 5), records[i]);
+      }
+    }
+  }
+}
+
+TEST(RecordReaderWriterTest, TestReadRecordsIntoData) {
+  Env* env = Env::Default();
+  string fname =
+      testing::TmpDir() + "/record_reader_writer_read_records_data_test";
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriter writer(file.get());
+    for (int i = 0; i < 5; ++i) {
+      // Long enough for the records not to fit in a small tstring.
+      TF_EXPECT_OK(writer.WriteRecord(strings::StrCat(string(30, 'x'), i)));
+    }
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::SequentialRecordReader reader(read_file.get());
+  tstring data = "prefix";
+  std::vector<StringPiece> records;
+  TF_CHECK_OK(reader.ReadRecords(3, &data, &records));
+  ASSERT_EQ(3, records.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(strings::StrCat(string(30, 'x'), i), records[i]);
+  }
+  EXPECT_EQ(data.data() + 6, records[0].data());
+  EXPECT_EQ(6 + 3 * 31, data.size());
+
+  data.clear();
+  Status s = reader.ReadRecords(10, &data, &records);
+  EXPECT_EQ(error::OUT_OF_RANGE, s.code());
+  ASSERT_EQ(2, records.size());
+  EXPECT_EQ(strings::StrCat(string(30, 'x'), 4), records[1]);
+}
+
+// Writes records "abc", "defg" and "hij" to `fname` and corrupts the data of
+// "defg".
+static void WriteCorruptedRecords(const string& fname) {
+  Env* env = Env::Default();
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriter writer(file.get());
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_EXPECT_OK(writer.WriteRecord("defg"));
+    TF_EXPECT_OK(writer.WriteRecord("hij"));
+    TF_CHECK_OK(writer.Flush());
+  }
+  string contents;
+  TF_CHECK_OK(ReadFileToString(env, fname, &contents));
+  // "defg" starts at 19 + kHeaderSize.
+  contents[19 + io::RecordReader::kHeaderSize] = 'x';
+  TF_CHECK_OK(WriteStringToFile(env, fname, contents));
+}
+
+TEST(RecordReaderWriterTest, TestReadRecordsCorruptedData) {
+  Env* env = Env::Default();
+  string fname =
+      testing::TmpDir() + "/record_reader_writer_read_records_corrupted_test";
+  WriteCorruptedRecords(fname);
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::RecordReader reader(read_file.get());
+  uint64 offset = 0;
+  std::vector<tstring> records;
+  Status s = reader.ReadRecords(&offset, 3, &records);
+  EXPECT_EQ(error::DATA_LOSS, s.code());
+  EXPECT_EQ("corrupted record at 31", s.message());
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("abc", records[0]);
+  EXPECT_EQ(19, offset);
+}
+
+TEST(RecordReaderWriterTest, TestReadRecordsIntoDataCorruptedData) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() +
+                 "/record_reader_writer_read_records_data_corrupted_test";
+  WriteCorruptedRecords(fname);
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::RecordReader reader(read_file.get());
+  uint64 offset = 0;
+  tstring data;
+  std::vector<StringPiece> records;
+  Status s = reader.ReadRecords(&offset, 3, &data, &records);
+  EXPECT_EQ(error::DATA_LOSS, s.code());
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("abc", records[0]);
+  EXPECT_EQ(19, offset);
+}
+
+TEST(RecordReaderWriterTest, TestChecksumSampling) {
+  Env* env = Env::Default();
+  string fname =
+      testing::TmpDir() + "/record_reader_writer_checksum_sampling_test";
+  WriteCorruptedRecords(fname);
+
+  for (int64_t verify_checksum_every_n : {0, 2, 3}) {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options;
+    options.verify_checksum_every_n = verify_checksum_every_n;
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 0;
+    tstring record;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("abc", record);
+    // The corrupted second record is not verified.
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("xefg", record);
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("hij", record);
+  }
+
+  for (int64_t verify_checksum_every_n : {1, 2}) {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options;
+    options.verify_checksum_every_n = verify_checksum_every_n;
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 19;
+    std::vector<tstring> records;
+    Status s = reader.ReadRecords(&offset, 2, &records);
+    EXPECT_EQ(error::DATA_LOSS, s.code());
+    EXPECT_TRUE(records.empty());
+  }
+}
+
 TEST(RecordReaderWriterTest, TestMalformedInput) {
   Env* env = Env::Default();
   string fname =
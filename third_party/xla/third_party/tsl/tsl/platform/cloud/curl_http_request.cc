@@ -16,10 +16,12 @@ limitations under the License.
 #include "tsl/platform/cloud/curl_http_request.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "tsl/lib/gtl/map_util.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/macros.h"
+#include "tsl/platform/mutex.h"
 #include "tsl/platform/scanner.h"
 #include "tsl/platform/str_util.h"
 #include "tsl/platform/types.h"
@@ -34,7 +36,20 @@ namespace {
 // Set to 1 to enable verbose debug output from curl.
 constexpr uint64 kVerboseOutput = 0;
 
+// Maximum number of idle easy handles kept around for reuse. Each idle handle
+// holds on to its own connection cache, so this also bounds the number of
+// keep-alive connections that outlive the requests that opened them.
+constexpr size_t kMaxIdleCurlHandles = 64;
+
 // Proxy to the real libcurl implementation.
+//
+// Easy handles released through curl_easy_cleanup() are reset and pooled
+// instead of being destroyed, so that the next request picks up the live
+// connections of an earlier one and skips the TCP and TLS setup. All handles
+// also share the DNS cache and the TLS session cache, so that a handle opening
+// a new connection can still resume a session negotiated by another handle.
+// The connection cache itself is deliberately not shared: libcurl does not
+// support using shared connections from multiple threads concurrently.
 class LibCurlProxy : public LibCurl {
  public:
   static LibCurlProxy* Load() {
@@ -45,7 +60,21 @@ class LibCurlProxy : public LibCurl {
     return libcurl;
   }
 
-  CURL* curl_easy_init() override { return ::curl_easy_init(); }
+  CURL* curl_easy_init() override {
+    {
+      mutex_lock l(idle_mu_);
+      if (!idle_handles_.empty()) {
+        CURL* curl = idle_handles_.back();
+        idle_handles_.pop_back();
+        return curl;
+      }
+    }
+    CURL* curl = ::curl_easy_init();
+    if (curl != nullptr && share_ != nullptr) {
+      CHECK_CURL_OK(::curl_easy_setopt(curl, CURLOPT_SHARE, share_));
+    }
+    return curl;
+  }
 
   CURLcode curl_easy_setopt(CURL* curl, CURLoption option,
                             uint64 param) override {
@@ -96,7 +125,17 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_easy_cleanup(CURL* curl) override {
-    return ::curl_easy_cleanup(curl);
+    // Resetting keeps the live connections and the attached share handle, but
+    // drops every option pointing into the request that is going away.
+    ::curl_easy_reset(curl);
+    {
+      mutex_lock l(idle_mu_);
+      if (idle_handles_.size() < kMaxIdleCurlHandles) {
+        idle_handles_.push_back(curl);
+        return;
+      }
+    }
+    ::curl_easy_cleanup(curl);
   }
 
   char* curl_easy_escape(CURL* curl, const char* str, int length) override {
@@ -112,7 +151,58 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+ private:
+  LibCurlProxy() {
+    share_ = ::curl_share_init();
+    if (share_ == nullptr) {
+      LOG(WARNING) << "Couldn't initialize a curl share handle; DNS and TLS "
+                      "session caches won't be shared between requests.";
+      return;
+    }
+    CHECK_EQ(::curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &LockShare),
+             CURLSHE_OK);
+    CHECK_EQ(::curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &UnlockShare),
+             CURLSHE_OK);
+    CHECK_EQ(::curl_share_setopt(share_, CURLSHOPT_USERDATA, this),
+             CURLSHE_OK);
+    CHECK_EQ(::curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS),
+             CURLSHE_OK);
+    CHECK_EQ(::curl_share_setopt(share_, CURLSHOPT_SHARE,
+                                 CURL_LOCK_DATA_SSL_SESSION),
+             CURLSHE_OK);
+  }
+
+  static void LockShare(CURL* handle, curl_lock_data data,
+                        curl_lock_access access, void* userptr) {
+    static_cast<LibCurlProxy*>(userptr)->share_mu_[data].lock();
+  }
+
+  static void UnlockShare(CURL* handle, curl_lock_data data, void* userptr) {
+    static_cast<LibCurlProxy*>(userptr)->share_mu_[data].unlock();
+  }
+
+  // The proxy is a leaked singleton, so the share handle and the pooled easy
+  // handles live until the process exits.
+  CURLSH* share_ = nullptr;
+  mutex share_mu_[CURL_LOCK_DATA_LAST];
+
+  mutex idle_mu_;
+  std::vector<CURL*> idle_handles_ TF_GUARDED_BY(idle_mu_);
 };
+
+// Returns the HTTP version requested from libcurl. HTTP/2 is negotiated over
+// TLS when TF_CURL_ENABLE_HTTP2 is set, falling back to HTTP/1.1 for servers
+// that don't offer it.
+uint64 HttpVersion() {
+  static const uint64 version = []() -> uint64 {
+    bool enable_http2 = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_CURL_ENABLE_HTTP2", false,
+                                   &enable_http2));
+    return enable_http2 ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1;
+  }();
+  return version;
+}
 }  // namespace
 
 CurlHttpRequest::CurlHttpRequest() : CurlHttpRequest(LibCurlProxy::Load()) {}
@@ -140,9 +230,9 @@ CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
   // Do not use signals for timeouts - does not work in multi-threaded programs.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L));
 
-  // TODO(b/74351157): Enable HTTP/2.
+  // TODO(b/74351157): Enable HTTP/2 by default.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
-                                           CURL_HTTP_VERSION_1_1));
+                                           HttpVersion()));
 
   // Set up the progress meter.
   CHECK_CURL_OK(
@@ -16,7 +16,9 @@ limitations under the License.
 #include "tsl/platform/cloud/curl_http_request.h"
 
 #include <fstream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "tsl/lib/core/status_test_util.h"
@@ -959,5 +961,19 @@ TEST(CurlHttpRequestTest, StatsPut) {
   TF_EXPECT_OK(stats.record_response_result_);
 }
 
+TEST(CurlHttpRequestTest, RealLibCurlHandlesAreReusable) {
+  // Released handles go back to a pool and must come out of it reset, with
+  // none of the options of the request that used them before.
+  for (int i = 0; i < 200; ++i) {
+    std::vector<std::unique_ptr<CurlHttpRequest>> requests;
+    for (int j = 0; j < i % 100; ++j) {
+      requests.push_back(std::make_unique<CurlHttpRequest>());
+      requests.back()->SetUri("http://www.testuri.com/" + std::to_string(j));
+    }
+    CurlHttpRequest http_request;
+    EXPECT_EQ("a%20b", http_request.EscapeString("a b"));
+  }
+}
+
 }  // namespace
 }  // namespace tsl
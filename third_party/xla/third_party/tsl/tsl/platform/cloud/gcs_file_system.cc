@@ -45,6 +45,7 @@ limitations under the License.
 #include "tsl/platform/cloud/file_block_cache.h"
 #include "tsl/platform/cloud/google_auth_provider.h"
 #include "tsl/platform/cloud/ram_file_block_cache.h"
+#include "tsl/platform/blocking_counter.h"
 #include "tsl/platform/cloud/time_util.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
@@ -163,6 +164,23 @@ constexpr char kAppendMode[] = "GCS_APPEND_MODE";
 // objects.
 constexpr char kComposeAppend[] = "compose";
 
+// The environment variable that sets the number of parts that large files are
+// uploaded as at the same time (format: <int32_t>, at most 32). The parts are
+// temporary objects composed into the file, so as with compose appends this
+// is disabled by default.
+constexpr char kParallelUploadParts[] = "GCS_PARALLEL_UPLOAD_PARTS";
+// The environment variable that overrides the minimum size of the files that
+// are uploaded in parts. Specified in MB.
+constexpr char kParallelUploadThreshold[] = "GCS_PARALLEL_UPLOAD_THRESHOLD_MB";
+// The environment variable that sets the number of ranged requests that large
+// reads are split into (format: <int32_t>). Disabled by default.
+constexpr char kParallelReadConnections[] = "GCS_PARALLEL_READ_CONNECTIONS";
+// The environment variable that overrides the minimum size of the reads that
+// are split. Specified in MB.
+constexpr char kParallelReadThreshold[] = "GCS_PARALLEL_READ_THRESHOLD_MB";
+// The maximum number of source objects of a compose request.
+constexpr int kMaxComposeSources = 32;
+
 Status GetTmpFilename(string* filename) {
   *filename = io::GetTempFilename("");
   return OkStatus();
@@ -461,6 +479,13 @@ typedef std::function<Status(const string& fname, const string& bucket,
                              const string& object, int64_t* generation)>
     GenerationGetter;
 
+// Function object declaration with params needed to upload a file in parts.
+typedef std::function<Status(const std::string& tmp_content_filename,
+                             uint64 file_size, const std::string& bucket,
+                             const std::string& object,
+                             const std::string& gcs_path, bool* uploaded)>
+    ParallelUploader;
+
 /// \brief GCS-based implementation of a writeable file.
 ///
 /// Since GCS objects are immutable, this implementation writes to a local
@@ -474,7 +499,8 @@ class GcsWritableFile : public WritableFile {
                   RetryConfig retry_config, bool compose_append,
                   SessionCreator session_creator,
                   ObjectUploader object_uploader, StatusPoller status_poller,
-                  GenerationGetter generation_getter)
+                  GenerationGetter generation_getter,
+                  ParallelUploader parallel_uploader)
       : bucket_(bucket),
         object_(object),
         filesystem_(filesystem),
@@ -487,7 +513,8 @@ class GcsWritableFile : public WritableFile {
         session_creator_(std::move(session_creator)),
         object_uploader_(std::move(object_uploader)),
         status_poller_(std::move(status_poller)),
-        generation_getter_(std::move(generation_getter)) {
+        generation_getter_(std::move(generation_getter)),
+        parallel_uploader_(std::move(parallel_uploader)) {
     // TODO: to make it safer, outfile_ should be constructed from an FD
     VLOG(3) << "GcsWritableFile: " << GetGcsPath();
     if (GetTmpFilename(&tmp_content_filename_).ok()) {
@@ -508,7 +535,8 @@ class GcsWritableFile : public WritableFile {
                   RetryConfig retry_config, bool compose_append,
                   SessionCreator session_creator,
                   ObjectUploader object_uploader, StatusPoller status_poller,
-                  GenerationGetter generation_getter)
+                  GenerationGetter generation_getter,
+                  ParallelUploader parallel_uploader)
       : bucket_(bucket),
         object_(object),
         filesystem_(filesystem),
@@ -521,7 +549,8 @@ class GcsWritableFile : public WritableFile {
         session_creator_(std::move(session_creator)),
         object_uploader_(std::move(object_uploader)),
         status_poller_(std::move(status_poller)),
-        generation_getter_(std::move(generation_getter)) {
+        generation_getter_(std::move(generation_getter)),
+        parallel_uploader_(std::move(parallel_uploader)) {
     VLOG(3) << "GcsWritableFile: " << GetGcsPath() << "with existing file "
             << tmp_content_filename;
     tmp_content_filename_ = tmp_content_filename;
@@ -602,6 +631,20 @@ class GcsWritableFile : public WritableFile {
       return errors::Internal(
           "Could not write to the internal temporary file.");
     }
+    if (!compose_append_ || start_offset_ == 0) {
+      // The whole file is uploaded, which may be done in parts.
+      uint64 file_size;
+      TF_RETURN_IF_ERROR(GetCurrentFileSize(&file_size));
+      bool uploaded = false;
+      TF_RETURN_IF_ERROR(parallel_uploader_(tmp_content_filename_, file_size,
+                                            bucket_, object_, GetGcsPath(),
+                                            &uploaded));
+      if (uploaded) {
+        file_cache_erase_();
+        start_offset_ = file_size;
+        return OkStatus();
+      }
+    }
     UploadSessionHandle session_handle;
     uint64 start_offset = 0;
     string object_to_upload = object_;
@@ -781,6 +824,7 @@ class GcsWritableFile : public WritableFile {
   const ObjectUploader object_uploader_;
   const StatusPoller status_poller_;
   const GenerationGetter generation_getter_;
+  const ParallelUploader parallel_uploader_;
 };
 
 class GcsReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
@@ -849,12 +893,16 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+  if (GetEnvVar(kMaxReadaheadBlocks, strings::safe_strtou64, &value)) {
+    max_readahead_blocks_ = value;
+  }
   if (!make_default_cache) {
     max_bytes = 0;
   }
   VLOG(1) << "GCS cache max size = " << max_bytes << " ; "
           << "block size = " << block_size_ << " ; "
-          << "max staleness = " << max_staleness;
+          << "max staleness = " << max_staleness << " ; "
+          << "max readahead blocks = " << max_readahead_blocks_;
   file_block_cache_ = MakeFileBlockCache(block_size_, max_bytes, max_staleness);
   // Apply overrides for the stat cache max age and max entries, if provided.
   uint64 stat_cache_max_age = kStatCacheDefaultMaxAge;
@@ -976,6 +1024,23 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
     compose_append_ = false;
   }
 
+  ParallelTransferConfig parallel_config;
+  int32_t parallel_value;
+  if (GetEnvVar(kParallelUploadParts, strings::safe_strto32, &parallel_value)) {
+    parallel_config.upload_parts = parallel_value;
+  }
+  if (GetEnvVar(kParallelUploadThreshold, strings::safe_strtou64, &value)) {
+    parallel_config.upload_threshold = value * 1024 * 1024;
+  }
+  if (GetEnvVar(kParallelReadConnections, strings::safe_strto32,
+                &parallel_value)) {
+    parallel_config.read_connections = parallel_value;
+  }
+  if (GetEnvVar(kParallelReadThreshold, strings::safe_strtou64, &value)) {
+    parallel_config.read_threshold = value * 1024 * 1024;
+  }
+  SetParallelTransferConfig(parallel_config);
+
   retry_config_ = GetGcsRetryConfig();
 }
 
@@ -1075,6 +1140,43 @@ void GcsFileSystem::ResetFileBlockCache(size_t block_size_bytes,
   }
 }
 
+void GcsFileSystem::SetParallelTransferConfig(
+    const ParallelTransferConfig& config) {
+  parallel_transfer_config_ = config;
+  parallel_transfer_config_.upload_parts =
+      std::min(std::max(config.upload_parts, 1), kMaxComposeSources);
+  parallel_transfer_config_.read_connections =
+      std::max(config.read_connections, 1);
+  // The calling thread transfers one of the parts itself.
+  const int num_threads = std::max(parallel_transfer_config_.upload_parts,
+                                   parallel_transfer_config_.read_connections) -
+                          1;
+  if (num_threads > 0) {
+    transfer_pool_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "gcs_transfer", num_threads);
+  } else {
+    transfer_pool_.reset();
+  }
+}
+
+Status GcsFileSystem::RunInParallel(int n,
+                                    const std::function<Status(int)>& fn) {
+  std::vector<Status> statuses(n);
+  BlockingCounter counter(n - 1);
+  for (int i = 1; i < n; ++i) {
+    transfer_pool_->Schedule([&fn, &statuses, &counter, i]() {
+      statuses[i] = fn(i);
+      counter.DecrementCount();
+    });
+  }
+  statuses[0] = fn(0);
+  counter.Wait();
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return OkStatus();
+}
+
 // A helper function to build a FileBlockCache for GcsFileSystem.
 std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
     size_t block_size, size_t max_bytes, uint64 max_staleness) {
@@ -1084,7 +1186,8 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
              size_t* bytes_transferred) {
         return LoadBufferFromGCS(filename, offset, n, buffer,
                                  bytes_transferred);
-      }));
+      },
+      Env::Default(), max_readahead_blocks_));
 
   // Check if cache is enabled here to avoid unnecessary mutex contention.
   cache_enabled_ = file_block_cache->IsCacheEnabled();
@@ -1103,6 +1206,52 @@ Status GcsFileSystem::LoadBufferFromGCS(const string& fname, size_t offset,
   profiler::TraceMe activity(
       [fname]() { return absl::StrCat("LoadBufferFromGCS ", fname); });
 
+  const int num_ranges =
+      n < parallel_transfer_config_.read_threshold
+          ? 1
+          : static_cast<int>(std::min<size_t>(
+                parallel_transfer_config_.read_connections, n));
+  if (num_ranges == 1) {
+    TF_RETURN_IF_ERROR(LoadRangeFromGCS(fname, bucket, object, offset, n,
+                                        buffer, bytes_transferred));
+  } else {
+    // Ranged requests past the end of the object read nothing, so the ranges
+    // are read at the same time and the data read is their longest prefix.
+    const size_t range_size = (n + num_ranges - 1) / num_ranges;
+    std::vector<size_t> range_bytes(num_ranges, 0);
+    TF_RETURN_IF_ERROR(RunInParallel(num_ranges, [&](int i) {
+      const size_t range_offset = std::min(n, i * range_size);
+      const size_t range_n = std::min(n - range_offset, range_size);
+      if (range_n == 0) return OkStatus();
+      return LoadRangeFromGCS(fname, bucket, object, offset + range_offset,
+                              range_n, buffer + range_offset, &range_bytes[i]);
+    }));
+    for (int i = 0; i < num_ranges; ++i) {
+      *bytes_transferred += range_bytes[i];
+      if (range_bytes[i] < range_size) {
+        for (int j = i + 1; j < num_ranges; ++j) {
+          if (range_bytes[j] > 0) {
+            return errors::Internal(strings::Printf(
+                "File contents are inconsistent for file: %s @ %lu.",
+                fname.c_str(), offset + i * range_size));
+          }
+        }
+        break;
+      }
+    }
+  }
+  activity.AppendMetadata([bytes_read = *bytes_transferred]() {
+    return profiler::TraceMeEncode({{"block_size", bytes_read}});
+  });
+  return OkStatus();
+}
+
+Status GcsFileSystem::LoadRangeFromGCS(const string& fname,
+                                       const string& bucket,
+                                       const string& object, size_t offset,
+                                       size_t n, char* buffer,
+                                       size_t* bytes_transferred) {
+  *bytes_transferred = 0;
   std::unique_ptr<HttpRequest> request;
   TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(&request),
                                   "when reading gs://", bucket, "/", object);
@@ -1124,9 +1273,6 @@ Status GcsFileSystem::LoadBufferFromGCS(const string& fname, size_t offset,
   *bytes_transferred = bytes_read;
   VLOG(1) << "Successful read of gs://" << bucket << "/" << object << " @ "
           << offset << " of size: " << bytes_read;
-  activity.AppendMetadata([bytes_read]() {
-    return profiler::TraceMeEncode({{"block_size", bytes_read}});
-  });
 
   if (stats_ != nullptr) {
     stats_->RecordBlockRetrieved(fname, offset, bytes_read);
@@ -1272,6 +1418,98 @@ Status GcsFileSystem::RequestUploadSessionStatus(const string& session_uri,
   return OkStatus();
 }
 
+Status GcsFileSystem::UploadInParallel(const std::string& tmp_content_filename,
+                                       uint64 file_size,
+                                       const std::string& bucket,
+                                       const std::string& object,
+                                       const std::string& gcs_path,
+                                       bool* uploaded) {
+  *uploaded = false;
+  const int num_parts = parallel_transfer_config_.upload_parts;
+  if (num_parts <= 1 || file_size < static_cast<uint64>(num_parts) ||
+      file_size < parallel_transfer_config_.upload_threshold) {
+    return OkStatus();
+  }
+  const uint64 part_size = (file_size + num_parts - 1) / num_parts;
+  std::vector<string> part_objects(num_parts);
+  for (int i = 0; i < num_parts; ++i) {
+    part_objects[i] =
+        strings::StrCat(io::Dirname(object), "/.tmpcompose/",
+                        io::Basename(object), ".part", i, "of", num_parts);
+  }
+  VLOG(3) << "UploadInParallel: " << gcs_path << " in " << num_parts
+          << " parts";
+
+  // Each part is read into memory and uploaded with a single request, since
+  // the parts are small compared to the whole file.
+  TF_RETURN_IF_ERROR(RunInParallel(num_parts, [&](int i) {
+    const uint64 part_offset = std::min(file_size, i * part_size);
+    const uint64 part_n = std::min(file_size - part_offset, part_size);
+    string data(part_n, '\0');
+    std::ifstream part_file(tmp_content_filename, std::ifstream::binary);
+    part_file.seekg(part_offset);
+    part_file.read(&data[0], part_n);
+    if (!part_file.good()) {
+      return errors::Internal(
+          "Could not read the internal temporary file for part ", i, " of ",
+          gcs_path);
+    }
+    return RetryingUtils::CallWithRetries(
+        [&]() {
+          std::unique_ptr<HttpRequest> request;
+          TF_RETURN_IF_ERROR(CreateHttpRequest(&request));
+          request->SetUri(strings::StrCat(
+              kGcsUploadUriBase, "b/", bucket, "/o?uploadType=media&name=",
+              request->EscapeString(part_objects[i])));
+          request->AddHeader("content-type", "application/octet-stream");
+          request->SetTimeouts(timeouts_.connect, timeouts_.idle,
+                               timeouts_.write);
+          request->SetPostFromBuffer(data.data(), data.size());
+          TF_RETURN_WITH_CONTEXT_IF_ERROR(
+              request->Send(), " when uploading part ", i, " of ", gcs_path);
+          return OkStatus();
+        },
+        retry_config_);
+  }));
+
+  TF_RETURN_IF_ERROR(RetryingUtils::CallWithRetries(
+      [&]() {
+        std::unique_ptr<HttpRequest> request;
+        TF_RETURN_IF_ERROR(CreateHttpRequest(&request));
+        request->SetUri(strings::StrCat(kGcsUriBase, "b/", bucket, "/o/",
+                                        request->EscapeString(object),
+                                        "/compose"));
+        string request_body = "{'sourceObjects': [";
+        for (int i = 0; i < num_parts; ++i) {
+          strings::StrAppend(&request_body, i > 0 ? "," : "", "{'name': '",
+                             part_objects[i], "'}");
+        }
+        strings::StrAppend(&request_body, "]}");
+        request->SetTimeouts(timeouts_.connect, timeouts_.idle,
+                             timeouts_.metadata);
+        request->AddHeader("content-type", "application/json");
+        request->SetPostFromBuffer(request_body.c_str(), request_body.size());
+        TF_RETURN_WITH_CONTEXT_IF_ERROR(request->Send(), " when composing to ",
+                                        gcs_path);
+        return OkStatus();
+      },
+      retry_config_));
+  *uploaded = true;
+
+  // The object is complete, so failing to delete a part only strands it.
+  for (const string& part_object : part_objects) {
+    const string part_path = strings::StrCat("gs://", bucket, "/", part_object);
+    const Status delete_status = RetryingUtils::DeleteWithRetries(
+        [&part_path, this]() { return DeleteFile(part_path, nullptr); },
+        retry_config_);
+    if (!delete_status.ok()) {
+      LOG(WARNING) << "Could not delete the temporary object " << part_path
+                   << ": " << delete_status;
+    }
+  }
+  return OkStatus();
+}
+
 Status GcsFileSystem::ParseGcsPathForScheme(StringPiece fname, string scheme,
                                             bool empty_object_ok,
                                             string* bucket, string* object) {
@@ -1346,12 +1584,19 @@ Status GcsFileSystem::NewWritableFile(const string& fname,
     *generation = stat.generation_number;
     return OkStatus();
   };
+  auto parallel_uploader =
+      [this](const std::string& tmp_content_filename, uint64 file_size,
+             const std::string& bucket, const std::string& object,
+             const std::string& gcs_path, bool* uploaded) {
+        return UploadInParallel(tmp_content_filename, file_size, bucket,
+                                object, gcs_path, uploaded);
+      };
 
   result->reset(new GcsWritableFile(
       bucket, object, this, &timeouts_,
       [this, fname]() { ClearFileCaches(fname); }, retry_config_,
       compose_append_, session_creator, object_uploader, status_poller,
-      generation_getter));
+      generation_getter, parallel_uploader));
   return OkStatus();
 }
 
@@ -1423,6 +1668,13 @@ Status GcsFileSystem::NewAppendableFile(const string& fname,
     *generation = stat.generation_number;
     return OkStatus();
   };
+  auto parallel_uploader =
+      [this](const std::string& tmp_content_filename, uint64 file_size,
+             const std::string& bucket, const std::string& object,
+             const std::string& gcs_path, bool* uploaded) {
+        return UploadInParallel(tmp_content_filename, file_size, bucket,
+                                object, gcs_path, uploaded);
+      };
 
   // Create a writable file and pass the old content to it.
   string bucket, object;
@@ -1431,7 +1683,7 @@ Status GcsFileSystem::NewAppendableFile(const string& fname,
       bucket, object, this, old_content_filename, &timeouts_,
       [this, fname]() { ClearFileCaches(fname); }, retry_config_,
       compose_append_, session_creator, object_uploader, status_poller,
-      generation_getter));
+      generation_getter, parallel_uploader));
   return OkStatus();
 }
 
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_PLATFORM_CLOUD_GCS_FILE_SYSTEM_H_
 #define TENSORFLOW_TSL_PLATFORM_CLOUD_GCS_FILE_SYSTEM_H_
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -32,6 +34,7 @@ limitations under the License.
 #include "tsl/platform/file_system.h"
 #include "tsl/platform/retrying_file_system.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/threadpool.h"
 
 namespace tsl {
 
@@ -62,6 +65,10 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that sets the maximum number of blocks that are
+// fetched ahead of sequential reads from GCS. Readahead is disabled by default.
+constexpr char kMaxReadaheadBlocks[] = "GCS_READ_CACHE_MAX_READAHEAD_BLOCKS";
+constexpr size_t kDefaultMaxReadaheadBlocks = 0;
 
 // Helper function to extract an environment variable and convert it into a
 // value of type T.
@@ -125,6 +132,7 @@ struct UploadSessionHandle {
 class GcsFileSystem : public FileSystem {
  public:
   struct TimeoutConfig;
+  struct ParallelTransferConfig;
 
   // Main constructor used (via RetryingFileSystem) throughout Tensorflow
   explicit GcsFileSystem(bool make_default_cache = true);
@@ -215,6 +223,9 @@ class GcsFileSystem : public FileSystem {
   }
 
   bool compose_append() const { return compose_append_; }
+  ParallelTransferConfig parallel_transfer_config() const {
+    return parallel_transfer_config_;
+  }
   string additional_header_name() const {
     return additional_header_ ? additional_header_->first : "";
   }
@@ -267,6 +278,23 @@ class GcsFileSystem : public FileSystem {
           write(write) {}
   };
 
+  /// Structure containing the configuration of the concurrent transfers used
+  /// for large objects.
+  ///
+  /// A part or connection count of 1 disables the corresponding transfers.
+  struct ParallelTransferConfig {
+    // Objects of at least `upload_threshold` bytes are uploaded as
+    // `upload_parts` temporary objects at the same time, which are then
+    // composed into the object. GCS composes at most 32 objects at once.
+    int upload_parts = 1;
+    uint64 upload_threshold = 256 * 1024 * 1024;
+
+    // Reads of at least `read_threshold` bytes are split into
+    // `read_connections` ranged requests that are made at the same time.
+    int read_connections = 1;
+    uint64 read_threshold = 32 * 1024 * 1024;
+  };
+
   Status CreateHttpRequest(std::unique_ptr<HttpRequest>* request);
 
   /// \brief Sets a new AuthProvider on the GCS FileSystem.
@@ -284,6 +312,11 @@ class GcsFileSystem : public FileSystem {
   void ResetFileBlockCache(size_t block_size_bytes, size_t max_bytes,
                            uint64 max_staleness_secs);
 
+  /// \brief Sets the configuration of the concurrent transfers.
+  ///
+  /// This should be called before any file is opened.
+  void SetParallelTransferConfig(const ParallelTransferConfig& config);
+
  protected:
   virtual std::unique_ptr<FileBlockCache> MakeFileBlockCache(
       size_t block_size, size_t max_bytes, uint64 max_staleness);
@@ -317,6 +350,16 @@ class GcsFileSystem : public FileSystem {
                                             const std::string& gcs_path,
                                             bool* completed, uint64* uploaded);
 
+  /// \brief Uploads the whole temporary file as concurrently uploaded parts
+  /// that are composed into the object, if the file is large enough.
+  ///
+  /// Sets 'uploaded' to false, and does nothing else, when parallel uploads
+  /// are disabled or the file is too small.
+  virtual Status UploadInParallel(const std::string& tmp_content_filename,
+                                  uint64 file_size, const std::string& bucket,
+                                  const std::string& object,
+                                  const std::string& gcs_path, bool* uploaded);
+
   Status ParseGcsPathForScheme(StringPiece fname, string scheme,
                                bool empty_object_ok, string* bucket,
                                string* object);
@@ -404,6 +447,15 @@ class GcsFileSystem : public FileSystem {
 
   Status RenameObject(const string& src, const string& target);
 
+  /// Reads the range with a single request. See LoadBufferFromGCS.
+  Status LoadRangeFromGCS(const string& fname, const string& bucket,
+                          const string& object, size_t offset, size_t n,
+                          char* buffer, size_t* bytes_transferred);
+
+  /// \brief Runs fn(0), ..., fn(n - 1) at the same time, using the transfer
+  /// thread pool, and returns the first error.
+  Status RunInParallel(int n, const std::function<Status(int)>& fn);
+
   // Clear all the caches related to the file with name `filename`.
   void ClearFileCaches(const string& fname);
 
@@ -415,6 +467,10 @@ class GcsFileSystem : public FileSystem {
   // Reads smaller than block_size_ will trigger a read of block_size_.
   uint64 block_size_;
 
+  // The maximum number of blocks the block cache fetches ahead of sequential
+  // reads.
+  size_t max_readahead_blocks_ = kDefaultMaxReadaheadBlocks;
+
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -436,6 +492,10 @@ class GcsFileSystem : public FileSystem {
   std::unordered_set<string> allowed_locations_;
   bool compose_append_;
 
+  ParallelTransferConfig parallel_transfer_config_;
+  // Runs the concurrent transfers, or nullptr when they are disabled.
+  std::unique_ptr<thread::ThreadPool> transfer_pool_;
+
   GcsStatsInterface* stats_ = nullptr;  // Not owned.
 
   // Additional header material to be transmitted with all GCS requests
@@ -3681,6 +3681,32 @@ TEST(GcsFileSystemTest, OverrideCacheParameters) {
   EXPECT_EQ(40, fs5.timeouts().write);
 }
 
+TEST(GcsFileSystemTest, OverrideParallelTransferParameters) {
+  GcsFileSystem fs1;
+  EXPECT_EQ(1, fs1.parallel_transfer_config().upload_parts);
+  EXPECT_EQ(1, fs1.parallel_transfer_config().read_connections);
+
+  setenv("GCS_PARALLEL_UPLOAD_PARTS", "8", 1);
+  setenv("GCS_PARALLEL_UPLOAD_THRESHOLD_MB", "100", 1);
+  setenv("GCS_PARALLEL_READ_CONNECTIONS", "4", 1);
+  setenv("GCS_PARALLEL_READ_THRESHOLD_MB", "16", 1);
+  GcsFileSystem fs2;
+  EXPECT_EQ(8, fs2.parallel_transfer_config().upload_parts);
+  EXPECT_EQ(100 * 1024 * 1024, fs2.parallel_transfer_config().upload_threshold);
+  EXPECT_EQ(4, fs2.parallel_transfer_config().read_connections);
+  EXPECT_EQ(16 * 1024 * 1024, fs2.parallel_transfer_config().read_threshold);
+
+  // GCS composes at most 32 objects.
+  setenv("GCS_PARALLEL_UPLOAD_PARTS", "64", 1);
+  GcsFileSystem fs3;
+  EXPECT_EQ(32, fs3.parallel_transfer_config().upload_parts);
+
+  unsetenv("GCS_PARALLEL_UPLOAD_PARTS");
+  unsetenv("GCS_PARALLEL_UPLOAD_THRESHOLD_MB");
+  unsetenv("GCS_PARALLEL_READ_CONNECTIONS");
+  unsetenv("GCS_PARALLEL_READ_THRESHOLD_MB");
+}
+
 TEST(GcsFileSystemTest, CreateHttpRequest) {
   std::vector<HttpRequest*> requests(
       {// IsDirectory is checking whether there are children objects.
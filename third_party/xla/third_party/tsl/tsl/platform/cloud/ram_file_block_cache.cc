@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tsl/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <memory>
 
@@ -22,6 +24,14 @@ limitations under the License.
 #include "tsl/platform/env.h"
 
 namespace tsl {
+namespace {
+
+// The number of consecutive sequential reads of a file that start readahead.
+constexpr int kMinSequentialReads = 2;
+// The weight of a new sample in the averages of the readahead timings.
+constexpr double kTimingSmoothing = 0.25;
+
+}  // namespace
 
 bool RamFileBlockCache::BlockNotStale(const std::shared_ptr<Block>& block) {
   mutex_lock l(block->mu);
@@ -48,6 +58,11 @@ std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::Lookup(
     }
   }
 
+  return InsertBlock(key);
+}
+
+std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::InsertBlock(
+    const Key& key) {
   // Insert a new empty block, setting the bookkeeping to sentinel values
   // in order to update them as appropriate.
   auto new_entry = std::make_shared<Block>();
@@ -75,6 +90,7 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
     // The block was evicted from another thread. Allow it to remain evicted.
     return OkStatus();
   }
+  block->prefetched = false;
   if (block->lru_iterator != lru_list_.begin()) {
     lru_list_.erase(block->lru_iterator);
     lru_list_.push_front(key);
@@ -84,12 +100,15 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
   // Check for inconsistent state. If there is a block later in the same file
   // in the cache, and our current block is not block size, this likely means
   // we have inconsistent state within the cache. Note: it's possible some
-  // incomplete reads may still go undetected.
+  // incomplete reads may still go undetected. Blocks fetched by readahead
+  // past the end of the file are ignored, since they are not read yet.
   if (block->data.size() < block_size_) {
     Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
     auto fcmp = block_map_.upper_bound(fmax);
-    if (fcmp != block_map_.begin() && key < (--fcmp)->first) {
-      return errors::Internal("Block cache contents are inconsistent.");
+    while (fcmp != block_map_.begin() && key < (--fcmp)->first) {
+      if (!fcmp->second->prefetched) {
+        return errors::Internal("Block cache contents are inconsistent.");
+      }
     }
   }
 
@@ -134,8 +153,14 @@ Status RamFileBlockCache::MaybeFetch(const Key& key,
         block->data.clear();
         block->data.resize(block_size_, 0);
         size_t bytes_transferred;
-        status.Update(block_fetcher_(key.first, key.second, block_size_,
-                                     block->data.data(), &bytes_transferred));
+        {
+          const uint64 fetch_start = env_->NowMicros();
+          status.Update(block_fetcher_(key.first, key.second, block_size_,
+                                       block->data.data(), &bytes_transferred));
+          if (fetch_pool_ && status.ok()) {
+            RecordFetchMicros(env_->NowMicros() - fetch_start);
+          }
+        }
         if (cache_stats_ != nullptr) {
           cache_stats_->RecordCacheMissBlockSize(bytes_transferred);
         }
@@ -184,6 +209,9 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   if (finish < offset + n) {
     finish += block_size_;
   }
+  if (fetch_pool_) {
+    MaybeReadahead(filename, start, finish);
+  }
   size_t total_bytes_transferred = 0;
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
@@ -229,6 +257,99 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   return OkStatus();
 }
 
+void RamFileBlockCache::RecordFetchMicros(uint64 micros) {
+  const uint64 average = fetch_micros_.load(std::memory_order_relaxed);
+  fetch_micros_.store(
+      average == 0 ? micros
+                   : static_cast<uint64>(kTimingSmoothing * micros +
+                                         (1 - kTimingSmoothing) * average),
+      std::memory_order_relaxed);
+}
+
+void RamFileBlockCache::MaybeReadahead(const string& filename, size_t start,
+                                       size_t finish) {
+  std::vector<std::pair<Key, std::shared_ptr<Block>>> prefetches;
+  {
+    mutex_lock lock(mu_);
+    ReadPattern& pattern = read_patterns_[filename];
+    const uint64 now = env_->NowMicros();
+    const bool sequential =
+        pattern.end > 0 &&
+        (start == pattern.end || start + block_size_ == pattern.end);
+    if (!sequential) {
+      pattern.sequential_reads = 0;
+      pattern.micros_per_block = 0;
+      pattern.readahead_end = 0;
+    } else {
+      ++pattern.sequential_reads;
+      if (finish > pattern.end) {
+        // The time since the previous read is the time the reader took to
+        // consume the blocks it advanced by.
+        const double micros_per_block =
+            static_cast<double>(now - pattern.last_read_micros) * block_size_ /
+            (finish - pattern.end);
+        pattern.micros_per_block =
+            pattern.micros_per_block == 0
+                ? micros_per_block
+                : kTimingSmoothing * micros_per_block +
+                      (1 - kTimingSmoothing) * pattern.micros_per_block;
+      }
+    }
+    if (!sequential || finish > pattern.end) {
+      pattern.last_read_micros = now;
+    }
+    pattern.end = finish;
+    if (pattern.sequential_reads < kMinSequentialReads) {
+      return;
+    }
+
+    // Read ahead as many blocks as the reader consumes while a block is
+    // fetched, so that the next block is ready when it is needed.
+    size_t depth = max_readahead_blocks_;
+    const uint64 fetch_micros = fetch_micros_.load(std::memory_order_relaxed);
+    if (fetch_micros > 0 && pattern.micros_per_block > 0) {
+      depth = std::min<size_t>(
+          depth, std::ceil(fetch_micros / pattern.micros_per_block) + 1);
+    }
+    const size_t readahead_finish = finish + depth * block_size_;
+    for (size_t pos = std::max(finish, pattern.readahead_end);
+         pos < readahead_finish; pos += block_size_) {
+      Key key = std::make_pair(filename, pos);
+      if (block_map_.find(key) != block_map_.end()) continue;
+      std::shared_ptr<Block> block = InsertBlock(key);
+      block->prefetched = true;
+      prefetches.emplace_back(std::move(key), std::move(block));
+    }
+    pattern.readahead_end = std::max(pattern.readahead_end, readahead_finish);
+  }
+  for (auto& prefetch : prefetches) {
+    fetch_pool_->Schedule([this, prefetch = std::move(prefetch)]() {
+      Prefetch(prefetch.first, prefetch.second);
+    });
+  }
+}
+
+void RamFileBlockCache::Prefetch(const Key& key,
+                                 const std::shared_ptr<Block>& block) {
+  const Status status = MaybeFetch(key, block);
+  mutex_lock lock(mu_);
+  if (block->timestamp == 0) {
+    // The block was evicted while it was fetched.
+    return;
+  }
+  // A partial block ends the file, and the blocks after it are empty. Drop
+  // them, so that only a read of the file caches its last block.
+  if (!status.ok() || block->data.size() < block_size_) {
+    auto entry = block_map_.find(key);
+    if (block->prefetched && entry != block_map_.end() &&
+        entry->second == block) {
+      RemoveBlock(entry);
+    }
+    return;
+  }
+  Trim();
+}
+
 bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
                                                        int64_t file_signature) {
   mutex_lock lock(mu_);
@@ -274,6 +395,7 @@ void RamFileBlockCache::Flush() {
   lru_list_.clear();
   lra_list_.clear();
   cache_size_ = 0;
+  read_patterns_.clear();
 }
 
 void RamFileBlockCache::RemoveFile(const string& filename) {
@@ -282,6 +404,7 @@ void RamFileBlockCache::RemoveFile(const string& filename) {
 }
 
 void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
+  read_patterns_.erase(filename);
   Key begin = std::make_pair(filename, 0);
   auto it = block_map_.lower_bound(begin);
   while (it != block_map_.end() && it->first.first == filename) {
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 #define TENSORFLOW_TSL_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <list>
 #include <map>
@@ -30,6 +32,7 @@ limitations under the License.
 #include "tsl/platform/status.h"
 #include "tsl/platform/stringpiece.h"
 #include "tsl/platform/thread_annotations.h"
+#include "tsl/platform/threadpool.h"
 #include "tsl/platform/types.h"
 
 namespace tsl {
@@ -38,6 +41,11 @@ namespace tsl {
 ///
 /// This class should be shared by read-only random access files on a remote
 /// filesystem (e.g. GCS).
+///
+/// If `max_readahead_blocks` is positive, sequential reads of a file fetch the
+/// blocks that follow them ahead of time on a pool of fetch threads. The number
+/// of blocks read ahead is the number of blocks the reader consumes while one
+/// block is fetched, up to `max_readahead_blocks` and half of the cache.
 class RamFileBlockCache : public FileBlockCache {
  public:
   /// The callback executed when a block is not found in the cache, and needs to
@@ -51,21 +59,32 @@ class RamFileBlockCache : public FileBlockCache {
       BlockFetcher;
 
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, Env* env = Env::Default(),
+                    size_t max_readahead_blocks = 0)
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
         block_fetcher_(block_fetcher),
-        env_(env) {
+        env_(env),
+        max_readahead_blocks_(
+            IsCacheEnabled()
+                ? std::min(max_readahead_blocks, max_bytes / block_size / 2)
+                : 0) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (max_readahead_blocks_ > 0) {
+      fetch_pool_ = std::make_unique<thread::ThreadPool>(
+          env_, "TF_readahead_FBC", max_readahead_blocks_);
+    }
     VLOG(1) << "GCS file block cache is "
             << (IsCacheEnabled() ? "enabled" : "disabled");
   }
 
   ~RamFileBlockCache() override {
+    // Destroying fetch_pool_ will block until the pending readahead is done.
+    fetch_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -109,6 +128,7 @@ class RamFileBlockCache : public FileBlockCache {
   size_t block_size() const override { return block_size_; }
   size_t max_bytes() const override { return max_bytes_; }
   uint64 max_staleness() const override { return max_staleness_; }
+  size_t max_readahead_blocks() const { return max_readahead_blocks_; }
 
   /// The current size (in bytes) of the cache.
   size_t CacheSize() const override TF_LOCKS_EXCLUDED(mu_);
@@ -131,6 +151,8 @@ class RamFileBlockCache : public FileBlockCache {
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
   Env* const env_;  // not owned
+  /// The maximum number of blocks fetched ahead of a sequential read.
+  const size_t max_readahead_blocks_;
 
   /// \brief The key type for the file block cache.
   ///
@@ -158,10 +180,11 @@ class RamFileBlockCache : public FileBlockCache {
   /// was cached, a coordination lock, and state & condition variables.
   ///
   /// Thread safety:
-  /// The iterator and timestamp fields should only be accessed while holding
-  /// the block-cache-wide mu_ instance variable. The state variable should only
-  /// be accessed while holding the Block's mu lock. The data vector should only
-  /// be accessed after state == FINISHED, and it should never be modified.
+  /// The iterator, timestamp and prefetched fields should only be accessed
+  /// while holding the block-cache-wide mu_ instance variable. The state
+  /// variable should only be accessed while holding the Block's mu lock. The
+  /// data vector should only be accessed after state == FINISHED, and it should
+  /// never be modified.
   ///
   /// In order to prevent deadlocks, never grab the block-cache-wide mu_ lock
   /// AFTER grabbing any block's mu lock. It is safe to grab mu without locking
@@ -175,6 +198,8 @@ class RamFileBlockCache : public FileBlockCache {
     std::list<Key>::iterator lra_iterator;
     /// The timestamp (seconds since epoch) at which the block was cached.
     uint64 timestamp;
+    /// Whether the block was fetched by readahead and has not been read yet.
+    bool prefetched = false;
     /// Mutex to guard state variable
     mutex mu;
     /// The state of the block.
@@ -188,6 +213,23 @@ class RamFileBlockCache : public FileBlockCache {
   /// The block map is an ordered map from Key to Block.
   typedef std::map<Key, std::shared_ptr<Block>> BlockMap;
 
+  /// \brief The access pattern of the recent reads of a file.
+  ///
+  /// A read is sequential if it starts in the last block of the previous read
+  /// of the file, or in the block after it.
+  struct ReadPattern {
+    /// The block-aligned end of the previous read.
+    size_t end = 0;
+    /// The number of consecutive sequential reads.
+    int sequential_reads = 0;
+    /// The time (microseconds since epoch) of the previous read.
+    uint64 last_read_micros = 0;
+    /// The average time the reader takes to consume a block, in microseconds.
+    double micros_per_block = 0;
+    /// The end of the blocks already scheduled for readahead.
+    size_t readahead_end = 0;
+  };
+
   /// Prune the cache by removing files with expired blocks.
   void Prune() TF_LOCKS_EXCLUDED(mu_);
 
@@ -197,6 +239,23 @@ class RamFileBlockCache : public FileBlockCache {
   /// Look up a Key in the block cache.
   std::shared_ptr<Block> Lookup(const Key& key) TF_LOCKS_EXCLUDED(mu_);
 
+  /// Insert a new empty block for `key`, which must not be in the cache.
+  std::shared_ptr<Block> InsertBlock(const Key& key)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Update the read pattern of the file with a read of the blocks in
+  /// [start, finish), and fetch the blocks that follow it if the reads are
+  /// sequential.
+  void MaybeReadahead(const string& filename, size_t start, size_t finish)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  /// Add a block fetch time to the average fetch time.
+  void RecordFetchMicros(uint64 micros);
+
+  /// Fetch a block inserted by readahead on the fetch pool.
+  void Prefetch(const Key& key, const std::shared_ptr<Block>& block)
+      TF_LOCKS_EXCLUDED(mu_);
+
   Status MaybeFetch(const Key& key, const std::shared_ptr<Block>& block)
       TF_LOCKS_EXCLUDED(mu_);
 
@@ -221,6 +280,14 @@ class RamFileBlockCache : public FileBlockCache {
   /// Notification for stopping the cache pruning thread.
   Notification stop_pruning_thread_;
 
+  /// The threads that fetch blocks ahead of sequential reads, or nullptr if
+  /// readahead is disabled.
+  std::unique_ptr<thread::ThreadPool> fetch_pool_;
+
+  /// The average time to fetch a block, in microseconds. Updated without mu_,
+  /// since fetches run while holding a block's mu lock.
+  std::atomic<uint64> fetch_micros_{0};
+
   /// Guards access to the block map, LRU list, and cached byte count.
   mutable mutex mu_;
 
@@ -243,6 +310,9 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64_t> file_signature_map_ TF_GUARDED_BY(mu_);
+
+  /// The read patterns of the files read with readahead enabled.
+  std::map<string, ReadPattern> read_patterns_ TF_GUARDED_BY(mu_);
 };
 
 }  // namespace tsl
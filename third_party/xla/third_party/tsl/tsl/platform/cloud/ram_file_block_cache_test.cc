@@ -15,12 +15,14 @@ limitations under the License.
 
 #include "tsl/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/blocking_counter.h"
 #include "tsl/platform/cloud/now_seconds_env.h"
 #include "tsl/platform/env.h"
+#include "tsl/platform/mutex.h"
 #include "tsl/platform/notification.h"
 #include "tsl/platform/test.h"
 
@@ -566,5 +568,78 @@ TEST(RamFileBlockCacheTest, Flush) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, ReadaheadIsBoundedByCacheSize) {
+  auto fetcher = [](const string& filename, size_t offset, size_t n,
+                    char* buffer, size_t* bytes_transferred) {
+    return OkStatus();
+  };
+  RamFileBlockCache cache1(16, 32, 0, fetcher, Env::Default(), 8);
+  RamFileBlockCache cache2(16, 1024, 0, fetcher, Env::Default(), 8);
+  RamFileBlockCache cache3(16, 0, 0, fetcher, Env::Default(), 8);
+  EXPECT_EQ(cache1.max_readahead_blocks(), 1);
+  EXPECT_EQ(cache2.max_readahead_blocks(), 8);
+  EXPECT_EQ(cache3.max_readahead_blocks(), 0);
+}
+
+TEST(RamFileBlockCacheTest, SequentialReadahead) {
+  // A file of 100 bytes, whose last block is partial.
+  const size_t block_size = 16;
+  const size_t file_size = 100;
+  mutex mu;
+  std::vector<size_t> fetched;
+  auto fetcher = [&mu, &fetched, file_size](const string& filename,
+                                            size_t offset, size_t n,
+                                            char* buffer,
+                                            size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      fetched.push_back(offset);
+    }
+    *bytes_transferred = offset < file_size ? std::min(n, file_size - offset)
+                                            : 0;
+    for (size_t i = 0; i < *bytes_transferred; ++i) {
+      buffer[i] = static_cast<char>(offset + i);
+    }
+    return OkStatus();
+  };
+  auto wait_for_fetch = [&mu, &fetched](size_t offset) {
+    for (int i = 0; i < 1000; ++i) {
+      {
+        mutex_lock l(mu);
+        if (std::find(fetched.begin(), fetched.end(), offset) !=
+            fetched.end()) {
+          return true;
+        }
+      }
+      Env::Default()->SleepForMicroseconds(10000);
+    }
+    return false;
+  };
+  RamFileBlockCache cache(block_size, 1024, 0, fetcher, Env::Default(), 2);
+  std::vector<char> out;
+  std::vector<char> contents;
+  // The third sequential read starts fetching the following blocks.
+  for (size_t pos = 0; pos < 3 * block_size; pos += block_size) {
+    TF_EXPECT_OK(ReadCache(&cache, "a", pos, block_size, &out));
+    contents.insert(contents.end(), out.begin(), out.end());
+  }
+  EXPECT_TRUE(wait_for_fetch(3 * block_size));
+  EXPECT_TRUE(wait_for_fetch(4 * block_size));
+  {
+    mutex_lock l(mu);
+    EXPECT_EQ(fetched.size(), 5);
+  }
+  // Reading on to the end of the file uses the blocks read ahead, and the
+  // readahead past the end of the file does not make the cache inconsistent.
+  for (size_t pos = 3 * block_size; pos < file_size; pos += block_size) {
+    TF_EXPECT_OK(ReadCache(&cache, "a", pos, block_size, &out));
+    contents.insert(contents.end(), out.begin(), out.end());
+  }
+  ASSERT_EQ(contents.size(), file_size);
+  for (size_t i = 0; i < file_size; ++i) {
+    EXPECT_EQ(contents[i], static_cast<char>(i));
+  }
+}
+
 }  // namespace
 }  // namespace tsl
@@ -64,6 +64,12 @@ int NumTotalCPUs();
 // identified.  If successful, the return value will be in [0, NumTotalCPUs()).
 int GetCurrentCPU();
 
+// Restricts the current thread to run on `num_cpus` of the CPUs that it may
+// currently run on, starting with the `first_cpu`-th one in increasing order of
+// the CPU ids.  Returns false if the affinity of the thread was not changed,
+// e.g. if the platform does not support it or if `first_cpu` is out of range.
+bool SetCurrentThreadCPUAffinity(int first_cpu, int num_cpus);
+
 // Returns an estimate of the number of hyperthreads per physical core
 // on the CPU
 int NumHyperthreadsPerCore();
@@ -163,6 +163,42 @@ int GetCurrentCPU() {
   return kUnknownCPU;
 }
 
+bool SetCurrentThreadCPUAffinity(int first_cpu, int num_cpus) {
+#if defined(__linux__)
+  for (int ncpus = 1024; ncpus < std::numeric_limits<int>::max() / 2;
+       ncpus *= 2) {
+    size_t setsize = CPU_ALLOC_SIZE(ncpus);
+    cpu_set_t* allowed = CPU_ALLOC(ncpus);
+    if (!allowed) break;
+    if (sched_getaffinity(0, setsize, allowed) != 0) {
+      CPU_FREE(allowed);
+      if (errno != EINVAL) break;
+      continue;
+    }
+    cpu_set_t* mask = CPU_ALLOC(ncpus);
+    if (!mask) {
+      CPU_FREE(allowed);
+      break;
+    }
+    CPU_ZERO_S(setsize, mask);
+    int index = 0;
+    for (int cpu = 0; cpu < ncpus; ++cpu) {
+      if (!CPU_ISSET_S(cpu, setsize, allowed)) continue;
+      if (index >= first_cpu && index < first_cpu + num_cpus) {
+        CPU_SET_S(cpu, setsize, mask);
+      }
+      ++index;
+    }
+    const bool result = first_cpu >= 0 && first_cpu < index && num_cpus > 0 &&
+                        sched_setaffinity(0, setsize, mask) == 0;
+    CPU_FREE(mask);
+    CPU_FREE(allowed);
+    return result;
+  }
+#endif
+  return false;
+}
+
 int NumHyperthreadsPerCore() {
   static const int ht_per_core = tsl::port::CPUIDNumSMT();
   return (ht_per_core > 0) ? ht_per_core : 1;
@@ -194,6 +194,11 @@ double NominalCPUFrequency() {
   return 1.0;
 }
 
+bool SetCurrentThreadCPUAffinity(int first_cpu, int num_cpus) {
+  // Not yet implemented.
+  return false;
+}
+
 int NumHyperthreadsPerCore() {
   static const int ht_per_core = tsl::port::CPUIDNumSMT();
   return (ht_per_core > 0) ? ht_per_core : 1;
@@ -43,6 +43,7 @@ namespace internal {
 // included only on DLL exports.
 DECL_DLL_EXPORT std::atomic<int> g_trace_level(
     TraceMeRecorder::kTracingDisabled);
+DECL_DLL_EXPORT std::atomic<int> g_trace_sampling_period(1);
 
 // g_trace_level implementation must be lock-free for faster execution of the
 // TraceMe API. This can be commented (if compilation is failing) but execution
@@ -373,9 +374,17 @@ TraceMeRecorder::Events TraceMeRecorder::Consume() {
   return result;
 }
 
-bool TraceMeRecorder::StartRecording(int level) {
+bool TraceMeRecorder::StartRecording(int level, int sampling_period) {
   level = std::max(0, level);
   mutex_lock lock(mutex_);
+  if (internal::g_trace_level.load(std::memory_order_acquire) !=
+      kTracingDisabled) {
+    return false;
+  }
+  // The sampling period is published before the trace level so that events
+  // are never recorded with the period of a previous session.
+  internal::g_trace_sampling_period.store(std::max(1, sampling_period),
+                                          std::memory_order_relaxed);
   // Change trace_level_ while holding mutex_.
   int expected = kTracingDisabled;
   bool started = internal::g_trace_level.compare_exchange_strong(
@@ -36,6 +36,10 @@ namespace internal {
 // Modified by TraceMeRecorder singleton when tracing starts/stops.
 TF_EXPORT extern std::atomic<int> g_trace_level;
 
+// Records one in every `g_trace_sampling_period` events started on a thread.
+// Modified by TraceMeRecorder singleton when tracing starts/stops.
+TF_EXPORT extern std::atomic<int> g_trace_sampling_period;
+
 }  // namespace internal
 
 // TraceMeRecorder is a singleton repository of TraceMe events.
@@ -83,7 +87,11 @@ class TraceMeRecorder {
   // Starts recording of TraceMe().
   // Only traces <= level will be recorded.
   // Level must be >= 0. If level is 0, no traces will be recorded.
-  static bool Start(int level) { return Get()->StartRecording(level); }
+  // If sampling_period is greater than 1, only one in every sampling_period
+  // TraceMe events started on each thread will be recorded.
+  static bool Start(int level, int sampling_period = 1) {
+    return Get()->StartRecording(level, sampling_period);
+  }
 
   // Stops recording and returns events recorded since Start().
   // Events passed to Record after Stop has started will be dropped.
@@ -94,6 +102,16 @@ class TraceMeRecorder {
     return internal::g_trace_level.load(std::memory_order_acquire) >= level;
   }
 
+  // Returns whether the next event started on this thread should be recorded
+  // under the current sampling period. Only meaningful while Active().
+  static inline bool ShouldSample() {
+    const int period =
+        internal::g_trace_sampling_period.load(std::memory_order_relaxed);
+    if (TF_PREDICT_TRUE(period <= 1)) return true;
+    thread_local uint32 counter = 0;
+    return ++counter % period == 0;
+  }
+
   // Default value for trace_level_ when tracing is disabled
   static constexpr int kTracingDisabled = -1;
 
@@ -118,7 +136,7 @@ class TraceMeRecorder {
   void RegisterThread(uint32 tid, std::shared_ptr<ThreadLocalRecorder> thread);
   void UnregisterThread(uint32 tid);
 
-  bool StartRecording(int level);
+  bool StartRecording(int level, int sampling_period);
   Events StopRecording();
 
   // Clears events from all active threads that were added due to Record
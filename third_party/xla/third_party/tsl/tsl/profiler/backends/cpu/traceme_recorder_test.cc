@@ -56,6 +56,31 @@ TEST(RecorderTest, SingleThreaded) {
               ElementsAre(Named("during1"), Named("during2")));
 }
 
+TEST(RecorderTest, Sampling) {
+  int64_t start_time = GetCurrentTimeNanos();
+  int64_t end_time = start_time + UniToNano(1);
+
+  TraceMeRecorder::Start(/*level=*/1, /*sampling_period=*/3);
+  int num_sampled = 0;
+  for (int i = 0; i < 9; ++i) {
+    if (TraceMeRecorder::ShouldSample()) {
+      ++num_sampled;
+      TraceMeRecorder::Record({"sampled", start_time, end_time});
+    }
+  }
+  auto results = TraceMeRecorder::Stop();
+  EXPECT_EQ(num_sampled, 3);
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].events.size(), 3);
+
+  // The sampling period does not carry over to the next session.
+  TraceMeRecorder::Start(/*level=*/1);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(TraceMeRecorder::ShouldSample());
+  }
+  TraceMeRecorder::Stop();
+}
+
 // Checks the functional behavior of the recorder, when used from several
 // unsynchronized threads.
 //
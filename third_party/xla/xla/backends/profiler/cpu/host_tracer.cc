@@ -39,7 +39,7 @@ namespace {
 // Thread-safety: This class is go/thread-compatible.
 class HostTracer : public tsl::profiler::ProfilerInterface {
  public:
-  explicit HostTracer(int host_trace_level);
+  explicit HostTracer(int host_trace_level, int sampling_period = 1);
   ~HostTracer() override;
 
   tsl::Status Start() override;  // TENSORFLOW_STATUS_OK
@@ -53,6 +53,9 @@ class HostTracer : public tsl::profiler::ProfilerInterface {
   // Level of host tracing.
   const int host_trace_level_;
 
+  // Records one in every `sampling_period_` TraceMe events on each thread.
+  const int sampling_period_;
+
   // True if currently recording.
   bool recording_ = false;
 
@@ -63,8 +66,8 @@ class HostTracer : public tsl::profiler::ProfilerInterface {
   tsl::profiler::TraceMeRecorder::Events events_;
 };
 
-HostTracer::HostTracer(int host_trace_level)
-    : host_trace_level_(host_trace_level) {}
+HostTracer::HostTracer(int host_trace_level, int sampling_period)
+    : host_trace_level_(host_trace_level), sampling_period_(sampling_period) {}
 
 HostTracer::~HostTracer() { Stop().IgnoreError(); }  // NOLINT
 
@@ -77,7 +80,8 @@ tsl::Status HostTracer::Start() {  // TENSORFLOW_STATUS_OK
   // start_timestamp_ns_ to prevent timestamp underflow in XPlane.
   // Therefore this have to be done before TraceMeRecorder::Start.
   start_timestamp_ns_ = tsl::profiler::GetCurrentTimeNanos();
-  recording_ = tsl::profiler::TraceMeRecorder::Start(host_trace_level_);
+  recording_ = tsl::profiler::TraceMeRecorder::Start(host_trace_level_,
+                                                      sampling_period_);
   if (!recording_) {
     return tsl::errors::Internal("Failed to start TraceMeRecorder");
   }
@@ -115,7 +119,8 @@ tsl::Status HostTracer::CollectData(  // TENSORFLOW_STATUS_OK
 std::unique_ptr<tsl::profiler::ProfilerInterface> CreateHostTracer(
     const HostTracerOptions& options) {
   if (options.trace_level == 0) return nullptr;
-  return std::make_unique<HostTracer>(options.trace_level);
+  return std::make_unique<HostTracer>(options.trace_level,
+                                      options.sampling_period);
 }
 
 }  // namespace profiler
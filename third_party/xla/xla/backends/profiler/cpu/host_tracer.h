@@ -32,6 +32,10 @@ struct HostTracerOptions {
   // - Level 3 enables tracing of all level 2 TraceMe(s) and more verbose
   //           (low-level) program execution details (cheap TF ops, etc).
   int trace_level = 2;
+
+  // Records one in every `sampling_period` TraceMe events on each thread.
+  // Values <= 1 record every event.
+  int sampling_period = 1;
 };
 
 std::unique_ptr<tsl::profiler::ProfilerInterface> CreateHostTracer(
@@ -26,6 +26,7 @@ std::unique_ptr<tsl::profiler::ProfilerInterface> CreateHostTracer(
     const tensorflow::ProfileOptions& profile_options) {
   HostTracerOptions options;
   options.trace_level = profile_options.host_tracer_level();
+  options.sampling_period = profile_options.host_tracer_sampling_period();
   return CreateHostTracer(options);
 }
 
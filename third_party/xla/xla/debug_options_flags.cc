@@ -212,6 +212,15 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_gpu_enable_cub_radix_sort(true);
   opts.set_xla_gpu_enable_cudnn_layer_norm(false);
   opts.set_xla_gpu_threshold_for_windowed_einsum_mib(100000);
+  opts.set_xla_gpu_shard_autotuning(false);
+  opts.set_xla_gpu_lhs_strict_memory_limit(false);
+  opts.set_xla_gpu_analyze_host_offloading(false);
+  opts.set_xla_gpu_merge_independent_dots(false);
+  opts.set_xla_cpu_parallel_tasks_per_thread(1);
+  opts.set_xla_cpu_object_cache_dir("");
+  opts.set_xla_gpu_windowed_einsum_cost_model(false);
+  opts.set_xla_gpu_collective_combine_devices_per_node(0);
+  opts.set_xla_gpu_inter_node_combine_threshold_bytes(kDefaultThreshold);
   return opts;
 }
 
@@ -1427,6 +1436,75 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       debug_options->xla_gpu_threshold_for_windowed_einsum_mib(),
       "Threshold to enable windowed einsum (collective matmul) in MB."
       "Default is 100000"));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_fusion_runtime_profile",
+      string_setter_for(&DebugOptions::set_xla_gpu_fusion_runtime_profile),
+      debug_options->xla_gpu_fusion_runtime_profile(),
+      "File with measured fusion runtimes (a text or binary "
+      "FusionRuntimeProfile) that priority fusion uses instead of the "
+      "estimates of the performance model. When dumping is enabled, a report "
+      "of predicted vs. measured runtime per fusion is dumped as well."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_shard_autotuning",
+      bool_setter_for(&DebugOptions::set_xla_gpu_shard_autotuning),
+      debug_options->xla_gpu_shard_autotuning(),
+      "Autotune each instruction on one process of a multi-host job and share "
+      "the result with the other processes through the distributed key-value "
+      "store, instead of autotuning it on every process."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_lhs_strict_memory_limit",
+      bool_setter_for(&DebugOptions::set_xla_gpu_lhs_strict_memory_limit),
+      debug_options->xla_gpu_lhs_strict_memory_limit(),
+      "Treat the memory limit of the latency-hiding scheduler as a hard limit, "
+      "limiting how early async collectives are started so that the schedule "
+      "fits in it."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_analyze_host_offloading",
+      bool_setter_for(&DebugOptions::set_xla_gpu_analyze_host_offloading),
+      debug_options->xla_gpu_analyze_host_offloading(),
+      "Report the activations of the scheduled module that could be offloaded "
+      "to host memory while unused. The report is dumped as "
+      "host_offload_candidates.txt when dumping is enabled."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_merge_independent_dots",
+      bool_setter_for(&DebugOptions::set_xla_gpu_merge_independent_dots),
+      debug_options->xla_gpu_merge_independent_dots(),
+      "Merge small independent dots with the same operand shapes into a "
+      "single batched dot, so that they run as one batched GEMM."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_parallel_tasks_per_thread",
+      int32_setter_for(&DebugOptions::set_xla_cpu_parallel_tasks_per_thread),
+      debug_options->xla_cpu_parallel_tasks_per_thread(),
+      "Maximum number of partitions per intra-op thread for ops parallelized "
+      "by XLA:CPU. Partitions are load balanced between threads at runtime."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_object_cache_dir",
+      string_setter_for(&DebugOptions::set_xla_cpu_object_cache_dir),
+      debug_options->xla_cpu_object_cache_dir(),
+      "If not empty, cache object files JIT-compiled by XLA:CPU in this "
+      "directory and reuse them when the same module is compiled again."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_windowed_einsum_cost_model",
+      bool_setter_for(&DebugOptions::set_xla_gpu_windowed_einsum_cost_model),
+      debug_options->xla_gpu_windowed_einsum_cost_model(),
+      "Decide whether to use windowed einsum for sharded dots from a roofline "
+      "model of the GPU instead of "
+      "--xla_gpu_threshold_for_windowed_einsum_mib."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_collective_combine_devices_per_node",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_collective_combine_devices_per_node),
+      debug_options->xla_gpu_collective_combine_devices_per_node(),
+      "Number of GPUs per node. If set, collectives whose replica groups span "
+      "multiple nodes are combined up to "
+      "--xla_gpu_inter_node_combine_threshold_bytes."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_inter_node_combine_threshold_bytes",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_inter_node_combine_threshold_bytes),
+      debug_options->xla_gpu_inter_node_combine_threshold_bytes(),
+      "Size threshold (in bytes) for combining collectives that communicate "
+      "between nodes."));
 }  // NOLINT(readability/fn_size)
 
 // Allocates flag_values and flag_objects; this function must not be called more
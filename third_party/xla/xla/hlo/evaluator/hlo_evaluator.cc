@@ -4635,6 +4635,20 @@ Status HloEvaluator::Postprocess(const HloInstruction* hlo) {
   return OkStatus();
 }
 
+/*static*/ bool HloEvaluator::IsLinearElementwise(
+    const Shape& result_shape, absl::Span<const Literal* const> operands) {
+  if (!LayoutUtil::IsDenseArray(result_shape) || !result_shape.is_static()) {
+    return false;
+  }
+  return absl::c_all_of(operands, [&](const Literal* operand) {
+    const Shape& shape = operand->shape();
+    return LayoutUtil::IsDenseArray(shape) && shape.is_static() &&
+           ShapeUtil::SameDimensions(shape, result_shape) &&
+           Layout::Equal().MinorToMajorOnly()(shape.layout(),
+                                              result_shape.layout());
+  });
+}
+
 namespace {
 template <typename T>
 std::unique_ptr<Array2D<T>> MatmulArray2DImpl(
@@ -18,12 +18,15 @@ limitations under the License.
 
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/types/span.h"
 #include "xla/array2d.h"
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
@@ -433,6 +436,44 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
   bool use_fast_path_ = false;
 
  private:
+  // Elementwise ops on at least this many elements are split across the
+  // threads of ShapeUtil::ForEachIndexParallel by PopulateLinear.
+  static constexpr int64_t kMinElementsPerThread = 1 << 14;
+
+  // Returns whether the element at linear index i of a literal of shape
+  // `result_shape` corresponds to the element at linear index i of each of
+  // `operands`, so that elementwise ops can iterate over the data of the
+  // literals directly rather than through multidimensional indices.
+  static bool IsLinearElementwise(const Shape& result_shape,
+                                  absl::Span<const Literal* const> operands);
+
+  // Sets the element at linear index i of `result` to generator(i).
+  template <typename NativeT>
+  static void PopulateLinear(Literal& result,
+                             absl::FunctionRef<NativeT(int64_t)> generator) {
+    absl::Span<NativeT> data = result.data<NativeT>();
+    const int64_t size = data.size();
+    const int64_t num_chunks =
+        std::min<int64_t>(ShapeUtil::GetForEachIndexParallelThreadCount(),
+                          size / kMinElementsPerThread);
+    if (num_chunks <= 1) {
+      for (int64_t i = 0; i < size; ++i) {
+        data[i] = generator(i);
+      }
+      return;
+    }
+    const int64_t chunk_size = CeilOfRatio(size, num_chunks);
+    ShapeUtil::ForEachIndexParallel(
+        ShapeUtil::MakeShape(PRED, {num_chunks}),
+        [&](absl::Span<const int64_t> chunk, int) -> StatusOr<bool> {
+          const int64_t end = std::min(size, (chunk[0] + 1) * chunk_size);
+          for (int64_t i = chunk[0] * chunk_size; i < end; ++i) {
+            data[i] = generator(i);
+          }
+          return true;
+        });
+  }
+
   template <typename ReturnT, typename NativeT>
   static StatusOr<Literal> ElementWiseUnaryOpImpl(
       const HloInstruction* instruction,
@@ -443,6 +484,12 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     TF_RET_CHECK(ShapeUtil::SameDimensions(shape, operand->shape()));
 
     Literal result(shape);
+    if (IsLinearElementwise(result.shape(), {&operand_literal})) {
+      absl::Span<const NativeT> operand_data = operand_literal.data<NativeT>();
+      PopulateLinear<ReturnT>(
+          result, [&](int64_t i) { return unary_op(operand_data[i]); });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return unary_op(operand_literal.Get<NativeT>(multi_index));
@@ -367,6 +367,30 @@ TEST_F(HloEvaluatorTest, DoesAdd) {
   TestBinaryOp(HloOpcode::kAdd, std::move(expected), std::move(lhs),
                std::move(rhs));
 }
+// Large enough to be split across threads.
+TEST_F(HloEvaluatorTest, DoesAddLarge) {
+  constexpr int64_t kSize = 1 << 20;
+  std::vector<int32_t> lhs(kSize), rhs(kSize), expected(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    lhs[i] = i;
+    rhs[i] = 2 * i;
+    expected[i] = 3 * i;
+  }
+  TestBinaryOp(HloOpcode::kAdd, LiteralUtil::CreateR1<int32_t>(expected),
+               LiteralUtil::CreateR1<int32_t>(lhs),
+               LiteralUtil::CreateR1<int32_t>(rhs));
+}
+
+TEST_F(HloEvaluatorTest, DoesAddWithDifferentLayouts) {
+  auto lhs = LiteralUtil::CreateR2WithLayout<int64_t>(
+      {{1, 0}, {-100, 4}}, LayoutUtil::MakeLayout({0, 1}));
+  auto rhs = LiteralUtil::CreateR2WithLayout<int64_t>(
+      {{2, 4}, {4, 4}}, LayoutUtil::MakeLayout({1, 0}));
+  auto expected = LiteralUtil::CreateR2<int64_t>({{3, 4}, {-96, 8}});
+  TestBinaryOp(HloOpcode::kAdd, std::move(expected), std::move(lhs),
+               std::move(rhs));
+}
+
 // Verifies that HloEvaluator evaluates a HLO instruction that performs
 // element-wise and with 2 operands.
 TEST_P(HloEvaluatorBf16Test, DoesAnd) {
@@ -1020,8 +1020,10 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return HandleDotSlowPath(dot);
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  std::is_same_v<NativeT, float>>* = nullptr>
+  template <typename NativeT,
+            typename std::enable_if_t<std::is_same_v<NativeT, float> ||
+                                      std::is_same_v<NativeT, double>>* =
+                nullptr>
   Status HandleDot(const HloInstruction* dot) {
     const HloInstruction* lhs = dot->operand(0);
     const HloInstruction* rhs = dot->operand(1);
@@ -1085,8 +1087,10 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return OkStatus();
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  !std::is_same_v<NativeT, float>>* = nullptr>
+  template <typename NativeT,
+            typename std::enable_if_t<!std::is_same_v<NativeT, float> &&
+                                      !std::is_same_v<NativeT, double>>* =
+                nullptr>
   Status HandleDot(const HloInstruction* dot) {
     return HandleDotSlowPath(dot);
   }
@@ -1620,14 +1624,24 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     const Literal& lhs_literal = parent_->GetEvaluatedLiteralFor(lhs);
     const Literal& rhs_literal = parent_->GetEvaluatedLiteralFor(rhs);
+    const std::function<ReturnT(ReturnT, ReturnT)> converted_op =
+        ConvertBinaryFunction(binary_op);
 
     Literal result(shape);
 
+    if (HloEvaluator::IsLinearElementwise(result.shape(),
+                                          {&lhs_literal, &rhs_literal})) {
+      absl::Span<const ReturnT> lhs_data = lhs_literal.data<ReturnT>();
+      absl::Span<const ReturnT> rhs_data = rhs_literal.data<ReturnT>();
+      HloEvaluator::PopulateLinear<ReturnT>(result, [&](int64_t i) {
+        return converted_op(lhs_data[i], rhs_data[i]);
+      });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
-          return ConvertBinaryFunction(binary_op)(
-              lhs_literal.Get<ReturnT>(multi_index),
-              rhs_literal.Get<ReturnT>(multi_index));
+          return converted_op(lhs_literal.Get<ReturnT>(multi_index),
+                              rhs_literal.Get<ReturnT>(multi_index));
         }));
     return std::move(result);
   }
@@ -1650,6 +1664,16 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    if (HloEvaluator::IsLinearElementwise(
+            result.shape(), {&lhs_literal, &rhs_literal, &ehs_literal})) {
+      absl::Span<const LhsType> lhs_data = lhs_literal.data<LhsType>();
+      absl::Span<const RhsType> rhs_data = rhs_literal.data<RhsType>();
+      absl::Span<const EhsType> ehs_data = ehs_literal.data<EhsType>();
+      HloEvaluator::PopulateLinear<ReturnT>(result, [&](int64_t i) {
+        return ternary_op(lhs_data[i], rhs_data[i], ehs_data[i]);
+      });
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return ternary_op(lhs_literal.Get<LhsType>(multi_index),
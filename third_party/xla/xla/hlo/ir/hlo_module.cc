@@ -120,6 +120,7 @@ HloModule::StackFrame HloModule::get_stack_frame(int id) const {
 HloComputation* HloModule::AddComputationInternal(
     std::unique_ptr<HloComputation> computation, bool is_entry,
     bool uniquify_identifiers, bool preserve_entry_layouts) {
+  absl::MutexLock lock(&identifiers_mutex_);
   if (is_entry) {
     CHECK_EQ(nullptr, entry_computation_);
     entry_computation_ = computation.get();
@@ -146,7 +147,7 @@ HloComputation* HloModule::AddComputationInternal(
 
     // Pick unique IDs for each instruction.
     for (auto* instruction : computation->instructions()) {
-      instruction->SetUniqueId(NewUniqueInstructionId());
+      instruction->SetUniqueId(next_unique_id_++);
     }
     // Set unique id to this computation.
     CHECK_NE(computation->root_instruction()->unique_id(), -1)
@@ -173,6 +174,12 @@ HloComputation* HloModule::AddComputationInternal(
   return computations_.back().get();
 }
 
+void HloModule::UniquifyInstruction(HloInstruction* instruction) {
+  absl::MutexLock lock(&identifiers_mutex_);
+  instruction->UniquifyName(&instruction_name_uniquer_);
+  instruction->SetUniqueId(next_unique_id_++);
+}
+
 HloComputation* HloModule::AddEntryComputation(
     std::unique_ptr<HloComputation> computation) {
   return AddComputationInternal(std::move(computation), /*is_entry=*/true,
@@ -30,6 +30,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/dynamic_parameter_binding.h"
 #include "xla/hlo/ir/hlo_clone_context.h"
@@ -492,11 +493,17 @@ class HloModule {
 
   // Assign a new unique dense id for an instruction
   int NewUniqueInstructionId() {
+    absl::MutexLock lock(&identifiers_mutex_);
     int result = next_unique_id_;
     next_unique_id_++;
     return result;
   }
 
+  // Gives "instruction" a name and an id which are unique in this module.
+  // Like adding embedded computations, this may be called concurrently by
+  // passes running on different computations of the module.
+  void UniquifyInstruction(HloInstruction* instruction);
+
   // input_output_alias_config indicates the list of aliased buffers that are
   // expected from the module.
   HloInputOutputAliasConfig& input_output_alias_config() {
@@ -542,6 +549,7 @@ class HloModule {
   }
 
   void SetAndUniquifyInstrName(HloInstruction* instr, absl::string_view name) {
+    absl::MutexLock lock(&identifiers_mutex_);
     instr->SetAndSanitizeName(name);
     instr->UniquifyName(&instruction_name_uniquer_);
   }
@@ -725,6 +733,10 @@ class HloModule {
   NameUniquer computation_name_uniquer_{/*separator=*/"."};
   NameUniquer instruction_name_uniquer_{/*separator=*/"."};
   int next_unique_id_ = 0;
+  // Guards the uniquers, next_unique_id_ and adding to computations_ when
+  // instructions and computations are added, so that passes can run on
+  // disjoint computations concurrently. Reading computations_ is not guarded.
+  absl::Mutex identifiers_mutex_;
 
   // Used to keep track of the next unique module id that should be assigned.
   static std::atomic<int> next_unique_module_id_;
@@ -38,7 +38,9 @@ limitations under the License.
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xla/client/local_client.h"
 #include "xla/client/xla_computation.h"
 #include "xla/pjrt/distributed/topology_util.h"
@@ -68,6 +70,7 @@ limitations under the License.
 #include "xla/pjrt/gpu/gpu_metrics.h"
 #include "xla/pjrt/gpu/nccl_id_store.h"
 #include "xla/pjrt/stream_executor_executable.pb.h"
+#include "xla/service/gpu/autotuner_util.h"
 #include "xla/service/gpu/gpu_compiler.h"
 #include "xla/xla.pb.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -443,41 +446,40 @@ StreamExecutorGpuClient::GetDefaultDeviceAssignment(int num_replicas,
                                                               num_partitions);
 }
 
-PjRtFuture<absl::Status> StreamExecutorGpuClient::CopyRawSubBufferToHost(
-    PjRtBuffer* pjrt_buffer, void* dst, int64_t offset, int64_t transfer_size) {
+namespace {
+
+// Enqueues a copy of `transfer_size` bytes at `offset` of `pjrt_buffer` to
+// `dst` on `stream`, after the buffer's definition events. The device memory
+// handle the copy reads from is appended to `sub_buffers`, which must be kept
+// alive until the copy has completed.
+absl::Status EnqueueRawCopyToHost(
+    PjRtBuffer* pjrt_buffer, void* dst, int64_t offset, int64_t transfer_size,
+    se::Stream* stream, tsl::thread::ThreadPool* thread_pool,
+    std::vector<std::unique_ptr<se::DeviceMemoryBase>>& sub_buffers) {
   auto* buffer = tensorflow::down_cast<PjRtStreamExecutorBuffer*>(pjrt_buffer);
   DCHECK(buffer);
-  PjRtStreamExecutorDevice* device = buffer->device();
-  LocalDeviceState* local_device = device->local_device_state();
-  // Always borrow a stream to avoid potential deadlocks enqueueing transfers
-  // that might be required in order to compute the inputs for computations
-  // that have already been enqueued. Such cycles can occur when there are
-  // cross-host data dependencies.
-  auto stream = local_device->BorrowStreamFromPool();
+  LocalDeviceState* local_device = buffer->device()->local_device_state();
 
   PjRtStreamExecutorBuffer::ScopedHold hold(buffer->GetBufferWithUsageHold());
   if (!hold.ok()) {
-    return PjRtFuture<absl::Status>(hold.status());
+    return hold.status();
   }
   auto device_buffer = hold.buffer();
   if (device_buffer->device_memory().size() != 1) {
-    return PjRtFuture<absl::Status>(
-        InvalidArgument("Copy raw buffer called on tuple"));
+    return InvalidArgument("Copy raw buffer called on tuple");
   }
   auto& device_memory = device_buffer->device_memory()[0];
   if (offset < 0 || offset > device_memory.size() ||
       device_memory.size() - offset < transfer_size) {
-    return PjRtFuture<absl::Status>(
-        InvalidArgument("Copy raw buffer called on buffer size %lld with "
-                        "invalid offset %lld, transfer size %lld",
-                        device_memory.size(), offset, transfer_size));
-  }
-  WaitForBufferDefinitionEventsOnStream(*device_buffer, stream.get());
-  absl::StatusOr<EventPool::Handle> event_or =
-      local_device->event_pool().AllocateEvent(stream->parent());
-  if (!event_or.ok()) {
-    return PjRtFuture<absl::Status>(event_or.status());
+    return InvalidArgument(
+        "Copy raw buffer called on buffer size %lld with "
+        "invalid offset %lld, transfer size %lld",
+        device_memory.size(), offset, transfer_size);
   }
+  WaitForBufferDefinitionEventsOnStream(*device_buffer, stream);
+  TF_ASSIGN_OR_RETURN(EventPool::Handle event,
+                      local_device->event_pool().AllocateEvent(
+                          stream->parent()));
 
   std::unique_ptr<se::DeviceMemoryBase> sub_buffer;
   if (transfer_size < device_memory.size()) {
@@ -492,44 +494,137 @@ PjRtFuture<absl::Status> StreamExecutorGpuClient::CopyRawSubBufferToHost(
     // that needs to outlive the transfer until the stream callback is invoked.
     stream->ThenMemcpy(dst, *sub_buffer, transfer_size);
   }
+  sub_buffers.push_back(std::move(sub_buffer));
 
-  auto usage_event =
-      std::make_shared<BufferSequencingEvent>(this->thread_pool());
-  local_device->event_pool().ThenRecordEvent(stream.get(), event_or.value());
-  usage_event->SetSequencingEvent(std::move(event_or).value(), stream.get());
+  auto usage_event = std::make_shared<BufferSequencingEvent>(thread_pool);
+  local_device->event_pool().ThenRecordEvent(stream, event);
+  usage_event->SetSequencingEvent(std::move(event), stream);
   // This usage hold will prevent device_buffer from being deleted before
   // the transfer is complete.
-  hold.ConvertUsageHold(stream.get(), std::move(usage_event),
+  hold.ConvertUsageHold(stream, std::move(usage_event),
                         /*reference_held=*/false);
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+PjRtFuture<absl::Status> StreamExecutorGpuClient::CopyRawSubBufferToHost(
+    PjRtBuffer* pjrt_buffer, void* dst, int64_t offset, int64_t transfer_size) {
+  return CopyRawBuffersToHost({RawCopyToHost{pjrt_buffer, dst, offset,
+                                             transfer_size}});
+}
+
+PjRtFuture<absl::Status> StreamExecutorGpuClient::CopyRawBuffersToHost(
+    absl::Span<const RawCopyToHost> copies) {
+  // Copies from the same device share one stream and one completion callback.
+  absl::flat_hash_map<LocalDeviceState*, std::vector<const RawCopyToHost*>>
+      copies_by_device;
+  std::vector<LocalDeviceState*> devices;
+  for (const RawCopyToHost& copy : copies) {
+    LocalDeviceState* local_device =
+        tensorflow::down_cast<PjRtStreamExecutorBuffer*>(copy.buffer)
+            ->device()
+            ->local_device_state();
+    auto [it, inserted] = copies_by_device.try_emplace(local_device);
+    if (inserted) {
+      devices.push_back(local_device);
+    }
+    it->second.push_back(&copy);
+  }
+  if (devices.empty()) {
+    return PjRtFuture<absl::Status>(absl::OkStatus());
+  }
 
   auto promise = PjRtFuture<absl::Status>::CreatePromise();
-  local_device->ThenExecuteCallback(
-      stream.get(), [promise, free_sub_range = sub_buffer.release(),
-                     free_stream = stream.release(), local_device]() mutable {
-        auto stream = std::unique_ptr<se::Stream>(free_stream);
-        auto sub_range = std::unique_ptr<se::DeviceMemoryBase>(free_sub_range);
-        local_device->ReturnStreamToPool(std::move(stream));
-        promise.Set(OkStatus());
-      });
+  struct State {
+    absl::Mutex mu;
+    int pending ABSL_GUARDED_BY(mu);
+    absl::Status status ABSL_GUARDED_BY(mu);
+  };
+  auto state = std::make_shared<State>();
+  {
+    absl::MutexLock lock(&state->mu);
+    state->pending = devices.size();
+  }
+  auto done = [state, promise](absl::Status status) mutable {
+    absl::MutexLock lock(&state->mu);
+    state->status.Update(status);
+    if (--state->pending == 0) {
+      promise.Set(state->status);
+    }
+  };
+
+  for (LocalDeviceState* local_device : devices) {
+    // Always borrow a stream to avoid potential deadlocks enqueueing transfers
+    // that might be required in order to compute the inputs for computations
+    // that have already been enqueued. Such cycles can occur when there are
+    // cross-host data dependencies.
+    auto stream = local_device->BorrowStreamFromPool();
+    std::vector<std::unique_ptr<se::DeviceMemoryBase>> sub_buffers;
+    absl::Status status;
+    for (const RawCopyToHost* copy : copies_by_device[local_device]) {
+      status.Update(EnqueueRawCopyToHost(copy->buffer, copy->dst, copy->offset,
+                                         copy->transfer_size, stream.get(),
+                                         this->thread_pool(), sub_buffers));
+    }
+    local_device->ThenExecuteCallback(
+        stream.get(), [done, status, free_stream = stream.release(),
+                       sub_buffers = std::make_shared<decltype(sub_buffers)>(
+                           std::move(sub_buffers)),
+                       local_device]() mutable {
+          auto stream = std::unique_ptr<se::Stream>(free_stream);
+          sub_buffers.reset();
+          local_device->ReturnStreamToPool(std::move(stream));
+          done(status);
+        });
+  }
 
   return PjRtFuture<Status>(
       std::move(promise),
       /*on_block_start=*/
       []() {
         tsl::profiler::TraceMeProducer traceme(
-            "StreamExecutorGpuClient::CopyRawSubBufferToHost");
-        VLOG(1) << "StreamExecutorGpuClient::CopyRawSubBufferToHost";
+            "StreamExecutorGpuClient::CopyRawBuffersToHost");
+        VLOG(1) << "StreamExecutorGpuClient::CopyRawBuffersToHost";
         return PjRtFutureHelpers::ProfilingKeys(
             {/*traceme_context_id =*/traceme.GetContextId()});
       },
       /*on_block_end=*/
       [](PjRtFutureHelpers::ProfilingKeys keys) {
         tsl::profiler::TraceMeConsumer traceme(
-            "StreamExecutorGpuClient::CopyRawSubBufferToHost",
+            "StreamExecutorGpuClient::CopyRawBuffersToHost",
             keys.traceme_context_id);
       });
 }
 
+absl::Status StreamExecutorGpuClient::DmaMap(void* data, size_t size) {
+  for (PjRtDevice* device : addressable_devices()) {
+    se::StreamExecutor* executor =
+        tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)
+            ->local_device_state()
+            ->executor();
+    if (!executor->HostMemoryRegister(data, size)) {
+      return Internal("Failed to register host memory %p of size %d with %s",
+                      data, size, device->DebugString());
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status StreamExecutorGpuClient::DmaUnmap(void* data) {
+  for (PjRtDevice* device : addressable_devices()) {
+    se::StreamExecutor* executor =
+        tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)
+            ->local_device_state()
+            ->executor();
+    if (!executor->HostMemoryUnregister(data)) {
+      return Internal("Failed to unregister host memory %p with %s", data,
+                      device->DebugString());
+    }
+  }
+  return absl::OkStatus();
+}
+
 StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
 StreamExecutorGpuClient::Compile(const XlaComputation& computation,
                                  CompileOptions options) {
@@ -838,6 +933,21 @@ Status BuildDistributedDevices(
   return OkStatus();
 }
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+// Lets the autotuners of all nodes share their results through the key-value
+// store when --xla_gpu_shard_autotuning is set.
+void SetAutotuneKeyValueStore(int node_id, int num_nodes,
+                              PjRtClient::KeyValueGetCallback kv_get,
+                              PjRtClient::KeyValuePutCallback kv_put) {
+  auto store = std::make_shared<gpu::AutotuneKeyValueStore>();
+  store->get = std::move(kv_get);
+  store->put = std::move(kv_put);
+  store->node_id = node_id;
+  store->num_nodes = num_nodes;
+  gpu::AutotunerUtil::SetKeyValueStore(std::move(store));
+}
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
 }  // namespace
 
 StreamExecutorGpuDevice::StreamExecutorGpuDevice(
@@ -975,6 +1085,13 @@ StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
   TF_RETURN_IF_ERROR(BuildDistributedDevices(
       pjrt_platform_name, std::move(local_device_states), options.node_id,
       options.num_nodes, &devices, gpu_run_options.get(), kv_get, kv_put));
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  // The mock callbacks above only live until this function returns.
+  if (options.num_nodes > 1 && !options.enable_mock_nccl) {
+    SetAutotuneKeyValueStore(options.node_id, options.num_nodes,
+                             options.kv_get, options.kv_put);
+  }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
   return std::unique_ptr<PjRtClient>(std::make_unique<StreamExecutorGpuClient>(
       pjrt_platform_name, xla_client, std::move(devices), options.node_id,
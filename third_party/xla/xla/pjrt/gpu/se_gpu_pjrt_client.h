@@ -191,6 +191,24 @@ class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
                                             int64_t offset,
                                             int64_t transfer_size) override;
 
+  struct RawCopyToHost {
+    PjRtBuffer* buffer;
+    void* dst;
+    int64_t offset;
+    int64_t transfer_size;
+  };
+
+  // Enqueues many raw copies to host at once. Copies from the same device
+  // share a single stream and completion callback, which keeps the overhead
+  // per copy low when fetching many small buffers. The returned future
+  // becomes ready once all copies have completed, with the first error if
+  // any. DMAs into memory registered with DmaMap run fully asynchronously.
+  PjRtFuture<Status> CopyRawBuffersToHost(
+      absl::Span<const RawCopyToHost> copies);
+
+  Status DmaMap(void* data, size_t size) override;
+  Status DmaUnmap(void* data) override;
+
   StatusOr<const xla::PjRtTopologyDescription*> GetTopologyDescription()
       const override {
     return &topology_;
@@ -34,6 +34,7 @@ limitations under the License.
 #include "absl/time/time.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
+#include "xla/pjrt/local_device_state.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/utils.h"
 #include "xla/service/hlo_parser.h"
@@ -41,6 +42,7 @@ limitations under the License.
 #include "xla/test.h"
 #include "xla/tests/literal_test_util.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/casts.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/status_matchers.h"
@@ -372,6 +374,29 @@ TEST(StreamExecutorGpuClientTest, FromHostAsync) {
         literals[i]->Relayout(src_literals[i].shape().layout()).data<float>());
   }
 }
+TEST(StreamExecutorGpuClientTest, ChunkedBufferFromHostBuffer) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetStreamExecutorGpuClient(GpuClientOptions()));
+  // Large enough to be transferred in several staging chunks, the last of
+  // which is partial.
+  std::vector<float> data(
+      (5 * LocalDeviceState::kHostStagingChunkBytes / 2) / sizeof(float));
+  std::iota(data.begin(), data.end(), 0.0f);
+  Shape shape = ShapeUtil::MakeShape(F32, {static_cast<int64_t>(data.size())});
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PjRtBuffer> buffer,
+      client->BufferFromHostBuffer(
+          data.data(), shape.element_type(), shape.dimensions(),
+          /*byte_strides=*/std::nullopt,
+          PjRtClient::HostBufferSemantics::kImmutableUntilTransferCompletes,
+          /*on_done_with_host_buffer=*/nullptr,
+          client->addressable_devices()[0]));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> literal,
+                          buffer->ToLiteralSync());
+  EXPECT_EQ(literal->data<float>(), absl::MakeConstSpan(data));
+}
+
 TEST(StreamExecutorGpuClientTest, CopyRawToHostFullBuffer) {
   TF_ASSERT_OK_AND_ASSIGN(auto client,
                           GetStreamExecutorGpuClient(GpuClientOptions()));
@@ -391,6 +416,31 @@ TEST(StreamExecutorGpuClientTest, CopyRawToHostFullBuffer) {
   free(dst);
 }
 
+TEST(StreamExecutorGpuClientTest, CopyRawBuffersToHostIntoDmaMappedMemory) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetStreamExecutorGpuClient(GpuClientOptions()));
+  std::vector<std::unique_ptr<PjRtBuffer>> buffers;
+  for (float value : {41.0f, 42.0f, 43.0f}) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        buffers.emplace_back(),
+        client->BufferFromHostLiteral(LiteralUtil::CreateR1<float>({value}),
+                                      client->addressable_devices()[0]));
+  }
+
+  std::vector<float> results(buffers.size());
+  TF_ASSERT_OK(client->DmaMap(results.data(), results.size() * sizeof(float)));
+  std::vector<StreamExecutorGpuClient::RawCopyToHost> copies;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    copies.push_back({buffers[i].get(), &results[i], /*offset=*/0,
+                      /*transfer_size=*/sizeof(float)});
+  }
+  auto* gpu_client =
+      tensorflow::down_cast<StreamExecutorGpuClient*>(client.get());
+  TF_EXPECT_OK(gpu_client->CopyRawBuffersToHost(copies).Await());
+  TF_EXPECT_OK(client->DmaUnmap(results.data()));
+  EXPECT_THAT(results, ElementsAre(41.0f, 42.0f, 43.0f));
+}
+
 TEST(StreamExecutorGpuClientTest, CopyRawToHostSubBuffer) {
   TF_ASSERT_OK_AND_ASSIGN(auto client,
                           GetStreamExecutorGpuClient(GpuClientOptions()));
@@ -108,6 +108,32 @@ LocalDeviceState::~LocalDeviceState() {
   if (!status.ok()) {
     LOG(ERROR) << "Error when closing device: " << status;
   }
+  absl::MutexLock lock(&host_staging_mu_);
+  for (void* chunk : host_staging_chunks_) {
+    executor_->HostMemoryDeallocate(chunk);
+  }
+}
+
+void* LocalDeviceState::AcquireHostStagingChunk() {
+  absl::MutexLock lock(&host_staging_mu_);
+  if (free_host_staging_chunks_.empty() &&
+      host_staging_chunks_.size() < kNumHostStagingChunks) {
+    void* chunk = executor_->HostMemoryAllocate(kHostStagingChunkBytes);
+    CHECK(chunk != nullptr) << "Failed to allocate host staging buffer";
+    host_staging_chunks_.push_back(chunk);
+    return chunk;
+  }
+  host_staging_mu_.Await(absl::Condition(
+      +[](std::vector<void*>* chunks) { return !chunks->empty(); },
+      &free_host_staging_chunks_));
+  void* chunk = free_host_staging_chunks_.back();
+  free_host_staging_chunks_.pop_back();
+  return chunk;
+}
+
+void LocalDeviceState::ReleaseHostStagingChunk(void* chunk) {
+  absl::MutexLock lock(&host_staging_mu_);
+  free_host_staging_chunks_.push_back(chunk);
 }
 
 Status LocalDeviceState::SynchronizeAllActivity() {
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_PJRT_LOCAL_DEVICE_STATE_H_
 #define XLA_PJRT_LOCAL_DEVICE_STATE_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -191,6 +192,19 @@ class LocalDeviceState {
 
   Semaphore& compute_semaphore() { return compute_semaphore_; }
 
+  // Host-to-device transfers larger than a chunk are split into chunks that
+  // go through a ring of reusable host staging buffers (pinned memory on GPU),
+  // so that staging chunk i+1 overlaps with the DMA of chunk i.
+  static constexpr int64_t kHostStagingChunkBytes = 16 << 20;
+  static constexpr int kNumHostStagingChunks = 4;
+
+  // Returns a staging buffer of kHostStagingChunkBytes, allocating it on first
+  // use. Blocks until a buffer is free if all of them are in use.
+  void* AcquireHostStagingChunk();
+  // Makes `chunk` available again. Must only be called once the transfer
+  // reading from it has completed, e.g. from ThenExecuteCallback.
+  void ReleaseHostStagingChunk(void* chunk);
+
   // Returns a fresh, PRNG-generated random seed for an XLA computation.
   int GetNewPrngSeed();
 
@@ -219,6 +233,11 @@ class LocalDeviceState {
   static constexpr int kNumDeviceToDeviceStreams = 4;
   static constexpr int kNumExternalReadyEventStreams = 4;
 
+  absl::Mutex host_staging_mu_;
+  std::vector<void*> host_staging_chunks_ ABSL_GUARDED_BY(host_staging_mu_);
+  std::vector<void*> free_host_staging_chunks_
+      ABSL_GUARDED_BY(host_staging_mu_);
+
   absl::Mutex mu_;
   int next_device_to_host_stream_ ABSL_GUARDED_BY(mu_) = 0;
   int next_device_to_device_stream_ ABSL_GUARDED_BY(mu_) = 0;
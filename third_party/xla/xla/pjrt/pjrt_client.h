@@ -879,6 +879,21 @@ class PjRtClient {
   // not guaranteed to be the physical/device address.
   virtual StatusOr<std::uintptr_t> UnsafeBufferPointer(PjRtBuffer* buffer);
 
+  // Registers `size` bytes of host memory at `data` with the devices of this
+  // client, so that transfers to and from it (e.g. PjRtBuffer::CopyRawToHost)
+  // can DMA directly into it without an intermediate host buffer. The memory
+  // must stay alive until it is unregistered with DmaUnmap.
+  virtual Status DmaMap(void* data, size_t size) {
+    return Unimplemented("DmaMap is not supported on platform: %s",
+                         platform_name());
+  }
+
+  // Unregisters host memory previously registered with DmaMap.
+  virtual Status DmaUnmap(void* data) {
+    return Unimplemented("DmaUnmap is not supported on platform: %s",
+                         platform_name());
+  }
+
   // Returns a vector of PjRtBuffers that can be used to receive
   // cross host transfers using `client` on `device'. Asynchronously calls
   // `notifier` once receive descriptors are ready to be communicated to the
@@ -872,12 +872,28 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
       py_buffer->GetBufferWithUsageHold());
   CHECK(device_buffer.ok());
 
+  // Large transfers that need no relayout are staged in chunks through the
+  // device's staging ring, overlapping the host copy of each chunk with the
+  // DMA of the previous one, instead of staging the whole buffer up front.
+  // This requires the device representation to be the plain host bytes.
+  const Shape& on_device_shape = py_buffer->on_device_shape();
+  const bool chunked_transfer =
+      !is_cpu_platform && should_stage_host_to_device_transfers() &&
+      host_buffer_semantics != HostBufferSemantics::kImmutableOnlyDuringCall &&
+      host_and_device_strides_equal &&
+      size > LocalDeviceState::kHostStagingChunkBytes &&
+      on_device_shape.IsArray() && !on_device_shape.is_dynamic() &&
+      on_device_shape.layout().tiles().empty() &&
+      on_device_shape.layout().element_size_in_bits() == 0 &&
+      transfer_manager->GetByteSizeRequirement(on_device_shape) == size;
+
   // If necessary, allocate a host-side buffer for staging host-to-device
   // transfers. On GPU this is a buffer in pinned memory.
   std::shared_ptr<void> staging_buffer;
-  if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
-      should_stage_host_to_device_transfers() ||
-      !host_and_device_strides_equal) {
+  if (!chunked_transfer &&
+      (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
+       should_stage_host_to_device_transfers() ||
+       !host_and_device_strides_equal)) {
     void* ptr = host_memory_allocator()->AllocateRaw(
         tsl::Allocator::kAllocatorAlignment, size);
     staging_buffer = std::shared_ptr<void>(
@@ -886,25 +902,40 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
         });
   }
 
+  // Transposes performed on the calling thread are split across the client's
+  // thread pool. Those performed on the thread pool itself are not, since
+  // waiting for other pool tasks from a pool thread could deadlock.
+  const bool transpose_on_calling_thread =
+      host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall;
   std::shared_ptr<TransposePlan> transpose;
   if (!host_and_device_strides_equal) {
     absl::InlinedVector<int64_t, 4> permutation(dims.size());
     absl::c_reverse_copy(device_shape.layout().minor_to_major(),
                          permutation.begin());
+    int num_threads = 1;
+    if (transpose_on_calling_thread) {
+      num_threads = TransposePlan::NumThreadsForSize(
+          size, thread_pool()->NumThreads());
+    }
     absl::MutexLock lock(&transpose_mu_);
     TF_ASSIGN_OR_RETURN(transpose,
                         transpose_cache_.GetOrCreate(
                             primitive_util::ByteWidth(type), dims, permutation,
-                            TransposePlan::Striding{*byte_strides}));
+                            TransposePlan::Striding{*byte_strides},
+                            TransposePlan::Tiling{},
+                            TransposePlan::Transformation::kNone, num_threads));
   }
 
   // Copy the buffer into a staging buffer before returning control to the
   // caller if the caller only guaranteed that the buffer is valid for the
   // duration of the call. Otherwise, we stage (if necessary) on a separate
   // thread.
-  if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall) {
+  if (transpose_on_calling_thread) {
     if (transpose) {
-      transpose->Execute(data, staging_buffer.get());
+      transpose->Execute(data, staging_buffer.get(),
+                         [this](std::function<void()> fn) {
+                           thread_pool()->Schedule(std::move(fn));
+                         });
     } else {
       std::memcpy(staging_buffer.get(), data, size);
     }
@@ -927,7 +958,8 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
        on_device_shape{py_buffer->on_device_shape()},
        staging_buffer{std::move(staging_buffer)},
        on_done_with_host_buffer{std::move(on_done_with_host_buffer)},
-       host_buffer_semantics, transpose{std::move(transpose)}]() {
+       host_buffer_semantics, transpose{std::move(transpose)},
+       chunked_transfer]() {
         PjRtStreamExecutorBuffer::ScopedHold device_buffer(
             movable_device_buffer);
         // This function uses TF_CHECK_OK and value() since we have no way
@@ -958,6 +990,25 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
               ShapeUtil::DeviceShapeToHostShape(on_device_shape));
           TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
               local_device->host_to_device_stream(), literal, buffer));
+        } else if (chunked_transfer) {
+          se::Stream* stream = local_device->host_to_device_stream();
+          se::DeviceMemoryBase device_memory = buffer.root_buffer();
+          for (int64_t offset = 0; offset < size;
+               offset += LocalDeviceState::kHostStagingChunkBytes) {
+            int64_t chunk_size = std::min(
+                LocalDeviceState::kHostStagingChunkBytes, size - offset);
+            // Blocks until the DMA of an earlier chunk has freed its buffer.
+            void* chunk = local_device->AcquireHostStagingChunk();
+            std::memcpy(chunk, static_cast<const char*>(data) + offset,
+                        chunk_size);
+            se::DeviceMemoryBase destination =
+                device_memory.GetByteSlice(offset, chunk_size);
+            stream->ThenMemcpy(&destination, chunk, chunk_size);
+            local_device->ThenExecuteCallback(stream, [local_device, chunk]() {
+              local_device->ReleaseHostStagingChunk(chunk);
+            });
+          }
+          CHECK(stream->ok()) << "Chunked host-to-device transfer failed";
         } else {
           BorrowingLiteral literal(
               reinterpret_cast<const char*>(data),
@@ -482,8 +482,9 @@ void TransposePlan::Execute(
       execute_by_type(nodes);
     }
   } else {
-    absl::BlockingCounter counter(nodes_.size());
-    for (absl::Span<Node const> nodes : nodes_) {
+    absl::BlockingCounter counter(nodes_.size() - 1);
+    for (size_t i = 1; i < nodes_.size(); ++i) {
+      absl::Span<Node const> nodes = nodes_[i];
       schedule_work([&, nodes]() {
         tsl::profiler::TraceMe traceme("Transpose::Execute",
                                        /*level=*/2);
@@ -491,6 +492,7 @@ void TransposePlan::Execute(
         counter.DecrementCount();
       });
     }
+    execute_by_type(nodes_[0]);
     counter.Wait();
   }
 }
@@ -501,6 +503,13 @@ void TransposePlan::Execute(
 TransposePlan::TransposePlan() = default;
 TransposePlan::~TransposePlan() = default;
 
+/*static*/ int TransposePlan::NumThreadsForSize(int64_t num_bytes,
+                                                int max_threads) {
+  int64_t num_threads = num_bytes / kMinBytesPerThread;
+  return static_cast<int>(
+      std::clamp<int64_t>(num_threads, 1, std::max(max_threads, 1)));
+}
+
 static void ComputeStrides(
     int64_t elem_size_in_bytes, absl::Span<const int64_t> dims,
     absl::Span<const int64_t> tiling,
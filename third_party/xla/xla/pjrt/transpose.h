@@ -97,9 +97,18 @@ class TransposePlan {
   TransposePlan();
   ~TransposePlan();
 
+  // Returns the number of threads worth requesting for a transpose of
+  // `num_bytes`, at most `max_threads`. Each thread gets at least
+  // kMinBytesPerThread, below which synchronization costs dominate.
+  static constexpr int64_t kMinBytesPerThread = 1 << 20;
+  static int NumThreadsForSize(int64_t num_bytes, int max_threads);
+
   // Executes the transposition.
   // `a` is the input array and `b` is the output array. The input and output
   // arrays must not overlap.
+  // If `schedule_work` is provided, all but one of the plan's chunks of work
+  // are passed to it and the remaining chunk runs on the calling thread, which
+  // then waits for the scheduled chunks to finish.
   // Currently there are no alignment requirements on either `a` or `b`. However
   // performance may be better if either or both are aligned.
   void Execute(const void* a, void* b,
@@ -468,6 +468,17 @@ static std::vector<TransposeTestCase> BenchmarkCases() {
                         /*permutation=*/{1, 2, 3, 0}),
       TransposeTestCase(/*dims=*/{256, 64, 64, 3},
                         /*permutation=*/{1, 3, 2, 0}),
+      // NHWC -> NCHW and NCHW -> NHWC activations.
+      TransposeTestCase(/*dims=*/{32, 224, 224, 3},
+                        /*permutation=*/{0, 3, 1, 2}),
+      TransposeTestCase(/*dims=*/{32, 3, 224, 224},
+                        /*permutation=*/{0, 2, 3, 1}),
+      TransposeTestCase(/*dims=*/{64, 56, 56, 64},
+                        /*permutation=*/{0, 3, 1, 2}),
+      TransposeTestCase(/*dims=*/{64, 64, 56, 56},
+                        /*permutation=*/{0, 2, 3, 1}),
+      TransposeTestCase(/*dims=*/{128, 14, 14, 256},
+                        /*permutation=*/{0, 3, 1, 2}),
   };
 }
 
@@ -519,6 +530,10 @@ static void BM_Transpose_uint8(const TransposeTestCase& bm, int parallelism,
                                ::testing::benchmark::State& state) {
   BM_Transpose<uint8_t>(bm, parallelism, state);
 }
+static void BM_Transpose_uint16(const TransposeTestCase& bm, int parallelism,
+                                ::testing::benchmark::State& state) {
+  BM_Transpose<uint16_t>(bm, parallelism, state);
+}
 static void BM_Transpose_float(const TransposeTestCase& bm, int parallelism,
                                ::testing::benchmark::State& state) {
   BM_Transpose<float>(bm, parallelism, state);
@@ -531,6 +546,7 @@ static void* benchmarks = []() {
       {
           {"BM_Eigen_uint8", BM_Eigen_uint8, {1}},
           {"BM_Transpose_uint8", BM_Transpose_uint8, {1, 4, 8}},  //
+          {"BM_Transpose_uint16", BM_Transpose_uint16, {1, 4, 8}},  //
           {"BM_Eigen_float", BM_Eigen_float, {1}},
           {"BM_Transpose_float", BM_Transpose_float, {1, 4, 8}},  //
   };
@@ -555,6 +571,15 @@ static void* benchmarks = []() {
   return nullptr;
 }();
 
+TEST(TransposeTest, NumThreadsForSize) {
+  constexpr int64_t kMin = TransposePlan::kMinBytesPerThread;
+  EXPECT_EQ(TransposePlan::NumThreadsForSize(0, 8), 1);
+  EXPECT_EQ(TransposePlan::NumThreadsForSize(kMin - 1, 8), 1);
+  EXPECT_EQ(TransposePlan::NumThreadsForSize(3 * kMin, 8), 3);
+  EXPECT_EQ(TransposePlan::NumThreadsForSize(100 * kMin, 8), 8);
+  EXPECT_EQ(TransposePlan::NumThreadsForSize(100 * kMin, 0), 1);
+}
+
 TEST(TransposePlanCache, Basics) {
   TransposePlanCache cache(2);
   TF_ASSERT_OK_AND_ASSIGN(
@@ -55,6 +55,7 @@ limitations under the License.
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_creation_utils.h"
 #include "xla/service/hlo_module_config.h"
+#include "xla/service/parallel_computation_runner.h"
 #include "xla/service/pattern_matcher.h"
 #include "xla/service/shape_inference.h"
 #include "xla/shape.h"
@@ -8554,6 +8555,16 @@ Status AlgebraicSimplifierVisitor::HandleMap(HloInstruction* map) {
 StatusOr<bool> AlgebraicSimplifier::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  if (thread_pool_ != nullptr) {
+    // The visitor keeps state across computations, so each computation gets
+    // its own.
+    return RunOnNonfusionComputations(
+        module, execution_threads, thread_pool_,
+        [this](HloComputation* comp) -> StatusOr<bool> {
+          AlgebraicSimplifierVisitor visitor(options_, this);
+          return visitor.Run(comp, options_, this);
+        });
+  }
   bool changed = false;
   AlgebraicSimplifierVisitor visitor(options_, this);
   for (auto* comp : module->MakeNonfusionComputations(execution_threads)) {
@@ -32,6 +32,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/util.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -273,9 +274,12 @@ class AlgebraicSimplifierOptions {
 class AlgebraicSimplifier : public HloModulePass {
  public:
   // If is_layout_sensitive is true, then the simplifier preserves layout during
-  // transformation. Otherwise, layout is ignored.
-  explicit AlgebraicSimplifier(const AlgebraicSimplifierOptions& options)
-      : options_(options) {}
+  // transformation. Otherwise, layout is ignored. If "thread_pool" is not
+  // null, computations which don't call each other are simplified
+  // concurrently.
+  explicit AlgebraicSimplifier(const AlgebraicSimplifierOptions& options,
+                               tsl::thread::ThreadPool* thread_pool = nullptr)
+      : options_(options), thread_pool_(thread_pool) {}
   ~AlgebraicSimplifier() override = default;
   absl::string_view name() const override { return "algsimp"; }
 
@@ -297,6 +301,7 @@ class AlgebraicSimplifier : public HloModulePass {
 
  protected:
   AlgebraicSimplifierOptions options_;
+  tsl::thread::ThreadPool* thread_pool_;
 };
 
 // AlgebraicSimplifierVisitor traverses the HLO computation and reduces certain
@@ -186,12 +186,14 @@ std::optional<GroupKey> CombineKey(const HloInstruction* instruction,
 
 }  // namespace
 
-AllGatherCombiner::AllGatherCombiner(int64_t combine_threshold_in_bytes,
-                                     int64_t combine_threshold_count,
-                                     bool combine_by_dim)
+AllGatherCombiner::AllGatherCombiner(
+    int64_t combine_threshold_in_bytes, int64_t combine_threshold_count,
+    bool combine_by_dim, CombineThresholdBytesFn combine_threshold_in_bytes_fn)
     : combine_threshold_in_bytes_(combine_threshold_in_bytes),
       combine_threshold_count_(combine_threshold_count),
-      combine_by_dim_(combine_by_dim) {}
+      combine_by_dim_(combine_by_dim),
+      combine_threshold_in_bytes_fn_(std::move(combine_threshold_in_bytes_fn)) {
+}
 
 StatusOr<bool> AllGatherCombiner::Run(
     HloModule* module,
@@ -211,6 +213,12 @@ StatusOr<bool> AllGatherCombiner::Run(
     return false;
   }
 
+  auto threshold_fn = [this](const HloInstruction* instruction) {
+    return combine_threshold_in_bytes_fn_
+               ? combine_threshold_in_bytes_fn_(instruction)
+               : combine_threshold_in_bytes_;
+  };
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -227,7 +235,7 @@ StatusOr<bool> AllGatherCombiner::Run(
     TF_ASSIGN_OR_RETURN(
         bool computation_changed,
         CombineInstructionsByKey<GroupKey>(computation, key_fn, combine_fn,
-                                           combine_threshold_in_bytes_,
+                                           threshold_fn,
                                            combine_threshold_count_));
     changed |= computation_changed;
   }
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/collective_combiner_utils.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/statusor.h"
 #include "xla/xla_data.pb.h"
@@ -30,8 +31,10 @@ namespace xla {
 // more efficient than many small ones.
 class AllGatherCombiner : public HloModulePass {
  public:
-  AllGatherCombiner(int64_t combine_threshold_in_bytes,
-                    int64_t combine_threshold_count, bool combine_by_dim);
+  AllGatherCombiner(
+      int64_t combine_threshold_in_bytes, int64_t combine_threshold_count,
+      bool combine_by_dim,
+      CombineThresholdBytesFn combine_threshold_in_bytes_fn = nullptr);
 
   absl::string_view name() const override { return "all-gather-combiner"; }
 
@@ -49,6 +52,10 @@ class AllGatherCombiner : public HloModulePass {
 
   // Combine only all-gather ops with the same gather dimension.
   bool combine_by_dim_;
+
+  // If set, overrides combine_threshold_in_bytes for each set of combined
+  // ops, given its first op.
+  CombineThresholdBytesFn combine_threshold_in_bytes_fn_;
 };
 
 }  // namespace xla
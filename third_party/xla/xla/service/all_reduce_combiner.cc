@@ -103,10 +103,13 @@ Status CombineAllReduces(absl::Span<HloInstruction* const> to_combine) {
 }
 }  // namespace
 
-AllReduceCombiner::AllReduceCombiner(int64_t combine_threshold_in_bytes,
-                                     int64_t combine_threshold_count)
+AllReduceCombiner::AllReduceCombiner(
+    int64_t combine_threshold_in_bytes, int64_t combine_threshold_count,
+    CombineThresholdBytesFn combine_threshold_in_bytes_fn)
     : combine_threshold_in_bytes_(combine_threshold_in_bytes),
-      combine_threshold_count_(combine_threshold_count) {}
+      combine_threshold_count_(combine_threshold_count),
+      combine_threshold_in_bytes_fn_(std::move(combine_threshold_in_bytes_fn)) {
+}
 
 StatusOr<bool> AllReduceCombiner::Run(
     HloModule* module,
@@ -125,6 +128,12 @@ StatusOr<bool> AllReduceCombiner::Run(
     return false;
   }
 
+  auto threshold_fn = [this](const HloInstruction* instruction) {
+    return combine_threshold_in_bytes_fn_
+               ? combine_threshold_in_bytes_fn_(instruction)
+               : combine_threshold_in_bytes_;
+  };
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -142,8 +151,8 @@ StatusOr<bool> AllReduceCombiner::Run(
     TF_ASSIGN_OR_RETURN(
         bool computation_changed,
         CombineInstructionsByKey<AllReduceKey>(
-            computation, key_fn, &CombineAllReduces,
-            combine_threshold_in_bytes_, combine_threshold_count_));
+            computation, key_fn, &CombineAllReduces, threshold_fn,
+            combine_threshold_count_));
     changed |= computation_changed;
   }
 
@@ -19,6 +19,7 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "xla/array2d.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/collective_combiner_utils.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/statusor.h"
 #include "xla/xla_data.pb.h"
@@ -31,8 +32,9 @@ namespace xla {
 // more efficient than many small ones.
 class AllReduceCombiner : public HloModulePass {
  public:
-  AllReduceCombiner(int64_t combine_threshold_in_bytes,
-                    int64_t combine_threshold_count);
+  AllReduceCombiner(
+      int64_t combine_threshold_in_bytes, int64_t combine_threshold_count,
+      CombineThresholdBytesFn combine_threshold_in_bytes_fn = nullptr);
 
   absl::string_view name() const override { return "all-reduce-combiner"; }
 
@@ -47,6 +49,10 @@ class AllReduceCombiner : public HloModulePass {
 
   // Combine all reduce ops up to this threshold (number of operands).
   int64_t combine_threshold_count_;
+
+  // If set, overrides combine_threshold_in_bytes for each set of combined
+  // ops, given its first op.
+  CombineThresholdBytesFn combine_threshold_in_bytes_fn_;
 };
 
 }  // namespace xla
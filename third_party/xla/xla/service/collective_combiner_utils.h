@@ -35,19 +35,27 @@ limitations under the License.
 
 namespace xla {
 
+// Returns the output byte size up to which the given collective may be
+// combined with others of the same key, e.g. depending on the interconnect its
+// replica groups communicate over.
+using CombineThresholdBytesFn = std::function<int64_t(const HloInstruction*)>;
+
 // Combines instructions with matching keys together.
 //
 // Instructions are combined in topological post-order.
 //
 // `key_fn` should return equal keys for two instructions that might be combined
 // together. Instructions will be combined until the threshold for output byte
-// size or instruction count is reached.
+// size or instruction count is reached. The byte threshold of a combined set is
+// `combine_threshold_bytes_fn` of its first instruction.
 template <typename K>
 StatusOr<bool> CombineInstructionsByKey(
     HloComputation* computation,
     absl::FunctionRef<std::optional<K>(const HloInstruction*)> key_fn,
     absl::FunctionRef<Status(absl::Span<HloInstruction* const>)> combine_fn,
-    int64_t combine_threshold_bytes, int64_t combine_threshold_count) {
+    absl::FunctionRef<int64_t(const HloInstruction*)>
+        combine_threshold_bytes_fn,
+    int64_t combine_threshold_count) {
   // Cache keys for each instruction and build sets of instructions with the
   // same key that might be combined together.
   absl::flat_hash_map<HloInstruction*, K> keys;
@@ -67,6 +75,7 @@ StatusOr<bool> CombineInstructionsByKey(
   while (!keys.empty()) {
     std::vector<HloInstruction*> to_combine;
     int64_t to_combine_bytes = 0;
+    int64_t combine_threshold_bytes = 0;
     absl::flat_hash_set<HloInstruction*>* group = nullptr;
 
     // Recompute reachability after every combine group because we can't
@@ -83,6 +92,7 @@ StatusOr<bool> CombineInstructionsByKey(
       // If this is the first instruction, set the active group.
       if (to_combine.empty()) {
         group = &groups.find(it->second)->second;
+        combine_threshold_bytes = combine_threshold_bytes_fn(instruction);
       }
 
       // Check instruction is in the active group.
@@ -141,6 +151,11 @@ StatusOr<bool> CombineInstructionsByKey(
     }
 
     if (to_combine.size() > 1) {
+      VLOG(1) << "Combining " << to_combine.size() << " "
+              << HloOpcodeString(to_combine.front()->opcode()) << " ops of "
+              << to_combine_bytes << " bytes (threshold "
+              << combine_threshold_bytes << " bytes) with replica groups "
+              << ReplicaGroupsToString(to_combine.front()->replica_groups());
       TF_RETURN_IF_ERROR(combine_fn(to_combine));
       changed = true;
     }
@@ -149,6 +164,18 @@ StatusOr<bool> CombineInstructionsByKey(
   return changed;
 }
 
+template <typename K>
+StatusOr<bool> CombineInstructionsByKey(
+    HloComputation* computation,
+    absl::FunctionRef<std::optional<K>(const HloInstruction*)> key_fn,
+    absl::FunctionRef<Status(absl::Span<HloInstruction* const>)> combine_fn,
+    int64_t combine_threshold_bytes, int64_t combine_threshold_count) {
+  return CombineInstructionsByKey<K>(
+      computation, key_fn, combine_fn,
+      [&](const HloInstruction*) { return combine_threshold_bytes; },
+      combine_threshold_count);
+}
+
 }  // namespace xla
 
 #endif  // XLA_SERVICE_COLLECTIVE_COMBINER_UTILS_H_
@@ -22,6 +22,9 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
@@ -42,7 +45,10 @@ limitations under the License.
 #include "xla/statusor.h"
 #include "xla/types.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
 
 namespace xla {
 namespace cpu {
@@ -97,6 +103,25 @@ static std::vector<llvm::VecDesc> VectorFunctionsForTargetLibraryInfoImpl() {
   return result;
 }
 
+std::string CompilerFunctor::ObjectCacheKey(const llvm::Module& module) const {
+  std::string fast_math_flags;
+  llvm::raw_string_ostream fast_math_flags_stream(fast_math_flags);
+  fast_math_flags_.print(fast_math_flags_stream);
+  fast_math_flags_stream.flush();
+
+  std::string key = absl::StrCat(
+      llvm_ir::DumpToString(&module), "\n",
+      target_machine_->getTargetTriple().str(), "\n",
+      target_machine_->getTargetCPU().str(), "\n",
+      target_machine_->getTargetFeatureString().str(), "\n", opt_level_,
+      optimize_for_size_, disable_expensive_passes_, disable_slp_vectorizer_,
+      dfsan_enabled_, "\n", fast_math_flags, "\n",
+      absl::StrJoin(dfsan_abi_list_files_, ","), "\n",
+      absl::StrJoin(convert_to_xla_runtime_abi_, ","));
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(key);
+  return absl::StrFormat("%016x%016x.o", fingerprint.high64, fingerprint.low64);
+}
+
 llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
     llvm::Module& module) {
   VLOG(2) << "IR before optimizations";
@@ -106,6 +131,35 @@ llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
     pre_optimization_hook_(module);
   }
 
+  auto run_post_codegen_hook = [&](const llvm::MemoryBuffer& memory_buffer) {
+    if (!post_codegen_hook_) {
+      return;
+    }
+    llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> obj_file =
+        llvm::object::ObjectFile::createObjectFile(memory_buffer);
+    if (obj_file) {
+      post_codegen_hook_(*obj_file.get());
+    } else {
+      LOG(WARNING) << "Could convert memory buffer to object file!";
+    }
+  };
+
+  tsl::Env* env = tsl::Env::Default();
+  std::string cache_path;
+  if (!object_cache_dir_.empty()) {
+    cache_path = tsl::io::JoinPath(object_cache_dir_, ObjectCacheKey(module));
+    std::string object;
+    if (env->FileExists(cache_path).ok() &&
+        tsl::ReadFileToString(env, cache_path, &object).ok()) {
+      VLOG(1) << "Loaded object file for " << module.getName().str()
+              << " from cache: " << cache_path;
+      std::unique_ptr<llvm::MemoryBuffer> memory_buffer =
+          llvm::MemoryBuffer::getMemBufferCopy(object, cache_path);
+      run_post_codegen_hook(*memory_buffer);
+      return std::move(memory_buffer);
+    }
+  }
+
   llvm::OptimizationLevel opt_level;
   if (optimize_for_size_) {
     opt_level = llvm::OptimizationLevel::Os;
@@ -211,16 +265,29 @@ llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
   std::unique_ptr<llvm::MemoryBuffer> memory_buffer(
       new llvm::SmallVectorMemoryBuffer(std::move(stream_buffer)));
 
-  if (post_codegen_hook_) {
-    llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> obj_file =
-        llvm::object::ObjectFile::createObjectFile(*memory_buffer);
-    if (obj_file) {
-      post_codegen_hook_(*obj_file.get());
-    } else {
-      LOG(WARNING) << "Could convert memory buffer to object file!";
+  if (!cache_path.empty()) {
+    // Write to a unique temporary file first, so that concurrent compilations
+    // never observe a partially written object file.
+    std::string tmp_path = cache_path;
+    absl::Status status = env->RecursivelyCreateDir(object_cache_dir_);
+    if (status.ok() && !env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+      status = absl::InternalError("Failed to create a temporary file name");
+    }
+    if (status.ok()) {
+      status = tsl::WriteStringToFile(env, tmp_path,
+                                      memory_buffer->getBuffer().str());
+    }
+    if (status.ok()) {
+      status = env->RenameFile(tmp_path, cache_path);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to write object file to cache " << cache_path
+                   << ": " << status;
     }
   }
 
+  run_post_codegen_hook(*memory_buffer);
+
   return std::move(memory_buffer);
 }
 
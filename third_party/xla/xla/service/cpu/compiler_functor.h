@@ -47,7 +47,8 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
           nullptr,
       bool dfsan_enabled = false,
       const std::vector<std::string>& dfsan_abi_list_files = {},
-      const std::vector<std::string>& convert_to_xla_runtime_abi = {})
+      const std::vector<std::string>& convert_to_xla_runtime_abi = {},
+      std::string object_cache_dir = "")
       : IRCompiler(llvm::orc::IRSymbolMapper::ManglingOptions()),
         target_machine_(target_machine),
         opt_level_(opt_level),
@@ -60,13 +61,18 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
         post_codegen_hook_(std::move(post_codegen_hook)),
         dfsan_enabled_(dfsan_enabled),
         dfsan_abi_list_files_(dfsan_abi_list_files),
-        convert_to_xla_runtime_abi_(convert_to_xla_runtime_abi) {}
+        convert_to_xla_runtime_abi_(convert_to_xla_runtime_abi),
+        object_cache_dir_(std::move(object_cache_dir)) {}
 
   // Compile a Module to an ObjectFile.
   llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(
       llvm::Module& module) override;
 
  private:
+  // Returns the name of the object file for `module` in the object cache. It
+  // covers the unoptimized IR and every option that affects code generation.
+  std::string ObjectCacheKey(const llvm::Module& module) const;
+
   llvm::TargetMachine* target_machine_;
   const unsigned opt_level_;
   const bool optimize_for_size_;
@@ -79,6 +85,9 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
   const bool dfsan_enabled_ = false;
   const std::vector<std::string> dfsan_abi_list_files_;
   const std::vector<std::string> convert_to_xla_runtime_abi_;
+  // If not empty, compiled object files are stored in and loaded from this
+  // directory, so that recompiling the same module skips LLVM entirely.
+  const std::string object_cache_dir_;
 };
 
 }  // namespace cpu
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/cpu/cpu_compiler.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -143,6 +144,7 @@ limitations under the License.
 #include "xla/service/cpu/dot_op_emitter.h"
 #include "xla/service/cpu/hlo_xla_runtime_pipeline.h"
 #include "xla/service/cpu/ir_emitter.h"
+#include "xla/service/cpu/op_concurrency_analysis.h"
 #include "xla/service/cpu/parallel_task_assignment.h"
 #include "xla/service/cpu/runtime/collectives.h"
 #include "xla/service/cpu/runtime/convolution_call.h"
@@ -941,8 +943,15 @@ Status CpuCompiler::RunHloPassesAfterLayoutAssn(
     // and thread synchronization dependencies which would likely increase
     // binary size (and most AOT applications are single-threaded).
     // TODO(b/29630486) Support multi-threaded AOT.
-    pipeline.AddPass<ParallelTaskAssigner>(
-        max_parallelism, ShapeSizeBytesFunction(), target_machine_features);
+    // Partitions are claimed dynamically at runtime, so splitting ops into
+    // more partitions than threads lets idle threads pick up the work of busy
+    // ones.
+    const int tasks_per_thread = std::max<int>(
+        1,
+        module->config().debug_options().xla_cpu_parallel_tasks_per_thread());
+    pipeline.AddPass<ParallelTaskAssigner>(max_parallelism * tasks_per_thread,
+                                           ShapeSizeBytesFunction(),
+                                           target_machine_features);
   }
   // Copy insertion should be performed immediately before IR emission to
   // avoid inserting unnecessary copies (later pass adds an instruction which
@@ -964,8 +973,18 @@ Status CpuCompiler::RunHloPasses(HloModule* module, bool is_aot_compile,
   TF_RETURN_IF_ERROR(RunHloPassesThroughLayoutAssn(
       module, is_aot_compile, &target_machine_features, is_mlir_compile));
 
-  return RunHloPassesAfterLayoutAssn(module, is_aot_compile,
-                                     &target_machine_features, is_mlir_compile);
+  TF_RETURN_IF_ERROR(RunHloPassesAfterLayoutAssn(
+      module, is_aot_compile, &target_machine_features, is_mlir_compile));
+  // The entry computation is emitted as a single function that runs its ops
+  // one after the other. Report how much running independent ops
+  // concurrently could gain.
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << "Op concurrency of " << module->name() << ": "
+            << EstimateOpConcurrency(module->entry_computation(),
+                                     ShapeSizeBytesFunction())
+                   .ToString();
+  }
+  return OkStatus();
 }
 
 namespace {
@@ -1365,7 +1384,8 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
       options::SlpVectorizerDisabled(module->config()),
       llvm_ir::GetCpuFastMathFlags(module->config()), pre_optimization_ir_hook,
       post_optimization_ir_hook,
-      OrcJITPostCompilationHook::Create(module.get()));
+      OrcJITPostCompilationHook::Create(module.get()),
+      module->config().debug_options().xla_cpu_object_cache_dir());
   if (!jit) {
     return InternalError("Creating JIT failed: %s",
                          llvm::toString(jit.takeError()));
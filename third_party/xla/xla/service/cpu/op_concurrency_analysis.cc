@@ -0,0 +1,103 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/op_concurrency_analysis.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_format.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/hlo_cost_analysis.h"
+
+namespace xla {
+namespace cpu {
+
+std::string OpConcurrencyEstimate::ToString() const {
+  return absl::StrFormat(
+      "total cost: %.0f, critical path cost: %.0f, max width: %d, "
+      "parallelism: %.2f",
+      total_cost, critical_path_cost, max_width, parallelism());
+}
+
+OpConcurrencyEstimate EstimateOpConcurrency(
+    const HloComputation* computation,
+    const HloCostAnalysis::ShapeSizeFunction& shape_size) {
+  HloCostAnalysis cost_analysis(shape_size);
+  const bool has_cost_analysis =
+      computation->root_instruction()->Accept(&cost_analysis).ok();
+
+  auto cost = [&](const HloInstruction* instr) -> double {
+    switch (instr->opcode()) {
+      case HloOpcode::kParameter:
+      case HloOpcode::kConstant:
+      case HloOpcode::kTuple:
+      case HloOpcode::kGetTupleElement:
+      case HloOpcode::kBitcast:
+      case HloOpcode::kAfterAll:
+      case HloOpcode::kAddDependency:
+        return 0;
+      default:
+        break;
+    }
+    if (has_cost_analysis) {
+      return 1 * cost_analysis.flop_count(*instr) +
+             2 * cost_analysis.transcendental_count(*instr) +
+             10 * cost_analysis.bytes_accessed(*instr);
+    }
+    return shape_size(instr->shape());
+  };
+
+  OpConcurrencyEstimate estimate;
+  // Cost of the most expensive chain ending at each instruction, and its
+  // number of non-trivial ops.
+  absl::flat_hash_map<const HloInstruction*, double> finish_cost;
+  absl::flat_hash_map<const HloInstruction*, int64_t> depth;
+  absl::flat_hash_map<int64_t, int64_t> width_at_depth;
+  for (const HloInstruction* instr : computation->MakeInstructionPostOrder()) {
+    double start_cost = 0;
+    int64_t start_depth = 0;
+    auto add_predecessor = [&](const HloInstruction* pred) {
+      start_cost = std::max(start_cost, finish_cost[pred]);
+      start_depth = std::max(start_depth, depth[pred]);
+    };
+    for (const HloInstruction* operand : instr->operands()) {
+      add_predecessor(operand);
+    }
+    for (const HloInstruction* pred : instr->control_predecessors()) {
+      add_predecessor(pred);
+    }
+
+    const double instr_cost = cost(instr);
+    finish_cost[instr] = start_cost + instr_cost;
+    depth[instr] = start_depth;
+    if (instr_cost > 0) {
+      depth[instr] = start_depth + 1;
+      estimate.max_width =
+          std::max(estimate.max_width, ++width_at_depth[start_depth + 1]);
+    }
+    estimate.total_cost += instr_cost;
+    estimate.critical_path_cost =
+        std::max(estimate.critical_path_cost, finish_cost[instr]);
+  }
+  return estimate;
+}
+
+}  // namespace cpu
+}  // namespace xla
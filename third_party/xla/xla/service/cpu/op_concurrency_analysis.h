@@ -0,0 +1,58 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_OP_CONCURRENCY_ANALYSIS_H_
+#define XLA_SERVICE_CPU_OP_CONCURRENCY_ANALYSIS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/service/hlo_cost_analysis.h"
+
+namespace xla {
+namespace cpu {
+
+// Estimates how much faster a computation would run if its independent
+// top-level ops were executed concurrently instead of one after the other, as
+// the single JIT-compiled function of CpuExecutable does.
+struct OpConcurrencyEstimate {
+  // Sum of the costs of all ops, i.e. the cost of sequential execution.
+  double total_cost = 0;
+  // Cost of the most expensive chain of dependent ops. No execution order can
+  // finish faster than this.
+  double critical_path_cost = 0;
+  // Largest number of non-trivial ops at the same dependency depth.
+  int64_t max_width = 0;
+
+  // Upper bound on the speedup from running independent ops concurrently.
+  double parallelism() const {
+    return critical_path_cost > 0 ? total_cost / critical_path_cost : 1.0;
+  }
+
+  std::string ToString() const;
+};
+
+// Costs are estimated like in ParallelTaskAssignment: from HloCostAnalysis,
+// falling back to the output size for ops it cannot analyze. Ops that don't
+// do any work (parameters, tuples, bitcasts, ...) cost nothing.
+OpConcurrencyEstimate EstimateOpConcurrency(
+    const HloComputation* computation,
+    const HloCostAnalysis::ShapeSizeFunction& shape_size);
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_CPU_OP_CONCURRENCY_ANALYSIS_H_
@@ -0,0 +1,72 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/op_concurrency_analysis.h"
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "xla/service/cpu/cpu_executable.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+using OpConcurrencyAnalysisTest = HloTestBase;
+
+TEST_F(OpConcurrencyAnalysisTest, IndependentOpsCanRunConcurrently) {
+  constexpr absl::string_view kHloString = R"(
+    HloModule wide
+    ENTRY e {
+      p0 = f32[1024] parameter(0)
+      p1 = f32[1024] parameter(1)
+      p2 = f32[1024] parameter(2)
+      p3 = f32[1024] parameter(3)
+      e0 = f32[1024] exponential(p0)
+      e1 = f32[1024] exponential(p1)
+      e2 = f32[1024] exponential(p2)
+      e3 = f32[1024] exponential(p3)
+      ROOT t = (f32[1024], f32[1024], f32[1024], f32[1024]) tuple(e0, e1, e2, e3)
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  OpConcurrencyEstimate estimate = EstimateOpConcurrency(
+      module->entry_computation(), CpuExecutable::ShapeSizeBytes);
+  EXPECT_EQ(estimate.max_width, 4);
+  EXPECT_DOUBLE_EQ(estimate.parallelism(), 4.0);
+}
+
+TEST_F(OpConcurrencyAnalysisTest, DependentOpsRunSequentially) {
+  constexpr absl::string_view kHloString = R"(
+    HloModule chain
+    ENTRY e {
+      p0 = f32[1024] parameter(0)
+      e0 = f32[1024] exponential(p0)
+      e1 = f32[1024] exponential(e0)
+      e2 = f32[1024] exponential(e1)
+      ROOT e3 = f32[1024] exponential(e2)
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  OpConcurrencyEstimate estimate = EstimateOpConcurrency(
+      module->entry_computation(), CpuExecutable::ShapeSizeBytes);
+  EXPECT_EQ(estimate.max_width, 1);
+  EXPECT_DOUBLE_EQ(estimate.parallelism(), 1.0);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
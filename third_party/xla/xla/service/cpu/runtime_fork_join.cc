@@ -17,6 +17,11 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
 #include "absl/base/dynamic_annotations.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -29,8 +34,12 @@ limitations under the License.
 using ComputeFunctionType = void (*)(void*, const void*, const void**, void**,
                                      void*, int64_t*, uint64_t*);
 
-// Dispatches 'num_partitions - 1' calls to 'function_ptr' in parallel.
-// Calls 'function_ptr' for first partition inline.
+// Calls 'function_ptr' once for each of the 'num_partitions' partitions.
+// Partitions are handed out dynamically: up to one worker per thread of the
+// intra-op pool, plus the calling thread, repeatedly claim the next unclaimed
+// partition until none are left. When some threads are busy with other work,
+// the others pick up more partitions instead of waiting for a straggler, so
+// emitting more partitions than threads balances load at runtime.
 // Uses blocking counter to synchronize threads after parallel calls complete.
 //
 // The 'partitions' array has a total number of elements equal to
@@ -82,24 +91,29 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ParallelForkJoin(
 
   std::vector<XlaCustomCallStatus> statuses(num_partitions);
 
-  // Dispatch 'num_partitions - 1' compute functions to run in parallel.
-  tsl::BlockingCounter bc(num_partitions - 1);
-  for (int32_t i = 1; i < num_partitions; ++i) {
-    const int64_t offset = i * stride;
+  // Runs partitions until all of them have been claimed.
+  std::atomic<int32_t> next_partition(0);
+  auto run_partitions = [&]() {
+    for (int32_t i = next_partition.fetch_add(1); i < num_partitions;
+         i = next_partition.fetch_add(1)) {
+      function(result_ptr, run_options_ptr, nullptr, buffer_table,
+               &statuses[i], &partitions[i * stride], prof_counters);
+      VLOG(3) << "ParallelForkJoin partition " << i << " done.";
+    }
+  };
+
+  // Dispatch workers to the pool, and run partitions on this thread as well.
+  const int32_t num_workers = std::min<int32_t>(
+      num_partitions - 1, run_options->intra_op_thread_pool()->numThreads());
+  tsl::BlockingCounter bc(num_workers);
+  for (int32_t i = 0; i < num_workers; ++i) {
     run_options->intra_op_thread_pool()->enqueueNoNotification(
-        [i, function, result_ptr, run_options_ptr, buffer_table, prof_counters,
-         partitions, offset, &bc, &statuses]() {
-          function(result_ptr, run_options_ptr, nullptr, buffer_table,
-                   &statuses[i], &partitions[offset], prof_counters);
+        [&run_partitions, &bc]() {
+          run_partitions();
           bc.DecrementCount();
-          VLOG(3) << "ParallelForkJoin partition " << i << " done.";
         });
   }
-
-  // Call first compute function inline.
-  function(result_ptr, run_options_ptr, params, buffer_table, &statuses[0],
-           &partitions[0], prof_counters);
-  VLOG(3) << "ParallelForkJoin partition 0 done.";
+  run_partitions();
   bc.Wait();
 
   // Collect all error messages (if any).
@@ -52,7 +52,8 @@ class SimpleOrcJIT : public llvm::JITEventListener {
   //
   // {pre,post}_optimization_hook is invoked on the module before/after all
   // LLVM IR-level optimizations.  post_codegen_hook is invoked after
-  // compiling to machine code.
+  // compiling to machine code.  If object_cache_dir is not empty, compiled
+  // object files are cached there across processes.
   SimpleOrcJIT(
       std::unique_ptr<llvm::orc::ExecutorProcessControl> target_process_control,
       std::unique_ptr<llvm::orc::ExecutionSession> execution_session,
@@ -62,7 +63,8 @@ class SimpleOrcJIT : public llvm::JITEventListener {
       llvm::FastMathFlags fast_math_flags,
       LLVMCompiler::ModuleHook pre_optimization_hook,
       LLVMCompiler::ModuleHook post_optimization_hook,
-      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook);
+      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+      std::string object_cache_dir = "");
 
   static llvm::Expected<std::unique_ptr<SimpleOrcJIT>> Create(
       const llvm::TargetOptions& target_options,
@@ -71,7 +73,8 @@ class SimpleOrcJIT : public llvm::JITEventListener {
       llvm::FastMathFlags fast_math_flags,
       LLVMCompiler::ModuleHook pre_optimization_hook,
       LLVMCompiler::ModuleHook post_optimization_hook,
-      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook);
+      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+      std::string object_cache_dir = "");
 
   ~SimpleOrcJIT() override;
 
@@ -21,9 +21,12 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
 #include "xla/service/graphcycles/graphcycles.h"
 #include "xla/service/shape_inference.h"
+#include "xla/shape_util.h"
 
 namespace xla {
 namespace {
@@ -371,6 +374,208 @@ StatusOr<bool> MergeDots(HloComputation* comp, int64_t max_size_to_merge) {
   return !dead_instrs.empty();
 }
 
+// Returns true if `a` and `b` compute the same kind of product on operands of
+// the same shapes, so that they can be stacked into one batched dot.
+bool CanBatchTogether(const HloInstruction* a, const HloInstruction* b) {
+  const DotDimensionNumbers& dnums_a = a->dot_dimension_numbers();
+  const DotDimensionNumbers& dnums_b = b->dot_dimension_numbers();
+  return ShapeUtil::Equal(a->shape(), b->shape()) &&
+         ShapeUtil::Equal(a->operand(0)->shape(), b->operand(0)->shape()) &&
+         ShapeUtil::Equal(a->operand(1)->shape(), b->operand(1)->shape()) &&
+         absl::c_equal(dnums_a.lhs_batch_dimensions(),
+                       dnums_b.lhs_batch_dimensions()) &&
+         absl::c_equal(dnums_a.rhs_batch_dimensions(),
+                       dnums_b.rhs_batch_dimensions()) &&
+         absl::c_equal(dnums_a.lhs_contracting_dimensions(),
+                       dnums_b.lhs_contracting_dimensions()) &&
+         absl::c_equal(dnums_a.rhs_contracting_dimensions(),
+                       dnums_b.rhs_contracting_dimensions()) &&
+         absl::c_equal(a->precision_config().operand_precision(),
+                       b->precision_config().operand_precision());
+}
+
+// Stacks independent dots that satisfy CanBatchTogether into one dot with an
+// extra leading batch dimension.  Example:
+//
+//   dot0 = f32[32,16] dot(f32[32,64] a0, f32[64,16] b0),
+//     lhs_contracting_dims={1}, rhs_contracting_dims={0}
+//   dot1 = f32[32,16] dot(f32[32,64] a1, f32[64,16] b1),
+//     lhs_contracting_dims={1}, rhs_contracting_dims={0}
+//
+// becomes
+//
+//   lhs = f32[2,32,64] concat(reshape(a0), reshape(a1)), dimensions={0}
+//   rhs = f32[2,64,16] concat(reshape(b0), reshape(b1)), dimensions={0}
+//   dot = f32[2,32,16] dot(lhs, rhs), lhs_batch_dims={0}, rhs_batch_dims={0},
+//     lhs_contracting_dims={2}, rhs_contracting_dims={1}
+//   dot0 = reshape(slice(dot))
+//   dot1 = reshape(slice(dot))
+//
+// which runs as a single batched GEMM instead of one GEMM per dot.
+StatusOr<HloInstruction*> MergeIntoBatch(
+    absl::Span<HloInstruction* const> dots) {
+  HloInstruction* first = dots.front();
+  const int64_t num_dots = dots.size();
+  VLOG(2) << "Merging " << num_dots << " independent dots like "
+          << first->ToString() << " into a batched dot";
+
+  auto stack_operands = [&](int64_t operand_index) {
+    Shape slice_shape = ShapeUtil::PrependMajorDimension(
+        1, first->operand(operand_index)->shape());
+    std::vector<HloInstruction*> slices;
+    slices.reserve(num_dots);
+    for (HloInstruction* dot : dots) {
+      slices.push_back(dot->AddInstruction(HloInstruction::CreateReshape(
+          slice_shape, dot->mutable_operand(operand_index))));
+    }
+    Shape stacked_shape = slice_shape;
+    stacked_shape.set_dimensions(0, num_dots);
+    return first->AddInstruction(
+        HloInstruction::CreateConcatenate(stacked_shape, slices, 0));
+  };
+  HloInstruction* lhs = stack_operands(0);
+  HloInstruction* rhs = stack_operands(1);
+
+  const DotDimensionNumbers& dnums = first->dot_dimension_numbers();
+  DotDimensionNumbers batched_dnums;
+  batched_dnums.add_lhs_batch_dimensions(0);
+  batched_dnums.add_rhs_batch_dimensions(0);
+  for (int64_t dim : dnums.lhs_batch_dimensions()) {
+    batched_dnums.add_lhs_batch_dimensions(dim + 1);
+  }
+  for (int64_t dim : dnums.rhs_batch_dimensions()) {
+    batched_dnums.add_rhs_batch_dimensions(dim + 1);
+  }
+  for (int64_t dim : dnums.lhs_contracting_dimensions()) {
+    batched_dnums.add_lhs_contracting_dimensions(dim + 1);
+  }
+  for (int64_t dim : dnums.rhs_contracting_dimensions()) {
+    batched_dnums.add_rhs_contracting_dimensions(dim + 1);
+  }
+
+  // Batch dimensions come first in the result of a dot, so the new one is the
+  // major dimension of the result.
+  Shape batched_shape =
+      ShapeUtil::PrependMajorDimension(num_dots, first->shape());
+  HloInstruction* batched_dot = first->AddInstruction(HloInstruction::CreateDot(
+      batched_shape, lhs, rhs, batched_dnums, first->precision_config()));
+  for (HloInstruction* dot : dots) {
+    if (!dot->metadata().op_name().empty()) {
+      batched_dot->set_metadata(dot->metadata());
+      break;
+    }
+  }
+
+  Shape slice_shape = ShapeUtil::PrependMajorDimension(1, first->shape());
+  DimensionVector start_indices(batched_shape.dimensions_size(), 0);
+  DimensionVector limit_indices(batched_shape.dimensions().begin(),
+                                batched_shape.dimensions().end());
+  DimensionVector strides(batched_shape.dimensions_size(), 1);
+  for (int64_t i = 0; i < num_dots; ++i) {
+    start_indices[0] = i;
+    limit_indices[0] = i + 1;
+    HloInstruction* slice = batched_dot->AddInstruction(
+        HloInstruction::CreateSlice(slice_shape, batched_dot, start_indices,
+                                    limit_indices, strides));
+    HloInstruction* result = batched_dot->AddInstruction(
+        HloInstruction::CreateReshape(dots[i]->shape(), slice));
+    TF_RETURN_IF_ERROR(dots[i]->ReplaceAllUsesWith(result));
+  }
+  return batched_dot;
+}
+
+StatusOr<bool> MergeIndependentDots(HloComputation* comp,
+                                    int64_t max_size_to_merge) {
+  // Groups of dots that could be batched together, in post order.
+  std::vector<std::vector<HloInstruction*>> groups;
+  std::vector<HloInstruction*> post_order = comp->MakeInstructionPostOrder();
+  for (HloInstruction* instr : post_order) {
+    if (instr->opcode() != HloOpcode::kDot ||
+        !instr->control_predecessors().empty() ||
+        !instr->control_successors().empty() || instr->shape().is_dynamic()) {
+      continue;
+    }
+    int64_t bytes = ShapeUtil::ByteSizeOfElements(instr->shape());
+    for (const HloInstruction* operand : instr->operands()) {
+      bytes += ShapeUtil::ByteSizeOfElements(operand->shape());
+    }
+    // Batching only pays off for dots too small to fill the device.
+    if (bytes > max_size_to_merge) {
+      continue;
+    }
+    auto group = absl::c_find_if(groups, [&](const auto& group) {
+      return CanBatchTogether(group.front(), instr);
+    });
+    if (group == groups.end()) {
+      groups.push_back({instr});
+    } else {
+      group->push_back(instr);
+    }
+  }
+  absl::erase_if(groups, [](const auto& group) { return group.size() < 2; });
+  if (groups.empty()) {
+    return false;
+  }
+
+  tensorflow::GraphCycles graph;
+  absl::flat_hash_map<HloInstruction*, int32_t> graph_ids_map;
+  auto graph_id = [&](HloInstruction* instr) {
+    auto [it, inserted] = graph_ids_map.emplace(instr, -1);
+    if (inserted) {
+      it->second = graph.NewNode();
+    }
+    return it->second;
+  };
+  for (HloInstruction* instr : post_order) {
+    int32_t id = graph_id(instr);
+    for (HloInstruction* operand : instr->operands()) {
+      CHECK(graph.InsertEdge(graph_id(operand), id));
+    }
+    for (HloInstruction* control_pred : instr->control_predecessors()) {
+      CHECK(graph.InsertEdge(graph_id(control_pred), id));
+    }
+  }
+
+  std::vector<HloInstruction*> dead_instrs;
+  for (const std::vector<HloInstruction*>& group : groups) {
+    // Greedily pick dots that are independent of all dots picked so far.
+    std::vector<HloInstruction*> batch;
+    for (HloInstruction* dot : group) {
+      int32_t dot_id = graph_id(dot);
+      if (absl::c_none_of(batch, [&](HloInstruction* other) {
+            int32_t other_id = graph_id(other);
+            return graph.IsReachableNonConst(dot_id, other_id) ||
+                   graph.IsReachableNonConst(other_id, dot_id);
+          })) {
+        batch.push_back(dot);
+      }
+    }
+    if (batch.size() < 2) {
+      continue;
+    }
+
+    TF_ASSIGN_OR_RETURN(HloInstruction * merged, MergeIntoBatch(batch));
+    // The merged dot depends on the inputs of every dot of the batch, and
+    // every user of the batch depends on it.
+    int32_t merged_id = graph_id(merged);
+    for (HloInstruction* dot : batch) {
+      int32_t dot_id = graph_id(dot);
+      graph.InsertEdge(dot_id, merged_id);
+      for (int32_t succ : graph.SuccessorsCopy(dot_id)) {
+        if (succ != merged_id) {
+          graph.InsertEdge(merged_id, succ);
+        }
+      }
+      dead_instrs.push_back(dot);
+    }
+  }
+
+  for (HloInstruction* instr : dead_instrs) {
+    TF_RETURN_IF_ERROR(comp->RemoveInstruction(instr));
+  }
+  return !dead_instrs.empty();
+}
+
 }  // anonymous namespace
 
 StatusOr<bool> DotMerger::Run(
@@ -382,6 +587,11 @@ StatusOr<bool> DotMerger::Run(
     TF_ASSIGN_OR_RETURN(bool changed_computation,
                         MergeDots(comp, max_size_to_merge_));
     changed |= changed_computation;
+    if (merge_independent_dots_) {
+      TF_ASSIGN_OR_RETURN(changed_computation,
+                          MergeIndependentDots(comp, max_size_to_merge_));
+      changed |= changed_computation;
+    }
   }
   return changed;
 }
@@ -51,10 +51,18 @@ namespace xla {
 //
 // Will skip gemms with more than one non-contracting dimension in the dot
 // operands to be concatenated.
+//
+// With `merge_independent_dots`, independent dots that don't share an operand
+// but have the same operand shapes, dimension numbers and precision are then
+// stacked into a single dot with an extra leading batch dimension, so that
+// many small GEMMs (e.g. one per attention head or expert) run as one batched
+// GEMM.  The same size threshold applies to every stacked dot.
 class DotMerger : public HloModulePass {
  public:
-  explicit DotMerger(int64_t max_size_to_merge)
-      : max_size_to_merge_(max_size_to_merge) {}
+  explicit DotMerger(int64_t max_size_to_merge,
+                     bool merge_independent_dots = false)
+      : max_size_to_merge_(max_size_to_merge),
+        merge_independent_dots_(merge_independent_dots) {}
 
   absl::string_view name() const override { return "dot-merger"; }
   using HloPassInterface::Run;
@@ -64,6 +72,7 @@ class DotMerger : public HloModulePass {
 
  private:
   int64_t max_size_to_merge_;
+  bool merge_independent_dots_;
 };
 
 }  // namespace xla
@@ -708,5 +708,83 @@ TEST_F(DotMergerTest, MergeWithTypeUpgrade) {
   EXPECT_EQ(d0, d1);
 }
 
+constexpr absl::string_view kIndependentDots = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs0 = f32[32,64] parameter(0)
+    rhs0 = f32[64,16] parameter(1)
+    lhs1 = f32[32,64] parameter(2)
+    rhs1 = f32[64,16] parameter(3)
+    lhs2 = f32[32,64] parameter(4)
+    rhs2 = f32[64,16] parameter(5)
+    dot0 = f32[32,16] dot(lhs0, rhs0), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    dot1 = f32[32,16] dot(lhs1, rhs1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    dot2 = f32[32,16] dot(lhs2, rhs2), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT tuple = (f32[32,16], f32[32,16], f32[32,16]) tuple(dot0, dot1, dot2)
+  })";
+
+TEST_F(DotMergerTest, NoMergeIndependentDotsByDefault) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kIndependentDots));
+  DotMerger pass(/*max_size_to_merge=*/std::numeric_limits<int64_t>::max());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(DotMergerTest, MergeIndependentDotsIntoBatch) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kIndependentDots));
+  DotMerger pass(/*max_size_to_merge=*/std::numeric_limits<int64_t>::max(),
+                 /*merge_independent_dots=*/true);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  SCOPED_TRACE(module->ToString());
+
+  EXPECT_TRUE(changed);
+  const HloInstruction* d0 = nullptr;
+  const HloInstruction* d1 = nullptr;
+  const HloInstruction* d2 = nullptr;
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::Tuple(
+          m::Reshape(m::Slice(
+              m::Dot(&d0,
+                     m::Concatenate(m::Reshape(m::Parameter(0)),
+                                    m::Reshape(m::Parameter(2)),
+                                    m::Reshape(m::Parameter(4))),
+                     m::Concatenate(m::Reshape(m::Parameter(1)),
+                                    m::Reshape(m::Parameter(3)),
+                                    m::Reshape(m::Parameter(5))))
+                  .WithShape(F32, {3, 32, 16}))),
+          m::Reshape(m::Slice(m::Op(&d1))),
+          m::Reshape(m::Slice(m::Op(&d2))))));
+  EXPECT_EQ(d0, d1);
+  EXPECT_EQ(d0, d2);
+  const DotDimensionNumbers& dnums = d0->dot_dimension_numbers();
+  EXPECT_THAT(dnums.lhs_batch_dimensions(), ::testing::ElementsAre(0));
+  EXPECT_THAT(dnums.rhs_batch_dimensions(), ::testing::ElementsAre(0));
+  EXPECT_THAT(dnums.lhs_contracting_dimensions(), ::testing::ElementsAre(2));
+  EXPECT_THAT(dnums.rhs_contracting_dimensions(), ::testing::ElementsAre(1));
+}
+
+TEST_F(DotMergerTest, NoMergeDependentDotsIntoBatch) {
+  absl::string_view module_string = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs0 = f32[16,16] parameter(0)
+    rhs0 = f32[16,16] parameter(1)
+    rhs1 = f32[16,16] parameter(2)
+    dot0 = f32[16,16] dot(lhs0, rhs0), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT dot1 = f32[16,16] dot(dot0, rhs1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_string));
+  DotMerger pass(/*max_size_to_merge=*/std::numeric_limits<int64_t>::max(),
+                 /*merge_independent_dots=*/true);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_FALSE(changed);
+}
+
 }  // namespace
 }  // namespace xla
@@ -29,9 +29,11 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "xla/autotune_results.pb.h"
 #include "xla/autotuning.pb.h"
 #include "xla/hlo/ir/hlo_clone_context.h"
@@ -51,6 +53,7 @@ limitations under the License.
 #include "xla/util.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/protobuf.h"  // IWYU pragma: keep
@@ -65,6 +68,10 @@ static absl::Mutex autotune_cache_mu(absl::kConstInit);
 static auto& autotune_cache ABSL_GUARDED_BY(autotune_cache_mu) =
     *new AutotuneCacheMap();
 
+static absl::Mutex autotune_store_mu(absl::kConstInit);
+static auto& autotune_store ABSL_GUARDED_BY(autotune_store_mu) =
+    *new std::shared_ptr<AutotuneKeyValueStore>();
+
 /*static*/ Status AutotunerUtil::SerializeAutotuneResults(
     AutotuneResults* results) {
   absl::MutexLock lock(&autotune_cache_mu);
@@ -164,6 +171,80 @@ static AutotuneResult* TryFindInCache(const AutotuneCacheKey& key) {
   return inserted;
 }
 
+/*static*/ void AutotunerUtil::SetKeyValueStore(
+    std::shared_ptr<AutotuneKeyValueStore> store) {
+  absl::MutexLock lock(&autotune_store_mu);
+  autotune_store = std::move(store);
+}
+
+// Returns the store to shard autotuning with, or null if autotuning of
+// `config` isn't sharded.
+static std::shared_ptr<AutotuneKeyValueStore> GetShardingStore(
+    const AutotuneConfig& config) {
+  if (!config.ShardAutotuning()) {
+    return nullptr;
+  }
+  absl::MutexLock lock(&autotune_store_mu);
+  if (autotune_store == nullptr || autotune_store->num_nodes <= 1) {
+    return nullptr;
+  }
+  return autotune_store;
+}
+
+static uint64_t ShardingFingerprint(const AutotuneCacheKey& key) {
+  return tsl::Fingerprint64(key.ToString());
+}
+
+static std::string ShardingStoreKey(const AutotuneCacheKey& key) {
+  return absl::StrCat("xla_gpu_autotune/",
+                      absl::Hex(ShardingFingerprint(key), absl::kZeroPad16));
+}
+
+/*static*/ bool AutotunerUtil::IsResultOwner(const AutotuneCacheKey& key,
+                                             const AutotuneConfig& config) {
+  auto store = GetShardingStore(config);
+  return store == nullptr ||
+         ShardingFingerprint(key) % store->num_nodes == store->node_id;
+}
+
+/*static*/ Status AutotunerUtil::PublishResult(const AutotuneCacheKey& key,
+                                               const AutotuneConfig& config) {
+  auto store = GetShardingStore(config);
+  if (store == nullptr) {
+    return OkStatus();
+  }
+  // An empty value tells the other processes that there is no result.
+  std::string value;
+  if (AutotuneResult* res = TryFindInCache(key)) {
+    value = res->SerializeAsString();
+  }
+  return store->put(ShardingStoreKey(key), value);
+}
+
+/*static*/ bool AutotunerUtil::WaitForResult(const AutotuneCacheKey& key,
+                                             const AutotuneConfig& config) {
+  auto store = GetShardingStore(config);
+  if (store == nullptr) {
+    return false;
+  }
+  StatusOr<std::string> value =
+      store->get(ShardingStoreKey(key), store->timeout);
+  if (!value.ok()) {
+    LOG(WARNING) << "Autotuning locally, failed to get the result from node "
+                 << ShardingFingerprint(key) % store->num_nodes << ": "
+                 << value.status();
+    return false;
+  }
+  AutotuneResult result;
+  if (value->empty() || !result.ParseFromString(*value)) {
+    VLOG(1) << "Autotuning locally, no result published for "
+            << key.ToString();
+    return false;
+  }
+  AddResult(key, std::move(result));
+  return true;
+}
+
 /*static*/ StatusOr<AutotuneResult> AutotunerUtil::Autotune(
     const HloInstruction* instr, const AutotuneConfig& config,
     const AutotuneNoCacheFn& autotune_fn) {
@@ -172,11 +253,27 @@ static AutotuneResult* TryFindInCache(const AutotuneCacheKey& key) {
     return *res;
   }
 
-  TF_ASSIGN_OR_RETURN(AutotuneResult autotune_result, autotune_fn());
+  bool is_owner = IsResultOwner(key, config);
+  if (!is_owner && WaitForResult(key, config)) {
+    if (AutotuneResult* res = TryFindInCache(key)) {
+      return *res;
+    }
+  }
+
+  StatusOr<AutotuneResult> autotune_result = autotune_fn();
+  if (autotune_result.ok()) {
+    absl::MutexLock lock(&autotune_cache_mu);
+    autotune_cache.emplace(key, *autotune_result);
+  }
+  if (is_owner) {
+    if (Status status = PublishResult(key, config); !status.ok()) {
+      LOG(WARNING) << "Failed to publish autotune result: " << status;
+    }
+  }
+  TF_RETURN_IF_ERROR(autotune_result.status());
 
   absl::MutexLock lock(&autotune_cache_mu);
-  auto [it, inserted] = autotune_cache.emplace(key, autotune_result);
-  return it->second;
+  return autotune_cache.at(key);
 }
 
 namespace {
@@ -19,10 +19,12 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 #include <variant>
 
+#include "absl/time/time.h"
 #include "xla/autotune_results.pb.h"
 #include "xla/autotuning.pb.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -57,6 +59,26 @@ struct DevicelessConfig {
   se::CudaComputeCapability cuda_compute_capability{0, 0};
 };
 
+// Callbacks to a key-value store shared by all processes of a multi-host job,
+// e.g. the PjRt distributed runtime. With --xla_gpu_shard_autotuning, each
+// instruction is autotuned by one process, which publishes the result in the
+// store; the other processes wait for it instead of autotuning.
+struct AutotuneKeyValueStore {
+  // Blocks until `key` is set or `timeout` expires. Must be thread-safe.
+  std::function<StatusOr<std::string>(std::string_view key,
+                                      absl::Duration timeout)>
+      get;
+  // Must be thread-safe.
+  std::function<Status(std::string_view key, std::string_view value)> put;
+
+  int node_id = 0;
+  int num_nodes = 1;
+
+  // How long to wait for another process to publish a result before falling
+  // back to autotuning locally.
+  absl::Duration timeout = absl::Minutes(10);
+};
+
 class AutotuneCacheKey {
  public:
   AutotuneCacheKey(absl::string_view model_str,
@@ -105,7 +127,8 @@ class AutotuneConfig {
         should_crash_on_check_failure_(
             debug_options.xla_gpu_crash_on_verification_failures()),
         exhaustive_tiling_search_(
-            debug_options.xla_gpu_exhaustive_tiling_search()) {}
+            debug_options.xla_gpu_exhaustive_tiling_search()),
+        shard_autotuning_(debug_options.xla_gpu_shard_autotuning()) {}
 
   absl::string_view GetModelStr() const {
     if (auto deviceless_config = std::get_if<DevicelessConfig>(&config_)) {
@@ -145,11 +168,16 @@ class AutotuneConfig {
 
   bool ExhaustiveTilingSearch() const { return exhaustive_tiling_search_; }
 
+  // Whether autotuning is split between the processes sharing the store set
+  // with AutotunerUtil::SetKeyValueStore.
+  bool ShardAutotuning() const { return shard_autotuning_; }
+
  private:
   std::variant<DeviceConfig, DevicelessConfig> config_;
   int32_t autotune_level_;
   bool should_crash_on_check_failure_;
   bool exhaustive_tiling_search_;
+  bool shard_autotuning_;
 };
 
 using AutotuneNoCacheFn = std::function<StatusOr<AutotuneResult>()>;
@@ -183,6 +211,31 @@ struct AutotunerUtil {
   // Normally, we don't have to use this low level method.
   static bool AddResult(const AutotuneCacheKey& key, AutotuneResult result);
 
+  // Sets the store used to share results between processes, or clears it if
+  // `store` is null. Only used when `AutotuneConfig::ShardAutotuning()`.
+  static void SetKeyValueStore(std::shared_ptr<AutotuneKeyValueStore> store);
+
+  // Returns whether this process has to autotune `key` itself: always true
+  // unless autotuning is sharded, in which case every key has exactly one
+  // owner.
+  //
+  // Normally, we don't have to use these low level methods. Autotune() shards
+  // automatically.
+  static bool IsResultOwner(const AutotuneCacheKey& key,
+                            const AutotuneConfig& config);
+
+  // Publishes the cached result for an owned `key` to the other processes. If
+  // there is no result, e.g. because autotuning failed, they are told to
+  // autotune `key` themselves. No-op unless autotuning is sharded.
+  static Status PublishResult(const AutotuneCacheKey& key,
+                              const AutotuneConfig& config);
+
+  // Waits until the owner of `key` publishes its result and adds it to the
+  // cache. Returns false if the owner failed or timed out, in which case the
+  // caller should autotune `key` locally.
+  static bool WaitForResult(const AutotuneCacheKey& key,
+                            const AutotuneConfig& config);
+
   // Creates a RedzoneAllocator from a given config. If `force_stream` is
   // provided, than it is used for checking redzones.
   static StatusOr<se::RedzoneAllocator> CreateRedzoneAllocator(
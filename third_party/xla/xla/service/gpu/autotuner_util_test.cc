@@ -15,17 +15,25 @@ limitations under the License.
 
 #include "xla/service/gpu/autotuner_util.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "xla/autotune_results.pb.h"
+#include "xla/autotuning.pb.h"
 #include "xla/tests/hlo_test_base.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"   // IWYU pragma: keep
 #include "tsl/platform/protobuf.h"  // IWYU pragma: keep
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace gpu {
@@ -123,6 +131,100 @@ TEST_F(AutotunerUtilTest, LoadAutotuneResultsFromFile_Protobuf) {
   TF_EXPECT_OK(AutotunerUtil::LoadAutotuneResultsFromFile(kFilePath));
 }
 
+// An in-process key-value store shared by simulated nodes.
+class FakeKeyValueStore {
+ public:
+  std::shared_ptr<AutotuneKeyValueStore> ForNode(int node_id, int num_nodes) {
+    auto store = std::make_shared<AutotuneKeyValueStore>();
+    store->get = [this](std::string_view key,
+                        absl::Duration) -> StatusOr<std::string> {
+      absl::MutexLock lock(&mu_);
+      auto it = values_.find(key);
+      if (it == values_.end()) {
+        return absl::DeadlineExceededError("key not set");
+      }
+      return it->second;
+    };
+    store->put = [this](std::string_view key, std::string_view value) {
+      absl::MutexLock lock(&mu_);
+      values_[key] = value;
+      return absl::OkStatus();
+    };
+    store->node_id = node_id;
+    store->num_nodes = num_nodes;
+    return store;
+  }
+
+ private:
+  absl::Mutex mu_;
+  absl::flat_hash_map<std::string, std::string> values_ ABSL_GUARDED_BY(mu_);
+};
+
+TEST_F(AutotunerUtilTest, ShardedAutotuningSharesResultsBetweenNodes) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloText));
+  const HloInstruction* dot = module->entry_computation()->root_instruction();
+  DebugOptions debug_options;
+  debug_options.set_xla_gpu_shard_autotuning(true);
+  AutotuneConfig config(DevicelessConfig{"test_gpu", {8, 0}}, debug_options);
+  AutotuneCacheKey key = AutotunerUtil::GetKey(dot, config);
+
+  FakeKeyValueStore kv_store;
+  AutotunerUtil::SetKeyValueStore(kv_store.ForNode(0, 2));
+  int owner = AutotunerUtil::IsResultOwner(key, config) ? 0 : 1;
+
+  AutotuneResult tuned;
+  tuned.mutable_gemm()->set_algorithm(42);
+  AutotunerUtil::ClearAutotuneResults();
+  AutotunerUtil::SetKeyValueStore(kv_store.ForNode(owner, 2));
+  EXPECT_TRUE(AutotunerUtil::IsResultOwner(key, config));
+  TF_ASSERT_OK_AND_ASSIGN(
+      AutotuneResult result,
+      AutotunerUtil::Autotune(dot, config, [&] { return tuned; }));
+  EXPECT_EQ(result.gemm().algorithm(), 42);
+
+  // The other node gets the result without autotuning.
+  AutotunerUtil::ClearAutotuneResults();
+  AutotunerUtil::SetKeyValueStore(kv_store.ForNode(1 - owner, 2));
+  EXPECT_FALSE(AutotunerUtil::IsResultOwner(key, config));
+  TF_ASSERT_OK_AND_ASSIGN(
+      result, AutotunerUtil::Autotune(dot, config, [&] {
+        return StatusOr<AutotuneResult>(
+            absl::InternalError("Unexpected autotuning"));
+      }));
+  EXPECT_EQ(result.gemm().algorithm(), 42);
+
+  AutotunerUtil::SetKeyValueStore(nullptr);
+  AutotunerUtil::ClearAutotuneResults();
+}
+
+TEST_F(AutotunerUtilTest, ShardedAutotuningFallsBackToLocalAutotuning) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloText));
+  const HloInstruction* dot = module->entry_computation()->root_instruction();
+  DebugOptions debug_options;
+  debug_options.set_xla_gpu_shard_autotuning(true);
+  AutotuneConfig config(DevicelessConfig{"test_gpu", {8, 0}}, debug_options);
+  AutotuneCacheKey key = AutotunerUtil::GetKey(dot, config);
+
+  FakeKeyValueStore kv_store;
+  AutotunerUtil::SetKeyValueStore(kv_store.ForNode(0, 2));
+  int non_owner = AutotunerUtil::IsResultOwner(key, config) ? 1 : 0;
+  AutotunerUtil::SetKeyValueStore(kv_store.ForNode(non_owner, 2));
+
+  // The owner never publishes a result.
+  AutotuneResult tuned;
+  tuned.mutable_gemm()->set_algorithm(7);
+  AutotunerUtil::ClearAutotuneResults();
+  TF_ASSERT_OK_AND_ASSIGN(
+      AutotuneResult result,
+      AutotunerUtil::Autotune(dot, config, [&] { return tuned; }));
+  EXPECT_EQ(result.gemm().algorithm(), 7);
+
+  AutotunerUtil::SetKeyValueStore(nullptr);
+  AutotunerUtil::ClearAutotuneResults();
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
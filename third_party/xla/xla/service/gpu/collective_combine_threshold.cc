@@ -0,0 +1,83 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/collective_combine_threshold.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/collective_combiner_utils.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/statusor.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+namespace gpu {
+
+bool SpansMultipleNodes(const HloInstruction* instr, int64_t devices_per_node) {
+  if (devices_per_node <= 0) {
+    return false;
+  }
+  std::optional<bool> use_global_device_ids;
+  if (auto* all_gather = DynCast<HloAllGatherInstruction>(instr)) {
+    use_global_device_ids = all_gather->use_global_device_ids();
+  } else if (auto* all_reduce = DynCast<HloAllReduceInstructionBase>(instr)) {
+    use_global_device_ids = all_reduce->use_global_device_ids();
+  }
+  StatusOr<CollectiveOpGroupMode> group_mode = GetCollectiveOpGroupMode(
+      instr->channel_id().has_value(), use_global_device_ids);
+  if (!group_mode.ok()) {
+    return false;
+  }
+
+  const HloModuleConfig& config = instr->GetModule()->config();
+  StatusOr<std::vector<ReplicaGroup>> groups =
+      GetParticipatingFlattenedIdGroups(instr->replica_groups(), *group_mode,
+                                        config.replica_count(),
+                                        config.num_partitions());
+  if (!groups.ok()) {
+    return false;
+  }
+  for (const ReplicaGroup& group : *groups) {
+    if (group.replica_ids_size() == 0) {
+      continue;
+    }
+    const int64_t node = group.replica_ids(0) / devices_per_node;
+    for (int64_t device : group.replica_ids()) {
+      if (device / devices_per_node != node) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+CombineThresholdBytesFn TopologyAwareCombineThreshold(
+    int64_t intra_node_threshold_bytes, int64_t inter_node_threshold_bytes,
+    int64_t devices_per_node) {
+  return [=](const HloInstruction* instr) {
+    return SpansMultipleNodes(instr, devices_per_node)
+               ? inter_node_threshold_bytes
+               : intra_node_threshold_bytes;
+  };
+}
+
+}  // namespace gpu
+}  // namespace xla
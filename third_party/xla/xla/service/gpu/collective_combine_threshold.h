@@ -0,0 +1,45 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_COLLECTIVE_COMBINE_THRESHOLD_H_
+#define XLA_SERVICE_GPU_COLLECTIVE_COMBINE_THRESHOLD_H_
+
+#include <cstdint>
+
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/collective_combiner_utils.h"
+
+namespace xla {
+namespace gpu {
+
+// Returns whether some replica group of the collective `instr` contains
+// devices of different nodes, i.e. communicates over the network rather than
+// NVLink. Devices are assumed to be numbered like the default device
+// assignment, replica * num_partitions + partition, and to be spread over
+// nodes in order, `devices_per_node` at a time.
+bool SpansMultipleNodes(const HloInstruction* instr, int64_t devices_per_node);
+
+// Returns a threshold function for the collective combiners that uses
+// `inter_node_threshold_bytes` for collectives spanning multiple nodes and
+// `intra_node_threshold_bytes` otherwise. Inter-node collectives have a much
+// higher latency, so they are worth combining into larger ops.
+CombineThresholdBytesFn TopologyAwareCombineThreshold(
+    int64_t intra_node_threshold_bytes, int64_t inter_node_threshold_bytes,
+    int64_t devices_per_node);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_COLLECTIVE_COMBINE_THRESHOLD_H_
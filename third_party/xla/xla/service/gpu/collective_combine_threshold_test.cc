@@ -0,0 +1,91 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/collective_combine_threshold.h"
+
+#include <gtest/gtest.h>
+#include "absl/algorithm/container.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/all_reduce_combiner.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using CollectiveCombineThresholdTest = HloTestBase;
+
+// 16 replicas on two nodes of 8 GPUs.
+constexpr absl::string_view kHloString = R"(
+HloModule m
+
+sum {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  ROOT add = f32[] add(a, b)
+}
+
+ENTRY e {
+  p0 = f32[256] parameter(0)
+  p1 = f32[256] parameter(1)
+  intra0 = f32[256] all-reduce(p0), replica_groups={{0,1,2,3,4,5,6,7},{8,9,10,11,12,13,14,15}}, to_apply=sum
+  intra1 = f32[256] all-reduce(p1), replica_groups={{0,1,2,3,4,5,6,7},{8,9,10,11,12,13,14,15}}, to_apply=sum
+  inter0 = f32[256] all-reduce(p0), replica_groups={{0,8},{1,9},{2,10},{3,11},{4,12},{5,13},{6,14},{7,15}}, to_apply=sum
+  inter1 = f32[256] all-reduce(p1), replica_groups={{0,8},{1,9},{2,10},{3,11},{4,12},{5,13},{6,14},{7,15}}, to_apply=sum
+  ROOT t = (f32[256], f32[256], f32[256], f32[256]) tuple(intra0, intra1, inter0, inter1)
+})";
+
+TEST_F(CollectiveCombineThresholdTest, SpansMultipleNodes) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(kHloString, /*replica_count=*/16));
+  const HloComputation* entry = module->entry_computation();
+  EXPECT_FALSE(SpansMultipleNodes(entry->GetInstructionWithName("intra0"),
+                                  /*devices_per_node=*/8));
+  EXPECT_TRUE(SpansMultipleNodes(entry->GetInstructionWithName("inter0"),
+                                 /*devices_per_node=*/8));
+  // With 16 GPUs per node everything is intra-node.
+  EXPECT_FALSE(SpansMultipleNodes(entry->GetInstructionWithName("inter0"),
+                                  /*devices_per_node=*/16));
+  // Unknown topology.
+  EXPECT_FALSE(SpansMultipleNodes(entry->GetInstructionWithName("inter0"),
+                                  /*devices_per_node=*/0));
+}
+
+TEST_F(CollectiveCombineThresholdTest, CombinesInterNodeAllReducesFurther) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(kHloString, /*replica_count=*/16));
+  // Each all-reduce is 1KiB: only the inter-node ones fit in one combined op.
+  AllReduceCombiner combiner(
+      /*combine_threshold_in_bytes=*/1024, /*combine_threshold_count=*/256,
+      TopologyAwareCombineThreshold(/*intra_node_threshold_bytes=*/1024,
+                                    /*inter_node_threshold_bytes=*/4096,
+                                    /*devices_per_node=*/8));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&combiner, module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(absl::c_count_if(module->entry_computation()->instructions(),
+                             [](const HloInstruction* instr) {
+                               return instr->opcode() == HloOpcode::kAllReduce;
+                             }),
+            3);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
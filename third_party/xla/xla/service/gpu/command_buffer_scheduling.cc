@@ -118,6 +118,21 @@ bool IsCommand<HloOpcode::kWhile>(const HloInstruction* hlo,
          IsCommand(hlo->while_body(), config);
 }
 
+// Conditionals can be executed inside command buffers only if all branches can
+// be executed as command buffers. CUDA graph conditional nodes for case
+// statements support a limited number of branches.
+template <>
+bool IsCommand<HloOpcode::kConditional>(const HloInstruction* hlo,
+                                        const CommandBufferConfig& config) {
+  static constexpr int64_t kMaxNumBranches = 8;
+  return config.contains(DebugOptions::CONDITIONALS) &&
+         hlo->branch_count() <= kMaxNumBranches &&
+         absl::c_all_of(hlo->branch_computations(),
+                        [&](const HloComputation* comp) {
+                          return IsCommand(comp, config);
+                        });
+}
+
 static bool IsCommand(const HloCustomCallInstruction* hlo,
                       const CommandBufferConfig& config) {
   return config.contains(DebugOptions::CUBLAS) && IsLegacyCublasMatmul(*hlo);
@@ -137,9 +152,30 @@ static bool IsCommand(const HloInstruction* hlo,
   if (hlo->opcode() == HloOpcode::kWhile)
     return IsCommand<HloOpcode::kWhile>(hlo, config);
 
+  if (hlo->opcode() == HloOpcode::kConditional)
+    return IsCommand<HloOpcode::kConditional>(hlo, config);
+
   return false;
 }
 
+// Returns the number of commands recorded for a command instruction. Control
+// flow commands record all commands of their nested computations, so a single
+// loop with a large body is worth a command buffer on its own.
+static int64_t NumCommands(const HloInstruction* hlo) {
+  if (!HloPredicateIsOp<HloOpcode::kWhile, HloOpcode::kConditional>(hlo)) {
+    return 1;
+  }
+  int64_t num_commands = 0;
+  for (const HloComputation* computation : hlo->called_computations()) {
+    for (const HloInstruction* inst : computation->instructions()) {
+      if (!IsNoOp(inst) && !IsConstant(inst) && !IsParameter(inst)) {
+        num_commands += NumCommands(inst);
+      }
+    }
+  }
+  return num_commands;
+}
+
 //===----------------------------------------------------------------------===//
 
 static void RemoveTrailingNoOps(HloInstructionSequence& seq) {
@@ -184,7 +220,7 @@ CommandBufferScheduling::CollectCommandBufferSequences(
   auto process_instruction = [&](Accumulator* acc, HloInstruction* inst) {
     if (IsCommand(inst, config)) {
       acc->current_seq.push_back(inst);
-      acc->num_commands_in_current_seq++;
+      acc->num_commands_in_current_seq += NumCommands(inst);
       return acc;
     } else if (IsNoOp(inst)) {
       if (acc->current_seq.size() > 0) {
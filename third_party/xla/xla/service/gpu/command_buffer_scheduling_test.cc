@@ -235,6 +235,62 @@ TEST_F(CommandBufferSchedulingTest, CollectCommandBufferSequence) {
   EXPECT_EQ(seq_1[1]->opcode(), HloOpcode::kFusion);
 }
 
+TEST_F(CommandBufferSchedulingTest, CollectControlFlowCommands) {
+  const char* hlo = R"(
+      HloModule TestModule, is_scheduled=true
+
+      %fused_computation(param_0: s32[]) -> s32[] {
+        %p0 = s32[] parameter(0)
+        ROOT %negate = s32[] negate(s32[] %p0)
+      }
+
+      %fused_computation.1(param_0: s32[]) -> s32[] {
+        %p0 = s32[] parameter(0)
+        ROOT %abs = s32[] abs(s32[] %p0)
+      }
+
+      %then (p: s32[]) -> s32[] {
+        %p = s32[] parameter(0)
+        %fusion = s32[] fusion(s32[] %p), kind=kLoop, calls=%fused_computation
+        ROOT %fusion.1 = s32[] fusion(s32[] %fusion), kind=kLoop, calls=%fused_computation.1
+      }
+
+      %else (p: s32[]) -> s32[] {
+        %p = s32[] parameter(0)
+        ROOT %fusion = s32[] fusion(s32[] %p), kind=kLoop, calls=%fused_computation
+      }
+
+      ENTRY %main (a: pred[], b: s32[]) -> s32[] {
+        %a = pred[] parameter(0)
+        %b = s32[] parameter(1)
+        ROOT %conditional = s32[] conditional(pred[] %a, s32[] %b, s32[] %b), true_computation=%then, false_computation=%else
+      })";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(hlo));
+
+  HloInstructionSequence seq;
+  for (HloInstruction* x : module->entry_computation()->instructions()) {
+    seq.push_back(x);
+  }
+
+  CommandBufferScheduling::CommandBufferConfig config;
+  config.insert(DebugOptions::FUSION);
+  EXPECT_TRUE(
+      CommandBufferScheduling::CollectCommandBufferSequences(seq, config)
+          .empty());
+
+  // A single conditional records all commands of its branches.
+  config.insert(DebugOptions::CONDITIONALS);
+  std::vector<HloInstructionSequence> command_buffer_sequences =
+      CommandBufferScheduling::CollectCommandBufferSequences(seq, config);
+  ASSERT_EQ(command_buffer_sequences.size(), 1);
+  std::vector<HloInstruction*> seq_0 =
+      command_buffer_sequences[0].instructions();
+  ASSERT_EQ(seq_0.size(), 1);
+  EXPECT_EQ(seq_0[0]->opcode(), HloOpcode::kConditional);
+}
+
 TEST_F(CommandBufferSchedulingTest, MoveParametersToFront) {
   const char* hlo = R"(
       HloModule TestModule, is_scheduled=true
@@ -40,10 +40,77 @@ namespace {
   }
 #endif
 
+// Maps a row index to the offset of its first element, so that the segment
+// offsets of equally sized rows don't need to be materialized in memory.
+struct RowOffset {
+  int row_size;
+  __host__ __device__ int operator()(int row) const { return row * row_size; }
+};
+
+using RowOffsetIterator =
+    gpuprim::TransformInputIterator<int, RowOffset,
+                                    gpuprim::CountingInputIterator<int>>;
+
+RowOffsetIterator MakeRowOffsetIterator(size_t num_items, size_t batch_size) {
+  return RowOffsetIterator(gpuprim::CountingInputIterator<int>(0),
+                           RowOffset{static_cast<int>(num_items / batch_size)});
+}
+
+// Sorts each of the `batch_size` rows of the input independently.
+template <typename KeyT>
+const char* CubSegmentedSortKeys(void* d_temp_storage, size_t& temp_bytes,
+                                 const void* d_keys_in, void* d_keys_out,
+                                 size_t num_items, bool descending,
+                                 size_t batch_size) {
+  RowOffsetIterator offsets = MakeRowOffsetIterator(num_items, batch_size);
+  auto err =
+      descending
+          ? gpuprim::DeviceSegmentedRadixSort::SortKeysDescending<KeyT>(
+                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
+                static_cast<KeyT*>(d_keys_out), num_items, batch_size, offsets,
+                offsets + 1)
+          : gpuprim::DeviceSegmentedRadixSort::SortKeys<KeyT>(
+                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
+                static_cast<KeyT*>(d_keys_out), num_items, batch_size, offsets,
+                offsets + 1);
+  CHK_GPU_ERR(err)
+  return nullptr;
+}
+
+template <typename KeyT, typename ValT>
+const char* CubSegmentedSortPairs(void* d_temp_storage, size_t& temp_bytes,
+                                  const void* d_keys_in, void* d_keys_out,
+                                  const void* d_values_in, void* d_values_out,
+                                  size_t num_items, bool descending,
+                                  size_t batch_size) {
+  RowOffsetIterator offsets = MakeRowOffsetIterator(num_items, batch_size);
+  auto err =
+      descending
+          ? gpuprim::DeviceSegmentedRadixSort::SortPairsDescending<KeyT, ValT>(
+                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
+                static_cast<KeyT*>(d_keys_out),
+                static_cast<const ValT*>(d_values_in),
+                static_cast<ValT*>(d_values_out), num_items, batch_size,
+                offsets, offsets + 1)
+          : gpuprim::DeviceSegmentedRadixSort::SortPairs<KeyT, ValT>(
+                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
+                static_cast<KeyT*>(d_keys_out),
+                static_cast<const ValT*>(d_values_in),
+                static_cast<ValT*>(d_values_out), num_items, batch_size,
+                offsets, offsets + 1);
+  CHK_GPU_ERR(err)
+  return nullptr;
+}
+
 template <typename KeyT>
 const char* CubSortKeys(void* d_temp_storage, size_t& temp_bytes,
                         const void* d_keys_in, void* d_keys_out,
-                        size_t num_items, bool descending) {
+                        size_t num_items, bool descending, size_t batch_size) {
+  if (batch_size > 1) {
+    return CubSegmentedSortKeys<KeyT>(d_temp_storage, temp_bytes, d_keys_in,
+                                      d_keys_out, num_items, descending,
+                                      batch_size);
+  }
   auto err =
       descending
           ? gpuprim::DeviceRadixSort::SortKeysDescending<KeyT>(
@@ -60,7 +127,12 @@ template <typename KeyT, typename ValT>
 const char* CubSortPairs(void* d_temp_storage, size_t& temp_bytes,
                          const void* d_keys_in, void* d_keys_out,
                          const void* d_values_in, void* d_values_out,
-                         size_t num_items, bool descending) {
+                         size_t num_items, bool descending, size_t batch_size) {
+  if (batch_size > 1) {
+    return CubSegmentedSortPairs<KeyT, ValT>(
+        d_temp_storage, temp_bytes, d_keys_in, d_keys_out, d_values_in,
+        d_values_out, num_items, descending, batch_size);
+  }
   auto err =
       descending
           ? gpuprim::DeviceRadixSort::SortPairsDescending<KeyT, ValT>(
@@ -82,19 +154,20 @@ const char* CubSortPairs(void* d_temp_storage, size_t& temp_bytes,
 #define XLA_CUB_DEFINE_SORT_KEYS(suffix, type)                               \
   const char* CubSortKeys_##suffix(void* d_temp_storage, size_t& temp_bytes, \
                                    const void* d_keys_in, void* d_keys_out,  \
-                                   size_t num_items, bool descending) {      \
+                                   size_t num_items, bool descending,        \
+                                   size_t batch_size) {                      \
     return CubSortKeys<type>(d_temp_storage, temp_bytes, d_keys_in,          \
-                             d_keys_out, num_items, descending);             \
+                             d_keys_out, num_items, descending, batch_size); \
   }
 
 #define XLA_CUB_DEFINE_SORT_PAIRS(suffix, type1, type2)                      \
   const char* CubSortPairs_##suffix(                                         \
       void* d_temp_storage, size_t& temp_bytes, const void* d_keys_in,       \
       void* d_keys_out, const void* d_values_in, void* d_values_out,         \
-      size_t num_items, bool descending) {                                   \
+      size_t num_items, bool descending, size_t batch_size) {                \
     return CubSortPairs<type1, type2>(d_temp_storage, temp_bytes, d_keys_in, \
                                       d_keys_out, d_values_in, d_values_out, \
-                                      num_items, descending);                \
+                                      num_items, descending, batch_size);    \
   }
 
 // Floating point types.
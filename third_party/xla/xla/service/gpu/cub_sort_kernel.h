@@ -24,18 +24,22 @@ namespace gpu {
 
 // Returns nullptr if no error, otherwise the error message as a null-terminated
 // string (cudaGetErrorString or similar).
+//
+// If `batch_size` is greater than one, the input is treated as `batch_size`
+// contiguous rows of `num_items / batch_size` elements, each sorted separately.
 #define XLA_CUB_DECLARE_SORT_KEYS(suffix)                                    \
   const char* CubSortKeys_##suffix(void* d_temp_storage, size_t& temp_bytes, \
                                    const void* d_keys_in, void* d_keys_out,  \
-                                   size_t num_items, bool descending);
+                                   size_t num_items, bool descending,        \
+                                   size_t batch_size);
 
 // Returns nullptr if no error, otherwise the error message as a null-terminated
-// string (cudaGetErrorString or similar).
+// string (cudaGetErrorString or similar). Rows are handled as for sort keys.
 #define XLA_CUB_DECLARE_SORT_PAIRS(suffix)                             \
   const char* CubSortPairs_##suffix(                                   \
       void* d_temp_storage, size_t& temp_bytes, const void* d_keys_in, \
       void* d_keys_out, const void* d_values_in, void* d_values_out,   \
-      size_t num_items, bool descending);
+      size_t num_items, bool descending, size_t batch_size);
 
 XLA_CUB_DECLARE_SORT_KEYS(bf16)
 XLA_CUB_DECLARE_SORT_KEYS(f16)
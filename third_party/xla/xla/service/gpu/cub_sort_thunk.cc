@@ -45,7 +45,7 @@ namespace {
 class CubSortKeysImpl : public CubSortRunnerInterface {
  public:
   using SortKeysFn = std::function<const char*(void*, size_t&, const void*,
-                                               void*, size_t, bool)>;
+                                               void*, size_t, bool, size_t)>;
 
   explicit CubSortKeysImpl(SortKeysFn sort_keys_fn, PrimitiveType type)
       : sort_keys_fn_(sort_keys_fn), type_(type) {}
@@ -53,10 +53,11 @@ class CubSortKeysImpl : public CubSortRunnerInterface {
   Status Run(se::DeviceMemoryBase input_keys, se::DeviceMemoryBase input_values,
              se::DeviceMemoryBase output_keys,
              se::DeviceMemoryBase output_values, se::DeviceMemoryBase scratch,
-             bool descending) override;
+             bool descending, int64_t batch_size) override;
   Status Run(const Thunk::ExecuteParams& params,
              const CubSortThunk* thunk) override;
-  StatusOr<int64_t> GetScratchSize(int64_t num_items) override;
+  StatusOr<int64_t> GetScratchSize(int64_t num_items,
+                                   int64_t batch_size) override;
 
  private:
   SortKeysFn sort_keys_fn_;
@@ -67,14 +68,15 @@ Status CubSortKeysImpl::Run(se::DeviceMemoryBase input_keys,
                             se::DeviceMemoryBase input_values,
                             se::DeviceMemoryBase output_keys,
                             se::DeviceMemoryBase output_values,
-                            se::DeviceMemoryBase scratch, bool descending) {
+                            se::DeviceMemoryBase scratch, bool descending,
+                            int64_t batch_size) {
   size_t temp_bytes = scratch.size();
   size_t num_items = input_keys.size() * 8 / primitive_util::BitWidth(type_);
   CHECK(input_values.is_null());
   CHECK(output_values.is_null());
   const char* error =
       sort_keys_fn_(scratch.opaque(), temp_bytes, input_keys.opaque(),
-                    output_keys.opaque(), num_items, descending);
+                    output_keys.opaque(), num_items, descending, batch_size);
   if (error != nullptr) {
     return absl::InvalidArgumentError(
         absl::StrCat("CubSortKeys error: ", error));
@@ -87,13 +89,15 @@ Status CubSortKeysImpl::Run(const Thunk::ExecuteParams& params,
   const BufferAllocations& allocs = *params.buffer_allocations;
   return Run(allocs.GetDeviceAddress(thunk->operand(0)), se::DeviceMemoryBase(),
              allocs.GetDeviceAddress(thunk->result(0)), se::DeviceMemoryBase(),
-             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending());
+             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending(),
+             thunk->batch_size());
 }
 
-StatusOr<int64_t> CubSortKeysImpl::GetScratchSize(int64_t num_items) {
+StatusOr<int64_t> CubSortKeysImpl::GetScratchSize(int64_t num_items,
+                                                  int64_t batch_size) {
   size_t temp_bytes = 0;
-  const char* error =
-      sort_keys_fn_(nullptr, temp_bytes, nullptr, nullptr, num_items, false);
+  const char* error = sort_keys_fn_(nullptr, temp_bytes, nullptr, nullptr,
+                                    num_items, false, batch_size);
   if (error != nullptr) {
     return absl::InvalidArgumentError(
         absl::StrCat("CubSortKeys error: ", error));
@@ -104,8 +108,9 @@ StatusOr<int64_t> CubSortKeysImpl::GetScratchSize(int64_t num_items) {
 // Template class for sorting a pair of tensors.
 class CubSortPairsImpl : public CubSortRunnerInterface {
  public:
-  using SortPairsFn = std::function<const char*(
-      void*, size_t&, const void*, void*, const void*, void*, size_t, bool)>;
+  using SortPairsFn =
+      std::function<const char*(void*, size_t&, const void*, void*,
+                                const void*, void*, size_t, bool, size_t)>;
 
   explicit CubSortPairsImpl(SortPairsFn sort_pairs_fn, PrimitiveType type)
       : sort_pairs_fn_(sort_pairs_fn), type_(type) {}
@@ -113,10 +118,11 @@ class CubSortPairsImpl : public CubSortRunnerInterface {
   Status Run(se::DeviceMemoryBase input_keys, se::DeviceMemoryBase input_values,
              se::DeviceMemoryBase output_keys,
              se::DeviceMemoryBase output_values, se::DeviceMemoryBase scratch,
-             bool descending) override;
+             bool descending, int64_t batch_size) override;
   Status Run(const Thunk::ExecuteParams& params,
              const CubSortThunk* thunk) override;
-  StatusOr<int64_t> GetScratchSize(int64_t num_items) override;
+  StatusOr<int64_t> GetScratchSize(int64_t num_items,
+                                   int64_t batch_size) override;
 
  private:
   SortPairsFn sort_pairs_fn_;
@@ -127,12 +133,14 @@ Status CubSortPairsImpl::Run(se::DeviceMemoryBase input_keys,
                              se::DeviceMemoryBase input_values,
                              se::DeviceMemoryBase output_keys,
                              se::DeviceMemoryBase output_values,
-                             se::DeviceMemoryBase scratch, bool descending) {
+                             se::DeviceMemoryBase scratch, bool descending,
+                             int64_t batch_size) {
   size_t temp_bytes = scratch.size();
   size_t num_items = input_keys.size() * 8 / primitive_util::BitWidth(type_);
   const char* error = sort_pairs_fn_(
       scratch.opaque(), temp_bytes, input_keys.opaque(), output_keys.opaque(),
-      input_values.opaque(), output_values.opaque(), num_items, descending);
+      input_values.opaque(), output_values.opaque(), num_items, descending,
+      batch_size);
   if (error != nullptr) {
     return absl::InvalidArgumentError(
         absl::StrCat("CubSortPairs error: ", error));
@@ -147,13 +155,16 @@ Status CubSortPairsImpl::Run(const Thunk::ExecuteParams& params,
              allocs.GetDeviceAddress(thunk->operand(1)),
              allocs.GetDeviceAddress(thunk->result(0)),
              allocs.GetDeviceAddress(thunk->result(1)),
-             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending());
+             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending(),
+             thunk->batch_size());
 }
 
-StatusOr<int64_t> CubSortPairsImpl::GetScratchSize(int64_t num_items) {
+StatusOr<int64_t> CubSortPairsImpl::GetScratchSize(int64_t num_items,
+                                                   int64_t batch_size) {
   size_t temp_bytes = 0;
-  const char* error = sort_pairs_fn_(nullptr, temp_bytes, nullptr, nullptr,
-                                     nullptr, nullptr, num_items, false);
+  const char* error =
+      sort_pairs_fn_(nullptr, temp_bytes, nullptr, nullptr, nullptr, nullptr,
+                     num_items, false, batch_size);
   if (error != nullptr) {
     return absl::InvalidArgumentError(
         absl::StrCat("CubSortPairs error: ", error));
@@ -248,23 +259,26 @@ CubSortThunk::CubSortThunk(ThunkInfo thunk_info, PrimitiveType type,
                            std::optional<PrimitiveType> value_type,
                            std::vector<BufferAllocation::Slice> operands,
                            std::vector<BufferAllocation::Slice> results,
-                           BufferAllocation::Slice scratch, bool descending)
+                           BufferAllocation::Slice scratch, bool descending,
+                           int64_t batch_size)
     : Thunk(Thunk::kCubSort, thunk_info),
       runner_(CubSortRunnerInterface::Create(type, value_type).value()),
       operands_(std::move(operands)),
       results_(std::move(results)),
       scratch_(scratch),
-      descending_(descending) {}
+      descending_(descending),
+      batch_size_(batch_size) {}
 
 Status RunCubSort(PrimitiveType type, std::optional<PrimitiveType> value_type,
                   se::DeviceMemoryBase input_keys,
                   se::DeviceMemoryBase input_values,
                   se::DeviceMemoryBase output_keys,
                   se::DeviceMemoryBase output_values,
-                  se::DeviceMemoryBase scratch, bool descending) {
+                  se::DeviceMemoryBase scratch, bool descending,
+                  int64_t batch_size) {
   auto runner = CubSortRunnerInterface::Create(type, value_type).value();
   return runner->Run(input_keys, input_values, output_keys, output_values,
-                     scratch, descending);
+                     scratch, descending, batch_size);
 }
 
 }  // namespace gpu
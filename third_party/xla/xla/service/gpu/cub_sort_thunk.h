@@ -38,10 +38,14 @@ class CubSortRunnerInterface {
                      se::DeviceMemoryBase input_values,
                      se::DeviceMemoryBase output_keys,
                      se::DeviceMemoryBase output_values,
-                     se::DeviceMemoryBase scratch, bool descending) = 0;
+                     se::DeviceMemoryBase scratch, bool descending,
+                     int64_t batch_size) = 0;
   virtual Status Run(const Thunk::ExecuteParams& params,
                      const class CubSortThunk* thunk) = 0;
-  virtual StatusOr<int64_t> GetScratchSize(int64_t num_items) = 0;
+  // Returns the scratch size needed to sort `batch_size` rows holding
+  // `num_items` elements in total.
+  virtual StatusOr<int64_t> GetScratchSize(int64_t num_items,
+                                           int64_t batch_size) = 0;
 
   static StatusOr<std::unique_ptr<CubSortRunnerInterface>> Create(
       PrimitiveType type, std::optional<PrimitiveType> value_type);
@@ -53,7 +57,8 @@ class CubSortThunk : public Thunk {
                std::optional<PrimitiveType> value_type,
                std::vector<BufferAllocation::Slice> operands,
                std::vector<BufferAllocation::Slice> results,
-               BufferAllocation::Slice scratch, bool descending);
+               BufferAllocation::Slice scratch, bool descending,
+               int64_t batch_size);
 
   Status ExecuteOnStream(const ExecuteParams& params) override {
     return runner_->Run(params, this);
@@ -63,6 +68,7 @@ class CubSortThunk : public Thunk {
   BufferAllocation::Slice result(int i) const { return results_[i]; }
   BufferAllocation::Slice scratch() const { return scratch_; }
   bool descending() const { return descending_; }
+  int64_t batch_size() const { return batch_size_; }
 
  private:
   std::unique_ptr<CubSortRunnerInterface> runner_;
@@ -70,6 +76,7 @@ class CubSortThunk : public Thunk {
   std::vector<BufferAllocation::Slice> results_;
   BufferAllocation::Slice scratch_;
   bool descending_;
+  int64_t batch_size_;
 };
 
 Status RunCubSort(PrimitiveType type, std::optional<PrimitiveType> value_type,
@@ -77,7 +84,8 @@ Status RunCubSort(PrimitiveType type, std::optional<PrimitiveType> value_type,
                   se::DeviceMemoryBase input_values,
                   se::DeviceMemoryBase output_keys,
                   se::DeviceMemoryBase output_values,
-                  se::DeviceMemoryBase scratch, bool descending);
+                  se::DeviceMemoryBase scratch, bool descending,
+                  int64_t batch_size);
 
 }  // namespace gpu
 }  // namespace xla
@@ -92,6 +92,7 @@ limitations under the License.
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/buffer_value.h"
 #include "xla/service/call_inliner.h"
+#include "xla/service/collective_combiner_utils.h"
 #include "xla/service/collective_permute_decomposer.h"
 #include "xla/service/collective_pipeliner.h"
 #include "xla/service/collectives_schedule_linearizer.h"
@@ -123,6 +124,7 @@ limitations under the License.
 #include "xla/service/gpu/all_reduce_blueconnect.h"
 #include "xla/service/gpu/autotuner_util.h"
 #include "xla/service/gpu/command_buffer_scheduling.h"
+#include "xla/service/gpu/collective_combine_threshold.h"
 #include "xla/service/gpu/compile_module_to_llvm_ir.h"
 #include "xla/service/gpu/conv_layout_normalization.h"
 #include "xla/service/gpu/copy_fusion.h"
@@ -148,6 +150,7 @@ limitations under the License.
 #include "xla/service/gpu/gpu_scatter_expander.h"
 #include "xla/service/gpu/hlo_fusion_stats.h"
 #include "xla/service/gpu/horizontal_loop_fusion.h"
+#include "xla/service/gpu/host_offload_analysis.h"
 #include "xla/service/gpu/ir_emission_utils.h"
 #include "xla/service/gpu/ir_emitter_context.h"
 #include "xla/service/gpu/ir_emitter_unnested.h"
@@ -535,6 +538,34 @@ void SetInstructionMetadata(HloModule* module) {
     }
   }
 }
+
+// Rough roofline of the GPU used by the SPMD partitioner to decide whether a
+// windowed einsum hides its collective behind the partial dots.
+spmd::SpmdPartitionerOptions::WindowedEinsumCostModel
+GetWindowedEinsumCostModel(const se::DeviceDescription& device_description) {
+  // Dense matmul throughput relative to FMA throughput of the CUDA cores.
+  double tensor_core_speedup = 1.0;
+  // NCCL ring bandwidth per GPU within a node, in GB/s.
+  double collective_gbps = 39.0;
+  if (const auto* cuda_cc = std::get_if<se::CudaComputeCapability>(
+          &device_description.gpu_compute_capability())) {
+    if (cuda_cc->IsAtLeastAmpere()) {
+      tensor_core_speedup = 16.0;
+      collective_gbps = 87.7;
+    } else if (cuda_cc->IsAtLeastVolta()) {
+      tensor_core_speedup = 8.0;
+    }
+  }
+  spmd::SpmdPartitionerOptions::WindowedEinsumCostModel cost_model;
+  cost_model.device_flops_per_second =
+      2.0 * device_description.core_count() *
+      device_description.fpus_per_core() *
+      device_description.clock_rate_ghz() * 1e9 * tensor_core_speedup;
+  cost_model.device_bytes_per_second = device_description.memory_bandwidth();
+  cost_model.collective_bytes_per_second = collective_gbps * 1e9;
+  cost_model.collective_latency_in_us = 10.0;
+  return cost_model;
+}
 }  // namespace
 
 // Runs optimization passes on the given HLO module.
@@ -682,9 +713,17 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
     spmd_pipeline.AddPass<ShardingPropagation>(
         /*is_spmd=*/true, /*propagate_metadata=*/false,
         hlo_module->config().allow_spmd_sharding_propagation_to_output());
-    spmd_pipeline.AddPass<spmd::StatefulRngSpmdPartitioner>(
-        num_partitions, hlo_module->config().replica_count(),
-        debug_options.xla_gpu_threshold_for_windowed_einsum_mib());
+    if (debug_options.xla_gpu_windowed_einsum_cost_model()) {
+      // Let the cost model decide for every size.
+      spmd_pipeline.AddPass<spmd::StatefulRngSpmdPartitioner>(
+          num_partitions, hlo_module->config().replica_count(),
+          /*threshold_for_windowed_einsum_mib=*/0,
+          GetWindowedEinsumCostModel(gpu_target_config.device_description));
+    } else {
+      spmd_pipeline.AddPass<spmd::StatefulRngSpmdPartitioner>(
+          num_partitions, hlo_module->config().replica_count(),
+          debug_options.xla_gpu_threshold_for_windowed_einsum_mib());
+    }
     spmd_pipeline.AddPass<CollectivePermuteMotion>();
     TF_RETURN_IF_ERROR(spmd_pipeline.Run(hlo_module).status());
   } else {
@@ -706,7 +745,7 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
       const auto* cuda_cc = std::get_if<se::CudaComputeCapability>(
           &gpu_target_config.device_description.gpu_compute_capability());
       if (cuda_cc != nullptr &&
-          !cuda_cc->IsAtLeast(se::CudaComputeCapability::VOLTA)) {
+          !cuda_cc->IsAtLeastVolta()) {
         return true;
       }
       return !gpu::IsMatrixMultiplication(*instr);
@@ -816,14 +855,18 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
       pipeline.AddPass<ScatterExpander>(
           ScatterExpander::kEliminateSimpleScatters);
       pipeline.AddPass<ScatterSliceSimplifier>();
-      pipeline.AddPass<AlgebraicSimplifier>(layout_insensitive_algsimp_opts);
+      pipeline.AddPass<AlgebraicSimplifier>(layout_insensitive_algsimp_opts,
+                                            thread_pool.get());
       pipeline.AddPass<BitcastDtypesExpander>();
       // AlgebraicSimplifier may add contracting dimensions to a dot.
       pipeline.AddPass<DotDimensionSorter>();
       pipeline.AddPass<DotDecomposer>();
       // Only merge "smallish" dots.  This threshold was not set carefully, but
       // so far we know that 1mb is too small.
-      pipeline.AddPass<DotMerger>(/*max_size_to_merge=*/int64_t{16} << 20);
+      pipeline.AddPass<DotMerger>(
+          /*max_size_to_merge=*/int64_t{16} << 20,
+          /*merge_independent_dots=*/
+          debug_options.xla_gpu_merge_independent_dots());
       pipeline.AddPass<SortSimplifier>();
       pipeline.AddPass<TupleSimplifier>();
       pipeline.AddPass<WhileLoopConstantSinking>();
@@ -848,7 +891,8 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
     [&, &pipeline =
             pipeline.AddPass<HloPassFix<HloPassPipeline>>("simplification-2")] {
       pipeline.AddPass<ConvertMover>();
-      pipeline.AddPass<AlgebraicSimplifier>(layout_insensitive_algsimp_opts);
+      pipeline.AddPass<AlgebraicSimplifier>(layout_insensitive_algsimp_opts,
+                                            thread_pool.get());
     }();
 
     pipeline.AddPass<HloComputationDeduplicator>(
@@ -1032,17 +1076,35 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
 
   {
     HloPassPipeline pipeline("post-fusion optimization");
+    // Collectives whose replica groups cross nodes use the inter-node
+    // threshold instead of the per-collective one.
+    auto combine_threshold_fn =
+        [&](int64_t intra_node_threshold_bytes) -> CombineThresholdBytesFn {
+      if (debug_options.xla_gpu_collective_combine_devices_per_node() <= 0) {
+        return nullptr;
+      }
+      return TopologyAwareCombineThreshold(
+          intra_node_threshold_bytes,
+          debug_options.xla_gpu_inter_node_combine_threshold_bytes(),
+          debug_options.xla_gpu_collective_combine_devices_per_node());
+    };
     pipeline.AddPass<AllGatherCombiner>(
         debug_options.xla_gpu_all_gather_combine_threshold_bytes(),
         /*combine_threshold_count=*/256,
-        debug_options.xla_gpu_enable_all_gather_combine_by_dim());
+        debug_options.xla_gpu_enable_all_gather_combine_by_dim(),
+        combine_threshold_fn(
+            debug_options.xla_gpu_all_gather_combine_threshold_bytes()));
     pipeline.AddPass<AllReduceCombiner>(
         debug_options.xla_gpu_all_reduce_combine_threshold_bytes(),
-        /*combine_threshold_count=*/256);
+        /*combine_threshold_count=*/256,
+        combine_threshold_fn(
+            debug_options.xla_gpu_all_reduce_combine_threshold_bytes()));
     pipeline.AddPass<ReduceScatterCombiner>(
         debug_options.xla_gpu_reduce_scatter_combine_threshold_bytes(),
         /*combine_threshold_count=*/256,
-        debug_options.xla_gpu_enable_reduce_scatter_combine_by_dim());
+        debug_options.xla_gpu_enable_reduce_scatter_combine_by_dim(),
+        combine_threshold_fn(
+            debug_options.xla_gpu_reduce_scatter_combine_threshold_bytes()));
 
     if (debug_options.xla_gpu_all_reduce_contiguous()) {
       pipeline.AddPass<AllReduceContiguous>();
@@ -1209,7 +1271,8 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
 
     // The LayoutAssignment pass may leave behind kCopy instructions which are
     // duplicate or NOPs, so remove them with algebraic simplification and CSE.
-    pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options);
+    pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options,
+                                                       thread_pool);
 
     // GemmRewriter assumes that all transposes are folded into gemms, but,
     // since commit 7d529df, this is not always true at this point.
@@ -1240,7 +1303,7 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
         gpu_target_config.device_description.gpu_compute_capability();
     const auto* cuda_cc = std::get_if<se::CudaComputeCapability>(&gpu_version);
     if (debug_options.xla_gpu_enable_triton_gemm() && cuda_cc != nullptr &&
-        cuda_cc->IsAtLeast(se::CudaComputeCapability::VOLTA)) {
+        cuda_cc->IsAtLeastVolta()) {
       pipeline.AddPass<GemmRewriterTriton>(gpu_version);
     }
     pipeline.AddPass<GemmRewriter>(gpu_version);
@@ -1250,7 +1313,8 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
 
     if (debug_options.xla_gpu_normalize_layouts()) {
       pipeline.AddPass<LayoutNormalization>(&NormalizeLayoutForGpuCustomCalls);
-      pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options);
+      pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options,
+                                                       thread_pool);
     }
     pipeline.AddPass<BroadcastCanonicalizer>();
 
@@ -1262,8 +1326,9 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
     // harder.
     if (debug_options.xla_gpu_enable_triton_softmax_fusion() &&
         cuda_cc != nullptr &&
-        cuda_cc->IsAtLeast(se::CudaComputeCapability::VOLTA)) {
-      pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options);
+        cuda_cc->IsAtLeastVolta()) {
+      pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options,
+                                                       thread_pool);
       pipeline.AddPass<SoftmaxRewriterTriton>(gpu_version);
     }
 
@@ -1316,7 +1381,8 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
 
   // The LayoutAssignment pass may leave behind kCopy instructions which are
   // duplicate or NOPs, so remove them with algebraic simplification and CSE.
-  pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options);
+  pipeline.AddPass<HloPassFix<AlgebraicSimplifier>>(simplifier_options,
+                                                     thread_pool);
 
   if (debug_options.xla_gpu_simplify_all_fp_conversions()) {
     // This pass cleans up chains of compiler-generated converts
@@ -1731,6 +1797,21 @@ GpuCompiler::CompileToBackendResult(
   TF_RETURN_IF_ERROR(ScheduleGpuModule(module, pointer_size_,
                                        scheduler_mem_limit, gpu_device_info));
 
+  if (module->config().debug_options().xla_gpu_analyze_host_offloading()) {
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<HostOffloadAnalysis> host_offload_analysis,
+        HostOffloadAnalysis::Run(*module, HostOffloadAnalysis::Options(),
+                                 ShapeSizeBytesFunction()));
+    LOG(INFO) << "Module " << module->name() << " has "
+              << host_offload_analysis->candidates().size()
+              << " host offload candidates holding "
+              << host_offload_analysis->offloadable_bytes() << " bytes";
+    if (DumpingEnabledForHloModule(*module)) {
+      DumpToFileInDirOrStdout(*module, "", "host_offload_candidates.txt",
+                              host_offload_analysis->ToString());
+    }
+  }
+
   TF_RETURN_IF_ERROR(RunPostSchedulingPipelines(module, scheduler_mem_limit));
 
   TF_ASSIGN_OR_RETURN(se::Platform * platform,
@@ -652,6 +652,12 @@ Status ScheduleGpuModule(HloModule* module, int64_t pointer_size,
   }
 
   SchedulerConfig config = GetSchedulerConfig(memory_limit);
+  if (module->config().debug_options().xla_gpu_lhs_strict_memory_limit()) {
+    config.strict_memory_limit = true;
+    // Give the scheduler a few attempts with a tighter limit before it falls
+    // back to the input schedule.
+    config.rerun = 3;
+  }
   auto gpu_latency_estimator = std::make_unique<GpuLatencyEstimator>();
 
   std::unique_ptr<LatencyEstimator> latency_estimator;
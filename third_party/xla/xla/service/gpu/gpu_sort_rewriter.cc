@@ -31,6 +31,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/layout_util.h"
 #include "xla/service/gpu/cub_sort_thunk.h"
 #include "xla/service/gpu/cublas_cudnn.h"
 #include "xla/shape.h"
@@ -97,19 +98,42 @@ StatusOr<std::unique_ptr<CubSortRunnerInterface>> CreateRunner(
           : std::nullopt);
 }
 
-// Verify that the sort tensor shape is supported by CUB.
+// Returns the number of rows that are sorted independently.
+int64_t GetBatchSize(const HloSortInstruction* sort_op) {
+  const Shape& shape = sort_op->operand(0)->shape();
+  return ShapeUtil::ElementsIn(shape) /
+         shape.dimensions(sort_op->sort_dimension());
+}
+
+// Verify that the sort tensor shape is supported by CUB, and that sorting it
+// with CUB is expected to be faster than the XLA sort emitter.
 bool IsCubCompatibleSort(HloSortInstruction* sort_op) {
   VLOG(1) << "Sort instruction: " << sort_op->name();
   if (sort_op->operand_count() != 1 && sort_op->operand_count() != 2) {
     VLOG(2) << "Unsupported operand count: " << sort_op->operand_count();
     return false;
   }
-  if (sort_op->operand(0)->shape().rank() != 1) {
-    VLOG(2) << "Only 1D shapes are supported";
-    return false;
+  const Shape& shape = sort_op->operand(0)->shape();
+  if (shape.rank() > 1) {
+    // Rows are sorted with a segmented sort, which requires each of them to
+    // be contiguous in memory.
+    for (const HloInstruction* operand : sort_op->operands()) {
+      if (!operand->shape().has_layout() ||
+          LayoutUtil::Minor(operand->shape().layout(), 0) !=
+              sort_op->sort_dimension()) {
+        VLOG(2) << "Only sorts along the most minor dimension are supported";
+        return false;
+      }
+    }
+    int64_t row_size = shape.dimensions(sort_op->sort_dimension());
+    if (row_size < GpuSortRewriter::kMinSegmentSize ||
+        row_size > GpuSortRewriter::kMaxSegmentSize) {
+      VLOG(2) << "Row size is outside of the range where a segmented sort "
+                 "is expected to see an improvement";
+      return false;
+    }
   }
-  if (sort_op->operand(0)->shape().dimensions(0) <
-      GpuSortRewriter::kSortSizeThreshold) {
+  if (ShapeUtil::ElementsIn(shape) < GpuSortRewriter::kSortSizeThreshold) {
     VLOG(2) << "Tensor shape size is too small to see an improvement";
     return false;
   }
@@ -154,7 +178,9 @@ StatusOr<bool> GpuSortRewriter::RunOnInstruction(HloSortInstruction* sort_op) {
   TF_ASSIGN_OR_RETURN(auto runner, CreateRunner(sort_op, sort_config));
   TF_ASSIGN_OR_RETURN(
       int64_t scratch_size,
-      runner->GetScratchSize(sort_op->operand(0)->shape().dimensions(0)));
+      runner->GetScratchSize(
+          ShapeUtil::ElementsIn(sort_op->operand(0)->shape()),
+          GetBatchSize(sort_op)));
 
   // Values are only present if sorting a pair of tensors.
   HloInstruction* keys = sort_op->mutable_operand(0);
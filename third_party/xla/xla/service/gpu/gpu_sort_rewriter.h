@@ -30,6 +30,9 @@ namespace gpu {
 // Rewrites sort operations into CustomCall HLOs that call into CUB.
 // Only a subset of shapes is supported - either a single tensor with a simple
 // compare function or a pair of tensors where keys are unsigned integers.
+// Tensors of rank higher than one are supported when they are sorted along
+// their most minor dimension, in which case each row is sorted separately with
+// a segmented radix sort.
 
 class GpuSortRewriter : public HloModulePass {
  public:
@@ -39,6 +42,13 @@ class GpuSortRewriter : public HloModulePass {
   // tensors with sizes below this limit.
   static constexpr int kSortSizeThreshold = 100000;
 
+  // Segmented sort runs a thread block per row. Short rows are handled well by
+  // the XLA sort emitter, which sorts them in shared memory, and very long
+  // rows leave most of the GPU idle unless there are many of them, so only
+  // rewrite batched sorts with row sizes in this range.
+  static constexpr int kMinSegmentSize = 128;
+  static constexpr int kMaxSegmentSize = 16384;
+
   using HloPassInterface::Run;
   StatusOr<bool> Run(
       HloModule* module,
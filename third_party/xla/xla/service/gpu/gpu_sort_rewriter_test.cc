@@ -204,7 +204,7 @@ ENTRY %main {
   EXPECT_FALSE(RunPass(module.get()));
 }
 
-// Only 1D shapes are supported.
+// Only sorts along the most minor dimension are supported.
 TEST_F(GpuSortRewriterTest, NoRewriteManyDimensions) {
   constexpr char kHlo[] = R"(
 HloModule TestModule
@@ -309,6 +309,73 @@ ENTRY %main {
   EXPECT_FALSE(RunPass(module.get()));
 }
 
+// Batched rows are sorted with a segmented sort.
+TEST_F(GpuSortRewriterTest, SortKeysBatchedRows) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs = f32[] parameter(0)
+  %rhs = f32[] parameter(1)
+  ROOT %gt = pred[] compare(%lhs, %rhs), direction=GT
+}
+
+ENTRY %main {
+  %input = f32[1000,256] parameter(0)
+  ROOT %sort = f32[1000,256] sort(%input), dimensions={1}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunPass(module.get()));
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::GetTupleElement(
+          m::CustomCall({kCubDeviceRadixSortTarget}, m::Parameter()), 0)));
+  ExpectDirection(module->entry_computation()->root_instruction()->operand(0),
+                  /*descending=*/true);
+}
+
+// Rows must be contiguous in memory.
+TEST_F(GpuSortRewriterTest, NoRewriteBatchedRowsNonMinorDimension) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs = f32[] parameter(0)
+  %rhs = f32[] parameter(1)
+  ROOT %lt = pred[] compare(%lhs, %rhs), direction=LT
+}
+
+ENTRY %main {
+  %input = f32[1000,256]{0,1} parameter(0)
+  ROOT %sort = f32[1000,256]{0,1} sort(%input), dimensions={1},
+      to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_FALSE(RunPass(module.get()));
+}
+
+// Short rows are left to the XLA sort emitter.
+TEST_F(GpuSortRewriterTest, NoRewriteBatchedShortRows) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs = f32[] parameter(0)
+  %rhs = f32[] parameter(1)
+  ROOT %lt = pred[] compare(%lhs, %rhs), direction=LT
+}
+
+ENTRY %main {
+  %input = f32[10000,32] parameter(0)
+  ROOT %sort = f32[10000,32] sort(%input), dimensions={1}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_FALSE(RunPass(module.get()));
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -0,0 +1,133 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/host_offload_analysis.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/hlo/utils/hlo_live_range.h"
+#include "xla/service/hlo_alias_analysis.h"
+#include "xla/service/hlo_value.h"
+#include "xla/statusor.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+std::string HostOffloadAnalysis::Candidate::ToString() const {
+  return absl::StrFormat("%s: %d bytes, idle between %d and %d",
+                         value->ToShortString(), bytes, offload_time,
+                         prefetch_time);
+}
+
+/*static*/ StatusOr<std::unique_ptr<HostOffloadAnalysis>>
+HostOffloadAnalysis::Run(
+    const HloModule& module, const Options& options,
+    const HloCostAnalysis::ShapeSizeFunction& shape_size) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloAliasAnalysis> alias_analysis,
+                      HloAliasAnalysis::Run(&module));
+  const HloComputation* entry = module.entry_computation();
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<HloLiveRange> live_range,
+      HloLiveRange::Run(module.schedule(), *alias_analysis, entry));
+  std::unique_ptr<HostOffloadAnalysis> analysis(new HostOffloadAnalysis(
+      std::move(alias_analysis), std::move(live_range)));
+
+  const auto& schedule = analysis->live_range_->instruction_schedule();
+  for (const HloValue* value :
+       analysis->alias_analysis_->dataflow_analysis().values()) {
+    const HloInstruction* producer = value->defining_instruction();
+    // Parameters and constants are not activations, and their device copy
+    // has to stay alive anyway.
+    if (producer->parent() != entry ||
+        producer->opcode() == HloOpcode::kParameter ||
+        producer->opcode() == HloOpcode::kConstant ||
+        !value->shape().IsArray()) {
+      continue;
+    }
+    // Buffers shared by several values (e.g. loop carried state) are updated
+    // in place and cannot be moved as a whole.
+    if (analysis->alias_analysis_->GetBufferContainingValue(*value)
+            .values()
+            .size() > 1) {
+      continue;
+    }
+    const int64_t bytes = shape_size(value->shape());
+    if (bytes < options.min_bytes) {
+      continue;
+    }
+
+    std::vector<int64_t> access_times = {schedule.at(producer)};
+    for (const HloUse& use : value->GetUses()) {
+      auto it = schedule.find(use.instruction);
+      if (it != schedule.end()) {
+        access_times.push_back(it->second);
+      }
+    }
+    absl::c_sort(access_times);
+
+    // Offload during the longest stretch without accesses.
+    int64_t offload_time = 0;
+    int64_t prefetch_time = 0;
+    for (int64_t i = 1; i < access_times.size(); ++i) {
+      if (access_times[i] - access_times[i - 1] >
+          prefetch_time - offload_time) {
+        offload_time = access_times[i - 1];
+        prefetch_time = access_times[i];
+      }
+    }
+    if (prefetch_time - offload_time < options.min_idle_time) {
+      continue;
+    }
+    analysis->candidates_.push_back(
+        Candidate{value, bytes, offload_time, prefetch_time});
+  }
+
+  absl::c_stable_sort(analysis->candidates_,
+                      [](const Candidate& a, const Candidate& b) {
+                        return a.bytes > b.bytes;
+                      });
+  return analysis;
+}
+
+int64_t HostOffloadAnalysis::offloadable_bytes() const {
+  int64_t bytes = 0;
+  for (const Candidate& candidate : candidates_) {
+    bytes += candidate.bytes;
+  }
+  return bytes;
+}
+
+std::string HostOffloadAnalysis::ToString() const {
+  std::string result =
+      absl::StrCat("Host offload candidates: ", candidates_.size(), ", ",
+                   offloadable_bytes(), " bytes\n");
+  for (const Candidate& candidate : candidates_) {
+    absl::StrAppend(&result, "  ", candidate.ToString(), "\n");
+  }
+  return result;
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,91 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_HOST_OFFLOAD_ANALYSIS_H_
+#define XLA_SERVICE_GPU_HOST_OFFLOAD_ANALYSIS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/utils/hlo_live_range.h"
+#include "xla/service/hlo_alias_analysis.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/hlo_value.h"
+#include "xla/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+// Finds activations of a scheduled module that could be kept in pinned host
+// memory instead of device memory: buffers of the entry computation that are
+// not accessed for a long stretch of the schedule, typically produced in the
+// forward pass and consumed again in the backward pass. Such a buffer can be
+// copied to host after its last use before the gap and copied back before its
+// next use, freeing device memory for the duration of the gap.
+//
+// The GPU runtime has no host memory space yet, so this only reports the
+// candidates and the device memory they would free.
+class HostOffloadAnalysis {
+ public:
+  struct Options {
+    // Buffers smaller than this are not worth the transfer.
+    int64_t min_bytes = 1 << 20;
+    // Minimum number of scheduled instructions during which the buffer is not
+    // accessed. The transfers to and from host are overlapped with them.
+    int64_t min_idle_time = 16;
+  };
+
+  struct Candidate {
+    const HloValue* value;
+    int64_t bytes;
+    // Logical times in the flattened schedule: the buffer would be copied to
+    // host after `offload_time` and copied back before `prefetch_time`.
+    int64_t offload_time;
+    int64_t prefetch_time;
+
+    std::string ToString() const;
+  };
+
+  static StatusOr<std::unique_ptr<HostOffloadAnalysis>> Run(
+      const HloModule& module, const Options& options,
+      const HloCostAnalysis::ShapeSizeFunction& shape_size);
+
+  // Candidates ordered by decreasing size.
+  const std::vector<Candidate>& candidates() const { return candidates_; }
+
+  // Total device memory held by the candidates during their idle time.
+  int64_t offloadable_bytes() const;
+
+  std::string ToString() const;
+
+ private:
+  HostOffloadAnalysis(std::unique_ptr<HloAliasAnalysis> alias_analysis,
+                      std::unique_ptr<HloLiveRange> live_range)
+      : alias_analysis_(std::move(alias_analysis)),
+        live_range_(std::move(live_range)) {}
+
+  std::unique_ptr<HloAliasAnalysis> alias_analysis_;
+  std::unique_ptr<HloLiveRange> live_range_;
+  std::vector<Candidate> candidates_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_HOST_OFFLOAD_ANALYSIS_H_
@@ -0,0 +1,88 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/host_offload_analysis.h"
+
+#include <cstdint>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using HostOffloadAnalysisTest = HloTestBase;
+
+int64_t ShapeSize(const Shape& shape) {
+  return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+}
+
+constexpr absl::string_view kHloString = R"(
+HloModule m, is_scheduled=true
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  saved = f32[1024] exponential(p0)
+  n0 = f32[1024] negate(p0)
+  n1 = f32[1024] negate(n0)
+  n2 = f32[1024] negate(n1)
+  n3 = f32[1024] negate(n2)
+  n4 = f32[1024] negate(n3)
+  ROOT add = f32[1024] add(saved, n4)
+})";
+
+TEST_F(HostOffloadAnalysisTest, FindsBufferIdleAcrossSchedule) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HostOffloadAnalysis::Options options;
+  options.min_bytes = 1024;
+  options.min_idle_time = 4;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto analysis, HostOffloadAnalysis::Run(*module, options, ShapeSize));
+
+  ASSERT_EQ(analysis->candidates().size(), 1);
+  const HostOffloadAnalysis::Candidate& candidate = analysis->candidates()[0];
+  EXPECT_EQ(candidate.value->defining_instruction()->name(), "saved");
+  EXPECT_EQ(candidate.bytes, 4096);
+  EXPECT_EQ(candidate.prefetch_time - candidate.offload_time, 6);
+  EXPECT_EQ(analysis->offloadable_bytes(), 4096);
+}
+
+TEST_F(HostOffloadAnalysisTest, IgnoresSmallAndShortLivedBuffers) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HostOffloadAnalysis::Options options;
+  options.min_bytes = 8192;
+  options.min_idle_time = 4;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto analysis, HostOffloadAnalysis::Run(*module, options, ShapeSize));
+  EXPECT_TRUE(analysis->candidates().empty());
+
+  options.min_bytes = 1024;
+  options.min_idle_time = 7;
+  TF_ASSERT_OK_AND_ASSIGN(
+      analysis, HostOffloadAnalysis::Run(*module, options, ShapeSize));
+  EXPECT_TRUE(analysis->candidates().empty());
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
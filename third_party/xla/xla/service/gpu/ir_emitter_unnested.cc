@@ -1534,13 +1534,22 @@ Status IrEmitterUnnested::EmitCubDeviceRadixSort(mlir::Operation* op) {
   TF_ASSIGN_OR_RETURN(BufferAllocation::Slice scratch,
                       GetAllocationSlice(radix_sort_op.getScratch()));
 
+  // Higher-rank inputs are sorted along their most minor dimension, so every
+  // other dimension contributes a row to sort separately.
+  const Shape keys_shape = GetShape(op->getOperand(0));
+  int64_t batch_size = 1;
+  if (keys_shape.rank() > 1) {
+    int64_t sort_dimension = LayoutUtil::Minor(keys_shape.layout(), 0);
+    batch_size = ShapeUtil::ElementsIn(keys_shape) /
+                 keys_shape.dimensions(sort_dimension);
+  }
+
   auto thunk = std::make_unique<CubSortThunk>(
-      Thunk::ThunkInfo::WithProfileAnnotation(op),
-      GetShape(op->getOperand(0)).element_type(),
+      Thunk::ThunkInfo::WithProfileAnnotation(op), keys_shape.element_type(),
       radix_sort_op.getInputs().size() == 2
           ? std::optional(GetShape(op->getOperand(1)).element_type())
           : std::nullopt,
-      operands, results, scratch, radix_sort_op.getDescending());
+      operands, results, scratch, radix_sort_op.getDescending(), batch_size);
 
   AddThunkToThunkSequence(std::move(thunk));
   return OkStatus();
@@ -60,15 +60,15 @@ LatencyEstimator::TimeCost AnalyticalLatencyEstimator::NodeCost(
     return kLowCost;
   }
 
-  absl::Duration total_estimated_time =
+  EstimateRunTimeData runtime_data =
       GpuPerformanceModel::EstimateRunTimeForInstruction(
           instr, &*cost_analysis_,
-          GpuPerformanceModelOptions::ForModule(instr->GetModule()))
-          .exec_time;
+          GpuPerformanceModelOptions::ForModule(instr->GetModule()));
   LatencyEstimator::TimeCost cost_in_us =
-      absl::ToDoubleMicroseconds(total_estimated_time);
+      absl::ToDoubleMicroseconds(runtime_data.exec_time);
   VLOG(10) << "Analytical estimator calculated cost for: " << instr->name()
-           << ". Cost: " << cost_in_us;
+           << ". Cost: " << cost_in_us
+           << ". Memory traffic: " << runtime_data.memory_traffic.ToString();
   return cost_in_us;
 }
 
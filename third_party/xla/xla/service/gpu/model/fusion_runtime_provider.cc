@@ -0,0 +1,88 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/fusion_runtime_provider.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/gpu/hlo_traversal.h"
+#include "xla/service/gpu/model/fusion_runtime_profile.pb.h"
+#include "xla/statusor.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
+
+namespace xla::gpu {
+
+uint64_t FusionRuntimeFingerprint(const HloFusionAdaptor& fusion) {
+  std::vector<HloInstructionAdaptor> nodes;
+  absl::flat_hash_map<HloInstructionAdaptor, int64_t> node_ids;
+  auto roots = fusion.GetRoots();
+  HloBfsConsumersFirstTraversal(roots, fusion, [&](HloInstructionAdaptor node) {
+    node_ids[node] = nodes.size();
+    nodes.push_back(node);
+    return TraversalResult::kVisitOperands;
+  });
+
+  // Instructions are printed without names, so the edges are encoded as the
+  // traversal positions of the operands. Operands outside of the fusion are
+  // only identified by their shape, which is already part of the printout.
+  std::string key = absl::StrCat(roots.size());
+  for (const HloInstructionAdaptor& node : nodes) {
+    absl::StrAppend(
+        &key, "\n",
+        node.instruction().ToString(HloPrintOptions::Fingerprint()), " <-");
+    for (const HloInstructionAdaptor& operand : node.GetOperands()) {
+      auto it = node_ids.find(operand);
+      absl::StrAppend(&key, " ", it == node_ids.end() ? -1 : it->second);
+    }
+  }
+  return tsl::Fingerprint64(key);
+}
+
+MeasuredFusionRuntimes::MeasuredFusionRuntimes(
+    const FusionRuntimeProfile& profile)
+    : device_name_(profile.device_name()) {
+  for (const FusionRuntimeProfileEntry& entry : profile.entries()) {
+    runtimes_[entry.fingerprint()] = absl::Nanoseconds(entry.runtime_ns());
+  }
+}
+
+/*static*/ StatusOr<std::unique_ptr<MeasuredFusionRuntimes>>
+MeasuredFusionRuntimes::LoadFromFile(const std::string& path) {
+  FusionRuntimeProfile profile;
+  TF_RETURN_IF_ERROR(
+      tsl::ReadTextOrBinaryProto(tsl::Env::Default(), path, &profile));
+  return std::make_unique<MeasuredFusionRuntimes>(profile);
+}
+
+std::optional<absl::Duration> MeasuredFusionRuntimes::GetRunTime(
+    const HloFusionAdaptor& fusion) const {
+  auto it = runtimes_.find(FusionRuntimeFingerprint(fusion));
+  if (it == runtimes_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+}  // namespace xla::gpu
@@ -0,0 +1,73 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_MODEL_FUSION_RUNTIME_PROVIDER_H_
+#define XLA_SERVICE_GPU_MODEL_FUSION_RUNTIME_PROVIDER_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "xla/service/gpu/hlo_traversal.h"
+#include "xla/service/gpu/model/fusion_runtime_profile.pb.h"
+#include "xla/statusor.h"
+
+namespace xla::gpu {
+
+// Returns a fingerprint of the instructions in `fusion` and the edges between
+// them. It doesn't depend on instruction names or ids, so an existing fusion
+// and a producer-consumer pair that would fuse into the same kernel have the
+// same fingerprint.
+uint64_t FusionRuntimeFingerprint(const HloFusionAdaptor& fusion);
+
+// Provides runtimes of fused kernels that override the estimates of the
+// analytical GPU performance model, e.g. runtimes measured by profiling.
+// Implementations must be thread-safe.
+class FusionRuntimeProvider {
+ public:
+  virtual ~FusionRuntimeProvider() = default;
+
+  // Returns the runtime of the kernel emitted for `fusion`, or nullopt if it is
+  // unknown and the analytical estimate should be used.
+  virtual std::optional<absl::Duration> GetRunTime(
+      const HloFusionAdaptor& fusion) const = 0;
+};
+
+// Looks up runtimes in a FusionRuntimeProfile by fusion fingerprint.
+class MeasuredFusionRuntimes : public FusionRuntimeProvider {
+ public:
+  explicit MeasuredFusionRuntimes(const FusionRuntimeProfile& profile);
+
+  // Reads a text or binary FusionRuntimeProfile from `path`.
+  static StatusOr<std::unique_ptr<MeasuredFusionRuntimes>> LoadFromFile(
+      const std::string& path);
+
+  const std::string& device_name() const { return device_name_; }
+  size_t size() const { return runtimes_.size(); }
+
+  std::optional<absl::Duration> GetRunTime(
+      const HloFusionAdaptor& fusion) const override;
+
+ private:
+  std::string device_name_;
+  absl::flat_hash_map<uint64_t, absl::Duration> runtimes_;
+};
+
+}  // namespace xla::gpu
+
+#endif  // XLA_SERVICE_GPU_MODEL_FUSION_RUNTIME_PROVIDER_H_
@@ -0,0 +1,126 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/fusion_runtime_provider.h"
+
+#include <cstdint>
+#include <optional>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
+#include "xla/service/gpu/hlo_traversal.h"
+#include "xla/service/gpu/model/fusion_runtime_profile.pb.h"
+#include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/gpu_performance_model.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+class FusionRuntimeProviderTest : public HloTestBase {};
+
+constexpr absl::string_view kHloString = R"(
+HloModule m
+
+fused_computation {
+  p0 = f32[1000] parameter(0)
+  exp = f32[1000] exponential(p0)
+  ROOT neg = f32[1000] negate(exp)
+}
+
+ENTRY e {
+  p0 = f32[1000] parameter(0)
+  exp = f32[1000] exponential(p0)
+  neg = f32[1000] negate(exp)
+  log = f32[1000] log(exp)
+  fusion = f32[1000] fusion(p0), kind=kLoop, calls=fused_computation
+  ROOT t = (f32[1000], f32[1000], f32[1000]) tuple(neg, log, fusion)
+})";
+
+TEST_F(FusionRuntimeProviderTest, ProducerConsumerMatchesFusion) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HloComputation* entry = module->entry_computation();
+  const HloInstruction* exp = entry->GetInstructionWithName("exp");
+  const HloInstruction* neg = entry->GetInstructionWithName("neg");
+  const HloInstruction* log = entry->GetInstructionWithName("log");
+  const HloInstruction* fusion = entry->GetInstructionWithName("fusion");
+
+  uint64_t fusion_fingerprint =
+      FusionRuntimeFingerprint(*HloFusionAdaptor::ForInstruction(fusion));
+  EXPECT_EQ(FusionRuntimeFingerprint(
+                ProducerConsumerFusion(HloFusionAdaptor::ForInstruction(exp),
+                                       HloFusionAdaptor::ForInstruction(neg))),
+            fusion_fingerprint);
+  EXPECT_NE(FusionRuntimeFingerprint(
+                ProducerConsumerFusion(HloFusionAdaptor::ForInstruction(exp),
+                                       HloFusionAdaptor::ForInstruction(log))),
+            fusion_fingerprint);
+  EXPECT_NE(FusionRuntimeFingerprint(*HloFusionAdaptor::ForInstruction(neg)),
+            fusion_fingerprint);
+}
+
+TEST_F(FusionRuntimeProviderTest, PerformanceModelUsesMeasuredRunTime) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HloComputation* entry = module->entry_computation();
+  const HloInstruction* fusion = entry->GetInstructionWithName("fusion");
+
+  FusionRuntimeProfile profile;
+  auto* entry_proto = profile.add_entries();
+  entry_proto->set_fingerprint(
+      FusionRuntimeFingerprint(*HloFusionAdaptor::ForInstruction(fusion)));
+  entry_proto->set_runtime_ns(500000);
+  MeasuredFusionRuntimes measured(profile);
+  EXPECT_EQ(measured.size(), 1);
+  EXPECT_EQ(measured.GetRunTime(*HloFusionAdaptor::ForInstruction(
+                entry->GetInstructionWithName("log"))),
+            std::nullopt);
+
+  se::DeviceDescription device_info{TestGpuDeviceInfo::RTXA6000DeviceInfo()};
+  GpuHloCostAnalysis analysis(
+      GpuHloCostAnalysis::Options{[](const Shape& shape) {
+                                    return ShapeUtil::ByteSizeOf(shape, 8);
+                                  },
+                                  /*per_second_rates=*/{},
+                                  /*count_multiple_input_accesses=*/true},
+      &device_info);
+  ASSERT_IS_OK(entry->Accept(&analysis));
+
+  GpuPerformanceModelOptions options = GpuPerformanceModelOptions::Default();
+  absl::Duration estimated_time =
+      GpuPerformanceModel::EstimateRunTimeForInstruction(fusion, &analysis,
+                                                         options)
+          .exec_time;
+  EXPECT_LT(estimated_time, absl::Microseconds(500));
+
+  options.fusion_runtime_provider = &measured;
+  EXPECT_EQ(GpuPerformanceModel::EstimateRunTimeForInstruction(
+                fusion, &analysis, options)
+                .exec_time,
+            absl::Microseconds(500));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -20,12 +20,14 @@ limitations under the License.
 #include <cstdint>
 #include <cstdlib>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "llvm/ADT/STLExtras.h"
@@ -96,13 +98,28 @@ int GetCoalescingWasteFactor(PrimitiveType element_type) {
 
 // Estimate read time of n_bytes_total bytes from global memory on a
 // given GPU. Account for L1 / L2 cache speedup if the input's nominal size
-// n_bytes_net is small.
+// n_bytes_net is small. If `traffic` is given, adds the bytes read from each
+// memory level to it.
 absl::Duration ReadTime(const se::DeviceDescription& gpu_device_info,
                         int64_t num_blocks, int64_t n_bytes_net,
                         int64_t n_bytes_total, PrimitiveType element_type,
-                        bool coalesced, bool first_read_from_dram) {
+                        bool coalesced, bool first_read_from_dram,
+                        MemoryTraffic* traffic = nullptr) {
   int waste_factor = coalesced ? 1 : GetCoalescingWasteFactor(element_type);
 
+  // Adds `n_bytes` read from the cache level that holds n_bytes_net bytes, or
+  // from DRAM if none does.
+  auto add_cached_traffic = [&](int64_t n_bytes) {
+    if (traffic == nullptr) return;
+    if (n_bytes_net < kL1CacheSizePerSM * gpu_device_info.core_count()) {
+      traffic->l1_bytes += n_bytes;
+    } else if (n_bytes_net < gpu_device_info.l2_cache_size()) {
+      traffic->l2_bytes += n_bytes;
+    } else {
+      traffic->dram_bytes += n_bytes * (coalesced ? 1 : waste_factor);
+    }
+  };
+
   // Limit the bandwidth for low occupancy cases. Each SM can issue at most
   // one 32B memory transaction per clock. H100 needs at least 56.8 active SMs
   // (1830 MHz) to saturate the memory bandwidth (3.35 TB/s).
@@ -138,6 +155,11 @@ absl::Duration ReadTime(const se::DeviceDescription& gpu_device_info,
     // Number of bytes that we be re-read, potentially from cache.
     int64_t n_bytes_read_cache = n_bytes_total - n_bytes_read_dram;
 
+    if (traffic != nullptr) {
+      traffic->dram_bytes += n_bytes_read_dram * waste_factor;
+    }
+    add_cached_traffic(n_bytes_read_cache);
+
     return absl::Seconds(n_bytes_read_dram / dram_bandwidth) +
            absl::Seconds(n_bytes_read_cache / rest_bandwidth);
   } else {
@@ -152,6 +174,7 @@ absl::Duration ReadTime(const se::DeviceDescription& gpu_device_info,
     }
 
     bandwidth = std::min(bandwidth, max_bandwidth);
+    add_cached_traffic(n_bytes_total);
     return absl::Seconds(n_bytes_total / bandwidth);
   }
 }
@@ -270,6 +293,12 @@ LaunchDimensions EstimateFusionLaunchDimensions(
 
 }  // namespace
 
+std::string MemoryTraffic::ToString() const {
+  return absl::StrFormat(
+      "DRAM: %d bytes, L2: %d bytes, L1: %d bytes, shared memory: %d bytes",
+      dram_bytes, l2_bytes, l1_bytes, shared_memory_bytes);
+}
+
 std::optional<EstimateRunTimeData> GpuPerformanceModelCache::Get(
     const HloInstruction& instruction) {
   absl::MutexLock lock(&mutex_);
@@ -357,13 +386,32 @@ GpuPerformanceModel::EstimateRunTimeForInstruction(
   int64_t num_threads = launch_dimensions.launch_bound();
 
   absl::Duration compute_time = ComputeTime(*device_info, flops, num_threads);
+  MemoryTraffic memory_traffic;
   absl::Duration read_time = ProducerInputAccessTime(
       cost_analysis, *device_info, launch_dimensions.num_blocks(),
-      /*producer=*/instr, fusion_analysis, config);
+      /*producer=*/instr, fusion_analysis, config, /*fused_consumer=*/nullptr,
+      &memory_traffic);
+  memory_traffic.dram_bytes += bytes_written;
+  // Tiled transposes write each tile to shared memory and read it back
+  // transposed.
+  if (fusion_analysis.has_value() &&
+      fusion_analysis->GetEmitterFusionKind() ==
+          HloFusionAnalysis::EmitterFusionKind::kTranspose) {
+    memory_traffic.shared_memory_bytes += 2 * bytes_written;
+  }
   absl::Duration write_time =
       absl::Seconds(1.0f * bytes_written / device_info->memory_bandwidth());
   absl::Duration exec_time = std::max(compute_time, read_time + write_time);
 
+  if (config.fusion_runtime_provider) {
+    if (auto measured_time = config.fusion_runtime_provider->GetRunTime(
+            *HloFusionAdaptor::ForInstruction(instr))) {
+      VLOG(8) << "Using measured run time " << *measured_time
+              << " instead of estimate " << exec_time;
+      exec_time = *measured_time;
+    }
+  }
+
   if (VLOG_IS_ON(8)) {
     LOG(INFO) << "FLOPs: " << flops;
     LOG(INFO) << "Bytes read: " << bytes_read;
@@ -372,9 +420,11 @@ GpuPerformanceModel::EstimateRunTimeForInstruction(
     LOG(INFO) << "Compute time: " << compute_time;
     LOG(INFO) << "Input read time: " << read_time;
     LOG(INFO) << "Output write time: " << write_time;
+    LOG(INFO) << "Memory traffic: " << memory_traffic.ToString();
   }
 
-  return {flops, bytes_written, num_threads, write_time, exec_time};
+  return {flops,      bytes_written, num_threads,
+          write_time, exec_time,     memory_traffic};
 }
 
 /*static*/ EstimateRunTimeData
@@ -485,7 +535,7 @@ float GetSharedUtilization(const GpuHloCostAnalysis* cost_analysis,
     const HloInstruction* producer,
     const std::optional<HloFusionAnalysis>& fusion_analysis,
     const GpuPerformanceModelOptions& config,
-    const HloInstruction* fused_consumer) {
+    const HloInstruction* fused_consumer, MemoryTraffic* traffic) {
   absl::Duration ret = absl::ZeroDuration();
   float producer_output_utilization =
       fused_consumer
@@ -525,7 +575,7 @@ float GetSharedUtilization(const GpuHloCostAnalysis* cost_analysis,
                           (producer_output_utilization - common_utilization);
     ret += ReadTime(gpu_device_info, num_blocks, /*n_bytes_net=*/n_bytes_net,
                     n_bytes_total, operand_shape.element_type(), coalesced,
-                    config.first_read_from_dram);
+                    config.first_read_from_dram, traffic);
   }
   return ret;
 }
@@ -613,6 +663,16 @@ absl::Duration GpuPerformanceModel::EstimateUnfusedExecTime(
           << " consumer: " << consumer->name();
   const se::DeviceDescription* device_info = cost_analysis->device_info_;
 
+  if (config.fusion_runtime_provider) {
+    ProducerConsumerFusion fusion(HloFusionAdaptor::ForInstruction(producer),
+                                  HloFusionAdaptor::ForInstruction(consumer));
+    if (auto measured_time =
+            config.fusion_runtime_provider->GetRunTime(fusion)) {
+      VLOG(8) << "Using measured fused run time " << *measured_time;
+      return *measured_time;
+    }
+  }
+
   int64_t fused_flops = producer_runtime.flops * utilization_by_this_consumer +
                         consumer_runtime.flops;
 
@@ -812,7 +872,13 @@ void GpuPerformanceModel::RecordEstimatedRunTime(
 
   auto backend_config = instruction->backend_config<FusionBackendConfig>();
   TF_CHECK_OK(backend_config.status()) << instruction->ToString();
-  backend_config->mutable_reification_cost()->set_end_to_end_cycles(cycles);
+  ReificationCost* reification_cost = backend_config->mutable_reification_cost();
+  reification_cost->set_end_to_end_cycles(cycles);
+  reification_cost->set_dram_bytes(data.memory_traffic.dram_bytes);
+  reification_cost->set_l2_bytes(data.memory_traffic.l2_bytes);
+  reification_cost->set_l1_bytes(data.memory_traffic.l1_bytes);
+  reification_cost->set_shared_memory_bytes(
+      data.memory_traffic.shared_memory_bytes);
   TF_CHECK_OK(instruction->set_backend_config(*backend_config));
 
   VLOG(8) << "RecordEstimatedRunTime: " << instruction->ToString();
@@ -17,6 +17,8 @@ limitations under the License.
 #define XLA_SERVICE_GPU_MODEL_GPU_PERFORMANCE_MODEL_H_
 
 #include <array>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -25,6 +27,7 @@ limitations under the License.
 #include "xla/service/gpu/hlo_fusion_analysis.h"
 #include "xla/service/gpu/hlo_traversal.h"
 #include "xla/service/gpu/model/fusion_analysis_cache.h"
+#include "xla/service/gpu/model/fusion_runtime_provider.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/stream_executor/device_description.h"
 
@@ -49,12 +52,34 @@ NVML_FUNCTOR(nvmlDeviceGetNvLinkCapability, nvmlReturn_t,
 namespace xla {
 namespace gpu {
 
+// Bytes a kernel is estimated to move between the SMs and each level of the
+// memory hierarchy.
+struct MemoryTraffic {
+  // Includes the part of the DRAM transactions wasted by uncoalesced reads.
+  int64_t dram_bytes = 0;
+  // Re-reads of buffers small enough to stay in the L2 or L1 cache.
+  int64_t l2_bytes = 0;
+  int64_t l1_bytes = 0;
+  // Tiles staged through shared memory, e.g. by transpose emitters.
+  int64_t shared_memory_bytes = 0;
+
+  MemoryTraffic& operator+=(const MemoryTraffic& other) {
+    dram_bytes += other.dram_bytes;
+    l2_bytes += other.l2_bytes;
+    l1_bytes += other.l1_bytes;
+    shared_memory_bytes += other.shared_memory_bytes;
+    return *this;
+  }
+  std::string ToString() const;
+};
+
 struct EstimateRunTimeData {
   int64_t flops;
   int64_t bytes_written;
   int64_t num_threads;
   absl::Duration write_time;
   absl::Duration exec_time;
+  MemoryTraffic memory_traffic;
 };
 
 class GpuPerformanceModelCache {
@@ -107,19 +132,25 @@ struct GpuPerformanceModelOptions {
 
   GpuPerformanceModelCache* gpu_performance_model_cache = nullptr;
 
+  // If present, runtimes known to this provider replace the analytical
+  // estimates of individual and producer-consumer fusions.
+  const FusionRuntimeProvider* fusion_runtime_provider = nullptr;
+
   static GpuPerformanceModelOptions Default() {
     return GpuPerformanceModelOptions();
   }
 
   static GpuPerformanceModelOptions PriorityFusion(
       HloFusionAnalysisCache* fusion_analysis_cache,
-      GpuPerformanceModelCache* gpu_performance_model_cache) {
+      GpuPerformanceModelCache* gpu_performance_model_cache,
+      const FusionRuntimeProvider* fusion_runtime_provider = nullptr) {
     GpuPerformanceModelOptions config;
     config.consider_coalescing = true;
     config.first_read_from_dram = true;
     config.calculate_full_priority = true;
     config.fusion_analysis_cache = fusion_analysis_cache;
     config.gpu_performance_model_cache = gpu_performance_model_cache;
+    config.fusion_runtime_provider = fusion_runtime_provider;
     return config;
   }
 
@@ -194,7 +225,8 @@ class GpuPerformanceModel {
       const HloInstruction* producer,
       const std::optional<HloFusionAnalysis>& fusion_analysis,
       const GpuPerformanceModelOptions& config,
-      const HloInstruction* fused_consumer = nullptr);
+      const HloInstruction* fused_consumer = nullptr,
+      MemoryTraffic* traffic = nullptr);
 };
 
 class GpuPerformanceWithCollectiveModel : public GpuPerformanceModel {
@@ -184,6 +184,42 @@ ENTRY e {
   EXPECT_NEAR(absl::ToInt64Microseconds(t.time_unfused), 118, 12);
 }
 
+TEST_F(GpuPerformanceModelTest, MemoryTrafficPerLevel) {
+  absl::string_view hlo_string = R"(
+HloModule m
+
+f {
+  p0 = f32[10000] parameter(0)
+  bc0 = f32[10000,1000] broadcast(p0), dimensions={0}
+  b0 = f32[10000000] bitcast(bc0)
+  p1 = f32[10000000] parameter(1)
+  ROOT a0 = f32[10000000] add(b0, p1)
+}
+
+ENTRY e {
+  p0 = f32[10000] parameter(0)
+  p1 = f32[10000000] parameter(1)
+  ROOT r.1 = f32[10000000] fusion(p0, p1), kind=kLoop, calls=f
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  ASSERT_IS_OK(root->Accept(&analysis_));
+
+  GpuPerformanceModelOptions options = GpuPerformanceModelOptions::Default();
+  options.first_read_from_dram = true;
+  EstimateRunTimeData data =
+      GpuPerformanceModel::EstimateRunTimeForInstruction(root, &analysis_,
+                                                         options);
+  // Parameter 1 and the output go through DRAM, parameter 0 is read from DRAM
+  // once and then re-read from L1.
+  EXPECT_EQ(data.memory_traffic.dram_bytes, 80000000 + 40000);
+  EXPECT_EQ(data.memory_traffic.l2_bytes, 0);
+  EXPECT_EQ(data.memory_traffic.l1_bytes, 40000000 - 40000);
+  EXPECT_EQ(data.memory_traffic.shared_memory_bytes, 0);
+}
+
 TEST_F(GpuPerformanceModelTest, L2CacheEffect) {
   absl::string_view hlo_string = R"(
 HloModule m
@@ -23,6 +23,7 @@ limitations under the License.
 #include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -44,6 +45,8 @@ limitations under the License.
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/hlo_traversal.h"
 #include "xla/service/gpu/model/fusion_analysis_cache.h"
+#include "xla/service/gpu/model/fusion_runtime_profile.pb.h"
+#include "xla/service/gpu/model/fusion_runtime_provider.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/model/gpu_performance_model.h"
 #include "xla/service/instruction_fusion.h"
@@ -121,12 +124,14 @@ class GpuPriorityFusionQueue : public FusionQueue {
       const se::DeviceDescription* device_info,
       FusionProcessDumpProto* fusion_process_dump,
       tsl::thread::ThreadPool* thread_pool,
-      HloFusionAnalysisCache& fusion_analysis_cache)
+      HloFusionAnalysisCache& fusion_analysis_cache,
+      const FusionRuntimeProvider* fusion_runtime_provider)
       : computation_(computation),
         cost_analysis_(cost_analysis_options, device_info),
         fusion_process_dump_(fusion_process_dump),
         thread_pool_(thread_pool),
-        fusion_analysis_cache_(fusion_analysis_cache) {
+        fusion_analysis_cache_(fusion_analysis_cache),
+        fusion_runtime_provider_(fusion_runtime_provider) {
     VLOG(2) << "Running full HLO cost analysis for " << computation_->name();
     TF_CHECK_OK(computation_->Accept(&cost_analysis_));
 
@@ -379,7 +384,8 @@ class GpuPriorityFusionQueue : public FusionQueue {
         GpuPerformanceModel::EstimateRunTimes(
             producer, &cost_analysis_,
             GpuPerformanceModelOptions::PriorityFusion(
-                &fusion_analysis_cache_, &gpu_performance_model_cache_),
+                &fusion_analysis_cache_, &gpu_performance_model_cache_,
+                fusion_runtime_provider_),
             producer->users());
     if (fusion_process_dump_) {
       absl::MutexLock lock(&fusion_process_dump_mutex_);
@@ -571,6 +577,9 @@ class GpuPriorityFusionQueue : public FusionQueue {
 
   HloFusionAnalysisCache& fusion_analysis_cache_;
 
+  // Measured runtimes that override the cost model. May be null.
+  const FusionRuntimeProvider* fusion_runtime_provider_;
+
   // Caches result of can_fuse for a (producer, consumer) pair. A cache entry is
   // invalidated if producer or consumer is modified.
   absl::flat_hash_map<
@@ -669,6 +678,13 @@ StatusOr<bool> GpuPriorityFusion::Run(
     DumpPerModuleProtobufToFile(*module, *fusion_process_dump_,
                                 module->config().debug_options(),
                                 "priority_fusion_dump");
+    if (const FusionRuntimeProvider* provider =
+            GetFusionRuntimeProvider(*module)) {
+      DumpPerModuleProtobufToFile(
+          *module,
+          MakeFusionRuntimeReport(*module, execution_threads, *provider),
+          module->config().debug_options(), "fusion_runtime_report");
+    }
   }
 
   return result;
@@ -716,11 +732,77 @@ HloInstruction* GpuPriorityFusion::FuseInstruction(
   return result;
 }
 
+const FusionRuntimeProvider* GpuPriorityFusion::GetFusionRuntimeProvider(
+    const HloModule& module) {
+  if (fusion_runtime_provider_) {
+    return fusion_runtime_provider_;
+  }
+  const std::string& path =
+      module.config().debug_options().xla_gpu_fusion_runtime_profile();
+  if (path != loaded_fusion_runtimes_path_) {
+    loaded_fusion_runtimes_path_ = path;
+    loaded_fusion_runtimes_.reset();
+    if (!path.empty()) {
+      auto measured = MeasuredFusionRuntimes::LoadFromFile(path);
+      if (!measured.ok()) {
+        LOG(WARNING) << "Failed to load fusion runtime profile " << path << ": "
+                     << measured.status();
+      } else if (!(*measured)->device_name().empty() &&
+                 (*measured)->device_name() != device_info_.name()) {
+        LOG(WARNING) << "Ignoring fusion runtime profile " << path
+                     << " measured on " << (*measured)->device_name()
+                     << ", compiling for " << device_info_.name();
+      } else {
+        VLOG(1) << "Loaded " << (*measured)->size()
+                << " measured fusion runtimes from " << path;
+        loaded_fusion_runtimes_ = *std::move(measured);
+      }
+    }
+  }
+  return loaded_fusion_runtimes_.get();
+}
+
+FusionRuntimeReport GpuPriorityFusion::MakeFusionRuntimeReport(
+    const HloModule& module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    const FusionRuntimeProvider& provider) {
+  FusionRuntimeReport report;
+  for (const HloComputation* computation :
+       module.MakeNonfusionComputations(execution_threads)) {
+    GpuHloCostAnalysis cost_analysis(cost_analysis_options_, &device_info_);
+    TF_CHECK_OK(computation->Accept(&cost_analysis));
+    for (const HloInstruction* instruction : computation->instructions()) {
+      if (instruction->opcode() != HloOpcode::kFusion) {
+        continue;
+      }
+      auto fusion = HloFusionAdaptor::ForInstruction(instruction);
+      // The prediction deliberately ignores `provider`.
+      EstimateRunTimeData predicted =
+          GpuPerformanceModel::EstimateRunTimeForInstruction(
+              instruction, &cost_analysis,
+              GpuPerformanceModelOptions::PriorityFusion(
+                  /*fusion_analysis_cache=*/nullptr,
+                  /*gpu_performance_model_cache=*/nullptr));
+      std::optional<absl::Duration> measured = provider.GetRunTime(*fusion);
+
+      auto* entry = report.add_entries();
+      entry->set_fusion_name(std::string(instruction->name()));
+      entry->set_fingerprint(FusionRuntimeFingerprint(*fusion));
+      entry->set_predicted_ns(absl::ToInt64Nanoseconds(predicted.exec_time));
+      if (measured) {
+        entry->set_measured_ns(absl::ToInt64Nanoseconds(*measured));
+      }
+    }
+  }
+  return report;
+}
+
 std::unique_ptr<FusionQueue> GpuPriorityFusion::GetFusionQueue(
     HloComputation* computation) {
   return std::unique_ptr<FusionQueue>(new GpuPriorityFusionQueue(
       computation, cost_analysis_options_, &device_info_,
-      fusion_process_dump_.get(), thread_pool_, fusion_analysis_cache_));
+      fusion_process_dump_.get(), thread_pool_, fusion_analysis_cache_,
+      GetFusionRuntimeProvider(*computation->parent())));
 }
 
 }  // namespace gpu
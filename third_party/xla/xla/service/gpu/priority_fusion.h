@@ -19,6 +19,7 @@ limitations under the License.
 #include <stdint.h>
 
 #include <memory>
+#include <string>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
@@ -30,6 +31,7 @@ limitations under the License.
 #include "xla/service/fusion_queue.h"
 #include "xla/service/gpu/fusion_process_dump.pb.h"
 #include "xla/service/gpu/model/fusion_analysis_cache.h"
+#include "xla/service/gpu/model/fusion_runtime_provider.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_pass_interface.h"
@@ -44,11 +46,14 @@ class GpuPriorityFusion : public InstructionFusion {
  public:
   GpuPriorityFusion(tsl::thread::ThreadPool* thread_pool,
                     const se::DeviceDescription& device,
-                    GpuHloCostAnalysis::Options cost_analysis_options)
+                    GpuHloCostAnalysis::Options cost_analysis_options,
+                    const FusionRuntimeProvider* fusion_runtime_provider =
+                        nullptr)
       : InstructionFusion(GpuPriorityFusion::IsExpensive),
         thread_pool_(thread_pool),
         device_info_(device),
         cost_analysis_options_(std::move(cost_analysis_options)),
+        fusion_runtime_provider_(fusion_runtime_provider),
         fusion_analysis_cache_(device_info_) {}
 
   absl::string_view name() const override { return "priority-fusion"; }
@@ -74,12 +79,31 @@ class GpuPriorityFusion : public InstructionFusion {
   HloInstruction* FuseInstruction(HloInstruction* fusion_instruction,
                                   HloInstruction* producer) override;
 
+  // Returns the provider of measured runtimes to use for `module`: the one
+  // passed to the constructor, or the profile named by
+  // --xla_gpu_fusion_runtime_profile. Returns null if there is none.
+  const FusionRuntimeProvider* GetFusionRuntimeProvider(
+      const HloModule& module);
+
+  // Compares the analytical estimate of every fusion in `module` with its
+  // measured runtime.
+  FusionRuntimeReport MakeFusionRuntimeReport(
+      const HloModule& module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads,
+      const FusionRuntimeProvider& provider);
+
   tsl::thread::ThreadPool* thread_pool_;
   se::DeviceDescription device_info_;
 
   // Cost model options that defines priorities in the queue.
   GpuHloCostAnalysis::Options cost_analysis_options_;
 
+  // Measured runtimes that override the cost model, if any. Either owned by
+  // the caller or loaded from `loaded_fusion_runtimes_path_`.
+  const FusionRuntimeProvider* fusion_runtime_provider_;
+  std::unique_ptr<MeasuredFusionRuntimes> loaded_fusion_runtimes_;
+  std::string loaded_fusion_runtimes_path_;
+
   // Proto with structured logs of fusion decisions. Used only for debugging. If
   // null, logging is disabled.
   std::unique_ptr<FusionProcessDumpProto> fusion_process_dump_;
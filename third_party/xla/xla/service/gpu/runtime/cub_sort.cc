@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/gpu/runtime/cub_sort.h"
 
+#include <cstdint>
 #include <optional>
 
 #include "absl/status/status.h"
@@ -37,15 +38,31 @@ namespace {
 using ::stream_executor::DeviceMemoryBase;
 using ::xla::runtime::CustomCall;
 using ::xla::runtime::FlatMemrefView;
+using ::xla::runtime::StridedMemrefView;
+
+// Returns the number of rows sorted independently: higher-rank inputs are
+// sorted along their innermost (unit stride) dimension.
+int64_t GetBatchSize(const StridedMemrefView& keys) {
+  if (keys.sizes.size() <= 1) return 1;
+  int64_t num_elements = 1;
+  int64_t row_size = 1;
+  for (size_t i = 0; i < keys.sizes.size(); ++i) {
+    num_elements *= keys.sizes[i];
+    if (keys.strides[i] == 1) row_size = keys.sizes[i];
+  }
+  return row_size == 0 ? 1 : num_elements / row_size;
+}
 
 absl::Status CubDeviceRadixSortKeysImpl(
-    const ServiceExecutableRunOptions* run_options, FlatMemrefView input_view,
-    FlatMemrefView output_view, FlatMemrefView scratch_view, bool descending) {
+    const ServiceExecutableRunOptions* run_options,
+    StridedMemrefView input_view, FlatMemrefView output_view,
+    FlatMemrefView scratch_view, bool descending) {
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   return RunCubSort(input_view.dtype, std::nullopt,
                     GetDeviceAddress(input_view), DeviceMemoryBase(),
                     GetDeviceAddress(output_view), DeviceMemoryBase(),
-                    GetDeviceAddress(scratch_view), descending);
+                    GetDeviceAddress(scratch_view), descending,
+                    GetBatchSize(input_view));
 #else
   return absl::UnimplementedError("CUB is not available");
 #endif
@@ -53,7 +70,7 @@ absl::Status CubDeviceRadixSortKeysImpl(
 
 absl::Status CubDeviceRadixSortPairsImpl(
     const ServiceExecutableRunOptions* run_options,
-    FlatMemrefView input_keys_view, FlatMemrefView input_values_view,
+    StridedMemrefView input_keys_view, FlatMemrefView input_values_view,
     FlatMemrefView output_keys_view, FlatMemrefView output_values_view,
     FlatMemrefView scratch_view, bool descending) {
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -61,7 +78,8 @@ absl::Status CubDeviceRadixSortPairsImpl(
       input_keys_view.dtype, input_values_view.dtype,
       GetDeviceAddress(input_keys_view), GetDeviceAddress(input_values_view),
       GetDeviceAddress(output_keys_view), GetDeviceAddress(output_values_view),
-      GetDeviceAddress(scratch_view), descending);
+      GetDeviceAddress(scratch_view), descending,
+      GetBatchSize(input_keys_view));
 #else
   return absl::UnimplementedError("CUB is not available");
 #endif
@@ -74,7 +92,7 @@ XLA_RUNTIME_DEFINE_CUSTOM_CALL(
     checks,
     CustomCall::Bind("xla.gpu.radix_sort_keys")
         .UserData<const ServiceExecutableRunOptions*>()
-        .Arg<FlatMemrefView>()  // input
+        .Arg<StridedMemrefView>()  // input
         .Arg<FlatMemrefView>()  // output
         .Arg<FlatMemrefView>()  // scratch
         .Attr<bool>("descending"));
@@ -84,7 +102,7 @@ XLA_RUNTIME_DEFINE_CUSTOM_CALL(
     checks,
     CustomCall::Bind("xla.gpu.radix_sort_pairs")
         .UserData<const ServiceExecutableRunOptions*>()
-        .Arg<FlatMemrefView>()  // input_keys
+        .Arg<StridedMemrefView>()  // input_keys
         .Arg<FlatMemrefView>()  // input_values
         .Arg<FlatMemrefView>()  // output_keys
         .Arg<FlatMemrefView>()  // output_values
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "xla/service/buffer_assignment.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "xla/service/gpu/gemm_thunk.h"
 #include "xla/service/gpu/kernel_thunk.h"
 #include "xla/service/gpu/runtime3/command_buffer_cmd.h"
+#include "xla/service/gpu/runtime3/conditional_thunk.h"
 #include "xla/service/gpu/runtime3/sequential_thunk.h"
 #include "xla/service/gpu/runtime3/while_thunk.h"
 #include "xla/service/gpu/thunk.h"
@@ -76,6 +78,27 @@ static StatusOr<Command> ConvertWhileThunk(const WhileThunk& thunk) {
                                     std::move(cond_cmds), std::move(body_cmds));
 }
 
+static StatusOr<Command> ConvertConditionalThunk(
+    const ConditionalThunk& thunk) {
+  const ConditionalThunkConfig& config = thunk.config();
+  std::vector<CommandBufferCmdSequence> branch_cmds;
+  branch_cmds.reserve(config.branch_thunks.size());
+  for (const std::unique_ptr<SequentialThunk>& branch : config.branch_thunks) {
+    TF_ASSIGN_OR_RETURN(CommandBufferCmdSequence cmds,
+                        ConvertToCommands(branch->thunks()));
+    branch_cmds.push_back(std::move(cmds));
+  }
+
+  // A predicate selects the first branch when true and the second when false.
+  if (config.branch_index_is_bool) {
+    return std::make_unique<IfElseCmd>(thunk.branch_index_buffer(),
+                                       std::move(branch_cmds[0]),
+                                       std::move(branch_cmds[1]));
+  }
+  return std::make_unique<CaseCmd>(thunk.branch_index_buffer(),
+                                   std::move(branch_cmds));
+}
+
 static StatusOr<Command> ConvertGemmThunk(const GemmThunk& thunk) {
   std::optional<const BufferAllocation::Slice> workspace = thunk.workspace();
   if (!workspace.has_value()) {
@@ -98,6 +121,9 @@ static StatusOr<Command> ConvertThunk(const Thunk& thunk) {
           static_cast<const DeviceToDeviceCopyThunk&>(thunk));
     case Thunk::Kind::kWhile:
       return ConvertWhileThunk(static_cast<const WhileThunk&>(thunk));
+    case Thunk::Kind::kConditional:
+      return ConvertConditionalThunk(
+          static_cast<const ConditionalThunk&>(thunk));
     case Thunk::Kind::kGemm: {
       return ConvertGemmThunk(static_cast<const GemmThunk&>(thunk));
     }
@@ -61,6 +61,12 @@ class ConditionalThunk : public Thunk {
     return config_.branch_thunks;
   }
 
+  const ConditionalThunkConfig& config() const { return config_; }
+
+  const BufferAllocation::Slice& branch_index_buffer() const {
+    return branch_index_buffer_index_;
+  }
+
  private:
   const ConditionalThunkConfig config_;
   BufferAllocation::Slice branch_index_buffer_index_;
@@ -172,6 +172,26 @@ ENTRY %main {
   EXPECT_TRUE(has_diff) << "uninitialized output";
 }
 
+// Batched sorts along the minor dimension are rewritten into segmented CUB
+// sorts; the rows must come out the same as with the reference backend.
+TEST_F(SortingTest, CubSegmentedSortRows) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs = f32[] parameter(0)
+  %rhs = f32[] parameter(1)
+  ROOT %gt = pred[] compare(%lhs, %rhs), direction=GT
+}
+
+ENTRY %main {
+  %input = f32[512,256] parameter(0)
+  ROOT %sort = f32[512,256] sort(%input), dimensions={1}, to_apply=%compare
+})";
+
+  EXPECT_TRUE(RunAndCompare(kHlo, ErrorSpec{0, 0}));
+}
+
 // Literal creation helper.
 template <PrimitiveType P, typename T>
 std::shared_ptr<Literal> CreateRandomLiteral(T mean, T stddev) {
@@ -942,10 +942,46 @@ StatusOr<bool> TritonAutotuner::Run(
                                               ? "(with correctness check)"
                                               : "(without correctness check)";
 
+      // With sharded autotuning, this process only autotunes the fusions it
+      // owns and gets the results for the others from their owners.
+      absl::flat_hash_map<const HloFusionInstruction*, GemmConfigSet>
+          not_owned_config_sets;
+      for (auto it = gemm_config_sets.begin(); it != gemm_config_sets.end();) {
+        const AutotuneCacheKey key = AutotunerUtil::GetKey(it->first, config_);
+        if (AutotunerUtil::IsResultOwner(key, config_)) {
+          ++it;
+          continue;
+        }
+        not_owned_config_sets.insert(*it);
+        gemm_config_sets.erase(it++);
+      }
+
       VLOG(1) << "Autotuning " << gemm_config_sets.size() << " fusions "
               << correctness_check_str << ".";
-      TF_RETURN_IF_ERROR(Autotune(config_, *opt_compile_util, thread_pool_,
-                                  debug_options, gemm_config_sets));
+      Status status = Autotune(config_, *opt_compile_util, thread_pool_,
+                               debug_options, gemm_config_sets);
+      // Publish even on failure, so that other processes don't have to wait
+      // for the timeout.
+      for (const auto& [fusion, unused] : gemm_config_sets) {
+        TF_RETURN_IF_ERROR(AutotunerUtil::PublishResult(
+            AutotunerUtil::GetKey(fusion, config_), config_));
+      }
+      TF_RETURN_IF_ERROR(status);
+
+      absl::flat_hash_map<const HloFusionInstruction*, GemmConfigSet>
+          missing_config_sets;
+      for (auto& [fusion, config_set] : not_owned_config_sets) {
+        if (!AutotunerUtil::WaitForResult(
+                AutotunerUtil::GetKey(fusion, config_), config_)) {
+          missing_config_sets.insert({fusion, std::move(config_set)});
+        }
+      }
+      if (!missing_config_sets.empty()) {
+        VLOG(1) << "Autotuning " << missing_config_sets.size()
+                << " fusions without a shared result.";
+        TF_RETURN_IF_ERROR(Autotune(config_, *opt_compile_util, thread_pool_,
+                                    debug_options, missing_config_sets));
+      }
       VLOG(1) << "Done autotuning.";
     }
   }
@@ -38,6 +38,8 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_clone_context.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -2723,7 +2725,11 @@ StatusOr<bool> HloRematerialization::RematerializeComputation(
         }
         if (instructions_added.remat_count == 0) {
           // Unable to find a block to rematerialize.
-          // Consider doubling the block size.
+          // Consider doubling the block size, unless there is no time left for
+          // the more expensive search.
+          if (OverCompileTimeBudget()) {
+            break;
+          }
           min_block_size = max_block_size + 1;
           max_block_size = 2 * max_block_size;
           is_first_phase = false;
@@ -2816,6 +2822,16 @@ StatusOr<bool> HloRematerialization::RematerializeComputation(
   return changed;
 }
 
+bool HloRematerialization::OverCompileTimeBudget() {
+  if (!over_compile_time_budget_ && absl::Now() > deadline_) {
+    LOG(WARNING) << "HloRematerialization exceeded its compile time budget of "
+                 << absl::FormatDuration(options_.compile_time_budget)
+                 << ", only rematerializing single instructions from now on.";
+    over_compile_time_budget_ = true;
+  }
+  return over_compile_time_budget_;
+}
+
 StatusOr<bool> HloRematerialization::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -2839,6 +2855,8 @@ StatusOr<bool> HloRematerialization::Run(
   XLA_VLOG_LINES(3, "Before HloRematerialization:\n" + module->ToString());
 
   // Initialize pass object state.
+  deadline_ = absl::Now() + options_.compile_time_budget;
+  over_compile_time_budget_ = false;
   computation_peak_memory_.clear();
   rematerialized_computations_.clear();
   instructions_rematerialized_ = 0;
@@ -21,6 +21,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
@@ -142,6 +143,11 @@ class HloRematerialization : public HloModulePass {
     CompactShapeFunction compact_shape_function;
 
     std::optional<HostMemoryOffloadConfig> host_memory_offload_config;
+
+    // Time the pass may spend on a module before it falls back to greedily
+    // rematerializing single instructions, without searching for larger
+    // blocks.
+    absl::Duration compile_time_budget = absl::InfiniteDuration();
   };
 
   explicit HloRematerialization(Options options, RematerializationSizes& sizes)
@@ -241,6 +247,13 @@ class HloRematerialization : public HloModulePass {
   // Tracking available channel id numbers to use to apply to rematerialized
   // channel instructions
   int64_t next_channel_id_;
+
+  // Returns true once the compile time budget of the current run is exhausted.
+  bool OverCompileTimeBudget();
+
+  // End of the compile time budget of the current run.
+  absl::Time deadline_ = absl::InfiniteFuture();
+  bool over_compile_time_budget_ = false;
 };
 
 }  // namespace xla
@@ -22,6 +22,7 @@ limitations under the License.
 #include <string>
 
 #include <gmock/gmock.h>
+#include "absl/time/time.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
@@ -48,9 +49,9 @@ using ::testing::_;
 class RecomputeAndCompressHloRematerializationTest
     : public RematerializationTestBase {
  protected:
-  StatusOr<bool> RunHloRematerialization(int64_t memory_limit_bytes,
-                                         HloModule* module,
-                                         int64_t min_remat_size = 0) {
+  StatusOr<bool> RunHloRematerialization(
+      int64_t memory_limit_bytes, HloModule* module, int64_t min_remat_size = 0,
+      absl::Duration compile_time_budget = absl::InfiniteDuration()) {
     TF_EXPECT_OK(verifier().Run(module).status());
     if (!module->has_schedule()) {
       HloMemoryScheduler scheduler(
@@ -67,6 +68,7 @@ class RecomputeAndCompressHloRematerializationTest
         /*block_size_limit=*/1, /*block_rematerialization_factor=*/1,
         min_remat_size, /*compact_shape_function=*/nullptr,
         /*host_memory_offload_config=*/std::nullopt);
+    options.compile_time_budget = compile_time_budget;
     HloRematerialization::RematerializationSizes sizes;
     HloRematerialization remat(options, sizes);
     return remat.Run(module);
@@ -113,6 +115,24 @@ TEST_F(RecomputeAndCompressHloRematerializationTest, SingleComputation) {
             remat_bcast);
 }
 
+// An exhausted compile time budget still rematerializes single instructions.
+TEST_F(RecomputeAndCompressHloRematerializationTest,
+       SingleComputationWithoutCompileTimeBudget) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(MakeRematerializableComputation());
+  const HloInstruction* concat = computation->root_instruction()->operand(0);
+  const HloInstruction* bcast = concat->operand(0);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      RunHloRematerialization(
+          /*memory_limit_bytes=*/14 * 1024, module.get(), /*min_remat_size=*/0,
+          /*compile_time_budget=*/absl::ZeroDuration()));
+  EXPECT_TRUE(changed);
+  EXPECT_THAT(concat->operand(0), op::Broadcast(::testing::Ne(bcast)));
+}
+
 // Test rematerialization of a single computation that contains nodes that
 // doesn't contain node worth using remat.
 TEST_F(RecomputeAndCompressHloRematerializationTest,
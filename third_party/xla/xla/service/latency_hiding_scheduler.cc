@@ -704,8 +704,9 @@ class ReadySetLt {
     // Check if memory pressure tracking is enabled. Even if it evaluate memory
     // pressure.
     if (sched_state_.config.memory_limit != UINT64_MAX &&
-        sched_state_.memory_pressure_tracker->memory_usage() >
-            (sched_state_.config.memory_limit / 2)) {
+        (sched_state_.config.strict_memory_limit ||
+         sched_state_.memory_pressure_tracker->memory_usage() >
+             (sched_state_.config.memory_limit / 2))) {
       a_increase = GetMemoryPressureChanges(a);
       b_increase = GetMemoryPressureChanges(b);
       // If out of memory reduce memory at all costs. Choose the instruction
@@ -753,6 +754,22 @@ class ReadySetLt {
               b, "kMemoryPeakOverLimit")) {
         return *value;
       }
+      // Under a strict limit an async start whose latency is already covered
+      // gains nothing from being hoisted further, it only keeps its buffer
+      // live. Scheduling it right away caps the prefetch distance of every
+      // collective at its latency.
+      if (sched_state_.config.strict_memory_limit) {
+        auto is_covered_start = [this](const ScheduleCandidate& c) {
+          return c.node->GetReadyTime() <= sched_state_.current_time &&
+                 sched_state_.async_tracker->IsSupportedAsyncStart(
+                     c.node->GetInstr());
+        };
+        if (auto value = DefaultSchedulerCore::ChooseBestCandidate(
+                is_covered_start(a), a, is_covered_start(b), b,
+                "kScheduleCoveredStart")) {
+          return *value;
+        }
+      }
     }
     // Some heuristic that try to prioritize unlocking "done" instructions
     // so that we can perform overlap. More fancy heuristics can be used by
@@ -1881,6 +1898,7 @@ LatencyHidingScheduler::LatencyHidingStatistics(
     return it;
   };
   absl::flat_hash_map<AsyncKind, double> wasted_time_per_collective;
+  double overlapped_cycles = 0;
   SchedulerConfig config;
   config.schedule_send_recvs = true;
   config.use_real_cost_model = true;
@@ -1906,6 +1924,7 @@ LatencyHidingScheduler::LatencyHidingStatistics(
       auto edge_it = find_node_successor_edge(start_node, instr_node);
       const double async_wasted_cycles =
           std::max(0.0, edge_it->Latency() - (current_time - std::get<1>(*it)));
+      overlapped_cycles += edge_it->Latency() - async_wasted_cycles;
       AsyncKind kind = opcode_to_async_kind(
           async_tracker->GetCanonicalAsyncOp(*start_instr).inner);
       wasted_time_per_collective[kind] += async_wasted_cycles;
@@ -1945,7 +1964,8 @@ LatencyHidingScheduler::LatencyHidingStatistics(
       /*memory_pressure_peak=*/
       memory_pressure_state ? mem_pressure_tracker.initial_memory_pressure() +
                                   memory_pressure_state->memory_peak
-                            : 0};
+                            : 0,
+      /*overlapped_cycles=*/overlapped_cycles};
 }
 
 // Prints a SchedulerStatistics object.
@@ -1985,6 +2005,8 @@ std::string LatencyHidingScheduler::SchedulerStatisticsString(
   absl::StrAppend(&result, "Total cycles: ", sched_stats.total_cycles, "\n");
   absl::StrAppend(&result, "Memory pressure peak (bytes): ",
                   sched_stats.memory_pressure_peak, "\n");
+  absl::StrAppend(&result, "Overlapped cycles: ", sched_stats.overlapped_cycles,
+                  "\n");
   return result;
 }
 
@@ -2049,6 +2071,15 @@ StatusOr<bool> LatencyHidingScheduler::Run(
   }
   LOG(INFO) << "LatencyHidingScheduler current memory usage: "
             << scheduler_core_->GetMemoryPeak() << " bytes.";
+  const bool strict_memory_limit = scheduler_core_->IsMemoryLimitStrict();
+  if (strict_memory_limit &&
+      scheduler_core_->GetMemoryPeak() > initial_memory_limit) {
+    LOG(WARNING) << "LatencyHidingScheduler could not fit the schedule in the "
+                    "strict memory limit of "
+                 << initial_memory_limit << " bytes, keeping the input "
+                 << "schedule of module " << module->name();
+    return false;
+  }
   for (HloComputation* computation : computations_to_schedule) {
     VLOG(1) << "Statistics before scheduling:";
     LogScheduleStatistics(computation);
@@ -2056,6 +2087,15 @@ StatusOr<bool> LatencyHidingScheduler::Run(
         computation, absl::MakeConstSpan(saved_schedules[computation]));
     VLOG(1) << "Statistics after scheduling:";
     LogScheduleStatistics(computation);
+    if (strict_memory_limit) {
+      SchedulerStatistics stats = LatencyHidingStatistics(
+          computation, latency_estimator_.get(), async_tracker_.get(),
+          shape_size_bytes_);
+      LOG(INFO) << "LatencyHidingScheduler " << computation->name()
+                << ": overlapped cycles: " << stats.overlapped_cycles
+                << ", memory pressure peak: " << stats.memory_pressure_peak
+                << " bytes (limit " << initial_memory_limit << " bytes)";
+    }
   }
   return true;
 }
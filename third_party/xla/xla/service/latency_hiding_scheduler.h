@@ -110,6 +110,11 @@ struct SchedulerConfig {
   bool resource_sharing = false;
   bool resource_serializing = false;
   bool depth_based_memory_pressure_reduction = false;
+  // Treat memory_limit as a hard limit. Memory pressure is taken into account
+  // for every scheduling decision, async starts are not hoisted past the point
+  // where their latency is covered, and if the reruns cannot bring the peak
+  // under the limit the input schedule is kept.
+  bool strict_memory_limit = false;
   int64_t rerun = 0;
 };
 
@@ -271,6 +276,7 @@ class SchedulerCore {
   virtual void SetMemoryLimit(uint64_t new_limit) = 0;
   virtual uint64_t GetMemoryLimit() = 0;
   virtual int64_t GetRerunTimes() = 0;
+  virtual bool IsMemoryLimitStrict() { return false; }
 };
 
 // Represents an edge between two nodes in the schedule graph.
@@ -833,6 +839,7 @@ class DefaultSchedulerCore : public SchedulerCore {
     this->config_.memory_limit = new_limit;
   }
   int64_t GetRerunTimes() override { return config_.rerun; }
+  bool IsMemoryLimitStrict() override { return config_.strict_memory_limit; }
 
  protected:
   virtual void LogInstruction(const HloInstruction* instr) const;
@@ -877,6 +884,8 @@ class LatencyHidingScheduler : public HloModulePass {
     double recv_wasted_cycles = 0;
     double total_cycles = 0;
     int64_t memory_pressure_peak = 0;
+    // Cycles of async op latency hidden behind other work.
+    double overlapped_cycles = 0;
   };
 
   LatencyHidingScheduler(
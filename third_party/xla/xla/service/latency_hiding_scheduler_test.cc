@@ -2917,6 +2917,40 @@ TEST_F(LatencyHidingSchedulerTest, RerunWithSmallerMemoryLimit) {
             PositionInVector(new_instruction_sequence, cps));
 }
 
+TEST_F(LatencyHidingSchedulerTest, StrictMemoryLimitKeepsInputSchedule) {
+  absl::string_view hlo_string = R"(
+    HloModule strict_memory_limit_test, is_scheduled=true
+    ENTRY main {
+     p0 = bf16[8]{0} parameter(0)
+     c = bf16[] constant(0)
+     b = bf16[43]{0} broadcast(c), dimensions={}
+     s = bf16[1]{0} slice(b), slice={[0:1]}
+     cp = bf16[8]{0} collective-permute(p0), source_target_pairs={{0,1},{1,2},{2,3}}
+    ROOT tuple = (bf16[8]{0}, bf16[1]{0}) tuple(cp, s)
+  }
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module, ParseHloText(hlo_string));
+  HloSchedule& module_schedule = hlo_module->schedule();
+  HloComputation* entry_computation = hlo_module->entry_computation();
+  auto sched_config = GetDefaultSchedConfig();
+  // No schedule fits in 50 bytes, so the scheduler must not move anything.
+  sched_config.memory_limit = 50;
+  sched_config.rerun = 1;
+  sched_config.strict_memory_limit = true;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunScheduler(hlo_module.get(), sched_config));
+  EXPECT_FALSE(changed);
+  std::vector<HloInstruction*> new_instruction_sequence =
+      module_schedule.sequence(entry_computation).instructions();
+  const HloInstruction* cps =
+      FindInstruction(hlo_module.get(), "collective-permute-start");
+  const HloInstruction* cpd =
+      FindInstruction(hlo_module.get(), "collective-permute-done");
+  EXPECT_EQ(PositionInVector(new_instruction_sequence, cps) + 1,
+            PositionInVector(new_instruction_sequence, cpd));
+}
+
 TEST_F(LatencyHidingSchedulerTest, MultipleAsyncDoneOperationsDoNotCreateLoop) {
   absl::string_view hlo_string = R"(
 HloModule multiple_async_done_scheduler_test, is_scheduled=true
@@ -0,0 +1,112 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/parallel_computation_runner.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/status.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+// Groups "computations" by their longest distance from a computation that is
+// not called by any other, deepest first.
+std::vector<std::vector<HloComputation*>> GroupByCallDepth(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    const std::vector<HloComputation*>& computations) {
+  absl::flat_hash_map<const HloComputation*, int> depths;
+  std::vector<HloComputation*> post_order =
+      module->MakeComputationPostOrder(execution_threads);
+  // Callers come before their callees in reverse post order.
+  for (auto it = post_order.rbegin(); it != post_order.rend(); ++it) {
+    const int depth = depths[*it];
+    for (const HloInstruction* instruction : (*it)->instructions()) {
+      for (const HloComputation* callee :
+           instruction->called_computations()) {
+        int& callee_depth = depths[callee];
+        callee_depth = std::max(callee_depth, depth + 1);
+      }
+    }
+  }
+
+  int max_depth = 0;
+  for (const HloComputation* computation : computations) {
+    max_depth = std::max(max_depth, depths[computation]);
+  }
+  std::vector<std::vector<HloComputation*>> groups(max_depth + 1);
+  for (HloComputation* computation : computations) {
+    groups[max_depth - depths[computation]].push_back(computation);
+  }
+  return groups;
+}
+
+}  // namespace
+
+StatusOr<bool> RunOnNonfusionComputations(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    tsl::thread::ThreadPool* thread_pool,
+    absl::FunctionRef<StatusOr<bool>(HloComputation*)> run) {
+  std::vector<HloComputation*> computations =
+      module->MakeNonfusionComputations(execution_threads);
+  bool changed = false;
+  if (thread_pool == nullptr || thread_pool->NumThreads() <= 1 ||
+      computations.size() <= 1) {
+    for (HloComputation* computation : computations) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed, run(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  for (const std::vector<HloComputation*>& group :
+       GroupByCallDepth(module, execution_threads, computations)) {
+    if (group.empty()) continue;
+    absl::Mutex mu;
+    Status status;
+    absl::BlockingCounter counter(group.size() - 1);
+    auto run_one = [&](HloComputation* computation) {
+      StatusOr<bool> computation_changed = run(computation);
+      absl::MutexLock lock(&mu);
+      if (!computation_changed.ok()) {
+        status.Update(computation_changed.status());
+      } else {
+        changed |= *computation_changed;
+      }
+    };
+    for (size_t i = 1; i < group.size(); ++i) {
+      thread_pool->Schedule([&, i]() {
+        run_one(group[i]);
+        counter.DecrementCount();
+      });
+    }
+    // The calling thread takes part in the work instead of idling.
+    run_one(group[0]);
+    counter.Wait();
+    TF_RETURN_IF_ERROR(status);
+  }
+  return changed;
+}
+
+}  // namespace xla
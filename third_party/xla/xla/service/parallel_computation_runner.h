@@ -0,0 +1,49 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_PARALLEL_COMPUTATION_RUNNER_H_
+#define XLA_SERVICE_PARALLEL_COMPUTATION_RUNNER_H_
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/statusor.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+
+// Runs "run" on each non-fusion computation of "module" in
+// "execution_threads" and returns whether any run changed its computation.
+//
+// Without a thread pool, computations are run one at a time, in the order of
+// HloModule::MakeNonfusionComputations. With one, computations are grouped by
+// their depth in the call graph, from the deepest to the entry computation.
+// Computations of one group neither call nor are called by each other, so
+// they are run concurrently on "thread_pool".
+//
+// "run" must be computation-local: it may only change the computation it is
+// given, although it may read the computations it calls and add new
+// computations to the module. Computations added by "run" are not visited.
+StatusOr<bool> RunOnNonfusionComputations(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    tsl::thread::ThreadPool* thread_pool,
+    absl::FunctionRef<StatusOr<bool>(HloComputation*)> run);
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_PARALLEL_COMPUTATION_RUNNER_H_
@@ -0,0 +1,104 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/parallel_computation_runner.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/tests/hlo_test_base.h"
+#include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+namespace {
+
+using ParallelComputationRunnerTest = HloTestBase;
+
+constexpr char kHlo[] = R"(
+HloModule module
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+mul {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT mul = f32[] multiply(x, y)
+}
+
+reduce_add {
+  p = f32[8] parameter(0)
+  c = f32[] constant(0)
+  ROOT r = f32[] reduce(p, c), dimensions={0}, to_apply=add
+}
+
+ENTRY entry {
+  p = f32[8] parameter(0)
+  c = f32[] constant(1)
+  sum = f32[] call(p), to_apply=reduce_add
+  prod = f32[] reduce(p, c), dimensions={0}, to_apply=mul
+  ROOT out = f32[] add(sum, prod)
+}
+)";
+
+TEST_F(ParallelComputationRunnerTest, RunsCalleesBeforeCallers) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 4);
+  absl::Mutex mu;
+  int next_index = 0;
+  absl::flat_hash_map<std::string, int> visit_index;
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      RunOnNonfusionComputations(
+          module.get(), /*execution_threads=*/{}, &thread_pool,
+          [&](HloComputation* computation) -> StatusOr<bool> {
+            absl::MutexLock lock(&mu);
+            visit_index[computation->name()] = next_index++;
+            return computation->name() == "mul";
+          }));
+  EXPECT_TRUE(changed);
+  ASSERT_EQ(visit_index.size(), 4);
+  EXPECT_LT(visit_index["add"], visit_index["reduce_add"]);
+  EXPECT_LT(visit_index["reduce_add"], visit_index["entry"]);
+  EXPECT_LT(visit_index["mul"], visit_index["entry"]);
+}
+
+TEST_F(ParallelComputationRunnerTest, ReturnsError) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 4);
+  auto status = RunOnNonfusionComputations(
+      module.get(), /*execution_threads=*/{}, &thread_pool,
+      [](HloComputation* computation) -> StatusOr<bool> {
+        if (computation->name() == "mul") {
+          return InternalError("failed on mul");
+        }
+        return false;
+      });
+  EXPECT_FALSE(status.ok());
+}
+
+}  // namespace
+}  // namespace xla
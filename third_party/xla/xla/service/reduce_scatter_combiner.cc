@@ -166,12 +166,14 @@ Status CombineReduceScatters(absl::Span<HloInstruction* const> to_combine) {
 }
 }  // namespace
 
-ReduceScatterCombiner::ReduceScatterCombiner(int64_t combine_threshold_in_bytes,
-                                             int64_t combine_threshold_count,
-                                             bool combine_by_dim)
+ReduceScatterCombiner::ReduceScatterCombiner(
+    int64_t combine_threshold_in_bytes, int64_t combine_threshold_count,
+    bool combine_by_dim, CombineThresholdBytesFn combine_threshold_in_bytes_fn)
     : combine_threshold_in_bytes_(combine_threshold_in_bytes),
       combine_threshold_count_(combine_threshold_count),
-      combine_by_dim_(combine_by_dim) {}
+      combine_by_dim_(combine_by_dim),
+      combine_threshold_in_bytes_fn_(std::move(combine_threshold_in_bytes_fn)) {
+}
 
 StatusOr<bool> ReduceScatterCombiner::Run(
     HloModule* module,
@@ -191,6 +193,12 @@ StatusOr<bool> ReduceScatterCombiner::Run(
     return false;
   }
 
+  auto threshold_fn = [this](const HloInstruction* instruction) {
+    return combine_threshold_in_bytes_fn_
+               ? combine_threshold_in_bytes_fn_(instruction)
+               : combine_threshold_in_bytes_;
+  };
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -217,8 +225,8 @@ StatusOr<bool> ReduceScatterCombiner::Run(
     TF_ASSIGN_OR_RETURN(
         bool computation_changed,
         CombineInstructionsByKey<ReduceScatterKey>(
-            computation, key_fn, &CombineReduceScatters,
-            combine_threshold_in_bytes_, combine_threshold_count_));
+            computation, key_fn, &CombineReduceScatters, threshold_fn,
+            combine_threshold_count_));
     changed |= computation_changed;
   }
 
@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_REDUCE_SCATTER_COMBINER_H_
 
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/collective_combiner_utils.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/statusor.h"
 
@@ -28,8 +29,10 @@ namespace xla {
 // more efficient than many small ones.
 class ReduceScatterCombiner : public HloModulePass {
  public:
-  ReduceScatterCombiner(int64_t combine_threshold_in_bytes,
-                        int64_t combine_threshold_count, bool combine_by_dim);
+  ReduceScatterCombiner(
+      int64_t combine_threshold_in_bytes, int64_t combine_threshold_count,
+      bool combine_by_dim,
+      CombineThresholdBytesFn combine_threshold_in_bytes_fn = nullptr);
 
   absl::string_view name() const override { return "reduce-scatter-combiner"; }
 
@@ -47,6 +50,10 @@ class ReduceScatterCombiner : public HloModulePass {
 
   // Combine only reduce-scatter ops with the same dimension.
   bool combine_by_dim_;
+
+  // If set, overrides combine_threshold_in_bytes for each set of combined
+  // ops, given its first op.
+  CombineThresholdBytesFn combine_threshold_in_bytes_fn_;
 };
 
 }  // namespace xla
@@ -54,6 +54,7 @@ limitations under the License.
 #include "xla/service/call_graph.h"
 #include "xla/service/computation_layout.h"
 #include "xla/service/flatten_call_graph.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_cse.h"
 #include "xla/service/hlo_dce.h"
 #include "xla/service/hlo_module_config.h"
@@ -2264,6 +2265,53 @@ std::vector<ReplicaGroup> SpmdPartitioningVisitor::CreateReplicaGroups(
   return device_groups;
 }
 
+double SpmdPartitioningVisitor::GetComputationTimeInMilliSec(
+    HloInstruction* hlo) {
+  const SpmdPartitionerOptions::WindowedEinsumCostModel& cost_model =
+      options_.windowed_einsum_cost_model;
+  if (cost_model.device_flops_per_second <= 0) {
+    return 0.0;
+  }
+  int64_t flops = 0;
+  if (hlo->opcode() == HloOpcode::kDot) {
+    flops = HloCostAnalysis::GetDotFlops(hlo->operand(0)->shape(), hlo->shape(),
+                                         hlo->dot_dimension_numbers());
+  } else if (hlo->opcode() == HloOpcode::kConvolution) {
+    flops = HloCostAnalysis::GetConvolutionFlops(
+        hlo, hlo->operand(0)->shape(), hlo->operand(1)->shape(), hlo->shape());
+  }
+  double seconds = flops / cost_model.device_flops_per_second;
+  if (cost_model.device_bytes_per_second > 0) {
+    int64_t bytes = ShapeSizeInBytes(hlo->shape());
+    for (const HloInstruction* operand : hlo->operands()) {
+      bytes += ShapeSizeInBytes(operand->shape());
+    }
+    seconds = std::max(seconds, bytes / cost_model.device_bytes_per_second);
+  }
+  return seconds * 1e3;
+}
+
+double SpmdPartitioningVisitor::GetCommunicationTimeInMilliSec(
+    int64_t bytes, absl::Span<const ReplicaGroup> device_groups) {
+  const SpmdPartitionerOptions::WindowedEinsumCostModel& cost_model =
+      options_.windowed_einsum_cost_model;
+  if (cost_model.device_flops_per_second <= 0 ||
+      cost_model.collective_bytes_per_second <= 0) {
+    return 0.0;
+  }
+  int64_t group_size = device_groups.empty()
+                           ? num_partitions_
+                           : device_groups[0].replica_ids_size();
+  if (group_size <= 1) {
+    return 0.0;
+  }
+  // Ring algorithms send (n - 1) / n of the data through each device.
+  double seconds = cost_model.collective_latency_in_us * 1e-6 +
+                   static_cast<double>(bytes) * (group_size - 1) / group_size /
+                       cost_model.collective_bytes_per_second;
+  return seconds * 1e3;
+}
+
 Status SpmdPartitioningVisitor::DefaultAction(HloInstruction* hlo) {
   if (hlo->HasSideEffect() && !hlo->sharding().HasUniqueDevice()) {
     return Unimplemented("Side-effect ops cannot be replicated: %s",
@@ -86,6 +86,22 @@ struct SpmdPartitionerOptions {
   bool enable_windowed_einsum_for_all_gather = true;
   // Enables windowed einsum for result reduce-scatter.
   bool enable_windowed_einsum_for_reduce_scatter = true;
+
+  // Roofline model of the target used to estimate whether a windowed einsum
+  // hides its collective behind the partial dots. When the estimated overlap
+  // does not beat running the dot and the collective back to back, windowed
+  // einsum is not used. Disabled when device_flops_per_second is zero, in
+  // which case only threshold_for_windowed_einsum_mib applies.
+  struct WindowedEinsumCostModel {
+    double device_flops_per_second = 0;
+    // Device memory bandwidth. If positive, a dot is never estimated to be
+    // faster than reading its operands and writing its result.
+    double device_bytes_per_second = 0;
+    // Bandwidth per device and fixed latency of a collective.
+    double collective_bytes_per_second = 0;
+    double collective_latency_in_us = 0;
+  };
+  WindowedEinsumCostModel windowed_einsum_cost_model;
 };
 
 // Class to wrap the computation builder to capture information during SPMD
@@ -592,14 +608,12 @@ class SpmdPartitioningVisitor : public DfsHloVisitorWithDefault {
                                      const HloSharding& root_sharding,
                                      const SpmdPartitionerOptions& options);
 
-  virtual double GetComputationTimeInMilliSec(HloInstruction* hlo) {
-    return 0.0;
-  }
+  // Estimated times used to decide on windowed einsum. By default they come
+  // from options().windowed_einsum_cost_model, and are 0 if it is disabled.
+  virtual double GetComputationTimeInMilliSec(HloInstruction* hlo);
 
   virtual double GetCommunicationTimeInMilliSec(
-      int64_t bytes, absl::Span<const ReplicaGroup> device_groups) {
-    return 0.0;
-  }
+      int64_t bytes, absl::Span<const ReplicaGroup> device_groups);
 
   virtual int GetCommunicationMultiplier(
       absl::Span<const ReplicaGroup> device_groups) {
@@ -53,7 +53,9 @@ class SpmdPartitioningTest
       bool choose_faster_windowed_einsum = false,
       bool unroll_windowed_einsum = false,
       bool bidirectional_windowed_einsum = false,
-      int64_t threshold_for_windowed_einsum_mib = -1) {
+      int64_t threshold_for_windowed_einsum_mib = -1,
+      SpmdPartitionerOptions::WindowedEinsumCostModel
+          windowed_einsum_cost_model = {}) {
     // Some tests (BackpropFilter convs) set this flag false to test two
     // different paths of the implementation.
     SpmdPartitionerOptions options;
@@ -67,6 +69,7 @@ class SpmdPartitioningTest
       options.threshold_for_windowed_einsum_mib =
           threshold_for_windowed_einsum_mib;
     }
+    options.windowed_einsum_cost_model = windowed_einsum_cost_model;
     auto collective_ops_creator =
         GetDefaultCollectiveOpsCreator(num_devices, /*num_replicas=*/1);
     // Do not use all-gather for pattern-matching purpose, as the partitioner
@@ -4383,6 +4386,57 @@ ENTRY entry {
   EXPECT_THAT(root, AllOf(op::Dot(lhs, rhs), op::Shape("f32[24,19648]")));
 }
 
+TEST_P(SpmdPartitioningTest, WindowedEinsumCostModel) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %p0 = f32[2048,2,3264]{2,1,0} parameter(0), sharding={devices=[1,1,2]0,1}
+  %p1 = f32[2,3264,2176]{2,1,0} parameter(1), sharding={devices=[2,1,1]0,1}
+  ROOT %dot.224 = f32[2048,2176]{1,0} dot(f32[2048,2,3264]{2,1,0} %p0, f32[2,3264,2176]{2,1,0} %p1), lhs_contracting_dims={1,2}, rhs_contracting_dims={0,1}, sharding={devices=[1,2]0,1}
+})";
+  auto has_while = [](const HloModule& module) {
+    return absl::c_any_of(module.entry_computation()->instructions(),
+                          [](const HloInstruction* instr) {
+                            return instr->opcode() == HloOpcode::kWhile;
+                          });
+  };
+
+  // The collective is much slower than the dot, so splitting it into
+  // collective-permutes only adds the extra permute of the prologue.
+  SpmdPartitionerOptions::WindowedEinsumCostModel slow_collective;
+  slow_collective.device_flops_per_second = 1e15;
+  slow_collective.collective_bytes_per_second = 1e9;
+  slow_collective.collective_latency_in_us = 10;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      PartitionComputation(hlo_string, /*num_devices=*/2,
+                           /*conv_halo_exchange_always_on_lhs=*/true,
+                           /*choose_faster_windowed_einsum=*/false,
+                           /*unroll_windowed_einsum=*/false,
+                           /*bidirectional_windowed_einsum=*/false,
+                           /*threshold_for_windowed_einsum_mib=*/0,
+                           slow_collective));
+  VLOG(1) << module->ToString();
+  EXPECT_FALSE(has_while(*module));
+
+  // A negligible collective is always worth overlapping.
+  SpmdPartitionerOptions::WindowedEinsumCostModel fast_collective;
+  fast_collective.device_flops_per_second = 1e9;
+  fast_collective.collective_bytes_per_second = 1e18;
+  TF_ASSERT_OK_AND_ASSIGN(
+      module,
+      PartitionComputation(hlo_string, /*num_devices=*/2,
+                           /*conv_halo_exchange_always_on_lhs=*/true,
+                           /*choose_faster_windowed_einsum=*/false,
+                           /*unroll_windowed_einsum=*/false,
+                           /*bidirectional_windowed_einsum=*/false,
+                           /*threshold_for_windowed_einsum_mib=*/0,
+                           fast_collective));
+  VLOG(1) << module->ToString();
+  EXPECT_TRUE(has_while(*module));
+}
+
 TEST_P(SpmdPartitioningTest, WindowedEinsumTwoContractingDimsLhsReshard) {
   absl::string_view hlo_string = R"(
 HloModule module
@@ -45,11 +45,15 @@ class StatefulRngSpmdPartitioningVisitor
 
 class StatefulRngSpmdPartitioner : public spmd::SpmdPartitioner {
  public:
-  StatefulRngSpmdPartitioner(int64_t num_partitions, int64_t num_replicas,
-                             int64_t threshold_for_windowed_einsum_mib = 100000)
+  StatefulRngSpmdPartitioner(
+      int64_t num_partitions, int64_t num_replicas,
+      int64_t threshold_for_windowed_einsum_mib = 100000,
+      spmd::SpmdPartitionerOptions::WindowedEinsumCostModel
+          windowed_einsum_cost_model = {})
       : spmd::SpmdPartitioner(
             num_partitions, num_replicas,
-            GetSpmdPartitionerOptions(threshold_for_windowed_einsum_mib)) {}
+            GetSpmdPartitionerOptions(threshold_for_windowed_einsum_mib,
+                                      windowed_einsum_cost_model)) {}
 
  protected:
   std::unique_ptr<spmd::SpmdPartitioningVisitor> CreateVisitor(
@@ -67,11 +71,14 @@ class StatefulRngSpmdPartitioner : public spmd::SpmdPartitioner {
 
  private:
   static spmd::SpmdPartitionerOptions GetSpmdPartitionerOptions(
-      int64_t threshold_for_windowed_einsum_mib) {
+      int64_t threshold_for_windowed_einsum_mib,
+      spmd::SpmdPartitionerOptions::WindowedEinsumCostModel
+          windowed_einsum_cost_model) {
     spmd::SpmdPartitionerOptions options;
     options.allow_module_signature_change = true;
     options.threshold_for_windowed_einsum_mib =
         threshold_for_windowed_einsum_mib;
+    options.windowed_einsum_cost_model = windowed_einsum_cost_model;
     return options;
   }
 };
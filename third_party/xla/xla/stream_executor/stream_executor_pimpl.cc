@@ -546,6 +546,22 @@ void StreamExecutor::HostMemoryDeallocate(void* location) {
   return implementation_->HostMemoryDeallocate(location);
 }
 
+bool StreamExecutor::HostMemoryRegister(void* location, uint64_t size) {
+  VLOG(1) << "Called StreamExecutor::HostMemoryRegister(location=" << location
+          << ", size=" << size << ")" << StackTraceIfVLOG10();
+  if (location == nullptr || size == 0) {
+    LOG(WARNING) << "attempting to register null or zero-sized memory: "
+                 << location << "; size " << size;
+  }
+  return implementation_->HostMemoryRegister(location, size);
+}
+
+bool StreamExecutor::HostMemoryUnregister(void* location) {
+  VLOG(1) << "Called StreamExecutor::HostMemoryUnregister(location="
+          << location << ")" << StackTraceIfVLOG10();
+  return implementation_->HostMemoryUnregister(location);
+}
+
 bool StreamExecutor::SynchronizeAllActivity() {
   VLOG(1) << "Called StreamExecutor::SynchronizeAllActivity()"
           << StackTraceIfVLOG10();
@@ -186,6 +186,13 @@ class StreamExecutor {
   // Deallocates a region of host memory allocated by HostMemoryAllocate().
   void HostMemoryDeallocate(void* location);
 
+  // Registers a region of host memory with the platform API, making it usable
+  // in asynchronous memcpy operations. Returns false on failure.
+  bool HostMemoryRegister(void* location, uint64_t size) ABSL_MUST_USE_RESULT;
+
+  // Unregisters a region of host memory registered with HostMemoryRegister().
+  bool HostMemoryUnregister(void* location) ABSL_MUST_USE_RESULT;
+
   // Synchronizes all activity occurring in the StreamExecutor's context (most
   // likely a whole device).
   bool SynchronizeAllActivity() ABSL_MUST_USE_RESULT;